@@ -2,7 +2,9 @@
 #define LIBWALLY_CORE_WALLY_HPP
 #pragma once
 
+#include <array>
 #include <type_traits>
+#include <utility>
 #include <string>
 #include <wally_address.h>
 #include <wally_bip32.h>
@@ -10,9 +12,18 @@
 #include <wally_bip39.h>
 #include <wally_core.h>
 #include <wally_crypto.h>
+#include <wally_psbt.h>
 #include <wally_script.h>
 #include <wally_transaction.h>
 
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <cstddef>
+#include <memory_resource>
+#define WALLY_HAVE_PMR 1
+#endif
+#endif
+
 /* These wrappers allow passing containers such as std::vector, std::array,
  * std::string and custom classes as input/output buffers to wally functions.
  */
@@ -49,6 +60,10 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(i321, i322, i323, WALLYB(i1), WALLYB(i2), WALLYB(i3), WALLYB(i4), WALLYB(i5), out); \
 }
 
+#define WALLY_FN_3333_S(F, N) inline int F(uint32_t i321, uint32_t i322, uint32_t i323, uint32_t i324, size_t * written) { \
+        return ::N(i321, i322, i323, i324, written); \
+}
+
 #define WALLY_FN_33SS_A(F, N) template <class O> inline int F(uint32_t i321, uint32_t i322, size_t s1, size_t s2, O * *out) { \
         return ::N(i321, i322, s1, s2, out); \
 }
@@ -168,6 +183,16 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(WALLYB(i1), written); \
 }
 
+#define WALLY_FN_BS_BS(F, N) template <class I1, class O> inline int F(const I1 &i1, size_t s1, O & out, size_t * written = 0) { \
+        size_t n; \
+        int ret = ::N(WALLYB(i1), s1, WALLYO(out), written ? written : &n); \
+        return written || ret != WALLY_OK ? ret : n == static_cast<size_t>(out.size()) ? WALLY_OK : WALLY_EINVAL; \
+}
+
+#define WALLY_FN_BBSB(F, N) template <class I1, class I2, class I3> inline int F(const I1 &i1, const I2 &i2, size_t s1, const I3 &i3) { \
+        return ::N(WALLYB(i1), WALLYB(i2), s1, WALLYB(i3)); \
+}
+
 #define WALLY_FN_BB33_B(F, N) template <class I1, class I2, class O> inline int F(const I1 &i1, const I2 &i2, uint32_t i321, uint32_t i322, O & out) { \
         return ::N(WALLYB(i1), WALLYB(i2), i321, i322, WALLYO(out)); \
 }
@@ -202,6 +227,18 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(WALLYP(p1), i321, WALLYB(i1), WALLYB(i2), i322, i641, i323, i324, i325, WALLYO(out)); \
     }
 
+#define WALLY_FN_PBBB33(F, N) template <class P1, class I1, class I2, class I3> inline int F(const P1 &p1, const I1 &i1, const I2 &i2, const I3 &i3, uint32_t i321, uint32_t i322) { \
+        return ::N(WALLYP(p1), WALLYB(i1), WALLYB(i2), WALLYB(i3), i321, i322); \
+}
+
+#define WALLY_FN_PBBB3_B(F, N) template <class P1, class I1, class I2, class I3, class O> inline int F(const P1 &p1, const I1 &i1, const I2 &i2, const I3 &i3, uint32_t i321, O & out) { \
+        return ::N(WALLYP(p1), WALLYB(i1), WALLYB(i2), WALLYB(i3), i321, WALLYO(out)); \
+}
+
+#define WALLY_FN_PP3B633_B(F, N) template <class P1, class P2, class I1, class O> inline int F(const P1 &p1, const P2 &p2, uint32_t i321, const I1 &i1, uint64_t i641, uint32_t i322, uint32_t i323, O & out) { \
+        return ::N(WALLYP(p1), WALLYP(p2), i321, WALLYB(i1), i641, i322, i323, WALLYO(out)); \
+}
+
 #define WALLY_FN_P3_A(F, N) template <class P1, class O> inline int F(const P1 &p1, uint32_t i321, O * *out) { \
         return ::N(WALLYP(p1), i321, out); \
 }
@@ -233,6 +270,11 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(WALLYP(p1), i641, WALLYB(i1), WALLYB(i2), i321, i322, WALLYO(out)); \
 }
 
+#define WALLY_FN_PP6BB33_B(F, N) template <class P1, class P2, class I1, class I2, class O> \
+    inline int F(const P1 &p1, const P2 &p2, uint64_t i641, const I1 &i1, const I2 &i2, uint32_t i321, uint32_t i322, O & out) { \
+        return ::N(WALLYP(p1), WALLYP(p2), i641, WALLYB(i1), WALLYB(i2), i321, i322, WALLYO(out)); \
+}
+
 #define WALLY_FN_P6BBBBBB3(F, N) template <class P1, class I1, class I2, class I3, class I4, class I5, class I6> \
     inline int F(const P1 &p1, uint64_t i641, const I1 &i1, const I2 &i2, const I3 &i3, const I4& i4, const I5 &i5, const I6 &i6, uint32_t i321) { \
         return ::N(WALLYP(p1), i641, WALLYB(i1), WALLYB(i2), WALLYB(i3), WALLYB(i4), WALLYB(i5), WALLYB(i6), i321); \
@@ -304,6 +346,10 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(WALLYP(p1), s1); \
 }
 
+#define WALLY_FN_PSS(F, N) template <class P1> inline int F(const P1 &p1, size_t s1, size_t s2) { \
+        return ::N(WALLYP(p1), s1, s2); \
+}
+
 #define WALLY_FN_PSB(F, N) template <class P1, class I1> inline int F(const P1 &p1, size_t s1, const I1 &i1) { \
         return ::N(WALLYP(p1), s1, WALLYB(i1)); \
 }
@@ -312,6 +358,10 @@ template <> inline auto get_p(const std::nullptr_t& p) {
         return ::N(WALLYP(p1), s1, WALLYP(p2)); \
 }
 
+#define WALLY_FN_PSSS_S(F, N) template <class P1> inline int F(const P1 &p1, size_t s1, size_t s2, size_t s3, size_t * written) { \
+        return ::N(WALLYP(p1), s1, s2, s3, written); \
+}
+
 #define WALLY_FN_PS_A(F, N) template <class P1, class O> inline int F(const P1 &p1, size_t s1, O * *out) { \
         return ::N(WALLYP(p1), s1, out); \
 }
@@ -340,6 +390,7 @@ template <> inline auto get_p(const std::nullptr_t& p) {
 
 WALLY_FN_3(init, wally_init)
 WALLY_FN_3(cleanup, wally_cleanup)
+WALLY_FN_3333_S(tx_input_get_weight_estimate, wally_tx_input_get_weight_estimate)
 WALLY_FN_333_BBBBBA(bip32_key_init_alloc, bip32_key_init_alloc)
 WALLY_FN_33SS_A(tx_init_alloc, wally_tx_init_alloc)
 WALLY_FN_3_A(tx_witness_stack_init_alloc, wally_tx_witness_stack_init_alloc)
@@ -355,28 +406,47 @@ WALLY_FN_B33_BS(scriptpubkey_csv_2of3_then_2_from_bytes, wally_scriptpubkey_csv_
 WALLY_FN_B33_BS(scriptpubkey_multisig_from_bytes, wally_scriptpubkey_multisig_from_bytes)
 WALLY_FN_B33_P(bip32_key_from_seed, bip32_key_from_seed)
 WALLY_FN_B3_A(base58_from_bytes, wally_base58_from_bytes)
+WALLY_FN_B3_A(base64_from_bytes, wally_base64_from_bytes)
+WALLY_FN_B3_A(psbt_view_from_bytes, wally_psbt_view_from_bytes)
 WALLY_FN_B3_A(tx_from_bytes, wally_tx_from_bytes)
+WALLY_FN_B3_A(tx_from_compact_bytes, wally_tx_from_compact_bytes)
+WALLY_FN_B3_B(ec_public_keys_convert, wally_ec_public_keys_convert)
+WALLY_FN_B3_B(ec_public_keys_from_private_keys, wally_ec_public_keys_from_private_keys)
+WALLY_FN_B3_B(tx_get_txid_from_bytes, wally_tx_get_txid_from_bytes)
+WALLY_FN_B3_B(tx_get_wtxid_from_bytes, wally_tx_get_wtxid_from_bytes)
 WALLY_FN_B3_BS(format_bitcoin_message, wally_format_bitcoin_message)
 WALLY_FN_B3_BS(script_push_from_bytes, wally_script_push_from_bytes)
 WALLY_FN_B3_BS(scriptpubkey_p2pkh_from_bytes, wally_scriptpubkey_p2pkh_from_bytes)
 WALLY_FN_B3_BS(scriptpubkey_p2sh_from_bytes, wally_scriptpubkey_p2sh_from_bytes)
+WALLY_FN_B3_BS(tx_get_output_script_types_from_bytes, wally_tx_get_output_script_types_from_bytes)
 WALLY_FN_B3_BS(witness_program_from_bytes, wally_witness_program_from_bytes)
 WALLY_FN_BB333_B(scrypt, wally_scrypt)
 WALLY_FN_BB3_A(bip38_from_private_key, bip38_from_private_key)
 WALLY_FN_BB3_B(aes, wally_aes)
 WALLY_FN_BB3_B(bip38_raw_from_private_key, bip38_raw_from_private_key)
 WALLY_FN_BB3_B(bip38_raw_to_private_key, bip38_raw_to_private_key)
+WALLY_FN_BB3_B(ec_public_keys_tweak_add, wally_ec_public_keys_tweak_add)
 WALLY_FN_BB3_B(ec_sig_from_bytes, wally_ec_sig_from_bytes)
+WALLY_FN_BB3_BS(ec_sig_from_bytes_batch, wally_ec_sig_from_bytes_batch)
 WALLY_FN_BB3_B(ec_sig_verify, wally_ec_sig_verify)
 WALLY_FN_BB3_BS(scriptsig_p2pkh_from_sig, wally_scriptsig_p2pkh_from_sig)
+WALLY_FN_BB3_BS(witness_p2wpkh_from_sig, wally_witness_p2wpkh_from_sig)
 WALLY_FN_BBB3_BS(aes_cbc, wally_aes_cbc)
 WALLY_FN_BBB3_BS(scriptsig_multisig_from_bytes, wally_scriptsig_multisig_from_bytes)
+WALLY_FN_BBB3_BS(scriptsig_multisig_from_der, wally_scriptsig_multisig_from_der)
+WALLY_FN_BB_B(ec_private_key_tweak_add, wally_ec_private_key_tweak_add)
+WALLY_FN_BB_B(ec_private_keys_tweak_add, wally_ec_private_keys_tweak_add)
+WALLY_FN_BB_B(ec_public_key_tweak_add, wally_ec_public_key_tweak_add)
+WALLY_FN_BB_B(ec_sig_to_public_key, wally_ec_sig_to_public_key)
+WALLY_FN_BB_B(ecdh, wally_ecdh)
 WALLY_FN_BB_B(hmac_sha256, wally_hmac_sha256)
 WALLY_FN_BB_B(hmac_sha512, wally_hmac_sha512)
 WALLY_FN_BP3_A(addr_segwit_from_bytes, wally_addr_segwit_from_bytes)
 WALLY_FN_BB_BS(scriptsig_p2pkh_from_der, wally_scriptsig_p2pkh_from_der)
 WALLY_FN_B_A(bip32_key_unserialize_alloc, bip32_key_unserialize_alloc)
 WALLY_FN_B_A(hex_from_bytes, wally_hex_from_bytes)
+WALLY_FN_B_B(block_get_hash, wally_block_get_hash)
+WALLY_FN_B_B(merkle_root, wally_merkle_root)
 WALLY_FN_B_B(ec_public_key_decompress, wally_ec_public_key_decompress)
 WALLY_FN_B_B(ec_public_key_from_private_key, wally_ec_public_key_from_private_key)
 WALLY_FN_B_B(ec_sig_from_der, wally_ec_sig_from_der)
@@ -386,16 +456,22 @@ WALLY_FN_B_B(sha256, wally_sha256)
 WALLY_FN_B_B(sha256d, wally_sha256d)
 WALLY_FN_B_B(sha512, wally_sha512)
 WALLY_FN_B_BS(ec_sig_to_der, wally_ec_sig_to_der)
+WALLY_FN_BS_BS(merkle_branch, wally_merkle_branch)
+WALLY_FN_BBSB(merkle_branch_verify, wally_merkle_branch_verify)
 WALLY_FN_B_P(bip32_key_unserialize, bip32_key_unserialize)
 WALLY_FN_B_S(scriptpubkey_get_type, wally_scriptpubkey_get_type)
 WALLY_FN_BB33_B(pbkdf2_hmac_sha256, wally_pbkdf2_hmac_sha256)
 WALLY_FN_BB33_B(pbkdf2_hmac_sha512, wally_pbkdf2_hmac_sha512)
 WALLY_FN_P(bip32_key_free, bip32_key_free)
 WALLY_FN_P(get_operations, wally_get_operations)
+WALLY_FN_P(psbt_view_free, wally_psbt_view_free)
+WALLY_FN_P(script_watchset_free, wally_script_watchset_free)
 WALLY_FN_P(set_operations, wally_set_operations)
 WALLY_FN_P(tx_free, wally_tx_free)
 WALLY_FN_P(tx_input_free, wally_tx_input_free)
 WALLY_FN_P(tx_output_free, wally_tx_output_free)
+WALLY_FN_P(tx_set_free, wally_tx_set_free)
+WALLY_FN_P(tx_sighash_ctx_free, wally_tx_sighash_ctx_free)
 WALLY_FN_P(tx_witness_stack_free, wally_tx_witness_stack_free)
 WALLY_FN_P3(tx_witness_stack_add_dummy, wally_tx_witness_stack_add_dummy)
 WALLY_FN_P3(tx_witness_stack_set_dummy, wally_tx_witness_stack_set_dummy)
@@ -403,17 +479,26 @@ WALLY_FN_P33_P(bip32_key_from_parent, bip32_key_from_parent)
 WALLY_FN_P3B(tx_witness_stack_set, wally_tx_witness_stack_set)
 WALLY_FN_P3B633_B(tx_get_btc_signature_hash, wally_tx_get_btc_signature_hash)
 WALLY_FN_P3BB36333_B(tx_get_signature_hash, wally_tx_get_signature_hash)
+WALLY_FN_PBBB3_B(tx_get_signature_hashes, wally_tx_get_signature_hashes)
+WALLY_FN_PBBB33(tx_sign_inputs, wally_tx_sign_inputs)
+WALLY_FN_PP3B633_B(tx_get_btc_signature_hash_ctx, wally_tx_get_btc_signature_hash_ctx)
 WALLY_FN_P3_A(bip32_key_to_base58, bip32_key_to_base58)
+WALLY_FN_P3_A(tx_clone, wally_tx_clone)
 WALLY_FN_P3_A(tx_from_hex, wally_tx_from_hex)
 WALLY_FN_P3_A(tx_to_hex, wally_tx_to_hex)
 WALLY_FN_P3_B(bip32_key_serialize, bip32_key_serialize)
 WALLY_FN_P3_B(wif_to_bytes, wally_wif_to_bytes)
 WALLY_FN_P3_BS(base58_to_bytes, wally_base58_to_bytes)
+WALLY_FN_P3_BS(base64_to_bytes, wally_base64_to_bytes)
 WALLY_FN_P3_BS(tx_to_bytes, wally_tx_to_bytes)
+WALLY_FN_P3_BS(tx_to_compact_bytes, wally_tx_to_compact_bytes)
 WALLY_FN_P3_BS(wif_to_public_key, wally_wif_to_public_key)
+WALLY_FN_P3_S(base64_get_maximum_length, wally_base64_get_maximum_length)
+WALLY_FN_P3_S(tx_get_compact_length, wally_tx_get_compact_length)
 WALLY_FN_P3_S(tx_get_length, wally_tx_get_length)
 WALLY_FN_P33_A(wif_to_address, wally_wif_to_address)
 WALLY_FN_P6B3(tx_add_raw_output, wally_tx_add_raw_output)
+WALLY_FN_PB(script_watchset_add, wally_script_watchset_add)
 WALLY_FN_PB(tx_witness_stack_add, wally_tx_witness_stack_add)
 WALLY_FN_PB33BP3(tx_add_raw_input, wally_tx_add_raw_input)
 WALLY_FN_PB3_A(bip32_key_from_parent_path_alloc, bip32_key_from_parent_path_alloc)
@@ -423,11 +508,17 @@ WALLY_FN_PB_A(bip39_mnemonic_from_bytes, bip39_mnemonic_from_bytes)
 WALLY_FN_PP(bip39_mnemonic_validate, bip39_mnemonic_validate)
 WALLY_FN_PP(tx_add_input, wally_tx_add_input)
 WALLY_FN_PP(tx_add_output, wally_tx_add_output)
+WALLY_FN_PP(tx_set_add, wally_tx_set_add)
 WALLY_FN_PP3_BS(addr_segwit_to_bytes, wally_addr_segwit_to_bytes)
 WALLY_FN_PP_BS(bip39_mnemonic_to_bytes, bip39_mnemonic_to_bytes)
 WALLY_FN_PP_BS(bip39_mnemonic_to_seed, bip39_mnemonic_to_seed)
 WALLY_FN_PS(tx_remove_input, wally_tx_remove_input)
 WALLY_FN_PS(tx_remove_output, wally_tx_remove_output)
+WALLY_FN_PB(tx_remove_inputs, wally_tx_remove_inputs)
+WALLY_FN_PB(tx_retain_outputs, wally_tx_retain_outputs)
+WALLY_FN_PS(tx_witness_stack_reserve, wally_tx_witness_stack_reserve)
+WALLY_FN_PSS(tx_reserve, wally_tx_reserve)
+WALLY_FN_PSSS_S(tx_get_weight_estimate, wally_tx_get_weight_estimate)
 WALLY_FN_PSB(tx_set_input_script, wally_tx_set_input_script)
 WALLY_FN_PSP(tx_set_input_witness, wally_tx_set_input_witness)
 WALLY_FN_PS_A(bip39_get_word, bip39_get_word)
@@ -435,7 +526,9 @@ WALLY_FN_P_A(bip32_key_from_base58_alloc, bip32_key_from_base58_alloc)
 WALLY_FN_P_A(bip39_get_languages, bip39_get_languages)
 WALLY_FN_P_A(bip39_get_wordlist, bip39_get_wordlist)
 WALLY_FN_P_BS(hex_to_bytes, wally_hex_to_bytes)
+WALLY_FN_P_BS(tx_get_output_script_types, wally_tx_get_output_script_types)
 WALLY_FN_P_S(base58_get_length, wally_base58_get_length)
+WALLY_FN_P_S(bip39_mnemonic_detect_languages, bip39_mnemonic_detect_languages)
 WALLY_FN_P_S(wif_is_uncompressed, wally_wif_is_uncompressed)
 WALLY_FN_P_S(tx_get_vsize, wally_tx_get_vsize)
 WALLY_FN_P_S(tx_get_weight, wally_tx_get_weight)
@@ -444,6 +537,86 @@ WALLY_FN_P_P(bip32_key_from_base58, bip32_key_from_base58)
 WALLY_FN_P_P(tx_get_total_output_satoshi, wally_tx_get_total_output_satoshi)
 WALLY_FN_S_S(tx_vsize_from_weight, wally_tx_vsize_from_weight)
 
+#ifdef WALLY_HAVE_PMR
+/* Allocate wally memory from a std::pmr::memory_resource chosen per thread.
+ * Call pmr_init() once, before any wally objects are allocated. Memory is
+ * then taken from the resource of the innermost memory_resource_scope on
+ * the allocating thread, or the default resource outside of any scope.
+ * Each allocation records its resource, so objects may be freed anywhere,
+ * but must not outlive the resource they were allocated from. Threads
+ * using scopes should bind a wally_thread_ctx created outside of any scope,
+ * so that scratch memory kept between calls is not shared between threads.
+ */
+namespace detail {
+struct alignas(std::max_align_t) pmr_header {
+    std::pmr::memory_resource *mr;
+    size_t size;
+};
+
+inline std::pmr::memory_resource *&pmr_current() {
+    static thread_local std::pmr::memory_resource *mr = nullptr;
+    return mr;
+}
+
+inline void *pmr_malloc(void *, size_t size) {
+    std::pmr::memory_resource *mr = pmr_current();
+    if (!mr)
+        mr = std::pmr::get_default_resource();
+    try {
+        void *p = mr->allocate(sizeof(pmr_header) + size, alignof(pmr_header));
+        pmr_header *h = static_cast<pmr_header *>(p);
+        h->mr = mr;
+        h->size = size;
+        return h + 1;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+inline void pmr_free(void *, void *p) {
+    if (p) {
+        pmr_header *h = static_cast<pmr_header *>(p) - 1;
+        h->mr->deallocate(h, sizeof(pmr_header) + h->size, alignof(pmr_header));
+    }
+}
+} /* namespace detail */
+
+inline int pmr_init() {
+    struct wally_operations ops;
+    int ret = ::wally_get_operations(&ops);
+    if (ret == WALLY_OK) {
+        ops.alloc_ctx = nullptr;
+        ops.malloc_ctx_fn = detail::pmr_malloc;
+        ops.free_ctx_fn = detail::pmr_free;
+        ops.realloc_ctx_fn = nullptr;
+        ret = ::wally_set_operations(&ops);
+    }
+    return ret;
+}
+
+class memory_resource_scope {
+public:
+    explicit memory_resource_scope(std::pmr::memory_resource *mr) noexcept
+        : m_prev(detail::pmr_current()) {
+        detail::pmr_current() = mr;
+    }
+    memory_resource_scope(const memory_resource_scope &) = delete;
+    memory_resource_scope &operator=(const memory_resource_scope &) = delete;
+    ~memory_resource_scope() {
+        /* Release any scratch memory kept from this scopes resource */
+        size_t limit;
+        if (::wally_get_scratch_limit(&limit) == WALLY_OK) {
+            ::wally_set_scratch_limit(0);
+            ::wally_set_scratch_limit(limit);
+        }
+        detail::pmr_current() = m_prev;
+    }
+
+private:
+    std::pmr::memory_resource *m_prev;
+};
+#endif /* WALLY_HAVE_PMR */
+
 inline struct secp256k1_context_struct *get_secp_context() {
     return ::wally_get_secp_context();
 }
@@ -467,6 +640,198 @@ inline bool is_elements_build()
     return ret != 0;
 }
 
+inline uint64_t get_cpu_features()
+{
+    uint64_t ret = 0;
+    ::wally_get_cpu_features(&ret);
+    return ret;
+}
+
+inline uint64_t get_init_duration()
+{
+    uint64_t ret = 0;
+    ::wally_get_init_duration(&ret);
+    return ret;
+}
+
+/* Owning, movable but non-copyable holders for objects allocated by wally.
+ * Pass out() to allocating functions, e.g. tx_from_hex(hex, 0, t.out()),
+ * and pass the holder itself wherever a pointer is expected.
+ */
+namespace detail {
+template <class T, class D> class owned_ptr {
+public:
+    owned_ptr() noexcept = default;
+    explicit owned_ptr(T *p) noexcept : m_p(p) {}
+    owned_ptr(const owned_ptr &) = delete;
+    owned_ptr &operator=(const owned_ptr &) = delete;
+    owned_ptr(owned_ptr &&other) noexcept : m_p(other.release()) {}
+    owned_ptr &operator=(owned_ptr &&other) noexcept {
+        reset(other.release());
+        return *this;
+    }
+    ~owned_ptr() { reset(); }
+
+    T *get() const noexcept { return m_p; }
+    T *operator->() const noexcept { return m_p; }
+    explicit operator bool() const noexcept { return m_p != nullptr; }
+
+    T *release() noexcept {
+        T *p = m_p;
+        m_p = nullptr;
+        return p;
+    }
+    void reset(T *p = nullptr) noexcept {
+        if (m_p != p) {
+            if (m_p)
+                D()(m_p);
+            m_p = p;
+        }
+    }
+    /* Free any held object and return a destination for a new one */
+    T **out() noexcept {
+        reset();
+        return &m_p;
+    }
+
+private:
+    T *m_p = nullptr;
+};
+
+struct tx_deleter {
+    void operator()(struct wally_tx *p) const noexcept { ::wally_tx_free(p); }
+};
+struct ext_key_deleter {
+    void operator()(struct ext_key *p) const noexcept { ::bip32_key_free(p); }
+};
+struct string_deleter {
+    void operator()(char *p) const noexcept { ::wally_free_string(p); }
+};
+} /* namespace detail */
+
+using tx = detail::owned_ptr<struct wally_tx, detail::tx_deleter>;
+using ext_key_ptr = detail::owned_ptr<struct ext_key, detail::ext_key_deleter>;
+
+class string : public detail::owned_ptr<char, detail::string_deleter> {
+public:
+    using owned_ptr::owned_ptr;
+
+    const char *c_str() const noexcept { return get() ? get() : ""; }
+    size_t size() const noexcept { return std::char_traits<char>::length(c_str()); }
+    bool empty() const noexcept { return !get() || !*get(); }
+    std::string str() const { return std::string(c_str()); }
+};
+
+/* Overloads returning fixed length results as std::array, so that no heap
+ * allocation is needed. Any contiguous view with data() and size() (e.g.
+ * std::span or gsl::span) may be passed as input; inputs whose length is
+ * known at compile time are checked at compile time. If ret is given it
+ * receives the wally return code, otherwise a failed call returns zeros.
+ */
+namespace detail {
+template <class C, class = void> struct static_len : std::integral_constant<size_t, 0> {};
+template <class C> struct static_len<C, decltype(void(std::tuple_size<C>::value))>
+    : std::integral_constant<size_t, std::tuple_size<C>::value> {};
+
+template <size_t N, class C> inline void check_len(const C &) {
+    static_assert(static_len<C>::value == 0 || static_len<C>::value == N,
+                  "input has the wrong length");
+}
+
+template <size_t N> inline std::array<unsigned char, N> result(int r, std::array<unsigned char, N> &out,
+                                                               int *ret) {
+    if (r != WALLY_OK)
+        ::wally_bzero(out.data(), N);
+    if (ret)
+        *ret = r;
+    return out;
+}
+} /* namespace detail */
+
+#define WALLY_FN_B_N(F, N, LEN) template <class I> inline std::array<unsigned char, LEN> F(const I &i1, int *ret = nullptr) { \
+        std::array<unsigned char, LEN> out; \
+        return detail::result(::N(WALLYB(i1), WALLYO(out)), out, ret); \
+}
+
+WALLY_FN_B_N(hash160, wally_hash160, HASH160_LEN)
+WALLY_FN_B_N(sha256, wally_sha256, SHA256_LEN)
+WALLY_FN_B_N(sha256d, wally_sha256d, SHA256_LEN)
+WALLY_FN_B_N(sha512, wally_sha512, SHA512_LEN)
+#undef WALLY_FN_B_N
+
+template <class I> inline std::array<unsigned char, EC_PUBLIC_KEY_LEN> ec_public_key_from_private_key(
+    const I &priv_key, int *ret = nullptr) {
+    std::array<unsigned char, EC_PUBLIC_KEY_LEN> out;
+    detail::check_len<EC_PRIVATE_KEY_LEN>(priv_key);
+    return detail::result(::wally_ec_public_key_from_private_key(WALLYB(priv_key), WALLYO(out)),
+                          out, ret);
+}
+
+template <class I1, class I2> inline std::array<unsigned char, EC_SIGNATURE_LEN> ec_sig_from_bytes(
+    const I1 &priv_key, const I2 &hash, uint32_t flags, int *ret = nullptr) {
+    std::array<unsigned char, EC_SIGNATURE_LEN> out;
+    detail::check_len<EC_PRIVATE_KEY_LEN>(priv_key);
+    detail::check_len<EC_MESSAGE_HASH_LEN>(hash);
+    return detail::result(::wally_ec_sig_from_bytes(WALLYB(priv_key), WALLYB(hash), flags, WALLYO(out)),
+                          out, ret);
+}
+
+template <class P1, class I1> inline std::array<unsigned char, SHA256_LEN> tx_get_btc_signature_hash(
+    const P1 &tx, uint32_t index, const I1 &script, uint64_t satoshi, uint32_t sighash,
+    uint32_t flags, int *ret = nullptr) {
+    std::array<unsigned char, SHA256_LEN> out;
+    return detail::result(::wally_tx_get_btc_signature_hash(WALLYP(tx), index, WALLYB(script), satoshi,
+                                                            sighash, flags, WALLYO(out)),
+                          out, ret);
+}
+
+/* Standard scriptPubKeys built from a hash at compile time where possible.
+ * The hash may be a std::array of the correct length or a pointer to at
+ * least that many bytes; no other validation is performed.
+ */
+namespace detail {
+template <size_t N, class H> constexpr bool is_hash() {
+    return std::is_pointer<H>::value || static_len<H>::value == N;
+}
+
+template <class H, size_t... I> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2PKH_LEN>
+p2pkh(const H &h, std::index_sequence<I...>) {
+    return {{ OP_DUP, OP_HASH160, HASH160_LEN, h[I]..., OP_EQUALVERIFY, OP_CHECKSIG }};
+}
+template <class H, size_t... I> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2SH_LEN>
+p2sh(const H &h, std::index_sequence<I...>) {
+    return {{ OP_HASH160, HASH160_LEN, h[I]..., OP_EQUAL }};
+}
+template <size_t N, class H, size_t... I> constexpr std::array<unsigned char, N + 2>
+witness_v0(const H &h, std::index_sequence<I...>) {
+    return {{ OP_0, N, h[I]... }};
+}
+} /* namespace detail */
+
+template <class H> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2PKH_LEN>
+scriptpubkey_p2pkh(const H &hash160) {
+    static_assert(detail::is_hash<HASH160_LEN, H>(), "p2pkh requires a hash160");
+    return detail::p2pkh(hash160, std::make_index_sequence<HASH160_LEN>{});
+}
+
+template <class H> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2SH_LEN>
+scriptpubkey_p2sh(const H &hash160) {
+    static_assert(detail::is_hash<HASH160_LEN, H>(), "p2sh requires a hash160");
+    return detail::p2sh(hash160, std::make_index_sequence<HASH160_LEN>{});
+}
+
+template <class H> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2WPKH_LEN>
+scriptpubkey_p2wpkh(const H &hash160) {
+    static_assert(detail::is_hash<HASH160_LEN, H>(), "p2wpkh requires a hash160");
+    return detail::witness_v0<HASH160_LEN>(hash160, std::make_index_sequence<HASH160_LEN>{});
+}
+
+template <class H> constexpr std::array<unsigned char, WALLY_SCRIPTPUBKEY_P2WSH_LEN>
+scriptpubkey_p2wsh(const H &sha256) {
+    static_assert(detail::is_hash<SHA256_LEN, H>(), "p2wsh requires a sha256");
+    return detail::witness_v0<SHA256_LEN>(sha256, std::make_index_sequence<SHA256_LEN>{});
+}
+
 #ifdef BUILD_ELEMENTS
 WALLY_FN_PBBBBBB(tx_elements_input_issuance_set, wally_tx_elements_input_issuance_set)
 WALLY_FN_P(tx_elements_input_issuance_free, wally_tx_elements_input_issuance_free)
@@ -479,6 +844,7 @@ WALLY_FN_P6BBBBBB3(tx_add_elements_raw_output, wally_tx_add_elements_raw_output)
 WALLY_FN_P_S(tx_is_elements, wally_tx_is_elements)
 WALLY_FN_6_B(tx_confidential_value_from_satoshi, wally_tx_confidential_value_from_satoshi)
 WALLY_FN_P6BB33_B(tx_get_elements_signature_hash, wally_tx_get_elements_signature_hash)
+WALLY_FN_PP6BB33_B(tx_get_elements_signature_hash_ctx, wally_tx_get_elements_signature_hash_ctx)
 WALLY_FN_B3B_B(tx_elements_issuance_generate_entropy, wally_tx_elements_issuance_generate_entropy)
 WALLY_FN_B_B(tx_elements_issuance_calculate_asset, wally_tx_elements_issuance_calculate_asset)
 WALLY_FN_B3_B(tx_elements_issuance_calculate_reissuance_token, wally_tx_elements_issuance_calculate_reissuance_token)
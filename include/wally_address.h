@@ -26,6 +26,83 @@ WALLY_CORE_API int wally_addr_segwit_from_bytes(
     uint32_t flags,
     char **output);
 
+#ifndef SWIG
+/**
+ * Create a segwit native address from a v0 witness program in a caller supplied buffer.
+ *
+ * :param bytes: Witness program bytes, including the version and data push opcode.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be 20 or 32 if script_version is 0.
+ * :param addr_family: Address family to generate, e.g. "bc" or "tb".
+ * :param flags: For future use. Must be 0.
+ * :param output: Destination for the resulting NUL terminated address string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_addr_segwit_from_bytes_to_buffer(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const char *addr_family,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create segwit native addresses from a batch of v0 witness programs.
+ *
+ * :param bytes: Witness program bytes, including the version and data push
+ *|    opcode, for each program stored contiguously.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each witness program in bytes.
+ * :param addr_family: Address family to generate, e.g. "bc" or "tb".
+ * :param flags: For future use. Must be 0.
+ * :param output: Destination for the resulting addresses. Each address is NUL
+ *|    terminated and immediately follows the previous one.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the total length of the addresses including
+ *|    their NUL terminators. If ``len`` is too small, ``written`` contains the
+ *|    buffer size required and the contents of ``output`` are undefined.
+ */
+WALLY_CORE_API int wally_addr_segwit_from_bytes_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    const char *addr_family,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Get the witness programs for a batch of segwit native addresses.
+ *
+ * :param str_in: The addresses to decode. Each address is NUL terminated and
+ *|    immediately follows the previous one, as produced by
+ *|    `wally_addr_segwit_from_bytes_batch`.
+ * :param str_in_len: The length of ``str_in`` in bytes, including the final NUL terminator.
+ * :param item_len: The length of each witness program in bytes. Any address
+ *|    whose witness program is not exactly this length is rejected.
+ * :param addr_family: Address family to accept, e.g. "bc" or "tb".
+ * :param flags: For future use. Must be 0.
+ * :param bytes_out: Destination for the resulting witness programs, stored contiguously.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the total length of the witness programs.
+ *|    If ``len`` is too small, ``bytes_out`` is left untouched and ``written``
+ *|    contains the buffer size required.
+ */
+WALLY_CORE_API int wally_addr_segwit_to_bytes_batch(
+    const char *str_in,
+    size_t str_in_len,
+    size_t item_len,
+    const char *addr_family,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Get a witness program from a segwit native address.
  *
@@ -61,6 +138,31 @@ WALLY_CORE_API int wally_wif_from_bytes(
     uint32_t flags,
     char **output);
 
+#ifndef SWIG
+/**
+ * Convert a private key to Wallet Import Format in a caller supplied buffer.
+ *
+ * :param priv_key: Private key bytes.
+ * :param priv_key_len: The length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param prefix: Prefix byte to use, e.g. 0x80, 0xef.
+ * :param flags: Pass ``WALLY_WIF_FLAG_COMPRESSED`` if the corresponding pubkey is compressed,
+ *|    otherwise ``WALLY_WIF_FLAG_UNCOMPRESSED``.
+ * :param output: Destination for the resulting NUL terminated Wallet Import Format string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_wif_from_bytes_to_buffer(
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    uint32_t prefix,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Convert a Wallet Import Format string to a private key.
  *
@@ -118,6 +220,108 @@ WALLY_CORE_API int wally_wif_to_address(
     uint32_t version,
     char **output);
 
+#ifndef SWIG
+/**
+ * Create a P2PKH address corresponding to a private key in Wallet Import Format
+ * in a caller supplied buffer.
+ *
+ * :param wif: Private key in Wallet Import Format.
+ * :param prefix: Prefix byte to use, e.g. 0x80, 0xef.
+ * :param version: Version byte to generate address, e.g. 0x00, 0x6f.
+ * :param output: Destination for the resulting NUL terminated address string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_wif_to_address_to_buffer(
+    const char *wif,
+    uint32_t prefix,
+    uint32_t version,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Decode a private key in Wallet Import Format along with its public key and P2PKH address.
+ *
+ * :param wif: Private key in Wallet Import Format.
+ * :param prefix: Prefix byte to use, e.g. 0x80, 0xef.
+ * :param version: Version byte to generate the address, e.g. 0x00, 0x6f.
+ * :param priv_key_out: Destination for the private key.
+ * :param priv_key_out_len: The length of ``priv_key_out`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param pub_key_out: Destination for the public key. A compressed public key
+ *|    is followed by zero padding.
+ * :param pub_key_out_len: The length of ``pub_key_out`` in bytes. Must be
+ *|    ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN``.
+ * :param flags_out: Destination for ``WALLY_WIF_FLAG_COMPRESSED`` or
+ *|    ``WALLY_WIF_FLAG_UNCOMPRESSED``.
+ * :param output: Destination for the resulting address string, or NULL if
+ *|    the address is not required.
+ *
+ * .. note:: The WIF string is decoded only once, unlike calling
+ *|    `wally_wif_to_bytes`, `wally_wif_to_public_key` and `wally_wif_to_address`
+ *|    in turn.
+ */
+WALLY_CORE_API int wally_wif_decode(
+    const char *wif,
+    uint32_t prefix,
+    uint32_t version,
+    unsigned char *priv_key_out,
+    size_t priv_key_out_len,
+    unsigned char *pub_key_out,
+    size_t pub_key_out_len,
+    uint32_t *flags_out,
+    char **output);
+
+/**
+ * Decode a batch of private keys in Wallet Import Format, as per `wally_wif_decode`.
+ *
+ * :param wifs: The private keys in Wallet Import Format to decode.
+ * :param num_wifs: The number of keys in ``wifs``.
+ * :param prefix: Prefix byte to use, e.g. 0x80, 0xef.
+ * :param version: Version byte to generate addresses, e.g. 0x00, 0x6f.
+ * :param run_fn: Function to run the decoding of each key as a separate
+ *|     task, for example on a thread pool. If NULL, keys are decoded in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param priv_keys_out: Destination for the private keys, one after another.
+ * :param priv_keys_out_len: Size of ``priv_keys_out`` in bytes. Must be
+ *|     ``EC_PRIVATE_KEY_LEN`` times ``num_wifs``.
+ * :param pub_keys_out: Destination for the public keys, one after another
+ *|     and each padded to ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` as per `wally_wif_decode`.
+ * :param pub_keys_out_len: Size of ``pub_keys_out`` in bytes. Must be
+ *|     ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` times ``num_wifs``.
+ * :param flags_out: Destination for the ``WALLY_WIF_FLAG_`` flags of each key.
+ * :param flags_out_len: The number of elements in ``flags_out``. Must be ``num_wifs``.
+ * :param output: Destination for the resulting addresses, or NULL if they
+ *|    are not required. Each address is NUL terminated and immediately
+ *|    follows the previous one.
+ * :param len: The length of ``output`` in bytes. Must be 0 if ``output`` is NULL.
+ * :param written: Destination for the total length of the addresses including
+ *|    their NUL terminators, or 0 if ``output`` is NULL. If ``len`` is too
+ *|    small, ``written`` contains the buffer size required and the contents
+ *|    of ``output`` are undefined.
+ *
+ * .. note:: If any key fails to decode, all outputs are cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_wif_decode_batch(
+    const char *const *wifs,
+    size_t num_wifs,
+    uint32_t prefix,
+    uint32_t version,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *priv_keys_out,
+    size_t priv_keys_out_len,
+    unsigned char *pub_keys_out,
+    size_t pub_keys_out_len,
+    uint32_t *flags_out,
+    size_t flags_out_len,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 #ifdef __cplusplus
 }
 #endif
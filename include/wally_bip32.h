@@ -57,6 +57,29 @@ struct ext_key {
 };
 #endif /* SWIG */
 
+#ifndef SWIG
+/** Fields to store in an `ext_key_pool` */
+#define BIP32_POOL_PUB_KEY   0x1 /** Store the public key of each key */
+#define BIP32_POOL_HASH160   0x2 /** Store the Hash160 of each public key */
+#define BIP32_POOL_CHILD_NUM 0x4 /** Store the child number of each key */
+
+/** A compact store of selected public fields from many extended keys */
+struct ext_key_pool {
+    /** The public keys, ``EC_PUBLIC_KEY_LEN`` bytes each, or NULL if not stored */
+    unsigned char *pub_keys;
+    /** The Hash160s of the public keys, ``HASH160_LEN`` bytes each, or NULL if not stored */
+    unsigned char *hash160s;
+    /** The child numbers of the keys, or NULL if not stored */
+    uint32_t *child_nums;
+    /** The number of keys stored */
+    size_t num_keys;
+    /** The maximum number of keys that can be stored */
+    size_t capacity;
+    /** The BIP32_POOL_ fields stored */
+    uint32_t fields;
+};
+#endif /* SWIG */
+
 #ifndef SWIG_PYTHON
 /**
  * Free a key allocated by `bip32_key_from_seed_alloc`
@@ -182,6 +205,27 @@ WALLY_CORE_API int bip32_key_from_parent(
     uint32_t child_num,
     uint32_t flags,
     struct ext_key *output);
+
+struct wally_ec_public_key;
+
+/**
+ * As per `bip32_key_from_parent`, using an already parsed parent public key.
+ *
+ * :param hdkey: The parent extended key.
+ * :param pub_key: The public key of ``hdkey``, from `wally_ec_public_key_init_alloc`.
+ * :param child_num: The child number to create.
+ * :param flags: BIP32_FLAG_KEY_ Flags indicating the type of derivation wanted.
+ * :param output: Destination for the resulting child extended key.
+ *
+ * .. note:: This avoids parsing the parent public key for each public
+ *|    derivation from the same parent.
+ */
+WALLY_CORE_API int bip32_key_from_parent_parsed(
+    const struct ext_key *hdkey,
+    const struct wally_ec_public_key *pub_key,
+    uint32_t child_num,
+    uint32_t flags,
+    struct ext_key *output);
 #endif
 
 /**
@@ -213,6 +257,232 @@ WALLY_CORE_API int bip32_key_from_parent_path(
     struct ext_key *output);
 #endif
 
+#ifndef SWIG
+/**
+ * Create a consecutive range of child extended keys from a parent extended key.
+ *
+ * :param hdkey: The parent extended key.
+ * :param child_num: The child number of the first key to create.
+ * :param flags: BIP32_FLAG_KEY_ Flags indicating the type of derivation wanted.
+ * :param output: Destination for the resulting child extended keys.
+ * :param output_len: The number of keys in ``output``. Keys are created for
+ *|    child numbers ``child_num`` to ``child_num + output_len - 1``.
+ *
+ * .. note:: The result is identical to calling `bip32_key_from_parent` for
+ *|    each child number, but the parent public key is parsed and the HMAC
+ *|    keyed on the parent chain code only once for the whole range, and the
+ *|    HMACs of several children are computed together. This makes it suitable
+ *|    for gap limit scanning. Pass ``BIP32_FLAG_SKIP_HASH`` to leave
+ *|    ``hash160`` and ``parent160`` of each child zeroed when they are not
+ *|    needed. If any child cannot be derived, all of ``output`` is cleared.
+ */
+WALLY_CORE_API int bip32_key_from_parent_range(
+    const struct ext_key *hdkey,
+    uint32_t child_num,
+    uint32_t flags,
+    struct ext_key *output,
+    size_t output_len);
+#endif
+
+#ifndef SWIG
+/** The maximum depth of path prefix stored by a `wally_bip32_path_cache` */
+#define BIP32_PATH_CACHE_MAX_DEPTH 8
+
+/** An opaque cache of intermediate keys for `bip32_key_from_parent_path_cached` */
+struct wally_bip32_path_cache;
+
+/**
+ * Create a cache of intermediate keys for repeated path derivation.
+ *
+ * :param max_entries: The maximum number of intermediate keys to cache.
+ *|    When full, the least recently used key is wiped and replaced.
+ * :param output: Destination for the resulting cache.
+ *
+ * .. note:: The cache holds private key material if private keys are
+ *|    derived through it, and is not thread safe. It should be freed with
+ *|    `bip32_path_cache_free`.
+ */
+WALLY_CORE_API int bip32_path_cache_init_alloc(
+    size_t max_entries,
+    struct wally_bip32_path_cache **output);
+
+/**
+ * As per `bip32_key_from_parent_path`, but caching the parent of the final key.
+ *
+ * :param cache: The cache from `bip32_path_cache_init_alloc`.
+ * :param hdkey: The parent extended key.
+ * :param child_path: The path of child numbers to create.
+ * :param child_path_len: The number of child numbers in ``child_path``.
+ * :param flags: BIP32_KEY_ Flags indicating the type of derivation wanted.
+ * :param output: Destination for the resulting child extended key.
+ *
+ * .. note:: Deriving paths that differ only in their final child number,
+ *|    for example ``m/84'/0'/0'/0/i`` for many ``i``, derives the shared
+ *|    prefix only once. The result is identical to `bip32_key_from_parent_path`.
+ *|    Paths longer than ``BIP32_PATH_CACHE_MAX_DEPTH + 1`` are not cached.
+ */
+WALLY_CORE_API int bip32_key_from_parent_path_cached(
+    struct wally_bip32_path_cache *cache,
+    const struct ext_key *hdkey,
+    const uint32_t *child_path,
+    size_t child_path_len,
+    uint32_t flags,
+    struct ext_key *output);
+
+/**
+ * Wipe all keys held in a cache.
+ *
+ * :param cache: The cache to flush.
+ */
+WALLY_CORE_API int bip32_path_cache_flush(
+    struct wally_bip32_path_cache *cache);
+
+/**
+ * Wipe and free a cache allocated by `bip32_path_cache_init_alloc`.
+ *
+ * :param cache: The cache to free.
+ */
+WALLY_CORE_API int bip32_path_cache_free(
+    struct wally_bip32_path_cache *cache);
+#endif /* SWIG */
+
+#ifndef SWIG
+/**
+ * Find the used receive and change addresses of an account.
+ *
+ * :param hdkey: The account extended key, e.g. for ``m/84'/0'/0'``.
+ * :param hashes: The known 20 byte hashes from the scriptPubKeys to find,
+ *|    concatenated in any order.
+ * :param hashes_len: The length of ``hashes`` in bytes. Must be a non-zero
+ *|    multiple of ``HASH160_LEN``.
+ * :param flags: The script types to match: ``WALLY_SCRIPT_TYPE_P2PKH`` and/or
+ *|    ``WALLY_SCRIPT_TYPE_P2WPKH`` match the hash160 of a child public key,
+ *|    ``WALLY_SCRIPT_TYPE_P2SH`` matches its p2sh-p2wpkh script hash.
+ * :param gap_limit: The number of unused children in a row after the last
+ *|    match at which to stop scanning each chain, e.g. 20.
+ * :param run_fn: The function used to run tasks, or NULL to run them in order
+ *|    on the calling thread.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param child_path_out: Destination for the matches found. Each match is
+ *|    written as two elements: the chain (0 for receive, 1 for change) and
+ *|    the child number, in order of chain and then child number.
+ * :param len: The number of elements in ``child_path_out``.
+ * :param written: Destination for the number of elements written to
+ *|    ``child_path_out``, i.e. twice the number of matches.
+ *
+ * .. note:: Children ``hdkey/0/i`` and ``hdkey/1/i`` are derived with
+ *|    `bip32_key_from_parent_range`, and the derivation and matching of
+ *|    each window of ``gap_limit`` children is split into tasks run by
+ *|    ``run_fn`` so that they can be run on several threads. Tasks run on
+ *|    other threads use that thread's context, not the callers.
+ *|    If ``len`` is too small, the required length is returned in ``written``.
+ */
+WALLY_CORE_API int bip32_key_discover(
+    const struct ext_key *hdkey,
+    const unsigned char *hashes,
+    size_t hashes_len,
+    uint32_t flags,
+    uint32_t gap_limit,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    uint32_t *child_path_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
+#ifndef SWIG
+/**
+ * Create the addresses of a consecutive range of children of an extended key.
+ *
+ * :param hdkey: The parent extended key, e.g. for ``m/84'/0'/0'/0``.
+ * :param child_num: The child number of the first address to create.
+ * :param num_addresses: The number of addresses to create.
+ * :param flags: The type of address to create: ``WALLY_SCRIPT_TYPE_P2PKH``,
+ *|    ``WALLY_SCRIPT_TYPE_P2SH`` for p2sh-p2wpkh or ``WALLY_SCRIPT_TYPE_P2WPKH``.
+ * :param version: The base 58 version byte for p2pkh or p2sh addresses, e.g.
+ *|    0x00 or 0x05 for mainnet. Must be 0 for p2wpkh.
+ * :param addr_family: Address family for p2wpkh addresses, e.g. "bc" or "tb".
+ *|    Must be NULL for p2pkh or p2sh.
+ * :param output: Destination for the resulting addresses. Each address is NUL
+ *|    terminated and immediately follows the previous one.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the total length of the addresses including
+ *|    their NUL terminators. If ``len`` is too small, ``written`` contains the
+ *|    buffer size required and the contents of ``output`` are undefined.
+ *
+ * .. note:: Children are derived with `bip32_key_from_parent_range` and the
+ *|    addresses are encoded with `wally_base58_from_bytes_batch` or
+ *|    `wally_addr_segwit_from_bytes_batch` in small batches on the stack,
+ *|    so no memory is allocated however many addresses are created.
+ */
+WALLY_CORE_API int bip32_key_to_addresses_range(
+    const struct ext_key *hdkey,
+    uint32_t child_num,
+    size_t num_addresses,
+    uint32_t flags,
+    uint32_t version,
+    const char *addr_family,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
+#ifndef SWIG
+/**
+ * Allocate a pool for storing selected fields of many extended keys.
+ *
+ * :param capacity: The maximum number of keys the pool can hold.
+ * :param fields: The BIP32_POOL_ fields to store for each key.
+ * :param output: Destination for the resulting empty pool.
+ *
+ * .. note:: Each field is stored in its own contiguous array, taking 57
+ *|    bytes per key for all fields rather than the size of an `ext_key`.
+ */
+WALLY_CORE_API int bip32_key_pool_init_alloc(
+    size_t capacity,
+    uint32_t fields,
+    struct ext_key_pool **output);
+
+/**
+ * Derive a consecutive range of public children and add them to a pool.
+ *
+ * :param pool: The pool to add the keys to.
+ * :param hdkey: The parent extended key.
+ * :param child_num: The child number of the first key to add.
+ * :param num_keys: The number of keys to add. The pool must have room for them.
+ * :param flags: For future use. Must be 0.
+ *
+ * .. note:: Children are derived as per `bip32_key_from_parent_range` with
+ *|    ``BIP32_FLAG_KEY_PUBLIC``, skipping Hash160 calculation when the pool
+ *|    does not store it. If any child cannot be derived, no keys are added.
+ */
+WALLY_CORE_API int bip32_key_pool_add_range(
+    struct ext_key_pool *pool,
+    const struct ext_key *hdkey,
+    uint32_t child_num,
+    size_t num_keys,
+    uint32_t flags);
+
+/**
+ * Get the number of bytes of memory used by a pool.
+ *
+ * :param pool: The pool to get the memory usage of.
+ * :param written: Destination for the number of bytes used, including
+ *|    room for keys up to the pool capacity.
+ */
+WALLY_CORE_API int bip32_key_pool_get_memory_usage(
+    const struct ext_key_pool *pool,
+    size_t *written);
+
+/**
+ * Free a pool allocated by `bip32_key_pool_init_alloc`.
+ *
+ * :param pool: The pool to free.
+ */
+WALLY_CORE_API int bip32_key_pool_free(
+    struct ext_key_pool *pool);
+#endif /* SWIG */
+
 /**
  * As per `bip32_key_from_parent_path`, but allocates the key.
  *
@@ -239,6 +509,58 @@ WALLY_CORE_API int bip32_key_to_base58(
     char **output);
 
 #ifndef SWIG
+/**
+ * Convert an extended key to base58 in a caller supplied buffer.
+ *
+ * :param hdkey: The extended key.
+ * :param flags: BIP32_FLAG_KEY_ Flags indicating which key to serialize. You can not
+ *|        serialize a private extended key from a public extended key.
+ * :param output: Destination for the resulting NUL terminated key in base58.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int bip32_key_to_base58_to_buffer(
+    const struct ext_key *hdkey,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Serialize a batch of extended keys and convert them to base58.
+ *
+ * :param hdkeys: The extended keys to convert.
+ * :param num_keys: The number of keys in ``hdkeys``.
+ * :param flags: BIP32_FLAG_KEY_ Flags indicating which key to serialize, as
+ *|    per `bip32_key_serialize`. Applies to every key.
+ * :param bytes_out: Destination for the serialized keys one after another,
+ *|    or NULL if they are not required.
+ * :param bytes_out_len: Size of ``bytes_out`` in bytes. Must be
+ *|    ``BIP32_SERIALIZED_LEN`` times ``num_keys``, or 0 if ``bytes_out`` is NULL.
+ * :param output: Destination for the resulting keys in base58. Each key is
+ *|    NUL terminated and immediately follows the previous one. As every
+ *|    key encodes to the same length, the strings have a fixed stride.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the total length of the strings including
+ *|    their NUL terminators. If ``len`` is too small, nothing is written
+ *|    and ``written`` contains the buffer size required.
+ *
+ * .. note:: The base58 checksums of several keys are computed together.
+ *|    If any key cannot be serialized, all outputs are cleared and an error
+ *|    is returned.
+ */
+WALLY_CORE_API int bip32_key_to_base58_batch(
+    const struct ext_key *hdkeys,
+    size_t num_keys,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t bytes_out_len,
+    char *output,
+    size_t len,
+    size_t *written);
+
 /**
  * Convert a base58 encoded extended key to an extended key.
  *
@@ -57,6 +57,32 @@ WALLY_CORE_API int bip38_from_private_key(
     uint32_t flags,
     char **output);
 
+#ifndef SWIG
+/**
+ * Encode a private key in BIP 38 address format in a caller supplied buffer.
+ *
+ * :param bytes: Private key to use.
+ * :param bytes_len: Size of ``bytes`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param pass: Password for the encoded private key.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param flags: BIP38_KEY_ flags indicating desired behavior.
+ * :param output: Destination for the resulting NUL terminated BIP38 address.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int bip38_from_private_key_to_buffer(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *pass,
+    size_t pass_len,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Decode a raw BIP 38 address to a private key.
  *
@@ -95,6 +121,65 @@ WALLY_CORE_API int bip38_to_private_key(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * Decode a batch of BIP 38 addresses to private keys.
+ *
+ * :param bip38: The BIP 38 addresses to decode.
+ * :param num_bip38: The number of addresses in ``bip38``.
+ * :param pass: Password for the encoded private keys.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param flags: BIP38_KEY_ flags indicating desired behavior.
+ * :param run_fn: Function to run the decoding of each address as a separate
+ *|     task, for example on a thread pool. If NULL, addresses are decoded in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the resulting private keys, one after another.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``
+ *|     times ``num_bip38``.
+ *
+ * .. note:: If any address fails to decode, all of ``bytes_out`` is cleared
+ *|    and an error is returned.
+ */
+WALLY_CORE_API int bip38_to_private_key_batch(
+    const char *const *bip38,
+    size_t num_bip38,
+    const unsigned char *pass,
+    size_t pass_len,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * As per `bip38_to_private_key`, but running asynchronously.
+ *
+ * :param bip38: BIP 38 address to decode. It is copied, as is ``pass``.
+ * :param pass: Password for the encoded private key.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param flags: BIP38_KEY_ flags indicating desired behavior.
+ * :param bytes_out: Destination for the resulting private key. It must
+ *|     remain valid until the operation completes.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param done_fn: Function to call with the result on completion, or NULL.
+ * :param done_ctx: Context passed to ``done_fn``.
+ * :param output: Destination for the resulting operation.
+ *|     The returned operation should be freed with `wally_async_free`.
+ *
+ * .. note:: See `wally_scrypt_async` for how the operation is run.
+ */
+WALLY_CORE_API int bip38_to_private_key_async(
+    const char *bip38,
+    const unsigned char *pass,
+    size_t pass_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    wally_async_done_t done_fn,
+    void *done_ctx,
+    struct wally_async **output);
+#endif /* SWIG */
+
 /**
  * Get compression and/or EC mult flags.
  *
@@ -24,6 +24,11 @@ struct words;
 /** The number of words in a BIP39 compliant wordlist */
 #define BIP39_WORDLIST_LEN 2048
 
+/** Recover a mnemonic where any one word may be wrong */
+#define BIP39_RECOVER_FLAG_REPLACE 0x1
+/** Recover a mnemonic with one word missing from an unknown position */
+#define BIP39_RECOVER_FLAG_INSERT 0x2
+
 /**
  * Get the list of default supported languages.
  *
@@ -32,6 +37,22 @@ struct words;
 WALLY_CORE_API int bip39_get_languages(
     char **output);
 
+#ifndef SWIG
+/**
+ * Get the list of default supported languages in a caller supplied buffer.
+ *
+ * :param output: Destination for the resulting NUL terminated list.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int bip39_get_languages_to_buffer(
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Get the default word list for a language.
  *
@@ -58,6 +79,26 @@ WALLY_CORE_API int bip39_get_word(
     size_t index,
     char **output);
 
+#ifndef SWIG
+/**
+ * Get the 'index'th word from a word list in a caller supplied buffer.
+ *
+ * :param w: Word list to use. Pass NULL to use the default English list.
+ * :param index: The 0-based index of the word in ``w``.
+ * :param output: Destination for the resulting NUL terminated word.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int bip39_get_word_to_buffer(
+    const struct words *w,
+    size_t index,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Generate a mnemonic sentence from the entropy in ``bytes``.
  *
@@ -74,6 +115,28 @@ WALLY_CORE_API int bip39_mnemonic_from_bytes(
     size_t bytes_len,
     char **output);
 
+#ifndef SWIG
+/**
+ * Generate a mnemonic sentence from the entropy in ``bytes`` in a caller supplied buffer.
+ *
+ * :param w: Word list to use. Pass NULL to use the default English list.
+ * :param bytes: Entropy to convert.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param output: Destination for the resulting NUL terminated mnemonic sentence.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator. If ``len`` is too small, ``output`` is left
+ *|    untouched and ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int bip39_mnemonic_from_bytes_to_buffer(
+    const struct words *w,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    char *output,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Convert a mnemonic sentence into entropy at ``bytes_out``.
  *
@@ -100,6 +163,22 @@ WALLY_CORE_API int bip39_mnemonic_validate(
     const struct words *w,
     const char *mnemonic);
 
+/**
+ * Determine which of the default word lists a mnemonic sentence is valid for.
+ *
+ * :param mnemonic: Mnemonic to check.
+ * :param written: Destination for a bitmask of the languages whose word
+ *|    list contains every word of ``mnemonic`` and whose checksum validates.
+ *|    Bit ``n`` corresponds to the ``n``th language returned by
+ *|    `bip39_get_languages`. Set to 0 if the mnemonic is not valid for any
+ *|    language.
+ *
+ * .. note:: The default word lists overlap, so more than one bit may be set.
+ */
+WALLY_CORE_API int bip39_mnemonic_detect_languages(
+    const char *mnemonic,
+    size_t *written);
+
 /**
  * Convert a mnemonic into a binary seed.
  *
@@ -117,6 +196,116 @@ WALLY_CORE_API int bip39_mnemonic_to_seed(
     size_t len,
     size_t *written);
 
+#ifndef SWIG
+/**
+ * Convert a batch of mnemonics into binary seeds.
+ *
+ * :param mnemonics: The mnemonics to convert.
+ * :param passphrases: The passphrase for each mnemonic, or NULL if no
+ *|      passphrases are needed. Individual entries may also be NULL.
+ * :param num_mnemonics: The number of entries in ``mnemonics``.
+ * :param bytes_out: The destination for the binary seeds, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. This must be
+ *|      ``BIP39_SEED_LEN_512`` times ``num_mnemonics``.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: The results are identical to calling `bip39_mnemonic_to_seed`
+ *|    for each mnemonic in turn. The key derivations run in lockstep so
+ *|    that they can share SIMD lanes, which improves throughput.
+ */
+WALLY_CORE_API int bip39_mnemonic_to_seed_batch(
+    const char *const *mnemonics,
+    const char *const *passphrases,
+    size_t num_mnemonics,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * As per `bip39_mnemonic_to_seed`, but running asynchronously.
+ *
+ * :param mnemonic: Mnemonic to convert. It is copied, as is ``passphrase``.
+ * :param passphrase: Mnemonic passphrase or NULL if no passphrase is needed.
+ * :param bytes_out: The destination for the binary seed. It must remain
+ *|      valid until the operation completes.
+ * :param len: The length of ``bytes_out`` in bytes. Currently This must
+ *|      be ``BIP39_SEED_LEN_512``.
+ * :param done_fn: Function to call with the result on completion, or NULL.
+ * :param done_ctx: Context passed to ``done_fn``.
+ * :param output: Destination for the resulting operation.
+ *|     The returned operation should be freed with `wally_async_free`.
+ *
+ * .. note:: See `wally_scrypt_async` for how the operation is run.
+ */
+WALLY_CORE_API int bip39_mnemonic_to_seed_async(
+    const char *mnemonic,
+    const char *passphrase,
+    unsigned char *bytes_out,
+    size_t len,
+    wally_async_done_t done_fn,
+    void *done_ctx,
+    struct wally_async **output);
+
+/**
+ * Find the corrections that make a mnemonic with one bad word valid.
+ *
+ * :param w: Word list to use. Pass NULL to use the default English list.
+ * :param mnemonic: The mnemonic to recover. A word that is not in ``w``,
+ *|    for example "?", marks the position of a wrong or missing word. All
+ *|    candidates for that position are tried.
+ * :param flags: ``BIP39_RECOVER_FLAG_REPLACE`` to try replacing each word
+ *|    in turn when no word is marked, ``BIP39_RECOVER_FLAG_INSERT`` to try
+ *|    inserting a word at each position, or 0 if a word is marked.
+ * :param passphrase: Mnemonic passphrase or NULL if no passphrase is needed.
+ *|    Must be NULL if ``hashes`` is NULL.
+ * :param child_path: The path from the master key to the key to match, or
+ *|    NULL to match the master key.
+ * :param child_path_len: The number of elements in ``child_path``.
+ * :param hashes: The known 20 byte hashes to match, concatenated in any
+ *|    order, e.g. from the scriptPubKey of the first receive address or the
+ *|    ``hash160`` of an account xpub. If NULL, every candidate with a valid
+ *|    checksum is returned without deriving any keys.
+ * :param hashes_len: The length of ``hashes`` in bytes. Must be a
+ *|    multiple of ``HASH160_LEN``.
+ * :param script_types: The scriptPubKey types to match, as for
+ *|    `bip32_key_discover`: ``WALLY_SCRIPT_TYPE_P2PKH`` and/or
+ *|    ``WALLY_SCRIPT_TYPE_P2WPKH`` match the hash160 of the key's public key,
+ *|    ``WALLY_SCRIPT_TYPE_P2SH`` matches its p2sh-p2wpkh script hash.
+ *|    Must be 0 if ``hashes`` is NULL.
+ * :param run_fn: The function used to run tasks, or NULL to run them in order
+ *|    on the calling thread.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param candidates_out: Destination for the corrections found, in order.
+ *|    Each is written as ``position * BIP39_WORDLIST_LEN + index``, where
+ *|    ``index`` is the index in ``w`` of the word at ``position`` in the
+ *|    recovered mnemonic. When inserting, the words from ``position`` on
+ *|    move up by one.
+ * :param len: The number of elements in ``candidates_out``.
+ * :param written: Destination for the number of corrections found.
+ *
+ * .. note:: Candidates are first filtered by checksum. This only packs
+ *|    each candidate's bits into the entropy and hashes it. The seeds of the
+ *|    remaining candidates are then derived in batches, in tasks run by
+ *|    ``run_fn`` so that they can run on several threads.
+ *|    If ``len`` is too small, the required length is returned in ``written``.
+ */
+WALLY_CORE_API int bip39_mnemonic_recover(
+    const struct words *w,
+    const char *mnemonic,
+    uint32_t flags,
+    const char *passphrase,
+    const uint32_t *child_path,
+    size_t child_path_len,
+    const unsigned char *hashes,
+    size_t hashes_len,
+    uint32_t script_types,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    uint32_t *candidates_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 #ifdef __cplusplus
 }
 #endif
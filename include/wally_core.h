@@ -28,16 +28,49 @@ extern "C" {
 #define WALLY_EINVAL -2 /** Invalid argument */
 #define WALLY_ENOMEM -3 /** malloc() failed */
 
+/** Create a libsecp256k1 context for signing only, without verification tables */
+#define WALLY_INIT_SIGN_ONLY   0x1
+/** Create a libsecp256k1 context for verification only, without signing tables */
+#define WALLY_INIT_VERIFY_ONLY 0x2
+/** Perform one-time initialization eagerly, see `wally_init` */
+#define WALLY_INIT_WARM_UP     0x4
+
 /**
  * Initialize wally.
  *
- * As wally is not currently threadsafe, this function should be called once
- * before threads are created by the application.
+ * This function should be called once before threads are created by the
+ * application. It selects any CPU-specific implementations and creates the
+ * shared libsecp256k1 context, which is otherwise created on first use.
+ * Creating the context is thread-safe, but callers wishing to randomize it
+ * should call `wally_secp_randomize` immediately after this function.
+ *
+ * :param flags: Flags controlling what to initialize. Either zero, or one of
+ *|    ``WALLY_INIT_SIGN_ONLY`` or ``WALLY_INIT_VERIFY_ONLY`` to reduce memory
+ *|    use by omitting the libsecp256k1 tables that are not needed. Either may
+ *|    be combined with ``WALLY_INIT_WARM_UP`` to run hashing, AES, signing,
+ *|    verification and BIP39 word lookups once, so that their tables are
+ *|    resident before the first real call. The time taken can be read with
+ *|    `wally_get_init_duration`.
  *
- * :param flags: Flags controlling what to initialize. Currently must be zero.
+ * .. note:: With a restricted context, the EC functions that need the
+ *|    omitted tables fail with ``WALLY_ERROR``: signing and deriving public
+ *|    keys from private keys require signing tables, while verifying
+ *|    signatures, recovering public keys from them and tweaking public keys
+ *|    require verification tables. BIP32 public derivation works with either.
+ *|    Calling this function with different flags replaces any existing
+ *|    context, and so must not be done while other threads are using wally.
  */
 WALLY_CORE_API int wally_init(uint32_t flags);
 
+/**
+ * Get the time taken by the last successful call to `wally_init`.
+ *
+ * :param value_out: Destination for the time in nanoseconds, including any
+ *|    warm-up requested with ``WALLY_INIT_WARM_UP``. This is 0 if no
+ *|    monotonic clock is available.
+ */
+WALLY_CORE_API int wally_get_init_duration(uint64_t *value_out);
+
 /**
  * Free any internally allocated memory.
  *
@@ -49,7 +82,9 @@ WALLY_CORE_API int wally_cleanup(uint32_t flags);
 /**
  * Fetch the wally internal secp256k1 context object.
  *
- * The context is created on demand.
+ * The context is created on demand. If a context has been bound to the
+ * calling thread with `wally_thread_ctx_set`, its secp256k1 context is
+ * returned instead.
  */
 struct secp256k1_context_struct *wally_get_secp_context(void);
 #endif
@@ -84,7 +119,7 @@ WALLY_CORE_API int wally_free_string(
  * The caller should call this function before using any functions that rely on
  * libsecp256k1 (i.e. Anything using public/private keys).
  *
- * As wally is not currently threadsafe, this function should either be
+ * Randomizing modifies the shared context, so this function should either be
  * called before threads are created or access to wally functions wrapped
  * in an application level mutex.
  *
@@ -95,6 +130,149 @@ WALLY_CORE_API int wally_secp_randomize(
     const unsigned char *bytes,
     size_t bytes_len);
 
+#ifndef SWIG
+/** An opaque per-thread context */
+struct wally_thread_ctx;
+
+/**
+ * Create a context for use by a single thread.
+ *
+ * Each context holds its own libsecp256k1 context, randomized with the
+ * given entropy. Once bound to a thread with `wally_thread_ctx_set`,
+ * functions called from that thread use it instead of the shared
+ * context. Threads with their own contexts can sign and derive keys in
+ * parallel without sharing blinding state or requiring a lock.
+ *
+ * :param bytes: Entropy to randomize the context with.
+ * :param bytes_len: Size of ``bytes`` in bytes. Must be ``WALLY_SECP_RANDOMIZE_LEN``.
+ * :param output: Destination for the resulting context.
+ *|    The returned context should be freed with `wally_thread_ctx_free`.
+ */
+WALLY_CORE_API int wally_thread_ctx_init_alloc(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    struct wally_thread_ctx **output);
+
+/**
+ * Bind a context to the calling thread.
+ *
+ * :param ctx: The context from `wally_thread_ctx_init_alloc`, or NULL to
+ *|    return the calling thread to using the shared context.
+ *
+ * .. note:: A context must only be bound to one thread at a time. Calling
+ *|    `wally_secp_randomize` from a thread with a bound context re-randomizes
+ *|    that context only. Returns ``WALLY_ERROR`` if the platform does not
+ *|    support thread-local storage.
+ */
+WALLY_CORE_API int wally_thread_ctx_set(
+    struct wally_thread_ctx *ctx);
+
+/**
+ * Free a context allocated by `wally_thread_ctx_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ *
+ * .. note:: The context is unbound if it is bound to the calling thread. It
+ *|    must not be bound to any other thread when freed.
+ */
+WALLY_CORE_API int wally_thread_ctx_free(
+    struct wally_thread_ctx *ctx);
+
+/** The default for `wally_set_scratch_limit` */
+#define WALLY_SCRATCH_LIMIT_DEFAULT 65536
+
+/**
+ * Set the largest scratch buffer kept for reuse by batched calls.
+ *
+ * Batched calls such as `wally_asset_surjectionproof_batch` and
+ * `wally_asset_rangeproof_verify_tx` need working memory proportional to
+ * the batch size. The shared context and each thread context keep the
+ * last such buffer, cleared after use, so that repeated batches do not
+ * allocate. Larger buffers are freed after each call.
+ *
+ * :param limit: The maximum buffer size in bytes to keep, or 0 to
+ *|    never keep a buffer.
+ */
+WALLY_CORE_API int wally_set_scratch_limit(
+    size_t limit);
+
+/**
+ * Get the largest scratch buffer kept for reuse by batched calls.
+ *
+ * :param written: Destination for the limit in bytes.
+ */
+WALLY_CORE_API int wally_get_scratch_limit(
+    size_t *written);
+
+/* Flags for `wally_secret_arena_init` */
+#define WALLY_SECRET_ARENA_LOCK 0x1 /** Lock the arena in memory so it cannot be swapped out */
+#define WALLY_SECRET_ARENA_GUARD 0x2 /** Surround the arena with inaccessible guard pages */
+
+/**
+ * Create an arena that secret temporaries are allocated from.
+ *
+ * The working memory of scrypt, PBKDF2 and the asynchronous key derivation
+ * functions is taken from the arena while it has room, and from the
+ * heap otherwise. Arena memory is excluded from core dumps where the
+ * platform allows. Buffers are cleared as they are freed; arena memory
+ * is reused once its last live allocation is freed.
+ *
+ * :param len: The size of the arena in bytes, rounded up to a whole
+ *|    number of pages. At most 4GB.
+ * :param flags: ``WALLY_SECRET_ARENA_`` flags.
+ *
+ * .. note:: Returns ``WALLY_ERROR`` if an arena already exists, if locking
+ *|    or guarding the memory fails (for example because of ``RLIMIT_MEMLOCK``),
+ *|    or if the platform does not support ``mmap``.
+ */
+WALLY_CORE_API int wally_secret_arena_init(
+    size_t len,
+    uint32_t flags);
+
+/**
+ * Free the arena created by `wally_secret_arena_init`.
+ *
+ * :param flags: Flags controlling freeing. Currently must be zero.
+ *
+ * .. note:: Returns ``WALLY_ERROR`` without freeing the arena if memory
+ *|    allocated from it is in use, for example by a running asynchronous
+ *|    operation. Returns ``WALLY_OK`` if there is no arena.
+ */
+WALLY_CORE_API int wally_secret_arena_free(uint32_t flags);
+
+/* Input size limits for `wally_set_input_limit` */
+#define WALLY_LIMIT_TX_LEN 0 /** Serialized transaction length in bytes */
+#define WALLY_LIMIT_TX_WITNESS_ITEMS 1 /** Witness stack items for each transaction input */
+#define WALLY_LIMIT_BASE58_LEN 2 /** Base58 string length */
+#define WALLY_LIMIT_MNEMONIC_LEN 3 /** Mnemonic string length */
+#define WALLY_NUM_LIMITS 4
+
+/**
+ * Set a limit on the size of input accepted by parsers.
+ *
+ * Callers handling untrusted data can use limits to cap the work done
+ * on malicious input, such as very long base58 strings, which take time
+ * quadratic in their length to decode. Inputs over a limit are rejected
+ * with WALLY_EINVAL before being decoded. By default no limits are set.
+ *
+ * :param limit: The limit to set, ``WALLY_LIMIT_``.
+ * :param value: The largest input size to accept, or 0 for no limit.
+ */
+WALLY_CORE_API int wally_set_input_limit(
+    uint32_t limit,
+    size_t value);
+
+/**
+ * Get a limit on the size of input accepted by parsers.
+ *
+ * :param limit: The limit to return, ``WALLY_LIMIT_``.
+ * :param written: Destination for the limit, or 0 if no limit is set.
+ */
+WALLY_CORE_API int wally_get_input_limit(
+    uint32_t limit,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Convert bytes to a (lower-case) hexadecimal string.
  *
@@ -188,6 +366,195 @@ WALLY_CORE_API int wally_base58_get_length(
     const char *str_in,
     size_t *written);
 
+/**
+ * Create a base 64 encoded string representing binary data.
+ *
+ * :param bytes: Binary data to convert.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param flags: Must be 0.
+ * :param output: Destination for the padded base 64 encoded string representing ``bytes``.
+ *|    The string returned should be freed using `wally_free_string`.
+ */
+WALLY_CORE_API int wally_base64_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    char **output);
+
+/**
+ * Decode a base 64 encoded string back into into binary data.
+ *
+ * :param str_in: Padded base 64 encoded string to decode.
+ * :param flags: Must be 0.
+ * :param bytes_out: Destination for converted binary data.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the decoded bytes.
+ *
+ * .. note:: Only canonical encodings are accepted: whitespace, missing
+ *|    padding and non-zero unused bits are rejected.
+ */
+WALLY_CORE_API int wally_base64_to_bytes(
+    const char *str_in,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Return the maximum length of a base 64 encoded string once decoded into bytes.
+ *
+ * The string is not validated, and the length returned may be up to 2
+ * bytes larger than the decoded data.
+ *
+ * :param str_in: Base 64 encoded string to find the length of.
+ * :param flags: Must be 0.
+ * :param written: Destination for the maximum length of the decoded bytes.
+ */
+WALLY_CORE_API int wally_base64_get_maximum_length(
+    const char *str_in,
+    uint32_t flags,
+    size_t *written);
+
+#ifndef SWIG
+/**
+ * Convert bytes to a (lower-case) hexadecimal string in a caller supplied buffer.
+ *
+ * :param bytes: Bytes to convert.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param output: Destination for the resulting NUL terminated hexadecimal string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator.
+ *
+ * .. note:: If ``len`` is too small, ``output`` is left untouched and
+ *|    ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_hex_from_bytes_to_buffer(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create a base 58 encoded string in a caller supplied buffer.
+ *
+ * :param bytes: Binary data to convert.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param flags: Pass ``BASE58_FLAG_CHECKSUM`` if ``bytes`` should have a
+ *|    checksum calculated and appended before converting to base 58.
+ * :param output: Destination for the resulting NUL terminated base 58 string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator.
+ *
+ * .. note:: If ``len`` is too small, ``output`` is left untouched and
+ *|    ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_base58_from_bytes_to_buffer(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Base 58 encode a batch of fixed length payloads into a caller supplied buffer.
+ *
+ * :param bytes: The payloads to convert, stored contiguously.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each payload in bytes.
+ * :param flags: Pass ``BASE58_FLAG_CHECKSUM`` if each payload should have a
+ *|    checksum calculated and appended before converting to base 58.
+ * :param output: Destination for the resulting strings. Each string is NUL
+ *|    terminated and immediately follows the previous one.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the total length of the strings including
+ *|    their NUL terminators.
+ *
+ * .. note:: If ``len`` is too small, ``written`` contains the buffer size
+ *|    required and the contents of ``output`` are undefined.
+ */
+WALLY_CORE_API int wally_base58_from_bytes_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Decode a batch of base 58 encoded strings into fixed length payloads.
+ *
+ * :param str_in: The strings to decode. Each string is NUL terminated and
+ *|    immediately follows the previous one, as produced by `wally_base58_from_bytes_batch`.
+ * :param str_in_len: The length of ``str_in`` in bytes, including the final NUL terminator.
+ * :param item_len: The decoded length of each payload, excluding any checksum.
+ *|    Any string that does not decode to exactly this length is rejected.
+ * :param flags: Pass ``BASE58_FLAG_CHECKSUM`` if each string has an embedded
+ *|    checksum that should be validated and removed.
+ * :param bytes_out: Destination for the decoded payloads, stored contiguously.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the total length of the decoded payloads.
+ *
+ * .. note:: If ``len`` is too small, ``bytes_out`` is left untouched and
+ *|    ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_base58_to_bytes_batch(
+    const char *str_in,
+    size_t str_in_len,
+    size_t item_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create a base 64 encoded string in a caller supplied buffer.
+ *
+ * :param bytes: Binary data to convert.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param flags: Must be 0.
+ * :param output: Destination for the resulting NUL terminated base 64 string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator.
+ *
+ * .. note:: If ``len`` is too small, ``output`` is left untouched and
+ *|    ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_base64_from_bytes_to_buffer(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Decode a base 64 encoded string of known length, which need not be NUL
+ * terminated, into binary data.
+ *
+ * :param str_in: Padded base 64 encoded string to decode.
+ * :param str_len: The length of ``str_in`` in bytes.
+ * :param flags: Must be 0.
+ * :param bytes_out: Destination for converted binary data.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the decoded bytes.
+ *
+ * .. note:: As for `wally_base64_to_bytes`, only canonical encodings are accepted.
+ */
+WALLY_CORE_API int wally_base64_n_to_bytes(
+    const char *str_in,
+    size_t str_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 
 #ifndef SWIG
 /** The type of an overridable function to allocate memory */
@@ -198,6 +565,27 @@ typedef void *(*wally_malloc_t)(
 typedef void (*wally_free_t)(
     void *ptr);
 
+/** The type of an overridable function to resize allocated memory */
+typedef void *(*wally_realloc_t)(
+    void *ptr,
+    size_t size);
+
+/** The type of an overridable function to allocate memory from a caller context */
+typedef void *(*wally_malloc_ctx_t)(
+    void *alloc_ctx,
+    size_t size);
+
+/** The type of an overridable function to free memory from a caller context */
+typedef void (*wally_free_ctx_t)(
+    void *alloc_ctx,
+    void *ptr);
+
+/** The type of an overridable function to resize memory from a caller context */
+typedef void *(*wally_realloc_ctx_t)(
+    void *alloc_ctx,
+    void *ptr,
+    size_t size);
+
 /** The type of an overridable function to clear memory */
 typedef void (*wally_bzero_t)(
     void *ptr, size_t len);
@@ -212,12 +600,85 @@ typedef int (*wally_ec_nonce_t)(
     unsigned int attempt
     );
 
+/** The type of an overridable function to generate an EC nonce from a caller context */
+typedef int (*wally_ec_nonce_ctx_t)(
+    void *nonce_ctx,
+    unsigned char *nonce32,
+    const unsigned char *msg32,
+    const unsigned char *key32,
+    const unsigned char *algo16,
+    void *data,
+    unsigned int attempt
+    );
+
+/** The type of a task to be run by a `wally_run_tasks_t` function */
+typedef void (*wally_task_t)(
+    void *task_ctx,
+    size_t index);
+
+/**
+ * The type of a caller supplied function to run independent tasks.
+ *
+ * The function must call ``task_fn(task_ctx, i)`` once for each ``i`` from
+ * 0 to ``num_tasks - 1``, in any order and possibly concurrently, and
+ * return only once every call has completed.
+ *
+ * Batch functions that are passed a NULL ``run_fn`` use the
+ * ``run_tasks_fn`` operation if one is set (see `wally_set_operations`),
+ * and otherwise run their tasks in turn on the calling thread.
+ */
+typedef void (*wally_run_tasks_t)(
+    void *run_ctx,
+    size_t num_tasks,
+    wally_task_t task_fn,
+    void *task_ctx);
+
+/**
+ * The type of a caller supplied function to run a task in the background.
+ *
+ * The function must arrange for ``task_fn(task_ctx, 0)`` to be called
+ * exactly once, for example on an executor thread, and return ``WALLY_OK``.
+ * If it cannot, it must not call ``task_fn`` and must return an error.
+ */
+typedef int (*wally_submit_t)(
+    void *submit_ctx,
+    wally_task_t task_fn,
+    void *task_ctx);
+
 /** Structure holding function pointers for overridable wally operations */
 struct wally_operations {
     wally_malloc_t malloc_fn;
     wally_free_t free_fn;
     wally_bzero_t bzero_fn;
     wally_ec_nonce_t ec_nonce_fn;
+    /** Resizes memory from ``malloc_fn``. If NULL, growing arrays of
+     *  non-secret data allocates, copies and frees instead. The default is
+     *  only kept while the default ``malloc_fn`` and ``free_fn`` are used */
+    wally_realloc_t realloc_fn;
+    /** The context passed to the ``_ctx_fn`` allocation functions */
+    void *alloc_ctx;
+    /** If non-NULL, used with ``alloc_ctx`` instead of ``malloc_fn`` */
+    wally_malloc_ctx_t malloc_ctx_fn;
+    /** Must be non-NULL if and only if ``malloc_ctx_fn`` is */
+    wally_free_ctx_t free_ctx_fn;
+    /** Optional, used with ``alloc_ctx`` instead of ``realloc_fn`` */
+    wally_realloc_ctx_t realloc_ctx_fn;
+    /** The context passed to ``ec_nonce_ctx_fn`` */
+    void *ec_nonce_ctx;
+    /** If non-NULL, used with ``ec_nonce_ctx`` instead of ``ec_nonce_fn`` */
+    wally_ec_nonce_ctx_t ec_nonce_ctx_fn;
+    /** The context passed to ``run_tasks_fn`` */
+    void *run_tasks_ctx;
+    /** If non-NULL, runs the tasks of batch functions that are passed no
+     *  ``run_fn`` of their own, for example `wally_thread_pool_run` with a
+     *  pool as ``run_tasks_ctx``. If NULL, such tasks run serially */
+    wally_run_tasks_t run_tasks_fn;
+    /** The context passed to ``submit_fn`` */
+    void *submit_ctx;
+    /** If non-NULL, runs asynchronous operations such as `wally_scrypt_async`
+     *  in the background. If NULL, they run to completion on the calling
+     *  thread before returning */
+    wally_submit_t submit_fn;
 };
 
 /**
@@ -232,10 +693,124 @@ WALLY_CORE_API int wally_get_operations(
  * Set the current overridable operations used by wally.
  *
  * :param ops: The overridable operations to set.
+ *
+ * .. note:: Any of ``malloc_fn``, ``free_fn``, ``bzero_fn`` and
+ *|    ``ec_nonce_fn`` that are NULL are left unchanged. The remaining members
+ *|    are always set, so NULL restores their default behaviour. Callers
+ *|    should pass a structure filled by `wally_get_operations` and then
+ *|    modified. Memory must be freed by the functions that allocated it, so
+ *|    allocation functions should only be changed when no wally objects
+ *|    allocated by the previous functions remain.
  */
 WALLY_CORE_API int wally_set_operations(
     const struct wally_operations *ops);
 
+/** The maximum number of worker threads in a `wally_thread_pool` */
+#define WALLY_THREAD_POOL_MAX_THREADS 256
+
+/** An opaque pool of worker threads for running batch tasks */
+struct wally_thread_pool;
+
+/**
+ * Create a pool of worker threads for running batch tasks.
+ *
+ * Wally never creates threads itself. Callers that want batch functions
+ * to run in parallel can create a pool and pass `wally_thread_pool_run`
+ * with it as the ``run_fn`` and ``run_ctx`` of a batch call, or set them
+ * as the ``run_tasks_fn`` and ``run_tasks_ctx`` operations to use it for
+ * every batch call.
+ *
+ * :param num_threads: The number of worker threads to create, at most
+ *|    ``WALLY_THREAD_POOL_MAX_THREADS``. The thread running the tasks
+ *|    also runs them, so 0 runs every task on the calling thread.
+ * :param output: Destination for the resulting pool.
+ *|    The returned pool should be freed with `wally_thread_pool_free`.
+ *
+ * .. note:: Returns ``WALLY_ERROR`` if the library was built without
+ *|    pthread support.
+ */
+WALLY_CORE_API int wally_thread_pool_init_alloc(
+    size_t num_threads,
+    struct wally_thread_pool **output);
+
+/**
+ * Run tasks on a thread pool, returning once they have all completed.
+ *
+ * This function is a `wally_run_tasks_t`. Only one set of tasks runs on
+ * a pool at a time: if the pool is busy, for example when a task itself
+ * runs tasks, the tasks are run on the calling thread instead.
+ *
+ * :param run_ctx: The pool from `wally_thread_pool_init_alloc`.
+ * :param num_tasks: The number of tasks to run.
+ * :param task_fn: The function to call with each task index.
+ * :param task_ctx: The context to pass to ``task_fn``.
+ */
+WALLY_CORE_API void wally_thread_pool_run(
+    void *run_ctx,
+    size_t num_tasks,
+    wally_task_t task_fn,
+    void *task_ctx);
+
+/**
+ * Stop the worker threads of a pool and free it.
+ *
+ * :param pool: The pool to free. It must not be running tasks.
+ */
+WALLY_CORE_API int wally_thread_pool_free(
+    struct wally_thread_pool *pool);
+
+/** An opaque asynchronous operation */
+struct wally_async;
+
+/**
+ * The type of a function called when an asynchronous operation completes.
+ *
+ * :param done_ctx: The context given when the operation was started.
+ * :param ret: The result of the operation. ``WALLY_ERROR`` if it was cancelled.
+ *
+ * .. note:: This is called on the thread that ran the operation, exactly
+ *|    once for each operation that was started successfully.
+ */
+typedef void (*wally_async_done_t)(
+    void *done_ctx,
+    int ret);
+
+/**
+ * Check whether an asynchronous operation has completed.
+ *
+ * :param op: The operation to check.
+ * :param written: Destination for 1 if ``op`` has completed, otherwise 0.
+ *
+ * .. note:: Returns the result of the operation once it has completed,
+ *|    and ``WALLY_OK`` while it is still running.
+ */
+WALLY_CORE_API int wally_async_poll(
+    const struct wally_async *op,
+    size_t *written);
+
+/**
+ * Request that an asynchronous operation stop.
+ *
+ * :param op: The operation to cancel.
+ *
+ * .. note:: Cancellation is cooperative: the operation stops at its next
+ *|    cancellation check and completes with ``WALLY_ERROR``, clearing its
+ *|    output. Cancelling a completed operation has no effect.
+ */
+WALLY_CORE_API int wally_async_cancel(
+    struct wally_async *op);
+
+/**
+ * Free an asynchronous operation, cancelling it if it has not completed.
+ *
+ * :param op: The operation to free.
+ *
+ * .. note:: The completion function is still called if the operation was
+ *|    running, and its output buffer must remain valid until then.
+ */
+WALLY_CORE_API int wally_async_free(
+    struct wally_async *op);
+
 #endif /* SWIG */
 
 /**
@@ -245,6 +820,82 @@ WALLY_CORE_API int wally_set_operations(
  */
 WALLY_CORE_API int wally_is_elements_build(uint64_t *value_out);
 
+/* CPU specific implementations, selected by wally_init */
+#define WALLY_CPU_SHA256_SSE4 0x1 /** SSE4.1 SHA-256 compression */
+#define WALLY_CPU_SHA256_SHANI 0x2 /** x86 SHA extensions SHA-256 compression */
+#define WALLY_CPU_SHA256_AVX2 0x4 /** AVX2 8-way SHA-256 batch hashing */
+#define WALLY_CPU_SHA256_ARMV8 0x8 /** ARMv8 SHA-256 compression */
+#define WALLY_CPU_SHA512_AVX2 0x10 /** AVX2 4-way SHA-512 batch hashing */
+#define WALLY_CPU_SHA512_ARMV8 0x20 /** ARMv8.2 SHA-512 compression */
+#define WALLY_CPU_AES_NI 0x40 /** x86 AES-NI encryption and decryption */
+#define WALLY_CPU_AES_ARMV8 0x80 /** ARMv8 AES encryption and decryption */
+#define WALLY_CPU_HEX_SSSE3 0x100 /** SSSE3 hex encoding and decoding */
+#define WALLY_CPU_SCRYPT_SSE2 0x200 /** SSE2 scrypt smix */
+#define WALLY_CPU_SCRYPT_NEON 0x400 /** NEON scrypt smix */
+#define WALLY_CPU_SCRYPT_AVX2 0x800 /** AVX2 multi-lane scrypt smix */
+#define WALLY_CPU_SCRYPT_AVX512 0x1000 /** AVX-512 multi-lane scrypt smix */
+#define WALLY_CPU_SHA512_SSSE3 0x2000 /** SSSE3 SHA-512 compression */
+#define WALLY_CPU_SHA512_AVX2_BMI2 0x4000 /** AVX2 and BMI2 SHA-512 compression */
+#define WALLY_CPU_RIPEMD160_AVX2 0x8000 /** AVX2 8-way RIPEMD-160 batch hashing */
+#define WALLY_CPU_BASE64_AVX2 0x10000 /** AVX2 base 64 encoding and decoding */
+#define WALLY_CPU_BASE64_NEON 0x20000 /** NEON base 64 encoding and decoding */
+#define WALLY_CPU_SHA256_SIMD128 0x40000 /** WebAssembly SIMD128 4-way SHA-256 batch hashing */
+#define WALLY_CPU_HEX_SIMD128 0x80000 /** WebAssembly SIMD128 hex encoding and decoding */
+
+/**
+ * Get the CPU specific implementations in use.
+ *
+ * :param value_out: Destination for the ``WALLY_CPU_`` flags of the
+ *|    implementations selected for the current CPU by `wally_init`.
+ *
+ * .. note:: Until `wally_init` is called only implementations chosen at
+ *|    compile time are used, and 0 is returned.
+ */
+WALLY_CORE_API int wally_get_cpu_features(uint64_t *value_out);
+
+/* Library statistics counters, available when built with --enable-stats */
+#define WALLY_STAT_ALLOCS 0 /** Number of allocations */
+#define WALLY_STAT_ALLOC_BYTES 1 /** Total bytes allocated */
+#define WALLY_STAT_SHA256_BLOCKS 2 /** SHA-256 block compressions */
+#define WALLY_STAT_SHA512_BLOCKS 3 /** SHA-512 block compressions */
+#define WALLY_STAT_EC_MULTS 4 /** Public key point multiplications */
+#define WALLY_STAT_EC_SIGNS 5 /** ECDSA signing operations */
+#define WALLY_STAT_EC_SIGN_NS 6 /** Nanoseconds spent signing */
+#define WALLY_STAT_EC_VERIFIES 7 /** ECDSA verifications */
+#define WALLY_STAT_EC_VERIFY_NS 8 /** Nanoseconds spent verifying */
+#define WALLY_STAT_TX_PARSES 9 /** Transactions parsed */
+#define WALLY_STAT_TX_PARSE_NS 10 /** Nanoseconds spent parsing transactions */
+#define WALLY_STAT_SIGHASHES 11 /** Signature hashes computed */
+#define WALLY_STAT_SIGHASH_NS 12 /** Nanoseconds spent computing signature hashes */
+#define WALLY_STAT_TX_ALLOC_BYTES 13 /** Bytes allocated for transactions */
+#define WALLY_STAT_SCRIPT_ALLOC_BYTES 14 /** Bytes allocated for scripts */
+#define WALLY_STAT_BIP32_ALLOC_BYTES 15 /** Bytes allocated for BIP32 keys */
+#define WALLY_STAT_ELEMENTS_ALLOC_BYTES 16 /** Bytes allocated for Elements operations */
+#define WALLY_NUM_STATS 17
+
+/**
+ * Get the current value of a library statistics counter.
+ *
+ * :param stat: The counter to return, ``WALLY_STAT_``.
+ * :param value_out: Destination for the counter value.
+ *
+ * .. note:: Returns WALLY_ERROR if the library was not configured with
+ *|    ``--enable-stats``. Counters are updated atomically but independently,
+ *|    so values read while other threads are calling wally may not be
+ *|    consistent with each other.
+ */
+WALLY_CORE_API int wally_get_stats(
+    uint32_t stat,
+    uint64_t *value_out);
+
+/**
+ * Reset all library statistics counters to zero.
+ *
+ * :param flags: Flags controlling the reset. Must be 0.
+ */
+WALLY_CORE_API int wally_reset_stats(
+    uint32_t flags);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,131 @@ WALLY_CORE_API int wally_scrypt(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * As per `wally_scrypt`, but running the parallel lanes as separate tasks.
+ *
+ * :param pass: Password to derive from.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param salt: Salt to derive from.
+ * :param salt_len: Length of ``salt`` in bytes.
+ * :param cost: The cost of the function. The larger this number, the
+ *|     longer the key will take to derive.
+ * :param block_size: The size of memory blocks required.
+ * :param parallelism: Parallelism factor.
+ * :param run_fn: Function to run the ``parallelism`` lanes, for example
+ *|     on a thread pool. If NULL, the ``run_tasks_fn`` operation is used,
+ *|     or if that is also NULL, this is equivalent to `wally_scrypt`.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the derived pseudorandom key.
+ * :param len: The length of ``bytes_out`` in bytes.
+ *
+ * .. note:: Each lane requires its own working memory, so this uses
+ *|    ``parallelism`` times the memory of `wally_scrypt`.
+ */
+WALLY_CORE_API int wally_scrypt_parallel(
+    const unsigned char *pass,
+    size_t pass_len,
+    const unsigned char *salt,
+    size_t salt_len,
+    uint32_t cost,
+    uint32_t block_size,
+    uint32_t parallelism,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * As per `wally_scrypt`, but running asynchronously.
+ *
+ * :param pass: Password to derive from. It is copied, so need not
+ *|     remain valid once this returns.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param salt: Salt to derive from. It is also copied.
+ * :param salt_len: Length of ``salt`` in bytes.
+ * :param cost: The cost of the function.
+ * :param block_size: The size of memory blocks required.
+ * :param parallelism: Parallelism factor.
+ * :param bytes_out: Destination for the derived pseudorandom key. It must
+ *|     remain valid until the operation completes.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param done_fn: Function to call with the result on completion, or NULL.
+ * :param done_ctx: Context passed to ``done_fn``.
+ * :param output: Destination for the resulting operation.
+ *|     The returned operation should be freed with `wally_async_free`.
+ *
+ * .. note:: The derivation runs with the ``submit_fn`` operation (see
+ *|    `wally_set_operations`), or on the calling thread if it is NULL.
+ *|    Invalid parameters other than NULL pointers are reported as the
+ *|    result of the operation.
+ */
+WALLY_CORE_API int wally_scrypt_async(
+    const unsigned char *pass,
+    size_t pass_len,
+    const unsigned char *salt,
+    size_t salt_len,
+    uint32_t cost,
+    uint32_t block_size,
+    uint32_t parallelism,
+    unsigned char *bytes_out,
+    size_t len,
+    wally_async_done_t done_fn,
+    void *done_ctx,
+    struct wally_async **output);
+
+/**
+ * Get the length of the scratch buffer required by `wally_scrypt_with_scratch`.
+ *
+ * :param cost: The cost of the function.
+ * :param block_size: The size of memory blocks required.
+ * :param parallelism: Parallelism factor.
+ * :param written: Destination for the required scratch length in bytes.
+ *
+ * .. note:: The length depends on the scrypt implementation selected for
+ *|    the current CPU, so `wally_init` should be called first.
+ */
+WALLY_CORE_API int wally_scrypt_get_scratch_length(
+    uint32_t cost,
+    uint32_t block_size,
+    uint32_t parallelism,
+    size_t *written);
+
+/**
+ * As per `wally_scrypt`, but using a caller supplied scratch buffer for
+ * all working memory instead of allocating it.
+ *
+ * :param pass: Password to derive from.
+ * :param pass_len: Length of ``pass`` in bytes.
+ * :param salt: Salt to derive from.
+ * :param salt_len: Length of ``salt`` in bytes.
+ * :param cost: The cost of the function. The larger this number, the
+ *|     longer the key will take to derive.
+ * :param block_size: The size of memory blocks required.
+ * :param parallelism: Parallelism factor.
+ * :param scratch: Working memory, which need not be aligned or initialized.
+ * :param scratch_len: The length of ``scratch`` in bytes. Must be at least
+ *|     the length returned by `wally_scrypt_get_scratch_length`.
+ * :param bytes_out: Destination for the derived pseudorandom key.
+ * :param len: The length of ``bytes_out`` in bytes.
+ *
+ * .. note:: The used part of ``scratch`` is cleared before returning.
+ *|    ``scratch`` must not be shared between concurrent calls.
+ */
+WALLY_CORE_API int wally_scrypt_with_scratch(
+    const unsigned char *pass,
+    size_t pass_len,
+    const unsigned char *salt,
+    size_t salt_len,
+    uint32_t cost,
+    uint32_t block_size,
+    uint32_t parallelism,
+    void *scratch,
+    size_t scratch_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 
 #define AES_BLOCK_LEN   16 /** Length of AES encrypted blocks */
 
@@ -89,6 +214,155 @@ WALLY_CORE_API int wally_aes_cbc(
     size_t len,
     size_t *written);
 
+#ifndef SWIG
+/** An opaque expanded AES key context */
+struct wally_aes_ctx;
+
+/**
+ * Create a context for encrypting/decrypting data using AES with a fixed key.
+ *
+ * :param key: Key material for initialisation.
+ * :param key_len: Length of ``key`` in bytes. Must be an AES_KEY_LEN_ constant.
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: The key is expanded for both encryption and decryption once when
+ *|    the context is created, rather than on every call.
+ *|    The returned context should be freed with `wally_aes_ctx_free`.
+ */
+WALLY_CORE_API int wally_aes_ctx_init_alloc(
+    const unsigned char *key,
+    size_t key_len,
+    struct wally_aes_ctx **output);
+
+/**
+ * As per `wally_aes`, using a key context.
+ *
+ * :param ctx: The key context from `wally_aes_ctx_init_alloc`.
+ * :param bytes: Bytes to encrypt/decrypt.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``AES_BLOCK_LEN``.
+ * :param flags: AES_FLAG_ constants indicating the desired behavior.
+ * :param bytes_out: Destination for the encrypted/decrypted data.
+ * :param len: The length of ``bytes_out`` in bytes. Must be a multiple of ``AES_BLOCK_LEN``.
+ */
+WALLY_CORE_API int wally_aes_ctx_compute(
+    const struct wally_aes_ctx *ctx,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * As per `wally_aes_cbc`, using a key context.
+ *
+ * :param ctx: The key context from `wally_aes_ctx_init_alloc`.
+ * :param iv: Initialisation vector.
+ * :param iv_len: Length of ``iv`` in bytes. Must be ``AES_BLOCK_LEN``.
+ * :param bytes: Bytes to encrypt/decrypt.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``AES_BLOCK_LEN``.
+ * :param flags: AES_FLAG_ constants indicating the desired behavior.
+ * :param bytes_out: Destination for the encrypted/decrypted data.
+ * :param len: The length of ``bytes_out`` in bytes. Must be a multiple of ``AES_BLOCK_LEN``.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_aes_cbc_ctx_compute(
+    const struct wally_aes_ctx *ctx,
+    const unsigned char *iv,
+    size_t iv_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Free a context allocated by `wally_aes_ctx_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_aes_ctx_free(
+    struct wally_aes_ctx *ctx);
+
+/** An opaque streaming AES-CBC encryption/decryption state */
+struct wally_aes_cbc_stream;
+
+/**
+ * Start encrypting/decrypting data incrementally using AES (CBC mode, PKCS#7 padding).
+ *
+ * :param key: Key material for initialisation.
+ * :param key_len: Length of ``key`` in bytes. Must be an AES_KEY_LEN_ constant.
+ * :param iv: Initialisation vector.
+ * :param iv_len: Length of ``iv`` in bytes. Must be ``AES_BLOCK_LEN``.
+ * :param flags: Either ``AES_FLAG_ENCRYPT`` or ``AES_FLAG_DECRYPT``.
+ * :param output: Destination for the resulting stream.
+ *
+ * .. note:: Data is passed with `wally_aes_cbc_stream_update`, followed by
+ *|    a single call to `wally_aes_cbc_stream_final`. The returned stream
+ *|    should be freed with `wally_aes_cbc_stream_free`.
+ */
+WALLY_CORE_API int wally_aes_cbc_stream_init_alloc(
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *iv,
+    size_t iv_len,
+    uint32_t flags,
+    struct wally_aes_cbc_stream **output);
+
+/**
+ * Encrypt/decrypt the next part of a streaming AES-CBC operation.
+ *
+ * :param stream: The stream from `wally_aes_cbc_stream_init_alloc`.
+ * :param bytes: Bytes to encrypt/decrypt.
+ * :param bytes_len: Length of ``bytes`` in bytes. May be any length.
+ * :param bytes_out: Destination for the encrypted/decrypted data. Must
+ *|    not overlap ``bytes``.
+ * :param len: The length of ``bytes_out`` in bytes. A length of
+ *|    ``bytes_len + AES_BLOCK_LEN`` is always sufficient.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: Only whole blocks are output; any partial block is kept until
+ *|    the next call. When decrypting, the last whole block is also kept for
+ *|    `wally_aes_cbc_stream_final` as it contains the padding. If ``len``
+ *|    is too small, nothing is processed and ``written`` contains the
+ *|    length required.
+ */
+WALLY_CORE_API int wally_aes_cbc_stream_update(
+    struct wally_aes_cbc_stream *stream,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Finish a streaming AES-CBC operation, adding or removing padding.
+ *
+ * :param stream: The stream from `wally_aes_cbc_stream_init_alloc`.
+ * :param bytes_out: Destination for the final encrypted/decrypted data.
+ * :param len: The length of ``bytes_out`` in bytes. ``AES_BLOCK_LEN``
+ *|    bytes is always sufficient.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: If ``len`` is too small, the stream is not finished and
+ *|    ``written`` contains the length required. Once finished, the stream
+ *|    can only be freed.
+ */
+WALLY_CORE_API int wally_aes_cbc_stream_final(
+    struct wally_aes_cbc_stream *stream,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Free a stream allocated by `wally_aes_cbc_stream_init_alloc`.
+ *
+ * :param stream: The stream to free.
+ */
+WALLY_CORE_API int wally_aes_cbc_stream_free(
+    struct wally_aes_cbc_stream *stream);
+#endif /* SWIG */
+
 
 /** Output length for `wally_sha256` */
 #define SHA256_LEN 32
@@ -138,6 +412,48 @@ WALLY_CORE_API int wally_sha256d(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * SHA-256(m) of a batch of equal length messages.
+ *
+ * :param bytes: The messages to hash, stored contiguously.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each message in bytes.
+ * :param bytes_out: Destination for the resulting hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be
+ *|    ``SHA256_LEN`` times the number of messages.
+ *
+ * .. note:: Where the CPU supports it, several messages are hashed at once.
+ *|    If ``item_len`` is at least ``SHA256_LEN``, ``bytes_out`` may be ``bytes``.
+ */
+WALLY_CORE_API int wally_sha256_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * SHA-256(SHA-256(m)) (double SHA-256) of a batch of equal length messages.
+ *
+ * :param bytes: The messages to hash, stored contiguously.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each message in bytes.
+ * :param bytes_out: Destination for the resulting hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be
+ *|    ``SHA256_LEN`` times the number of messages.
+ *
+ * .. note:: As for `wally_sha256_batch`, ``bytes_out`` may be ``bytes``
+ *|    if ``item_len`` is at least ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_sha256d_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 /**
  * SHA-512(m)
  *
@@ -169,6 +485,175 @@ WALLY_CORE_API int wally_hash160(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * RIPEMD-160(SHA-256(m)) of a batch of equal length messages.
+ *
+ * :param bytes: The messages to hash, stored contiguously.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each message in bytes.
+ * :param bytes_out: Destination for the resulting hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be
+ *|    ``HASH160_LEN`` times the number of messages.
+ *
+ * .. note:: Where the CPU supports it, several messages are hashed at once.
+ *|    If ``item_len`` is at least ``HASH160_LEN``, ``bytes_out`` may be ``bytes``.
+ */
+WALLY_CORE_API int wally_hash160_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
+#ifndef SWIG
+/** An opaque incremental SHA-256 hashing context */
+struct wally_sha256_ctx;
+
+/** An opaque incremental SHA-512 hashing context */
+struct wally_sha512_ctx;
+
+/**
+ * Create a context for computing SHA-256 incrementally.
+ *
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: Data is added with `wally_sha256_update`, and the hash computed
+ *|    with `wally_sha256_final`, `wally_sha256d_final` or `wally_hash160_final`.
+ *|    The returned context should be freed with `wally_sha256_free`.
+ */
+WALLY_CORE_API int wally_sha256_init_alloc(
+    struct wally_sha256_ctx **output);
+
+/**
+ * Add data to an incremental SHA-256 computation.
+ *
+ * :param ctx: The context from `wally_sha256_init_alloc`.
+ * :param bytes: The data to hash. May be NULL if ``bytes_len`` is zero.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ */
+WALLY_CORE_API int wally_sha256_update(
+    struct wally_sha256_ctx *ctx,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Finish an incremental SHA-256 computation: SHA-256(m).
+ *
+ * :param ctx: The context from `wally_sha256_init_alloc`.
+ * :param bytes_out: Destination for the resulting hash.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ *
+ * .. note:: The context is reset and may be used for another hash.
+ */
+WALLY_CORE_API int wally_sha256_final(
+    struct wally_sha256_ctx *ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Finish an incremental SHA-256 computation: SHA-256(SHA-256(m)).
+ *
+ * :param ctx: The context from `wally_sha256_init_alloc`.
+ * :param bytes_out: Destination for the resulting hash.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ *
+ * .. note:: The context is reset and may be used for another hash.
+ */
+WALLY_CORE_API int wally_sha256d_final(
+    struct wally_sha256_ctx *ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Finish an incremental SHA-256 computation: RIPEMD-160(SHA-256(m)).
+ *
+ * :param ctx: The context from `wally_sha256_init_alloc`.
+ * :param bytes_out: Destination for the resulting hash.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``HASH160_LEN``.
+ *
+ * .. note:: The context is reset and may be used for another hash.
+ */
+WALLY_CORE_API int wally_hash160_final(
+    struct wally_sha256_ctx *ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a context allocated by `wally_sha256_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_sha256_free(
+    struct wally_sha256_ctx *ctx);
+
+/**
+ * Create a context for computing SHA-512 incrementally.
+ *
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: The returned context should be freed with `wally_sha512_free`.
+ */
+WALLY_CORE_API int wally_sha512_init_alloc(
+    struct wally_sha512_ctx **output);
+
+/**
+ * Add data to an incremental SHA-512 computation.
+ *
+ * :param ctx: The context from `wally_sha512_init_alloc`.
+ * :param bytes: The data to hash. May be NULL if ``bytes_len`` is zero.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ */
+WALLY_CORE_API int wally_sha512_update(
+    struct wally_sha512_ctx *ctx,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Finish an incremental SHA-512 computation: SHA-512(m).
+ *
+ * :param ctx: The context from `wally_sha512_init_alloc`.
+ * :param bytes_out: Destination for the resulting hash.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA512_LEN``.
+ *
+ * .. note:: The context is reset and may be used for another hash.
+ */
+WALLY_CORE_API int wally_sha512_final(
+    struct wally_sha512_ctx *ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a context allocated by `wally_sha512_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_sha512_free(
+    struct wally_sha512_ctx *ctx);
+#endif /* SWIG */
+
+/** Key length for `wally_siphash24` */
+#define WALLY_SIPHASH_KEY_LEN 16
+
+#ifndef SWIG
+/**
+ * SipHash-2-4(k, m), as used for BIP152 short transaction ids.
+ *
+ * :param key: The 128 bit key, as two little endian 64 bit words.
+ * :param key_len: The length of ``key`` in bytes. Must be ``WALLY_SIPHASH_KEY_LEN``.
+ * :param bytes: The message to hash. May be NULL if ``bytes_len`` is zero.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param value_out: Destination for the resulting 64 bit hash.
+ */
+WALLY_CORE_API int wally_siphash24(
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint64_t *value_out);
+#endif /* SWIG */
+
 
 /** Output length for `wally_hmac_sha256` */
 #define HMAC_SHA256_LEN 32
@@ -195,23 +680,109 @@ WALLY_CORE_API int wally_hmac_sha256(
     size_t len);
 
 /**
- * Compute an HMAC using SHA-512
+ * Compute an HMAC using SHA-512
+ *
+ * :param key: The key for the hash
+ * :param key_len: The length of ``key`` in bytes.
+ * :param bytes: The message to hash
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param bytes_out: Destination for the resulting HMAC.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``HMAC_SHA512_LEN``.
+ */
+WALLY_CORE_API int wally_hmac_sha512(
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/** An opaque HMAC key context */
+struct wally_hmac_sha256_ctx;
+struct wally_hmac_sha512_ctx;
+
+/**
+ * Create a context for computing HMACs using SHA-256 with a fixed key.
+ *
+ * :param key: The key for the hash
+ * :param key_len: The length of ``key`` in bytes.
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: The padded key blocks are hashed once when the context is created,
+ *|    saving two SHA-256 compressions for each HMAC computed with it.
+ *|    The returned context should be freed with `wally_hmac_sha256_ctx_free`.
+ */
+WALLY_CORE_API int wally_hmac_sha256_ctx_init_alloc(
+    const unsigned char *key,
+    size_t key_len,
+    struct wally_hmac_sha256_ctx **output);
+
+/**
+ * Compute an HMAC using SHA-256 and a key context.
+ *
+ * :param ctx: The key context from `wally_hmac_sha256_ctx_init_alloc`.
+ * :param bytes: The message to hash
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param bytes_out: Destination for the resulting HMAC.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``HMAC_SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_hmac_sha256_ctx_compute(
+    const struct wally_hmac_sha256_ctx *ctx,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a context allocated by `wally_hmac_sha256_ctx_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_hmac_sha256_ctx_free(
+    struct wally_hmac_sha256_ctx *ctx);
+
+/**
+ * Create a context for computing HMACs using SHA-512 with a fixed key.
+ *
+ * :param key: The key for the hash
+ * :param key_len: The length of ``key`` in bytes.
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: The padded key blocks are hashed once when the context is created,
+ *|    saving two SHA-512 compressions for each HMAC computed with it.
+ *|    The returned context should be freed with `wally_hmac_sha512_ctx_free`.
+ */
+WALLY_CORE_API int wally_hmac_sha512_ctx_init_alloc(
+    const unsigned char *key,
+    size_t key_len,
+    struct wally_hmac_sha512_ctx **output);
+
+/**
+ * Compute an HMAC using SHA-512 and a key context.
  *
- * :param key: The key for the hash
- * :param key_len: The length of ``key`` in bytes.
+ * :param ctx: The key context from `wally_hmac_sha512_ctx_init_alloc`.
  * :param bytes: The message to hash
  * :param bytes_len: The length of ``bytes`` in bytes.
  * :param bytes_out: Destination for the resulting HMAC.
  * :param len: The length of ``bytes_out`` in bytes. Must be ``HMAC_SHA512_LEN``.
  */
-WALLY_CORE_API int wally_hmac_sha512(
-    const unsigned char *key,
-    size_t key_len,
+WALLY_CORE_API int wally_hmac_sha512_ctx_compute(
+    const struct wally_hmac_sha512_ctx *ctx,
     const unsigned char *bytes,
     size_t bytes_len,
     unsigned char *bytes_out,
     size_t len);
 
+/**
+ * Free a context allocated by `wally_hmac_sha512_ctx_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_hmac_sha512_ctx_free(
+    struct wally_hmac_sha512_ctx *ctx);
+#endif /* SWIG */
+
 
 /** Output length for `wally_pbkdf2_hmac_sha256` */
 #define PBKDF2_HMAC_SHA256_LEN 32
@@ -277,6 +848,8 @@ WALLY_CORE_API int wally_pbkdf2_hmac_sha512(
 #define EC_MESSAGE_HASH_LEN 32
 /** The length of a compact signature produced by EC signing */
 #define EC_SIGNATURE_LEN 64
+/** The length of a compact recoverable signature produced by EC signing */
+#define EC_SIGNATURE_RECOVERABLE_LEN 65
 /** The maximum encoded length of a DER encoded signature */
 #define EC_SIGNATURE_DER_MAX_LEN 72
 /** The maximum encoded length of a DER encoded signature created with EC_FLAG_GRIND_R */
@@ -288,6 +861,17 @@ WALLY_CORE_API int wally_pbkdf2_hmac_sha512(
 #define EC_FLAG_SCHNORR 0x2
 /** Indicates that the signature nonce should be incremented until the signature is low-R */
 #define EC_FLAG_GRIND_R 0x4
+/** Indicates that batch signing should output DER encoded signatures */
+#define EC_FLAG_DER 0x8
+/** Indicates that a recoverable ECDSA signature is required */
+#define EC_FLAG_RECOVERABLE 0x10
+
+/** Indicates that bulk public key derivation should output uncompressed keys */
+#define EC_PUBLIC_KEY_FLAG_UNCOMPRESSED 0x1
+/** Indicates that bulk public key derivation should output the HASH160 of each key */
+#define EC_PUBLIC_KEY_FLAG_HASH160 0x2
+/** Indicates that bulk public key conversion is given uncompressed keys */
+#define EC_PUBLIC_KEY_FLAG_FROM_UNCOMPRESSED 0x4
 
 
 /**
@@ -314,6 +898,53 @@ WALLY_CORE_API int wally_ec_public_key_from_private_key(
     unsigned char *bytes_out,
     size_t len);
 
+/**
+ * Create public keys from a batch of private keys.
+ *
+ * :param priv_keys: The private keys to create public keys from, one after another.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes. Must be a
+ *|    non-zero multiple of ``EC_PRIVATE_KEY_LEN``.
+ * :param flags: EC_PUBLIC_KEY_FLAG_ values indicating the output wanted. If 0,
+ *|    compressed public keys are returned.
+ * :param bytes_out: Destination for the resulting public keys or hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be the number of private
+ *|    keys times ``HASH160_LEN`` if ``EC_PUBLIC_KEY_FLAG_HASH160`` is given, or
+ *|    times ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` or ``EC_PUBLIC_KEY_LEN`` otherwise.
+ *
+ * .. note:: If any private key is invalid, ``bytes_out`` is cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_ec_public_keys_from_private_keys(
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Convert a batch of public keys between compressed and uncompressed encodings.
+ *
+ * :param pub_keys: The public keys to convert, one after another.
+ * :param pub_keys_len: The length of ``pub_keys`` in bytes. Must be a non-zero
+ *|    multiple of ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` if
+ *|    ``EC_PUBLIC_KEY_FLAG_FROM_UNCOMPRESSED`` is given, or of
+ *|    ``EC_PUBLIC_KEY_LEN`` otherwise.
+ * :param flags: EC_PUBLIC_KEY_FLAG_ values indicating the input given and
+ *|    the output wanted, as per `wally_ec_public_keys_from_private_keys`. If 0,
+ *|    compressed public keys are validated and returned unchanged.
+ * :param bytes_out: Destination for the converted public keys or hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be the number of public
+ *|    keys times ``HASH160_LEN`` if ``EC_PUBLIC_KEY_FLAG_HASH160`` is given, or
+ *|    times ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` or ``EC_PUBLIC_KEY_LEN`` otherwise.
+ *
+ * .. note:: If any public key is invalid, ``bytes_out`` is cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_ec_public_keys_convert(
+    const unsigned char *pub_keys,
+    size_t pub_keys_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
 /**
  * Create an uncompressed public key from a compressed public key.
  *
@@ -328,6 +959,212 @@ WALLY_CORE_API int wally_ec_public_key_decompress(
     unsigned char *bytes_out,
     size_t len);
 
+/**
+ * Tweak a public key by adding a tweak times the generator to it.
+ *
+ * :param pub_key: The public key to tweak.
+ * :param pub_key_len: The length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param tweak: The 32 byte tweak to add.
+ * :param tweak_len: The length of ``tweak`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the resulting compressed public key.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ *
+ * .. note:: Fails if the tweak is not less than the group order or the
+ *|    resulting key is the point at infinity.
+ */
+WALLY_CORE_API int wally_ec_public_key_tweak_add(
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    const unsigned char *tweak,
+    size_t tweak_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Tweak a batch of public keys as per `wally_ec_public_key_tweak_add`.
+ *
+ * :param pub_keys: The public keys to tweak, one after another, or a
+ *|    single public key to tweak by every tweak.
+ * :param pub_keys_len: The length of ``pub_keys`` in bytes. Must be
+ *|    ``EC_PUBLIC_KEY_LEN``, or ``EC_PUBLIC_KEY_LEN`` times the number of tweaks.
+ * :param tweaks: The 32 byte tweaks to add, one after another.
+ * :param tweaks_len: The length of ``tweaks`` in bytes. Must be a non-zero
+ *|    multiple of ``EC_PRIVATE_KEY_LEN``.
+ * :param flags: EC_PUBLIC_KEY_FLAG_ values indicating the output wanted, as
+ *|    per `wally_ec_public_keys_from_private_keys`. If 0, compressed public
+ *|    keys are returned.
+ * :param bytes_out: Destination for the resulting public keys or hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be the number of tweaks
+ *|    times ``HASH160_LEN`` if ``EC_PUBLIC_KEY_FLAG_HASH160`` is given, or
+ *|    times ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` or ``EC_PUBLIC_KEY_LEN`` otherwise.
+ *
+ * .. note:: A single public key is parsed only once. If any key or tweak
+ *|    is invalid, ``bytes_out`` is cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_ec_public_keys_tweak_add(
+    const unsigned char *pub_keys,
+    size_t pub_keys_len,
+    const unsigned char *tweaks,
+    size_t tweaks_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Tweak a private key by adding a tweak to it modulo the group order.
+ *
+ * :param priv_key: The private key to tweak.
+ * :param priv_key_len: The length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param tweak: The 32 byte tweak to add.
+ * :param tweak_len: The length of ``tweak`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the resulting private key.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ *
+ * .. note:: The public key of the result is the result of tweaking the
+ *|    public key of ``priv_key`` with `wally_ec_public_key_tweak_add`.
+ */
+WALLY_CORE_API int wally_ec_private_key_tweak_add(
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    const unsigned char *tweak,
+    size_t tweak_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Tweak a batch of private keys as per `wally_ec_private_key_tweak_add`.
+ *
+ * :param priv_keys: The private keys to tweak, one after another, or a
+ *|    single private key to tweak by every tweak.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes. Must be
+ *|    ``EC_PRIVATE_KEY_LEN``, or ``EC_PRIVATE_KEY_LEN`` times the number of tweaks.
+ * :param tweaks: The 32 byte tweaks to add, one after another.
+ * :param tweaks_len: The length of ``tweaks`` in bytes. Must be a non-zero
+ *|    multiple of ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the resulting private keys, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``tweaks_len``.
+ *
+ * .. note:: If any key or tweak is invalid, ``bytes_out`` is cleared and
+ *|    an error is returned.
+ */
+WALLY_CORE_API int wally_ec_private_keys_tweak_add(
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    const unsigned char *tweaks,
+    size_t tweaks_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/** An opaque parsed public key */
+struct wally_ec_public_key;
+
+/**
+ * Parse a public key for repeated use.
+ *
+ * :param pub_key: The public key to parse.
+ * :param pub_key_len: The length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param output: Destination for the resulting parsed public key.
+ *
+ * .. note:: Parsing a compressed public key requires a field square root.
+ *|    Functions taking a parsed key avoid repeating this for keys used
+ *|    many times. The returned key should be freed with `wally_ec_public_key_free`.
+ */
+WALLY_CORE_API int wally_ec_public_key_init_alloc(
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    struct wally_ec_public_key **output);
+
+/**
+ * As per `wally_ec_public_key_decompress`, using a parsed public key.
+ *
+ * :param key: The parsed public key to decompress.
+ * :param bytes_out: Destination for the resulting public key.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN``.
+ */
+WALLY_CORE_API int wally_ec_public_key_decompress_parsed(
+    const struct wally_ec_public_key *key,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * As per `wally_ec_public_key_tweak_add`, using a parsed public key.
+ *
+ * :param key: The parsed public key to tweak.
+ * :param tweak: The 32 byte tweak to add.
+ * :param tweak_len: The length of ``tweak`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the resulting compressed public key.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ */
+WALLY_CORE_API int wally_ec_public_key_tweak_add_parsed(
+    const struct wally_ec_public_key *key,
+    const unsigned char *tweak,
+    size_t tweak_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a parsed public key allocated by `wally_ec_public_key_init_alloc`.
+ *
+ * :param key: The parsed public key to free.
+ */
+WALLY_CORE_API int wally_ec_public_key_free(
+    struct wally_ec_public_key *key);
+
+/** An opaque private key prepared for repeated signing */
+struct wally_ec_signing_key;
+
+/**
+ * Prepare a private key for signing many message hashes.
+ *
+ * :param priv_key: The private key to prepare.
+ * :param priv_key_len: The length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param output: Destination for the resulting signing key.
+ *
+ * .. note:: The returned key caches the RFC6979 nonce generation state that
+ *|    depends only on the private key. To use it, set ``ec_nonce_ctx`` to the
+ *|    key and ``ec_nonce_ctx_fn`` to `wally_ec_signing_key_nonce` with
+ *|    `wally_set_operations`, then sign as normal. The returned key should be
+ *|    freed with `wally_ec_signing_key_free` once it is no longer set.
+ */
+WALLY_CORE_API int wally_ec_signing_key_init_alloc(
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    struct wally_ec_signing_key **output);
+
+/**
+ * Free a signing key allocated by `wally_ec_signing_key_init_alloc`.
+ *
+ * :param key: The signing key to free.
+ */
+WALLY_CORE_API int wally_ec_signing_key_free(
+    struct wally_ec_signing_key *key);
+
+/**
+ * Generate an RFC6979 nonce using a signing key, as a ``wally_ec_nonce_ctx_t``.
+ *
+ * :param nonce_ctx: The signing key from `wally_ec_signing_key_init_alloc`.
+ * :param nonce32: Destination for the resulting nonce.
+ * :param msg32: The message hash being signed.
+ * :param key32: The private key being signed with.
+ * :param algo16: The algorithm name, or NULL.
+ * :param data: Extra entropy, or NULL.
+ * :param attempt: The number of nonces already rejected.
+ *
+ * .. note:: Returns 1 on success and 0 on failure, as for libsecp256k1 nonce
+ *|    functions. Nonces are identical to those of the default nonce function.
+ *|    If ``key32`` is not the signing key, ``ec_nonce_fn`` is used instead.
+ */
+WALLY_CORE_API int wally_ec_signing_key_nonce(
+    void *nonce_ctx,
+    unsigned char *nonce32,
+    const unsigned char *msg32,
+    const unsigned char *key32,
+    const unsigned char *algo16,
+    void *data,
+    unsigned int attempt);
+#endif /* SWIG */
+
 /**
  * Sign a message hash with a private key, producing a compact signature.
  *
@@ -337,7 +1174,11 @@ WALLY_CORE_API int wally_ec_public_key_decompress(
  * :param bytes_len: The length of ``bytes`` in bytes. Must be ``EC_MESSAGE_HASH_LEN``.
  * :param flags: EC_FLAG_ flag values indicating desired behavior.
  * :param bytes_out: Destination for the resulting compact signature.
- * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_SIGNATURE_LEN``.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_SIGNATURE_RECOVERABLE_LEN``
+ *|    if ``EC_FLAG_RECOVERABLE`` is given, or ``EC_SIGNATURE_LEN`` otherwise.
+ *
+ * .. note:: A recoverable signature is prefixed with a header byte of 31 plus
+ *|    the recovery id, as used for Bitcoin signed messages.
  */
 WALLY_CORE_API int wally_ec_sig_from_bytes(
     const unsigned char *priv_key,
@@ -348,6 +1189,102 @@ WALLY_CORE_API int wally_ec_sig_from_bytes(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * Sign a message hash with ECDSA, grinding for a low-R signature a bounded number of times.
+ *
+ * :param priv_key: The private key to sign with.
+ * :param priv_key_len: The length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes: The message hash to sign.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be ``EC_MESSAGE_HASH_LEN``.
+ * :param flags: Must be ``EC_FLAG_ECDSA | EC_FLAG_GRIND_R``.
+ * :param max_attempts: The maximum number of signing attempts to make, or
+ *|    0 to grind until a low-R signature is found as `wally_ec_sig_from_bytes` does.
+ * :param bytes_out: Destination for the resulting compact signature.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_SIGNATURE_LEN``.
+ * :param attempts: Destination for the number of signing attempts made.
+ *
+ * .. note:: Each attempt costs one full signing operation; on average two
+ *|    attempts are needed. If no low-R signature is found within
+ *|    ``max_attempts``, the last (valid, high-R) signature is returned and
+ *|    the caller can detect this by checking whether ``bytes_out[0] >= 0x80``.
+ */
+WALLY_CORE_API int wally_ec_sig_from_bytes_grind(
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    uint32_t max_attempts,
+    unsigned char *bytes_out,
+    size_t len,
+    uint32_t *attempts);
+#endif /* SWIG */
+
+/**
+ * Sign a batch of message hashes with ECDSA.
+ *
+ * :param priv_keys: The private keys to sign with, one after another.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes. Must be a
+ *|    non-zero multiple of ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes: The message hashes to sign, one for each private key.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be ``EC_MESSAGE_HASH_LEN``
+ *|    times the number of private keys.
+ * :param flags: ``EC_FLAG_ECDSA``, optionally combined with ``EC_FLAG_GRIND_R``
+ *|    and either ``EC_FLAG_DER`` to output DER encoded signatures or
+ *|    ``EC_FLAG_RECOVERABLE`` to output recoverable signatures.
+ * :param bytes_out: Destination for the resulting signatures, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Compact signatures
+ *|    require ``EC_SIGNATURE_LEN`` bytes each, recoverable signatures
+ *|    ``EC_SIGNATURE_RECOVERABLE_LEN`` bytes, while DER signatures require at
+ *|    most ``EC_SIGNATURE_DER_MAX_LEN`` (or ``EC_SIGNATURE_DER_MAX_LOW_R_LEN``
+ *|    with ``EC_FLAG_GRIND_R``) bytes each.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: DER signatures are variable length and self-delimiting. If
+ *|    ``len`` is too small, ``written`` is set to the required length and
+ *|    nothing is written. If any hash cannot be signed, ``bytes_out`` is
+ *|    cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_ec_sig_from_bytes_batch(
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+#ifndef SWIG
+/**
+ * As per `wally_ec_sig_from_bytes_batch`, but signing each hash as a separate task.
+ *
+ * :param priv_keys: The private keys to sign with, one after another.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes.
+ * :param bytes: The message hashes to sign, one for each private key.
+ * :param bytes_len: The length of ``bytes`` in bytes.
+ * :param flags: EC_FLAG_ flag values indicating desired behavior.
+ * :param run_fn: Function to run the signing of each hash, for example
+ *|     on a thread pool. If NULL, hashes are signed in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the resulting signatures, one after another.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_ec_sig_from_bytes_batch_parallel(
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Convert a signature to low-s form.
  *
@@ -392,6 +1329,87 @@ WALLY_CORE_API int wally_ec_sig_from_der(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * Convert a batch of signatures to low-s form.
+ *
+ * :param sigs: The compact signatures to convert, one after another.
+ * :param sigs_len: The length of ``sigs`` in bytes. Must be
+ *|    ``EC_SIGNATURE_LEN`` times the number of signatures.
+ * :param results_out: Destination for the result of each signature, 1 if
+ *|    it was valid or 0 otherwise.
+ * :param results_out_len: Size of ``results_out`` in bytes, i.e. the number of signatures.
+ * :param bytes_out: Destination for the resulting low-s signatures, one after
+ *|    another. The output for any invalid signature is cleared. May be the
+ *|    same as ``sigs`` to normalize in place.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``sigs_len``.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every signature is valid.
+ */
+WALLY_CORE_API int wally_ec_sig_normalize_batch(
+    const unsigned char *sigs,
+    size_t sigs_len,
+    unsigned char *results_out,
+    size_t results_out_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Convert a batch of compact signatures to DER encoding.
+ *
+ * :param sigs: The compact signatures to convert, one after another.
+ * :param sigs_len: The length of ``sigs`` in bytes. Must be
+ *|    ``EC_SIGNATURE_LEN`` times the number of signatures.
+ * :param lens_out: Destination for the length of each DER encoded signature,
+ *|    or 0 if the signature is invalid.
+ * :param lens_out_len: The number of elements in ``lens_out``, i.e. the number of signatures.
+ * :param bytes_out: Destination for the DER encoded signatures. Each is written
+ *|    at the start of its own ``EC_SIGNATURE_DER_MAX_LEN`` byte slot, and the
+ *|    remainder of the slot is cleared.
+ * :param len: The length of ``bytes_out`` in bytes. Must be
+ *|    ``EC_SIGNATURE_DER_MAX_LEN`` times the number of signatures.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every signature is valid.
+ */
+WALLY_CORE_API int wally_ec_sig_to_der_batch(
+    const unsigned char *sigs,
+    size_t sigs_len,
+    size_t *lens_out,
+    size_t lens_out_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Convert a batch of DER encoded signatures to compact signatures.
+ *
+ * :param bytes: The DER encoded signatures to convert, each at the start of
+ *|    its own ``EC_SIGNATURE_DER_MAX_LEN`` byte slot as produced by
+ *|    `wally_ec_sig_to_der_batch`.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be
+ *|    ``EC_SIGNATURE_DER_MAX_LEN`` times the number of signatures.
+ * :param lens: The length of each DER encoded signature in its slot.
+ * :param num_lens: The number of elements in ``lens``, i.e. the number of signatures.
+ * :param results_out: Destination for the result of each signature, 1 if
+ *|    it was decoded or 0 otherwise.
+ * :param results_out_len: Size of ``results_out`` in bytes. Must be ``num_lens``.
+ * :param bytes_out: Destination for the compact signatures, one after another.
+ *|    The output for any signature that fails to decode is cleared.
+ * :param len: The length of ``bytes_out`` in bytes. Must be
+ *|    ``EC_SIGNATURE_LEN`` times the number of signatures.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every signature is decoded.
+ */
+WALLY_CORE_API int wally_ec_sig_from_der_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const size_t *lens,
+    size_t num_lens,
+    unsigned char *results_out,
+    size_t results_out_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 /**
  * Verify a signed message hash.
  *
@@ -412,6 +1430,128 @@ WALLY_CORE_API int wally_ec_sig_verify(
     const unsigned char *sig,
     size_t sig_len);
 
+#ifndef SWIG
+/**
+ * As per `wally_ec_sig_verify`, using a parsed public key.
+ *
+ * :param key: The parsed public key to verify with.
+ * :param bytes: The message hash to verify.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be ``EC_MESSAGE_HASH_LEN``.
+ * :param flags: EC_FLAG_ flag values indicating desired behavior.
+ * :param sig: The compact signature of the message in ``bytes``.
+ * :param sig_len: The length of ``sig`` in bytes. Must be ``EC_SIGNATURE_LEN``.
+ */
+WALLY_CORE_API int wally_ec_sig_verify_parsed(
+    const struct wally_ec_public_key *key,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    const unsigned char *sig,
+    size_t sig_len);
+#endif /* SWIG */
+
+#ifndef SWIG
+/**
+ * Verify a batch of signed message hashes.
+ *
+ * :param pub_keys: The public keys to verify with, one after another.
+ * :param pub_keys_len: The length of ``pub_keys`` in bytes. Must be
+ *|    ``EC_PUBLIC_KEY_LEN`` times the number of signatures.
+ * :param bytes: The message hashes to verify, one after another.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be
+ *|    ``EC_MESSAGE_HASH_LEN`` times the number of signatures.
+ * :param flags: Must be ``EC_FLAG_ECDSA``.
+ * :param sigs: The compact signatures of the messages in ``bytes``, one after another.
+ * :param sigs_len: The length of ``sigs`` in bytes. Must be
+ *|    ``EC_SIGNATURE_LEN`` times the number of signatures.
+ * :param run_fn: Function to run verification of groups of signatures as
+ *|     separate tasks, for example on a thread pool. If NULL, signatures are
+ *|     verified in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the verification result of each signature,
+ *|     1 if the signature is valid or 0 otherwise.
+ * :param len: Size of ``bytes_out`` in bytes, i.e. the number of signatures.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every signature is valid. Tasks use
+ *|    the libsecp256k1 context of the calling thread.
+ */
+WALLY_CORE_API int wally_ec_sig_verify_batch(
+    const unsigned char *pub_keys,
+    size_t pub_keys_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    const unsigned char *sigs,
+    size_t sigs_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
+/**
+ * Recover the public key that created a recoverable signature.
+ *
+ * :param bytes: The message hash that was signed.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be ``EC_MESSAGE_HASH_LEN``.
+ * :param sig: The recoverable signature of the message hash.
+ * :param sig_len: The length of ``sig`` in bytes. Must be ``EC_SIGNATURE_RECOVERABLE_LEN``.
+ * :param bytes_out: Destination for the recovered compressed public key.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ *
+ * .. note:: Verification by recovery succeeds if the recovered public key
+ *|    (or its HASH160, for an address) matches the expected signer.
+ */
+WALLY_CORE_API int wally_ec_sig_to_public_key(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *sig,
+    size_t sig_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/**
+ * Recover the public keys that created a batch of recoverable signatures.
+ *
+ * :param bytes: The message hashes that were signed, one after another.
+ * :param bytes_len: The length of ``bytes`` in bytes. Must be
+ *|    ``EC_MESSAGE_HASH_LEN`` times the number of signatures.
+ * :param sigs: The recoverable signatures of the message hashes, one after another.
+ * :param sigs_len: The length of ``sigs`` in bytes. Must be
+ *|    ``EC_SIGNATURE_RECOVERABLE_LEN`` times the number of signatures.
+ * :param flags: EC_PUBLIC_KEY_FLAG_ values indicating the output wanted, as
+ *|    per `wally_ec_public_keys_from_private_keys`.
+ * :param run_fn: Function to run recovery of groups of signatures as
+ *|     separate tasks, for example on a thread pool. If NULL, signatures are
+ *|     recovered in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param results_out: Destination for the recovery result of each signature,
+ *|     1 if a public key was recovered or 0 otherwise.
+ * :param results_out_len: Size of ``results_out`` in bytes, i.e. the number of signatures.
+ * :param bytes_out: Destination for the recovered public keys or hashes, one after
+ *|     another. The output for any signature that fails to recover is cleared.
+ * :param len: The length of ``bytes_out`` in bytes. Must be the number of
+ *|    signatures times ``HASH160_LEN`` if ``EC_PUBLIC_KEY_FLAG_HASH160`` is given,
+ *|    or times ``EC_PUBLIC_KEY_UNCOMPRESSED_LEN`` or ``EC_PUBLIC_KEY_LEN`` otherwise.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every public key is recovered. Tasks use
+ *|    the libsecp256k1 context of the calling thread.
+ */
+WALLY_CORE_API int wally_ec_sig_to_public_key_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *sigs,
+    size_t sigs_len,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *results_out,
+    size_t results_out_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 /** The maximum size of input message that can be formatted */
 #define BITCOIN_MESSAGE_MAX_LEN (64 * 1024 - 64)
 
@@ -439,6 +1579,87 @@ WALLY_CORE_API int wally_format_bitcoin_message(const unsigned char *bytes,
                                                 size_t len,
                                                 size_t *written);
 
+#ifndef SWIG
+/**
+ * Hash a batch of messages for use as bitcoin signed messages.
+ *
+ * :param messages: The message strings to hash.
+ * :param message_lens: The length of each message in ``messages`` in bytes.
+ *|    Each must be less than or equal to BITCOIN_MESSAGE_MAX_LEN.
+ * :param num_messages: The number of messages in ``messages``.
+ * :param flags: Must be ``BITCOIN_MESSAGE_FLAG_HASH``.
+ * :param bytes_out: Destination for the message hashes, one after another.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA256_LEN``
+ *|    times ``num_messages``.
+ *
+ * .. note:: If any message is invalid, ``bytes_out`` is cleared and an error is returned.
+ */
+WALLY_CORE_API int wally_format_bitcoin_message_batch(
+    const unsigned char *const *messages,
+    const size_t *message_lens,
+    size_t num_messages,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
+/**
+ * Compute an EC Diffie-Hellman shared secret.
+ *
+ * :param pub_key: The compressed public key of the other party.
+ * :param pub_key_len: The length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param priv_key: The private key to multiply ``pub_key`` by.
+ * :param priv_key_len: The length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the shared secret, the SHA256 of the
+ *|    compressed shared point.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_ecdh(
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/**
+ * Compute a batch of EC Diffie-Hellman shared secrets.
+ *
+ * :param pub_keys: The compressed public keys of the other parties, one after another.
+ * :param pub_keys_len: The length of ``pub_keys`` in bytes. Must be
+ *|    ``EC_PUBLIC_KEY_LEN`` times the number of secrets.
+ * :param priv_keys: The private keys to multiply each public key by, one
+ *|    after another, or a single private key to use with every public key.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes. Must be
+ *|    ``EC_PRIVATE_KEY_LEN``, or ``EC_PRIVATE_KEY_LEN`` times the number of secrets.
+ * :param run_fn: Function to compute groups of secrets as separate tasks, for
+ *|     example on a thread pool. If NULL, secrets are computed in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param results_out: Destination for the result of each secret, 1 if
+ *|     it was computed or 0 otherwise.
+ * :param results_out_len: Size of ``results_out`` in bytes, i.e. the number of secrets.
+ * :param bytes_out: Destination for the shared secrets, one after another, as per
+ *|     `wally_ecdh`. The output for any secret that fails is cleared.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``SHA256_LEN``
+ *|    times the number of secrets.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every secret is computed. Tasks use
+ *|    the libsecp256k1 context of the calling thread.
+ */
+WALLY_CORE_API int wally_ecdh_batch(
+    const unsigned char *pub_keys,
+    size_t pub_keys_len,
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *results_out,
+    size_t results_out_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,12 @@ extern "C" {
 
 #define ASSET_RANGEPROOF_MAX_LEN 5134 /** Maximum length of an Asset Range Proof */
 
+#define ASSET_RANGEPROOF_EXP 0 /** Base 10 exponent of the Asset Range Proofs created by wally */
+
+#define ASSET_RANGEPROOF_MIN_BITS 32 /** Minimum bits of value proven by the Asset Range Proofs created by wally */
+
+#define ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS 100 /** Default input selection attempts for a Surjection Proof */
+
 /**
  * Create a blinded Asset Generator from an Asset Tag and Asset Blinding Factor.
  *
@@ -76,6 +82,206 @@ WALLY_CORE_API int wally_asset_rangeproof(
     size_t len,
     size_t *written);
 
+/**
+ * Get the exact length of an Asset Range Proof.
+ *
+ * :param value: The value the proof is for.
+ * :param min_value: The minimum value the proof is for.
+ * :param exp: The base 10 exponent of the proof, from -1 to 18.
+ * :param min_bits: The minimum number of bits of value to prove, from 0 to 64.
+ * :param written: Destination for the length of the proof in bytes.
+ *
+ * .. note:: Proofs from `wally_asset_rangeproof` use an ``exp`` of
+ *|    ``ASSET_RANGEPROOF_EXP`` and ``min_bits`` of ``ASSET_RANGEPROOF_MIN_BITS``,
+ *|    and may be written to a buffer of exactly this length.
+ */
+WALLY_CORE_API int wally_asset_rangeproof_size(
+    uint64_t value,
+    uint64_t min_value,
+    int exp,
+    int min_bits,
+    size_t *written);
+
+#ifndef SWIG
+struct wally_ec_public_key;
+struct wally_hmac_sha256_ctx;
+struct wally_tx_output;
+
+/** An opaque parsed Asset Generator */
+struct wally_asset_generator;
+
+/**
+ * Parse an Asset Generator for repeated use.
+ *
+ * :param generator: Asset Generator to parse.
+ * :param generator_len: Length of ``generator`` in bytes. Must be ``ASSET_GENERATOR_LEN``.
+ * :param output: Destination for the resulting parsed Asset Generator.
+ *
+ * .. note:: The returned generator should be freed with `wally_asset_generator_free`.
+ */
+WALLY_CORE_API int wally_asset_generator_init_alloc(
+    const unsigned char *generator,
+    size_t generator_len,
+    struct wally_asset_generator **output);
+
+/**
+ * Create a parsed Asset Generator from an Asset Tag and optional Asset Blinding Factor.
+ *
+ * :param asset: Asset Tag to create a generator for.
+ * :param asset_len: Length of ``asset`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param abf: Asset Blinding Factor, or NULL to create an unblinded generator.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN`` or 0.
+ * :param output: Destination for the resulting parsed Asset Generator.
+ *
+ * .. note:: Creating a generator from an Asset Tag hashes the tag to a curve
+ *|    point. Callers handling few distinct assets can create each unblinded
+ *|    generator once and reuse it. The returned generator should be freed
+ *|    with `wally_asset_generator_free`.
+ */
+WALLY_CORE_API int wally_asset_generator_from_tag_alloc(
+    const unsigned char *asset,
+    size_t asset_len,
+    const unsigned char *abf,
+    size_t abf_len,
+    struct wally_asset_generator **output);
+
+/**
+ * Serialize a parsed Asset Generator.
+ *
+ * :param generator: The parsed Asset Generator to serialize.
+ * :param bytes_out: Destination for the resulting Asset Generator.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``ASSET_GENERATOR_LEN``.
+ */
+WALLY_CORE_API int wally_asset_generator_to_bytes(
+    const struct wally_asset_generator *generator,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a parsed Asset Generator allocated by `wally_asset_generator_init_alloc`
+ * or `wally_asset_generator_from_tag_alloc`.
+ *
+ * :param generator: The parsed Asset Generator to free.
+ */
+WALLY_CORE_API int wally_asset_generator_free(
+    struct wally_asset_generator *generator);
+
+/**
+ * Generate a value commitment using a parsed Asset Generator.
+ *
+ * :param value: The value to commit to.
+ * :param vbf: The Value Blinding Factor.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param generator: The parsed Asset Generator of the value.
+ * :param bytes_out: Destination for the value commitment.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``ASSET_COMMITMENT_LEN``.
+ *
+ * .. note:: The result is the same as calling `wally_asset_value_commitment`
+ *|    with the serialized generator, without parsing it for each commitment.
+ */
+WALLY_CORE_API int wally_asset_value_commitment_parsed(
+    uint64_t value,
+    const unsigned char *vbf,
+    size_t vbf_len,
+    const struct wally_asset_generator *generator,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Generate value commitments for an array of values.
+ *
+ * :param values: The values to commit to.
+ * :param values_len: The number of elements in ``values``.
+ * :param vbf: The Value Blinding Factor of each value, concatenated.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN`` * ``values_len``.
+ * :param generator: The Asset Generator of each value, concatenated.
+ * :param generator_len: Length of ``generator`` in bytes. Must be ``ASSET_GENERATOR_LEN`` * ``values_len``.
+ * :param bytes_out: Destination for the value commitments, each ``ASSET_COMMITMENT_LEN``
+ *|    bytes, in the order of ``values``.
+ * :param len: The length of ``bytes_out`` in bytes. Must be ``ASSET_COMMITMENT_LEN`` * ``values_len``.
+ *
+ * .. note:: The result is the same as calling `wally_asset_value_commitment`
+ *|    for each value. Consecutive identical generators are parsed once.
+ *|    If any commitment fails, ``bytes_out`` is cleared.
+ */
+WALLY_CORE_API int wally_asset_value_commitment_batch(
+    const uint64_t *values,
+    size_t values_len,
+    const unsigned char *vbf,
+    size_t vbf_len,
+    const unsigned char *generator,
+    size_t generator_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * As per `wally_asset_rangeproof`, using a parsed blinding public key
+ * and Asset Generator.
+ *
+ * .. note:: This avoids parsing the public key from
+ *|    `wally_ec_public_key_init_alloc` when creating many rangeproofs for
+ *|    outputs sent to the same blinding key, and the generator from
+ *|    `wally_asset_generator_init_alloc` for outputs of the same asset.
+ */
+WALLY_CORE_API int wally_asset_rangeproof_parsed(
+    uint64_t value,
+    const struct wally_ec_public_key *pub_key,
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    const unsigned char *asset,
+    size_t asset_len,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *vbf,
+    size_t vbf_len,
+    const unsigned char *commitment,
+    size_t commitment_len,
+    const unsigned char *extra,
+    size_t extra_len,
+    const struct wally_asset_generator *generator,
+    uint64_t min_value,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create an Asset Range Proof directly into a transaction output.
+ *
+ * :param output: The elements output to create the rangeproof for.
+ * :param value: The value of the output.
+ * :param pub_key: The blinding public key of the output.
+ * :param pub_key_len: Length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param priv_key: The ephemeral private key to blind the output with.
+ * :param priv_key_len: Length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param asset: The Asset Tag of the output.
+ * :param asset_len: Length of ``asset`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param abf: The Asset Blinding Factor of the output.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param vbf: The Value Blinding Factor of the output.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param min_value: The minimum value to prove.
+ *
+ * .. note:: As per `wally_asset_rangeproof`, using the output's value
+ *|    commitment and asset generator, with its scriptPubKey as the extra
+ *|    data. The proof is created in storage of exactly its final length,
+ *|    which replaces any existing rangeproof on the output without copying.
+ */
+WALLY_CORE_API int wally_tx_elements_output_rangeproof_set(
+    struct wally_tx_output *output,
+    uint64_t value,
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    const unsigned char *asset,
+    size_t asset_len,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *vbf,
+    size_t vbf_len,
+    uint64_t min_value);
+#endif /* SWIG */
+
 WALLY_CORE_API int wally_asset_surjectionproof_size(
     size_t num_inputs,
     size_t *written);
@@ -99,6 +305,144 @@ WALLY_CORE_API int wally_asset_surjectionproof(
     size_t len,
     size_t *written);
 
+/**
+ * Verify an Asset Surjection Proof.
+ *
+ * :param proof: The surjection proof to verify.
+ * :param proof_len: Length of ``proof`` in bytes.
+ * :param output_generator: The Asset Generator of the output the proof is for.
+ * :param output_generator_len: Length of ``output_generator`` in bytes. Must be ``ASSET_GENERATOR_LEN``.
+ * :param generator: The Asset Generators of each input.
+ * :param generator_len: Length of ``generator`` in bytes. Must be a non-zero
+ *|    multiple of ``ASSET_GENERATOR_LEN``.
+ *
+ * .. note:: Returns ``WALLY_EINVAL`` if the proof is not valid.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_verify(
+    const unsigned char *proof,
+    size_t proof_len,
+    const unsigned char *output_generator,
+    size_t output_generator_len,
+    const unsigned char *generator,
+    size_t generator_len);
+
+#ifndef SWIG
+/** An opaque set of parsed Surjection Proof inputs */
+struct wally_asset_surjectionproof_inputs;
+
+/**
+ * Parse the input assets of a Surjection Proof for repeated use.
+ *
+ * :param asset: The Asset Tags of each input.
+ * :param asset_len: Length of ``asset`` in bytes. Must be a non-zero multiple of ``ASSET_TAG_LEN``.
+ * :param abf: The Asset Blinding Factors of each input.
+ * :param abf_len: Length of ``abf`` in bytes. Must equal ``asset_len``.
+ * :param generator: The Asset Generators of each input.
+ * :param generator_len: Length of ``generator`` in bytes. Must be
+ *|    ``ASSET_GENERATOR_LEN`` times the number of inputs.
+ * :param output: Destination for the resulting parsed inputs.
+ *
+ * .. note:: The returned inputs should be freed with
+ *|    `wally_asset_surjectionproof_inputs_free`.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_inputs_init_alloc(
+    const unsigned char *asset,
+    size_t asset_len,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *generator,
+    size_t generator_len,
+    struct wally_asset_surjectionproof_inputs **output);
+
+/**
+ * Free parsed inputs allocated by `wally_asset_surjectionproof_inputs_init_alloc`.
+ *
+ * :param inputs: The parsed inputs to free.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_inputs_free(
+    struct wally_asset_surjectionproof_inputs *inputs);
+
+/**
+ * As per `wally_asset_surjectionproof`, using parsed inputs and a given iteration limit.
+ *
+ * :param inputs: The parsed inputs to prove the output asset is one of.
+ * :param output_asset: The Asset Tag of the output.
+ * :param output_asset_len: Length of ``output_asset`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param output_abf: The Asset Blinding Factor of the output.
+ * :param output_abf_len: Length of ``output_abf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param output_generator: The Asset Generator of the output.
+ * :param output_generator_len: Length of ``output_generator`` in bytes. Must be ``ASSET_GENERATOR_LEN``.
+ * :param bytes: Random entropy for choosing the inputs used in the proof.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be 32.
+ * :param max_iterations: The maximum number of random input selections to try.
+ *|    ``ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS`` is used by `wally_asset_surjectionproof`.
+ * :param bytes_out: Destination for the resulting Surjection Proof.
+ * :param len: Length of ``bytes_out`` in bytes. Must be the size returned
+ *|    by `wally_asset_surjectionproof_size` for the number of inputs.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: Each selection attempt is cheap compared to generating the
+ *|    proof, so ``max_iterations`` bounds the worst case latency of a call.
+ *|    Returns ``WALLY_ERROR`` if no selection containing a matching input
+ *|    is found; the caller should retry with different entropy.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_parsed(
+    const struct wally_asset_surjectionproof_inputs *inputs,
+    const unsigned char *output_asset,
+    size_t output_asset_len,
+    const unsigned char *output_abf,
+    size_t output_abf_len,
+    const unsigned char *output_generator,
+    size_t output_generator_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t max_iterations,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create Surjection Proofs for several outputs with the same inputs.
+ *
+ * :param inputs: The parsed inputs to prove each output asset is one of.
+ * :param output_asset: The Asset Tags of each output.
+ * :param output_asset_len: Length of ``output_asset`` in bytes. Must be a non-zero multiple of ``ASSET_TAG_LEN``.
+ * :param output_abf: The Asset Blinding Factors of each output.
+ * :param output_abf_len: Length of ``output_abf`` in bytes. Must equal ``output_asset_len``.
+ * :param output_generator: The Asset Generators of each output.
+ * :param output_generator_len: Length of ``output_generator`` in bytes. Must be
+ *|    ``ASSET_GENERATOR_LEN`` times the number of outputs.
+ * :param bytes: Random entropy for each output's proof, 32 bytes per output.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be 32 times the number of outputs.
+ * :param max_iterations: The maximum number of random input selections to try per output.
+ * :param run_fn: Function to create each proof as a separate task, for
+ *|    example on a thread pool. If NULL, proofs are created in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the resulting Surjection Proofs.
+ * :param len: Length of ``bytes_out`` in bytes. Must be the size returned
+ *|    by `wally_asset_surjectionproof_size` times the number of outputs.
+ *
+ * .. note:: Proofs for a given number of inputs all have the same size,
+ *|    and are written to ``bytes_out`` one after another in output order.
+ *|    The output generators are parsed once before any task runs.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_batch(
+    const struct wally_asset_surjectionproof_inputs *inputs,
+    const unsigned char *output_asset,
+    size_t output_asset_len,
+    const unsigned char *output_abf,
+    size_t output_abf_len,
+    const unsigned char *output_generator,
+    size_t output_generator_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t max_iterations,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 WALLY_CORE_API int wally_asset_unblind(
     const unsigned char *pub_key,
     size_t pub_key_len,
@@ -120,6 +464,535 @@ WALLY_CORE_API int wally_asset_unblind(
     size_t vbf_out_len,
     uint64_t *value_out);
 
+/**
+ * Verify an Asset Range Proof.
+ *
+ * :param proof: The rangeproof to verify.
+ * :param proof_len: Length of ``proof`` in bytes.
+ * :param commitment: The value commitment the proof is for.
+ * :param commitment_len: Length of ``commitment`` in bytes. Must be ``ASSET_COMMITMENT_LEN``.
+ * :param extra: The extra data committed to by the proof, e.g. the output's scriptPubKey.
+ * :param extra_len: Length of ``extra`` in bytes.
+ * :param generator: The asset generator of the value commitment.
+ * :param generator_len: Length of ``generator`` in bytes. Must be ``ASSET_GENERATOR_LEN``.
+ *
+ * .. note:: Returns ``WALLY_EINVAL`` if the proof is not valid.
+ */
+WALLY_CORE_API int wally_asset_rangeproof_verify(
+    const unsigned char *proof,
+    size_t proof_len,
+    const unsigned char *commitment,
+    size_t commitment_len,
+    const unsigned char *extra,
+    size_t extra_len,
+    const unsigned char *generator,
+    size_t generator_len);
+
+#ifndef SWIG
+struct wally_tx;
+
+/**
+ * Verify the rangeproofs of every confidential output of a transaction.
+ *
+ * :param tx: The elements transaction to verify.
+ * :param run_fn: Function to verify each proof as a separate task, for
+ *|    example on a thread pool. If NULL, proofs are verified in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ *
+ * .. note:: The value commitment and asset generator of each output with a
+ *|    confidential value are parsed once before any task runs, and each
+ *|    proof must commit to its output's scriptPubKey as extra data.
+ *|    Outputs without a confidential value are skipped. Returns ``WALLY_EINVAL`` if
+ *|    any proof is missing or not valid, and ``WALLY_ERROR`` if the library
+ *|    was built without elements support.
+ */
+WALLY_CORE_API int wally_asset_rangeproof_verify_tx(
+    const struct wally_tx *tx,
+    wally_run_tasks_t run_fn,
+    void *run_ctx);
+
+/**
+ * Verify the surjection proofs of every blinded output of a transaction.
+ *
+ * :param tx: The elements transaction to verify.
+ * :param generator: The Asset Generators of the assets spent by each
+ *|    input, followed by those of any assets the inputs issue.
+ * :param generator_len: Length of ``generator`` in bytes. Must be a non-zero
+ *|    multiple of ``ASSET_GENERATOR_LEN``.
+ * :param run_fn: Function to verify each proof as a separate task, for
+ *|    example on a thread pool. If NULL, proofs are verified in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ *
+ * .. note:: The input generators, and the asset generator of each output
+ *|    with a blinded asset, are parsed once before any task runs, and the
+ *|    parsed input generators are shared by every task. Outputs with an
+ *|    explicit asset are skipped. Returns ``WALLY_EINVAL`` if any proof is
+ *|    missing or not valid, and ``WALLY_ERROR`` if the library was built
+ *|    without elements support.
+ */
+WALLY_CORE_API int wally_asset_surjectionproof_verify_tx(
+    const struct wally_tx *tx,
+    const unsigned char *generator,
+    size_t generator_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx);
+
+/**
+ * Find and unblind the confidential outputs of a transaction sent to a blinding key.
+ *
+ * :param tx: The elements transaction to scan.
+ * :param priv_key: The blinding private key to unblind outputs with.
+ * :param priv_key_len: Length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param run_fn: Function to try each output as a separate task, for
+ *|    example on a thread pool. If NULL, outputs are tried in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param index_out: Destination for the index of each output unblinded.
+ * :param asset_out: Destination for the asset tag of each output unblinded.
+ * :param asset_out_len: Length of ``asset_out`` in bytes. Must be ``ASSET_TAG_LEN`` * ``len``.
+ * :param abf_out: Destination for the asset blinding factor of each output unblinded.
+ * :param abf_out_len: Length of ``abf_out`` in bytes. Must be ``ASSET_TAG_LEN`` * ``len``.
+ * :param vbf_out: Destination for the value blinding factor of each output unblinded.
+ * :param vbf_out_len: Length of ``vbf_out`` in bytes. Must be ``ASSET_TAG_LEN`` * ``len``.
+ * :param value_out: Destination for the value of each output unblinded.
+ * :param len: The number of elements in ``index_out`` and ``value_out``.
+ * :param written: Destination for the number of outputs unblinded.
+ *
+ * .. note:: Each output's nonce pubkey, value commitment and asset generator
+ *|    are parsed once, and outputs whose rangeproof header shows they cannot
+ *|    be rewound are skipped without any EC multiplication. The remaining
+ *|    outputs are rewound as tasks run by ``run_fn``; those that fail to
+ *|    rewind are not for this key and are skipped. Results are written in
+ *|    output order. If ``len`` is too small, ``written`` contains the number
+ *|    of outputs unblinded and only the first ``len`` are returned.
+ *|    Returns ``WALLY_ERROR`` if the library was built without elements support.
+ */
+WALLY_CORE_API int wally_asset_unblind_tx(
+    const struct wally_tx *tx,
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    uint32_t *index_out,
+    unsigned char *asset_out,
+    size_t asset_out_len,
+    unsigned char *abf_out,
+    size_t abf_out_len,
+    unsigned char *vbf_out,
+    size_t vbf_out_len,
+    uint64_t *value_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Blind the outputs of a transaction, creating their commitments and proofs.
+ *
+ * :param tx: The elements transaction whose outputs are to be blinded.
+ * :param indices: The index of each output to blind.
+ * :param indices_len: The number of elements in ``indices``.
+ * :param values: The values of each input, followed by the values of each output to blind.
+ * :param values_len: The number of elements in ``values``. Must be ``num_inputs`` + ``indices_len``.
+ * :param num_inputs: The number of inputs to the transaction.
+ * :param asset: The asset tags of each input, followed by those of each output to blind.
+ * :param asset_len: Length of ``asset`` in bytes. Must be ``ASSET_TAG_LEN`` * ``values_len``.
+ * :param abf: The asset blinding factors of each input, followed by those of each output to blind.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN`` * ``values_len``.
+ * :param vbf: The value blinding factors of each input, followed by those
+ *|    of each output to blind except the last.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN`` * (``values_len`` - 1).
+ * :param generator: The asset generators of each input.
+ * :param generator_len: Length of ``generator`` in bytes. Must be
+ *|    ``ASSET_GENERATOR_LEN`` * ``num_inputs``.
+ * :param pub_key: The blinding public key of each output to blind.
+ * :param pub_key_len: Length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN`` * ``indices_len``.
+ * :param priv_key: The ephemeral private key to blind each output with.
+ * :param priv_key_len: Length of ``priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN`` * ``indices_len``.
+ * :param bytes: Random entropy for the surjection proof of each output to blind.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be 32 * ``indices_len``.
+ * :param run_fn: Function to blind each output as a separate task, for
+ *|    example on a thread pool. If NULL, outputs are blinded in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the value blinding factor of the last output blinded.
+ * :param len: Length of ``bytes_out`` in bytes. Must be ``ASSET_TAG_LEN``.
+ *
+ * .. note:: This performs `wally_asset_final_vbf` and then, for each output,
+ *|    `wally_asset_generator_from_bytes`, `wally_asset_value_commitment`,
+ *|    `wally_asset_rangeproof` and `wally_asset_surjectionproof`, setting
+ *|    the results as per `wally_tx_elements_output_commitment_set`. Each
+ *|    output's proofs are written directly into storage allocated before
+ *|    any task runs, and the rangeproof commits to the output's
+ *|    scriptPubKey. Outputs not in ``indices``, such as the fee, are left
+ *|    unchanged. The transaction is only modified if every output is blinded;
+ *|    ``WALLY_ERROR`` indicates that the caller should retry with different
+ *|    blinding factors or entropy, or that the library was built without
+ *|    elements support.
+ */
+WALLY_CORE_API int wally_tx_blind(
+    struct wally_tx *tx,
+    const uint32_t *indices,
+    size_t indices_len,
+    const uint64_t *values,
+    size_t values_len,
+    size_t num_inputs,
+    const unsigned char *asset,
+    size_t asset_len,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *vbf,
+    size_t vbf_len,
+    const unsigned char *generator,
+    size_t generator_len,
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    const unsigned char *priv_key,
+    size_t priv_key_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the weight of a transaction once its outputs are blinded, without blinding them.
+ *
+ * :param tx: The elements transaction whose outputs are to be blinded.
+ * :param indices: The index of each output to blind.
+ * :param indices_len: The number of elements in ``indices``.
+ * :param values: The values of each input, followed by the values of each output to blind.
+ * :param values_len: The number of elements in ``values``. Must be ``num_inputs`` + ``indices_len``.
+ * :param num_inputs: The number of inputs the surjection proofs are made over.
+ * :param written: Destination for the weight of the blinded transaction.
+ *
+ * .. note:: The arguments are those of `wally_tx_blind`, which creates
+ *|    proofs of the sizes given by `wally_asset_rangeproof_size` and
+ *|    `wally_asset_surjectionproof_size`. The result is exactly the weight
+ *|    `wally_tx_get_weight` returns once the outputs are blinded, and can be
+ *|    converted with `wally_tx_vsize_from_weight`. Inputs are included as
+ *|    they are, so unsigned inputs should be given dummy signatures first.
+ */
+WALLY_CORE_API int wally_tx_get_blinded_weight_estimate(
+    const struct wally_tx *tx,
+    const uint32_t *indices,
+    size_t indices_len,
+    const uint64_t *values,
+    size_t values_len,
+    size_t num_inputs,
+    size_t *written);
+
+/** A running balance of the blinding factors of a transaction's inputs and outputs */
+struct wally_asset_blind_sum {
+    unsigned char sum[ASSET_TAG_LEN];
+};
+
+/**
+ * Initialize an empty blinding factor balance.
+ *
+ * :param sum: The balance to initialize.
+ *
+ * .. note:: The balance holds secret data: clear it with `wally_bzero`
+ *|    when no longer needed. It contains no pointers, so may be copied to
+ *|    save and restore the balance, for example during coin selection.
+ */
+WALLY_CORE_API int wally_asset_blind_sum_init(
+    struct wally_asset_blind_sum *sum);
+
+/**
+ * Add an input's blinding factors to a blinding factor balance.
+ *
+ * :param sum: The balance to update.
+ * :param value: The value of the input.
+ * :param abf: The Asset Blinding Factor of the input.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param vbf: The Value Blinding Factor of the input.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ */
+WALLY_CORE_API int wally_asset_blind_sum_add_input(
+    struct wally_asset_blind_sum *sum,
+    uint64_t value,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *vbf,
+    size_t vbf_len);
+
+/**
+ * Add an output's blinding factors to a blinding factor balance.
+ *
+ * :param sum: The balance to update.
+ * :param value: The value of the output.
+ * :param abf: The Asset Blinding Factor of the output.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param vbf: The Value Blinding Factor of the output.
+ * :param vbf_len: Length of ``vbf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ */
+WALLY_CORE_API int wally_asset_blind_sum_add_output(
+    struct wally_asset_blind_sum *sum,
+    uint64_t value,
+    const unsigned char *abf,
+    size_t abf_len,
+    const unsigned char *vbf,
+    size_t vbf_len);
+
+/**
+ * Compute the Value Blinding Factor of the final output from a blinding factor balance.
+ *
+ * :param sum: The balance of every input and every other output.
+ * :param value: The value of the final output.
+ * :param abf: The Asset Blinding Factor of the final output.
+ * :param abf_len: Length of ``abf`` in bytes. Must be ``ASSET_TAG_LEN``.
+ * :param bytes_out: Destination for the final Value Blinding Factor.
+ * :param len: Size of ``bytes_out``. Must be ``ASSET_TAG_LEN``.
+ *
+ * .. note:: This gives the same result as `wally_asset_final_vbf` called
+ *|    with every input and output added to ``sum``. ``sum`` is unchanged,
+ *|    so more outputs may be added and the final output recomputed.
+ */
+WALLY_CORE_API int wally_asset_blind_sum_final_vbf(
+    const struct wally_asset_blind_sum *sum,
+    uint64_t value,
+    const unsigned char *abf,
+    size_t abf_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Derive a SLIP-77 master blinding key from a seed.
+ *
+ * :param bytes: The seed, e.g. from `bip39_mnemonic_to_seed`.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be one of ``BIP32_ENTROPY_LEN_128``,
+ *|    ``BIP32_ENTROPY_LEN_256`` or ``BIP32_ENTROPY_LEN_512``.
+ * :param bytes_out: Destination for the SLIP-21 node of the master blinding key.
+ * :param len: Size of ``bytes_out``. Must be ``HMAC_SHA512_LEN``.
+ *
+ * .. note:: The master blinding key is the last 32 bytes of the node.
+ *|    Functions taking a master blinding key accept either the full node or
+ *|    those 32 bytes.
+ */
+WALLY_CORE_API int wally_asset_blinding_key_from_seed(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Derive the SLIP-77 blinding private key of a scriptPubKey.
+ *
+ * :param bytes: The master blinding key from `wally_asset_blinding_key_from_seed`.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be ``HMAC_SHA512_LEN`` or
+ *|    ``HMAC_SHA256_LEN``.
+ * :param script: The scriptPubKey to derive the blinding key of.
+ * :param script_len: Length of ``script`` in bytes.
+ * :param bytes_out: Destination for the blinding private key.
+ * :param len: Size of ``bytes_out``. Must be ``EC_PRIVATE_KEY_LEN``.
+ */
+WALLY_CORE_API int wally_asset_blinding_key_to_ec_private_key(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *script,
+    size_t script_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Create a context for deriving SLIP-77 blinding keys from a master blinding key.
+ *
+ * :param bytes: The master blinding key from `wally_asset_blinding_key_from_seed`.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be ``HMAC_SHA512_LEN`` or
+ *|    ``HMAC_SHA256_LEN``.
+ * :param output: Destination for the resulting context.
+ *
+ * .. note:: The context is an HMAC-SHA-256 context keyed with the master
+ *|    blinding key, so each key derived with it saves re-keying the HMAC.
+ *|    It should be freed with `wally_hmac_sha256_ctx_free`.
+ */
+WALLY_CORE_API int wally_asset_blinding_key_ctx_init_alloc(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    struct wally_hmac_sha256_ctx **output);
+
+/**
+ * As per `wally_asset_blinding_key_to_ec_private_key`, using a context from
+ * `wally_asset_blinding_key_ctx_init_alloc`.
+ */
+WALLY_CORE_API int wally_asset_blinding_key_ctx_to_ec_private_key(
+    const struct wally_hmac_sha256_ctx *ctx,
+    const unsigned char *script,
+    size_t script_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Derive the SLIP-77 blinding private keys of a batch of equal length scriptPubKeys.
+ *
+ * :param bytes: The master blinding key from `wally_asset_blinding_key_from_seed`.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be ``HMAC_SHA512_LEN`` or
+ *|    ``HMAC_SHA256_LEN``.
+ * :param scripts: The scriptPubKeys, stored contiguously.
+ * :param scripts_len: Length of ``scripts`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each scriptPubKey in bytes.
+ * :param bytes_out: Destination for the blinding private keys, each
+ *|    ``EC_PRIVATE_KEY_LEN`` bytes, in the order of ``scripts``.
+ * :param len: Size of ``bytes_out``. Must be ``EC_PRIVATE_KEY_LEN`` * the number of scripts.
+ *
+ * .. note:: The scriptPubKeys written by `wally_scripts_to_addresses` can be
+ *|    passed directly. The HMAC is keyed once and, where the CPU supports it,
+ *|    several scripts are hashed at once.
+ */
+WALLY_CORE_API int wally_asset_blinding_key_to_ec_private_key_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    size_t item_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/** An opaque parsed list of PAK (pegout authorization key) online and offline keys */
+struct wally_asset_pak_keys;
+
+/**
+ * Get the length of a PAK whitelist proof.
+ *
+ * :param num_keys: The number of online/offline key pairs in the PAK list,
+ *|    from 1 to 255.
+ * :param written: Destination for the length of the proof in bytes.
+ */
+WALLY_CORE_API int wally_asset_pak_whitelistproof_size(
+    size_t num_keys,
+    size_t *written);
+
+/**
+ * Create a PAK whitelist proof that a key is authorized for pegouts.
+ *
+ * :param online_keys: The compressed online public keys of the PAK list, concatenated.
+ * :param online_keys_len: Length of ``online_keys`` in bytes. Must be a
+ *|    multiple of ``EC_PUBLIC_KEY_LEN``.
+ * :param offline_keys: The compressed offline public keys of the PAK list, concatenated.
+ * :param offline_keys_len: Length of ``offline_keys`` in bytes. Must equal ``online_keys_len``.
+ * :param key_index: The index of the signer's key pair in the PAK list.
+ * :param sub_pubkey: The public key to whitelist.
+ * :param sub_pubkey_len: Length of ``sub_pubkey`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param online_priv_key: The private key of the signer's online public key.
+ * :param online_priv_key_len: Length of ``online_priv_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param summed_key: The private key of the sum of ``sub_pubkey`` and the
+ *|    signer's offline public key.
+ * :param summed_key_len: Length of ``summed_key`` in bytes. Must be ``EC_PRIVATE_KEY_LEN``.
+ * :param bytes_out: Destination for the resulting proof.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the proof. If ``len`` is too
+ *|    small, ``written`` contains the buffer size required, as given by
+ *|    `wally_asset_pak_whitelistproof_size`.
+ */
+WALLY_CORE_API int wally_asset_pak_whitelistproof(
+    const unsigned char *online_keys,
+    size_t online_keys_len,
+    const unsigned char *offline_keys,
+    size_t offline_keys_len,
+    size_t key_index,
+    const unsigned char *sub_pubkey,
+    size_t sub_pubkey_len,
+    const unsigned char *online_priv_key,
+    size_t online_priv_key_len,
+    const unsigned char *summed_key,
+    size_t summed_key_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Verify a PAK whitelist proof.
+ *
+ * :param online_keys: The compressed online public keys of the PAK list, concatenated.
+ * :param online_keys_len: Length of ``online_keys`` in bytes. Must be a
+ *|    multiple of ``EC_PUBLIC_KEY_LEN``.
+ * :param offline_keys: The compressed offline public keys of the PAK list, concatenated.
+ * :param offline_keys_len: Length of ``offline_keys`` in bytes. Must equal ``online_keys_len``.
+ * :param sub_pubkey: The whitelisted public key.
+ * :param sub_pubkey_len: Length of ``sub_pubkey`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param proof: The whitelist proof to verify.
+ * :param proof_len: Length of ``proof`` in bytes.
+ *
+ * .. note:: Returns ``WALLY_EINVAL`` if the proof is not valid.
+ */
+WALLY_CORE_API int wally_asset_pak_whitelistproof_verify(
+    const unsigned char *online_keys,
+    size_t online_keys_len,
+    const unsigned char *offline_keys,
+    size_t offline_keys_len,
+    const unsigned char *sub_pubkey,
+    size_t sub_pubkey_len,
+    const unsigned char *proof,
+    size_t proof_len);
+
+/**
+ * Parse a PAK list for verifying many whitelist proofs.
+ *
+ * :param online_keys: The compressed online public keys of the PAK list, concatenated.
+ * :param online_keys_len: Length of ``online_keys`` in bytes. Must be a
+ *|    multiple of ``EC_PUBLIC_KEY_LEN``.
+ * :param offline_keys: The compressed offline public keys of the PAK list, concatenated.
+ * :param offline_keys_len: Length of ``offline_keys`` in bytes. Must equal ``online_keys_len``.
+ * :param output: Destination for the resulting parsed PAK list.
+ *
+ * .. note:: The returned list should be freed with `wally_asset_pak_keys_free`.
+ */
+WALLY_CORE_API int wally_asset_pak_keys_init_alloc(
+    const unsigned char *online_keys,
+    size_t online_keys_len,
+    const unsigned char *offline_keys,
+    size_t offline_keys_len,
+    struct wally_asset_pak_keys **output);
+
+/**
+ * Free a parsed PAK list allocated by `wally_asset_pak_keys_init_alloc`.
+ *
+ * :param keys: The parsed PAK list to free.
+ */
+WALLY_CORE_API int wally_asset_pak_keys_free(
+    struct wally_asset_pak_keys *keys);
+
+/**
+ * As per `wally_asset_pak_whitelistproof_verify`, using a parsed PAK list.
+ */
+WALLY_CORE_API int wally_asset_pak_whitelistproof_verify_parsed(
+    const struct wally_asset_pak_keys *keys,
+    const unsigned char *sub_pubkey,
+    size_t sub_pubkey_len,
+    const unsigned char *proof,
+    size_t proof_len);
+
+/**
+ * Verify a batch of PAK whitelist proofs against a parsed PAK list.
+ *
+ * :param keys: The parsed PAK list from `wally_asset_pak_keys_init_alloc`.
+ * :param sub_pubkeys: The whitelisted public keys, one after another.
+ * :param sub_pubkeys_len: Length of ``sub_pubkeys`` in bytes. Must be
+ *|    ``EC_PUBLIC_KEY_LEN`` times the number of proofs.
+ * :param proofs: The whitelist proofs, one after another.
+ * :param proofs_len: Length of ``proofs`` in bytes. Must be the
+ *|    `wally_asset_pak_whitelistproof_size` of the list times the number of proofs.
+ * :param run_fn: Function to run verification of groups of proofs as
+ *|     separate tasks, for example on a thread pool. If NULL, proofs are
+ *|     verified in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param bytes_out: Destination for the verification result of each proof,
+ *|     1 if the proof is valid or 0 otherwise.
+ * :param len: Size of ``bytes_out`` in bytes, i.e. the number of proofs.
+ *
+ * .. note:: Returns ``WALLY_OK`` only if every proof is valid. Tasks use
+ *|    the libsecp256k1 context of the calling thread.
+ */
+WALLY_CORE_API int wally_asset_pak_whitelistproof_verify_batch(
+    const struct wally_asset_pak_keys *keys,
+    const unsigned char *sub_pubkeys,
+    size_t sub_pubkeys_len,
+    const unsigned char *proofs,
+    size_t proofs_len,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,226 @@
+#ifndef LIBWALLY_CORE_PSBT_H
+#define LIBWALLY_CORE_PSBT_H
+
+#include "wally_core.h"
+#include "wally_transaction.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WALLY_PSBT_MAP_GLOBAL 0 /** The global map of a PSBT */
+#define WALLY_PSBT_MAP_INPUT  1 /** The map of a PSBT input */
+#define WALLY_PSBT_MAP_OUTPUT 2 /** The map of a PSBT output */
+
+/* Global key types */
+#define WALLY_PSBT_GLOBAL_UNSIGNED_TX 0x00
+#define WALLY_PSBT_GLOBAL_XPUB        0x01
+#define WALLY_PSBT_GLOBAL_VERSION     0xfb
+
+/* Input key types */
+#define WALLY_PSBT_IN_NON_WITNESS_UTXO    0x00
+#define WALLY_PSBT_IN_WITNESS_UTXO        0x01
+#define WALLY_PSBT_IN_PARTIAL_SIG         0x02
+#define WALLY_PSBT_IN_SIGHASH_TYPE        0x03
+#define WALLY_PSBT_IN_REDEEM_SCRIPT       0x04
+#define WALLY_PSBT_IN_WITNESS_SCRIPT      0x05
+#define WALLY_PSBT_IN_BIP32_DERIVATION    0x06
+#define WALLY_PSBT_IN_FINAL_SCRIPTSIG     0x07
+#define WALLY_PSBT_IN_FINAL_SCRIPTWITNESS 0x08
+
+/* Output key types */
+#define WALLY_PSBT_OUT_REDEEM_SCRIPT    0x00
+#define WALLY_PSBT_OUT_WITNESS_SCRIPT   0x01
+#define WALLY_PSBT_OUT_BIP32_DERIVATION 0x02
+
+/** A key-value pair of a PSBT map. Pointers refer to the parsed bytes
+ * unless the pair was set with `wally_psbt_view_set_pair` */
+struct wally_psbt_pair {
+    uint64_t type;
+    const unsigned char *key; /* The whole key, starting with its type */
+    size_t key_len;
+    const unsigned char *key_data; /* The key following its type */
+    size_t key_data_len;
+    const unsigned char *value;
+    size_t value_len;
+};
+
+/** A BIP 174 PSBT parsed as ranges over its serialization */
+struct wally_psbt_view;
+
+/**
+ * Parse a serialized PSBT without copying its key-value maps.
+ *
+ * :param bytes: The serialized PSBT. Must remain valid and unchanged
+ *|    until the view is freed.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0.
+ * :param output: Destination for the resulting PSBT view.
+ *
+ * .. note:: Only the unsigned transaction is decoded. UTXOs, signatures
+ *|    and other values are returned as ranges of ``bytes`` and decoded
+ *|    by their getters when needed. Version 0 PSBTs are supported.
+ */
+WALLY_CORE_API int wally_psbt_view_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_psbt_view **output);
+
+/**
+ * Free a PSBT view allocated by `wally_psbt_view_from_bytes`.
+ *
+ * :param view: The PSBT view to free.
+ */
+WALLY_CORE_API int wally_psbt_view_free(
+    struct wally_psbt_view *view);
+
+/**
+ * Get the unsigned transaction of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param output: Destination for the unsigned transaction. It is owned
+ *|    by the view and is valid until the view is freed.
+ */
+WALLY_CORE_API int wally_psbt_view_get_tx(
+    const struct wally_psbt_view *view,
+    const struct wally_tx **output);
+
+/**
+ * Get the number of key-value pairs in a map of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param map: ``WALLY_PSBT_MAP_GLOBAL``, ``WALLY_PSBT_MAP_INPUT`` or
+ *|    ``WALLY_PSBT_MAP_OUTPUT``.
+ * :param index: The index of the input or output. Must be 0 for the global map.
+ * :param written: Destination for the number of pairs in the map.
+ */
+WALLY_CORE_API int wally_psbt_view_get_num_pairs(
+    const struct wally_psbt_view *view,
+    uint32_t map,
+    size_t index,
+    size_t *written);
+
+/**
+ * Get a key-value pair from a map of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param map: ``WALLY_PSBT_MAP_GLOBAL``, ``WALLY_PSBT_MAP_INPUT`` or
+ *|    ``WALLY_PSBT_MAP_OUTPUT``.
+ * :param index: The index of the input or output. Must be 0 for the global map.
+ * :param pair_index: The index of the pair in the map.
+ * :param output: Destination for the pair. It is valid until the map
+ *|    is changed or the view is freed.
+ */
+WALLY_CORE_API int wally_psbt_view_get_pair(
+    const struct wally_psbt_view *view,
+    uint32_t map,
+    size_t index,
+    size_t pair_index,
+    const struct wally_psbt_pair **output);
+
+/**
+ * Find a key-value pair in a map of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param map: ``WALLY_PSBT_MAP_GLOBAL``, ``WALLY_PSBT_MAP_INPUT`` or
+ *|    ``WALLY_PSBT_MAP_OUTPUT``.
+ * :param index: The index of the input or output. Must be 0 for the global map.
+ * :param type: The key type to find, e.g. ``WALLY_PSBT_IN_PARTIAL_SIG``.
+ * :param key_data: The key following its type, e.g. the public key of a
+ *|    partial signature.
+ * :param key_data_len: Size of ``key_data`` in bytes.
+ * :param written: Destination for the index of the pair, or the number of
+ *|    pairs in the map if it has no pair with the given key.
+ */
+WALLY_CORE_API int wally_psbt_view_find_pair(
+    const struct wally_psbt_view *view,
+    uint32_t map,
+    size_t index,
+    uint32_t type,
+    const unsigned char *key_data,
+    size_t key_data_len,
+    size_t *written);
+
+/**
+ * Add or replace a key-value pair in a map of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param map: ``WALLY_PSBT_MAP_GLOBAL``, ``WALLY_PSBT_MAP_INPUT`` or
+ *|    ``WALLY_PSBT_MAP_OUTPUT``.
+ * :param index: The index of the input or output. Must be 0 for the global map.
+ * :param key: The whole key, starting with its type.
+ * :param key_len: Size of ``key`` in bytes.
+ * :param value: The value to set.
+ * :param value_len: Size of ``value`` in bytes.
+ *
+ * .. note:: The key and value are copied. A pair with the same key is
+ *|    replaced in place, otherwise the pair is appended to the map. The
+ *|    unsigned transaction cannot be replaced.
+ */
+WALLY_CORE_API int wally_psbt_view_set_pair(
+    struct wally_psbt_view *view,
+    uint32_t map,
+    size_t index,
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *value,
+    size_t value_len);
+
+/**
+ * Remove a key-value pair from a map of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param map: ``WALLY_PSBT_MAP_GLOBAL``, ``WALLY_PSBT_MAP_INPUT`` or
+ *|    ``WALLY_PSBT_MAP_OUTPUT``.
+ * :param index: The index of the input or output. Must be 0 for the global map.
+ * :param pair_index: The index of the pair to remove. The unsigned
+ *|    transaction cannot be removed.
+ */
+WALLY_CORE_API int wally_psbt_view_remove_pair(
+    struct wally_psbt_view *view,
+    uint32_t map,
+    size_t index,
+    size_t pair_index);
+
+/**
+ * Get the value of the UTXO spent by an input of a PSBT view.
+ *
+ * :param view: The PSBT view.
+ * :param index: The index of the input.
+ * :param value_out: Destination for the value in satoshi.
+ *
+ * .. note:: The witness UTXO is used if present. Otherwise the non-witness
+ *|    UTXO is decoded, after checking that its txid matches the outpoint
+ *|    the input spends. Returns WALLY_EINVAL if the input has neither.
+ */
+WALLY_CORE_API int wally_psbt_view_get_input_satoshi(
+    const struct wally_psbt_view *view,
+    size_t index,
+    uint64_t *value_out);
+
+/**
+ * Serialize a PSBT view.
+ *
+ * :param view: The PSBT view to serialize.
+ * :param flags: Must be 0.
+ * :param bytes_out: Destination for the serialized PSBT.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the serialized PSBT.
+ *
+ * .. note:: Maps that have not been changed are copied from the parsed
+ *|    bytes unmodified. If ``len`` is too small, ``written`` contains the
+ *|    buffer size required.
+ */
+WALLY_CORE_API int wally_psbt_view_to_bytes(
+    const struct wally_psbt_view *view,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBWALLY_CORE_PSBT_H */
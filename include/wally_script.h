@@ -33,6 +33,7 @@ extern "C" {
 #define WALLY_SCRIPT_HASH160  0x1 /** hash160 input bytes before using them */
 #define WALLY_SCRIPT_SHA256   0x2 /** sha256 input bytes before using them */
 #define WALLY_SCRIPT_AS_PUSH  0x4 /** Return a push of the generated script */
+#define WALLY_SCRIPT_MULTISIG_SORTED 0x8 /** Sort public keys (BIP67) */
 
 /* Script opcodes */
 #define OP_0 0x00
@@ -288,7 +289,8 @@ WALLY_CORE_API int wally_scriptpubkey_p2sh_from_bytes(
  * :param bytes: Compressed public keys to create a scriptPubkey from.
  * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``EC_PUBLIC_KEY_LEN``.
  * :param threshold: The number of signatures that must match to satisfy the script.
- * :param flags: Must be zero.
+ * :param flags: Must be ``WALLY_SCRIPT_MULTISIG_SORTED`` to sort the keys
+ *|    lexicographically as per BIP67, or 0 to use them in the order given.
  * :param bytes_out: Destination for the resulting scriptPubkey.
  * :param len: The length of ``bytes_out`` in bytes.
  * :param written: Destination for the number of bytes written to ``bytes_out``.
@@ -328,6 +330,33 @@ WALLY_CORE_API int wally_scriptsig_multisig_from_bytes(
     size_t len,
     size_t *written);
 
+/**
+ * Create a multisig scriptSig from DER signatures plus sighash.
+ *
+ * :param script: The redeem script this scriptSig provides signatures for.
+ * :param script_len: The length of ``script`` in bytes.
+ * :param bytes: The concatenated DER encoded signatures to place in the
+ *|    scriptSig, each with its sighash byte appended to it.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param lens: The length of each signature in ``bytes``.
+ * :param lens_len: The number of signatures in ``bytes``.
+ * :param flags: Must be zero.
+ * :param bytes_out: Destination for the resulting scriptSig.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_scriptsig_multisig_from_der(
+    const unsigned char *script,
+    size_t script_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const uint32_t *lens,
+    size_t lens_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
 /**
  * Create a CSV 2of2 multisig with a single key recovery scriptPubkey.
  *
@@ -422,6 +451,326 @@ WALLY_CORE_API int wally_witness_program_from_bytes(
     size_t len,
     size_t *written);
 
+/**
+ * Create a serialized P2WPKH witness from a pubkey and compact signature.
+ *
+ * The witness is written as it appears in a serialized transaction: the
+ * number of items, followed by the DER encoded signature with ``sighash``
+ * appended and then ``pub_key``, each prefixed with its length. This
+ * allows building a signed transaction without allocating a witness stack.
+ *
+ * :param pub_key: The public key to create a witness with.
+ * :param pub_key_len: Length of ``pub_key`` in bytes. Must be ``EC_PUBLIC_KEY_LEN``.
+ * :param sig: The compact signature to create a witness with.
+ * :param sig_len: The length of ``sig`` in bytes. Must be ``EC_SIGNATURE_LEN``.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param bytes_out: Destination for the resulting witness.
+ * :param len: The length of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_witness_p2wpkh_from_sig(
+    const unsigned char *pub_key,
+    size_t pub_key_len,
+    const unsigned char *sig,
+    size_t sig_len,
+    uint32_t sighash,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+#ifndef SWIG
+/**
+ * Create scriptPubkeys and addresses for a batch of equal length redeem scripts.
+ *
+ * :param bytes: The redeem scripts, stored contiguously.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``item_len``.
+ * :param item_len: The length of each redeem script in bytes.
+ * :param script_type: ``WALLY_SCRIPT_TYPE_P2SH`` for P2SH, ``WALLY_SCRIPT_TYPE_P2WSH``
+ *|    for P2WSH, or both OR-ed together for P2SH wrapped P2WSH.
+ * :param addr_family: Address family to generate P2WSH addresses for,
+ *|    e.g. "bc" or "tb". Ignored if ``script_type`` includes ``WALLY_SCRIPT_TYPE_P2SH``.
+ * :param version: Version byte to generate P2SH addresses with, e.g. 0x05, 0xc4.
+ *|    Ignored if ``script_type`` is ``WALLY_SCRIPT_TYPE_P2WSH``.
+ * :param flags: Must be zero.
+ * :param bytes_out: Destination for the resulting scriptPubkeys, stored
+ *|    contiguously, or NULL if only the addresses are required.
+ * :param len: The length of ``bytes_out`` in bytes. Must be the number of
+ *|    scripts times ``WALLY_SCRIPTPUBKEY_P2SH_LEN`` for P2SH types, times
+ *|    ``WALLY_SCRIPTPUBKEY_P2WSH_LEN`` for P2WSH, or 0 if ``bytes_out`` is NULL.
+ * :param output: Destination for the resulting addresses. Each address is NUL
+ *|    terminated and immediately follows the previous one.
+ * :param output_len: The length of ``output`` in bytes.
+ * :param written: Destination for the total length of the addresses including
+ *|    their NUL terminators. If ``output_len`` is too small, ``written`` contains
+ *|    the buffer size required and the contents of ``output`` are undefined.
+ *
+ * .. note:: Where the CPU supports it, several scripts are hashed at once.
+ */
+WALLY_CORE_API int wally_scripts_to_addresses(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t item_len,
+    uint32_t script_type,
+    const char *addr_family,
+    uint32_t version,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    char *output,
+    size_t output_len,
+    size_t *written);
+
+/** An iterator over the opcodes of a script */
+struct wally_script_iterator {
+    const unsigned char *bytes; /* The script being iterated */
+    size_t bytes_len;
+    size_t offset; /* The position of the next opcode in ``bytes`` */
+    unsigned char opcode; /* The current opcode */
+    const unsigned char *push; /* The data pushed by the current opcode */
+    size_t push_len;
+};
+
+/**
+ * Initialize an iterator over the opcodes of a script.
+ *
+ * :param iter: The iterator to initialize.
+ * :param bytes: The script to iterate. Must remain valid while ``iter`` is used.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ *
+ * .. note:: The iterator does not allocate memory and need not be freed.
+ */
+WALLY_CORE_API int wally_script_iterator_init(
+    struct wally_script_iterator *iter,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Advance a script iterator to the next opcode.
+ *
+ * :param iter: The iterator to advance.
+ * :param written: Destination for 1 if ``iter`` now holds the next opcode,
+ *|    or 0 if the end of the script has been reached.
+ *
+ * .. note:: For push opcodes, ``iter->push`` points to the pushed data
+ *|    within the script and ``iter->push_len`` gives its length. For other
+ *|    opcodes and empty pushes, ``iter->push`` is NULL and ``iter->push_len``
+ *|    is 0. ``WALLY_EINVAL`` is returned if a push extends past the end of
+ *|    the script, in which case the iterator is not advanced.
+ */
+WALLY_CORE_API int wally_script_iterator_next(
+    struct wally_script_iterator *iter,
+    size_t *written);
+
+/** Grow the buffer of a `wally_script_writer` as the script is written */
+#define WALLY_SCRIPT_WRITER_FLAG_GROW 0x1
+
+/** A writer appending opcodes and pushes to a script */
+struct wally_script_writer {
+    unsigned char *bytes; /* The buffer the script is written to */
+    size_t len; /* The capacity of ``bytes`` in bytes */
+    size_t written; /* The length of the script, which may exceed ``len`` */
+    uint32_t flags;
+};
+
+/**
+ * Initialize a writer for building a script.
+ *
+ * :param writer: The writer to initialize.
+ * :param bytes_out: The buffer to write the script to, or NULL if
+ *|    ``WALLY_SCRIPT_WRITER_FLAG_GROW`` is given.
+ * :param len: The length of ``bytes_out`` in bytes, or the initial capacity
+ *|    to allocate if ``WALLY_SCRIPT_WRITER_FLAG_GROW`` is given.
+ * :param flags: ``WALLY_SCRIPT_WRITER_FLAG_GROW`` to allocate the buffer
+ *|    and grow it as required, or 0 to write to ``bytes_out``.
+ *
+ * .. note:: If the script written is longer than a caller provided buffer,
+ *|    the items that do not fit are not written. ``writer->written`` then
+ *|    gives the buffer size required and the contents of ``bytes_out``
+ *|    are undefined. A writer that grows its buffer must be freed using
+ *|    `wally_script_writer_free`.
+ */
+WALLY_CORE_API int wally_script_writer_init(
+    struct wally_script_writer *writer,
+    unsigned char *bytes_out,
+    size_t len,
+    uint32_t flags);
+
+/**
+ * Free the buffer allocated by a script writer, if any.
+ *
+ * :param writer: The writer to free.
+ */
+WALLY_CORE_API int wally_script_writer_free(
+    struct wally_script_writer *writer);
+
+/**
+ * Append a single opcode to a script.
+ *
+ * :param writer: The writer to append to.
+ * :param opcode: The opcode to append. Must be at most 0xff.
+ */
+WALLY_CORE_API int wally_script_writer_add_opcode(
+    struct wally_script_writer *writer,
+    uint32_t opcode);
+
+/**
+ * Append raw bytes, such as an existing script, to a script.
+ *
+ * :param writer: The writer to append to.
+ * :param bytes: The bytes to append.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ */
+WALLY_CORE_API int wally_script_writer_add_bytes(
+    struct wally_script_writer *writer,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Append a push of some data to a script.
+ *
+ * :param writer: The writer to append to.
+ * :param bytes: The data to push.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: ``WALLY_SCRIPT_HASH160`` or ``WALLY_SCRIPT_SHA256`` to
+ *|    hash ``bytes`` before pushing it, or 0.
+ *
+ * .. note:: The push is encoded as by `wally_script_push_from_bytes`.
+ */
+WALLY_CORE_API int wally_script_writer_add_push(
+    struct wally_script_writer *writer,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags);
+
+/**
+ * Append a number to a script, using its minimal encoding.
+ *
+ * :param writer: The writer to append to.
+ * :param value: The number to append.
+ *
+ * .. note:: ``0``, ``-1`` and ``1`` to ``16`` are written as their
+ *|    ``OP_0``, ``OP_1NEGATE`` and ``OP_1`` to ``OP_16`` opcodes. Other
+ *|    values are pushed as little-endian sign-magnitude script numbers.
+ */
+WALLY_CORE_API int wally_script_writer_add_int(
+    struct wally_script_writer *writer,
+    int64_t value);
+#endif /* SWIG */
+
+struct wally_script_watchset;
+struct wally_tx;
+
+/**
+ * Allocate an empty set of scripts to watch for in transaction outputs.
+ *
+ * :param allocation_len: The number of scripts to pre-allocate space for.
+ * :param flags: ``WALLY_SCRIPT_HASH160`` or ``WALLY_SCRIPT_SHA256`` to
+ *|    store the hash of each script instead of the script itself, or 0.
+ * :param output: Destination for the resulting watch set.
+ *
+ * .. note:: Storing hashes uses a fixed amount of memory per script, but
+ *|    each script looked up must then be hashed.
+ */
+WALLY_CORE_API int wally_script_watchset_init_alloc(
+    size_t allocation_len,
+    uint32_t flags,
+    struct wally_script_watchset **output);
+
+/**
+ * Free a watch set allocated by `wally_script_watchset_init_alloc`.
+ *
+ * :param set: The watch set to free.
+ */
+WALLY_CORE_API int wally_script_watchset_free(
+    struct wally_script_watchset *set);
+
+/**
+ * Add a script to a watch set.
+ *
+ * :param set: The watch set to add to.
+ * :param bytes: The script to add.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must not be zero.
+ *
+ * .. note:: Adding a script already in the set has no effect.
+ */
+WALLY_CORE_API int wally_script_watchset_add(
+    struct wally_script_watchset *set,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Add a number of scripts to a watch set.
+ *
+ * :param set: The watch set to add to.
+ * :param bytes: The scripts to add, concatenated.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param lens: The length of each script in ``bytes``. Each length must
+ *|    be non-zero, and the lengths must sum to ``bytes_len``.
+ * :param lens_len: The number of scripts in ``bytes``.
+ *
+ * .. note:: Either all of the scripts are added, or none are.
+ */
+WALLY_CORE_API int wally_script_watchset_add_scripts(
+    struct wally_script_watchset *set,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const uint32_t *lens,
+    size_t lens_len);
+
+/**
+ * Determine whether a script is in a watch set.
+ *
+ * :param set: The watch set to search.
+ * :param bytes: The script to look up.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param written: Destination for 1 if the script is in the set, otherwise 0.
+ */
+WALLY_CORE_API int wally_script_watchset_contains(
+    const struct wally_script_watchset *set,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t *written);
+
+#ifndef SWIG
+struct wally_tx_view;
+
+/**
+ * Find the outputs of a transaction whose scripts are in a watch set.
+ *
+ * :param set: The watch set to search.
+ * :param tx: The transaction to match the outputs of.
+ * :param indices_out: Destination for the indices of the matching outputs,
+ *|    in output order.
+ * :param len: The number of indices ``indices_out`` can hold.
+ * :param written: Destination for the number of matching outputs. If this
+ *|    is greater than ``len``, only the first ``len`` indices are written.
+ */
+WALLY_CORE_API int wally_script_watchset_match_tx(
+    const struct wally_script_watchset *set,
+    const struct wally_tx *tx,
+    uint32_t *indices_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Find the outputs of a transaction view whose scripts are in a watch set.
+ *
+ * :param set: The watch set to search.
+ * :param view: The transaction view to match the outputs of.
+ * :param indices_out: Destination for the indices of the matching outputs,
+ *|    in output order.
+ * :param len: The number of indices ``indices_out`` can hold.
+ * :param written: Destination for the number of matching outputs. If this
+ *|    is greater than ``len``, only the first ``len`` indices are written.
+ */
+WALLY_CORE_API int wally_script_watchset_match_tx_view(
+    const struct wally_script_watchset *set,
+    const struct wally_tx_view *view,
+    uint32_t *indices_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
 #ifdef __cplusplus
 }
 #endif
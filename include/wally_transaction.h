@@ -15,21 +15,50 @@ extern "C" {
 #define WALLY_TX_IS_ISSUANCE 2
 #define WALLY_TX_IS_PEGIN 4
 #define WALLY_TX_IS_COINBASE 8
+#define WALLY_TX_PROOFS_REFERENCED 16 /* Proofs point into the bytes the tx was decoded from */
+#define WALLY_TX_READ_ONLY 32 /* Part of a read-only clone, which may not be modified */
 
 #define WALLY_SATOSHI_PER_BTC 100000000
 #define WALLY_BTC_MAX 21000000
 
 #define WALLY_TXHASH_LEN 32 /** Size of a transaction hash in bytes */
+#define WALLY_BLOCK_HEADER_LEN 80 /** Size of a serialized block header in bytes */
+#define WALLY_BIP152_SHORT_ID_LEN 6 /** Size of a BIP 152 short transaction id in bytes */
+#define WALLY_BIP152_NO_MATCH 0xffffffff /** Index for a short id with no unique match */
+#define WALLY_TX_IOVEC_REF_LEN 128 /** Scripts and witness items this long are referenced by wally_tx_to_iovecs */
+#define WALLY_TX_SIGHASH_CTX_LEN 106 /** Size of a serialized BTC sighash context in bytes */
+#define WALLY_TX_SIGHASH_CTX_ELEMENTS_LEN 138 /** Size of a serialized Elements sighash context in bytes */
+
+/** Network magic values prefixing blocks in block files, as little endian integers */
+#define WALLY_NETWORK_MAGIC_MAINNET  0xd9b4bef9
+#define WALLY_NETWORK_MAGIC_TESTNET  0x0709110b
+#define WALLY_NETWORK_MAGIC_TESTNET4 0x283f161c
+#define WALLY_NETWORK_MAGIC_SIGNET   0x40cf030a
+#define WALLY_NETWORK_MAGIC_REGTEST  0xdab5bffa
 
 #define WALLY_TX_FLAG_USE_WITNESS  0x1 /* Encode witness data if present */
 #define WALLY_TX_FLAG_USE_ELEMENTS 0x2 /* Encode/Decode as an elements transaction */
+#define WALLY_TX_FLAG_SKIP_WITNESS_DECODE 0x4 /* Decode: validate but don't decode witness stacks */
+#define WALLY_TX_FLAG_REFERENCE_PROOFS 0x8 /* Decode: reference elements proofs in place */
 
 #define WALLY_TX_FLAG_BLINDED_INITIAL_ISSUANCE 0x1
 
+#define WALLY_TX_CLONE_READ_ONLY 0x1 /* Clone into a single read-only allocation */
+
 #define WALLY_TX_DUMMY_NULL 0x1 /* An empty witness item */
 #define WALLY_TX_DUMMY_SIG  0x2 /* A dummy signature */
 #define WALLY_TX_DUMMY_SIG_LOW_R  0x4 /* A dummy signature created with EC_FLAG_GRIND_R */
 
+#define WALLY_COINSELECT_BNB      0x1 /* Branch and bound search for a changeless selection */
+#define WALLY_COINSELECT_KNAPSACK 0x2 /* Knapsack selection leaving change */
+
+#define WALLY_UTXO_RECORD_LEN 80 /** Size of a UTXO snapshot record in bytes */
+#define WALLY_UTXO_SNAPSHOT_HEADER_LEN 16 /** Size of a UTXO snapshot header in bytes */
+#define WALLY_UTXO_FLAG_SKIP_UNSUPPORTED 0x1 /* Skip coins with scripts records can't hold */
+#define WALLY_UTXO_FLAG_COINS_BY_TXID 0x2 /* Coins are grouped by txid, as in dumptxoutset v2 */
+
+#define WALLY_TX_SET_WTXID 0x1 /* Look up transactions in a set by wtxid */
+
 /** Sighash flags for transaction signing */
 #define WALLY_SIGHASH_ALL          0x01
 #define WALLY_SIGHASH_NONE         0x02
@@ -59,6 +88,7 @@ extern "C" {
 struct wally_tx_input;
 struct wally_tx_output;
 struct wally_tx;
+struct wally_tx_sighash_ctx;
 #else
 /** A transaction witness item */
 struct wally_tx_witness_item {
@@ -128,6 +158,106 @@ struct wally_tx {
     size_t num_outputs;
     size_t outputs_allocation_len;
 };
+
+/** Precomputed BIP 143 hashes for signing the inputs of a transaction */
+struct wally_tx_sighash_ctx {
+    unsigned char hash_prevouts[SHA256_LEN];
+    unsigned char hash_sequence[SHA256_LEN];
+    unsigned char hash_outputs[SHA256_LEN];
+#ifdef BUILD_ELEMENTS
+    unsigned char hash_issuances[SHA256_LEN];
+#endif /* BUILD_ELEMENTS */
+    size_t num_inputs;
+    size_t num_outputs;
+    size_t is_elements;
+};
+
+/** A caller-owned memory arena for allocating transactions from */
+struct wally_tx_arena {
+    unsigned char *bytes;
+    size_t len;
+    size_t used;
+};
+
+/** A segment of a serialized transaction. Its layout matches the POSIX
+ *  ``struct iovec``, so arrays of segments can be passed to ``writev`` */
+struct wally_tx_iovec {
+    const void *iov_base;
+    size_t iov_len;
+};
+
+/** A parsed bitcoin block header */
+struct wally_block_header {
+    uint32_t version;
+    unsigned char prev_block_hash[SHA256_LEN];
+    unsigned char merkle_root[SHA256_LEN];
+    uint32_t timestamp;
+    uint32_t bits;
+    uint32_t nonce;
+};
+
+/** An iterator over the transactions in a serialized block */
+struct wally_block_iterator {
+    const unsigned char *bytes;
+    size_t bytes_len;
+    size_t offset;
+    size_t num_txs;
+    size_t index;
+};
+
+/** An input of a transaction view. Pointers refer to the viewed bytes */
+struct wally_tx_view_input {
+    const unsigned char *txhash;
+    uint32_t index;
+    uint32_t sequence;
+    const unsigned char *script;
+    size_t script_len;
+    const unsigned char *witness; /* Serialized witness items, or NULL */
+    size_t num_witness_items;
+};
+
+/** An output of a transaction view. Pointers refer to the viewed bytes */
+struct wally_tx_view_output {
+    uint64_t satoshi;
+    const unsigned char *script;
+    size_t script_len;
+};
+
+/** A read-only view of a serialized bitcoin transaction */
+struct wally_tx_view {
+    const unsigned char *bytes;
+    size_t bytes_len;
+    uint32_t version;
+    uint32_t locktime;
+    struct wally_tx_view_input *inputs;
+    size_t num_inputs;
+    struct wally_tx_view_output *outputs;
+    size_t num_outputs;
+};
+
+/**
+ * A batch of bitcoin transactions decoded into contiguous columns.
+ *
+ * The inputs of transaction ``i`` are at indices ``input_offsets[i]`` to
+ * ``input_offsets[i + 1] - 1`` of the input columns, and likewise for
+ * outputs. The script of output ``i`` is ``scripts + script_offsets[i]``,
+ * with length ``script_offsets[i + 1] - script_offsets[i]``.
+ */
+struct wally_tx_batch {
+    size_t num_txs;
+    uint32_t *versions;
+    uint32_t *locktimes;
+    size_t *input_offsets; /* num_txs + 1 entries */
+    size_t *output_offsets; /* num_txs + 1 entries */
+    size_t num_inputs;
+    unsigned char *prevout_txhashes; /* num_inputs * WALLY_TXHASH_LEN bytes */
+    uint32_t *prevout_indices;
+    uint32_t *sequences;
+    size_t num_outputs;
+    uint64_t *satoshis;
+    size_t *script_offsets; /* num_outputs + 1 entries */
+    unsigned char *scripts;
+};
 #endif /* SWIG */
 
 /**
@@ -162,6 +292,16 @@ WALLY_CORE_API int wally_tx_witness_stack_add_dummy(
     struct wally_tx_witness_stack *stack,
     uint32_t flags);
 
+/**
+ * Ensure a witness stack can hold a number of items without reallocating.
+ *
+ * :param stack: The witness stack to reserve space in.
+ * :param num_items: The number of items to reserve space for.
+ */
+WALLY_CORE_API int wally_tx_witness_stack_reserve(
+    struct wally_tx_witness_stack *stack,
+    size_t num_items);
+
 /**
  * Set a witness item to a witness stack.
  *
@@ -269,6 +409,80 @@ WALLY_CORE_API int wally_tx_init_alloc(
     size_t outputs_allocation_len,
     struct wally_tx **output);
 
+/**
+ * Create a deep copy of a transaction.
+ *
+ * :param tx: The transaction to clone.
+ * :param flags: Flags controlling cloning, ``WALLY_TX_CLONE_READ_ONLY`` or 0.
+ * :param output: Destination for the resulting transaction.
+ *
+ * .. note:: The clone is independent of ``tx`` and must be freed with
+ *|    `wally_tx_free`. Its input and output arrays are allocated at
+ *|    exactly the size required to hold the inputs and outputs of ``tx``.
+ *|    If ``WALLY_TX_CLONE_READ_ONLY`` is given, the clone and all of its
+ *|    data are copied into one allocation, and it is immutable: functions
+ *|    that would modify it, its inputs, outputs or witness stacks fail with
+ *|    ``WALLY_EINVAL``, and its inputs and outputs have
+ *|    ``WALLY_TX_READ_ONLY`` set in their ``features``. A read-only clone
+ *|    can be shared with `wally_tx_share`. Call `wally_tx_unshare` to get a
+ *|    copy that can be modified.
+ */
+WALLY_CORE_API int wally_tx_clone(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    struct wally_tx **output);
+
+#ifndef SWIG
+/**
+ * Share a read-only transaction with another owner without copying it.
+ *
+ * :param tx: The transaction to share, which must have been cloned with
+ *|    ``WALLY_TX_CLONE_READ_ONLY``.
+ * :param output: Destination for the shared transaction, which is ``tx``.
+ *|    Each owner must free it with `wally_tx_free`.
+ *
+ * .. note:: A read-only transaction can be read, shared and freed from
+ *|    several threads at once. Call `wally_tx_unshare` to get a copy that
+ *|    can be modified.
+ */
+WALLY_CORE_API int wally_tx_share(
+    struct wally_tx *tx,
+    struct wally_tx **output);
+
+/**
+ * Make a transaction modifiable, copying it if it is read-only.
+ *
+ * :param tx: The transaction to unshare. If it was cloned with
+ *|    ``WALLY_TX_CLONE_READ_ONLY``, it is replaced by a deep copy, and the
+ *|    caller's ownership of the original is released. Otherwise it is left
+ *|    unchanged.
+ */
+WALLY_CORE_API int wally_tx_unshare(
+    struct wally_tx **tx);
+
+/**
+ * Determine if a read-only transaction is shared by more than one owner.
+ *
+ * :param tx: The transaction to check.
+ * :param written: Destination for 1 if ``tx`` is shared, otherwise 0.
+ */
+WALLY_CORE_API int wally_tx_is_shared(
+    const struct wally_tx *tx,
+    size_t *written);
+#endif /* SWIG */
+
+/**
+ * Ensure a transaction can hold a number of inputs and outputs without reallocating.
+ *
+ * :param tx: The transaction to reserve space in.
+ * :param num_inputs: The number of inputs to reserve space for.
+ * :param num_outputs: The number of outputs to reserve space for.
+ */
+WALLY_CORE_API int wally_tx_reserve(
+    struct wally_tx *tx,
+    size_t num_inputs,
+    size_t num_outputs);
+
 /**
  * Add a transaction input to a transaction.
  *
@@ -314,6 +528,22 @@ WALLY_CORE_API int wally_tx_remove_input(
     struct wally_tx *tx,
     size_t index);
 
+/**
+ * Remove multiple transaction inputs from a transaction.
+ *
+ * :param tx: The transaction to remove the inputs from.
+ * :param indices: The zero-based indices of the inputs to remove, in
+ *|     strictly increasing order.
+ * :param indices_len: The number of indices in ``indices``.
+ *
+ * .. note:: The remaining inputs are compacted in a single pass and the
+ *|    input array is not reallocated.
+ */
+WALLY_CORE_API int wally_tx_remove_inputs(
+    struct wally_tx *tx,
+    const uint32_t *indices,
+    size_t indices_len);
+
 /**
  * Set the scriptsig for an input in a transaction.
  *
@@ -377,6 +607,111 @@ WALLY_CORE_API int wally_tx_remove_output(
     struct wally_tx *tx,
     size_t index);
 
+/**
+ * Remove all transaction outputs not selected by a mask from a transaction.
+ *
+ * :param tx: The transaction to remove the outputs from.
+ * :param mask: One byte per output, non-zero to keep the output or zero
+ *|     to remove it.
+ * :param mask_len: Length of ``mask`` in bytes. Must equal the number of outputs.
+ *
+ * .. note:: The remaining outputs are compacted in a single pass and the
+ *|    output array is not reallocated.
+ */
+WALLY_CORE_API int wally_tx_retain_outputs(
+    struct wally_tx *tx,
+    const unsigned char *mask,
+    size_t mask_len);
+
+#ifndef SWIG
+/** Hash indexes of the outpoints and output scripts of a transaction */
+struct wally_tx_index;
+
+/**
+ * Allocate an index of the input outpoints and output scripts of a transaction.
+ *
+ * :param tx: The transaction to index.
+ * :param flags: Flags controlling index creation. Must be 0.
+ * :param output: Destination for the resulting index.
+ *|    The index returned should be freed using `wally_tx_index_free`.
+ *
+ * .. note:: The index does not reference ``tx``, and is not changed when
+ *|    ``tx`` is. Call `wally_tx_index_update` after inputs or outputs are
+ *|    added or removed. Outpoints or scripts changed in place are not found
+ *|    until a new index is allocated.
+ */
+WALLY_CORE_API int wally_tx_index_init_alloc(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    struct wally_tx_index **output);
+
+/**
+ * Update an index after inputs or outputs are added to or removed from a transaction.
+ *
+ * :param index: The index to update.
+ * :param tx: The transaction that ``index`` was allocated for.
+ *
+ * Appended inputs and outputs are added to the index. If any were removed,
+ * the index is rebuilt.
+ */
+WALLY_CORE_API int wally_tx_index_update(
+    struct wally_tx_index *index,
+    const struct wally_tx *tx);
+
+/**
+ * Free an index allocated by `wally_tx_index_init_alloc`.
+ *
+ * :param index: The index to free.
+ */
+WALLY_CORE_API int wally_tx_index_free(
+    struct wally_tx_index *index);
+
+/**
+ * Find the input of a transaction that spends an outpoint.
+ *
+ * :param tx: The transaction to search.
+ * :param index: An index of ``tx`` from `wally_tx_index_init_alloc`, or
+ *|    NULL to search ``tx`` linearly.
+ * :param txhash: The transaction hash of the outpoint.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param utxo_index: The output index of the outpoint.
+ * :param written: Destination for the index of the first input spending
+ *|    the outpoint, or the number of inputs in ``tx`` if none spends it.
+ *
+ * .. note:: Inputs found using ``index`` are checked against ``tx``, so an
+ *|    out of date index never returns an input that does not spend the
+ *|    outpoint, but may fail to find one that does.
+ */
+WALLY_CORE_API int wally_tx_find_input_by_outpoint(
+    const struct wally_tx *tx,
+    const struct wally_tx_index *index,
+    const unsigned char *txhash,
+    size_t txhash_len,
+    uint32_t utxo_index,
+    size_t *written);
+
+/**
+ * Find the output of a transaction that pays to a script.
+ *
+ * :param tx: The transaction to search.
+ * :param index: An index of ``tx`` from `wally_tx_index_init_alloc`, or
+ *|    NULL to search ``tx`` linearly.
+ * :param script: The scriptPubKey to find.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param written: Destination for the index of the first output paying
+ *|    to ``script``, or the number of outputs in ``tx`` if none pays to it.
+ *
+ * .. note:: Outputs found using ``index`` are checked against ``tx``, as
+ *|    for `wally_tx_find_input_by_outpoint`.
+ */
+WALLY_CORE_API int wally_tx_find_output_by_script(
+    const struct wally_tx *tx,
+    const struct wally_tx_index *index,
+    const unsigned char *script,
+    size_t script_len,
+    size_t *written);
+#endif /* SWIG */
+
 /**
  * Get the number of inputs in a transaction that have witness data.
  *
@@ -392,6 +727,10 @@ WALLY_CORE_API int wally_tx_get_witness_count(
  * Free a transaction allocated by `wally_tx_init_alloc`.
  *
  * :param tx: The transaction to free.
+ *
+ * .. note:: If ``tx`` is a shared read-only clone, this releases the
+ *|    caller's ownership of it, and it is only freed when its last owner
+ *|    frees it.
  */
 WALLY_CORE_API int wally_tx_free(struct wally_tx *tx);
 #endif /* SWIG_PYTHON */
@@ -415,6 +754,21 @@ WALLY_CORE_API int wally_tx_get_length(
  * :param bytes_len: Length of ``bytes`` in bytes.
  * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
  * :param output: Destination for the resulting transaction.
+ *
+ * .. note:: If ``flags`` includes WALLY_TX_FLAG_SKIP_WITNESS_DECODE, witness
+ *|    data is validated but not decoded, and each input's ``witness`` is left
+ *|    NULL. The resulting transaction has the txid of the serialized one, but
+ *|    is serialized, measured and hashed as if it had no witness data. Use
+ *|    `wally_tx_from_bytes_skip_witness` to find the skipped witnesses.
+ *|    This flag is not supported for elements transactions.
+ *
+ * .. note:: If ``flags`` includes WALLY_TX_FLAG_REFERENCE_PROOFS, the range
+ *|    and surjection proofs of an elements transaction point into ``bytes``
+ *|    rather than being copied, and the inputs and outputs holding them have
+ *|    WALLY_TX_PROOFS_REFERENCED set in their ``features``. ``bytes`` must
+ *|    not be modified or freed until the transaction is freed. Proofs are
+ *|    copied if they are replaced or the input/output holding them is cloned.
+ *|    This flag is only supported for elements transactions.
  */
 WALLY_CORE_API int wally_tx_from_bytes(
     const unsigned char *bytes,
@@ -427,6 +781,7 @@ WALLY_CORE_API int wally_tx_from_bytes(
  *
  * :param hex: Hexadecimal string containing the transaction.
  * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
+ *|     WALLY_TX_FLAG_REFERENCE_PROOFS is not supported.
  * :param output: Destination for the resulting transaction.
  */
 WALLY_CORE_API int wally_tx_from_hex(
@@ -434,148 +789,2238 @@ WALLY_CORE_API int wally_tx_from_hex(
     uint32_t flags,
     struct wally_tx **output);
 
+#ifndef SWIG
 /**
- * Serialize a transaction to bytes.
+ * Create a transaction from its serialized bytes, without decoding its witnesses.
  *
- * :param tx: The transaction to serialize.
+ * :param bytes: Bytes to create the transaction from.
+ * :param bytes_len: Length of ``bytes`` in bytes.
  * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
- * :param bytes_out: Destination for the serialized transaction.
- * :param len: Size of ``bytes_out`` in bytes.
- * :param written: Destination for the length of the serialized transaction.
+ *|     WALLY_TX_FLAG_SKIP_WITNESS_DECODE is implied. Elements transactions
+ *|     are not supported.
+ * :param witness_offsets: Destination for the offset in ``bytes`` of each
+ *|     input's serialized witness stack, or 0 if ``bytes`` has no witness data.
+ * :param witness_offsets_len: The number of entries in ``witness_offsets``.
+ * :param written: Destination for the number of inputs. If this is greater
+ *|     than ``witness_offsets_len``, only the first ``witness_offsets_len``
+ *|     offsets are stored.
+ * :param output: Destination for the resulting transaction.
+ *
+ * .. note:: The transaction is decoded as if by `wally_tx_from_bytes` with
+ *|    WALLY_TX_FLAG_SKIP_WITNESS_DECODE. A witness that is needed later can be
+ *|    decoded from its offset with `wally_tx_witness_stack_from_bytes`.
  */
-WALLY_CORE_API int wally_tx_to_bytes(
-    const struct wally_tx *tx,
+WALLY_CORE_API int wally_tx_from_bytes_skip_witness(
+    const unsigned char *bytes,
+    size_t bytes_len,
     uint32_t flags,
-    unsigned char *bytes_out,
-    size_t len,
-    size_t *written);
+    size_t *witness_offsets,
+    size_t witness_offsets_len,
+    size_t *written,
+    struct wally_tx **output);
 
 /**
- * Serialize a transaction to hex.
+ * Decode a serialized witness stack.
  *
- * :param tx: The transaction to serialize.
+ * :param bytes: Bytes of the serialized witness stack, starting with its item
+ *|     count. Any bytes following the witness stack are ignored.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param written: Destination for the number of bytes decoded.
+ * :param output: Destination for the resulting witness stack, or NULL if it
+ *|     has no items.
+ */
+WALLY_CORE_API int wally_tx_witness_stack_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t *written,
+    struct wally_tx_witness_stack **output);
+#endif /* SWIG */
+
+/**
+ * Compute the txid of a serialized transaction without decoding it.
+ *
+ * :param bytes: Bytes of the serialized transaction.
+ * :param bytes_len: Length of ``bytes`` in bytes.
  * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
- * :param output: Destination for the resulting hexadecimal string.
+ * :param bytes_out: Destination for the txid.
+ * :param len: Size of ``bytes_out``. Must be ``WALLY_TXHASH_LEN``.
+ */
+WALLY_CORE_API int wally_tx_get_txid_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the wtxid of a serialized transaction without decoding it.
  *
- * .. note:: The string returned should be freed using `wally_free_string`.
+ * :param bytes: Bytes of the serialized transaction.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param bytes_out: Destination for the wtxid.
+ * :param len: Size of ``bytes_out``. Must be ``WALLY_TXHASH_LEN``.
  */
-WALLY_CORE_API int wally_tx_to_hex(
-    const struct wally_tx *tx,
+WALLY_CORE_API int wally_tx_get_wtxid_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
     uint32_t flags,
-    char **output);
+    unsigned char *bytes_out,
+    size_t len);
 
 /**
- * Get the weight of a transaction.
+ * Get the script type of every output of a transaction.
  *
- * :param tx: The transaction to get the weight of.
- * :param written: Destination for the weight.
+ * :param tx: The transaction to classify the outputs of.
+ * :param bytes_out: Destination for the ``WALLY_SCRIPT_TYPE_`` script type
+ *|    of each output, in output order.
+ * :param len: Size of ``bytes_out``. Should be at least the number of outputs.
+ * :param written: Destination for the number of outputs. If this is greater
+ *|    than ``len``, nothing is written to ``bytes_out``.
  */
-WALLY_CORE_API int wally_tx_get_weight(
+WALLY_CORE_API int wally_tx_get_output_script_types(
     const struct wally_tx *tx,
+    unsigned char *bytes_out,
+    size_t len,
     size_t *written);
 
 /**
- * Get the virtual size of a transaction.
+ * Get the script type of every output of a serialized transaction without
+ * decoding it.
  *
- * :param tx: The transaction to get the virtual size of.
- * :param written: Destination for the virtual size.
+ * :param bytes: Bytes of the serialized transaction.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
+ * :param bytes_out: Destination for the ``WALLY_SCRIPT_TYPE_`` script type
+ *|    of each output, in output order.
+ * :param len: Size of ``bytes_out``. Should be at least the number of outputs.
+ * :param written: Destination for the number of outputs. If this is greater
+ *|    than ``len``, nothing is written to ``bytes_out``.
  */
-WALLY_CORE_API int wally_tx_get_vsize(
-    const struct wally_tx *tx,
+WALLY_CORE_API int wally_tx_get_output_script_types_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
     size_t *written);
 
+#ifndef SWIG
 /**
- * Compute transaction vsize from transaction weight.
+ * Initialize an arena for allocating transactions from caller-owned memory.
  *
- * :param weight: The weight to convert to a virtual size.
- * :param written: Destination for the virtual size.
+ * :param arena: The arena to initialize.
+ * :param bytes_out: Memory to allocate from.
+ * :param len: Size of ``bytes_out`` in bytes.
  */
-WALLY_CORE_API int wally_tx_vsize_from_weight(
-    size_t weight,
-    size_t *written);
+WALLY_CORE_API int wally_tx_arena_init(
+    struct wally_tx_arena *arena,
+    unsigned char *bytes_out,
+    size_t len);
 
 /**
- * Compute the total sum of all outputs in a transaction.
+ * Release all transactions allocated from an arena at once.
  *
- * :param tx: The transaction to compute the total from.
- * :param value_out: Destination for the output total.
+ * :param arena: The arena to reset.
+ *
+ * .. note:: The arena memory is wiped, after which any transactions
+ *|    allocated from it must no longer be used.
  */
-WALLY_CORE_API int wally_tx_get_total_output_satoshi(
-    const struct wally_tx *tx,
-    uint64_t *value_out);
+WALLY_CORE_API int wally_tx_arena_reset(
+    struct wally_tx_arena *arena);
 
 /**
- * Create a BTC transaction for signing and return its hash.
+ * Create a transaction from its serialized bytes, allocating from an arena.
  *
- * :param tx: The transaction to generate the signature hash from.
- * :param index: The input index of the input being signed for.
- * :param script: The scriptSig for the input represented by ``index``.
- * :param script_len: Size of ``script`` in bytes.
- * :param satoshi: The amount spent by the input being signed for. Only used if
- *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
- * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
- * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
- *|     to generate a pre-segwit Bitcoin signature.
- * :param bytes_out: Destination for the signature hash.
- * :param len: Size of ``bytes_out`` in bytes. Must be at least ``SHA256_LEN``.
+ * :param bytes: Bytes to create the transaction from.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param arena: The arena to allocate the transaction from.
+ * :param output: Destination for the resulting transaction.
+ *
+ * .. note:: The transaction is freed by `wally_tx_arena_reset` and must
+ *|    not be passed to `wally_tx_free` or to any function that modifies it.
+ *|    Returns WALLY_ENOMEM, leaving the arena unchanged, if the arena is
+ *|    too small to hold the transaction.
  */
-WALLY_CORE_API int wally_tx_get_btc_signature_hash(
-    const struct wally_tx *tx,
-    size_t index,
-    const unsigned char *script,
-    size_t script_len,
-    uint64_t satoshi,
-    uint32_t sighash,
+WALLY_CORE_API int wally_tx_from_bytes_arena(
+    const unsigned char *bytes,
+    size_t bytes_len,
     uint32_t flags,
-    unsigned char *bytes_out,
-    size_t len);
+    struct wally_tx_arena *arena,
+    struct wally_tx **output);
 
 /**
- * Create a transaction for signing and return its hash.
+ * Create a batch of transactions from their serialized bytes, allocating from an arena.
  *
- * :param tx: The transaction to generate the signature hash from.
- * :param index: The input index of the input being signed for.
- * :param script: The scriptSig for the input represented by ``index``.
- * :param script_len: Size of ``script`` in bytes.
- * :param extra: Extra bytes to include in the transaction preimage.
- * :param extra_len: Size of ``extra`` in bytes.
- * :param extra_offset: Offset with the preimage to store ``extra``. To store
- *|     it at the end of the preimage, use 0xffffffff.
- * :param satoshi: The amount spent by the input being signed for. Only used if
- *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
- * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
- * :param tx_sighash: The 32bit sighash value to include in the preimage to hash.
- *|     This must be given in host CPU endianess; For normal Bitcoin signing
- *|     the value of ``sighash`` should be given.
+ * :param bytes: The serialized transactions.
+ * :param bytes_lens: The length of each serialized transaction in bytes.
+ * :param num_txs: The number of entries in ``bytes`` and ``bytes_lens``.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param run_fn: Function to run the decoding as separate tasks, for example
+ *|     on a thread pool. If NULL, the ``run_tasks_fn`` operation is used,
+ *|     or if that is also NULL, transactions are decoded in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param arena: The arena to allocate the transactions from.
+ * :param output: Destination for the ``num_txs`` resulting transactions.
+ *
+ * .. note:: The transactions are laid out in the arena in order, and are
+ *|    freed together by `wally_tx_arena_reset`, as per
+ *|    `wally_tx_from_bytes_arena`. If any transaction is invalid, or
+ *|    WALLY_ENOMEM if the arena is too small to hold them all, an error is
+ *|    returned, ``output`` is filled with NULL and the arena is unchanged.
+ */
+WALLY_CORE_API int wally_txs_from_bytes_arena(
+    const unsigned char *const *bytes,
+    const size_t *bytes_lens,
+    size_t num_txs,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    struct wally_tx_arena *arena,
+    struct wally_tx **output);
+
+/**
+ * Create a read-only view of a serialized transaction without copying it.
+ *
+ * :param bytes: Bytes of the serialized transaction.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param output: Destination for the resulting transaction view.
+ *
+ * .. note:: The view refers to ``bytes`` directly, which must remain valid
+ *|    and unchanged until the view is freed.
+ */
+WALLY_CORE_API int wally_tx_view_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx_view **output);
+
+/**
+ * Create a read-only view of a serialized transaction, allocating from an arena.
+ *
+ * :param bytes: Bytes of the serialized transaction.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param arena: The arena to allocate the view from.
+ * :param output: Destination for the resulting transaction view.
+ *
+ * .. note:: As with `wally_tx_view_from_bytes`, the view refers to ``bytes``
+ *|    directly. The view is freed by `wally_tx_arena_reset` and must not be
+ *|    passed to `wally_tx_view_free`. Returns WALLY_ENOMEM, leaving the
+ *|    arena unchanged, if the arena is too small to hold the view.
+ */
+WALLY_CORE_API int wally_tx_view_from_bytes_arena(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx_arena *arena,
+    struct wally_tx_view **output);
+
+/**
+ * Create a read-only view of a hex-encoded transaction.
+ *
+ * :param hex: Hex encoded transaction.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param bytes_out: Caller-supplied buffer to decode the transaction into.
+ * :param len: Size of ``bytes_out``. Must be at least half the length of ``hex``.
+ * :param output: Destination for the resulting transaction view.
+ *
+ * .. note:: The view refers to ``bytes_out``, which must remain valid and
+ *|    unchanged until the view is freed.
+ */
+WALLY_CORE_API int wally_tx_view_from_hex(
+    const char *hex,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    struct wally_tx_view **output);
+
+/**
+ * Free a transaction view allocated by `wally_tx_view_from_bytes`.
+ *
+ * :param view: The transaction view to free.
+ */
+WALLY_CORE_API int wally_tx_view_free(
+    struct wally_tx_view *view);
+
+/**
+ * Return the transaction hash of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param bytes_out: Destination for the transaction hash.
+ * :param len: Size of ``bytes_out``. Must be ``WALLY_TXHASH_LEN``.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_txhash(
+    const struct wally_tx_view *view,
+    size_t index,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Return the previous output index of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param written: Destination for the previous output index.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_index(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t *written);
+
+/**
+ * Return the sequence number of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param written: Destination for the sequence number.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_sequence(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t *written);
+
+/**
+ * Return the scriptSig of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param bytes_out: Destination for the scriptSig.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_script(
+    const struct wally_tx_view *view,
+    size_t index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Return the length of the scriptSig of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param written: Destination for the length of the scriptSig.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_script_len(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t *written);
+
+/**
+ * Return a witness item of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param wit_index: The zero-based index of the witness item.
+ * :param bytes_out: Destination for the witness item.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_witness(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t wit_index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Return the length of a witness item of an input in a transaction view.
+ *
+ * :param view: The transaction view to get the input from.
+ * :param index: The zero-based index of the input.
+ * :param wit_index: The zero-based index of the witness item.
+ * :param written: Destination for the length of the witness item.
+ */
+WALLY_CORE_API int wally_tx_view_get_input_witness_len(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t wit_index,
+    size_t *written);
+
+/**
+ * Return the scriptPubkey of an output in a transaction view.
+ *
+ * :param view: The transaction view to get the output from.
+ * :param index: The zero-based index of the output.
+ * :param bytes_out: Destination for the scriptPubkey.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_tx_view_get_output_script(
+    const struct wally_tx_view *view,
+    size_t index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Return the length of the scriptPubkey of an output in a transaction view.
+ *
+ * :param view: The transaction view to get the output from.
+ * :param index: The zero-based index of the output.
+ * :param written: Destination for the length of the scriptPubkey.
+ */
+WALLY_CORE_API int wally_tx_view_get_output_script_len(
+    const struct wally_tx_view *view,
+    size_t index,
+    size_t *written);
+
+/**
+ * Return the satoshi value of an output in a transaction view.
+ *
+ * :param view: The transaction view to get the output from.
+ * :param index: The zero-based index of the output.
+ * :param value_out: Destination for the satoshi value.
+ */
+WALLY_CORE_API int wally_tx_view_get_output_satoshi(
+    const struct wally_tx_view *view,
+    size_t index,
+    uint64_t *value_out);
+
+/**
+ * Create a BTC signature hash from a transaction view.
+ *
+ * This is equivalent to `wally_tx_get_btc_signature_hash`, but hashes
+ * the serialized transaction a view refers to without parsing it into
+ * a ``wally_tx``. It never allocates.
+ *
+ * :param view: The transaction view to generate the signature hash from.
+ * :param index: The input index of the input being signed for.
+ * :param script: The (unprefixed) scriptCode for the input being signed.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param satoshi: The amount spent by the input being signed for. Only used if
+ *|    flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature hash,
+ *|    or 0 to generate a pre-segwit Bitcoin signature hash.
+ * :param bytes_out: Destination for the signature hash.
+ * :param len: Size of ``bytes_out``. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_tx_view_get_btc_signature_hash(
+    const struct wally_tx_view *view,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    uint64_t satoshi,
+    uint32_t sighash,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Decode a sequence of serialized transactions into a columnar batch.
+ *
+ * :param bytes: The serialized transactions, concatenated.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements transactions are not supported.
+ * :param output: Destination for the resulting transaction batch.
+ *
+ * .. note:: The batch is allocated as a single block and copies the
+ *|    data it holds, so ``bytes`` need not remain valid once it returns.
+ *|    Witness data is not included in the batch.
+ */
+WALLY_CORE_API int wally_tx_batch_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx_batch **output);
+
+/**
+ * Decode the transactions of a serialized block into a columnar batch.
+ *
+ * :param bytes: The serialized block.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements blocks are not supported.
+ * :param output: Destination for the resulting transaction batch.
+ */
+WALLY_CORE_API int wally_block_get_tx_batch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx_batch **output);
+
+/**
+ * Free a transaction batch allocated by `wally_tx_batch_from_bytes`
+ * or `wally_block_get_tx_batch`.
+ *
+ * :param batch: The transaction batch to free.
+ */
+WALLY_CORE_API int wally_tx_batch_free(
+    struct wally_tx_batch *batch);
+#endif /* SWIG */
+
+/**
+ * Serialize a transaction to bytes.
+ *
+ * If ``len`` is too small, the required length is returned in ``written``
+ * and the contents of ``bytes_out`` are undefined. A buffer that is grown
+ * to at least ``written`` bytes and passed again is written in full.
+ *
+ * :param tx: The transaction to serialize.
+ * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
+ * :param bytes_out: Destination for the serialized transaction.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the serialized transaction.
+ */
+WALLY_CORE_API int wally_tx_to_bytes(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Serialize a transaction to hex.
+ *
+ * :param tx: The transaction to serialize.
+ * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
+ * :param output: Destination for the resulting hexadecimal string.
+ *
+ * .. note:: The string returned should be freed using `wally_free_string`.
+ */
+WALLY_CORE_API int wally_tx_to_hex(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    char **output);
+
+/**
+ * Return the length of a transaction once serialized in compact form.
+ *
+ * :param tx: The transaction to find the compact serialized length of.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to include witness data, or 0.
+ * :param written: Destination for the length of the compact serialization.
+ */
+WALLY_CORE_API int wally_tx_get_compact_length(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    size_t *written);
+
+/**
+ * Serialize a transaction to bytes in compact form for storage.
+ *
+ * :param tx: The transaction to serialize.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to include witness data, or 0.
+ * :param bytes_out: Destination for the compact serialized transaction.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the compact serialization.
+ *
+ * .. note:: The compact form is not a consensus format, and is
+ *|    intended only for archiving transactions to be decoded with
+ *|    `wally_tx_from_compact_bytes`. Integers are encoded as variable
+ *|    length, amounts have trailing zeros removed, and P2PKH, P2SH,
+ *|    P2WPKH, P2WSH and P2TR scriptPubKeys are stored as a template
+ *|    number and their hash. Elements transactions and output amounts
+ *|    over 21 million BTC are not supported.
+ */
+WALLY_CORE_API int wally_tx_to_compact_bytes(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create a transaction from bytes serialized in compact form.
+ *
+ * :param bytes: Bytes to create the transaction from, as written by
+ *|    `wally_tx_to_compact_bytes`.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0.
+ * :param output: Destination for the resulting transaction.
+ */
+WALLY_CORE_API int wally_tx_from_compact_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx **output);
+
+#ifndef SWIG
+/**
+ * Serialize a transaction to hex in a caller supplied buffer.
+ *
+ * :param tx: The transaction to serialize.
+ * :param flags: WALLY_TX_FLAG_ Flags controlling serialization options.
+ * :param output: Destination for the resulting NUL terminated hexadecimal string.
+ * :param len: The length of ``output`` in bytes.
+ * :param written: Destination for the length of the string including
+ *|    its NUL terminator.
+ *
+ * .. note:: If ``len`` is too small, ``output`` is left untouched and
+ *|    ``written`` contains the buffer size required.
+ */
+WALLY_CORE_API int wally_tx_to_hex_to_buffer(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    char *output,
+    size_t len,
+    size_t *written);
+
+/**
+ * Serialize a transaction as segments referring to its scripts and witnesses.
+ *
+ * :param tx: The transaction to serialize. Elements transactions are not supported.
+ * :param flags: ``WALLY_TX_FLAG_USE_WITNESS`` to serialize witnesses, or 0.
+ * :param bytes_out: Destination for the serialized fields that are not
+ *|    referenced from ``tx``, such as counts, outpoints and amounts.
+ * :param len: Size of ``bytes_out`` in bytes. The serialized length of
+ *|    ``tx`` is always sufficient.
+ * :param iov_out: Destination for the segments of the serialization, in order.
+ * :param iov_len: The number of items in ``iov_out``.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ * :param iov_written: Destination for the number of segments written to ``iov_out``.
+ *
+ * .. note:: Scripts and witness items of at least
+ *|    ``WALLY_TX_IOVEC_REF_LEN`` bytes are referenced rather than copied,
+ *|    and so the segments are only valid while ``tx`` and ``bytes_out``
+ *|    are unchanged. If ``len`` or ``iov_len`` is too small, the required
+ *|    sizes are returned in ``written`` and ``iov_written`` and the
+ *|    segments must not be used.
+ */
+WALLY_CORE_API int wally_tx_to_iovecs(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    struct wally_tx_iovec *iov_out,
+    size_t iov_len,
+    size_t *written,
+    size_t *iov_written);
+
+/**
+ * Get the number of bytes of memory used by a transaction.
+ *
+ * :param tx: The transaction to get the memory usage of.
+ * :param written: Destination for the number of bytes used.
+ *
+ * The total includes the transaction, its inputs and outputs, their
+ * scripts, witnesses and Elements fields. Proofs
+ * referencing the bytes the transaction was decoded from, and allocator
+ * overheads, are not included.
+ */
+WALLY_CORE_API int wally_tx_get_memory_usage(
+    const struct wally_tx *tx,
+    size_t *written);
+#endif /* SWIG */
+
+/**
+ * Get the weight of a transaction.
+ *
+ * :param tx: The transaction to get the weight of.
+ * :param written: Destination for the weight.
+ */
+WALLY_CORE_API int wally_tx_get_weight(
+    const struct wally_tx *tx,
+    size_t *written);
+
+/**
+ * Get the virtual size of a transaction.
+ *
+ * :param tx: The transaction to get the virtual size of.
+ * :param written: Destination for the virtual size.
+ */
+WALLY_CORE_API int wally_tx_get_vsize(
+    const struct wally_tx *tx,
+    size_t *written);
+
+/**
+ * Compute transaction vsize from transaction weight.
+ *
+ * :param weight: The weight to convert to a virtual size.
+ * :param written: Destination for the virtual size.
+ */
+WALLY_CORE_API int wally_tx_vsize_from_weight(
+    size_t weight,
+    size_t *written);
+
+/**
+ * Estimate the weight of spending an input without creating its scriptSig or witness.
+ *
+ * :param script_type: The WALLY_SCRIPT_TYPE_ of the output being spent.
+ *|    One of ``WALLY_SCRIPT_TYPE_P2PKH``, ``WALLY_SCRIPT_TYPE_P2WPKH``,
+ *|    ``WALLY_SCRIPT_TYPE_MULTISIG``, or ``WALLY_SCRIPT_TYPE_P2SH`` OR-ed
+ *|    with ``WALLY_SCRIPT_TYPE_P2WPKH`` or ``WALLY_SCRIPT_TYPE_MULTISIG``
+ *|    for P2SH spends. ``WALLY_SCRIPT_TYPE_P2WSH`` OR-ed with
+ *|    ``WALLY_SCRIPT_TYPE_MULTISIG`` (and optionally ``WALLY_SCRIPT_TYPE_P2SH``)
+ *|    gives a (P2SH wrapped) P2WSH multisig spend.
+ * :param threshold: The number of signatures required for multisig types, otherwise 0.
+ * :param num_keys: The number of compressed public keys in the multisig
+ *|    script for multisig types, otherwise 0.
+ * :param flags: ``WALLY_TX_DUMMY_SIG`` to size signatures at their maximum
+ *|    length, or ``WALLY_TX_DUMMY_SIG_LOW_R`` for signatures created with
+ *|    ``EC_FLAG_GRIND_R``.
+ * :param written: Destination for the weight of the input, including its
+ *|    witness if it has one.
+ *
+ * .. note:: The weight is the same as that of an input created with
+ *|    dummy signatures of the given type, and is an upper bound on the
+ *|    weight once signed. Public keys are assumed to be compressed.
+ */
+WALLY_CORE_API int wally_tx_input_get_weight_estimate(
+    uint32_t script_type,
+    uint32_t threshold,
+    uint32_t num_keys,
+    uint32_t flags,
+    size_t *written);
+
+/**
+ * Estimate the weight of a transaction after adding inputs to it.
+ *
+ * :param tx: The transaction to add inputs to. Any existing inputs are included
+ *|    as they are. Elements transactions are not supported.
+ * :param num_inputs: The number of inputs to add.
+ * :param num_witness_inputs: The number of the inputs to add that have a witness.
+ * :param input_weight: The total weight of the inputs to add, for example as
+ *|    summed from `wally_tx_input_get_weight_estimate`.
+ * :param written: Destination for the estimated weight.
+ */
+WALLY_CORE_API int wally_tx_get_weight_estimate(
+    const struct wally_tx *tx,
+    size_t num_inputs,
+    size_t num_witness_inputs,
+    size_t input_weight,
+    size_t *written);
+
+#ifndef SWIG
+/**
+ * Select coins to spend from a set of unspent outputs.
+ *
+ * :param values: The value of each unspent output in satoshi.
+ * :param values_len: The number of elements in ``values``.
+ * :param weights: The weight of spending each unspent output, for example
+ *|    from `wally_tx_input_get_weight_estimate`. If the transaction may have
+ *|    witness inputs, add 1 to the weight of each non-witness input.
+ * :param weights_len: The number of elements in ``weights``. Must equal ``values_len``.
+ * :param target: The value to pay in satoshi, excluding fees.
+ * :param base_weight: The weight of the transaction without any inputs,
+ *|    plus 2 for the segwit marker and flag if it may have witness inputs.
+ *|    For ``WALLY_COINSELECT_KNAPSACK`` this should include the change output.
+ * :param fee_rate: The fee rate to pay in satoshi per 1000 virtual bytes.
+ * :param cost_of_change: The cost of creating and later spending a change
+ *|    output. Changeless selections may exceed the target by up to this
+ *|    amount, and knapsack selections aim to leave at least this much change.
+ * :param flags: ``WALLY_COINSELECT_BNB`` and/or ``WALLY_COINSELECT_KNAPSACK``.
+ *|    If both are given, knapsack selection is used when no changeless
+ *|    selection is found.
+ * :param run_fn: The function used to run tasks, or NULL to run them in order
+ *|    on the calling thread.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param indices_out: Destination for the indices of the selected outputs,
+ *|    in increasing order.
+ * :param len: The number of elements in ``indices_out``.
+ * :param written: Destination for the number of indices written, or 0 if
+ *|    no selection pays the target and fees.
+ *
+ * .. note:: Fees are computed per input from ``weights`` and rounded up,
+ *|    with the input count varint costed for all spendable outputs, so the
+ *|    fee of the resulting transaction is never less than ``fee_rate``.
+ *|    Outputs costing more to spend than their value are never selected.
+ *|    The search is split into tasks run by ``run_fn``, and the result
+ *|    does not depend on how the tasks are run.
+ *|    If ``len`` is too small, the required length is returned in ``written``.
+ */
+WALLY_CORE_API int wally_coinselect(
+    const uint64_t *values,
+    size_t values_len,
+    const uint32_t *weights,
+    size_t weights_len,
+    uint64_t target,
+    size_t base_weight,
+    uint64_t fee_rate,
+    uint64_t cost_of_change,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    uint32_t *indices_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
+#ifndef SWIG
+/**
+ * Create a UTXO snapshot record for an unspent output.
+ *
+ * :param txhash: The transaction hash of the output.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param vout: The index of the output in its transaction.
+ * :param satoshi: The value of the output in satoshi.
+ * :param script: The scriptPubKey of the output. Must be a P2PKH, P2SH,
+ *|    P2WPKH or P2WSH script.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param bytes_out: Destination for the record.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``WALLY_UTXO_RECORD_LEN``.
+ *
+ * .. note:: A record holds the outpoint, the value, the script type and
+ *|    the hash160 or witness program of the script, at fixed offsets.
+ */
+WALLY_CORE_API int wally_utxo_record_from_script(
+    const unsigned char *txhash,
+    size_t txhash_len,
+    uint32_t vout,
+    uint64_t satoshi,
+    const unsigned char *script,
+    size_t script_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compress a transaction output in bitcoin core's compressed txout format.
+ *
+ * :param satoshi: The value of the output in satoshi.
+ * :param script: The scriptPubKey of the output.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param bytes_out: Destination for the compressed output.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: The amount has its trailing zeros removed, and P2PKH, P2SH
+ *|    and P2PK scriptPubKeys are stored as a type byte and their hash or
+ *|    public key X coordinate, as in the chainstate and UTXO snapshots
+ *|    of bitcoin core. If ``len`` is too small, the required length is
+ *|    returned in ``written``.
+ */
+WALLY_CORE_API int wally_txout_to_compressed(
+    uint64_t satoshi,
+    const unsigned char *script,
+    size_t script_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Decompress a transaction output in bitcoin core's compressed txout format.
+ *
+ * :param bytes: Bytes starting with the compressed output.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param satoshi_out: Destination for the value of the output in satoshi.
+ * :param bytes_out: Destination for the scriptPubKey of the output.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the scriptPubKey.
+ * :param consumed: Destination for the number of bytes of ``bytes``
+ *|    holding the compressed output.
+ *
+ * .. note:: Scripts larger than 10000 bytes decompress as a single
+ *|    OP_RETURN, as they do in bitcoin core. If ``len`` is too small,
+ *|    the required length is returned in ``written``.
+ */
+WALLY_CORE_API int wally_txout_from_compressed(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint64_t *satoshi_out,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written,
+    size_t *consumed);
+
+/**
+ * Create UTXO snapshot records from coins dumped by bitcoin core.
+ *
+ * :param bytes: The coins, without any file header. Each is an outpoint
+ *|    followed by a coin (the height, coinbase flag and compressed txout)
+ *|    as written by ``dumptxoutset`` before bitcoin core 28. With
+ *|    WALLY_UTXO_FLAG_COINS_BY_TXID, coins are instead grouped under a
+ *|    txid and count with varint output indices, as written by later
+ *|    versions.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param flags: WALLY_UTXO_FLAG_ Flags controlling decoding.
+ * :param bytes_out: Destination for the records, one for each coin.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes of records.
+ *
+ * .. note:: The records can be passed to `wally_utxo_snapshot_from_records`
+ *|    to create a snapshot. Heights and coinbase flags are not kept.
+ *|    Coins whose scripts are not P2PKH, P2SH, P2WPKH or P2WSH are
+ *|    rejected unless ``flags`` includes WALLY_UTXO_FLAG_SKIP_UNSUPPORTED.
+ *|    If ``len`` is too small, the required length is returned in ``written``.
+ */
+WALLY_CORE_API int wally_utxo_records_from_coins(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Create a UTXO snapshot from records sorted in any order.
+ *
+ * :param bytes: Records created with `wally_utxo_record_from_script`,
+ *|    concatenated. May be NULL for an empty snapshot.
+ * :param bytes_len: Size of ``bytes`` in bytes. Must be a multiple of
+ *|    ``WALLY_UTXO_RECORD_LEN``.
+ * :param bytes_out: Destination for the snapshot. May be the same buffer
+ *|    ``bytes`` was copied into at offset ``WALLY_UTXO_SNAPSHOT_HEADER_LEN``.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to
+ *|    ``bytes_out``: ``WALLY_UTXO_SNAPSHOT_HEADER_LEN`` plus ``bytes_len``.
+ *
+ * .. note:: The records are sorted by outpoint so that snapshots can be
+ *|    searched without any index. A snapshot contains no pointers and can
+ *|    be written to a file and memory mapped, for example by processes
+ *|    sharing a read-only UTXO set. Records with duplicate outpoints are
+ *|    rejected. If ``len`` is too small, the required length is returned
+ *|    in ``written``.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_from_records(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Get the number of records in a UTXO snapshot.
+ *
+ * :param bytes: The snapshot, for example as memory mapped from a file.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param written: Destination for the number of records.
+ *
+ * .. note:: Only the snapshot header is validated, so this function
+ *|    returns immediately for snapshots of any size.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_get_num_records(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t *written);
+
+/**
+ * Find the record for an outpoint in a UTXO snapshot.
+ *
+ * :param bytes: The snapshot to search.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param txhash: The transaction hash of the outpoint.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param vout: The output index of the outpoint.
+ * :param written: Destination for the index of the record, or the number
+ *|    of records in the snapshot if the outpoint is not present.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_find(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *txhash,
+    size_t txhash_len,
+    uint32_t vout,
+    size_t *written);
+
+/**
+ * Get the outpoint and value of a record in a UTXO snapshot.
+ *
+ * :param bytes: The snapshot containing the record.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param index: The index of the record.
+ * :param txhash_out: Destination for the transaction hash, or NULL.
+ * :param txhash_len: Size of ``txhash_out`` in bytes. Must be
+ *|    ``WALLY_TXHASH_LEN``, or 0 if ``txhash_out`` is NULL.
+ * :param vout_out: Destination for the output index, or NULL.
+ * :param satoshi_out: Destination for the value in satoshi, or NULL.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_get(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t index,
+    unsigned char *txhash_out,
+    size_t txhash_len,
+    uint32_t *vout_out,
+    uint64_t *satoshi_out);
+
+/**
+ * Get the scriptPubKey of a record in a UTXO snapshot.
+ *
+ * :param bytes: The snapshot containing the record.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param index: The index of the record.
+ * :param bytes_out: Destination for the scriptPubKey.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_get_scriptpubkey(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Look up the outputs spent by a transaction in a UTXO snapshot.
+ *
+ * :param bytes: The snapshot to search.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param tx: The transaction whose inputs to look up.
+ * :param values_out: Destination for the value spent by each input.
+ * :param values_len: The number of items in ``values_out``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param bytes_out: Destination for the script to sign for each input,
+ *|     each prefixed with its length encoded as a varint.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: The outputs are written in the form expected by
+ *|    `wally_tx_get_signature_hashes`. Every input must spend a P2PKH or
+ *|    P2WPKH output in the snapshot, since other types must be signed with
+ *|    a script that the snapshot does not contain. The script for P2WPKH
+ *|    inputs is the BIP 143 scriptCode. If ``len`` is too small, the
+ *|    required length is returned in ``written``.
+ */
+WALLY_CORE_API int wally_utxo_snapshot_get_prevouts(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const struct wally_tx *tx,
+    uint64_t *values_out,
+    size_t values_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+#endif /* SWIG */
+
+/**
+ * Compute the total sum of all outputs in a transaction.
+ *
+ * :param tx: The transaction to compute the total from.
+ * :param value_out: Destination for the output total.
+ */
+WALLY_CORE_API int wally_tx_get_total_output_satoshi(
+    const struct wally_tx *tx,
+    uint64_t *value_out);
+
+/**
+ * Compute the fee paid by a BTC transaction.
+ *
+ * :param tx: The transaction to compute the fee of.
+ * :param values: The value of the output spent by each input of ``tx``.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param value_out: Destination for the fee in satoshi.
+ *
+ * .. note:: Fails if the outputs of ``tx`` spend more than its inputs.
+ */
+WALLY_CORE_API int wally_tx_get_fee(
+    const struct wally_tx *tx,
+    const uint64_t *values,
+    size_t values_len,
+    uint64_t *value_out);
+
+/**
+ * Compute the fee rate of a BTC transaction.
+ *
+ * :param tx: The transaction to compute the fee rate of.
+ * :param values: The value of the output spent by each input of ``tx``.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param value_out: Destination for the fee rate in satoshi per 1000
+ *|     virtual bytes, rounded down.
+ */
+WALLY_CORE_API int wally_tx_get_fee_rate(
+    const struct wally_tx *tx,
+    const uint64_t *values,
+    size_t values_len,
+    uint64_t *value_out);
+
+#ifndef SWIG
+/**
+ * Compute the fee rates of a batch of BTC transactions.
+ *
+ * :param txs: The transactions to compute the fee rates of.
+ * :param num_txs: The number of items in ``txs``.
+ * :param values: The value of the output spent by each input of each
+ *|     transaction, in transaction then input order.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     total number of inputs in ``txs``.
+ * :param fee_rates_out: Destination for the fee rate of each transaction
+ *|     in satoshi per 1000 virtual bytes, rounded down.
+ * :param fee_rates_len: The number of items in ``fee_rates_out``. Must
+ *|     match ``num_txs``.
+ *
+ * .. note:: The prevout values for transactions whose parents are in a
+ *|    `wally_tx_set` can be looked up with `wally_tx_set_get_prevout_values`.
+ */
+WALLY_CORE_API int wally_tx_get_fee_rates(
+    const struct wally_tx *const *txs,
+    size_t num_txs,
+    const uint64_t *values,
+    size_t values_len,
+    uint64_t *fee_rates_out,
+    size_t fee_rates_len);
+#endif /* SWIG */
+
+/**
+ * Create a BTC transaction for signing and return its hash.
+ *
+ * :param tx: The transaction to generate the signature hash from.
+ * :param index: The input index of the input being signed for.
+ * :param script: The scriptSig for the input represented by ``index``.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param satoshi: The amount spent by the input being signed for. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
+ *|     to generate a pre-segwit Bitcoin signature.
+ * :param bytes_out: Destination for the signature hash.
+ * :param len: Size of ``bytes_out`` in bytes. Must be at least ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_tx_get_btc_signature_hash(
+    const struct wally_tx *tx,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    uint64_t satoshi,
+    uint32_t sighash,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Create a transaction for signing and return its hash.
+ *
+ * :param tx: The transaction to generate the signature hash from.
+ * :param index: The input index of the input being signed for.
+ * :param script: The scriptSig for the input represented by ``index``.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param extra: Extra bytes to include in the transaction preimage.
+ * :param extra_len: Size of ``extra`` in bytes.
+ * :param extra_offset: Offset with the preimage to store ``extra``. To store
+ *|     it at the end of the preimage, use 0xffffffff.
+ * :param satoshi: The amount spent by the input being signed for. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param tx_sighash: The 32bit sighash value to include in the preimage to hash.
+ *|     This must be given in host CPU endianess; For normal Bitcoin signing
+ *|     the value of ``sighash`` should be given.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
+ *|     to generate a pre-segwit Bitcoin signature.
+ * :param bytes_out: Destination for the signature hash.
+ * :param len: Size of ``bytes_out`` in bytes. Must be at least ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_tx_get_signature_hash(
+    const struct wally_tx *tx,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    const unsigned char *extra,
+    size_t extra_len,
+    uint32_t extra_offset,
+    uint64_t satoshi,
+    uint32_t sighash,
+    uint32_t tx_sighash,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/**
+ * Initialize a context holding the BIP 143 hashes of a transaction.
+ *
+ * :param tx: The transaction to compute the hashes from.
+ * :param flags: Reserved, must be 0.
+ * :param ctx: Destination for the computed hashes.
+ *
+ * .. note:: The context must be re-initialized if ``tx`` is modified.
+ */
+WALLY_CORE_API int wally_tx_sighash_ctx_init(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    struct wally_tx_sighash_ctx *ctx);
+#endif
+
+/**
+ * Allocate and initialize a context holding the BIP 143 hashes of a transaction.
+ *
+ * :param tx: The transaction to compute the hashes from.
+ * :param flags: Reserved, must be 0.
+ * :param output: Destination for the resulting context.
+ */
+WALLY_CORE_API int wally_tx_sighash_ctx_init_alloc(
+    const struct wally_tx *tx,
+    uint32_t flags,
+    struct wally_tx_sighash_ctx **output);
+
+/**
+ * Free a context allocated by `wally_tx_sighash_ctx_init_alloc`.
+ *
+ * :param ctx: The context to free.
+ */
+WALLY_CORE_API int wally_tx_sighash_ctx_free(
+    struct wally_tx_sighash_ctx *ctx);
+
+#ifndef SWIG
+/**
+ * Serialize a context holding the BIP 143 hashes of a transaction.
+ *
+ * :param ctx: The context to serialize.
+ * :param flags: Reserved, must be 0.
+ * :param bytes_out: Destination for the serialized context.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the number of bytes written to ``bytes_out``.
+ *
+ * .. note:: This allows a host to send the hashes of a transaction to a
+ *|    signing device, which can check them with a
+ *|    `wally_tx_sighash_verifier_init_alloc` verifier rather than computing
+ *|    them itself. BTC contexts are ``WALLY_TX_SIGHASH_CTX_LEN`` bytes long
+ *|    and Elements contexts ``WALLY_TX_SIGHASH_CTX_ELEMENTS_LEN``. If
+ *|    ``len`` is too small, ``written`` contains the length required.
+ */
+WALLY_CORE_API int wally_tx_sighash_ctx_to_bytes(
+    const struct wally_tx_sighash_ctx *ctx,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Initialize a context holding BIP 143 hashes from its serialized form.
+ *
+ * :param bytes: The context serialized by `wally_tx_sighash_ctx_to_bytes`.
+ * :param bytes_len: Size of ``bytes`` in bytes.
+ * :param flags: Reserved, must be 0.
+ * :param ctx: Destination for the deserialized hashes.
+ *
+ * .. note:: The hashes are not checked against any transaction. A signer
+ *|    that did not compute them should check them with a verifier from
+ *|    `wally_tx_sighash_verifier_init_alloc` before signing with them.
+ */
+WALLY_CORE_API int wally_tx_sighash_ctx_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_tx_sighash_ctx *ctx);
+
+/** An opaque verifier of the BIP 143 hashes in a sighash context */
+struct wally_tx_sighash_verifier;
+
+/**
+ * Start verifying the BIP 143 hashes of a context as a transaction is streamed.
+ *
+ * :param ctx: The context to verify. It is copied, and need not outlive
+ *|    the verifier.
+ * :param flags: Reserved, must be 0.
+ * :param output: Destination for the resulting verifier.
+ *
+ * .. note:: The inputs and outputs of the transaction are passed in order
+ *|    with `wally_tx_sighash_verifier_add_input` and
+ *|    `wally_tx_sighash_verifier_add_output`, and need not be kept in
+ *|    memory once passed. `wally_tx_sighash_verifier_final` then checks
+ *|    the hashes, which can be used to sign every input of the transaction
+ *|    without streaming it again. Only BTC contexts can be verified.
+ */
+WALLY_CORE_API int wally_tx_sighash_verifier_init_alloc(
+    const struct wally_tx_sighash_ctx *ctx,
+    uint32_t flags,
+    struct wally_tx_sighash_verifier **output);
+
+/**
+ * Pass the next input of the transaction to a sighash context verifier.
+ *
+ * :param verifier: The verifier from `wally_tx_sighash_verifier_init_alloc`.
+ * :param txhash: The transaction hash of the transaction this input comes from.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param utxo_index: The zero-based index of the transaction output
+ *|     in ``txhash`` that this input comes from.
+ * :param sequence: The sequence number for the input.
+ *
+ * .. note:: Returns WALLY_EINVAL if the context has fewer inputs.
+ */
+WALLY_CORE_API int wally_tx_sighash_verifier_add_input(
+    struct wally_tx_sighash_verifier *verifier,
+    const unsigned char *txhash,
+    size_t txhash_len,
+    uint32_t utxo_index,
+    uint32_t sequence);
+
+/**
+ * Pass the next output of the transaction to a sighash context verifier.
+ *
+ * :param verifier: The verifier from `wally_tx_sighash_verifier_init_alloc`.
+ * :param satoshi: The amount of the output in satoshi.
+ * :param script: The scriptPubkey for the output.
+ * :param script_len: Size of ``script`` in bytes.
+ *
+ * .. note:: Returns WALLY_EINVAL if the context has fewer outputs.
+ */
+WALLY_CORE_API int wally_tx_sighash_verifier_add_output(
+    struct wally_tx_sighash_verifier *verifier,
+    uint64_t satoshi,
+    const unsigned char *script,
+    size_t script_len);
+
+/**
+ * Check the hashes of a sighash context against the transaction streamed.
+ *
+ * :param verifier: The verifier from `wally_tx_sighash_verifier_init_alloc`.
+ *
+ * .. note:: Returns WALLY_OK if the hashes match, WALLY_ERROR if they do
+ *|    not, or WALLY_EINVAL if fewer inputs or outputs than the context has
+ *|    were passed. Once finished, the verifier can only be freed.
+ */
+WALLY_CORE_API int wally_tx_sighash_verifier_final(
+    struct wally_tx_sighash_verifier *verifier);
+
+/**
+ * Free a verifier allocated by `wally_tx_sighash_verifier_init_alloc`.
+ *
+ * :param verifier: The verifier to free.
+ */
+WALLY_CORE_API int wally_tx_sighash_verifier_free(
+    struct wally_tx_sighash_verifier *verifier);
+
+/** An opaque calculator of signature hashes from a streamed transaction */
+struct wally_tx_sighash_stream;
+
+/**
+ * Start computing signature hashes from a transaction streamed in chunks.
+ *
+ * :param flags: Reserved, must be 0.
+ * :param output: Destination for the resulting stream.
+ *
+ * .. note:: The signature hashes to compute are given with
+ *|    `wally_tx_sighash_stream_add_input`, then the serialized transaction
+ *|    is passed in chunks of any size with `wally_tx_sighash_stream_update`
+ *|    and the hashes are returned by `wally_tx_sighash_stream_final`. The
+ *|    transaction is parsed as it is streamed and is never held in memory,
+ *|    so memory use depends only on the hashes requested. Only BTC
+ *|    transactions are supported.
+ */
+WALLY_CORE_API int wally_tx_sighash_stream_init_alloc(
+    uint32_t flags,
+    struct wally_tx_sighash_stream **output);
+
+/**
+ * Request a signature hash from a streamed transaction.
+ *
+ * :param stream: The stream from `wally_tx_sighash_stream_init_alloc`.
+ * :param index: The input index of the input being signed for.
+ * :param script: The scriptSig for the input represented by ``index``.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param satoshi: The amount spent by the input being signed for. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
+ *|     to generate a pre-segwit Bitcoin signature.
+ *
+ * .. note:: Hashes must be requested before any of the transaction is
+ *|    streamed. ``script`` is copied.
+ */
+WALLY_CORE_API int wally_tx_sighash_stream_add_input(
+    struct wally_tx_sighash_stream *stream,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    uint64_t satoshi,
+    uint32_t sighash,
+    uint32_t flags);
+
+/**
+ * Pass the next part of the serialized transaction to a signature hash stream.
+ *
+ * :param stream: The stream from `wally_tx_sighash_stream_init_alloc`.
+ * :param bytes: The next bytes of the serialized transaction.
+ * :param bytes_len: Size of ``bytes`` in bytes. May be any length.
+ *
+ * .. note:: Returns WALLY_EINVAL if the transaction is invalid, longer than
+ *|    the ``WALLY_LIMIT_TX_LEN`` input limit, or followed by further data.
+ *|    Once an error is returned, the stream can only be freed.
+ */
+WALLY_CORE_API int wally_tx_sighash_stream_update(
+    struct wally_tx_sighash_stream *stream,
+    const unsigned char *bytes,
+    size_t bytes_len);
+
+/**
+ * Finish a signature hash stream, returning the hashes requested.
+ *
+ * :param stream: The stream from `wally_tx_sighash_stream_init_alloc`.
+ * :param bytes_out: Destination for the signature hashes, in the order
+ *|    they were requested.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN`` times
+ *|    the number of hashes requested.
+ *
+ * .. note:: Returns WALLY_EINVAL if the whole transaction has not been
+ *|    streamed. The hashes are those `wally_tx_get_btc_signature_hash`
+ *|    returns for the same transaction. Once finished, the stream can only
+ *|    be freed.
+ */
+WALLY_CORE_API int wally_tx_sighash_stream_final(
+    struct wally_tx_sighash_stream *stream,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Free a stream allocated by `wally_tx_sighash_stream_init_alloc`.
+ *
+ * :param stream: The stream to free.
+ */
+WALLY_CORE_API int wally_tx_sighash_stream_free(
+    struct wally_tx_sighash_stream *stream);
+#endif /* SWIG */
+
+/**
+ * Create a BTC transaction for signing and return its hash, using
+ * precomputed BIP 143 hashes.
+ *
+ * This is equivalent to `wally_tx_get_btc_signature_hash`, but avoids
+ * re-hashing the inputs and outputs of ``tx`` for every input signed.
+ *
+ * :param tx: The transaction to generate the signature hash from.
+ * :param ctx: The context initialized from ``tx``, or NULL to compute the
+ *|     BIP 143 hashes on demand.
+ * :param index: The input index of the input being signed for.
+ * :param script: The scriptSig for the input represented by ``index``.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param satoshi: The amount spent by the input being signed for. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
  * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
  *|     to generate a pre-segwit Bitcoin signature.
  * :param bytes_out: Destination for the signature hash.
  * :param len: Size of ``bytes_out`` in bytes. Must be at least ``SHA256_LEN``.
  */
-WALLY_CORE_API int wally_tx_get_signature_hash(
-    const struct wally_tx *tx,
-    size_t index,
-    const unsigned char *script,
-    size_t script_len,
-    const unsigned char *extra,
-    size_t extra_len,
-    uint32_t extra_offset,
-    uint64_t satoshi,
-    uint32_t sighash,
-    uint32_t tx_sighash,
+WALLY_CORE_API int wally_tx_get_btc_signature_hash_ctx(
+    const struct wally_tx *tx,
+    const struct wally_tx_sighash_ctx *ctx,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    uint64_t satoshi,
+    uint32_t sighash,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Create a BTC transaction for signing and return the hashes of all its inputs.
+ *
+ * :param tx: The transaction to generate the signature hashes from.
+ * :param scripts: The scriptSig for each input of ``tx`` in order, each
+ *|     prefixed with its length encoded as a varint.
+ * :param scripts_len: Size of ``scripts`` in bytes.
+ * :param values: The amount spent by each input of ``tx``. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 values otherwise.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature
+ *|     desired for each input of ``tx``.
+ * :param sighash_len: The number of items in ``sighash``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate BIP 143 signatures, or 0
+ *|     to generate pre-segwit Bitcoin signatures.
+ * :param bytes_out: Destination for the signature hashes.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN`` times
+ *|     the number of inputs in ``tx``.
+ */
+WALLY_CORE_API int wally_tx_get_signature_hashes(
+    const struct wally_tx *tx,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    const uint64_t *values,
+    size_t values_len,
+    const uint32_t *sighash,
+    size_t sighash_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Sign every input of a transaction with its own private key.
+ *
+ * :param tx: The transaction to sign. Each input must spend a P2PKH,
+ *|     P2WPKH or P2SH-wrapped P2WPKH output paying to the compressed public
+ *|     key of its private key. Elements transactions are not supported.
+ * :param scripts: The scriptPubKey spent by each input of ``tx`` in order,
+ *|     each prefixed with its length encoded as a varint.
+ * :param scripts_len: Size of ``scripts`` in bytes.
+ * :param values: The amount spent by each input of ``tx``.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param priv_keys: The private key for each input of ``tx``, one after another.
+ * :param priv_keys_len: The length of ``priv_keys`` in bytes. Must be
+ *|     ``EC_PRIVATE_KEY_LEN`` times the number of inputs in ``tx``.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature
+ *|     desired for every input of ``tx``.
+ * :param flags: ``EC_FLAG_GRIND_R`` to produce low-R signatures, or 0.
+ *
+ * The scriptSig and witness of every input are replaced. If any input
+ * cannot be signed, ``tx`` is not modified.
+ */
+WALLY_CORE_API int wally_tx_sign_inputs(
+    struct wally_tx *tx,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    const uint64_t *values,
+    size_t values_len,
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    uint32_t sighash,
+    uint32_t flags);
+
+#ifndef SWIG
+/**
+ * Sign every input of a transaction, computing signatures in parallel.
+ *
+ * See `wally_tx_sign_inputs`.
+ *
+ * :param run_fn: The function used to run signing tasks, for example
+ *|     on a thread pool. If NULL, inputs are signed in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ */
+WALLY_CORE_API int wally_tx_sign_inputs_parallel(
+    struct wally_tx *tx,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    const uint64_t *values,
+    size_t values_len,
+    const unsigned char *priv_keys,
+    size_t priv_keys_len,
+    uint32_t sighash,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx);
+#endif /* SWIG */
+
+/**
+ * Verify the signatures of every input of a transaction.
+ *
+ * :param tx: The transaction to verify. Each input must spend a P2PKH,
+ *|     P2WPKH, P2SH-wrapped P2WPKH or P2WSH multisig output. Elements
+ *|     transactions are not supported.
+ * :param scripts: The scriptPubKey spent by each input of ``tx`` in order,
+ *|     each prefixed with its length encoded as a varint.
+ * :param scripts_len: Size of ``scripts`` in bytes.
+ * :param values: The amount spent by each input of ``tx``.
+ * :param values_len: The number of items in ``values``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param flags: Must be 0.
+ * :param bytes_out: Destination for the result for each input, 1 if all of
+ *|     its signatures are valid or 0 otherwise.
+ * :param len: Size of ``bytes_out`` in bytes. Must match the number of
+ *|     inputs in ``tx``.
+ *
+ * .. note:: Signatures and keys are taken from each input's scriptSig and
+ *|    witness, which must have the standard form for the script spent.
+ *|    Signatures must be strict DER with a low S value, as required by
+ *|    standardness rules. Returns ``WALLY_OK`` only if every input is valid.
+ */
+WALLY_CORE_API int wally_tx_verify_input_signatures(
+    const struct wally_tx *tx,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    const uint64_t *values,
+    size_t values_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
+#ifndef SWIG
+/**
+ * Verify the signatures of every input of a transaction in parallel.
+ *
+ * See `wally_tx_verify_input_signatures`.
+ *
+ * :param run_fn: The function used to run verification tasks, for example
+ *|     on a thread pool. If NULL, signatures are verified in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ */
+WALLY_CORE_API int wally_tx_verify_input_signatures_parallel(
+    const struct wally_tx *tx,
+    const unsigned char *scripts,
+    size_t scripts_len,
+    const uint64_t *values,
+    size_t values_len,
+    uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
+/**
+ * Determine if a transaction is a coinbase transaction.
+ *
+ * :param tx: The transaction to check.
+ * :param written: 1 if the transaction is a coinbase transaction, otherwise 0.
+ */
+WALLY_CORE_API int wally_tx_is_coinbase(
+    const struct wally_tx *tx,
+    size_t *written);
+
+/**
+ * Compute the hash of a block from its serialized header.
+ *
+ * :param bytes: The serialized block or block header.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be at least ``WALLY_BLOCK_HEADER_LEN``.
+ * :param bytes_out: Destination for the block hash.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_block_get_hash(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the merkle root of a list of transaction hashes.
+ *
+ * :param bytes: The concatenated transaction hashes, in block order.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a non-zero multiple of ``SHA256_LEN``.
+ * :param bytes_out: Destination for the merkle root.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_merkle_root(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the merkle branch proving a transaction hash is in a merkle tree.
+ *
+ * :param bytes: The concatenated transaction hashes, in block order.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a non-zero multiple of ``SHA256_LEN``.
+ * :param index: The zero-based index of the transaction hash to prove.
+ * :param bytes_out: Destination for the concatenated branch hashes, from the leaf up.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the branch.
+ */
+WALLY_CORE_API int wally_merkle_branch(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    size_t index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Verify a merkle branch proving a transaction hash is in a merkle tree.
+ *
+ * :param txhash: The transaction hash to verify.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param branch: The concatenated branch hashes, from the leaf up.
+ * :param branch_len: Length of ``branch`` in bytes. Must be a multiple of ``SHA256_LEN``.
+ * :param index: The zero-based index of the transaction hash in the tree.
+ * :param merkle_root: The expected merkle root.
+ * :param merkle_root_len: Size of ``merkle_root`` in bytes. Must be ``SHA256_LEN``.
+ *
+ * .. note:: Returns WALLY_OK if the branch is valid, otherwise WALLY_EINVAL.
+ */
+WALLY_CORE_API int wally_merkle_branch_verify(
+    const unsigned char *txhash,
+    size_t txhash_len,
+    const unsigned char *branch,
+    size_t branch_len,
+    size_t index,
+    const unsigned char *merkle_root,
+    size_t merkle_root_len);
+
+#ifndef SWIG
+/**
+ * Parse a serialized block header.
+ *
+ * :param bytes: The serialized block or block header.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be at least ``WALLY_BLOCK_HEADER_LEN``.
+ * :param output: Destination for the parsed block header.
+ */
+WALLY_CORE_API int wally_block_header_from_bytes(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    struct wally_block_header *output);
+
+/**
+ * Verify the linkage and proof of work of a run of block headers.
+ *
+ * :param bytes: The serialized block headers, in chain order.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a non-zero
+ *|    multiple of ``WALLY_BLOCK_HEADER_LEN``.
+ * :param prev_hash: The hash of the block before the first header, or NULL
+ *|    to skip checking the first headers previous block hash.
+ * :param prev_hash_len: Size of ``prev_hash`` in bytes. Must be ``SHA256_LEN``.
+ * :param flags: Must be 0.
+ * :param bytes_out: Destination for the hash of the last header, or NULL.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``, or 0
+ *|    if ``bytes_out`` is NULL.
+ * :param written: Destination for the number of headers that were verified.
+ *
+ * .. note:: Each header must refer to the hash of the one before it and
+ *|    its hash must meet the target encoded in its own ``bits``. Changes
+ *|    in difficulty are not checked against any network's rules. Headers
+ *|    are hashed several at a time where the CPU supports it. Returns
+ *|    WALLY_EINVAL if any header is invalid, with ``written`` giving the
+ *|    index of the first invalid header.
+ */
+WALLY_CORE_API int wally_block_header_verify_chain(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *prev_hash,
+    size_t prev_hash_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Initialize an iterator over the transactions in a serialized block.
+ *
+ * :param bytes: The serialized block.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: Must be 0. Elements blocks are not supported.
+ * :param output: Destination for the initialized iterator.
+ *
+ * .. note:: The iterator refers to ``bytes`` directly, which must remain
+ *|    valid and unchanged while it is in use.
+ */
+WALLY_CORE_API int wally_block_iterator_init(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    struct wally_block_iterator *output);
+
+/**
+ * Return the next transaction from a block iterator.
+ *
+ * :param iter: The block iterator.
+ * :param tx_bytes: Destination for a pointer to the serialized transaction
+ *|    within the block, or NULL once all transactions have been returned.
+ * :param tx_bytes_len: Destination for the length of the serialized transaction.
+ * :param bytes_out: Destination for the txid of the transaction, or NULL.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``, or 0
+ *|    if ``bytes_out`` is NULL.
+ *
+ * .. note:: The returned transaction can be decoded with `wally_tx_view_from_bytes`
+ *|    or `wally_tx_from_bytes`. Returns WALLY_EINVAL if a transaction is
+ *|    invalid or the block has trailing data after its last transaction.
+ */
+WALLY_CORE_API int wally_block_iterator_next(
+    struct wally_block_iterator *iter,
+    const unsigned char **tx_bytes,
+    size_t *tx_bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the txids of the transactions in a serialized block in parallel.
+ *
+ * :param bytes: The serialized block.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param flags: ``WALLY_TX_FLAG_USE_WITNESS`` to also compute wtxids, or 0.
+ * :param run_fn: The function used to run hashing tasks, for example on a
+ *|     thread pool. If NULL, transactions are hashed in turn.
+ * :param run_ctx: Context passed to ``run_fn``.
+ * :param merkle_root_out: Destination for the merkle root of the txids, or NULL.
+ * :param merkle_root_len: Size of ``merkle_root_out`` in bytes. Must be
+ *|     ``SHA256_LEN``, or 0 if ``merkle_root_out`` is NULL.
+ * :param bytes_out: Destination for the concatenated txids in block order,
+ *|     followed by the wtxids in block order if ``flags`` is
+ *|     ``WALLY_TX_FLAG_USE_WITNESS``.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the hashes.
+ *
+ * .. note:: The block is split into ranges of transactions which are
+ *|    hashed as separate tasks. The wtxid of the coinbase is the hash of
+ *|    its serialization, not the zero hash used for witness commitments.
+ *|    If ``len`` is too small, the required length is returned in
+ *|    ``written`` and nothing is written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_block_get_txids(
+    const unsigned char *bytes,
+    size_t bytes_len,
     uint32_t flags,
+    wally_run_tasks_t run_fn,
+    void *run_ctx,
+    unsigned char *merkle_root_out,
+    size_t merkle_root_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Compute the BIP 152 SipHash key for the short ids of a compact block.
+ *
+ * :param bytes: The serialized block or block header.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be at least ``WALLY_BLOCK_HEADER_LEN``.
+ * :param nonce: The nonce from the compact block.
+ * :param bytes_out: Destination for the key.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``WALLY_SIPHASH_KEY_LEN``.
+ */
+WALLY_CORE_API int wally_bip152_short_id_key(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint64_t nonce,
     unsigned char *bytes_out,
     size_t len);
 
 /**
- * Determine if a transaction is a coinbase transaction.
+ * Compute the BIP 152 short ids of a list of transaction hashes.
  *
- * :param tx: The transaction to check.
- * :param written: 1 if the transaction is a coinbase transaction, otherwise 0.
+ * :param key: The key from `wally_bip152_short_id_key`.
+ * :param key_len: Size of ``key`` in bytes. Must be ``WALLY_SIPHASH_KEY_LEN``.
+ * :param bytes: The concatenated txids or wtxids.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a non-zero multiple of ``WALLY_TXHASH_LEN``.
+ * :param bytes_out: Destination for the concatenated short ids.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``WALLY_BIP152_SHORT_ID_LEN``
+ *|    times the number of hashes.
  */
-WALLY_CORE_API int wally_tx_is_coinbase(
+WALLY_CORE_API int wally_bip152_short_ids(
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Compute the BIP 152 short ids of the transactions in a serialized block.
+ *
+ * :param bytes: The serialized block.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param nonce: The nonce for the compact block.
+ * :param flags: ``WALLY_TX_FLAG_USE_WITNESS`` to use wtxids as in BIP 152
+ *|    version 2, or 0 to use txids.
+ * :param bytes_out: Destination for the concatenated short ids, in block order.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the short ids.
+ *
+ * .. note:: If ``len`` is too small, the required length is returned in
+ *|    ``written`` and nothing is written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_block_get_short_ids(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint64_t nonce,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Match the BIP 152 short ids of a compact block against known transactions.
+ *
+ * :param key: The key from `wally_bip152_short_id_key`.
+ * :param key_len: Size of ``key`` in bytes. Must be ``WALLY_SIPHASH_KEY_LEN``.
+ * :param short_ids: The concatenated short ids from the compact block.
+ * :param short_ids_len: Length of ``short_ids`` in bytes. Must be a non-zero
+ *|    multiple of ``WALLY_BIP152_SHORT_ID_LEN``.
+ * :param bytes: The concatenated txids or wtxids of the known transactions,
+ *|    for example those in a mempool.
+ * :param bytes_len: Length of ``bytes`` in bytes. Must be a multiple of ``WALLY_TXHASH_LEN``.
+ * :param indices_out: Destination for the index in ``bytes`` of the
+ *|    transaction matching each short id.
+ * :param len: The number of indices ``indices_out`` can hold. Must be the
+ *|    number of short ids.
+ * :param written: Destination for the number of short ids matched.
+ *
+ * .. note:: Short ids that match no transaction, or more than one, are given
+ *|    the index ``WALLY_BIP152_NO_MATCH``; the transactions for these must be
+ *|    requested from the peer.
+ */
+WALLY_CORE_API int wally_bip152_short_ids_match(
+    const unsigned char *key,
+    size_t key_len,
+    const unsigned char *short_ids,
+    size_t short_ids_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t *indices_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Build a BIP 158 basic filter from a list of scripts.
+ *
+ * :param block_hash: The hash of the block the filter is for.
+ * :param block_hash_len: Size of ``block_hash`` in bytes. Must be ``SHA256_LEN``.
+ * :param bytes: The scripts to include in the filter, concatenated.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param lens: The length of each script in ``bytes``. Each length must
+ *|    be non-zero, and the lengths must sum to ``bytes_len``.
+ * :param lens_len: The number of scripts in ``bytes``.
+ * :param bytes_out: Destination for the serialized filter.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the filter.
+ *
+ * .. note:: Duplicate scripts are included in the filter once.
+ *|    If ``len`` is too small, the required length is returned in
+ *|    ``written`` and nothing is written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_bip158_filter_from_scripts(
+    const unsigned char *block_hash,
+    size_t block_hash_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const uint32_t *lens,
+    size_t lens_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Build the BIP 158 basic filter of a serialized block.
+ *
+ * :param bytes: The serialized block.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param prev_scripts: The scripts spent by each input of the block, in
+ *|    block order and excluding the coinbase input, concatenated.
+ * :param prev_scripts_len: Length of ``prev_scripts`` in bytes.
+ * :param prev_lens: The length of each script in ``prev_scripts``. The
+ *|    lengths must sum to ``prev_scripts_len``.
+ * :param prev_lens_len: The number of scripts in ``prev_scripts``. Must
+ *|    be the number of inputs in the block, excluding the coinbase input.
+ * :param flags: Must be 0. Elements blocks are not supported.
+ * :param bytes_out: Destination for the serialized filter.
+ * :param len: Size of ``bytes_out`` in bytes.
+ * :param written: Destination for the length of the filter.
+ *
+ * .. note:: The filter contains every non-empty, non-OP_RETURN output
+ *|    script and every non-empty spent script, as specified by BIP 158.
+ *|    If ``len`` is too small, the required length is returned in
+ *|    ``written`` and nothing is written to ``bytes_out``.
+ */
+WALLY_CORE_API int wally_block_get_bip158_filter(
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const unsigned char *prev_scripts,
+    size_t prev_scripts_len,
+    const uint32_t *prev_lens,
+    size_t prev_lens_len,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Match a list of scripts against a BIP 158 basic filter.
+ *
+ * :param block_hash: The hash of the block the filter is for.
+ * :param block_hash_len: Size of ``block_hash`` in bytes. Must be ``SHA256_LEN``.
+ * :param filter: The serialized filter.
+ * :param filter_len: Length of ``filter`` in bytes.
+ * :param bytes: The scripts to match, for example those of a wallet, concatenated.
+ * :param bytes_len: Length of ``bytes`` in bytes.
+ * :param lens: The length of each script in ``bytes``. Each length must
+ *|    be non-zero, and the lengths must sum to ``bytes_len``.
+ * :param lens_len: The number of scripts in ``bytes``.
+ * :param written: Destination for the number of scripts that match the filter.
+ *
+ * .. note:: The filter is decoded once for all scripts. As filters are
+ *|    probabilistic, a script may match a filter that does not contain it
+ *|    with a probability of 1 in 784931.
+ */
+WALLY_CORE_API int wally_bip158_filter_match(
+    const unsigned char *block_hash,
+    size_t block_hash_len,
+    const unsigned char *filter,
+    size_t filter_len,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    const uint32_t *lens,
+    size_t lens_len,
+    size_t *written);
+
+/**
+ * Compute the BIP 157 header of a BIP 158 filter.
+ *
+ * :param filter: The serialized filter.
+ * :param filter_len: Length of ``filter`` in bytes.
+ * :param prev_header: The header of the filter of the previous block.
+ * :param prev_header_len: Size of ``prev_header`` in bytes. Must be ``SHA256_LEN``.
+ * :param bytes_out: Destination for the filter header.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_bip158_filter_header(
+    const unsigned char *filter,
+    size_t filter_len,
+    const unsigned char *prev_header,
+    size_t prev_header_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * The type of a function that reads from a stream for a `wally_block_reader`.
+ *
+ * The function should read up to ``len`` bytes into ``bytes_out`` and set
+ * ``written`` to the number read, or to 0 at the end of the stream. Any
+ * return value other than WALLY_OK is returned to the reader's caller.
+ */
+typedef int (*wally_read_fn_t)(
+    void *read_ctx,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/** A reader of blocks from a stream in Bitcoin Core block file format */
+struct wally_block_reader;
+
+/**
+ * Allocate a block reader.
+ *
+ * :param magic: The ``WALLY_NETWORK_MAGIC_`` value of the network whose
+ *|    blocks are read.
+ * :param key: The key that block files are obfuscated with, as stored in
+ *|    Bitcoin Core's ``blocks/xor.dat``, or NULL if they are not obfuscated.
+ * :param key_len: Size of ``key`` in bytes. Must be 8, or 0 if ``key`` is NULL.
+ * :param max_block_len: The size of the largest block to read. The reader
+ *|    allocates a buffer of this size plus 8 bytes, which bounds its memory
+ *|    use. 4000000 is enough for any valid bitcoin block.
+ * :param read_fn: The function to read the stream with. For a file
+ *|    descriptor, this can be a simple wrapper around ``read(2)``.
+ * :param read_ctx: Context passed to ``read_fn``.
+ * :param flags: Must be 0.
+ * :param output: Destination for the resulting reader.
+ *
+ * .. note:: The stream must start at the beginning of a block file, since
+ *|    obfuscation depends on the offset in the file. Several files can be
+ *|    read as one stream if each is a multiple of 8 bytes long, as Bitcoin
+ *|    Core preallocates them to be.
+ */
+WALLY_CORE_API int wally_block_reader_init_alloc(
+    uint32_t magic,
+    const unsigned char *key,
+    size_t key_len,
+    size_t max_block_len,
+    wally_read_fn_t read_fn,
+    void *read_ctx,
+    uint32_t flags,
+    struct wally_block_reader **output);
+
+/**
+ * Free a block reader allocated by `wally_block_reader_init_alloc`.
+ *
+ * :param reader: The reader to free.
+ */
+WALLY_CORE_API int wally_block_reader_free(
+    struct wally_block_reader *reader);
+
+/**
+ * Read the next block from a block reader.
+ *
+ * :param reader: The block reader.
+ * :param block_bytes: Destination for a pointer to the serialized block,
+ *|    or NULL at the end of the stream.
+ * :param block_bytes_len: Destination for the length of the serialized block.
+ *
+ * .. note:: Each block is expected to be framed by the network magic and its
+ *|    length, as in ``blk*.dat`` files. Data up to the next magic, such as
+ *|    the zero padding at the end of block files, is skipped. The returned
+ *|    block is held in the reader's buffer and is valid until the next call
+ *|    that reads from the reader. Returns WALLY_EINVAL if a block is larger
+ *|    than ``max_block_len`` or is truncated.
+ */
+WALLY_CORE_API int wally_block_reader_next_block(
+    struct wally_block_reader *reader,
+    const unsigned char **block_bytes,
+    size_t *block_bytes_len);
+
+/**
+ * Read the next transaction from a block reader.
+ *
+ * :param reader: The block reader.
+ * :param tx_bytes: Destination for a pointer to the serialized transaction,
+ *|    or NULL at the end of the stream.
+ * :param tx_bytes_len: Destination for the length of the serialized transaction.
+ * :param bytes_out: Destination for the txid of the transaction, or NULL.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``, or 0
+ *|    if ``bytes_out`` is NULL.
+ *
+ * .. note:: Transactions are returned from the block last returned by
+ *|    `wally_block_reader_next_block`, then from each following block in
+ *|    turn. The returned transaction is valid until the next call that
+ *|    reads from the reader, and can be decoded with
+ *|    `wally_tx_view_from_bytes` or `wally_tx_from_bytes`.
+ */
+WALLY_CORE_API int wally_block_reader_next_tx(
+    struct wally_block_reader *reader,
+    const unsigned char **tx_bytes,
+    size_t *tx_bytes_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
+/** A set of transactions indexed by txid, wtxid and spent outpoint */
+struct wally_tx_set;
+
+/**
+ * Allocate an empty transaction set.
+ *
+ * :param allocation_len: The number of transactions to pre-allocate space for.
+ * :param flags: Must be 0.
+ * :param output: Destination for the resulting transaction set.
+ */
+WALLY_CORE_API int wally_tx_set_init_alloc(
+    size_t allocation_len,
+    uint32_t flags,
+    struct wally_tx_set **output);
+
+/**
+ * Free a transaction set allocated by `wally_tx_set_init_alloc`.
+ *
+ * :param set: The transaction set to free.
+ */
+WALLY_CORE_API int wally_tx_set_free(
+    struct wally_tx_set *set);
+
+/**
+ * Add a copy of a transaction to a transaction set.
+ *
+ * :param set: The transaction set to add to.
+ * :param tx: The transaction to add. Coinbase and elements transactions
+ *|    are not supported.
+ *
+ * .. note:: Fails with ``WALLY_EINVAL`` if the transaction is already in
+ *|    the set, spends an outpoint that a transaction in the set spends, or
+ *|    spends the same outpoint twice. Use `wally_tx_set_get_conflicts` to
+ *|    find the transactions it conflicts with.
+ */
+WALLY_CORE_API int wally_tx_set_add(
+    struct wally_tx_set *set,
+    const struct wally_tx *tx);
+
+/**
+ * Remove a transaction from a transaction set.
+ *
+ * :param set: The transaction set to remove from.
+ * :param txhash: The txid of the transaction to remove.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ *
+ * .. note:: Transactions spending the outputs of the removed transaction
+ *|    are not removed.
+ */
+WALLY_CORE_API int wally_tx_set_remove(
+    struct wally_tx_set *set,
+    const unsigned char *txhash,
+    size_t txhash_len);
+
+/**
+ * Get the number of transactions in a transaction set.
+ *
+ * :param set: The transaction set.
+ * :param written: Destination for the number of transactions.
+ */
+WALLY_CORE_API int wally_tx_set_get_num_txs(
+    const struct wally_tx_set *set,
+    size_t *written);
+
+/**
+ * Determine whether a transaction is in a transaction set.
+ *
+ * :param set: The transaction set to search.
+ * :param bytes: The txid, or wtxid if ``flags`` is ``WALLY_TX_SET_WTXID``.
+ * :param bytes_len: Size of ``bytes`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param flags: ``WALLY_TX_SET_WTXID`` to look up by wtxid, or 0 for txid.
+ * :param written: Destination for 1 if the transaction is in the set, otherwise 0.
+ */
+WALLY_CORE_API int wally_tx_set_contains(
+    const struct wally_tx_set *set,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    size_t *written);
+
+/**
+ * Get the txid of the transaction in a set that spends an outpoint.
+ *
+ * :param set: The transaction set to search.
+ * :param txhash: The transaction hash of the outpoint.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param utxo_index: The output index of the outpoint.
+ * :param bytes_out: Destination for the txid of the spending transaction.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param written: Destination for the number of bytes written to
+ *|    ``bytes_out``: 0 if no transaction in the set spends the outpoint.
+ */
+WALLY_CORE_API int wally_tx_set_get_spender(
+    const struct wally_tx_set *set,
+    const unsigned char *txhash,
+    size_t txhash_len,
+    uint32_t utxo_index,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Get the txids of the transactions in a set that conflict with a transaction.
+ *
+ * :param set: The transaction set to search.
+ * :param tx: The transaction to find conflicts for.
+ * :param bytes_out: Destination for the txids of the transactions that
+ *|    spend any of the outpoints ``tx`` spends, in input order.
+ * :param len: Size of ``bytes_out`` in bytes. Must be a multiple of
+ *|    ``WALLY_TXHASH_LEN``.
+ * :param written: Destination for the number of bytes written to
+ *|    ``bytes_out``. If ``len`` is too small, the required length is
+ *|    returned and only the txids that fit are written.
+ *
+ * .. note:: A transaction already in the set conflicts with itself.
+ */
+WALLY_CORE_API int wally_tx_set_get_conflicts(
+    const struct wally_tx_set *set,
+    const struct wally_tx *tx,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+/**
+ * Get the txids of the in-set ancestors of a transaction in a set.
+ *
+ * :param set: The transaction set to search.
+ * :param txhash: The txid of the transaction, which must be in the set.
+ * :param txhash_len: Size of ``txhash`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param bytes_out: Destination for the txids of the ancestors, nearest first.
+ * :param len: Size of ``bytes_out`` in bytes. Must be a multiple of
+ *|    ``WALLY_TXHASH_LEN``.
+ * :param written: Destination for the number of bytes written to
+ *|    ``bytes_out``. If ``len`` is too small, the required length is
+ *|    returned and only the txids that fit are written.
+ */
+WALLY_CORE_API int wally_tx_set_get_ancestors(
+    const struct wally_tx_set *set,
+    const unsigned char *txhash,
+    size_t txhash_len,
+    unsigned char *bytes_out,
+    size_t len,
+    size_t *written);
+
+#ifndef SWIG
+/**
+ * Get a transaction from a transaction set.
+ *
+ * :param set: The transaction set to search.
+ * :param bytes: The txid, or wtxid if ``flags`` is ``WALLY_TX_SET_WTXID``.
+ * :param bytes_len: Size of ``bytes`` in bytes. Must be ``WALLY_TXHASH_LEN``.
+ * :param flags: ``WALLY_TX_SET_WTXID`` to look up by wtxid, or 0 for txid.
+ * :param output: Destination for the transaction, or NULL if it is not in
+ *|    the set. The transaction is owned by the set and is valid until it
+ *|    is removed or the set is freed.
+ */
+WALLY_CORE_API int wally_tx_set_get_tx(
+    const struct wally_tx_set *set,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    uint32_t flags,
+    const struct wally_tx **output);
+
+/**
+ * Look up the values spent by a transaction's inputs in a transaction set.
+ *
+ * :param set: The transaction set to search.
+ * :param tx: The transaction whose inputs to look up. Need not be in the set.
+ * :param values_out: Destination for the value spent by each input.
+ * :param values_len: The number of items in ``values_out``. Must match the
+ *|     number of inputs in ``tx``.
+ * :param written: Destination for the number of inputs whose value was found.
+ *
+ * .. note:: Only inputs spending an output of a transaction in the set are
+ *|    written, the values for all other inputs are left unchanged. Callers
+ *|    can fill those values from another source such as
+ *|    `wally_utxo_snapshot_get_prevouts` before computing fees.
+ */
+WALLY_CORE_API int wally_tx_set_get_prevout_values(
+    const struct wally_tx_set *set,
     const struct wally_tx *tx,
+    uint64_t *values_out,
+    size_t values_len,
     size_t *written);
+#endif /* SWIG */
 
 #ifdef BUILD_ELEMENTS
 /**
@@ -883,6 +3328,41 @@ WALLY_CORE_API int wally_tx_get_elements_signature_hash(
     unsigned char *bytes_out,
     size_t len);
 
+/**
+ * Create a Elements transaction for signing and return its hash, using
+ * precomputed BIP 143 hashes.
+ *
+ * This is equivalent to `wally_tx_get_elements_signature_hash`, but avoids
+ * re-hashing the inputs, issuances and outputs of ``tx`` for every input signed.
+ *
+ * :param tx: The transaction to generate the signature hash from.
+ * :param ctx: The context initialized from ``tx``, or NULL to compute the
+ *|     BIP 143 hashes on demand.
+ * :param index: The input index of the input being signed for.
+ * :param script: The scriptSig for the input represented by ``index``.
+ * :param script_len: Size of ``script`` in bytes.
+ * :param value: The (confidential) value spent by the input being signed for. Only used if
+ *|     flags includes WALLY_TX_FLAG_USE_WITNESS, pass 0 otherwise.
+ * :param value_len: Size of ``value`` in bytes.
+ * :param sighash: WALLY_SIGHASH_ flags specifying the type of signature desired.
+ * :param flags: WALLY_TX_FLAG_USE_WITNESS to generate a BIP 143 signature, or 0
+ *|     to generate a pre-segwit Bitcoin signature.
+ * :param bytes_out: Destination for the signature hash.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``SHA256_LEN``.
+ */
+WALLY_CORE_API int wally_tx_get_elements_signature_hash_ctx(
+    const struct wally_tx *tx,
+    const struct wally_tx_sighash_ctx *ctx,
+    size_t index,
+    const unsigned char *script,
+    size_t script_len,
+    const unsigned char *value,
+    size_t value_len,
+    uint32_t sighash,
+    uint32_t flags,
+    unsigned char *bytes_out,
+    size_t len);
+
 /**
  * Calculate the asset entropy from a prevout and the Ricardian contract hash.
  *
@@ -934,6 +3414,81 @@ WALLY_CORE_API int wally_tx_elements_issuance_calculate_reissuance_token(
     unsigned char *bytes_out,
     size_t len);
 
+#ifndef SWIG
+/**
+ * Calculate the asset entropy, asset and re-issuance token of every
+ * issuance input of a transaction.
+ *
+ * :param tx: The elements transaction to calculate the issuances of.
+ * :param index_out: Destination for the input index of each issuance.
+ * :param entropy_out: Destination for the asset entropy of each issuance.
+ * :param entropy_out_len: Size of ``entropy_out`` in bytes. Must be ``SHA256_LEN`` * ``len``.
+ * :param asset_out: Destination for the asset tag of each issuance.
+ * :param asset_out_len: Size of ``asset_out`` in bytes. Must be ``SHA256_LEN`` * ``len``.
+ * :param token_out: Destination for the re-issuance token of each issuance.
+ * :param token_out_len: Size of ``token_out`` in bytes. Must be ``SHA256_LEN`` * ``len``.
+ * :param len: The number of elements in ``index_out``.
+ * :param written: Destination for the number of issuance inputs.
+ *
+ * .. note:: This is equivalent to calling
+ *|    `wally_tx_elements_issuance_generate_entropy`,
+ *|    `wally_tx_elements_issuance_calculate_asset` and
+ *|    `wally_tx_elements_issuance_calculate_reissuance_token` for each
+ *|    input, taking the contract hash from the input's ``entropy`` field.
+ *|    For a re-issuance, ``entropy`` already holds the asset entropy and
+ *|    no token is created, so the token returned is all zeros.
+ *|    Results are written in input order. If ``len`` is too small,
+ *|    ``written`` contains the number of issuance inputs and only the
+ *|    first ``len`` are returned.
+ */
+WALLY_CORE_API int wally_tx_elements_issuance_calculate_ids(
+    const struct wally_tx *tx,
+    uint32_t *index_out,
+    unsigned char *entropy_out,
+    size_t entropy_out_len,
+    unsigned char *asset_out,
+    size_t asset_out_len,
+    unsigned char *token_out,
+    size_t token_out_len,
+    size_t len,
+    size_t *written);
+
+/**
+ * Convert an array of satoshi values to explicit confidential values.
+ *
+ * :param satoshi: The values in satoshi to convert.
+ * :param satoshi_len: The number of elements in ``satoshi``.
+ * :param bytes_out: Destination for the confidential values, each
+ *|    ``WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN`` bytes, in the order of ``satoshi``.
+ * :param len: Size of ``bytes_out`` in bytes. Must be
+ *|    ``WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN`` * ``satoshi_len``.
+ */
+WALLY_CORE_API int wally_tx_confidential_value_from_satoshi_batch(
+    const uint64_t *satoshi,
+    size_t satoshi_len,
+    unsigned char *bytes_out,
+    size_t len);
+
+/**
+ * Convert an array of asset tags to explicit confidential assets.
+ *
+ * :param asset: The asset tags to convert, concatenated.
+ * :param asset_len: Length of ``asset`` in bytes. Must be a non-zero
+ *|    multiple of ``WALLY_TX_ASSET_TAG_LEN``.
+ * :param bytes_out: Destination for the confidential assets, each
+ *|    ``WALLY_TX_ASSET_CT_ASSET_LEN`` bytes, in the order of ``asset``.
+ * :param len: Size of ``bytes_out`` in bytes. Must be ``WALLY_TX_ASSET_CT_ASSET_LEN``
+ *|    * the number of asset tags.
+ *
+ * .. note:: ``bytes_out`` may point to ``asset`` to convert in place.
+ */
+WALLY_CORE_API int wally_tx_confidential_asset_from_tag_batch(
+    const unsigned char *asset,
+    size_t asset_len,
+    unsigned char *bytes_out,
+    size_t len);
+#endif /* SWIG */
+
 #endif /* BUILD_ELEMENTS */
 
 #ifdef __cplusplus
@@ -1,3 +1,13 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <wmmintrin.h>
+#define AES_HW_X86 1
+#elif defined(__GNUC__) && defined(__aarch64__) && !defined(__AARCH64EB__) && \
+    defined(WALLY_ARM_KERNELS)
+#include <arm_neon.h>
+#define AES_HW_ARMV8 1
+#endif
+
 #include "internal.h"
 #include <include/wally_crypto.h>
 #include <stdbool.h>
@@ -5,8 +15,45 @@
 #include "ctaes/ctaes.h"
 #include "ctaes/ctaes.c"
 
+#if defined(AES_HW_X86)
+#include "aes_ni.inl"
+#elif defined(AES_HW_ARMV8)
+#include "aes_armv8.inl"
+#endif
+
 #define ALL_OPS (AES_FLAG_ENCRYPT | AES_FLAG_DECRYPT)
 
+#define AES_MAX_ROUNDS 14
+#define AES_CBC_CHUNK_BLOCKS 8 /* Blocks to decrypt at once in CBC mode */
+
+#ifdef HAVE_AES_HW
+static bool use_aes_hw = false;
+#endif
+
+uint32_t aes_optimize(uint32_t cpu_features)
+{
+#ifdef HAVE_AES_HW
+    if (cpu_features & AES_HW_FEATURE) {
+        use_aes_hw = true; /* Hardware AES is available */
+        return AES_HW_FEATURE;
+    }
+#endif
+    (void)cpu_features;
+    return 0;
+}
+
+/* An expanded AES key, for either ctaes or hardware AES */
+struct wally_aes_ctx {
+    AES256_ctx ct; /* Large enough for AES128_ctx/AES192_ctx as well */
+#ifdef HAVE_AES_HW
+    unsigned char rk_enc[(AES_MAX_ROUNDS + 1) * AES_BLOCK_LEN];
+    unsigned char rk_dec[(AES_MAX_ROUNDS + 1) * AES_BLOCK_LEN];
+    size_t rounds;
+    bool hw;
+#endif
+    size_t key_len;
+};
+
 static bool is_valid_key_len(size_t key_len)
 {
     return key_len == AES_KEY_LEN_128 || key_len == AES_KEY_LEN_192 ||
@@ -20,95 +67,230 @@ static bool are_valid_args(const unsigned char *key, size_t key_len,
            (flags & ALL_OPS) != ALL_OPS;
 }
 
-static void aes_enc(AES256_ctx *ctx,
-                    const unsigned char *key, size_t key_len,
+#ifdef HAVE_AES_HW
+/* FIPS-197 key expansion, using the hardware S-box so that it is also
+ * constant time. For decryption the round keys are converted for the
+ * equivalent inverse cipher used by the AES decryption instructions. */
+static void aes_hw_init(struct wally_aes_ctx *ctx, const unsigned char *key,
+                        size_t key_len, uint32_t flags)
+{
+    uint32_t w[(AES_MAX_ROUNDS + 1) * 4], t;
+    unsigned char rk[(AES_MAX_ROUNDS + 1) * AES_BLOCK_LEN];
+    const size_t nk = key_len / 4, num_words = (nk + 7) * 4;
+    uint32_t rcon = 1;
+    size_t i;
+
+    ctx->rounds = nk + 6;
+    memcpy(w, key, key_len);
+    for (i = nk; i < num_words; ++i) {
+        t = w[i - 1];
+        if (i % nk == 0) {
+            t = aes_hw_subword((t >> 8) | (t << 24)) ^ rcon; /* RotWord */
+            rcon = ((rcon << 1) ^ ((rcon >> 7) * 0x1b)) & 0xff;
+        } else if (nk > 6 && i % nk == 4)
+            t = aes_hw_subword(t);
+        w[i] = w[i - nk] ^ t;
+    }
+    memcpy(rk, w, num_words * sizeof(uint32_t));
+
+    if (flags & AES_FLAG_ENCRYPT)
+        memcpy(ctx->rk_enc, rk, num_words * sizeof(uint32_t));
+    if (flags & AES_FLAG_DECRYPT) {
+        memcpy(ctx->rk_dec, rk + ctx->rounds * AES_BLOCK_LEN, AES_BLOCK_LEN);
+        for (i = 1; i < ctx->rounds; ++i)
+            aes_hw_invmix(ctx->rk_dec + i * AES_BLOCK_LEN,
+                          rk + (ctx->rounds - i) * AES_BLOCK_LEN);
+        memcpy(ctx->rk_dec + ctx->rounds * AES_BLOCK_LEN, rk, AES_BLOCK_LEN);
+    }
+    wally_clear_2(w, sizeof(w), rk, sizeof(rk));
+}
+#endif
+
+/* Expand key for encryption and/or decryption as given by flags */
+static void aes_init(struct wally_aes_ctx *ctx,
+                     const unsigned char *key, size_t key_len,
+                     uint32_t flags)
+{
+    ctx->key_len = key_len;
+#ifdef HAVE_AES_HW
+    if ((ctx->hw = use_aes_hw)) {
+        aes_hw_init(ctx, key, key_len, flags);
+        return;
+    }
+#endif
+    (void)flags;
+    switch (key_len) {
+    case AES_KEY_LEN_128:
+        AES128_init((AES128_ctx *)&ctx->ct, key);
+        break;
+    case AES_KEY_LEN_192:
+        AES192_init((AES192_ctx *)&ctx->ct, key);
+        break;
+    case AES_KEY_LEN_256:
+        AES256_init(&ctx->ct, key);
+        break;
+    }
+}
+
+static void aes_enc(const struct wally_aes_ctx *ctx,
                     const unsigned char *bytes, size_t bytes_len,
                     unsigned char *bytes_out)
 {
     bytes_len /= AES_BLOCK_LEN;
 
-    switch (key_len) {
+#ifdef HAVE_AES_HW
+    if (ctx->hw) {
+        aes_hw_encrypt(ctx->rk_enc, ctx->rounds, bytes_len, bytes_out, bytes);
+        return;
+    }
+#endif
+    switch (ctx->key_len) {
     case AES_KEY_LEN_128:
-        AES128_init((AES128_ctx *)ctx, key);
-        AES128_encrypt((AES128_ctx *)ctx, bytes_len, bytes_out, bytes);
+        AES128_encrypt((const AES128_ctx *)&ctx->ct, bytes_len, bytes_out, bytes);
         break;
 
     case AES_KEY_LEN_192:
-        AES192_init((AES192_ctx *)ctx, key);
-        AES192_encrypt((AES192_ctx *)ctx, bytes_len, bytes_out, bytes);
+        AES192_encrypt((const AES192_ctx *)&ctx->ct, bytes_len, bytes_out, bytes);
         break;
 
     case AES_KEY_LEN_256:
-        AES256_init(ctx, key);
-        AES256_encrypt(ctx, bytes_len, bytes_out, bytes);
+        AES256_encrypt(&ctx->ct, bytes_len, bytes_out, bytes);
         break;
     }
 }
 
-static void aes_dec(AES256_ctx *ctx,
-                    const unsigned char *key, size_t key_len,
+static void aes_dec(const struct wally_aes_ctx *ctx,
                     const unsigned char *bytes, size_t bytes_len,
                     unsigned char *bytes_out)
 {
     bytes_len /= AES_BLOCK_LEN;
 
-    switch (key_len) {
+#ifdef HAVE_AES_HW
+    if (ctx->hw) {
+        aes_hw_decrypt(ctx->rk_dec, ctx->rounds, bytes_len, bytes_out, bytes);
+        return;
+    }
+#endif
+    switch (ctx->key_len) {
     case AES_KEY_LEN_128:
-        AES128_init((AES128_ctx *)ctx, key);
-        AES128_decrypt((AES128_ctx *)ctx, bytes_len, bytes_out, bytes);
+        AES128_decrypt((const AES128_ctx *)&ctx->ct, bytes_len, bytes_out, bytes);
         break;
 
     case AES_KEY_LEN_192:
-        AES192_init((AES192_ctx *)ctx, key);
-        AES192_decrypt((AES192_ctx *)ctx, bytes_len, bytes_out, bytes);
+        AES192_decrypt((const AES192_ctx *)&ctx->ct, bytes_len, bytes_out, bytes);
         break;
 
     case AES_KEY_LEN_256:
-        AES256_init(ctx, key);
-        AES256_decrypt(ctx, bytes_len, bytes_out, bytes);
+        AES256_decrypt(&ctx->ct, bytes_len, bytes_out, bytes);
         break;
     }
 }
 
-int wally_aes(const unsigned char *key, size_t key_len,
-              const unsigned char *bytes, size_t bytes_len,
-              uint32_t flags,
-              unsigned char *bytes_out, size_t len)
+static int aes_impl(const struct wally_aes_ctx *ctx,
+                    const unsigned char *bytes, size_t bytes_len,
+                    uint32_t flags,
+                    unsigned char *bytes_out, size_t len)
 {
-    AES256_ctx ctx;
-
-    if (!are_valid_args(key, key_len, bytes, flags) ||
+    if (!bytes || (flags & ALL_OPS) == ALL_OPS ||
         len % AES_BLOCK_LEN || !bytes_len || bytes_len % AES_BLOCK_LEN ||
         flags & ~ALL_OPS || !bytes_out || !len)
         return WALLY_EINVAL;
 
     if (flags & AES_FLAG_ENCRYPT)
-        aes_enc(&ctx, key, key_len, bytes, bytes_len, bytes_out);
+        aes_enc(ctx, bytes, bytes_len, bytes_out);
     else
-        aes_dec(&ctx, key, key_len, bytes, bytes_len, bytes_out);
-
-    wally_clear(&ctx, sizeof(ctx));
+        aes_dec(ctx, bytes, bytes_len, bytes_out);
     return WALLY_OK;
 }
 
-int wally_aes_cbc(const unsigned char *key, size_t key_len,
-                  const unsigned char *iv, size_t iv_len,
-                  const unsigned char *bytes, size_t bytes_len,
-                  uint32_t flags,
-                  unsigned char *bytes_out, size_t len,
-                  size_t *written)
+/* CBC encrypt whole blocks, updating chain to the last ciphertext block */
+static void aes_cbc_enc_blocks(const struct wally_aes_ctx *ctx,
+                               unsigned char *chain,
+                               const unsigned char *bytes, size_t blocks,
+                               unsigned char *bytes_out)
+{
+    size_t i, n;
+
+    for (i = 0; i < blocks; ++i) {
+        for (n = 0; n < AES_BLOCK_LEN; ++n)
+            chain[n] ^= bytes[n];
+        aes_enc(ctx, chain, AES_BLOCK_LEN, chain);
+        memcpy(bytes_out, chain, AES_BLOCK_LEN);
+        bytes += AES_BLOCK_LEN;
+        bytes_out += AES_BLOCK_LEN;
+    }
+}
+
+/* CBC decrypt whole blocks, updating chain to the last ciphertext block */
+static void aes_cbc_dec_blocks(const struct wally_aes_ctx *ctx,
+                               unsigned char *chain,
+                               const unsigned char *bytes, size_t blocks,
+                               unsigned char *bytes_out)
 {
-    unsigned char buf[AES_BLOCK_LEN];
-    AES256_ctx ctx;
-    size_t i, n, blocks;
-    unsigned char remainder;
+    /* Decryption is not chained, so decrypt several blocks at once */
+    unsigned char chunk[AES_CBC_CHUNK_BLOCKS * AES_BLOCK_LEN];
+    size_t i, j, n, num;
+
+    for (i = 0; i < blocks; i += num) {
+        num = blocks - i < AES_CBC_CHUNK_BLOCKS ? blocks - i : AES_CBC_CHUNK_BLOCKS;
+        aes_dec(ctx, bytes, num * AES_BLOCK_LEN, chunk);
+        for (j = num - 1; j > 0; --j)
+            for (n = 0; n < AES_BLOCK_LEN; ++n)
+                chunk[j * AES_BLOCK_LEN + n] ^= bytes[(j - 1) * AES_BLOCK_LEN + n];
+        for (n = 0; n < AES_BLOCK_LEN; ++n)
+            chunk[n] ^= chain[n];
+        /* Keep the last ciphertext block, as bytes may equal bytes_out */
+        memcpy(chain, bytes + (num - 1) * AES_BLOCK_LEN, AES_BLOCK_LEN);
+        memcpy(bytes_out, chunk, num * AES_BLOCK_LEN);
+        bytes += num * AES_BLOCK_LEN;
+        bytes_out += num * AES_BLOCK_LEN;
+    }
+    wally_clear(chunk, sizeof(chunk));
+}
+
+/* Add PKCS#7 padding to the remainder bytes in buf and encrypt it */
+static void aes_cbc_enc_final(const struct wally_aes_ctx *ctx,
+                              unsigned char *chain,
+                              unsigned char *buf, size_t remainder,
+                              unsigned char *bytes_out)
+{
+    memset(buf + remainder, AES_BLOCK_LEN - remainder, AES_BLOCK_LEN - remainder);
+    aes_cbc_enc_blocks(ctx, chain, buf, 1, bytes_out);
+}
+
+/* Decrypt the final block in place, returning the unpadded length */
+static size_t aes_cbc_dec_final(const struct wally_aes_ctx *ctx,
+                                const unsigned char *prev, unsigned char *buf)
+{
+    size_t n, remainder;
+
+    aes_dec(ctx, buf, AES_BLOCK_LEN, buf);
+    for (n = 0; n < AES_BLOCK_LEN; ++n)
+        buf[n] = prev[n] ^ buf[n];
+
+    /* Modulo the resulting padding amount to the block size - we do
+     * not attempt to verify the decryption by checking the padding in
+     * the decrypted block. */
+    remainder = AES_BLOCK_LEN - (buf[AES_BLOCK_LEN - 1] % AES_BLOCK_LEN);
+    return remainder == AES_BLOCK_LEN ? 0 : remainder;
+}
+
+static int aes_cbc_impl(const struct wally_aes_ctx *ctx,
+                        const unsigned char *iv, size_t iv_len,
+                        const unsigned char *bytes, size_t bytes_len,
+                        uint32_t flags,
+                        unsigned char *bytes_out, size_t len,
+                        size_t *written)
+{
+    unsigned char buf[AES_BLOCK_LEN], chain[AES_BLOCK_LEN];
+    size_t blocks, remainder;
 
     if (written)
         *written = 0;
 
-    if (!are_valid_args(key, key_len, bytes, flags) ||
+    if (!bytes || (flags & ALL_OPS) == ALL_OPS ||
         ((flags & AES_FLAG_ENCRYPT) && (len % AES_BLOCK_LEN)) ||
-        ((flags & AES_FLAG_DECRYPT) && (bytes_len % AES_BLOCK_LEN)) ||
+        ((flags & AES_FLAG_DECRYPT) && (!bytes_len || bytes_len % AES_BLOCK_LEN)) ||
         !iv || iv_len != AES_BLOCK_LEN || flags & ~ALL_OPS || !written)
         return WALLY_EINVAL;
 
@@ -121,59 +303,265 @@ int wally_aes_cbc(const unsigned char *key, size_t key_len,
     } else {
         /* Determine output length from decrypted final block */
         const unsigned char *last = bytes + bytes_len - AES_BLOCK_LEN;
-        const unsigned char *prev = last - AES_BLOCK_LEN;
 
-        if (!--blocks)
-            prev = iv;
-        aes_dec(&ctx, key, key_len, last, AES_BLOCK_LEN, buf);
-        for (n = 0; n < AES_BLOCK_LEN; ++n)
-            buf[n] = prev[n] ^ buf[n];
-
-        /* Modulo the resulting padding amount to the block size - we do
-         * not attempt to verify the decryption by checking the padding in
-         * the decrypted block. */
-        remainder = AES_BLOCK_LEN - (buf[AES_BLOCK_LEN - 1] % AES_BLOCK_LEN);
-        if (remainder == AES_BLOCK_LEN)
-            remainder = 0;
+        memcpy(buf, last, AES_BLOCK_LEN);
+        --blocks;
+        remainder = aes_cbc_dec_final(ctx, blocks ? last - AES_BLOCK_LEN : iv, buf);
         *written = blocks * AES_BLOCK_LEN + remainder;
     }
     if (len < *written || !*written)
         goto finish; /* Inform caller how much space is needed */
 
     if (!bytes_out) {
-        wally_clear_2(buf, sizeof(buf), &ctx, sizeof(ctx));
+        wally_clear(buf, sizeof(buf));
         return WALLY_EINVAL;
     }
 
-    if (flags & AES_FLAG_DECRYPT)
+    memcpy(chain, iv, AES_BLOCK_LEN);
+    if (flags & AES_FLAG_ENCRYPT) {
+        aes_cbc_enc_blocks(ctx, chain, bytes, blocks, bytes_out);
+        bytes += blocks * AES_BLOCK_LEN;
+        bytes_out += blocks * AES_BLOCK_LEN;
+        memcpy(buf, bytes, remainder);
+        aes_cbc_enc_final(ctx, chain, buf, remainder, bytes_out);
+    } else {
         memcpy(bytes_out + blocks * AES_BLOCK_LEN, buf, remainder);
+        aes_cbc_dec_blocks(ctx, chain, bytes, blocks, bytes_out);
+    }
 
-    for (i = 0; i < blocks; ++i) {
-        if (flags & AES_FLAG_ENCRYPT) {
-            for (n = 0; n < AES_BLOCK_LEN; ++n)
-                buf[n] = bytes[n] ^ iv[n];
-            aes_enc(&ctx, key, key_len, buf, AES_BLOCK_LEN, bytes_out);
-            iv = bytes_out;
-        } else {
-            aes_dec(&ctx, key, key_len, bytes, AES_BLOCK_LEN, bytes_out);
-            for (n = 0; n < AES_BLOCK_LEN; ++n)
-                bytes_out[n] = bytes_out[n] ^ iv[n];
-            iv = bytes;
+finish:
+    wally_clear_2(buf, sizeof(buf), chain, sizeof(chain));
+    return WALLY_OK;
+}
+
+int wally_aes(const unsigned char *key, size_t key_len,
+              const unsigned char *bytes, size_t bytes_len,
+              uint32_t flags,
+              unsigned char *bytes_out, size_t len)
+{
+    struct wally_aes_ctx ctx;
+    int ret;
+
+    if (!are_valid_args(key, key_len, bytes, flags))
+        return WALLY_EINVAL;
+
+    aes_init(&ctx, key, key_len, flags & ALL_OPS);
+    ret = aes_impl(&ctx, bytes, bytes_len, flags, bytes_out, len);
+    wally_clear(&ctx, sizeof(ctx));
+    return ret;
+}
+
+int wally_aes_cbc(const unsigned char *key, size_t key_len,
+                  const unsigned char *iv, size_t iv_len,
+                  const unsigned char *bytes, size_t bytes_len,
+                  uint32_t flags,
+                  unsigned char *bytes_out, size_t len,
+                  size_t *written)
+{
+    struct wally_aes_ctx ctx;
+    int ret;
+
+    if (written)
+        *written = 0;
+
+    if (!are_valid_args(key, key_len, bytes, flags))
+        return WALLY_EINVAL;
+
+    aes_init(&ctx, key, key_len, flags & ALL_OPS);
+    ret = aes_cbc_impl(&ctx, iv, iv_len, bytes, bytes_len, flags,
+                       bytes_out, len, written);
+    wally_clear(&ctx, sizeof(ctx));
+    return ret;
+}
+
+int wally_aes_ctx_init_alloc(const unsigned char *key, size_t key_len,
+                             struct wally_aes_ctx **output)
+{
+    if (output)
+        *output = NULL;
+
+    if (!key || !is_valid_key_len(key_len) || !output)
+        return WALLY_EINVAL;
+
+    if (!(*output = wally_malloc(sizeof(**output))))
+        return WALLY_ENOMEM;
+    aes_init(*output, key, key_len, ALL_OPS);
+    return WALLY_OK;
+}
+
+int wally_aes_ctx_compute(const struct wally_aes_ctx *ctx,
+                          const unsigned char *bytes, size_t bytes_len,
+                          uint32_t flags,
+                          unsigned char *bytes_out, size_t len)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+    return aes_impl(ctx, bytes, bytes_len, flags, bytes_out, len);
+}
+
+int wally_aes_cbc_ctx_compute(const struct wally_aes_ctx *ctx,
+                              const unsigned char *iv, size_t iv_len,
+                              const unsigned char *bytes, size_t bytes_len,
+                              uint32_t flags,
+                              unsigned char *bytes_out, size_t len,
+                              size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!ctx)
+        return WALLY_EINVAL;
+    return aes_cbc_impl(ctx, iv, iv_len, bytes, bytes_len, flags,
+                        bytes_out, len, written);
+}
+
+int wally_aes_ctx_free(struct wally_aes_ctx *ctx)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+    wally_clear(ctx, sizeof(*ctx));
+    wally_free(ctx);
+    return WALLY_OK;
+}
+
+/* The state of a streaming CBC encryption or decryption */
+struct wally_aes_cbc_stream {
+    struct wally_aes_ctx ctx;
+    unsigned char chain[AES_BLOCK_LEN]; /* The previous ciphertext block */
+    unsigned char buf[AES_BLOCK_LEN]; /* Input not yet processed */
+    size_t buf_len;
+    uint32_t flags;
+};
+
+int wally_aes_cbc_stream_init_alloc(const unsigned char *key, size_t key_len,
+                                    const unsigned char *iv, size_t iv_len,
+                                    uint32_t flags,
+                                    struct wally_aes_cbc_stream **output)
+{
+    if (output)
+        *output = NULL;
+
+    if (!key || !is_valid_key_len(key_len) || !iv || iv_len != AES_BLOCK_LEN ||
+        (flags != AES_FLAG_ENCRYPT && flags != AES_FLAG_DECRYPT) || !output)
+        return WALLY_EINVAL;
+
+    if (!(*output = wally_malloc(sizeof(**output))))
+        return WALLY_ENOMEM;
+    aes_init(&(*output)->ctx, key, key_len, flags);
+    memcpy((*output)->chain, iv, AES_BLOCK_LEN);
+    (*output)->buf_len = 0;
+    (*output)->flags = flags;
+    return WALLY_OK;
+}
+
+int wally_aes_cbc_stream_update(struct wally_aes_cbc_stream *stream,
+                                const unsigned char *bytes, size_t bytes_len,
+                                unsigned char *bytes_out, size_t len,
+                                size_t *written)
+{
+    size_t blocks, keep, head;
+
+    if (written)
+        *written = 0;
+
+    if (!stream || !stream->flags || (!bytes && bytes_len) || !written ||
+        bytes_len > SIZE_MAX - AES_BLOCK_LEN)
+        return WALLY_EINVAL;
+
+    blocks = (stream->buf_len + bytes_len) / AES_BLOCK_LEN;
+    keep = (stream->buf_len + bytes_len) % AES_BLOCK_LEN;
+    if (stream->flags & AES_FLAG_DECRYPT && blocks && !keep) {
+        /* Hold back the last block, which contains the padding */
+        --blocks;
+        keep = AES_BLOCK_LEN;
+    }
+    *written = blocks * AES_BLOCK_LEN;
+    if (len < *written)
+        return WALLY_OK; /* Inform caller how much space is needed */
+
+    if (blocks) {
+        if (!bytes_out) {
+            *written = 0;
+            return WALLY_EINVAL;
         }
-        bytes += AES_BLOCK_LEN;
-        bytes_out += AES_BLOCK_LEN;
+        if (stream->buf_len) {
+            /* Complete and process the buffered block first */
+            head = AES_BLOCK_LEN - stream->buf_len;
+            memcpy(stream->buf + stream->buf_len, bytes, head);
+            bytes += head;
+            bytes_len -= head;
+            if (stream->flags & AES_FLAG_ENCRYPT)
+                aes_cbc_enc_blocks(&stream->ctx, stream->chain, stream->buf, 1, bytes_out);
+            else
+                aes_cbc_dec_blocks(&stream->ctx, stream->chain, stream->buf, 1, bytes_out);
+            bytes_out += AES_BLOCK_LEN;
+            stream->buf_len = 0;
+            --blocks;
+        }
+        if (stream->flags & AES_FLAG_ENCRYPT)
+            aes_cbc_enc_blocks(&stream->ctx, stream->chain, bytes, blocks, bytes_out);
+        else
+            aes_cbc_dec_blocks(&stream->ctx, stream->chain, bytes, blocks, bytes_out);
+        bytes += blocks * AES_BLOCK_LEN;
+        bytes_len -= blocks * AES_BLOCK_LEN;
     }
+    /* Buffer whatever remains */
+    if (bytes_len)
+        memcpy(stream->buf + stream->buf_len, bytes, bytes_len);
+    stream->buf_len = keep;
+    return WALLY_OK;
+}
 
-    if (flags & AES_FLAG_ENCRYPT) {
-        for (n = 0; n < remainder; ++n)
-            buf[n] = bytes[n] ^ iv[n];
-        remainder = 16 - remainder;
-        for (; n < AES_BLOCK_LEN; ++n)
-            buf[n] = remainder ^ iv[n];
-        aes_enc(&ctx, key, key_len, buf, AES_BLOCK_LEN, bytes_out);
+int wally_aes_cbc_stream_final(struct wally_aes_cbc_stream *stream,
+                               unsigned char *bytes_out, size_t len,
+                               size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!stream || !stream->flags || !written ||
+        (stream->flags & AES_FLAG_DECRYPT && stream->buf_len != AES_BLOCK_LEN))
+        return WALLY_EINVAL;
+
+    if (stream->flags & AES_FLAG_ENCRYPT) {
+        *written = AES_BLOCK_LEN;
+        if (len < *written)
+            return WALLY_OK; /* Inform caller how much space is needed */
+        if (!bytes_out) {
+            *written = 0;
+            return WALLY_EINVAL;
+        }
+        aes_cbc_enc_final(&stream->ctx, stream->chain, stream->buf,
+                          stream->buf_len, bytes_out);
+    } else {
+        unsigned char buf[AES_BLOCK_LEN];
+
+        /* Determine output length from decrypted final block */
+        memcpy(buf, stream->buf, AES_BLOCK_LEN);
+        *written = aes_cbc_dec_final(&stream->ctx, stream->chain, buf);
+        if (len < *written) {
+            wally_clear(buf, sizeof(buf));
+            return WALLY_OK; /* Inform caller how much space is needed */
+        }
+        if (*written && !bytes_out) {
+            wally_clear(buf, sizeof(buf));
+            *written = 0;
+            return WALLY_EINVAL;
+        }
+        memcpy(bytes_out, buf, *written);
+        wally_clear(buf, sizeof(buf));
     }
+    /* The stream cannot be used again once finalized */
+    wally_clear_2(stream->chain, sizeof(stream->chain), stream->buf, sizeof(stream->buf));
+    stream->buf_len = 0;
+    stream->flags = 0;
+    return WALLY_OK;
+}
 
-finish:
-    wally_clear_2(buf, sizeof(buf), &ctx, sizeof(ctx));
+int wally_aes_cbc_stream_free(struct wally_aes_cbc_stream *stream)
+{
+    if (!stream)
+        return WALLY_EINVAL;
+    wally_clear(stream, sizeof(*stream));
+    wally_free(stream);
     return WALLY_OK;
 }
@@ -0,0 +1,57 @@
+/* AES using the ARMv8 cryptography extensions, which are constant time */
+#define HAVE_AES_HW 1
+#define AES_HW_FEATURE WALLY_CPU_AES_ARMV8
+#if defined(__clang__)
+#define AES_HW_TARGET __attribute__((target("crypto")))
+#else
+#define AES_HW_TARGET __attribute__((target("+crypto")))
+#endif
+
+/* Apply the AES S-box to each byte of w */
+AES_HW_TARGET static uint32_t aes_hw_subword(uint32_t w)
+{
+    /* With all columns equal ShiftRows has no effect, so AESE with a zero
+     * key returns SubWord(w) in each lane */
+    const uint8x16_t v = vreinterpretq_u8_u32(vdupq_n_u32(w));
+    return vgetq_lane_u32(vreinterpretq_u32_u8(vaeseq_u8(v, vdupq_n_u8(0))), 0);
+}
+
+/* Apply InvMixColumns to the round key rk */
+AES_HW_TARGET static void aes_hw_invmix(unsigned char *rk_out, const unsigned char *rk)
+{
+    vst1q_u8(rk_out, vaesimcq_u8(vld1q_u8(rk)));
+}
+
+AES_HW_TARGET static void aes_hw_encrypt(const unsigned char *rk, size_t rounds,
+                                         size_t blocks, unsigned char *out,
+                                         const unsigned char *in)
+{
+    size_t i, r;
+
+    for (i = 0; i < blocks; ++i) {
+        uint8x16_t x = vld1q_u8(in);
+        for (r = 0; r < rounds - 1; ++r)
+            x = vaesmcq_u8(vaeseq_u8(x, vld1q_u8(rk + r * AES_BLOCK_LEN)));
+        x = vaeseq_u8(x, vld1q_u8(rk + (rounds - 1) * AES_BLOCK_LEN));
+        vst1q_u8(out, veorq_u8(x, vld1q_u8(rk + rounds * AES_BLOCK_LEN)));
+        in += AES_BLOCK_LEN;
+        out += AES_BLOCK_LEN;
+    }
+}
+
+AES_HW_TARGET static void aes_hw_decrypt(const unsigned char *rk, size_t rounds,
+                                         size_t blocks, unsigned char *out,
+                                         const unsigned char *in)
+{
+    size_t i, r;
+
+    for (i = 0; i < blocks; ++i) {
+        uint8x16_t x = vld1q_u8(in);
+        for (r = 0; r < rounds - 1; ++r)
+            x = vaesimcq_u8(vaesdq_u8(x, vld1q_u8(rk + r * AES_BLOCK_LEN)));
+        x = vaesdq_u8(x, vld1q_u8(rk + (rounds - 1) * AES_BLOCK_LEN));
+        vst1q_u8(out, veorq_u8(x, vld1q_u8(rk + rounds * AES_BLOCK_LEN)));
+        in += AES_BLOCK_LEN;
+        out += AES_BLOCK_LEN;
+    }
+}
@@ -0,0 +1,95 @@
+/* AES using the x86 AES-NI instructions, which are constant time */
+#define HAVE_AES_HW 1
+#define AES_HW_FEATURE WALLY_CPU_AES_NI
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+
+/* Apply the AES S-box to each byte of w */
+AES_HW_TARGET static uint32_t aes_hw_subword(uint32_t w)
+{
+    /* AESKEYGENASSIST returns SubWord(dword 1) in dword 0 */
+    const __m128i v = _mm_set_epi32(0, 0, (int)w, 0);
+    return (uint32_t)_mm_cvtsi128_si32(_mm_aeskeygenassist_si128(v, 0));
+}
+
+/* Apply InvMixColumns to the round key rk */
+AES_HW_TARGET static void aes_hw_invmix(unsigned char *rk_out, const unsigned char *rk)
+{
+    const __m128i k = _mm_loadu_si128((const __m128i *)rk);
+    _mm_storeu_si128((__m128i *)rk_out, _mm_aesimc_si128(k));
+}
+
+AES_HW_TARGET static void aes_hw_encrypt(const unsigned char *rk, size_t rounds,
+                                         size_t blocks, unsigned char *out,
+                                         const unsigned char *in)
+{
+    const __m128i *k = (const __m128i *)rk;
+    __m128i x0, x1, x2, x3;
+    size_t i, r;
+
+    /* Encrypt four blocks at a time to hide the AESENC latency */
+    for (i = 0; i + 4 <= blocks; i += 4) {
+        x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(k));
+        x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 1), _mm_loadu_si128(k));
+        x2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 2), _mm_loadu_si128(k));
+        x3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 3), _mm_loadu_si128(k));
+        for (r = 1; r < rounds; ++r) {
+            const __m128i kr = _mm_loadu_si128(k + r);
+            x0 = _mm_aesenc_si128(x0, kr);
+            x1 = _mm_aesenc_si128(x1, kr);
+            x2 = _mm_aesenc_si128(x2, kr);
+            x3 = _mm_aesenc_si128(x3, kr);
+        }
+        _mm_storeu_si128((__m128i *)out, _mm_aesenclast_si128(x0, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 1, _mm_aesenclast_si128(x1, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 2, _mm_aesenclast_si128(x2, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 3, _mm_aesenclast_si128(x3, _mm_loadu_si128(k + rounds)));
+        in += 4 * AES_BLOCK_LEN;
+        out += 4 * AES_BLOCK_LEN;
+    }
+    for (; i < blocks; ++i) {
+        x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(k));
+        for (r = 1; r < rounds; ++r)
+            x0 = _mm_aesenc_si128(x0, _mm_loadu_si128(k + r));
+        _mm_storeu_si128((__m128i *)out, _mm_aesenclast_si128(x0, _mm_loadu_si128(k + rounds)));
+        in += AES_BLOCK_LEN;
+        out += AES_BLOCK_LEN;
+    }
+}
+
+AES_HW_TARGET static void aes_hw_decrypt(const unsigned char *rk, size_t rounds,
+                                         size_t blocks, unsigned char *out,
+                                         const unsigned char *in)
+{
+    const __m128i *k = (const __m128i *)rk;
+    __m128i x0, x1, x2, x3;
+    size_t i, r;
+
+    /* Decrypt four blocks at a time to hide the AESDEC latency */
+    for (i = 0; i + 4 <= blocks; i += 4) {
+        x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(k));
+        x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 1), _mm_loadu_si128(k));
+        x2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 2), _mm_loadu_si128(k));
+        x3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in + 3), _mm_loadu_si128(k));
+        for (r = 1; r < rounds; ++r) {
+            const __m128i kr = _mm_loadu_si128(k + r);
+            x0 = _mm_aesdec_si128(x0, kr);
+            x1 = _mm_aesdec_si128(x1, kr);
+            x2 = _mm_aesdec_si128(x2, kr);
+            x3 = _mm_aesdec_si128(x3, kr);
+        }
+        _mm_storeu_si128((__m128i *)out, _mm_aesdeclast_si128(x0, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 1, _mm_aesdeclast_si128(x1, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 2, _mm_aesdeclast_si128(x2, _mm_loadu_si128(k + rounds)));
+        _mm_storeu_si128((__m128i *)out + 3, _mm_aesdeclast_si128(x3, _mm_loadu_si128(k + rounds)));
+        in += 4 * AES_BLOCK_LEN;
+        out += 4 * AES_BLOCK_LEN;
+    }
+    for (; i < blocks; ++i) {
+        x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(k));
+        for (r = 1; r < rounds; ++r)
+            x0 = _mm_aesdec_si128(x0, _mm_loadu_si128(k + r));
+        _mm_storeu_si128((__m128i *)out, _mm_aesdeclast_si128(x0, _mm_loadu_si128(k + rounds)));
+        in += AES_BLOCK_LEN;
+        out += AES_BLOCK_LEN;
+    }
+}
@@ -2,12 +2,21 @@
 #include "base58.h"
 #include "ccan/ccan/crypto/sha256/sha256.h"
 #include "ccan/ccan/endian/endian.h"
+#include <include/wally_bip32.h>
 #include <include/wally_crypto.h>
 
 /* Temporary stack buffer sizes */
-#define BIGNUM_WORDS 128u
+#define BIGNUM_WORDS ((size_t)WALLY_BASE58_STACK_WORDS)
 #define BIGNUM_BYTES (BIGNUM_WORDS * sizeof(uint32_t))
 #define BASE58_ALL_DEFINED_FLAGS (BASE58_FLAG_CHECKSUM)
+#define BATCH_STACK_BYTES 128u
+#define BASE58_LIMB 656356768u /* 58^5, the largest power of 58 in 32 bits */
+/* Serialized extended keys with checksums: 82 bytes, 111 base 58 digits */
+#define XKEY_BYTES (BIP32_SERIALIZED_LEN + BASE58_CHECKSUM_LEN)
+#define XKEY_LIMBS ((BASE58_XKEY_LEN + 4) / 5)
+#define XKEY_WORDS ((XKEY_BYTES + 3) / 4)
+/* The number of extended key checksums computed together */
+#define XKEY_BATCH 8u
 
 static const unsigned char base58_to_byte[256] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* ........ */
@@ -71,13 +80,16 @@ static int base58_decode(const char *base58, size_t base58_len,
 {
     uint32_t bn_buf[BIGNUM_WORDS];
     uint32_t *bn = bn_buf, *top_word, *bn_p;
-    size_t bn_words = 0, ones, cp_len, i;
+    size_t bn_words = 0, ones, cp_len, i, j;
     unsigned char *cp;
     int ret = WALLY_EINVAL;
 
     if (!base58 || !base58_len)
         return WALLY_EINVAL; /* Empty string can't be decoded or represented */
 
+    if (wally_exceeds_input_limit(WALLY_LIMIT_BASE58_LEN, base58_len))
+        return WALLY_EINVAL; /* Decoding is quadratic, refuse over-long input */
+
     /* Process leading '1's */
     for (ones = 0; ones < base58_len && base58[ones] == '1'; ++ones)
         ; /* no-op*/
@@ -101,26 +113,30 @@ static int base58_decode(const char *base58, size_t base58_len,
             goto cleanup;
         }
 
-    /* Iterate through the characters adding them to our bignum. We keep
-     * track of the current top word to avoid iterating over words that
-     * we know are zero. */
+    /* Iterate through the characters adding them to our bignum, up to 5 at
+     * a time since 58^5 fits in a uint32_t. We keep track of the current
+     * top word to avoid iterating over words that we know are zero. */
     top_word = bn + bn_words - 1;
     *top_word = 0;
 
-    for (i = 0; i < base58_len; ++i) {
-        unsigned char byte = base58_to_byte[((unsigned char *)base58)[i]];
-        if (!byte--)
-            goto cleanup; /* Invalid char */
+    for (i = 0; i < base58_len; ) {
+        uint32_t mult = 1, carry = 0;
+
+        for (j = 0; j < 5 && i < base58_len; ++j, ++i) {
+            unsigned char byte = base58_to_byte[((unsigned char *)base58)[i]];
+            if (!byte--)
+                goto cleanup; /* Invalid char */
+            carry = carry * 58 + byte;
+            mult *= 58;
+        }
 
         for (bn_p = bn + bn_words - 1; bn_p >= top_word; --bn_p) {
-            uint64_t mult = *bn_p * 58ull + byte;
-            *bn_p = mult & 0xffffffff;
-            byte = (mult >> 32) & 0xff;
-            if (byte && bn_p == top_word) {
-                *--top_word = byte; /* Increase bignum size */
-                break;
-            }
+            const uint64_t v = (uint64_t)*bn_p * mult + carry;
+            *bn_p = v & 0xffffffff;
+            carry = v >> 32;
         }
+        if (carry)
+            *--top_word = carry; /* Increase bignum size */
     }
 
     /* We have our bignum stored from top_word to bn + bn_words - 1. Convert
@@ -161,19 +177,22 @@ uint32_t base58_get_checksum(const unsigned char *bytes, size_t bytes_len)
 }
 
 
-int wally_base58_from_bytes(const unsigned char *bytes, size_t bytes_len,
-                            uint32_t flags, char **output)
+/* Encode into a newly allocated string if output is non-NULL, otherwise
+ * into str_out if it is large enough. *written is set to the encoded
+ * length including the NUL terminator in either case.
+ */
+static int base58_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                             uint32_t flags, char **output,
+                             char *str_out, size_t len, size_t *written)
 {
     uint32_t checksum, *cs_p = NULL;
-    unsigned char bn_buf[BIGNUM_BYTES];
-    unsigned char *bn = bn_buf, *top_byte, *bn_p;
-    size_t bn_bytes = 0, zeros, i, orig_len = bytes_len;
+    uint32_t bn_buf[BIGNUM_WORDS];
+    uint32_t *bn = bn_buf, top;
+    size_t bn_words = 0, used = 0, zeros, digits = 0, i, j, orig_len = bytes_len;
+    char *str_p;
     int ret = WALLY_EINVAL;
 
-    if (output)
-        *output = NULL;
-
-    if (!bytes || !bytes_len || (flags & ~BASE58_ALL_DEFINED_FLAGS) || !output)
+    if (!bytes || !bytes_len || (flags & ~BASE58_ALL_DEFINED_FLAGS))
         goto cleanup; /* Invalid argument */
 
     if (flags & BASE58_FLAG_CHECKSUM) {
@@ -188,70 +207,278 @@ int wally_base58_from_bytes(const unsigned char *bytes, size_t bytes_len,
     for (zeros = 0; zeros < bytes_len && !b(zeros); ++zeros)
         ; /* no-op*/
 
-    if (zeros == bytes_len) {
-        if (!(*output = wally_malloc(zeros + 1))) {
-            ret = WALLY_ENOMEM;
-            goto cleanup;
+    if (zeros != bytes_len) {
+        /* Our bignum is stored least significant limb first, with each
+         * limb holding 5 base 58 digits. Size it from the number of digits
+         * required: log(256)/log(58) rounded up */
+        bn_words = ((bytes_len - zeros) * 138 / 100 + 1) / 5 + 1;
+
+        /* Allocate our bignum buffer if it won't fit on the stack */
+        if (bn_words > BIGNUM_WORDS)
+            if (!(bn = wally_malloc(bn_words * sizeof(*bn)))) {
+                bn_words = 0;
+                ret = WALLY_ENOMEM;
+                goto cleanup;
+            }
+
+        /* Add the input to our bignum 32 bits at a time, taking any odd
+         * leading bytes first so the remaining input is whole words */
+        for (i = zeros; i < bytes_len; ) {
+            size_t n = i == zeros && (bytes_len - zeros) % 4 ? (bytes_len - zeros) % 4 : 4;
+            const uint64_t mult = 1ull << (n * 8);
+            uint64_t carry = 0;
+
+            for (j = 0; j < n; ++j)
+                carry = (carry << 8) | b(i + j);
+            i += n;
+
+            for (j = 0; j < used; ++j) {
+                const uint64_t v = bn[j] * mult + carry;
+                bn[j] = v % BASE58_LIMB;
+                carry = v / BASE58_LIMB;
+            }
+            while (carry) {
+                bn[used++] = carry % BASE58_LIMB; /* Increase bignum size */
+                carry /= BASE58_LIMB;
+            }
         }
 
-        memset(*output, '1', zeros);
-        (*output)[zeros] = '\0';
-        return WALLY_OK; /* All 0's */
+        /* All limbs except the top one contribute exactly 5 digits */
+        for (top = bn[used - 1]; top; top /= 58)
+            ++digits;
+        digits += (used - 1) * 5;
     }
 
-    bn_bytes = (bytes_len - zeros) * 138 / 100 + 1; /* log(256)/log(58) rounded up */
+    /* Copy the result */
+    *written = zeros + digits + 1;
 
-    /* Allocate our bignum buffer if it won't fit on the stack */
-    if (bn_bytes > BIGNUM_BYTES)
-        if (!(bn = wally_malloc(bn_bytes))) {
+    if (output) {
+        if (!(*output = wally_malloc(*written))) {
+            *written = 0;
             ret = WALLY_ENOMEM;
             goto cleanup;
         }
+        str_out = *output;
+    } else if (len < *written) {
+        ret = WALLY_OK; /* Not enough room in str_out */
+        goto cleanup;
+    }
 
-    top_byte = bn + bn_bytes - 1;
-    *top_byte = 0;
-
-    for (i = zeros; i < bytes_len; ++i) {
-        uint32_t carry = b(i);
-        for (bn_p = bn + bn_bytes - 1; bn_p >= top_byte; --bn_p) {
-            carry = *bn_p * 256 + carry;
-            *bn_p = carry % 58;
-            carry = carry / 58;
-            if (carry && bn_p == top_byte)
-                *--top_byte = 0; /* Increase bignum size */
+    memset(str_out, '1', zeros);
+    str_p = str_out + zeros + digits;
+    *str_p = '\0';
+    for (i = 0; i < used; ++i) {
+        uint32_t limb = bn[i];
+        for (j = 0; j < 5 && (limb || i != used - 1); ++j) {
+            *--str_p = byte_to_base58[limb % 58];
+            limb /= 58;
         }
     }
 
-    while (!*top_byte && top_byte < bn + bn_bytes - 1)
-        ++top_byte; /* Skip leading zero bytes in our bignum */
+    ret = WALLY_OK;
 
-    /* Copy the result */
-    bn_bytes = bn + bn_bytes - top_byte;
+cleanup:
+    wally_clear(bn, bn_words * sizeof(*bn));
+    if (bn != bn_buf)
+        wally_free(bn);
+    return ret;
+#undef b
+}
 
-    if (!(*output = wally_malloc(zeros + bn_bytes + 1))) {
-        ret = WALLY_ENOMEM;
-        goto cleanup;
+int wally_base58_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                            uint32_t flags, char **output)
+{
+    size_t written;
+
+    if (output)
+        *output = NULL;
+
+    if (!output)
+        return WALLY_EINVAL;
+
+    return base58_from_bytes(bytes, bytes_len, flags, output,
+                             NULL, 0, &written);
+}
+
+int wally_base58_from_bytes_to_buffer(const unsigned char *bytes,
+                                      size_t bytes_len, uint32_t flags,
+                                      char *output, size_t len,
+                                      size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!output || !written)
+        return WALLY_EINVAL;
+
+    return base58_from_bytes(bytes, bytes_len, flags, NULL,
+                             output, len, written);
+}
+
+
+/* As per base58_from_bytes, specialised for the fixed extended key layout */
+static int xkey_encode(const unsigned char *bytes, uint32_t checksum, char *str_out)
+{
+    unsigned char buf[XKEY_BYTES];
+    uint32_t bn[XKEY_LIMBS], limb;
+    size_t used = 0, i, j;
+    char *str_p;
+    int ret = WALLY_EINVAL;
+
+    memcpy(buf, bytes, BIP32_SERIALIZED_LEN);
+    memcpy(buf + BIP32_SERIALIZED_LEN, &checksum, sizeof(checksum));
+
+    /* Add the leading odd bytes, then the remaining whole words */
+    for (i = 0; i < XKEY_BYTES; ) {
+        const size_t n = i ? 4 : XKEY_BYTES % 4;
+        uint64_t carry = 0;
+
+        for (j = 0; j < n; ++j)
+            carry = (carry << 8) | buf[i++];
+
+        for (j = 0; j < used; ++j) {
+            const uint64_t v = ((uint64_t)bn[j] << (n * 8)) + carry;
+            bn[j] = v % BASE58_LIMB;
+            carry = v / BASE58_LIMB;
+        }
+        for (; carry; carry /= BASE58_LIMB)
+            bn[used++] = carry % BASE58_LIMB; /* Cannot overflow: 58^115 > 2^656 */
+    }
+
+    /* The top limb must hold exactly the one digit that 5 does not divide */
+    if (used == XKEY_LIMBS && bn[used - 1] < 58) {
+        str_p = str_out + BASE58_XKEY_LEN;
+        *str_p = '\0';
+        for (i = 0; i < used - 1; ++i) {
+            for (limb = bn[i], j = 0; j < 5; ++j, limb /= 58)
+                *--str_p = byte_to_base58[limb % 58];
+        }
+        *--str_p = byte_to_base58[bn[used - 1]];
+        ret = WALLY_OK;
     }
 
-    memset(*output, '1', zeros);
-    for (i = 0; i < bn_bytes; ++i)
-        (*output)[zeros + i] = byte_to_base58[top_byte[i]];
-    (*output)[zeros + bn_bytes] = '\0';
+    wally_clear_3(buf, sizeof(buf), bn, sizeof(bn), &checksum, sizeof(checksum));
+    return ret;
+}
 
-    ret = WALLY_OK;
+int base58_from_xkey(const unsigned char *bytes, char *str_out)
+{
+    return xkey_encode(bytes, base58_get_checksum(bytes, BIP32_SERIALIZED_LEN), str_out);
+}
+
+int base58_from_xkeys(const unsigned char *bytes, size_t num_keys, char *str_out)
+{
+    struct sha256 sha[XKEY_BATCH];
+    size_t i, j, count;
+    int ret = WALLY_OK;
+
+    for (i = 0; i < num_keys && ret == WALLY_OK; i += count) {
+        count = num_keys - i < XKEY_BATCH ? num_keys - i : XKEY_BATCH;
+        /* Compute the checksums of the whole batch at once */
+        sha256d_batch(sha, bytes + i * BIP32_SERIALIZED_LEN, BIP32_SERIALIZED_LEN, count);
+        for (j = 0; j < count && ret == WALLY_OK; ++j)
+            ret = xkey_encode(bytes + (i + j) * BIP32_SERIALIZED_LEN, sha[j].u.u32[0],
+                              str_out + (i + j) * (BASE58_XKEY_LEN + 1));
+    }
+    wally_clear(sha, sizeof(sha));
+    return ret;
+}
+
+/* As per base58_decode, specialised for the fixed extended key layout */
+int base58_to_xkey(const char *str_in, unsigned char *bytes_out)
+{
+    uint32_t bn[XKEY_WORDS], checksum;
+    size_t used = 0, i, j;
+    int ret = WALLY_EINVAL;
+
+    /* A leading '1' is a zero byte, which no valid key starts with */
+    if (str_in[0] == '1')
+        return WALLY_EINVAL;
+
+    /* Add the leading odd digits, then the remaining groups of 5 */
+    for (i = 0; i < BASE58_XKEY_LEN; ) {
+        const size_t n = i ? 5 : BASE58_XKEY_LEN % 5;
+        uint32_t mult = 1, carry = 0;
+
+        for (j = 0; j < n; ++j, ++i) {
+            unsigned char byte = base58_to_byte[((const unsigned char *)str_in)[i]];
+            if (!byte--)
+                goto cleanup; /* Invalid char */
+            carry = carry * 58 + byte;
+            mult *= 58;
+        }
+
+        for (j = 0; j < used; ++j) {
+            const uint64_t v = (uint64_t)bn[j] * mult + carry;
+            bn[j] = v & 0xffffffff;
+            carry = v >> 32;
+        }
+        if (carry) {
+            if (used == XKEY_WORDS)
+                goto cleanup; /* Too large */
+            bn[used++] = carry;
+        }
+    }
+
+    /* The result must be exactly XKEY_BYTES long, i.e. have a non-zero first byte */
+    if (used != XKEY_WORDS || bn[used - 1] >> 16 || !(bn[used - 1] >> 8))
+        goto cleanup;
+
+    bytes_out[0] = bn[used - 1] >> 8;
+    bytes_out[1] = bn[used - 1] & 0xff;
+    for (i = 0; i < used - 1; ++i) {
+        /* Words are stored least significant first, excluding the checksum */
+        const uint32_t be = cpu_to_be32(bn[used - 2 - i]);
+        if (i == used - 2)
+            memcpy(&checksum, &be, sizeof(be));
+        else
+            memcpy(bytes_out + 2 + i * 4, &be, sizeof(be));
+    }
+
+    if (checksum == base58_get_checksum(bytes_out, BIP32_SERIALIZED_LEN))
+        ret = WALLY_OK;
+    else
+        wally_clear(bytes_out, BIP32_SERIALIZED_LEN);
 
 cleanup:
-    wally_clear(bn, bn_bytes);
-    if (bn != bn_buf)
-        wally_free(bn);
+    wally_clear_2(bn, sizeof(bn), &checksum, sizeof(checksum));
     return ret;
-#undef b
 }
 
+int wally_base58_from_bytes_batch(const unsigned char *bytes, size_t bytes_len,
+                                  size_t item_len, uint32_t flags,
+                                  char *output, size_t len, size_t *written)
+{
+    size_t i, n, total = 0;
+    int ret;
+
+    if (written)
+        *written = 0;
+
+    if (!bytes || !bytes_len || !item_len || bytes_len % item_len ||
+        (flags & ~BASE58_ALL_DEFINED_FLAGS) || !output || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < bytes_len; i += item_len) {
+        /* Once output is full, only compute the required length */
+        const size_t remaining = total < len ? len - total : 0;
+        ret = base58_from_bytes(bytes + i, item_len, flags, NULL,
+                                remaining ? output + total : output,
+                                remaining, &n);
+        if (ret != WALLY_OK) {
+            wally_clear(output, len);
+            return ret;
+        }
+        total += n;
+    }
+    *written = total;
+    return WALLY_OK;
+}
 
 int wally_base58_get_length(const char *str_in, size_t *written)
 {
-    return base58_decode(str_in, strlen(str_in), NULL, written);
+    return base58_decode(str_in, wally_strlen_limited(str_in, WALLY_LIMIT_BASE58_LEN),
+                         NULL, written);
 }
 
 int wally_base58_to_bytes(const char *str_in, uint32_t flags,
@@ -273,7 +500,8 @@ int wally_base58_to_bytes(const char *str_in, uint32_t flags,
         return WALLY_EINVAL; /* No room for checksum */
 
     *written = len;
-    ret = base58_decode(str_in, strlen(str_in), bytes_out, written);
+    ret = base58_decode(str_in, wally_strlen_limited(str_in, WALLY_LIMIT_BASE58_LEN),
+                        bytes_out, written);
     if (!ret && *written > len)
         return WALLY_OK; /* not enough space, return required amount */
 
@@ -296,3 +524,61 @@ int wally_base58_to_bytes(const char *str_in, uint32_t flags,
     }
     return ret;
 }
+
+int wally_base58_to_bytes_batch(const char *str_in, size_t str_in_len,
+                                size_t item_len, uint32_t flags,
+                                unsigned char *bytes_out, size_t len,
+                                size_t *written)
+{
+    unsigned char buf[BATCH_STACK_BYTES], *decoded = buf;
+    const size_t decoded_len = item_len +
+                               (flags & BASE58_FLAG_CHECKSUM ? BASE58_CHECKSUM_LEN : 0);
+    size_t i, n, num_items = 0;
+    uint32_t checksum;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!str_in || !str_in_len || str_in[str_in_len - 1] || !item_len ||
+        (flags & ~BASE58_ALL_DEFINED_FLAGS) || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < str_in_len; ++i)
+        if (!str_in[i])
+            ++num_items;
+
+    if (len < num_items * item_len) {
+        *written = num_items * item_len;
+        return WALLY_OK; /* Not enough room in bytes_out */
+    }
+
+    /* Allocate our decoding buffer if it won't fit on the stack */
+    if (decoded_len > sizeof(buf) && !(decoded = wally_malloc(decoded_len)))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < num_items && ret == WALLY_OK; ++i) {
+        const size_t str_len = strlen(str_in);
+
+        n = decoded_len;
+        if (base58_decode(str_in, str_len, decoded, &n) || n != decoded_len)
+            ret = WALLY_EINVAL; /* Invalid string or wrong decoded length */
+        else if (flags & BASE58_FLAG_CHECKSUM) {
+            checksum = base58_get_checksum(decoded, item_len);
+            if (memcmp(decoded + item_len, &checksum, sizeof(checksum)))
+                ret = WALLY_EINVAL; /* Checksum mismatch */
+        }
+        if (ret == WALLY_OK)
+            memcpy(bytes_out + i * item_len, decoded, item_len);
+        str_in += str_len + 1;
+    }
+
+    wally_clear(decoded, decoded_len);
+    if (decoded != buf)
+        wally_free(decoded);
+    if (ret == WALLY_OK)
+        *written = num_items * item_len;
+    else
+        wally_clear(bytes_out, num_items * item_len);
+    return ret;
+}
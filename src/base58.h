@@ -11,4 +11,47 @@ uint32_t base58_get_checksum(
     const unsigned char *bytes,
     size_t len);
 
+/* The base 58 length of a serialized extended key with its checksum */
+#define BASE58_XKEY_LEN 111u
+
+/**
+ * Base 58 encode a serialized extended key with its checksum.
+ *
+ * @bytes: The BIP32_SERIALIZED_LEN byte serialized key.
+ * @str_out: Destination for the NUL terminated string, which must be
+ *     BASE58_XKEY_LEN + 1 bytes long.
+ *
+ * Fails if the key does not encode to exactly BASE58_XKEY_LEN characters,
+ * which is the case for every key with a valid BIP32 version.
+ */
+int base58_from_xkey(
+    const unsigned char *bytes,
+    char *str_out);
+
+/**
+ * Base 58 encode a batch of serialized extended keys with their checksums.
+ *
+ * @bytes: The serialized keys, BIP32_SERIALIZED_LEN bytes each.
+ * @num_keys: The number of keys in @bytes.
+ * @str_out: Destination for the NUL terminated strings, which must be
+ *     num_keys * (BASE58_XKEY_LEN + 1) bytes long. Each string
+ *     immediately follows the previous one.
+ *
+ * As per base58_from_xkey, but with the checksums computed together.
+ */
+int base58_from_xkeys(
+    const unsigned char *bytes,
+    size_t num_keys,
+    char *str_out);
+
+/**
+ * Decode a base 58 serialized extended key and validate its checksum.
+ *
+ * @str_in: The BASE58_XKEY_LEN character string to decode.
+ * @bytes_out: Destination for the BIP32_SERIALIZED_LEN byte serialized key.
+ */
+int base58_to_xkey(
+    const char *str_in,
+    unsigned char *bytes_out);
+
 #endif /* LIBWALLY_BASE58_H */
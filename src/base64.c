@@ -0,0 +1,428 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <immintrin.h>
+#define HAVE_BASE64_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON) && \
+    defined(WALLY_ARM_KERNELS)
+#include <arm_neon.h>
+/* NEON is mandatory on ARM64, so is always used when enabled */
+#define HAVE_BASE64_NEON 1
+#endif
+
+#include "internal.h"
+#include <stdbool.h>
+
+#define BASE64_ALL_DEFINED_FLAGS 0
+
+static const char base64_alphabet[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* The value of each base 64 character, or 0xFF if invalid */
+static const unsigned char base64_to_byte[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F, /* ...+.../ */
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, /* 01234567 */
+    0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* 89...... */
+
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, /* .ABCDEFG */
+    0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, /* HIJKLMNO */
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, /* PQRSTUVW */
+    0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* XYZ..... */
+
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, /* .abcdefg */
+    0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, /* hijklmno */
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, /* pqrstuvw */
+    0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* xyz..... */
+
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, /* ........ */
+};
+
+#ifdef HAVE_BASE64_AVX2
+static int use_avx2 = 0;
+
+/* Encode 24 bytes at a time, returning the number of bytes encoded.
+ * Each 32 byte load reads 4 bytes past the 24 encoded */
+AVX2_TARGET
+static size_t base64_encode_avx2(const unsigned char *bytes, size_t bytes_len,
+                                 char *out)
+{
+    /* Place each 3 byte group as bytes 1,0,2,1 of a 32 bit lane */
+    const __m256i shuf = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                          1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    /* Offsets from each 6 bit value to its character, by value range */
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                             '/' - 63, 'A', 0, 0,
+                                             'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                             '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                             '/' - 63, 'A', 0, 0);
+    size_t i;
+
+    for (i = 0; i + 28 <= bytes_len; i += 24) {
+        const __m128i lo = _mm_loadu_si128((const __m128i *)(bytes + i));
+        const __m128i hi = _mm_loadu_si128((const __m128i *)(bytes + i + 12));
+        const __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo),
+                                                                      hi, 1), shuf);
+        /* Move each 6 bit field into its own byte */
+        const __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                              _mm256_set1_epi32(0x04000040));
+        const __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                              _mm256_set1_epi32(0x01000010));
+        const __m256i idx = _mm256_or_si256(ac, bd);
+        /* Map 0-25 to 13, 26-51 to 0 and 52-63 to 1-12, to select the offset */
+        __m256i range = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+        range = _mm256_or_si256(range, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx),
+                                                        _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i *)(out + i / 3 * 4),
+                            _mm256_add_epi8(idx, _mm256_shuffle_epi8(offsets, range)));
+    }
+    return i;
+}
+
+/* Decode 32 characters at a time into 24 bytes, returning false if any
+ * are invalid */
+AVX2_TARGET
+static bool base64_decode_avx2(const char *str, size_t str_len,
+                               unsigned char *bytes_out, size_t *written)
+{
+    /* Character classes by low and high nibble: a character is valid
+     * if its classes do not intersect */
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    /* Offsets from each character to its value by high nibble, with '/'
+     * given the offset in slot 1 */
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    /* Pack the 3 low bytes of each 32 bit lane, then the 6 used lanes */
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    size_t i;
+
+    for (i = 0; i + 32 <= str_len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(str + i));
+        const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), mask_2f);
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(v, mask_2f));
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        const __m256i is_2f = _mm256_cmpeq_epi8(v, mask_2f);
+        unsigned char *p = bytes_out + i / 4 * 3;
+
+        if (!_mm256_testz_si256(lo, hi)) {
+            *written = i / 4 * 3;
+            return false;
+        }
+        v = _mm256_add_epi8(v, _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(is_2f, hi_nibbles)));
+        /* Merge 4 6 bit values into 3 bytes in each 32 bit lane */
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), lanes);
+        _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+        _mm_storel_epi64((__m128i *)(p + 16), _mm256_extracti128_si256(v, 1));
+    }
+    *written = i / 4 * 3;
+    return true;
+}
+#endif /* HAVE_BASE64_AVX2 */
+
+#ifdef HAVE_BASE64_NEON
+/* Encode 48 bytes at a time, returning the number of bytes encoded */
+static size_t base64_encode_neon(const unsigned char *bytes, size_t bytes_len,
+                                 char *out)
+{
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    uint8x16x4_t lut;
+    size_t i;
+
+    lut.val[0] = vld1q_u8((const uint8_t *)base64_alphabet);
+    lut.val[1] = vld1q_u8((const uint8_t *)base64_alphabet + 16);
+    lut.val[2] = vld1q_u8((const uint8_t *)base64_alphabet + 32);
+    lut.val[3] = vld1q_u8((const uint8_t *)base64_alphabet + 48);
+
+    for (i = 0; i + 48 <= bytes_len; i += 48) {
+        const uint8x16x3_t v = vld3q_u8(bytes + i);
+        uint8x16x4_t idx;
+
+        idx.val[0] = vshrq_n_u8(v.val[0], 2);
+        idx.val[1] = vandq_u8(vsliq_n_u8(vshrq_n_u8(v.val[1], 4), v.val[0], 4), mask);
+        idx.val[2] = vandq_u8(vsliq_n_u8(vshrq_n_u8(v.val[2], 6), v.val[1], 2), mask);
+        idx.val[3] = vandq_u8(v.val[2], mask);
+        idx.val[0] = vqtbl4q_u8(lut, idx.val[0]);
+        idx.val[1] = vqtbl4q_u8(lut, idx.val[1]);
+        idx.val[2] = vqtbl4q_u8(lut, idx.val[2]);
+        idx.val[3] = vqtbl4q_u8(lut, idx.val[3]);
+        vst4q_u8((uint8_t *)out + i / 3 * 4, idx);
+    }
+    return i;
+}
+
+/* Decode 64 characters at a time into 48 bytes, returning false if any
+ * are invalid */
+static bool base64_decode_neon(const char *str, size_t str_len,
+                               unsigned char *bytes_out, size_t *written)
+{
+    const uint8x16_t offset = vdupq_n_u8(64);
+    uint8x16x4_t lut_lo, lut_hi;
+    size_t i, j;
+
+    for (j = 0; j < 4; ++j) {
+        lut_lo.val[j] = vld1q_u8(base64_to_byte + j * 16);
+        lut_hi.val[j] = vld1q_u8(base64_to_byte + 64 + j * 16);
+    }
+
+    for (i = 0; i + 64 <= str_len; i += 64) {
+        uint8x16x4_t v = vld4q_u8((const uint8_t *)str + i);
+        uint8x16x3_t out;
+        uint8x16_t invalid = vdupq_n_u8(0);
+
+        for (j = 0; j < 4; ++j) {
+            /* Characters of 128 and above look up 0, but set the top bit */
+            const uint8x16_t c = v.val[j];
+            v.val[j] = vqtbx4q_u8(vqtbl4q_u8(lut_lo, c), lut_hi, vsubq_u8(c, offset));
+            invalid = vorrq_u8(invalid, vorrq_u8(v.val[j], c));
+        }
+        if (vmaxvq_u8(invalid) & 0x80) {
+            *written = i / 4 * 3;
+            return false;
+        }
+        out.val[0] = vorrq_u8(vshlq_n_u8(v.val[0], 2), vshrq_n_u8(v.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(v.val[1], 4), vshrq_n_u8(v.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(v.val[2], 6), v.val[3]);
+        vst3q_u8(bytes_out + i / 4 * 3, out);
+    }
+    *written = i / 4 * 3;
+    return true;
+}
+#endif /* HAVE_BASE64_NEON */
+
+uint32_t base64_optimize(uint32_t cpu_features)
+{
+#ifdef HAVE_BASE64_AVX2
+    if (cpu_features & WALLY_CPU_BASE64_AVX2) {
+        use_avx2 = 1; /* AVX2 is available */
+        return WALLY_CPU_BASE64_AVX2;
+    }
+#endif
+    (void)cpu_features;
+#ifdef HAVE_BASE64_NEON
+    return WALLY_CPU_BASE64_NEON;
+#else
+    return 0;
+#endif
+}
+
+static size_t base64_encoded_len(size_t bytes_len)
+{
+    return (bytes_len + 2) / 3 * 4;
+}
+
+static void base64_encode(const unsigned char *bytes, size_t bytes_len,
+                          char *output)
+{
+    size_t i = 0;
+    uint32_t v;
+
+#if defined(HAVE_BASE64_AVX2)
+    if (use_avx2)
+        i = base64_encode_avx2(bytes, bytes_len, output);
+#elif defined(HAVE_BASE64_NEON)
+    i = base64_encode_neon(bytes, bytes_len, output);
+#endif
+    output += i / 3 * 4;
+    for (; i + 3 <= bytes_len; i += 3) {
+        v = (uint32_t)bytes[i] << 16 | (uint32_t)bytes[i + 1] << 8 | bytes[i + 2];
+        *output++ = base64_alphabet[v >> 18];
+        *output++ = base64_alphabet[(v >> 12) & 0x3f];
+        *output++ = base64_alphabet[(v >> 6) & 0x3f];
+        *output++ = base64_alphabet[v & 0x3f];
+    }
+    if (i < bytes_len) {
+        /* Encode the final 1 or 2 bytes, with padding */
+        v = (uint32_t)bytes[i] << 16;
+        if (i + 1 < bytes_len)
+            v |= (uint32_t)bytes[i + 1] << 8;
+        *output++ = base64_alphabet[v >> 18];
+        *output++ = base64_alphabet[(v >> 12) & 0x3f];
+        *output++ = i + 1 < bytes_len ? base64_alphabet[(v >> 6) & 0x3f] : '=';
+        *output++ = '=';
+    }
+    *output = '\0';
+}
+
+int wally_base64_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                            uint32_t flags, char **output)
+{
+    if (output)
+        *output = NULL;
+
+    if (!bytes || flags & ~BASE64_ALL_DEFINED_FLAGS || !output)
+        return WALLY_EINVAL;
+
+    *output = wally_malloc(base64_encoded_len(bytes_len) + 1);
+    if (!*output)
+        return WALLY_ENOMEM;
+
+    base64_encode(bytes, bytes_len, *output);
+    return WALLY_OK;
+}
+
+int wally_base64_from_bytes_to_buffer(const unsigned char *bytes, size_t bytes_len,
+                                      uint32_t flags, char *output, size_t len,
+                                      size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!bytes || flags & ~BASE64_ALL_DEFINED_FLAGS || !output || !written)
+        return WALLY_EINVAL;
+
+    *written = base64_encoded_len(bytes_len) + 1;
+    if (len >= *written)
+        base64_encode(bytes, bytes_len, output);
+    return WALLY_OK;
+}
+
+/* Return the decoded length of a padded base 64 string, or 0 if its
+ * length or padding is invalid */
+static size_t base64_decoded_len(const char *str, size_t str_len)
+{
+    if (!str_len || str_len % 4)
+        return 0;
+    if (str[str_len - 1] != '=')
+        return str_len / 4 * 3;
+    return str_len / 4 * 3 - (str[str_len - 2] == '=' ? 2 : 1);
+}
+
+static int base64_decode(const char *str, size_t str_len,
+                         unsigned char *bytes_out, size_t len, size_t *written)
+{
+    const unsigned char *p = (const unsigned char *)str;
+    const size_t decoded_len = base64_decoded_len(str, str_len);
+    size_t i = 0, done = 0;
+    unsigned char a, b, c, d;
+
+    if (!str_len)
+        return WALLY_OK; /* Empty string */
+    if (!decoded_len)
+        return WALLY_EINVAL;
+    if (len < decoded_len) {
+        *written = decoded_len;
+        return WALLY_OK; /* Not enough room in bytes_out */
+    }
+
+    /* The final group may be padded, so is always decoded below */
+#if defined(HAVE_BASE64_AVX2)
+    if (use_avx2 && !base64_decode_avx2(str, str_len - 4, bytes_out, &done))
+        goto fail;
+#elif defined(HAVE_BASE64_NEON)
+    if (!base64_decode_neon(str, str_len - 4, bytes_out, &done))
+        goto fail;
+#endif
+    for (i = done / 3 * 4; i < str_len - 4; i += 4, done += 3) {
+        a = base64_to_byte[p[i]];
+        b = base64_to_byte[p[i + 1]];
+        c = base64_to_byte[p[i + 2]];
+        d = base64_to_byte[p[i + 3]];
+        if ((a | b | c | d) & 0x80)
+            goto fail;
+        bytes_out[done] = a << 2 | b >> 4;
+        bytes_out[done + 1] = b << 4 | c >> 2;
+        bytes_out[done + 2] = c << 6 | d;
+    }
+
+    a = base64_to_byte[p[i]];
+    b = base64_to_byte[p[i + 1]];
+    c = decoded_len - done > 1 ? base64_to_byte[p[i + 2]] : 0;
+    d = decoded_len - done > 2 ? base64_to_byte[p[i + 3]] : 0;
+    if ((a | b | c | d) & 0x80)
+        goto fail;
+    /* Bits not covered by the decoded bytes must be zero */
+    if ((decoded_len - done == 1 && b & 0xf) || (decoded_len - done == 2 && c & 0x3))
+        goto fail;
+    bytes_out[done] = a << 2 | b >> 4;
+    if (decoded_len - done > 1)
+        bytes_out[done + 1] = b << 4 | c >> 2;
+    if (decoded_len - done > 2)
+        bytes_out[done + 2] = c << 6 | d;
+    *written = decoded_len;
+    return WALLY_OK;
+
+fail:
+    wally_clear(bytes_out, decoded_len);
+    return WALLY_EINVAL;
+}
+
+int wally_base64_to_bytes(const char *str_in, uint32_t flags,
+                          unsigned char *bytes_out, size_t len,
+                          size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!str_in || flags & ~BASE64_ALL_DEFINED_FLAGS ||
+        !bytes_out || !len || !written)
+        return WALLY_EINVAL;
+
+    return base64_decode(str_in, strlen(str_in), bytes_out, len, written);
+}
+
+int wally_base64_n_to_bytes(const char *str_in, size_t str_len, uint32_t flags,
+                            unsigned char *bytes_out, size_t len,
+                            size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!str_in || flags & ~BASE64_ALL_DEFINED_FLAGS ||
+        !bytes_out || !len || !written)
+        return WALLY_EINVAL;
+
+    return base64_decode(str_in, str_len, bytes_out, len, written);
+}
+
+int wally_base64_get_maximum_length(const char *str_in, uint32_t flags,
+                                    size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!str_in || flags & ~BASE64_ALL_DEFINED_FLAGS || !written)
+        return WALLY_EINVAL;
+
+    *written = strlen(str_in) / 4 * 3;
+    return WALLY_OK;
+}
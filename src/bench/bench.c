@@ -0,0 +1,3715 @@
+#include "config.h"
+
+#include <wally_core.h>
+#include <wally_address.h>
+#include <wally_bip32.h>
+#include <wally_bip39.h>
+#include <wally_crypto.h>
+#include <wally_psbt.h>
+#include <wally_script.h>
+#include <wally_transaction.h>
+#ifdef BUILD_ELEMENTS
+#include <wally_elements.h>
+#endif
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+/* Benchmarks for wally operations. Each benchmark's iterations are split
+ * into samples, and the median and 99th percentile time per operation over
+ * the samples are reported. Usage:
+ *
+ *   bench_wally [--json] [--samples=N] [name_prefix ...]
+ *
+ * Name prefixes select a subset of benchmarks, e.g. "bench_wally tx_ bip32_".
+ * --json writes the results as JSON for comparison with
+ * tools/bench_compare.py */
+
+#define DEFAULT_SAMPLES 10
+#define MAX_SAMPLES 1000
+
+#define check_ret(expr) do { \
+        if ((expr) != WALLY_OK) { \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #expr); \
+            exit(1); \
+        } \
+    } while (0)
+
+typedef void (*bench_fn_t)(void *ctx, size_t iterations);
+
+static int num_filters;
+static char **filters;
+static size_t num_samples = DEFAULT_SAMPLES;
+static int json_output;
+static int num_results;
+
+static double get_time(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 0.000001;
+}
+
+static int is_selected(const char *name)
+{
+    int i;
+
+    if (!num_filters)
+        return 1;
+    for (i = 0; i < num_filters; ++i)
+        if (!strncmp(name, filters[i], strlen(filters[i])))
+            return 1;
+    return 0;
+}
+
+static int compare_doubles(const void *lhs, const void *rhs)
+{
+    const double l = *(const double *)lhs, r = *(const double *)rhs;
+    return l < r ? -1 : l > r;
+}
+
+static void run_bench(const char *name, bench_fn_t fn, void *ctx, size_t iterations)
+{
+    double samples[MAX_SAMPLES], median, p99;
+    const size_t n = iterations < num_samples ? iterations : num_samples;
+    const size_t per_sample = (iterations + n - 1) / n;
+    size_t i;
+
+    if (!is_selected(name))
+        return;
+
+    fn(ctx, iterations / 10 + 1); /* Warm up caches and lazy initialization */
+    for (i = 0; i < n; ++i) {
+        const double start = get_time();
+        fn(ctx, per_sample);
+        samples[i] = (get_time() - start) * 1000000000.0 / per_sample;
+    }
+    qsort(samples, n, sizeof(samples[0]), compare_doubles);
+    median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    p99 = samples[(n * 99 + 99) / 100 - 1]; /* Nearest rank */
+
+    if (json_output)
+        printf("%s\n    {\"name\": \"%s\", \"iterations\": %lu, \"samples\": %lu, "
+               "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"min_ns\": %.1f}",
+               num_results ? "," : "", name, (unsigned long)(n * per_sample),
+               (unsigned long)n, median, p99, samples[0]);
+    else
+        printf("%-32s %14.1f ns/op %14.1f ops/sec %14.1f ns p99\n",
+               name, median, 1000000000.0 / median, p99);
+    ++num_results;
+    fflush(stdout);
+}
+
+static void fill(unsigned char *bytes, size_t len, unsigned char seed)
+{
+    size_t i;
+    for (i = 0; i < len; ++i)
+        bytes[i] = (unsigned char)(seed + i * 7);
+}
+
+/*
+ * Transactions
+ */
+struct tx_bench {
+    struct wally_tx *tx;
+    unsigned char *bytes;
+    size_t bytes_len;
+    uint32_t flags; /* Serialization flags */
+    unsigned char script[WALLY_SCRIPTPUBKEY_P2PKH_LEN];
+    unsigned char witness_script[3 + 15 * (EC_PUBLIC_KEY_LEN + 1)];
+    const unsigned char *script_code; /* Script signed by sighash benchmarks */
+    size_t script_code_len;
+#ifdef BUILD_ELEMENTS
+    unsigned char value[WALLY_TX_ASSET_CT_VALUE_LEN];
+#endif
+};
+
+static void tx_bench_finish(struct tx_bench *b, uint32_t flags)
+{
+    size_t written;
+
+    b->flags = flags;
+    /* wally_tx_get_length detects elements transactions itself */
+    check_ret(wally_tx_get_length(b->tx, flags & ~WALLY_TX_FLAG_USE_ELEMENTS,
+                                  &b->bytes_len));
+    if (!(b->bytes = malloc(b->bytes_len)))
+        exit(1);
+    check_ret(wally_tx_to_bytes(b->tx, flags, b->bytes, b->bytes_len, &written));
+}
+
+/* Build a transaction spending num_inputs P2PKH inputs to two outputs */
+static void tx_bench_init(struct tx_bench *b, size_t num_inputs)
+{
+    unsigned char txhash[WALLY_TXHASH_LEN], script_sig[107];
+    size_t i;
+
+    fill(b->script, sizeof(b->script), 3);
+    b->script[0] = OP_DUP;
+    b->script_code = b->script;
+    b->script_code_len = sizeof(b->script);
+    check_ret(wally_tx_init_alloc(2, 0, num_inputs, 2, &b->tx));
+    for (i = 0; i < num_inputs; ++i) {
+        fill(txhash, sizeof(txhash), (unsigned char)i);
+        fill(script_sig, sizeof(script_sig), (unsigned char)(i + 1));
+        check_ret(wally_tx_add_raw_input(b->tx, txhash, sizeof(txhash), (uint32_t)i,
+                                         0xffffffff, script_sig, sizeof(script_sig),
+                                         NULL, 0));
+    }
+    for (i = 0; i < 2; ++i)
+        check_ret(wally_tx_add_raw_output(b->tx, 10000 + i, b->script,
+                                          sizeof(b->script), 0));
+    tx_bench_finish(b, WALLY_TX_FLAG_USE_WITNESS);
+}
+
+/*
+ * Corpus transactions mirroring common mainnet and Liquid shapes. Signatures,
+ * keys and proofs are filler of the real sizes, since parsing, serialization
+ * and signature hashing do not validate them.
+ */
+
+/* Add a witness input: a DER signature per signer, then the final item */
+static void add_witness_input(struct wally_tx *tx, size_t i, size_t num_sigs,
+                              const unsigned char *final_item, size_t final_item_len,
+                              bool is_elements)
+{
+    struct wally_tx_witness_stack *witness;
+    unsigned char txhash[WALLY_TXHASH_LEN], sig[EC_SIGNATURE_DER_MAX_LEN + 1];
+    size_t j;
+#ifndef BUILD_ELEMENTS
+    (void)is_elements;
+#endif
+
+    fill(txhash, sizeof(txhash), (unsigned char)i);
+    check_ret(wally_tx_witness_stack_init_alloc(num_sigs + 2, &witness));
+    if (num_sigs > 1)
+        check_ret(wally_tx_witness_stack_add(witness, NULL, 0)); /* CHECKMULTISIG bug */
+    for (j = 0; j < num_sigs; ++j) {
+        fill(sig, sizeof(sig), (unsigned char)(i + j));
+        sig[0] = 0x30;
+        sig[sizeof(sig) - 1] = WALLY_SIGHASH_ALL;
+        check_ret(wally_tx_witness_stack_add(witness, sig, sizeof(sig)));
+    }
+    check_ret(wally_tx_witness_stack_add(witness, final_item, final_item_len));
+#ifdef BUILD_ELEMENTS
+    if (is_elements)
+        check_ret(wally_tx_add_elements_raw_input(tx, txhash, sizeof(txhash), (uint32_t)i,
+                                                  0xfffffffd, NULL, 0, witness, NULL, 0,
+                                                  NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                                  NULL, 0, NULL, 0));
+    else
+#endif
+    check_ret(wally_tx_add_raw_input(tx, txhash, sizeof(txhash), (uint32_t)i,
+                                     0xfffffffd, NULL, 0, witness, 0));
+    check_ret(wally_tx_witness_stack_free(witness));
+}
+
+/* Exchange wallet consolidation: 500 P2WPKH inputs to a single output */
+static void corpus_consolidation(struct tx_bench *b)
+{
+    unsigned char pubkey[EC_PUBLIC_KEY_LEN], script[WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    size_t i;
+
+    fill(b->script, sizeof(b->script), 3);
+    b->script[0] = OP_DUP;
+    b->script_code = b->script;
+    b->script_code_len = sizeof(b->script);
+    check_ret(wally_tx_init_alloc(2, 0, 500, 1, &b->tx));
+    for (i = 0; i < 500; ++i) {
+        fill(pubkey, sizeof(pubkey), (unsigned char)i);
+        pubkey[0] = 0x02;
+        add_witness_input(b->tx, i, 1, pubkey, sizeof(pubkey), false);
+    }
+    fill(script, sizeof(script), 5);
+    script[0] = OP_0;
+    script[1] = HASH160_LEN;
+    check_ret(wally_tx_add_raw_output(b->tx, 5000000000ull, script, sizeof(script), 0));
+    tx_bench_finish(b, WALLY_TX_FLAG_USE_WITNESS);
+}
+
+/* Exchange or pool payout: 2 P2WPKH inputs to 1000 mixed-type outputs */
+static void corpus_payout(struct tx_bench *b)
+{
+    static const size_t script_lens[] = {
+        WALLY_SCRIPTPUBKEY_P2PKH_LEN, WALLY_SCRIPTPUBKEY_P2SH_LEN,
+        WALLY_SCRIPTPUBKEY_P2WPKH_LEN, WALLY_SCRIPTPUBKEY_P2WSH_LEN
+    };
+    unsigned char pubkey[EC_PUBLIC_KEY_LEN], script[WALLY_SCRIPTPUBKEY_P2WSH_LEN];
+    size_t i;
+
+    fill(b->script, sizeof(b->script), 3);
+    b->script[0] = OP_DUP;
+    b->script_code = b->script;
+    b->script_code_len = sizeof(b->script);
+    check_ret(wally_tx_init_alloc(2, 0, 2, 1000, &b->tx));
+    for (i = 0; i < 2; ++i) {
+        fill(pubkey, sizeof(pubkey), (unsigned char)i);
+        pubkey[0] = 0x03;
+        add_witness_input(b->tx, i, 1, pubkey, sizeof(pubkey), false);
+    }
+    for (i = 0; i < 1000; ++i) {
+        fill(script, sizeof(script), (unsigned char)i);
+        check_ret(wally_tx_add_raw_output(b->tx, 10000 + i * 37, script,
+                                          script_lens[i % 4], 0));
+    }
+    tx_bench_finish(b, WALLY_TX_FLAG_USE_WITNESS);
+}
+
+/* Custody spend: 20 P2WSH 11-of-15 multisig inputs to two outputs */
+static void corpus_multisig(struct tx_bench *b)
+{
+    unsigned char *p = b->witness_script, script[WALLY_SCRIPTPUBKEY_P2WSH_LEN];
+    size_t i;
+
+    *p++ = OP_11;
+    for (i = 0; i < 15; ++i) {
+        *p++ = EC_PUBLIC_KEY_LEN;
+        fill(p, EC_PUBLIC_KEY_LEN, (unsigned char)(i + 50));
+        p[0] = 0x02;
+        p += EC_PUBLIC_KEY_LEN;
+    }
+    *p++ = OP_15;
+    *p = OP_CHECKMULTISIG;
+    b->script_code = b->witness_script;
+    b->script_code_len = sizeof(b->witness_script);
+    check_ret(wally_tx_init_alloc(2, 0, 20, 2, &b->tx));
+    for (i = 0; i < 20; ++i)
+        add_witness_input(b->tx, i, 11, b->witness_script,
+                          sizeof(b->witness_script), false);
+    fill(script, sizeof(script), 7);
+    script[0] = OP_0;
+    script[1] = SHA256_LEN;
+    for (i = 0; i < 2; ++i)
+        check_ret(wally_tx_add_raw_output(b->tx, 2500000000ull + i, script,
+                                          sizeof(script), 0));
+    tx_bench_finish(b, WALLY_TX_FLAG_USE_WITNESS);
+}
+
+#ifdef BUILD_ELEMENTS
+/* Liquid confidential transaction: 2 P2WPKH inputs to 2 blinded outputs,
+ * each with a 52 bit rangeproof and a surjection proof, plus the fee */
+static void corpus_confidential(struct tx_bench *b)
+{
+    unsigned char pubkey[EC_PUBLIC_KEY_LEN], script[WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    unsigned char asset[WALLY_TX_ASSET_CT_ASSET_LEN], nonce[WALLY_TX_ASSET_CT_NONCE_LEN];
+    unsigned char rangeproof[4174], surjectionproof[67];
+    unsigned char fee_value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN] = { 1, 0, 0, 0, 0, 0, 0, 0x0f, 0xa0 };
+    size_t i;
+
+    fill(b->script, sizeof(b->script), 3);
+    b->script[0] = OP_DUP;
+    b->script_code = b->script;
+    b->script_code_len = sizeof(b->script);
+    fill(b->value, sizeof(b->value), 9);
+    b->value[0] = WALLY_TX_ASSET_CT_VALUE_PREFIX_A;
+    check_ret(wally_tx_init_alloc(2, 0, 2, 3, &b->tx));
+    for (i = 0; i < 2; ++i) {
+        fill(pubkey, sizeof(pubkey), (unsigned char)i);
+        pubkey[0] = 0x02;
+        add_witness_input(b->tx, i, 1, pubkey, sizeof(pubkey), true);
+    }
+    fill(script, sizeof(script), 11);
+    script[0] = OP_0;
+    script[1] = HASH160_LEN;
+    fill(rangeproof, sizeof(rangeproof), 13);
+    fill(surjectionproof, sizeof(surjectionproof), 15);
+    for (i = 0; i < 2; ++i) {
+        fill(asset, sizeof(asset), (unsigned char)(i + 17));
+        asset[0] = WALLY_TX_ASSET_CT_ASSET_PREFIX_A;
+        fill(nonce, sizeof(nonce), (unsigned char)(i + 19));
+        nonce[0] = WALLY_TX_ASSET_CT_NONCE_PREFIX_A;
+        check_ret(wally_tx_add_elements_raw_output(b->tx, script, sizeof(script),
+                                                   asset, sizeof(asset),
+                                                   b->value, sizeof(b->value),
+                                                   nonce, sizeof(nonce),
+                                                   surjectionproof, sizeof(surjectionproof),
+                                                   rangeproof, sizeof(rangeproof), 0));
+    }
+    fill(asset, sizeof(asset), 21);
+    asset[0] = 1; /* Explicit (unblinded) fee asset */
+    check_ret(wally_tx_add_elements_raw_output(b->tx, NULL, 0, asset, sizeof(asset),
+                                               fee_value, sizeof(fee_value),
+                                               NULL, 0, NULL, 0, NULL, 0, 0));
+    tx_bench_finish(b, WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS);
+}
+#endif /* BUILD_ELEMENTS */
+
+static const struct {
+    const char *name;
+    void (*init)(struct tx_bench *b);
+} tx_corpus[] = {
+    { "consolidation", corpus_consolidation },
+    { "payout", corpus_payout },
+    { "multisig", corpus_multisig },
+#ifdef BUILD_ELEMENTS
+    { "confidential", corpus_confidential },
+#endif
+};
+
+static void tx_bench_free(struct tx_bench *b)
+{
+    check_ret(wally_tx_free(b->tx));
+    free(b->bytes);
+}
+
+static void bench_tx_parse(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    struct wally_tx *tx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_from_bytes(b->bytes, b->bytes_len, b->flags, &tx));
+        check_ret(wally_tx_free(tx));
+    }
+}
+
+#ifdef BUILD_ELEMENTS
+static void bench_tx_parse_referenced(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    const uint32_t flags = b->flags | WALLY_TX_FLAG_REFERENCE_PROOFS;
+    struct wally_tx *tx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_from_bytes(b->bytes, b->bytes_len, flags, &tx));
+        check_ret(wally_tx_free(tx));
+    }
+}
+#endif
+
+static void bench_tx_serialize(void *ctx, size_t iterations)
+{
+    struct tx_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_to_bytes(b->tx, b->flags, b->bytes, b->bytes_len, &written));
+}
+
+static void bench_tx_to_compact(void *ctx, size_t iterations)
+{
+    struct tx_bench *b = ctx;
+    unsigned char *bytes;
+    size_t i, len, written;
+
+    check_ret(wally_tx_get_compact_length(b->tx, b->flags, &len));
+    if (!(bytes = malloc(len)))
+        exit(1);
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_to_compact_bytes(b->tx, b->flags, bytes, len, &written));
+    free(bytes);
+}
+
+static void bench_tx_from_compact(void *ctx, size_t iterations)
+{
+    struct tx_bench *b = ctx;
+    struct wally_tx *tx;
+    unsigned char *bytes;
+    size_t i, len, written;
+
+    check_ret(wally_tx_get_compact_length(b->tx, b->flags, &len));
+    if (!(bytes = malloc(len)))
+        exit(1);
+    check_ret(wally_tx_to_compact_bytes(b->tx, b->flags, bytes, len, &written));
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_from_compact_bytes(bytes, len, 0, &tx));
+        check_ret(wally_tx_free(tx));
+    }
+    free(bytes);
+}
+
+static void bench_tx_to_hex(void *ctx, size_t iterations)
+{
+    struct tx_bench *b = ctx;
+    char *hex;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_to_hex(b->tx, b->flags, &hex));
+        check_ret(wally_free_string(hex));
+    }
+}
+
+/* Serialize into segments, copying only fields not referenced from the tx */
+static void bench_tx_to_iovecs(void *ctx, size_t iterations)
+{
+    struct tx_bench *b = ctx;
+    struct wally_tx_iovec iov[1024];
+    unsigned char *scratch = malloc(b->bytes_len);
+    size_t i, written, iov_written;
+
+    if (!scratch)
+        exit(1);
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_to_iovecs(b->tx, b->flags, scratch, b->bytes_len,
+                                     iov, sizeof(iov) / sizeof(iov[0]),
+                                     &written, &iov_written));
+        if (iov_written > sizeof(iov) / sizeof(iov[0]))
+            exit(1);
+    }
+    free(scratch);
+}
+
+static void sighash(const struct tx_bench *b, size_t iterations, uint32_t flags,
+                    const struct wally_tx_sighash_ctx *sighash_ctx)
+{
+    unsigned char hash[SHA256_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+#ifdef BUILD_ELEMENTS
+        if (b->flags & WALLY_TX_FLAG_USE_ELEMENTS) {
+            check_ret(wally_tx_get_elements_signature_hash_ctx(b->tx, sighash_ctx,
+                                                               i % b->tx->num_inputs,
+                                                               b->script_code, b->script_code_len,
+                                                               b->value, sizeof(b->value),
+                                                               WALLY_SIGHASH_ALL, flags,
+                                                               hash, sizeof(hash)));
+            continue;
+        }
+#endif
+        check_ret(wally_tx_get_btc_signature_hash_ctx(b->tx, sighash_ctx, i % b->tx->num_inputs,
+                                                      b->script_code, b->script_code_len,
+                                                      50000, WALLY_SIGHASH_ALL, flags,
+                                                      hash, sizeof(hash)));
+    }
+}
+
+static void bench_sighash_legacy(void *ctx, size_t iterations)
+{
+    sighash(ctx, iterations, 0, NULL);
+}
+
+static void bench_sighash_bip143(void *ctx, size_t iterations)
+{
+    sighash(ctx, iterations, WALLY_TX_FLAG_USE_WITNESS, NULL);
+}
+
+/* BIP 143 signing of every input, hashing the prevouts/sequences/outputs
+ * (and for Elements, issuances) once up front */
+static void bench_sighash_bip143_ctx(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    struct wally_tx_sighash_ctx *sighash_ctx;
+
+    check_ret(wally_tx_sighash_ctx_init_alloc(b->tx, 0, &sighash_ctx));
+    sighash(b, iterations, WALLY_TX_FLAG_USE_WITNESS, sighash_ctx);
+    check_ret(wally_tx_sighash_ctx_free(sighash_ctx));
+}
+
+/* BIP 143 signing of every input from a view of the serialized tx */
+static void bench_sighash_bip143_view(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    struct wally_tx_view *view;
+    unsigned char hash[SHA256_LEN];
+    size_t i;
+
+    check_ret(wally_tx_view_from_bytes(b->bytes, b->bytes_len, 0, &view));
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_view_get_btc_signature_hash(view, i % view->num_inputs,
+                                                       b->script_code, b->script_code_len,
+                                                       50000, WALLY_SIGHASH_ALL,
+                                                       WALLY_TX_FLAG_USE_WITNESS,
+                                                       hash, sizeof(hash)));
+    check_ret(wally_tx_view_free(view));
+}
+
+/* BIP 143 signing of one input from the tx streamed in 64 byte chunks */
+static void bench_sighash_bip143_stream(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    struct wally_tx_sighash_stream *stream;
+    unsigned char hash[SHA256_LEN];
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_sighash_stream_init_alloc(0, &stream));
+        check_ret(wally_tx_sighash_stream_add_input(stream, i % b->tx->num_inputs,
+                                                    b->script_code, b->script_code_len,
+                                                    50000, WALLY_SIGHASH_ALL,
+                                                    WALLY_TX_FLAG_USE_WITNESS));
+        for (j = 0; j < b->bytes_len; j += 64)
+            check_ret(wally_tx_sighash_stream_update(stream, b->bytes + j,
+                                                     b->bytes_len - j < 64 ? b->bytes_len - j : 64));
+        check_ret(wally_tx_sighash_stream_final(stream, hash, sizeof(hash)));
+        check_ret(wally_tx_sighash_stream_free(stream));
+    }
+}
+
+static void bench_script_get_type(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    size_t i, script_type;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scriptpubkey_get_type(b->script_code, b->script_code_len,
+                                              &script_type));
+}
+
+static void bench_script_iterate(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    struct wally_script_iterator iter;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_script_iterator_init(&iter, b->script_code, b->script_code_len));
+        do {
+            check_ret(wally_script_iterator_next(&iter, &written));
+        } while (written);
+    }
+}
+
+static void bench_output_script_types_single(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    size_t i, j, script_type;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < b->tx->num_outputs; ++j)
+            if (b->tx->outputs[j].script_len)
+                check_ret(wally_scriptpubkey_get_type(b->tx->outputs[j].script,
+                                                      b->tx->outputs[j].script_len,
+                                                      &script_type));
+}
+
+static void bench_output_script_types(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    unsigned char *types = malloc(b->tx->num_outputs);
+    size_t i, written;
+
+    if (!types)
+        exit(1);
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_get_output_script_types(b->tx, types, b->tx->num_outputs,
+                                                   &written));
+    free(types);
+}
+
+static void bench_output_script_types_from_bytes(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    unsigned char *types = malloc(b->tx->num_outputs);
+    size_t i, written;
+
+    if (!types)
+        exit(1);
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_get_output_script_types_from_bytes(
+                      b->bytes, b->bytes_len, b->flags & WALLY_TX_FLAG_USE_ELEMENTS,
+                      types, b->tx->num_outputs, &written));
+    free(types);
+}
+
+/* Decoding a batch of transactions into one arena, as received over RPC */
+#define NUM_ARENA_TXS 256
+#define NUM_ARENA_POOL_THREADS 4
+
+struct txs_arena_bench {
+    const struct tx_bench *tx;
+    struct wally_thread_pool *pool;
+    const unsigned char *bytes[NUM_ARENA_TXS];
+    size_t bytes_lens[NUM_ARENA_TXS];
+    struct wally_tx *txs[NUM_ARENA_TXS];
+    struct wally_tx_arena arena;
+};
+
+static void bench_txs_from_bytes_arena(void *ctx, size_t iterations)
+{
+    struct txs_arena_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_txs_from_bytes_arena(b->bytes, b->bytes_lens, NUM_ARENA_TXS, 0,
+                                             b->pool ? wally_thread_pool_run : NULL,
+                                             b->pool, &b->arena, b->txs));
+        check_ret(wally_tx_arena_reset(&b->arena));
+    }
+}
+
+static void bench_txs_from_bytes_arena_separate(void *ctx, size_t iterations)
+{
+    struct txs_arena_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < NUM_ARENA_TXS; ++j)
+            check_ret(wally_tx_from_bytes(b->bytes[j], b->bytes_lens[j], 0, b->txs + j));
+        for (j = 0; j < NUM_ARENA_TXS; ++j)
+            check_ret(wally_tx_free(b->txs[j]));
+    }
+}
+
+static void bench_txs_arena(const struct tx_bench *tx)
+{
+    struct txs_arena_bench *b = malloc(sizeof(*b));
+    const size_t mem_len = NUM_ARENA_TXS * (8 * tx->bytes_len + 1024);
+    unsigned char *mem = malloc(mem_len);
+    size_t i;
+
+    if (!b || !mem)
+        exit(1);
+    b->tx = tx;
+    b->pool = NULL;
+    for (i = 0; i < NUM_ARENA_TXS; ++i) {
+        b->bytes[i] = tx->bytes;
+        b->bytes_lens[i] = tx->bytes_len;
+    }
+    check_ret(wally_tx_arena_init(&b->arena, mem, mem_len));
+    run_bench("txs_arena_256", bench_txs_from_bytes_arena, b, 20);
+    run_bench("txs_arena_256_separate", bench_txs_from_bytes_arena_separate, b, 20);
+    check_ret(wally_thread_pool_init_alloc(NUM_ARENA_POOL_THREADS, &b->pool));
+    run_bench("txs_arena_256_pool", bench_txs_from_bytes_arena, b, 20);
+    check_ret(wally_thread_pool_free(b->pool));
+    free(mem);
+    free(b);
+}
+
+static void bench_tx(void)
+{
+    static const size_t num_inputs[] = { 1, 10, 100 };
+    struct tx_bench b;
+    char name[64];
+    size_t i, iterations;
+
+    for (i = 0; i < sizeof(num_inputs) / sizeof(num_inputs[0]); ++i) {
+        tx_bench_init(&b, num_inputs[i]);
+        iterations = 20000 / num_inputs[i];
+        sprintf(name, "tx_parse_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_tx_parse, &b, iterations);
+        sprintf(name, "tx_serialize_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_tx_serialize, &b, iterations);
+        sprintf(name, "sighash_legacy_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_sighash_legacy, &b, iterations);
+        sprintf(name, "sighash_bip143_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_sighash_bip143, &b, 20000);
+        sprintf(name, "sighash_bip143_ctx_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_sighash_bip143_ctx, &b, 20000);
+        sprintf(name, "sighash_bip143_view_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_sighash_bip143_view, &b, 20000);
+        sprintf(name, "sighash_bip143_stream_%u_inputs", (unsigned int)num_inputs[i]);
+        run_bench(name, bench_sighash_bip143_stream, &b, iterations);
+        tx_bench_free(&b);
+    }
+
+    for (i = 0; i < sizeof(tx_corpus) / sizeof(tx_corpus[0]); ++i) {
+        tx_corpus[i].init(&b);
+        /* Scale iterations to keep each benchmark's run time similar */
+        iterations = 20000000 / b.bytes_len + 1;
+        sprintf(name, "tx_parse_%s", tx_corpus[i].name);
+        run_bench(name, bench_tx_parse, &b, iterations);
+        if (!strcmp(tx_corpus[i].name, "payout"))
+            bench_txs_arena(&b);
+#ifdef BUILD_ELEMENTS
+        if (b.flags & WALLY_TX_FLAG_USE_ELEMENTS) {
+            sprintf(name, "tx_parse_referenced_%s", tx_corpus[i].name);
+            run_bench(name, bench_tx_parse_referenced, &b, iterations);
+        }
+#endif
+        sprintf(name, "tx_serialize_%s", tx_corpus[i].name);
+        run_bench(name, bench_tx_serialize, &b, iterations);
+        if (!(b.flags & WALLY_TX_FLAG_USE_ELEMENTS)) {
+            sprintf(name, "tx_to_iovecs_%s", tx_corpus[i].name);
+            run_bench(name, bench_tx_to_iovecs, &b, iterations);
+            sprintf(name, "tx_to_compact_%s", tx_corpus[i].name);
+            run_bench(name, bench_tx_to_compact, &b, iterations);
+            sprintf(name, "tx_from_compact_%s", tx_corpus[i].name);
+            run_bench(name, bench_tx_from_compact, &b, iterations);
+        }
+        sprintf(name, "tx_to_hex_%s", tx_corpus[i].name);
+        run_bench(name, bench_tx_to_hex, &b, iterations);
+        sprintf(name, "sighash_legacy_%s", tx_corpus[i].name);
+        run_bench(name, bench_sighash_legacy, &b, iterations);
+        sprintf(name, "sighash_bip143_%s", tx_corpus[i].name);
+        run_bench(name, bench_sighash_bip143, &b, 20000);
+        sprintf(name, "sighash_bip143_ctx_%s", tx_corpus[i].name);
+        run_bench(name, bench_sighash_bip143_ctx, &b, 20000);
+        sprintf(name, "script_get_type_%s", tx_corpus[i].name);
+        run_bench(name, bench_script_get_type, &b, 200000);
+        sprintf(name, "script_iterate_%s", tx_corpus[i].name);
+        run_bench(name, bench_script_iterate, &b, 200000);
+        sprintf(name, "output_script_types_single_%s", tx_corpus[i].name);
+        run_bench(name, bench_output_script_types_single, &b, 200000);
+        sprintf(name, "output_script_types_%s", tx_corpus[i].name);
+        run_bench(name, bench_output_script_types, &b, 200000);
+        sprintf(name, "output_script_types_from_bytes_%s", tx_corpus[i].name);
+        run_bench(name, bench_output_script_types_from_bytes, &b, iterations);
+        tx_bench_free(&b);
+    }
+}
+
+struct watchset_bench {
+    struct tx_bench tx;
+    struct wally_script_watchset *set;
+    uint32_t indices[1000];
+};
+
+static void bench_watchset_contains(void *ctx, size_t iterations)
+{
+    const struct watchset_bench *b = ctx;
+    const struct wally_tx *tx = b->tx.tx;
+    size_t i, j, written;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < tx->num_outputs; ++j)
+            check_ret(wally_script_watchset_contains(b->set, tx->outputs[j].script,
+                                                     tx->outputs[j].script_len,
+                                                     &written));
+}
+
+static void bench_watchset_match_tx(void *ctx, size_t iterations)
+{
+    struct watchset_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_script_watchset_match_tx(b->set, b->tx.tx, b->indices,
+                                                 sizeof(b->indices) / sizeof(b->indices[0]),
+                                                 &written));
+}
+
+/* Match the 1000 outputs of the payout transaction against 10000 scripts,
+ * 10 of which are outputs of the transaction */
+static void bench_watchset(void)
+{
+    static const struct {
+        const char *name;
+        uint32_t flags;
+    } modes[] = {
+        { "watchset", 0 },
+        { "watchset_sha256", WALLY_SCRIPT_SHA256 },
+    };
+    unsigned char script[WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    struct watchset_bench b;
+    char name[64];
+    size_t i, j;
+
+    corpus_payout(&b.tx);
+    for (i = 0; i < sizeof(modes) / sizeof(modes[0]); ++i) {
+        check_ret(wally_script_watchset_init_alloc(10000, modes[i].flags, &b.set));
+        for (j = 0; j < 10000 - 10; ++j) {
+            fill(script, sizeof(script), (unsigned char)j);
+            script[0] = OP_0;
+            script[1] = HASH160_LEN;
+            memcpy(script + 2, &j, sizeof(j)); /* Make each script unique */
+            check_ret(wally_script_watchset_add(b.set, script, sizeof(script)));
+        }
+        for (j = 0; j < 10; ++j)
+            check_ret(wally_script_watchset_add(b.set, b.tx.tx->outputs[j * 100].script,
+                                                b.tx.tx->outputs[j * 100].script_len));
+        sprintf(name, "%s_contains_payout", modes[i].name);
+        run_bench(name, bench_watchset_contains, &b, 200);
+        sprintf(name, "%s_match_tx_payout", modes[i].name);
+        run_bench(name, bench_watchset_match_tx, &b, 200);
+        check_ret(wally_script_watchset_free(b.set));
+    }
+    tx_bench_free(&b.tx);
+}
+
+/* A set of 10000 two input transactions, and a transaction to check against it */
+#define NUM_SET_TXS 10000
+
+struct tx_set_bench {
+    struct tx_bench tx;
+    struct wally_tx_set *set;
+    unsigned char conflicts[2 * WALLY_TXHASH_LEN];
+    unsigned char txid[WALLY_TXHASH_LEN];
+};
+
+/* Make the inputs of the template transaction spend unique outpoints */
+static void tx_set_bench_spend(struct tx_set_bench *b, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < b->tx.tx->num_inputs; ++i)
+        memcpy(b->tx.tx->inputs[i].txhash, &n, sizeof(n));
+}
+
+static void bench_tx_set_get_conflicts(void *ctx, size_t iterations)
+{
+    struct tx_set_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_set_get_conflicts(b->set, b->tx.tx, b->conflicts,
+                                             sizeof(b->conflicts), &written));
+        if (written != WALLY_TXHASH_LEN)
+            exit(1);
+    }
+}
+
+static void bench_tx_set_add_remove(void *ctx, size_t iterations)
+{
+    struct tx_set_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_tx_set_add(b->set, b->tx.tx));
+        check_ret(wally_tx_set_remove(b->set, b->txid, sizeof(b->txid)));
+    }
+}
+
+static void bench_tx_set(void)
+{
+    struct tx_set_bench b;
+    size_t i;
+
+    tx_bench_init(&b.tx, 2);
+    check_ret(wally_tx_set_init_alloc(NUM_SET_TXS, 0, &b.set));
+    for (i = 0; i < NUM_SET_TXS; ++i) {
+        tx_set_bench_spend(&b, i);
+        check_ret(wally_tx_set_add(b.set, b.tx.tx));
+    }
+    /* Conflict with a transaction in the set through one input */
+    tx_set_bench_spend(&b, NUM_SET_TXS);
+    i = NUM_SET_TXS / 2;
+    memcpy(b.tx.tx->inputs[1].txhash, &i, sizeof(i));
+    run_bench("tx_set_get_conflicts_10000_txs", bench_tx_set_get_conflicts, &b, 2000);
+    /* Add and remove a transaction that doesn't conflict */
+    tx_set_bench_spend(&b, NUM_SET_TXS);
+    check_ret(wally_tx_to_bytes(b.tx.tx, 0, b.tx.bytes, b.tx.bytes_len, &i));
+    check_ret(wally_tx_get_txid_from_bytes(b.tx.bytes, i, 0, b.txid, sizeof(b.txid)));
+    run_bench("tx_set_add_remove_10000_txs", bench_tx_set_add_remove, &b, 2000);
+    check_ret(wally_tx_set_free(b.set));
+    tx_bench_free(&b.tx);
+}
+
+/* Find each input of a 1000 input transaction by its outpoint */
+#define NUM_FIND_INPUTS 1000
+
+struct tx_find_bench {
+    struct tx_bench tx;
+    struct wally_tx_index *index; /* NULL to search linearly */
+};
+
+static void bench_tx_find_inputs(void *ctx, size_t iterations)
+{
+    struct tx_find_bench *b = ctx;
+    size_t i, j, written;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < NUM_FIND_INPUTS; ++j) {
+            const struct wally_tx_input *input = b->tx.tx->inputs + j;
+            check_ret(wally_tx_find_input_by_outpoint(b->tx.tx, b->index, input->txhash,
+                                                      sizeof(input->txhash),
+                                                      input->index, &written));
+            if (written != j)
+                exit(1);
+        }
+    }
+}
+
+static void bench_tx_find(void)
+{
+    struct tx_find_bench b;
+    size_t i;
+
+    tx_bench_init(&b.tx, NUM_FIND_INPUTS);
+    for (i = 0; i < NUM_FIND_INPUTS; ++i)
+        memcpy(b.tx.tx->inputs[i].txhash, &i, sizeof(i)); /* Unique outpoints */
+    check_ret(wally_tx_index_init_alloc(b.tx.tx, 0, &b.index));
+    run_bench("tx_find_input_by_outpoint_1000_inputs", bench_tx_find_inputs, &b, 200);
+    check_ret(wally_tx_index_free(b.index));
+    b.index = NULL;
+    run_bench("tx_find_input_by_outpoint_1000_inputs_linear",
+              bench_tx_find_inputs, &b, 20);
+    tx_bench_free(&b.tx);
+}
+
+/*
+ * PSBTs
+ */
+#define NUM_PSBT_INPUTS 2
+#define NUM_PSBT_UTXO_INPUTS 5000
+
+/* A co-signing request: two inputs, each carrying the ~750KB transaction
+ * it spends as its non-witness UTXO, one with a partial signature */
+struct psbt_bench {
+    struct tx_bench utxo;
+    unsigned char *bytes;
+    size_t bytes_len;
+    unsigned char *out;
+    unsigned char pubkey[EC_PUBLIC_KEY_LEN];
+};
+
+static unsigned char *psbt_bench_varint(unsigned char *p, size_t n)
+{
+    if (n < 0xfd) {
+        *p++ = (unsigned char)n;
+        return p;
+    }
+    *p++ = 0xfe;
+    *p++ = n & 0xff;
+    *p++ = (n >> 8) & 0xff;
+    *p++ = (n >> 16) & 0xff;
+    *p++ = (n >> 24) & 0xff;
+    return p;
+}
+
+static unsigned char *psbt_bench_pair(unsigned char *p, unsigned char type,
+                                      const unsigned char *key_data, size_t key_data_len,
+                                      const unsigned char *value, size_t value_len)
+{
+    p = psbt_bench_varint(p, key_data_len + 1);
+    *p++ = type;
+    memcpy(p, key_data, key_data_len);
+    p = psbt_bench_varint(p + key_data_len, value_len);
+    memcpy(p, value, value_len);
+    return p + value_len;
+}
+
+static void psbt_bench_init(struct psbt_bench *b)
+{
+    unsigned char txid[WALLY_TXHASH_LEN], tx_bytes[256], sig[EC_SIGNATURE_DER_MAX_LEN + 1];
+    struct wally_tx *tx;
+    unsigned char *p;
+    size_t i, tx_len;
+
+    tx_bench_init(&b->utxo, NUM_PSBT_UTXO_INPUTS);
+    check_ret(wally_tx_get_txid_from_bytes(b->utxo.bytes, b->utxo.bytes_len, 0,
+                                           txid, sizeof(txid)));
+    check_ret(wally_tx_init_alloc(2, 0, NUM_PSBT_INPUTS, 1, &tx));
+    for (i = 0; i < NUM_PSBT_INPUTS; ++i)
+        check_ret(wally_tx_add_raw_input(tx, txid, sizeof(txid), (uint32_t)i,
+                                         0xfffffffd, NULL, 0, NULL, 0));
+    check_ret(wally_tx_add_raw_output(tx, 15000, b->utxo.script,
+                                      sizeof(b->utxo.script), 0));
+    check_ret(wally_tx_to_bytes(tx, 0, tx_bytes, sizeof(tx_bytes), &tx_len));
+    check_ret(wally_tx_free(tx));
+
+    b->bytes_len = 5 + 2 * (b->utxo.bytes_len + sizeof(b->pubkey) + sizeof(sig) + 32) +
+                   tx_len + 16;
+    if (!(b->bytes = malloc(b->bytes_len)) || !(b->out = malloc(b->bytes_len * 2)))
+        exit(1);
+    fill(b->pubkey, sizeof(b->pubkey), 9);
+    b->pubkey[0] = 0x02;
+    fill(sig, sizeof(sig), 11);
+    sig[0] = 0x30;
+
+    memcpy(b->bytes, "psbt\xff", 5);
+    p = psbt_bench_pair(b->bytes + 5, WALLY_PSBT_GLOBAL_UNSIGNED_TX, NULL, 0,
+                        tx_bytes, tx_len);
+    *p++ = 0;
+    for (i = 0; i < NUM_PSBT_INPUTS; ++i) {
+        p = psbt_bench_pair(p, WALLY_PSBT_IN_NON_WITNESS_UTXO, NULL, 0,
+                            b->utxo.bytes, b->utxo.bytes_len);
+        if (!i)
+            p = psbt_bench_pair(p, WALLY_PSBT_IN_PARTIAL_SIG, b->pubkey,
+                                sizeof(b->pubkey), sig, sizeof(sig));
+        *p++ = 0;
+    }
+    *p++ = 0; /* Output map */
+    b->bytes_len = p - b->bytes;
+}
+
+static void bench_psbt_parse(void *ctx, size_t iterations)
+{
+    const struct psbt_bench *b = ctx;
+    struct wally_psbt_view *view;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_psbt_view_from_bytes(b->bytes, b->bytes_len, 0, &view));
+        check_ret(wally_psbt_view_free(view));
+    }
+}
+
+/* Parse, then find each input's value and the partial signature */
+static void bench_psbt_parse_values(void *ctx, size_t iterations)
+{
+    const struct psbt_bench *b = ctx;
+    struct wally_psbt_view *view;
+    uint64_t satoshi;
+    size_t i, j, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_psbt_view_from_bytes(b->bytes, b->bytes_len, 0, &view));
+        for (j = 0; j < NUM_PSBT_INPUTS; ++j)
+            check_ret(wally_psbt_view_get_input_satoshi(view, j, &satoshi));
+        check_ret(wally_psbt_view_find_pair(view, WALLY_PSBT_MAP_INPUT, 0,
+                                            WALLY_PSBT_IN_PARTIAL_SIG, b->pubkey,
+                                            sizeof(b->pubkey), &written));
+        if (written != 1)
+            exit(1); /* The signature follows the UTXO */
+        check_ret(wally_psbt_view_free(view));
+    }
+}
+
+/* The work a parser that copies its UTXOs into transactions performs to
+ * find the same values: decoding and checking each UTXO */
+static void bench_psbt_parse_decode_utxos(void *ctx, size_t iterations)
+{
+    const struct psbt_bench *b = ctx;
+    unsigned char txid[WALLY_TXHASH_LEN];
+    struct wally_tx *tx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < NUM_PSBT_INPUTS; ++j) {
+            check_ret(wally_tx_from_bytes(b->utxo.bytes, b->utxo.bytes_len, 0, &tx));
+            check_ret(wally_tx_free(tx));
+            check_ret(wally_tx_get_txid_from_bytes(b->utxo.bytes, b->utxo.bytes_len, 0,
+                                                   txid, sizeof(txid)));
+        }
+    }
+}
+
+/* Add a signature to the second input and re-serialize */
+static void bench_psbt_sign_serialize(void *ctx, size_t iterations)
+{
+    const struct psbt_bench *b = ctx;
+    const unsigned char key[EC_PUBLIC_KEY_LEN + 1] = { WALLY_PSBT_IN_PARTIAL_SIG, 0x03 };
+    unsigned char sig[EC_SIGNATURE_DER_MAX_LEN + 1];
+    struct wally_psbt_view *view;
+    size_t i, written;
+
+    fill(sig, sizeof(sig), 13);
+    check_ret(wally_psbt_view_from_bytes(b->bytes, b->bytes_len, 0, &view));
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_psbt_view_set_pair(view, WALLY_PSBT_MAP_INPUT, 1,
+                                           key, sizeof(key), sig, sizeof(sig)));
+        check_ret(wally_psbt_view_to_bytes(view, 0, b->out, b->bytes_len * 2, &written));
+    }
+    check_ret(wally_psbt_view_free(view));
+}
+
+static void bench_psbt(void)
+{
+    struct psbt_bench b;
+
+    psbt_bench_init(&b);
+    run_bench("psbt_parse_1500kb", bench_psbt_parse, &b, 20000);
+    run_bench("psbt_parse_values_1500kb", bench_psbt_parse_values, &b, 200);
+    run_bench("psbt_parse_decode_utxos_1500kb", bench_psbt_parse_decode_utxos, &b, 200);
+    run_bench("psbt_sign_serialize_1500kb", bench_psbt_sign_serialize, &b, 200);
+    free(b.bytes);
+    free(b.out);
+    tx_bench_free(&b.utxo);
+}
+
+/* Fee rates for a batch of 1000 two input transactions */
+#define NUM_FEE_TXS 1000
+
+struct fee_rates_bench {
+    struct tx_bench tx;
+    const struct wally_tx *txs[NUM_FEE_TXS];
+    uint64_t values[NUM_FEE_TXS * 2];
+    uint64_t fee_rates[NUM_FEE_TXS];
+};
+
+static void bench_tx_get_fee_rates(void *ctx, size_t iterations)
+{
+    struct fee_rates_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_get_fee_rates(b->txs, NUM_FEE_TXS, b->values,
+                                         NUM_FEE_TXS * 2, b->fee_rates,
+                                         NUM_FEE_TXS));
+}
+
+static void bench_fee_rates(void)
+{
+    struct fee_rates_bench *b = malloc(sizeof(*b));
+    size_t i;
+
+    if (!b)
+        exit(1);
+    tx_bench_init(&b->tx, 2);
+    for (i = 0; i < NUM_FEE_TXS; ++i)
+        b->txs[i] = b->tx.tx;
+    for (i = 0; i < NUM_FEE_TXS * 2; ++i)
+        b->values[i] = 20000 + i;
+    run_bench("tx_get_fee_rates_1000_txs", bench_tx_get_fee_rates, b, 200);
+    tx_bench_free(&b->tx);
+    free(b);
+}
+
+/*
+ * Fee estimation
+ */
+#define NUM_CANDIDATE_INPUTS 10
+
+/* Estimate the vsize of spending P2WPKH candidates by adding dummy inputs */
+static void bench_vsize_dummy(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    unsigned char txhash[WALLY_TXHASH_LEN], pubkey[EC_PUBLIC_KEY_LEN];
+    size_t i, j, vsize;
+
+    fill(txhash, sizeof(txhash), 1);
+    fill(pubkey, sizeof(pubkey), 2);
+    for (i = 0; i < iterations; ++i) {
+        struct wally_tx *tx;
+        check_ret(wally_tx_clone(b->tx, 0, &tx));
+        for (j = 0; j < NUM_CANDIDATE_INPUTS; ++j) {
+            struct wally_tx_witness_stack *witness;
+            check_ret(wally_tx_witness_stack_init_alloc(2, &witness));
+            check_ret(wally_tx_witness_stack_add_dummy(witness, WALLY_TX_DUMMY_SIG));
+            check_ret(wally_tx_witness_stack_add(witness, pubkey, sizeof(pubkey)));
+            check_ret(wally_tx_add_raw_input(tx, txhash, sizeof(txhash), (uint32_t)j,
+                                             0xffffffff, NULL, 0, witness, 0));
+            check_ret(wally_tx_witness_stack_free(witness));
+        }
+        check_ret(wally_tx_get_vsize(tx, &vsize));
+        check_ret(wally_tx_free(tx));
+    }
+}
+
+static void bench_vsize_estimate(void *ctx, size_t iterations)
+{
+    const struct tx_bench *b = ctx;
+    size_t i, j, input_weight, weight, vsize;
+
+    for (i = 0; i < iterations; ++i) {
+        weight = 0;
+        for (j = 0; j < NUM_CANDIDATE_INPUTS; ++j) {
+            check_ret(wally_tx_input_get_weight_estimate(WALLY_SCRIPT_TYPE_P2WPKH, 0, 0,
+                                                         WALLY_TX_DUMMY_SIG, &input_weight));
+            weight += input_weight;
+        }
+        check_ret(wally_tx_get_weight_estimate(b->tx, NUM_CANDIDATE_INPUTS,
+                                               NUM_CANDIDATE_INPUTS, weight, &weight));
+        check_ret(wally_tx_vsize_from_weight(weight, &vsize));
+    }
+}
+
+/* Size a 10 input P2WPKH candidate set paying to two outputs */
+static void bench_fee_estimation(void)
+{
+    struct tx_bench b;
+
+    tx_bench_init(&b, 0);
+    run_bench("vsize_p2wpkh_10_dummy", bench_vsize_dummy, &b, 20000);
+    run_bench("vsize_p2wpkh_10_estimate", bench_vsize_estimate, &b, 200000);
+    tx_bench_free(&b);
+}
+
+/*
+ * Coin selection
+ */
+#define NUM_COINSELECT_UTXOS 100000
+
+struct coinselect_bench {
+    uint64_t *values;
+    uint32_t *weights;
+    uint32_t *indices;
+    uint64_t target;
+};
+
+static void bench_coinselect_run(void *ctx, size_t iterations, uint32_t flags)
+{
+    const struct coinselect_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_coinselect(b->values, NUM_COINSELECT_UTXOS,
+                                   b->weights, NUM_COINSELECT_UTXOS,
+                                   b->target, 4 * 53 + 2, 2000, 5000, flags,
+                                   NULL, NULL, b->indices,
+                                   NUM_COINSELECT_UTXOS, &written));
+}
+
+static void bench_coinselect_bnb(void *ctx, size_t iterations)
+{
+    bench_coinselect_run(ctx, iterations, WALLY_COINSELECT_BNB);
+}
+
+static void bench_coinselect_knapsack(void *ctx, size_t iterations)
+{
+    bench_coinselect_run(ctx, iterations, WALLY_COINSELECT_KNAPSACK);
+}
+
+/* Select from a 100k UTXO wallet of P2WPKH outputs with varied values */
+static void bench_coinselect(void)
+{
+    struct coinselect_bench b;
+    uint64_t seed = 77;
+    size_t i, weight;
+
+    check_ret(wally_tx_input_get_weight_estimate(WALLY_SCRIPT_TYPE_P2WPKH, 0, 0,
+                                                 WALLY_TX_DUMMY_SIG, &weight));
+    b.values = malloc(NUM_COINSELECT_UTXOS * sizeof(*b.values));
+    b.weights = malloc(NUM_COINSELECT_UTXOS * sizeof(*b.weights));
+    b.indices = malloc(NUM_COINSELECT_UTXOS * sizeof(*b.indices));
+    if (!b.values || !b.weights || !b.indices)
+        exit(1);
+    for (i = 0; i < NUM_COINSELECT_UTXOS; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        b.values[i] = 1000 + (seed >> 33) % 10000000;
+        b.weights[i] = (uint32_t)weight;
+    }
+    b.target = 123456789;
+    run_bench("coinselect_100k_bnb", bench_coinselect_bnb, &b, 5);
+    run_bench("coinselect_100k_knapsack", bench_coinselect_knapsack, &b, 5);
+    free(b.values);
+    free(b.weights);
+    free(b.indices);
+}
+
+/*
+ * UTXO snapshots
+ */
+#define NUM_SNAPSHOT_UTXOS 100000
+#define NUM_SNAPSHOT_INPUTS 10
+
+struct snapshot_bench {
+    struct tx_bench tx;
+    unsigned char *snapshot;
+    size_t snapshot_len;
+    unsigned char *coins; /* The snapshot's UTXOs as dumptxoutset coins */
+    size_t coins_len;
+    unsigned char prevouts[NUM_SNAPSHOT_INPUTS * (WALLY_SCRIPTPUBKEY_P2PKH_LEN + 1)];
+    uint64_t values[NUM_SNAPSHOT_INPUTS];
+};
+
+static void bench_snapshot_find(void *ctx, size_t iterations)
+{
+    const struct snapshot_bench *b = ctx;
+    size_t i, index;
+
+    for (i = 0; i < iterations; ++i) {
+        const struct wally_tx_input *input = b->tx.tx->inputs + i % NUM_SNAPSHOT_INPUTS;
+        check_ret(wally_utxo_snapshot_find(b->snapshot, b->snapshot_len,
+                                           input->txhash, WALLY_TXHASH_LEN,
+                                           input->index, &index));
+    }
+}
+
+static void bench_snapshot_get_prevouts(void *ctx, size_t iterations)
+{
+    struct snapshot_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_utxo_snapshot_get_prevouts(b->snapshot, b->snapshot_len, b->tx.tx,
+                                                   b->values, NUM_SNAPSHOT_INPUTS,
+                                                   b->prevouts, sizeof(b->prevouts),
+                                                   &written));
+}
+
+static void bench_records_from_coins(void *ctx, size_t iterations)
+{
+    struct snapshot_bench *b = ctx;
+    unsigned char *records = b->snapshot + WALLY_UTXO_SNAPSHOT_HEADER_LEN;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_utxo_records_from_coins(b->coins, b->coins_len, 0, records,
+                                                b->snapshot_len - WALLY_UTXO_SNAPSHOT_HEADER_LEN,
+                                                &written));
+}
+
+/* Look up the prevouts of a 10 input tx in a 100k UTXO snapshot */
+static void bench_snapshot(void)
+{
+    const size_t records_len = NUM_SNAPSHOT_UTXOS * WALLY_UTXO_RECORD_LEN;
+    struct snapshot_bench b;
+    unsigned char *records, script[WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    uint64_t seed = 78;
+    size_t i, j;
+
+    tx_bench_init(&b.tx, NUM_SNAPSHOT_INPUTS);
+    b.snapshot_len = WALLY_UTXO_SNAPSHOT_HEADER_LEN + records_len;
+    if (!(b.snapshot = malloc(b.snapshot_len)))
+        exit(1);
+    records = b.snapshot + WALLY_UTXO_SNAPSHOT_HEADER_LEN;
+    b.coins_len = 0;
+    if (!(b.coins = malloc(NUM_SNAPSHOT_UTXOS * (WALLY_TXHASH_LEN + sizeof(uint32_t) + 1 + 64))))
+        exit(1);
+    fill(script, sizeof(script), 4);
+    script[0] = OP_0;
+    script[1] = HASH160_LEN;
+    for (i = 0; i < NUM_SNAPSHOT_UTXOS; ++i) {
+        unsigned char txhash[WALLY_TXHASH_LEN];
+        uint32_t vout = (uint32_t)i;
+
+        if (i < NUM_SNAPSHOT_INPUTS)
+            memcpy(txhash, b.tx.tx->inputs[i].txhash, sizeof(txhash));
+        else
+            for (j = 0; j < sizeof(txhash); ++j) {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                txhash[j] = (unsigned char)(seed >> 56);
+            }
+        check_ret(wally_utxo_record_from_script(txhash, sizeof(txhash), vout, 10000 + i,
+                                                script, sizeof(script),
+                                                records + i * WALLY_UTXO_RECORD_LEN,
+                                                WALLY_UTXO_RECORD_LEN));
+        /* Outpoint, height 1 non-coinbase code, then the compressed txout */
+        memcpy(b.coins + b.coins_len, txhash, sizeof(txhash));
+        b.coins_len += sizeof(txhash);
+        b.coins[b.coins_len++] = vout & 0xff;
+        b.coins[b.coins_len++] = (vout >> 8) & 0xff;
+        b.coins[b.coins_len++] = (vout >> 16) & 0xff;
+        b.coins[b.coins_len++] = vout >> 24;
+        b.coins[b.coins_len++] = 2;
+        check_ret(wally_txout_to_compressed(10000 + i, script, sizeof(script),
+                                            b.coins + b.coins_len, 64, &j));
+        b.coins_len += j;
+    }
+    check_ret(wally_utxo_snapshot_from_records(records, records_len, b.snapshot,
+                                               b.snapshot_len, &i));
+    run_bench("utxo_snapshot_find_100k", bench_snapshot_find, &b, 200000);
+    run_bench("utxo_snapshot_get_prevouts_10", bench_snapshot_get_prevouts, &b, 50000);
+    run_bench("utxo_records_from_coins_100k", bench_records_from_coins, &b, 50);
+    free(b.coins);
+    free(b.snapshot);
+    tx_bench_free(&b.tx);
+}
+
+/*
+ * Block files
+ */
+#define NUM_STREAM_BLOCKS 10
+#define NUM_STREAM_BLOCK_TXS 1000
+#define STREAM_READ_LEN 65536
+
+struct stream_bench {
+    unsigned char *bytes;
+    size_t bytes_len;
+    size_t pos;
+};
+
+/* Read from memory in chunks, as read(2) would from a file */
+static int stream_read(void *read_ctx, unsigned char *bytes_out, size_t len, size_t *written)
+{
+    struct stream_bench *b = read_ctx;
+    size_t n = b->bytes_len - b->pos;
+
+    if (n > len)
+        n = len;
+    if (n > STREAM_READ_LEN)
+        n = STREAM_READ_LEN;
+    memcpy(bytes_out, b->bytes + b->pos, n);
+    b->pos += n;
+    *written = n;
+    return WALLY_OK;
+}
+
+static void bench_block_reader(void *ctx, size_t iterations)
+{
+    struct stream_bench *b = ctx;
+    unsigned char txid[SHA256_LEN];
+    size_t i, tx_bytes_len, num_txs;
+
+    for (i = 0; i < iterations; ++i) {
+        struct wally_block_reader *reader;
+        const unsigned char *tx_bytes;
+
+        b->pos = 0;
+        check_ret(wally_block_reader_init_alloc(WALLY_NETWORK_MAGIC_MAINNET, NULL, 0,
+                                                4000000, stream_read, b, 0, &reader));
+        num_txs = 0;
+        do {
+            check_ret(wally_block_reader_next_tx(reader, &tx_bytes, &tx_bytes_len,
+                                                 txid, sizeof(txid)));
+            num_txs += tx_bytes != NULL;
+        } while (tx_bytes);
+        check_ret(wally_block_reader_free(reader));
+        if (num_txs != NUM_STREAM_BLOCKS * NUM_STREAM_BLOCK_TXS)
+            exit(1);
+    }
+}
+
+static void bench_block_get_short_ids(void *ctx, size_t iterations)
+{
+    const struct stream_bench *b = ctx;
+    unsigned char short_ids[NUM_STREAM_BLOCK_TXS * WALLY_BIP152_SHORT_ID_LEN];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_block_get_short_ids(b->bytes, b->bytes_len, i,
+                                            WALLY_TX_FLAG_USE_WITNESS, short_ids,
+                                            sizeof(short_ids), &written));
+        if (written != sizeof(short_ids))
+            exit(1);
+    }
+}
+
+/* Decode a block into columns, then scan its output values */
+static void bench_block_get_tx_batch(void *ctx, size_t iterations)
+{
+    const struct stream_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        struct wally_tx_batch *batch;
+        uint64_t total = 0;
+
+        check_ret(wally_block_get_tx_batch(b->bytes, b->bytes_len, 0, &batch));
+        for (j = 0; j < batch->num_outputs; ++j)
+            total += batch->satoshis[j];
+        if (batch->num_txs != NUM_STREAM_BLOCK_TXS || !total)
+            exit(1);
+        check_ret(wally_tx_batch_free(batch));
+    }
+}
+
+/* Txids, wtxids and the merkle root of a block, serially or on a pool */
+#define NUM_TXIDS_POOL_THREADS 4
+
+struct block_txids_bench {
+    const struct stream_bench *block;
+    struct wally_thread_pool *pool;
+    unsigned char hashes[NUM_STREAM_BLOCK_TXS * 2 * WALLY_TXHASH_LEN];
+    unsigned char merkle_root[SHA256_LEN];
+};
+
+static void bench_block_get_txids(void *ctx, size_t iterations)
+{
+    struct block_txids_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_block_get_txids(b->block->bytes, b->block->bytes_len,
+                                        WALLY_TX_FLAG_USE_WITNESS,
+                                        b->pool ? wally_thread_pool_run : NULL, b->pool,
+                                        b->merkle_root, sizeof(b->merkle_root),
+                                        b->hashes, sizeof(b->hashes), &written));
+        if (written != sizeof(b->hashes))
+            exit(1);
+    }
+}
+
+static void bench_block_txids(const struct stream_bench *block)
+{
+    struct block_txids_bench *b = malloc(sizeof(*b));
+
+    if (!b)
+        exit(1);
+    b->block = block;
+    b->pool = NULL;
+    run_bench("block_get_txids_1000_txs", bench_block_get_txids, b, 50);
+    check_ret(wally_thread_pool_init_alloc(NUM_TXIDS_POOL_THREADS, &b->pool));
+    run_bench("block_get_txids_1000_txs_pool", bench_block_get_txids, b, 50);
+    check_ret(wally_thread_pool_free(b->pool));
+    free(b);
+}
+
+/* BIP 158 filters of a block whose inputs spend distinct p2wpkh scripts */
+#define FILTER_SCRIPT_LEN 22
+#define NUM_FILTER_PREVOUTS (2 * NUM_STREAM_BLOCK_TXS - 2) /* Excluding the coinbase */
+#define NUM_FILTER_SCRIPTS (NUM_FILTER_PREVOUTS + NUM_STREAM_BLOCK_TXS / 2)
+
+struct filter_bench {
+    const unsigned char *block;
+    size_t block_len;
+    unsigned char block_hash[SHA256_LEN];
+    unsigned char scripts[NUM_FILTER_SCRIPTS * FILTER_SCRIPT_LEN];
+    uint32_t lens[NUM_FILTER_SCRIPTS];
+    unsigned char filter[8192];
+    size_t filter_len;
+};
+
+static void bench_block_get_bip158_filter(void *ctx, size_t iterations)
+{
+    struct filter_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_block_get_bip158_filter(b->block, b->block_len,
+                                                b->scripts, NUM_FILTER_PREVOUTS * FILTER_SCRIPT_LEN,
+                                                b->lens, NUM_FILTER_PREVOUTS, 0,
+                                                b->filter, sizeof(b->filter),
+                                                &b->filter_len));
+        if (b->filter_len > sizeof(b->filter))
+            exit(1);
+    }
+}
+
+/* Match a wallet of 1000 scripts, half of them spent in the block */
+static void bench_bip158_filter_match(void *ctx, size_t iterations)
+{
+    const struct filter_bench *b = ctx;
+    const size_t offset = NUM_FILTER_SCRIPTS - NUM_STREAM_BLOCK_TXS;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_bip158_filter_match(b->block_hash, SHA256_LEN,
+                                            b->filter, b->filter_len,
+                                            b->scripts + offset * FILTER_SCRIPT_LEN,
+                                            NUM_STREAM_BLOCK_TXS * FILTER_SCRIPT_LEN,
+                                            b->lens, NUM_STREAM_BLOCK_TXS, &written));
+        if (written < NUM_STREAM_BLOCK_TXS / 2)
+            exit(1);
+    }
+}
+
+static void bench_bip158_filters(const unsigned char *block, size_t block_len)
+{
+    struct filter_bench *b = malloc(sizeof(*b));
+    size_t i;
+
+    if (!b)
+        exit(1);
+    b->block = block;
+    b->block_len = block_len;
+    check_ret(wally_block_get_hash(block, block_len, b->block_hash, SHA256_LEN));
+    for (i = 0; i < NUM_FILTER_SCRIPTS; ++i) {
+        unsigned char *p = b->scripts + i * FILTER_SCRIPT_LEN;
+        p[0] = OP_0;
+        p[1] = HASH160_LEN;
+        fill(p + 2, HASH160_LEN, (unsigned char)i);
+        memcpy(p + 2, &i, sizeof(uint16_t)); /* Make each script distinct */
+        b->lens[i] = FILTER_SCRIPT_LEN;
+    }
+    bench_block_get_bip158_filter(b, 1); /* Build the filter to match against */
+    run_bench("block_get_bip158_filter_1000_txs", bench_block_get_bip158_filter, b, 50);
+    run_bench("bip158_filter_match_1000_scripts", bench_bip158_filter_match, b, 50);
+    free(b);
+}
+
+/* Verify a chain of 2016 headers, one difficulty period */
+#define NUM_CHAIN_HEADERS 2016
+
+static void bench_block_header_verify_chain(void *ctx, size_t iterations)
+{
+    const unsigned char *headers = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        check_ret(wally_block_header_verify_chain(headers,
+                                                  NUM_CHAIN_HEADERS * WALLY_BLOCK_HEADER_LEN,
+                                                  NULL, 0, 0, NULL, 0, &written));
+        if (written != NUM_CHAIN_HEADERS)
+            exit(1);
+    }
+}
+
+static void bench_header_chain(void)
+{
+    unsigned char *headers, *p;
+    size_t i;
+
+    if (!(headers = malloc(NUM_CHAIN_HEADERS * WALLY_BLOCK_HEADER_LEN)))
+        exit(1);
+    for (i = 0, p = headers; i < NUM_CHAIN_HEADERS; ++i, p += WALLY_BLOCK_HEADER_LEN) {
+        fill(p, WALLY_BLOCK_HEADER_LEN, (unsigned char)i);
+        if (i)
+            check_ret(wally_block_get_hash(p - WALLY_BLOCK_HEADER_LEN, WALLY_BLOCK_HEADER_LEN,
+                                           p + 4, SHA256_LEN));
+        /* The easiest target whose top two bytes any hash meets */
+        p[72] = 0xff;
+        p[73] = 0xff;
+        p[74] = 0x00;
+        p[75] = 0x21;
+    }
+    run_bench("block_header_verify_chain_2016", bench_block_header_verify_chain, headers, 20);
+    free(headers);
+}
+
+/* Stream 10 blocks of 1000 two input transactions with their txids */
+static void bench_block_files(void)
+{
+    struct tx_bench tx;
+    struct stream_bench b;
+    size_t block_len, i, j;
+    unsigned char *p;
+
+    tx_bench_init(&tx, 2);
+    block_len = WALLY_BLOCK_HEADER_LEN + 3 + NUM_STREAM_BLOCK_TXS * tx.bytes_len;
+    b.bytes_len = NUM_STREAM_BLOCKS * (8 + block_len);
+    if (!(b.bytes = malloc(b.bytes_len)))
+        exit(1);
+    for (i = 0, p = b.bytes; i < NUM_STREAM_BLOCKS; ++i) {
+        const uint32_t magic = WALLY_NETWORK_MAGIC_MAINNET;
+        unsigned char frame[8] = {
+            magic & 0xff, (magic >> 8) & 0xff, (magic >> 16) & 0xff, magic >> 24,
+            block_len & 0xff, (block_len >> 8) & 0xff, (block_len >> 16) & 0xff, 0
+        };
+        memcpy(p, frame, sizeof(frame));
+        fill(p + 8, WALLY_BLOCK_HEADER_LEN, (unsigned char)i);
+        p += 8 + WALLY_BLOCK_HEADER_LEN;
+        *p++ = 0xfd; /* Transaction count as a 3 byte varint */
+        *p++ = NUM_STREAM_BLOCK_TXS & 0xff;
+        *p++ = NUM_STREAM_BLOCK_TXS >> 8;
+        for (j = 0; j < NUM_STREAM_BLOCK_TXS; ++j, p += tx.bytes_len)
+            memcpy(p, tx.bytes, tx.bytes_len);
+    }
+    run_bench("block_reader_10x1000_txs", bench_block_reader, &b, 20);
+    /* Compact block short ids of the first block */
+    b.bytes += 8;
+    b.bytes_len = block_len;
+    run_bench("block_get_short_ids_1000_txs", bench_block_get_short_ids, &b, 50);
+    run_bench("block_get_tx_batch_1000_txs", bench_block_get_tx_batch, &b, 50);
+    bench_block_txids(&b);
+    bench_bip158_filters(b.bytes, b.bytes_len);
+    b.bytes -= 8;
+    free(b.bytes);
+    tx_bench_free(&tx);
+    bench_header_chain();
+}
+
+/*
+ * Transaction signing
+ */
+#define NUM_SIGN_INPUTS 10
+
+struct sign_bench {
+    struct wally_tx *tx;
+    unsigned char priv_keys[NUM_SIGN_INPUTS * EC_PRIVATE_KEY_LEN];
+    unsigned char scripts[NUM_SIGN_INPUTS * (1 + WALLY_SCRIPTPUBKEY_P2WPKH_LEN)];
+    uint64_t values[NUM_SIGN_INPUTS];
+};
+
+static void bench_sign_inputs(void *ctx, size_t iterations)
+{
+    struct sign_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_sign_inputs(b->tx, b->scripts, sizeof(b->scripts),
+                                       b->values, NUM_SIGN_INPUTS,
+                                       b->priv_keys, sizeof(b->priv_keys),
+                                       WALLY_SIGHASH_ALL, EC_FLAG_GRIND_R));
+}
+
+/* Sign each input in turn from its private key, as callers did before
+ * wally_tx_sign_inputs */
+static void bench_sign_inputs_loop(void *ctx, size_t iterations)
+{
+    struct sign_bench *b = ctx;
+    unsigned char script_code[WALLY_SCRIPTPUBKEY_P2PKH_LEN], hash[SHA256_LEN];
+    unsigned char sig[EC_SIGNATURE_LEN], der[EC_SIGNATURE_DER_MAX_LEN + 1];
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN];
+    size_t i, j, written, der_len;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < NUM_SIGN_INPUTS; ++j) {
+            const unsigned char *program = b->scripts + j * (1 + WALLY_SCRIPTPUBKEY_P2WPKH_LEN) + 3;
+            const unsigned char *priv_key = b->priv_keys + j * EC_PRIVATE_KEY_LEN;
+            struct wally_tx_witness_stack *witness;
+
+            check_ret(wally_ec_public_key_from_private_key(priv_key, EC_PRIVATE_KEY_LEN,
+                                                           pub_key, sizeof(pub_key)));
+            check_ret(wally_scriptpubkey_p2pkh_from_bytes(program, HASH160_LEN, 0,
+                                                          script_code, sizeof(script_code),
+                                                          &written));
+            check_ret(wally_tx_get_btc_signature_hash(b->tx, j, script_code, sizeof(script_code),
+                                                      b->values[j], WALLY_SIGHASH_ALL,
+                                                      WALLY_TX_FLAG_USE_WITNESS,
+                                                      hash, sizeof(hash)));
+            check_ret(wally_ec_sig_from_bytes(priv_key, EC_PRIVATE_KEY_LEN, hash, sizeof(hash),
+                                              EC_FLAG_ECDSA | EC_FLAG_GRIND_R,
+                                              sig, sizeof(sig)));
+            check_ret(wally_ec_sig_to_der(sig, sizeof(sig), der, sizeof(der), &der_len));
+            der[der_len++] = WALLY_SIGHASH_ALL;
+            check_ret(wally_tx_witness_stack_init_alloc(2, &witness));
+            check_ret(wally_tx_witness_stack_add(witness, der, der_len));
+            check_ret(wally_tx_witness_stack_add(witness, pub_key, sizeof(pub_key)));
+            check_ret(wally_tx_set_input_witness(b->tx, j, witness));
+            check_ret(wally_tx_witness_stack_free(witness));
+        }
+    }
+}
+
+static void bench_verify_inputs(void *ctx, size_t iterations)
+{
+    struct sign_bench *b = ctx;
+    unsigned char results[NUM_SIGN_INPUTS];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_verify_input_signatures(b->tx, b->scripts, sizeof(b->scripts),
+                                                   b->values, NUM_SIGN_INPUTS, 0,
+                                                   results, sizeof(results)));
+}
+
+/* Verify each input in turn from its witness */
+static void bench_verify_inputs_loop(void *ctx, size_t iterations)
+{
+    struct sign_bench *b = ctx;
+    unsigned char script_code[WALLY_SCRIPTPUBKEY_P2PKH_LEN], hash[SHA256_LEN];
+    unsigned char sig[EC_SIGNATURE_LEN];
+    size_t i, j, written;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < NUM_SIGN_INPUTS; ++j) {
+            const struct wally_tx_witness_stack *witness = b->tx->inputs[j].witness;
+            const struct wally_tx_witness_item *der = witness->items;
+            const struct wally_tx_witness_item *pub_key = witness->items + 1;
+
+            check_ret(wally_hash160(pub_key->witness, pub_key->witness_len,
+                                    hash, HASH160_LEN));
+            check_ret(wally_scriptpubkey_p2pkh_from_bytes(hash, HASH160_LEN, 0,
+                                                          script_code, sizeof(script_code),
+                                                          &written));
+            check_ret(wally_tx_get_btc_signature_hash(b->tx, j, script_code, sizeof(script_code),
+                                                      b->values[j],
+                                                      der->witness[der->witness_len - 1],
+                                                      WALLY_TX_FLAG_USE_WITNESS,
+                                                      hash, sizeof(hash)));
+            check_ret(wally_ec_sig_from_der(der->witness, der->witness_len - 1,
+                                            sig, sizeof(sig)));
+            check_ret(wally_ec_sig_verify(pub_key->witness, pub_key->witness_len,
+                                          hash, sizeof(hash), EC_FLAG_ECDSA,
+                                          sig, sizeof(sig)));
+        }
+    }
+}
+
+/* Sign and verify a 10 input p2wpkh transaction */
+static void bench_signing(void)
+{
+    struct sign_bench b;
+    unsigned char txhash[WALLY_TXHASH_LEN], pub_key[EC_PUBLIC_KEY_LEN], h160[HASH160_LEN];
+    unsigned char *p = b.scripts;
+    size_t i, written;
+
+    check_ret(wally_tx_init_alloc(2, 0, NUM_SIGN_INPUTS, 1, &b.tx));
+    for (i = 0; i < NUM_SIGN_INPUTS; ++i) {
+        unsigned char *priv_key = b.priv_keys + i * EC_PRIVATE_KEY_LEN;
+
+        fill(txhash, sizeof(txhash), (unsigned char)i);
+        check_ret(wally_tx_add_raw_input(b.tx, txhash, sizeof(txhash), 0, 0xffffffff,
+                                         NULL, 0, NULL, 0));
+        fill(priv_key, EC_PRIVATE_KEY_LEN, (unsigned char)(i + 1));
+        check_ret(wally_ec_public_key_from_private_key(priv_key, EC_PRIVATE_KEY_LEN,
+                                                       pub_key, sizeof(pub_key)));
+        check_ret(wally_hash160(pub_key, sizeof(pub_key), h160, sizeof(h160)));
+        *p++ = WALLY_SCRIPTPUBKEY_P2WPKH_LEN;
+        check_ret(wally_witness_program_from_bytes(h160, sizeof(h160), 0, p,
+                                                   WALLY_SCRIPTPUBKEY_P2WPKH_LEN, &written));
+        p += WALLY_SCRIPTPUBKEY_P2WPKH_LEN;
+        b.values[i] = 100000 + i;
+    }
+    check_ret(wally_tx_add_raw_output(b.tx, 900000, b.scripts + 1,
+                                      WALLY_SCRIPTPUBKEY_P2WPKH_LEN, 0));
+    run_bench("tx_sign_inputs_p2wpkh_10", bench_sign_inputs, &b, 200);
+    run_bench("tx_sign_inputs_p2wpkh_10_loop", bench_sign_inputs_loop, &b, 200);
+    /* The benchmarks above leave the transaction signed */
+    check_ret(wally_tx_sign_inputs(b.tx, b.scripts, sizeof(b.scripts), b.values,
+                                   NUM_SIGN_INPUTS, b.priv_keys, sizeof(b.priv_keys),
+                                   WALLY_SIGHASH_ALL, EC_FLAG_GRIND_R));
+    run_bench("tx_verify_input_signatures_p2wpkh_10", bench_verify_inputs, &b, 200);
+    run_bench("tx_verify_input_signatures_p2wpkh_10_loop", bench_verify_inputs_loop, &b, 200);
+    check_ret(wally_tx_free(b.tx));
+}
+
+/* Pre-segwit SIGHASH_ALL hashes of a sweep of 300 2-of-3 multisig inputs */
+#define NUM_LEGACY_INPUTS 300
+#define LEGACY_SCRIPT_LEN 105
+
+struct legacy_sighash_bench {
+    struct wally_tx *tx;
+    unsigned char scripts[NUM_LEGACY_INPUTS * (1 + LEGACY_SCRIPT_LEN)];
+    uint64_t values[NUM_LEGACY_INPUTS];
+    uint32_t sighashes[NUM_LEGACY_INPUTS];
+    unsigned char hashes[NUM_LEGACY_INPUTS * SHA256_LEN];
+};
+
+static void bench_legacy_sighashes(void *ctx, size_t iterations)
+{
+    struct legacy_sighash_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_get_signature_hashes(b->tx, b->scripts, sizeof(b->scripts),
+                                                b->values, NUM_LEGACY_INPUTS,
+                                                b->sighashes, NUM_LEGACY_INPUTS, 0,
+                                                b->hashes, sizeof(b->hashes)));
+}
+
+/* Hash each input in turn, as callers without a batch function do */
+static void bench_legacy_sighashes_loop(void *ctx, size_t iterations)
+{
+    struct legacy_sighash_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < NUM_LEGACY_INPUTS; ++j)
+            check_ret(wally_tx_get_btc_signature_hash(b->tx, j,
+                                                      b->scripts + j * (1 + LEGACY_SCRIPT_LEN) + 1,
+                                                      LEGACY_SCRIPT_LEN, 0, WALLY_SIGHASH_ALL, 0,
+                                                      b->hashes + j * SHA256_LEN, SHA256_LEN));
+}
+
+static void bench_legacy_sighash(void)
+{
+    struct legacy_sighash_bench *b = malloc(sizeof(*b));
+    unsigned char txhash[WALLY_TXHASH_LEN], *p;
+    size_t i;
+
+    if (!b)
+        exit(1);
+    check_ret(wally_tx_init_alloc(1, 0, NUM_LEGACY_INPUTS, 2, &b->tx));
+    for (i = 0, p = b->scripts; i < NUM_LEGACY_INPUTS; ++i) {
+        fill(txhash, sizeof(txhash), (unsigned char)i);
+        check_ret(wally_tx_add_raw_input(b->tx, txhash, sizeof(txhash), (uint32_t)i,
+                                         0xffffffff, NULL, 0, NULL, 0));
+        *p++ = LEGACY_SCRIPT_LEN;
+        fill(p, LEGACY_SCRIPT_LEN, (unsigned char)(i + 1));
+        p += LEGACY_SCRIPT_LEN;
+        b->values[i] = 100000 + i;
+        b->sighashes[i] = WALLY_SIGHASH_ALL;
+    }
+    for (i = 0; i < 2; ++i)
+        check_ret(wally_tx_add_raw_output(b->tx, 1000000 + i, b->scripts + 1,
+                                          WALLY_SCRIPTPUBKEY_P2PKH_LEN, 0));
+    run_bench("tx_get_signature_hashes_legacy_300", bench_legacy_sighashes, b, 20);
+    run_bench("tx_get_signature_hashes_legacy_300_loop", bench_legacy_sighashes_loop, b, 20);
+    check_ret(wally_tx_free(b->tx));
+    free(b);
+}
+
+/*
+ * Multisig scripts
+ */
+struct multisig_bench {
+    unsigned char pub_keys[3 * EC_PUBLIC_KEY_LEN];
+    unsigned char sigs[2 * EC_SIGNATURE_LEN];
+    uint32_t sighashes[2];
+    unsigned char ders[2 * (EC_SIGNATURE_DER_MAX_LEN + 1)];
+    uint32_t der_lens[2];
+    size_t ders_len;
+    unsigned char script[3 + 3 * (EC_PUBLIC_KEY_LEN + 1)];
+};
+
+static void multisig_scriptpubkey(const struct multisig_bench *b,
+                                  size_t iterations, uint32_t flags)
+{
+    unsigned char script[sizeof(b->script)];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scriptpubkey_multisig_from_bytes(b->pub_keys, sizeof(b->pub_keys),
+                                                         2, flags, script,
+                                                         sizeof(script), &written));
+}
+
+static void bench_scriptpubkey_multisig(void *ctx, size_t iterations)
+{
+    multisig_scriptpubkey(ctx, iterations, 0);
+}
+
+static void bench_scriptpubkey_multisig_sorted(void *ctx, size_t iterations)
+{
+    multisig_scriptpubkey(ctx, iterations, WALLY_SCRIPT_MULTISIG_SORTED);
+}
+
+static void bench_scriptsig_multisig_from_bytes(void *ctx, size_t iterations)
+{
+    const struct multisig_bench *b = ctx;
+    unsigned char script_sig[512];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scriptsig_multisig_from_bytes(b->script, sizeof(b->script),
+                                                      b->sigs, sizeof(b->sigs),
+                                                      b->sighashes, 2, 0, script_sig,
+                                                      sizeof(script_sig), &written));
+}
+
+static void bench_scriptsig_multisig_from_der(void *ctx, size_t iterations)
+{
+    const struct multisig_bench *b = ctx;
+    unsigned char script_sig[512];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scriptsig_multisig_from_der(b->script, sizeof(b->script),
+                                                    b->ders, b->ders_len,
+                                                    b->der_lens, 2, 0, script_sig,
+                                                    sizeof(script_sig), &written));
+}
+
+#define NUM_DEPOSIT_SCRIPTS 1000
+
+struct deposit_bench {
+    unsigned char scripts[NUM_DEPOSIT_SCRIPTS * (3 + 3 * (EC_PUBLIC_KEY_LEN + 1))];
+    unsigned char spks[NUM_DEPOSIT_SCRIPTS * WALLY_SCRIPTPUBKEY_P2WSH_LEN];
+    char addrs[NUM_DEPOSIT_SCRIPTS * 64];
+};
+
+static const size_t deposit_script_len = 3 + 3 * (EC_PUBLIC_KEY_LEN + 1);
+
+/* Derive each P2WSH deposit address one script at a time */
+static void bench_p2wsh_addresses(void *ctx, size_t iterations)
+{
+    struct deposit_bench *b = ctx;
+    size_t i, j, written;
+
+    for (i = 0; i < iterations; ++i) {
+        char *p = b->addrs;
+        for (j = 0; j < NUM_DEPOSIT_SCRIPTS; ++j) {
+            unsigned char sha[SHA256_LEN];
+            unsigned char *spk = b->spks + j * WALLY_SCRIPTPUBKEY_P2WSH_LEN;
+            check_ret(wally_sha256(b->scripts + j * deposit_script_len,
+                                   deposit_script_len, sha, sizeof(sha)));
+            check_ret(wally_witness_program_from_bytes(sha, sizeof(sha), 0, spk,
+                                                       WALLY_SCRIPTPUBKEY_P2WSH_LEN,
+                                                       &written));
+            check_ret(wally_addr_segwit_from_bytes_to_buffer(spk, written, "bc", 0, p,
+                                                             b->addrs + sizeof(b->addrs) - p,
+                                                             &written));
+            p += written;
+        }
+    }
+}
+
+static void bench_p2wsh_addresses_batch(void *ctx, size_t iterations)
+{
+    struct deposit_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scripts_to_addresses(b->scripts, sizeof(b->scripts),
+                                             deposit_script_len, WALLY_SCRIPT_TYPE_P2WSH,
+                                             "bc", 0, 0, b->spks, sizeof(b->spks),
+                                             b->addrs, sizeof(b->addrs), &written));
+}
+
+/* Build 2-of-3 multisig scripts, scriptSigs and deposit addresses */
+static void bench_multisig(void)
+{
+    struct multisig_bench b;
+    struct deposit_bench *deposit;
+    size_t i, written;
+
+    fill(b.pub_keys, sizeof(b.pub_keys), 1);
+    fill(b.sigs, sizeof(b.sigs), 2);
+    b.ders_len = 0;
+    for (i = 0; i < 2; ++i) {
+        b.pub_keys[i * EC_PUBLIC_KEY_LEN] = 0x02 + i;
+        b.sigs[i * EC_SIGNATURE_LEN] &= 0x7f; /* Keep R and S in range */
+        b.sigs[i * EC_SIGNATURE_LEN + EC_SIGNATURE_LEN / 2] &= 0x7f;
+        b.sighashes[i] = WALLY_SIGHASH_ALL;
+        check_ret(wally_ec_sig_to_der(b.sigs + i * EC_SIGNATURE_LEN, EC_SIGNATURE_LEN,
+                                      b.ders + b.ders_len, EC_SIGNATURE_DER_MAX_LEN,
+                                      &written));
+        b.ders[b.ders_len + written] = WALLY_SIGHASH_ALL;
+        b.der_lens[i] = written + 1;
+        b.ders_len += written + 1;
+    }
+    b.pub_keys[2 * EC_PUBLIC_KEY_LEN] = 0x02;
+    check_ret(wally_scriptpubkey_multisig_from_bytes(b.pub_keys, sizeof(b.pub_keys), 2,
+                                                     WALLY_SCRIPT_MULTISIG_SORTED,
+                                                     b.script, sizeof(b.script), &written));
+    run_bench("scriptpubkey_multisig_2of3", bench_scriptpubkey_multisig, &b, 200000);
+    run_bench("scriptpubkey_multisig_2of3_sorted", bench_scriptpubkey_multisig_sorted, &b, 200000);
+    run_bench("scriptsig_multisig_2of3_from_bytes", bench_scriptsig_multisig_from_bytes, &b, 20000);
+    run_bench("scriptsig_multisig_2of3_from_der", bench_scriptsig_multisig_from_der, &b, 200000);
+
+    /* Vary the first key of each redeem script to create deposit scripts */
+    deposit = malloc(sizeof(*deposit));
+    if (!deposit)
+        exit(1);
+    for (i = 0; i < NUM_DEPOSIT_SCRIPTS; ++i) {
+        memcpy(deposit->scripts + i * deposit_script_len, b.script, deposit_script_len);
+        memcpy(deposit->scripts + i * deposit_script_len + 3, &i, sizeof(i));
+    }
+    run_bench("p2wsh_addresses_2of3", bench_p2wsh_addresses, deposit, 20);
+    run_bench("p2wsh_addresses_2of3_batch", bench_p2wsh_addresses_batch, deposit, 20);
+    free(deposit);
+}
+
+/*
+ * BIP32/BIP39
+ */
+struct bip32_bench {
+    struct ext_key master;
+    struct ext_key master_pub;
+};
+
+static void bench_bip32_priv(void *ctx, size_t iterations)
+{
+    const struct bip32_bench *b = ctx;
+    struct ext_key child;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent(&b->master, (uint32_t)i,
+                                        BIP32_FLAG_KEY_PRIVATE, &child));
+}
+
+static void bench_bip32_priv_hardened(void *ctx, size_t iterations)
+{
+    const struct bip32_bench *b = ctx;
+    struct ext_key child;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent(&b->master,
+                                        BIP32_INITIAL_HARDENED_CHILD | (uint32_t)i,
+                                        BIP32_FLAG_KEY_PRIVATE, &child));
+}
+
+static void bench_bip32_pub(void *ctx, size_t iterations)
+{
+    const struct bip32_bench *b = ctx;
+    struct ext_key child;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent(&b->master_pub, (uint32_t)i,
+                                        BIP32_FLAG_KEY_PUBLIC, &child));
+}
+
+/* Derive a BIP84 account key, m/84'/0'/0' */
+static void bench_bip32_path_account(void *ctx, size_t iterations)
+{
+    const struct bip32_bench *b = ctx;
+    const uint32_t path[] = { BIP32_INITIAL_HARDENED_CHILD | 84,
+                              BIP32_INITIAL_HARDENED_CHILD,
+                              BIP32_INITIAL_HARDENED_CHILD };
+    struct ext_key account;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent_path(&b->master, path, 3,
+                                             BIP32_FLAG_KEY_PRIVATE, &account));
+}
+
+#define NUM_EXPORT_KEYS 64
+#define XKEY_STR_LEN 112 /* A base58 extended key and its NUL terminator */
+
+/* Export account xpubs one at a time, or as a single batch */
+static void bench_bip32_export_impl(void *ctx, size_t iterations, bool batch)
+{
+    const struct bip32_bench *b = ctx;
+    struct ext_key keys[NUM_EXPORT_KEYS];
+    unsigned char bytes[NUM_EXPORT_KEYS * BIP32_SERIALIZED_LEN];
+    char out[NUM_EXPORT_KEYS * XKEY_STR_LEN], *str;
+    size_t i, j, written;
+
+    for (i = 0; i < NUM_EXPORT_KEYS; ++i)
+        keys[i] = b->master_pub;
+    for (i = 0; i < iterations; ++i) {
+        if (batch) {
+            check_ret(bip32_key_to_base58_batch(keys, NUM_EXPORT_KEYS, BIP32_FLAG_KEY_PUBLIC,
+                                                bytes, sizeof(bytes),
+                                                out, sizeof(out), &written));
+            continue;
+        }
+        for (j = 0; j < NUM_EXPORT_KEYS; ++j) {
+            check_ret(bip32_key_serialize(keys + j, BIP32_FLAG_KEY_PUBLIC,
+                                          bytes + j * BIP32_SERIALIZED_LEN,
+                                          BIP32_SERIALIZED_LEN));
+            check_ret(bip32_key_to_base58(keys + j, BIP32_FLAG_KEY_PUBLIC, &str));
+            memcpy(out + j * XKEY_STR_LEN, str, XKEY_STR_LEN);
+            check_ret(wally_free_string(str));
+        }
+    }
+}
+
+static void bench_bip32_export(void *ctx, size_t iterations)
+{
+    bench_bip32_export_impl(ctx, iterations, true);
+}
+
+static void bench_bip32_export_separate(void *ctx, size_t iterations)
+{
+    bench_bip32_export_impl(ctx, iterations, false);
+}
+
+static void bench_bip39_seed(void *ctx, size_t iterations)
+{
+    unsigned char seed[BIP39_SEED_LEN_512];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip39_mnemonic_to_seed(ctx, "passphrase", seed, sizeof(seed), &written));
+}
+
+struct bip39_bench {
+    char *en;
+    char *es;
+};
+
+static void bench_bip39_validate(const char *lang, const char *mnemonic, size_t iterations)
+{
+    struct words *w;
+    size_t i;
+
+    check_ret(bip39_get_wordlist(lang, &w));
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip39_mnemonic_validate(w, mnemonic));
+}
+
+static void bench_bip39_validate_en(void *ctx, size_t iterations)
+{
+    bench_bip39_validate("en", ((const struct bip39_bench *)ctx)->en, iterations);
+}
+
+/* Spanish is not sorted in code point order, so has no binary search */
+static void bench_bip39_validate_es(void *ctx, size_t iterations)
+{
+    bench_bip39_validate("es", ((const struct bip39_bench *)ctx)->es, iterations);
+}
+
+static void bench_bip39_detect(void *ctx, size_t iterations)
+{
+    const char *mnemonic = ((const struct bip39_bench *)ctx)->es;
+    size_t i, mask;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip39_mnemonic_detect_languages(mnemonic, &mask));
+}
+
+/* Try every language in turn, as callers did before
+ * bip39_mnemonic_detect_languages */
+static void bench_bip39_detect_loop(void *ctx, size_t iterations)
+{
+    static const char *langs[] = { "en", "es", "fr", "it", "jp", "zhs", "zht" };
+    const char *mnemonic = ((const struct bip39_bench *)ctx)->es;
+    struct words *w;
+    size_t i, j, mask;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0, mask = 0; j < sizeof(langs) / sizeof(langs[0]); ++j) {
+            check_ret(bip39_get_wordlist(langs[j], &w));
+            if (bip39_mnemonic_validate(w, mnemonic) == WALLY_OK)
+                mask |= 1u << j;
+        }
+    }
+}
+
+/* Find every single word replacement with a valid checksum */
+static void bench_bip39_recover(void *ctx, size_t iterations)
+{
+    const char *mnemonic = ((const struct bip39_bench *)ctx)->en;
+    uint32_t candidates[2048];
+    struct words *w;
+    size_t i, written;
+
+    check_ret(bip39_get_wordlist("en", &w));
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip39_mnemonic_recover(w, mnemonic, BIP39_RECOVER_FLAG_REPLACE,
+                                         NULL, NULL, 0, NULL, 0, 0, NULL, NULL,
+                                         candidates, sizeof(candidates) / sizeof(candidates[0]),
+                                         &written));
+}
+
+static void bench_bip39(void)
+{
+    unsigned char entropy[BIP39_ENTROPY_LEN_256];
+    struct bip39_bench b;
+    struct words *w;
+
+    fill(entropy, sizeof(entropy), 1);
+    check_ret(bip39_get_wordlist("en", &w));
+    check_ret(bip39_mnemonic_from_bytes(w, entropy, sizeof(entropy), &b.en));
+    check_ret(bip39_get_wordlist("es", &w));
+    check_ret(bip39_mnemonic_from_bytes(w, entropy, sizeof(entropy), &b.es));
+    run_bench("bip39_mnemonic_validate_24_en", bench_bip39_validate_en, &b, 20000);
+    run_bench("bip39_mnemonic_validate_24_es", bench_bip39_validate_es, &b, 20000);
+    run_bench("bip39_mnemonic_detect_24_es", bench_bip39_detect, &b, 20000);
+    run_bench("bip39_mnemonic_detect_24_es_loop", bench_bip39_detect_loop, &b, 20000);
+    run_bench("bip39_mnemonic_recover_24_replace", bench_bip39_recover, &b, 20);
+    check_ret(wally_free_string(b.en));
+    check_ret(wally_free_string(b.es));
+}
+
+static void bench_bip32(void)
+{
+    static char mnemonic[] = "abandon abandon abandon abandon abandon abandon "
+                             "abandon abandon abandon abandon abandon about";
+    unsigned char seed[BIP32_ENTROPY_LEN_256];
+    struct bip32_bench b;
+
+    fill(seed, sizeof(seed), 1);
+    check_ret(bip32_key_from_seed(seed, sizeof(seed), BIP32_VER_MAIN_PRIVATE, 0, &b.master));
+    check_ret(bip32_key_from_parent(&b.master, 0, BIP32_FLAG_KEY_PUBLIC, &b.master_pub));
+    run_bench("bip32_derive_priv", bench_bip32_priv, &b, 2000);
+    run_bench("bip32_derive_priv_hardened", bench_bip32_priv_hardened, &b, 2000);
+    run_bench("bip32_derive_pub", bench_bip32_pub, &b, 2000);
+    run_bench("bip32_derive_path_account", bench_bip32_path_account, &b, 2000);
+    run_bench("bip32_key_to_base58_batch_64", bench_bip32_export, &b, 500);
+    run_bench("bip32_key_to_base58_batch_64_separate", bench_bip32_export_separate, &b, 500);
+    run_bench("bip39_mnemonic_to_seed", bench_bip39_seed, mnemonic, 20);
+}
+
+/*
+ * Encodings
+ */
+struct encode_bench {
+    unsigned char bytes[1024];
+    char *str;
+};
+
+static void bench_base58_from_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_base58_from_bytes(b->bytes, BIP32_SERIALIZED_LEN,
+                                          BASE58_FLAG_CHECKSUM, &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+static void bench_base58_to_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char bytes[BIP32_SERIALIZED_LEN + BASE58_CHECKSUM_LEN];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_base58_to_bytes(b->str, BASE58_FLAG_CHECKSUM,
+                                        bytes, sizeof(bytes), &written));
+}
+
+static void bench_segwit_from_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_addr_segwit_from_bytes(b->bytes, WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                               "bc", 0, &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+static void bench_segwit_to_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char bytes[WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_addr_segwit_to_bytes(b->str, "bc", 0,
+                                             bytes, sizeof(bytes), &written));
+}
+
+static void bench_hex_from_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_hex_from_bytes(b->bytes, sizeof(b->bytes), &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+static void bench_hex_to_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char bytes[sizeof(b->bytes)];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_hex_to_bytes(b->str, bytes, sizeof(bytes), &written));
+}
+
+static void bench_base64_from_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    char str[sizeof(b->bytes) / 3 * 4 + 8];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_base64_from_bytes_to_buffer(b->bytes, sizeof(b->bytes), 0,
+                                                    str, sizeof(str), &written));
+}
+
+static void bench_base64_to_bytes(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char bytes[sizeof(b->bytes)];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_base64_to_bytes(b->str, 0, bytes, sizeof(bytes), &written));
+}
+
+static void bench_wif_decode(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    uint32_t flags;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_wif_decode(b->str, 0x80, 0x00, priv_key, sizeof(priv_key),
+                                   pub_key, sizeof(pub_key), &flags, &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+/* Decode the private key, public key and address separately, as callers did
+ * before wally_wif_decode */
+static void bench_wif_decode_separate(void *ctx, size_t iterations)
+{
+    struct encode_bench *b = ctx;
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_wif_is_uncompressed(b->str, &written));
+        check_ret(wally_wif_to_bytes(b->str, 0x80, written ? WALLY_WIF_FLAG_UNCOMPRESSED
+                                                           : WALLY_WIF_FLAG_COMPRESSED,
+                                     priv_key, sizeof(priv_key)));
+        check_ret(wally_wif_to_public_key(b->str, 0x80, pub_key, sizeof(pub_key), &written));
+        check_ret(wally_wif_to_address(b->str, 0x80, 0x00, &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+static void bench_encodings(void)
+{
+    struct encode_bench b;
+    struct ext_key master;
+
+    fill(b.bytes, sizeof(b.bytes), 1);
+    check_ret(bip32_key_from_seed(b.bytes, BIP32_ENTROPY_LEN_256,
+                                  BIP32_VER_MAIN_PRIVATE, 0, &master));
+    check_ret(bip32_key_serialize(&master, BIP32_FLAG_KEY_PUBLIC,
+                                  b.bytes, BIP32_SERIALIZED_LEN));
+    check_ret(wally_base58_from_bytes(b.bytes, BIP32_SERIALIZED_LEN,
+                                      BASE58_FLAG_CHECKSUM, &b.str));
+    run_bench("base58_from_bytes_xpub", bench_base58_from_bytes, &b, 20000);
+    run_bench("base58_to_bytes_xpub", bench_base58_to_bytes, &b, 20000);
+    check_ret(wally_free_string(b.str));
+
+    b.bytes[0] = OP_0;
+    b.bytes[1] = HASH160_LEN;
+    check_ret(wally_addr_segwit_from_bytes(b.bytes, WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                           "bc", 0, &b.str));
+    run_bench("bech32_from_bytes_p2wpkh", bench_segwit_from_bytes, &b, 50000);
+    run_bench("bech32_to_bytes_p2wpkh", bench_segwit_to_bytes, &b, 50000);
+    check_ret(wally_free_string(b.str));
+
+    check_ret(wally_hex_from_bytes(b.bytes, sizeof(b.bytes), &b.str));
+    run_bench("hex_from_bytes_1k", bench_hex_from_bytes, &b, 20000);
+    run_bench("hex_to_bytes_1k", bench_hex_to_bytes, &b, 20000);
+    check_ret(wally_free_string(b.str));
+
+    check_ret(wally_base64_from_bytes(b.bytes, sizeof(b.bytes), 0, &b.str));
+    run_bench("base64_from_bytes_1k", bench_base64_from_bytes, &b, 20000);
+    run_bench("base64_to_bytes_1k", bench_base64_to_bytes, &b, 20000);
+    check_ret(wally_free_string(b.str));
+
+    check_ret(wally_wif_from_bytes(b.bytes, EC_PRIVATE_KEY_LEN, 0x80,
+                                   WALLY_WIF_FLAG_COMPRESSED, &b.str));
+    run_bench("wif_decode", bench_wif_decode, &b, 20000);
+    run_bench("wif_decode_separate", bench_wif_decode_separate, &b, 20000);
+    check_ret(wally_free_string(b.str));
+}
+
+/*
+ * Crypto
+ */
+struct crypto_bench {
+    unsigned char key[AES_KEY_LEN_256];
+    unsigned char iv[AES_BLOCK_LEN];
+    unsigned char bytes[1024];
+    unsigned char out[1024 + AES_BLOCK_LEN];
+};
+
+static void bench_scrypt(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_scrypt(b->key, sizeof(b->key), b->iv, sizeof(b->iv),
+                               16384, 8, 1, b->out, 64));
+}
+
+static void bench_aes_block(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_aes(b->key, sizeof(b->key), b->bytes, AES_BLOCK_LEN,
+                            AES_FLAG_ENCRYPT, b->out, AES_BLOCK_LEN));
+}
+
+static void bench_aes_cbc(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_aes_cbc(b->key, sizeof(b->key), b->iv, sizeof(b->iv),
+                                b->bytes, sizeof(b->bytes), AES_FLAG_ENCRYPT,
+                                b->out, sizeof(b->out), &written));
+}
+
+static void bench_sig_recoverable(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_from_bytes(b->key, EC_PRIVATE_KEY_LEN,
+                                          b->bytes, EC_MESSAGE_HASH_LEN,
+                                          EC_FLAG_ECDSA | EC_FLAG_RECOVERABLE,
+                                          b->out, EC_SIGNATURE_RECOVERABLE_LEN));
+}
+
+static void bench_sig(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char sig[EC_SIGNATURE_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_from_bytes(b->key, EC_PRIVATE_KEY_LEN,
+                                          b->bytes, EC_MESSAGE_HASH_LEN,
+                                          EC_FLAG_ECDSA, sig, sizeof(sig)));
+}
+
+static void bench_sig_signing_key(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    struct wally_operations ops, orig_ops;
+    struct wally_ec_signing_key *key;
+
+    check_ret(wally_ec_signing_key_init_alloc(b->key, EC_PRIVATE_KEY_LEN, &key));
+    check_ret(wally_get_operations(&orig_ops));
+    ops = orig_ops;
+    ops.ec_nonce_ctx = key;
+    ops.ec_nonce_ctx_fn = wally_ec_signing_key_nonce;
+    check_ret(wally_set_operations(&ops));
+    bench_sig(ctx, iterations);
+    check_ret(wally_set_operations(&orig_ops));
+    check_ret(wally_ec_signing_key_free(key));
+}
+
+/* Verification uses the ecmult table sized by --enable-minimal-memory */
+static void bench_sig_verify(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN], sig[EC_SIGNATURE_LEN];
+    size_t i;
+
+    check_ret(wally_ec_public_key_from_private_key(b->key, EC_PRIVATE_KEY_LEN,
+                                                   pub_key, sizeof(pub_key)));
+    check_ret(wally_ec_sig_from_bytes(b->key, EC_PRIVATE_KEY_LEN,
+                                      b->bytes, EC_MESSAGE_HASH_LEN,
+                                      EC_FLAG_ECDSA, sig, sizeof(sig)));
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_verify(pub_key, sizeof(pub_key),
+                                      b->bytes, EC_MESSAGE_HASH_LEN,
+                                      EC_FLAG_ECDSA, sig, sizeof(sig)));
+}
+
+static void bench_sig_to_public_key(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_to_public_key(b->bytes, EC_MESSAGE_HASH_LEN,
+                                             b->out, EC_SIGNATURE_RECOVERABLE_LEN,
+                                             pub_key, sizeof(pub_key)));
+}
+
+#define NUM_RECOVER_SIGS 16
+
+/* Recover the signers of a batch of signed messages as hash160s */
+static void bench_sig_to_public_key_batch(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char hashes[NUM_RECOVER_SIGS * EC_MESSAGE_HASH_LEN];
+    unsigned char sigs[NUM_RECOVER_SIGS * EC_SIGNATURE_RECOVERABLE_LEN];
+    unsigned char results[NUM_RECOVER_SIGS], h160s[NUM_RECOVER_SIGS * HASH160_LEN];
+    size_t i;
+
+    for (i = 0; i < NUM_RECOVER_SIGS; ++i) {
+        memcpy(hashes + i * EC_MESSAGE_HASH_LEN, b->bytes, EC_MESSAGE_HASH_LEN);
+        memcpy(sigs + i * EC_SIGNATURE_RECOVERABLE_LEN, b->out, EC_SIGNATURE_RECOVERABLE_LEN);
+    }
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_to_public_key_batch(hashes, sizeof(hashes), sigs, sizeof(sigs),
+                                                   EC_PUBLIC_KEY_FLAG_HASH160, NULL, NULL,
+                                                   results, sizeof(results),
+                                                   h160s, sizeof(h160s)));
+}
+
+#define NUM_BATCH_SIGS 64
+#define NUM_POOL_THREADS 4
+
+static void bench_sig_batch_impl(void *ctx, size_t iterations, size_t num_threads)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char priv_keys[NUM_BATCH_SIGS * EC_PRIVATE_KEY_LEN];
+    unsigned char hashes[NUM_BATCH_SIGS * EC_MESSAGE_HASH_LEN];
+    unsigned char sigs[NUM_BATCH_SIGS * EC_SIGNATURE_LEN];
+    struct wally_thread_pool *pool = NULL;
+    size_t i, written;
+
+    for (i = 0; i < NUM_BATCH_SIGS; ++i) {
+        memcpy(priv_keys + i * EC_PRIVATE_KEY_LEN, b->key, EC_PRIVATE_KEY_LEN);
+        memcpy(hashes + i * EC_MESSAGE_HASH_LEN, b->bytes, EC_MESSAGE_HASH_LEN);
+    }
+    if (num_threads)
+        check_ret(wally_thread_pool_init_alloc(num_threads, &pool));
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_from_bytes_batch_parallel(priv_keys, sizeof(priv_keys),
+                                                         hashes, sizeof(hashes), EC_FLAG_ECDSA,
+                                                         pool ? wally_thread_pool_run : NULL,
+                                                         pool, sigs, sizeof(sigs), &written));
+    if (pool)
+        check_ret(wally_thread_pool_free(pool));
+}
+
+static void bench_sig_batch(void *ctx, size_t iterations)
+{
+    bench_sig_batch_impl(ctx, iterations, 0);
+}
+
+/* As above, on a pool of NUM_POOL_THREADS workers plus the calling thread */
+static void bench_sig_batch_pool(void *ctx, size_t iterations)
+{
+    bench_sig_batch_impl(ctx, iterations, NUM_POOL_THREADS);
+}
+
+static void bench_ecdh(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN], secret[SHA256_LEN];
+    size_t i;
+
+    check_ret(wally_ec_public_key_from_private_key(b->bytes, EC_PRIVATE_KEY_LEN,
+                                                   pub_key, sizeof(pub_key)));
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ecdh(pub_key, sizeof(pub_key), b->key, EC_PRIVATE_KEY_LEN,
+                             secret, sizeof(secret)));
+}
+
+#define NUM_ECDH_SECRETS 16
+
+static void bench_ecdh_batch(void *ctx, size_t iterations)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char priv_keys[NUM_ECDH_SECRETS * EC_PRIVATE_KEY_LEN];
+    unsigned char pub_keys[NUM_ECDH_SECRETS * EC_PUBLIC_KEY_LEN];
+    unsigned char results[NUM_ECDH_SECRETS], secrets[NUM_ECDH_SECRETS * SHA256_LEN];
+    size_t i;
+
+    for (i = 0; i < NUM_ECDH_SECRETS; ++i) {
+        fill(priv_keys + i * EC_PRIVATE_KEY_LEN, EC_PRIVATE_KEY_LEN, i + 1);
+        check_ret(wally_ec_public_key_from_private_key(priv_keys + i * EC_PRIVATE_KEY_LEN,
+                                                       EC_PRIVATE_KEY_LEN,
+                                                       pub_keys + i * EC_PUBLIC_KEY_LEN,
+                                                       EC_PUBLIC_KEY_LEN));
+    }
+    /* Scan with a single private key, as for confidential outputs */
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ecdh_batch(pub_keys, sizeof(pub_keys), b->key, EC_PRIVATE_KEY_LEN,
+                                   NULL, NULL, results, sizeof(results),
+                                   secrets, sizeof(secrets)));
+}
+
+#define NUM_CONVERT_KEYS 64
+
+/* Decompress and hash keys one at a time, or as a single batch */
+static void bench_public_keys_convert_impl(void *ctx, size_t iterations, bool batch)
+{
+    unsigned char priv_keys[NUM_CONVERT_KEYS * EC_PRIVATE_KEY_LEN];
+    unsigned char pub_keys[NUM_CONVERT_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char full[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    unsigned char h160s[NUM_CONVERT_KEYS * HASH160_LEN];
+    size_t i, j;
+
+    (void)ctx;
+    for (i = 0; i < NUM_CONVERT_KEYS; ++i)
+        fill(priv_keys + i * EC_PRIVATE_KEY_LEN, EC_PRIVATE_KEY_LEN, i + 1);
+    check_ret(wally_ec_public_keys_from_private_keys(priv_keys, sizeof(priv_keys), 0,
+                                                     pub_keys, sizeof(pub_keys)));
+    for (i = 0; i < iterations; ++i) {
+        if (batch) {
+            check_ret(wally_ec_public_keys_convert(pub_keys, sizeof(pub_keys),
+                                                   EC_PUBLIC_KEY_FLAG_UNCOMPRESSED |
+                                                   EC_PUBLIC_KEY_FLAG_HASH160,
+                                                   h160s, sizeof(h160s)));
+            continue;
+        }
+        for (j = 0; j < NUM_CONVERT_KEYS; ++j) {
+            check_ret(wally_ec_public_key_decompress(pub_keys + j * EC_PUBLIC_KEY_LEN,
+                                                     EC_PUBLIC_KEY_LEN, full, sizeof(full)));
+            check_ret(wally_hash160(full, sizeof(full),
+                                    h160s + j * HASH160_LEN, HASH160_LEN));
+        }
+    }
+}
+
+static void bench_public_keys_convert(void *ctx, size_t iterations)
+{
+    bench_public_keys_convert_impl(ctx, iterations, true);
+}
+
+static void bench_public_keys_convert_separate(void *ctx, size_t iterations)
+{
+    bench_public_keys_convert_impl(ctx, iterations, false);
+}
+
+#define NUM_TWEAK_KEYS 64
+
+/* Tweak a base public key to P2WPKH hashes one at a time, or as a single batch */
+static void bench_public_keys_tweak_add_impl(void *ctx, size_t iterations, bool batch)
+{
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char tweaks[NUM_TWEAK_KEYS * EC_PRIVATE_KEY_LEN];
+    unsigned char tweaked[EC_PUBLIC_KEY_LEN];
+    unsigned char h160s[NUM_TWEAK_KEYS * HASH160_LEN];
+    size_t i, j;
+
+    (void)ctx;
+    fill(priv_key, sizeof(priv_key), 5);
+    check_ret(wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                                   pub_key, sizeof(pub_key)));
+    for (i = 0; i < NUM_TWEAK_KEYS; ++i)
+        fill(tweaks + i * EC_PRIVATE_KEY_LEN, EC_PRIVATE_KEY_LEN, i + 1);
+    for (i = 0; i < iterations; ++i) {
+        if (batch) {
+            check_ret(wally_ec_public_keys_tweak_add(pub_key, sizeof(pub_key),
+                                                     tweaks, sizeof(tweaks),
+                                                     EC_PUBLIC_KEY_FLAG_HASH160,
+                                                     h160s, sizeof(h160s)));
+            continue;
+        }
+        for (j = 0; j < NUM_TWEAK_KEYS; ++j) {
+            check_ret(wally_ec_public_key_tweak_add(pub_key, sizeof(pub_key),
+                                                    tweaks + j * EC_PRIVATE_KEY_LEN,
+                                                    EC_PRIVATE_KEY_LEN,
+                                                    tweaked, sizeof(tweaked)));
+            check_ret(wally_hash160(tweaked, sizeof(tweaked),
+                                    h160s + j * HASH160_LEN, HASH160_LEN));
+        }
+    }
+}
+
+static void bench_public_keys_tweak_add(void *ctx, size_t iterations)
+{
+    bench_public_keys_tweak_add_impl(ctx, iterations, true);
+}
+
+static void bench_public_keys_tweak_add_separate(void *ctx, size_t iterations)
+{
+    bench_public_keys_tweak_add_impl(ctx, iterations, false);
+}
+
+#define NUM_HASH160_KEYS 64
+
+/* Hash160 compressed public keys one at a time, or as a single batch */
+static void bench_hash160_impl(void *ctx, size_t iterations, bool batch)
+{
+    unsigned char pub_keys[NUM_HASH160_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char h160s[NUM_HASH160_KEYS * HASH160_LEN];
+    size_t i, j;
+
+    (void)ctx;
+    fill(pub_keys, sizeof(pub_keys), 4);
+    for (i = 0; i < iterations; ++i) {
+        if (batch) {
+            check_ret(wally_hash160_batch(pub_keys, sizeof(pub_keys), EC_PUBLIC_KEY_LEN,
+                                          h160s, sizeof(h160s)));
+            continue;
+        }
+        for (j = 0; j < NUM_HASH160_KEYS; ++j)
+            check_ret(wally_hash160(pub_keys + j * EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN,
+                                    h160s + j * HASH160_LEN, HASH160_LEN));
+    }
+}
+
+static void bench_hash160_batch(void *ctx, size_t iterations)
+{
+    bench_hash160_impl(ctx, iterations, true);
+}
+
+static void bench_hash160_separate(void *ctx, size_t iterations)
+{
+    bench_hash160_impl(ctx, iterations, false);
+}
+
+#define NUM_DER_SIGS 64
+
+/* Normalize, DER encode and decode signatures one at a time, or as batches */
+static void bench_sigs_der_impl(void *ctx, size_t iterations, bool batch)
+{
+    struct crypto_bench *b = ctx;
+    unsigned char sigs[NUM_DER_SIGS * EC_SIGNATURE_LEN], results[NUM_DER_SIGS];
+    unsigned char ders[NUM_DER_SIGS * EC_SIGNATURE_DER_MAX_LEN];
+    size_t lens[NUM_DER_SIGS], i, j;
+
+    check_ret(wally_ec_sig_from_bytes(b->key, EC_PRIVATE_KEY_LEN,
+                                      b->bytes, EC_MESSAGE_HASH_LEN,
+                                      EC_FLAG_ECDSA, sigs, EC_SIGNATURE_LEN));
+    for (i = 1; i < NUM_DER_SIGS; ++i)
+        memcpy(sigs + i * EC_SIGNATURE_LEN, sigs, EC_SIGNATURE_LEN);
+    for (i = 0; i < iterations; ++i) {
+        if (batch) {
+            check_ret(wally_ec_sig_normalize_batch(sigs, sizeof(sigs), results,
+                                                   sizeof(results), sigs, sizeof(sigs)));
+            check_ret(wally_ec_sig_to_der_batch(sigs, sizeof(sigs), lens, NUM_DER_SIGS,
+                                                ders, sizeof(ders)));
+            check_ret(wally_ec_sig_from_der_batch(ders, sizeof(ders), lens, NUM_DER_SIGS,
+                                                  results, sizeof(results),
+                                                  sigs, sizeof(sigs)));
+            continue;
+        }
+        for (j = 0; j < NUM_DER_SIGS; ++j) {
+            unsigned char *sig = sigs + j * EC_SIGNATURE_LEN;
+            unsigned char *der = ders + j * EC_SIGNATURE_DER_MAX_LEN;
+
+            check_ret(wally_ec_sig_normalize(sig, EC_SIGNATURE_LEN, sig, EC_SIGNATURE_LEN));
+            check_ret(wally_ec_sig_to_der(sig, EC_SIGNATURE_LEN,
+                                          der, EC_SIGNATURE_DER_MAX_LEN, lens + j));
+            check_ret(wally_ec_sig_from_der(der, lens[j], sig, EC_SIGNATURE_LEN));
+        }
+    }
+}
+
+static void bench_sigs_der(void *ctx, size_t iterations)
+{
+    bench_sigs_der_impl(ctx, iterations, true);
+}
+
+static void bench_sigs_der_separate(void *ctx, size_t iterations)
+{
+    bench_sigs_der_impl(ctx, iterations, false);
+}
+
+static void bench_crypto(void)
+{
+    struct crypto_bench b;
+
+    fill(b.key, sizeof(b.key), 1);
+    fill(b.iv, sizeof(b.iv), 2);
+    fill(b.bytes, sizeof(b.bytes), 3);
+    run_bench("scrypt_16384_8_1", bench_scrypt, &b, 3);
+    /* The same, with the working memory taken from a secret arena */
+    check_ret(wally_secret_arena_init(32 * 1024 * 1024, WALLY_SECRET_ARENA_GUARD));
+    run_bench("scrypt_16384_8_1_arena", bench_scrypt, &b, 3);
+    check_ret(wally_secret_arena_free(0));
+    run_bench("aes256_block", bench_aes_block, &b, 200000);
+    run_bench("aes256_cbc_1k", bench_aes_cbc, &b, 20000);
+    run_bench("ec_sig_from_bytes", bench_sig, &b, 20000);
+    run_bench("ec_sig_from_bytes_signing_key", bench_sig_signing_key, &b, 20000);
+    run_bench("ec_sig_from_bytes_recoverable", bench_sig_recoverable, &b, 20000);
+    run_bench("ec_sig_verify", bench_sig_verify, &b, 20000);
+    run_bench("ec_sig_from_bytes_batch_64", bench_sig_batch, &b, 300);
+    run_bench("ec_sig_from_bytes_batch_64_pool", bench_sig_batch_pool, &b, 300);
+    run_bench("ec_sig_to_public_key", bench_sig_to_public_key, &b, 20000);
+    run_bench("ec_sig_to_public_key_batch_16", bench_sig_to_public_key_batch, &b, 1000);
+    run_bench("hash160_batch_64", bench_hash160_batch, &b, 20000);
+    run_bench("hash160_batch_64_separate", bench_hash160_separate, &b, 20000);
+    run_bench("ec_sigs_normalize_der_64", bench_sigs_der, &b, 2000);
+    run_bench("ec_sigs_normalize_der_64_separate", bench_sigs_der_separate, &b, 2000);
+    run_bench("ec_public_keys_convert_64", bench_public_keys_convert, &b, 1000);
+    run_bench("ec_public_keys_convert_64_separate", bench_public_keys_convert_separate, &b, 1000);
+    run_bench("ec_public_keys_tweak_add_64", bench_public_keys_tweak_add, &b, 200);
+    run_bench("ec_public_keys_tweak_add_64_separate", bench_public_keys_tweak_add_separate, &b, 200);
+    run_bench("ecdh", bench_ecdh, &b, 20000);
+    run_bench("ecdh_batch_16", bench_ecdh_batch, &b, 1000);
+}
+
+/*
+ * Binding overhead: the same small operations are timed through each
+ * language wrapper by test/bench_bindings.py, wrap_js/test/bench_bindings.js
+ * and swig_java's bench_bindings, under the same names
+ */
+#define BINDING_BATCH_LEN 16
+
+struct binding_bench {
+    unsigned char bytes[32]; /* Hashed, hex encoded and signed */
+    unsigned char priv_keys[BINDING_BATCH_LEN * EC_PRIVATE_KEY_LEN];
+    unsigned char hashes[BINDING_BATCH_LEN * EC_MESSAGE_HASH_LEN];
+    unsigned char sigs[BINDING_BATCH_LEN * EC_SIGNATURE_LEN];
+    struct ext_key master;
+    struct ext_key keys[BINDING_BATCH_LEN];
+};
+
+static void bench_binding_sha256(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_sha256(b->bytes, sizeof(b->bytes), b->sigs, SHA256_LEN));
+}
+
+static void bench_binding_hex(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        char *str;
+        check_ret(wally_hex_from_bytes(b->bytes, sizeof(b->bytes), &str));
+        check_ret(wally_free_string(str));
+    }
+}
+
+static void bench_binding_sig(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_from_bytes(b->priv_keys, EC_PRIVATE_KEY_LEN,
+                                          b->bytes, sizeof(b->bytes), EC_FLAG_ECDSA,
+                                          b->sigs, EC_SIGNATURE_LEN));
+}
+
+static void bench_binding_sig_batch(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_ec_sig_from_bytes_batch(b->priv_keys, sizeof(b->priv_keys),
+                                                b->hashes, sizeof(b->hashes),
+                                                EC_FLAG_ECDSA, b->sigs, sizeof(b->sigs),
+                                                &written));
+}
+
+static void bench_binding_derive(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent(&b->master, 1, BIP32_FLAG_KEY_PUBLIC, b->keys));
+}
+
+static void bench_binding_derive_range(void *ctx, size_t iterations)
+{
+    struct binding_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(bip32_key_from_parent_range(&b->master, 1, BIP32_FLAG_KEY_PUBLIC,
+                                              b->keys, BINDING_BATCH_LEN));
+}
+
+static void bench_bindings(void)
+{
+    struct binding_bench b;
+    unsigned char seed[BIP32_ENTROPY_LEN_256];
+    size_t i;
+
+    /* Each binding benchmark uses these same inputs */
+    memset(b.bytes, 0x02, sizeof(b.bytes));
+    memset(b.priv_keys, 0x01, sizeof(b.priv_keys));
+    for (i = 0; i < BINDING_BATCH_LEN; ++i)
+        memcpy(b.hashes + i * EC_MESSAGE_HASH_LEN, b.bytes, EC_MESSAGE_HASH_LEN);
+    memset(seed, 0x03, sizeof(seed));
+    check_ret(bip32_key_from_seed(seed, sizeof(seed), BIP32_VER_MAIN_PRIVATE, 0, &b.master));
+
+    run_bench("binding_sha256_32", bench_binding_sha256, &b, 200000);
+    run_bench("binding_hex_from_bytes_32", bench_binding_hex, &b, 200000);
+    run_bench("binding_ec_sig_from_bytes", bench_binding_sig, &b, 20000);
+    run_bench("binding_ec_sig_from_bytes_batch_16", bench_binding_sig_batch, &b, 1000);
+    run_bench("binding_bip32_derive_pub", bench_binding_derive, &b, 20000);
+    run_bench("binding_bip32_derive_pub_range_16", bench_binding_derive_range, &b, 1000);
+}
+
+/*
+ * Worst case parser inputs: pathological input is timed both with no
+ * input limits and with limits set by wally_set_input_limit ("_limited")
+ */
+#define WORST_WITNESS_ITEMS 100000
+#define WORST_BASE58_LEN 4096
+#define WORST_STR_LEN 65536
+
+struct worst_bench {
+    unsigned char *tx; /* A tx with one huge witness stack of empty items */
+    size_t tx_len;
+    unsigned char varint_tx[32]; /* A tx claiming 2^64 - 1 inputs */
+    char base58[WORST_BASE58_LEN + 1];
+    char mnemonic[WORST_STR_LEN + 1]; /* Repeated words */
+    char addr[WORST_STR_LEN + 1]; /* An over-long bech32 address */
+    unsigned char out[WORST_BASE58_LEN];
+};
+
+static void bench_worst_tx_witness_items(void *ctx, size_t iterations)
+{
+    struct worst_bench *b = ctx;
+    struct wally_tx *tx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        if (wally_tx_from_bytes(b->tx, b->tx_len, 0, &tx) == WALLY_OK)
+            check_ret(wally_tx_free(tx));
+}
+
+static void bench_worst_tx_varint(void *ctx, size_t iterations)
+{
+    struct worst_bench *b = ctx;
+    struct wally_tx *tx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        if (wally_tx_from_bytes(b->varint_tx, sizeof(b->varint_tx), 0, &tx) == WALLY_OK)
+            exit(1); /* Must be rejected */
+}
+
+static void bench_worst_base58(void *ctx, size_t iterations)
+{
+    struct worst_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        wally_base58_to_bytes(b->base58, 0, b->out, sizeof(b->out), &written);
+}
+
+static void bench_worst_mnemonic(void *ctx, size_t iterations)
+{
+    struct worst_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        if (bip39_mnemonic_to_bytes(NULL, b->mnemonic, b->out, BIP39_ENTROPY_LEN_256,
+                                    &written) == WALLY_OK && written <= BIP39_ENTROPY_LEN_256)
+            exit(1); /* Must be rejected */
+}
+
+static void bench_worst_segwit(void *ctx, size_t iterations)
+{
+    struct worst_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        if (wally_addr_segwit_to_bytes(b->addr, "bc", 0, b->out, sizeof(b->out),
+                                       &written) == WALLY_OK)
+            exit(1); /* Must be rejected */
+}
+
+static void run_worst_bench(const char *name, bench_fn_t fn, void *ctx,
+                            size_t iterations, uint32_t limit, size_t limit_value)
+{
+    char limited_name[64];
+
+    run_bench(name, fn, ctx, iterations);
+    snprintf(limited_name, sizeof(limited_name), "%s_limited", name);
+    check_ret(wally_set_input_limit(limit, limit_value));
+    run_bench(limited_name, fn, ctx, iterations * 100);
+    check_ret(wally_set_input_limit(limit, 0));
+}
+
+static void bench_worst_case(void)
+{
+    static const unsigned char tx_head[] = {
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01 /* version, segwit flag, 1 input */
+    };
+    struct worst_bench b;
+    unsigned char *p;
+    size_t i;
+
+    memset(&b, 0, sizeof(b));
+    b.tx_len = sizeof(tx_head) + WALLY_TXHASH_LEN + 4 + 1 + 4 + /* input */
+               1 + 8 + 1 + /* 1 output */
+               5 + WORST_WITNESS_ITEMS + 4; /* witness, locktime */
+    if (!(b.tx = calloc(1, b.tx_len)))
+        exit(1);
+    memcpy(b.tx, tx_head, sizeof(tx_head));
+    p = b.tx + sizeof(tx_head) + WALLY_TXHASH_LEN + 4 + 1 + 4;
+    *p++ = 1; /* 1 output, zero value and empty script */
+    p += 8 + 1;
+    *p++ = 0xfe; /* witness item count, followed by empty items */
+    p[0] = WORST_WITNESS_ITEMS & 0xff;
+    p[1] = (WORST_WITNESS_ITEMS >> 8) & 0xff;
+    p[2] = (WORST_WITNESS_ITEMS >> 16) & 0xff;
+
+    memcpy(b.varint_tx, tx_head, 4);
+    memset(b.varint_tx + 4, 0xff, 9);
+
+    memset(b.base58, 'z', WORST_BASE58_LEN);
+    for (i = 0; i + 8 <= WORST_STR_LEN; i += 8)
+        memcpy(b.mnemonic + i, "abandon ", 8);
+    b.mnemonic[i - 1] = '\0';
+    memcpy(b.addr, "bc1q", 4);
+    memset(b.addr + 4, 'q', WORST_STR_LEN - 4);
+
+    /* Limits suitable for a caller expecting standard sized input */
+    run_worst_bench("worst_tx_witness_100k", bench_worst_tx_witness_items, &b, 100,
+                    WALLY_LIMIT_TX_WITNESS_ITEMS, 1000);
+    run_worst_bench("worst_tx_len_100k", bench_worst_tx_witness_items, &b, 100,
+                    WALLY_LIMIT_TX_LEN, 100000);
+    run_bench("worst_tx_varint_count", bench_worst_tx_varint, &b, 200000);
+    run_worst_bench("worst_base58_4k", bench_worst_base58, &b, 20,
+                    WALLY_LIMIT_BASE58_LEN, 128);
+    run_worst_bench("worst_mnemonic_64k", bench_worst_mnemonic, &b, 100,
+                    WALLY_LIMIT_MNEMONIC_LEN, 1024);
+    /* Segwit addresses have a fixed maximum length, so need no limit */
+    run_bench("worst_segwit_addr_64k", bench_worst_segwit, &b, 200000);
+    free(b.tx);
+}
+
+#ifdef BUILD_ELEMENTS
+/*
+ * Elements blinding
+ */
+#define NUM_ASSETS 3
+
+struct elements_bench {
+    unsigned char assets[NUM_ASSETS * ASSET_TAG_LEN];
+    unsigned char abfs[NUM_ASSETS * ASSET_TAG_LEN];
+    unsigned char generators[NUM_ASSETS * ASSET_GENERATOR_LEN];
+    unsigned char same_generators[NUM_ASSETS * ASSET_GENERATOR_LEN];
+    unsigned char vbfs[NUM_ASSETS * ASSET_TAG_LEN];
+    unsigned char commitments[NUM_ASSETS * ASSET_COMMITMENT_LEN];
+    unsigned char output_abf[ASSET_TAG_LEN];
+    unsigned char output_generator[ASSET_GENERATOR_LEN];
+    unsigned char vbf[ASSET_TAG_LEN];
+    unsigned char entropy[ASSET_TAG_LEN];
+    unsigned char commitment[ASSET_COMMITMENT_LEN];
+    unsigned char sender_priv_key[EC_PRIVATE_KEY_LEN];
+    unsigned char sender_pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char receiver_priv_key[EC_PRIVATE_KEY_LEN];
+    unsigned char receiver_pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char rangeproof[ASSET_RANGEPROOF_MAX_LEN];
+    size_t rangeproof_len;
+    unsigned char surjectionproof[256];
+    size_t surjectionproof_len;
+    struct wally_asset_generator *parsed_generator;
+    struct wally_asset_surjectionproof_inputs *surjectionproof_inputs;
+};
+
+static void bench_asset_generator(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    unsigned char generator[ASSET_GENERATOR_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_generator_from_bytes(b->assets, ASSET_TAG_LEN,
+                                                   b->abfs, ASSET_TAG_LEN,
+                                                   generator, sizeof(generator)));
+}
+
+static void bench_asset_value_commitment(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_value_commitment(50000, b->vbf, sizeof(b->vbf),
+                                               b->generators, ASSET_GENERATOR_LEN,
+                                               b->commitment, sizeof(b->commitment)));
+}
+
+static void bench_asset_value_commitment_parsed(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_value_commitment_parsed(50000, b->vbf, sizeof(b->vbf),
+                                                      b->parsed_generator,
+                                                      b->commitment, sizeof(b->commitment)));
+}
+
+static void bench_asset_value_commitment_batch(void *ctx, size_t iterations)
+{
+    static const uint64_t values[NUM_ASSETS] = { 50000, 60000, 70000 };
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_value_commitment_batch(values, NUM_ASSETS,
+                                                     b->vbfs, sizeof(b->vbfs),
+                                                     b->same_generators,
+                                                     sizeof(b->same_generators),
+                                                     b->commitments, sizeof(b->commitments)));
+}
+
+static void bench_asset_value_commitment_batch_single(void *ctx, size_t iterations)
+{
+    static const uint64_t values[NUM_ASSETS] = { 50000, 60000, 70000 };
+    struct elements_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < NUM_ASSETS; ++j)
+            check_ret(wally_asset_value_commitment(values[j], b->vbfs + j * ASSET_TAG_LEN,
+                                                   ASSET_TAG_LEN,
+                                                   b->same_generators + j * ASSET_GENERATOR_LEN,
+                                                   ASSET_GENERATOR_LEN,
+                                                   b->commitments + j * ASSET_COMMITMENT_LEN,
+                                                   ASSET_COMMITMENT_LEN));
+}
+
+static void bench_asset_rangeproof(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_rangeproof(50000, b->receiver_pub_key, EC_PUBLIC_KEY_LEN,
+                                         b->sender_priv_key, EC_PRIVATE_KEY_LEN,
+                                         b->assets, ASSET_TAG_LEN,
+                                         b->abfs, ASSET_TAG_LEN,
+                                         b->vbf, sizeof(b->vbf),
+                                         b->commitment, sizeof(b->commitment),
+                                         NULL, 0, b->generators, ASSET_GENERATOR_LEN,
+                                         1, b->rangeproof, sizeof(b->rangeproof),
+                                         &b->rangeproof_len));
+}
+
+static void bench_asset_rangeproof_verify(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_rangeproof_verify(b->rangeproof, b->rangeproof_len,
+                                                b->commitment, sizeof(b->commitment),
+                                                NULL, 0, b->generators, ASSET_GENERATOR_LEN));
+}
+
+static void bench_asset_surjectionproof(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i, written;
+
+    /* Prove the reblinded first asset is one of the NUM_ASSETS inputs */
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_surjectionproof(b->assets, ASSET_TAG_LEN,
+                                              b->output_abf, sizeof(b->output_abf),
+                                              b->output_generator,
+                                              sizeof(b->output_generator),
+                                              b->entropy, sizeof(b->entropy),
+                                              b->assets, sizeof(b->assets),
+                                              b->abfs, sizeof(b->abfs),
+                                              b->generators, sizeof(b->generators),
+                                              b->surjectionproof, b->surjectionproof_len,
+                                              &written));
+}
+
+static void bench_asset_surjectionproof_parsed(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_surjectionproof_parsed(b->surjectionproof_inputs,
+                                                     b->assets, ASSET_TAG_LEN,
+                                                     b->output_abf, sizeof(b->output_abf),
+                                                     b->output_generator,
+                                                     sizeof(b->output_generator),
+                                                     b->entropy, sizeof(b->entropy),
+                                                     ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS,
+                                                     b->surjectionproof,
+                                                     b->surjectionproof_len, &written));
+}
+
+static void bench_asset_surjectionproof_verify(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_surjectionproof_verify(b->surjectionproof, b->surjectionproof_len,
+                                                     b->output_generator,
+                                                     sizeof(b->output_generator),
+                                                     b->generators, sizeof(b->generators)));
+}
+
+static void bench_asset_unblind(void *ctx, size_t iterations)
+{
+    struct elements_bench *b = ctx;
+    unsigned char asset[ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    uint64_t value;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_unblind(b->sender_pub_key, EC_PUBLIC_KEY_LEN,
+                                      b->receiver_priv_key, EC_PRIVATE_KEY_LEN,
+                                      b->rangeproof, b->rangeproof_len,
+                                      b->commitment, sizeof(b->commitment),
+                                      NULL, 0, b->generators, ASSET_GENERATOR_LEN,
+                                      asset, sizeof(asset), abf, sizeof(abf),
+                                      vbf, sizeof(vbf), &value));
+}
+
+#define NUM_BLIND_OUTPUTS 20
+
+struct blind_bench {
+    struct wally_tx *tx;
+    uint32_t indices[NUM_BLIND_OUTPUTS];
+    uint64_t values[NUM_BLIND_OUTPUTS + 1];
+    unsigned char assets[(NUM_BLIND_OUTPUTS + 1) * ASSET_TAG_LEN];
+    unsigned char abfs[(NUM_BLIND_OUTPUTS + 1) * ASSET_TAG_LEN];
+    unsigned char vbfs[NUM_BLIND_OUTPUTS * ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN];
+    unsigned char pub_keys[NUM_BLIND_OUTPUTS * EC_PUBLIC_KEY_LEN];
+    unsigned char priv_keys[NUM_BLIND_OUTPUTS * EC_PRIVATE_KEY_LEN];
+    unsigned char entropy[NUM_BLIND_OUTPUTS * 32];
+    unsigned char final_vbf[ASSET_TAG_LEN];
+};
+
+static void bench_tx_blind(void *ctx, size_t iterations)
+{
+    struct blind_bench *b = ctx;
+    size_t i;
+
+    /* Blinding replaces the outputs' commitments and proofs, so can repeat */
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_blind(b->tx, b->indices, NUM_BLIND_OUTPUTS,
+                                 b->values, NUM_BLIND_OUTPUTS + 1, 1,
+                                 b->assets, sizeof(b->assets), b->abfs, sizeof(b->abfs),
+                                 b->vbfs, sizeof(b->vbfs), b->generator, sizeof(b->generator),
+                                 b->pub_keys, sizeof(b->pub_keys),
+                                 b->priv_keys, sizeof(b->priv_keys),
+                                 b->entropy, sizeof(b->entropy), NULL, NULL,
+                                 b->final_vbf, sizeof(b->final_vbf)));
+}
+
+static void bench_tx_blinded_weight_estimate(void *ctx, size_t iterations)
+{
+    struct blind_bench *b = ctx;
+    size_t i, weight;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_get_blinded_weight_estimate(b->tx, b->indices, NUM_BLIND_OUTPUTS,
+                                                       b->values, NUM_BLIND_OUTPUTS + 1, 1,
+                                                       &weight));
+}
+
+/* Blind a transaction paying one confidential input to 20 outputs */
+static void bench_blind(void)
+{
+    unsigned char txhash[WALLY_TXHASH_LEN], asset[WALLY_TX_ASSET_CT_ASSET_LEN];
+    unsigned char value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN], script[22];
+    struct blind_bench b;
+    size_t i;
+
+    fill(b.assets, ASSET_TAG_LEN, 1);
+    fill(b.abfs, ASSET_TAG_LEN, 2);
+    fill(b.vbfs, ASSET_TAG_LEN, 3);
+    check_ret(wally_asset_generator_from_bytes(b.assets, ASSET_TAG_LEN, b.abfs, ASSET_TAG_LEN,
+                                               b.generator, sizeof(b.generator)));
+    b.values[0] = NUM_BLIND_OUTPUTS * 1000;
+    fill(txhash, sizeof(txhash), 4);
+    asset[0] = 1; /* Explicit (unblinded) asset */
+    memcpy(asset + 1, b.assets, ASSET_TAG_LEN);
+    check_ret(wally_tx_confidential_value_from_satoshi(1000, value, sizeof(value)));
+    check_ret(wally_tx_init_alloc(2, 0, 1, NUM_BLIND_OUTPUTS, &b.tx));
+    check_ret(wally_tx_add_elements_raw_input(b.tx, txhash, sizeof(txhash), 0, 0xfffffffd,
+                                              NULL, 0, NULL, NULL, 0, NULL, 0, NULL, 0,
+                                              NULL, 0, NULL, 0, NULL, 0, NULL, 0));
+
+    for (i = 0; i < NUM_BLIND_OUTPUTS; ++i) {
+        b.indices[i] = (uint32_t)i;
+        b.values[i + 1] = 1000;
+        memcpy(b.assets + (i + 1) * ASSET_TAG_LEN, b.assets, ASSET_TAG_LEN);
+        fill(b.abfs + (i + 1) * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 30));
+        if (i + 1 < NUM_BLIND_OUTPUTS)
+            fill(b.vbfs + (i + 1) * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 60));
+        fill(b.priv_keys + i * EC_PRIVATE_KEY_LEN, EC_PRIVATE_KEY_LEN, (unsigned char)(i + 90));
+        fill(b.entropy + i * 32, 32, (unsigned char)(i + 120));
+        /* Blind to the ephemeral key's own public key; any valid key will do */
+        check_ret(wally_ec_public_key_from_private_key(b.priv_keys + i * EC_PRIVATE_KEY_LEN,
+                                                       EC_PRIVATE_KEY_LEN,
+                                                       b.pub_keys + i * EC_PUBLIC_KEY_LEN,
+                                                       EC_PUBLIC_KEY_LEN));
+        fill(script, sizeof(script), (unsigned char)(i + 150));
+        script[0] = 0x00;
+        script[1] = 0x14;
+        check_ret(wally_tx_add_elements_raw_output(b.tx, script, sizeof(script),
+                                                   asset, sizeof(asset), value, sizeof(value),
+                                                   NULL, 0, NULL, 0, NULL, 0, 0));
+    }
+
+    run_bench("tx_blinded_weight_20_outputs", bench_tx_blinded_weight_estimate, &b, 100000);
+    run_bench("tx_blind_20_outputs", bench_tx_blind, &b, 10);
+    wally_tx_free(b.tx);
+}
+
+#define NUM_BALANCE_VALUES 20
+
+struct balance_bench {
+    uint64_t values[NUM_BALANCE_VALUES];
+    unsigned char abfs[NUM_BALANCE_VALUES * ASSET_TAG_LEN];
+    unsigned char vbfs[NUM_BALANCE_VALUES * ASSET_TAG_LEN];
+    struct wally_asset_blind_sum sum; /* All but the last two values */
+};
+
+/* Recompute the final vbf from every value, as each new output is tried */
+static void bench_final_vbf(void *ctx, size_t iterations)
+{
+    const struct balance_bench *b = ctx;
+    unsigned char vbf[ASSET_TAG_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_final_vbf(b->values, NUM_BALANCE_VALUES, 1,
+                                        b->abfs, sizeof(b->abfs),
+                                        b->vbfs, (NUM_BALANCE_VALUES - 1) * ASSET_TAG_LEN,
+                                        vbf, sizeof(vbf)));
+}
+
+/* Add the new output to a saved balance, then compute the final vbf */
+static void bench_blind_sum(void *ctx, size_t iterations)
+{
+    const struct balance_bench *b = ctx;
+    const size_t n = NUM_BALANCE_VALUES - 2;
+    struct wally_asset_blind_sum sum;
+    unsigned char vbf[ASSET_TAG_LEN];
+    size_t i;
+
+    for (i = 0; i < iterations; ++i) {
+        sum = b->sum;
+        check_ret(wally_asset_blind_sum_add_output(&sum, b->values[n],
+                                                   b->abfs + n * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                                   b->vbfs + n * ASSET_TAG_LEN, ASSET_TAG_LEN));
+        check_ret(wally_asset_blind_sum_final_vbf(&sum, b->values[n + 1],
+                                                  b->abfs + (n + 1) * ASSET_TAG_LEN,
+                                                  ASSET_TAG_LEN, vbf, sizeof(vbf)));
+    }
+}
+
+/* Balance one input against NUM_BALANCE_VALUES - 1 outputs */
+static void bench_balance(void)
+{
+    struct balance_bench b;
+    size_t i;
+
+    check_ret(wally_asset_blind_sum_init(&b.sum));
+    for (i = 0; i < NUM_BALANCE_VALUES; ++i) {
+        b.values[i] = i ? 1000 : (NUM_BALANCE_VALUES - 1) * 1000;
+        fill(b.abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 1));
+        fill(b.vbfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 30));
+        if (!i)
+            check_ret(wally_asset_blind_sum_add_input(&b.sum, b.values[i],
+                                                      b.abfs, ASSET_TAG_LEN,
+                                                      b.vbfs, ASSET_TAG_LEN));
+        else if (i < NUM_BALANCE_VALUES - 2)
+            check_ret(wally_asset_blind_sum_add_output(&b.sum, b.values[i],
+                                                       b.abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                                       b.vbfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN));
+    }
+
+    run_bench("asset_final_vbf_20_values", bench_final_vbf, &b, 20000);
+    run_bench("asset_blind_sum_20_values", bench_blind_sum, &b, 20000);
+}
+
+#define NUM_ISSUANCES 10
+
+static void bench_issuance_ids(void *ctx, size_t iterations)
+{
+    const struct wally_tx *tx = ctx;
+    unsigned char entropy[NUM_ISSUANCES * SHA256_LEN], asset[NUM_ISSUANCES * SHA256_LEN];
+    unsigned char token[NUM_ISSUANCES * SHA256_LEN];
+    uint32_t indices[NUM_ISSUANCES];
+    size_t i, written;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_tx_elements_issuance_calculate_ids(tx, indices, entropy, sizeof(entropy),
+                                                           asset, sizeof(asset),
+                                                           token, sizeof(token),
+                                                           NUM_ISSUANCES, &written));
+}
+
+static void bench_issuance_ids_single(void *ctx, size_t iterations)
+{
+    const struct wally_tx *tx = ctx;
+    unsigned char entropy[SHA256_LEN], asset[SHA256_LEN], token[SHA256_LEN];
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        for (j = 0; j < tx->num_inputs; ++j) {
+            const struct wally_tx_input *in = tx->inputs + j;
+            check_ret(wally_tx_elements_issuance_generate_entropy(in->txhash, sizeof(in->txhash),
+                                                                  in->index, in->entropy,
+                                                                  sizeof(in->entropy),
+                                                                  entropy, sizeof(entropy)));
+            check_ret(wally_tx_elements_issuance_calculate_asset(entropy, sizeof(entropy),
+                                                                 asset, sizeof(asset)));
+            check_ret(wally_tx_elements_issuance_calculate_reissuance_token(entropy,
+                                                                            sizeof(entropy), 0,
+                                                                            token, sizeof(token)));
+        }
+    }
+}
+
+/*
+ * SLIP-77 blinding keys
+ */
+#define NUM_BLINDING_SCRIPTS 256
+
+struct blinding_key_bench {
+    unsigned char node[HMAC_SHA512_LEN];
+    unsigned char scripts[NUM_BLINDING_SCRIPTS * WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    unsigned char priv_keys[NUM_BLINDING_SCRIPTS * EC_PRIVATE_KEY_LEN];
+};
+
+static void bench_blinding_keys(void *ctx, size_t iterations)
+{
+    struct blinding_key_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_blinding_key_to_ec_private_key_batch(b->node, sizeof(b->node),
+                                                                   b->scripts, sizeof(b->scripts),
+                                                                   WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                                                   b->priv_keys,
+                                                                   sizeof(b->priv_keys)));
+}
+
+static void bench_blinding_keys_single(void *ctx, size_t iterations)
+{
+    struct blinding_key_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < NUM_BLINDING_SCRIPTS; ++j)
+            check_ret(wally_hmac_sha256(b->node + HMAC_SHA256_LEN, HMAC_SHA256_LEN,
+                                        b->scripts + j * WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                        WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                        b->priv_keys + j * EC_PRIVATE_KEY_LEN,
+                                        EC_PRIVATE_KEY_LEN));
+}
+
+static void bench_blinding_key(void)
+{
+    struct blinding_key_bench b;
+    unsigned char seed[BIP32_ENTROPY_LEN_512];
+    size_t i;
+
+    fill(seed, sizeof(seed), 1);
+    check_ret(wally_asset_blinding_key_from_seed(seed, sizeof(seed), b.node, sizeof(b.node)));
+    for (i = 0; i < NUM_BLINDING_SCRIPTS; ++i)
+        fill(b.scripts + i * WALLY_SCRIPTPUBKEY_P2WPKH_LEN, WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+             (unsigned char)i);
+
+    run_bench("asset_blinding_keys_256", bench_blinding_keys, &b, 200);
+    run_bench("asset_blinding_keys_256_single", bench_blinding_keys_single, &b, 200);
+}
+
+/*
+ * PAK whitelist proofs
+ */
+#define NUM_PAK_BENCH_KEYS 15
+#define NUM_PAK_BENCH_PROOFS 16
+#define PAK_BENCH_PROOF_LEN (1 + 32 * (NUM_PAK_BENCH_KEYS + 1))
+
+struct pak_bench {
+    unsigned char online[NUM_PAK_BENCH_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char offline[NUM_PAK_BENCH_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char sub_pubkeys[NUM_PAK_BENCH_PROOFS * EC_PUBLIC_KEY_LEN];
+    unsigned char proofs[NUM_PAK_BENCH_PROOFS * PAK_BENCH_PROOF_LEN];
+    unsigned char results[NUM_PAK_BENCH_PROOFS];
+    struct wally_asset_pak_keys *keys;
+};
+
+static void bench_pak_verify_batch(void *ctx, size_t iterations)
+{
+    struct pak_bench *b = ctx;
+    size_t i;
+
+    for (i = 0; i < iterations; ++i)
+        check_ret(wally_asset_pak_whitelistproof_verify_batch(b->keys, b->sub_pubkeys,
+                                                              sizeof(b->sub_pubkeys),
+                                                              b->proofs, sizeof(b->proofs),
+                                                              NULL, NULL, b->results,
+                                                              sizeof(b->results)));
+}
+
+static void bench_pak_verify_single(void *ctx, size_t iterations)
+{
+    struct pak_bench *b = ctx;
+    size_t i, j;
+
+    for (i = 0; i < iterations; ++i)
+        for (j = 0; j < NUM_PAK_BENCH_PROOFS; ++j)
+            check_ret(wally_asset_pak_whitelistproof_verify(b->online, sizeof(b->online),
+                                                            b->offline, sizeof(b->offline),
+                                                            b->sub_pubkeys + j * EC_PUBLIC_KEY_LEN,
+                                                            EC_PUBLIC_KEY_LEN,
+                                                            b->proofs + j * PAK_BENCH_PROOF_LEN,
+                                                            PAK_BENCH_PROOF_LEN));
+}
+
+/* Make a key from a private key whose last byte is k */
+static void pak_bench_key(unsigned char k, unsigned char *priv_key, unsigned char *pub_key)
+{
+    memset(priv_key, 0, EC_PRIVATE_KEY_LEN);
+    priv_key[EC_PRIVATE_KEY_LEN - 1] = k;
+    check_ret(wally_ec_public_key_from_private_key(priv_key, EC_PRIVATE_KEY_LEN,
+                                                   pub_key, EC_PUBLIC_KEY_LEN));
+}
+
+static void bench_pak(void)
+{
+    struct pak_bench b;
+    unsigned char online_priv[EC_PRIVATE_KEY_LEN], summed[EC_PRIVATE_KEY_LEN];
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN];
+    size_t i, written;
+
+    for (i = 0; i < NUM_PAK_BENCH_KEYS; ++i) {
+        pak_bench_key((unsigned char)(i + 1), online_priv, b.online + i * EC_PUBLIC_KEY_LEN);
+        pak_bench_key((unsigned char)(i + 21), summed, b.offline + i * EC_PUBLIC_KEY_LEN);
+    }
+    for (i = 0; i < NUM_PAK_BENCH_PROOFS; ++i) {
+        /* Signer 0 has offline private key 21: whitelist private key 100 + i */
+        pak_bench_key((unsigned char)(100 + i), summed, b.sub_pubkeys + i * EC_PUBLIC_KEY_LEN);
+        pak_bench_key(1, online_priv, pub_key);
+        pak_bench_key((unsigned char)(121 + i), summed, pub_key);
+        check_ret(wally_asset_pak_whitelistproof(b.online, sizeof(b.online),
+                                                 b.offline, sizeof(b.offline), 0,
+                                                 b.sub_pubkeys + i * EC_PUBLIC_KEY_LEN,
+                                                 EC_PUBLIC_KEY_LEN,
+                                                 online_priv, sizeof(online_priv),
+                                                 summed, sizeof(summed),
+                                                 b.proofs + i * PAK_BENCH_PROOF_LEN,
+                                                 PAK_BENCH_PROOF_LEN, &written));
+    }
+    check_ret(wally_asset_pak_keys_init_alloc(b.online, sizeof(b.online),
+                                              b.offline, sizeof(b.offline), &b.keys));
+
+    run_bench("asset_pak_verify_16_batch", bench_pak_verify_batch, &b, 20);
+    run_bench("asset_pak_verify_16_single", bench_pak_verify_single, &b, 20);
+    wally_asset_pak_keys_free(b.keys);
+}
+
+/* Compute the ids of a transaction issuing NUM_ISSUANCES assets */
+static void bench_issuance(void)
+{
+    unsigned char txhash[WALLY_TXHASH_LEN], contract_hash[SHA256_LEN];
+    unsigned char nonce[SHA256_LEN] = { 0 }, amount[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN];
+    struct wally_tx *tx;
+    size_t i;
+
+    check_ret(wally_tx_confidential_value_from_satoshi(1000, amount, sizeof(amount)));
+    check_ret(wally_tx_init_alloc(2, 0, NUM_ISSUANCES, 0, &tx));
+    for (i = 0; i < NUM_ISSUANCES; ++i) {
+        fill(txhash, sizeof(txhash), (unsigned char)(i + 1));
+        fill(contract_hash, sizeof(contract_hash), (unsigned char)(i + 40));
+        check_ret(wally_tx_add_elements_raw_input(tx, txhash, sizeof(txhash),
+                                                  WALLY_TX_ISSUANCE_FLAG, 0xffffffff,
+                                                  NULL, 0, NULL, nonce, sizeof(nonce),
+                                                  contract_hash, sizeof(contract_hash),
+                                                  amount, sizeof(amount), NULL, 0,
+                                                  NULL, 0, NULL, 0, NULL, 0));
+    }
+
+    run_bench("issuance_ids_10_inputs", bench_issuance_ids, tx, 20000);
+    run_bench("issuance_ids_10_single", bench_issuance_ids_single, tx, 20000);
+    wally_tx_free(tx);
+}
+
+static void bench_elements(void)
+{
+    struct elements_bench b;
+    size_t i;
+
+    for (i = 0; i < NUM_ASSETS; ++i) {
+        fill(b.assets + i * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 1));
+        fill(b.abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 11));
+        check_ret(wally_asset_generator_from_bytes(b.assets + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                                   b.abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                                   b.generators + i * ASSET_GENERATOR_LEN,
+                                                   ASSET_GENERATOR_LEN));
+        fill(b.vbfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN, (unsigned char)(i + 31));
+        memcpy(b.same_generators + i * ASSET_GENERATOR_LEN, b.generators, ASSET_GENERATOR_LEN);
+    }
+    fill(b.output_abf, sizeof(b.output_abf), 20);
+    check_ret(wally_asset_generator_from_bytes(b.assets, ASSET_TAG_LEN,
+                                               b.output_abf, sizeof(b.output_abf),
+                                               b.output_generator,
+                                               sizeof(b.output_generator)));
+    fill(b.vbf, sizeof(b.vbf), 21);
+    fill(b.entropy, sizeof(b.entropy), 22);
+    fill(b.sender_priv_key, sizeof(b.sender_priv_key), 23);
+    fill(b.receiver_priv_key, sizeof(b.receiver_priv_key), 24);
+    check_ret(wally_ec_public_key_from_private_key(b.sender_priv_key, EC_PRIVATE_KEY_LEN,
+                                                   b.sender_pub_key, EC_PUBLIC_KEY_LEN));
+    check_ret(wally_ec_public_key_from_private_key(b.receiver_priv_key, EC_PRIVATE_KEY_LEN,
+                                                   b.receiver_pub_key, EC_PUBLIC_KEY_LEN));
+    check_ret(wally_asset_surjectionproof_size(NUM_ASSETS, &b.surjectionproof_len));
+    check_ret(wally_asset_generator_init_alloc(b.generators, ASSET_GENERATOR_LEN,
+                                               &b.parsed_generator));
+    check_ret(wally_asset_surjectionproof_inputs_init_alloc(b.assets, sizeof(b.assets),
+                                                            b.abfs, sizeof(b.abfs),
+                                                            b.generators, sizeof(b.generators),
+                                                            &b.surjectionproof_inputs));
+    bench_asset_value_commitment(&b, 1);
+
+    run_bench("asset_generator_from_bytes", bench_asset_generator, &b, 2000);
+    run_bench("asset_value_commitment", bench_asset_value_commitment, &b, 2000);
+    run_bench("asset_value_commitment_parsed", bench_asset_value_commitment_parsed, &b, 2000);
+    run_bench("asset_value_commitment_batch_3", bench_asset_value_commitment_batch, &b, 1000);
+    run_bench("asset_value_commitment_batch_3_single",
+              bench_asset_value_commitment_batch_single, &b, 1000);
+    /* Always create the proof, since unblinding requires it */
+    bench_asset_rangeproof(&b, 1);
+    run_bench("asset_rangeproof", bench_asset_rangeproof, &b, 50);
+    run_bench("asset_rangeproof_verify", bench_asset_rangeproof_verify, &b, 200);
+    run_bench("asset_surjectionproof_3_inputs", bench_asset_surjectionproof, &b, 200);
+    run_bench("asset_surjectionproof_3_parsed", bench_asset_surjectionproof_parsed,
+              &b, 200);
+    run_bench("asset_surjectionproof_3_verify", bench_asset_surjectionproof_verify,
+              &b, 200);
+    run_bench("asset_unblind", bench_asset_unblind, &b, 200);
+    wally_asset_generator_free(b.parsed_generator);
+    wally_asset_surjectionproof_inputs_free(b.surjectionproof_inputs);
+    bench_blind();
+    bench_issuance();
+    bench_balance();
+    bench_blinding_key();
+    bench_pak();
+}
+#endif /* BUILD_ELEMENTS */
+
+int main(int argc, char *argv[])
+{
+    uint64_t cpu_features;
+    int i;
+
+    filters = argv + 1;
+    for (i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--json"))
+            json_output = 1;
+        else if (!strncmp(argv[i], "--samples=", 10)) {
+            num_samples = strtoul(argv[i] + 10, NULL, 10);
+            if (!num_samples || num_samples > MAX_SAMPLES) {
+                fprintf(stderr, "--samples must be between 1 and %d\n", MAX_SAMPLES);
+                return 1;
+            }
+        } else
+            filters[num_filters++] = argv[i];
+    }
+
+    check_ret(wally_init(0));
+    check_ret(wally_get_cpu_features(&cpu_features));
+    if (json_output)
+        printf("{\n  \"samples\": %lu,\n  \"cpu_features\": %lu,\n  \"benchmarks\": [",
+               (unsigned long)num_samples, (unsigned long)cpu_features);
+    bench_tx();
+    bench_watchset();
+    bench_tx_set();
+    bench_tx_find();
+    bench_psbt();
+    bench_fee_rates();
+    bench_fee_estimation();
+    bench_coinselect();
+    bench_snapshot();
+    bench_block_files();
+    bench_signing();
+    bench_legacy_sighash();
+    bench_multisig();
+    bench_bip32();
+    bench_bip39();
+    bench_encodings();
+    bench_crypto();
+    bench_bindings();
+    bench_worst_case();
+#ifdef BUILD_ELEMENTS
+    bench_elements();
+#endif
+    if (json_output)
+        printf("\n  ]\n}\n");
+    check_ret(wally_cleanup(0));
+    return 0;
+}
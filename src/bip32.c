@@ -1,15 +1,29 @@
+#define WALLY_STATS_ALLOC_STAT WALLY_STAT_BIP32_ALLOC_BYTES
 #include "internal.h"
 #include "hmac.h"
 #include "ccan/ccan/crypto/ripemd160/ripemd160.h"
 #include "ccan/ccan/crypto/sha512/sha512.h"
 #include "ccan/ccan/endian/endian.h"
 #include "ccan/ccan/build_assert/build_assert.h"
+#include <include/wally_address.h>
 #include <include/wally_bip32.h>
 #include <include/wally_crypto.h>
+#include <include/wally_script.h>
+#include "base58.h"
 #include "bip32_int.h"
 #include <stdbool.h>
+#include <stdlib.h>
 
 #define BIP32_ALL_DEFINED_FLAGS (BIP32_FLAG_KEY_PRIVATE | BIP32_FLAG_KEY_PUBLIC | BIP32_FLAG_SKIP_HASH)
+/* Internal: leave the public key of a private child zeroed. Only valid for
+ * path nodes whose child is hardened and whose fingerprint is not needed */
+#define BIP32_FLAG_SKIP_PUB_KEY 0x80000000u
+
+/* Child derivation HMAC data: a serialized key followed by ser32(i) */
+#define BIP32_CHILD_KEY_LEN 33u
+#define BIP32_CHILD_DATA_LEN (BIP32_CHILD_KEY_LEN + sizeof(uint32_t))
+/* The number of children whose HMACs are computed together */
+#define BIP32_RANGE_BATCH 8u
 
 static const unsigned char SEED[] = {
     'B', 'i', 't', 'c', 'o', 'i', 'n', ' ', 's', 'e', 'e', 'd'
@@ -106,12 +120,17 @@ static void key_compute_hash160(struct ext_key *key_out)
                   key_out->hash160, sizeof(key_out->hash160));
 }
 
+static void key_free(struct ext_key *key)
+{
+    wally_clear(key, sizeof(*key));
+    wally_pool_free(key, sizeof(*key));
+}
+
 int bip32_key_free(const struct ext_key *hdkey)
 {
     if (!hdkey)
         return WALLY_EINVAL;
-    wally_clear((void *)hdkey, sizeof(*hdkey));
-    wally_free((void *)hdkey);
+    key_free((struct ext_key *)hdkey);
     return WALLY_OK;
 }
 
@@ -169,7 +188,7 @@ int bip32_key_from_seed(const unsigned char *bytes, size_t bytes_len,
 #define ALLOC_KEY() \
     if (!output) \
         return WALLY_EINVAL; \
-    *output = wally_malloc(sizeof(struct ext_key)); \
+    *output = wally_pool_malloc(sizeof(struct ext_key)); \
     if (!*output) \
         return WALLY_ENOMEM; \
     wally_clear((void *)*output, sizeof(struct ext_key))
@@ -183,7 +202,7 @@ int bip32_key_from_seed_alloc(const unsigned char *bytes, size_t bytes_len,
     ALLOC_KEY();
     ret = bip32_key_from_seed(bytes, bytes_len, version, flags, *output);
     if (ret != WALLY_OK) {
-        wally_free((void *)*output);
+        key_free(*output);
         *output = NULL;
     }
     return ret;
@@ -339,7 +358,7 @@ int bip32_key_unserialize_alloc(const unsigned char *bytes, size_t bytes_len,
     ALLOC_KEY();
     ret = bip32_key_unserialize(bytes, bytes_len, *output);
     if (ret) {
-        wally_free(*output);
+        key_free(*output);
         *output = 0;
     }
     return ret;
@@ -365,29 +384,27 @@ int bip32_key_unserialize_alloc(const unsigned char *bytes, size_t bytes_len,
  * no test vectors or paths describing these values to validate against.
  * Further, there are no public-public vectors in the BIP32 spec either.
  */
-int bip32_key_from_parent(const struct ext_key *hdkey, uint32_t child_num,
-                          uint32_t flags, struct ext_key *key_out)
+/* Check that child_num can be derived from hdkey as requested by flags */
+static int key_from_parent_check(const struct ext_key *hdkey, uint32_t child_num,
+                                 uint32_t flags, struct ext_key *key_out)
 {
-    struct sha512 sha;
-    const secp256k1_context *ctx;
-    const bool we_are_private = hdkey && key_is_private(hdkey);
+    const bool we_are_private = key_is_private(hdkey);
     const bool derive_private = !(flags & BIP32_FLAG_KEY_PUBLIC);
     const bool hardened = child_is_hardened(child_num);
 
-    if (flags & ~BIP32_ALL_DEFINED_FLAGS)
-        return WALLY_EINVAL; /* These flags are not defined yet */
-
-    if (!hdkey || !key_out)
-        return WALLY_EINVAL;
-
-    if (!(ctx = secp_ctx()))
-        return WALLY_ENOMEM;
-
     if (!we_are_private && (derive_private || hardened))
         return wipe_key_fail(key_out); /* Unsupported derivation */
 
     if (hdkey->depth == 0xff)
         return wipe_key_fail(key_out); /* Maximum depth reached */
+    return WALLY_OK;
+}
+
+/* Compute the HMAC message 'Data' for deriving child_num from hdkey */
+static void key_from_parent_data(const struct ext_key *hdkey, uint32_t child_num,
+                                 unsigned char *data)
+{
+    const uint32_t child_num_be = cpu_to_be32(child_num);
 
     /*
      *  Private parent -> private child:
@@ -401,31 +418,37 @@ int bip32_key_from_parent(const struct ext_key *hdkey, uint32_t child_num,
      * Public parent -> non hardened public child
      *    CKDpub((Kpar, cpar), i) -> (Ki, ci)
      */
-
-    /* NB: We use the key_outs' priv_key+child_num to hold 'Data' here */
-    if (hardened) {
+    if (child_is_hardened(child_num)) {
         /* Hardened: Data = 0x00 || ser256(kpar) || ser32(i)) */
-        memcpy(key_out->priv_key, hdkey->priv_key, sizeof(hdkey->priv_key));
+        memcpy(data, hdkey->priv_key, sizeof(hdkey->priv_key));
     } else {
         /* Non Hardened Private: Data = serP(point(kpar)) || ser32(i)
          * Non Hardened Public : Data = serP(kpar) || ser32(i)
          *   point(kpar) when par is private is the public key.
          */
-        memcpy(key_out->priv_key, hdkey->pub_key, sizeof(hdkey->pub_key));
+        memcpy(data, hdkey->pub_key, sizeof(hdkey->pub_key));
     }
 
     /* This is the '|| ser32(i)' part of the above */
-    key_out->child_num = cpu_to_be32(child_num);
+    memcpy(data + BIP32_CHILD_KEY_LEN, &child_num_be, sizeof(child_num_be));
+}
 
-    /* I = HMAC-SHA512(Key = cpar, Data) */
-    hmac_sha512_impl(&sha, hdkey->chain_code, sizeof(hdkey->chain_code),
-                     key_out->priv_key,
-                     sizeof(key_out->priv_key) + sizeof(key_out->child_num));
+/* Complete the derivation of child_num from hdkey, given the HMAC result.
+ * parent_pub is hdkey's parsed public key, or NULL to parse it as needed */
+static int key_from_parent_finish(const secp256k1_context *ctx,
+                                  const struct ext_key *hdkey,
+                                  const secp256k1_pubkey *parent_pub,
+                                  uint32_t child_num,
+                                  uint32_t flags, const struct sha512 *sha,
+                                  struct ext_key *key_out)
+{
+    const bool we_are_private = key_is_private(hdkey);
+    const bool derive_private = !(flags & BIP32_FLAG_KEY_PUBLIC);
 
     /* Split I into two 32-byte sequences, IL and IR
      * The returned chain code ci is IR (i.e. the 2nd half of our hmac sha512)
      */
-    memcpy(key_out->chain_code, sha.u.u8 + sizeof(sha) / 2,
+    memcpy(key_out->chain_code, sha->u.u8 + sizeof(*sha) / 2,
            sizeof(key_out->chain_code));
 
     if (we_are_private) {
@@ -434,34 +457,49 @@ int bip32_key_from_parent(const struct ext_key *hdkey, uint32_t child_num,
          * (NOTE: privkey_tweak_add checks both conditions)
          */
         memcpy(key_out->priv_key, hdkey->priv_key, sizeof(hdkey->priv_key));
-        if (!privkey_tweak_add(ctx, key_out->priv_key + 1, sha.u.u8)) {
-            wally_clear(&sha, sizeof(sha));
+        if (!privkey_tweak_add(ctx, key_out->priv_key + 1, sha->u.u8))
             return wipe_key_fail(key_out); /* Out of bounds FIXME: Iterate to the next? */
-        }
 
-        if (key_compute_pub_key(key_out) != WALLY_OK) {
-            wally_clear(&sha, sizeof(sha));
+        if (flags & BIP32_FLAG_SKIP_PUB_KEY)
+            wally_clear(key_out->pub_key, sizeof(key_out->pub_key));
+        else if (key_compute_pub_key(key_out) != WALLY_OK)
             return wipe_key_fail(key_out);
-        }
     } else {
         /* The returned child key ki is point(parse256(IL) + kpar)
          * In case parse256(IL) ≥ n or Ki is the point at infinity, the
          * resulting key is invalid (NOTE: pubkey_tweak_add checks both
          * conditions)
          */
-        secp256k1_pubkey pub_key;
+        secp256k1_pubkey pub_key, tweak_pub, child_pub;
+        const secp256k1_pubkey *points[2] = { &pub_key, &tweak_pub };
         size_t len = sizeof(key_out->pub_key);
+        bool ok;
 
         /* FIXME: Out of bounds on pubkey_tweak_add */
-        if (!pubkey_parse(ctx, &pub_key, hdkey->pub_key,
-                          sizeof(hdkey->pub_key)) ||
-            !pubkey_tweak_add(ctx, &pub_key, sha.u.u8) ||
-            !pubkey_serialize(ctx, key_out->pub_key, &len, &pub_key,
-                              PUBKEY_COMPRESSED) ||
-            len != sizeof(key_out->pub_key)) {
-            wally_clear(&sha, sizeof(sha));
+        if (parent_pub)
+            memcpy(&pub_key, parent_pub, sizeof(pub_key));
+        else if (!pubkey_parse(ctx, &pub_key, hdkey->pub_key,
+                               sizeof(hdkey->pub_key)))
             return wipe_key_fail(key_out);
+
+        /* Computing point(parse256(IL)) with the generator tables and adding
+         * it to Kpar is cheaper than the general multiplication done by
+         * pubkey_tweak_add. Fall back to pubkey_tweak_add when IL is zero
+         * or the context has no generator tables */
+        if (pubkey_create(ctx, &tweak_pub, sha->u.u8))
+            ok = secp256k1_ec_pubkey_combine(ctx, &child_pub, points, 2);
+        else {
+            memcpy(&child_pub, &pub_key, sizeof(child_pub));
+            ok = pubkey_tweak_add(ctx, &child_pub, sha->u.u8);
         }
+
+        ok = ok && pubkey_serialize(ctx, key_out->pub_key, &len, &child_pub,
+                                    PUBKEY_COMPRESSED) &&
+             len == sizeof(key_out->pub_key);
+        wally_clear_3(&pub_key, sizeof(pub_key), &tweak_pub, sizeof(tweak_pub),
+                      &child_pub, sizeof(child_pub));
+        if (!ok)
+            return wipe_key_fail(key_out);
     }
 
     if (derive_private) {
@@ -488,10 +526,138 @@ int bip32_key_from_parent(const struct ext_key *hdkey, uint32_t child_num,
         memcpy(key_out->parent160, hdkey->hash160, sizeof(hdkey->hash160));
         key_compute_hash160(key_out);
     }
-    wally_clear(&sha, sizeof(sha));
     return WALLY_OK;
 }
 
+static int key_from_parent(const struct ext_key *hdkey,
+                           const secp256k1_pubkey *parent_pub, uint32_t child_num,
+                           uint32_t flags, struct ext_key *key_out)
+{
+    unsigned char data[BIP32_CHILD_DATA_LEN];
+    struct sha512 sha;
+    const secp256k1_context *ctx;
+    int ret;
+
+    if (flags & ~(BIP32_ALL_DEFINED_FLAGS | BIP32_FLAG_SKIP_PUB_KEY))
+        return WALLY_EINVAL; /* These flags are not defined yet */
+
+    if (!hdkey || !key_out)
+        return WALLY_EINVAL;
+
+    if (!(ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    if ((ret = key_from_parent_check(hdkey, child_num, flags, key_out)) != WALLY_OK)
+        return ret;
+
+    /* I = HMAC-SHA512(Key = cpar, Data) */
+    key_from_parent_data(hdkey, child_num, data);
+    hmac_sha512_impl(&sha, hdkey->chain_code, sizeof(hdkey->chain_code),
+                     data, sizeof(data));
+
+    ret = key_from_parent_finish(ctx, hdkey, parent_pub, child_num, flags, &sha, key_out);
+    wally_clear_2(data, sizeof(data), &sha, sizeof(sha));
+    return ret;
+}
+
+int bip32_key_from_parent(const struct ext_key *hdkey, uint32_t child_num,
+                          uint32_t flags, struct ext_key *key_out)
+{
+    int ret;
+
+    WALLY_TRACE2(bip32_key_from_parent__entry, child_num, flags);
+    if (flags & BIP32_FLAG_SKIP_PUB_KEY)
+        ret = WALLY_EINVAL; /* Internal only */
+    else
+        ret = key_from_parent(hdkey, NULL, child_num, flags, key_out);
+    WALLY_TRACE1(bip32_key_from_parent__return, ret);
+    return ret;
+}
+
+int bip32_key_from_parent_parsed(const struct ext_key *hdkey,
+                                 const struct wally_ec_public_key *pub_key,
+                                 uint32_t child_num, uint32_t flags,
+                                 struct ext_key *key_out)
+{
+    if (!hdkey || !pub_key || flags & BIP32_FLAG_SKIP_PUB_KEY ||
+        memcmp(hdkey->pub_key, pub_key->pub_key, sizeof(hdkey->pub_key)))
+        return WALLY_EINVAL; /* Not the parsed public key of hdkey */
+
+    return key_from_parent(hdkey, &pub_key->pub, child_num, flags, key_out);
+}
+
+int bip32_key_from_parent_range(const struct ext_key *hdkey, uint32_t child_num,
+                                uint32_t flags, struct ext_key *output,
+                                size_t output_len)
+{
+    unsigned char data[BIP32_RANGE_BATCH * BIP32_CHILD_DATA_LEN];
+    unsigned char hashes[BIP32_RANGE_BATCH * HASH160_LEN];
+    struct sha512 sha[BIP32_RANGE_BATCH];
+    struct wally_hmac_sha512_ctx hmac_ctx;
+    secp256k1_pubkey parent_pub;
+    const secp256k1_context *ctx;
+    size_t i, j, count;
+    int ret = WALLY_OK;
+
+    if (flags & ~BIP32_ALL_DEFINED_FLAGS)
+        return WALLY_EINVAL; /* These flags are not defined yet */
+
+    if (!hdkey || !output || !output_len ||
+        output_len - 1 > (size_t)(0xffffffff - child_num))
+        return WALLY_EINVAL;
+
+    if (!(ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    /* Public children all tweak the parent public key: parse it once */
+    if (!key_is_private(hdkey) &&
+        !pubkey_parse(ctx, &parent_pub, hdkey->pub_key, sizeof(hdkey->pub_key)))
+        ret = WALLY_EINVAL;
+
+    /* Every child is keyed on the parent chain code: hash its pads once */
+    hmac_sha512_ctx_init_impl(&hmac_ctx, hdkey->chain_code, sizeof(hdkey->chain_code));
+
+    for (i = 0; i < output_len && ret == WALLY_OK; i += count) {
+        count = output_len - i < BIP32_RANGE_BATCH ? output_len - i : BIP32_RANGE_BATCH;
+
+        for (j = 0; j < count && ret == WALLY_OK; ++j) {
+            const uint32_t n = child_num + (uint32_t)(i + j);
+            ret = key_from_parent_check(hdkey, n, flags, output + i + j);
+            key_from_parent_data(hdkey, n, data + j * BIP32_CHILD_DATA_LEN);
+        }
+        if (ret != WALLY_OK)
+            break;
+
+        /* Compute the HMACs for all children in the batch at once */
+        hmac_sha512_ctx_batch_impl(&hmac_ctx, sha, data, BIP32_CHILD_DATA_LEN, count);
+
+        for (j = 0; j < count && ret == WALLY_OK; ++j)
+            ret = key_from_parent_finish(ctx, hdkey,
+                                         key_is_private(hdkey) ? NULL : &parent_pub,
+                                         child_num + (uint32_t)(i + j),
+                                         flags | BIP32_FLAG_SKIP_HASH, sha + j, output + i + j);
+
+        if (ret == WALLY_OK && !(flags & BIP32_FLAG_SKIP_HASH)) {
+            /* Compute the hash160s for all children in the batch at once */
+            for (j = 0; j < count; ++j)
+                memcpy(data + j * EC_PUBLIC_KEY_LEN, output[i + j].pub_key,
+                       EC_PUBLIC_KEY_LEN);
+            ret = wally_hash160_batch(data, count * EC_PUBLIC_KEY_LEN,
+                                      EC_PUBLIC_KEY_LEN, hashes, count * HASH160_LEN);
+            for (j = 0; j < count && ret == WALLY_OK; ++j) {
+                memcpy(output[i + j].parent160, hdkey->hash160, HASH160_LEN);
+                memcpy(output[i + j].hash160, hashes + j * HASH160_LEN, HASH160_LEN);
+            }
+        }
+    }
+
+    if (ret != WALLY_OK)
+        wally_clear(output, output_len * sizeof(*output));
+    wally_clear_5(data, sizeof(data), hashes, sizeof(hashes), sha, sizeof(sha),
+                  &hmac_ctx, sizeof(hmac_ctx), &parent_pub, sizeof(parent_pub));
+    return ret;
+}
+
 int bip32_key_from_parent_alloc(const struct ext_key *hdkey,
                                 uint32_t child_num, uint32_t flags,
                                 struct ext_key **output)
@@ -501,7 +667,7 @@ int bip32_key_from_parent_alloc(const struct ext_key *hdkey,
     ALLOC_KEY();
     ret = bip32_key_from_parent(hdkey, child_num, flags, *output);
     if (ret) {
-        wally_free(*output);
+        key_free(*output);
         *output = 0;
     }
     return ret;
@@ -511,8 +677,6 @@ int bip32_key_from_parent_path(const struct ext_key *hdkey,
                                const uint32_t *child_path, size_t child_path_len,
                                uint32_t flags, struct ext_key *key_out)
 {
-    /* Optimization: We can skip hash calculations for internal nodes */
-    uint32_t derivation_flags = flags | BIP32_FLAG_SKIP_HASH;
     struct ext_key tmp[2];
     size_t i, tmp_idx = 0;
     int ret;
@@ -525,9 +689,15 @@ int bip32_key_from_parent_path(const struct ext_key *hdkey,
 
     for (i = 0; i < child_path_len; ++i) {
         struct ext_key *derived = &tmp[tmp_idx];
-        if (i + 2 >= child_path_len)
-            derivation_flags = flags; /* Use callers flags for the final derivations */
-        ret = bip32_key_from_parent(hdkey, child_path[i], derivation_flags, derived);
+        uint32_t node_flags = flags; /* Use callers flags for the final derivations */
+        if (i + 2 < child_path_len) {
+            /* Optimization: We can skip hash calculations for internal nodes,
+             * and their public keys when a hardened child is derived next */
+            node_flags |= BIP32_FLAG_SKIP_HASH;
+            if (!(flags & BIP32_FLAG_KEY_PUBLIC) && child_is_hardened(child_path[i + 1]))
+                node_flags |= BIP32_FLAG_SKIP_PUB_KEY;
+        }
+        ret = key_from_parent(hdkey, NULL, child_path[i], node_flags, derived);
         if (ret != WALLY_OK)
             break;
         hdkey = derived;    /* Derived becomes next parent */
@@ -541,6 +711,473 @@ int bip32_key_from_parent_path(const struct ext_key *hdkey,
     return ret;
 }
 
+/* A cached parent node, keyed on the root key, path prefix and flags */
+struct path_cache_entry {
+    unsigned char root_chain_code[32];
+    unsigned char root_pub_key[33];
+    bool root_is_private;
+    uint32_t flags;
+    uint32_t path[BIP32_PATH_CACHE_MAX_DEPTH];
+    size_t path_len;
+    uint64_t last_used; /* 0 if this entry is unused */
+    struct ext_key node;
+};
+
+struct wally_bip32_path_cache {
+    struct path_cache_entry *entries;
+    size_t num_entries;
+    uint64_t clock;
+};
+
+int bip32_path_cache_init_alloc(size_t max_entries,
+                                struct wally_bip32_path_cache **output)
+{
+    struct wally_bip32_path_cache *cache;
+
+    if (output)
+        *output = NULL;
+
+    if (!max_entries || !output)
+        return WALLY_EINVAL;
+
+    if (!(cache = wally_malloc(sizeof(*cache))))
+        return WALLY_ENOMEM;
+
+    if (!(cache->entries = wally_malloc(max_entries * sizeof(*cache->entries)))) {
+        wally_free(cache);
+        return WALLY_ENOMEM;
+    }
+    cache->num_entries = max_entries;
+    bip32_path_cache_flush(cache);
+    *output = cache;
+    return WALLY_OK;
+}
+
+int bip32_path_cache_flush(struct wally_bip32_path_cache *cache)
+{
+    if (!cache)
+        return WALLY_EINVAL;
+    wally_clear(cache->entries, cache->num_entries * sizeof(*cache->entries));
+    cache->clock = 0;
+    return WALLY_OK;
+}
+
+int bip32_path_cache_free(struct wally_bip32_path_cache *cache)
+{
+    if (!cache)
+        return WALLY_EINVAL;
+    bip32_path_cache_flush(cache);
+    wally_free(cache->entries);
+    wally_clear(cache, sizeof(*cache));
+    wally_free(cache);
+    return WALLY_OK;
+}
+
+static bool path_cache_matches(const struct path_cache_entry *e,
+                               const struct ext_key *hdkey,
+                               const uint32_t *path, size_t path_len,
+                               uint32_t flags)
+{
+    return e->last_used && e->flags == flags && e->path_len == path_len &&
+           e->root_is_private == key_is_private(hdkey) &&
+           !memcmp(e->path, path, path_len * sizeof(*path)) &&
+           !memcmp(e->root_chain_code, hdkey->chain_code, sizeof(e->root_chain_code)) &&
+           !memcmp(e->root_pub_key, hdkey->pub_key, sizeof(e->root_pub_key));
+}
+
+int bip32_key_from_parent_path_cached(struct wally_bip32_path_cache *cache,
+                                      const struct ext_key *hdkey,
+                                      const uint32_t *child_path, size_t child_path_len,
+                                      uint32_t flags, struct ext_key *key_out)
+{
+    const size_t prefix_len = child_path_len ? child_path_len - 1 : 0;
+    struct path_cache_entry *e = NULL;
+    size_t i;
+    int ret;
+
+    if (!cache)
+        return WALLY_EINVAL;
+
+    if (prefix_len == 0 || prefix_len > BIP32_PATH_CACHE_MAX_DEPTH ||
+        flags & ~BIP32_ALL_DEFINED_FLAGS || !hdkey || !child_path || !key_out)
+        return bip32_key_from_parent_path(hdkey, child_path, child_path_len,
+                                          flags, key_out);
+
+    /* Find the parent of the final key, or else the least recently used entry */
+    for (i = 0; i < cache->num_entries; ++i) {
+        struct path_cache_entry *candidate = cache->entries + i;
+        if (path_cache_matches(candidate, hdkey, child_path, prefix_len, flags)) {
+            e = candidate;
+            break;
+        }
+        if (!e || candidate->last_used < e->last_used)
+            e = candidate;
+    }
+
+    if (i == cache->num_entries) {
+        /* Not cached: evict the selected entry and derive the parent into it */
+        wally_clear(e, sizeof(*e));
+        ret = bip32_key_from_parent_path(hdkey, child_path, prefix_len, flags, &e->node);
+        if (ret != WALLY_OK) {
+            wally_clear(e, sizeof(*e));
+            wally_clear(key_out, sizeof(*key_out));
+            return ret;
+        }
+        memcpy(e->root_chain_code, hdkey->chain_code, sizeof(e->root_chain_code));
+        memcpy(e->root_pub_key, hdkey->pub_key, sizeof(e->root_pub_key));
+        e->root_is_private = key_is_private(hdkey);
+        e->flags = flags;
+        memcpy(e->path, child_path, prefix_len * sizeof(*child_path));
+        e->path_len = prefix_len;
+    }
+    e->last_used = ++cache->clock;
+
+    return bip32_key_from_parent(&e->node, child_path[prefix_len], flags, key_out);
+}
+
+/* Children derived and matched by each task during discovery */
+#define DISCOVER_CHUNK BIP32_RANGE_BATCH
+#define DISCOVER_SCRIPT_TYPES (WALLY_SCRIPT_TYPE_P2PKH | WALLY_SCRIPT_TYPE_P2WPKH | \
+                               WALLY_SCRIPT_TYPE_P2SH)
+#define DISCOVER_FAILED 0xff
+
+/* A window of children on one chain to derive and match as tasks */
+struct discover_tasks {
+    const struct ext_key *chain;
+    const unsigned char *hashes; /* Sorted known hashes */
+    size_t num_hashes;
+    uint32_t flags;
+    uint32_t start;
+    size_t count;
+    unsigned char *matched; /* Per child: 1 if matched, 0 if not */
+};
+
+static int hash160_cmp(const void *lhs, const void *rhs)
+{
+    return memcmp(lhs, rhs, HASH160_LEN);
+}
+
+static bool discover_is_known(const struct discover_tasks *t,
+                              const unsigned char *hash)
+{
+    return bsearch(hash, t->hashes, t->num_hashes, HASH160_LEN, hash160_cmp) != NULL;
+}
+
+static bool discover_matches(const struct discover_tasks *t,
+                             const struct ext_key *key)
+{
+    /* p2sh-p2wpkh: the hash of the script "OP_0 <hash160(pub_key)>" */
+    unsigned char script[2 + HASH160_LEN] = { OP_0, HASH160_LEN }, hash[HASH160_LEN];
+    bool ret = false;
+
+    if (t->flags & (WALLY_SCRIPT_TYPE_P2PKH | WALLY_SCRIPT_TYPE_P2WPKH))
+        ret = discover_is_known(t, key->hash160);
+
+    if (!ret && (t->flags & WALLY_SCRIPT_TYPE_P2SH)) {
+        memcpy(script + 2, key->hash160, HASH160_LEN);
+        ret = wally_hash160(script, sizeof(script), hash, sizeof(hash)) == WALLY_OK &&
+              discover_is_known(t, hash);
+        wally_clear(hash, sizeof(hash));
+    }
+    return ret;
+}
+
+static void discover_task(void *task_ctx, size_t index)
+{
+    const struct discover_tasks *t = (const struct discover_tasks *)task_ctx;
+    const size_t offset = index * DISCOVER_CHUNK;
+    const size_t count = t->count - offset < DISCOVER_CHUNK ? t->count - offset : DISCOVER_CHUNK;
+    struct ext_key keys[DISCOVER_CHUNK];
+    size_t i;
+
+    if (bip32_key_from_parent_range(t->chain, t->start + (uint32_t)offset,
+                                    BIP32_FLAG_KEY_PUBLIC, keys, count) != WALLY_OK)
+        memset(t->matched + offset, DISCOVER_FAILED, count);
+    else
+        for (i = 0; i < count; ++i)
+            t->matched[offset + i] = discover_matches(t, keys + i) ? 1 : 0;
+    wally_clear(keys, sizeof(keys));
+}
+
+/* Scan one chain, appending the child numbers of any matches to child_path_out */
+static int discover_chain(struct discover_tasks *t, uint32_t chain_num,
+                          uint32_t gap_limit,
+                          wally_run_tasks_t run_fn, void *run_ctx,
+                          uint32_t *child_path_out, size_t len, size_t *written)
+{
+    /* Children are scanned until gap_limit in a row after the last match are unused */
+    uint64_t end = gap_limit;
+    size_t i, num_tasks;
+    int ret = WALLY_OK;
+
+    t->start = 0;
+    while (ret == WALLY_OK && t->start < end) {
+        t->count = (size_t)(end - t->start);
+        if (!(t->matched = wally_malloc(t->count)))
+            return WALLY_ENOMEM;
+
+        num_tasks = (t->count + DISCOVER_CHUNK - 1) / DISCOVER_CHUNK;
+        wally_run_tasks(run_fn, run_ctx, num_tasks, discover_task, t);
+
+        for (i = 0; i < t->count && ret == WALLY_OK; ++i) {
+            if (t->matched[i] == DISCOVER_FAILED)
+                ret = WALLY_EINVAL;
+            else if (t->matched[i]) {
+                const uint32_t child_num = t->start + (uint32_t)i;
+                if (*written + 2 <= len) {
+                    child_path_out[*written] = chain_num;
+                    child_path_out[*written + 1] = child_num;
+                }
+                *written += 2;
+                end = (uint64_t)child_num + 1 + gap_limit;
+                if (end > BIP32_INITIAL_HARDENED_CHILD)
+                    end = BIP32_INITIAL_HARDENED_CHILD;
+            }
+        }
+        t->start += (uint32_t)t->count;
+        wally_free(t->matched);
+    }
+    return ret;
+}
+
+int bip32_key_discover(const struct ext_key *hdkey,
+                       const unsigned char *hashes, size_t hashes_len,
+                       uint32_t flags, uint32_t gap_limit,
+                       wally_run_tasks_t run_fn, void *run_ctx,
+                       uint32_t *child_path_out, size_t len, size_t *written)
+{
+    struct discover_tasks tasks;
+    struct ext_key chain;
+    unsigned char *sorted;
+    uint32_t chain_num;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!hdkey || !hashes || !hashes_len || hashes_len % HASH160_LEN ||
+        !flags || (flags & ~DISCOVER_SCRIPT_TYPES) ||
+        !gap_limit || gap_limit > BIP32_INITIAL_HARDENED_CHILD ||
+        !child_path_out || !written)
+        return WALLY_EINVAL;
+
+    /* Sort the known hashes so each child can be looked up quickly */
+    if (!(sorted = wally_malloc(hashes_len)))
+        return WALLY_ENOMEM;
+    memcpy(sorted, hashes, hashes_len);
+    qsort(sorted, hashes_len / HASH160_LEN, HASH160_LEN, hash160_cmp);
+
+    tasks.chain = &chain;
+    tasks.hashes = sorted;
+    tasks.num_hashes = hashes_len / HASH160_LEN;
+    tasks.flags = flags;
+
+    /* Scan the receive chain (0) and then the change chain (1) */
+    for (chain_num = 0; chain_num < 2 && ret == WALLY_OK; ++chain_num) {
+        ret = bip32_key_from_parent(hdkey, chain_num,
+                                    BIP32_FLAG_KEY_PUBLIC | BIP32_FLAG_SKIP_HASH, &chain);
+        if (ret == WALLY_OK)
+            ret = discover_chain(&tasks, chain_num, gap_limit, run_fn, run_ctx,
+                                 child_path_out, len, written);
+    }
+
+    if (ret != WALLY_OK)
+        *written = 0;
+    wally_clear(&chain, sizeof(chain));
+    wally_free(sorted);
+    return ret;
+}
+
+/* Encode the addresses of a batch of children with the batch encoders */
+static int addresses_encode(const struct ext_key *keys, size_t count,
+                            uint32_t flags, uint32_t version,
+                            const char *addr_family,
+                            char *output, size_t len, size_t *written)
+{
+    /* Witness programs "OP_0 <hash160>", or base 58 payloads "version <hash160>" */
+    unsigned char items[BIP32_RANGE_BATCH * WALLY_SCRIPTPUBKEY_P2WPKH_LEN];
+    unsigned char hashes[BIP32_RANGE_BATCH * HASH160_LEN];
+    const size_t item_len = flags == WALLY_SCRIPT_TYPE_P2WPKH ?
+                            WALLY_SCRIPTPUBKEY_P2WPKH_LEN : 1 + HASH160_LEN;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (flags == WALLY_SCRIPT_TYPE_P2SH) {
+        /* p2sh-p2wpkh: hash160 the redeem scripts "OP_0 <hash160(pub_key)>" */
+        for (i = 0; i < count; ++i) {
+            items[i * WALLY_SCRIPTPUBKEY_P2WPKH_LEN] = OP_0;
+            items[i * WALLY_SCRIPTPUBKEY_P2WPKH_LEN + 1] = HASH160_LEN;
+            memcpy(items + i * WALLY_SCRIPTPUBKEY_P2WPKH_LEN + 2, keys[i].hash160, HASH160_LEN);
+        }
+        ret = wally_hash160_batch(items, count * WALLY_SCRIPTPUBKEY_P2WPKH_LEN,
+                                  WALLY_SCRIPTPUBKEY_P2WPKH_LEN, hashes, count * HASH160_LEN);
+        for (i = 0; i < count && ret == WALLY_OK; ++i) {
+            items[i * item_len] = (unsigned char)version;
+            memcpy(items + i * item_len + 1, hashes + i * HASH160_LEN, HASH160_LEN);
+        }
+    } else {
+        for (i = 0; i < count; ++i) {
+            unsigned char *item = items + i * item_len;
+            if (flags == WALLY_SCRIPT_TYPE_P2WPKH) {
+                *item++ = OP_0;
+                *item++ = HASH160_LEN;
+            } else
+                *item++ = (unsigned char)version;
+            memcpy(item, keys[i].hash160, HASH160_LEN);
+        }
+    }
+
+    if (ret == WALLY_OK) {
+        if (flags == WALLY_SCRIPT_TYPE_P2WPKH)
+            ret = wally_addr_segwit_from_bytes_batch(items, count * item_len, item_len,
+                                                     addr_family, 0, output, len, written);
+        else
+            ret = wally_base58_from_bytes_batch(items, count * item_len, item_len,
+                                                BASE58_FLAG_CHECKSUM, output, len, written);
+    }
+    wally_clear_2(items, sizeof(items), hashes, sizeof(hashes));
+    return ret;
+}
+
+int bip32_key_to_addresses_range(const struct ext_key *hdkey, uint32_t child_num,
+                                 size_t num_addresses, uint32_t flags,
+                                 uint32_t version, const char *addr_family,
+                                 char *output, size_t len, size_t *written)
+{
+    const bool is_segwit = flags == WALLY_SCRIPT_TYPE_P2WPKH;
+    struct ext_key keys[BIP32_RANGE_BATCH];
+    size_t i, n = 0, count, total = 0;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!hdkey || !num_addresses ||
+        num_addresses - 1 > (size_t)(0xffffffff - child_num) ||
+        (flags != WALLY_SCRIPT_TYPE_P2PKH && flags != WALLY_SCRIPT_TYPE_P2SH && !is_segwit) ||
+        (is_segwit && (!addr_family || version)) ||
+        (!is_segwit && (addr_family || version > 0xff)) ||
+        !output || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_addresses && ret == WALLY_OK; i += count) {
+        /* Once output is full, only compute the required length */
+        const size_t remaining = total < len ? len - total : 0;
+        count = num_addresses - i < BIP32_RANGE_BATCH ? num_addresses - i : BIP32_RANGE_BATCH;
+        ret = bip32_key_from_parent_range(hdkey, child_num + (uint32_t)i,
+                                          BIP32_FLAG_KEY_PUBLIC, keys, count);
+        if (ret == WALLY_OK)
+            ret = addresses_encode(keys, count, flags, version, addr_family,
+                                   remaining ? output + total : output,
+                                   remaining, &n);
+        total += n;
+    }
+
+    wally_clear(keys, sizeof(keys));
+    if (ret == WALLY_OK)
+        *written = total;
+    else
+        wally_clear(output, len);
+    return ret;
+}
+
+#define BIP32_POOL_ALL_FIELDS (BIP32_POOL_PUB_KEY | BIP32_POOL_HASH160 | BIP32_POOL_CHILD_NUM)
+
+int bip32_key_pool_init_alloc(size_t capacity, uint32_t fields,
+                              struct ext_key_pool **output)
+{
+    struct ext_key_pool *pool;
+
+    if (output)
+        *output = NULL;
+
+    if (!capacity || !fields || (fields & ~BIP32_POOL_ALL_FIELDS) || !output ||
+        capacity > ((size_t)-1) / EC_PUBLIC_KEY_LEN)
+        return WALLY_EINVAL;
+
+    if (!(pool = wally_malloc(sizeof(*pool))))
+        return WALLY_ENOMEM;
+    wally_clear(pool, sizeof(*pool));
+    pool->capacity = capacity;
+    pool->fields = fields;
+
+    if (((fields & BIP32_POOL_PUB_KEY) &&
+         !(pool->pub_keys = wally_malloc(capacity * EC_PUBLIC_KEY_LEN))) ||
+        ((fields & BIP32_POOL_HASH160) &&
+         !(pool->hash160s = wally_malloc(capacity * HASH160_LEN))) ||
+        ((fields & BIP32_POOL_CHILD_NUM) &&
+         !(pool->child_nums = wally_malloc(capacity * sizeof(uint32_t))))) {
+        bip32_key_pool_free(pool);
+        return WALLY_ENOMEM;
+    }
+    *output = pool;
+    return WALLY_OK;
+}
+
+int bip32_key_pool_add_range(struct ext_key_pool *pool, const struct ext_key *hdkey,
+                             uint32_t child_num, size_t num_keys, uint32_t flags)
+{
+    /* Only public fields are stored, so the hash is only needed if it is kept */
+    const uint32_t derive_flags = BIP32_FLAG_KEY_PUBLIC |
+        (pool && (pool->fields & BIP32_POOL_HASH160) ? 0 : BIP32_FLAG_SKIP_HASH);
+    struct ext_key keys[BIP32_RANGE_BATCH];
+    size_t i, j, count, idx;
+    int ret = WALLY_OK;
+
+    if (!pool || !hdkey || !num_keys || flags ||
+        num_keys > pool->capacity - pool->num_keys ||
+        num_keys - 1 > (size_t)(0xffffffff - child_num))
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_keys && ret == WALLY_OK; i += count) {
+        count = num_keys - i < BIP32_RANGE_BATCH ? num_keys - i : BIP32_RANGE_BATCH;
+        ret = bip32_key_from_parent_range(hdkey, child_num + (uint32_t)i,
+                                          derive_flags, keys, count);
+        for (j = 0; j < count && ret == WALLY_OK; ++j) {
+            idx = pool->num_keys + i + j;
+            if (pool->pub_keys)
+                memcpy(pool->pub_keys + idx * EC_PUBLIC_KEY_LEN,
+                       keys[j].pub_key, EC_PUBLIC_KEY_LEN);
+            if (pool->hash160s)
+                memcpy(pool->hash160s + idx * HASH160_LEN,
+                       keys[j].hash160, HASH160_LEN);
+            if (pool->child_nums)
+                pool->child_nums[idx] = keys[j].child_num;
+        }
+    }
+
+    if (ret == WALLY_OK)
+        pool->num_keys += num_keys;
+    wally_clear(keys, sizeof(keys));
+    return ret;
+}
+
+int bip32_key_pool_get_memory_usage(const struct ext_key_pool *pool,
+                                    size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!pool || !written)
+        return WALLY_EINVAL;
+    *written = sizeof(*pool) +
+               (pool->pub_keys ? pool->capacity * EC_PUBLIC_KEY_LEN : 0) +
+               (pool->hash160s ? pool->capacity * HASH160_LEN : 0) +
+               (pool->child_nums ? pool->capacity * sizeof(uint32_t) : 0);
+    return WALLY_OK;
+}
+
+int bip32_key_pool_free(struct ext_key_pool *pool)
+{
+    if (!pool)
+        return WALLY_EINVAL;
+    wally_free(pool->pub_keys);
+    wally_free(pool->hash160s);
+    wally_free(pool->child_nums);
+    wally_clear(pool, sizeof(*pool));
+    wally_free(pool);
+    return WALLY_OK;
+}
+
 int bip32_key_from_parent_path_alloc(const struct ext_key *hdkey,
                                      const uint32_t *child_path, size_t child_path_len,
                                      uint32_t flags,
@@ -552,7 +1189,7 @@ int bip32_key_from_parent_path_alloc(const struct ext_key *hdkey,
     ret = bip32_key_from_parent_path(hdkey, child_path, child_path_len,
                                      flags, *output);
     if (ret) {
-        wally_free(*output);
+        key_free(*output);
         *output = 0;
     }
     return ret;
@@ -635,28 +1272,110 @@ int bip32_key_to_base58(const struct ext_key *hdkey,
     int ret;
     unsigned char bytes[BIP32_SERIALIZED_LEN];
 
+    if (output)
+        *output = NULL;
+
+    if (!output)
+        return WALLY_EINVAL;
+
     if ((ret = bip32_key_serialize(hdkey, flags, bytes, sizeof(bytes))))
         return ret;
 
-    ret = wally_base58_from_bytes(bytes, BIP32_SERIALIZED_LEN, BASE58_FLAG_CHECKSUM, output);
+    if (!(*output = wally_malloc(BASE58_XKEY_LEN + 1)))
+        ret = WALLY_ENOMEM;
+    else if ((ret = base58_from_xkey(bytes, *output)) != WALLY_OK) {
+        wally_free(*output);
+        *output = NULL;
+    }
 
     wally_clear(bytes, sizeof(bytes));
     return ret;
 }
 
+int bip32_key_to_base58_to_buffer(const struct ext_key *hdkey,
+                                  uint32_t flags,
+                                  char *output, size_t len,
+                                  size_t *written)
+{
+    int ret;
+    unsigned char bytes[BIP32_SERIALIZED_LEN];
+
+    if (written)
+        *written = 0;
+
+    if (!output || !written)
+        return WALLY_EINVAL;
+
+    if ((ret = bip32_key_serialize(hdkey, flags, bytes, sizeof(bytes))))
+        return ret;
+
+    /* Every valid key encodes to the same length */
+    *written = BASE58_XKEY_LEN + 1;
+    if (len >= *written && (ret = base58_from_xkey(bytes, output)) != WALLY_OK)
+        *written = 0;
+
+    wally_clear(bytes, sizeof(bytes));
+    return ret;
+}
+
+int bip32_key_to_base58_batch(const struct ext_key *hdkeys, size_t num_keys,
+                              uint32_t flags,
+                              unsigned char *bytes_out, size_t bytes_out_len,
+                              char *output, size_t len, size_t *written)
+{
+    /* Serialized keys when the caller does not want them */
+    unsigned char bytes[BIP32_RANGE_BATCH * BIP32_SERIALIZED_LEN];
+    const size_t str_len = BASE58_XKEY_LEN + 1;
+    size_t i, j, count;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!hdkeys || !num_keys || num_keys > SIZE_MAX / (str_len + BIP32_SERIALIZED_LEN) ||
+        (bytes_out ? bytes_out_len != num_keys * BIP32_SERIALIZED_LEN : bytes_out_len != 0) ||
+        !output || !written)
+        return WALLY_EINVAL;
+
+    *written = num_keys * str_len;
+    if (len < *written)
+        return WALLY_OK; /* Not enough output space, return required size */
+
+    for (i = 0; i < num_keys && ret == WALLY_OK; i += count) {
+        unsigned char *dest = bytes_out ? bytes_out + i * BIP32_SERIALIZED_LEN : bytes;
+
+        count = num_keys - i < BIP32_RANGE_BATCH ? num_keys - i : BIP32_RANGE_BATCH;
+        for (j = 0; j < count && ret == WALLY_OK; ++j)
+            ret = bip32_key_serialize(hdkeys + i + j, flags,
+                                      dest + j * BIP32_SERIALIZED_LEN, BIP32_SERIALIZED_LEN);
+        if (ret == WALLY_OK)
+            ret = base58_from_xkeys(dest, count, output + i * str_len);
+    }
+
+    if (ret != WALLY_OK) {
+        if (bytes_out)
+            wally_clear(bytes_out, bytes_out_len);
+        wally_clear(output, len);
+        *written = 0;
+    }
+    wally_clear(bytes, sizeof(bytes));
+    return ret;
+}
+
 int bip32_key_from_base58(const char *base58,
                           struct ext_key *output)
 {
     int ret;
-    unsigned char bytes[BIP32_SERIALIZED_LEN + BASE58_CHECKSUM_LEN];
-    size_t written;
+    unsigned char bytes[BIP32_SERIALIZED_LEN];
+    size_t base58_len = 0;
 
-    if ((ret = wally_base58_to_bytes(base58, BASE58_FLAG_CHECKSUM, bytes, sizeof(bytes), &written)))
-        return ret;
+    /* Every valid key encodes to the same length */
+    while (base58 && base58_len <= BASE58_XKEY_LEN && base58[base58_len])
+        ++base58_len;
+    if (base58_len != BASE58_XKEY_LEN)
+        return WALLY_EINVAL;
 
-    if (written != BIP32_SERIALIZED_LEN)
-        ret = WALLY_EINVAL;
-    else
+    if ((ret = base58_to_xkey(base58, bytes)) == WALLY_OK)
         ret = bip32_key_unserialize(bytes, BIP32_SERIALIZED_LEN, output);
 
     wally_clear(bytes, sizeof(bytes));
@@ -671,7 +1390,7 @@ int bip32_key_from_base58_alloc(const char *base58,
     ALLOC_KEY();
     ret = bip32_key_from_base58(base58, *output);
     if (ret) {
-        wally_free(*output);
+        key_free(*output);
         *output = 0;
     }
     return ret;
@@ -113,7 +113,7 @@ static int address_from_private_key(const unsigned char *bytes,
     }
     if (ret == WALLY_OK) {
         sha256(&sha, pub_key, pub_key_len);
-        ripemd160(&buf.hash160, &sha, sizeof(sha));
+        ripemd160_32(&buf.hash160, &sha);
         buf.network_bytes.bytes[3] = network;
         ret = wally_base58_from_bytes(&buf.network_bytes.bytes[3],
                                       sizeof(unsigned char) + sizeof(buf.hash160),
@@ -219,6 +219,31 @@ int bip38_from_private_key(const unsigned char *bytes, size_t bytes_len,
     return ret;
 }
 
+int bip38_from_private_key_to_buffer(const unsigned char *bytes, size_t bytes_len,
+                                     const unsigned char *pass, size_t pass_len,
+                                     uint32_t flags, char *output, size_t len,
+                                     size_t *written)
+{
+    struct bip38_layout_t buf;
+    int ret;
+
+    if (written)
+        *written = 0;
+
+    if (!output || !written)
+        return WALLY_EINVAL;
+
+    ret = bip38_raw_from_private_key(bytes, bytes_len, pass, pass_len,
+                                     flags, &buf.prefix, BIP38_SERIALIZED_LEN);
+    if (!ret)
+        ret = wally_base58_from_bytes_to_buffer(&buf.prefix, BIP38_SERIALIZED_LEN,
+                                                BASE58_FLAG_CHECKSUM,
+                                                output, len, written);
+
+    wally_clear(&buf, sizeof(buf));
+    return ret;
+}
+
 
 static void aes_dec_impl(const unsigned char *cyphertext, const unsigned char *xor,
                          const unsigned char *key, unsigned char *bytes_out)
@@ -337,6 +362,108 @@ int bip38_to_private_key(const char *bip38,
                           bytes_out, len);
 }
 
+/* The inputs and results for decoding a batch of keys as tasks */
+struct to_private_key_tasks {
+    const char *const *bip38;
+    const unsigned char *pass;
+    size_t pass_len;
+    uint32_t flags;
+    unsigned char *bytes_out;
+    int *rets;
+};
+
+static void to_private_key_task(void *task_ctx, size_t i)
+{
+    struct to_private_key_tasks *t = task_ctx;
+    t->rets[i] = to_private_key(t->bip38[i], NULL, 0, t->pass, t->pass_len,
+                                t->flags, t->bytes_out + i * EC_PRIVATE_KEY_LEN,
+                                EC_PRIVATE_KEY_LEN);
+}
+
+int bip38_to_private_key_batch(const char *const *bip38, size_t num_bip38,
+                               const unsigned char *pass, size_t pass_len,
+                               uint32_t flags,
+                               wally_run_tasks_t run_fn, void *run_ctx,
+                               unsigned char *bytes_out, size_t len)
+{
+    struct to_private_key_tasks tasks;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!bip38 || !num_bip38 || !bytes_out ||
+        len / EC_PRIVATE_KEY_LEN != num_bip38 || len % EC_PRIVATE_KEY_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_bip38; ++i)
+        if (!bip38[i])
+            return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!secp_ctx())
+        return WALLY_ENOMEM;
+
+    tasks.bip38 = bip38;
+    tasks.pass = pass;
+    tasks.pass_len = pass_len;
+    tasks.flags = flags;
+    tasks.bytes_out = bytes_out;
+    if (!(tasks.rets = wally_malloc(num_bip38 * sizeof(int))))
+        return WALLY_ENOMEM;
+
+    wally_run_tasks(run_fn, run_ctx, num_bip38, to_private_key_task, &tasks);
+
+    for (i = 0; i < num_bip38 && ret == WALLY_OK; ++i)
+        ret = tasks.rets[i];
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    wally_free(tasks.rets);
+    return ret;
+}
+
+/* The copied inputs of an asynchronous decode, followed by pass and bip38 */
+struct to_private_key_async {
+    size_t pass_len;
+    uint32_t flags;
+    unsigned char *bytes_out;
+    size_t len;
+};
+
+static int to_private_key_async_work(void *work_ctx)
+{
+    struct to_private_key_async *a = work_ctx;
+    const unsigned char *pass = (const unsigned char *)(a + 1);
+    return to_private_key((const char *)pass + a->pass_len, NULL, 0,
+                          pass, a->pass_len, a->flags, a->bytes_out, a->len);
+}
+
+int bip38_to_private_key_async(const char *bip38,
+                               const unsigned char *pass, size_t pass_len,
+                               uint32_t flags,
+                               unsigned char *bytes_out, size_t len,
+                               wally_async_done_t done_fn, void *done_ctx,
+                               struct wally_async **output)
+{
+    const size_t bip38_len = bip38 ? strlen(bip38) + 1 : 0;
+    const size_t work_len = sizeof(struct to_private_key_async) + pass_len + bip38_len;
+    struct to_private_key_async *a;
+
+    if (output)
+        *output = NULL;
+    if (!bip38 || (!pass && pass_len) || !output)
+        return WALLY_EINVAL;
+    if ((a = wally_secret_alloc(work_len))) {
+        a->pass_len = pass_len;
+        a->flags = flags;
+        a->bytes_out = bytes_out;
+        a->len = len;
+        if (pass_len)
+            memcpy(a + 1, pass, pass_len);
+        memcpy((unsigned char *)(a + 1) + pass_len, bip38, bip38_len);
+    }
+    return wally_async_start(to_private_key_async_work, a, work_len,
+                             bytes_out, len, done_fn, done_ctx, output);
+}
+
 static int get_flags(const char *bip38,
                      const unsigned char *bytes, size_t bytes_len,
                      size_t *written)
@@ -4,8 +4,10 @@
 #include "hmac.h"
 #include "ccan/ccan/crypto/sha256/sha256.h"
 #include "ccan/ccan/crypto/sha512/sha512.h"
+#include <include/wally_bip32.h>
 #include <include/wally_bip39.h>
 #include <include/wally_crypto.h>
+#include <include/wally_script.h>
 
 #include "data/wordlists/chinese_simplified.c"
 #include "data/wordlists/chinese_traditional.c"
@@ -28,14 +30,36 @@ static const struct {
     /* FIXME: Should 'zh' map to traditional or simplified? */
 };
 
+static const char languages[] = "en es fr it jp zhs zht";
+
+/* Copy a NUL terminated string to a caller supplied buffer */
+static int str_to_buffer(const char *str, char *output, size_t len, size_t *written)
+{
+    *written = strlen(str) + 1;
+    if (len >= *written)
+        memcpy(output, str, *written);
+    return WALLY_OK;
+}
+
 int bip39_get_languages(char **output)
 {
     if (!output)
         return WALLY_EINVAL;
-    *output = wally_strdup("en es fr it jp zhs zht");
+    *output = wally_strdup(languages);
     return *output ? WALLY_OK : WALLY_ENOMEM;
 }
 
+int bip39_get_languages_to_buffer(char *output, size_t len, size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!output || !written)
+        return WALLY_EINVAL;
+
+    return str_to_buffer(languages, output, len, written);
+}
+
 int bip39_get_wordlist(const char *lang, struct words **output)
 {
     size_t i;
@@ -71,6 +95,22 @@ int bip39_get_word(const struct words *w, size_t idx,
     return *output ? WALLY_OK : WALLY_ENOMEM;
 }
 
+int bip39_get_word_to_buffer(const struct words *w, size_t idx,
+                             char *output, size_t len, size_t *written)
+{
+    const char *word;
+
+    if (written)
+        *written = 0;
+
+    w = w ? w : &en_words;
+
+    if (!output || !written || !(word = wordlist_lookup_index(w, idx)))
+        return WALLY_EINVAL;
+
+    return str_to_buffer(word, output, len, written);
+}
+
 /* Convert an input entropy length to a mask for checksum bits. As it
  * returns 0 for bad lengths, it serves as a validation function too.
  */
@@ -98,12 +138,26 @@ static size_t bip39_checksum(const unsigned char *bytes, size_t bytes_len, size_
     return ret & mask;
 }
 
+/* Append the checksum to entropy in tmp_bytes, returning its total length */
+static size_t entropy_with_checksum(const unsigned char *bytes, size_t bytes_len,
+                                    size_t mask, unsigned char *tmp_bytes)
+{
+    size_t checksum;
+
+    memcpy(tmp_bytes, bytes, bytes_len);
+    checksum = bip39_checksum(bytes, bytes_len, mask);
+    tmp_bytes[bytes_len] = checksum & 0xff;
+    if (mask > 0xff)
+        tmp_bytes[++bytes_len] = (checksum >> 8) & 0xff;
+    return bytes_len + 1;
+}
+
 int bip39_mnemonic_from_bytes(const struct words *w,
                               const unsigned char *bytes, size_t bytes_len,
                               char **output)
 {
     unsigned char tmp_bytes[BIP39_ENTROPY_LEN_MAX];
-    size_t checksum, mask;
+    size_t mask;
 
     if (output)
         *output = NULL;
@@ -116,16 +170,36 @@ int bip39_mnemonic_from_bytes(const struct words *w,
     if (w->bits != 11u || !(mask = len_to_mask(bytes_len)))
         return WALLY_EINVAL;
 
-    memcpy(tmp_bytes, bytes, bytes_len);
-    checksum = bip39_checksum(bytes, bytes_len, mask);
-    tmp_bytes[bytes_len] = checksum & 0xff;
-    if (mask > 0xff)
-        tmp_bytes[++bytes_len] = (checksum >> 8) & 0xff;
-    *output = mnemonic_from_bytes(w, tmp_bytes, bytes_len + 1);
+    bytes_len = entropy_with_checksum(bytes, bytes_len, mask, tmp_bytes);
+    *output = mnemonic_from_bytes(w, tmp_bytes, bytes_len);
     wally_clear(tmp_bytes, sizeof(tmp_bytes));
     return *output ? WALLY_OK : WALLY_ENOMEM;
 }
 
+int bip39_mnemonic_from_bytes_to_buffer(const struct words *w,
+                                        const unsigned char *bytes, size_t bytes_len,
+                                        char *output, size_t len, size_t *written)
+{
+    unsigned char tmp_bytes[BIP39_ENTROPY_LEN_MAX];
+    size_t mask;
+
+    if (written)
+        *written = 0;
+
+    if (!bytes || !bytes_len || !output || !written)
+        return WALLY_EINVAL;
+
+    w = w ? w : &en_words;
+
+    if (w->bits != 11u || !(mask = len_to_mask(bytes_len)))
+        return WALLY_EINVAL;
+
+    bytes_len = entropy_with_checksum(bytes, bytes_len, mask, tmp_bytes);
+    *written = mnemonic_from_bytes_to_buffer(w, tmp_bytes, bytes_len, output, len);
+    wally_clear(tmp_bytes, sizeof(tmp_bytes));
+    return WALLY_OK;
+}
+
 static bool checksum_ok(const unsigned char *bytes, size_t idx, size_t mask)
 {
     /* The checksum is stored after the data to sum */
@@ -136,12 +210,31 @@ static bool checksum_ok(const unsigned char *bytes, size_t idx, size_t mask)
     return (stored & mask) == calculated;
 }
 
-int bip39_mnemonic_to_bytes(const struct words *w, const char *mnemonic,
-                            unsigned char *bytes_out, size_t len,
-                            size_t *written)
+/* Remove the checksum from the decoded length of a mnemonic, verifying
+ * the checksum if the entropy fits in len bytes */
+static int mnemonic_verify(const unsigned char *tmp_bytes, size_t *tmp_len, size_t len)
+{
+    size_t mask;
+
+    /* Remove checksum bytes from the output length */
+    --*tmp_len;
+    if (*tmp_len > BIP39_ENTROPY_LEN_256)
+        --*tmp_len; /* Second byte required */
+
+    if (*tmp_len > BIP39_ENTROPY_LEN_MAX)
+        return WALLY_EINVAL; /* Too big for biggest supported entropy */
+    if (*tmp_len <= len && (!(mask = len_to_mask(*tmp_len)) ||
+                            !checksum_ok(tmp_bytes, *tmp_len, mask)))
+        return WALLY_EINVAL; /* Bad checksum */
+    return WALLY_OK;
+}
+
+/* Decode a mnemonic into tmp_bytes, returning the entropy length in
+ * tmp_len. The checksum is only checked if the entropy fits in len bytes */
+static int mnemonic_decode(const struct words *w, const char *mnemonic,
+                           unsigned char *tmp_bytes, size_t *tmp_len,
+                           size_t len)
 {
-    unsigned char tmp_bytes[BIP39_ENTROPY_LEN_MAX];
-    size_t mask, tmp_len;
     int ret;
 
     /* Ideally we would infer the wordlist here. Unfortunately this cannot
@@ -155,34 +248,34 @@ int bip39_mnemonic_to_bytes(const struct words *w, const char *mnemonic,
      */
     w = w ? w : &en_words;
 
+    if (w->bits != 11u || !mnemonic ||
+        wally_exceeds_input_limit(WALLY_LIMIT_MNEMONIC_LEN,
+                                  wally_strlen_limited(mnemonic, WALLY_LIMIT_MNEMONIC_LEN)))
+        return WALLY_EINVAL;
+
+    ret = mnemonic_to_bytes(w, mnemonic, tmp_bytes, BIP39_ENTROPY_LEN_MAX, tmp_len);
+    if (!ret)
+        ret = mnemonic_verify(tmp_bytes, tmp_len, len);
+    return ret;
+}
+
+int bip39_mnemonic_to_bytes(const struct words *w, const char *mnemonic,
+                            unsigned char *bytes_out, size_t len,
+                            size_t *written)
+{
+    unsigned char tmp_bytes[BIP39_ENTROPY_LEN_MAX];
+    size_t tmp_len = 0;
+    int ret;
+
     if (written)
         *written = 0;
 
-    if (w->bits != 11u || !mnemonic || !bytes_out)
+    if (!bytes_out)
         return WALLY_EINVAL;
 
-    ret = mnemonic_to_bytes(w, mnemonic, tmp_bytes, sizeof(tmp_bytes), &tmp_len);
-
-    if (!ret) {
-        /* Remove checksum bytes from the output length */
-        --tmp_len;
-        if (tmp_len > BIP39_ENTROPY_LEN_256)
-            --tmp_len; /* Second byte required */
-
-        if (tmp_len > sizeof(tmp_bytes))
-            ret = WALLY_EINVAL; /* Too big for biggest supported entropy */
-        else {
-            if (tmp_len <= len) {
-                if (!(mask = len_to_mask(tmp_len)) ||
-                    !checksum_ok(tmp_bytes, tmp_len, mask)) {
-                    tmp_len = 0;
-                    ret = WALLY_EINVAL; /* Bad checksum */
-                }
-                else
-                    memcpy(bytes_out, tmp_bytes, tmp_len);
-            }
-        }
-    }
+    ret = mnemonic_decode(w, mnemonic, tmp_bytes, &tmp_len, len);
+    if (!ret && tmp_len <= len)
+        memcpy(bytes_out, tmp_bytes, tmp_len);
 
     wally_clear(tmp_bytes, sizeof(tmp_bytes));
     if (!ret && written)
@@ -192,20 +285,88 @@ int bip39_mnemonic_to_bytes(const struct words *w, const char *mnemonic,
 
 int bip39_mnemonic_validate(const struct words *w, const char *mnemonic)
 {
-    unsigned char buf[BIP39_ENTROPY_LEN_MAX];
-    size_t len;
-    int ret = bip39_mnemonic_to_bytes(w, mnemonic, buf, sizeof(buf), &len);
-    wally_clear(buf, sizeof(buf));
+    unsigned char tmp_bytes[BIP39_ENTROPY_LEN_MAX];
+    size_t tmp_len;
+    int ret = mnemonic_decode(w, mnemonic, tmp_bytes, &tmp_len, sizeof(tmp_bytes));
+    wally_clear(tmp_bytes, sizeof(tmp_bytes));
     return ret;
 }
 
+#define NUM_LANGUAGES (sizeof(lookup) / sizeof(lookup[0]))
+
+int bip39_mnemonic_detect_languages(const char *mnemonic, size_t *written)
+{
+    unsigned char tmp_bytes[NUM_LANGUAGES][BIP39_ENTROPY_LEN_MAX];
+    const char *p;
+    size_t num_words = 1u, candidates, i, j;
+
+    if (written)
+        *written = 0;
+
+    if (!mnemonic || !written)
+        return WALLY_EINVAL;
+
+    for (p = mnemonic; *p; ++p)
+        num_words += *p == ' '; /* FIXME: utf-8 sep */
+    if ((num_words * 11u + 7u) / 8u > BIP39_ENTROPY_LEN_MAX)
+        return WALLY_OK; /* Too long for any language */
+
+    wally_clear(tmp_bytes, sizeof(tmp_bytes));
+    candidates = (1u << NUM_LANGUAGES) - 1u;
+
+    /* Tokenise once, looking each word up in every language it may still
+     * be from. Hashes are shared between lists with the same seed */
+    for (i = 0, p = mnemonic; i < num_words && candidates; ++i) {
+        const char *word = p;
+        uint64_t hash = 0;
+        uint32_t hash_seed = 0;
+        bool have_hash = false;
+
+        while (*p && *p != ' ') /* FIXME: utf-8 sep */
+            ++p;
+        for (j = 0; j < NUM_LANGUAGES; ++j) {
+            const struct words *w = lookup[j].words;
+            size_t idx;
+
+            if (!(candidates & (1u << j)))
+                continue;
+            if (!have_hash || w->hash_seed != hash_seed) {
+                hash = wordlist_hash_word(w, word, p - word);
+                hash_seed = w->hash_seed;
+                have_hash = true;
+            }
+            idx = wordlist_lookup_word_hash(w, word, p - word, hash);
+            if (idx)
+                mnemonic_store_index(w->bits, tmp_bytes[j], i, idx - 1);
+            else
+                candidates &= ~(1u << j);
+        }
+        ++p; /* Skip the separator */
+    }
+
+    for (j = 0; j < NUM_LANGUAGES; ++j) {
+        size_t tmp_len = (num_words * 11u + 7u) / 8u;
+        if ((candidates & (1u << j)) &&
+            mnemonic_verify(tmp_bytes[j], &tmp_len, BIP39_ENTROPY_LEN_MAX) != WALLY_OK)
+            candidates &= ~(1u << j);
+    }
+
+    wally_clear(tmp_bytes, sizeof(tmp_bytes));
+    *written = candidates;
+    return WALLY_OK;
+}
+
+#define BIP39_PBKDF2_COST 2048u
+#define BIP39_SALT_PREFIX "mnemonic"
+#define BIP39_SALT_PREFIX_LEN (sizeof(BIP39_SALT_PREFIX) - 1)
+
 int  bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
                             unsigned char *bytes_out, size_t len,
                             size_t *written)
 {
-    const size_t bip9_cost = 2048u;
-    const char *prefix = "mnemonic";
-    const size_t prefix_len = strlen(prefix);
+    const size_t bip9_cost = BIP39_PBKDF2_COST;
+    const char *prefix = BIP39_SALT_PREFIX;
+    const size_t prefix_len = BIP39_SALT_PREFIX_LEN;
     const size_t passphrase_len = passphrase ? strlen(passphrase) : 0;
     const size_t salt_len = prefix_len + passphrase_len;
     unsigned char *salt;
@@ -217,7 +378,7 @@ int  bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
     if (!mnemonic || !bytes_out || len != BIP39_SEED_LEN_512)
         return WALLY_EINVAL;
 
-    salt = wally_malloc(salt_len);
+    salt = wally_secret_alloc(salt_len);
     if (!salt)
         return WALLY_ENOMEM;
 
@@ -232,8 +393,423 @@ int  bip39_mnemonic_to_seed(const char *mnemonic, const char *passphrase,
     if (!ret && written)
         *written = BIP39_SEED_LEN_512; /* Succeeded */
 
-    wally_clear(salt, salt_len);
-    wally_free(salt);
+    wally_secret_free(salt, salt_len);
+    return ret;
+}
+
+/* The copied inputs of an asynchronous seed derivation, followed by
+ * the mnemonic and passphrase strings */
+struct mnemonic_to_seed_async {
+    size_t mnemonic_len;
+    int have_passphrase;
+    unsigned char *bytes_out;
+    size_t len;
+};
+
+static int mnemonic_to_seed_async_work(void *work_ctx)
+{
+    struct mnemonic_to_seed_async *a = work_ctx;
+    const char *mnemonic = (const char *)(a + 1);
+    const char *passphrase = mnemonic + a->mnemonic_len + 1;
+    return bip39_mnemonic_to_seed(mnemonic, a->have_passphrase ? passphrase : NULL,
+                                  a->bytes_out, a->len, NULL);
+}
+
+int bip39_mnemonic_to_seed_async(const char *mnemonic, const char *passphrase,
+                                 unsigned char *bytes_out, size_t len,
+                                 wally_async_done_t done_fn, void *done_ctx,
+                                 struct wally_async **output)
+{
+    const size_t mnemonic_len = mnemonic ? strlen(mnemonic) : 0;
+    const size_t passphrase_len = passphrase ? strlen(passphrase) : 0;
+    const size_t work_len = sizeof(struct mnemonic_to_seed_async) +
+                            mnemonic_len + passphrase_len + 2;
+    struct mnemonic_to_seed_async *a;
+
+    if (output)
+        *output = NULL;
+    if (!mnemonic || !output)
+        return WALLY_EINVAL;
+    if ((a = wally_secret_alloc(work_len))) {
+        char *p = (char *)(a + 1);
+        a->mnemonic_len = mnemonic_len;
+        a->have_passphrase = passphrase != NULL;
+        a->bytes_out = bytes_out;
+        a->len = len;
+        memcpy(p, mnemonic, mnemonic_len + 1);
+        memcpy(p + mnemonic_len + 1, passphrase ? passphrase : "", passphrase_len + 1);
+    }
+    return wally_async_start(mnemonic_to_seed_async_work, a, work_len,
+                             bytes_out, len, done_fn, done_ctx, output);
+}
+
+int bip39_mnemonic_to_seed_batch(const char *const *mnemonics,
+                                 const char *const *passphrases,
+                                 size_t num_mnemonics,
+                                 unsigned char *bytes_out, size_t len,
+                                 size_t *written)
+{
+    const unsigned char **passes, **salts;
+    size_t *pass_lens, *salt_lens, salts_len = 0, alloc_len, i;
+    unsigned char *buff, *salt;
+    int ret;
+
+    if (written)
+        *written = 0;
 
+    if (!mnemonics || !num_mnemonics || !bytes_out ||
+        len / BIP39_SEED_LEN_512 != num_mnemonics || len % BIP39_SEED_LEN_512)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_mnemonics; ++i) {
+        if (!mnemonics[i])
+            return WALLY_EINVAL;
+        salts_len += BIP39_SALT_PREFIX_LEN;
+        if (passphrases && passphrases[i])
+            salts_len += strlen(passphrases[i]);
+    }
+
+    /* Allocate the PBKDF2 inputs and the salts in a single buffer */
+    alloc_len = num_mnemonics * (2 * sizeof(unsigned char *) + 2 * sizeof(size_t));
+    if (!(buff = wally_secret_alloc(alloc_len + salts_len)))
+        return WALLY_ENOMEM;
+    passes = (const unsigned char **)buff;
+    salts = passes + num_mnemonics;
+    pass_lens = (size_t *)(salts + num_mnemonics);
+    salt_lens = pass_lens + num_mnemonics;
+    salt = buff + alloc_len;
+
+    for (i = 0; i < num_mnemonics; ++i) {
+        const size_t passphrase_len = passphrases && passphrases[i] ? strlen(passphrases[i]) : 0;
+
+        passes[i] = (const unsigned char *)mnemonics[i];
+        pass_lens[i] = strlen(mnemonics[i]);
+        memcpy(salt, BIP39_SALT_PREFIX, BIP39_SALT_PREFIX_LEN);
+        if (passphrase_len)
+            memcpy(salt + BIP39_SALT_PREFIX_LEN, passphrases[i], passphrase_len);
+        salts[i] = salt;
+        salt_lens[i] = BIP39_SALT_PREFIX_LEN + passphrase_len;
+        salt += salt_lens[i];
+    }
+
+    ret = pbkdf2_hmac_sha512_batch_impl(passes, pass_lens, salts, salt_lens,
+                                        num_mnemonics, BIP39_PBKDF2_COST,
+                                        bytes_out, BIP39_SEED_LEN_512);
+    if (!ret && written)
+        *written = len; /* Succeeded */
+
+    wally_secret_free(buff, alloc_len + salts_len);
+    return ret;
+}
+
+/* The most words a mnemonic can have, for 320 bits of entropy */
+#define RECOVER_MAX_WORDS 30
+/* The longest word in the default word lists, in bytes */
+#define RECOVER_MAX_WORD_LEN 27
+#define RECOVER_MAX_MNEMONIC_LEN (RECOVER_MAX_WORDS * (RECOVER_MAX_WORD_LEN + 1))
+/* Candidates whose seeds are derived in lockstep by each task */
+#define RECOVER_CHUNK 8
+#define RECOVER_FLAGS (BIP39_RECOVER_FLAG_REPLACE | BIP39_RECOVER_FLAG_INSERT)
+#define RECOVER_SCRIPT_TYPES (WALLY_SCRIPT_TYPE_P2PKH | WALLY_SCRIPT_TYPE_P2WPKH | \
+                              WALLY_SCRIPT_TYPE_P2SH)
+#define RECOVER_FAILED 0xff
+#define RECOVER_UNKNOWN 0xffff /* Index of a word not in the word list */
+
+/* The known words of a mnemonic, and the candidates to try for it */
+struct recover_tasks {
+    const struct words *w;
+    uint16_t known[RECOVER_MAX_WORDS]; /* Indices of the given words */
+    size_t num_words; /* Number of words in a recovered mnemonic */
+    bool insert; /* True if the candidate word is inserted, not replaced */
+    const unsigned char *salt;
+    size_t salt_len;
+    const uint32_t *child_path;
+    size_t child_path_len;
+    const unsigned char *hashes; /* Sorted known hashes */
+    size_t num_hashes;
+    uint32_t script_types;
+    const uint32_t *candidates;
+    size_t num_candidates;
+    unsigned char *matched; /* Per candidate: 1 if matched, 0 if not */
+};
+
+/* Get the word indices of the mnemonic given by a candidate */
+static void recover_indices(const struct recover_tasks *t, uint32_t candidate,
+                            uint16_t *indices)
+{
+    const size_t pos = candidate / BIP39_WORDLIST_LEN;
+    size_t i;
+
+    for (i = 0; i < t->num_words; ++i) {
+        if (i == pos)
+            indices[i] = candidate % BIP39_WORDLIST_LEN;
+        else
+            indices[i] = t->known[t->insert && i > pos ? i - 1 : i];
+    }
+}
+
+static int recover_hash_cmp(const void *lhs, const void *rhs)
+{
+    return memcmp(lhs, rhs, HASH160_LEN);
+}
+
+static bool recover_is_known(const struct recover_tasks *t, const unsigned char *hash)
+{
+    return bsearch(hash, t->hashes, t->num_hashes, HASH160_LEN, recover_hash_cmp) != NULL;
+}
+
+static bool recover_matches(const struct recover_tasks *t, const struct ext_key *key)
+{
+    /* p2sh-p2wpkh: the hash of the script "OP_0 <hash160(pub_key)>" */
+    unsigned char script[2 + HASH160_LEN] = { OP_0, HASH160_LEN }, hash[HASH160_LEN];
+    bool ret = false;
+
+    if (t->script_types & (WALLY_SCRIPT_TYPE_P2PKH | WALLY_SCRIPT_TYPE_P2WPKH))
+        ret = recover_is_known(t, key->hash160);
+
+    if (!ret && (t->script_types & WALLY_SCRIPT_TYPE_P2SH)) {
+        memcpy(script + 2, key->hash160, HASH160_LEN);
+        ret = wally_hash160(script, sizeof(script), hash, sizeof(hash)) == WALLY_OK &&
+              recover_is_known(t, hash);
+        wally_clear(hash, sizeof(hash));
+    }
+    return ret;
+}
+
+/* Derive the seeds of a chunk of candidates, and match their keys */
+static void recover_task(void *task_ctx, size_t index)
+{
+    const struct recover_tasks *t = (const struct recover_tasks *)task_ctx;
+    const size_t offset = index * RECOVER_CHUNK;
+    const size_t count = t->num_candidates - offset < RECOVER_CHUNK ?
+                         t->num_candidates - offset : RECOVER_CHUNK;
+    char mnemonics[RECOVER_CHUNK][RECOVER_MAX_MNEMONIC_LEN];
+    const unsigned char *passes[RECOVER_CHUNK], *salts[RECOVER_CHUNK];
+    size_t pass_lens[RECOVER_CHUNK], salt_lens[RECOVER_CHUNK], i, j;
+    unsigned char seeds[RECOVER_CHUNK * BIP39_SEED_LEN_512];
+    uint16_t indices[RECOVER_MAX_WORDS];
+    struct ext_key master, key;
+    int ret = WALLY_OK;
+
+    for (i = 0; i < count; ++i) {
+        char *p = mnemonics[i];
+
+        recover_indices(t, t->candidates[offset + i], indices);
+        for (j = 0; j < t->num_words; ++j) {
+            const char *word = wordlist_lookup_index(t->w, indices[j]);
+            const size_t word_len = strlen(word);
+
+            if (word_len > RECOVER_MAX_WORD_LEN) {
+                ret = WALLY_EINVAL; /* Not a default word list */
+                break;
+            }
+            memcpy(p, word, word_len);
+            p += word_len;
+            *p++ = ' ';
+        }
+        passes[i] = (const unsigned char *)mnemonics[i];
+        pass_lens[i] = p - mnemonics[i] - 1; /* Without the trailing space */
+        salts[i] = t->salt;
+        salt_lens[i] = t->salt_len;
+    }
+
+    if (ret == WALLY_OK)
+        ret = pbkdf2_hmac_sha512_batch_impl(passes, pass_lens, salts, salt_lens,
+                                            count, BIP39_PBKDF2_COST,
+                                            seeds, BIP39_SEED_LEN_512);
+
+    for (i = 0; i < count; ++i) {
+        if (ret == WALLY_OK)
+            ret = bip32_key_from_seed(seeds + i * BIP39_SEED_LEN_512, BIP39_SEED_LEN_512,
+                                      BIP32_VER_MAIN_PRIVATE, 0, &master);
+        if (ret == WALLY_OK && t->child_path_len)
+            ret = bip32_key_from_parent_path(&master, t->child_path, t->child_path_len,
+                                             BIP32_FLAG_KEY_PRIVATE, &key);
+        else if (ret == WALLY_OK)
+            memcpy(&key, &master, sizeof(key));
+        if (ret != WALLY_OK)
+            t->matched[offset + i] = RECOVER_FAILED;
+        else
+            t->matched[offset + i] = recover_matches(t, &key) ? 1 : 0;
+    }
+
+    wally_clear_4(mnemonics, sizeof(mnemonics), seeds, sizeof(seeds),
+                  &master, sizeof(master), &key, sizeof(key));
+    wally_clear(indices, sizeof(indices));
+}
+
+/* Find the candidates with valid checksums, writing them to candidates_out */
+static void recover_checksums(const struct recover_tasks *t,
+                              const size_t *positions, size_t num_positions,
+                              uint32_t *candidates_out, size_t len, size_t *written)
+{
+    const size_t entropy_len = t->num_words * 4 / 3, mask = len_to_mask(entropy_len);
+    unsigned char base[BIP39_ENTROPY_LEN_MAX], bytes[BIP39_ENTROPY_LEN_MAX];
+    uint16_t indices[RECOVER_MAX_WORDS];
+    size_t i, j, v;
+
+    for (i = 0; i < num_positions; ++i) {
+        const size_t pos = positions[i];
+        const uint32_t first = (uint32_t)(pos * BIP39_WORDLIST_LEN);
+
+        /* Pack the known words once per position, leaving the candidate
+         * word's bits clear. Each candidate then only sets its own bits */
+        recover_indices(t, first, indices);
+        wally_clear(base, sizeof(base));
+        for (j = 0; j < t->num_words; ++j)
+            mnemonic_store_index(11u, base, j, indices[j]);
+
+        for (v = 0; v < BIP39_WORDLIST_LEN; ++v) {
+            if (!t->insert && t->known[pos] == v)
+                continue; /* The word is being replaced */
+            if (t->insert && pos && t->known[pos - 1] == v)
+                continue; /* Duplicates inserting v after the previous word */
+            memcpy(bytes, base, sizeof(bytes));
+            mnemonic_store_index(11u, bytes, pos, v);
+            if (checksum_ok(bytes, entropy_len, mask)) {
+                if (*written < len)
+                    candidates_out[*written] = first + (uint32_t)v;
+                ++*written;
+            }
+        }
+    }
+    wally_clear_3(base, sizeof(base), bytes, sizeof(bytes), indices, sizeof(indices));
+}
+
+int bip39_mnemonic_recover(const struct words *w, const char *mnemonic,
+                           uint32_t flags, const char *passphrase,
+                           const uint32_t *child_path, size_t child_path_len,
+                           const unsigned char *hashes, size_t hashes_len,
+                           uint32_t script_types,
+                           wally_run_tasks_t run_fn, void *run_ctx,
+                           uint32_t *candidates_out, size_t len, size_t *written)
+{
+    struct recover_tasks t;
+    size_t positions[RECOVER_MAX_WORDS], num_positions = 0, num_known = 0;
+    size_t unknown_pos = 0, num_unknown = 0, num_tasks, i;
+    unsigned char *sorted = NULL, *salt = NULL;
+    uint32_t *candidates = NULL;
+    const char *p;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    w = w ? w : &en_words;
+
+    if (w->bits != 11u || !mnemonic || (flags & ~RECOVER_FLAGS) ||
+        flags == RECOVER_FLAGS ||
+        (!child_path && child_path_len) ||
+        (!hashes != !hashes_len) || hashes_len % HASH160_LEN ||
+        (script_types & ~RECOVER_SCRIPT_TYPES) || (!hashes != !script_types) ||
+        (!hashes && (passphrase || child_path)) ||
+        !candidates_out || !written)
+        return WALLY_EINVAL;
+
+    wally_clear(&t, sizeof(t));
+    t.w = w;
+    t.insert = (flags & BIP39_RECOVER_FLAG_INSERT) != 0;
+
+    /* Look up the words, noting the position of any that are unknown */
+    for (p = mnemonic; ; ++p) {
+        const char *word = p;
+        size_t idx;
+
+        while (*p && *p != ' ') /* FIXME: utf-8 sep */
+            ++p;
+        if (num_known == RECOVER_MAX_WORDS) {
+            ret = WALLY_EINVAL; /* Too many words */
+            goto cleanup;
+        }
+        idx = wordlist_lookup_word_len(w, word, p - word);
+        if (!idx) {
+            unknown_pos = num_known;
+            ++num_unknown;
+        }
+        t.known[num_known++] = idx ? (uint16_t)(idx - 1) : RECOVER_UNKNOWN;
+        if (!*p)
+            break;
+    }
+
+    t.num_words = num_known + (t.insert ? 1 : 0);
+    if (num_unknown > 1 || (num_unknown && t.insert) ||
+        (!num_unknown && !flags) || t.num_words > RECOVER_MAX_WORDS ||
+        t.num_words % 3 || !len_to_mask(t.num_words * 4 / 3)) {
+        ret = WALLY_EINVAL; /* Nothing to recover, or unrecoverable */
+        goto cleanup;
+    }
+
+    if (num_unknown)
+        positions[num_positions++] = unknown_pos;
+    else
+        for (i = 0; i < t.num_words; ++i)
+            positions[num_positions++] = i;
+
+    if (!hashes) {
+        /* Only filter by checksum */
+        recover_checksums(&t, positions, num_positions, candidates_out, len, written);
+        goto cleanup;
+    }
+
+    /* Collect the candidates with valid checksums to match */
+    candidates = wally_malloc(num_positions * BIP39_WORDLIST_LEN * sizeof(uint32_t));
+    if (!candidates) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+    recover_checksums(&t, positions, num_positions, candidates,
+                      num_positions * BIP39_WORDLIST_LEN, &t.num_candidates);
+    *written = 0;
+    if (!t.num_candidates)
+        goto cleanup;
+
+    t.salt_len = BIP39_SALT_PREFIX_LEN + (passphrase ? strlen(passphrase) : 0);
+    sorted = wally_malloc(hashes_len);
+    salt = wally_malloc(t.salt_len);
+    t.matched = wally_malloc(t.num_candidates);
+    if (!sorted || !salt || !t.matched) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+    memcpy(salt, BIP39_SALT_PREFIX, BIP39_SALT_PREFIX_LEN);
+    if (passphrase)
+        memcpy(salt + BIP39_SALT_PREFIX_LEN, passphrase, t.salt_len - BIP39_SALT_PREFIX_LEN);
+    memcpy(sorted, hashes, hashes_len);
+    qsort(sorted, hashes_len / HASH160_LEN, HASH160_LEN, recover_hash_cmp);
+    t.salt = salt;
+    t.child_path = child_path;
+    t.child_path_len = child_path_len;
+    t.hashes = sorted;
+    t.num_hashes = hashes_len / HASH160_LEN;
+    t.script_types = script_types;
+    t.candidates = candidates;
+
+    num_tasks = (t.num_candidates + RECOVER_CHUNK - 1) / RECOVER_CHUNK;
+    wally_run_tasks(run_fn, run_ctx, num_tasks, recover_task, &t);
+
+    for (i = 0; i < t.num_candidates && ret == WALLY_OK; ++i) {
+        if (t.matched[i] == RECOVER_FAILED)
+            ret = WALLY_EINVAL;
+        else if (t.matched[i]) {
+            if (*written < len)
+                candidates_out[*written] = candidates[i];
+            ++*written;
+        }
+    }
+
+cleanup:
+    if (ret != WALLY_OK)
+        *written = 0;
+    if (candidates) {
+        wally_clear(candidates, num_positions * BIP39_WORDLIST_LEN * sizeof(uint32_t));
+        wally_free(candidates);
+    }
+    if (salt) {
+        wally_clear(salt, t.salt_len);
+        wally_free(salt);
+    }
+    wally_free(sorted);
+    wally_free(t.matched);
+    wally_clear(&t, sizeof(t));
     return ret;
 }
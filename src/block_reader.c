@@ -0,0 +1,208 @@
+#include "internal.h"
+
+#include <include/wally_transaction.h>
+
+#include <stdbool.h>
+#include "script_int.h"
+
+/* Each block is preceded by the network magic and its length */
+#define BLOCK_FRAME_LEN 8
+#define BLOCK_XOR_KEY_LEN 8
+
+/* A block must hold at least a header and a transaction count */
+#define BLOCK_MIN_LEN (WALLY_BLOCK_HEADER_LEN + 1)
+
+struct wally_block_reader {
+    wally_read_fn_t read_fn;
+    void *read_ctx;
+    unsigned char magic[4];
+    unsigned char xor_key[BLOCK_XOR_KEY_LEN];
+    bool use_xor;
+    uint64_t stream_offset; /* Number of bytes read from the stream */
+    unsigned char *buf;
+    size_t buf_len;
+    size_t start; /* Start of the unconsumed bytes in buf */
+    size_t end; /* End of the bytes read into buf */
+    bool eof;
+    size_t block_len; /* Length of the last block returned, including framing */
+    struct wally_block_iterator iter;
+    bool have_block;
+};
+
+/* Read into buf until at least n unconsumed bytes are available or the
+ * stream ends, moving the unconsumed bytes to the start of buf if needed */
+static int reader_fill(struct wally_block_reader *r, size_t n)
+{
+    while (r->end - r->start < n && !r->eof) {
+        size_t written = 0, i;
+        int ret;
+
+        if (r->start && r->buf_len - r->start < n) {
+            memmove(r->buf, r->buf + r->start, r->end - r->start);
+            r->end -= r->start;
+            r->start = 0;
+        }
+        ret = r->read_fn(r->read_ctx, r->buf + r->end, r->buf_len - r->end, &written);
+        if (ret != WALLY_OK)
+            return ret;
+        if (written > r->buf_len - r->end)
+            return WALLY_ERROR; /* Callback overran the buffer */
+        if (r->use_xor)
+            for (i = 0; i < written; ++i)
+                r->buf[r->end + i] ^= r->xor_key[(r->stream_offset + i) % BLOCK_XOR_KEY_LEN];
+        r->end += written;
+        r->stream_offset += written;
+        r->eof = !written;
+    }
+    return WALLY_OK;
+}
+
+int wally_block_reader_init_alloc(uint32_t magic,
+                                  const unsigned char *key, size_t key_len,
+                                  size_t max_block_len,
+                                  wally_read_fn_t read_fn, void *read_ctx,
+                                  uint32_t flags,
+                                  struct wally_block_reader **output)
+{
+    struct wally_block_reader *result;
+
+    if (output)
+        *output = NULL;
+
+    if ((key != NULL) != (key_len == BLOCK_XOR_KEY_LEN) ||
+        max_block_len < BLOCK_MIN_LEN ||
+        max_block_len > UINT32_MAX || !read_fn || flags || !output)
+        return WALLY_EINVAL;
+
+    if (!(result = wally_malloc(sizeof(*result))))
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    result->buf_len = max_block_len + BLOCK_FRAME_LEN;
+    if (!(result->buf = wally_malloc(result->buf_len))) {
+        wally_free(result);
+        return WALLY_ENOMEM;
+    }
+    result->read_fn = read_fn;
+    result->read_ctx = read_ctx;
+    uint32_to_le_bytes(magic, result->magic);
+    if (key) {
+        size_t i;
+        memcpy(result->xor_key, key, key_len);
+        for (i = 0; i < key_len; ++i)
+            result->use_xor |= key[i] != 0;
+    }
+    *output = result;
+    return WALLY_OK;
+}
+
+int wally_block_reader_free(struct wally_block_reader *reader)
+{
+    if (reader) {
+        clear_and_free(reader->buf, reader->buf_len);
+        clear_and_free(reader, sizeof(*reader));
+    }
+    return WALLY_OK;
+}
+
+int wally_block_reader_next_block(struct wally_block_reader *reader,
+                                  const unsigned char **block_bytes,
+                                  size_t *block_bytes_len)
+{
+    uint32_t block_len;
+    int ret;
+
+    if (block_bytes)
+        *block_bytes = NULL;
+    if (block_bytes_len)
+        *block_bytes_len = 0;
+
+    if (!reader || !block_bytes || !block_bytes_len)
+        return WALLY_EINVAL;
+
+    /* Consume the previously returned block */
+    reader->start += reader->block_len;
+    reader->block_len = 0;
+    reader->have_block = false;
+
+    /* Skip to the next magic. This passes over the zero padding that
+     * Bitcoin Core preallocates at the end of its block files */
+    for (;;) {
+        const unsigned char *p;
+        size_t avail;
+
+        if ((ret = reader_fill(reader, BLOCK_FRAME_LEN)) != WALLY_OK)
+            return ret;
+        avail = reader->end - reader->start;
+        p = reader->buf + reader->start;
+        if (avail >= sizeof(reader->magic) &&
+            !memcmp(p, reader->magic, sizeof(reader->magic)))
+            break;
+        if (avail < BLOCK_FRAME_LEN && reader->eof) {
+            /* No further block: discard any trailing bytes */
+            reader->start = reader->end;
+            return WALLY_OK;
+        }
+        p = memchr(p + 1, reader->magic[0], avail - 1);
+        reader->start = p ? (size_t)(p - reader->buf) : reader->end;
+    }
+
+    if (reader->end - reader->start < BLOCK_FRAME_LEN)
+        return WALLY_EINVAL; /* Truncated frame */
+    uint32_from_le_bytes(reader->buf + reader->start + 4, &block_len);
+    if (block_len < BLOCK_MIN_LEN || block_len > reader->buf_len - BLOCK_FRAME_LEN)
+        return WALLY_EINVAL; /* Too small, or larger than our buffer */
+
+    if ((ret = reader_fill(reader, BLOCK_FRAME_LEN + block_len)) != WALLY_OK)
+        return ret;
+    if (reader->end - reader->start < BLOCK_FRAME_LEN + block_len)
+        return WALLY_EINVAL; /* Truncated block */
+
+    reader->block_len = BLOCK_FRAME_LEN + block_len;
+    *block_bytes = reader->buf + reader->start + BLOCK_FRAME_LEN;
+    *block_bytes_len = block_len;
+    return WALLY_OK;
+}
+
+int wally_block_reader_next_tx(struct wally_block_reader *reader,
+                               const unsigned char **tx_bytes,
+                               size_t *tx_bytes_len,
+                               unsigned char *bytes_out, size_t len)
+{
+    int ret;
+
+    if (tx_bytes)
+        *tx_bytes = NULL;
+    if (tx_bytes_len)
+        *tx_bytes_len = 0;
+
+    if (!reader || !tx_bytes || !tx_bytes_len ||
+        (bytes_out != NULL) != (len == SHA256_LEN))
+        return WALLY_EINVAL;
+
+    for (;;) {
+        if (reader->block_len && !reader->have_block) {
+            /* Iterate the block last returned by wally_block_reader_next_block */
+            ret = wally_block_iterator_init(reader->buf + reader->start + BLOCK_FRAME_LEN,
+                                            reader->block_len - BLOCK_FRAME_LEN,
+                                            0, &reader->iter);
+            if (ret != WALLY_OK)
+                return ret;
+            reader->have_block = true;
+        }
+        if (reader->have_block) {
+            ret = wally_block_iterator_next(&reader->iter, tx_bytes, tx_bytes_len,
+                                            bytes_out, len);
+            if (ret != WALLY_OK || *tx_bytes)
+                return ret;
+        }
+        /* The current block is exhausted: move to the next */
+        {
+            const unsigned char *block;
+            size_t block_len;
+
+            ret = wally_block_reader_next_block(reader, &block, &block_len);
+            if (ret != WALLY_OK || !block)
+                return ret;
+        }
+    }
+}
@@ -12,6 +12,8 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+/* For the WALLY_CPU_ implementation flags */
+#include <include/wally_core.h>
 
 static void invalidate_ripemd160(struct ripemd160_ctx *ctx)
 {
@@ -48,6 +50,28 @@ void ripemd160_done(struct ripemd160_ctx *ctx, struct ripemd160 *res)
 	RIPEMD160_Final(res->u.u8, &ctx->c);
 	invalidate_ripemd160(ctx);
 }
+
+uint32_t ripemd160_optimize(uint32_t cpu_features UNUSED)
+{
+	return 0;
+}
+
+void ripemd160_32(struct ripemd160 *ripemd, const void *p)
+{
+	ripemd160(ripemd, p, 32);
+}
+
+void ripemd160_32_batch(struct ripemd160 *ripemd, const void *p, size_t n)
+{
+	struct ripemd160 tmp;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		ripemd160(&tmp, (const unsigned char *)p + i * 32, 32);
+		ripemd[i] = tmp;
+	}
+	CCAN_CLEAR_MEMORY(&tmp, sizeof(tmp));
+}
 #else
 inline static uint32_t f1(uint32_t x, uint32_t y, uint32_t z) { return x ^ y ^ z; }
 inline static uint32_t f2(uint32_t x, uint32_t y, uint32_t z) { return (x & y) | (~x & z); }
@@ -269,6 +293,28 @@ static void Transform(uint32_t *s, const uint32_t *chunk)
     s[4] = t + b1 + c2;
 }
 
+#if defined(__x86_64__) || defined(__amd64__)
+#include "ripemd160_avx2.c"
+#endif
+
+#ifdef HAVE_RIPEMD160_AVX2
+static bool use_avx2_batch = false;
+#endif
+
+uint32_t ripemd160_optimize(uint32_t cpu_features)
+{
+	uint32_t selected = 0;
+#ifdef HAVE_RIPEMD160_AVX2
+	if (cpu_features & WALLY_CPU_RIPEMD160_AVX2) {
+		use_avx2_batch = true; /* AVX2 is available */
+		selected = WALLY_CPU_RIPEMD160_AVX2;
+	}
+#else
+	(void)cpu_features;
+#endif
+	return selected;
+}
+
 static void add(struct ripemd160_ctx *ctx, const void *p, size_t len)
 {
 	const unsigned char *data = p;
@@ -331,6 +377,42 @@ void ripemd160_done(struct ripemd160_ctx *ctx, struct ripemd160 *res)
 		res->u.u32[i] = cpu_to_le32(ctx->s[i]);
 	invalidate_ripemd160(ctx);
 }
+
+void ripemd160_32(struct ripemd160 *ripemd, const void *p)
+{
+	/* A 32 byte message is a single block with fixed padding */
+	union {
+		uint32_t u32[16];
+		unsigned char u8[64];
+	} block;
+	uint32_t s[5];
+	size_t i;
+
+	memcpy(block.u8, p, 32);
+	memset(block.u8 + 32, 0, sizeof(block) - 32);
+	block.u8[32] = 0x80;
+	block.u8[57] = 1; /* Length: 256 bits, little endian */
+	Initialize(s);
+	Transform(s, block.u32);
+	for (i = 0; i < 5; i++)
+		ripemd->u.u32[i] = cpu_to_le32(s[i]);
+	CCAN_CLEAR_MEMORY(&block, sizeof(block));
+	CCAN_CLEAR_MEMORY(s, sizeof(s));
+}
+
+void ripemd160_32_batch(struct ripemd160 *ripemd, const void *p, size_t n)
+{
+	const unsigned char *data = p;
+	size_t i = 0;
+
+#ifdef HAVE_RIPEMD160_AVX2
+	if (use_avx2_batch)
+		for (; i + 8 <= n; i += 8)
+			ripemd160_32_8way_avx2(ripemd + i, data + i * 32);
+#endif
+	for (; i < n; i++)
+		ripemd160_32(ripemd + i, data + i * 32);
+}
 #endif
 
 void ripemd160(struct ripemd160 *ripemd, const void *p, size_t size)
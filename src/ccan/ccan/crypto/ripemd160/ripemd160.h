@@ -39,6 +39,37 @@ struct ripemd160 {
  */
 void ripemd160(struct ripemd160 *ripemd, const void *p, size_t size);
 
+/**
+ * ripemd160_optimize - enable optimised functionality if possible.
+ * @cpu_features: the WALLY_CPU_ implementations the current CPU can run.
+ *
+ * Returns the WALLY_CPU_RIPEMD160_ implementations selected.
+ */
+uint32_t ripemd160_optimize(uint32_t cpu_features);
+
+/**
+ * ripemd160_32 - return ripemd160 of a 32 byte object.
+ * @ripemd160: the ripemd160 to fill in
+ * @p: pointer to 32 bytes of memory, e.g. a SHA256 digest
+ *
+ * Equivalent to ripemd160(@ripemd160, @p, 32), but hashes the single
+ * padded block directly.
+ */
+void ripemd160_32(struct ripemd160 *ripemd, const void *p);
+
+/**
+ * ripemd160_32_batch - return the ripemd160 of each of @n 32 byte objects.
+ * @ripemd160: array of @n ripemd160s to fill in
+ * @p: pointer to @n objects of 32 bytes each, stored contiguously
+ * @n: the number of objects
+ *
+ * Equivalent to calling ripemd160_32() for each object in turn, but
+ * hashes several objects at once where the CPU supports it. Each group
+ * of objects is read in full before its results are written, so
+ * @ripemd160 may point to @p itself.
+ */
+void ripemd160_32_batch(struct ripemd160 *ripemd, const void *p, size_t n);
+
 /**
  * struct ripemd160_ctx - structure to store running context for ripemd160
  */
@@ -0,0 +1,161 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* 8-way RIPEMD160 using AVX2, hashing eight 32 byte messages at once.
+ *
+ * Each lane holds one message, so the rounds are those of Transform()
+ * with every 32 bit operation applied to eight words. Only the single,
+ * pre-padded block of a 32 byte message (e.g. a SHA256 digest, as when
+ * computing hash160) is supported. This file is included from
+ * ripemd160.c after Transform().
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#include <immintrin.h>
+#define HAVE_RIPEMD160_AVX2 1
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+/* Message word and rotate amount for each round of the left and right lines */
+static const unsigned char RMD_AVX2_WL[80] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+	3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+	1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+	4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13
+};
+static const unsigned char RMD_AVX2_WR[80] = {
+	5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+	6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+	15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+	8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+	12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11
+};
+static const unsigned char RMD_AVX2_RL[80] = {
+	11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+	7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+	11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+	11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+	9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6
+};
+static const unsigned char RMD_AVX2_RR[80] = {
+	8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+	9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+	9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+	15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+	8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11
+};
+static const uint32_t RMD_AVX2_KL[5] = {
+	0, 0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xA953FD4Eul
+};
+static const uint32_t RMD_AVX2_KR[5] = {
+	0x50A28BE6ul, 0x5C4DD124ul, 0x6D703EF3ul, 0x7A6D76E9ul, 0
+};
+
+#define AVX2_ROL(x, n) _mm256_or_si256(_mm256_sll_epi32(x, _mm_cvtsi32_si128(n)), \
+				       _mm256_srl_epi32(x, _mm_cvtsi32_si128(32 - (n))))
+#define AVX2_ROL10(x) _mm256_or_si256(_mm256_slli_epi32(x, 10), _mm256_srli_epi32(x, 22))
+#define AVX2_ADD3(x, y, z) _mm256_add_epi32(_mm256_add_epi32(x, y), z)
+
+/* The five boolean functions f1..f5 of Transform() */
+AVX2_TARGET
+static inline __m256i avx2_rmd_f(int j, __m256i x, __m256i y, __m256i z)
+{
+	const __m256i ones = _mm256_set1_epi32(-1);
+
+	switch (j) {
+	case 0:
+		return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+	case 1:
+		return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z));
+	case 2:
+		return _mm256_xor_si256(_mm256_or_si256(x, _mm256_xor_si256(y, ones)), z);
+	case 3:
+		return _mm256_or_si256(_mm256_and_si256(x, z), _mm256_andnot_si256(z, y));
+	}
+	return _mm256_xor_si256(x, _mm256_or_si256(y, _mm256_xor_si256(z, ones)));
+}
+
+/* One RIPEMD160 compression of the message words w into the state s */
+AVX2_TARGET
+static void avx2_rmd_transform(__m256i *s, const __m256i *w)
+{
+	__m256i a1 = s[0], b1 = s[1], c1 = s[2], d1 = s[3], e1 = s[4];
+	__m256i a2 = a1, b2 = b1, c2 = c1, d2 = d1, e2 = e1, t;
+	size_t i;
+
+	for (i = 0; i < 80; i++) {
+		const int j = (int)(i / 16);
+
+		t = AVX2_ADD3(a1, avx2_rmd_f(j, b1, c1, d1), w[RMD_AVX2_WL[i]]);
+		t = _mm256_add_epi32(t, _mm256_set1_epi32((int)RMD_AVX2_KL[j]));
+		t = _mm256_add_epi32(AVX2_ROL(t, RMD_AVX2_RL[i]), e1);
+		a1 = e1;
+		e1 = d1;
+		d1 = AVX2_ROL10(c1);
+		c1 = b1;
+		b1 = t;
+
+		t = AVX2_ADD3(a2, avx2_rmd_f(4 - j, b2, c2, d2), w[RMD_AVX2_WR[i]]);
+		t = _mm256_add_epi32(t, _mm256_set1_epi32((int)RMD_AVX2_KR[j]));
+		t = _mm256_add_epi32(AVX2_ROL(t, RMD_AVX2_RR[i]), e2);
+		a2 = e2;
+		e2 = d2;
+		d2 = AVX2_ROL10(c2);
+		c2 = b2;
+		b2 = t;
+	}
+
+	t = s[0];
+	s[0] = AVX2_ADD3(s[1], c1, d2);
+	s[1] = AVX2_ADD3(s[2], d1, e2);
+	s[2] = AVX2_ADD3(s[3], e1, a2);
+	s[3] = AVX2_ADD3(s[4], a1, b2);
+	s[4] = AVX2_ADD3(t, b1, c2);
+}
+
+/* Hash the eight contiguous 32 byte messages at p into ripemd[0..7] */
+AVX2_TARGET
+static void ripemd160_32_8way_avx2(struct ripemd160 *ripemd, const unsigned char *p)
+{
+	uint32_t words[8][8], out[5][8];
+	__m256i s[5], w[16];
+	size_t i, j;
+
+	/* Transpose the messages so that each vector holds one word of each */
+	for (j = 0; j < 8; j++) {
+		for (i = 0; i < 8; i++) {
+			memcpy(&words[i][j], p + j * 32 + i * 4, sizeof(uint32_t));
+			words[i][j] = le32_to_cpu(words[i][j]);
+		}
+	}
+	for (i = 0; i < 8; i++)
+		w[i] = _mm256_loadu_si256((const __m256i *)words[i]);
+	/* The fixed padding of a 32 byte message */
+	w[8] = _mm256_set1_epi32(0x80);
+	for (i = 9; i < 16; i++)
+		w[i] = _mm256_setzero_si256();
+	w[14] = _mm256_set1_epi32(32 << 3);
+
+	s[0] = _mm256_set1_epi32(0x67452301ul);
+	s[1] = _mm256_set1_epi32((int)0xEFCDAB89ul);
+	s[2] = _mm256_set1_epi32((int)0x98BADCFEul);
+	s[3] = _mm256_set1_epi32(0x10325476ul);
+	s[4] = _mm256_set1_epi32((int)0xC3D2E1F0ul);
+	avx2_rmd_transform(s, w);
+
+	/* Read all input before writing: ripemd may overlap p */
+	for (i = 0; i < 5; i++)
+		_mm256_storeu_si256((__m256i *)out[i], s[i]);
+	for (j = 0; j < 8; j++)
+		for (i = 0; i < 5; i++)
+			ripemd[j].u.u32[i] = cpu_to_le32(out[i][j]);
+
+	CCAN_CLEAR_MEMORY(words, sizeof(words));
+	CCAN_CLEAR_MEMORY(out, sizeof(out));
+	CCAN_CLEAR_MEMORY(s, sizeof(s));
+	CCAN_CLEAR_MEMORY(w, sizeof(w));
+}
+#endif
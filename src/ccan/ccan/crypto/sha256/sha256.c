@@ -12,6 +12,16 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+/* For the WALLY_CPU_ implementation flags */
+#include <include/wally_core.h>
+
+#ifdef WALLY_ENABLE_STATS
+/* Count compressions in wally's statistics, see src/internal.h */
+void wally_stats_add(uint32_t stat, uint64_t n);
+#define SHA256_STATS_ADD(blocks) wally_stats_add(WALLY_STAT_SHA256_BLOCKS, blocks)
+#else
+#define SHA256_STATS_ADD(blocks)
+#endif
 
 #ifdef CCAN_CRYPTO_SHA256_USE_OPENSSL
 static void invalidate_sha256(struct sha256_ctx *ctx)
@@ -40,6 +50,15 @@ void sha256_done(struct sha256_ctx *ctx, struct sha256 *res)
 	SHA256_Final(res->u.u8, &ctx->c);
 	invalidate_sha256(ctx);
 }
+
+void sha256d_64(struct sha256 *sha, const void *p)
+{
+	struct sha256 tmp;
+
+	sha256(&tmp, p, 64);
+	sha256(sha, &tmp, sizeof(tmp));
+	CCAN_CLEAR_MEMORY(&tmp, sizeof(tmp));
+}
 #else
 static void invalidate_sha256(struct sha256_ctx *ctx)
 {
@@ -173,20 +192,45 @@ static void TransformDefault(uint32_t *s, const uint32_t *chunk, size_t blocks)
 }
 
 #if defined(__x86_64__) || defined(__amd64__)
-#include <cpuid.h>
-
 #include "sha256_sse4.c"
+#include "sha256_shani.c"
+#include "sha256_avx2.c"
+
+#define TRANSFORM_SSE4 1
+#define TRANSFORM_SHANI 2
+static int use_optimized_transform = 0;
+#ifdef HAVE_SHA256_AVX2
+static bool use_avx2_batch = false;
+#endif
+#elif defined(__aarch64__) && defined(WALLY_ARM_KERNELS)
+#include "sha256_armv8.c"
 
+#define TRANSFORM_ARMV8 1
 static int use_optimized_transform = 0;
+#elif defined(__wasm_simd128__)
+/* SIMD128 is enabled at compile time, so the 4-way batch is always used */
+#include "sha256_simd128.c"
 #endif
 
 static inline void Transform(uint32_t *s, const uint32_t *chunk, size_t blocks)
 {
+	SHA256_STATS_ADD(blocks);
 #if defined(__x86_64__) || defined(__amd64__)
-	if (use_optimized_transform) {
+#ifdef HAVE_SHA256_SHANI
+	if (use_optimized_transform == TRANSFORM_SHANI) {
+		TransformSHANI(s, chunk, blocks);
+		return;
+	}
+#endif
+	if (use_optimized_transform == TRANSFORM_SSE4) {
 		TransformSSE4(s, chunk, blocks);
 		return;
 	}
+#elif defined(HAVE_SHA256_ARMV8)
+	if (use_optimized_transform == TRANSFORM_ARMV8) {
+		TransformARMV8(s, chunk, blocks);
+		return;
+	}
 #endif
 	TransformDefault(s, chunk, blocks);
 }
@@ -230,20 +274,40 @@ static void add(struct sha256_ctx *ctx, const void *p, size_t len)
 	}
 }
 
-void sha256_optimize(void)
+uint32_t sha256_optimize(uint32_t cpu_features)
 {
+	uint32_t selected = 0;
 #if defined(__x86_64__) || defined(__amd64__)
-	uint32_t leaf = 1, subleaf = 0;
-	uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
-#ifdef __GNUC__
-	__cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
-#else
-	__asm__ ("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "0"(leaf), "2"(subleaf));
+	if (cpu_features & WALLY_CPU_SHA256_SSE4) {
+		use_optimized_transform = TRANSFORM_SSE4; /* SSE4 is available */
+		selected = WALLY_CPU_SHA256_SSE4;
+	}
+#ifdef HAVE_SHA256_SHANI
+	if (cpu_features & WALLY_CPU_SHA256_SHANI) {
+		use_optimized_transform = TRANSFORM_SHANI; /* SHA-NI is available */
+		selected = WALLY_CPU_SHA256_SHANI;
+	}
 #endif
-	if ((ecx >> 19) & 1) {
-		use_optimized_transform = 1; /* SSE4 is available */
+#ifdef HAVE_SHA256_AVX2
+	/* Single stream SHA-NI is faster than 8-way AVX2 */
+	if (use_optimized_transform != TRANSFORM_SHANI &&
+	    (cpu_features & WALLY_CPU_SHA256_AVX2)) {
+		use_avx2_batch = true; /* AVX2 is available */
+		selected |= WALLY_CPU_SHA256_AVX2;
 	}
 #endif
+#elif defined(HAVE_SHA256_ARMV8)
+	if (cpu_features & WALLY_CPU_SHA256_ARMV8) {
+		use_optimized_transform = TRANSFORM_ARMV8; /* ARMv8 SHA2 is available */
+		selected = WALLY_CPU_SHA256_ARMV8;
+	}
+#elif defined(HAVE_SHA256_SIMD128)
+	(void)cpu_features;
+	selected = WALLY_CPU_SHA256_SIMD128;
+#else
+	(void)cpu_features;
+#endif
+	return selected;
 }
 
 void sha256_init(struct sha256_ctx *ctx)
@@ -273,6 +337,49 @@ void sha256_done(struct sha256_ctx *ctx, struct sha256 *res)
 		res->u.u32[i] = cpu_to_be32(ctx->s[i]);
 	invalidate_sha256(ctx);
 }
+
+void sha256d_64(struct sha256 *sha, const void *p)
+{
+	/* Padding block for a 64 byte message: '1' bit then length 512 bits */
+	static const union {
+		unsigned char u8[64];
+		uint32_t u32[16];
+	} pad64 = { {
+		0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0
+	} };
+	struct sha256_ctx ctx = SHA256_INIT;
+	union {
+		uint32_t u32[16];
+		unsigned char u8[64];
+	} block;
+	size_t i;
+
+	/* First hash: the data block followed by the fixed padding block */
+	if (alignment_ok(p, sizeof(uint32_t)))
+		Transform(ctx.s, (const uint32_t *)p, 1);
+	else {
+		memcpy(block.u8, p, sizeof(block));
+		Transform(ctx.s, block.u32, 1);
+	}
+	Transform(ctx.s, pad64.u32, 1);
+
+	/* Second hash: a single block holding the 32 byte digest and its
+	 * padding, with length 256 bits */
+	memset(&block, 0, sizeof(block));
+	for (i = 0; i < 8; i++)
+		block.u32[i] = cpu_to_be32(ctx.s[i]);
+	block.u8[32] = 0x80;
+	block.u8[62] = 0x01;
+	sha256_init(&ctx);
+	Transform(ctx.s, block.u32, 1);
+	for (i = 0; i < 8; i++)
+		sha->u.u32[i] = cpu_to_be32(ctx.s[i]);
+	CCAN_CLEAR_MEMORY(&ctx, sizeof(ctx));
+	CCAN_CLEAR_MEMORY(&block, sizeof(block));
+}
 #endif
 
 void sha256(struct sha256 *sha, const void *p, size_t size)
@@ -285,6 +392,103 @@ void sha256(struct sha256 *sha, const void *p, size_t size)
 	CCAN_CLEAR_MEMORY(&ctx, sizeof(ctx));
 }
 	
+/* Hash each object continuing from ctxs[i * ctx_stride], or from the
+ * initial state if ctxs is NULL */
+static void sha256_batch_impl(struct sha256 *sha, const struct sha256_ctx *ctxs,
+			      size_t ctx_stride, const void *p, size_t item_len,
+			      size_t n, bool dbl)
+{
+	const unsigned char *data = p;
+	const bool from_init = ctxs == NULL;
+	struct sha256_ctx init, tmp_ctx;
+	struct sha256 tmp;
+	size_t i = 0;
+
+	if (from_init) {
+		sha256_init(&init);
+		ctxs = &init;
+		ctx_stride = 0;
+	}
+	while (i < n) {
+#ifdef HAVE_SHA256_AVX2
+		if (use_avx2_batch && i + 8 <= n) {
+			const struct sha256_ctx *lane_ctxs[8];
+			const unsigned char *msgs[8];
+			size_t j;
+
+			for (j = 0; j < 8; j++) {
+				lane_ctxs[j] = ctxs + (i + j) * ctx_stride;
+				msgs[j] = data + (i + j) * item_len;
+				if (lane_ctxs[j]->bytes % 64)
+					break; /* Midstate required for each lane */
+			}
+			if (j == 8) {
+				sha256_8way_avx2(sha + i, lane_ctxs, msgs, item_len, dbl);
+				SHA256_STATS_ADD(8 * ((item_len + 9 + 63) / 64 + (dbl ? 1 : 0)));
+				i += 8;
+				continue;
+			}
+		}
+#endif
+#ifdef HAVE_SHA256_SIMD128
+		if (i + 4 <= n) {
+			const struct sha256_ctx *lane_ctxs[4];
+			const unsigned char *msgs[4];
+			size_t j;
+
+			for (j = 0; j < 4; j++) {
+				lane_ctxs[j] = ctxs + (i + j) * ctx_stride;
+				msgs[j] = data + (i + j) * item_len;
+				if (lane_ctxs[j]->bytes % 64)
+					break; /* Midstate required for each lane */
+			}
+			if (j == 4) {
+				sha256_4way_simd128(sha + i, lane_ctxs, msgs, item_len, dbl);
+				SHA256_STATS_ADD(4 * ((item_len + 9 + 63) / 64 + (dbl ? 1 : 0)));
+				i += 4;
+				continue;
+			}
+		}
+#endif
+		if (dbl && from_init && item_len == 64)
+			sha256d_64(sha + i, data + i * item_len);
+		else {
+			tmp_ctx = ctxs[i * ctx_stride];
+			sha256_update(&tmp_ctx, data + i * item_len, item_len);
+			if (dbl) {
+				sha256_done(&tmp_ctx, &tmp);
+				sha256(sha + i, &tmp, sizeof(tmp));
+			} else
+				sha256_done(&tmp_ctx, sha + i);
+		}
+		i++;
+	}
+	CCAN_CLEAR_MEMORY(&tmp_ctx, sizeof(tmp_ctx));
+	CCAN_CLEAR_MEMORY(&tmp, sizeof(tmp));
+}
+
+void sha256_batch(struct sha256 *sha, const void *p, size_t item_len, size_t n)
+{
+	sha256_batch_impl(sha, NULL, 0, p, item_len, n, false);
+}
+
+void sha256d_batch(struct sha256 *sha, const void *p, size_t item_len, size_t n)
+{
+	sha256_batch_impl(sha, NULL, 0, p, item_len, n, true);
+}
+
+void sha256_batch_from(struct sha256 *sha, const struct sha256_ctx *ctx,
+		       const void *p, size_t item_len, size_t n)
+{
+	sha256_batch_impl(sha, ctx, 0, p, item_len, n, false);
+}
+
+void sha256_batch_from_each(struct sha256 *sha, const struct sha256_ctx *ctxs,
+			    const void *p, size_t item_len, size_t n)
+{
+	sha256_batch_impl(sha, ctxs, 1, p, item_len, n, false);
+}
+
 void sha256_u8(struct sha256_ctx *ctx, uint8_t v)
 {
 	sha256_update(ctx, &v, sizeof(v));
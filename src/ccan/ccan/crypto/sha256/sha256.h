@@ -27,9 +27,23 @@ struct sha256 {
 };
 
 /**
- * sha256_optimize - check for and enable optimised functionality if possible.
+ * sha256_optimize - enable optimised functionality if possible.
+ * @cpu_features: the WALLY_CPU_ implementations the current CPU can run.
+ *
+ * Returns the WALLY_CPU_SHA256_ implementations selected.
+ */
+uint32_t sha256_optimize(uint32_t cpu_features);
+
+/**
+ * sha256d_64 - return the double sha256 of a 64 byte object.
+ * @sha256: the sha256 to fill in
+ * @p: pointer to 64 bytes of memory
+ *
+ * This is equivalent to sha256() of the result of sha256() of @p, but
+ * avoids buffering by hashing fixed, pre-padded blocks directly. Used
+ * for hashing merkle tree nodes.
  */
-void sha256_optimize(void);
+void sha256d_64(struct sha256 *sha, const void *p);
 
 /**
  * sha256 - return sha256 of an object.
@@ -58,6 +72,33 @@ struct sha256_ctx {
 #endif
 };
 
+/**
+ * sha256_batch - return the sha256 of each of @n equal length objects.
+ * @sha: array of @n sha256s to fill in
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * Equivalent to calling sha256() for each object in turn, but hashes
+ * several objects at once where the CPU supports it. Each group of
+ * objects is read in full before its results are written, so when
+ * @item_len is at least 32 bytes @sha may point to @p itself, allowing
+ * a level of a merkle tree to be hashed in place.
+ */
+void sha256_batch(struct sha256 *sha, const void *p, size_t item_len, size_t n);
+
+/**
+ * sha256d_batch - return the double sha256 of each of @n equal length objects.
+ * @sha: array of @n sha256s to fill in
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * As sha256_batch(), but each result is the sha256 of the sha256 of
+ * its object.
+ */
+void sha256d_batch(struct sha256 *sha, const void *p, size_t item_len, size_t n);
+
 /**
  * sha256_init - initialize an SHA256 context.
  * @ctx: the sha256_ctx to initialize
@@ -134,6 +175,34 @@ void sha256_update(struct sha256_ctx *ctx, const void *p, size_t size);
  */
 void sha256_done(struct sha256_ctx *sha256, struct sha256 *res);
 
+/**
+ * sha256_batch_from - finish the sha256 of @n objects from a common prefix.
+ * @sha: array of @n sha256s to fill in
+ * @ctx: the SHA256 context holding the prefix, which is not modified
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * Equivalent to sha256_update() then sha256_done() on a copy of @ctx for
+ * each object. As for sha256_batch(), several objects are hashed at once
+ * where possible, which requires the prefix to be a multiple of 64 bytes.
+ */
+void sha256_batch_from(struct sha256 *sha, const struct sha256_ctx *ctx,
+		       const void *p, size_t item_len, size_t n);
+
+/**
+ * sha256_batch_from_each - finish the sha256 of @n objects from their own prefixes.
+ * @sha: array of @n sha256s to fill in
+ * @ctxs: array of @n SHA256 contexts holding each prefix, which are not modified
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * As sha256_batch_from(), but each object continues from its own context.
+ */
+void sha256_batch_from_each(struct sha256 *sha, const struct sha256_ctx *ctxs,
+			    const void *p, size_t item_len, size_t n);
+
 /* Add various types to an SHA256 hash */
 void sha256_u8(struct sha256_ctx *ctx, uint8_t v);
 void sha256_u16(struct sha256_ctx *ctx, uint16_t v);
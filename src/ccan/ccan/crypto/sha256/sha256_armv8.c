@@ -0,0 +1,107 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* SHA256 transform using the ARMv8 cryptography extensions.
+ *
+ * Based on https://github.com/noloader/SHA-Intrinsics/blob/master/sha256-arm.c,
+ * Written and placed in public domain by Jeffrey Walton.
+ * Based on code from ARM, and by Johannes Schneiders, Skip Hovsmith and
+ * Barry O'Rourke for the mbedTLS project.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && defined(__aarch64__) && defined(WALLY_ARM_KERNELS)
+#include <arm_neon.h>
+#define HAVE_SHA256_ARMV8 1
+
+#if defined(__clang__)
+#define ARMV8_SHA256_TARGET __attribute__((target("crypto")))
+#else
+#define ARMV8_SHA256_TARGET __attribute__((target("+crypto")))
+#endif
+
+/* Perform four rounds using the message words in m plus the constants at k */
+#define ARMV8_SHA256_QUAD(k, m) do { \
+	const uint32x4_t wk_ = vaddq_u32(m, vld1q_u32(K256_ARMV8 + (k))); \
+	const uint32x4_t abcd_ = state0; \
+	state0 = vsha256hq_u32(state0, state1, wk_); \
+	state1 = vsha256h2q_u32(state1, abcd_, wk_); \
+	} while (0)
+
+/* As above, also computing the next four message words into m0 */
+#define ARMV8_SHA256_QUAD_SCHEDULE(k, m0, m1, m2, m3) do { \
+	ARMV8_SHA256_QUAD(k, m0); \
+	m0 = vsha256su1q_u32(vsha256su0q_u32(m0, m1), m2, m3); \
+	} while (0)
+
+static const uint32_t K256_ARMV8[] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+ARMV8_SHA256_TARGET
+static void TransformARMV8(uint32_t *s, const uint32_t *chunk, size_t blocks)
+{
+	const uint8_t *p = (const uint8_t *)chunk;
+	uint32x4_t state0, state1, abcd_save, efgh_save, m0, m1, m2, m3;
+
+	/* Load state */
+	state0 = vld1q_u32(s);
+	state1 = vld1q_u32(s + 4);
+
+	while (blocks--) {
+		/* Remember old state */
+		abcd_save = state0;
+		efgh_save = state1;
+
+		/* Load data, converting it from big-endian */
+		m0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+		m1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16)));
+		m2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 32)));
+		m3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 48)));
+
+		/* Transform */
+		ARMV8_SHA256_QUAD_SCHEDULE(0, m0, m1, m2, m3);
+		ARMV8_SHA256_QUAD_SCHEDULE(4, m1, m2, m3, m0);
+		ARMV8_SHA256_QUAD_SCHEDULE(8, m2, m3, m0, m1);
+		ARMV8_SHA256_QUAD_SCHEDULE(12, m3, m0, m1, m2);
+		ARMV8_SHA256_QUAD_SCHEDULE(16, m0, m1, m2, m3);
+		ARMV8_SHA256_QUAD_SCHEDULE(20, m1, m2, m3, m0);
+		ARMV8_SHA256_QUAD_SCHEDULE(24, m2, m3, m0, m1);
+		ARMV8_SHA256_QUAD_SCHEDULE(28, m3, m0, m1, m2);
+		ARMV8_SHA256_QUAD_SCHEDULE(32, m0, m1, m2, m3);
+		ARMV8_SHA256_QUAD_SCHEDULE(36, m1, m2, m3, m0);
+		ARMV8_SHA256_QUAD_SCHEDULE(40, m2, m3, m0, m1);
+		ARMV8_SHA256_QUAD_SCHEDULE(44, m3, m0, m1, m2);
+		ARMV8_SHA256_QUAD(48, m0);
+		ARMV8_SHA256_QUAD(52, m1);
+		ARMV8_SHA256_QUAD(56, m2);
+		ARMV8_SHA256_QUAD(60, m3);
+
+		/* Combine with old state */
+		state0 = vaddq_u32(state0, abcd_save);
+		state1 = vaddq_u32(state1, efgh_save);
+
+		/* Advance */
+		p += 64;
+	}
+
+	/* Store state */
+	vst1q_u32(s, state0);
+	vst1q_u32(s + 4, state1);
+}
+#endif
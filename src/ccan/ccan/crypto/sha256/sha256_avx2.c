@@ -0,0 +1,170 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* 8-way SHA256 using AVX2, hashing eight equal length messages at once.
+ *
+ * The round functions follow Bitcoin Core's src/crypto/sha256_avx2.cpp,
+ * generalised from 64 byte inputs to any message length.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#include <immintrin.h>
+#define HAVE_SHA256_AVX2 1
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+static const uint32_t K256_AVX2[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define AVX2_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define AVX2_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define AVX2_ADD3(x, y, z) _mm256_add_epi32(_mm256_add_epi32(x, y), z)
+
+AVX2_TARGET
+static inline __m256i avx2_load_be32(const unsigned char *const *lanes, size_t offset)
+{
+	uint32_t v[8];
+	size_t i;
+
+	for (i = 0; i < 8; i++) {
+		memcpy(&v[i], lanes[i] + offset, sizeof(v[i]));
+		v[i] = be32_to_cpu(v[i]);
+	}
+	return _mm256_loadu_si256((const __m256i *)v);
+}
+
+/* One SHA256 compression of the message schedule in w into the state s */
+AVX2_TARGET
+static void avx2_transform(__m256i *s, __m256i *w)
+{
+	__m256i a = s[0], b = s[1], c = s[2], d = s[3];
+	__m256i e = s[4], f = s[5], g = s[6], h = s[7];
+	size_t i;
+
+	for (i = 0; i < 64; i++) {
+		__m256i t1, t2;
+
+		if (i >= 16) {
+			const __m256i w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];
+			const __m256i s1 = AVX2_XOR3(AVX2_ROR(w2, 17), AVX2_ROR(w2, 19), _mm256_srli_epi32(w2, 10));
+			const __m256i s0 = AVX2_XOR3(AVX2_ROR(w15, 7), AVX2_ROR(w15, 18), _mm256_srli_epi32(w15, 3));
+			w[i & 15] = _mm256_add_epi32(AVX2_ADD3(w[i & 15], s1, w[(i - 7) & 15]), s0);
+		}
+		t1 = AVX2_ADD3(h, AVX2_XOR3(AVX2_ROR(e, 6), AVX2_ROR(e, 11), AVX2_ROR(e, 25)),
+			       _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g))));
+		t1 = AVX2_ADD3(t1, _mm256_set1_epi32(K256_AVX2[i]), w[i & 15]);
+		t2 = _mm256_add_epi32(AVX2_XOR3(AVX2_ROR(a, 2), AVX2_ROR(a, 13), AVX2_ROR(a, 22)),
+				      _mm256_or_si256(_mm256_and_si256(a, b),
+						      _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, t2);
+	}
+
+	s[0] = _mm256_add_epi32(s[0], a);
+	s[1] = _mm256_add_epi32(s[1], b);
+	s[2] = _mm256_add_epi32(s[2], c);
+	s[3] = _mm256_add_epi32(s[3], d);
+	s[4] = _mm256_add_epi32(s[4], e);
+	s[5] = _mm256_add_epi32(s[5], f);
+	s[6] = _mm256_add_epi32(s[6], g);
+	s[7] = _mm256_add_epi32(s[7], h);
+}
+
+AVX2_TARGET
+static void avx2_init(__m256i *s)
+{
+	s[0] = _mm256_set1_epi32(0x6a09e667);
+	s[1] = _mm256_set1_epi32(0xbb67ae85);
+	s[2] = _mm256_set1_epi32(0x3c6ef372);
+	s[3] = _mm256_set1_epi32(0xa54ff53a);
+	s[4] = _mm256_set1_epi32(0x510e527f);
+	s[5] = _mm256_set1_epi32(0x9b05688c);
+	s[6] = _mm256_set1_epi32(0x1f83d9ab);
+	s[7] = _mm256_set1_epi32(0x5be0cd19);
+}
+
+/* Hash (or double hash) the eight len byte messages msgs into sha[0..7].
+ * Each message is hashed continuing from the corresponding context in
+ * ctxs, which must have processed a multiple of the block size */
+AVX2_TARGET
+static void sha256_8way_avx2(struct sha256 *sha, const struct sha256_ctx *const *ctxs,
+			     const unsigned char *const *msgs, size_t len, bool dbl)
+{
+	unsigned char tail[8][128];
+	const unsigned char *lanes[8];
+	const size_t full = len / 64, rem = len % 64;
+	const size_t tail_len = rem + 9 > 64 ? 128 : 64;
+	__m256i s[8], w[16];
+	uint32_t out[8][8];
+	size_t i, j;
+
+	/* Build the padded final block(s) of each message */
+	for (i = 0; i < 8; i++) {
+		const uint64_t bits = cpu_to_be64(((uint64_t)ctxs[i]->bytes + len) << 3);
+		memcpy(tail[i], msgs[i] + full * 64, rem);
+		tail[i][rem] = 0x80;
+		memset(tail[i] + rem + 1, 0, tail_len - rem - 1 - 8);
+		memcpy(tail[i] + tail_len - 8, &bits, 8);
+	}
+
+	for (i = 0; i < 8; i++) {
+		for (j = 0; j < 8; j++)
+			out[i][j] = ctxs[j]->s[i];
+		s[i] = _mm256_loadu_si256((const __m256i *)out[i]);
+	}
+	for (j = 0; j < full + tail_len / 64; j++) {
+		for (i = 0; i < 8; i++)
+			lanes[i] = j < full ? msgs[i] + j * 64 : tail[i] + (j - full) * 64;
+		for (i = 0; i < 16; i++)
+			w[i] = avx2_load_be32(lanes, i * 4);
+		avx2_transform(s, w);
+	}
+
+	if (dbl) {
+		/* Hash the 32 byte digests: a single pre-padded block */
+		for (i = 0; i < 8; i++)
+			w[i] = s[i];
+		w[8] = _mm256_set1_epi32(0x80000000);
+		for (i = 9; i < 15; i++)
+			w[i] = _mm256_setzero_si256();
+		w[15] = _mm256_set1_epi32(256);
+		avx2_init(s);
+		avx2_transform(s, w);
+	}
+
+	for (i = 0; i < 8; i++)
+		_mm256_storeu_si256((__m256i *)out[i], s[i]);
+	for (i = 0; i < 8; i++)
+		for (j = 0; j < 8; j++)
+			sha[i].u.u32[j] = cpu_to_be32(out[j][i]);
+
+	CCAN_CLEAR_MEMORY(tail, sizeof(tail));
+	CCAN_CLEAR_MEMORY(out, sizeof(out));
+	CCAN_CLEAR_MEMORY(s, sizeof(s));
+	CCAN_CLEAR_MEMORY(w, sizeof(w));
+}
+#endif
@@ -0,0 +1,111 @@
+/* Copyright (c) 2018 The Bitcoin Core developers
+ * Distributed under the MIT software license, see the accompanying
+ * file COPYING or http://www.opensource.org/licenses/mit-license.php.
+ *
+ * (translated to c from Bitcoin Cores src/crypto/sha256_shani.cpp).
+ * Based on https://github.com/noloader/SHA-Intrinsics/blob/master/sha256-x86.c,
+ * Written and placed in public domain by Jeffrey Walton.
+ * Based on code from Intel, and by Sean Gulley for the miTLS project.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#include <immintrin.h>
+#define HAVE_SHA256_SHANI 1
+
+#define SHANI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+/* Load 16 message bytes, converting them from big-endian */
+#define SHANI_LOAD(p) \
+	_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p)), \
+			 _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull))
+
+/* Perform four rounds using the message words in m plus the constants k1:k0 */
+#define SHANI_QUADROUND(s0, s1, m, k1, k0) do { \
+	const __m128i msg_ = _mm_add_epi32(m, _mm_set_epi64x(k1, k0)); \
+	s1 = _mm_sha256rnds2_epu32(s1, s0, msg_); \
+	s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(msg_, 0x0e)); \
+	} while (0)
+
+/* Message schedule steps */
+#define SHANI_SHIFT_A(m0, m1) m0 = _mm_sha256msg1_epu32(m0, m1)
+#define SHANI_SHIFT_C(m0, m1, m2) \
+	m2 = _mm_sha256msg2_epu32(_mm_add_epi32(m2, _mm_alignr_epi8(m1, m0, 4)), m1)
+#define SHANI_SHIFT_B(m0, m1, m2) do { \
+	SHANI_SHIFT_C(m0, m1, m2); \
+	SHANI_SHIFT_A(m0, m1); \
+	} while (0)
+
+SHANI_TARGET
+static void TransformSHANI(uint32_t* s, const uint32_t* chunk, size_t blocks)
+{
+	__m128i m0, m1, m2, m3, s0, s1, so0, so1, t1, t2;
+
+	/* Load state, shuffling it into the order the instructions expect */
+	s0 = _mm_loadu_si128((const __m128i *)s);
+	s1 = _mm_loadu_si128((const __m128i *)(s + 4));
+	t1 = _mm_shuffle_epi32(s0, 0xB1);
+	t2 = _mm_shuffle_epi32(s1, 0x1B);
+	s0 = _mm_alignr_epi8(t1, t2, 0x08);
+	s1 = _mm_blend_epi16(t2, t1, 0xF0);
+
+	while (blocks--) {
+		/* Remember old state */
+		so0 = s0;
+		so1 = s1;
+
+		/* Load data and transform */
+		m0 = SHANI_LOAD(chunk);
+		SHANI_QUADROUND(s0, s1, m0, 0xe9b5dba5b5c0fbcfull, 0x71374491428a2f98ull);
+		m1 = SHANI_LOAD(chunk + 4);
+		SHANI_QUADROUND(s0, s1, m1, 0xab1c5ed5923f82a4ull, 0x59f111f13956c25bull);
+		SHANI_SHIFT_A(m0, m1);
+		m2 = SHANI_LOAD(chunk + 8);
+		SHANI_QUADROUND(s0, s1, m2, 0x550c7dc3243185beull, 0x12835b01d807aa98ull);
+		SHANI_SHIFT_A(m1, m2);
+		m3 = SHANI_LOAD(chunk + 12);
+		SHANI_QUADROUND(s0, s1, m3, 0xc19bf1749bdc06a7ull, 0x80deb1fe72be5d74ull);
+		SHANI_SHIFT_B(m2, m3, m0);
+		SHANI_QUADROUND(s0, s1, m0, 0x240ca1cc0fc19dc6ull, 0xefbe4786e49b69c1ull);
+		SHANI_SHIFT_B(m3, m0, m1);
+		SHANI_QUADROUND(s0, s1, m1, 0x76f988da5cb0a9dcull, 0x4a7484aa2de92c6full);
+		SHANI_SHIFT_B(m0, m1, m2);
+		SHANI_QUADROUND(s0, s1, m2, 0xbf597fc7b00327c8ull, 0xa831c66d983e5152ull);
+		SHANI_SHIFT_B(m1, m2, m3);
+		SHANI_QUADROUND(s0, s1, m3, 0x1429296706ca6351ull, 0xd5a79147c6e00bf3ull);
+		SHANI_SHIFT_B(m2, m3, m0);
+		SHANI_QUADROUND(s0, s1, m0, 0x53380d134d2c6dfcull, 0x2e1b213827b70a85ull);
+		SHANI_SHIFT_B(m3, m0, m1);
+		SHANI_QUADROUND(s0, s1, m1, 0x92722c8581c2c92eull, 0x766a0abb650a7354ull);
+		SHANI_SHIFT_B(m0, m1, m2);
+		SHANI_QUADROUND(s0, s1, m2, 0xc76c51a3c24b8b70ull, 0xa81a664ba2bfe8a1ull);
+		SHANI_SHIFT_B(m1, m2, m3);
+		SHANI_QUADROUND(s0, s1, m3, 0x106aa070f40e3585ull, 0xd6990624d192e819ull);
+		SHANI_SHIFT_B(m2, m3, m0);
+		SHANI_QUADROUND(s0, s1, m0, 0x34b0bcb52748774cull, 0x1e376c0819a4c116ull);
+		SHANI_SHIFT_B(m3, m0, m1);
+		SHANI_QUADROUND(s0, s1, m1, 0x682e6ff35b9cca4full, 0x4ed8aa4a391c0cb3ull);
+		SHANI_SHIFT_C(m0, m1, m2);
+		SHANI_QUADROUND(s0, s1, m2, 0x8cc7020884c87814ull, 0x78a5636f748f82eeull);
+		SHANI_SHIFT_C(m1, m2, m3);
+		SHANI_QUADROUND(s0, s1, m3, 0xc67178f2bef9a3f7ull, 0xa4506ceb90befffaull);
+
+		/* Combine with old state */
+		s0 = _mm_add_epi32(s0, so0);
+		s1 = _mm_add_epi32(s1, so1);
+
+		/* Advance */
+		chunk += 64 / sizeof(uint32_t);
+	}
+
+	/* Unshuffle and store the state */
+	t1 = _mm_shuffle_epi32(s0, 0x1B);
+	t2 = _mm_shuffle_epi32(s1, 0xB1);
+	s0 = _mm_blend_epi16(t1, t2, 0xF0);
+	s1 = _mm_alignr_epi8(t2, t1, 0x08);
+	_mm_storeu_si128((__m128i *)s, s0);
+	_mm_storeu_si128((__m128i *)(s + 4), s1);
+}
+#endif
@@ -12,6 +12,16 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <string.h>
+/* For the WALLY_CPU_ implementation flags */
+#include <include/wally_core.h>
+
+#ifdef WALLY_ENABLE_STATS
+/* Count compressions in wally's statistics, see src/internal.h */
+void wally_stats_add(uint32_t stat, uint64_t n);
+#define SHA512_STATS_ADD(blocks) wally_stats_add(WALLY_STAT_SHA512_BLOCKS, blocks)
+#else
+#define SHA512_STATS_ADD(blocks)
+#endif
 
 static void invalidate_sha512(struct sha512_ctx *ctx)
 {
@@ -84,7 +94,7 @@ static void Round(uint64_t a, uint64_t b, uint64_t c, uint64_t *d, uint64_t e, u
 }
 
 /** Perform one SHA-512 transformation, processing a 128-byte chunk. */
-static void Transform(uint64_t *s, const uint64_t *chunk)
+static void TransformDefault(uint64_t *s, const uint64_t *chunk)
 {
 	uint64_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
 	uint64_t w0, w1, w2, w3, w4, w5, w6, w7, w8, w9, w10, w11, w12, w13, w14, w15;
@@ -184,6 +194,43 @@ static void Transform(uint64_t *s, const uint64_t *chunk)
 	s[7] += h;
 }
 
+#if defined(__aarch64__) && defined(WALLY_ARM_KERNELS)
+#include "sha512_armv8.c"
+
+static int use_optimized_transform = 0;
+#elif defined(__x86_64__) || defined(__amd64__)
+#include "sha512_avx2.c"
+#include "sha512_ssse3.c"
+
+/* 1 to use TransformSSSE3(), 2 to use TransformAVX2() */
+static int use_optimized_transform = 0;
+#endif
+
+#ifdef HAVE_SHA512_AVX2
+static bool use_avx2_batch = false;
+#endif
+
+static inline void Transform(uint64_t *s, const uint64_t *chunk)
+{
+	SHA512_STATS_ADD(1);
+#ifdef HAVE_SHA512_ARMV8
+	if (use_optimized_transform) {
+		TransformARMV8(s, chunk);
+		return;
+	}
+#endif
+#ifdef HAVE_SHA512_SSSE3
+	if (use_optimized_transform) {
+		if (use_optimized_transform == 2)
+			TransformAVX2(s, chunk);
+		else
+			TransformSSSE3(s, chunk);
+		return;
+	}
+#endif
+	TransformDefault(s, chunk);
+}
+
 static void add(struct sha512_ctx *ctx, const void *p, size_t len)
 {
 	const unsigned char *data = p;
@@ -219,6 +266,34 @@ static void add(struct sha512_ctx *ctx, const void *p, size_t len)
 	}
 }
 
+uint32_t sha512_optimize(uint32_t cpu_features)
+{
+	uint32_t selected = 0;
+#ifdef HAVE_SHA512_ARMV8
+	if (cpu_features & WALLY_CPU_SHA512_ARMV8) {
+		use_optimized_transform = 1; /* ARMv8.2 SHA512 is available */
+		selected |= WALLY_CPU_SHA512_ARMV8;
+	}
+#endif
+#ifdef HAVE_SHA512_AVX2
+	if (cpu_features & WALLY_CPU_SHA512_AVX2) {
+		use_avx2_batch = true; /* AVX2 is available */
+		selected |= WALLY_CPU_SHA512_AVX2;
+	}
+#endif
+#ifdef HAVE_SHA512_SSSE3
+	if (cpu_features & WALLY_CPU_SHA512_AVX2_BMI2) {
+		use_optimized_transform = 2; /* AVX2 and BMI2 are available */
+		selected |= WALLY_CPU_SHA512_AVX2_BMI2;
+	} else if (cpu_features & WALLY_CPU_SHA512_SSSE3) {
+		use_optimized_transform = 1; /* SSSE3 is available */
+		selected |= WALLY_CPU_SHA512_SSSE3;
+	}
+#endif
+	(void)cpu_features;
+	return selected;
+}
+
 void sha512_init(struct sha512_ctx *ctx)
 {
 	struct sha512_ctx init = SHA512_INIT;
@@ -258,3 +333,64 @@ void sha512(struct sha512 *sha, const void *p, size_t size)
 	sha512_done(&ctx, sha);
 	CCAN_CLEAR_MEMORY(&ctx, sizeof(ctx));
 }
+
+/* Hash each object continuing from ctxs[i * ctx_stride], or from the
+ * initial state if ctxs is NULL */
+static void sha512_batch_impl(struct sha512 *sha, const struct sha512_ctx *ctxs,
+			      size_t ctx_stride, const void *p, size_t item_len,
+			      size_t n)
+{
+	const unsigned char *data = p;
+	struct sha512_ctx init, tmp_ctx;
+	size_t i = 0;
+
+	if (!ctxs) {
+		sha512_init(&init);
+		ctxs = &init;
+		ctx_stride = 0;
+	}
+	while (i < n) {
+#ifdef HAVE_SHA512_AVX2
+		if (use_avx2_batch && i + 4 <= n) {
+			const struct sha512_ctx *lane_ctxs[4];
+			const unsigned char *msgs[4];
+			size_t j;
+
+			for (j = 0; j < 4; j++) {
+				lane_ctxs[j] = ctxs + (i + j) * ctx_stride;
+				msgs[j] = data + (i + j) * item_len;
+				if (lane_ctxs[j]->bytes % 128)
+					break; /* Midstate required for each lane */
+			}
+			if (j == 4) {
+				sha512_4way_avx2(sha + i, lane_ctxs, msgs, item_len);
+				SHA512_STATS_ADD(4 * ((item_len + 17 + 127) / 128));
+				i += 4;
+				continue;
+			}
+		}
+#endif
+		tmp_ctx = ctxs[i * ctx_stride];
+		sha512_update(&tmp_ctx, data + i * item_len, item_len);
+		sha512_done(&tmp_ctx, sha + i);
+		i++;
+	}
+	CCAN_CLEAR_MEMORY(&tmp_ctx, sizeof(tmp_ctx));
+}
+
+void sha512_batch(struct sha512 *sha, const void *p, size_t item_len, size_t n)
+{
+	sha512_batch_impl(sha, NULL, 0, p, item_len, n);
+}
+
+void sha512_batch_from(struct sha512 *sha, const struct sha512_ctx *ctx,
+		       const void *p, size_t item_len, size_t n)
+{
+	sha512_batch_impl(sha, ctx, 0, p, item_len, n);
+}
+
+void sha512_batch_from_each(struct sha512 *sha, const struct sha512_ctx *ctxs,
+			    const void *p, size_t item_len, size_t n)
+{
+	sha512_batch_impl(sha, ctxs, 1, p, item_len, n);
+}
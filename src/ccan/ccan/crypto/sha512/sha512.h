@@ -37,6 +37,20 @@ struct sha512 {
  */
 void sha512(struct sha512 *sha, const void *p, size_t size);
 
+/**
+ * sha512_batch - return the sha512 of each of @n equal length objects.
+ * @sha: array of @n sha512s to fill in
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * Equivalent to calling sha512() for each object in turn, but hashes
+ * several objects at once where the CPU supports it. Each group of
+ * objects is read in full before its results are written, so when
+ * @item_len is at least 64 bytes @sha may point to @p itself.
+ */
+void sha512_batch(struct sha512 *sha, const void *p, size_t item_len, size_t n);
+
 /**
  * struct sha512_ctx - structure to store running context for sha512
  */
@@ -53,6 +67,14 @@ struct sha512_ctx {
 #endif
 };
 
+/**
+ * sha512_optimize - enable optimised functionality if possible.
+ * @cpu_features: the WALLY_CPU_ implementations the current CPU can run.
+ *
+ * Returns the WALLY_CPU_SHA512_ implementations selected.
+ */
+uint32_t sha512_optimize(uint32_t cpu_features);
+
 /**
  * sha512_init - initialize an SHA512 context.
  * @ctx: the sha512_ctx to initialize
@@ -132,4 +154,32 @@ void sha512_update(struct sha512_ctx *ctx, const void *p, size_t size);
  */
 void sha512_done(struct sha512_ctx *sha512, struct sha512 *res);
 
+/**
+ * sha512_batch_from - finish the sha512 of @n objects from a common prefix.
+ * @sha: array of @n sha512s to fill in
+ * @ctx: the SHA512 context holding the prefix, which is not modified
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * Equivalent to sha512_update() then sha512_done() on a copy of @ctx for
+ * each object. As for sha512_batch(), several objects are hashed at once
+ * where possible, which requires the prefix to be a multiple of 128 bytes.
+ */
+void sha512_batch_from(struct sha512 *sha, const struct sha512_ctx *ctx,
+		       const void *p, size_t item_len, size_t n);
+
+/**
+ * sha512_batch_from_each - finish the sha512 of @n objects from their own prefixes.
+ * @sha: array of @n sha512s to fill in
+ * @ctxs: array of @n SHA512 contexts holding each prefix, which are not modified
+ * @p: pointer to @n objects of @item_len bytes each, stored contiguously
+ * @item_len: the size in bytes of each object
+ * @n: the number of objects
+ *
+ * As sha512_batch_from(), but each object continues from its own context.
+ */
+void sha512_batch_from_each(struct sha512 *sha, const struct sha512_ctx *ctxs,
+			    const void *p, size_t item_len, size_t n);
+
 #endif /* CCAN_CRYPTO_SHA512_H */
@@ -0,0 +1,155 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* SHA512 transform using the ARMv8.2 SHA512 cryptography extensions.
+ *
+ * The round structure follows the Linux kernel's arch/arm64/crypto/sha512-ce-core.S
+ * by Ard Biesheuvel, expressed using compiler intrinsics.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && defined(__aarch64__) && defined(WALLY_ARM_KERNELS)
+#include <arm_neon.h>
+#define HAVE_SHA512_ARMV8 1
+
+#if defined(__clang__)
+#define ARMV8_SHA512_TARGET __attribute__((target("sha3")))
+#else
+#define ARMV8_SHA512_TARGET __attribute__((target("+sha3")))
+#endif
+
+/* Perform two rounds. The state is held in five registers: s0 = (a, b),
+ * s1 = (c, d), s2 = (e, f) and s3 = (g, h) on entry, with s4 unused.
+ * On exit (a, b) is in s3 and (e, f) in s4, so callers rotate the
+ * register roles for the next two rounds.
+ */
+#define ARMV8_SHA512_DROUND(s0, s1, s2, s3, s4, k, w) do { \
+	const uint64x2_t kw_ = vaddq_u64(w, vld1q_u64(K512_ARMV8 + (k))); \
+	const uint64x2_t fg_ = vextq_u64(s2, s3, 1); \
+	const uint64x2_t de_ = vextq_u64(s1, s2, 1); \
+	s3 = vaddq_u64(s3, vextq_u64(kw_, kw_, 1)); \
+	s3 = vsha512hq_u64(s3, fg_, de_); \
+	s4 = vaddq_u64(s1, s3); \
+	s3 = vsha512h2q_u64(s3, s1, s0); \
+	} while (0)
+
+/* As above, also computing the next two message words into w0 */
+#define ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, k, w0, w1, w7, w4, w5) do { \
+	ARMV8_SHA512_DROUND(s0, s1, s2, s3, s4, k, w0); \
+	w0 = vsha512su1q_u64(vsha512su0q_u64(w0, w1), w7, vextq_u64(w4, w5, 1)); \
+	} while (0)
+
+static const uint64_t K512_ARMV8[] = {
+	0x428a2f98d728ae22ull, 0x7137449123ef65cdull,
+	0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+	0x3956c25bf348b538ull, 0x59f111f1b605d019ull,
+	0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+	0xd807aa98a3030242ull, 0x12835b0145706fbeull,
+	0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+	0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull,
+	0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+	0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull,
+	0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+	0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull,
+	0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+	0x983e5152ee66dfabull, 0xa831c66d2db43210ull,
+	0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+	0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull,
+	0x06ca6351e003826full, 0x142929670a0e6e70ull,
+	0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull,
+	0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+	0x650a73548baf63deull, 0x766a0abb3c77b2a8ull,
+	0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+	0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull,
+	0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+	0xd192e819d6ef5218ull, 0xd69906245565a910ull,
+	0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+	0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull,
+	0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+	0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull,
+	0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+	0x748f82ee5defb2fcull, 0x78a5636f43172f60ull,
+	0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+	0x90befffa23631e28ull, 0xa4506cebde82bde9ull,
+	0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+	0xca273eceea26619cull, 0xd186b8c721c0c207ull,
+	0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+	0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull,
+	0x113f9804bef90daeull, 0x1b710b35131c471bull,
+	0x28db77f523047d84ull, 0x32caab7b40c72493ull,
+	0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+	0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull,
+	0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull
+};
+
+ARMV8_SHA512_TARGET
+static void TransformARMV8(uint64_t *s, const uint64_t *chunk)
+{
+	const uint8_t *p = (const uint8_t *)chunk;
+	uint64x2_t s0, s1, s2, s3, s4, m0, m1, m2, m3, m4, m5, m6, m7;
+
+	/* Load state */
+	s0 = vld1q_u64(s);
+	s1 = vld1q_u64(s + 2);
+	s2 = vld1q_u64(s + 4);
+	s3 = vld1q_u64(s + 6);
+
+	/* Load data, converting it from big-endian */
+	m0 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p)));
+	m1 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 16)));
+	m2 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 32)));
+	m3 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 48)));
+	m4 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 64)));
+	m5 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 80)));
+	m6 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 96)));
+	m7 = vreinterpretq_u64_u8(vrev64q_u8(vld1q_u8(p + 112)));
+
+	/* Transform */
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 0, m0, m1, m7, m4, m5);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 2, m1, m2, m0, m5, m6);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 4, m2, m3, m1, m6, m7);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 6, m3, m4, m2, m7, m0);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 8, m4, m5, m3, m0, m1);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 10, m5, m6, m4, m1, m2);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 12, m6, m7, m5, m2, m3);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 14, m7, m0, m6, m3, m4);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 16, m0, m1, m7, m4, m5);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 18, m1, m2, m0, m5, m6);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 20, m2, m3, m1, m6, m7);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 22, m3, m4, m2, m7, m0);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 24, m4, m5, m3, m0, m1);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 26, m5, m6, m4, m1, m2);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 28, m6, m7, m5, m2, m3);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 30, m7, m0, m6, m3, m4);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 32, m0, m1, m7, m4, m5);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 34, m1, m2, m0, m5, m6);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 36, m2, m3, m1, m6, m7);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 38, m3, m4, m2, m7, m0);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 40, m4, m5, m3, m0, m1);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 42, m5, m6, m4, m1, m2);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 44, m6, m7, m5, m2, m3);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 46, m7, m0, m6, m3, m4);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 48, m0, m1, m7, m4, m5);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 50, m1, m2, m0, m5, m6);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 52, m2, m3, m1, m6, m7);
+	ARMV8_SHA512_DROUND_SCHEDULE(s2, s3, s1, s4, s0, 54, m3, m4, m2, m7, m0);
+	ARMV8_SHA512_DROUND_SCHEDULE(s4, s2, s0, s1, s3, 56, m4, m5, m3, m0, m1);
+	ARMV8_SHA512_DROUND_SCHEDULE(s1, s4, s3, s0, s2, 58, m5, m6, m4, m1, m2);
+	ARMV8_SHA512_DROUND_SCHEDULE(s0, s1, s2, s3, s4, 60, m6, m7, m5, m2, m3);
+	ARMV8_SHA512_DROUND_SCHEDULE(s3, s0, s4, s2, s1, 62, m7, m0, m6, m3, m4);
+	ARMV8_SHA512_DROUND(s2, s3, s1, s4, s0, 64, m0);
+	ARMV8_SHA512_DROUND(s4, s2, s0, s1, s3, 66, m1);
+	ARMV8_SHA512_DROUND(s1, s4, s3, s0, s2, 68, m2);
+	ARMV8_SHA512_DROUND(s0, s1, s2, s3, s4, 70, m3);
+	ARMV8_SHA512_DROUND(s3, s0, s4, s2, s1, 72, m4);
+	ARMV8_SHA512_DROUND(s2, s3, s1, s4, s0, 74, m5);
+	ARMV8_SHA512_DROUND(s4, s2, s0, s1, s3, 76, m6);
+	ARMV8_SHA512_DROUND(s1, s4, s3, s0, s2, 78, m7);
+
+	/* Combine with old state and store */
+	vst1q_u64(s, vaddq_u64(s0, vld1q_u64(s)));
+	vst1q_u64(s + 2, vaddq_u64(s1, vld1q_u64(s + 2)));
+	vst1q_u64(s + 4, vaddq_u64(s2, vld1q_u64(s + 4)));
+	vst1q_u64(s + 6, vaddq_u64(s3, vld1q_u64(s + 6)));
+}
+#endif
@@ -0,0 +1,170 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* 4-way SHA512 using AVX2, hashing four equal length messages at once.
+ *
+ * Each 256 bit register holds the same state word of four independent
+ * hashes, so the rounds follow TransformDefault() lane for lane.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#include <immintrin.h>
+#define HAVE_SHA512_AVX2 1
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+static const uint64_t K512_AVX2[80] = {
+	0x428a2f98d728ae22ull, 0x7137449123ef65cdull,
+	0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+	0x3956c25bf348b538ull, 0x59f111f1b605d019ull,
+	0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+	0xd807aa98a3030242ull, 0x12835b0145706fbeull,
+	0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+	0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull,
+	0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+	0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull,
+	0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+	0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull,
+	0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+	0x983e5152ee66dfabull, 0xa831c66d2db43210ull,
+	0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+	0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull,
+	0x06ca6351e003826full, 0x142929670a0e6e70ull,
+	0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull,
+	0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+	0x650a73548baf63deull, 0x766a0abb3c77b2a8ull,
+	0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+	0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull,
+	0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+	0xd192e819d6ef5218ull, 0xd69906245565a910ull,
+	0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+	0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull,
+	0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+	0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull,
+	0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+	0x748f82ee5defb2fcull, 0x78a5636f43172f60ull,
+	0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+	0x90befffa23631e28ull, 0xa4506cebde82bde9ull,
+	0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+	0xca273eceea26619cull, 0xd186b8c721c0c207ull,
+	0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+	0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull,
+	0x113f9804bef90daeull, 0x1b710b35131c471bull,
+	0x28db77f523047d84ull, 0x32caab7b40c72493ull,
+	0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+	0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull,
+	0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull
+};
+
+#define AVX2_ROR64(x, n) _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+#define AVX2_XOR3(x, y, z) _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define AVX2_ADD3(x, y, z) _mm256_add_epi64(_mm256_add_epi64(x, y), z)
+
+AVX2_TARGET
+static inline __m256i avx2_load_be64(const unsigned char *const *lanes, size_t offset)
+{
+	uint64_t v[4];
+	size_t i;
+
+	for (i = 0; i < 4; i++) {
+		memcpy(&v[i], lanes[i] + offset, sizeof(v[i]));
+		v[i] = be64_to_cpu(v[i]);
+	}
+	return _mm256_loadu_si256((const __m256i *)v);
+}
+
+/* One SHA512 compression of the message schedule in w into the state s */
+AVX2_TARGET
+static void avx2_transform512(__m256i *s, __m256i *w)
+{
+	__m256i a = s[0], b = s[1], c = s[2], d = s[3];
+	__m256i e = s[4], f = s[5], g = s[6], h = s[7];
+	size_t i;
+
+	for (i = 0; i < 80; i++) {
+		__m256i t1, t2;
+
+		if (i >= 16) {
+			const __m256i w2 = w[(i - 2) & 15], w15 = w[(i - 15) & 15];
+			const __m256i s1 = AVX2_XOR3(AVX2_ROR64(w2, 19), AVX2_ROR64(w2, 61), _mm256_srli_epi64(w2, 6));
+			const __m256i s0 = AVX2_XOR3(AVX2_ROR64(w15, 1), AVX2_ROR64(w15, 8), _mm256_srli_epi64(w15, 7));
+			w[i & 15] = _mm256_add_epi64(AVX2_ADD3(w[i & 15], s1, w[(i - 7) & 15]), s0);
+		}
+		t1 = AVX2_ADD3(h, AVX2_XOR3(AVX2_ROR64(e, 14), AVX2_ROR64(e, 18), AVX2_ROR64(e, 41)),
+			       _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g))));
+		t1 = AVX2_ADD3(t1, _mm256_set1_epi64x((long long)K512_AVX2[i]), w[i & 15]);
+		t2 = _mm256_add_epi64(AVX2_XOR3(AVX2_ROR64(a, 28), AVX2_ROR64(a, 34), AVX2_ROR64(a, 39)),
+				      _mm256_or_si256(_mm256_and_si256(a, b),
+						      _mm256_and_si256(c, _mm256_or_si256(a, b))));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi64(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi64(t1, t2);
+	}
+
+	s[0] = _mm256_add_epi64(s[0], a);
+	s[1] = _mm256_add_epi64(s[1], b);
+	s[2] = _mm256_add_epi64(s[2], c);
+	s[3] = _mm256_add_epi64(s[3], d);
+	s[4] = _mm256_add_epi64(s[4], e);
+	s[5] = _mm256_add_epi64(s[5], f);
+	s[6] = _mm256_add_epi64(s[6], g);
+	s[7] = _mm256_add_epi64(s[7], h);
+}
+
+/* Hash the four len byte messages msgs into sha[0..3]. Each message is
+ * hashed continuing from the corresponding context in ctxs, which must
+ * have processed a multiple of the block size */
+AVX2_TARGET
+static void sha512_4way_avx2(struct sha512 *sha, const struct sha512_ctx *const *ctxs,
+			     const unsigned char *const *msgs, size_t len)
+{
+	unsigned char tail[4][256];
+	const unsigned char *lanes[4];
+	const size_t full = len / 128, rem = len % 128;
+	const size_t tail_len = rem + 17 > 128 ? 256 : 128;
+	__m256i s[8], w[16];
+	uint64_t out[8][4];
+	size_t i, j;
+
+	/* Build the padded final block(s) of each message. The length is
+	 * stored as 128 bits, the top 64 of which are always zero here */
+	for (i = 0; i < 4; i++) {
+		const uint64_t bits = cpu_to_be64(((uint64_t)ctxs[i]->bytes + len) << 3);
+		memcpy(tail[i], msgs[i] + full * 128, rem);
+		tail[i][rem] = 0x80;
+		memset(tail[i] + rem + 1, 0, tail_len - rem - 1 - 8);
+		memcpy(tail[i] + tail_len - 8, &bits, 8);
+	}
+
+	for (i = 0; i < 8; i++) {
+		for (j = 0; j < 4; j++)
+			out[i][j] = ctxs[j]->s[i];
+		s[i] = _mm256_loadu_si256((const __m256i *)out[i]);
+	}
+	for (j = 0; j < full + tail_len / 128; j++) {
+		for (i = 0; i < 4; i++)
+			lanes[i] = j < full ? msgs[i] + j * 128 : tail[i] + (j - full) * 128;
+		for (i = 0; i < 16; i++)
+			w[i] = avx2_load_be64(lanes, i * 8);
+		avx2_transform512(s, w);
+	}
+
+	for (i = 0; i < 8; i++)
+		_mm256_storeu_si256((__m256i *)out[i], s[i]);
+	for (i = 0; i < 4; i++)
+		for (j = 0; j < 8; j++)
+			sha[i].u.u64[j] = cpu_to_be64(out[j][i]);
+
+	CCAN_CLEAR_MEMORY(tail, sizeof(tail));
+	CCAN_CLEAR_MEMORY(out, sizeof(out));
+	CCAN_CLEAR_MEMORY(s, sizeof(s));
+	CCAN_CLEAR_MEMORY(w, sizeof(w));
+}
+#endif
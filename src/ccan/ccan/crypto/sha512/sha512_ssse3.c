@@ -0,0 +1,137 @@
+/* MIT (BSD) license - see LICENSE file for details */
+/* Single stream SHA512 with a vectorised message schedule.
+ *
+ * As in Intel's SSSE3 and AVX2 SHA512 implementations, the schedule is
+ * computed two words at a time and the round constants added to it
+ * in 128 bit registers, ahead of the scalar rounds that consume it. The
+ * same code is built for SSSE3 and for AVX2 with BMI2, where the compiler
+ * uses three operand VEX encodings for the schedule and rorx rotates in
+ * the rounds. This file is included from sha512.c after TransformDefault().
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#include <immintrin.h>
+#define HAVE_SHA512_SSSE3 1
+
+static const uint64_t K512_SSSE3[80] __attribute__((aligned(16))) = {
+	0x428a2f98d728ae22ull, 0x7137449123ef65cdull,
+	0xb5c0fbcfec4d3b2full, 0xe9b5dba58189dbbcull,
+	0x3956c25bf348b538ull, 0x59f111f1b605d019ull,
+	0x923f82a4af194f9bull, 0xab1c5ed5da6d8118ull,
+	0xd807aa98a3030242ull, 0x12835b0145706fbeull,
+	0x243185be4ee4b28cull, 0x550c7dc3d5ffb4e2ull,
+	0x72be5d74f27b896full, 0x80deb1fe3b1696b1ull,
+	0x9bdc06a725c71235ull, 0xc19bf174cf692694ull,
+	0xe49b69c19ef14ad2ull, 0xefbe4786384f25e3ull,
+	0x0fc19dc68b8cd5b5ull, 0x240ca1cc77ac9c65ull,
+	0x2de92c6f592b0275ull, 0x4a7484aa6ea6e483ull,
+	0x5cb0a9dcbd41fbd4ull, 0x76f988da831153b5ull,
+	0x983e5152ee66dfabull, 0xa831c66d2db43210ull,
+	0xb00327c898fb213full, 0xbf597fc7beef0ee4ull,
+	0xc6e00bf33da88fc2ull, 0xd5a79147930aa725ull,
+	0x06ca6351e003826full, 0x142929670a0e6e70ull,
+	0x27b70a8546d22ffcull, 0x2e1b21385c26c926ull,
+	0x4d2c6dfc5ac42aedull, 0x53380d139d95b3dfull,
+	0x650a73548baf63deull, 0x766a0abb3c77b2a8ull,
+	0x81c2c92e47edaee6ull, 0x92722c851482353bull,
+	0xa2bfe8a14cf10364ull, 0xa81a664bbc423001ull,
+	0xc24b8b70d0f89791ull, 0xc76c51a30654be30ull,
+	0xd192e819d6ef5218ull, 0xd69906245565a910ull,
+	0xf40e35855771202aull, 0x106aa07032bbd1b8ull,
+	0x19a4c116b8d2d0c8ull, 0x1e376c085141ab53ull,
+	0x2748774cdf8eeb99ull, 0x34b0bcb5e19b48a8ull,
+	0x391c0cb3c5c95a63ull, 0x4ed8aa4ae3418acbull,
+	0x5b9cca4f7763e373ull, 0x682e6ff3d6b2b8a3ull,
+	0x748f82ee5defb2fcull, 0x78a5636f43172f60ull,
+	0x84c87814a1f0ab72ull, 0x8cc702081a6439ecull,
+	0x90befffa23631e28ull, 0xa4506cebde82bde9ull,
+	0xbef9a3f7b2c67915ull, 0xc67178f2e372532bull,
+	0xca273eceea26619cull, 0xd186b8c721c0c207ull,
+	0xeada7dd6cde0eb1eull, 0xf57d4f7fee6ed178ull,
+	0x06f067aa72176fbaull, 0x0a637dc5a2c898a6ull,
+	0x113f9804bef90daeull, 0x1b710b35131c471bull,
+	0x28db77f523047d84ull, 0x32caab7b40c72493ull,
+	0x3c9ebe0a15c9bebcull, 0x431d67c49c100d4cull,
+	0x4cc5d4becb3e42b6ull, 0x597f299cfc657e2aull,
+	0x5fcb6fab3ad6faecull, 0x6c44198c4a475817ull
+};
+
+#define SSSE3_ROR64(x, n) _mm_or_si128(_mm_srli_epi64(x, n), _mm_slli_epi64(x, 64 - (n)))
+#define SSSE3_XOR3(x, y, z) _mm_xor_si128(_mm_xor_si128(x, y), z)
+
+/* Compute schedule words t and t + 1 from the ring x of the last 16 words,
+ * storing them in x and, with their round constants added, in wk */
+#define SSSE3_SCHEDULE(x, wk, t) do { \
+	const __m128i w2 = x[((t) / 2 - 1) & 7], w16 = x[((t) / 2) & 7]; \
+	const __m128i w7 = _mm_alignr_epi8(x[((t) / 2 - 3) & 7], x[((t) / 2 - 4) & 7], 8); \
+	const __m128i w15 = _mm_alignr_epi8(x[((t) / 2 + 1) & 7], w16, 8); \
+	const __m128i s1 = SSSE3_XOR3(SSSE3_ROR64(w2, 19), SSSE3_ROR64(w2, 61), _mm_srli_epi64(w2, 6)); \
+	const __m128i s0 = SSSE3_XOR3(SSSE3_ROR64(w15, 1), SSSE3_ROR64(w15, 8), _mm_srli_epi64(w15, 7)); \
+	x[((t) / 2) & 7] = _mm_add_epi64(_mm_add_epi64(w16, s0), _mm_add_epi64(w7, s1)); \
+	_mm_store_si128((__m128i *)(wk + (t)), \
+			_mm_add_epi64(x[((t) / 2) & 7], _mm_load_si128((const __m128i *)(K512_SSSE3 + (t))))); \
+} while (0)
+
+/* Eight rounds starting at round i, leaving the state rotated back to a..h */
+#define SSSE3_ROUNDS8(wk, i) do { \
+	Round(a, b, c, &d, e, f, g, &h, 0, wk[(i) + 0]); \
+	Round(h, a, b, &c, d, e, f, &g, 0, wk[(i) + 1]); \
+	Round(g, h, a, &b, c, d, e, &f, 0, wk[(i) + 2]); \
+	Round(f, g, h, &a, b, c, d, &e, 0, wk[(i) + 3]); \
+	Round(e, f, g, &h, a, b, c, &d, 0, wk[(i) + 4]); \
+	Round(d, e, f, &g, h, a, b, &c, 0, wk[(i) + 5]); \
+	Round(c, d, e, &f, g, h, a, &b, 0, wk[(i) + 6]); \
+	Round(b, c, d, &e, f, g, h, &a, 0, wk[(i) + 7]); \
+} while (0)
+
+#define SSSE3_TRANSFORM(name, isa) \
+__attribute__((target(isa))) \
+static void name(uint64_t *s, const uint64_t *chunk) \
+{ \
+	const __m128i flip = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, \
+					  0, 1, 2, 3, 4, 5, 6, 7); \
+	uint64_t a = s[0], b = s[1], c = s[2], d = s[3]; \
+	uint64_t e = s[4], f = s[5], g = s[6], h = s[7]; \
+	uint64_t wk[80] __attribute__((aligned(16))); \
+	__m128i x[8]; \
+	size_t i; \
+\
+	for (i = 0; i < 8; i++) { \
+		x[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)chunk + i), flip); \
+		_mm_store_si128((__m128i *)wk + i, \
+				_mm_add_epi64(x[i], _mm_load_si128((const __m128i *)K512_SSSE3 + i))); \
+	} \
+	/* Schedule the next 16 words while running the rounds on the last 16 */ \
+	for (i = 0; i < 64; i += 16) { \
+		SSSE3_SCHEDULE(x, wk, i + 16); \
+		SSSE3_SCHEDULE(x, wk, i + 18); \
+		SSSE3_SCHEDULE(x, wk, i + 20); \
+		SSSE3_SCHEDULE(x, wk, i + 22); \
+		SSSE3_ROUNDS8(wk, i); \
+		SSSE3_SCHEDULE(x, wk, i + 24); \
+		SSSE3_SCHEDULE(x, wk, i + 26); \
+		SSSE3_SCHEDULE(x, wk, i + 28); \
+		SSSE3_SCHEDULE(x, wk, i + 30); \
+		SSSE3_ROUNDS8(wk, i + 8); \
+	} \
+	SSSE3_ROUNDS8(wk, 64); \
+	SSSE3_ROUNDS8(wk, 72); \
+\
+	s[0] += a; \
+	s[1] += b; \
+	s[2] += c; \
+	s[3] += d; \
+	s[4] += e; \
+	s[5] += f; \
+	s[6] += g; \
+	s[7] += h; \
+	CCAN_CLEAR_MEMORY(wk, sizeof(wk)); \
+	CCAN_CLEAR_MEMORY(x, sizeof(x)); \
+}
+
+SSSE3_TRANSFORM(TransformSSSE3, "ssse3")
+SSSE3_TRANSFORM(TransformAVX2, "avx2,bmi2")
+#endif
@@ -0,0 +1,416 @@
+#include "internal.h"
+
+#include <include/wally_transaction.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "script_int.h"
+
+#define COINSELECT_ALL_FLAGS (WALLY_COINSELECT_BNB | WALLY_COINSELECT_KNAPSACK)
+
+/* The branch and bound search is split into 2^BNB_SPLIT_DEPTH subtrees by
+ * fixing the inclusion of the largest coins, each searched as a task */
+#define BNB_SPLIT_DEPTH 4
+#define BNB_MAX_TRIES 100000 /* Total tries across all subtrees */
+
+/* The knapsack's random subset search is split into this many tasks */
+#define KNAPSACK_TASKS 8
+#define KNAPSACK_ITERATIONS 1000 /* Total iterations across all tasks */
+
+#define BNB_TASKS (1 << BNB_SPLIT_DEPTH)
+#define MAX_TASKS (KNAPSACK_TASKS > BNB_TASKS ? KNAPSACK_TASKS : BNB_TASKS)
+
+#define SATOSHI_MAX ((uint64_t)WALLY_SATOSHI_PER_BTC * WALLY_BTC_MAX)
+#define NO_SOLUTION ((uint64_t)-1)
+
+/* A spendable coin, sorted by decreasing effective value */
+struct coin {
+    uint64_t value; /* Value less the fee to spend it */
+    uint32_t index; /* Index of the coin in the callers arrays */
+};
+
+/* The best selection found by a single task */
+struct coinselect_result {
+    uint64_t excess; /* Selected value over the target, or NO_SOLUTION */
+    size_t num_selected;
+    uint32_t *selected; /* Positions of the selected coins in sorted order */
+    uint32_t *work; /* Working storage for the task */
+};
+
+struct coinselect_tasks {
+    const struct coin *coins;
+    size_t num_coins;
+    const uint64_t *lookahead; /* Sum of coin values from each position onwards */
+    uint64_t target;
+    uint64_t cost_of_change;
+    size_t split_depth;
+    struct coinselect_result *results;
+};
+
+static int coin_cmp(const void *lhs, const void *rhs)
+{
+    const struct coin *l = lhs, *r = rhs;
+    if (l->value != r->value)
+        return l->value > r->value ? -1 : 1;
+    return l->index < r->index ? -1 : (l->index > r->index);
+}
+
+static int index_cmp(const void *lhs, const void *rhs)
+{
+    const uint32_t l = *(const uint32_t *)lhs, r = *(const uint32_t *)rhs;
+    return l < r ? -1 : (l > r);
+}
+
+/* Return true if (excess, num_selected) is better than the result r */
+static bool is_better(const struct coinselect_result *r,
+                      uint64_t excess, size_t num_selected)
+{
+    return excess < r->excess ||
+           (excess == r->excess && num_selected < r->num_selected);
+}
+
+static void set_result(struct coinselect_result *r, uint64_t excess,
+                       const uint32_t *selected, size_t num_selected)
+{
+    r->excess = excess;
+    r->num_selected = num_selected;
+    memcpy(r->selected, selected, num_selected * sizeof(*selected));
+}
+
+/* Depth first search of one subtree for a selection within
+ * [target, target + cost_of_change], trying inclusion before exclusion */
+static void bnb_task(void *task_ctx, size_t index)
+{
+    const struct coinselect_tasks *t = task_ctx;
+    struct coinselect_result *r = t->results + index;
+    const struct coin *coins = t->coins;
+    const uint64_t upper = t->target + t->cost_of_change;
+    uint32_t *sel = r->work;
+    size_t pos, num_fixed = 0, num_sel, tries;
+    uint64_t cur = 0;
+
+    for (pos = 0; pos < t->split_depth; ++pos)
+        if (index & (1u << pos)) {
+            sel[num_fixed++] = (uint32_t)pos;
+            cur += coins[pos].value;
+        }
+    num_sel = num_fixed;
+    pos = t->split_depth;
+
+    for (tries = 0; tries < BNB_MAX_TRIES / BNB_TASKS; ++tries) {
+        bool backtrack = true;
+
+        if (cur + t->lookahead[pos] < t->target || cur > upper)
+            ; /* Cannot reach the target, or overshot it */
+        else if (cur >= t->target) {
+            if (is_better(r, cur - t->target, num_sel))
+                set_result(r, cur - t->target, sel, num_sel);
+        } else if (pos < t->num_coins)
+            backtrack = false;
+
+        if (backtrack) {
+            /* Exclude the last included coin and try the coins after it */
+            if (num_sel == num_fixed)
+                break; /* Subtree exhausted */
+            pos = sel[--num_sel];
+            cur -= coins[pos].value;
+            ++pos;
+        } else if (pos && coins[pos].value == coins[pos - 1].value &&
+                   (!num_sel || sel[num_sel - 1] != pos - 1)) {
+            /* Including this coin is equivalent to including the last
+             * excluded coin of the same value, which was already tried */
+            ++pos;
+        } else {
+            sel[num_sel++] = (uint32_t)pos;
+            cur += coins[pos].value;
+            ++pos;
+        }
+    }
+}
+
+/* xorshift64*: a fast, deterministic generator for the knapsack search */
+static uint64_t knapsack_rand(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ull;
+}
+
+/* Stochastically approximate the smallest subset of the coins
+ * reaching the target, as per Bitcoin Core's ApproximateBestSubset */
+static void knapsack_task(void *task_ctx, size_t index)
+{
+    const struct coinselect_tasks *t = task_ctx;
+    struct coinselect_result *r = t->results + index;
+    const size_t n = t->num_coins;
+    unsigned char *included = (unsigned char *)r->work;
+    uint64_t state = (index + 1) * 0x9e3779b97f4a7c15ull, rnd = 0;
+    size_t i, j, iter, pass, num_sel, bits = 0;
+
+    for (iter = 0; iter < KNAPSACK_ITERATIONS / KNAPSACK_TASKS &&
+         r->excess; ++iter) {
+        uint64_t total = 0;
+        size_t best_pos = n, best_pass = 0;
+        bool reached = false;
+
+        memset(included, 0, n);
+        num_sel = 0;
+        for (pass = 0; pass < 2 && !reached; ++pass) {
+            for (i = 0; i < n; ++i) {
+                if (pass == 0) {
+                    if (!bits) {
+                        rnd = knapsack_rand(&state);
+                        bits = 64;
+                    }
+                    --bits;
+                    if (!((rnd >>= 1) & 1))
+                        continue;
+                } else if (included[i])
+                    continue;
+                total += t->coins[i].value;
+                ++num_sel;
+                if (total < t->target)
+                    included[i] = (unsigned char)(pass + 1);
+                else {
+                    reached = true;
+                    if (is_better(r, total - t->target, num_sel)) {
+                        r->excess = total - t->target;
+                        r->num_selected = num_sel;
+                        best_pos = i;
+                        best_pass = pass + 1;
+                    }
+                    total -= t->coins[i].value;
+                    --num_sel;
+                }
+            }
+        }
+        if (best_pos != n) {
+            /* Coins before a position are not changed once it is passed,
+             * so the best selection is every coin included before it,
+             * plus any included in an earlier pass, plus the coin itself */
+            size_t k = 0;
+            for (j = 0; j < n; ++j)
+                if (j == best_pos ||
+                    (included[j] && (j < best_pos || included[j] < best_pass)))
+                    r->selected[k++] = (uint32_t)j;
+        }
+    }
+}
+
+static void run_tasks(struct coinselect_tasks *t, size_t num_tasks,
+                      wally_task_t task_fn,
+                      wally_run_tasks_t run_fn, void *run_ctx)
+{
+    size_t i;
+
+    for (i = 0; i < num_tasks; ++i) {
+        t->results[i].excess = NO_SOLUTION;
+        t->results[i].num_selected = 0;
+    }
+    wally_run_tasks(run_fn, run_ctx, num_tasks, task_fn, t);
+}
+
+/* Return the best of the task results, the earliest winning ties */
+static const struct coinselect_result *best_result(const struct coinselect_tasks *t,
+                                                   size_t num_tasks)
+{
+    const struct coinselect_result *best = t->results;
+    size_t i;
+
+    for (i = 1; i < num_tasks; ++i)
+        if (is_better(best, t->results[i].excess, t->results[i].num_selected))
+            best = t->results + i;
+    return best->excess == NO_SOLUTION ? NULL : best;
+}
+
+static const struct coinselect_result *select_bnb(struct coinselect_tasks *t,
+                                                  wally_run_tasks_t run_fn,
+                                                  void *run_ctx)
+{
+    t->split_depth = t->num_coins < BNB_SPLIT_DEPTH ? t->num_coins : BNB_SPLIT_DEPTH;
+    run_tasks(t, (size_t)1 << t->split_depth, bnb_task, run_fn, run_ctx);
+    return best_result(t, (size_t)1 << t->split_depth);
+}
+
+/* Select coins for a payment with change, as per Bitcoin Core's KnapsackSolver */
+static const struct coinselect_result *select_knapsack(struct coinselect_tasks *t,
+                                                       wally_run_tasks_t run_fn,
+                                                       void *run_ctx,
+                                                       struct coinselect_result *single)
+{
+    const uint64_t target = t->target, min_change = t->cost_of_change;
+    const struct coinselect_result *best = NULL;
+    const size_t num_coins = t->num_coins;
+    size_t i, first_lower;
+    uint64_t total_lower = 0;
+
+    /* Coins are sorted largest first: find an exact match, the lowest
+     * coin at least target + min_change, and the sum of those below it */
+    for (first_lower = 0; first_lower < num_coins; ++first_lower) {
+        const uint64_t value = t->coins[first_lower].value;
+        if (value == target) {
+            single->excess = 0;
+            single->num_selected = 1;
+            single->selected[0] = (uint32_t)first_lower;
+            return single;
+        }
+        if (value < target + min_change)
+            break;
+    }
+    for (i = first_lower; i < num_coins; ++i) {
+        if (t->coins[i].value == target) {
+            single->excess = 0;
+            single->num_selected = 1;
+            single->selected[0] = (uint32_t)i;
+            return single;
+        }
+        total_lower += t->coins[i].value;
+    }
+    single->excess = NO_SOLUTION;
+    if (first_lower) {
+        single->excess = t->coins[first_lower - 1].value - target;
+        single->num_selected = 1;
+        single->selected[0] = (uint32_t)(first_lower - 1);
+    }
+
+    if (total_lower == target) {
+        single->excess = 0;
+        single->num_selected = num_coins - first_lower;
+        for (i = first_lower; i < num_coins; ++i)
+            single->selected[i - first_lower] = (uint32_t)i;
+        return single;
+    }
+    if (total_lower < target)
+        return single->excess == NO_SOLUTION ? NULL : single;
+
+    /* Search the coins below the lowest larger coin only */
+    t->coins += first_lower;
+    t->num_coins -= first_lower;
+    run_tasks(t, KNAPSACK_TASKS, knapsack_task, run_fn, run_ctx);
+    best = best_result(t, KNAPSACK_TASKS);
+    if (best->excess && total_lower >= target + min_change) {
+        /* No exact match: try again leaving room for change */
+        t->target = target + min_change;
+        run_tasks(t, KNAPSACK_TASKS, knapsack_task, run_fn, run_ctx);
+        best = best_result(t, KNAPSACK_TASKS);
+        for (i = 0; i < KNAPSACK_TASKS; ++i)
+            t->results[i].excess += min_change;
+        t->target = target;
+    }
+    for (i = 0; i < KNAPSACK_TASKS; ++i)
+        for (first_lower = 0; first_lower < t->results[i].num_selected; ++first_lower)
+            t->results[i].selected[first_lower] += (uint32_t)(num_coins - t->num_coins);
+    t->coins -= num_coins - t->num_coins;
+    t->num_coins = num_coins;
+
+    /* Prefer the lowest larger coin if it is smaller or
+     * the subset found does not leave enough for change */
+    if (single->excess != NO_SOLUTION &&
+        ((best->excess && best->excess < min_change) || single->excess <= best->excess))
+        return single;
+    return best;
+}
+
+int wally_coinselect(const uint64_t *values, size_t values_len,
+                     const uint32_t *weights, size_t weights_len,
+                     uint64_t target, size_t base_weight,
+                     uint64_t fee_rate, uint64_t cost_of_change,
+                     uint32_t flags,
+                     wally_run_tasks_t run_fn, void *run_ctx,
+                     uint32_t *indices_out, size_t len, size_t *written)
+{
+    struct coinselect_tasks tasks;
+    struct coinselect_result single, results[MAX_TASKS];
+    const struct coinselect_result *best = NULL;
+    struct coin *coins = NULL;
+    uint64_t *lookahead = NULL, total = 0, fixed_fee;
+    uint32_t *storage = NULL;
+    size_t i, n = 0;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!values || !values_len || values_len > UINT32_MAX ||
+        !weights || weights_len != values_len || !fee_rate ||
+        !flags || (flags & ~COINSELECT_ALL_FLAGS) || !indices_out || !written)
+        return WALLY_EINVAL;
+
+    /* Count the coins worth spending, and check the total value is sane */
+    for (i = 0; i < values_len; ++i) {
+        if (values[i] > SATOSHI_MAX || (total += values[i]) > SATOSHI_MAX)
+            return WALLY_EINVAL;
+        if (values[i] * 4000 > (uint64_t)weights[i] * fee_rate)
+            ++n;
+    }
+    if (target > total || fee_rate > WALLY_SATOSHI_PER_BTC ||
+        cost_of_change > SATOSHI_MAX)
+        return WALLY_EINVAL;
+    if (!n)
+        return WALLY_OK; /* No coin is worth spending */
+
+    /* Fees for the transaction outside its inputs. The input count is
+     * costed as if every coin were selected, and 3 weight units are added
+     * to cover rounding the transaction weight up to its vsize */
+    base_weight += 4 * (varint_get_length(n) - varint_get_length(0)) + 3;
+    fixed_fee = ((uint64_t)base_weight * fee_rate + 3999) / 4000;
+
+    coins = wally_malloc(n * sizeof(*coins));
+    lookahead = wally_malloc((n + 1) * sizeof(*lookahead));
+    /* Each task needs two arrays of n indices, plus one for single coin results */
+    storage = wally_malloc((2 * MAX_TASKS + 1) * n * sizeof(*storage));
+    if (!coins || !lookahead || !storage) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+
+    /* Compute each coins effective value and sort them largest first */
+    for (i = 0, n = 0; i < values_len; ++i) {
+        const uint64_t fee = ((uint64_t)weights[i] * fee_rate + 3999) / 4000;
+        if (values[i] * 4000 > (uint64_t)weights[i] * fee_rate) {
+            coins[n].value = values[i] - fee;
+            coins[n++].index = (uint32_t)i;
+        }
+    }
+    qsort(coins, n, sizeof(*coins), coin_cmp);
+    lookahead[n] = 0;
+    for (i = n; i > 0; --i)
+        lookahead[i - 1] = lookahead[i] + coins[i - 1].value;
+
+    for (i = 0; i < MAX_TASKS; ++i) {
+        results[i].selected = storage + 2 * i * n;
+        results[i].work = storage + (2 * i + 1) * n;
+    }
+    single.selected = storage + 2 * MAX_TASKS * n;
+
+    tasks.coins = coins;
+    tasks.num_coins = n;
+    tasks.lookahead = lookahead;
+    tasks.target = target + fixed_fee;
+    tasks.cost_of_change = cost_of_change;
+    tasks.results = results;
+
+    if (tasks.target > lookahead[0])
+        goto cleanup; /* Insufficient funds after fees */
+
+    if (flags & WALLY_COINSELECT_BNB)
+        best = select_bnb(&tasks, run_fn, run_ctx);
+    if (!best && (flags & WALLY_COINSELECT_KNAPSACK))
+        best = select_knapsack(&tasks, run_fn, run_ctx, &single);
+
+    if (best) {
+        *written = best->num_selected;
+        if (best->num_selected <= len) {
+            for (i = 0; i < best->num_selected; ++i)
+                indices_out[i] = coins[best->selected[i]].index;
+            qsort(indices_out, best->num_selected, sizeof(*indices_out), index_cmp);
+        }
+    }
+
+cleanup:
+    wally_free(coins);
+    wally_free(lookahead);
+    wally_free(storage);
+    return ret;
+}
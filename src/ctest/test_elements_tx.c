@@ -1,6 +1,9 @@
 #include "config.h"
 
+#include <wally_bip32.h>
 #include <wally_crypto.h>
+#include <wally_elements.h>
+#include <wally_script.h>
 #include <wally_transaction.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -31,6 +34,31 @@ static const size_t pegin_tx_vsiz = 304; // from liquidd
 
 #define check_ret(r) if (r != WALLY_OK) return false
 
+static bool tx_bytes_roundtrip(const char *tx_hex, uint32_t flags)
+{
+    struct wally_tx *tx;
+    unsigned char *bytes;
+    char *new_hex;
+    size_t bytes_len = strlen(tx_hex) / 2, written;
+    bool ok;
+
+    if (!(bytes = malloc(bytes_len)))
+        return false;
+    ok = wally_hex_to_bytes(tx_hex, bytes, bytes_len, &written) == WALLY_OK &&
+         wally_tx_from_bytes(bytes, bytes_len, flags, &tx) == WALLY_OK;
+    free(bytes);
+    if (!ok)
+        return false;
+
+    ok = wally_tx_to_hex(tx, flags, &new_hex) == WALLY_OK;
+    if (ok) {
+        ok = !strcmp(tx_hex, new_hex);
+        wally_free_string(new_hex);
+    }
+    wally_tx_free(tx);
+    return ok;
+}
+
 static bool tx_roundtrip(const char *tx_hex, const char *sighash_hex)
 {
     struct wally_tx *tx;
@@ -55,6 +83,10 @@ static bool tx_roundtrip(const char *tx_hex, const char *sighash_hex)
     ret = wally_free_string(new_hex);
     check_ret(ret);
 
+    /* Decoding from bytes must match decoding from hex */
+    if (!tx_bytes_roundtrip(tx_hex, flags))
+        return false;
+
     ret = wally_tx_is_elements(tx, &is_elements);
     if (ret != WALLY_OK || !is_elements)
         return false;
@@ -297,6 +329,1285 @@ static bool test_tx_parse(void)
            tx_pegin(pegin_hex, pegin_wit_hex, sizeof(pegin_wit_hex) / sizeof(pegin_wit_hex[0]));
 }
 
+/* Run tasks in reverse order, as a caller supplied thread pool might */
+static void run_tasks_reversed(void *run_ctx, size_t num_tasks,
+                               wally_task_t task_fn, void *task_ctx)
+{
+    size_t *num_run = run_ctx;
+    while (num_tasks--) {
+        task_fn(task_ctx, num_tasks);
+        ++*num_run;
+    }
+}
+
+/* Signature hashes computed with a context must match those computed without */
+static bool sighash_ctx_matches(const char *tx_hex)
+{
+    static const uint32_t sighashes[] = {
+        WALLY_SIGHASH_ALL, WALLY_SIGHASH_NONE, WALLY_SIGHASH_SINGLE,
+        WALLY_SIGHASH_ALL | WALLY_SIGHASH_ANYONECANPAY,
+        WALLY_SIGHASH_NONE | WALLY_SIGHASH_ANYONECANPAY,
+        WALLY_SIGHASH_SINGLE | WALLY_SIGHASH_ANYONECANPAY
+    };
+    const uint32_t tx_flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char ct_value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN];
+    unsigned char expected[SHA256_LEN], hash[SHA256_LEN];
+    struct wally_tx_sighash_ctx *ctx;
+    struct wally_tx *tx;
+    size_t i, j, flags;
+    bool ok = true;
+
+    if (wally_tx_from_hex(tx_hex, tx_flags, &tx) != WALLY_OK)
+        return false;
+    if (wally_tx_confidential_value_from_satoshi(1000, ct_value, sizeof(ct_value)) != WALLY_OK ||
+        wally_tx_sighash_ctx_init_alloc(tx, 0, &ctx) != WALLY_OK) {
+        wally_tx_free(tx);
+        return false;
+    }
+
+    for (i = 0; ok && i < tx->num_inputs; ++i) {
+        for (j = 0; ok && j < sizeof(sighashes) / sizeof(sighashes[0]); ++j) {
+            for (flags = 0; ok && flags <= WALLY_TX_FLAG_USE_WITNESS; ++flags) {
+                const struct wally_tx_input *in = &tx->inputs[i];
+                const unsigned char *value = flags ? ct_value : NULL;
+                const size_t value_len = flags ? sizeof(ct_value) : 0;
+
+                ok = wally_tx_get_elements_signature_hash(tx, i, in->script, in->script_len,
+                                                          value, value_len, sighashes[j],
+                                                          flags, expected,
+                                                          sizeof(expected)) == WALLY_OK &&
+                     wally_tx_get_elements_signature_hash_ctx(tx, ctx, i, in->script,
+                                                              in->script_len, value, value_len,
+                                                              sighashes[j], flags, hash,
+                                                              sizeof(hash)) == WALLY_OK &&
+                     !memcmp(expected, hash, sizeof(hash));
+            }
+        }
+    }
+
+    wally_tx_sighash_ctx_free(ctx);
+    wally_tx_free(tx);
+    return ok;
+}
+
+static bool test_sighash_ctx(void)
+{
+    const uint32_t tx_flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char ct_value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN], hash[SHA256_LEN];
+    struct wally_tx_sighash_ctx *ctx;
+    struct wally_tx *tx, *other;
+    bool ok;
+
+    if (!sighash_ctx_matches(asset_issuance_hex) || !sighash_ctx_matches(wit_hex) ||
+        !sighash_ctx_matches(pegin_hex))
+        return false;
+
+    /* The context must match the transaction it was created from */
+    if (wally_tx_from_hex(asset_issuance_hex, tx_flags, &tx) != WALLY_OK)
+        return false;
+    if (wally_tx_from_hex(wit_hex, tx_flags, &other) != WALLY_OK) {
+        wally_tx_free(tx);
+        return false;
+    }
+    ok = wally_tx_confidential_value_from_satoshi(1000, ct_value, sizeof(ct_value)) == WALLY_OK &&
+         wally_tx_sighash_ctx_init_alloc(tx, 0, &ctx) == WALLY_OK;
+    if (ok) {
+        ok = wally_tx_get_elements_signature_hash_ctx(other, ctx, 0, NULL, 0,
+                                                      ct_value, sizeof(ct_value),
+                                                      WALLY_SIGHASH_ALL,
+                                                      WALLY_TX_FLAG_USE_WITNESS,
+                                                      hash, sizeof(hash)) == WALLY_EINVAL;
+        wally_tx_sighash_ctx_free(ctx);
+    }
+    wally_tx_free(other);
+    wally_tx_free(tx);
+    return ok;
+}
+
+static bool bytes_within(const unsigned char *p, const unsigned char *bytes, size_t len)
+{
+    return p >= bytes && p < bytes + len;
+}
+
+static bool test_reference_proofs(void)
+{
+    const uint32_t flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char *bytes, *serialized;
+    struct wally_tx *tx, *copy = NULL;
+    struct wally_tx_output *out;
+    size_t bytes_len = strlen(wit_hex) / 2, written;
+    bool ok = false;
+
+    /* Referencing needs bytes that outlive the tx, which from_hex can't provide */
+    if (wally_tx_from_hex(wit_hex, flags | WALLY_TX_FLAG_REFERENCE_PROOFS, &tx) != WALLY_EINVAL)
+        return false;
+
+    bytes = malloc(bytes_len);
+    serialized = malloc(bytes_len);
+    if (!bytes || !serialized ||
+        wally_hex_to_bytes(wit_hex, bytes, bytes_len, &written) != WALLY_OK ||
+        wally_tx_from_bytes(bytes, bytes_len, WALLY_TX_FLAG_USE_WITNESS |
+                            WALLY_TX_FLAG_REFERENCE_PROOFS, &tx) != WALLY_EINVAL ||
+        wally_tx_from_bytes(bytes, bytes_len, flags | WALLY_TX_FLAG_REFERENCE_PROOFS,
+                            &tx) != WALLY_OK) {
+        free(bytes);
+        free(serialized);
+        return false;
+    }
+
+    /* Proofs point into the source bytes, and serialize unchanged */
+    out = &tx->outputs[1];
+    if ((tx->outputs[0].features & WALLY_TX_PROOFS_REFERENCED) || /* No proofs */
+        !(out->features & WALLY_TX_PROOFS_REFERENCED) ||
+        !bytes_within(out->surjectionproof, bytes, bytes_len) ||
+        !bytes_within(out->rangeproof, bytes, bytes_len) ||
+        wally_tx_to_bytes(tx, flags, serialized, bytes_len, &written) != WALLY_OK ||
+        written != bytes_len || memcmp(bytes, serialized, bytes_len))
+        goto done;
+
+    /* Cloning an output copies its proofs */
+    if (wally_tx_init_alloc(2, 0, 0, 1, &copy) != WALLY_OK ||
+        wally_tx_add_output(copy, out) != WALLY_OK ||
+        (copy->outputs[0].features & WALLY_TX_PROOFS_REFERENCED) ||
+        bytes_within(copy->outputs[0].rangeproof, bytes, bytes_len) ||
+        memcmp(copy->outputs[0].rangeproof, out->rangeproof, out->rangeproof_len))
+        goto done;
+
+    /* Replacing the proofs copies them */
+    if (wally_tx_elements_output_commitment_set(out, copy->outputs[0].asset,
+                                                copy->outputs[0].asset_len,
+                                                copy->outputs[0].value,
+                                                copy->outputs[0].value_len,
+                                                copy->outputs[0].nonce,
+                                                copy->outputs[0].nonce_len,
+                                                copy->outputs[0].surjectionproof,
+                                                copy->outputs[0].surjectionproof_len,
+                                                copy->outputs[0].rangeproof,
+                                                copy->outputs[0].rangeproof_len) != WALLY_OK ||
+        (out->features & WALLY_TX_PROOFS_REFERENCED) ||
+        bytes_within(out->rangeproof, bytes, bytes_len) ||
+        wally_tx_to_bytes(tx, flags, serialized, bytes_len, &written) != WALLY_OK ||
+        written != bytes_len || memcmp(bytes, serialized, bytes_len))
+        goto done;
+
+    /* Freeing the tx leaves the source bytes intact */
+    wally_tx_free(tx);
+    tx = NULL;
+    ok = wally_tx_from_bytes(bytes, bytes_len, flags, &tx) == WALLY_OK;
+
+done:
+    wally_tx_free(copy);
+    wally_tx_free(tx);
+    free(bytes);
+    free(serialized);
+    return ok;
+}
+
+static bool test_issuance_ids(void)
+{
+    const uint32_t flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char entropy[2 * SHA256_LEN], asset[2 * SHA256_LEN], token[2 * SHA256_LEN];
+    unsigned char expected[SHA256_LEN], zero[SHA256_LEN] = { 0 };
+    const struct wally_tx_input *in;
+    struct wally_tx *tx;
+    uint32_t indices[2];
+    size_t written;
+    bool ok;
+
+    if (wally_tx_from_hex(asset_issuance_hex, flags, &tx) != WALLY_OK)
+        return false;
+    in = &tx->inputs[0];
+
+    /* An initial issuance matches the individual calculations */
+    ok = wally_tx_elements_issuance_calculate_ids(tx, indices, entropy, sizeof(entropy),
+                                                  asset, sizeof(asset), token, sizeof(token),
+                                                  2, &written) == WALLY_OK &&
+         written == 1 && indices[0] == 0 &&
+         wally_tx_elements_issuance_generate_entropy(in->txhash, sizeof(in->txhash),
+                                                     in->index, in->entropy,
+                                                     sizeof(in->entropy), expected,
+                                                     sizeof(expected)) == WALLY_OK &&
+         !memcmp(entropy, expected, SHA256_LEN) &&
+         wally_tx_elements_issuance_calculate_asset(entropy, SHA256_LEN, expected,
+                                                    sizeof(expected)) == WALLY_OK &&
+         !memcmp(asset, expected, SHA256_LEN) &&
+         wally_tx_elements_issuance_calculate_reissuance_token(
+             entropy, SHA256_LEN,
+             in->issuance_amount_len == WALLY_TX_ASSET_CT_VALUE_LEN ?
+             WALLY_TX_FLAG_BLINDED_INITIAL_ISSUANCE : 0,
+             expected, sizeof(expected)) == WALLY_OK &&
+         !memcmp(token, expected, SHA256_LEN);
+
+    /* A re-issuance carries its entropy and creates no token */
+    tx->inputs[0].blinding_nonce[0] = 1;
+    ok = ok && wally_tx_elements_issuance_calculate_ids(tx, indices, entropy, SHA256_LEN,
+                                                        asset, SHA256_LEN, token, SHA256_LEN,
+                                                        1, &written) == WALLY_OK &&
+         written == 1 && !memcmp(entropy, in->entropy, SHA256_LEN) &&
+         wally_tx_elements_issuance_calculate_asset(in->entropy, sizeof(in->entropy),
+                                                    expected, sizeof(expected)) == WALLY_OK &&
+         !memcmp(asset, expected, SHA256_LEN) && !memcmp(token, zero, SHA256_LEN);
+
+    /* Invalid arguments */
+    ok = ok && wally_tx_elements_issuance_calculate_ids(NULL, indices, entropy, SHA256_LEN,
+                                                        asset, SHA256_LEN, token, SHA256_LEN,
+                                                        1, &written) == WALLY_EINVAL &&
+         wally_tx_elements_issuance_calculate_ids(tx, indices, entropy, SHA256_LEN,
+                                                  asset, SHA256_LEN, token, SHA256_LEN,
+                                                  2, &written) == WALLY_EINVAL;
+
+    wally_tx_free(tx);
+    return ok;
+}
+
+static bool test_blind_sum(void)
+{
+    static const uint64_t values[5] = { 20000, 7000, 12000, 9000, 10000 };
+    unsigned char abfs[5 * ASSET_TAG_LEN], vbfs[4 * ASSET_TAG_LEN];
+    unsigned char expected[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN], bad[ASSET_TAG_LEN];
+    struct wally_asset_blind_sum sum, saved;
+    size_t i;
+
+    for (i = 0; i < sizeof(abfs); ++i)
+        abfs[i] = (unsigned char)(i * 7 + 1);
+    for (i = 0; i < sizeof(vbfs); ++i)
+        vbfs[i] = (unsigned char)(i * 13 + 2);
+    memset(bad, 0xff, sizeof(bad)); /* Larger than the group order */
+
+    /* Two inputs, three outputs: the final output balances the rest */
+    if (wally_asset_final_vbf(values, 5, 2, abfs, sizeof(abfs), vbfs, sizeof(vbfs),
+                              expected, sizeof(expected)) != WALLY_OK)
+        return false;
+
+    /* Adding in any order matches, and the balance can be saved and restored */
+    if (wally_asset_blind_sum_init(&sum) != WALLY_OK ||
+        wally_asset_blind_sum_add_output(&sum, values[3], abfs + 3 * ASSET_TAG_LEN,
+                                         ASSET_TAG_LEN, vbfs + 3 * ASSET_TAG_LEN,
+                                         ASSET_TAG_LEN) != WALLY_OK ||
+        wally_asset_blind_sum_add_input(&sum, values[1], abfs + ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                        vbfs + ASSET_TAG_LEN, ASSET_TAG_LEN) != WALLY_OK)
+        return false;
+    saved = sum;
+    if (wally_asset_blind_sum_add_output(&sum, 1, abfs, ASSET_TAG_LEN,
+                                         vbfs, ASSET_TAG_LEN) != WALLY_OK)
+        return false; /* A candidate output that is then discarded */
+    sum = saved;
+    if (wally_asset_blind_sum_add_input(&sum, values[0], abfs, ASSET_TAG_LEN,
+                                        vbfs, ASSET_TAG_LEN) != WALLY_OK ||
+        wally_asset_blind_sum_add_output(&sum, values[2], abfs + 2 * ASSET_TAG_LEN,
+                                         ASSET_TAG_LEN, vbfs + 2 * ASSET_TAG_LEN,
+                                         ASSET_TAG_LEN) != WALLY_OK ||
+        wally_asset_blind_sum_final_vbf(&sum, values[4], abfs + 4 * ASSET_TAG_LEN,
+                                        ASSET_TAG_LEN, vbf, sizeof(vbf)) != WALLY_OK ||
+        memcmp(vbf, expected, sizeof(vbf)))
+        return false;
+
+    /* Out of range blinding factors leave the balance unchanged */
+    saved = sum;
+    if (wally_asset_blind_sum_add_input(&sum, 1, bad, sizeof(bad),
+                                        vbfs, ASSET_TAG_LEN) != WALLY_EINVAL ||
+        wally_asset_blind_sum_add_output(&sum, 1, abfs, ASSET_TAG_LEN,
+                                         bad, sizeof(bad)) != WALLY_EINVAL ||
+        wally_asset_blind_sum_final_vbf(&sum, 1, bad, sizeof(bad),
+                                        vbf, sizeof(vbf)) != WALLY_EINVAL ||
+        memcmp(&sum, &saved, sizeof(sum)))
+        return false;
+
+    /* Invalid arguments */
+    if (wally_asset_blind_sum_init(NULL) != WALLY_EINVAL ||
+        wally_asset_blind_sum_add_input(NULL, 1, abfs, ASSET_TAG_LEN,
+                                        vbfs, ASSET_TAG_LEN) != WALLY_EINVAL ||
+        wally_asset_blind_sum_add_output(&sum, 1, abfs, ASSET_TAG_LEN - 1,
+                                         vbfs, ASSET_TAG_LEN) != WALLY_EINVAL ||
+        wally_asset_blind_sum_add_output(&sum, 1, abfs, ASSET_TAG_LEN,
+                                         NULL, ASSET_TAG_LEN) != WALLY_EINVAL ||
+        wally_asset_blind_sum_final_vbf(&sum, 1, abfs, ASSET_TAG_LEN,
+                                        vbf, sizeof(vbf) - 1) != WALLY_EINVAL)
+        return false;
+
+    wally_bzero(&sum, sizeof(sum));
+    wally_bzero(&saved, sizeof(saved));
+    return true;
+}
+
+static size_t num_allocs;
+
+static void *counting_malloc(size_t len)
+{
+    ++num_allocs;
+    return malloc(len);
+}
+
+static bool final_vbf_allocs(size_t expected)
+{
+    static const uint64_t values[3] = { 20000, 12000, 8000 };
+    unsigned char abfs[3 * ASSET_TAG_LEN], vbfs[2 * ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+
+    memset(abfs, 1, sizeof(abfs));
+    memset(vbfs, 2, sizeof(vbfs));
+    num_allocs = 0;
+    return wally_asset_final_vbf(values, 3, 1, abfs, sizeof(abfs), vbfs, sizeof(vbfs),
+                                 vbf, sizeof(vbf)) == WALLY_OK &&
+           num_allocs == expected;
+}
+
+static bool test_scratch(void)
+{
+    struct wally_operations ops, orig_ops;
+    size_t limit;
+    bool ok;
+
+    if (wally_get_scratch_limit(&limit) != WALLY_OK ||
+        limit != WALLY_SCRATCH_LIMIT_DEFAULT ||
+        wally_get_scratch_limit(NULL) != WALLY_EINVAL ||
+        wally_get_operations(&orig_ops) != WALLY_OK)
+        return false;
+
+    ops = orig_ops;
+    ops.malloc_fn = counting_malloc;
+    ops.free_fn = free;
+    if (wally_set_operations(&ops) != WALLY_OK)
+        return false;
+
+    /* The first call allocates scratch memory, later calls reuse it */
+    ok = final_vbf_allocs(1) && final_vbf_allocs(0) && final_vbf_allocs(0);
+
+    /* With no limit nothing is kept, so every call allocates */
+    ok = ok && wally_set_scratch_limit(0) == WALLY_OK &&
+         final_vbf_allocs(1) && final_vbf_allocs(1) &&
+         wally_set_scratch_limit(WALLY_SCRATCH_LIMIT_DEFAULT) == WALLY_OK &&
+         final_vbf_allocs(1) && final_vbf_allocs(0);
+
+    return wally_set_operations(&orig_ops) == WALLY_OK && ok;
+}
+
+static bool output_script_types_match(const char *tx_hex, const unsigned char *expected,
+                                      size_t num_expected)
+{
+    const uint32_t flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char *bytes, types[8], types_from_bytes[8];
+    size_t bytes_len = strlen(tx_hex) / 2, written, i;
+    struct wally_tx *tx = NULL;
+    bool ok = false;
+
+    bytes = malloc(bytes_len);
+    if (!bytes ||
+        wally_hex_to_bytes(tx_hex, bytes, bytes_len, &written) != WALLY_OK ||
+        wally_tx_from_bytes(bytes, bytes_len, flags, &tx) != WALLY_OK ||
+        wally_tx_get_output_script_types(tx, types, sizeof(types), &written) != WALLY_OK ||
+        written != num_expected || memcmp(types, expected, num_expected) ||
+        wally_tx_get_output_script_types_from_bytes(bytes, bytes_len, WALLY_TX_FLAG_USE_ELEMENTS,
+                                                    types_from_bytes, sizeof(types_from_bytes),
+                                                    &written) != WALLY_OK ||
+        written != num_expected || memcmp(types_from_bytes, expected, num_expected) ||
+        /* Parsing as a non-elements transaction fails */
+        wally_tx_get_output_script_types_from_bytes(bytes, bytes_len, 0, types_from_bytes,
+                                                    sizeof(types_from_bytes),
+                                                    &written) == WALLY_OK)
+        goto done;
+
+    /* The types match classifying each output individually */
+    for (i = 0; i < tx->num_outputs; ++i) {
+        size_t script_type = WALLY_SCRIPT_TYPE_UNKNOWN;
+        if (tx->outputs[i].script_len &&
+            wally_scriptpubkey_get_type(tx->outputs[i].script, tx->outputs[i].script_len,
+                                        &script_type) != WALLY_OK)
+            goto done;
+        if (script_type != types[i])
+            goto done;
+    }
+    ok = true;
+
+done:
+    wally_tx_free(tx);
+    free(bytes);
+    return ok;
+}
+
+static bool test_output_script_types(void)
+{
+    /* Fee outputs have an empty script */
+    const unsigned char wit_types[] = {
+        WALLY_SCRIPT_TYPE_UNKNOWN, WALLY_SCRIPT_TYPE_P2SH, WALLY_SCRIPT_TYPE_P2SH
+    };
+    const unsigned char coinbase_types[] = {
+        WALLY_SCRIPT_TYPE_P2PKH, WALLY_SCRIPT_TYPE_OP_RETURN
+    };
+    const unsigned char pegin_types[] = {
+        WALLY_SCRIPT_TYPE_P2PKH, WALLY_SCRIPT_TYPE_UNKNOWN
+    };
+
+    return output_script_types_match(wit_hex, wit_types, sizeof(wit_types)) &&
+           output_script_types_match(coinbase_hex, coinbase_types, sizeof(coinbase_types)) &&
+           output_script_types_match(pegin_hex, pegin_types, sizeof(pegin_types));
+}
+
+static bool test_rangeproof_verify(void)
+{
+    unsigned char asset[ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN], commitment[ASSET_COMMITMENT_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char proof[ASSET_RANGEPROOF_MAX_LEN], extra[] = { 0x6a, 0x01, 0x02 };
+    const uint32_t flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    struct wally_tx *tx;
+    size_t proof_len, num_run = 0;
+    int ret;
+
+    memset(asset, 1, sizeof(asset));
+    memset(abf, 2, sizeof(abf));
+    memset(vbf, 3, sizeof(vbf));
+    memset(priv_key, 4, sizeof(priv_key));
+    if (wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                             pub_key, sizeof(pub_key)) != WALLY_OK ||
+        wally_asset_generator_from_bytes(asset, sizeof(asset), abf, sizeof(abf),
+                                         generator, sizeof(generator)) != WALLY_OK ||
+        wally_asset_value_commitment(1000, vbf, sizeof(vbf), generator, sizeof(generator),
+                                     commitment, sizeof(commitment)) != WALLY_OK ||
+        wally_asset_rangeproof(1000, pub_key, sizeof(pub_key), priv_key, sizeof(priv_key),
+                               asset, sizeof(asset), abf, sizeof(abf), vbf, sizeof(vbf),
+                               commitment, sizeof(commitment), extra, sizeof(extra),
+                               generator, sizeof(generator), 1,
+                               proof, sizeof(proof), &proof_len) != WALLY_OK)
+        return false;
+
+    /* A proof verifies only against its own commitment and extra data */
+    if (wally_asset_rangeproof_verify(proof, proof_len, commitment, sizeof(commitment),
+                                      extra, sizeof(extra),
+                                      generator, sizeof(generator)) != WALLY_OK ||
+        wally_asset_rangeproof_verify(proof, proof_len, commitment, sizeof(commitment),
+                                      extra, sizeof(extra) - 1,
+                                      generator, sizeof(generator)) != WALLY_EINVAL ||
+        wally_asset_rangeproof_verify(proof, proof_len - 1, commitment, sizeof(commitment),
+                                      extra, sizeof(extra),
+                                      generator, sizeof(generator)) != WALLY_EINVAL ||
+        wally_asset_rangeproof_verify(NULL, 0, commitment, sizeof(commitment),
+                                      extra, sizeof(extra),
+                                      generator, sizeof(generator)) != WALLY_EINVAL)
+        return false;
+
+    proof[proof_len / 2] ^= 1;
+    if (wally_asset_rangeproof_verify(proof, proof_len, commitment, sizeof(commitment),
+                                      extra, sizeof(extra),
+                                      generator, sizeof(generator)) != WALLY_EINVAL)
+        return false;
+
+    /* Verify every confidential output of a transaction from elementsd */
+    ret = wally_tx_from_hex(wit_hex, flags, &tx);
+    check_ret(ret);
+
+    if (wally_asset_rangeproof_verify_tx(tx, NULL, NULL) != WALLY_OK ||
+        wally_asset_rangeproof_verify_tx(tx, run_tasks_reversed, &num_run) != WALLY_OK ||
+        num_run != 2)
+        return false;
+
+    tx->outputs[1].rangeproof[100] ^= 1;
+    if (wally_asset_rangeproof_verify_tx(tx, run_tasks_reversed, &num_run) != WALLY_EINVAL ||
+        wally_asset_rangeproof_verify_tx(NULL, NULL, NULL) != WALLY_EINVAL)
+        return false;
+
+    ret = wally_tx_free(tx);
+    check_ret(ret);
+    return true;
+}
+
+static bool test_parsed_generator(void)
+{
+    unsigned char asset[ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN], bytes[ASSET_GENERATOR_LEN];
+    unsigned char commitment[ASSET_COMMITMENT_LEN], parsed_commitment[ASSET_COMMITMENT_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char proof[ASSET_RANGEPROOF_MAX_LEN], parsed_proof[ASSET_RANGEPROOF_MAX_LEN];
+    struct wally_asset_generator *gen, *blinded, *unblinded;
+    struct wally_ec_public_key *key;
+    size_t proof_len, parsed_proof_len;
+    bool ok;
+
+    memset(asset, 1, sizeof(asset));
+    memset(abf, 2, sizeof(abf));
+    memset(vbf, 3, sizeof(vbf));
+    memset(priv_key, 4, sizeof(priv_key));
+    if (wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                             pub_key, sizeof(pub_key)) != WALLY_OK ||
+        wally_ec_public_key_init_alloc(pub_key, sizeof(pub_key), &key) != WALLY_OK ||
+        wally_asset_generator_from_bytes(asset, sizeof(asset), abf, sizeof(abf),
+                                         generator, sizeof(generator)) != WALLY_OK ||
+        wally_asset_value_commitment(1000, vbf, sizeof(vbf), generator, sizeof(generator),
+                                     commitment, sizeof(commitment)) != WALLY_OK ||
+        wally_asset_rangeproof(1000, pub_key, sizeof(pub_key), priv_key, sizeof(priv_key),
+                               asset, sizeof(asset), abf, sizeof(abf), vbf, sizeof(vbf),
+                               commitment, sizeof(commitment), NULL, 0,
+                               generator, sizeof(generator), 1,
+                               proof, sizeof(proof), &proof_len) != WALLY_OK)
+        return false;
+
+    if (wally_asset_generator_init_alloc(generator, sizeof(generator), &gen) != WALLY_OK ||
+        wally_asset_generator_from_tag_alloc(asset, sizeof(asset), abf, sizeof(abf),
+                                             &blinded) != WALLY_OK ||
+        wally_asset_generator_from_tag_alloc(asset, sizeof(asset), NULL, 0,
+                                             &unblinded) != WALLY_OK)
+        return false;
+
+    /* Parsed and unparsed generators give identical results */
+    ok = wally_asset_generator_to_bytes(blinded, bytes, sizeof(bytes)) == WALLY_OK &&
+         !memcmp(bytes, generator, sizeof(bytes)) &&
+         wally_asset_value_commitment_parsed(1000, vbf, sizeof(vbf), gen,
+                                             parsed_commitment,
+                                             sizeof(parsed_commitment)) == WALLY_OK &&
+         !memcmp(parsed_commitment, commitment, sizeof(commitment)) &&
+         wally_asset_rangeproof_parsed(1000, key, priv_key, sizeof(priv_key),
+                                       asset, sizeof(asset), abf, sizeof(abf),
+                                       vbf, sizeof(vbf), commitment, sizeof(commitment),
+                                       NULL, 0, blinded, 1, parsed_proof,
+                                       sizeof(parsed_proof), &parsed_proof_len) == WALLY_OK &&
+         parsed_proof_len == proof_len && !memcmp(parsed_proof, proof, proof_len);
+
+    /* An unblinded generator round trips through its serialization */
+    ok = ok && wally_asset_generator_to_bytes(unblinded, bytes, sizeof(bytes)) == WALLY_OK &&
+         memcmp(bytes, generator, sizeof(bytes)) &&
+         wally_asset_generator_free(gen) == WALLY_OK &&
+         wally_asset_generator_init_alloc(bytes, sizeof(bytes), &gen) == WALLY_OK &&
+         wally_asset_generator_to_bytes(gen, generator, sizeof(generator)) == WALLY_OK &&
+         !memcmp(bytes, generator, sizeof(bytes));
+
+    /* Invalid arguments */
+    wally_asset_generator_free(blinded);
+    bytes[0] = 0xff;
+    ok = ok && wally_asset_generator_init_alloc(bytes, sizeof(bytes), &blinded) == WALLY_EINVAL &&
+         !blinded &&
+         wally_asset_generator_from_tag_alloc(asset, sizeof(asset), NULL, sizeof(abf),
+                                              &blinded) == WALLY_EINVAL &&
+         wally_asset_generator_to_bytes(gen, bytes, sizeof(bytes) - 1) == WALLY_EINVAL &&
+         wally_asset_value_commitment_parsed(1000, vbf, sizeof(vbf), NULL,
+                                             parsed_commitment,
+                                             sizeof(parsed_commitment)) == WALLY_EINVAL &&
+         wally_asset_rangeproof_parsed(1000, key, priv_key, sizeof(priv_key),
+                                       asset, sizeof(asset), abf, sizeof(abf),
+                                       vbf, sizeof(vbf), commitment, sizeof(commitment),
+                                       NULL, 0, NULL, 1, parsed_proof,
+                                       sizeof(parsed_proof), &parsed_proof_len) == WALLY_EINVAL &&
+         wally_asset_generator_free(NULL) == WALLY_EINVAL;
+
+    wally_asset_generator_free(gen);
+    wally_asset_generator_free(unblinded);
+    wally_ec_public_key_free(key);
+    return ok;
+}
+
+static bool test_rangeproof_size(void)
+{
+    const uint64_t values[] = { 0, 1, 1000, 0xffffffff, 1ull << 40, 0x7fffffffffffffffull };
+    unsigned char asset[ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN], commitment[ASSET_COMMITMENT_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char proof[ASSET_RANGEPROOF_MAX_LEN], script[] = { 0x00, 0x14, 0 };
+    struct wally_tx *tx;
+    uint64_t min_value;
+    size_t i, proof_len, written;
+
+    memset(asset, 1, sizeof(asset));
+    memset(abf, 2, sizeof(abf));
+    memset(vbf, 3, sizeof(vbf));
+    memset(priv_key, 4, sizeof(priv_key));
+    if (wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                             pub_key, sizeof(pub_key)) != WALLY_OK ||
+        wally_asset_generator_from_bytes(asset, sizeof(asset), abf, sizeof(abf),
+                                         generator, sizeof(generator)) != WALLY_OK)
+        return false;
+
+    /* Proofs fit exactly in a buffer of the predicted size */
+    for (i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+        for (min_value = 0; min_value < 2 && min_value <= values[i]; ++min_value) {
+            if (wally_asset_rangeproof_size(values[i], min_value, ASSET_RANGEPROOF_EXP,
+                                            ASSET_RANGEPROOF_MIN_BITS,
+                                            &proof_len) != WALLY_OK ||
+                wally_asset_value_commitment(values[i], vbf, sizeof(vbf),
+                                             generator, sizeof(generator),
+                                             commitment, sizeof(commitment)) != WALLY_OK ||
+                wally_asset_rangeproof(values[i], pub_key, sizeof(pub_key),
+                                       priv_key, sizeof(priv_key),
+                                       asset, sizeof(asset), abf, sizeof(abf),
+                                       vbf, sizeof(vbf), commitment, sizeof(commitment),
+                                       NULL, 0, generator, sizeof(generator), min_value,
+                                       proof, proof_len - 1, &written) != WALLY_EINVAL ||
+                wally_asset_rangeproof(values[i], pub_key, sizeof(pub_key),
+                                       priv_key, sizeof(priv_key),
+                                       asset, sizeof(asset), abf, sizeof(abf),
+                                       vbf, sizeof(vbf), commitment, sizeof(commitment),
+                                       NULL, 0, generator, sizeof(generator), min_value,
+                                       proof, proof_len, &written) != WALLY_OK ||
+                written != proof_len)
+                return false;
+        }
+    }
+
+    if (wally_asset_rangeproof_size(1, 0, -1, 0, &proof_len) != WALLY_OK ||
+        proof_len != 1 + 8 + 32 * 2 + 32 ||
+        wally_asset_rangeproof_size(1, 2, 0, 32, &proof_len) != WALLY_EINVAL ||
+        wally_asset_rangeproof_size(1, 0, 19, 32, &proof_len) != WALLY_EINVAL ||
+        wally_asset_rangeproof_size(1, 0, 0, 65, &proof_len) != WALLY_EINVAL ||
+        wally_asset_rangeproof_size(1, 0, 0, 32, NULL) != WALLY_EINVAL)
+        return false;
+
+    /* Proofs can be created directly into an output */
+    if (wally_tx_init_alloc(2, 0, 0, 1, &tx) != WALLY_OK ||
+        wally_tx_add_elements_raw_output(tx, script, sizeof(script),
+                                         generator, sizeof(generator),
+                                         commitment, sizeof(commitment),
+                                         pub_key, sizeof(pub_key), NULL, 0,
+                                         NULL, 0, 0) != WALLY_OK ||
+        wally_asset_rangeproof_verify_tx(tx, NULL, NULL) != WALLY_EINVAL)
+        return false;
+    --i; /* commitment is to the last value */
+    if (wally_tx_elements_output_rangeproof_set(tx->outputs, values[i], pub_key, sizeof(pub_key),
+                                                priv_key, sizeof(priv_key),
+                                                asset, sizeof(asset), abf, sizeof(abf),
+                                                vbf, sizeof(vbf), 1) != WALLY_OK ||
+        wally_asset_rangeproof_size(values[i], 1, ASSET_RANGEPROOF_EXP,
+                                    ASSET_RANGEPROOF_MIN_BITS, &proof_len) != WALLY_OK ||
+        tx->outputs[0].rangeproof_len != proof_len ||
+        wally_asset_rangeproof_verify_tx(tx, NULL, NULL) != WALLY_OK ||
+        wally_tx_elements_output_rangeproof_set(tx->outputs, values[i], pub_key, sizeof(pub_key),
+                                                priv_key, sizeof(priv_key),
+                                                asset, sizeof(asset), abf, sizeof(abf),
+                                                vbf, sizeof(vbf), 1) != WALLY_OK ||
+        wally_tx_elements_output_rangeproof_set(NULL, values[i], pub_key, sizeof(pub_key),
+                                                priv_key, sizeof(priv_key),
+                                                asset, sizeof(asset), abf, sizeof(abf),
+                                                vbf, sizeof(vbf), 1) != WALLY_EINVAL)
+        return false;
+
+    return wally_tx_free(tx) == WALLY_OK;
+}
+
+/* Add an output of value blinded to pub_key, with an ephemeral key of seed */
+static bool add_blinded_output(struct wally_tx *tx, uint64_t value,
+                               const unsigned char *pub_key, unsigned char seed)
+{
+    unsigned char asset[ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN], commitment[ASSET_COMMITMENT_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], nonce[EC_PUBLIC_KEY_LEN];
+    unsigned char proof[ASSET_RANGEPROOF_MAX_LEN], script[] = { 0x00, 0x14, 0 };
+    size_t proof_len;
+
+    memset(asset, 1, sizeof(asset));
+    memset(abf, seed + 1, sizeof(abf));
+    memset(vbf, seed + 2, sizeof(vbf));
+    memset(priv_key, seed + 3, sizeof(priv_key));
+    script[2] = seed;
+    return wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                                nonce, sizeof(nonce)) == WALLY_OK &&
+           wally_asset_generator_from_bytes(asset, sizeof(asset), abf, sizeof(abf),
+                                            generator, sizeof(generator)) == WALLY_OK &&
+           wally_asset_value_commitment(value, vbf, sizeof(vbf), generator, sizeof(generator),
+                                        commitment, sizeof(commitment)) == WALLY_OK &&
+           wally_asset_rangeproof(value, pub_key, EC_PUBLIC_KEY_LEN,
+                                  priv_key, sizeof(priv_key), asset, sizeof(asset),
+                                  abf, sizeof(abf), vbf, sizeof(vbf),
+                                  commitment, sizeof(commitment), script, sizeof(script),
+                                  generator, sizeof(generator), 1,
+                                  proof, sizeof(proof), &proof_len) == WALLY_OK &&
+           wally_tx_add_elements_raw_output(tx, script, sizeof(script),
+                                            generator, sizeof(generator),
+                                            commitment, sizeof(commitment),
+                                            nonce, sizeof(nonce), NULL, 0,
+                                            proof, proof_len, 0) == WALLY_OK;
+}
+
+static bool test_unblind_tx(void)
+{
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char other_priv_key[EC_PRIVATE_KEY_LEN], other_pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char txhash[WALLY_TXHASH_LEN] = { 0 }, fee[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN];
+    unsigned char asset[ASSET_TAG_LEN], fee_asset[WALLY_TX_ASSET_CT_ASSET_LEN];
+    unsigned char assets[3 * ASSET_TAG_LEN], abfs[3 * ASSET_TAG_LEN], vbfs[3 * ASSET_TAG_LEN];
+    uint32_t indices[3];
+    uint64_t values[3];
+    struct wally_tx *tx;
+    size_t written, num_run = 0;
+
+    memset(priv_key, 10, sizeof(priv_key));
+    memset(other_priv_key, 11, sizeof(other_priv_key));
+    memset(asset, 1, sizeof(asset));
+    memset(fee_asset, 1, sizeof(fee_asset));
+    if (wally_ec_public_key_from_private_key(priv_key, sizeof(priv_key),
+                                             pub_key, sizeof(pub_key)) != WALLY_OK ||
+        wally_ec_public_key_from_private_key(other_priv_key, sizeof(other_priv_key),
+                                             other_pub_key, sizeof(other_pub_key)) != WALLY_OK ||
+        wally_tx_confidential_value_from_satoshi(500, fee, sizeof(fee)) != WALLY_OK ||
+        wally_tx_init_alloc(2, 0, 1, 4, &tx) != WALLY_OK)
+        return false;
+
+    /* Outputs 0 and 2 are sent to pub_key, 1 to another key, 3 is the fee */
+    if (wally_tx_add_elements_raw_input(tx, txhash, sizeof(txhash), 0, 0xffffffff,
+                                        NULL, 0, NULL, NULL, 0, NULL, 0, NULL, 0,
+                                        NULL, 0, NULL, 0, NULL, 0, NULL, 0) != WALLY_OK ||
+        !add_blinded_output(tx, 1000, pub_key, 20) ||
+        !add_blinded_output(tx, 2000, other_pub_key, 30) ||
+        !add_blinded_output(tx, 3000, pub_key, 40) ||
+        wally_tx_add_elements_raw_output(tx, NULL, 0, fee_asset, sizeof(fee_asset),
+                                         fee, sizeof(fee), NULL, 0, NULL, 0,
+                                         NULL, 0, 0) != WALLY_OK ||
+        wally_asset_rangeproof_verify_tx(tx, NULL, NULL) != WALLY_OK)
+        return false;
+
+    if (wally_asset_unblind_tx(tx, priv_key, sizeof(priv_key),
+                               run_tasks_reversed, &num_run, indices,
+                               assets, sizeof(assets), abfs, sizeof(abfs),
+                               vbfs, sizeof(vbfs), values, 3, &written) != WALLY_OK ||
+        num_run != 3 || written != 2 ||
+        indices[0] != 0 || values[0] != 1000 || indices[1] != 2 || values[1] != 3000 ||
+        memcmp(assets, asset, ASSET_TAG_LEN) || abfs[0] != 21 || vbfs[0] != 22 ||
+        memcmp(assets + ASSET_TAG_LEN, asset, ASSET_TAG_LEN) ||
+        abfs[ASSET_TAG_LEN] != 41 || vbfs[ASSET_TAG_LEN] != 42)
+        return false;
+
+    /* Too few results: the number found is returned, with the first filled */
+    if (wally_asset_unblind_tx(tx, other_priv_key, sizeof(other_priv_key), NULL, NULL,
+                               indices, assets, ASSET_TAG_LEN, abfs, ASSET_TAG_LEN,
+                               vbfs, ASSET_TAG_LEN, values, 1, &written) != WALLY_OK ||
+        written != 1 || indices[0] != 1 || values[0] != 2000 ||
+        wally_asset_unblind_tx(tx, pub_key, sizeof(pub_key), NULL, NULL,
+                               indices, assets, ASSET_TAG_LEN, abfs, ASSET_TAG_LEN,
+                               vbfs, ASSET_TAG_LEN, values, 1, &written) != WALLY_EINVAL ||
+        wally_asset_unblind_tx(tx, priv_key, sizeof(priv_key), NULL, NULL,
+                               indices, assets, ASSET_TAG_LEN, abfs, ASSET_TAG_LEN,
+                               vbfs, ASSET_TAG_LEN, values, 1, &written) != WALLY_OK ||
+        written != 2 || indices[0] != 0)
+        return false;
+
+    return wally_tx_free(tx) == WALLY_OK;
+}
+
+#define SP_INPUTS 4
+#define SP_LEN (2 + 1 + 32 * 4) /* Proof size for 4 inputs, 3 used */
+
+static bool test_surjectionproof(void)
+{
+    unsigned char assets[SP_INPUTS * ASSET_TAG_LEN], abfs[SP_INPUTS * ASSET_TAG_LEN];
+    unsigned char generators[SP_INPUTS * ASSET_GENERATOR_LEN];
+    unsigned char output_assets[2 * ASSET_TAG_LEN], output_abfs[2 * ASSET_TAG_LEN];
+    unsigned char output_generators[2 * ASSET_GENERATOR_LEN], entropy[2 * 32];
+    unsigned char expected[2 * SP_LEN], proof[SP_LEN], proofs[2 * SP_LEN];
+    struct wally_asset_surjectionproof_inputs *inputs;
+    size_t i, proof_len, written, num_run = 0;
+    bool ok;
+
+    for (i = 0; i < SP_INPUTS; ++i) {
+        memset(assets + i * ASSET_TAG_LEN, 1 + i, ASSET_TAG_LEN);
+        memset(abfs + i * ASSET_TAG_LEN, 11 + i, ASSET_TAG_LEN);
+        if (wally_asset_generator_from_bytes(assets + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                             abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                             generators + i * ASSET_GENERATOR_LEN,
+                                             ASSET_GENERATOR_LEN) != WALLY_OK)
+            return false;
+    }
+    /* The outputs reblind the second and fourth input assets */
+    for (i = 0; i < 2; ++i) {
+        memcpy(output_assets + i * ASSET_TAG_LEN, assets + (1 + 2 * i) * ASSET_TAG_LEN,
+               ASSET_TAG_LEN);
+        memset(output_abfs + i * ASSET_TAG_LEN, 21 + i, ASSET_TAG_LEN);
+        memset(entropy + i * 32, 31 + i, 32);
+        if (wally_asset_generator_from_bytes(output_assets + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                             output_abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                             output_generators + i * ASSET_GENERATOR_LEN,
+                                             ASSET_GENERATOR_LEN) != WALLY_OK ||
+            wally_asset_surjectionproof(output_assets + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                        output_abfs + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                        output_generators + i * ASSET_GENERATOR_LEN,
+                                        ASSET_GENERATOR_LEN, entropy + i * 32, 32,
+                                        assets, sizeof(assets), abfs, sizeof(abfs),
+                                        generators, sizeof(generators),
+                                        expected + i * SP_LEN, SP_LEN,
+                                        &written) != WALLY_OK || written != SP_LEN)
+            return false;
+    }
+
+    if (wally_asset_surjectionproof_size(SP_INPUTS, &proof_len) != WALLY_OK ||
+        proof_len != SP_LEN ||
+        wally_asset_surjectionproof_inputs_init_alloc(assets, sizeof(assets),
+                                                      abfs, sizeof(abfs),
+                                                      generators, sizeof(generators),
+                                                      &inputs) != WALLY_OK)
+        return false;
+
+    /* Parsed inputs and batches give the same proofs as the unparsed call */
+    ok = wally_asset_surjectionproof_parsed(inputs, output_assets, ASSET_TAG_LEN,
+                                            output_abfs, ASSET_TAG_LEN,
+                                            output_generators, ASSET_GENERATOR_LEN,
+                                            entropy, 32,
+                                            ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS,
+                                            proof, sizeof(proof), &written) == WALLY_OK &&
+         written == SP_LEN && !memcmp(proof, expected, SP_LEN) &&
+         wally_asset_surjectionproof_batch(inputs, output_assets, sizeof(output_assets),
+                                           output_abfs, sizeof(output_abfs),
+                                           output_generators, sizeof(output_generators),
+                                           entropy, sizeof(entropy),
+                                           ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS,
+                                           run_tasks_reversed, &num_run,
+                                           proofs, sizeof(proofs)) == WALLY_OK &&
+         num_run == 2 && !memcmp(proofs, expected, sizeof(expected));
+
+    /* Every proof verifies against its own output generator only */
+    for (i = 0; i < 2 && ok; ++i)
+        ok = wally_asset_surjectionproof_verify(expected + i * SP_LEN, SP_LEN,
+                                                output_generators + i * ASSET_GENERATOR_LEN,
+                                                ASSET_GENERATOR_LEN,
+                                                generators, sizeof(generators)) == WALLY_OK &&
+             wally_asset_surjectionproof_verify(expected + i * SP_LEN, SP_LEN,
+                                                output_generators + (1 - i) * ASSET_GENERATOR_LEN,
+                                                ASSET_GENERATOR_LEN,
+                                                generators, sizeof(generators)) == WALLY_EINVAL;
+    memcpy(proof, expected, SP_LEN);
+    proof[SP_LEN - 1] ^= 1;
+    ok = ok && wally_asset_surjectionproof_verify(proof, SP_LEN,
+                                                  output_generators, ASSET_GENERATOR_LEN,
+                                                  generators, sizeof(generators)) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_verify(NULL, SP_LEN,
+                                            output_generators, ASSET_GENERATOR_LEN,
+                                            generators, sizeof(generators)) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_verify(expected, SP_LEN,
+                                            output_generators, ASSET_GENERATOR_LEN,
+                                            generators, sizeof(generators) - 1) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_verify(expected, SP_LEN, output_generators,
+                                            ASSET_GENERATOR_LEN, NULL, 0) == WALLY_EINVAL;
+
+    /* An output asset not among the inputs cannot be proven */
+    memset(output_assets + ASSET_TAG_LEN, 9, ASSET_TAG_LEN);
+    ok = ok && wally_asset_surjectionproof_batch(inputs, output_assets, sizeof(output_assets),
+                                                 output_abfs, sizeof(output_abfs),
+                                                 output_generators, sizeof(output_generators),
+                                                 entropy, sizeof(entropy), 10, NULL, NULL,
+                                                 proofs, sizeof(proofs)) == WALLY_ERROR &&
+         wally_asset_surjectionproof_parsed(inputs, output_assets, ASSET_TAG_LEN,
+                                            output_abfs, ASSET_TAG_LEN,
+                                            output_generators, ASSET_GENERATOR_LEN,
+                                            entropy, 32, 0, proof, sizeof(proof),
+                                            &written) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_parsed(NULL, output_assets, ASSET_TAG_LEN,
+                                            output_abfs, ASSET_TAG_LEN,
+                                            output_generators, ASSET_GENERATOR_LEN,
+                                            entropy, 32, 1, proof, sizeof(proof),
+                                            &written) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_inputs_free(NULL) == WALLY_EINVAL;
+
+    wally_asset_surjectionproof_inputs_free(inputs);
+    return ok;
+}
+
+/* Create a transaction with two explicit outputs to blind and a fee */
+static struct wally_tx *make_blind_tx(void)
+{
+    unsigned char txhash[WALLY_TXHASH_LEN] = { 0 }, asset[WALLY_TX_ASSET_CT_ASSET_LEN];
+    unsigned char value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN], script[] = { 0x00, 0x14, 0 };
+    const uint64_t satoshi[3] = { 6000, 3500, 500 };
+    struct wally_tx *tx;
+    size_t i;
+
+    memset(asset, 1, sizeof(asset));
+    if (wally_tx_init_alloc(2, 0, 1, 3, &tx) != WALLY_OK)
+        return NULL;
+    if (wally_tx_add_elements_raw_input(tx, txhash, sizeof(txhash), 0, 0xffffffff,
+                                        NULL, 0, NULL, NULL, 0, NULL, 0, NULL, 0,
+                                        NULL, 0, NULL, 0, NULL, 0, NULL, 0) != WALLY_OK)
+        goto fail;
+    for (i = 0; i < 3; ++i) {
+        script[2] = (unsigned char)i;
+        if (wally_tx_confidential_value_from_satoshi(satoshi[i], value,
+                                                     sizeof(value)) != WALLY_OK ||
+            wally_tx_add_elements_raw_output(tx, i == 2 ? NULL : script,
+                                             i == 2 ? 0 : sizeof(script),
+                                             asset, sizeof(asset), value, sizeof(value),
+                                             NULL, 0, NULL, 0, NULL, 0, 0) != WALLY_OK)
+            goto fail;
+    }
+    return tx;
+fail:
+    wally_tx_free(tx);
+    return NULL;
+}
+
+static bool test_tx_blind(void)
+{
+    const uint32_t indices[2] = { 0, 1 }, bad_indices[2] = { 1, 1 };
+    const uint64_t values[3] = { 10000, 6000, 3500 };
+    const uint32_t flags = WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS;
+    unsigned char assets[3 * ASSET_TAG_LEN], abfs[3 * ASSET_TAG_LEN], vbfs[2 * ASSET_TAG_LEN];
+    unsigned char generator[ASSET_GENERATOR_LEN], other_generator[ASSET_GENERATOR_LEN];
+    unsigned char entropy[2 * 32], ephemeral_keys[2 * EC_PRIVATE_KEY_LEN];
+    unsigned char priv_keys[2 * EC_PRIVATE_KEY_LEN];
+    unsigned char pub_keys[2 * EC_PUBLIC_KEY_LEN], final_vbf[ASSET_TAG_LEN];
+    unsigned char serial_vbf[ASSET_TAG_LEN], asset[ASSET_TAG_LEN];
+    unsigned char abf[ASSET_TAG_LEN], vbf[ASSET_TAG_LEN];
+    char *blinded_hex = NULL, *serial_hex = NULL;
+    struct wally_tx *tx = make_blind_tx(), *serial_tx = make_blind_tx();
+    struct wally_tx *read_only = NULL;
+    uint32_t index;
+    uint64_t value;
+    size_t i, written, weight, estimate, num_run = 0;
+    bool ok = tx && serial_tx;
+
+    memset(assets, 1, sizeof(assets));
+    memset(abfs, 5, ASSET_TAG_LEN);
+    memset(abfs + ASSET_TAG_LEN, 7, ASSET_TAG_LEN);
+    memset(abfs + 2 * ASSET_TAG_LEN, 8, ASSET_TAG_LEN);
+    memset(vbfs, 6, ASSET_TAG_LEN);
+    memset(vbfs + ASSET_TAG_LEN, 9, ASSET_TAG_LEN);
+    memset(entropy, 14, sizeof(entropy));
+    for (i = 0; i < 2 && ok; ++i) {
+        memset(priv_keys + i * EC_PRIVATE_KEY_LEN, 10 + i, EC_PRIVATE_KEY_LEN);
+        memset(ephemeral_keys + i * EC_PRIVATE_KEY_LEN, 12 + i, EC_PRIVATE_KEY_LEN);
+        ok = wally_ec_public_key_from_private_key(priv_keys + i * EC_PRIVATE_KEY_LEN,
+                                                  EC_PRIVATE_KEY_LEN,
+                                                  pub_keys + i * EC_PUBLIC_KEY_LEN,
+                                                  EC_PUBLIC_KEY_LEN) == WALLY_OK;
+    }
+    ok = ok && wally_asset_generator_from_bytes(assets, ASSET_TAG_LEN, abfs, ASSET_TAG_LEN,
+                                                generator, sizeof(generator)) == WALLY_OK;
+
+#define BLIND(t, idx, run_fn, run_ctx, vbf_out) \
+    wally_tx_blind(t, idx, 2, values, 3, 1, assets, sizeof(assets), abfs, sizeof(abfs), \
+                   vbfs, sizeof(vbfs), generator, sizeof(generator), \
+                   pub_keys, sizeof(pub_keys), ephemeral_keys, sizeof(ephemeral_keys), \
+                   entropy, sizeof(entropy), run_fn, run_ctx, vbf_out, ASSET_TAG_LEN)
+
+    /* Invalid outputs leave the transaction unchanged */
+    ok = ok && BLIND(tx, bad_indices, NULL, NULL, final_vbf) == WALLY_EINVAL &&
+         tx->outputs[1].value_len == WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN;
+
+    /* Read-only clones can't be blinded */
+    ok = ok && wally_tx_clone(tx, WALLY_TX_CLONE_READ_ONLY, &read_only) == WALLY_OK &&
+         BLIND(read_only, indices, NULL, NULL, final_vbf) == WALLY_EINVAL &&
+         wally_tx_elements_output_rangeproof_set(read_only->outputs, values[1],
+                                                 pub_keys, EC_PUBLIC_KEY_LEN,
+                                                 ephemeral_keys, EC_PRIVATE_KEY_LEN,
+                                                 assets, ASSET_TAG_LEN, abfs, ASSET_TAG_LEN,
+                                                 vbfs, ASSET_TAG_LEN, 1) == WALLY_EINVAL;
+    wally_tx_free(read_only);
+
+    /* The weight once blinded can be computed without creating the proofs */
+    ok = ok && wally_tx_get_blinded_weight_estimate(tx, indices, 2, values, 3, 1,
+                                                    &estimate) == WALLY_OK &&
+         wally_tx_get_blinded_weight_estimate(tx, bad_indices, 2, values, 3, 1,
+                                              &written) == WALLY_EINVAL && !written &&
+         wally_tx_get_blinded_weight_estimate(tx, indices, 2, values, 2, 1,
+                                              &written) == WALLY_EINVAL &&
+         wally_tx_get_blinded_weight_estimate(tx, indices, 2, values, 3, 0,
+                                              &written) == WALLY_EINVAL &&
+         wally_tx_get_blinded_weight_estimate(NULL, indices, 2, values, 3, 1,
+                                              &written) == WALLY_EINVAL;
+
+    /* Blinding with tasks gives the same transaction as blinding in turn */
+    ok = ok && BLIND(tx, indices, run_tasks_reversed, &num_run, final_vbf) == WALLY_OK &&
+         num_run == 2 &&
+         BLIND(serial_tx, indices, NULL, NULL, serial_vbf) == WALLY_OK &&
+         !memcmp(final_vbf, serial_vbf, sizeof(final_vbf)) &&
+         wally_tx_to_hex(tx, flags, &blinded_hex) == WALLY_OK &&
+         wally_tx_to_hex(serial_tx, flags, &serial_hex) == WALLY_OK &&
+         !strcmp(blinded_hex, serial_hex);
+#undef BLIND
+
+    /* The fee is left explicit, and every blinded output can be unblinded */
+    ok = ok && tx->outputs[2].value_len == WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN &&
+         tx->outputs[0].surjectionproof_len && tx->outputs[1].surjectionproof_len &&
+         wally_asset_rangeproof_verify_tx(tx, NULL, NULL) == WALLY_OK &&
+         wally_tx_get_weight(tx, &weight) == WALLY_OK && weight == estimate;
+
+    /* The surjection proofs verify against the input generator only */
+    num_run = 0;
+    ok = ok && wally_asset_surjectionproof_verify_tx(tx, generator, sizeof(generator),
+                                                     run_tasks_reversed, &num_run) == WALLY_OK &&
+         num_run == 2 &&
+         wally_asset_surjectionproof_verify_tx(tx, generator, sizeof(generator),
+                                               NULL, NULL) == WALLY_OK &&
+         wally_asset_surjectionproof_verify_tx(NULL, generator, sizeof(generator),
+                                               NULL, NULL) == WALLY_EINVAL &&
+         wally_asset_surjectionproof_verify_tx(tx, generator, sizeof(generator) - 1,
+                                               NULL, NULL) == WALLY_EINVAL &&
+         wally_asset_generator_from_bytes(assets, ASSET_TAG_LEN, vbfs, ASSET_TAG_LEN,
+                                          other_generator,
+                                          sizeof(other_generator)) == WALLY_OK &&
+         wally_asset_surjectionproof_verify_tx(tx, other_generator, sizeof(other_generator),
+                                               NULL, NULL) == WALLY_EINVAL;
+    for (i = 0; i < 2 && ok; ++i)
+        ok = wally_asset_unblind_tx(tx, priv_keys + i * EC_PRIVATE_KEY_LEN,
+                                    EC_PRIVATE_KEY_LEN, NULL, NULL, &index,
+                                    asset, sizeof(asset), abf, sizeof(abf),
+                                    vbf, sizeof(vbf), &value, 1, &written) == WALLY_OK &&
+             written == 1 && index == i && value == values[i + 1] &&
+             !memcmp(asset, assets, sizeof(asset)) &&
+             !memcmp(abf, abfs + (i + 1) * ASSET_TAG_LEN, sizeof(abf)) &&
+             !memcmp(vbf, i ? final_vbf : vbfs + ASSET_TAG_LEN, sizeof(vbf));
+
+    wally_free_string(blinded_hex);
+    wally_free_string(serial_hex);
+    wally_tx_free(tx);
+    wally_tx_free(serial_tx);
+    return ok;
+}
+
+static bool test_batch_encoding(void)
+{
+    const uint64_t values[3] = { 0, 1000, UINT64_MAX };
+    unsigned char asset[3 * ASSET_TAG_LEN], abf[ASSET_TAG_LEN], vbf[3 * ASSET_TAG_LEN];
+    unsigned char generator[3 * ASSET_GENERATOR_LEN], commitment[ASSET_COMMITMENT_LEN];
+    unsigned char commitments[3 * ASSET_COMMITMENT_LEN], value[WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN];
+    unsigned char explicit_values[3 * WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN];
+    unsigned char explicit_assets[3 * WALLY_TX_ASSET_CT_ASSET_LEN];
+    size_t i;
+    bool ok = true;
+
+    memset(abf, 2, sizeof(abf));
+    for (i = 0; i < 3; ++i) {
+        /* The first two values share an asset and so a generator */
+        memset(asset + i * ASSET_TAG_LEN, i ? (int)i : 1, ASSET_TAG_LEN);
+        memset(vbf + i * ASSET_TAG_LEN, 3 + (int)i, ASSET_TAG_LEN);
+        if (wally_asset_generator_from_bytes(asset + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                             abf, sizeof(abf),
+                                             generator + i * ASSET_GENERATOR_LEN,
+                                             ASSET_GENERATOR_LEN) != WALLY_OK)
+            return false;
+    }
+
+    /* Batch results match the single value calls */
+    ok = wally_asset_value_commitment_batch(values, 3, vbf, sizeof(vbf),
+                                            generator, sizeof(generator),
+                                            commitments, sizeof(commitments)) == WALLY_OK &&
+         wally_tx_confidential_value_from_satoshi_batch(values, 3, explicit_values,
+                                                        sizeof(explicit_values)) == WALLY_OK &&
+         wally_tx_confidential_asset_from_tag_batch(asset, sizeof(asset), explicit_assets,
+                                                    sizeof(explicit_assets)) == WALLY_OK;
+    for (i = 0; i < 3 && ok; ++i)
+        ok = wally_asset_value_commitment(values[i], vbf + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                          generator + i * ASSET_GENERATOR_LEN,
+                                          ASSET_GENERATOR_LEN,
+                                          commitment, sizeof(commitment)) == WALLY_OK &&
+             !memcmp(commitments + i * ASSET_COMMITMENT_LEN, commitment, sizeof(commitment)) &&
+             wally_tx_confidential_value_from_satoshi(values[i], value,
+                                                      sizeof(value)) == WALLY_OK &&
+             !memcmp(explicit_values + i * sizeof(value), value, sizeof(value)) &&
+             explicit_assets[i * WALLY_TX_ASSET_CT_ASSET_LEN] == 0x1 &&
+             !memcmp(explicit_assets + i * WALLY_TX_ASSET_CT_ASSET_LEN + 1,
+                     asset + i * ASSET_TAG_LEN, ASSET_TAG_LEN);
+
+    /* Assets convert in place */
+    memcpy(commitments, asset, sizeof(asset));
+    ok = ok && wally_tx_confidential_asset_from_tag_batch(commitments, sizeof(asset),
+                                                          commitments,
+                                                          sizeof(explicit_assets)) == WALLY_OK &&
+         !memcmp(commitments, explicit_assets, sizeof(explicit_assets));
+
+    /* Invalid arguments; a failed commitment clears the output */
+    memset(generator + 2 * ASSET_GENERATOR_LEN, 0xff, ASSET_GENERATOR_LEN);
+    ok = ok && wally_asset_value_commitment_batch(values, 3, vbf, sizeof(vbf),
+                                                  generator, sizeof(generator),
+                                                  commitments,
+                                                  sizeof(commitments)) == WALLY_EINVAL &&
+         !commitments[0] &&
+         wally_asset_value_commitment_batch(values, 0, vbf, 0, generator, 0,
+                                            commitments, 0) == WALLY_EINVAL &&
+         wally_asset_value_commitment_batch(values, 2, vbf, sizeof(vbf),
+                                            generator, 2 * ASSET_GENERATOR_LEN, commitments,
+                                            2 * ASSET_COMMITMENT_LEN) == WALLY_EINVAL &&
+         wally_tx_confidential_value_from_satoshi_batch(values, 3, explicit_values,
+                                                        sizeof(explicit_values) - 1) == WALLY_EINVAL &&
+         wally_tx_confidential_value_from_satoshi_batch(NULL, 3, explicit_values,
+                                                        sizeof(explicit_values)) == WALLY_EINVAL &&
+         wally_tx_confidential_asset_from_tag_batch(asset, sizeof(asset) - 1, explicit_assets,
+                                                    sizeof(explicit_assets)) == WALLY_EINVAL &&
+         wally_tx_confidential_asset_from_tag_batch(asset, sizeof(asset), explicit_assets,
+                                                    sizeof(explicit_assets) + 1) == WALLY_EINVAL;
+    return ok;
+}
+
+static bool test_slip77(void)
+{
+    /* From SLIP-0077: the seed of "all all all all all all all all all all all all" */
+    const char *seed_hex = "c76c4ac4f4e4a00d6b274d5c39c700bb4a7ddc04fbc6f78e85ca75007b5b495f"
+                           "74a9043eeb77bdd53aa6fc3a0e31462270316fa04b8c19114c8798706cd02ac8";
+    const char *master_hex = "6c2de18eabeff3f7822bc724ad482bef0557f3e1c1e1c75b7a393a5ced4de616";
+    const char *script_hex = "76a914a579388225827d9f2fe9014add644487808c695d88ac";
+    const char *priv_key_hex = "4e6e94df28448c7bb159271fe546da464ea863b3887d2eec6afd841184b70592";
+    unsigned char seed[BIP32_ENTROPY_LEN_512], node[HMAC_SHA512_LEN], master[HMAC_SHA256_LEN];
+    unsigned char scripts[3 * WALLY_SCRIPTPUBKEY_P2PKH_LEN], expected[EC_PRIVATE_KEY_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], priv_keys[3 * EC_PRIVATE_KEY_LEN];
+    struct wally_hmac_sha256_ctx *ctx;
+    size_t written, i;
+    bool ok;
+
+    if (wally_hex_to_bytes(seed_hex, seed, sizeof(seed), &written) != WALLY_OK ||
+        wally_hex_to_bytes(master_hex, master, sizeof(master), &written) != WALLY_OK ||
+        wally_hex_to_bytes(script_hex, scripts, WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                           &written) != WALLY_OK ||
+        wally_hex_to_bytes(priv_key_hex, expected, sizeof(expected), &written) != WALLY_OK)
+        return false;
+    for (i = 1; i < 3; ++i) {
+        memcpy(scripts + i * WALLY_SCRIPTPUBKEY_P2PKH_LEN, scripts, WALLY_SCRIPTPUBKEY_P2PKH_LEN);
+        scripts[i * WALLY_SCRIPTPUBKEY_P2PKH_LEN + 3] ^= (unsigned char)i;
+    }
+
+    ok = wally_asset_blinding_key_from_seed(seed, sizeof(seed), node, sizeof(node)) == WALLY_OK &&
+         !memcmp(node + HMAC_SHA256_LEN, master, sizeof(master)) &&
+         wally_asset_blinding_key_to_ec_private_key(node, sizeof(node), scripts,
+                                                    WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                                                    priv_key, sizeof(priv_key)) == WALLY_OK &&
+         !memcmp(priv_key, expected, sizeof(priv_key)) &&
+         wally_asset_blinding_key_to_ec_private_key(master, sizeof(master), scripts,
+                                                    WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                                                    priv_key, sizeof(priv_key)) == WALLY_OK &&
+         !memcmp(priv_key, expected, sizeof(priv_key)) &&
+         wally_asset_blinding_key_ctx_init_alloc(master, sizeof(master), &ctx) == WALLY_OK;
+    if (!ok)
+        return false;
+
+    /* The context and batch forms match the single key */
+    ok = wally_asset_blinding_key_to_ec_private_key_batch(node, sizeof(node),
+                                                          scripts, sizeof(scripts),
+                                                          WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                                                          priv_keys, sizeof(priv_keys)) == WALLY_OK &&
+         !memcmp(priv_keys, expected, sizeof(expected));
+    for (i = 0; i < 3 && ok; ++i)
+        ok = wally_asset_blinding_key_ctx_to_ec_private_key(ctx,
+                                                            scripts + i * WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                                                            WALLY_SCRIPTPUBKEY_P2PKH_LEN,
+                                                            priv_key, sizeof(priv_key)) == WALLY_OK &&
+             !memcmp(priv_keys + i * EC_PRIVATE_KEY_LEN, priv_key, sizeof(priv_key));
+
+    /* Invalid arguments */
+    ok = ok && wally_asset_blinding_key_from_seed(seed, sizeof(seed) - 1, node,
+                                                  sizeof(node)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_from_seed(seed, sizeof(seed), node,
+                                            sizeof(master)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_to_ec_private_key(node, sizeof(node) - 1, scripts,
+                                                    WALLY_SCRIPTPUBKEY_P2PKH_LEN, priv_key,
+                                                    sizeof(priv_key)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_to_ec_private_key(node, sizeof(node), NULL, 0, priv_key,
+                                                    sizeof(priv_key)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_ctx_to_ec_private_key(NULL, scripts,
+                                                        WALLY_SCRIPTPUBKEY_P2PKH_LEN, priv_key,
+                                                        sizeof(priv_key)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_to_ec_private_key_batch(node, sizeof(node), scripts,
+                                                          sizeof(scripts) - 1,
+                                                          WALLY_SCRIPTPUBKEY_P2PKH_LEN, priv_keys,
+                                                          sizeof(priv_keys)) == WALLY_EINVAL &&
+         wally_asset_blinding_key_to_ec_private_key_batch(node, sizeof(node), scripts,
+                                                          sizeof(scripts),
+                                                          WALLY_SCRIPTPUBKEY_P2PKH_LEN, priv_keys,
+                                                          sizeof(priv_key)) == WALLY_EINVAL;
+
+    wally_hmac_sha256_ctx_free(ctx);
+    return ok && wally_asset_blinding_key_ctx_init_alloc(NULL, sizeof(master),
+                                                         &ctx) == WALLY_EINVAL && !ctx;
+}
+
+#define NUM_PAK_KEYS 3
+#define NUM_PAK_PROOFS 4
+
+static void pak_key(unsigned char k, unsigned char *priv_key, unsigned char *pub_key)
+{
+    memset(priv_key, 0, EC_PRIVATE_KEY_LEN);
+    priv_key[EC_PRIVATE_KEY_LEN - 1] = k;
+    wally_ec_public_key_from_private_key(priv_key, EC_PRIVATE_KEY_LEN,
+                                         pub_key, EC_PUBLIC_KEY_LEN);
+}
+
+static bool test_pak_whitelistproof(void)
+{
+    unsigned char online[NUM_PAK_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char offline[NUM_PAK_KEYS * EC_PUBLIC_KEY_LEN];
+    unsigned char sub_pubkeys[NUM_PAK_PROOFS * EC_PUBLIC_KEY_LEN];
+    unsigned char online_priv[EC_PRIVATE_KEY_LEN], summed[EC_PRIVATE_KEY_LEN];
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char proofs[NUM_PAK_PROOFS * (1 + 32 * (NUM_PAK_KEYS + 1))];
+    unsigned char results[NUM_PAK_PROOFS];
+    struct wally_asset_pak_keys *keys;
+    size_t proof_len, written, i;
+    bool ok;
+
+    /* Keys with small private keys, so that the summed keys are easy to compute */
+    for (i = 0; i < NUM_PAK_KEYS; ++i) {
+        pak_key((unsigned char)(i + 1), priv_key, online + i * EC_PUBLIC_KEY_LEN);
+        pak_key((unsigned char)(10 * (i + 1)), priv_key, offline + i * EC_PUBLIC_KEY_LEN);
+    }
+    if (wally_asset_pak_whitelistproof_size(NUM_PAK_KEYS, &proof_len) != WALLY_OK ||
+        proof_len * NUM_PAK_PROOFS != sizeof(proofs) ||
+        wally_asset_pak_whitelistproof(online, sizeof(online), offline, sizeof(offline), 0,
+                                       online, EC_PUBLIC_KEY_LEN, priv_key, sizeof(priv_key),
+                                       priv_key, sizeof(priv_key), proofs, proof_len - 1,
+                                       &written) != WALLY_OK || written != proof_len)
+        return false;
+    for (i = 0; i < NUM_PAK_PROOFS; ++i) {
+        /* Signer i % NUM_PAK_KEYS whitelists the key with private key 100 + i */
+        const size_t index = i % NUM_PAK_KEYS;
+        pak_key((unsigned char)(100 + i), priv_key, sub_pubkeys + i * EC_PUBLIC_KEY_LEN);
+        pak_key((unsigned char)(index + 1), online_priv, pub_key);
+        pak_key((unsigned char)(100 + i + 10 * (index + 1)), summed, pub_key);
+        if (wally_asset_pak_whitelistproof(online, sizeof(online), offline, sizeof(offline),
+                                           index, sub_pubkeys + i * EC_PUBLIC_KEY_LEN,
+                                           EC_PUBLIC_KEY_LEN, online_priv, sizeof(online_priv),
+                                           summed, sizeof(summed), proofs + i * proof_len,
+                                           proof_len, &written) != WALLY_OK ||
+            written != proof_len)
+            return false;
+    }
+
+    if (wally_asset_pak_keys_init_alloc(online, sizeof(online), offline, sizeof(offline),
+                                        &keys) != WALLY_OK)
+        return false;
+
+    /* Every proof verifies, only with its own key */
+    ok = wally_asset_pak_whitelistproof_verify_batch(keys, sub_pubkeys, sizeof(sub_pubkeys),
+                                                     proofs, sizeof(proofs), NULL, NULL,
+                                                     results, sizeof(results)) == WALLY_OK;
+    for (i = 0; i < NUM_PAK_PROOFS && ok; ++i)
+        ok = results[i] == 1 &&
+             wally_asset_pak_whitelistproof_verify(online, sizeof(online),
+                                                   offline, sizeof(offline),
+                                                   sub_pubkeys + i * EC_PUBLIC_KEY_LEN,
+                                                   EC_PUBLIC_KEY_LEN, proofs + i * proof_len,
+                                                   proof_len) == WALLY_OK &&
+             wally_asset_pak_whitelistproof_verify_parsed(keys,
+                                                          sub_pubkeys + i * EC_PUBLIC_KEY_LEN,
+                                                          EC_PUBLIC_KEY_LEN,
+                                                          proofs + i * proof_len,
+                                                          proof_len) == WALLY_OK &&
+             wally_asset_pak_whitelistproof_verify_parsed(keys,
+                                                          sub_pubkeys + ((i + 1) % NUM_PAK_PROOFS) * EC_PUBLIC_KEY_LEN,
+                                                          EC_PUBLIC_KEY_LEN,
+                                                          proofs + i * proof_len,
+                                                          proof_len) == WALLY_EINVAL;
+
+    /* A bad proof fails only its own result */
+    proofs[2 * proof_len + 5] ^= 1;
+    ok = ok && wally_asset_pak_whitelistproof_verify_batch(keys, sub_pubkeys,
+                                                           sizeof(sub_pubkeys), proofs,
+                                                           sizeof(proofs), NULL, NULL, results,
+                                                           sizeof(results)) == WALLY_EINVAL &&
+         results[0] && results[1] && !results[2] && results[3];
+
+    /* Invalid arguments */
+    ok = ok && wally_asset_pak_whitelistproof_verify(online, sizeof(online), offline,
+                                                     sizeof(offline) - EC_PUBLIC_KEY_LEN,
+                                                     sub_pubkeys, EC_PUBLIC_KEY_LEN, proofs,
+                                                     proof_len) == WALLY_EINVAL &&
+         wally_asset_pak_whitelistproof_verify_parsed(keys, sub_pubkeys, EC_PUBLIC_KEY_LEN,
+                                                      proofs, proof_len - 1) == WALLY_EINVAL &&
+         wally_asset_pak_whitelistproof_verify_batch(keys, sub_pubkeys, sizeof(sub_pubkeys),
+                                                     proofs, sizeof(proofs) - 1, NULL, NULL,
+                                                     results, sizeof(results)) == WALLY_EINVAL &&
+         wally_asset_pak_whitelistproof(online, sizeof(online), offline, sizeof(offline),
+                                        NUM_PAK_KEYS, sub_pubkeys, EC_PUBLIC_KEY_LEN,
+                                        online_priv, sizeof(online_priv), summed,
+                                        sizeof(summed), proofs, proof_len,
+                                        &written) == WALLY_EINVAL && !written &&
+         wally_asset_pak_whitelistproof_size(0, &written) == WALLY_EINVAL &&
+         wally_asset_pak_whitelistproof_size(255, &written) == WALLY_OK &&
+         wally_asset_pak_whitelistproof_size(256, &written) == WALLY_EINVAL &&
+         wally_asset_pak_keys_free(NULL) == WALLY_EINVAL;
+
+    wally_asset_pak_keys_free(keys);
+    return ok;
+}
+
 int main(void)
 {
     bool tests_ok = true;
@@ -304,6 +1615,21 @@ int main(void)
 #define RUN(t) if (!t()) { printf(#t " test_tx() test failed!\n"); tests_ok = false; }
 
     RUN(test_tx_parse);
+    RUN(test_sighash_ctx);
+    RUN(test_reference_proofs);
+    RUN(test_issuance_ids);
+    RUN(test_blind_sum);
+    RUN(test_scratch);
+    RUN(test_output_script_types);
+    RUN(test_rangeproof_verify);
+    RUN(test_parsed_generator);
+    RUN(test_rangeproof_size);
+    RUN(test_unblind_tx);
+    RUN(test_surjectionproof);
+    RUN(test_tx_blind);
+    RUN(test_batch_encoding);
+    RUN(test_slip77);
+    RUN(test_pak_whitelistproof);
 
     return tests_ok ? 0 : 1;
 }
@@ -0,0 +1,260 @@
+#include "config.h"
+
+#include <wally_bip32.h>
+#include <wally_crypto.h>
+#include <wally_transaction.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Measure the stack high-water mark of the signing path, and check that
+ * signing performs no heap allocations. Each operation runs with an
+ * allocator that counts calls and fails them, so an allocation also makes
+ * the operation itself fail.
+ *
+ * Each operation is run on a thread with a custom stack that is filled
+ * with a known pattern first. The deepest byte that no longer holds the
+ * pattern when the thread exits gives the stack used. The stack used by
+ * an empty thread is subtracted to exclude thread startup costs.
+ *
+ * The totals are printed for comparing builds, for example when
+ * configuring with --enable-small-stack, and checked against STACK_BUDGET.
+ */
+#define STACK_LEN (256u * 1024u)
+#define STACK_FILL 0x5a
+
+#ifndef STACK_BUDGET
+#define STACK_BUDGET (16u * 1024u)
+#endif
+
+/* Large enough that serializing the signing preimage wouldn't fit
+ * in the stack buffers used to avoid allocations */
+#define BIG_SCRIPT_LEN 4096u
+
+/* The inputs of the batch signature hash transaction, and the length of
+ * the script each one is hashed with */
+#define BATCH_NUM_INPUTS 4u
+#define BATCH_SCRIPT_LEN 25u
+
+static unsigned char *gstack;
+static struct wally_tx *gtx;
+static struct wally_tx *gbatch_tx;
+static unsigned char gbatch_scripts[BATCH_NUM_INPUTS * (1 + BATCH_SCRIPT_LEN)];
+static unsigned char gbatch_hashes[BATCH_NUM_INPUTS * SHA256_LEN];
+static unsigned char gscript[BIG_SCRIPT_LEN];
+static unsigned char gpriv_key[EC_PRIVATE_KEY_LEN];
+static unsigned char ghash[SHA256_LEN];
+static unsigned char gsig[EC_SIGNATURE_LEN];
+static struct ext_key gmaster;
+static size_t gnum_allocs;
+
+static const unsigned char SEED[BIP32_ENTROPY_LEN_256] = {
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08
+};
+
+static void *failing_malloc(size_t len)
+{
+    (void)len;
+    ++gnum_allocs;
+    return NULL;
+}
+
+static bool op_noop(void)
+{
+    return true;
+}
+
+static bool op_sighash(void)
+{
+    return wally_tx_get_btc_signature_hash(gtx, 0, gscript, sizeof(gscript),
+                                           0, WALLY_SIGHASH_ALL, 0,
+                                           ghash, sizeof(ghash)) == WALLY_OK;
+}
+
+static bool op_sighash_segwit(void)
+{
+    return wally_tx_get_btc_signature_hash(gtx, 0, gscript, sizeof(gscript),
+                                           1000, WALLY_SIGHASH_ALL,
+                                           WALLY_TX_FLAG_USE_WITNESS,
+                                           ghash, sizeof(ghash)) == WALLY_OK;
+}
+
+static bool op_sighashes(void)
+{
+    const uint64_t values[BATCH_NUM_INPUTS] = { 0, 0, 0, 0 };
+    const uint32_t sighash[BATCH_NUM_INPUTS] = {
+        WALLY_SIGHASH_ALL, WALLY_SIGHASH_ALL, WALLY_SIGHASH_ALL, WALLY_SIGHASH_ALL
+    };
+
+    return wally_tx_get_signature_hashes(gbatch_tx, gbatch_scripts, sizeof(gbatch_scripts),
+                                         values, BATCH_NUM_INPUTS,
+                                         sighash, BATCH_NUM_INPUTS, 0,
+                                         gbatch_hashes, sizeof(gbatch_hashes)) == WALLY_OK;
+}
+
+static bool op_bip32_derive(void)
+{
+    const uint32_t path[] = { BIP32_INITIAL_HARDENED_CHILD + 84,
+                              BIP32_INITIAL_HARDENED_CHILD, 0, 0 };
+    struct ext_key derived;
+    bool ret;
+
+    ret = bip32_key_from_parent_path(&gmaster, path, 4, BIP32_FLAG_KEY_PRIVATE,
+                                     &derived) == WALLY_OK;
+    wally_bzero(&derived, sizeof(derived));
+    return ret;
+}
+
+static bool op_sign(void)
+{
+    return wally_ec_sig_from_bytes(gpriv_key, sizeof(gpriv_key),
+                                   ghash, sizeof(ghash), EC_FLAG_ECDSA,
+                                   gsig, sizeof(gsig)) == WALLY_OK;
+}
+
+static bool op_sig_to_der(void)
+{
+    unsigned char der[EC_SIGNATURE_DER_MAX_LEN];
+    size_t written;
+
+    return wally_ec_sig_to_der(gsig, sizeof(gsig), der, sizeof(der),
+                               &written) == WALLY_OK;
+}
+
+static bool op_xpub(void)
+{
+    char xpub[BIP32_SERIALIZED_LEN * 2];
+    size_t written;
+
+    return bip32_key_to_base58_to_buffer(&gmaster, BIP32_FLAG_KEY_PUBLIC,
+                                         xpub, sizeof(xpub),
+                                         &written) == WALLY_OK;
+}
+
+static const struct {
+    const char *name;
+    bool (*fn)(void);
+} TESTS[] = {
+    { "sighash", op_sighash },
+    { "sighash_segwit", op_sighash_segwit },
+    { "sighashes", op_sighashes },
+    { "bip32_derive", op_bip32_derive },
+    { "sign", op_sign },
+    { "sig_to_der", op_sig_to_der },
+    { "xpub", op_xpub }
+};
+
+static bool (*gop)(void);
+
+static void *run_op(void *unused)
+{
+    (void)unused;
+    return gop() ? NULL : gstack;
+}
+
+/* Run fn on a freshly filled stack, returning the bytes of stack used */
+static bool measure(bool (*fn)(void), size_t *used)
+{
+    pthread_t id;
+    pthread_attr_t attr;
+    void *op_failed;
+    size_t i;
+
+    gop = fn;
+    memset(gstack, STACK_FILL, STACK_LEN);
+    if (pthread_attr_init(&attr) ||
+        pthread_attr_setstack(&attr, gstack, STACK_LEN) ||
+        pthread_create(&id, &attr, run_op, NULL) ||
+        pthread_join(id, &op_failed) || op_failed)
+        return false;
+    pthread_attr_destroy(&attr);
+
+    /* The stack grows down: find the deepest byte written */
+    for (i = 0; i < STACK_LEN && gstack[i] == STACK_FILL; ++i)
+        ; /* no-op */
+    *used = STACK_LEN - i;
+    return true;
+}
+
+static bool setup(void)
+{
+    size_t i;
+    bool ok;
+
+    for (i = 0; i < sizeof(gscript); ++i)
+        gscript[i] = 0x51; /* OP_1 */
+    memset(gbatch_scripts, 0x51, sizeof(gbatch_scripts));
+    for (i = 0; i < BATCH_NUM_INPUTS; ++i)
+        gbatch_scripts[i * (1 + BATCH_SCRIPT_LEN)] = BATCH_SCRIPT_LEN;
+    for (i = 0; i < sizeof(gpriv_key); ++i)
+        gpriv_key[i] = i + 1;
+    memset(ghash, 0x11, sizeof(ghash));
+
+    ok = bip32_key_from_seed(SEED, sizeof(SEED), BIP32_VER_MAIN_PRIVATE,
+                             0, &gmaster) == WALLY_OK &&
+         wally_tx_init_alloc(2, 0, 1, 1, &gtx) == WALLY_OK &&
+         wally_tx_add_raw_input(gtx, ghash, sizeof(ghash), 0, 0xffffffff,
+                                NULL, 0, NULL, 0) == WALLY_OK &&
+         wally_tx_add_raw_output(gtx, 1000, gscript, 22, 0) == WALLY_OK &&
+         wally_tx_init_alloc(2, 0, BATCH_NUM_INPUTS, 1, &gbatch_tx) == WALLY_OK &&
+         wally_tx_add_raw_output(gbatch_tx, 1000, gscript, 22, 0) == WALLY_OK;
+    for (i = 0; ok && i < BATCH_NUM_INPUTS; ++i)
+        ok = wally_tx_add_raw_input(gbatch_tx, ghash, sizeof(ghash), i, 0xffffffff,
+                                    NULL, 0, NULL, 0) == WALLY_OK;
+    return ok && op_sign(); /* Create gsig */
+}
+
+int main(void)
+{
+    struct wally_operations ops, orig_ops;
+    size_t i, baseline, used;
+    bool ok = true;
+
+    if (wally_init(0) != WALLY_OK || !setup())
+        return 1;
+
+    if (!(gstack = malloc(STACK_LEN)) || !measure(op_noop, &baseline))
+        return 1;
+
+    if (wally_get_operations(&orig_ops) != WALLY_OK)
+        return 1;
+    ops = orig_ops;
+    ops.malloc_fn = failing_malloc;
+    ops.free_fn = free;
+    if (wally_set_operations(&ops) != WALLY_OK)
+        return 1;
+
+    printf("stack budget %u bytes\n", (unsigned int)STACK_BUDGET);
+    for (i = 0; i < sizeof(TESTS) / sizeof(TESTS[0]); ++i) {
+        gnum_allocs = 0;
+        if (!measure(TESTS[i].fn, &used)) {
+            printf("%s: failed after %u allocations\n", TESTS[i].name,
+                   (unsigned int)gnum_allocs);
+            ok = false;
+            continue;
+        }
+        used = used > baseline ? used - baseline : 0;
+        printf("%-16s %6u bytes of stack, %u allocations\n", TESTS[i].name,
+               (unsigned int)used, (unsigned int)gnum_allocs);
+        if (used > STACK_BUDGET) {
+            printf("%s: exceeds the stack budget\n", TESTS[i].name);
+            ok = false;
+        }
+        if (gnum_allocs) {
+            printf("%s: allocates on the signing path\n", TESTS[i].name);
+            ok = false;
+        }
+    }
+
+    wally_set_operations(&orig_ops);
+    wally_tx_free(gtx);
+    wally_tx_free(gbatch_tx);
+    free(gstack);
+    wally_cleanup(0);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "config.h"
+
+#include <wally_core.h>
+#include <wally_crypto.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define NUM_THREADS 4
+#define NUM_TASKS 1000
+#define NUM_NESTED 10
+#define NUM_SIGS 16
+
+static struct wally_thread_pool *gpool;
+static unsigned char gcounts[NUM_TASKS];
+static unsigned char gnested_counts[NUM_TASKS / NUM_NESTED][NUM_NESTED];
+static size_t gnum_runs;
+
+static void count_task(void *task_ctx, size_t i)
+{
+    unsigned char *counts = task_ctx;
+    ++counts[i];
+}
+
+/* Each task runs a batch of its own on the (busy) pool */
+static void nested_task(void *task_ctx, size_t i)
+{
+    (void)task_ctx;
+    wally_thread_pool_run(gpool, NUM_NESTED, count_task, gnested_counts[i]);
+}
+
+static void counting_run_tasks(void *run_ctx, size_t num_tasks,
+                               wally_task_t task_fn, void *task_ctx)
+{
+    ++gnum_runs;
+    wally_thread_pool_run(run_ctx, num_tasks, task_fn, task_ctx);
+}
+
+static bool all_equal(const unsigned char *p, size_t len, unsigned char value)
+{
+    size_t i;
+    for (i = 0; i < len; ++i)
+        if (p[i] != value)
+            return false;
+    return true;
+}
+
+static bool test_run(struct wally_thread_pool *pool)
+{
+    size_t i;
+
+    memset(gcounts, 0, sizeof(gcounts));
+    /* Run many batches to exercise workers joining and leaving batches */
+    for (i = 0; i < 100; ++i)
+        wally_thread_pool_run(pool, NUM_TASKS, count_task, gcounts);
+    wally_thread_pool_run(pool, 1, count_task, gcounts);
+    wally_thread_pool_run(pool, 0, count_task, gcounts);
+    return gcounts[0] == 101 && all_equal(gcounts + 1, NUM_TASKS - 1, 100);
+}
+
+static bool test_nested(void)
+{
+    memset(gnested_counts, 0, sizeof(gnested_counts));
+    wally_thread_pool_run(gpool, NUM_TASKS / NUM_NESTED, nested_task, NULL);
+    return all_equal(&gnested_counts[0][0], sizeof(gnested_counts), 1);
+}
+
+/* Batch functions called without a run_fn use the run_tasks_fn operation */
+static bool test_operation(void)
+{
+    unsigned char priv_keys[NUM_SIGS * EC_PRIVATE_KEY_LEN];
+    unsigned char hashes[NUM_SIGS * EC_MESSAGE_HASH_LEN];
+    unsigned char expected[NUM_SIGS * EC_SIGNATURE_LEN], sigs[sizeof(expected)];
+    struct wally_operations ops, orig_ops;
+    size_t i, written;
+    bool ok;
+
+    for (i = 0; i < sizeof(priv_keys); ++i)
+        priv_keys[i] = (unsigned char)(i % EC_PRIVATE_KEY_LEN + 1 + i / EC_PRIVATE_KEY_LEN);
+    memset(hashes, 0x11, sizeof(hashes));
+
+    if (wally_ec_sig_from_bytes_batch(priv_keys, sizeof(priv_keys), hashes, sizeof(hashes),
+                                      EC_FLAG_ECDSA, expected, sizeof(expected),
+                                      &written) != WALLY_OK || gnum_runs ||
+        wally_get_operations(&orig_ops) != WALLY_OK)
+        return false;
+
+    ops = orig_ops;
+    ops.run_tasks_fn = counting_run_tasks;
+    ops.run_tasks_ctx = gpool;
+    if (wally_set_operations(&ops) != WALLY_OK)
+        return false;
+    ok = wally_ec_sig_from_bytes_batch(priv_keys, sizeof(priv_keys), hashes, sizeof(hashes),
+                                       EC_FLAG_ECDSA, sigs, sizeof(sigs),
+                                       &written) == WALLY_OK &&
+         gnum_runs == 1 && !memcmp(sigs, expected, sizeof(sigs));
+    return wally_set_operations(&orig_ops) == WALLY_OK && ok;
+}
+
+int main(void)
+{
+    struct wally_thread_pool *serial;
+    bool tests_ok = true;
+
+    if (wally_init(0) != WALLY_OK ||
+        wally_thread_pool_init_alloc(WALLY_THREAD_POOL_MAX_THREADS + 1,
+                                     &serial) != WALLY_EINVAL || serial ||
+        wally_thread_pool_init_alloc(NUM_THREADS, NULL) != WALLY_EINVAL ||
+        wally_thread_pool_free(NULL) != WALLY_EINVAL ||
+        wally_thread_pool_init_alloc(0, &serial) != WALLY_OK ||
+        wally_thread_pool_init_alloc(NUM_THREADS, &gpool) != WALLY_OK)
+        return 1;
+
+#define RUN(t) if (!(t)) { printf(#t " test_thread_pool() test failed!\n"); tests_ok = false; }
+
+    RUN(test_run(serial));
+    RUN(test_run(gpool));
+    RUN(test_run(NULL));
+    RUN(test_nested());
+    RUN(test_operation());
+
+    if (wally_thread_pool_free(serial) != WALLY_OK ||
+        wally_thread_pool_free(gpool) != WALLY_OK)
+        tests_ok = false;
+    wally_cleanup(0);
+    return tests_ok ? 0 : 1;
+}
@@ -0,0 +1,297 @@
+#include "config.h"
+
+#include <wally_bip32.h>
+#include <wally_core.h>
+#include <wally_crypto.h>
+#include <wally_transaction.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Runs signing, verification, derivation, transaction parsing and scrypt
+ * from many threads at once, checking every result against one computed
+ * by a single thread and reporting how throughput scales.
+ *
+ * The first round runs before wally_init, so that all threads race to
+ * create the global secp context on first use.
+ *
+ * The number of threads defaults to the number of CPUs, up to
+ * DEFAULT_MAX_THREADS, and can be set up to MAX_THREADS with
+ * WALLY_TEST_THREADS. Efficiency is the speedup over one thread as a
+ * percentage of the number of threads that can run at once. The test
+ * fails on scaling only if WALLY_TEST_MIN_EFFICIENCY gives a minimum
+ * percentage, since timings from shared machines are unreliable.
+ */
+#define MAX_THREADS 64
+#define DEFAULT_MAX_THREADS 16
+#define NUM_ITERATIONS 64
+
+static const char *tx_hex = "020000000001012f94ddd965758445be2dfac132c5e75c517edf5ea04b745a953d0bc04c32829901000000006aedc98002a8c500000000000022002009246bbe3beb48cf1f6f2954f90d648eb04d68570b797e104fead9e6c3c87fd40544020000000000160014c221cdfc1b867d82f19d761d4e09f3b6216d8a8304004830450221008aaa56e4f0efa1f7b7ed690944ac1b59f046a59306fcd1d09924936bd500046d02202b22e13a2ad7e16a0390d726c56dfc9f07647f7abcfac651e35e5dc9d830fc8a01483045022100e096ad0acdc9e8261d1cdad973f7f234ee84a6ee68e0b89ff0c1370896e63fe102202ec36d7554d1feac8bc297279f89830da98953664b73d38767e81ee0763b9988014752210390134e68561872313ba59e56700732483f4a43c2de24559cb8c7039f25f7faf821039eb59b267a78f1020f27a83dc5e3b1e4157e4a517774040a196e9f43f08ad17d52ae89a3b720";
+
+/* Inputs and the expected output of each operation */
+static unsigned char gpriv_key[EC_PRIVATE_KEY_LEN];
+static unsigned char gpub_key[EC_PUBLIC_KEY_LEN];
+static unsigned char ghash[EC_MESSAGE_HASH_LEN];
+static unsigned char gseed[BIP32_ENTROPY_LEN_256];
+static unsigned char gtx[512];
+static size_t gtx_len;
+static struct ext_key gmaster;
+
+static unsigned char gsig[EC_SIGNATURE_LEN];
+static unsigned char gchild_pub_key[EC_PUBLIC_KEY_LEN];
+static unsigned char gscrypt[32];
+
+/* Public keys computed by each thread in the first round */
+static unsigned char gcold_pub_keys[MAX_THREADS][EC_PUBLIC_KEY_LEN];
+
+/* Each operation computes one result in the given thread, returning
+ * false if it fails or differs from the expected result */
+typedef bool (*op_fn_t)(size_t thread);
+
+static bool op_cold_start(size_t thread)
+{
+    return wally_ec_public_key_from_private_key(gpriv_key, sizeof(gpriv_key),
+                                                gcold_pub_keys[thread],
+                                                EC_PUBLIC_KEY_LEN) == WALLY_OK;
+}
+
+static bool op_sign(size_t thread)
+{
+    unsigned char sig[EC_SIGNATURE_LEN];
+    (void)thread;
+    return wally_ec_sig_from_bytes(gpriv_key, sizeof(gpriv_key), ghash, sizeof(ghash),
+                                   EC_FLAG_ECDSA, sig, sizeof(sig)) == WALLY_OK &&
+           !memcmp(sig, gsig, sizeof(sig));
+}
+
+static bool op_verify(size_t thread)
+{
+    (void)thread;
+    return wally_ec_sig_verify(gpub_key, sizeof(gpub_key), ghash, sizeof(ghash),
+                               EC_FLAG_ECDSA, gsig, sizeof(gsig)) == WALLY_OK;
+}
+
+static bool op_derive(size_t thread)
+{
+    struct ext_key child;
+    (void)thread;
+    return bip32_key_from_parent(&gmaster, 7, BIP32_FLAG_KEY_PUBLIC,
+                                 &child) == WALLY_OK &&
+           !memcmp(child.pub_key, gchild_pub_key, sizeof(gchild_pub_key));
+}
+
+static bool op_tx_parse(size_t thread)
+{
+    struct wally_tx *tx;
+    unsigned char bytes[sizeof(gtx)];
+    size_t written;
+    bool ok;
+    (void)thread;
+
+    /* Parse and re-serialize the transaction */
+    if (wally_tx_from_bytes(gtx, gtx_len, WALLY_TX_FLAG_USE_WITNESS, &tx) != WALLY_OK)
+        return false;
+    ok = wally_tx_to_bytes(tx, WALLY_TX_FLAG_USE_WITNESS, bytes, sizeof(bytes),
+                           &written) == WALLY_OK &&
+         written == gtx_len && !memcmp(bytes, gtx, gtx_len);
+    return wally_tx_free(tx) == WALLY_OK && ok;
+}
+
+static bool op_scrypt(size_t thread)
+{
+    unsigned char out[sizeof(gscrypt)];
+    (void)thread;
+    return wally_scrypt(gseed, sizeof(gseed), ghash, sizeof(ghash), 64, 8, 1,
+                        out, sizeof(out)) == WALLY_OK &&
+           !memcmp(out, gscrypt, sizeof(out));
+}
+
+static const struct {
+    const char *name;
+    op_fn_t fn;
+} ops[] = {
+    { "sign", op_sign },
+    { "verify", op_verify },
+    { "derive", op_derive },
+    { "tx_parse", op_tx_parse },
+    { "scrypt", op_scrypt }
+};
+#define NUM_OPS (sizeof(ops) / sizeof(ops[0]))
+
+/* Threads wait at the start gate so that they run concurrently */
+static pthread_mutex_t gstart_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gstart_cond = PTHREAD_COND_INITIALIZER;
+static size_t gnum_waiting;
+static size_t gnum_threads;
+static size_t gnum_iterations;
+static op_fn_t gop_fn; /* The operation to run, or NULL to run them all */
+static bool gfailed[MAX_THREADS];
+
+static void start_gate(void)
+{
+    pthread_mutex_lock(&gstart_lock);
+    if (++gnum_waiting == gnum_threads)
+        pthread_cond_broadcast(&gstart_cond);
+    else
+        while (gnum_waiting < gnum_threads)
+            pthread_cond_wait(&gstart_cond, &gstart_lock);
+    pthread_mutex_unlock(&gstart_lock);
+}
+
+static void *run_thread(void *failed)
+{
+    const size_t thread = (bool *)failed - gfailed;
+    size_t i, j;
+
+    start_gate();
+    for (i = 0; i < gnum_iterations; ++i) {
+        if (gop_fn) {
+            if (!gop_fn(thread))
+                gfailed[thread] = true;
+        } else {
+            for (j = 0; j < NUM_OPS; ++j)
+                if (!ops[j].fn(thread))
+                    gfailed[thread] = true;
+        }
+    }
+    return NULL;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Run fn num_iterations times in each of num_threads threads, returning
+ * the elapsed time in ns, or 0 if any result was wrong */
+static uint64_t run_threads(size_t num_threads, op_fn_t fn, size_t num_iterations)
+{
+    pthread_t ids[MAX_THREADS];
+    uint64_t start;
+    size_t i, num_started;
+    bool ok = true;
+
+    gnum_waiting = 0;
+    gnum_threads = num_threads;
+    gnum_iterations = num_iterations;
+    gop_fn = fn;
+    memset(gfailed, 0, sizeof(gfailed));
+
+    start = now_ns();
+    for (num_started = 0; num_started < num_threads; ++num_started)
+        if (pthread_create(&ids[num_started], NULL, run_thread, &gfailed[num_started]))
+            break;
+    if (num_started != num_threads) {
+        /* Let the started threads through the gate so they can be joined */
+        printf("error: pthread_create failed\n");
+        pthread_mutex_lock(&gstart_lock);
+        gnum_threads = gnum_waiting = 0;
+        gnum_iterations = 0;
+        pthread_cond_broadcast(&gstart_cond);
+        pthread_mutex_unlock(&gstart_lock);
+        ok = false;
+    }
+    for (i = 0; i < num_started; ++i)
+        if (pthread_join(ids[i], NULL) || gfailed[i])
+            ok = false;
+    return ok ? now_ns() - start + 1 : 0;
+}
+
+/* Compute the inputs and results each thread is checked against */
+static bool setup(void)
+{
+    struct ext_key child;
+
+    if (wally_ec_public_key_from_private_key(gpriv_key, sizeof(gpriv_key),
+                                             gpub_key, sizeof(gpub_key)) != WALLY_OK ||
+        wally_ec_sig_from_bytes(gpriv_key, sizeof(gpriv_key), ghash, sizeof(ghash),
+                                EC_FLAG_ECDSA, gsig, sizeof(gsig)) != WALLY_OK ||
+        bip32_key_from_seed(gseed, sizeof(gseed), BIP32_VER_MAIN_PRIVATE, 0,
+                            &gmaster) != WALLY_OK ||
+        bip32_key_from_parent(&gmaster, 7, BIP32_FLAG_KEY_PUBLIC, &child) != WALLY_OK ||
+        wally_hex_to_bytes(tx_hex, gtx, sizeof(gtx), &gtx_len) != WALLY_OK ||
+        gtx_len > sizeof(gtx) ||
+        wally_scrypt(gseed, sizeof(gseed), ghash, sizeof(ghash), 64, 8, 1,
+                     gscrypt, sizeof(gscrypt)) != WALLY_OK)
+        return false;
+    memcpy(gchild_pub_key, child.pub_key, sizeof(gchild_pub_key));
+    return op_tx_parse(0);
+}
+
+static size_t get_num_threads(void)
+{
+    const char *env = getenv("WALLY_TEST_THREADS");
+    long n = env ? atol(env) : sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (!env && n > DEFAULT_MAX_THREADS)
+        n = DEFAULT_MAX_THREADS;
+    if (n < 2)
+        n = 2; /* Always run concurrently, even on one CPU */
+    return n > MAX_THREADS ? MAX_THREADS : (size_t)n;
+}
+
+int main(void)
+{
+    const char *min_env = getenv("WALLY_TEST_MIN_EFFICIENCY");
+    const double min_efficiency = min_env ? atof(min_env) : 0.0;
+    const size_t num_threads = get_num_threads();
+    const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    /* The best possible speedup running on all threads */
+    const double ideal = num_cpus > 0 && (size_t)num_cpus < num_threads ?
+                         (double)num_cpus : (double)num_threads;
+    uint64_t single_ns, multi_ns;
+    double speedup, efficiency;
+    size_t i;
+    bool tests_ok = true;
+
+    for (i = 0; i < sizeof(gpriv_key); ++i)
+        gpriv_key[i] = (unsigned char)(i + 1);
+    memset(ghash, 0x11, sizeof(ghash));
+    memset(gseed, 0x22, sizeof(gseed));
+
+    /* Race to create the secp context, then check every result */
+    if (!run_threads(num_threads, op_cold_start, 1) || !setup() ||
+        !run_threads(num_threads, NULL, 1)) {
+        printf("cold start test_threads() test failed!\n");
+        return 1;
+    }
+    for (i = 0; i < num_threads; ++i)
+        if (memcmp(gcold_pub_keys[i], gpub_key, sizeof(gpub_key))) {
+            printf("cold start test_threads() test failed!\n");
+            return 1;
+        }
+    if (wally_init(0) != WALLY_OK)
+        return 1;
+
+    printf("%u threads on %ld CPUs, %u iterations per thread\n",
+           (unsigned int)num_threads, num_cpus, NUM_ITERATIONS);
+    for (i = 0; i < NUM_OPS; ++i) {
+        single_ns = run_threads(1, ops[i].fn, NUM_ITERATIONS);
+        multi_ns = run_threads(num_threads, ops[i].fn, NUM_ITERATIONS);
+        if (!single_ns || !multi_ns) {
+            printf("%s test_threads() test failed!\n", ops[i].name);
+            tests_ok = false;
+            continue;
+        }
+        /* 100% means each CPU ran as fast as a single thread did alone */
+        speedup = (double)num_threads * single_ns / multi_ns;
+        efficiency = 100.0 * speedup / ideal;
+        printf("%-10s single %8.2fus  all %8.2fus  speedup %5.2fx  efficiency %5.1f%%\n",
+               ops[i].name, single_ns / 1000.0 / NUM_ITERATIONS,
+               multi_ns / 1000.0 / NUM_ITERATIONS, speedup, efficiency);
+        if (efficiency < min_efficiency) {
+            printf("%s test_threads() efficiency below %.1f%%!\n",
+                   ops[i].name, min_efficiency);
+            tests_ok = false;
+        }
+    }
+
+    wally_cleanup(0);
+    return tests_ok ? 0 : 1;
+}
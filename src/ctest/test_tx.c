@@ -1,5 +1,6 @@
 #include "config.h"
 
+#include <wally_script.h>
 #include <wally_transaction.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -126,6 +127,105 @@ static bool test_tx_parse(void)
            tx_coinbase(coinbase_hex);
 }
 
+static bool script_iterate(const unsigned char *script, size_t script_len,
+                           const unsigned char *opcodes, const size_t *push_lens,
+                           size_t num_opcodes)
+{
+    struct wally_script_iterator iter;
+    size_t i, written, offset = 0;
+
+    if (wally_script_iterator_init(&iter, script, script_len) != WALLY_OK)
+        return false;
+
+    for (i = 0; i < num_opcodes; ++i) {
+        size_t opcode_len = 1;
+        if (opcodes[i] == OP_PUSHDATA1)
+            opcode_len = 2;
+        else if (opcodes[i] == OP_PUSHDATA2)
+            opcode_len = 3;
+        else if (opcodes[i] == OP_PUSHDATA4)
+            opcode_len = 5;
+        if (wally_script_iterator_next(&iter, &written) != WALLY_OK || !written ||
+            iter.opcode != opcodes[i] || iter.push_len != push_lens[i] ||
+            !iter.push != !push_lens[i] ||
+            iter.offset != offset + opcode_len + push_lens[i])
+            return false;
+        /* Pushed data must point into the script, without copying */
+        if (iter.push && iter.push != script + offset + opcode_len)
+            return false;
+        offset = iter.offset;
+    }
+    /* The end of the script is reported repeatedly */
+    for (i = 0; i < 2; ++i)
+        if (wally_script_iterator_next(&iter, &written) != WALLY_OK || written ||
+            iter.push || iter.push_len)
+            return false;
+    return iter.offset == script_len;
+}
+
+static bool test_script_iterator(void)
+{
+    const unsigned char multisig_ops[] = { OP_2, 33, 33, OP_2, OP_CHECKMULTISIG };
+    const size_t multisig_lens[] = { 0, 33, 33, 0, 0 };
+    const unsigned char p2pkh_ops[] = { 0x48, 0x41 };
+    const size_t p2pkh_lens[] = { 0x48, 0x41 };
+    const unsigned char pushdata[] = {
+        OP_0, OP_PUSHDATA1, 1, 0xaa, OP_PUSHDATA2, 2, 0, 0xbb, 0xcc,
+        OP_PUSHDATA4, 1, 0, 0, 0, 0xdd, OP_1NEGATE, OP_PUSHDATA1, 0
+    };
+    const unsigned char pushdata_ops[] = {
+        OP_0, OP_PUSHDATA1, OP_PUSHDATA2, OP_PUSHDATA4, OP_1NEGATE, OP_PUSHDATA1
+    };
+    const size_t pushdata_lens[] = { 0, 1, 2, 1, 0, 0 };
+    const unsigned char truncated[] = { OP_DUP, OP_PUSHDATA2, 3, 0, 0xaa, 0xbb };
+    struct wally_tx *tx;
+    struct wally_tx_witness_item *item;
+    struct wally_script_iterator iter;
+    size_t written, script_type;
+    bool ok;
+
+    if (wally_tx_from_hex(wit_hex, WALLY_TX_FLAG_USE_WITNESS, &tx) != WALLY_OK)
+        return false;
+    /* The final witness item is a 2of2 multisig witness script */
+    item = &tx->inputs[0].witness->items[tx->inputs[0].witness->num_items - 1];
+    ok = script_iterate(item->witness, item->witness_len,
+                        multisig_ops, multisig_lens, 5) &&
+         wally_scriptpubkey_get_type(item->witness, item->witness_len,
+                                     &script_type) == WALLY_OK &&
+         script_type == WALLY_SCRIPT_TYPE_MULTISIG;
+    wally_tx_free(tx);
+    if (!ok)
+        return false;
+
+    /* A p2pkh scriptSig pushes a signature and public key */
+    if (wally_tx_from_hex(p2pkh_hex, 0, &tx) != WALLY_OK)
+        return false;
+    ok = script_iterate(tx->inputs[0].script, tx->inputs[0].script_len,
+                        p2pkh_ops, p2pkh_lens, 2);
+    wally_tx_free(tx);
+
+    ok = ok && script_iterate(pushdata, sizeof(pushdata),
+                              pushdata_ops, pushdata_lens, 6) &&
+         script_iterate(NULL, 0, NULL, NULL, 0);
+    if (!ok)
+        return false;
+
+    /* A push past the end of the script fails without advancing */
+    if (wally_script_iterator_init(&iter, truncated, sizeof(truncated)) != WALLY_OK ||
+        wally_script_iterator_next(&iter, &written) != WALLY_OK ||
+        !written || iter.opcode != OP_DUP ||
+        wally_script_iterator_next(&iter, &written) != WALLY_EINVAL ||
+        written || iter.offset != 1 ||
+        wally_script_iterator_next(&iter, &written) != WALLY_EINVAL)
+        return false;
+
+    /* Invalid arguments */
+    return wally_script_iterator_init(NULL, truncated, sizeof(truncated)) == WALLY_EINVAL &&
+           wally_script_iterator_init(&iter, NULL, 1) == WALLY_EINVAL &&
+           wally_script_iterator_next(NULL, &written) == WALLY_EINVAL &&
+           wally_script_iterator_next(&iter, NULL) == WALLY_EINVAL;
+}
+
 int main(void)
 {
     bool tests_ok = true;
@@ -133,6 +233,7 @@ int main(void)
 #define RUN(t) if (!t()) { printf(#t " test_tx() test failed!\n"); tests_ok = false; }
 
     RUN(test_tx_parse);
+    RUN(test_script_iterator);
 
     return tests_ok ? 0 : 1;
 }
@@ -2051,352 +2051,398 @@ static const unsigned char zhs_[] = {
     0xe7,0x9f,0xae,0,
     0xe6,0xad,0x87,0,
 };
-#define zhs ((const char*)zhs_)
-static const char *zhs_i[] = {
-    zhs+0, zhs+4, zhs+8, zhs+12, zhs+16, zhs+20,
-    zhs+24, zhs+28, zhs+32, zhs+36, zhs+40, zhs+44,
-    zhs+48, zhs+52, zhs+56, zhs+60, zhs+64, zhs+68,
-    zhs+72, zhs+76, zhs+80, zhs+84, zhs+88, zhs+92,
-    zhs+96, zhs+100, zhs+104, zhs+108, zhs+112, zhs+116,
-    zhs+120, zhs+124, zhs+128, zhs+132, zhs+136, zhs+140,
-    zhs+144, zhs+148, zhs+152, zhs+156, zhs+160, zhs+164,
-    zhs+168, zhs+172, zhs+176, zhs+180, zhs+184, zhs+188,
-    zhs+192, zhs+196, zhs+200, zhs+204, zhs+208, zhs+212,
-    zhs+216, zhs+220, zhs+224, zhs+228, zhs+232, zhs+236,
-    zhs+240, zhs+244, zhs+248, zhs+252, zhs+256, zhs+260,
-    zhs+264, zhs+268, zhs+272, zhs+276, zhs+280, zhs+284,
-    zhs+288, zhs+292, zhs+296, zhs+300, zhs+304, zhs+308,
-    zhs+312, zhs+316, zhs+320, zhs+324, zhs+328, zhs+332,
-    zhs+336, zhs+340, zhs+344, zhs+348, zhs+352, zhs+356,
-    zhs+360, zhs+364, zhs+368, zhs+372, zhs+376, zhs+380,
-    zhs+384, zhs+388, zhs+392, zhs+396, zhs+400, zhs+404,
-    zhs+408, zhs+412, zhs+416, zhs+420, zhs+424, zhs+428,
-    zhs+432, zhs+436, zhs+440, zhs+444, zhs+448, zhs+452,
-    zhs+456, zhs+460, zhs+464, zhs+468, zhs+472, zhs+476,
-    zhs+480, zhs+484, zhs+488, zhs+492, zhs+496, zhs+500,
-    zhs+504, zhs+508, zhs+512, zhs+516, zhs+520, zhs+524,
-    zhs+528, zhs+532, zhs+536, zhs+540, zhs+544, zhs+548,
-    zhs+552, zhs+556, zhs+560, zhs+564, zhs+568, zhs+572,
-    zhs+576, zhs+580, zhs+584, zhs+588, zhs+592, zhs+596,
-    zhs+600, zhs+604, zhs+608, zhs+612, zhs+616, zhs+620,
-    zhs+624, zhs+628, zhs+632, zhs+636, zhs+640, zhs+644,
-    zhs+648, zhs+652, zhs+656, zhs+660, zhs+664, zhs+668,
-    zhs+672, zhs+676, zhs+680, zhs+684, zhs+688, zhs+692,
-    zhs+696, zhs+700, zhs+704, zhs+708, zhs+712, zhs+716,
-    zhs+720, zhs+724, zhs+728, zhs+732, zhs+736, zhs+740,
-    zhs+744, zhs+748, zhs+752, zhs+756, zhs+760, zhs+764,
-    zhs+768, zhs+772, zhs+776, zhs+780, zhs+784, zhs+788,
-    zhs+792, zhs+796, zhs+800, zhs+804, zhs+808, zhs+812,
-    zhs+816, zhs+820, zhs+824, zhs+828, zhs+832, zhs+836,
-    zhs+840, zhs+844, zhs+848, zhs+852, zhs+856, zhs+860,
-    zhs+864, zhs+868, zhs+872, zhs+876, zhs+880, zhs+884,
-    zhs+888, zhs+892, zhs+896, zhs+900, zhs+904, zhs+908,
-    zhs+912, zhs+916, zhs+920, zhs+924, zhs+928, zhs+932,
-    zhs+936, zhs+940, zhs+944, zhs+948, zhs+952, zhs+956,
-    zhs+960, zhs+964, zhs+968, zhs+972, zhs+976, zhs+980,
-    zhs+984, zhs+988, zhs+992, zhs+996, zhs+1000, zhs+1004,
-    zhs+1008, zhs+1012, zhs+1016, zhs+1020, zhs+1024, zhs+1028,
-    zhs+1032, zhs+1036, zhs+1040, zhs+1044, zhs+1048, zhs+1052,
-    zhs+1056, zhs+1060, zhs+1064, zhs+1068, zhs+1072, zhs+1076,
-    zhs+1080, zhs+1084, zhs+1088, zhs+1092, zhs+1096, zhs+1100,
-    zhs+1104, zhs+1108, zhs+1112, zhs+1116, zhs+1120, zhs+1124,
-    zhs+1128, zhs+1132, zhs+1136, zhs+1140, zhs+1144, zhs+1148,
-    zhs+1152, zhs+1156, zhs+1160, zhs+1164, zhs+1168, zhs+1172,
-    zhs+1176, zhs+1180, zhs+1184, zhs+1188, zhs+1192, zhs+1196,
-    zhs+1200, zhs+1204, zhs+1208, zhs+1212, zhs+1216, zhs+1220,
-    zhs+1224, zhs+1228, zhs+1232, zhs+1236, zhs+1240, zhs+1244,
-    zhs+1248, zhs+1252, zhs+1256, zhs+1260, zhs+1264, zhs+1268,
-    zhs+1272, zhs+1276, zhs+1280, zhs+1284, zhs+1288, zhs+1292,
-    zhs+1296, zhs+1300, zhs+1304, zhs+1308, zhs+1312, zhs+1316,
-    zhs+1320, zhs+1324, zhs+1328, zhs+1332, zhs+1336, zhs+1340,
-    zhs+1344, zhs+1348, zhs+1352, zhs+1356, zhs+1360, zhs+1364,
-    zhs+1368, zhs+1372, zhs+1376, zhs+1380, zhs+1384, zhs+1388,
-    zhs+1392, zhs+1396, zhs+1400, zhs+1404, zhs+1408, zhs+1412,
-    zhs+1416, zhs+1420, zhs+1424, zhs+1428, zhs+1432, zhs+1436,
-    zhs+1440, zhs+1444, zhs+1448, zhs+1452, zhs+1456, zhs+1460,
-    zhs+1464, zhs+1468, zhs+1472, zhs+1476, zhs+1480, zhs+1484,
-    zhs+1488, zhs+1492, zhs+1496, zhs+1500, zhs+1504, zhs+1508,
-    zhs+1512, zhs+1516, zhs+1520, zhs+1524, zhs+1528, zhs+1532,
-    zhs+1536, zhs+1540, zhs+1544, zhs+1548, zhs+1552, zhs+1556,
-    zhs+1560, zhs+1564, zhs+1568, zhs+1572, zhs+1576, zhs+1580,
-    zhs+1584, zhs+1588, zhs+1592, zhs+1596, zhs+1600, zhs+1604,
-    zhs+1608, zhs+1612, zhs+1616, zhs+1620, zhs+1624, zhs+1628,
-    zhs+1632, zhs+1636, zhs+1640, zhs+1644, zhs+1648, zhs+1652,
-    zhs+1656, zhs+1660, zhs+1664, zhs+1668, zhs+1672, zhs+1676,
-    zhs+1680, zhs+1684, zhs+1688, zhs+1692, zhs+1696, zhs+1700,
-    zhs+1704, zhs+1708, zhs+1712, zhs+1716, zhs+1720, zhs+1724,
-    zhs+1728, zhs+1732, zhs+1736, zhs+1740, zhs+1744, zhs+1748,
-    zhs+1752, zhs+1756, zhs+1760, zhs+1764, zhs+1768, zhs+1772,
-    zhs+1776, zhs+1780, zhs+1784, zhs+1788, zhs+1792, zhs+1796,
-    zhs+1800, zhs+1804, zhs+1808, zhs+1812, zhs+1816, zhs+1820,
-    zhs+1824, zhs+1828, zhs+1832, zhs+1836, zhs+1840, zhs+1844,
-    zhs+1848, zhs+1852, zhs+1856, zhs+1860, zhs+1864, zhs+1868,
-    zhs+1872, zhs+1876, zhs+1880, zhs+1884, zhs+1888, zhs+1892,
-    zhs+1896, zhs+1900, zhs+1904, zhs+1908, zhs+1912, zhs+1916,
-    zhs+1920, zhs+1924, zhs+1928, zhs+1932, zhs+1936, zhs+1940,
-    zhs+1944, zhs+1948, zhs+1952, zhs+1956, zhs+1960, zhs+1964,
-    zhs+1968, zhs+1972, zhs+1976, zhs+1980, zhs+1984, zhs+1988,
-    zhs+1992, zhs+1996, zhs+2000, zhs+2004, zhs+2008, zhs+2012,
-    zhs+2016, zhs+2020, zhs+2024, zhs+2028, zhs+2032, zhs+2036,
-    zhs+2040, zhs+2044, zhs+2048, zhs+2052, zhs+2056, zhs+2060,
-    zhs+2064, zhs+2068, zhs+2072, zhs+2076, zhs+2080, zhs+2084,
-    zhs+2088, zhs+2092, zhs+2096, zhs+2100, zhs+2104, zhs+2108,
-    zhs+2112, zhs+2116, zhs+2120, zhs+2124, zhs+2128, zhs+2132,
-    zhs+2136, zhs+2140, zhs+2144, zhs+2148, zhs+2152, zhs+2156,
-    zhs+2160, zhs+2164, zhs+2168, zhs+2172, zhs+2176, zhs+2180,
-    zhs+2184, zhs+2188, zhs+2192, zhs+2196, zhs+2200, zhs+2204,
-    zhs+2208, zhs+2212, zhs+2216, zhs+2220, zhs+2224, zhs+2228,
-    zhs+2232, zhs+2236, zhs+2240, zhs+2244, zhs+2248, zhs+2252,
-    zhs+2256, zhs+2260, zhs+2264, zhs+2268, zhs+2272, zhs+2276,
-    zhs+2280, zhs+2284, zhs+2288, zhs+2292, zhs+2296, zhs+2300,
-    zhs+2304, zhs+2308, zhs+2312, zhs+2316, zhs+2320, zhs+2324,
-    zhs+2328, zhs+2332, zhs+2336, zhs+2340, zhs+2344, zhs+2348,
-    zhs+2352, zhs+2356, zhs+2360, zhs+2364, zhs+2368, zhs+2372,
-    zhs+2376, zhs+2380, zhs+2384, zhs+2388, zhs+2392, zhs+2396,
-    zhs+2400, zhs+2404, zhs+2408, zhs+2412, zhs+2416, zhs+2420,
-    zhs+2424, zhs+2428, zhs+2432, zhs+2436, zhs+2440, zhs+2444,
-    zhs+2448, zhs+2452, zhs+2456, zhs+2460, zhs+2464, zhs+2468,
-    zhs+2472, zhs+2476, zhs+2480, zhs+2484, zhs+2488, zhs+2492,
-    zhs+2496, zhs+2500, zhs+2504, zhs+2508, zhs+2512, zhs+2516,
-    zhs+2520, zhs+2524, zhs+2528, zhs+2532, zhs+2536, zhs+2540,
-    zhs+2544, zhs+2548, zhs+2552, zhs+2556, zhs+2560, zhs+2564,
-    zhs+2568, zhs+2572, zhs+2576, zhs+2580, zhs+2584, zhs+2588,
-    zhs+2592, zhs+2596, zhs+2600, zhs+2604, zhs+2608, zhs+2612,
-    zhs+2616, zhs+2620, zhs+2624, zhs+2628, zhs+2632, zhs+2636,
-    zhs+2640, zhs+2644, zhs+2648, zhs+2652, zhs+2656, zhs+2660,
-    zhs+2664, zhs+2668, zhs+2672, zhs+2676, zhs+2680, zhs+2684,
-    zhs+2688, zhs+2692, zhs+2696, zhs+2700, zhs+2704, zhs+2708,
-    zhs+2712, zhs+2716, zhs+2720, zhs+2724, zhs+2728, zhs+2732,
-    zhs+2736, zhs+2740, zhs+2744, zhs+2748, zhs+2752, zhs+2756,
-    zhs+2760, zhs+2764, zhs+2768, zhs+2772, zhs+2776, zhs+2780,
-    zhs+2784, zhs+2788, zhs+2792, zhs+2796, zhs+2800, zhs+2804,
-    zhs+2808, zhs+2812, zhs+2816, zhs+2820, zhs+2824, zhs+2828,
-    zhs+2832, zhs+2836, zhs+2840, zhs+2844, zhs+2848, zhs+2852,
-    zhs+2856, zhs+2860, zhs+2864, zhs+2868, zhs+2872, zhs+2876,
-    zhs+2880, zhs+2884, zhs+2888, zhs+2892, zhs+2896, zhs+2900,
-    zhs+2904, zhs+2908, zhs+2912, zhs+2916, zhs+2920, zhs+2924,
-    zhs+2928, zhs+2932, zhs+2936, zhs+2940, zhs+2944, zhs+2948,
-    zhs+2952, zhs+2956, zhs+2960, zhs+2964, zhs+2968, zhs+2972,
-    zhs+2976, zhs+2980, zhs+2984, zhs+2988, zhs+2992, zhs+2996,
-    zhs+3000, zhs+3004, zhs+3008, zhs+3012, zhs+3016, zhs+3020,
-    zhs+3024, zhs+3028, zhs+3032, zhs+3036, zhs+3040, zhs+3044,
-    zhs+3048, zhs+3052, zhs+3056, zhs+3060, zhs+3064, zhs+3068,
-    zhs+3072, zhs+3076, zhs+3080, zhs+3084, zhs+3088, zhs+3092,
-    zhs+3096, zhs+3100, zhs+3104, zhs+3108, zhs+3112, zhs+3116,
-    zhs+3120, zhs+3124, zhs+3128, zhs+3132, zhs+3136, zhs+3140,
-    zhs+3144, zhs+3148, zhs+3152, zhs+3156, zhs+3160, zhs+3164,
-    zhs+3168, zhs+3172, zhs+3176, zhs+3180, zhs+3184, zhs+3188,
-    zhs+3192, zhs+3196, zhs+3200, zhs+3204, zhs+3208, zhs+3212,
-    zhs+3216, zhs+3220, zhs+3224, zhs+3228, zhs+3232, zhs+3236,
-    zhs+3240, zhs+3244, zhs+3248, zhs+3252, zhs+3256, zhs+3260,
-    zhs+3264, zhs+3268, zhs+3272, zhs+3276, zhs+3280, zhs+3284,
-    zhs+3288, zhs+3292, zhs+3296, zhs+3300, zhs+3304, zhs+3308,
-    zhs+3312, zhs+3316, zhs+3320, zhs+3324, zhs+3328, zhs+3332,
-    zhs+3336, zhs+3340, zhs+3344, zhs+3348, zhs+3352, zhs+3356,
-    zhs+3360, zhs+3364, zhs+3368, zhs+3372, zhs+3376, zhs+3380,
-    zhs+3384, zhs+3388, zhs+3392, zhs+3396, zhs+3400, zhs+3404,
-    zhs+3408, zhs+3412, zhs+3416, zhs+3420, zhs+3424, zhs+3428,
-    zhs+3432, zhs+3436, zhs+3440, zhs+3444, zhs+3448, zhs+3452,
-    zhs+3456, zhs+3460, zhs+3464, zhs+3468, zhs+3472, zhs+3476,
-    zhs+3480, zhs+3484, zhs+3488, zhs+3492, zhs+3496, zhs+3500,
-    zhs+3504, zhs+3508, zhs+3512, zhs+3516, zhs+3520, zhs+3524,
-    zhs+3528, zhs+3532, zhs+3536, zhs+3540, zhs+3544, zhs+3548,
-    zhs+3552, zhs+3556, zhs+3560, zhs+3564, zhs+3568, zhs+3572,
-    zhs+3576, zhs+3580, zhs+3584, zhs+3588, zhs+3592, zhs+3596,
-    zhs+3600, zhs+3604, zhs+3608, zhs+3612, zhs+3616, zhs+3620,
-    zhs+3624, zhs+3628, zhs+3632, zhs+3636, zhs+3640, zhs+3644,
-    zhs+3648, zhs+3652, zhs+3656, zhs+3660, zhs+3664, zhs+3668,
-    zhs+3672, zhs+3676, zhs+3680, zhs+3684, zhs+3688, zhs+3692,
-    zhs+3696, zhs+3700, zhs+3704, zhs+3708, zhs+3712, zhs+3716,
-    zhs+3720, zhs+3724, zhs+3728, zhs+3732, zhs+3736, zhs+3740,
-    zhs+3744, zhs+3748, zhs+3752, zhs+3756, zhs+3760, zhs+3764,
-    zhs+3768, zhs+3772, zhs+3776, zhs+3780, zhs+3784, zhs+3788,
-    zhs+3792, zhs+3796, zhs+3800, zhs+3804, zhs+3808, zhs+3812,
-    zhs+3816, zhs+3820, zhs+3824, zhs+3828, zhs+3832, zhs+3836,
-    zhs+3840, zhs+3844, zhs+3848, zhs+3852, zhs+3856, zhs+3860,
-    zhs+3864, zhs+3868, zhs+3872, zhs+3876, zhs+3880, zhs+3884,
-    zhs+3888, zhs+3892, zhs+3896, zhs+3900, zhs+3904, zhs+3908,
-    zhs+3912, zhs+3916, zhs+3920, zhs+3924, zhs+3928, zhs+3932,
-    zhs+3936, zhs+3940, zhs+3944, zhs+3948, zhs+3952, zhs+3956,
-    zhs+3960, zhs+3964, zhs+3968, zhs+3972, zhs+3976, zhs+3980,
-    zhs+3984, zhs+3988, zhs+3992, zhs+3996, zhs+4000, zhs+4004,
-    zhs+4008, zhs+4012, zhs+4016, zhs+4020, zhs+4024, zhs+4028,
-    zhs+4032, zhs+4036, zhs+4040, zhs+4044, zhs+4048, zhs+4052,
-    zhs+4056, zhs+4060, zhs+4064, zhs+4068, zhs+4072, zhs+4076,
-    zhs+4080, zhs+4084, zhs+4088, zhs+4092, zhs+4096, zhs+4100,
-    zhs+4104, zhs+4108, zhs+4112, zhs+4116, zhs+4120, zhs+4124,
-    zhs+4128, zhs+4132, zhs+4136, zhs+4140, zhs+4144, zhs+4148,
-    zhs+4152, zhs+4156, zhs+4160, zhs+4164, zhs+4168, zhs+4172,
-    zhs+4176, zhs+4180, zhs+4184, zhs+4188, zhs+4192, zhs+4196,
-    zhs+4200, zhs+4204, zhs+4208, zhs+4212, zhs+4216, zhs+4220,
-    zhs+4224, zhs+4228, zhs+4232, zhs+4236, zhs+4240, zhs+4244,
-    zhs+4248, zhs+4252, zhs+4256, zhs+4260, zhs+4264, zhs+4268,
-    zhs+4272, zhs+4276, zhs+4280, zhs+4284, zhs+4288, zhs+4292,
-    zhs+4296, zhs+4300, zhs+4304, zhs+4308, zhs+4312, zhs+4316,
-    zhs+4320, zhs+4324, zhs+4328, zhs+4332, zhs+4336, zhs+4340,
-    zhs+4344, zhs+4348, zhs+4352, zhs+4356, zhs+4360, zhs+4364,
-    zhs+4368, zhs+4372, zhs+4376, zhs+4380, zhs+4384, zhs+4388,
-    zhs+4392, zhs+4396, zhs+4400, zhs+4404, zhs+4408, zhs+4412,
-    zhs+4416, zhs+4420, zhs+4424, zhs+4428, zhs+4432, zhs+4436,
-    zhs+4440, zhs+4444, zhs+4448, zhs+4452, zhs+4456, zhs+4460,
-    zhs+4464, zhs+4468, zhs+4472, zhs+4476, zhs+4480, zhs+4484,
-    zhs+4488, zhs+4492, zhs+4496, zhs+4500, zhs+4504, zhs+4508,
-    zhs+4512, zhs+4516, zhs+4520, zhs+4524, zhs+4528, zhs+4532,
-    zhs+4536, zhs+4540, zhs+4544, zhs+4548, zhs+4552, zhs+4556,
-    zhs+4560, zhs+4564, zhs+4568, zhs+4572, zhs+4576, zhs+4580,
-    zhs+4584, zhs+4588, zhs+4592, zhs+4596, zhs+4600, zhs+4604,
-    zhs+4608, zhs+4612, zhs+4616, zhs+4620, zhs+4624, zhs+4628,
-    zhs+4632, zhs+4636, zhs+4640, zhs+4644, zhs+4648, zhs+4652,
-    zhs+4656, zhs+4660, zhs+4664, zhs+4668, zhs+4672, zhs+4676,
-    zhs+4680, zhs+4684, zhs+4688, zhs+4692, zhs+4696, zhs+4700,
-    zhs+4704, zhs+4708, zhs+4712, zhs+4716, zhs+4720, zhs+4724,
-    zhs+4728, zhs+4732, zhs+4736, zhs+4740, zhs+4744, zhs+4748,
-    zhs+4752, zhs+4756, zhs+4760, zhs+4764, zhs+4768, zhs+4772,
-    zhs+4776, zhs+4780, zhs+4784, zhs+4788, zhs+4792, zhs+4796,
-    zhs+4800, zhs+4804, zhs+4808, zhs+4812, zhs+4816, zhs+4820,
-    zhs+4824, zhs+4828, zhs+4832, zhs+4836, zhs+4840, zhs+4844,
-    zhs+4848, zhs+4852, zhs+4856, zhs+4860, zhs+4864, zhs+4868,
-    zhs+4872, zhs+4876, zhs+4880, zhs+4884, zhs+4888, zhs+4892,
-    zhs+4896, zhs+4900, zhs+4904, zhs+4908, zhs+4912, zhs+4916,
-    zhs+4920, zhs+4924, zhs+4928, zhs+4932, zhs+4936, zhs+4940,
-    zhs+4944, zhs+4948, zhs+4952, zhs+4956, zhs+4960, zhs+4964,
-    zhs+4968, zhs+4972, zhs+4976, zhs+4980, zhs+4984, zhs+4988,
-    zhs+4992, zhs+4996, zhs+5000, zhs+5004, zhs+5008, zhs+5012,
-    zhs+5016, zhs+5020, zhs+5024, zhs+5028, zhs+5032, zhs+5036,
-    zhs+5040, zhs+5044, zhs+5048, zhs+5052, zhs+5056, zhs+5060,
-    zhs+5064, zhs+5068, zhs+5072, zhs+5076, zhs+5080, zhs+5084,
-    zhs+5088, zhs+5092, zhs+5096, zhs+5100, zhs+5104, zhs+5108,
-    zhs+5112, zhs+5116, zhs+5120, zhs+5124, zhs+5128, zhs+5132,
-    zhs+5136, zhs+5140, zhs+5144, zhs+5148, zhs+5152, zhs+5156,
-    zhs+5160, zhs+5164, zhs+5168, zhs+5172, zhs+5176, zhs+5180,
-    zhs+5184, zhs+5188, zhs+5192, zhs+5196, zhs+5200, zhs+5204,
-    zhs+5208, zhs+5212, zhs+5216, zhs+5220, zhs+5224, zhs+5228,
-    zhs+5232, zhs+5236, zhs+5240, zhs+5244, zhs+5248, zhs+5252,
-    zhs+5256, zhs+5260, zhs+5264, zhs+5268, zhs+5272, zhs+5276,
-    zhs+5280, zhs+5284, zhs+5288, zhs+5292, zhs+5296, zhs+5300,
-    zhs+5304, zhs+5308, zhs+5312, zhs+5316, zhs+5320, zhs+5324,
-    zhs+5328, zhs+5332, zhs+5336, zhs+5340, zhs+5344, zhs+5348,
-    zhs+5352, zhs+5356, zhs+5360, zhs+5364, zhs+5368, zhs+5372,
-    zhs+5376, zhs+5380, zhs+5384, zhs+5388, zhs+5392, zhs+5396,
-    zhs+5400, zhs+5404, zhs+5408, zhs+5412, zhs+5416, zhs+5420,
-    zhs+5424, zhs+5428, zhs+5432, zhs+5436, zhs+5440, zhs+5444,
-    zhs+5448, zhs+5452, zhs+5456, zhs+5460, zhs+5464, zhs+5468,
-    zhs+5472, zhs+5476, zhs+5480, zhs+5484, zhs+5488, zhs+5492,
-    zhs+5496, zhs+5500, zhs+5504, zhs+5508, zhs+5512, zhs+5516,
-    zhs+5520, zhs+5524, zhs+5528, zhs+5532, zhs+5536, zhs+5540,
-    zhs+5544, zhs+5548, zhs+5552, zhs+5556, zhs+5560, zhs+5564,
-    zhs+5568, zhs+5572, zhs+5576, zhs+5580, zhs+5584, zhs+5588,
-    zhs+5592, zhs+5596, zhs+5600, zhs+5604, zhs+5608, zhs+5612,
-    zhs+5616, zhs+5620, zhs+5624, zhs+5628, zhs+5632, zhs+5636,
-    zhs+5640, zhs+5644, zhs+5648, zhs+5652, zhs+5656, zhs+5660,
-    zhs+5664, zhs+5668, zhs+5672, zhs+5676, zhs+5680, zhs+5684,
-    zhs+5688, zhs+5692, zhs+5696, zhs+5700, zhs+5704, zhs+5708,
-    zhs+5712, zhs+5716, zhs+5720, zhs+5724, zhs+5728, zhs+5732,
-    zhs+5736, zhs+5740, zhs+5744, zhs+5748, zhs+5752, zhs+5756,
-    zhs+5760, zhs+5764, zhs+5768, zhs+5772, zhs+5776, zhs+5780,
-    zhs+5784, zhs+5788, zhs+5792, zhs+5796, zhs+5800, zhs+5804,
-    zhs+5808, zhs+5812, zhs+5816, zhs+5820, zhs+5824, zhs+5828,
-    zhs+5832, zhs+5836, zhs+5840, zhs+5844, zhs+5848, zhs+5852,
-    zhs+5856, zhs+5860, zhs+5864, zhs+5868, zhs+5872, zhs+5876,
-    zhs+5880, zhs+5884, zhs+5888, zhs+5892, zhs+5896, zhs+5900,
-    zhs+5904, zhs+5908, zhs+5912, zhs+5916, zhs+5920, zhs+5924,
-    zhs+5928, zhs+5932, zhs+5936, zhs+5940, zhs+5944, zhs+5948,
-    zhs+5952, zhs+5956, zhs+5960, zhs+5964, zhs+5968, zhs+5972,
-    zhs+5976, zhs+5980, zhs+5984, zhs+5988, zhs+5992, zhs+5996,
-    zhs+6000, zhs+6004, zhs+6008, zhs+6012, zhs+6016, zhs+6020,
-    zhs+6024, zhs+6028, zhs+6032, zhs+6036, zhs+6040, zhs+6044,
-    zhs+6048, zhs+6052, zhs+6056, zhs+6060, zhs+6064, zhs+6068,
-    zhs+6072, zhs+6076, zhs+6080, zhs+6084, zhs+6088, zhs+6092,
-    zhs+6096, zhs+6100, zhs+6104, zhs+6108, zhs+6112, zhs+6116,
-    zhs+6120, zhs+6124, zhs+6128, zhs+6132, zhs+6136, zhs+6140,
-    zhs+6144, zhs+6148, zhs+6152, zhs+6156, zhs+6160, zhs+6164,
-    zhs+6168, zhs+6172, zhs+6176, zhs+6180, zhs+6184, zhs+6188,
-    zhs+6192, zhs+6196, zhs+6200, zhs+6204, zhs+6208, zhs+6212,
-    zhs+6216, zhs+6220, zhs+6224, zhs+6228, zhs+6232, zhs+6236,
-    zhs+6240, zhs+6244, zhs+6248, zhs+6252, zhs+6256, zhs+6260,
-    zhs+6264, zhs+6268, zhs+6272, zhs+6276, zhs+6280, zhs+6284,
-    zhs+6288, zhs+6292, zhs+6296, zhs+6300, zhs+6304, zhs+6308,
-    zhs+6312, zhs+6316, zhs+6320, zhs+6324, zhs+6328, zhs+6332,
-    zhs+6336, zhs+6340, zhs+6344, zhs+6348, zhs+6352, zhs+6356,
-    zhs+6360, zhs+6364, zhs+6368, zhs+6372, zhs+6376, zhs+6380,
-    zhs+6384, zhs+6388, zhs+6392, zhs+6396, zhs+6400, zhs+6404,
-    zhs+6408, zhs+6412, zhs+6416, zhs+6420, zhs+6424, zhs+6428,
-    zhs+6432, zhs+6436, zhs+6440, zhs+6444, zhs+6448, zhs+6452,
-    zhs+6456, zhs+6460, zhs+6464, zhs+6468, zhs+6472, zhs+6476,
-    zhs+6480, zhs+6484, zhs+6488, zhs+6492, zhs+6496, zhs+6500,
-    zhs+6504, zhs+6508, zhs+6512, zhs+6516, zhs+6520, zhs+6524,
-    zhs+6528, zhs+6532, zhs+6536, zhs+6540, zhs+6544, zhs+6548,
-    zhs+6552, zhs+6556, zhs+6560, zhs+6564, zhs+6568, zhs+6572,
-    zhs+6576, zhs+6580, zhs+6584, zhs+6588, zhs+6592, zhs+6596,
-    zhs+6600, zhs+6604, zhs+6608, zhs+6612, zhs+6616, zhs+6620,
-    zhs+6624, zhs+6628, zhs+6632, zhs+6636, zhs+6640, zhs+6644,
-    zhs+6648, zhs+6652, zhs+6656, zhs+6660, zhs+6664, zhs+6668,
-    zhs+6672, zhs+6676, zhs+6680, zhs+6684, zhs+6688, zhs+6692,
-    zhs+6696, zhs+6700, zhs+6704, zhs+6708, zhs+6712, zhs+6716,
-    zhs+6720, zhs+6724, zhs+6728, zhs+6732, zhs+6736, zhs+6740,
-    zhs+6744, zhs+6748, zhs+6752, zhs+6756, zhs+6760, zhs+6764,
-    zhs+6768, zhs+6772, zhs+6776, zhs+6780, zhs+6784, zhs+6788,
-    zhs+6792, zhs+6796, zhs+6800, zhs+6804, zhs+6808, zhs+6812,
-    zhs+6816, zhs+6820, zhs+6824, zhs+6828, zhs+6832, zhs+6836,
-    zhs+6840, zhs+6844, zhs+6848, zhs+6852, zhs+6856, zhs+6860,
-    zhs+6864, zhs+6868, zhs+6872, zhs+6876, zhs+6880, zhs+6884,
-    zhs+6888, zhs+6892, zhs+6896, zhs+6900, zhs+6904, zhs+6908,
-    zhs+6912, zhs+6916, zhs+6920, zhs+6924, zhs+6928, zhs+6932,
-    zhs+6936, zhs+6940, zhs+6944, zhs+6948, zhs+6952, zhs+6956,
-    zhs+6960, zhs+6964, zhs+6968, zhs+6972, zhs+6976, zhs+6980,
-    zhs+6984, zhs+6988, zhs+6992, zhs+6996, zhs+7000, zhs+7004,
-    zhs+7008, zhs+7012, zhs+7016, zhs+7020, zhs+7024, zhs+7028,
-    zhs+7032, zhs+7036, zhs+7040, zhs+7044, zhs+7048, zhs+7052,
-    zhs+7056, zhs+7060, zhs+7064, zhs+7068, zhs+7072, zhs+7076,
-    zhs+7080, zhs+7084, zhs+7088, zhs+7092, zhs+7096, zhs+7100,
-    zhs+7104, zhs+7108, zhs+7112, zhs+7116, zhs+7120, zhs+7124,
-    zhs+7128, zhs+7132, zhs+7136, zhs+7140, zhs+7144, zhs+7148,
-    zhs+7152, zhs+7156, zhs+7160, zhs+7164, zhs+7168, zhs+7172,
-    zhs+7176, zhs+7180, zhs+7184, zhs+7188, zhs+7192, zhs+7196,
-    zhs+7200, zhs+7204, zhs+7208, zhs+7212, zhs+7216, zhs+7220,
-    zhs+7224, zhs+7228, zhs+7232, zhs+7236, zhs+7240, zhs+7244,
-    zhs+7248, zhs+7252, zhs+7256, zhs+7260, zhs+7264, zhs+7268,
-    zhs+7272, zhs+7276, zhs+7280, zhs+7284, zhs+7288, zhs+7292,
-    zhs+7296, zhs+7300, zhs+7304, zhs+7308, zhs+7312, zhs+7316,
-    zhs+7320, zhs+7324, zhs+7328, zhs+7332, zhs+7336, zhs+7340,
-    zhs+7344, zhs+7348, zhs+7352, zhs+7356, zhs+7360, zhs+7364,
-    zhs+7368, zhs+7372, zhs+7376, zhs+7380, zhs+7384, zhs+7388,
-    zhs+7392, zhs+7396, zhs+7400, zhs+7404, zhs+7408, zhs+7412,
-    zhs+7416, zhs+7420, zhs+7424, zhs+7428, zhs+7432, zhs+7436,
-    zhs+7440, zhs+7444, zhs+7448, zhs+7452, zhs+7456, zhs+7460,
-    zhs+7464, zhs+7468, zhs+7472, zhs+7476, zhs+7480, zhs+7484,
-    zhs+7488, zhs+7492, zhs+7496, zhs+7500, zhs+7504, zhs+7508,
-    zhs+7512, zhs+7516, zhs+7520, zhs+7524, zhs+7528, zhs+7532,
-    zhs+7536, zhs+7540, zhs+7544, zhs+7548, zhs+7552, zhs+7556,
-    zhs+7560, zhs+7564, zhs+7568, zhs+7572, zhs+7576, zhs+7580,
-    zhs+7584, zhs+7588, zhs+7592, zhs+7596, zhs+7600, zhs+7604,
-    zhs+7608, zhs+7612, zhs+7616, zhs+7620, zhs+7624, zhs+7628,
-    zhs+7632, zhs+7636, zhs+7640, zhs+7644, zhs+7648, zhs+7652,
-    zhs+7656, zhs+7660, zhs+7664, zhs+7668, zhs+7672, zhs+7676,
-    zhs+7680, zhs+7684, zhs+7688, zhs+7692, zhs+7696, zhs+7700,
-    zhs+7704, zhs+7708, zhs+7712, zhs+7716, zhs+7720, zhs+7724,
-    zhs+7728, zhs+7732, zhs+7736, zhs+7740, zhs+7744, zhs+7748,
-    zhs+7752, zhs+7756, zhs+7760, zhs+7764, zhs+7768, zhs+7772,
-    zhs+7776, zhs+7780, zhs+7784, zhs+7788, zhs+7792, zhs+7796,
-    zhs+7800, zhs+7804, zhs+7808, zhs+7812, zhs+7816, zhs+7820,
-    zhs+7824, zhs+7828, zhs+7832, zhs+7836, zhs+7840, zhs+7844,
-    zhs+7848, zhs+7852, zhs+7856, zhs+7860, zhs+7864, zhs+7868,
-    zhs+7872, zhs+7876, zhs+7880, zhs+7884, zhs+7888, zhs+7892,
-    zhs+7896, zhs+7900, zhs+7904, zhs+7908, zhs+7912, zhs+7916,
-    zhs+7920, zhs+7924, zhs+7928, zhs+7932, zhs+7936, zhs+7940,
-    zhs+7944, zhs+7948, zhs+7952, zhs+7956, zhs+7960, zhs+7964,
-    zhs+7968, zhs+7972, zhs+7976, zhs+7980, zhs+7984, zhs+7988,
-    zhs+7992, zhs+7996, zhs+8000, zhs+8004, zhs+8008, zhs+8012,
-    zhs+8016, zhs+8020, zhs+8024, zhs+8028, zhs+8032, zhs+8036,
-    zhs+8040, zhs+8044, zhs+8048, zhs+8052, zhs+8056, zhs+8060,
-    zhs+8064, zhs+8068, zhs+8072, zhs+8076, zhs+8080, zhs+8084,
-    zhs+8088, zhs+8092, zhs+8096, zhs+8100, zhs+8104, zhs+8108,
-    zhs+8112, zhs+8116, zhs+8120, zhs+8124, zhs+8128, zhs+8132,
-    zhs+8136, zhs+8140, zhs+8144, zhs+8148, zhs+8152, zhs+8156,
-    zhs+8160, zhs+8164, zhs+8168, zhs+8172, zhs+8176, zhs+8180,
-    zhs+8184, zhs+8188, zhs+8192,
+static const uint16_t zhs_o[] = {
+    0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44,
+    48, 52, 56, 60, 64, 68, 72, 76, 80, 84, 88, 92,
+    96, 100, 104, 108, 112, 116, 120, 124, 128, 132, 136, 140,
+    144, 148, 152, 156, 160, 164, 168, 172, 176, 180, 184, 188,
+    192, 196, 200, 204, 208, 212, 216, 220, 224, 228, 232, 236,
+    240, 244, 248, 252, 256, 260, 264, 268, 272, 276, 280, 284,
+    288, 292, 296, 300, 304, 308, 312, 316, 320, 324, 328, 332,
+    336, 340, 344, 348, 352, 356, 360, 364, 368, 372, 376, 380,
+    384, 388, 392, 396, 400, 404, 408, 412, 416, 420, 424, 428,
+    432, 436, 440, 444, 448, 452, 456, 460, 464, 468, 472, 476,
+    480, 484, 488, 492, 496, 500, 504, 508, 512, 516, 520, 524,
+    528, 532, 536, 540, 544, 548, 552, 556, 560, 564, 568, 572,
+    576, 580, 584, 588, 592, 596, 600, 604, 608, 612, 616, 620,
+    624, 628, 632, 636, 640, 644, 648, 652, 656, 660, 664, 668,
+    672, 676, 680, 684, 688, 692, 696, 700, 704, 708, 712, 716,
+    720, 724, 728, 732, 736, 740, 744, 748, 752, 756, 760, 764,
+    768, 772, 776, 780, 784, 788, 792, 796, 800, 804, 808, 812,
+    816, 820, 824, 828, 832, 836, 840, 844, 848, 852, 856, 860,
+    864, 868, 872, 876, 880, 884, 888, 892, 896, 900, 904, 908,
+    912, 916, 920, 924, 928, 932, 936, 940, 944, 948, 952, 956,
+    960, 964, 968, 972, 976, 980, 984, 988, 992, 996, 1000, 1004,
+    1008, 1012, 1016, 1020, 1024, 1028, 1032, 1036, 1040, 1044, 1048, 1052,
+    1056, 1060, 1064, 1068, 1072, 1076, 1080, 1084, 1088, 1092, 1096, 1100,
+    1104, 1108, 1112, 1116, 1120, 1124, 1128, 1132, 1136, 1140, 1144, 1148,
+    1152, 1156, 1160, 1164, 1168, 1172, 1176, 1180, 1184, 1188, 1192, 1196,
+    1200, 1204, 1208, 1212, 1216, 1220, 1224, 1228, 1232, 1236, 1240, 1244,
+    1248, 1252, 1256, 1260, 1264, 1268, 1272, 1276, 1280, 1284, 1288, 1292,
+    1296, 1300, 1304, 1308, 1312, 1316, 1320, 1324, 1328, 1332, 1336, 1340,
+    1344, 1348, 1352, 1356, 1360, 1364, 1368, 1372, 1376, 1380, 1384, 1388,
+    1392, 1396, 1400, 1404, 1408, 1412, 1416, 1420, 1424, 1428, 1432, 1436,
+    1440, 1444, 1448, 1452, 1456, 1460, 1464, 1468, 1472, 1476, 1480, 1484,
+    1488, 1492, 1496, 1500, 1504, 1508, 1512, 1516, 1520, 1524, 1528, 1532,
+    1536, 1540, 1544, 1548, 1552, 1556, 1560, 1564, 1568, 1572, 1576, 1580,
+    1584, 1588, 1592, 1596, 1600, 1604, 1608, 1612, 1616, 1620, 1624, 1628,
+    1632, 1636, 1640, 1644, 1648, 1652, 1656, 1660, 1664, 1668, 1672, 1676,
+    1680, 1684, 1688, 1692, 1696, 1700, 1704, 1708, 1712, 1716, 1720, 1724,
+    1728, 1732, 1736, 1740, 1744, 1748, 1752, 1756, 1760, 1764, 1768, 1772,
+    1776, 1780, 1784, 1788, 1792, 1796, 1800, 1804, 1808, 1812, 1816, 1820,
+    1824, 1828, 1832, 1836, 1840, 1844, 1848, 1852, 1856, 1860, 1864, 1868,
+    1872, 1876, 1880, 1884, 1888, 1892, 1896, 1900, 1904, 1908, 1912, 1916,
+    1920, 1924, 1928, 1932, 1936, 1940, 1944, 1948, 1952, 1956, 1960, 1964,
+    1968, 1972, 1976, 1980, 1984, 1988, 1992, 1996, 2000, 2004, 2008, 2012,
+    2016, 2020, 2024, 2028, 2032, 2036, 2040, 2044, 2048, 2052, 2056, 2060,
+    2064, 2068, 2072, 2076, 2080, 2084, 2088, 2092, 2096, 2100, 2104, 2108,
+    2112, 2116, 2120, 2124, 2128, 2132, 2136, 2140, 2144, 2148, 2152, 2156,
+    2160, 2164, 2168, 2172, 2176, 2180, 2184, 2188, 2192, 2196, 2200, 2204,
+    2208, 2212, 2216, 2220, 2224, 2228, 2232, 2236, 2240, 2244, 2248, 2252,
+    2256, 2260, 2264, 2268, 2272, 2276, 2280, 2284, 2288, 2292, 2296, 2300,
+    2304, 2308, 2312, 2316, 2320, 2324, 2328, 2332, 2336, 2340, 2344, 2348,
+    2352, 2356, 2360, 2364, 2368, 2372, 2376, 2380, 2384, 2388, 2392, 2396,
+    2400, 2404, 2408, 2412, 2416, 2420, 2424, 2428, 2432, 2436, 2440, 2444,
+    2448, 2452, 2456, 2460, 2464, 2468, 2472, 2476, 2480, 2484, 2488, 2492,
+    2496, 2500, 2504, 2508, 2512, 2516, 2520, 2524, 2528, 2532, 2536, 2540,
+    2544, 2548, 2552, 2556, 2560, 2564, 2568, 2572, 2576, 2580, 2584, 2588,
+    2592, 2596, 2600, 2604, 2608, 2612, 2616, 2620, 2624, 2628, 2632, 2636,
+    2640, 2644, 2648, 2652, 2656, 2660, 2664, 2668, 2672, 2676, 2680, 2684,
+    2688, 2692, 2696, 2700, 2704, 2708, 2712, 2716, 2720, 2724, 2728, 2732,
+    2736, 2740, 2744, 2748, 2752, 2756, 2760, 2764, 2768, 2772, 2776, 2780,
+    2784, 2788, 2792, 2796, 2800, 2804, 2808, 2812, 2816, 2820, 2824, 2828,
+    2832, 2836, 2840, 2844, 2848, 2852, 2856, 2860, 2864, 2868, 2872, 2876,
+    2880, 2884, 2888, 2892, 2896, 2900, 2904, 2908, 2912, 2916, 2920, 2924,
+    2928, 2932, 2936, 2940, 2944, 2948, 2952, 2956, 2960, 2964, 2968, 2972,
+    2976, 2980, 2984, 2988, 2992, 2996, 3000, 3004, 3008, 3012, 3016, 3020,
+    3024, 3028, 3032, 3036, 3040, 3044, 3048, 3052, 3056, 3060, 3064, 3068,
+    3072, 3076, 3080, 3084, 3088, 3092, 3096, 3100, 3104, 3108, 3112, 3116,
+    3120, 3124, 3128, 3132, 3136, 3140, 3144, 3148, 3152, 3156, 3160, 3164,
+    3168, 3172, 3176, 3180, 3184, 3188, 3192, 3196, 3200, 3204, 3208, 3212,
+    3216, 3220, 3224, 3228, 3232, 3236, 3240, 3244, 3248, 3252, 3256, 3260,
+    3264, 3268, 3272, 3276, 3280, 3284, 3288, 3292, 3296, 3300, 3304, 3308,
+    3312, 3316, 3320, 3324, 3328, 3332, 3336, 3340, 3344, 3348, 3352, 3356,
+    3360, 3364, 3368, 3372, 3376, 3380, 3384, 3388, 3392, 3396, 3400, 3404,
+    3408, 3412, 3416, 3420, 3424, 3428, 3432, 3436, 3440, 3444, 3448, 3452,
+    3456, 3460, 3464, 3468, 3472, 3476, 3480, 3484, 3488, 3492, 3496, 3500,
+    3504, 3508, 3512, 3516, 3520, 3524, 3528, 3532, 3536, 3540, 3544, 3548,
+    3552, 3556, 3560, 3564, 3568, 3572, 3576, 3580, 3584, 3588, 3592, 3596,
+    3600, 3604, 3608, 3612, 3616, 3620, 3624, 3628, 3632, 3636, 3640, 3644,
+    3648, 3652, 3656, 3660, 3664, 3668, 3672, 3676, 3680, 3684, 3688, 3692,
+    3696, 3700, 3704, 3708, 3712, 3716, 3720, 3724, 3728, 3732, 3736, 3740,
+    3744, 3748, 3752, 3756, 3760, 3764, 3768, 3772, 3776, 3780, 3784, 3788,
+    3792, 3796, 3800, 3804, 3808, 3812, 3816, 3820, 3824, 3828, 3832, 3836,
+    3840, 3844, 3848, 3852, 3856, 3860, 3864, 3868, 3872, 3876, 3880, 3884,
+    3888, 3892, 3896, 3900, 3904, 3908, 3912, 3916, 3920, 3924, 3928, 3932,
+    3936, 3940, 3944, 3948, 3952, 3956, 3960, 3964, 3968, 3972, 3976, 3980,
+    3984, 3988, 3992, 3996, 4000, 4004, 4008, 4012, 4016, 4020, 4024, 4028,
+    4032, 4036, 4040, 4044, 4048, 4052, 4056, 4060, 4064, 4068, 4072, 4076,
+    4080, 4084, 4088, 4092, 4096, 4100, 4104, 4108, 4112, 4116, 4120, 4124,
+    4128, 4132, 4136, 4140, 4144, 4148, 4152, 4156, 4160, 4164, 4168, 4172,
+    4176, 4180, 4184, 4188, 4192, 4196, 4200, 4204, 4208, 4212, 4216, 4220,
+    4224, 4228, 4232, 4236, 4240, 4244, 4248, 4252, 4256, 4260, 4264, 4268,
+    4272, 4276, 4280, 4284, 4288, 4292, 4296, 4300, 4304, 4308, 4312, 4316,
+    4320, 4324, 4328, 4332, 4336, 4340, 4344, 4348, 4352, 4356, 4360, 4364,
+    4368, 4372, 4376, 4380, 4384, 4388, 4392, 4396, 4400, 4404, 4408, 4412,
+    4416, 4420, 4424, 4428, 4432, 4436, 4440, 4444, 4448, 4452, 4456, 4460,
+    4464, 4468, 4472, 4476, 4480, 4484, 4488, 4492, 4496, 4500, 4504, 4508,
+    4512, 4516, 4520, 4524, 4528, 4532, 4536, 4540, 4544, 4548, 4552, 4556,
+    4560, 4564, 4568, 4572, 4576, 4580, 4584, 4588, 4592, 4596, 4600, 4604,
+    4608, 4612, 4616, 4620, 4624, 4628, 4632, 4636, 4640, 4644, 4648, 4652,
+    4656, 4660, 4664, 4668, 4672, 4676, 4680, 4684, 4688, 4692, 4696, 4700,
+    4704, 4708, 4712, 4716, 4720, 4724, 4728, 4732, 4736, 4740, 4744, 4748,
+    4752, 4756, 4760, 4764, 4768, 4772, 4776, 4780, 4784, 4788, 4792, 4796,
+    4800, 4804, 4808, 4812, 4816, 4820, 4824, 4828, 4832, 4836, 4840, 4844,
+    4848, 4852, 4856, 4860, 4864, 4868, 4872, 4876, 4880, 4884, 4888, 4892,
+    4896, 4900, 4904, 4908, 4912, 4916, 4920, 4924, 4928, 4932, 4936, 4940,
+    4944, 4948, 4952, 4956, 4960, 4964, 4968, 4972, 4976, 4980, 4984, 4988,
+    4992, 4996, 5000, 5004, 5008, 5012, 5016, 5020, 5024, 5028, 5032, 5036,
+    5040, 5044, 5048, 5052, 5056, 5060, 5064, 5068, 5072, 5076, 5080, 5084,
+    5088, 5092, 5096, 5100, 5104, 5108, 5112, 5116, 5120, 5124, 5128, 5132,
+    5136, 5140, 5144, 5148, 5152, 5156, 5160, 5164, 5168, 5172, 5176, 5180,
+    5184, 5188, 5192, 5196, 5200, 5204, 5208, 5212, 5216, 5220, 5224, 5228,
+    5232, 5236, 5240, 5244, 5248, 5252, 5256, 5260, 5264, 5268, 5272, 5276,
+    5280, 5284, 5288, 5292, 5296, 5300, 5304, 5308, 5312, 5316, 5320, 5324,
+    5328, 5332, 5336, 5340, 5344, 5348, 5352, 5356, 5360, 5364, 5368, 5372,
+    5376, 5380, 5384, 5388, 5392, 5396, 5400, 5404, 5408, 5412, 5416, 5420,
+    5424, 5428, 5432, 5436, 5440, 5444, 5448, 5452, 5456, 5460, 5464, 5468,
+    5472, 5476, 5480, 5484, 5488, 5492, 5496, 5500, 5504, 5508, 5512, 5516,
+    5520, 5524, 5528, 5532, 5536, 5540, 5544, 5548, 5552, 5556, 5560, 5564,
+    5568, 5572, 5576, 5580, 5584, 5588, 5592, 5596, 5600, 5604, 5608, 5612,
+    5616, 5620, 5624, 5628, 5632, 5636, 5640, 5644, 5648, 5652, 5656, 5660,
+    5664, 5668, 5672, 5676, 5680, 5684, 5688, 5692, 5696, 5700, 5704, 5708,
+    5712, 5716, 5720, 5724, 5728, 5732, 5736, 5740, 5744, 5748, 5752, 5756,
+    5760, 5764, 5768, 5772, 5776, 5780, 5784, 5788, 5792, 5796, 5800, 5804,
+    5808, 5812, 5816, 5820, 5824, 5828, 5832, 5836, 5840, 5844, 5848, 5852,
+    5856, 5860, 5864, 5868, 5872, 5876, 5880, 5884, 5888, 5892, 5896, 5900,
+    5904, 5908, 5912, 5916, 5920, 5924, 5928, 5932, 5936, 5940, 5944, 5948,
+    5952, 5956, 5960, 5964, 5968, 5972, 5976, 5980, 5984, 5988, 5992, 5996,
+    6000, 6004, 6008, 6012, 6016, 6020, 6024, 6028, 6032, 6036, 6040, 6044,
+    6048, 6052, 6056, 6060, 6064, 6068, 6072, 6076, 6080, 6084, 6088, 6092,
+    6096, 6100, 6104, 6108, 6112, 6116, 6120, 6124, 6128, 6132, 6136, 6140,
+    6144, 6148, 6152, 6156, 6160, 6164, 6168, 6172, 6176, 6180, 6184, 6188,
+    6192, 6196, 6200, 6204, 6208, 6212, 6216, 6220, 6224, 6228, 6232, 6236,
+    6240, 6244, 6248, 6252, 6256, 6260, 6264, 6268, 6272, 6276, 6280, 6284,
+    6288, 6292, 6296, 6300, 6304, 6308, 6312, 6316, 6320, 6324, 6328, 6332,
+    6336, 6340, 6344, 6348, 6352, 6356, 6360, 6364, 6368, 6372, 6376, 6380,
+    6384, 6388, 6392, 6396, 6400, 6404, 6408, 6412, 6416, 6420, 6424, 6428,
+    6432, 6436, 6440, 6444, 6448, 6452, 6456, 6460, 6464, 6468, 6472, 6476,
+    6480, 6484, 6488, 6492, 6496, 6500, 6504, 6508, 6512, 6516, 6520, 6524,
+    6528, 6532, 6536, 6540, 6544, 6548, 6552, 6556, 6560, 6564, 6568, 6572,
+    6576, 6580, 6584, 6588, 6592, 6596, 6600, 6604, 6608, 6612, 6616, 6620,
+    6624, 6628, 6632, 6636, 6640, 6644, 6648, 6652, 6656, 6660, 6664, 6668,
+    6672, 6676, 6680, 6684, 6688, 6692, 6696, 6700, 6704, 6708, 6712, 6716,
+    6720, 6724, 6728, 6732, 6736, 6740, 6744, 6748, 6752, 6756, 6760, 6764,
+    6768, 6772, 6776, 6780, 6784, 6788, 6792, 6796, 6800, 6804, 6808, 6812,
+    6816, 6820, 6824, 6828, 6832, 6836, 6840, 6844, 6848, 6852, 6856, 6860,
+    6864, 6868, 6872, 6876, 6880, 6884, 6888, 6892, 6896, 6900, 6904, 6908,
+    6912, 6916, 6920, 6924, 6928, 6932, 6936, 6940, 6944, 6948, 6952, 6956,
+    6960, 6964, 6968, 6972, 6976, 6980, 6984, 6988, 6992, 6996, 7000, 7004,
+    7008, 7012, 7016, 7020, 7024, 7028, 7032, 7036, 7040, 7044, 7048, 7052,
+    7056, 7060, 7064, 7068, 7072, 7076, 7080, 7084, 7088, 7092, 7096, 7100,
+    7104, 7108, 7112, 7116, 7120, 7124, 7128, 7132, 7136, 7140, 7144, 7148,
+    7152, 7156, 7160, 7164, 7168, 7172, 7176, 7180, 7184, 7188, 7192, 7196,
+    7200, 7204, 7208, 7212, 7216, 7220, 7224, 7228, 7232, 7236, 7240, 7244,
+    7248, 7252, 7256, 7260, 7264, 7268, 7272, 7276, 7280, 7284, 7288, 7292,
+    7296, 7300, 7304, 7308, 7312, 7316, 7320, 7324, 7328, 7332, 7336, 7340,
+    7344, 7348, 7352, 7356, 7360, 7364, 7368, 7372, 7376, 7380, 7384, 7388,
+    7392, 7396, 7400, 7404, 7408, 7412, 7416, 7420, 7424, 7428, 7432, 7436,
+    7440, 7444, 7448, 7452, 7456, 7460, 7464, 7468, 7472, 7476, 7480, 7484,
+    7488, 7492, 7496, 7500, 7504, 7508, 7512, 7516, 7520, 7524, 7528, 7532,
+    7536, 7540, 7544, 7548, 7552, 7556, 7560, 7564, 7568, 7572, 7576, 7580,
+    7584, 7588, 7592, 7596, 7600, 7604, 7608, 7612, 7616, 7620, 7624, 7628,
+    7632, 7636, 7640, 7644, 7648, 7652, 7656, 7660, 7664, 7668, 7672, 7676,
+    7680, 7684, 7688, 7692, 7696, 7700, 7704, 7708, 7712, 7716, 7720, 7724,
+    7728, 7732, 7736, 7740, 7744, 7748, 7752, 7756, 7760, 7764, 7768, 7772,
+    7776, 7780, 7784, 7788, 7792, 7796, 7800, 7804, 7808, 7812, 7816, 7820,
+    7824, 7828, 7832, 7836, 7840, 7844, 7848, 7852, 7856, 7860, 7864, 7868,
+    7872, 7876, 7880, 7884, 7888, 7892, 7896, 7900, 7904, 7908, 7912, 7916,
+    7920, 7924, 7928, 7932, 7936, 7940, 7944, 7948, 7952, 7956, 7960, 7964,
+    7968, 7972, 7976, 7980, 7984, 7988, 7992, 7996, 8000, 8004, 8008, 8012,
+    8016, 8020, 8024, 8028, 8032, 8036, 8040, 8044, 8048, 8052, 8056, 8060,
+    8064, 8068, 8072, 8076, 8080, 8084, 8088, 8092, 8096, 8100, 8104, 8108,
+    8112, 8116, 8120, 8124, 8128, 8132, 8136, 8140, 8144, 8148, 8152, 8156,
+    8160, 8164, 8168, 8172, 8176, 8180, 8184, 8188,
+   };
+
+static const uint16_t zhs_d[] = {
+    9, 266, 26, 50, 93, 16, 5, 125, 39, 14, 0, 14,
+    25, 1, 26, 14, 5, 142, 14, 53, 27, 55, 131, 57,
+    377, 6, 71, 278, 19, 15, 144, 5, 21, 0, 3, 53,
+    76, 150, 14, 11, 1, 53, 23, 56, 4, 15, 41, 13,
+    37, 5, 3, 15, 7, 204, 1, 51, 8, 364, 7, 53,
+    2, 45, 1, 0, 97, 0, 50, 29, 17, 11, 11, 54,
+    73, 6, 29, 2, 52, 28, 170, 39, 109, 36, 5, 9,
+    0, 1546, 1, 30, 1, 421, 1, 87, 25, 1, 0, 7,
+    8, 8, 5, 9, 0, 16, 15, 0, 112, 117, 1, 58,
+    0, 29, 27, 0, 2, 0, 45, 226, 70, 7, 50, 1,
+    69, 116, 0, 47, 202, 2, 27, 9, 0, 13, 3, 63,
+    28, 68, 1, 71, 58, 18, 354, 346, 1, 1, 28, 55,
+    26, 5, 5, 24, 64, 11, 5, 2, 13, 0, 152, 7,
+    0, 267, 514, 317, 153, 3, 0, 156, 2, 18, 161, 154,
+    14, 0, 0, 222, 38, 0, 112, 0, 52, 0, 13, 0,
+    7, 1, 6, 66, 231, 21, 5, 149, 247, 11, 109, 5,
+    135, 4, 13, 15, 30, 6, 117, 123, 0, 8, 1, 41,
+    97, 3, 3, 1, 12, 22, 18, 0, 11, 2, 9, 0,
+    218, 4, 1950, 341, 276, 83, 60, 1, 4, 342, 0, 301,
+    179, 0, 205, 46, 0, 235, 0, 99, 3, 0, 239, 4,
+    30, 10, 1, 27, 94, 323, 0, 30, 146, 15, 184, 0,
+    185, 58, 38, 0, 165, 353, 0, 259, 708, 255, 3, 7,
+    1, 69, 0, 149, 4, 121, 0, 4, 2, 1, 27, 34,
+    34, 61, 224, 54, 125, 34, 56, 171, 192, 126, 173, 7,
+    271, 180, 0, 24, 1, 342, 639, 54, 522, 0, 23, 0,
+    0, 1108, 10, 17, 216, 36, 6, 435, 237, 2, 7, 367,
+    46, 4, 47, 3, 502, 11, 13, 32, 1, 687, 2356, 76,
+    365, 237, 27, 1, 14, 396, 21, 45, 121, 21, 65, 763,
+    32, 134, 13, 1, 29, 215, 9, 7, 266, 378, 2, 171,
+    0, 150, 2, 1, 540, 177, 18, 18, 0, 405, 20, 719,
+    62, 64, 9, 7, 23, 17, 21, 1, 41, 72, 244, 1,
+    23, 722, 139, 208, 19, 90, 32, 2697, 143, 5, 175, 139,
+    47, 1, 2339, 16, 49, 2, 399, 85, 1136, 187, 8, 48,
+    35, 80, 180, 56, 8, 12, 734, 437, 10, 78, 31, 0,
+    0, 263, 80, 18, 1, 258, 0, 403, 830, 208, 0, 2480,
+    46, 72, 5, 14, 37, 86, 27, 791, 36, 1533, 37, 22,
+    0, 160, 7, 6, 4, 868, 2643, 364, 696, 2, 438, 0,
+    33, 176, 2, 321, 502, 141, 163, 9, 576, 3842, 1315, 588,
+    1, 724, 324, 1286, 4522, 51, 10, 389, 412, 21, 474, 72,
+    803, 121, 657, 0, 1, 1398, 1, 2205, 256, 538, 109, 3855,
+    1531, 29, 28, 241, 719, 1926, 6, 35, 3, 2, 1874, 11,
+    423, 0, 609, 2510, 8, 2183, 102, 270, 3270, 6, 179, 1,
+    79, 8380, 47, 298, 891, 9, 858, 1609,
+   };
+static const uint16_t zhs_h[] = {
+    1237, 1249, 1487, 17, 1313, 781, 1983, 1627, 1887, 483, 646, 635,
+    138, 25, 11, 1177, 96, 398, 1412, 1253, 158, 1447, 1910, 378,
+    1666, 1238, 1351, 703, 2039, 1449, 1858, 545, 1632, 1967, 248, 1653,
+    94, 666, 942, 840, 43, 247, 1894, 1339, 295, 530, 1370, 1942,
+    825, 182, 1840, 1355, 108, 1153, 1863, 928, 1224, 1963, 175, 1443,
+    1957, 437, 1639, 1791, 776, 2043, 1413, 145, 1917, 1514, 576, 1843,
+    472, 1070, 385, 985, 330, 864, 1016, 731, 1893, 748, 1185, 1192,
+    442, 641, 912, 399, 1965, 1777, 1760, 1589, 558, 789, 116, 1229,
+    1696, 1146, 1755, 1521, 433, 645, 1220, 209, 1150, 1675, 564, 493,
+    642, 1300, 1252, 1962, 499, 990, 5, 721, 809, 1694, 1331, 342,
+    932, 983, 987, 1222, 33, 1958, 1587, 1517, 163, 909, 1074, 1389,
+    1986, 194, 1518, 532, 1356, 1927, 1257, 1011, 333, 121, 1649, 1272,
+    1830, 1531, 1827, 954, 1739, 3, 1603, 1844, 286, 1528, 937, 502,
+    13, 882, 322, 480, 861, 358, 142, 1819, 686, 1486, 1242, 1987,
+    1096, 186, 1021, 557, 421, 1454, 1193, 1937, 962, 963, 692, 1474,
+    41, 1080, 62, 829, 583, 923, 1988, 1384, 20, 2042, 1428, 818,
+    1216, 426, 1175, 1856, 1822, 1617, 1861, 1107, 842, 435, 698, 1480,
+    569, 2028, 595, 1364, 328, 1007, 88, 1828, 245, 195, 418, 826,
+    423, 292, 1954, 279, 1919, 1891, 1676, 1470, 624, 2001, 655, 481,
+    1655, 933, 1323, 1108, 1882, 633, 484, 1826, 1423, 639, 393, 649,
+    66, 870, 1388, 593, 1699, 1234, 1867, 87, 1122, 178, 1209, 71,
+    539, 702, 16, 559, 1922, 753, 111, 879, 1251, 1802, 1690, 1076,
+    270, 1578, 899, 363, 717, 1305, 1680, 1476, 135, 1176, 715, 738,
+    1403, 1273, 917, 1767, 782, 1982, 1182, 1689, 341, 236, 2046, 313,
+    1299, 1671, 316, 1025, 629, 376, 459, 278, 1132, 1064, 2025, 2005,
+    1602, 1787, 1106, 1707, 1109, 1411, 1398, 374, 82, 1488, 1126, 1569,
+    243, 1805, 1727, 1525, 143, 551, 329, 1335, 1994, 579, 1236, 802,
+    993, 1623, 977, 1717, 112, 929, 1315, 1939, 420, 1265, 737, 201,
+    614, 1538, 1274, 1325, 408, 309, 681, 1120, 1832, 1375, 978, 858,
+    464, 1974, 1316, 129, 565, 1789, 578, 375, 1053, 369, 517, 1815,
+    1452, 90, 1950, 1588, 1732, 1439, 1180, 691, 950, 1631, 944, 1744,
+    508, 302, 897, 57, 332, 1848, 803, 832, 1584, 434, 1731, 1864,
+    1821, 296, 1852, 876, 560, 1630, 77, 1429, 32, 205, 1708, 1116,
+    1952, 1711, 1017, 1629, 258, 854, 1499, 615, 610, 1953, 1558, 1018,
+    1504, 1462, 1534, 1044, 1133, 1652, 1765, 1152, 1766, 55, 587, 1992,
+    881, 807, 1271, 441, 1343, 632, 627, 926, 791, 663, 285, 124,
+    634, 1465, 1674, 1215, 1762, 1453, 346, 1410, 473, 1581, 1854, 1609,
+    1250, 1357, 1038, 1321, 30, 1730, 264, 1260, 986, 893, 885, 1174,
+    1714, 1888, 1870, 1667, 674, 2007, 1114, 230, 79, 1380, 934, 1029,
+    63, 204, 1254, 1737, 1926, 137, 979, 956, 1754, 1866, 1862, 601,
+    12, 1918, 58, 130, 1190, 1013, 910, 1886, 21, 713, 509, 1382,
+    949, 1095, 1268, 1379, 1081, 1527, 971, 788, 1999, 693, 355, 395,
+    427, 526, 1829, 463, 1778, 1358, 1407, 1378, 763, 1065, 1090, 537,
+    331, 1747, 1684, 91, 1597, 566, 1924, 1223, 153, 1509, 1396, 1406,
+    1156, 1729, 1482, 638, 1450, 397, 1713, 477, 413, 1187, 45, 1591,
+    611, 218, 110, 1686, 1291, 67, 141, 1645, 516, 513, 115, 468,
+    1128, 1640, 179, 1469, 544, 660, 1105, 1697, 390, 1817, 471, 863,
+    957, 1599, 1648, 662, 519, 53, 981, 428, 891, 357, 908, 242,
+    904, 1637, 1669, 335, 759, 1057, 946, 1936, 1466, 282, 1635, 351,
+    1520, 154, 568, 436, 810, 1121, 1324, 1687, 287, 1353, 1210, 1535,
+    546, 1905, 787, 874, 659, 2038, 653, 920, 1056, 262, 690, 1083,
+    867, 1656, 1163, 1457, 263, 1048, 720, 609, 743, 1823, 1049, 550,
+    368, 998, 1956, 1896, 664, 199, 1207, 924, 1442, 1712, 626, 1280,
+    1786, 212, 1678, 1123, 1330, 334, 1682, 1715, 966, 318, 1664, 1295,
+    1580, 1392, 311, 253, 896, 777, 284, 344, 476, 2008, 1092, 1394,
+    699, 136, 892, 1162, 132, 367, 144, 106, 1212, 1419, 1430, 1329,
+    1214, 1508, 582, 750, 1654, 353, 969, 449, 1860, 685, 1644, 843,
+    1023, 465, 1033, 1586, 1201, 1807, 1792, 1542, 252, 1969, 1498, 968,
+    708, 109, 1511, 105, 1259, 1921, 1745, 1072, 1415, 1435, 92, 1636,
+    2012, 959, 1810, 784, 1692, 718, 815, 85, 1540, 1276, 415, 585,
+    1039, 1277, 274, 1703, 1366, 1218, 1659, 1319, 170, 139, 1855, 1441,
+    1890, 1871, 668, 967, 10, 347, 1050, 1336, 947, 827, 191, 325,
+    149, 50, 767, 1168, 735, 1706, 883, 217, 1245, 1293, 1490, 1800,
+    1575, 1533, 276, 1349, 1681, 1773, 1576, 701, 1145, 1022, 1775, 619,
+    984, 1079, 820, 1945, 1658, 727, 1368, 2020, 1618, 1165, 1928, 1506,
+    1500, 916, 1287, 687, 1042, 343, 1239, 1757, 1718, 443, 1981, 1422,
+    705, 1003, 913, 538, 1195, 834, 293, 197, 1555, 1416, 1031, 155,
+    60, 73, 960, 1400, 2000, 1501, 1702, 617, 1467, 123, 1934, 23,
+    222, 371, 352, 1793, 1633, 938, 1405, 955, 1333, 1087, 2022, 707,
+    4, 2035, 1369, 1930, 22, 630, 887, 1100, 974, 1159, 231, 1941,
+    1677, 647, 1183, 1437, 1420, 277, 1968, 1651, 290, 86, 451, 173,
+    152, 1071, 2010, 1477, 848, 1621, 1783, 460, 1211, 1748, 808, 1489,
+    146, 40, 47, 39, 901, 446, 652, 457, 548, 1947, 798, 889,
+    804, 187, 1668, 970, 1625, 1749, 1530, 425, 1679, 1698, 349, 1622,
+    1341, 68, 1665, 1002, 581, 600, 1255, 1833, 134, 921, 672, 291,
+    556, 151, 1985, 192, 1240, 512, 1140, 1935, 323, 1494, 837, 1117,
+    1991, 1579, 324, 549, 466, 927, 1909, 1266, 940, 521, 1911, 1497,
+    765, 1661, 1347, 675, 1491, 733, 1203, 1834, 999, 1127, 1984, 166,
+    389, 1750, 1294, 1573, 1082, 396, 1281, 613, 1797, 490, 716, 456,
+    1460, 625, 751, 2037, 1481, 1691, 1734, 859, 831, 1741, 317, 1020,
+    773, 1134, 755, 36, 1427, 431, 1746, 1390, 1585, 1560, 594, 605,
+    18, 1444, 657, 1425, 1496, 1032, 1522, 1688, 1204, 1306, 772, 379,
+    1761, 1557, 1401, 1327, 606, 1616, 1836, 164, 570, 2014, 181, 275,
+    541, 59, 1838, 1012, 497, 2006, 1851, 1344, 440, 1059, 306, 1181,
+    769, 1756, 2002, 1317, 462, 1539, 1931, 359, 301, 1923, 1262, 523,
+    637, 1312, 1303, 943, 257, 2017, 1943, 905, 1672, 265, 1614, 684,
+    1577, 1551, 188, 445, 1228, 133, 1859, 2033, 1288, 1433, 232, 1352,
+    1980, 1248, 774, 1256, 1779, 1468, 1889, 27, 608, 1161, 269, 1258,
+    1524, 1650, 1037, 1811, 184, 1086, 1478, 895, 1027, 1372, 364, 38,
+    612, 534, 836, 304, 1264, 2018, 1835, 952, 1780, 1139, 604, 1879,
+    1374, 54, 813, 1426, 438, 801, 1296, 1798, 1908, 44, 1545, 1571,
+    1898, 1736, 1806, 1550, 746, 239, 1000, 2032, 822, 1719, 159, 506,
+    555, 1348, 338, 846, 1088, 1034, 1243, 114, 1642, 1179, 1831, 29,
+    1151, 42, 1030, 728, 980, 752, 31, 348, 250, 1308, 1959, 273,
+    1505, 1137, 1094, 623, 411, 1284, 948, 1799, 651, 1507, 381, 903,
+    1458, 577, 953, 1872, 599, 865, 147, 1200, 1093, 1785, 172, 220,
+    1058, 792, 1842, 524, 1553, 1901, 1158, 1332, 515, 315, 709, 1803,
+    1989, 1436, 1367, 1263, 1552, 470, 1847, 1916, 1184, 169, 535, 356,
+    448, 1434, 1008, 540, 1432, 1808, 945, 1455, 833, 1, 1362, 203,
+    1167, 1472, 1532, 226, 866, 1752, 223, 81, 700, 964, 157, 214,
+    1695, 1448, 1709, 1946, 454, 107, 1915, 254, 1564, 215, 1519, 100,
+    167, 2027, 402, 288, 89, 1456, 563, 1570, 1973, 1641, 1484, 120,
+    650, 1311, 208, 1241, 824, 712, 766, 1365, 410, 1948, 1813, 1005,
+    2, 697, 682, 202, 1131, 1751, 1285, 817, 501, 1978, 1026, 742,
+    522, 1738, 1471, 401, 1155, 1424, 2016, 450, 1270, 382, 2041, 1903,
+    176, 1771, 621, 1897, 2030, 1473, 1290, 1292, 80, 1399, 1944, 845,
+    567, 1350, 1685, 930, 99, 1359, 406, 673, 1464, 677, 906, 131,
+    104, 1459, 1208, 689, 444, 1036, 1881, 314, 1774, 620, 607, 860,
+    372, 696, 28, 294, 494, 654, 1279, 1232, 873, 1066, 498, 2031,
+    1932, 453, 1878, 362, 1526, 706, 554, 1763, 419, 1583, 496, 492,
+    1314, 1069, 939, 308, 1721, 1125, 680, 771, 919, 486, 1626, 851,
+    1318, 857, 233, 1776, 1402, 1997, 1906, 1502, 574, 1548, 562, 683,
+    586, 272, 975, 888, 1788, 1601, 1097, 1562, 1781, 268, 841, 447,
+    1009, 852, 1361, 1804, 1876, 1925, 819, 1733, 1960, 467, 1845, 280,
+    1492, 779, 237, 1966, 336, 1837, 900, 729, 1282, 283, 1010, 796,
+    1171, 1275, 2015, 1102, 2029, 520, 196, 694, 122, 1089, 1075, 429,
+    126, 1726, 1391, 160, 1796, 148, 1164, 1567, 1559, 1054, 1820, 823,
+    216, 1611, 747, 207, 1381, 95, 1913, 648, 65, 1892, 1230, 591,
+    1035, 1929, 1536, 1604, 475, 1600, 734, 907, 1320, 238, 1101, 210,
+    127, 1073, 898, 643, 597, 1493, 602, 1647, 213, 961, 125, 193,
+    1825, 816, 1938, 361, 474, 1103, 510, 1990, 931, 616, 2034, 531,
+    572, 2036, 84, 403, 1418, 1964, 61, 1561, 241, 1949, 452, 1794,
+    1485, 1479, 936, 1543, 914, 1062, 430, 1895, 1824, 1340, 744, 113,
+    1877, 102, 78, 511, 529, 1899, 1386, 533, 1194, 1225, 797, 1463,
+    491, 839, 255, 461, 52, 902, 1067, 1663, 1310, 995, 1297, 996,
+    543, 198, 2024, 422, 1849, 1563, 1722, 1596, 0, 1061, 1338, 377,
+    1972, 1880, 1582, 76, 1373, 1574, 830, 2044, 785, 835, 373, 300,
+    495, 1607, 386, 1004, 1993, 661, 542, 310, 384, 732, 1610, 877,
+    1302, 1594, 1646, 482, 770, 1144, 588, 640, 211, 780, 1735, 504,
+    1298, 2040, 1172, 9, 1920, 1612, 424, 658, 281, 319, 1816, 1235,
+    894, 665, 853, 726, 994, 862, 592, 1592, 1322, 911, 1753, 1523,
+    1110, 1115, 1772, 1955, 337, 761, 590, 1198, 458, 478, 1440, 778,
+    1148, 407, 392, 1865, 1914, 117, 190, 886, 805, 303, 2023, 754,
+    951, 1199, 267, 799, 1028, 1904, 455, 1976, 503, 1393, 618, 1818,
+    2047, 1078, 1875, 365, 762, 2013, 1547, 1099, 14, 1334, 704, 2011,
+    1857, 1673, 240, 1510, 1219, 1055, 871, 670, 1231, 1043, 380, 972,
+    922, 307, 1376, 8, 1662, 2045, 1907, 1693, 1619, 1385, 1104, 1040,
+    200, 1565, 400, 1371, 1286, 1595, 1438, 1657, 74, 722, 1801, 1590,
+    1041, 547, 723, 19, 768, 1998, 1221, 1701, 119, 711, 1383, 1149,
+    1700, 1006, 1047, 49, 1206, 34, 814, 1996, 1143, 1227, 412, 589,
+    1759, 235, 536, 1051, 1052, 177, 1304, 1157, 1404, 1138, 101, 416,
+    1705, 1716, 35, 1202, 1417, 1084, 1345, 1409, 1431, 764, 1885, 409,
+    168, 1213, 2021, 1724, 64, 340, 669, 1354, 992, 636, 417, 1098,
+    1024, 15, 518, 584, 439, 224, 383, 1307, 489, 1188, 1186, 1529,
+    1154, 758, 1541, 528, 228, 973, 812, 941, 890, 251, 219, 271,
+    1461, 1395, 404, 1725, 1546, 1173, 1091, 1136, 1060, 1475, 1568, 1046,
+    1884, 321, 234, 339, 299, 1267, 1951, 656, 1421, 844, 103, 1045,
+    1868, 724, 1197, 394, 312, 1513, 1723, 1634, 1342, 2009, 1166, 514,
+    320, 1728, 678, 2019, 256, 1841, 189, 432, 225, 603, 289, 989,
+    741, 982, 1113, 249, 1615, 1446, 1554, 793, 1613, 1853, 326, 128,
+    1014, 1068, 297, 266, 1360, 1549, 391, 345, 756, 1720, 1598, 26,
+    644, 165, 875, 1233, 1387, 1516, 183, 1933, 918, 988, 70, 1135,
+    150, 1660, 370, 628, 838, 1638, 48, 880, 598, 1710, 1704, 1147,
+    884, 1850, 405, 1606, 51, 1503, 327, 1643, 1326, 730, 821, 800,
+    505, 1812, 745, 679, 1995, 795, 1261, 1085, 868, 174, 7, 575,
+    259, 1170, 1226, 1624, 244, 1118, 83, 1141, 162, 1178, 1397, 354,
+    925, 1971, 56, 1495, 1196, 1874, 622, 1169, 1769, 1809, 847, 298,
+    1129, 260, 1683, 1512, 180, 1160, 1124, 736, 93, 487, 206, 1337,
+    1217, 710, 775, 1544, 156, 1515, 1869, 118, 479, 552, 573, 991,
+    485, 1205, 75, 1269, 1620, 1670, 790, 387, 1063, 1940, 786, 246,
+    1839, 958, 1743, 97, 171, 1977, 527, 1112, 1970, 794, 1015, 1283,
+    1782, 1790, 1019, 580, 571, 856, 676, 688, 1873, 1795, 1130, 1077,
+    631, 1111, 749, 366, 227, 1278, 1289, 1814, 1328, 976, 1301, 695,
+    185, 1764, 878, 739, 1846, 1408, 596, 1912, 1414, 1883, 811, 849,
+    1628, 1556, 1961, 360, 2026, 46, 1119, 37, 1900, 553, 855, 1768,
+    1784, 221, 2003, 1142, 1451, 6, 1758, 507, 1001, 2004, 350, 1189,
+    1363, 935, 965, 997, 806, 1246, 757, 828, 714, 525, 740, 1975,
+    488, 725, 1191, 760, 1346, 388, 414, 140, 1247, 1770, 1537, 469,
+    1566, 850, 1377, 1244, 1593, 1605, 69, 671, 261, 1309, 72, 915,
+    1572, 1445, 1740, 161, 305, 229, 667, 1608, 719, 500, 98, 783,
+    1742, 24, 1979, 1483, 872, 869, 1902, 561,
    };
-#undef zhs
 
 static const struct words zhs_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words zhs_words = {
     false,
     (const char *)zhs_,
     0, /* Constant string */
-    zhs_i
+    NULL, /* Words are located by offset */
+    zhs_o,
+    0u,
+    zhs_d,
+    zhs_h
 };
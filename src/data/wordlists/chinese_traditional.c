@@ -2051,352 +2051,398 @@ static const unsigned char zht_[] = {
     0xe7,0x9f,0xae,0,
     0xe6,0xad,0x87,0,
 };
-#define zht ((const char*)zht_)
-static const char *zht_i[] = {
-    zht+0, zht+4, zht+8, zht+12, zht+16, zht+20,
-    zht+24, zht+28, zht+32, zht+36, zht+40, zht+44,
-    zht+48, zht+52, zht+56, zht+60, zht+64, zht+68,
-    zht+72, zht+76, zht+80, zht+84, zht+88, zht+92,
-    zht+96, zht+100, zht+104, zht+108, zht+112, zht+116,
-    zht+120, zht+124, zht+128, zht+132, zht+136, zht+140,
-    zht+144, zht+148, zht+152, zht+156, zht+160, zht+164,
-    zht+168, zht+172, zht+176, zht+180, zht+184, zht+188,
-    zht+192, zht+196, zht+200, zht+204, zht+208, zht+212,
-    zht+216, zht+220, zht+224, zht+228, zht+232, zht+236,
-    zht+240, zht+244, zht+248, zht+252, zht+256, zht+260,
-    zht+264, zht+268, zht+272, zht+276, zht+280, zht+284,
-    zht+288, zht+292, zht+296, zht+300, zht+304, zht+308,
-    zht+312, zht+316, zht+320, zht+324, zht+328, zht+332,
-    zht+336, zht+340, zht+344, zht+348, zht+352, zht+356,
-    zht+360, zht+364, zht+368, zht+372, zht+376, zht+380,
-    zht+384, zht+388, zht+392, zht+396, zht+400, zht+404,
-    zht+408, zht+412, zht+416, zht+420, zht+424, zht+428,
-    zht+432, zht+436, zht+440, zht+444, zht+448, zht+452,
-    zht+456, zht+460, zht+464, zht+468, zht+472, zht+476,
-    zht+480, zht+484, zht+488, zht+492, zht+496, zht+500,
-    zht+504, zht+508, zht+512, zht+516, zht+520, zht+524,
-    zht+528, zht+532, zht+536, zht+540, zht+544, zht+548,
-    zht+552, zht+556, zht+560, zht+564, zht+568, zht+572,
-    zht+576, zht+580, zht+584, zht+588, zht+592, zht+596,
-    zht+600, zht+604, zht+608, zht+612, zht+616, zht+620,
-    zht+624, zht+628, zht+632, zht+636, zht+640, zht+644,
-    zht+648, zht+652, zht+656, zht+660, zht+664, zht+668,
-    zht+672, zht+676, zht+680, zht+684, zht+688, zht+692,
-    zht+696, zht+700, zht+704, zht+708, zht+712, zht+716,
-    zht+720, zht+724, zht+728, zht+732, zht+736, zht+740,
-    zht+744, zht+748, zht+752, zht+756, zht+760, zht+764,
-    zht+768, zht+772, zht+776, zht+780, zht+784, zht+788,
-    zht+792, zht+796, zht+800, zht+804, zht+808, zht+812,
-    zht+816, zht+820, zht+824, zht+828, zht+832, zht+836,
-    zht+840, zht+844, zht+848, zht+852, zht+856, zht+860,
-    zht+864, zht+868, zht+872, zht+876, zht+880, zht+884,
-    zht+888, zht+892, zht+896, zht+900, zht+904, zht+908,
-    zht+912, zht+916, zht+920, zht+924, zht+928, zht+932,
-    zht+936, zht+940, zht+944, zht+948, zht+952, zht+956,
-    zht+960, zht+964, zht+968, zht+972, zht+976, zht+980,
-    zht+984, zht+988, zht+992, zht+996, zht+1000, zht+1004,
-    zht+1008, zht+1012, zht+1016, zht+1020, zht+1024, zht+1028,
-    zht+1032, zht+1036, zht+1040, zht+1044, zht+1048, zht+1052,
-    zht+1056, zht+1060, zht+1064, zht+1068, zht+1072, zht+1076,
-    zht+1080, zht+1084, zht+1088, zht+1092, zht+1096, zht+1100,
-    zht+1104, zht+1108, zht+1112, zht+1116, zht+1120, zht+1124,
-    zht+1128, zht+1132, zht+1136, zht+1140, zht+1144, zht+1148,
-    zht+1152, zht+1156, zht+1160, zht+1164, zht+1168, zht+1172,
-    zht+1176, zht+1180, zht+1184, zht+1188, zht+1192, zht+1196,
-    zht+1200, zht+1204, zht+1208, zht+1212, zht+1216, zht+1220,
-    zht+1224, zht+1228, zht+1232, zht+1236, zht+1240, zht+1244,
-    zht+1248, zht+1252, zht+1256, zht+1260, zht+1264, zht+1268,
-    zht+1272, zht+1276, zht+1280, zht+1284, zht+1288, zht+1292,
-    zht+1296, zht+1300, zht+1304, zht+1308, zht+1312, zht+1316,
-    zht+1320, zht+1324, zht+1328, zht+1332, zht+1336, zht+1340,
-    zht+1344, zht+1348, zht+1352, zht+1356, zht+1360, zht+1364,
-    zht+1368, zht+1372, zht+1376, zht+1380, zht+1384, zht+1388,
-    zht+1392, zht+1396, zht+1400, zht+1404, zht+1408, zht+1412,
-    zht+1416, zht+1420, zht+1424, zht+1428, zht+1432, zht+1436,
-    zht+1440, zht+1444, zht+1448, zht+1452, zht+1456, zht+1460,
-    zht+1464, zht+1468, zht+1472, zht+1476, zht+1480, zht+1484,
-    zht+1488, zht+1492, zht+1496, zht+1500, zht+1504, zht+1508,
-    zht+1512, zht+1516, zht+1520, zht+1524, zht+1528, zht+1532,
-    zht+1536, zht+1540, zht+1544, zht+1548, zht+1552, zht+1556,
-    zht+1560, zht+1564, zht+1568, zht+1572, zht+1576, zht+1580,
-    zht+1584, zht+1588, zht+1592, zht+1596, zht+1600, zht+1604,
-    zht+1608, zht+1612, zht+1616, zht+1620, zht+1624, zht+1628,
-    zht+1632, zht+1636, zht+1640, zht+1644, zht+1648, zht+1652,
-    zht+1656, zht+1660, zht+1664, zht+1668, zht+1672, zht+1676,
-    zht+1680, zht+1684, zht+1688, zht+1692, zht+1696, zht+1700,
-    zht+1704, zht+1708, zht+1712, zht+1716, zht+1720, zht+1724,
-    zht+1728, zht+1732, zht+1736, zht+1740, zht+1744, zht+1748,
-    zht+1752, zht+1756, zht+1760, zht+1764, zht+1768, zht+1772,
-    zht+1776, zht+1780, zht+1784, zht+1788, zht+1792, zht+1796,
-    zht+1800, zht+1804, zht+1808, zht+1812, zht+1816, zht+1820,
-    zht+1824, zht+1828, zht+1832, zht+1836, zht+1840, zht+1844,
-    zht+1848, zht+1852, zht+1856, zht+1860, zht+1864, zht+1868,
-    zht+1872, zht+1876, zht+1880, zht+1884, zht+1888, zht+1892,
-    zht+1896, zht+1900, zht+1904, zht+1908, zht+1912, zht+1916,
-    zht+1920, zht+1924, zht+1928, zht+1932, zht+1936, zht+1940,
-    zht+1944, zht+1948, zht+1952, zht+1956, zht+1960, zht+1964,
-    zht+1968, zht+1972, zht+1976, zht+1980, zht+1984, zht+1988,
-    zht+1992, zht+1996, zht+2000, zht+2004, zht+2008, zht+2012,
-    zht+2016, zht+2020, zht+2024, zht+2028, zht+2032, zht+2036,
-    zht+2040, zht+2044, zht+2048, zht+2052, zht+2056, zht+2060,
-    zht+2064, zht+2068, zht+2072, zht+2076, zht+2080, zht+2084,
-    zht+2088, zht+2092, zht+2096, zht+2100, zht+2104, zht+2108,
-    zht+2112, zht+2116, zht+2120, zht+2124, zht+2128, zht+2132,
-    zht+2136, zht+2140, zht+2144, zht+2148, zht+2152, zht+2156,
-    zht+2160, zht+2164, zht+2168, zht+2172, zht+2176, zht+2180,
-    zht+2184, zht+2188, zht+2192, zht+2196, zht+2200, zht+2204,
-    zht+2208, zht+2212, zht+2216, zht+2220, zht+2224, zht+2228,
-    zht+2232, zht+2236, zht+2240, zht+2244, zht+2248, zht+2252,
-    zht+2256, zht+2260, zht+2264, zht+2268, zht+2272, zht+2276,
-    zht+2280, zht+2284, zht+2288, zht+2292, zht+2296, zht+2300,
-    zht+2304, zht+2308, zht+2312, zht+2316, zht+2320, zht+2324,
-    zht+2328, zht+2332, zht+2336, zht+2340, zht+2344, zht+2348,
-    zht+2352, zht+2356, zht+2360, zht+2364, zht+2368, zht+2372,
-    zht+2376, zht+2380, zht+2384, zht+2388, zht+2392, zht+2396,
-    zht+2400, zht+2404, zht+2408, zht+2412, zht+2416, zht+2420,
-    zht+2424, zht+2428, zht+2432, zht+2436, zht+2440, zht+2444,
-    zht+2448, zht+2452, zht+2456, zht+2460, zht+2464, zht+2468,
-    zht+2472, zht+2476, zht+2480, zht+2484, zht+2488, zht+2492,
-    zht+2496, zht+2500, zht+2504, zht+2508, zht+2512, zht+2516,
-    zht+2520, zht+2524, zht+2528, zht+2532, zht+2536, zht+2540,
-    zht+2544, zht+2548, zht+2552, zht+2556, zht+2560, zht+2564,
-    zht+2568, zht+2572, zht+2576, zht+2580, zht+2584, zht+2588,
-    zht+2592, zht+2596, zht+2600, zht+2604, zht+2608, zht+2612,
-    zht+2616, zht+2620, zht+2624, zht+2628, zht+2632, zht+2636,
-    zht+2640, zht+2644, zht+2648, zht+2652, zht+2656, zht+2660,
-    zht+2664, zht+2668, zht+2672, zht+2676, zht+2680, zht+2684,
-    zht+2688, zht+2692, zht+2696, zht+2700, zht+2704, zht+2708,
-    zht+2712, zht+2716, zht+2720, zht+2724, zht+2728, zht+2732,
-    zht+2736, zht+2740, zht+2744, zht+2748, zht+2752, zht+2756,
-    zht+2760, zht+2764, zht+2768, zht+2772, zht+2776, zht+2780,
-    zht+2784, zht+2788, zht+2792, zht+2796, zht+2800, zht+2804,
-    zht+2808, zht+2812, zht+2816, zht+2820, zht+2824, zht+2828,
-    zht+2832, zht+2836, zht+2840, zht+2844, zht+2848, zht+2852,
-    zht+2856, zht+2860, zht+2864, zht+2868, zht+2872, zht+2876,
-    zht+2880, zht+2884, zht+2888, zht+2892, zht+2896, zht+2900,
-    zht+2904, zht+2908, zht+2912, zht+2916, zht+2920, zht+2924,
-    zht+2928, zht+2932, zht+2936, zht+2940, zht+2944, zht+2948,
-    zht+2952, zht+2956, zht+2960, zht+2964, zht+2968, zht+2972,
-    zht+2976, zht+2980, zht+2984, zht+2988, zht+2992, zht+2996,
-    zht+3000, zht+3004, zht+3008, zht+3012, zht+3016, zht+3020,
-    zht+3024, zht+3028, zht+3032, zht+3036, zht+3040, zht+3044,
-    zht+3048, zht+3052, zht+3056, zht+3060, zht+3064, zht+3068,
-    zht+3072, zht+3076, zht+3080, zht+3084, zht+3088, zht+3092,
-    zht+3096, zht+3100, zht+3104, zht+3108, zht+3112, zht+3116,
-    zht+3120, zht+3124, zht+3128, zht+3132, zht+3136, zht+3140,
-    zht+3144, zht+3148, zht+3152, zht+3156, zht+3160, zht+3164,
-    zht+3168, zht+3172, zht+3176, zht+3180, zht+3184, zht+3188,
-    zht+3192, zht+3196, zht+3200, zht+3204, zht+3208, zht+3212,
-    zht+3216, zht+3220, zht+3224, zht+3228, zht+3232, zht+3236,
-    zht+3240, zht+3244, zht+3248, zht+3252, zht+3256, zht+3260,
-    zht+3264, zht+3268, zht+3272, zht+3276, zht+3280, zht+3284,
-    zht+3288, zht+3292, zht+3296, zht+3300, zht+3304, zht+3308,
-    zht+3312, zht+3316, zht+3320, zht+3324, zht+3328, zht+3332,
-    zht+3336, zht+3340, zht+3344, zht+3348, zht+3352, zht+3356,
-    zht+3360, zht+3364, zht+3368, zht+3372, zht+3376, zht+3380,
-    zht+3384, zht+3388, zht+3392, zht+3396, zht+3400, zht+3404,
-    zht+3408, zht+3412, zht+3416, zht+3420, zht+3424, zht+3428,
-    zht+3432, zht+3436, zht+3440, zht+3444, zht+3448, zht+3452,
-    zht+3456, zht+3460, zht+3464, zht+3468, zht+3472, zht+3476,
-    zht+3480, zht+3484, zht+3488, zht+3492, zht+3496, zht+3500,
-    zht+3504, zht+3508, zht+3512, zht+3516, zht+3520, zht+3524,
-    zht+3528, zht+3532, zht+3536, zht+3540, zht+3544, zht+3548,
-    zht+3552, zht+3556, zht+3560, zht+3564, zht+3568, zht+3572,
-    zht+3576, zht+3580, zht+3584, zht+3588, zht+3592, zht+3596,
-    zht+3600, zht+3604, zht+3608, zht+3612, zht+3616, zht+3620,
-    zht+3624, zht+3628, zht+3632, zht+3636, zht+3640, zht+3644,
-    zht+3648, zht+3652, zht+3656, zht+3660, zht+3664, zht+3668,
-    zht+3672, zht+3676, zht+3680, zht+3684, zht+3688, zht+3692,
-    zht+3696, zht+3700, zht+3704, zht+3708, zht+3712, zht+3716,
-    zht+3720, zht+3724, zht+3728, zht+3732, zht+3736, zht+3740,
-    zht+3744, zht+3748, zht+3752, zht+3756, zht+3760, zht+3764,
-    zht+3768, zht+3772, zht+3776, zht+3780, zht+3784, zht+3788,
-    zht+3792, zht+3796, zht+3800, zht+3804, zht+3808, zht+3812,
-    zht+3816, zht+3820, zht+3824, zht+3828, zht+3832, zht+3836,
-    zht+3840, zht+3844, zht+3848, zht+3852, zht+3856, zht+3860,
-    zht+3864, zht+3868, zht+3872, zht+3876, zht+3880, zht+3884,
-    zht+3888, zht+3892, zht+3896, zht+3900, zht+3904, zht+3908,
-    zht+3912, zht+3916, zht+3920, zht+3924, zht+3928, zht+3932,
-    zht+3936, zht+3940, zht+3944, zht+3948, zht+3952, zht+3956,
-    zht+3960, zht+3964, zht+3968, zht+3972, zht+3976, zht+3980,
-    zht+3984, zht+3988, zht+3992, zht+3996, zht+4000, zht+4004,
-    zht+4008, zht+4012, zht+4016, zht+4020, zht+4024, zht+4028,
-    zht+4032, zht+4036, zht+4040, zht+4044, zht+4048, zht+4052,
-    zht+4056, zht+4060, zht+4064, zht+4068, zht+4072, zht+4076,
-    zht+4080, zht+4084, zht+4088, zht+4092, zht+4096, zht+4100,
-    zht+4104, zht+4108, zht+4112, zht+4116, zht+4120, zht+4124,
-    zht+4128, zht+4132, zht+4136, zht+4140, zht+4144, zht+4148,
-    zht+4152, zht+4156, zht+4160, zht+4164, zht+4168, zht+4172,
-    zht+4176, zht+4180, zht+4184, zht+4188, zht+4192, zht+4196,
-    zht+4200, zht+4204, zht+4208, zht+4212, zht+4216, zht+4220,
-    zht+4224, zht+4228, zht+4232, zht+4236, zht+4240, zht+4244,
-    zht+4248, zht+4252, zht+4256, zht+4260, zht+4264, zht+4268,
-    zht+4272, zht+4276, zht+4280, zht+4284, zht+4288, zht+4292,
-    zht+4296, zht+4300, zht+4304, zht+4308, zht+4312, zht+4316,
-    zht+4320, zht+4324, zht+4328, zht+4332, zht+4336, zht+4340,
-    zht+4344, zht+4348, zht+4352, zht+4356, zht+4360, zht+4364,
-    zht+4368, zht+4372, zht+4376, zht+4380, zht+4384, zht+4388,
-    zht+4392, zht+4396, zht+4400, zht+4404, zht+4408, zht+4412,
-    zht+4416, zht+4420, zht+4424, zht+4428, zht+4432, zht+4436,
-    zht+4440, zht+4444, zht+4448, zht+4452, zht+4456, zht+4460,
-    zht+4464, zht+4468, zht+4472, zht+4476, zht+4480, zht+4484,
-    zht+4488, zht+4492, zht+4496, zht+4500, zht+4504, zht+4508,
-    zht+4512, zht+4516, zht+4520, zht+4524, zht+4528, zht+4532,
-    zht+4536, zht+4540, zht+4544, zht+4548, zht+4552, zht+4556,
-    zht+4560, zht+4564, zht+4568, zht+4572, zht+4576, zht+4580,
-    zht+4584, zht+4588, zht+4592, zht+4596, zht+4600, zht+4604,
-    zht+4608, zht+4612, zht+4616, zht+4620, zht+4624, zht+4628,
-    zht+4632, zht+4636, zht+4640, zht+4644, zht+4648, zht+4652,
-    zht+4656, zht+4660, zht+4664, zht+4668, zht+4672, zht+4676,
-    zht+4680, zht+4684, zht+4688, zht+4692, zht+4696, zht+4700,
-    zht+4704, zht+4708, zht+4712, zht+4716, zht+4720, zht+4724,
-    zht+4728, zht+4732, zht+4736, zht+4740, zht+4744, zht+4748,
-    zht+4752, zht+4756, zht+4760, zht+4764, zht+4768, zht+4772,
-    zht+4776, zht+4780, zht+4784, zht+4788, zht+4792, zht+4796,
-    zht+4800, zht+4804, zht+4808, zht+4812, zht+4816, zht+4820,
-    zht+4824, zht+4828, zht+4832, zht+4836, zht+4840, zht+4844,
-    zht+4848, zht+4852, zht+4856, zht+4860, zht+4864, zht+4868,
-    zht+4872, zht+4876, zht+4880, zht+4884, zht+4888, zht+4892,
-    zht+4896, zht+4900, zht+4904, zht+4908, zht+4912, zht+4916,
-    zht+4920, zht+4924, zht+4928, zht+4932, zht+4936, zht+4940,
-    zht+4944, zht+4948, zht+4952, zht+4956, zht+4960, zht+4964,
-    zht+4968, zht+4972, zht+4976, zht+4980, zht+4984, zht+4988,
-    zht+4992, zht+4996, zht+5000, zht+5004, zht+5008, zht+5012,
-    zht+5016, zht+5020, zht+5024, zht+5028, zht+5032, zht+5036,
-    zht+5040, zht+5044, zht+5048, zht+5052, zht+5056, zht+5060,
-    zht+5064, zht+5068, zht+5072, zht+5076, zht+5080, zht+5084,
-    zht+5088, zht+5092, zht+5096, zht+5100, zht+5104, zht+5108,
-    zht+5112, zht+5116, zht+5120, zht+5124, zht+5128, zht+5132,
-    zht+5136, zht+5140, zht+5144, zht+5148, zht+5152, zht+5156,
-    zht+5160, zht+5164, zht+5168, zht+5172, zht+5176, zht+5180,
-    zht+5184, zht+5188, zht+5192, zht+5196, zht+5200, zht+5204,
-    zht+5208, zht+5212, zht+5216, zht+5220, zht+5224, zht+5228,
-    zht+5232, zht+5236, zht+5240, zht+5244, zht+5248, zht+5252,
-    zht+5256, zht+5260, zht+5264, zht+5268, zht+5272, zht+5276,
-    zht+5280, zht+5284, zht+5288, zht+5292, zht+5296, zht+5300,
-    zht+5304, zht+5308, zht+5312, zht+5316, zht+5320, zht+5324,
-    zht+5328, zht+5332, zht+5336, zht+5340, zht+5344, zht+5348,
-    zht+5352, zht+5356, zht+5360, zht+5364, zht+5368, zht+5372,
-    zht+5376, zht+5380, zht+5384, zht+5388, zht+5392, zht+5396,
-    zht+5400, zht+5404, zht+5408, zht+5412, zht+5416, zht+5420,
-    zht+5424, zht+5428, zht+5432, zht+5436, zht+5440, zht+5444,
-    zht+5448, zht+5452, zht+5456, zht+5460, zht+5464, zht+5468,
-    zht+5472, zht+5476, zht+5480, zht+5484, zht+5488, zht+5492,
-    zht+5496, zht+5500, zht+5504, zht+5508, zht+5512, zht+5516,
-    zht+5520, zht+5524, zht+5528, zht+5532, zht+5536, zht+5540,
-    zht+5544, zht+5548, zht+5552, zht+5556, zht+5560, zht+5564,
-    zht+5568, zht+5572, zht+5576, zht+5580, zht+5584, zht+5588,
-    zht+5592, zht+5596, zht+5600, zht+5604, zht+5608, zht+5612,
-    zht+5616, zht+5620, zht+5624, zht+5628, zht+5632, zht+5636,
-    zht+5640, zht+5644, zht+5648, zht+5652, zht+5656, zht+5660,
-    zht+5664, zht+5668, zht+5672, zht+5676, zht+5680, zht+5684,
-    zht+5688, zht+5692, zht+5696, zht+5700, zht+5704, zht+5708,
-    zht+5712, zht+5716, zht+5720, zht+5724, zht+5728, zht+5732,
-    zht+5736, zht+5740, zht+5744, zht+5748, zht+5752, zht+5756,
-    zht+5760, zht+5764, zht+5768, zht+5772, zht+5776, zht+5780,
-    zht+5784, zht+5788, zht+5792, zht+5796, zht+5800, zht+5804,
-    zht+5808, zht+5812, zht+5816, zht+5820, zht+5824, zht+5828,
-    zht+5832, zht+5836, zht+5840, zht+5844, zht+5848, zht+5852,
-    zht+5856, zht+5860, zht+5864, zht+5868, zht+5872, zht+5876,
-    zht+5880, zht+5884, zht+5888, zht+5892, zht+5896, zht+5900,
-    zht+5904, zht+5908, zht+5912, zht+5916, zht+5920, zht+5924,
-    zht+5928, zht+5932, zht+5936, zht+5940, zht+5944, zht+5948,
-    zht+5952, zht+5956, zht+5960, zht+5964, zht+5968, zht+5972,
-    zht+5976, zht+5980, zht+5984, zht+5988, zht+5992, zht+5996,
-    zht+6000, zht+6004, zht+6008, zht+6012, zht+6016, zht+6020,
-    zht+6024, zht+6028, zht+6032, zht+6036, zht+6040, zht+6044,
-    zht+6048, zht+6052, zht+6056, zht+6060, zht+6064, zht+6068,
-    zht+6072, zht+6076, zht+6080, zht+6084, zht+6088, zht+6092,
-    zht+6096, zht+6100, zht+6104, zht+6108, zht+6112, zht+6116,
-    zht+6120, zht+6124, zht+6128, zht+6132, zht+6136, zht+6140,
-    zht+6144, zht+6148, zht+6152, zht+6156, zht+6160, zht+6164,
-    zht+6168, zht+6172, zht+6176, zht+6180, zht+6184, zht+6188,
-    zht+6192, zht+6196, zht+6200, zht+6204, zht+6208, zht+6212,
-    zht+6216, zht+6220, zht+6224, zht+6228, zht+6232, zht+6236,
-    zht+6240, zht+6244, zht+6248, zht+6252, zht+6256, zht+6260,
-    zht+6264, zht+6268, zht+6272, zht+6276, zht+6280, zht+6284,
-    zht+6288, zht+6292, zht+6296, zht+6300, zht+6304, zht+6308,
-    zht+6312, zht+6316, zht+6320, zht+6324, zht+6328, zht+6332,
-    zht+6336, zht+6340, zht+6344, zht+6348, zht+6352, zht+6356,
-    zht+6360, zht+6364, zht+6368, zht+6372, zht+6376, zht+6380,
-    zht+6384, zht+6388, zht+6392, zht+6396, zht+6400, zht+6404,
-    zht+6408, zht+6412, zht+6416, zht+6420, zht+6424, zht+6428,
-    zht+6432, zht+6436, zht+6440, zht+6444, zht+6448, zht+6452,
-    zht+6456, zht+6460, zht+6464, zht+6468, zht+6472, zht+6476,
-    zht+6480, zht+6484, zht+6488, zht+6492, zht+6496, zht+6500,
-    zht+6504, zht+6508, zht+6512, zht+6516, zht+6520, zht+6524,
-    zht+6528, zht+6532, zht+6536, zht+6540, zht+6544, zht+6548,
-    zht+6552, zht+6556, zht+6560, zht+6564, zht+6568, zht+6572,
-    zht+6576, zht+6580, zht+6584, zht+6588, zht+6592, zht+6596,
-    zht+6600, zht+6604, zht+6608, zht+6612, zht+6616, zht+6620,
-    zht+6624, zht+6628, zht+6632, zht+6636, zht+6640, zht+6644,
-    zht+6648, zht+6652, zht+6656, zht+6660, zht+6664, zht+6668,
-    zht+6672, zht+6676, zht+6680, zht+6684, zht+6688, zht+6692,
-    zht+6696, zht+6700, zht+6704, zht+6708, zht+6712, zht+6716,
-    zht+6720, zht+6724, zht+6728, zht+6732, zht+6736, zht+6740,
-    zht+6744, zht+6748, zht+6752, zht+6756, zht+6760, zht+6764,
-    zht+6768, zht+6772, zht+6776, zht+6780, zht+6784, zht+6788,
-    zht+6792, zht+6796, zht+6800, zht+6804, zht+6808, zht+6812,
-    zht+6816, zht+6820, zht+6824, zht+6828, zht+6832, zht+6836,
-    zht+6840, zht+6844, zht+6848, zht+6852, zht+6856, zht+6860,
-    zht+6864, zht+6868, zht+6872, zht+6876, zht+6880, zht+6884,
-    zht+6888, zht+6892, zht+6896, zht+6900, zht+6904, zht+6908,
-    zht+6912, zht+6916, zht+6920, zht+6924, zht+6928, zht+6932,
-    zht+6936, zht+6940, zht+6944, zht+6948, zht+6952, zht+6956,
-    zht+6960, zht+6964, zht+6968, zht+6972, zht+6976, zht+6980,
-    zht+6984, zht+6988, zht+6992, zht+6996, zht+7000, zht+7004,
-    zht+7008, zht+7012, zht+7016, zht+7020, zht+7024, zht+7028,
-    zht+7032, zht+7036, zht+7040, zht+7044, zht+7048, zht+7052,
-    zht+7056, zht+7060, zht+7064, zht+7068, zht+7072, zht+7076,
-    zht+7080, zht+7084, zht+7088, zht+7092, zht+7096, zht+7100,
-    zht+7104, zht+7108, zht+7112, zht+7116, zht+7120, zht+7124,
-    zht+7128, zht+7132, zht+7136, zht+7140, zht+7144, zht+7148,
-    zht+7152, zht+7156, zht+7160, zht+7164, zht+7168, zht+7172,
-    zht+7176, zht+7180, zht+7184, zht+7188, zht+7192, zht+7196,
-    zht+7200, zht+7204, zht+7208, zht+7212, zht+7216, zht+7220,
-    zht+7224, zht+7228, zht+7232, zht+7236, zht+7240, zht+7244,
-    zht+7248, zht+7252, zht+7256, zht+7260, zht+7264, zht+7268,
-    zht+7272, zht+7276, zht+7280, zht+7284, zht+7288, zht+7292,
-    zht+7296, zht+7300, zht+7304, zht+7308, zht+7312, zht+7316,
-    zht+7320, zht+7324, zht+7328, zht+7332, zht+7336, zht+7340,
-    zht+7344, zht+7348, zht+7352, zht+7356, zht+7360, zht+7364,
-    zht+7368, zht+7372, zht+7376, zht+7380, zht+7384, zht+7388,
-    zht+7392, zht+7396, zht+7400, zht+7404, zht+7408, zht+7412,
-    zht+7416, zht+7420, zht+7424, zht+7428, zht+7432, zht+7436,
-    zht+7440, zht+7444, zht+7448, zht+7452, zht+7456, zht+7460,
-    zht+7464, zht+7468, zht+7472, zht+7476, zht+7480, zht+7484,
-    zht+7488, zht+7492, zht+7496, zht+7500, zht+7504, zht+7508,
-    zht+7512, zht+7516, zht+7520, zht+7524, zht+7528, zht+7532,
-    zht+7536, zht+7540, zht+7544, zht+7548, zht+7552, zht+7556,
-    zht+7560, zht+7564, zht+7568, zht+7572, zht+7576, zht+7580,
-    zht+7584, zht+7588, zht+7592, zht+7596, zht+7600, zht+7604,
-    zht+7608, zht+7612, zht+7616, zht+7620, zht+7624, zht+7628,
-    zht+7632, zht+7636, zht+7640, zht+7644, zht+7648, zht+7652,
-    zht+7656, zht+7660, zht+7664, zht+7668, zht+7672, zht+7676,
-    zht+7680, zht+7684, zht+7688, zht+7692, zht+7696, zht+7700,
-    zht+7704, zht+7708, zht+7712, zht+7716, zht+7720, zht+7724,
-    zht+7728, zht+7732, zht+7736, zht+7740, zht+7744, zht+7748,
-    zht+7752, zht+7756, zht+7760, zht+7764, zht+7768, zht+7772,
-    zht+7776, zht+7780, zht+7784, zht+7788, zht+7792, zht+7796,
-    zht+7800, zht+7804, zht+7808, zht+7812, zht+7816, zht+7820,
-    zht+7824, zht+7828, zht+7832, zht+7836, zht+7840, zht+7844,
-    zht+7848, zht+7852, zht+7856, zht+7860, zht+7864, zht+7868,
-    zht+7872, zht+7876, zht+7880, zht+7884, zht+7888, zht+7892,
-    zht+7896, zht+7900, zht+7904, zht+7908, zht+7912, zht+7916,
-    zht+7920, zht+7924, zht+7928, zht+7932, zht+7936, zht+7940,
-    zht+7944, zht+7948, zht+7952, zht+7956, zht+7960, zht+7964,
-    zht+7968, zht+7972, zht+7976, zht+7980, zht+7984, zht+7988,
-    zht+7992, zht+7996, zht+8000, zht+8004, zht+8008, zht+8012,
-    zht+8016, zht+8020, zht+8024, zht+8028, zht+8032, zht+8036,
-    zht+8040, zht+8044, zht+8048, zht+8052, zht+8056, zht+8060,
-    zht+8064, zht+8068, zht+8072, zht+8076, zht+8080, zht+8084,
-    zht+8088, zht+8092, zht+8096, zht+8100, zht+8104, zht+8108,
-    zht+8112, zht+8116, zht+8120, zht+8124, zht+8128, zht+8132,
-    zht+8136, zht+8140, zht+8144, zht+8148, zht+8152, zht+8156,
-    zht+8160, zht+8164, zht+8168, zht+8172, zht+8176, zht+8180,
-    zht+8184, zht+8188, zht+8192,
+static const uint16_t zht_o[] = {
+    0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44,
+    48, 52, 56, 60, 64, 68, 72, 76, 80, 84, 88, 92,
+    96, 100, 104, 108, 112, 116, 120, 124, 128, 132, 136, 140,
+    144, 148, 152, 156, 160, 164, 168, 172, 176, 180, 184, 188,
+    192, 196, 200, 204, 208, 212, 216, 220, 224, 228, 232, 236,
+    240, 244, 248, 252, 256, 260, 264, 268, 272, 276, 280, 284,
+    288, 292, 296, 300, 304, 308, 312, 316, 320, 324, 328, 332,
+    336, 340, 344, 348, 352, 356, 360, 364, 368, 372, 376, 380,
+    384, 388, 392, 396, 400, 404, 408, 412, 416, 420, 424, 428,
+    432, 436, 440, 444, 448, 452, 456, 460, 464, 468, 472, 476,
+    480, 484, 488, 492, 496, 500, 504, 508, 512, 516, 520, 524,
+    528, 532, 536, 540, 544, 548, 552, 556, 560, 564, 568, 572,
+    576, 580, 584, 588, 592, 596, 600, 604, 608, 612, 616, 620,
+    624, 628, 632, 636, 640, 644, 648, 652, 656, 660, 664, 668,
+    672, 676, 680, 684, 688, 692, 696, 700, 704, 708, 712, 716,
+    720, 724, 728, 732, 736, 740, 744, 748, 752, 756, 760, 764,
+    768, 772, 776, 780, 784, 788, 792, 796, 800, 804, 808, 812,
+    816, 820, 824, 828, 832, 836, 840, 844, 848, 852, 856, 860,
+    864, 868, 872, 876, 880, 884, 888, 892, 896, 900, 904, 908,
+    912, 916, 920, 924, 928, 932, 936, 940, 944, 948, 952, 956,
+    960, 964, 968, 972, 976, 980, 984, 988, 992, 996, 1000, 1004,
+    1008, 1012, 1016, 1020, 1024, 1028, 1032, 1036, 1040, 1044, 1048, 1052,
+    1056, 1060, 1064, 1068, 1072, 1076, 1080, 1084, 1088, 1092, 1096, 1100,
+    1104, 1108, 1112, 1116, 1120, 1124, 1128, 1132, 1136, 1140, 1144, 1148,
+    1152, 1156, 1160, 1164, 1168, 1172, 1176, 1180, 1184, 1188, 1192, 1196,
+    1200, 1204, 1208, 1212, 1216, 1220, 1224, 1228, 1232, 1236, 1240, 1244,
+    1248, 1252, 1256, 1260, 1264, 1268, 1272, 1276, 1280, 1284, 1288, 1292,
+    1296, 1300, 1304, 1308, 1312, 1316, 1320, 1324, 1328, 1332, 1336, 1340,
+    1344, 1348, 1352, 1356, 1360, 1364, 1368, 1372, 1376, 1380, 1384, 1388,
+    1392, 1396, 1400, 1404, 1408, 1412, 1416, 1420, 1424, 1428, 1432, 1436,
+    1440, 1444, 1448, 1452, 1456, 1460, 1464, 1468, 1472, 1476, 1480, 1484,
+    1488, 1492, 1496, 1500, 1504, 1508, 1512, 1516, 1520, 1524, 1528, 1532,
+    1536, 1540, 1544, 1548, 1552, 1556, 1560, 1564, 1568, 1572, 1576, 1580,
+    1584, 1588, 1592, 1596, 1600, 1604, 1608, 1612, 1616, 1620, 1624, 1628,
+    1632, 1636, 1640, 1644, 1648, 1652, 1656, 1660, 1664, 1668, 1672, 1676,
+    1680, 1684, 1688, 1692, 1696, 1700, 1704, 1708, 1712, 1716, 1720, 1724,
+    1728, 1732, 1736, 1740, 1744, 1748, 1752, 1756, 1760, 1764, 1768, 1772,
+    1776, 1780, 1784, 1788, 1792, 1796, 1800, 1804, 1808, 1812, 1816, 1820,
+    1824, 1828, 1832, 1836, 1840, 1844, 1848, 1852, 1856, 1860, 1864, 1868,
+    1872, 1876, 1880, 1884, 1888, 1892, 1896, 1900, 1904, 1908, 1912, 1916,
+    1920, 1924, 1928, 1932, 1936, 1940, 1944, 1948, 1952, 1956, 1960, 1964,
+    1968, 1972, 1976, 1980, 1984, 1988, 1992, 1996, 2000, 2004, 2008, 2012,
+    2016, 2020, 2024, 2028, 2032, 2036, 2040, 2044, 2048, 2052, 2056, 2060,
+    2064, 2068, 2072, 2076, 2080, 2084, 2088, 2092, 2096, 2100, 2104, 2108,
+    2112, 2116, 2120, 2124, 2128, 2132, 2136, 2140, 2144, 2148, 2152, 2156,
+    2160, 2164, 2168, 2172, 2176, 2180, 2184, 2188, 2192, 2196, 2200, 2204,
+    2208, 2212, 2216, 2220, 2224, 2228, 2232, 2236, 2240, 2244, 2248, 2252,
+    2256, 2260, 2264, 2268, 2272, 2276, 2280, 2284, 2288, 2292, 2296, 2300,
+    2304, 2308, 2312, 2316, 2320, 2324, 2328, 2332, 2336, 2340, 2344, 2348,
+    2352, 2356, 2360, 2364, 2368, 2372, 2376, 2380, 2384, 2388, 2392, 2396,
+    2400, 2404, 2408, 2412, 2416, 2420, 2424, 2428, 2432, 2436, 2440, 2444,
+    2448, 2452, 2456, 2460, 2464, 2468, 2472, 2476, 2480, 2484, 2488, 2492,
+    2496, 2500, 2504, 2508, 2512, 2516, 2520, 2524, 2528, 2532, 2536, 2540,
+    2544, 2548, 2552, 2556, 2560, 2564, 2568, 2572, 2576, 2580, 2584, 2588,
+    2592, 2596, 2600, 2604, 2608, 2612, 2616, 2620, 2624, 2628, 2632, 2636,
+    2640, 2644, 2648, 2652, 2656, 2660, 2664, 2668, 2672, 2676, 2680, 2684,
+    2688, 2692, 2696, 2700, 2704, 2708, 2712, 2716, 2720, 2724, 2728, 2732,
+    2736, 2740, 2744, 2748, 2752, 2756, 2760, 2764, 2768, 2772, 2776, 2780,
+    2784, 2788, 2792, 2796, 2800, 2804, 2808, 2812, 2816, 2820, 2824, 2828,
+    2832, 2836, 2840, 2844, 2848, 2852, 2856, 2860, 2864, 2868, 2872, 2876,
+    2880, 2884, 2888, 2892, 2896, 2900, 2904, 2908, 2912, 2916, 2920, 2924,
+    2928, 2932, 2936, 2940, 2944, 2948, 2952, 2956, 2960, 2964, 2968, 2972,
+    2976, 2980, 2984, 2988, 2992, 2996, 3000, 3004, 3008, 3012, 3016, 3020,
+    3024, 3028, 3032, 3036, 3040, 3044, 3048, 3052, 3056, 3060, 3064, 3068,
+    3072, 3076, 3080, 3084, 3088, 3092, 3096, 3100, 3104, 3108, 3112, 3116,
+    3120, 3124, 3128, 3132, 3136, 3140, 3144, 3148, 3152, 3156, 3160, 3164,
+    3168, 3172, 3176, 3180, 3184, 3188, 3192, 3196, 3200, 3204, 3208, 3212,
+    3216, 3220, 3224, 3228, 3232, 3236, 3240, 3244, 3248, 3252, 3256, 3260,
+    3264, 3268, 3272, 3276, 3280, 3284, 3288, 3292, 3296, 3300, 3304, 3308,
+    3312, 3316, 3320, 3324, 3328, 3332, 3336, 3340, 3344, 3348, 3352, 3356,
+    3360, 3364, 3368, 3372, 3376, 3380, 3384, 3388, 3392, 3396, 3400, 3404,
+    3408, 3412, 3416, 3420, 3424, 3428, 3432, 3436, 3440, 3444, 3448, 3452,
+    3456, 3460, 3464, 3468, 3472, 3476, 3480, 3484, 3488, 3492, 3496, 3500,
+    3504, 3508, 3512, 3516, 3520, 3524, 3528, 3532, 3536, 3540, 3544, 3548,
+    3552, 3556, 3560, 3564, 3568, 3572, 3576, 3580, 3584, 3588, 3592, 3596,
+    3600, 3604, 3608, 3612, 3616, 3620, 3624, 3628, 3632, 3636, 3640, 3644,
+    3648, 3652, 3656, 3660, 3664, 3668, 3672, 3676, 3680, 3684, 3688, 3692,
+    3696, 3700, 3704, 3708, 3712, 3716, 3720, 3724, 3728, 3732, 3736, 3740,
+    3744, 3748, 3752, 3756, 3760, 3764, 3768, 3772, 3776, 3780, 3784, 3788,
+    3792, 3796, 3800, 3804, 3808, 3812, 3816, 3820, 3824, 3828, 3832, 3836,
+    3840, 3844, 3848, 3852, 3856, 3860, 3864, 3868, 3872, 3876, 3880, 3884,
+    3888, 3892, 3896, 3900, 3904, 3908, 3912, 3916, 3920, 3924, 3928, 3932,
+    3936, 3940, 3944, 3948, 3952, 3956, 3960, 3964, 3968, 3972, 3976, 3980,
+    3984, 3988, 3992, 3996, 4000, 4004, 4008, 4012, 4016, 4020, 4024, 4028,
+    4032, 4036, 4040, 4044, 4048, 4052, 4056, 4060, 4064, 4068, 4072, 4076,
+    4080, 4084, 4088, 4092, 4096, 4100, 4104, 4108, 4112, 4116, 4120, 4124,
+    4128, 4132, 4136, 4140, 4144, 4148, 4152, 4156, 4160, 4164, 4168, 4172,
+    4176, 4180, 4184, 4188, 4192, 4196, 4200, 4204, 4208, 4212, 4216, 4220,
+    4224, 4228, 4232, 4236, 4240, 4244, 4248, 4252, 4256, 4260, 4264, 4268,
+    4272, 4276, 4280, 4284, 4288, 4292, 4296, 4300, 4304, 4308, 4312, 4316,
+    4320, 4324, 4328, 4332, 4336, 4340, 4344, 4348, 4352, 4356, 4360, 4364,
+    4368, 4372, 4376, 4380, 4384, 4388, 4392, 4396, 4400, 4404, 4408, 4412,
+    4416, 4420, 4424, 4428, 4432, 4436, 4440, 4444, 4448, 4452, 4456, 4460,
+    4464, 4468, 4472, 4476, 4480, 4484, 4488, 4492, 4496, 4500, 4504, 4508,
+    4512, 4516, 4520, 4524, 4528, 4532, 4536, 4540, 4544, 4548, 4552, 4556,
+    4560, 4564, 4568, 4572, 4576, 4580, 4584, 4588, 4592, 4596, 4600, 4604,
+    4608, 4612, 4616, 4620, 4624, 4628, 4632, 4636, 4640, 4644, 4648, 4652,
+    4656, 4660, 4664, 4668, 4672, 4676, 4680, 4684, 4688, 4692, 4696, 4700,
+    4704, 4708, 4712, 4716, 4720, 4724, 4728, 4732, 4736, 4740, 4744, 4748,
+    4752, 4756, 4760, 4764, 4768, 4772, 4776, 4780, 4784, 4788, 4792, 4796,
+    4800, 4804, 4808, 4812, 4816, 4820, 4824, 4828, 4832, 4836, 4840, 4844,
+    4848, 4852, 4856, 4860, 4864, 4868, 4872, 4876, 4880, 4884, 4888, 4892,
+    4896, 4900, 4904, 4908, 4912, 4916, 4920, 4924, 4928, 4932, 4936, 4940,
+    4944, 4948, 4952, 4956, 4960, 4964, 4968, 4972, 4976, 4980, 4984, 4988,
+    4992, 4996, 5000, 5004, 5008, 5012, 5016, 5020, 5024, 5028, 5032, 5036,
+    5040, 5044, 5048, 5052, 5056, 5060, 5064, 5068, 5072, 5076, 5080, 5084,
+    5088, 5092, 5096, 5100, 5104, 5108, 5112, 5116, 5120, 5124, 5128, 5132,
+    5136, 5140, 5144, 5148, 5152, 5156, 5160, 5164, 5168, 5172, 5176, 5180,
+    5184, 5188, 5192, 5196, 5200, 5204, 5208, 5212, 5216, 5220, 5224, 5228,
+    5232, 5236, 5240, 5244, 5248, 5252, 5256, 5260, 5264, 5268, 5272, 5276,
+    5280, 5284, 5288, 5292, 5296, 5300, 5304, 5308, 5312, 5316, 5320, 5324,
+    5328, 5332, 5336, 5340, 5344, 5348, 5352, 5356, 5360, 5364, 5368, 5372,
+    5376, 5380, 5384, 5388, 5392, 5396, 5400, 5404, 5408, 5412, 5416, 5420,
+    5424, 5428, 5432, 5436, 5440, 5444, 5448, 5452, 5456, 5460, 5464, 5468,
+    5472, 5476, 5480, 5484, 5488, 5492, 5496, 5500, 5504, 5508, 5512, 5516,
+    5520, 5524, 5528, 5532, 5536, 5540, 5544, 5548, 5552, 5556, 5560, 5564,
+    5568, 5572, 5576, 5580, 5584, 5588, 5592, 5596, 5600, 5604, 5608, 5612,
+    5616, 5620, 5624, 5628, 5632, 5636, 5640, 5644, 5648, 5652, 5656, 5660,
+    5664, 5668, 5672, 5676, 5680, 5684, 5688, 5692, 5696, 5700, 5704, 5708,
+    5712, 5716, 5720, 5724, 5728, 5732, 5736, 5740, 5744, 5748, 5752, 5756,
+    5760, 5764, 5768, 5772, 5776, 5780, 5784, 5788, 5792, 5796, 5800, 5804,
+    5808, 5812, 5816, 5820, 5824, 5828, 5832, 5836, 5840, 5844, 5848, 5852,
+    5856, 5860, 5864, 5868, 5872, 5876, 5880, 5884, 5888, 5892, 5896, 5900,
+    5904, 5908, 5912, 5916, 5920, 5924, 5928, 5932, 5936, 5940, 5944, 5948,
+    5952, 5956, 5960, 5964, 5968, 5972, 5976, 5980, 5984, 5988, 5992, 5996,
+    6000, 6004, 6008, 6012, 6016, 6020, 6024, 6028, 6032, 6036, 6040, 6044,
+    6048, 6052, 6056, 6060, 6064, 6068, 6072, 6076, 6080, 6084, 6088, 6092,
+    6096, 6100, 6104, 6108, 6112, 6116, 6120, 6124, 6128, 6132, 6136, 6140,
+    6144, 6148, 6152, 6156, 6160, 6164, 6168, 6172, 6176, 6180, 6184, 6188,
+    6192, 6196, 6200, 6204, 6208, 6212, 6216, 6220, 6224, 6228, 6232, 6236,
+    6240, 6244, 6248, 6252, 6256, 6260, 6264, 6268, 6272, 6276, 6280, 6284,
+    6288, 6292, 6296, 6300, 6304, 6308, 6312, 6316, 6320, 6324, 6328, 6332,
+    6336, 6340, 6344, 6348, 6352, 6356, 6360, 6364, 6368, 6372, 6376, 6380,
+    6384, 6388, 6392, 6396, 6400, 6404, 6408, 6412, 6416, 6420, 6424, 6428,
+    6432, 6436, 6440, 6444, 6448, 6452, 6456, 6460, 6464, 6468, 6472, 6476,
+    6480, 6484, 6488, 6492, 6496, 6500, 6504, 6508, 6512, 6516, 6520, 6524,
+    6528, 6532, 6536, 6540, 6544, 6548, 6552, 6556, 6560, 6564, 6568, 6572,
+    6576, 6580, 6584, 6588, 6592, 6596, 6600, 6604, 6608, 6612, 6616, 6620,
+    6624, 6628, 6632, 6636, 6640, 6644, 6648, 6652, 6656, 6660, 6664, 6668,
+    6672, 6676, 6680, 6684, 6688, 6692, 6696, 6700, 6704, 6708, 6712, 6716,
+    6720, 6724, 6728, 6732, 6736, 6740, 6744, 6748, 6752, 6756, 6760, 6764,
+    6768, 6772, 6776, 6780, 6784, 6788, 6792, 6796, 6800, 6804, 6808, 6812,
+    6816, 6820, 6824, 6828, 6832, 6836, 6840, 6844, 6848, 6852, 6856, 6860,
+    6864, 6868, 6872, 6876, 6880, 6884, 6888, 6892, 6896, 6900, 6904, 6908,
+    6912, 6916, 6920, 6924, 6928, 6932, 6936, 6940, 6944, 6948, 6952, 6956,
+    6960, 6964, 6968, 6972, 6976, 6980, 6984, 6988, 6992, 6996, 7000, 7004,
+    7008, 7012, 7016, 7020, 7024, 7028, 7032, 7036, 7040, 7044, 7048, 7052,
+    7056, 7060, 7064, 7068, 7072, 7076, 7080, 7084, 7088, 7092, 7096, 7100,
+    7104, 7108, 7112, 7116, 7120, 7124, 7128, 7132, 7136, 7140, 7144, 7148,
+    7152, 7156, 7160, 7164, 7168, 7172, 7176, 7180, 7184, 7188, 7192, 7196,
+    7200, 7204, 7208, 7212, 7216, 7220, 7224, 7228, 7232, 7236, 7240, 7244,
+    7248, 7252, 7256, 7260, 7264, 7268, 7272, 7276, 7280, 7284, 7288, 7292,
+    7296, 7300, 7304, 7308, 7312, 7316, 7320, 7324, 7328, 7332, 7336, 7340,
+    7344, 7348, 7352, 7356, 7360, 7364, 7368, 7372, 7376, 7380, 7384, 7388,
+    7392, 7396, 7400, 7404, 7408, 7412, 7416, 7420, 7424, 7428, 7432, 7436,
+    7440, 7444, 7448, 7452, 7456, 7460, 7464, 7468, 7472, 7476, 7480, 7484,
+    7488, 7492, 7496, 7500, 7504, 7508, 7512, 7516, 7520, 7524, 7528, 7532,
+    7536, 7540, 7544, 7548, 7552, 7556, 7560, 7564, 7568, 7572, 7576, 7580,
+    7584, 7588, 7592, 7596, 7600, 7604, 7608, 7612, 7616, 7620, 7624, 7628,
+    7632, 7636, 7640, 7644, 7648, 7652, 7656, 7660, 7664, 7668, 7672, 7676,
+    7680, 7684, 7688, 7692, 7696, 7700, 7704, 7708, 7712, 7716, 7720, 7724,
+    7728, 7732, 7736, 7740, 7744, 7748, 7752, 7756, 7760, 7764, 7768, 7772,
+    7776, 7780, 7784, 7788, 7792, 7796, 7800, 7804, 7808, 7812, 7816, 7820,
+    7824, 7828, 7832, 7836, 7840, 7844, 7848, 7852, 7856, 7860, 7864, 7868,
+    7872, 7876, 7880, 7884, 7888, 7892, 7896, 7900, 7904, 7908, 7912, 7916,
+    7920, 7924, 7928, 7932, 7936, 7940, 7944, 7948, 7952, 7956, 7960, 7964,
+    7968, 7972, 7976, 7980, 7984, 7988, 7992, 7996, 8000, 8004, 8008, 8012,
+    8016, 8020, 8024, 8028, 8032, 8036, 8040, 8044, 8048, 8052, 8056, 8060,
+    8064, 8068, 8072, 8076, 8080, 8084, 8088, 8092, 8096, 8100, 8104, 8108,
+    8112, 8116, 8120, 8124, 8128, 8132, 8136, 8140, 8144, 8148, 8152, 8156,
+    8160, 8164, 8168, 8172, 8176, 8180, 8184, 8188,
+   };
+
+static const uint16_t zht_d[] = {
+    44, 68, 17, 240, 63, 73, 0, 0, 9, 257, 41, 2,
+    12, 0, 0, 9, 155, 30, 55, 7, 19, 115, 66, 74,
+    33, 3, 60, 104, 72, 136, 136, 68, 7, 2, 21, 48,
+    12, 85, 54, 13, 446, 18, 64, 38, 4, 306, 25, 18,
+    54, 0, 0, 64, 2, 9, 71, 65, 13, 1, 315, 0,
+    1, 101, 1, 5, 356, 2, 7, 205, 3, 1, 216, 0,
+    24, 2, 11, 89, 8, 74, 431, 0, 1, 5, 43, 167,
+    15, 43, 136, 0, 12, 113, 0, 12, 96, 9, 8, 11,
+    337, 100, 0, 147, 164, 2, 1, 15, 51, 17, 10, 200,
+    7, 20, 956, 0, 2, 3, 30, 28, 0, 1, 38, 3,
+    18, 8, 26, 269, 16, 133, 36, 1, 2, 11, 1, 166,
+    565, 170, 14, 55, 19, 251, 223, 0, 28, 23, 9, 60,
+    149, 30, 214, 32, 0, 6, 1, 0, 3, 33, 7, 115,
+    16, 2, 499, 71, 189, 0, 8, 5, 9, 124, 12, 28,
+    13, 3, 100, 338, 18, 221, 11, 6, 405, 0, 106, 8,
+    17, 28, 0, 272, 109, 22, 85, 426, 20, 0, 82, 6,
+    107, 4, 0, 23, 372, 118, 0, 13, 0, 206, 13, 353,
+    20, 18, 32, 313, 437, 14, 262, 3, 2, 0, 26, 3,
+    1704, 2, 14, 161, 2, 213, 3, 126, 8, 165, 6, 87,
+    5, 1, 501, 28, 390, 58, 2, 146, 8, 0, 55, 4,
+    1, 73, 0, 5, 4, 436, 16, 47, 16, 1, 13, 9,
+    12, 1, 1492, 165, 44, 130, 8, 106, 264, 44, 52, 31,
+    13, 694, 2, 63, 3, 372, 1, 15, 0, 131, 20, 330,
+    0, 6, 0, 455, 30, 31, 72, 963, 27, 118, 307, 2,
+    9, 402, 0, 85, 264, 74, 401, 19, 90, 0, 150, 3,
+    150, 476, 0, 0, 9, 0, 88, 528, 219, 12, 296, 236,
+    46, 0, 0, 40, 238, 1042, 65, 1, 7, 44, 51, 2,
+    457, 25, 86, 0, 11, 159, 4, 677, 36, 385, 641, 54,
+    43, 7, 7, 520, 280, 44, 4, 2, 13, 141, 2, 617,
+    0, 242, 45, 11, 353, 97, 487, 21, 8, 535, 0, 16,
+    62, 1038, 144, 535, 716, 248, 128, 0, 199, 130, 863, 25,
+    1, 607, 239, 13, 1, 0, 40, 17, 179, 494, 110, 9,
+    133, 44, 88, 42, 515, 3, 2, 63, 114, 869, 47, 36,
+    4, 128, 210, 7, 0, 8, 1521, 199, 46, 6, 1890, 739,
+    190, 745, 777, 0, 3, 252, 4, 617, 246, 4045, 35, 0,
+    138, 234, 0, 41, 43, 0, 12, 6, 4, 575, 169, 22,
+    189, 328, 131, 1, 5, 64, 111, 685, 60, 79, 131, 15,
+    6, 1452, 0, 407, 225, 1, 6, 8, 35, 0, 5, 143,
+    5, 17, 1488, 8, 97, 593, 7, 0, 156, 3, 882, 42,
+    13, 662, 544, 753, 105, 0, 4, 735, 862, 423, 9, 18,
+    113, 304, 275, 180, 767, 637, 20, 3, 185, 4, 190, 170,
+    486, 1, 54, 77, 108, 1635, 579, 176, 1071, 28, 500, 6,
+    516, 186, 646, 16, 32, 680, 120, 0,
+   };
+static const uint16_t zht_h[] = {
+    125, 1489, 456, 1546, 639, 1874, 320, 395, 363, 1462, 1304, 1431,
+    4, 1494, 169, 665, 1459, 1616, 116, 851, 2023, 1567, 231, 437,
+    1543, 850, 1211, 492, 344, 614, 21, 613, 379, 1640, 1512, 1612,
+    1460, 871, 1267, 826, 1405, 538, 890, 1366, 332, 767, 129, 119,
+    733, 1052, 1949, 924, 1253, 425, 7, 144, 780, 1381, 856, 961,
+    1034, 666, 1587, 674, 454, 2043, 757, 128, 504, 1148, 631, 748,
+    32, 82, 1669, 226, 72, 112, 1780, 1385, 977, 1083, 724, 1495,
+    1528, 1455, 903, 1273, 1965, 1247, 1217, 1718, 357, 1426, 1210, 1140,
+    1878, 691, 1072, 1137, 927, 1314, 470, 404, 478, 2046, 1245, 755,
+    1659, 1300, 985, 2006, 254, 575, 541, 373, 926, 1818, 218, 1596,
+    1526, 539, 349, 864, 1960, 148, 1236, 202, 1144, 925, 1538, 1974,
+    552, 832, 704, 1904, 2008, 1798, 756, 1011, 1189, 729, 227, 959,
+    1653, 833, 885, 1690, 1219, 1985, 2012, 310, 83, 334, 1394, 565,
+    528, 840, 823, 1062, 965, 1658, 1721, 1869, 686, 1416, 1429, 1099,
+    747, 1885, 876, 557, 421, 1682, 875, 311, 306, 392, 672, 1836,
+    997, 1397, 180, 249, 1870, 865, 1428, 1846, 1611, 1566, 967, 1436,
+    1545, 1894, 1993, 1913, 1191, 1213, 58, 808, 353, 2007, 1610, 105,
+    1359, 1550, 1524, 237, 276, 1410, 372, 1243, 1473, 612, 173, 1509,
+    1265, 1943, 140, 895, 905, 906, 48, 1321, 1824, 1752, 607, 308,
+    827, 587, 519, 451, 1283, 1346, 327, 591, 1423, 761, 303, 1145,
+    1044, 994, 1823, 137, 1699, 714, 181, 1692, 1177, 544, 1362, 408,
+    570, 1834, 1552, 717, 1251, 1377, 762, 1242, 1163, 577, 1026, 863,
+    1999, 1856, 1166, 2035, 1581, 465, 1736, 1282, 1038, 424, 1435, 664,
+    1513, 1010, 238, 558, 1478, 450, 304, 1444, 683, 1471, 676, 1465,
+    1621, 1311, 848, 247, 512, 1373, 1886, 518, 1323, 459, 1104, 1203,
+    712, 1953, 1539, 1059, 503, 1002, 1417, 1315, 1485, 1646, 1126, 1222,
+    1500, 601, 1737, 1107, 113, 949, 1340, 1051, 814, 1931, 1713, 1187,
+    1585, 313, 1817, 1498, 1779, 910, 679, 1948, 10, 256, 146, 2025,
+    1647, 758, 1274, 1134, 122, 1761, 1559, 1322, 1271, 471, 2037, 1632,
+    1758, 740, 1479, 1802, 1411, 782, 1188, 873, 1649, 1486, 1297, 233,
+    1005, 1557, 78, 165, 1871, 1523, 901, 849, 1232, 893, 899, 774,
+    1389, 2034, 1008, 1625, 1952, 1097, 700, 1115, 1833, 633, 546, 909,
+    1133, 2000, 1852, 1860, 1841, 1335, 1060, 822, 719, 1962, 1915, 730,
+    268, 1199, 708, 1519, 1325, 1233, 800, 1725, 638, 143, 1558, 1910,
+    282, 1252, 1127, 1622, 1739, 1688, 940, 29, 1702, 248, 960, 821,
+    881, 104, 581, 969, 99, 1515, 1491, 1897, 1135, 902, 1925, 1893,
+    440, 670, 1224, 1352, 100, 1709, 1742, 331, 267, 886, 315, 1291,
+    1464, 522, 1249, 624, 30, 629, 61, 197, 286, 1814, 947, 469,
+    352, 641, 1472, 1108, 510, 979, 1387, 8, 79, 498, 1110, 1867,
+    224, 434, 973, 161, 1294, 1704, 1969, 121, 1563, 1420, 2028, 957,
+    1680, 803, 1068, 1365, 1301, 486, 1862, 205, 1919, 898, 1469, 239,
+    1848, 1466, 1447, 1379, 1901, 433, 515, 1763, 1138, 1307, 355, 2044,
+    211, 1467, 648, 166, 912, 1029, 628, 1458, 1162, 777, 1404, 572,
+    1159, 939, 52, 1185, 274, 1986, 432, 191, 1775, 241, 472, 245,
+    1827, 1877, 752, 852, 831, 396, 458, 734, 230, 981, 145, 787,
+    1014, 647, 1662, 1630, 1724, 1347, 1781, 1769, 1421, 602, 76, 15,
+    17, 1339, 60, 1774, 1111, 1932, 506, 1977, 1580, 1882, 1908, 1573,
+    855, 810, 1175, 1939, 1875, 583, 367, 1796, 1351, 316, 1968, 223,
+    1290, 943, 449, 1849, 1745, 136, 1202, 1726, 766, 1604, 1889, 1777,
+    1439, 46, 1241, 1293, 443, 935, 952, 414, 1502, 1744, 49, 1320,
+    779, 321, 1006, 1149, 574, 783, 1521, 1238, 888, 1516, 1606, 1027,
+    94, 1717, 1727, 1165, 1341, 474, 1154, 554, 154, 476, 232, 1773,
+    1840, 1256, 1198, 1402, 1795, 1891, 413, 1944, 65, 621, 918, 485,
+    1929, 966, 866, 302, 2019, 2030, 1156, 229, 31, 1660, 495, 1418,
+    251, 262, 627, 177, 1593, 598, 44, 872, 75, 1673, 861, 124,
+    699, 460, 955, 1094, 1122, 1092, 1843, 1371, 1572, 1061, 491, 1747,
+    1015, 964, 1075, 2045, 705, 1614, 1966, 1367, 464, 1694, 741, 1476,
+    1261, 1100, 1124, 1065, 405, 1701, 1996, 2039, 252, 1453, 1497, 1654,
+    179, 2027, 1681, 1804, 1599, 110, 97, 1624, 937, 1700, 658, 409,
+    288, 1920, 1627, 862, 1815, 1181, 723, 521, 45, 340, 435, 593,
+    737, 1096, 637, 346, 1246, 632, 623, 388, 364, 1643, 333, 706,
+    168, 69, 2021, 1012, 1698, 1349, 1956, 911, 1477, 791, 391, 1507,
+    763, 1013, 1171, 578, 1443, 1851, 56, 217, 2038, 508, 1119, 1756,
+    799, 341, 1608, 1636, 1413, 1037, 258, 1990, 411, 879, 1239, 1592,
+    853, 497, 839, 841, 1384, 1488, 42, 1639, 775, 410, 1021, 725,
+    452, 1988, 1047, 427, 285, 1372, 444, 1954, 1813, 1179, 1086, 1240,
+    342, 2029, 754, 972, 1483, 1499, 1164, 1805, 1645, 1276, 1031, 1793,
+    930, 936, 615, 27, 463, 134, 769, 768, 109, 297, 1619, 1597,
+    354, 1935, 1280, 77, 1876, 383, 1069, 1963, 359, 588, 149, 1732,
+    1287, 64, 259, 531, 1141, 1998, 1184, 175, 1928, 271, 185, 645,
+    1767, 2042, 933, 351, 167, 1650, 1503, 399, 1715, 778, 611, 707,
+    162, 222, 2010, 318, 307, 974, 1432, 1898, 928, 509, 126, 228,
+    1603, 1907, 1259, 1783, 2022, 447, 636, 1683, 502, 186, 605, 1218,
+    1258, 1789, 1668, 1470, 1992, 585, 1579, 1378, 649, 1370, 999, 214,
+    1228, 1635, 1277, 423, 643, 1613, 266, 1070, 394, 1961, 1678, 545,
+    738, 1912, 1656, 455, 422, 1484, 1057, 1884, 88, 513, 776, 1023,
+    270, 1457, 1790, 225, 47, 685, 1706, 562, 1527, 1562, 1505, 663,
+    847, 842, 576, 212, 1125, 917, 441, 1764, 1081, 1536, 269, 264,
+    1529, 580, 192, 1664, 1180, 1123, 1902, 1270, 1571, 1665, 325, 1976,
+    993, 1863, 1590, 1391, 3, 1866, 785, 1263, 796, 661, 1620, 1605,
+    1880, 524, 555, 586, 825, 889, 568, 944, 1178, 1408, 1441, 1214,
+    1327, 900, 103, 1425, 138, 916, 579, 16, 19, 1025, 1040, 426,
+    635, 1067, 1152, 1757, 694, 2026, 93, 954, 651, 1085, 1223, 147,
+    62, 439, 1229, 70, 620, 1157, 1266, 626, 788, 781, 312, 805,
+    1806, 393, 1942, 1318, 946, 617, 1995, 1056, 561, 242, 654, 523,
+    1987, 204, 1001, 680, 195, 442, 1922, 743, 929, 1835, 1561, 1066,
+    1957, 1695, 742, 1762, 272, 536, 702, 804, 595, 133, 630, 1600,
+    843, 962, 111, 516, 1560, 1129, 1938, 397, 1945, 1895, 365, 380,
+    1979, 1829, 813, 1109, 336, 1626, 878, 467, 896, 14, 1380, 1080,
+    667, 945, 490, 375, 1903, 1514, 1720, 711, 2031, 1363, 1970, 1801,
+    622, 1176, 1686, 120, 1696, 37, 1671, 1262, 1368, 563, 213, 1716,
+    793, 1250, 1569, 57, 2013, 1309, 461, 493, 130, 1054, 0, 158,
+    199, 1275, 338, 26, 1120, 151, 1153, 1532, 298, 1053, 2040, 89,
+    348, 1493, 1927, 673, 356, 2047, 5, 500, 183, 1382, 386, 1933,
+    693, 1036, 1313, 1356, 1345, 795, 1091, 1900, 2018, 1440, 236, 188,
+    596, 462, 488, 156, 416, 1501, 484, 1369, 481, 1980, 697, 1868,
+    983, 39, 996, 1427, 1553, 1395, 772, 51, 1735, 1063, 291, 950,
+    41, 1564, 489, 407, 809, 991, 1463, 971, 820, 292, 701, 1556,
+    1916, 836, 760, 174, 314, 295, 1785, 246, 1768, 857, 507, 203,
+    468, 9, 1896, 142, 980, 290, 514, 1155, 371, 1858, 1295, 1926,
+    1139, 1765, 196, 982, 934, 107, 86, 1374, 324, 1544, 540, 1831,
+    1221, 1825, 1360, 1406, 184, 1446, 1114, 193, 550, 287, 1208, 1112,
+    1855, 1095, 1710, 1754, 1865, 1182, 547, 1906, 590, 1030, 1206, 1151,
+    350, 681, 600, 24, 625, 1376, 771, 829, 106, 722, 1589, 1082,
+    68, 1583, 200, 517, 652, 1354, 1310, 71, 668, 921, 1355, 1454,
+    765, 457, 1209, 329, 415, 1103, 735, 1357, 1, 1967, 1899, 189,
+    543, 382, 1168, 1978, 1375, 1623, 1687, 801, 678, 43, 1192, 1278,
+    1921, 182, 210, 1200, 744, 1130, 1487, 838, 989, 1438, 194, 280,
+    1348, 384, 6, 1797, 1595, 984, 98, 690, 1306, 250, 1172, 1508,
+    1578, 1697, 1048, 257, 1364, 1707, 453, 526, 1475, 135, 1490, 604,
+    1319, 1629, 1778, 1540, 1074, 511, 1883, 1358, 1234, 1746, 751, 1212,
+    1940, 1087, 1800, 1298, 608, 1584, 1169, 1302, 660, 798, 487, 84,
+    368, 794, 975, 1000, 499, 1147, 1284, 811, 1333, 835, 1386, 692,
+    85, 1216, 941, 559, 789, 11, 1434, 401, 819, 1121, 1113, 684,
+    38, 1317, 1598, 164, 1158, 1837, 1638, 1655, 640, 1196, 1337, 1941,
+    970, 12, 92, 300, 1018, 1637, 479, 190, 1225, 108, 417, 369,
+    1105, 428, 1811, 1326, 1644, 1046, 992, 1350, 1452, 34, 1541, 938,
+    216, 1303, 942, 1390, 301, 95, 1748, 1973, 1433, 1892, 569, 1672,
+    243, 361, 548, 1449, 1918, 377, 1424, 115, 689, 1045, 1890, 403,
+    1651, 1534, 278, 817, 597, 1393, 347, 1729, 1914, 1269, 659, 923,
+    400, 28, 1607, 834, 696, 1102, 1437, 1685, 1712, 362, 1879, 1445,
+    1292, 1237, 1480, 1997, 1838, 73, 1032, 1537, 1857, 675, 153, 1740,
+    1816, 1972, 1909, 1336, 1205, 390, 1808, 1330, 883, 908, 1415, 35,
+    370, 201, 1881, 40, 1226, 1887, 265, 963, 773, 1677, 1691, 1759,
+    759, 448, 1009, 551, 1786, 1719, 1964, 1574, 606, 1193, 854, 339,
+    1401, 1079, 567, 1663, 117, 1281, 998, 718, 387, 732, 874, 2024,
+    1738, 1722, 1520, 1955, 1633, 430, 18, 1268, 309, 1676, 2041, 118,
+    677, 753, 2001, 1194, 1510, 343, 1353, 698, 1285, 1853, 882, 1850,
+    1657, 1594, 919, 1547, 385, 102, 537, 406, 1207, 1555, 726, 1481,
+    986, 1089, 656, 687, 1035, 1522, 2005, 1456, 1055, 520, 296, 1971,
+    1714, 1403, 163, 1670, 132, 209, 790, 376, 657, 897, 1753, 1167,
+    1888, 1450, 1772, 1398, 1392, 1160, 1422, 374, 1518, 566, 1728, 922,
+    750, 1204, 1577, 1591, 858, 1575, 1983, 114, 1819, 235, 532, 1733,
+    1106, 1324, 1296, 527, 2011, 1568, 914, 553, 1826, 987, 482, 1468,
+    845, 438, 418, 728, 319, 1170, 1257, 1844, 860, 317, 2020, 599,
+    20, 475, 483, 1260, 1734, 859, 1279, 1131, 764, 2002, 1264, 87,
+    642, 1810, 1383, 1448, 2, 1705, 1024, 594, 1601, 127, 1409, 279,
+    988, 1708, 1344, 150, 157, 1618, 2015, 1760, 139, 50, 294, 1020,
+    261, 1994, 2036, 1049, 1791, 1911, 322, 326, 1548, 63, 978, 275,
+    496, 2032, 1407, 1329, 1430, 713, 1003, 868, 1461, 710, 412, 589,
+    1576, 1361, 619, 844, 682, 956, 1799, 1820, 1586, 571, 716, 429,
+    176, 887, 1845, 1215, 1730, 1161, 1183, 1666, 530, 299, 837, 1872,
+    1308, 662, 1288, 1617, 1766, 582, 715, 1504, 123, 976, 2003, 867,
+    953, 1551, 792, 1689, 1947, 1667, 1474, 618, 281, 1043, 703, 337,
+    1684, 1244, 749, 240, 584, 1984, 812, 436, 846, 1602, 770, 1506,
+    535, 542, 1186, 1078, 1809, 1400, 23, 1093, 655, 990, 1073, 720,
+    534, 1641, 22, 1634, 273, 824, 255, 155, 1743, 1782, 1652, 283,
+    2004, 1679, 1173, 505, 1286, 1128, 1039, 1254, 59, 2009, 1615, 1342,
+    816, 1334, 1628, 1019, 709, 277, 650, 171, 1981, 1812, 480, 67,
+    172, 1022, 1776, 807, 253, 745, 1731, 1854, 818, 1917, 1451, 378,
+    1255, 1004, 323, 830, 1220, 1549, 419, 345, 1828, 431, 1227, 215,
+    560, 1235, 634, 870, 2016, 1792, 1033, 445, 1794, 1923, 1058, 284,
+    293, 525, 335, 1749, 152, 1028, 234, 381, 1142, 36, 494, 1975,
+    828, 1007, 1787, 1143, 96, 1642, 1842, 695, 1750, 913, 1741, 81,
+    549, 305, 1951, 1755, 891, 198, 1859, 564, 1542, 220, 219, 1693,
+    915, 1723, 1839, 610, 244, 1861, 1117, 1588, 1272, 1174, 1305, 74,
+    995, 366, 1648, 1248, 784, 1016, 721, 101, 1905, 1042, 53, 920,
+    1343, 260, 1930, 786, 1959, 1116, 1230, 736, 1570, 160, 206, 1631,
+    1331, 1150, 90, 616, 2017, 1946, 907, 1803, 1338, 178, 1864, 669,
+    1396, 951, 1675, 1565, 1077, 1289, 159, 1098, 1661, 2014, 55, 533,
+    904, 797, 1442, 80, 877, 1674, 1530, 466, 1924, 54, 13, 1582,
+    815, 1788, 1332, 529, 1201, 1822, 746, 1991, 1873, 289, 1146, 1190,
+    592, 1088, 1312, 1821, 968, 263, 653, 1076, 1412, 603, 1535, 1132,
+    170, 1936, 1847, 473, 66, 208, 141, 1525, 1414, 884, 1934, 609,
+    688, 806, 932, 1496, 739, 1982, 398, 1136, 1770, 1554, 1517, 1050,
+    1784, 221, 1482, 207, 328, 1751, 1771, 420, 802, 1958, 330, 1492,
+    1328, 358, 1399, 91, 892, 1090, 644, 1041, 1101, 1064, 1197, 573,
+    646, 1937, 948, 1316, 1711, 1832, 1388, 931, 2033, 1231, 1703, 1533,
+    1118, 1017, 1807, 958, 727, 477, 446, 671, 731, 894, 869, 1609,
+    1071, 402, 1084, 1531, 1950, 33, 501, 1419, 1195, 131, 1989, 187,
+    1830, 880, 1299, 1511, 360, 556, 25, 389,
    };
-#undef zht
 
 static const struct words zht_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words zht_words = {
     false,
     (const char *)zht_,
     0, /* Constant string */
-    zht_i
+    NULL, /* Words are located by offset */
+    zht_o,
+    0u,
+    zht_d,
+    zht_h
 };
@@ -2051,352 +2051,398 @@ static const unsigned char en_[] = {
     0x7a,0x6f,0x6e,0x65,0,
     0x7a,0x6f,0x6f,0,
 };
-#define en ((const char*)en_)
-static const char *en_i[] = {
-    en+0, en+8, en+16, en+21, en+27, en+33,
-    en+40, en+47, en+56, en+63, en+69, en+76,
-    en+85, en+93, en+100, en+108, en+113, en+122,
-    en+130, en+137, en+141, en+148, en+154, en+162,
-    en+169, en+175, en+179, en+186, en+194, en+201,
-    en+207, en+213, en+221, en+228, en+236, en+243,
-    en+250, en+257, en+263, en+267, en+273, en+279,
-    en+285, en+289, en+293, en+301, en+307, en+313,
-    en+319, en+327, en+333, en+339, en+343, en+349,
-    en+355, en+362, en+368, en+374, en+382, en+387,
-    en+393, en+400, en+408, en+416, en+422, en+429,
-    en+436, en+444, en+451, en+459, en+465, en+471,
-    en+477, en+484, en+490, en+499, en+506, en+514,
-    en+521, en+529, en+537, en+545, en+549, en+555,
-    en+563, en+570, en+576, en+584, en+590, en+595,
-    en+602, en+607, en+613, en+619, en+623, en+629,
-    en+635, en+640, en+647, en+655, en+662, en+669,
-    en+675, en+679, en+688, en+695, en+703, en+707,
-    en+714, en+722, en+728, en+735, en+742, en+749,
-    en+757, en+762, en+769, en+776, en+785, en+793,
-    en+801, en+807, en+814, en+819, en+826, en+831,
-    en+838, en+846, en+854, en+860, en+866, en+872,
-    en+877, en+885, en+891, en+899, en+904, en+909,
-    en+918, en+924, en+930, en+934, en+942, en+950,
-    en+955, en+962, en+969, en+976, en+980, en+987,
-    en+995, en+1002, en+1007, en+1013, en+1020, en+1027,
-    en+1033, en+1038, en+1045, en+1053, en+1060, en+1065,
-    en+1072, en+1078, en+1085, en+1092, en+1100, en+1106,
-    en+1111, en+1117, en+1125, en+1130, en+1137, en+1144,
-    en+1152, en+1159, en+1167, en+1171, en+1176, en+1181,
-    en+1189, en+1194, en+1200, en+1207, en+1213, en+1219,
-    en+1225, en+1233, en+1239, en+1245, en+1251, en+1257,
-    en+1263, en+1271, en+1278, en+1283, en+1288, en+1294,
-    en+1300, en+1305, en+1310, en+1315, en+1320, en+1325,
-    en+1331, en+1336, en+1342, en+1349, en+1356, en+1363,
-    en+1368, en+1375, en+1382, en+1386, en+1390, en+1398,
-    en+1404, en+1410, en+1416, en+1422, en+1428, en+1435,
-    en+1441, en+1448, en+1454, en+1461, en+1467, en+1473,
-    en+1482, en+1489, en+1496, en+1502, en+1510, en+1516,
-    en+1522, en+1529, en+1535, en+1542, en+1550, en+1556,
-    en+1561, en+1566, en+1573, en+1580, en+1587, en+1594,
-    en+1601, en+1607, en+1611, en+1620, en+1625, en+1632,
-    en+1638, en+1643, en+1651, en+1657, en+1663, en+1670,
-    en+1675, en+1680, en+1685, en+1690, en+1697, en+1702,
-    en+1706, en+1712, en+1719, en+1725, en+1732, en+1738,
-    en+1745, en+1752, en+1760, en+1768, en+1776, en+1780,
-    en+1787, en+1792, en+1798, en+1805, en+1811, en+1816,
-    en+1821, en+1826, en+1833, en+1840, en+1847, en+1851,
-    en+1859, en+1865, en+1874, en+1881, en+1888, en+1894,
-    en+1902, en+1907, en+1915, en+1922, en+1929, en+1936,
-    en+1944, en+1951, en+1959, en+1965, en+1971, en+1980,
-    en+1987, en+1993, en+2001, en+2008, en+2014, en+2019,
-    en+2025, en+2031, en+2038, en+2043, en+2050, en+2056,
-    en+2064, en+2070, en+2076, en+2084, en+2091, en+2098,
-    en+2106, en+2114, en+2120, en+2126, en+2132, en+2141,
-    en+2148, en+2156, en+2161, en+2167, en+2173, en+2178,
-    en+2186, en+2191, en+2196, en+2202, en+2208, en+2215,
-    en+2221, en+2228, en+2234, en+2240, en+2247, en+2252,
-    en+2258, en+2263, en+2269, en+2275, en+2281, en+2287,
-    en+2292, en+2298, en+2306, en+2313, en+2319, en+2325,
-    en+2333, en+2338, en+2345, en+2350, en+2355, en+2363,
-    en+2369, en+2376, en+2384, en+2389, en+2397, en+2403,
-    en+2410, en+2418, en+2426, en+2434, en+2442, en+2451,
-    en+2459, en+2468, en+2476, en+2485, en+2490, en+2495,
-    en+2502, en+2507, en+2513, en+2518, en+2523, en+2531,
-    en+2536, en+2543, en+2549, en+2557, en+2564, en+2571,
-    en+2578, en+2584, en+2591, en+2597, en+2604, en+2610,
-    en+2615, en+2621, en+2627, en+2634, en+2640, en+2646,
-    en+2652, en+2659, en+2665, en+2670, en+2678, en+2684,
-    en+2690, en+2697, en+2702, en+2708, en+2715, en+2721,
-    en+2729, en+2735, en+2742, en+2750, en+2757, en+2763,
-    en+2767, en+2775, en+2780, en+2788, en+2792, en+2801,
-    en+2809, en+2817, en+2825, en+2831, en+2839, en+2846,
-    en+2851, en+2857, en+2861, en+2868, en+2873, en+2879,
-    en+2886, en+2893, en+2898, en+2907, en+2912, en+2916,
-    en+2921, en+2928, en+2935, en+2942, en+2951, en+2958,
-    en+2966, en+2975, en+2984, en+2989, en+2997, en+3004,
-    en+3009, en+3016, en+3022, en+3030, en+3037, en+3044,
-    en+3051, en+3059, en+3064, en+3071, en+3078, en+3086,
-    en+3092, en+3099, en+3106, en+3115, en+3122, en+3129,
-    en+3134, en+3142, en+3150, en+3157, en+3164, en+3172,
-    en+3179, en+3186, en+3194, en+3199, en+3207, en+3213,
-    en+3218, en+3225, en+3230, en+3237, en+3245, en+3253,
-    en+3261, en+3268, en+3277, en+3284, en+3289, en+3298,
-    en+3307, en+3315, en+3320, en+3328, en+3337, en+3345,
-    en+3354, en+3361, en+3368, en+3376, en+3382, en+3389,
-    en+3398, en+3402, en+3407, en+3415, en+3422, en+3429,
-    en+3436, en+3442, en+3447, en+3452, en+3459, en+3464,
-    en+3470, en+3477, en+3483, en+3491, en+3496, en+3502,
-    en+3508, en+3514, en+3520, en+3526, en+3531, en+3537,
-    en+3542, en+3547, en+3551, en+3556, en+3561, en+3566,
-    en+3573, en+3578, en+3584, en+3589, en+3595, en+3603,
-    en+3609, en+3615, en+3621, en+3626, en+3632, en+3639,
-    en+3644, en+3649, en+3654, en+3662, en+3670, en+3675,
-    en+3680, en+3688, en+3695, en+3699, en+3705, en+3712,
-    en+3718, en+3724, en+3733, en+3741, en+3749, en+3758,
-    en+3767, en+3773, en+3778, en+3785, en+3792, en+3800,
-    en+3807, en+3815, en+3822, en+3830, en+3836, en+3843,
-    en+3849, en+3853, en+3861, en+3869, en+3875, en+3882,
-    en+3890, en+3897, en+3904, en+3912, en+3918, en+3925,
-    en+3932, en+3939, en+3946, en+3953, en+3959, en+3966,
-    en+3972, en+3981, en+3989, en+3995, en+4001, en+4005,
-    en+4011, en+4017, en+4025, en+4031, en+4037, en+4044,
-    en+4050, en+4058, en+4065, en+4073, en+4080, en+4089,
-    en+4094, en+4100, en+4107, en+4113, en+4121, en+4128,
-    en+4137, en+4144, en+4152, en+4159, en+4167, en+4176,
-    en+4184, en+4192, en+4198, en+4204, en+4209, en+4216,
-    en+4223, en+4230, en+4237, en+4245, en+4252, en+4260,
-    en+4267, en+4273, en+4277, en+4285, en+4292, en+4297,
-    en+4305, en+4310, en+4316, en+4322, en+4327, en+4333,
-    en+4338, en+4345, en+4352, en+4356, en+4362, en+4370,
-    en+4375, en+4383, en+4387, en+4393, en+4400, en+4408,
-    en+4414, en+4423, en+4431, en+4440, en+4448, en+4452,
-    en+4457, en+4462, en+4469, en+4475, en+4484, en+4490,
-    en+4496, en+4500, en+4506, en+4514, en+4520, en+4527,
-    en+4532, en+4537, en+4544, en+4550, en+4555, en+4560,
-    en+4567, en+4574, en+4579, en+4584, en+4590, en+4597,
-    en+4602, en+4606, en+4614, en+4618, en+4623, en+4629,
-    en+4635, en+4640, en+4647, en+4652, en+4659, en+4664,
-    en+4670, en+4676, en+4682, en+4689, en+4695, en+4701,
-    en+4705, en+4710, en+4716, en+4720, en+4725, en+4730,
-    en+4737, en+4742, en+4747, en+4753, en+4760, en+4767,
-    en+4772, en+4780, en+4786, en+4794, en+4801, en+4808,
-    en+4814, en+4818, en+4826, en+4832, en+4841, en+4847,
-    en+4854, en+4861, en+4866, en+4872, en+4878, en+4884,
-    en+4891, en+4897, en+4902, en+4906, en+4912, en+4920,
-    en+4925, en+4932, en+4939, en+4944, en+4951, en+4959,
-    en+4964, en+4968, en+4975, en+4983, en+4990, en+4997,
-    en+5005, en+5009, en+5014, en+5019, en+5026, en+5032,
-    en+5037, en+5045, en+5052, en+5058, en+5065, en+5073,
-    en+5081, en+5087, en+5093, en+5098, en+5105, en+5112,
-    en+5120, en+5125, en+5130, en+5135, en+5142, en+5148,
-    en+5154, en+5160, en+5168, en+5174, en+5180, en+5186,
-    en+5192, en+5197, en+5202, en+5207, en+5215, en+5220,
-    en+5225, en+5231, en+5239, en+5246, en+5253, en+5260,
-    en+5265, en+5270, en+5276, en+5282, en+5288, en+5294,
-    en+5300, en+5308, en+5314, en+5320, en+5325, en+5331,
-    en+5336, en+5344, en+5350, en+5355, en+5361, en+5367,
-    en+5373, en+5379, en+5385, en+5392, en+5396, en+5400,
-    en+5406, en+5411, en+5416, en+5423, en+5431, en+5436,
-    en+5442, en+5449, en+5454, en+5460, en+5468, en+5472,
-    en+5477, en+5482, en+5489, en+5494, en+5501, en+5507,
-    en+5513, en+5522, en+5529, en+5535, en+5542, en+5547,
-    en+5551, en+5556, en+5563, en+5568, en+5573, en+5578,
-    en+5582, en+5587, en+5595, en+5601, en+5608, en+5613,
-    en+5618, en+5626, en+5633, en+5638, en+5644, en+5649,
-    en+5654, en+5659, en+5666, en+5672, en+5681, en+5686,
-    en+5692, en+5697, en+5703, en+5707, en+5712, en+5718,
-    en+5725, en+5731, en+5739, en+5746, en+5751, en+5758,
-    en+5764, en+5769, en+5777, en+5784, en+5788, en+5793,
-    en+5798, en+5807, en+5812, en+5819, en+5823, en+5831,
-    en+5839, en+5845, en+5853, en+5861, en+5868, en+5875,
-    en+5882, en+5890, en+5898, en+5903, en+5911, en+5918,
-    en+5927, en+5933, en+5942, en+5949, en+5958, en+5965,
-    en+5973, en+5980, en+5987, en+5995, en+6003, en+6010,
-    en+6017, en+6024, en+6030, en+6039, en+6045, en+6053,
-    en+6060, en+6067, en+6074, en+6082, en+6090, en+6097,
-    en+6106, en+6111, en+6118, en+6125, en+6133, en+6138,
-    en+6145, en+6153, en+6159, en+6164, en+6170, en+6177,
-    en+6184, en+6188, en+6193, en+6201, en+6207, en+6213,
-    en+6219, en+6223, en+6228, en+6233, en+6241, en+6245,
-    en+6251, en+6257, en+6262, en+6269, en+6276, en+6281,
-    en+6286, en+6295, en+6300, en+6305, en+6313, en+6317,
-    en+6322, en+6326, en+6333, en+6338, en+6346, en+6351,
-    en+6355, en+6363, en+6368, en+6375, en+6380, en+6385,
-    en+6391, en+6397, en+6402, en+6406, en+6412, en+6418,
-    en+6425, en+6430, en+6435, en+6440, en+6449, en+6456,
-    en+6462, en+6468, en+6474, en+6480, en+6488, en+6493,
-    en+6497, en+6502, en+6510, en+6516, en+6521, en+6528,
-    en+6533, en+6539, en+6545, en+6553, en+6558, en+6562,
-    en+6568, en+6575, en+6583, en+6589, en+6594, en+6601,
-    en+6606, en+6614, en+6621, en+6628, en+6634, en+6639,
-    en+6647, en+6655, en+6663, en+6668, en+6673, en+6679,
-    en+6684, en+6689, en+6695, en+6700, en+6705, en+6712,
-    en+6717, en+6724, en+6729, en+6736, en+6741, en+6746,
-    en+6754, en+6760, en+6765, en+6771, en+6778, en+6783,
-    en+6788, en+6796, en+6801, en+6808, en+6813, en+6819,
-    en+6825, en+6833, en+6840, en+6846, en+6852, en+6859,
-    en+6866, en+6874, en+6878, en+6884, en+6891, en+6896,
-    en+6901, en+6906, en+6912, en+6917, en+6924, en+6928,
-    en+6935, en+6943, en+6949, en+6957, en+6964, en+6970,
-    en+6977, en+6983, en+6990, en+6997, en+7004, en+7013,
-    en+7018, en+7023, en+7030, en+7036, en+7045, en+7050,
-    en+7057, en+7064, en+7072, en+7077, en+7084, en+7089,
-    en+7097, en+7102, en+7111, en+7117, en+7123, en+7130,
-    en+7135, en+7142, en+7149, en+7157, en+7162, en+7168,
-    en+7174, en+7180, en+7186, en+7191, en+7199, en+7205,
-    en+7212, en+7219, en+7228, en+7233, en+7241, en+7247,
-    en+7252, en+7260, en+7266, en+7273, en+7281, en+7288,
-    en+7295, en+7300, en+7308, en+7312, en+7318, en+7326,
-    en+7333, en+7339, en+7346, en+7350, en+7357, en+7365,
-    en+7372, en+7380, en+7386, en+7391, en+7397, en+7402,
-    en+7410, en+7419, en+7426, en+7433, en+7439, en+7448,
-    en+7454, en+7459, en+7465, en+7470, en+7477, en+7482,
-    en+7491, en+7498, en+7505, en+7514, en+7520, en+7525,
-    en+7532, en+7539, en+7547, en+7552, en+7558, en+7563,
-    en+7570, en+7577, en+7583, en+7590, en+7597, en+7602,
-    en+7607, en+7612, en+7621, en+7629, en+7637, en+7644,
-    en+7650, en+7655, en+7659, en+7667, en+7675, en+7681,
-    en+7686, en+7691, en+7696, en+7702, en+7708, en+7714,
-    en+7722, en+7729, en+7736, en+7742, en+7747, en+7755,
-    en+7760, en+7768, en+7775, en+7781, en+7785, en+7793,
-    en+7800, en+7806, en+7810, en+7814, en+7819, en+7826,
-    en+7833, en+7841, en+7849, en+7856, en+7864, en+7870,
-    en+7876, en+7884, en+7889, en+7893, en+7899, en+7906,
-    en+7912, en+7916, en+7921, en+7925, en+7931, en+7939,
-    en+7944, en+7949, en+7953, en+7959, en+7966, en+7971,
-    en+7976, en+7982, en+7990, en+7997, en+8004, en+8011,
-    en+8017, en+8025, en+8031, en+8040, en+8046, en+8053,
-    en+8062, en+8069, en+8077, en+8083, en+8091, en+8097,
-    en+8104, en+8112, en+8117, en+8122, en+8127, en+8131,
-    en+8137, en+8144, en+8151, en+8157, en+8162, en+8169,
-    en+8174, en+8179, en+8186, en+8191, en+8197, en+8203,
-    en+8209, en+8217, en+8223, en+8230, en+8237, en+8242,
-    en+8249, en+8255, en+8260, en+8266, en+8271, en+8279,
-    en+8286, en+8294, en+8300, en+8305, en+8313, en+8319,
-    en+8326, en+8331, en+8339, en+8347, en+8351, en+8359,
-    en+8366, en+8373, en+8380, en+8388, en+8395, en+8402,
-    en+8406, en+8412, en+8418, en+8425, en+8434, en+8440,
-    en+8447, en+8455, en+8461, en+8465, en+8472, en+8477,
-    en+8483, en+8488, en+8496, en+8501, en+8508, en+8514,
-    en+8520, en+8526, en+8533, en+8541, en+8547, en+8552,
-    en+8559, en+8566, en+8572, en+8577, en+8584, en+8589,
-    en+8594, en+8600, en+8606, en+8611, en+8618, en+8623,
-    en+8628, en+8633, en+8641, en+8649, en+8658, en+8667,
-    en+8672, en+8679, en+8687, en+8695, en+8702, en+8708,
-    en+8717, en+8724, en+8732, en+8739, en+8747, en+8755,
-    en+8762, en+8770, en+8776, en+8782, en+8790, en+8796,
-    en+8805, en+8812, en+8820, en+8826, en+8834, en+8842,
-    en+8850, en+8857, en+8865, en+8873, en+8881, en+8887,
-    en+8896, en+8904, en+8912, en+8918, en+8926, en+8933,
-    en+8941, en+8946, en+8951, en+8957, en+8965, en+8971,
-    en+8977, en+8983, en+8992, en+8999, en+9007, en+9013,
-    en+9018, en+9022, en+9029, en+9037, en+9045, en+9053,
-    en+9061, en+9070, en+9076, en+9081, en+9086, en+9092,
-    en+9099, en+9107, en+9112, en+9117, en+9123, en+9129,
-    en+9134, en+9139, en+9145, en+9151, en+9156, en+9162,
-    en+9169, en+9175, en+9181, en+9186, en+9191, en+9198,
-    en+9204, en+9208, en+9214, en+9220, en+9225, en+9232,
-    en+9238, en+9246, en+9253, en+9261, en+9268, en+9275,
-    en+9283, en+9290, en+9298, en+9305, en+9312, en+9319,
-    en+9326, en+9334, en+9341, en+9347, en+9355, en+9362,
-    en+9367, en+9374, en+9383, en+9390, en+9397, en+9404,
-    en+9410, en+9415, en+9422, en+9429, en+9436, en+9444,
-    en+9451, en+9459, en+9466, en+9475, en+9482, en+9491,
-    en+9500, en+9507, en+9514, en+9522, en+9529, en+9537,
-    en+9544, en+9551, en+9558, en+9565, en+9569, en+9576,
-    en+9581, en+9586, en+9591, en+9597, en+9603, en+9609,
-    en+9615, en+9620, en+9625, en+9632, en+9637, en+9644,
-    en+9650, en+9656, en+9661, en+9667, en+9673, en+9680,
-    en+9687, en+9695, en+9700, en+9707, en+9712, en+9717,
-    en+9724, en+9730, en+9736, en+9742, en+9748, en+9755,
-    en+9760, en+9764, en+9769, en+9773, en+9780, en+9786,
-    en+9790, en+9797, en+9805, en+9810, en+9815, en+9821,
-    en+9828, en+9834, en+9839, en+9846, en+9851, en+9858,
-    en+9863, en+9871, en+9879, en+9885, en+9893, en+9898,
-    en+9902, en+9908, en+9913, en+9919, en+9927, en+9933,
-    en+9940, en+9947, en+9955, en+9964, en+9973, en+9979,
-    en+9985, en+9992, en+9999, en+10005, en+10009, en+10016,
-    en+10023, en+10028, en+10035, en+10042, en+10050, en+10059,
-    en+10064, en+10069, en+10077, en+10084, en+10089, en+10097,
-    en+10104, en+10110, en+10119, en+10126, en+10134, en+10142,
-    en+10149, en+10155, en+10161, en+10168, en+10174, en+10182,
-    en+10188, en+10193, en+10199, en+10207, en+10214, en+10220,
-    en+10226, en+10231, en+10238, en+10244, en+10249, en+10255,
-    en+10260, en+10266, en+10275, en+10281, en+10288, en+10294,
-    en+10302, en+10306, en+10314, en+10319, en+10324, en+10330,
-    en+10336, en+10341, en+10348, en+10353, en+10359, en+10366,
-    en+10374, en+10381, en+10387, en+10392, en+10398, en+10405,
-    en+10413, en+10417, en+10422, en+10428, en+10435, en+10439,
-    en+10445, en+10450, en+10456, en+10462, en+10467, en+10472,
-    en+10478, en+10486, en+10492, en+10498, en+10505, en+10510,
-    en+10517, en+10522, en+10527, en+10533, en+10539, en+10545,
-    en+10551, en+10557, en+10564, en+10570, en+10576, en+10581,
-    en+10587, en+10592, en+10597, en+10604, en+10611, en+10616,
-    en+10621, en+10626, en+10632, en+10640, en+10646, en+10655,
-    en+10661, en+10669, en+10674, en+10679, en+10685, en+10690,
-    en+10695, en+10701, en+10706, en+10713, en+10719, en+10725,
-    en+10731, en+10739, en+10745, en+10751, en+10759, en+10765,
-    en+10771, en+10777, en+10784, en+10790, en+10797, en+10803,
-    en+10808, en+10815, en+10821, en+10827, en+10835, en+10841,
-    en+10847, en+10852, en+10858, en+10865, en+10872, en+10876,
-    en+10883, en+10891, en+10900, en+10907, en+10915, en+10921,
-    en+10927, en+10934, en+10940, en+10946, en+10952, en+10958,
-    en+10963, en+10969, en+10975, en+10980, en+10985, en+10992,
-    en+10998, en+11004, en+11010, en+11016, en+11024, en+11030,
-    en+11036, en+11042, en+11048, en+11057, en+11064, en+11071,
-    en+11078, en+11087, en+11095, en+11101, en+11109, en+11115,
-    en+11123, en+11130, en+11137, en+11145, en+11150, en+11157,
-    en+11164, en+11170, en+11178, en+11183, en+11190, en+11194,
-    en+11200, en+11207, en+11213, en+11220, en+11228, en+11233,
-    en+11241, en+11247, en+11256, en+11265, en+11272, en+11280,
-    en+11288, en+11296, en+11302, en+11307, en+11313, en+11319,
-    en+11325, en+11331, en+11336, en+11342, en+11349, en+11355,
-    en+11362, en+11370, en+11376, en+11383, en+11389, en+11396,
-    en+11400, en+11405, en+11412, en+11417, en+11422, en+11427,
-    en+11434, en+11439, en+11445, en+11452, en+11457, en+11463,
-    en+11468, en+11473, en+11477, en+11484, en+11491, en+11496,
-    en+11501, en+11506, en+11511, en+11517, en+11522, en+11528,
-    en+11533, en+11540, en+11546, en+11551, en+11557, en+11562,
-    en+11570, en+11576, en+11583, en+11589, en+11595, en+11603,
-    en+11610, en+11615, en+11621, en+11626, en+11633, en+11638,
-    en+11643, en+11647, en+11653, en+11660, en+11666, en+11672,
-    en+11680, en+11686, en+11694, en+11698, en+11707, en+11714,
-    en+11720, en+11727, en+11736, en+11741, en+11748, en+11756,
-    en+11761, en+11767, en+11771, en+11777, en+11784, en+11790,
-    en+11798, en+11807, en+11812, en+11818, en+11826, en+11833,
-    en+11839, en+11844, en+11848, en+11854, en+11860, en+11868,
-    en+11875, en+11881, en+11890, en+11895, en+11901, en+11908,
-    en+11913, en+11919, en+11924, en+11930, en+11936, en+11942,
-    en+11948, en+11956, en+11961, en+11966, en+11973, en+11981,
-    en+11987, en+11992, en+11998, en+12006, en+12012, en+12018,
-    en+12022, en+12027, en+12035, en+12042, en+12047, en+12054,
-    en+12061, en+12066, en+12073, en+12080, en+12087, en+12093,
-    en+12098, en+12104, en+12108, en+12113, en+12121, en+12126,
-    en+12135, en+12142, en+12150, en+12156, en+12164, en+12170,
-    en+12175, en+12182, en+12189, en+12197, en+12205, en+12212,
-    en+12217, en+12226, en+12234, en+12241, en+12247, en+12255,
-    en+12262, en+12269, en+12277, en+12284, en+12289, en+12295,
-    en+12301, en+12307, en+12312, en+12318, en+12322, en+12327,
-    en+12334, en+12342, en+12348, en+12356, en+12363, en+12370,
-    en+12376, en+12382, en+12389, en+12395, en+12399, en+12406,
-    en+12412, en+12420, en+12425, en+12431, en+12439, en+12446,
-    en+12453, en+12461, en+12467, en+12472, en+12479, en+12487,
-    en+12492, en+12499, en+12507, en+12514, en+12522, en+12530,
-    en+12538, en+12544, en+12549, en+12557, en+12565, en+12572,
-    en+12580, en+12586, en+12591, en+12597, en+12604, en+12610,
-    en+12616, en+12622, en+12628, en+12633, en+12641, en+12648,
-    en+12653, en+12660, en+12665, en+12671, en+12676, en+12681,
-    en+12686, en+12693, en+12698, en+12706, en+12711, en+12719,
-    en+12724, en+12729, en+12735, en+12741, en+12746, en+12750,
-    en+12757, en+12764, en+12769, en+12776, en+12784, en+12788,
-    en+12796, en+12804, en+12810, en+12818, en+12823, en+12827,
-    en+12833, en+12838, en+12844, en+12850, en+12855, en+12861,
-    en+12866, en+12874, en+12879, en+12885, en+12890, en+12895,
-    en+12900, en+12904, en+12911, en+12916, en+12921, en+12926,
-    en+12933, en+12940, en+12945, en+12952, en+12957, en+12962,
-    en+12970, en+12975, en+12981, en+12988, en+12993, en+12998,
-    en+13003, en+13008, en+13014, en+13020, en+13026, en+13031,
-    en+13037, en+13045, en+13051, en+13057, en+13063, en+13068,
-    en+13073, en+13080, en+13084, en+13090, en+13096, en+13102,
-    en+13107, en+13112, en+13116,
+static const uint16_t en_o[] = {
+    0, 8, 16, 21, 27, 33, 40, 47, 56, 63, 69, 76,
+    85, 93, 100, 108, 113, 122, 130, 137, 141, 148, 154, 162,
+    169, 175, 179, 186, 194, 201, 207, 213, 221, 228, 236, 243,
+    250, 257, 263, 267, 273, 279, 285, 289, 293, 301, 307, 313,
+    319, 327, 333, 339, 343, 349, 355, 362, 368, 374, 382, 387,
+    393, 400, 408, 416, 422, 429, 436, 444, 451, 459, 465, 471,
+    477, 484, 490, 499, 506, 514, 521, 529, 537, 545, 549, 555,
+    563, 570, 576, 584, 590, 595, 602, 607, 613, 619, 623, 629,
+    635, 640, 647, 655, 662, 669, 675, 679, 688, 695, 703, 707,
+    714, 722, 728, 735, 742, 749, 757, 762, 769, 776, 785, 793,
+    801, 807, 814, 819, 826, 831, 838, 846, 854, 860, 866, 872,
+    877, 885, 891, 899, 904, 909, 918, 924, 930, 934, 942, 950,
+    955, 962, 969, 976, 980, 987, 995, 1002, 1007, 1013, 1020, 1027,
+    1033, 1038, 1045, 1053, 1060, 1065, 1072, 1078, 1085, 1092, 1100, 1106,
+    1111, 1117, 1125, 1130, 1137, 1144, 1152, 1159, 1167, 1171, 1176, 1181,
+    1189, 1194, 1200, 1207, 1213, 1219, 1225, 1233, 1239, 1245, 1251, 1257,
+    1263, 1271, 1278, 1283, 1288, 1294, 1300, 1305, 1310, 1315, 1320, 1325,
+    1331, 1336, 1342, 1349, 1356, 1363, 1368, 1375, 1382, 1386, 1390, 1398,
+    1404, 1410, 1416, 1422, 1428, 1435, 1441, 1448, 1454, 1461, 1467, 1473,
+    1482, 1489, 1496, 1502, 1510, 1516, 1522, 1529, 1535, 1542, 1550, 1556,
+    1561, 1566, 1573, 1580, 1587, 1594, 1601, 1607, 1611, 1620, 1625, 1632,
+    1638, 1643, 1651, 1657, 1663, 1670, 1675, 1680, 1685, 1690, 1697, 1702,
+    1706, 1712, 1719, 1725, 1732, 1738, 1745, 1752, 1760, 1768, 1776, 1780,
+    1787, 1792, 1798, 1805, 1811, 1816, 1821, 1826, 1833, 1840, 1847, 1851,
+    1859, 1865, 1874, 1881, 1888, 1894, 1902, 1907, 1915, 1922, 1929, 1936,
+    1944, 1951, 1959, 1965, 1971, 1980, 1987, 1993, 2001, 2008, 2014, 2019,
+    2025, 2031, 2038, 2043, 2050, 2056, 2064, 2070, 2076, 2084, 2091, 2098,
+    2106, 2114, 2120, 2126, 2132, 2141, 2148, 2156, 2161, 2167, 2173, 2178,
+    2186, 2191, 2196, 2202, 2208, 2215, 2221, 2228, 2234, 2240, 2247, 2252,
+    2258, 2263, 2269, 2275, 2281, 2287, 2292, 2298, 2306, 2313, 2319, 2325,
+    2333, 2338, 2345, 2350, 2355, 2363, 2369, 2376, 2384, 2389, 2397, 2403,
+    2410, 2418, 2426, 2434, 2442, 2451, 2459, 2468, 2476, 2485, 2490, 2495,
+    2502, 2507, 2513, 2518, 2523, 2531, 2536, 2543, 2549, 2557, 2564, 2571,
+    2578, 2584, 2591, 2597, 2604, 2610, 2615, 2621, 2627, 2634, 2640, 2646,
+    2652, 2659, 2665, 2670, 2678, 2684, 2690, 2697, 2702, 2708, 2715, 2721,
+    2729, 2735, 2742, 2750, 2757, 2763, 2767, 2775, 2780, 2788, 2792, 2801,
+    2809, 2817, 2825, 2831, 2839, 2846, 2851, 2857, 2861, 2868, 2873, 2879,
+    2886, 2893, 2898, 2907, 2912, 2916, 2921, 2928, 2935, 2942, 2951, 2958,
+    2966, 2975, 2984, 2989, 2997, 3004, 3009, 3016, 3022, 3030, 3037, 3044,
+    3051, 3059, 3064, 3071, 3078, 3086, 3092, 3099, 3106, 3115, 3122, 3129,
+    3134, 3142, 3150, 3157, 3164, 3172, 3179, 3186, 3194, 3199, 3207, 3213,
+    3218, 3225, 3230, 3237, 3245, 3253, 3261, 3268, 3277, 3284, 3289, 3298,
+    3307, 3315, 3320, 3328, 3337, 3345, 3354, 3361, 3368, 3376, 3382, 3389,
+    3398, 3402, 3407, 3415, 3422, 3429, 3436, 3442, 3447, 3452, 3459, 3464,
+    3470, 3477, 3483, 3491, 3496, 3502, 3508, 3514, 3520, 3526, 3531, 3537,
+    3542, 3547, 3551, 3556, 3561, 3566, 3573, 3578, 3584, 3589, 3595, 3603,
+    3609, 3615, 3621, 3626, 3632, 3639, 3644, 3649, 3654, 3662, 3670, 3675,
+    3680, 3688, 3695, 3699, 3705, 3712, 3718, 3724, 3733, 3741, 3749, 3758,
+    3767, 3773, 3778, 3785, 3792, 3800, 3807, 3815, 3822, 3830, 3836, 3843,
+    3849, 3853, 3861, 3869, 3875, 3882, 3890, 3897, 3904, 3912, 3918, 3925,
+    3932, 3939, 3946, 3953, 3959, 3966, 3972, 3981, 3989, 3995, 4001, 4005,
+    4011, 4017, 4025, 4031, 4037, 4044, 4050, 4058, 4065, 4073, 4080, 4089,
+    4094, 4100, 4107, 4113, 4121, 4128, 4137, 4144, 4152, 4159, 4167, 4176,
+    4184, 4192, 4198, 4204, 4209, 4216, 4223, 4230, 4237, 4245, 4252, 4260,
+    4267, 4273, 4277, 4285, 4292, 4297, 4305, 4310, 4316, 4322, 4327, 4333,
+    4338, 4345, 4352, 4356, 4362, 4370, 4375, 4383, 4387, 4393, 4400, 4408,
+    4414, 4423, 4431, 4440, 4448, 4452, 4457, 4462, 4469, 4475, 4484, 4490,
+    4496, 4500, 4506, 4514, 4520, 4527, 4532, 4537, 4544, 4550, 4555, 4560,
+    4567, 4574, 4579, 4584, 4590, 4597, 4602, 4606, 4614, 4618, 4623, 4629,
+    4635, 4640, 4647, 4652, 4659, 4664, 4670, 4676, 4682, 4689, 4695, 4701,
+    4705, 4710, 4716, 4720, 4725, 4730, 4737, 4742, 4747, 4753, 4760, 4767,
+    4772, 4780, 4786, 4794, 4801, 4808, 4814, 4818, 4826, 4832, 4841, 4847,
+    4854, 4861, 4866, 4872, 4878, 4884, 4891, 4897, 4902, 4906, 4912, 4920,
+    4925, 4932, 4939, 4944, 4951, 4959, 4964, 4968, 4975, 4983, 4990, 4997,
+    5005, 5009, 5014, 5019, 5026, 5032, 5037, 5045, 5052, 5058, 5065, 5073,
+    5081, 5087, 5093, 5098, 5105, 5112, 5120, 5125, 5130, 5135, 5142, 5148,
+    5154, 5160, 5168, 5174, 5180, 5186, 5192, 5197, 5202, 5207, 5215, 5220,
+    5225, 5231, 5239, 5246, 5253, 5260, 5265, 5270, 5276, 5282, 5288, 5294,
+    5300, 5308, 5314, 5320, 5325, 5331, 5336, 5344, 5350, 5355, 5361, 5367,
+    5373, 5379, 5385, 5392, 5396, 5400, 5406, 5411, 5416, 5423, 5431, 5436,
+    5442, 5449, 5454, 5460, 5468, 5472, 5477, 5482, 5489, 5494, 5501, 5507,
+    5513, 5522, 5529, 5535, 5542, 5547, 5551, 5556, 5563, 5568, 5573, 5578,
+    5582, 5587, 5595, 5601, 5608, 5613, 5618, 5626, 5633, 5638, 5644, 5649,
+    5654, 5659, 5666, 5672, 5681, 5686, 5692, 5697, 5703, 5707, 5712, 5718,
+    5725, 5731, 5739, 5746, 5751, 5758, 5764, 5769, 5777, 5784, 5788, 5793,
+    5798, 5807, 5812, 5819, 5823, 5831, 5839, 5845, 5853, 5861, 5868, 5875,
+    5882, 5890, 5898, 5903, 5911, 5918, 5927, 5933, 5942, 5949, 5958, 5965,
+    5973, 5980, 5987, 5995, 6003, 6010, 6017, 6024, 6030, 6039, 6045, 6053,
+    6060, 6067, 6074, 6082, 6090, 6097, 6106, 6111, 6118, 6125, 6133, 6138,
+    6145, 6153, 6159, 6164, 6170, 6177, 6184, 6188, 6193, 6201, 6207, 6213,
+    6219, 6223, 6228, 6233, 6241, 6245, 6251, 6257, 6262, 6269, 6276, 6281,
+    6286, 6295, 6300, 6305, 6313, 6317, 6322, 6326, 6333, 6338, 6346, 6351,
+    6355, 6363, 6368, 6375, 6380, 6385, 6391, 6397, 6402, 6406, 6412, 6418,
+    6425, 6430, 6435, 6440, 6449, 6456, 6462, 6468, 6474, 6480, 6488, 6493,
+    6497, 6502, 6510, 6516, 6521, 6528, 6533, 6539, 6545, 6553, 6558, 6562,
+    6568, 6575, 6583, 6589, 6594, 6601, 6606, 6614, 6621, 6628, 6634, 6639,
+    6647, 6655, 6663, 6668, 6673, 6679, 6684, 6689, 6695, 6700, 6705, 6712,
+    6717, 6724, 6729, 6736, 6741, 6746, 6754, 6760, 6765, 6771, 6778, 6783,
+    6788, 6796, 6801, 6808, 6813, 6819, 6825, 6833, 6840, 6846, 6852, 6859,
+    6866, 6874, 6878, 6884, 6891, 6896, 6901, 6906, 6912, 6917, 6924, 6928,
+    6935, 6943, 6949, 6957, 6964, 6970, 6977, 6983, 6990, 6997, 7004, 7013,
+    7018, 7023, 7030, 7036, 7045, 7050, 7057, 7064, 7072, 7077, 7084, 7089,
+    7097, 7102, 7111, 7117, 7123, 7130, 7135, 7142, 7149, 7157, 7162, 7168,
+    7174, 7180, 7186, 7191, 7199, 7205, 7212, 7219, 7228, 7233, 7241, 7247,
+    7252, 7260, 7266, 7273, 7281, 7288, 7295, 7300, 7308, 7312, 7318, 7326,
+    7333, 7339, 7346, 7350, 7357, 7365, 7372, 7380, 7386, 7391, 7397, 7402,
+    7410, 7419, 7426, 7433, 7439, 7448, 7454, 7459, 7465, 7470, 7477, 7482,
+    7491, 7498, 7505, 7514, 7520, 7525, 7532, 7539, 7547, 7552, 7558, 7563,
+    7570, 7577, 7583, 7590, 7597, 7602, 7607, 7612, 7621, 7629, 7637, 7644,
+    7650, 7655, 7659, 7667, 7675, 7681, 7686, 7691, 7696, 7702, 7708, 7714,
+    7722, 7729, 7736, 7742, 7747, 7755, 7760, 7768, 7775, 7781, 7785, 7793,
+    7800, 7806, 7810, 7814, 7819, 7826, 7833, 7841, 7849, 7856, 7864, 7870,
+    7876, 7884, 7889, 7893, 7899, 7906, 7912, 7916, 7921, 7925, 7931, 7939,
+    7944, 7949, 7953, 7959, 7966, 7971, 7976, 7982, 7990, 7997, 8004, 8011,
+    8017, 8025, 8031, 8040, 8046, 8053, 8062, 8069, 8077, 8083, 8091, 8097,
+    8104, 8112, 8117, 8122, 8127, 8131, 8137, 8144, 8151, 8157, 8162, 8169,
+    8174, 8179, 8186, 8191, 8197, 8203, 8209, 8217, 8223, 8230, 8237, 8242,
+    8249, 8255, 8260, 8266, 8271, 8279, 8286, 8294, 8300, 8305, 8313, 8319,
+    8326, 8331, 8339, 8347, 8351, 8359, 8366, 8373, 8380, 8388, 8395, 8402,
+    8406, 8412, 8418, 8425, 8434, 8440, 8447, 8455, 8461, 8465, 8472, 8477,
+    8483, 8488, 8496, 8501, 8508, 8514, 8520, 8526, 8533, 8541, 8547, 8552,
+    8559, 8566, 8572, 8577, 8584, 8589, 8594, 8600, 8606, 8611, 8618, 8623,
+    8628, 8633, 8641, 8649, 8658, 8667, 8672, 8679, 8687, 8695, 8702, 8708,
+    8717, 8724, 8732, 8739, 8747, 8755, 8762, 8770, 8776, 8782, 8790, 8796,
+    8805, 8812, 8820, 8826, 8834, 8842, 8850, 8857, 8865, 8873, 8881, 8887,
+    8896, 8904, 8912, 8918, 8926, 8933, 8941, 8946, 8951, 8957, 8965, 8971,
+    8977, 8983, 8992, 8999, 9007, 9013, 9018, 9022, 9029, 9037, 9045, 9053,
+    9061, 9070, 9076, 9081, 9086, 9092, 9099, 9107, 9112, 9117, 9123, 9129,
+    9134, 9139, 9145, 9151, 9156, 9162, 9169, 9175, 9181, 9186, 9191, 9198,
+    9204, 9208, 9214, 9220, 9225, 9232, 9238, 9246, 9253, 9261, 9268, 9275,
+    9283, 9290, 9298, 9305, 9312, 9319, 9326, 9334, 9341, 9347, 9355, 9362,
+    9367, 9374, 9383, 9390, 9397, 9404, 9410, 9415, 9422, 9429, 9436, 9444,
+    9451, 9459, 9466, 9475, 9482, 9491, 9500, 9507, 9514, 9522, 9529, 9537,
+    9544, 9551, 9558, 9565, 9569, 9576, 9581, 9586, 9591, 9597, 9603, 9609,
+    9615, 9620, 9625, 9632, 9637, 9644, 9650, 9656, 9661, 9667, 9673, 9680,
+    9687, 9695, 9700, 9707, 9712, 9717, 9724, 9730, 9736, 9742, 9748, 9755,
+    9760, 9764, 9769, 9773, 9780, 9786, 9790, 9797, 9805, 9810, 9815, 9821,
+    9828, 9834, 9839, 9846, 9851, 9858, 9863, 9871, 9879, 9885, 9893, 9898,
+    9902, 9908, 9913, 9919, 9927, 9933, 9940, 9947, 9955, 9964, 9973, 9979,
+    9985, 9992, 9999, 10005, 10009, 10016, 10023, 10028, 10035, 10042, 10050, 10059,
+    10064, 10069, 10077, 10084, 10089, 10097, 10104, 10110, 10119, 10126, 10134, 10142,
+    10149, 10155, 10161, 10168, 10174, 10182, 10188, 10193, 10199, 10207, 10214, 10220,
+    10226, 10231, 10238, 10244, 10249, 10255, 10260, 10266, 10275, 10281, 10288, 10294,
+    10302, 10306, 10314, 10319, 10324, 10330, 10336, 10341, 10348, 10353, 10359, 10366,
+    10374, 10381, 10387, 10392, 10398, 10405, 10413, 10417, 10422, 10428, 10435, 10439,
+    10445, 10450, 10456, 10462, 10467, 10472, 10478, 10486, 10492, 10498, 10505, 10510,
+    10517, 10522, 10527, 10533, 10539, 10545, 10551, 10557, 10564, 10570, 10576, 10581,
+    10587, 10592, 10597, 10604, 10611, 10616, 10621, 10626, 10632, 10640, 10646, 10655,
+    10661, 10669, 10674, 10679, 10685, 10690, 10695, 10701, 10706, 10713, 10719, 10725,
+    10731, 10739, 10745, 10751, 10759, 10765, 10771, 10777, 10784, 10790, 10797, 10803,
+    10808, 10815, 10821, 10827, 10835, 10841, 10847, 10852, 10858, 10865, 10872, 10876,
+    10883, 10891, 10900, 10907, 10915, 10921, 10927, 10934, 10940, 10946, 10952, 10958,
+    10963, 10969, 10975, 10980, 10985, 10992, 10998, 11004, 11010, 11016, 11024, 11030,
+    11036, 11042, 11048, 11057, 11064, 11071, 11078, 11087, 11095, 11101, 11109, 11115,
+    11123, 11130, 11137, 11145, 11150, 11157, 11164, 11170, 11178, 11183, 11190, 11194,
+    11200, 11207, 11213, 11220, 11228, 11233, 11241, 11247, 11256, 11265, 11272, 11280,
+    11288, 11296, 11302, 11307, 11313, 11319, 11325, 11331, 11336, 11342, 11349, 11355,
+    11362, 11370, 11376, 11383, 11389, 11396, 11400, 11405, 11412, 11417, 11422, 11427,
+    11434, 11439, 11445, 11452, 11457, 11463, 11468, 11473, 11477, 11484, 11491, 11496,
+    11501, 11506, 11511, 11517, 11522, 11528, 11533, 11540, 11546, 11551, 11557, 11562,
+    11570, 11576, 11583, 11589, 11595, 11603, 11610, 11615, 11621, 11626, 11633, 11638,
+    11643, 11647, 11653, 11660, 11666, 11672, 11680, 11686, 11694, 11698, 11707, 11714,
+    11720, 11727, 11736, 11741, 11748, 11756, 11761, 11767, 11771, 11777, 11784, 11790,
+    11798, 11807, 11812, 11818, 11826, 11833, 11839, 11844, 11848, 11854, 11860, 11868,
+    11875, 11881, 11890, 11895, 11901, 11908, 11913, 11919, 11924, 11930, 11936, 11942,
+    11948, 11956, 11961, 11966, 11973, 11981, 11987, 11992, 11998, 12006, 12012, 12018,
+    12022, 12027, 12035, 12042, 12047, 12054, 12061, 12066, 12073, 12080, 12087, 12093,
+    12098, 12104, 12108, 12113, 12121, 12126, 12135, 12142, 12150, 12156, 12164, 12170,
+    12175, 12182, 12189, 12197, 12205, 12212, 12217, 12226, 12234, 12241, 12247, 12255,
+    12262, 12269, 12277, 12284, 12289, 12295, 12301, 12307, 12312, 12318, 12322, 12327,
+    12334, 12342, 12348, 12356, 12363, 12370, 12376, 12382, 12389, 12395, 12399, 12406,
+    12412, 12420, 12425, 12431, 12439, 12446, 12453, 12461, 12467, 12472, 12479, 12487,
+    12492, 12499, 12507, 12514, 12522, 12530, 12538, 12544, 12549, 12557, 12565, 12572,
+    12580, 12586, 12591, 12597, 12604, 12610, 12616, 12622, 12628, 12633, 12641, 12648,
+    12653, 12660, 12665, 12671, 12676, 12681, 12686, 12693, 12698, 12706, 12711, 12719,
+    12724, 12729, 12735, 12741, 12746, 12750, 12757, 12764, 12769, 12776, 12784, 12788,
+    12796, 12804, 12810, 12818, 12823, 12827, 12833, 12838, 12844, 12850, 12855, 12861,
+    12866, 12874, 12879, 12885, 12890, 12895, 12900, 12904, 12911, 12916, 12921, 12926,
+    12933, 12940, 12945, 12952, 12957, 12962, 12970, 12975, 12981, 12988, 12993, 12998,
+    13003, 13008, 13014, 13020, 13026, 13031, 13037, 13045, 13051, 13057, 13063, 13068,
+    13073, 13080, 13084, 13090, 13096, 13102, 13107, 13112,
+   };
+
+static const uint16_t en_d[] = {
+    78, 190, 0, 26, 57, 3, 31, 1, 7, 30, 91, 83,
+    2, 107, 7, 3, 168, 0, 21, 66, 145, 0, 8, 76,
+    0, 49, 83, 102, 133, 4, 28, 53, 2, 136, 31, 36,
+    433, 0, 0, 19, 24, 12, 0, 139, 3, 108, 74, 0,
+    3, 58, 202, 1, 137, 3, 30, 1, 109, 8, 22, 23,
+    4, 12, 10, 173, 95, 96, 0, 6, 34, 104, 248, 5,
+    60, 1, 1, 75, 0, 10, 51, 19, 4, 30, 11, 16,
+    27, 1, 0, 15, 0, 99, 0, 5, 832, 0, 8, 78,
+    617, 61, 35, 3, 12, 93, 177, 5, 27, 3, 43, 50,
+    0, 203, 188, 42, 44, 154, 0, 44, 12, 1, 2, 14,
+    39, 8, 0, 70, 14, 104, 1, 0, 5, 24, 15, 54,
+    224, 0, 0, 140, 12, 13, 79, 15, 62, 24, 5, 111,
+    5, 20, 311, 0, 32, 2, 0, 16, 1, 0, 11, 202,
+    6, 37, 8, 432, 105, 528, 0, 2, 22, 9, 0, 6,
+    57, 9, 7, 48, 0, 544, 29, 0, 5, 1, 0, 0,
+    30, 31, 256, 65, 7, 1, 96, 314, 18, 1, 312, 87,
+    202, 17, 230, 0, 1, 4, 12, 30, 21, 5, 45, 24,
+    0, 2, 402, 767, 32, 71, 346, 18, 40, 3, 17, 17,
+    172, 146, 803, 17, 123, 114, 0, 137, 73, 98, 18, 38,
+    14, 0, 167, 4, 2, 0, 0, 50, 84, 9, 116, 6,
+    537, 19, 3, 12, 0, 116, 448, 0, 163, 96, 491, 293,
+    3, 338, 33, 15, 0, 8, 9, 10, 2, 0, 73, 45,
+    90, 0, 132, 48, 232, 0, 0, 729, 413, 3, 125, 107,
+    7, 115, 165, 51, 56, 530, 616, 5, 106, 67, 135, 0,
+    143, 0, 36, 10, 4, 864, 335, 0, 55, 43, 35, 6,
+    3, 739, 404, 385, 10, 69, 79, 159, 164, 1, 48, 24,
+    26, 305, 1, 8, 1, 2076, 6, 334, 499, 7, 0, 33,
+    50, 60, 796, 984, 11, 9, 218, 33, 8, 272, 183, 280,
+    0, 145, 2, 33, 2, 10, 2, 330, 243, 385, 0, 746,
+    480, 84, 19, 781, 7, 2, 142, 352, 36, 324, 164, 111,
+    83, 2, 92, 8, 31, 60, 5, 1049, 0, 514, 6, 2,
+    881, 0, 1, 288, 46, 5, 3, 246, 7, 18, 6, 2,
+    1103, 627, 55, 186, 7, 52, 691, 223, 140, 305, 478, 144,
+    1, 44, 12, 67, 3, 39, 30, 19, 0, 42, 350, 7,
+    623, 196, 480, 3632, 635, 1376, 175, 527, 1942, 69, 42, 11,
+    14, 20, 8, 1112, 0, 0, 547, 1, 30, 127, 38, 3,
+    122, 0, 1279, 18, 498, 142, 14, 369, 1045, 226, 1303, 0,
+    6, 6, 105, 1042, 5, 3254, 41, 404, 1683, 2, 360, 12,
+    270, 2, 111, 322, 4, 2285, 1169, 51, 13, 465, 4106, 259,
+    0, 786, 87, 577, 1, 20, 3108, 34, 99, 8, 5, 3802,
+    572, 280, 2067, 444, 311, 441, 600, 322, 2854, 0, 0, 96,
+    5836, 2899, 597, 1, 7749, 4788, 196, 2, 138, 11, 71, 377,
+    10, 1794, 103, 75, 10, 5031, 17, 2,
+   };
+static const uint16_t en_h[] = {
+    636, 1064, 810, 18, 1600, 1171, 1054, 1400, 1564, 951, 1211, 1325,
+    160, 529, 1071, 1843, 167, 1840, 998, 503, 1805, 1578, 1150, 453,
+    1254, 382, 1856, 162, 1253, 2046, 41, 2003, 477, 1276, 853, 555,
+    418, 639, 1869, 1938, 1914, 638, 1908, 813, 12, 963, 1219, 1850,
+    1287, 2029, 233, 1017, 1288, 123, 489, 627, 930, 1974, 782, 730,
+    1259, 1773, 1107, 1498, 396, 427, 1520, 718, 500, 695, 1446, 774,
+    1894, 1730, 921, 1163, 1162, 1375, 1390, 1789, 1996, 1424, 1701, 1879,
+    1654, 1603, 1445, 1777, 2006, 1104, 835, 165, 956, 159, 2018, 1094,
+    985, 1893, 840, 697, 273, 1006, 1617, 1791, 1927, 2043, 1321, 240,
+    915, 1469, 431, 521, 1197, 893, 982, 603, 274, 972, 935, 1998,
+    1310, 1728, 1612, 837, 727, 1953, 923, 553, 647, 1809, 1267, 99,
+    1093, 79, 1303, 715, 728, 1123, 1198, 172, 190, 1441, 1842, 1935,
+    1976, 353, 720, 902, 13, 1988, 441, 1500, 1265, 1266, 1808, 1798,
+    296, 938, 270, 277, 1713, 322, 409, 1119, 1313, 1257, 1501, 413,
+    170, 203, 1985, 587, 544, 657, 1677, 1892, 862, 1275, 1069, 1014,
+    1826, 417, 232, 11, 1244, 1504, 1513, 72, 386, 54, 1365, 357,
+    1041, 1384, 1192, 604, 710, 1200, 1806, 1130, 398, 297, 1451, 557,
+    860, 648, 1642, 1455, 1978, 140, 846, 626, 1190, 717, 1024, 1072,
+    1966, 617, 541, 2025, 1760, 2026, 87, 361, 405, 1585, 807, 1608,
+    1139, 474, 1376, 488, 857, 806, 1272, 1638, 1300, 1763, 1478, 1407,
+    842, 217, 1295, 1153, 1033, 1194, 508, 119, 1209, 428, 324, 1345,
+    653, 786, 1872, 1878, 268, 1659, 355, 1922, 747, 1687, 1820, 1542,
+    1357, 1462, 2019, 348, 263, 590, 1230, 646, 1912, 161, 1055, 650,
+    791, 1644, 282, 1347, 1374, 836, 31, 931, 481, 858, 952, 112,
+    1860, 776, 1113, 1948, 1959, 1583, 901, 1854, 1135, 486, 267, 471,
+    148, 381, 1835, 1089, 1505, 89, 620, 942, 1522, 1329, 1770, 1364,
+    1121, 1485, 602, 175, 1415, 917, 1852, 46, 1732, 895, 744, 464,
+    319, 1496, 1702, 678, 214, 1776, 1349, 1386, 1284, 305, 1901, 1761,
+    1708, 1320, 2007, 1705, 1356, 504, 1268, 1523, 533, 115, 2012, 1397,
+    822, 1330, 1823, 1750, 1273, 328, 966, 187, 1676, 435, 301, 1124,
+    1678, 1176, 600, 845, 236, 377, 1967, 1924, 698, 1359, 132, 2030,
+    546, 655, 2045, 225, 198, 887, 1709, 1502, 1754, 1781, 1437, 694,
+    1771, 552, 1393, 105, 1841, 302, 1220, 337, 907, 1575, 667, 855,
+    1945, 412, 191, 1148, 844, 196, 748, 171, 406, 993, 1960, 1470,
+    601, 26, 843, 1942, 777, 1080, 1590, 468, 1420, 1817, 410, 969,
+    1997, 1204, 1696, 1479, 27, 792, 260, 98, 306, 1147, 1968, 415,
+    679, 1742, 1387, 1751, 1246, 1611, 373, 338, 1499, 713, 371, 809,
+    1618, 1173, 977, 723, 1991, 1825, 520, 2015, 991, 1002, 550, 1951,
+    86, 1680, 1205, 1440, 1610, 795, 763, 2011, 393, 1549, 1946, 1686,
+    1516, 133, 246, 195, 513, 1096, 742, 623, 1133, 103, 726, 911,
+    1954, 1090, 994, 473, 1208, 1876, 912, 1899, 567, 130, 783, 0,
+    1726, 1417, 1689, 124, 828, 111, 838, 1816, 2022, 1092, 138, 1589,
+    1476, 1223, 629, 1271, 1381, 764, 980, 174, 458, 570, 1471, 1565,
+    833, 1875, 896, 574, 1787, 2017, 961, 1594, 818, 729, 71, 1535,
+    906, 294, 1786, 399, 750, 81, 1979, 919, 968, 1044, 1588, 1896,
+    1157, 1077, 1593, 1491, 1472, 920, 1887, 651, 642, 363, 1174, 528,
+    1495, 675, 1885, 664, 1042, 433, 592, 1801, 1727, 1137, 1660, 672,
+    154, 1620, 184, 538, 1882, 1965, 863, 1286, 1950, 1383, 1637, 714,
+    457, 1493, 14, 1828, 1941, 1296, 254, 670, 1712, 176, 43, 1362,
+    1889, 1983, 51, 153, 1216, 1076, 1745, 821, 539, 637, 624, 287,
+    82, 1084, 460, 781, 323, 1698, 466, 608, 1229, 1037, 345, 449,
+    758, 333, 1915, 1792, 493, 892, 751, 1703, 300, 1735, 814, 2016,
+    1290, 34, 1921, 149, 1868, 45, 654, 131, 164, 88, 1114, 1047,
+    1178, 1977, 865, 788, 909, 252, 360, 1025, 1536, 1463, 437, 1582,
+    722, 1458, 1861, 293, 1640, 1581, 1370, 1739, 237, 211, 1883, 1604,
+    1700, 452, 1298, 450, 1484, 999, 1009, 134, 700, 194, 1625, 1573,
+    368, 2041, 1623, 1074, 1863, 1984, 1438, 1848, 1483, 350, 485, 1838,
+    1416, 643, 1318, 320, 1538, 177, 1569, 1412, 1046, 778, 1243, 1465,
+    1385, 385, 1352, 290, 1371, 704, 407, 1291, 498, 1481, 1755, 4,
+    1304, 1459, 1925, 1529, 1126, 1095, 229, 1431, 2033, 1733, 1999, 113,
+    1651, 1902, 102, 387, 249, 70, 1221, 677, 954, 1040, 359, 253,
+    1736, 1767, 1665, 459, 1110, 434, 1722, 5, 606, 738, 1226, 269,
+    332, 56, 1309, 258, 75, 1278, 1467, 343, 507, 940, 1175, 1351,
+    392, 1280, 1788, 1691, 57, 1624, 402, 1218, 341, 1613, 347, 1556,
+    910, 1196, 1635, 1939, 873, 326, 37, 1769, 796, 1802, 1212, 687,
+    344, 914, 829, 275, 1361, 1373, 60, 1858, 1845, 1692, 1052, 1228,
+    52, 897, 436, 1601, 226, 1891, 566, 771, 1115, 765, 918, 545,
+    425, 633, 1490, 1410, 1314, 1818, 1242, 1170, 933, 753, 1418, 1231,
+    997, 1597, 1508, 1714, 470, 206, 1580, 1227, 1195, 1667, 875, 1545,
+    770, 313, 47, 691, 1369, 551, 257, 243, 1719, 1567, 580, 950,
+    877, 1658, 2034, 169, 181, 228, 658, 804, 501, 2004, 1576, 943,
+    1249, 318, 1201, 690, 2032, 1898, 1685, 298, 542, 1859, 1322, 1203,
+    868, 221, 69, 731, 490, 1881, 903, 784, 1233, 605, 976, 1434,
+    1335, 339, 772, 749, 239, 582, 1151, 2047, 652, 93, 889, 1632,
+    1327, 850, 7, 586, 1053, 1004, 666, 90, 220, 1120, 1657, 505,
+    1010, 1548, 1511, 156, 967, 50, 411, 173, 1145, 117, 793, 937,
+    311, 1079, 1477, 759, 1489, 1466, 536, 95, 1534, 894, 499, 1411,
+    251, 1940, 609, 1111, 1916, 962, 1661, 607, 588, 1524, 1222, 1057,
+    121, 874, 990, 839, 707, 1000, 262, 1829, 1555, 472, 1023, 1775,
+    315, 1963, 1824, 1323, 989, 673, 1294, 74, 378, 785, 68, 152,
+    55, 1378, 48, 1166, 576, 1474, 594, 204, 188, 1492, 1928, 321,
+    143, 1261, 1067, 1401, 1360, 1159, 1514, 32, 255, 1328, 1399, 1634,
+    595, 1756, 1710, 1263, 1336, 1342, 1464, 227, 1426, 1515, 1085, 641,
+    706, 960, 2010, 336, 719, 534, 1264, 983, 1697, 1497, 1394, 1191,
+    970, 192, 527, 864, 535, 80, 1029, 259, 455, 292, 278, 1724,
+    209, 166, 1616, 659, 1252, 1187, 496, 1425, 1715, 1758, 1897, 1961,
+    447, 1969, 1306, 1210, 563, 1340, 848, 572, 547, 964, 735, 388,
+    888, 28, 1910, 1797, 1160, 1749, 1482, 394, 2035, 1933, 746, 756,
+    1913, 1099, 446, 939, 1337, 1460, 1932, 1871, 984, 1449, 737, 1022,
+    1282, 927, 1554, 1235, 106, 1380, 579, 1559, 946, 186, 483, 1134,
+    803, 1981, 1225, 1125, 558, 210, 1957, 1799, 1574, 571, 615, 649,
+    805, 811, 443, 367, 66, 1646, 669, 1636, 613, 1540, 49, 682,
+    1766, 743, 2038, 509, 1662, 1738, 126, 1586, 916, 491, 1102, 936,
+    180, 349, 1759, 1011, 1731, 1884, 1546, 104, 1247, 108, 1103, 900,
+    1413, 1199, 462, 1346, 1919, 135, 1168, 1647, 884, 959, 1003, 1256,
+    1169, 107, 42, 1388, 1144, 1405, 1366, 1152, 372, 1274, 1561, 1748,
+    1391, 716, 502, 97, 518, 1301, 351, 725, 1615, 1408, 342, 1213,
+    693, 1815, 1070, 1626, 1142, 1796, 610, 183, 1905, 1720, 565, 150,
+    1422, 1607, 830, 185, 1215, 1675, 1989, 85, 543, 1468, 1744, 1444,
+    631, 1931, 1870, 1255, 329, 118, 1693, 1358, 469, 2027, 9, 1836,
+    199, 1530, 1992, 1143, 681, 354, 1224, 1193, 308, 1679, 397, 801,
+    1911, 1343, 881, 775, 1051, 1599, 1241, 794, 376, 904, 395, 1721,
+    1293, 688, 383, 1457, 424, 1087, 859, 734, 974, 816, 1557, 1812,
+    593, 1061, 1717, 1075, 1592, 1452, 1780, 899, 591, 202, 1182, 768,
+    1248, 314, 1389, 1918, 973, 867, 953, 1550, 1627, 1683, 1001, 1161,
+    403, 1747, 1429, 1363, 712, 19, 820, 316, 589, 1138, 1319, 1105,
+    1341, 20, 6, 832, 1299, 824, 800, 234, 1975, 1551, 1419, 1655,
+    1648, 440, 699, 2039, 475, 898, 1031, 2013, 1403, 1302, 1108, 65,
+    1062, 1572, 445, 674, 1866, 2, 1614, 790, 1005, 271, 1704, 519,
+    789, 91, 1855, 958, 1443, 530, 932, 584, 1949, 1811, 1034, 1664,
+    384, 23, 630, 1019, 73, 1558, 17, 281, 1048, 482, 656, 1517,
+    1630, 1864, 238, 1027, 692, 1929, 741, 1461, 59, 1283, 299, 1392,
+    512, 988, 141, 1129, 596, 879, 517, 1117, 676, 1250, 92, 1065,
+    1672, 1521, 2001, 948, 1453, 949, 1239, 1830, 442, 540, 1641, 1279,
+    158, 1050, 1262, 261, 352, 1718, 1807, 1270, 346, 1633, 1156, 779,
+    660, 815, 327, 78, 1016, 44, 426, 235, 1986, 1964, 1164, 819,
+    1058, 1711, 2021, 218, 451, 1877, 1570, 1, 1846, 423, 922, 1063,
+    612, 929, 1810, 157, 1958, 1695, 1442, 1602, 1030, 1947, 276, 144,
+    1448, 711, 913, 1377, 1488, 245, 1782, 178, 3, 364, 1552, 797,
+    870, 77, 1987, 1831, 1833, 205, 861, 100, 1926, 947, 1181, 978,
+    523, 1930, 391, 524, 1971, 1943, 1537, 1305, 1507, 1944, 979, 448,
+    618, 1688, 35, 1494, 1406, 1260, 1813, 1013, 307, 1008, 129, 1518,
+    516, 621, 532, 851, 908, 2040, 147, 137, 721, 1338, 1118, 163,
+    1402, 1923, 1743, 1955, 1790, 109, 965, 1081, 856, 569, 182, 1670,
+    39, 1541, 110, 25, 1752, 739, 280, 1547, 1768, 421, 454, 1109,
+    264, 1746, 1238, 872, 1098, 16, 1131, 1207, 568, 1707, 1794, 708,
+    248, 207, 1980, 179, 514, 1774, 2037, 1920, 597, 1414, 1020, 497,
+    1832, 114, 40, 1167, 957, 1428, 1890, 334, 1995, 799, 1140, 356,
+    823, 1674, 484, 289, 1793, 1149, 757, 578, 1165, 1430, 1800, 479,
+    284, 754, 599, 577, 463, 136, 1083, 1663, 1764, 511, 408, 265,
+    476, 1056, 1073, 890, 1577, 76, 598, 67, 492, 340, 439, 1237,
+    1188, 762, 1316, 575, 247, 1021, 945, 2005, 1803, 755, 127, 1510,
+    1026, 745, 1141, 1334, 416, 560, 1324, 222, 2042, 1741, 975, 96,
+    1251, 928, 1308, 272, 1409, 632, 1952, 1421, 286, 1993, 303, 787,
+    467, 1307, 309, 562, 1853, 686, 1865, 760, 1202, 854, 1934, 432,
+    1779, 1032, 478, 128, 1584, 1723, 732, 766, 941, 1606, 285, 1814,
+    84, 465, 619, 1888, 1086, 295, 665, 379, 506, 1395, 288, 847,
+    370, 1784, 585, 1232, 2000, 200, 1729, 696, 1671, 1734, 1539, 250,
+    1112, 671, 1844, 767, 1757, 279, 1804, 208, 101, 1311, 1994, 869,
+    1132, 139, 1097, 1355, 1936, 2020, 1068, 640, 866, 1629, 22, 622,
+    628, 1917, 1439, 1454, 740, 1289, 992, 1450, 1544, 701, 1656, 374,
+    1907, 554, 1312, 64, 1772, 231, 1762, 1681, 1059, 1528, 223, 1127,
+    1543, 24, 925, 852, 1045, 1186, 365, 145, 1436, 414, 94, 2014,
+    724, 1292, 1737, 1837, 644, 780, 1433, 663, 1834, 583, 752, 1088,
+    1819, 702, 1035, 1553, 1650, 944, 1339, 1122, 241, 456, 401, 244,
+    849, 1185, 362, 1566, 151, 30, 1956, 33, 1404, 611, 380, 1857,
+    1155, 1533, 1694, 995, 142, 1716, 808, 1043, 817, 736, 1217, 283,
+    61, 1435, 1350, 1066, 2008, 1962, 1895, 1432, 390, 400, 802, 1106,
+    120, 769, 189, 1486, 885, 213, 522, 1180, 1285, 1423, 1525, 1317,
+    1527, 812, 886, 1839, 480, 705, 1639, 1906, 1177, 1060, 312, 1886,
+    661, 1018, 438, 1621, 1595, 1560, 1503, 419, 1398, 971, 1970, 581,
+    1506, 564, 1563, 1015, 703, 389, 825, 1331, 201, 559, 1847, 634,
+    1874, 1673, 1315, 36, 1101, 1396, 1622, 525, 616, 1631, 215, 224,
+    29, 1427, 1158, 880, 2009, 83, 168, 1100, 826, 1509, 125, 573,
+    1082, 1519, 1206, 684, 1136, 1234, 986, 834, 155, 291, 645, 1154,
+    1245, 2044, 1269, 1367, 317, 614, 358, 827, 531, 1909, 1512, 683,
+    1116, 841, 1326, 685, 955, 883, 1706, 335, 1487, 2002, 1666, 625,
+    444, 878, 1867, 1821, 325, 733, 310, 798, 62, 116, 1146, 1596,
+    63, 1172, 1862, 1591, 1827, 1873, 1480, 1900, 404, 1609, 761, 934,
+    831, 1851, 58, 375, 1973, 1333, 1643, 2031, 924, 635, 1240, 891,
+    548, 331, 21, 1372, 1982, 1236, 8, 905, 1765, 1348, 494, 1652,
+    680, 1684, 2028, 1562, 1990, 981, 122, 1972, 689, 193, 1682, 1379,
+    242, 1179, 1785, 1699, 1353, 495, 1447, 2024, 1690, 1783, 1532, 1795,
+    926, 1904, 369, 429, 556, 1619, 1649, 1039, 876, 430, 216, 1281,
+    1214, 1778, 1028, 256, 1473, 773, 1740, 1078, 1849, 537, 1579, 1587,
+    1297, 1937, 871, 197, 1368, 1669, 1725, 1382, 549, 1753, 510, 1258,
+    1184, 709, 1571, 1038, 1332, 1531, 420, 662, 15, 1128, 2036, 2023,
+    1645, 1007, 1456, 487, 330, 1475, 1628, 668, 1880, 461, 1189, 1903,
+    1598, 1526, 212, 1354, 1568, 230, 53, 1668, 266, 561, 526, 1049,
+    1091, 38, 1653, 1183, 10, 1822, 1277, 219, 304, 422, 146, 366,
+    515, 1605, 1012, 1344, 996, 882, 987, 1036,
    };
-#undef en
 
 static const struct words en_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words en_words = {
     true,
     (const char *)en_,
     0, /* Constant string */
-    en_i
+    NULL, /* Words are located by offset */
+    en_o,
+    0u,
+    en_d,
+    en_h
 };
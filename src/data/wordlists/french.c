@@ -2051,352 +2051,398 @@ static const unsigned char fr_[] = {
     0x7a,0x65,0x73,0x74,0x65,0,
     0x7a,0x6f,0x6f,0x6c,0x6f,0x67,0x69,0x65,0,
 };
-#define fr ((const char*)fr_)
-static const char *fr_i[] = {
-    fr+0, fr+9, fr+17, fr+26, fr+34, fr+41,
-    fr+49, fr+57, fr+64, fr+72, fr+81, fr+89,
-    fr+97, fr+104, fr+112, fr+119, fr+127, fr+134,
-    fr+142, fr+153, fr+160, fr+168, fr+177, fr+186,
-    fr+195, fr+204, fr+213, fr+221, fr+228, fr+234,
-    fr+242, fr+251, fr+257, fr+265, fr+276, fr+285,
-    fr+292, fr+298, fr+305, fr+312, fr+322, fr+332,
-    fr+341, fr+349, fr+358, fr+366, fr+374, fr+381,
-    fr+389, fr+397, fr+404, fr+411, fr+419, fr+427,
-    fr+437, fr+445, fr+454, fr+462, fr+470, fr+479,
-    fr+486, fr+494, fr+500, fr+507, fr+515, fr+526,
-    fr+533, fr+539, fr+548, fr+555, fr+563, fr+571,
-    fr+579, fr+587, fr+595, fr+604, fr+611, fr+621,
-    fr+627, fr+637, fr+645, fr+655, fr+663, fr+671,
-    fr+679, fr+688, fr+695, fr+703, fr+713, fr+721,
-    fr+728, fr+734, fr+745, fr+754, fr+761, fr+768,
-    fr+776, fr+782, fr+791, fr+800, fr+808, fr+816,
-    fr+824, fr+833, fr+842, fr+851, fr+858, fr+869,
-    fr+875, fr+884, fr+893, fr+900, fr+908, fr+916,
-    fr+923, fr+930, fr+939, fr+947, fr+955, fr+963,
-    fr+972, fr+980, fr+988, fr+999, fr+1007, fr+1016,
-    fr+1025, fr+1033, fr+1042, fr+1050, fr+1059, fr+1067,
-    fr+1075, fr+1083, fr+1090, fr+1098, fr+1105, fr+1114,
-    fr+1123, fr+1132, fr+1140, fr+1147, fr+1156, fr+1165,
-    fr+1173, fr+1181, fr+1189, fr+1200, fr+1208, fr+1215,
-    fr+1224, fr+1232, fr+1239, fr+1248, fr+1257, fr+1266,
-    fr+1274, fr+1282, fr+1288, fr+1295, fr+1303, fr+1309,
-    fr+1316, fr+1323, fr+1331, fr+1340, fr+1348, fr+1357,
-    fr+1365, fr+1373, fr+1380, fr+1388, fr+1396, fr+1403,
-    fr+1411, fr+1420, fr+1427, fr+1435, fr+1443, fr+1450,
-    fr+1457, fr+1465, fr+1474, fr+1480, fr+1486, fr+1493,
-    fr+1500, fr+1507, fr+1513, fr+1519, fr+1526, fr+1532,
-    fr+1540, fr+1547, fr+1556, fr+1565, fr+1574, fr+1581,
-    fr+1589, fr+1598, fr+1605, fr+1614, fr+1622, fr+1631,
-    fr+1642, fr+1651, fr+1659, fr+1665, fr+1671, fr+1678,
-    fr+1686, fr+1693, fr+1701, fr+1710, fr+1717, fr+1726,
-    fr+1735, fr+1744, fr+1752, fr+1761, fr+1768, fr+1781,
-    fr+1789, fr+1796, fr+1804, fr+1812, fr+1819, fr+1827,
-    fr+1836, fr+1843, fr+1851, fr+1859, fr+1866, fr+1872,
-    fr+1878, fr+1887, fr+1895, fr+1903, fr+1912, fr+1920,
-    fr+1928, fr+1936, fr+1942, fr+1951, fr+1958, fr+1966,
-    fr+1974, fr+1981, fr+1990, fr+1999, fr+2007, fr+2013,
-    fr+2021, fr+2029, fr+2036, fr+2043, fr+2049, fr+2056,
-    fr+2063, fr+2070, fr+2077, fr+2085, fr+2094, fr+2100,
-    fr+2108, fr+2114, fr+2120, fr+2127, fr+2134, fr+2141,
-    fr+2148, fr+2156, fr+2163, fr+2172, fr+2181, fr+2188,
-    fr+2196, fr+2204, fr+2210, fr+2217, fr+2226, fr+2235,
-    fr+2244, fr+2252, fr+2261, fr+2269, fr+2276, fr+2285,
-    fr+2292, fr+2300, fr+2308, fr+2316, fr+2322, fr+2330,
-    fr+2337, fr+2345, fr+2352, fr+2360, fr+2369, fr+2376,
-    fr+2382, fr+2390, fr+2398, fr+2405, fr+2413, fr+2421,
-    fr+2429, fr+2436, fr+2445, fr+2452, fr+2458, fr+2468,
-    fr+2476, fr+2484, fr+2493, fr+2501, fr+2509, fr+2516,
-    fr+2525, fr+2534, fr+2543, fr+2552, fr+2559, fr+2568,
-    fr+2574, fr+2582, fr+2588, fr+2596, fr+2604, fr+2612,
-    fr+2620, fr+2628, fr+2636, fr+2643, fr+2651, fr+2660,
-    fr+2668, fr+2677, fr+2685, fr+2693, fr+2701, fr+2709,
-    fr+2716, fr+2724, fr+2731, fr+2738, fr+2746, fr+2753,
-    fr+2761, fr+2770, fr+2778, fr+2785, fr+2795, fr+2804,
-    fr+2814, fr+2822, fr+2831, fr+2840, fr+2848, fr+2855,
-    fr+2868, fr+2875, fr+2882, fr+2890, fr+2897, fr+2905,
-    fr+2912, fr+2920, fr+2928, fr+2935, fr+2944, fr+2952,
-    fr+2961, fr+2968, fr+2977, fr+2986, fr+2994, fr+3003,
-    fr+3014, fr+3023, fr+3030, fr+3036, fr+3044, fr+3052,
-    fr+3062, fr+3068, fr+3077, fr+3086, fr+3094, fr+3100,
-    fr+3109, fr+3116, fr+3122, fr+3129, fr+3137, fr+3146,
-    fr+3155, fr+3163, fr+3172, fr+3178, fr+3185, fr+3193,
-    fr+3201, fr+3208, fr+3214, fr+3222, fr+3230, fr+3238,
-    fr+3245, fr+3253, fr+3260, fr+3268, fr+3275, fr+3283,
-    fr+3290, fr+3298, fr+3307, fr+3314, fr+3320, fr+3328,
-    fr+3337, fr+3343, fr+3352, fr+3359, fr+3366, fr+3377,
-    fr+3385, fr+3393, fr+3402, fr+3410, fr+3418, fr+3427,
-    fr+3435, fr+3442, fr+3452, fr+3461, fr+3469, fr+3477,
-    fr+3486, fr+3494, fr+3503, fr+3512, fr+3521, fr+3529,
-    fr+3537, fr+3544, fr+3550, fr+3557, fr+3565, fr+3573,
-    fr+3582, fr+3589, fr+3597, fr+3607, fr+3616, fr+3624,
-    fr+3630, fr+3636, fr+3644, fr+3652, fr+3660, fr+3668,
-    fr+3675, fr+3681, fr+3689, fr+3697, fr+3704, fr+3715,
-    fr+3726, fr+3736, fr+3744, fr+3753, fr+3761, fr+3767,
-    fr+3775, fr+3785, fr+3792, fr+3800, fr+3808, fr+3816,
-    fr+3822, fr+3830, fr+3838, fr+3847, fr+3858, fr+3866,
-    fr+3873, fr+3882, fr+3891, fr+3899, fr+3906, fr+3914,
-    fr+3922, fr+3930, fr+3936, fr+3945, fr+3953, fr+3961,
-    fr+3968, fr+3975, fr+3983, fr+3991, fr+4002, fr+4012,
-    fr+4023, fr+4034, fr+4045, fr+4055, fr+4066, fr+4077,
-    fr+4087, fr+4098, fr+4108, fr+4118, fr+4129, fr+4138,
-    fr+4149, fr+4158, fr+4169, fr+4179, fr+4190, fr+4200,
-    fr+4211, fr+4222, fr+4233, fr+4244, fr+4253, fr+4263,
-    fr+4272, fr+4281, fr+4291, fr+4302, fr+4312, fr+4321,
-    fr+4331, fr+4340, fr+4351, fr+4362, fr+4373, fr+4383,
-    fr+4394, fr+4404, fr+4415, fr+4424, fr+4433, fr+4444,
-    fr+4457, fr+4466, fr+4475, fr+4486, fr+4497, fr+4508,
-    fr+4519, fr+4528, fr+4536, fr+4544, fr+4551, fr+4558,
-    fr+4567, fr+4575, fr+4582, fr+4593, fr+4603, fr+4611,
-    fr+4617, fr+4624, fr+4633, fr+4642, fr+4650, fr+4659,
-    fr+4667, fr+4676, fr+4685, fr+4694, fr+4703, fr+4712,
-    fr+4720, fr+4727, fr+4735, fr+4741, fr+4747, fr+4755,
-    fr+4764, fr+4772, fr+4781, fr+4788, fr+4795, fr+4804,
-    fr+4812, fr+4819, fr+4826, fr+4833, fr+4841, fr+4850,
-    fr+4859, fr+4866, fr+4874, fr+4881, fr+4887, fr+4894,
-    fr+4901, fr+4909, fr+4918, fr+4927, fr+4935, fr+4943,
-    fr+4951, fr+4958, fr+4967, fr+4977, fr+4987, fr+4997,
-    fr+5007, fr+5018, fr+5028, fr+5037, fr+5046, fr+5054,
-    fr+5065, fr+5074, fr+5084, fr+5094, fr+5106, fr+5117,
-    fr+5125, fr+5133, fr+5144, fr+5154, fr+5164, fr+5172,
-    fr+5181, fr+5189, fr+5196, fr+5205, fr+5214, fr+5225,
-    fr+5234, fr+5244, fr+5255, fr+5265, fr+5276, fr+5288,
-    fr+5301, fr+5311, fr+5322, fr+5333, fr+5341, fr+5352,
-    fr+5361, fr+5370, fr+5379, fr+5387, fr+5398, fr+5409,
-    fr+5417, fr+5427, fr+5438, fr+5447, fr+5456, fr+5465,
-    fr+5473, fr+5484, fr+5493, fr+5503, fr+5511, fr+5519,
-    fr+5528, fr+5537, fr+5545, fr+5553, fr+5563, fr+5571,
-    fr+5580, fr+5588, fr+5596, fr+5602, fr+5611, fr+5620,
-    fr+5629, fr+5635, fr+5643, fr+5650, fr+5659, fr+5668,
-    fr+5677, fr+5686, fr+5695, fr+5704, fr+5711, fr+5720,
-    fr+5729, fr+5742, fr+5750, fr+5759, fr+5767, fr+5774,
-    fr+5783, fr+5794, fr+5804, fr+5814, fr+5823, fr+5834,
-    fr+5847, fr+5855, fr+5866, fr+5874, fr+5884, fr+5895,
-    fr+5904, fr+5914, fr+5925, fr+5936, fr+5946, fr+5955,
-    fr+5964, fr+5974, fr+5981, fr+5992, fr+6001, fr+6009,
-    fr+6018, fr+6029, fr+6036, fr+6043, fr+6052, fr+6060,
-    fr+6068, fr+6075, fr+6083, fr+6090, fr+6098, fr+6106,
-    fr+6118, fr+6127, fr+6137, fr+6148, fr+6159, fr+6170,
-    fr+6180, fr+6190, fr+6200, fr+6207, fr+6216, fr+6226,
-    fr+6235, fr+6246, fr+6257, fr+6267, fr+6276, fr+6284,
-    fr+6293, fr+6303, fr+6313, fr+6324, fr+6335, fr+6344,
-    fr+6355, fr+6365, fr+6371, fr+6382, fr+6390, fr+6399,
-    fr+6408, fr+6417, fr+6424, fr+6435, fr+6443, fr+6451,
-    fr+6459, fr+6468, fr+6477, fr+6484, fr+6492, fr+6501,
-    fr+6512, fr+6521, fr+6529, fr+6538, fr+6545, fr+6554,
-    fr+6563, fr+6571, fr+6577, fr+6586, fr+6594, fr+6601,
-    fr+6609, fr+6617, fr+6625, fr+6632, fr+6640, fr+6648,
-    fr+6656, fr+6663, fr+6672, fr+6681, fr+6687, fr+6695,
-    fr+6702, fr+6709, fr+6716, fr+6723, fr+6733, fr+6744,
-    fr+6756, fr+6764, fr+6770, fr+6778, fr+6786, fr+6795,
-    fr+6802, fr+6811, fr+6819, fr+6828, fr+6836, fr+6843,
-    fr+6853, fr+6860, fr+6868, fr+6875, fr+6884, fr+6891,
-    fr+6900, fr+6909, fr+6919, fr+6927, fr+6934, fr+6940,
-    fr+6948, fr+6957, fr+6963, fr+6969, fr+6975, fr+6983,
-    fr+6989, fr+6997, fr+7004, fr+7012, fr+7021, fr+7029,
-    fr+7038, fr+7044, fr+7052, fr+7059, fr+7065, fr+7074,
-    fr+7081, fr+7089, fr+7095, fr+7104, fr+7113, fr+7122,
-    fr+7129, fr+7138, fr+7147, fr+7155, fr+7163, fr+7170,
-    fr+7180, fr+7189, fr+7197, fr+7204, fr+7212, fr+7219,
-    fr+7228, fr+7236, fr+7244, fr+7254, fr+7262, fr+7269,
-    fr+7278, fr+7291, fr+7299, fr+7307, fr+7316, fr+7324,
-    fr+7332, fr+7338, fr+7346, fr+7354, fr+7362, fr+7368,
-    fr+7376, fr+7382, fr+7389, fr+7397, fr+7404, fr+7411,
-    fr+7417, fr+7424, fr+7432, fr+7440, fr+7449, fr+7458,
-    fr+7466, fr+7473, fr+7482, fr+7490, fr+7496, fr+7504,
-    fr+7515, fr+7524, fr+7533, fr+7545, fr+7553, fr+7559,
-    fr+7566, fr+7577, fr+7590, fr+7601, fr+7607, fr+7615,
-    fr+7622, fr+7629, fr+7636, fr+7643, fr+7649, fr+7655,
-    fr+7662, fr+7670, fr+7676, fr+7683, fr+7692, fr+7700,
-    fr+7706, fr+7714, fr+7720, fr+7728, fr+7736, fr+7744,
-    fr+7751, fr+7760, fr+7769, fr+7776, fr+7784, fr+7793,
-    fr+7800, fr+7806, fr+7814, fr+7822, fr+7829, fr+7836,
-    fr+7845, fr+7853, fr+7861, fr+7869, fr+7877, fr+7884,
-    fr+7891, fr+7898, fr+7906, fr+7916, fr+7926, fr+7935,
-    fr+7941, fr+7950, fr+7958, fr+7967, fr+7976, fr+7985,
-    fr+7994, fr+8002, fr+8008, fr+8015, fr+8022, fr+8031,
-    fr+8039, fr+8048, fr+8055, fr+8062, fr+8071, fr+8082,
-    fr+8088, fr+8099, fr+8107, fr+8115, fr+8125, fr+8133,
-    fr+8142, fr+8148, fr+8157, fr+8166, fr+8172, fr+8179,
-    fr+8187, fr+8198, fr+8206, fr+8214, fr+8222, fr+8228,
-    fr+8236, fr+8244, fr+8252, fr+8261, fr+8269, fr+8276,
-    fr+8283, fr+8291, fr+8298, fr+8305, fr+8312, fr+8319,
-    fr+8326, fr+8335, fr+8345, fr+8351, fr+8359, fr+8366,
-    fr+8374, fr+8381, fr+8390, fr+8399, fr+8405, fr+8413,
-    fr+8420, fr+8428, fr+8437, fr+8446, fr+8453, fr+8464,
-    fr+8473, fr+8481, fr+8490, fr+8498, fr+8507, fr+8516,
-    fr+8525, fr+8534, fr+8543, fr+8551, fr+8558, fr+8567,
-    fr+8576, fr+8584, fr+8592, fr+8599, fr+8608, fr+8617,
-    fr+8626, fr+8636, fr+8644, fr+8652, fr+8661, fr+8668,
-    fr+8677, fr+8686, fr+8694, fr+8703, fr+8711, fr+8719,
-    fr+8728, fr+8737, fr+8746, fr+8755, fr+8762, fr+8770,
-    fr+8777, fr+8786, fr+8795, fr+8803, fr+8812, fr+8821,
-    fr+8829, fr+8838, fr+8847, fr+8856, fr+8865, fr+8873,
-    fr+8880, fr+8887, fr+8895, fr+8902, fr+8910, fr+8916,
-    fr+8924, fr+8931, fr+8938, fr+8944, fr+8952, fr+8960,
-    fr+8966, fr+8972, fr+8981, fr+8989, fr+8997, fr+9005,
-    fr+9012, fr+9021, fr+9029, fr+9036, fr+9042, fr+9049,
-    fr+9057, fr+9066, fr+9073, fr+9079, fr+9087, fr+9095,
-    fr+9102, fr+9113, fr+9119, fr+9126, fr+9134, fr+9140,
-    fr+9147, fr+9156, fr+9166, fr+9174, fr+9181, fr+9187,
-    fr+9195, fr+9203, fr+9211, fr+9219, fr+9225, fr+9233,
-    fr+9241, fr+9250, fr+9256, fr+9264, fr+9270, fr+9278,
-    fr+9285, fr+9292, fr+9300, fr+9308, fr+9316, fr+9325,
-    fr+9333, fr+9340, fr+9347, fr+9355, fr+9364, fr+9371,
-    fr+9381, fr+9387, fr+9395, fr+9403, fr+9411, fr+9420,
-    fr+9429, fr+9437, fr+9443, fr+9449, fr+9456, fr+9465,
-    fr+9473, fr+9484, fr+9491, fr+9500, fr+9508, fr+9518,
-    fr+9525, fr+9533, fr+9540, fr+9549, fr+9557, fr+9565,
-    fr+9574, fr+9581, fr+9589, fr+9597, fr+9603, fr+9609,
-    fr+9616, fr+9622, fr+9628, fr+9634, fr+9641, fr+9650,
-    fr+9656, fr+9664, fr+9672, fr+9682, fr+9690, fr+9696,
-    fr+9702, fr+9709, fr+9717, fr+9725, fr+9733, fr+9741,
-    fr+9749, fr+9756, fr+9764, fr+9773, fr+9780, fr+9787,
-    fr+9795, fr+9803, fr+9814, fr+9822, fr+9829, fr+9838,
-    fr+9847, fr+9856, fr+9865, fr+9874, fr+9882, fr+9889,
-    fr+9898, fr+9905, fr+9914, fr+9920, fr+9929, fr+9938,
-    fr+9945, fr+9954, fr+9963, fr+9970, fr+9981, fr+9991,
-    fr+10000, fr+10008, fr+10017, fr+10023, fr+10031, fr+10041,
-    fr+10051, fr+10062, fr+10072, fr+10082, fr+10091, fr+10100,
-    fr+10110, fr+10120, fr+10127, fr+10137, fr+10145, fr+10151,
-    fr+10158, fr+10167, fr+10174, fr+10183, fr+10192, fr+10198,
-    fr+10207, fr+10214, fr+10222, fr+10234, fr+10244, fr+10253,
-    fr+10260, fr+10268, fr+10276, fr+10283, fr+10290, fr+10297,
-    fr+10304, fr+10312, fr+10320, fr+10326, fr+10336, fr+10344,
-    fr+10352, fr+10359, fr+10367, fr+10376, fr+10384, fr+10390,
-    fr+10397, fr+10405, fr+10414, fr+10422, fr+10431, fr+10439,
-    fr+10448, fr+10456, fr+10465, fr+10474, fr+10482, fr+10490,
-    fr+10498, fr+10506, fr+10513, fr+10519, fr+10526, fr+10533,
-    fr+10540, fr+10548, fr+10555, fr+10563, fr+10572, fr+10581,
-    fr+10590, fr+10599, fr+10607, fr+10614, fr+10623, fr+10632,
-    fr+10641, fr+10647, fr+10654, fr+10662, fr+10671, fr+10681,
-    fr+10690, fr+10697, fr+10703, fr+10712, fr+10719, fr+10728,
-    fr+10735, fr+10742, fr+10751, fr+10760, fr+10767, fr+10778,
-    fr+10785, fr+10795, fr+10806, fr+10817, fr+10828, fr+10834,
-    fr+10842, fr+10851, fr+10859, fr+10867, fr+10873, fr+10879,
-    fr+10886, fr+10894, fr+10901, fr+10907, fr+10913, fr+10922,
-    fr+10931, fr+10940, fr+10947, fr+10956, fr+10963, fr+10972,
-    fr+10980, fr+10989, fr+10997, fr+11005, fr+11013, fr+11022,
-    fr+11031, fr+11038, fr+11044, fr+11052, fr+11058, fr+11067,
-    fr+11076, fr+11084, fr+11090, fr+11099, fr+11107, fr+11116,
-    fr+11124, fr+11131, fr+11140, fr+11149, fr+11157, fr+11165,
-    fr+11174, fr+11182, fr+11190, fr+11198, fr+11207, fr+11216,
-    fr+11225, fr+11231, fr+11239, fr+11248, fr+11257, fr+11264,
-    fr+11270, fr+11277, fr+11286, fr+11295, fr+11303, fr+11311,
-    fr+11319, fr+11328, fr+11336, fr+11346, fr+11355, fr+11361,
-    fr+11368, fr+11377, fr+11385, fr+11394, fr+11403, fr+11409,
-    fr+11417, fr+11425, fr+11432, fr+11439, fr+11448, fr+11456,
-    fr+11463, fr+11471, fr+11479, fr+11488, fr+11494, fr+11500,
-    fr+11509, fr+11516, fr+11525, fr+11532, fr+11540, fr+11547,
-    fr+11553, fr+11562, fr+11570, fr+11578, fr+11584, fr+11594,
-    fr+11600, fr+11609, fr+11616, fr+11627, fr+11636, fr+11643,
-    fr+11651, fr+11657, fr+11666, fr+11675, fr+11683, fr+11692,
-    fr+11701, fr+11708, fr+11715, fr+11723, fr+11731, fr+11740,
-    fr+11749, fr+11757, fr+11766, fr+11773, fr+11780, fr+11788,
-    fr+11797, fr+11806, fr+11813, fr+11822, fr+11830, fr+11841,
-    fr+11850, fr+11859, fr+11866, fr+11875, fr+11884, fr+11890,
-    fr+11898, fr+11905, fr+11913, fr+11920, fr+11930, fr+11936,
-    fr+11944, fr+11952, fr+11960, fr+11973, fr+11983, fr+11990,
-    fr+12000, fr+12009, fr+12018, fr+12026, fr+12035, fr+12045,
-    fr+12054, fr+12063, fr+12070, fr+12076, fr+12082, fr+12091,
-    fr+12097, fr+12106, fr+12113, fr+12121, fr+12128, fr+12135,
-    fr+12142, fr+12149, fr+12158, fr+12164, fr+12173, fr+12181,
-    fr+12188, fr+12196, fr+12203, fr+12211, fr+12219, fr+12226,
-    fr+12234, fr+12242, fr+12249, fr+12257, fr+12263, fr+12269,
-    fr+12277, fr+12285, fr+12293, fr+12300, fr+12307, fr+12316,
-    fr+12324, fr+12332, fr+12339, fr+12346, fr+12352, fr+12360,
-    fr+12366, fr+12374, fr+12383, fr+12392, fr+12400, fr+12407,
-    fr+12415, fr+12423, fr+12430, fr+12438, fr+12447, fr+12454,
-    fr+12463, fr+12471, fr+12479, fr+12488, fr+12499, fr+12505,
-    fr+12514, fr+12523, fr+12534, fr+12542, fr+12550, fr+12557,
-    fr+12564, fr+12570, fr+12578, fr+12585, fr+12593, fr+12601,
-    fr+12609, fr+12617, fr+12626, fr+12637, fr+12647, fr+12657,
-    fr+12667, fr+12676, fr+12687, fr+12698, fr+12708, fr+12717,
-    fr+12724, fr+12731, fr+12738, fr+12749, fr+12760, fr+12768,
-    fr+12776, fr+12786, fr+12792, fr+12801, fr+12810, fr+12819,
-    fr+12826, fr+12837, fr+12848, fr+12857, fr+12866, fr+12875,
-    fr+12883, fr+12892, fr+12899, fr+12907, fr+12914, fr+12920,
-    fr+12927, fr+12935, fr+12943, fr+12951, fr+12960, fr+12967,
-    fr+12976, fr+12983, fr+12992, fr+13001, fr+13012, fr+13020,
-    fr+13029, fr+13036, fr+13045, fr+13053, fr+13062, fr+13070,
-    fr+13077, fr+13086, fr+13095, fr+13104, fr+13111, fr+13118,
-    fr+13127, fr+13135, fr+13141, fr+13150, fr+13160, fr+13169,
-    fr+13180, fr+13191, fr+13200, fr+13210, fr+13221, fr+13232,
-    fr+13241, fr+13249, fr+13258, fr+13268, fr+13277, fr+13285,
-    fr+13295, fr+13306, fr+13314, fr+13321, fr+13332, fr+13341,
-    fr+13351, fr+13362, fr+13375, fr+13383, fr+13391, fr+13399,
-    fr+13407, fr+13414, fr+13423, fr+13432, fr+13439, fr+13448,
-    fr+13456, fr+13463, fr+13470, fr+13478, fr+13487, fr+13496,
-    fr+13504, fr+13511, fr+13519, fr+13528, fr+13536, fr+13544,
-    fr+13551, fr+13561, fr+13572, fr+13583, fr+13591, fr+13598,
-    fr+13609, fr+13620, fr+13628, fr+13639, fr+13648, fr+13657,
-    fr+13667, fr+13677, fr+13686, fr+13694, fr+13704, fr+13715,
-    fr+13724, fr+13731, fr+13737, fr+13744, fr+13752, fr+13759,
-    fr+13768, fr+13776, fr+13783, fr+13790, fr+13796, fr+13806,
-    fr+13814, fr+13822, fr+13829, fr+13835, fr+13842, fr+13849,
-    fr+13856, fr+13864, fr+13870, fr+13877, fr+13883, fr+13891,
-    fr+13899, fr+13907, fr+13915, fr+13921, fr+13927, fr+13933,
-    fr+13940, fr+13948, fr+13955, fr+13964, fr+13970, fr+13979,
-    fr+13986, fr+13993, fr+14001, fr+14007, fr+14015, fr+14022,
-    fr+14030, fr+14037, fr+14044, fr+14051, fr+14057, fr+14064,
-    fr+14071, fr+14080, fr+14089, fr+14098, fr+14106, fr+14114,
-    fr+14123, fr+14130, fr+14137, fr+14145, fr+14152, fr+14161,
-    fr+14169, fr+14178, fr+14191, fr+14202, fr+14210, fr+14219,
-    fr+14227, fr+14235, fr+14241, fr+14249, fr+14258, fr+14267,
-    fr+14277, fr+14286, fr+14294, fr+14307, fr+14317, fr+14327,
-    fr+14336, fr+14345, fr+14356, fr+14364, fr+14372, fr+14380,
-    fr+14390, fr+14401, fr+14410, fr+14419, fr+14429, fr+14440,
-    fr+14447, fr+14455, fr+14465, fr+14473, fr+14481, fr+14489,
-    fr+14498, fr+14506, fr+14514, fr+14523, fr+14533, fr+14542,
-    fr+14551, fr+14559, fr+14565, fr+14572, fr+14580, fr+14589,
-    fr+14596, fr+14606, fr+14615, fr+14622, fr+14628, fr+14637,
-    fr+14644, fr+14650, fr+14657, fr+14663, fr+14670, fr+14679,
-    fr+14686, fr+14693, fr+14702, fr+14710, fr+14717, fr+14725,
-    fr+14734, fr+14740, fr+14748, fr+14757, fr+14764, fr+14772,
-    fr+14779, fr+14785, fr+14793, fr+14802, fr+14810, fr+14818,
-    fr+14827, fr+14835, fr+14842, fr+14851, fr+14860, fr+14869,
-    fr+14877, fr+14887, fr+14896, fr+14903, fr+14910, fr+14918,
-    fr+14926, fr+14935, fr+14944, fr+14951, fr+14960, fr+14968,
-    fr+14977, fr+14985, fr+14994, fr+15001, fr+15010, fr+15019,
-    fr+15025, fr+15033, fr+15044, fr+15052, fr+15060, fr+15068,
-    fr+15077, fr+15085, fr+15094, fr+15103, fr+15112, fr+15120,
-    fr+15127, fr+15135, fr+15143, fr+15151, fr+15162, fr+15170,
-    fr+15178, fr+15188, fr+15194, fr+15202, fr+15210, fr+15218,
-    fr+15225, fr+15234, fr+15243, fr+15251, fr+15259, fr+15268,
-    fr+15274, fr+15283, fr+15290, fr+15296, fr+15304, fr+15310,
-    fr+15317, fr+15326, fr+15332, fr+15340, fr+15346, fr+15355,
-    fr+15364, fr+15373, fr+15380, fr+15387, fr+15393, fr+15401,
-    fr+15410, fr+15416, fr+15425, fr+15434, fr+15440, fr+15448,
-    fr+15458, fr+15469, fr+15476, fr+15482, fr+15490, fr+15497,
-    fr+15506, fr+15513, fr+15519, fr+15526, fr+15532, fr+15540,
-    fr+15549, fr+15560, fr+15567, fr+15575, fr+15583, fr+15592,
-    fr+15599, fr+15606, fr+15614, fr+15623, fr+15631, fr+15637,
-    fr+15644, fr+15650, fr+15658, fr+15667, fr+15675, fr+15682,
-    fr+15691, fr+15698, fr+15707, fr+15714, fr+15720, fr+15729,
-    fr+15737, fr+15746, fr+15754, fr+15763, fr+15770, fr+15777,
-    fr+15786, fr+15795, fr+15804, fr+15813, fr+15821, fr+15830,
-    fr+15838, fr+15847, fr+15853, fr+15862, fr+15871, fr+15877,
-    fr+15884, fr+15892, fr+15899, fr+15907, fr+15914, fr+15922,
-    fr+15928, fr+15935, fr+15942, fr+15950, fr+15956, fr+15965,
-    fr+15972, fr+15981, fr+15989, fr+15997, fr+16003, fr+16010,
-    fr+16019, fr+16027, fr+16035, fr+16042, fr+16051, fr+16057,
-    fr+16063, fr+16069, fr+16075, fr+16081, fr+16088, fr+16096,
-    fr+16103, fr+16112, fr+16118, fr+16127, fr+16135, fr+16144,
-    fr+16152, fr+16159, fr+16166, fr+16172, fr+16180, fr+16188,
-    fr+16195, fr+16202, fr+16209, fr+16216, fr+16222, fr+16230,
-    fr+16238, fr+16250, fr+16261, fr+16269, fr+16278, fr+16287,
-    fr+16299, fr+16306, fr+16315, fr+16324, fr+16332, fr+16340,
-    fr+16347, fr+16354, fr+16361, fr+16367, fr+16374, fr+16386,
-    fr+16396, fr+16403, fr+16409, fr+16416, fr+16423, fr+16432,
-    fr+16440, fr+16448, fr+16457, fr+16465, fr+16472, fr+16480,
-    fr+16489, fr+16496, fr+16505, fr+16514, fr+16523, fr+16529,
-    fr+16536, fr+16543, fr+16550, fr+16559, fr+16566, fr+16572,
-    fr+16580, fr+16589, fr+16597, fr+16604, fr+16613, fr+16622,
-    fr+16629, fr+16635, fr+16642, fr+16650, fr+16659, fr+16666,
-    fr+16675, fr+16682, fr+16689, fr+16696, fr+16702, fr+16710,
-    fr+16717, fr+16725, fr+16731, fr+16739, fr+16745, fr+16753,
-    fr+16762, fr+16768, fr+16777,
+static const uint16_t fr_o[] = {
+    0, 9, 17, 26, 34, 41, 49, 57, 64, 72, 81, 89,
+    97, 104, 112, 119, 127, 134, 142, 153, 160, 168, 177, 186,
+    195, 204, 213, 221, 228, 234, 242, 251, 257, 265, 276, 285,
+    292, 298, 305, 312, 322, 332, 341, 349, 358, 366, 374, 381,
+    389, 397, 404, 411, 419, 427, 437, 445, 454, 462, 470, 479,
+    486, 494, 500, 507, 515, 526, 533, 539, 548, 555, 563, 571,
+    579, 587, 595, 604, 611, 621, 627, 637, 645, 655, 663, 671,
+    679, 688, 695, 703, 713, 721, 728, 734, 745, 754, 761, 768,
+    776, 782, 791, 800, 808, 816, 824, 833, 842, 851, 858, 869,
+    875, 884, 893, 900, 908, 916, 923, 930, 939, 947, 955, 963,
+    972, 980, 988, 999, 1007, 1016, 1025, 1033, 1042, 1050, 1059, 1067,
+    1075, 1083, 1090, 1098, 1105, 1114, 1123, 1132, 1140, 1147, 1156, 1165,
+    1173, 1181, 1189, 1200, 1208, 1215, 1224, 1232, 1239, 1248, 1257, 1266,
+    1274, 1282, 1288, 1295, 1303, 1309, 1316, 1323, 1331, 1340, 1348, 1357,
+    1365, 1373, 1380, 1388, 1396, 1403, 1411, 1420, 1427, 1435, 1443, 1450,
+    1457, 1465, 1474, 1480, 1486, 1493, 1500, 1507, 1513, 1519, 1526, 1532,
+    1540, 1547, 1556, 1565, 1574, 1581, 1589, 1598, 1605, 1614, 1622, 1631,
+    1642, 1651, 1659, 1665, 1671, 1678, 1686, 1693, 1701, 1710, 1717, 1726,
+    1735, 1744, 1752, 1761, 1768, 1781, 1789, 1796, 1804, 1812, 1819, 1827,
+    1836, 1843, 1851, 1859, 1866, 1872, 1878, 1887, 1895, 1903, 1912, 1920,
+    1928, 1936, 1942, 1951, 1958, 1966, 1974, 1981, 1990, 1999, 2007, 2013,
+    2021, 2029, 2036, 2043, 2049, 2056, 2063, 2070, 2077, 2085, 2094, 2100,
+    2108, 2114, 2120, 2127, 2134, 2141, 2148, 2156, 2163, 2172, 2181, 2188,
+    2196, 2204, 2210, 2217, 2226, 2235, 2244, 2252, 2261, 2269, 2276, 2285,
+    2292, 2300, 2308, 2316, 2322, 2330, 2337, 2345, 2352, 2360, 2369, 2376,
+    2382, 2390, 2398, 2405, 2413, 2421, 2429, 2436, 2445, 2452, 2458, 2468,
+    2476, 2484, 2493, 2501, 2509, 2516, 2525, 2534, 2543, 2552, 2559, 2568,
+    2574, 2582, 2588, 2596, 2604, 2612, 2620, 2628, 2636, 2643, 2651, 2660,
+    2668, 2677, 2685, 2693, 2701, 2709, 2716, 2724, 2731, 2738, 2746, 2753,
+    2761, 2770, 2778, 2785, 2795, 2804, 2814, 2822, 2831, 2840, 2848, 2855,
+    2868, 2875, 2882, 2890, 2897, 2905, 2912, 2920, 2928, 2935, 2944, 2952,
+    2961, 2968, 2977, 2986, 2994, 3003, 3014, 3023, 3030, 3036, 3044, 3052,
+    3062, 3068, 3077, 3086, 3094, 3100, 3109, 3116, 3122, 3129, 3137, 3146,
+    3155, 3163, 3172, 3178, 3185, 3193, 3201, 3208, 3214, 3222, 3230, 3238,
+    3245, 3253, 3260, 3268, 3275, 3283, 3290, 3298, 3307, 3314, 3320, 3328,
+    3337, 3343, 3352, 3359, 3366, 3377, 3385, 3393, 3402, 3410, 3418, 3427,
+    3435, 3442, 3452, 3461, 3469, 3477, 3486, 3494, 3503, 3512, 3521, 3529,
+    3537, 3544, 3550, 3557, 3565, 3573, 3582, 3589, 3597, 3607, 3616, 3624,
+    3630, 3636, 3644, 3652, 3660, 3668, 3675, 3681, 3689, 3697, 3704, 3715,
+    3726, 3736, 3744, 3753, 3761, 3767, 3775, 3785, 3792, 3800, 3808, 3816,
+    3822, 3830, 3838, 3847, 3858, 3866, 3873, 3882, 3891, 3899, 3906, 3914,
+    3922, 3930, 3936, 3945, 3953, 3961, 3968, 3975, 3983, 3991, 4002, 4012,
+    4023, 4034, 4045, 4055, 4066, 4077, 4087, 4098, 4108, 4118, 4129, 4138,
+    4149, 4158, 4169, 4179, 4190, 4200, 4211, 4222, 4233, 4244, 4253, 4263,
+    4272, 4281, 4291, 4302, 4312, 4321, 4331, 4340, 4351, 4362, 4373, 4383,
+    4394, 4404, 4415, 4424, 4433, 4444, 4457, 4466, 4475, 4486, 4497, 4508,
+    4519, 4528, 4536, 4544, 4551, 4558, 4567, 4575, 4582, 4593, 4603, 4611,
+    4617, 4624, 4633, 4642, 4650, 4659, 4667, 4676, 4685, 4694, 4703, 4712,
+    4720, 4727, 4735, 4741, 4747, 4755, 4764, 4772, 4781, 4788, 4795, 4804,
+    4812, 4819, 4826, 4833, 4841, 4850, 4859, 4866, 4874, 4881, 4887, 4894,
+    4901, 4909, 4918, 4927, 4935, 4943, 4951, 4958, 4967, 4977, 4987, 4997,
+    5007, 5018, 5028, 5037, 5046, 5054, 5065, 5074, 5084, 5094, 5106, 5117,
+    5125, 5133, 5144, 5154, 5164, 5172, 5181, 5189, 5196, 5205, 5214, 5225,
+    5234, 5244, 5255, 5265, 5276, 5288, 5301, 5311, 5322, 5333, 5341, 5352,
+    5361, 5370, 5379, 5387, 5398, 5409, 5417, 5427, 5438, 5447, 5456, 5465,
+    5473, 5484, 5493, 5503, 5511, 5519, 5528, 5537, 5545, 5553, 5563, 5571,
+    5580, 5588, 5596, 5602, 5611, 5620, 5629, 5635, 5643, 5650, 5659, 5668,
+    5677, 5686, 5695, 5704, 5711, 5720, 5729, 5742, 5750, 5759, 5767, 5774,
+    5783, 5794, 5804, 5814, 5823, 5834, 5847, 5855, 5866, 5874, 5884, 5895,
+    5904, 5914, 5925, 5936, 5946, 5955, 5964, 5974, 5981, 5992, 6001, 6009,
+    6018, 6029, 6036, 6043, 6052, 6060, 6068, 6075, 6083, 6090, 6098, 6106,
+    6118, 6127, 6137, 6148, 6159, 6170, 6180, 6190, 6200, 6207, 6216, 6226,
+    6235, 6246, 6257, 6267, 6276, 6284, 6293, 6303, 6313, 6324, 6335, 6344,
+    6355, 6365, 6371, 6382, 6390, 6399, 6408, 6417, 6424, 6435, 6443, 6451,
+    6459, 6468, 6477, 6484, 6492, 6501, 6512, 6521, 6529, 6538, 6545, 6554,
+    6563, 6571, 6577, 6586, 6594, 6601, 6609, 6617, 6625, 6632, 6640, 6648,
+    6656, 6663, 6672, 6681, 6687, 6695, 6702, 6709, 6716, 6723, 6733, 6744,
+    6756, 6764, 6770, 6778, 6786, 6795, 6802, 6811, 6819, 6828, 6836, 6843,
+    6853, 6860, 6868, 6875, 6884, 6891, 6900, 6909, 6919, 6927, 6934, 6940,
+    6948, 6957, 6963, 6969, 6975, 6983, 6989, 6997, 7004, 7012, 7021, 7029,
+    7038, 7044, 7052, 7059, 7065, 7074, 7081, 7089, 7095, 7104, 7113, 7122,
+    7129, 7138, 7147, 7155, 7163, 7170, 7180, 7189, 7197, 7204, 7212, 7219,
+    7228, 7236, 7244, 7254, 7262, 7269, 7278, 7291, 7299, 7307, 7316, 7324,
+    7332, 7338, 7346, 7354, 7362, 7368, 7376, 7382, 7389, 7397, 7404, 7411,
+    7417, 7424, 7432, 7440, 7449, 7458, 7466, 7473, 7482, 7490, 7496, 7504,
+    7515, 7524, 7533, 7545, 7553, 7559, 7566, 7577, 7590, 7601, 7607, 7615,
+    7622, 7629, 7636, 7643, 7649, 7655, 7662, 7670, 7676, 7683, 7692, 7700,
+    7706, 7714, 7720, 7728, 7736, 7744, 7751, 7760, 7769, 7776, 7784, 7793,
+    7800, 7806, 7814, 7822, 7829, 7836, 7845, 7853, 7861, 7869, 7877, 7884,
+    7891, 7898, 7906, 7916, 7926, 7935, 7941, 7950, 7958, 7967, 7976, 7985,
+    7994, 8002, 8008, 8015, 8022, 8031, 8039, 8048, 8055, 8062, 8071, 8082,
+    8088, 8099, 8107, 8115, 8125, 8133, 8142, 8148, 8157, 8166, 8172, 8179,
+    8187, 8198, 8206, 8214, 8222, 8228, 8236, 8244, 8252, 8261, 8269, 8276,
+    8283, 8291, 8298, 8305, 8312, 8319, 8326, 8335, 8345, 8351, 8359, 8366,
+    8374, 8381, 8390, 8399, 8405, 8413, 8420, 8428, 8437, 8446, 8453, 8464,
+    8473, 8481, 8490, 8498, 8507, 8516, 8525, 8534, 8543, 8551, 8558, 8567,
+    8576, 8584, 8592, 8599, 8608, 8617, 8626, 8636, 8644, 8652, 8661, 8668,
+    8677, 8686, 8694, 8703, 8711, 8719, 8728, 8737, 8746, 8755, 8762, 8770,
+    8777, 8786, 8795, 8803, 8812, 8821, 8829, 8838, 8847, 8856, 8865, 8873,
+    8880, 8887, 8895, 8902, 8910, 8916, 8924, 8931, 8938, 8944, 8952, 8960,
+    8966, 8972, 8981, 8989, 8997, 9005, 9012, 9021, 9029, 9036, 9042, 9049,
+    9057, 9066, 9073, 9079, 9087, 9095, 9102, 9113, 9119, 9126, 9134, 9140,
+    9147, 9156, 9166, 9174, 9181, 9187, 9195, 9203, 9211, 9219, 9225, 9233,
+    9241, 9250, 9256, 9264, 9270, 9278, 9285, 9292, 9300, 9308, 9316, 9325,
+    9333, 9340, 9347, 9355, 9364, 9371, 9381, 9387, 9395, 9403, 9411, 9420,
+    9429, 9437, 9443, 9449, 9456, 9465, 9473, 9484, 9491, 9500, 9508, 9518,
+    9525, 9533, 9540, 9549, 9557, 9565, 9574, 9581, 9589, 9597, 9603, 9609,
+    9616, 9622, 9628, 9634, 9641, 9650, 9656, 9664, 9672, 9682, 9690, 9696,
+    9702, 9709, 9717, 9725, 9733, 9741, 9749, 9756, 9764, 9773, 9780, 9787,
+    9795, 9803, 9814, 9822, 9829, 9838, 9847, 9856, 9865, 9874, 9882, 9889,
+    9898, 9905, 9914, 9920, 9929, 9938, 9945, 9954, 9963, 9970, 9981, 9991,
+    10000, 10008, 10017, 10023, 10031, 10041, 10051, 10062, 10072, 10082, 10091, 10100,
+    10110, 10120, 10127, 10137, 10145, 10151, 10158, 10167, 10174, 10183, 10192, 10198,
+    10207, 10214, 10222, 10234, 10244, 10253, 10260, 10268, 10276, 10283, 10290, 10297,
+    10304, 10312, 10320, 10326, 10336, 10344, 10352, 10359, 10367, 10376, 10384, 10390,
+    10397, 10405, 10414, 10422, 10431, 10439, 10448, 10456, 10465, 10474, 10482, 10490,
+    10498, 10506, 10513, 10519, 10526, 10533, 10540, 10548, 10555, 10563, 10572, 10581,
+    10590, 10599, 10607, 10614, 10623, 10632, 10641, 10647, 10654, 10662, 10671, 10681,
+    10690, 10697, 10703, 10712, 10719, 10728, 10735, 10742, 10751, 10760, 10767, 10778,
+    10785, 10795, 10806, 10817, 10828, 10834, 10842, 10851, 10859, 10867, 10873, 10879,
+    10886, 10894, 10901, 10907, 10913, 10922, 10931, 10940, 10947, 10956, 10963, 10972,
+    10980, 10989, 10997, 11005, 11013, 11022, 11031, 11038, 11044, 11052, 11058, 11067,
+    11076, 11084, 11090, 11099, 11107, 11116, 11124, 11131, 11140, 11149, 11157, 11165,
+    11174, 11182, 11190, 11198, 11207, 11216, 11225, 11231, 11239, 11248, 11257, 11264,
+    11270, 11277, 11286, 11295, 11303, 11311, 11319, 11328, 11336, 11346, 11355, 11361,
+    11368, 11377, 11385, 11394, 11403, 11409, 11417, 11425, 11432, 11439, 11448, 11456,
+    11463, 11471, 11479, 11488, 11494, 11500, 11509, 11516, 11525, 11532, 11540, 11547,
+    11553, 11562, 11570, 11578, 11584, 11594, 11600, 11609, 11616, 11627, 11636, 11643,
+    11651, 11657, 11666, 11675, 11683, 11692, 11701, 11708, 11715, 11723, 11731, 11740,
+    11749, 11757, 11766, 11773, 11780, 11788, 11797, 11806, 11813, 11822, 11830, 11841,
+    11850, 11859, 11866, 11875, 11884, 11890, 11898, 11905, 11913, 11920, 11930, 11936,
+    11944, 11952, 11960, 11973, 11983, 11990, 12000, 12009, 12018, 12026, 12035, 12045,
+    12054, 12063, 12070, 12076, 12082, 12091, 12097, 12106, 12113, 12121, 12128, 12135,
+    12142, 12149, 12158, 12164, 12173, 12181, 12188, 12196, 12203, 12211, 12219, 12226,
+    12234, 12242, 12249, 12257, 12263, 12269, 12277, 12285, 12293, 12300, 12307, 12316,
+    12324, 12332, 12339, 12346, 12352, 12360, 12366, 12374, 12383, 12392, 12400, 12407,
+    12415, 12423, 12430, 12438, 12447, 12454, 12463, 12471, 12479, 12488, 12499, 12505,
+    12514, 12523, 12534, 12542, 12550, 12557, 12564, 12570, 12578, 12585, 12593, 12601,
+    12609, 12617, 12626, 12637, 12647, 12657, 12667, 12676, 12687, 12698, 12708, 12717,
+    12724, 12731, 12738, 12749, 12760, 12768, 12776, 12786, 12792, 12801, 12810, 12819,
+    12826, 12837, 12848, 12857, 12866, 12875, 12883, 12892, 12899, 12907, 12914, 12920,
+    12927, 12935, 12943, 12951, 12960, 12967, 12976, 12983, 12992, 13001, 13012, 13020,
+    13029, 13036, 13045, 13053, 13062, 13070, 13077, 13086, 13095, 13104, 13111, 13118,
+    13127, 13135, 13141, 13150, 13160, 13169, 13180, 13191, 13200, 13210, 13221, 13232,
+    13241, 13249, 13258, 13268, 13277, 13285, 13295, 13306, 13314, 13321, 13332, 13341,
+    13351, 13362, 13375, 13383, 13391, 13399, 13407, 13414, 13423, 13432, 13439, 13448,
+    13456, 13463, 13470, 13478, 13487, 13496, 13504, 13511, 13519, 13528, 13536, 13544,
+    13551, 13561, 13572, 13583, 13591, 13598, 13609, 13620, 13628, 13639, 13648, 13657,
+    13667, 13677, 13686, 13694, 13704, 13715, 13724, 13731, 13737, 13744, 13752, 13759,
+    13768, 13776, 13783, 13790, 13796, 13806, 13814, 13822, 13829, 13835, 13842, 13849,
+    13856, 13864, 13870, 13877, 13883, 13891, 13899, 13907, 13915, 13921, 13927, 13933,
+    13940, 13948, 13955, 13964, 13970, 13979, 13986, 13993, 14001, 14007, 14015, 14022,
+    14030, 14037, 14044, 14051, 14057, 14064, 14071, 14080, 14089, 14098, 14106, 14114,
+    14123, 14130, 14137, 14145, 14152, 14161, 14169, 14178, 14191, 14202, 14210, 14219,
+    14227, 14235, 14241, 14249, 14258, 14267, 14277, 14286, 14294, 14307, 14317, 14327,
+    14336, 14345, 14356, 14364, 14372, 14380, 14390, 14401, 14410, 14419, 14429, 14440,
+    14447, 14455, 14465, 14473, 14481, 14489, 14498, 14506, 14514, 14523, 14533, 14542,
+    14551, 14559, 14565, 14572, 14580, 14589, 14596, 14606, 14615, 14622, 14628, 14637,
+    14644, 14650, 14657, 14663, 14670, 14679, 14686, 14693, 14702, 14710, 14717, 14725,
+    14734, 14740, 14748, 14757, 14764, 14772, 14779, 14785, 14793, 14802, 14810, 14818,
+    14827, 14835, 14842, 14851, 14860, 14869, 14877, 14887, 14896, 14903, 14910, 14918,
+    14926, 14935, 14944, 14951, 14960, 14968, 14977, 14985, 14994, 15001, 15010, 15019,
+    15025, 15033, 15044, 15052, 15060, 15068, 15077, 15085, 15094, 15103, 15112, 15120,
+    15127, 15135, 15143, 15151, 15162, 15170, 15178, 15188, 15194, 15202, 15210, 15218,
+    15225, 15234, 15243, 15251, 15259, 15268, 15274, 15283, 15290, 15296, 15304, 15310,
+    15317, 15326, 15332, 15340, 15346, 15355, 15364, 15373, 15380, 15387, 15393, 15401,
+    15410, 15416, 15425, 15434, 15440, 15448, 15458, 15469, 15476, 15482, 15490, 15497,
+    15506, 15513, 15519, 15526, 15532, 15540, 15549, 15560, 15567, 15575, 15583, 15592,
+    15599, 15606, 15614, 15623, 15631, 15637, 15644, 15650, 15658, 15667, 15675, 15682,
+    15691, 15698, 15707, 15714, 15720, 15729, 15737, 15746, 15754, 15763, 15770, 15777,
+    15786, 15795, 15804, 15813, 15821, 15830, 15838, 15847, 15853, 15862, 15871, 15877,
+    15884, 15892, 15899, 15907, 15914, 15922, 15928, 15935, 15942, 15950, 15956, 15965,
+    15972, 15981, 15989, 15997, 16003, 16010, 16019, 16027, 16035, 16042, 16051, 16057,
+    16063, 16069, 16075, 16081, 16088, 16096, 16103, 16112, 16118, 16127, 16135, 16144,
+    16152, 16159, 16166, 16172, 16180, 16188, 16195, 16202, 16209, 16216, 16222, 16230,
+    16238, 16250, 16261, 16269, 16278, 16287, 16299, 16306, 16315, 16324, 16332, 16340,
+    16347, 16354, 16361, 16367, 16374, 16386, 16396, 16403, 16409, 16416, 16423, 16432,
+    16440, 16448, 16457, 16465, 16472, 16480, 16489, 16496, 16505, 16514, 16523, 16529,
+    16536, 16543, 16550, 16559, 16566, 16572, 16580, 16589, 16597, 16604, 16613, 16622,
+    16629, 16635, 16642, 16650, 16659, 16666, 16675, 16682, 16689, 16696, 16702, 16710,
+    16717, 16725, 16731, 16739, 16745, 16753, 16762, 16768,
+   };
+
+static const uint16_t fr_d[] = {
+    29, 5, 12, 11, 4, 82, 2, 381, 1, 74, 3, 93,
+    141, 30, 21, 27, 19, 1, 9, 1, 3, 8, 1, 61,
+    1, 0, 268, 1, 5, 0, 0, 2, 44, 62, 26, 0,
+    0, 13, 8, 56, 4, 2, 23, 8, 145, 0, 4, 74,
+    2, 20, 293, 8, 59, 0, 54, 81, 0, 28, 0, 0,
+    202, 11, 14, 0, 19, 285, 108, 83, 178, 20, 49, 93,
+    124, 0, 30, 39, 9, 3, 63, 0, 8, 57, 0, 1,
+    9, 9, 52, 98, 12, 1, 0, 3, 163, 405, 2, 17,
+    5, 35, 2, 25, 7, 0, 2, 10, 12, 46, 4, 215,
+    0, 87, 37, 50, 83, 1, 5, 475, 143, 11, 23, 200,
+    0, 10, 17, 83, 234, 0, 108, 0, 36, 6, 63, 15,
+    251, 147, 2, 5, 24, 117, 10, 0, 0, 2, 98, 6,
+    84, 8, 89, 253, 3, 45, 1, 0, 498, 2, 214, 5,
+    14, 0, 11, 34, 270, 21, 81, 34, 0, 19, 2, 0,
+    1, 8, 23, 3, 10, 12, 58, 5, 28, 1, 2, 1,
+    5, 3, 127, 16, 229, 152, 10, 415, 1, 42, 4, 62,
+    4, 4, 38, 2, 1575, 50, 106, 98, 41, 40, 81, 124,
+    18, 9, 32, 40, 195, 21, 4, 246, 0, 111, 332, 0,
+    0, 127, 4, 26, 94, 64, 34, 1, 2, 94, 0, 10,
+    2, 44, 251, 6, 17, 5, 24, 21, 0, 40, 158, 182,
+    16, 171, 8, 83, 25, 395, 85, 3, 44, 262, 3, 26,
+    2, 15, 52, 14, 39, 901, 11, 86, 34, 18, 116, 29,
+    175, 0, 44, 23, 24, 138, 17, 0, 0, 0, 8, 21,
+    18, 222, 5, 0, 167, 4, 59, 540, 136, 4, 112, 226,
+    0, 140, 443, 59, 9, 0, 186, 9, 1, 858, 419, 240,
+    126, 282, 38, 2, 319, 30, 6, 342, 79, 3, 34, 76,
+    21, 20, 20, 7, 8, 56, 24, 8, 165, 9, 1, 22,
+    0, 585, 497, 4, 1, 193, 15, 88, 273, 115, 513, 48,
+    9, 278, 870, 372, 97, 0, 26, 39, 181, 43, 194, 126,
+    12, 251, 140, 7, 325, 467, 145, 48, 37, 304, 363, 91,
+    54, 22, 14, 54, 2, 2, 32, 5, 60, 28, 105, 403,
+    734, 255, 36, 12, 0, 154, 294, 26, 29, 5, 1177, 16,
+    401, 216, 734, 78, 695, 233, 105, 1982, 0, 164, 1, 54,
+    3, 311, 6, 217, 198, 647, 1686, 2, 506, 1343, 222, 706,
+    5, 306, 8, 967, 769, 0, 3, 832, 13, 2017, 0, 43,
+    36, 1050, 348, 153, 23, 141, 6, 10, 3, 73, 2176, 55,
+    5, 69, 727, 212, 610, 307, 52, 62, 397, 55, 220, 355,
+    390, 1570, 0, 37, 19, 195, 54, 298, 35, 3704, 338, 20,
+    374, 239, 63, 10, 2582, 56, 109, 217, 93, 44, 0, 9,
+    172, 1, 1, 38, 3908, 383, 0, 3761, 354, 134, 4946, 158,
+    466, 341, 360, 383, 0, 186, 440, 438, 2637, 981, 92, 1560,
+    530, 5002, 803, 16, 661, 64, 156, 10, 8, 24, 2534, 903,
+    12, 182, 173, 350, 48, 473, 151, 71,
+   };
+static const uint16_t fr_h[] = {
+    1321, 1625, 1557, 143, 772, 1737, 101, 1969, 1311, 1838, 1559, 589,
+    29, 513, 1857, 1392, 1077, 1832, 415, 278, 1601, 954, 393, 1470,
+    1491, 2044, 1662, 335, 569, 490, 192, 1477, 783, 806, 86, 273,
+    1459, 208, 2026, 1457, 802, 1059, 554, 1379, 1058, 1993, 732, 1260,
+    702, 233, 1415, 1279, 1161, 1687, 874, 2024, 1034, 265, 1057, 1185,
+    8, 51, 537, 151, 1280, 859, 568, 1537, 831, 426, 64, 1026,
+    691, 311, 1035, 654, 1211, 280, 1539, 910, 350, 1443, 935, 1263,
+    74, 588, 1981, 1569, 1435, 581, 1028, 1319, 1216, 419, 556, 664,
+    436, 96, 1525, 701, 1821, 601, 1827, 363, 1186, 1237, 50, 1296,
+    2008, 990, 820, 805, 2037, 649, 1346, 399, 1322, 417, 1102, 1691,
+    1137, 812, 938, 585, 255, 1896, 1365, 108, 1757, 1826, 1483, 1962,
+    138, 308, 1044, 196, 832, 141, 850, 1768, 353, 247, 2038, 778,
+    1204, 1469, 937, 2047, 911, 1698, 977, 1229, 786, 1184, 919, 505,
+    1618, 1402, 1013, 1564, 1224, 1676, 930, 475, 446, 262, 647, 835,
+    1709, 2, 544, 1386, 1643, 484, 1931, 719, 684, 134, 1918, 1696,
+    931, 427, 351, 1610, 395, 213, 1145, 251, 345, 1823, 1723, 1353,
+    1786, 1466, 860, 1774, 730, 1914, 1381, 1806, 384, 1999, 1439, 662,
+    307, 865, 1685, 440, 412, 642, 2007, 1633, 414, 767, 1555, 90,
+    410, 48, 1063, 1882, 933, 1002, 754, 340, 2045, 534, 1785, 2004,
+    9, 1072, 1340, 952, 1545, 808, 165, 1220, 1982, 485, 1291, 1430,
+    1517, 834, 1213, 1170, 1848, 1897, 1021, 17, 524, 843, 643, 519,
+    1190, 1223, 496, 946, 260, 1620, 1599, 1521, 1974, 70, 218, 435,
+    1755, 1366, 1241, 1080, 457, 1192, 204, 1165, 1256, 1478, 1240, 830,
+    421, 1176, 889, 1531, 2029, 489, 582, 669, 1996, 269, 1509, 1305,
+    1990, 19, 1129, 1930, 761, 638, 1889, 1000, 30, 506, 1845, 77,
+    1587, 371, 1153, 2012, 1017, 1972, 1196, 1038, 168, 1820, 708, 1887,
+    1966, 1980, 360, 1312, 819, 1565, 1496, 677, 1752, 1693, 861, 1257,
+    818, 694, 120, 413, 1109, 1973, 123, 277, 683, 85, 1640, 785,
+    279, 1158, 595, 645, 871, 580, 1421, 55, 1880, 1921, 530, 244,
+    1465, 1497, 603, 1568, 1304, 318, 330, 1174, 3, 1704, 68, 562,
+    1671, 2013, 1878, 1970, 574, 288, 1287, 1609, 1653, 640, 1561, 103,
+    1406, 322, 1747, 984, 342, 47, 1336, 479, 633, 306, 1500, 1716,
+    1117, 1039, 164, 856, 1604, 810, 545, 392, 18, 1444, 1890, 1991,
+    401, 590, 1437, 1656, 1639, 223, 1499, 925, 744, 1040, 845, 1409,
+    374, 91, 1283, 1944, 1919, 294, 529, 319, 1655, 1419, 1672, 315,
+    378, 731, 774, 1157, 1498, 1711, 1866, 868, 743, 184, 1060, 1095,
+    1108, 1647, 1003, 1277, 1148, 1065, 1571, 1330, 646, 1422, 119, 1135,
+    968, 1950, 723, 388, 2040, 87, 944, 1032, 140, 313, 792, 535,
+    609, 1801, 1929, 1612, 1452, 1187, 137, 695, 65, 1337, 1570, 1917,
+    1175, 1177, 2000, 23, 1194, 725, 185, 405, 966, 598, 317, 1554,
+    801, 1368, 1985, 173, 1468, 33, 1251, 693, 281, 1617, 1556, 398,
+    1763, 870, 1651, 2033, 169, 1344, 1520, 455, 838, 1448, 706, 986,
+    1064, 634, 1660, 258, 115, 678, 759, 1523, 641, 1503, 1324, 566,
+    520, 1159, 763, 486, 813, 1694, 1744, 11, 893, 99, 1688, 752,
+    1781, 476, 782, 892, 1119, 1902, 354, 2016, 2005, 750, 941, 828,
+    839, 656, 1995, 373, 482, 1428, 190, 1228, 707, 630, 1562, 579,
+    1674, 1590, 718, 1482, 1149, 983, 998, 855, 1714, 1215, 1822, 1807,
+    1132, 358, 809, 541, 1100, 1753, 1712, 396, 1414, 1813, 508, 1199,
+    1462, 1828, 1383, 1261, 286, 199, 180, 592, 658, 1202, 1288, 1066,
+    512, 284, 356, 1293, 1600, 1301, 970, 381, 339, 735, 627, 448,
+    943, 1529, 144, 510, 764, 409, 1006, 515, 1203, 1408, 323, 550,
+    390, 366, 252, 450, 1627, 2039, 1538, 1359, 1595, 1707, 1456, 453,
+    107, 431, 1090, 1596, 1891, 665, 460, 1756, 1049, 1308, 188, 1281,
+    1314, 1665, 1740, 1378, 1306, 1024, 523, 301, 546, 1817, 171, 909,
+    1019, 1964, 771, 1934, 866, 981, 425, 1124, 787, 309, 746, 1495,
+    1286, 1745, 201, 430, 777, 1794, 1156, 890, 1294, 1844, 1800, 567,
+    1299, 823, 1851, 1519, 428, 736, 39, 1092, 1372, 316, 238, 1984,
+    1492, 509, 584, 494, 829, 1583, 1360, 571, 928, 102, 881, 1913,
+    776, 1380, 416, 1501, 42, 663, 62, 501, 217, 623, 1635, 1644,
+    1334, 957, 1899, 1295, 1151, 539, 1510, 961, 672, 1364, 321, 1748,
+    1317, 847, 402, 1522, 1400, 235, 625, 1217, 1961, 705, 1320, 2035,
+    105, 659, 1908, 1445, 980, 1195, 391, 1518, 1244, 1683, 844, 158,
+    1377, 578, 472, 1927, 1877, 1830, 259, 817, 1093, 116, 1425, 326,
+    586, 480, 1789, 1871, 1790, 291, 745, 690, 2036, 846, 576, 888,
+    1658, 1487, 923, 1935, 1994, 558, 779, 59, 1847, 722, 420, 1239,
+    1649, 285, 724, 60, 1479, 1114, 439, 518, 1971, 268, 227, 971,
+    1731, 1533, 1728, 956, 94, 271, 66, 1892, 674, 1808, 1081, 1937,
+    2031, 1815, 1227, 748, 1765, 1549, 1188, 355, 1433, 929, 1056, 841,
+    0, 604, 726, 1942, 394, 376, 1071, 1819, 1146, 1388, 2017, 1904,
+    4, 1107, 12, 1749, 883, 557, 1928, 80, 98, 2030, 1726, 599,
+    1272, 1313, 502, 686, 289, 877, 1681, 1265, 1854, 1885, 591, 1268,
+    1551, 912, 1582, 1536, 1121, 1719, 1872, 254, 740, 948, 608, 1831,
+    403, 884, 2010, 469, 465, 139, 1140, 561, 1042, 461, 668, 46,
+    1856, 635, 1262, 1689, 655, 437, 1447, 1434, 2009, 945, 1266, 1593,
+    1173, 898, 1061, 276, 53, 1162, 124, 261, 2003, 2015, 2028, 1342,
+    1646, 56, 1730, 215, 100, 1952, 1375, 117, 1905, 1361, 1805, 1967,
+    976, 1282, 127, 1638, 248, 459, 299, 913, 1323, 237, 179, 1047,
+    464, 156, 1303, 878, 657, 1907, 1489, 712, 963, 1111, 2041, 1797,
+    1410, 517, 1710, 474, 1630, 1331, 741, 1128, 499, 1345, 1243, 728,
+    1089, 1198, 936, 365, 715, 1083, 572, 1622, 320, 994, 1333, 1485,
+    1276, 216, 104, 770, 495, 312, 1284, 873, 542, 1874, 1264, 853,
+    1852, 926, 864, 988, 628, 114, 1464, 225, 526, 1030, 118, 488,
+    22, 89, 1943, 1611, 181, 1391, 467, 434, 1116, 1959, 521, 851,
+    1628, 125, 1893, 1505, 500, 2046, 1112, 1329, 1270, 613, 791, 685,
+    14, 1839, 1214, 960, 1958, 852, 1233, 43, 962, 1809, 525, 49,
+    1440, 979, 1677, 906, 1760, 1782, 784, 1014, 1912, 2043, 747, 1271,
+    727, 275, 1720, 1701, 1816, 1144, 1956, 1018, 833, 1833, 1989, 1169,
+    563, 1126, 126, 178, 1394, 175, 274, 902, 20, 324, 1242, 1810,
+    292, 1493, 616, 666, 993, 300, 2020, 1534, 1865, 1703, 1829, 379,
+    650, 368, 611, 1411, 1349, 111, 1717, 1131, 573, 978, 632, 1903,
+    1911, 1965, 477, 765, 1155, 1449, 901, 548, 1876, 1142, 1955, 1729,
+    128, 1837, 221, 887, 202, 146, 338, 1139, 1399, 908, 41, 1769,
+    1245, 676, 907, 1976, 264, 110, 1530, 230, 1191, 1230, 498, 161,
+    93, 1247, 1076, 1210, 671, 1960, 739, 551, 1125, 347, 565, 1713,
+    1575, 1130, 1015, 1029, 583, 2023, 920, 553, 982, 1901, 1166, 1948,
+    799, 575, 1739, 1992, 1858, 1648, 95, 1451, 667, 332, 869, 1069,
+    713, 1524, 162, 228, 240, 481, 1761, 1977, 2002, 1225, 1616, 1134,
+    38, 1423, 1949, 1894, 302, 1113, 1637, 636, 1799, 234, 631, 1923,
+    1404, 205, 32, 1285, 1654, 1751, 1657, 1668, 547, 1850, 183, 1811,
+    418, 1750, 145, 1963, 1670, 367, 84, 1363, 854, 63, 1052, 1951,
+    1418, 21, 1424, 92, 343, 1608, 1208, 97, 964, 1438, 1218, 210,
+    1396, 1115, 949, 1357, 959, 1387, 1836, 1835, 533, 951, 1315, 788,
+    1792, 1988, 1454, 1105, 1679, 1692, 973, 577, 617, 687, 327, 1007,
+    131, 445, 862, 24, 1460, 1, 155, 899, 471, 1843, 148, 953,
+    969, 612, 1298, 1926, 816, 61, 1070, 454, 1722, 78, 531, 1335,
+    1585, 1946, 1120, 189, 1666, 692, 191, 1252, 263, 1417, 1864, 660,
+    800, 1104, 346, 1863, 540, 1736, 142, 133, 73, 1574, 1147, 1661,
+    522, 1307, 1207, 1290, 1200, 27, 516, 1475, 1867, 559, 822, 1547,
+    149, 679, 1544, 1558, 1458, 837, 1938, 1367, 1859, 1369, 1861, 1376,
+    386, 1812, 1580, 1471, 290, 789, 1535, 211, 359, 1775, 468, 758,
+    947, 597, 620, 451, 1168, 1516, 442, 696, 1062, 974, 1474, 1968,
+    1098, 1883, 826, 2034, 587, 1853, 1680, 629, 958, 1041, 1219, 989,
+    815, 1932, 1869, 1339, 198, 1398, 36, 1455, 1143, 67, 222, 781,
+    738, 1180, 297, 1721, 1506, 797, 711, 1746, 58, 1512, 652, 1641,
+    1427, 1103, 121, 1659, 790, 1767, 1804, 1983, 1742, 1205, 34, 532,
+    432, 1001, 112, 900, 372, 75, 1426, 1362, 1327, 940, 975, 1005,
+    452, 52, 1043, 458, 1987, 934, 1397, 1573, 1886, 357, 729, 775,
+    348, 1234, 2042, 1473, 1578, 721, 333, 915, 229, 849, 136, 246,
+    487, 13, 1626, 1236, 1695, 594, 1488, 1201, 5, 1597, 352, 1916,
+    681, 1316, 863, 1351, 1033, 304, 504, 1436, 76, 429, 528, 1025,
+    1429, 1543, 1160, 1940, 1352, 1846, 253, 1615, 129, 1783, 447, 2021,
+    160, 1514, 1802, 621, 1791, 1347, 1594, 1613, 688, 1238, 79, 991,
+    1796, 1743, 1302, 1553, 1328, 2025, 1091, 1206, 955, 81, 152, 1278,
+    714, 174, 996, 803, 1708, 1795, 1350, 1540, 176, 1450, 619, 965,
+    885, 1699, 1189, 891, 1567, 1476, 1764, 1527, 1412, 875, 212, 1798,
+    283, 894, 473, 1632, 389, 1619, 972, 1697, 424, 1706, 857, 385,
+    848, 26, 967, 570, 256, 1772, 675, 6, 1343, 397, 303, 449,
+    406, 1232, 153, 1576, 1803, 1045, 939, 653, 1614, 411, 1915, 1358,
+    1197, 795, 375, 922, 1770, 44, 895, 1818, 999, 904, 1246, 760,
+    1589, 1226, 197, 1849, 364, 1289, 1010, 159, 1332, 1766, 1326, 1777,
+    2014, 1754, 1581, 1432, 987, 35, 1138, 1154, 538, 773, 614, 209,
+    1686, 1870, 624, 950, 1579, 383, 177, 231, 1441, 903, 1086, 836,
+    1725, 1075, 1824, 1250, 370, 337, 1700, 1925, 1413, 1623, 1678, 1106,
+    858, 40, 438, 130, 167, 680, 1682, 328, 441, 618, 109, 503,
+    794, 1133, 492, 872, 560, 1920, 2011, 756, 1563, 1370, 1253, 1222,
+    1480, 157, 1012, 1957, 1300, 1022, 710, 992, 1979, 239, 1645, 661,
+    1735, 549, 1255, 1048, 470, 1738, 1873, 1171, 1053, 1840, 1855, 408,
+    1741, 1088, 1150, 703, 331, 985, 83, 1118, 916, 1841, 1269, 1094,
+    1193, 1407, 1181, 444, 867, 1552, 1267, 1027, 1548, 905, 334, 1773,
+    527, 876, 245, 1667, 1355, 689, 1395, 224, 1924, 639, 1532, 1004,
+    37, 1054, 927, 1787, 1771, 507, 1389, 2018, 1515, 602, 734, 1776,
+    1526, 443, 1385, 1249, 600, 241, 1141, 615, 1442, 69, 1860, 2019,
+    1788, 257, 698, 226, 1420, 1484, 310, 1881, 1051, 1758, 1020, 1486,
+    1586, 1603, 1097, 1842, 564, 842, 1221, 1163, 1453, 880, 1152, 1504,
+    699, 605, 1607, 1631, 361, 314, 1879, 511, 670, 648, 1906, 804,
+    768, 769, 380, 607, 1941, 150, 423, 924, 1673, 377, 1416, 673,
+    305, 207, 1393, 1793, 1895, 88, 1338, 1082, 1621, 82, 203, 1727,
+    793, 1933, 1513, 344, 1909, 31, 478, 1507, 733, 896, 54, 195,
+    45, 1718, 349, 1490, 267, 1050, 1936, 1494, 135, 1978, 250, 1705,
+    1733, 483, 593, 1259, 1814, 1178, 1945, 1011, 1779, 2006, 1209, 720,
+    1606, 1588, 1636, 1947, 1868, 1356, 249, 1663, 16, 329, 637, 1910,
+    921, 266, 296, 1825, 407, 1642, 1572, 382, 387, 1374, 1780, 1953,
+    28, 1273, 1254, 1862, 1371, 463, 1634, 193, 1101, 71, 194, 422,
+    1401, 606, 186, 1650, 1074, 1778, 1431, 807, 1073, 1046, 796, 626,
+    757, 555, 272, 1164, 751, 1390, 1079, 1759, 298, 1055, 1724, 780,
+    1560, 1528, 1690, 456, 552, 1702, 172, 1598, 493, 1684, 1123, 1888,
+    1122, 154, 697, 1998, 1467, 282, 1511, 1591, 187, 811, 170, 132,
+    2001, 1605, 15, 882, 163, 1508, 404, 755, 1023, 1087, 1997, 1318,
+    200, 1602, 1297, 1405, 1037, 1067, 766, 1403, 717, 1541, 814, 514,
+    1099, 1212, 1715, 1986, 1542, 466, 1975, 879, 1922, 886, 1127, 1954,
+    1463, 1900, 824, 2032, 147, 232, 682, 1669, 1258, 1009, 1732, 220,
+    242, 997, 72, 1734, 1834, 1274, 1085, 341, 1325, 1172, 166, 1629,
+    287, 1179, 1016, 1550, 1110, 369, 1182, 897, 1036, 270, 433, 737,
+    206, 1481, 1084, 700, 704, 57, 1566, 536, 622, 1310, 25, 7,
+    753, 219, 1875, 1248, 1472, 1309, 543, 917, 325, 1446, 1384, 749,
+    106, 336, 1183, 1784, 462, 914, 1348, 1031, 362, 1502, 1373, 1898,
+    651, 295, 491, 1652, 10, 932, 1136, 1461, 610, 293, 1624, 742,
+    995, 1096, 1546, 1762, 762, 214, 825, 1664, 1068, 113, 243, 821,
+    798, 122, 840, 2022, 1382, 1592, 1292, 2027, 1341, 1584, 1354, 942,
+    236, 1275, 1884, 918, 1231, 827, 596, 400, 644, 1939, 1675, 1167,
+    182, 1078, 716, 709, 1235, 497, 1577, 1008,
    };
-#undef fr
 
 static const struct words fr_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words fr_words = {
     false,
     (const char *)fr_,
     0, /* Constant string */
-    fr_i
+    NULL, /* Words are located by offset */
+    fr_o,
+    0u,
+    fr_d,
+    fr_h
 };
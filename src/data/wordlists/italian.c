@@ -2051,352 +2051,398 @@ static const unsigned char it_[] = {
     0x7a,0x75,0x6c,0x75,0,
     0x7a,0x75,0x70,0x70,0x61,0,
 };
-#define it ((const char*)it_)
-static const char *it_i[] = {
-    it+0, it+6, it+15, it+24, it+30, it+37,
-    it+45, it+54, it+63, it+72, it+80, it+89,
-    it+97, it+105, it+111, it+117, it+122, it+131,
-    it+140, it+146, it+153, it+162, it+169, it+178,
-    it+186, it+192, it+201, it+209, it+218, it+226,
-    it+234, it+243, it+252, it+258, it+267, it+273,
-    it+280, it+288, it+297, it+303, it+311, it+320,
-    it+329, it+338, it+345, it+354, it+360, it+368,
-    it+377, it+382, it+389, it+394, it+403, it+412,
-    it+417, it+425, it+433, it+439, it+448, it+457,
-    it+465, it+473, it+482, it+491, it+498, it+506,
-    it+513, it+522, it+531, it+539, it+548, it+556,
-    it+563, it+571, it+578, it+587, it+595, it+603,
-    it+610, it+618, it+624, it+632, it+641, it+647,
-    it+655, it+663, it+672, it+681, it+687, it+693,
-    it+702, it+710, it+719, it+728, it+737, it+746,
-    it+753, it+758, it+766, it+773, it+780, it+787,
-    it+794, it+801, it+810, it+818, it+824, it+833,
-    it+842, it+847, it+856, it+864, it+873, it+878,
-    it+886, it+895, it+901, it+910, it+919, it+928,
-    it+936, it+944, it+951, it+959, it+968, it+977,
-    it+986, it+994, it+1002, it+1009, it+1017, it+1026,
-    it+1033, it+1041, it+1049, it+1056, it+1063, it+1068,
-    it+1076, it+1083, it+1092, it+1100, it+1108, it+1117,
-    it+1122, it+1131, it+1139, it+1148, it+1156, it+1163,
-    it+1172, it+1180, it+1186, it+1192, it+1201, it+1207,
-    it+1216, it+1221, it+1230, it+1238, it+1243, it+1252,
-    it+1259, it+1268, it+1276, it+1284, it+1292, it+1298,
-    it+1305, it+1314, it+1322, it+1330, it+1338, it+1346,
-    it+1354, it+1362, it+1371, it+1379, it+1388, it+1394,
-    it+1403, it+1410, it+1420, it+1427, it+1433, it+1440,
-    it+1448, it+1455, it+1463, it+1470, it+1475, it+1483,
-    it+1492, it+1500, it+1506, it+1514, it+1520, it+1527,
-    it+1535, it+1543, it+1551, it+1559, it+1568, it+1576,
-    it+1582, it+1591, it+1599, it+1607, it+1616, it+1622,
-    it+1630, it+1638, it+1644, it+1649, it+1656, it+1662,
-    it+1668, it+1675, it+1681, it+1687, it+1696, it+1704,
-    it+1712, it+1717, it+1725, it+1730, it+1737, it+1742,
-    it+1749, it+1756, it+1761, it+1770, it+1776, it+1785,
-    it+1793, it+1800, it+1809, it+1818, it+1824, it+1833,
-    it+1841, it+1850, it+1858, it+1866, it+1875, it+1882,
-    it+1889, it+1897, it+1906, it+1912, it+1918, it+1927,
-    it+1935, it+1943, it+1951, it+1959, it+1965, it+1972,
-    it+1980, it+1989, it+1998, it+2005, it+2013, it+2023,
-    it+2032, it+2041, it+2047, it+2056, it+2063, it+2069,
-    it+2077, it+2082, it+2089, it+2097, it+2102, it+2108,
-    it+2114, it+2122, it+2131, it+2139, it+2145, it+2153,
-    it+2160, it+2169, it+2177, it+2185, it+2193, it+2199,
-    it+2207, it+2215, it+2224, it+2232, it+2240, it+2247,
-    it+2255, it+2262, it+2270, it+2275, it+2282, it+2290,
-    it+2298, it+2305, it+2313, it+2322, it+2331, it+2339,
-    it+2345, it+2353, it+2362, it+2371, it+2377, it+2385,
-    it+2394, it+2403, it+2413, it+2422, it+2430, it+2438,
-    it+2443, it+2451, it+2460, it+2468, it+2476, it+2483,
-    it+2491, it+2497, it+2505, it+2514, it+2522, it+2529,
-    it+2537, it+2547, it+2552, it+2559, it+2569, it+2578,
-    it+2586, it+2592, it+2599, it+2608, it+2615, it+2621,
-    it+2626, it+2632, it+2639, it+2646, it+2655, it+2663,
-    it+2669, it+2678, it+2687, it+2692, it+2701, it+2709,
-    it+2715, it+2724, it+2733, it+2739, it+2747, it+2755,
-    it+2765, it+2772, it+2780, it+2787, it+2796, it+2804,
-    it+2810, it+2816, it+2824, it+2831, it+2840, it+2848,
-    it+2856, it+2864, it+2871, it+2879, it+2889, it+2895,
-    it+2900, it+2907, it+2916, it+2923, it+2932, it+2939,
-    it+2947, it+2956, it+2965, it+2975, it+2983, it+2992,
-    it+3002, it+3010, it+3019, it+3028, it+3036, it+3044,
-    it+3051, it+3061, it+3069, it+3077, it+3086, it+3094,
-    it+3102, it+3108, it+3116, it+3123, it+3131, it+3139,
-    it+3148, it+3156, it+3163, it+3171, it+3180, it+3187,
-    it+3195, it+3203, it+3212, it+3218, it+3226, it+3234,
-    it+3240, it+3248, it+3254, it+3262, it+3271, it+3280,
-    it+3287, it+3294, it+3301, it+3308, it+3316, it+3323,
-    it+3332, it+3340, it+3346, it+3354, it+3362, it+3367,
-    it+3373, it+3381, it+3390, it+3398, it+3406, it+3414,
-    it+3421, it+3429, it+3437, it+3445, it+3454, it+3461,
-    it+3469, it+3477, it+3485, it+3494, it+3503, it+3511,
-    it+3517, it+3526, it+3534, it+3542, it+3548, it+3556,
-    it+3565, it+3572, it+3581, it+3590, it+3599, it+3606,
-    it+3616, it+3624, it+3634, it+3643, it+3653, it+3660,
-    it+3669, it+3678, it+3685, it+3692, it+3700, it+3709,
-    it+3718, it+3726, it+3735, it+3744, it+3752, it+3760,
-    it+3767, it+3776, it+3781, it+3789, it+3796, it+3804,
-    it+3813, it+3821, it+3829, it+3838, it+3847, it+3856,
-    it+3861, it+3868, it+3876, it+3885, it+3894, it+3902,
-    it+3910, it+3919, it+3925, it+3931, it+3938, it+3947,
-    it+3956, it+3964, it+3969, it+3977, it+3982, it+3990,
-    it+3997, it+4005, it+4011, it+4018, it+4025, it+4034,
-    it+4041, it+4046, it+4052, it+4060, it+4069, it+4075,
-    it+4083, it+4088, it+4096, it+4105, it+4111, it+4119,
-    it+4125, it+4134, it+4142, it+4151, it+4156, it+4164,
-    it+4172, it+4182, it+4191, it+4200, it+4209, it+4216,
-    it+4224, it+4231, it+4237, it+4242, it+4247, it+4253,
-    it+4261, it+4269, it+4276, it+4282, it+4290, it+4299,
-    it+4308, it+4314, it+4323, it+4330, it+4338, it+4345,
-    it+4353, it+4361, it+4368, it+4376, it+4384, it+4393,
-    it+4401, it+4408, it+4417, it+4424, it+4429, it+4436,
-    it+4442, it+4450, it+4458, it+4467, it+4472, it+4480,
-    it+4488, it+4496, it+4502, it+4510, it+4519, it+4524,
-    it+4532, it+4541, it+4549, it+4558, it+4567, it+4573,
-    it+4581, it+4590, it+4596, it+4604, it+4613, it+4621,
-    it+4626, it+4633, it+4642, it+4650, it+4658, it+4667,
-    it+4675, it+4682, it+4690, it+4695, it+4704, it+4711,
-    it+4717, it+4726, it+4734, it+4742, it+4749, it+4758,
-    it+4767, it+4775, it+4781, it+4790, it+4797, it+4805,
-    it+4811, it+4820, it+4825, it+4834, it+4843, it+4851,
-    it+4858, it+4866, it+4874, it+4883, it+4888, it+4897,
-    it+4904, it+4911, it+4916, it+4923, it+4929, it+4936,
-    it+4944, it+4952, it+4961, it+4970, it+4976, it+4984,
-    it+4992, it+5000, it+5006, it+5012, it+5018, it+5026,
-    it+5031, it+5040, it+5045, it+5053, it+5062, it+5069,
-    it+5075, it+5083, it+5090, it+5096, it+5104, it+5113,
-    it+5119, it+5126, it+5134, it+5142, it+5149, it+5156,
-    it+5165, it+5172, it+5181, it+5188, it+5195, it+5204,
-    it+5212, it+5221, it+5230, it+5236, it+5244, it+5252,
-    it+5262, it+5270, it+5278, it+5286, it+5291, it+5300,
-    it+5308, it+5316, it+5322, it+5331, it+5337, it+5346,
-    it+5355, it+5365, it+5373, it+5380, it+5386, it+5395,
-    it+5402, it+5410, it+5417, it+5426, it+5433, it+5442,
-    it+5450, it+5456, it+5464, it+5472, it+5479, it+5484,
-    it+5493, it+5499, it+5505, it+5513, it+5520, it+5525,
-    it+5532, it+5541, it+5547, it+5555, it+5563, it+5571,
-    it+5579, it+5585, it+5594, it+5600, it+5609, it+5617,
-    it+5626, it+5634, it+5643, it+5649, it+5656, it+5663,
-    it+5672, it+5677, it+5686, it+5692, it+5700, it+5708,
-    it+5713, it+5722, it+5730, it+5739, it+5745, it+5754,
-    it+5763, it+5769, it+5776, it+5782, it+5790, it+5798,
-    it+5807, it+5814, it+5820, it+5827, it+5834, it+5842,
-    it+5851, it+5859, it+5866, it+5874, it+5882, it+5888,
-    it+5894, it+5899, it+5906, it+5914, it+5921, it+5927,
-    it+5935, it+5943, it+5949, it+5957, it+5964, it+5971,
-    it+5980, it+5988, it+5995, it+6001, it+6008, it+6016,
-    it+6023, it+6030, it+6037, it+6044, it+6053, it+6059,
-    it+6066, it+6075, it+6080, it+6088, it+6097, it+6103,
-    it+6112, it+6120, it+6126, it+6131, it+6138, it+6147,
-    it+6154, it+6161, it+6170, it+6176, it+6183, it+6192,
-    it+6201, it+6209, it+6218, it+6226, it+6233, it+6240,
-    it+6248, it+6257, it+6265, it+6272, it+6280, it+6288,
-    it+6297, it+6305, it+6314, it+6323, it+6331, it+6340,
-    it+6348, it+6357, it+6365, it+6374, it+6383, it+6390,
-    it+6399, it+6405, it+6412, it+6420, it+6428, it+6437,
-    it+6446, it+6455, it+6463, it+6471, it+6479, it+6488,
-    it+6496, it+6504, it+6514, it+6523, it+6530, it+6538,
-    it+6546, it+6555, it+6564, it+6573, it+6580, it+6589,
-    it+6597, it+6607, it+6616, it+6623, it+6630, it+6639,
-    it+6648, it+6656, it+6663, it+6669, it+6677, it+6685,
-    it+6694, it+6703, it+6711, it+6719, it+6728, it+6737,
-    it+6745, it+6752, it+6760, it+6767, it+6777, it+6783,
-    it+6792, it+6800, it+6807, it+6815, it+6820, it+6826,
-    it+6835, it+6844, it+6852, it+6858, it+6866, it+6873,
-    it+6881, it+6888, it+6896, it+6904, it+6911, it+6918,
-    it+6926, it+6932, it+6941, it+6947, it+6953, it+6959,
-    it+6966, it+6974, it+6980, it+6990, it+6995, it+7004,
-    it+7011, it+7016, it+7024, it+7030, it+7039, it+7048,
-    it+7056, it+7064, it+7071, it+7079, it+7084, it+7091,
-    it+7097, it+7102, it+7110, it+7117, it+7125, it+7130,
-    it+7137, it+7145, it+7152, it+7160, it+7168, it+7176,
-    it+7181, it+7190, it+7195, it+7204, it+7211, it+7220,
-    it+7226, it+7231, it+7239, it+7247, it+7253, it+7259,
-    it+7267, it+7276, it+7283, it+7292, it+7299, it+7306,
-    it+7313, it+7321, it+7327, it+7336, it+7345, it+7354,
-    it+7364, it+7372, it+7378, it+7387, it+7392, it+7399,
-    it+7408, it+7417, it+7427, it+7435, it+7443, it+7452,
-    it+7460, it+7469, it+7475, it+7484, it+7492, it+7500,
-    it+7506, it+7515, it+7524, it+7532, it+7540, it+7550,
-    it+7560, it+7568, it+7575, it+7583, it+7591, it+7601,
-    it+7610, it+7619, it+7628, it+7633, it+7641, it+7647,
-    it+7655, it+7663, it+7668, it+7676, it+7685, it+7693,
-    it+7699, it+7708, it+7713, it+7721, it+7729, it+7737,
-    it+7744, it+7752, it+7762, it+7767, it+7775, it+7783,
-    it+7791, it+7799, it+7805, it+7814, it+7821, it+7828,
-    it+7835, it+7844, it+7849, it+7856, it+7863, it+7872,
-    it+7880, it+7888, it+7894, it+7903, it+7911, it+7920,
-    it+7926, it+7935, it+7945, it+7953, it+7962, it+7969,
-    it+7976, it+7982, it+7987, it+7995, it+8005, it+8011,
-    it+8019, it+8029, it+8036, it+8045, it+8053, it+8061,
-    it+8069, it+8074, it+8082, it+8092, it+8099, it+8108,
-    it+8117, it+8123, it+8131, it+8141, it+8147, it+8153,
-    it+8160, it+8166, it+8175, it+8183, it+8191, it+8201,
-    it+8210, it+8217, it+8223, it+8231, it+8238, it+8243,
-    it+8251, it+8258, it+8267, it+8272, it+8280, it+8286,
-    it+8296, it+8304, it+8311, it+8319, it+8327, it+8336,
-    it+8345, it+8353, it+8362, it+8371, it+8379, it+8388,
-    it+8396, it+8404, it+8412, it+8420, it+8426, it+8434,
-    it+8442, it+8451, it+8456, it+8466, it+8474, it+8480,
-    it+8487, it+8494, it+8501, it+8506, it+8511, it+8518,
-    it+8526, it+8534, it+8544, it+8553, it+8560, it+8568,
-    it+8577, it+8585, it+8592, it+8598, it+8605, it+8611,
-    it+8619, it+8626, it+8634, it+8639, it+8648, it+8656,
-    it+8665, it+8671, it+8677, it+8686, it+8696, it+8703,
-    it+8713, it+8723, it+8733, it+8738, it+8746, it+8754,
-    it+8762, it+8770, it+8778, it+8788, it+8796, it+8801,
-    it+8808, it+8817, it+8825, it+8832, it+8838, it+8848,
-    it+8854, it+8862, it+8871, it+8877, it+8883, it+8893,
-    it+8900, it+8906, it+8912, it+8921, it+8931, it+8936,
-    it+8944, it+8953, it+8961, it+8969, it+8975, it+8982,
-    it+8992, it+9000, it+9007, it+9016, it+9024, it+9034,
-    it+9039, it+9048, it+9057, it+9066, it+9074, it+9083,
-    it+9092, it+9099, it+9106, it+9111, it+9117, it+9126,
-    it+9133, it+9142, it+9149, it+9154, it+9163, it+9172,
-    it+9177, it+9183, it+9188, it+9197, it+9204, it+9212,
-    it+9218, it+9224, it+9230, it+9238, it+9246, it+9254,
-    it+9262, it+9267, it+9277, it+9282, it+9291, it+9299,
-    it+9307, it+9313, it+9318, it+9325, it+9335, it+9344,
-    it+9352, it+9357, it+9364, it+9372, it+9381, it+9387,
-    it+9396, it+9404, it+9413, it+9422, it+9429, it+9437,
-    it+9442, it+9450, it+9457, it+9465, it+9474, it+9483,
-    it+9491, it+9500, it+9508, it+9518, it+9526, it+9533,
-    it+9541, it+9550, it+9559, it+9566, it+9573, it+9580,
-    it+9588, it+9597, it+9605, it+9614, it+9622, it+9630,
-    it+9635, it+9642, it+9650, it+9659, it+9669, it+9679,
-    it+9689, it+9697, it+9706, it+9712, it+9722, it+9731,
-    it+9740, it+9748, it+9757, it+9765, it+9770, it+9780,
-    it+9787, it+9795, it+9805, it+9811, it+9819, it+9826,
-    it+9835, it+9843, it+9851, it+9857, it+9864, it+9872,
-    it+9880, it+9888, it+9894, it+9899, it+9908, it+9916,
-    it+9923, it+9932, it+9939, it+9945, it+9952, it+9960,
-    it+9967, it+9976, it+9985, it+9992, it+10001, it+10008,
-    it+10016, it+10024, it+10032, it+10039, it+10047, it+10056,
-    it+10065, it+10074, it+10082, it+10089, it+10098, it+10106,
-    it+10115, it+10123, it+10133, it+10142, it+10148, it+10157,
-    it+10165, it+10172, it+10181, it+10187, it+10196, it+10204,
-    it+10211, it+10219, it+10225, it+10233, it+10238, it+10247,
-    it+10256, it+10266, it+10275, it+10282, it+10289, it+10296,
-    it+10304, it+10313, it+10321, it+10330, it+10339, it+10348,
-    it+10356, it+10366, it+10376, it+10385, it+10394, it+10403,
-    it+10409, it+10418, it+10426, it+10435, it+10443, it+10452,
-    it+10460, it+10469, it+10478, it+10487, it+10495, it+10504,
-    it+10512, it+10520, it+10526, it+10535, it+10542, it+10550,
-    it+10557, it+10566, it+10573, it+10582, it+10588, it+10594,
-    it+10601, it+10610, it+10618, it+10626, it+10634, it+10639,
-    it+10646, it+10655, it+10661, it+10669, it+10675, it+10684,
-    it+10694, it+10703, it+10712, it+10720, it+10728, it+10736,
-    it+10742, it+10750, it+10758, it+10763, it+10772, it+10782,
-    it+10789, it+10796, it+10805, it+10814, it+10824, it+10832,
-    it+10841, it+10851, it+10856, it+10866, it+10872, it+10881,
-    it+10889, it+10897, it+10907, it+10916, it+10924, it+10933,
-    it+10942, it+10951, it+10958, it+10967, it+10977, it+10984,
-    it+10991, it+10997, it+11005, it+11015, it+11024, it+11029,
-    it+11039, it+11048, it+11057, it+11062, it+11069, it+11078,
-    it+11088, it+11097, it+11107, it+11116, it+11124, it+11133,
-    it+11142, it+11148, it+11157, it+11167, it+11175, it+11185,
-    it+11194, it+11202, it+11211, it+11220, it+11228, it+11236,
-    it+11243, it+11253, it+11262, it+11272, it+11281, it+11290,
-    it+11299, it+11307, it+11317, it+11327, it+11335, it+11344,
-    it+11352, it+11361, it+11371, it+11380, it+11389, it+11399,
-    it+11408, it+11417, it+11425, it+11435, it+11443, it+11452,
-    it+11459, it+11467, it+11475, it+11484, it+11489, it+11498,
-    it+11506, it+11516, it+11525, it+11533, it+11541, it+11549,
-    it+11557, it+11566, it+11571, it+11579, it+11589, it+11597,
-    it+11604, it+11609, it+11618, it+11626, it+11633, it+11638,
-    it+11647, it+11654, it+11663, it+11670, it+11677, it+11687,
-    it+11695, it+11702, it+11711, it+11717, it+11725, it+11733,
-    it+11740, it+11749, it+11757, it+11765, it+11770, it+11778,
-    it+11785, it+11794, it+11800, it+11805, it+11813, it+11821,
-    it+11828, it+11837, it+11846, it+11853, it+11861, it+11871,
-    it+11880, it+11889, it+11897, it+11904, it+11912, it+11919,
-    it+11925, it+11932, it+11939, it+11948, it+11957, it+11966,
-    it+11972, it+11980, it+11990, it+11997, it+12005, it+12013,
-    it+12020, it+12026, it+12034, it+12044, it+12051, it+12060,
-    it+12067, it+12076, it+12084, it+12093, it+12103, it+12113,
-    it+12123, it+12132, it+12142, it+12151, it+12160, it+12169,
-    it+12175, it+12185, it+12194, it+12202, it+12209, it+12219,
-    it+12227, it+12234, it+12242, it+12250, it+12257, it+12265,
-    it+12273, it+12281, it+12290, it+12297, it+12306, it+12314,
-    it+12323, it+12332, it+12341, it+12351, it+12361, it+12370,
-    it+12377, it+12386, it+12395, it+12402, it+12412, it+12422,
-    it+12431, it+12440, it+12447, it+12453, it+12461, it+12471,
-    it+12481, it+12491, it+12499, it+12506, it+12515, it+12525,
-    it+12535, it+12543, it+12552, it+12562, it+12568, it+12578,
-    it+12587, it+12596, it+12601, it+12610, it+12617, it+12623,
-    it+12631, it+12639, it+12648, it+12655, it+12663, it+12670,
-    it+12676, it+12685, it+12695, it+12703, it+12711, it+12718,
-    it+12728, it+12736, it+12745, it+12753, it+12762, it+12772,
-    it+12778, it+12784, it+12792, it+12799, it+12807, it+12817,
-    it+12823, it+12832, it+12841, it+12849, it+12859, it+12868,
-    it+12876, it+12882, it+12891, it+12900, it+12910, it+12918,
-    it+12928, it+12936, it+12943, it+12951, it+12958, it+12964,
-    it+12972, it+12981, it+12989, it+12997, it+13007, it+13016,
-    it+13025, it+13033, it+13042, it+13047, it+13055, it+13065,
-    it+13073, it+13079, it+13087, it+13095, it+13102, it+13112,
-    it+13120, it+13129, it+13139, it+13148, it+13157, it+13164,
-    it+13173, it+13182, it+13191, it+13200, it+13209, it+13215,
-    it+13224, it+13231, it+13240, it+13248, it+13255, it+13264,
-    it+13270, it+13278, it+13286, it+13293, it+13302, it+13307,
-    it+13316, it+13325, it+13334, it+13340, it+13346, it+13354,
-    it+13364, it+13371, it+13379, it+13385, it+13393, it+13402,
-    it+13410, it+13416, it+13426, it+13436, it+13444, it+13450,
-    it+13458, it+13464, it+13471, it+13480, it+13488, it+13497,
-    it+13506, it+13513, it+13521, it+13530, it+13540, it+13549,
-    it+13558, it+13568, it+13577, it+13582, it+13592, it+13601,
-    it+13609, it+13617, it+13627, it+13636, it+13642, it+13650,
-    it+13659, it+13668, it+13676, it+13685, it+13693, it+13703,
-    it+13713, it+13721, it+13728, it+13735, it+13744, it+13753,
-    it+13761, it+13770, it+13778, it+13786, it+13792, it+13799,
-    it+13806, it+13815, it+13821, it+13828, it+13836, it+13845,
-    it+13853, it+13861, it+13869, it+13878, it+13887, it+13897,
-    it+13905, it+13914, it+13920, it+13929, it+13938, it+13946,
-    it+13953, it+13963, it+13968, it+13976, it+13984, it+13992,
-    it+14001, it+14011, it+14021, it+14030, it+14037, it+14045,
-    it+14053, it+14061, it+14069, it+14077, it+14084, it+14093,
-    it+14100, it+14109, it+14116, it+14125, it+14133, it+14142,
-    it+14151, it+14161, it+14166, it+14176, it+14184, it+14192,
-    it+14197, it+14205, it+14213, it+14221, it+14229, it+14239,
-    it+14245, it+14253, it+14261, it+14270, it+14276, it+14281,
-    it+14289, it+14298, it+14308, it+14314, it+14321, it+14329,
-    it+14336, it+14345, it+14355, it+14363, it+14369, it+14378,
-    it+14387, it+14392, it+14402, it+14410, it+14416, it+14424,
-    it+14431, it+14439, it+14446, it+14452, it+14459, it+14469,
-    it+14478, it+14483, it+14491, it+14498, it+14508, it+14514,
-    it+14522, it+14530, it+14540, it+14546, it+14554, it+14559,
-    it+14565, it+14574, it+14582, it+14592, it+14598, it+14604,
-    it+14612, it+14620, it+14628, it+14636, it+14644, it+14654,
-    it+14661, it+14670, it+14678, it+14686, it+14695, it+14703,
-    it+14712, it+14721, it+14729, it+14736, it+14745, it+14754,
-    it+14760, it+14768, it+14777, it+14786, it+14794, it+14803,
-    it+14813, it+14820, it+14828, it+14833, it+14843, it+14853,
-    it+14862, it+14869, it+14875, it+14882, it+14891, it+14899,
-    it+14908, it+14917, it+14925, it+14934, it+14942, it+14950,
-    it+14958, it+14967, it+14972, it+14979, it+14987, it+14995,
-    it+15004, it+15010, it+15018, it+15023, it+15031, it+15038,
-    it+15045, it+15054, it+15060, it+15066, it+15075, it+15085,
-    it+15092, it+15102, it+15111, it+15121, it+15129, it+15138,
-    it+15143, it+15148, it+15154, it+15162, it+15170, it+15175,
-    it+15182, it+15188, it+15195, it+15204, it+15212, it+15221,
-    it+15230, it+15237, it+15245, it+15255, it+15265, it+15274,
-    it+15282, it+15288, it+15295, it+15304, it+15313, it+15322,
-    it+15330, it+15338, it+15346, it+15355, it+15360, it+15370,
-    it+15378, it+15385, it+15392, it+15400, it+15409, it+15415,
-    it+15423, it+15430, it+15437, it+15446, it+15454, it+15461,
-    it+15468, it+15476, it+15483, it+15490, it+15500, it+15506,
-    it+15513, it+15521, it+15530, it+15539, it+15544, it+15552,
-    it+15562, it+15570, it+15579, it+15587, it+15596, it+15604,
-    it+15612, it+15622, it+15631, it+15639, it+15648, it+15658,
-    it+15667, it+15675, it+15683, it+15690, it+15695, it+15703,
-    it+15710, it+15720, it+15726, it+15733, it+15741, it+15750,
-    it+15760, it+15768, it+15776, it+15782, it+15790, it+15797,
-    it+15802, it+15810, it+15818, it+15826, it+15833, it+15841,
-    it+15846, it+15851, it+15860, it+15867, it+15873, it+15882,
-    it+15890, it+15899, it+15905, it+15913, it+15921, it+15929,
-    it+15936, it+15944, it+15949, it+15957, it+15965, it+15973,
-    it+15979, it+15987, it+15993, it+15999, it+16006, it+16015,
-    it+16022, it+16027, it+16033,
+static const uint16_t it_o[] = {
+    0, 6, 15, 24, 30, 37, 45, 54, 63, 72, 80, 89,
+    97, 105, 111, 117, 122, 131, 140, 146, 153, 162, 169, 178,
+    186, 192, 201, 209, 218, 226, 234, 243, 252, 258, 267, 273,
+    280, 288, 297, 303, 311, 320, 329, 338, 345, 354, 360, 368,
+    377, 382, 389, 394, 403, 412, 417, 425, 433, 439, 448, 457,
+    465, 473, 482, 491, 498, 506, 513, 522, 531, 539, 548, 556,
+    563, 571, 578, 587, 595, 603, 610, 618, 624, 632, 641, 647,
+    655, 663, 672, 681, 687, 693, 702, 710, 719, 728, 737, 746,
+    753, 758, 766, 773, 780, 787, 794, 801, 810, 818, 824, 833,
+    842, 847, 856, 864, 873, 878, 886, 895, 901, 910, 919, 928,
+    936, 944, 951, 959, 968, 977, 986, 994, 1002, 1009, 1017, 1026,
+    1033, 1041, 1049, 1056, 1063, 1068, 1076, 1083, 1092, 1100, 1108, 1117,
+    1122, 1131, 1139, 1148, 1156, 1163, 1172, 1180, 1186, 1192, 1201, 1207,
+    1216, 1221, 1230, 1238, 1243, 1252, 1259, 1268, 1276, 1284, 1292, 1298,
+    1305, 1314, 1322, 1330, 1338, 1346, 1354, 1362, 1371, 1379, 1388, 1394,
+    1403, 1410, 1420, 1427, 1433, 1440, 1448, 1455, 1463, 1470, 1475, 1483,
+    1492, 1500, 1506, 1514, 1520, 1527, 1535, 1543, 1551, 1559, 1568, 1576,
+    1582, 1591, 1599, 1607, 1616, 1622, 1630, 1638, 1644, 1649, 1656, 1662,
+    1668, 1675, 1681, 1687, 1696, 1704, 1712, 1717, 1725, 1730, 1737, 1742,
+    1749, 1756, 1761, 1770, 1776, 1785, 1793, 1800, 1809, 1818, 1824, 1833,
+    1841, 1850, 1858, 1866, 1875, 1882, 1889, 1897, 1906, 1912, 1918, 1927,
+    1935, 1943, 1951, 1959, 1965, 1972, 1980, 1989, 1998, 2005, 2013, 2023,
+    2032, 2041, 2047, 2056, 2063, 2069, 2077, 2082, 2089, 2097, 2102, 2108,
+    2114, 2122, 2131, 2139, 2145, 2153, 2160, 2169, 2177, 2185, 2193, 2199,
+    2207, 2215, 2224, 2232, 2240, 2247, 2255, 2262, 2270, 2275, 2282, 2290,
+    2298, 2305, 2313, 2322, 2331, 2339, 2345, 2353, 2362, 2371, 2377, 2385,
+    2394, 2403, 2413, 2422, 2430, 2438, 2443, 2451, 2460, 2468, 2476, 2483,
+    2491, 2497, 2505, 2514, 2522, 2529, 2537, 2547, 2552, 2559, 2569, 2578,
+    2586, 2592, 2599, 2608, 2615, 2621, 2626, 2632, 2639, 2646, 2655, 2663,
+    2669, 2678, 2687, 2692, 2701, 2709, 2715, 2724, 2733, 2739, 2747, 2755,
+    2765, 2772, 2780, 2787, 2796, 2804, 2810, 2816, 2824, 2831, 2840, 2848,
+    2856, 2864, 2871, 2879, 2889, 2895, 2900, 2907, 2916, 2923, 2932, 2939,
+    2947, 2956, 2965, 2975, 2983, 2992, 3002, 3010, 3019, 3028, 3036, 3044,
+    3051, 3061, 3069, 3077, 3086, 3094, 3102, 3108, 3116, 3123, 3131, 3139,
+    3148, 3156, 3163, 3171, 3180, 3187, 3195, 3203, 3212, 3218, 3226, 3234,
+    3240, 3248, 3254, 3262, 3271, 3280, 3287, 3294, 3301, 3308, 3316, 3323,
+    3332, 3340, 3346, 3354, 3362, 3367, 3373, 3381, 3390, 3398, 3406, 3414,
+    3421, 3429, 3437, 3445, 3454, 3461, 3469, 3477, 3485, 3494, 3503, 3511,
+    3517, 3526, 3534, 3542, 3548, 3556, 3565, 3572, 3581, 3590, 3599, 3606,
+    3616, 3624, 3634, 3643, 3653, 3660, 3669, 3678, 3685, 3692, 3700, 3709,
+    3718, 3726, 3735, 3744, 3752, 3760, 3767, 3776, 3781, 3789, 3796, 3804,
+    3813, 3821, 3829, 3838, 3847, 3856, 3861, 3868, 3876, 3885, 3894, 3902,
+    3910, 3919, 3925, 3931, 3938, 3947, 3956, 3964, 3969, 3977, 3982, 3990,
+    3997, 4005, 4011, 4018, 4025, 4034, 4041, 4046, 4052, 4060, 4069, 4075,
+    4083, 4088, 4096, 4105, 4111, 4119, 4125, 4134, 4142, 4151, 4156, 4164,
+    4172, 4182, 4191, 4200, 4209, 4216, 4224, 4231, 4237, 4242, 4247, 4253,
+    4261, 4269, 4276, 4282, 4290, 4299, 4308, 4314, 4323, 4330, 4338, 4345,
+    4353, 4361, 4368, 4376, 4384, 4393, 4401, 4408, 4417, 4424, 4429, 4436,
+    4442, 4450, 4458, 4467, 4472, 4480, 4488, 4496, 4502, 4510, 4519, 4524,
+    4532, 4541, 4549, 4558, 4567, 4573, 4581, 4590, 4596, 4604, 4613, 4621,
+    4626, 4633, 4642, 4650, 4658, 4667, 4675, 4682, 4690, 4695, 4704, 4711,
+    4717, 4726, 4734, 4742, 4749, 4758, 4767, 4775, 4781, 4790, 4797, 4805,
+    4811, 4820, 4825, 4834, 4843, 4851, 4858, 4866, 4874, 4883, 4888, 4897,
+    4904, 4911, 4916, 4923, 4929, 4936, 4944, 4952, 4961, 4970, 4976, 4984,
+    4992, 5000, 5006, 5012, 5018, 5026, 5031, 5040, 5045, 5053, 5062, 5069,
+    5075, 5083, 5090, 5096, 5104, 5113, 5119, 5126, 5134, 5142, 5149, 5156,
+    5165, 5172, 5181, 5188, 5195, 5204, 5212, 5221, 5230, 5236, 5244, 5252,
+    5262, 5270, 5278, 5286, 5291, 5300, 5308, 5316, 5322, 5331, 5337, 5346,
+    5355, 5365, 5373, 5380, 5386, 5395, 5402, 5410, 5417, 5426, 5433, 5442,
+    5450, 5456, 5464, 5472, 5479, 5484, 5493, 5499, 5505, 5513, 5520, 5525,
+    5532, 5541, 5547, 5555, 5563, 5571, 5579, 5585, 5594, 5600, 5609, 5617,
+    5626, 5634, 5643, 5649, 5656, 5663, 5672, 5677, 5686, 5692, 5700, 5708,
+    5713, 5722, 5730, 5739, 5745, 5754, 5763, 5769, 5776, 5782, 5790, 5798,
+    5807, 5814, 5820, 5827, 5834, 5842, 5851, 5859, 5866, 5874, 5882, 5888,
+    5894, 5899, 5906, 5914, 5921, 5927, 5935, 5943, 5949, 5957, 5964, 5971,
+    5980, 5988, 5995, 6001, 6008, 6016, 6023, 6030, 6037, 6044, 6053, 6059,
+    6066, 6075, 6080, 6088, 6097, 6103, 6112, 6120, 6126, 6131, 6138, 6147,
+    6154, 6161, 6170, 6176, 6183, 6192, 6201, 6209, 6218, 6226, 6233, 6240,
+    6248, 6257, 6265, 6272, 6280, 6288, 6297, 6305, 6314, 6323, 6331, 6340,
+    6348, 6357, 6365, 6374, 6383, 6390, 6399, 6405, 6412, 6420, 6428, 6437,
+    6446, 6455, 6463, 6471, 6479, 6488, 6496, 6504, 6514, 6523, 6530, 6538,
+    6546, 6555, 6564, 6573, 6580, 6589, 6597, 6607, 6616, 6623, 6630, 6639,
+    6648, 6656, 6663, 6669, 6677, 6685, 6694, 6703, 6711, 6719, 6728, 6737,
+    6745, 6752, 6760, 6767, 6777, 6783, 6792, 6800, 6807, 6815, 6820, 6826,
+    6835, 6844, 6852, 6858, 6866, 6873, 6881, 6888, 6896, 6904, 6911, 6918,
+    6926, 6932, 6941, 6947, 6953, 6959, 6966, 6974, 6980, 6990, 6995, 7004,
+    7011, 7016, 7024, 7030, 7039, 7048, 7056, 7064, 7071, 7079, 7084, 7091,
+    7097, 7102, 7110, 7117, 7125, 7130, 7137, 7145, 7152, 7160, 7168, 7176,
+    7181, 7190, 7195, 7204, 7211, 7220, 7226, 7231, 7239, 7247, 7253, 7259,
+    7267, 7276, 7283, 7292, 7299, 7306, 7313, 7321, 7327, 7336, 7345, 7354,
+    7364, 7372, 7378, 7387, 7392, 7399, 7408, 7417, 7427, 7435, 7443, 7452,
+    7460, 7469, 7475, 7484, 7492, 7500, 7506, 7515, 7524, 7532, 7540, 7550,
+    7560, 7568, 7575, 7583, 7591, 7601, 7610, 7619, 7628, 7633, 7641, 7647,
+    7655, 7663, 7668, 7676, 7685, 7693, 7699, 7708, 7713, 7721, 7729, 7737,
+    7744, 7752, 7762, 7767, 7775, 7783, 7791, 7799, 7805, 7814, 7821, 7828,
+    7835, 7844, 7849, 7856, 7863, 7872, 7880, 7888, 7894, 7903, 7911, 7920,
+    7926, 7935, 7945, 7953, 7962, 7969, 7976, 7982, 7987, 7995, 8005, 8011,
+    8019, 8029, 8036, 8045, 8053, 8061, 8069, 8074, 8082, 8092, 8099, 8108,
+    8117, 8123, 8131, 8141, 8147, 8153, 8160, 8166, 8175, 8183, 8191, 8201,
+    8210, 8217, 8223, 8231, 8238, 8243, 8251, 8258, 8267, 8272, 8280, 8286,
+    8296, 8304, 8311, 8319, 8327, 8336, 8345, 8353, 8362, 8371, 8379, 8388,
+    8396, 8404, 8412, 8420, 8426, 8434, 8442, 8451, 8456, 8466, 8474, 8480,
+    8487, 8494, 8501, 8506, 8511, 8518, 8526, 8534, 8544, 8553, 8560, 8568,
+    8577, 8585, 8592, 8598, 8605, 8611, 8619, 8626, 8634, 8639, 8648, 8656,
+    8665, 8671, 8677, 8686, 8696, 8703, 8713, 8723, 8733, 8738, 8746, 8754,
+    8762, 8770, 8778, 8788, 8796, 8801, 8808, 8817, 8825, 8832, 8838, 8848,
+    8854, 8862, 8871, 8877, 8883, 8893, 8900, 8906, 8912, 8921, 8931, 8936,
+    8944, 8953, 8961, 8969, 8975, 8982, 8992, 9000, 9007, 9016, 9024, 9034,
+    9039, 9048, 9057, 9066, 9074, 9083, 9092, 9099, 9106, 9111, 9117, 9126,
+    9133, 9142, 9149, 9154, 9163, 9172, 9177, 9183, 9188, 9197, 9204, 9212,
+    9218, 9224, 9230, 9238, 9246, 9254, 9262, 9267, 9277, 9282, 9291, 9299,
+    9307, 9313, 9318, 9325, 9335, 9344, 9352, 9357, 9364, 9372, 9381, 9387,
+    9396, 9404, 9413, 9422, 9429, 9437, 9442, 9450, 9457, 9465, 9474, 9483,
+    9491, 9500, 9508, 9518, 9526, 9533, 9541, 9550, 9559, 9566, 9573, 9580,
+    9588, 9597, 9605, 9614, 9622, 9630, 9635, 9642, 9650, 9659, 9669, 9679,
+    9689, 9697, 9706, 9712, 9722, 9731, 9740, 9748, 9757, 9765, 9770, 9780,
+    9787, 9795, 9805, 9811, 9819, 9826, 9835, 9843, 9851, 9857, 9864, 9872,
+    9880, 9888, 9894, 9899, 9908, 9916, 9923, 9932, 9939, 9945, 9952, 9960,
+    9967, 9976, 9985, 9992, 10001, 10008, 10016, 10024, 10032, 10039, 10047, 10056,
+    10065, 10074, 10082, 10089, 10098, 10106, 10115, 10123, 10133, 10142, 10148, 10157,
+    10165, 10172, 10181, 10187, 10196, 10204, 10211, 10219, 10225, 10233, 10238, 10247,
+    10256, 10266, 10275, 10282, 10289, 10296, 10304, 10313, 10321, 10330, 10339, 10348,
+    10356, 10366, 10376, 10385, 10394, 10403, 10409, 10418, 10426, 10435, 10443, 10452,
+    10460, 10469, 10478, 10487, 10495, 10504, 10512, 10520, 10526, 10535, 10542, 10550,
+    10557, 10566, 10573, 10582, 10588, 10594, 10601, 10610, 10618, 10626, 10634, 10639,
+    10646, 10655, 10661, 10669, 10675, 10684, 10694, 10703, 10712, 10720, 10728, 10736,
+    10742, 10750, 10758, 10763, 10772, 10782, 10789, 10796, 10805, 10814, 10824, 10832,
+    10841, 10851, 10856, 10866, 10872, 10881, 10889, 10897, 10907, 10916, 10924, 10933,
+    10942, 10951, 10958, 10967, 10977, 10984, 10991, 10997, 11005, 11015, 11024, 11029,
+    11039, 11048, 11057, 11062, 11069, 11078, 11088, 11097, 11107, 11116, 11124, 11133,
+    11142, 11148, 11157, 11167, 11175, 11185, 11194, 11202, 11211, 11220, 11228, 11236,
+    11243, 11253, 11262, 11272, 11281, 11290, 11299, 11307, 11317, 11327, 11335, 11344,
+    11352, 11361, 11371, 11380, 11389, 11399, 11408, 11417, 11425, 11435, 11443, 11452,
+    11459, 11467, 11475, 11484, 11489, 11498, 11506, 11516, 11525, 11533, 11541, 11549,
+    11557, 11566, 11571, 11579, 11589, 11597, 11604, 11609, 11618, 11626, 11633, 11638,
+    11647, 11654, 11663, 11670, 11677, 11687, 11695, 11702, 11711, 11717, 11725, 11733,
+    11740, 11749, 11757, 11765, 11770, 11778, 11785, 11794, 11800, 11805, 11813, 11821,
+    11828, 11837, 11846, 11853, 11861, 11871, 11880, 11889, 11897, 11904, 11912, 11919,
+    11925, 11932, 11939, 11948, 11957, 11966, 11972, 11980, 11990, 11997, 12005, 12013,
+    12020, 12026, 12034, 12044, 12051, 12060, 12067, 12076, 12084, 12093, 12103, 12113,
+    12123, 12132, 12142, 12151, 12160, 12169, 12175, 12185, 12194, 12202, 12209, 12219,
+    12227, 12234, 12242, 12250, 12257, 12265, 12273, 12281, 12290, 12297, 12306, 12314,
+    12323, 12332, 12341, 12351, 12361, 12370, 12377, 12386, 12395, 12402, 12412, 12422,
+    12431, 12440, 12447, 12453, 12461, 12471, 12481, 12491, 12499, 12506, 12515, 12525,
+    12535, 12543, 12552, 12562, 12568, 12578, 12587, 12596, 12601, 12610, 12617, 12623,
+    12631, 12639, 12648, 12655, 12663, 12670, 12676, 12685, 12695, 12703, 12711, 12718,
+    12728, 12736, 12745, 12753, 12762, 12772, 12778, 12784, 12792, 12799, 12807, 12817,
+    12823, 12832, 12841, 12849, 12859, 12868, 12876, 12882, 12891, 12900, 12910, 12918,
+    12928, 12936, 12943, 12951, 12958, 12964, 12972, 12981, 12989, 12997, 13007, 13016,
+    13025, 13033, 13042, 13047, 13055, 13065, 13073, 13079, 13087, 13095, 13102, 13112,
+    13120, 13129, 13139, 13148, 13157, 13164, 13173, 13182, 13191, 13200, 13209, 13215,
+    13224, 13231, 13240, 13248, 13255, 13264, 13270, 13278, 13286, 13293, 13302, 13307,
+    13316, 13325, 13334, 13340, 13346, 13354, 13364, 13371, 13379, 13385, 13393, 13402,
+    13410, 13416, 13426, 13436, 13444, 13450, 13458, 13464, 13471, 13480, 13488, 13497,
+    13506, 13513, 13521, 13530, 13540, 13549, 13558, 13568, 13577, 13582, 13592, 13601,
+    13609, 13617, 13627, 13636, 13642, 13650, 13659, 13668, 13676, 13685, 13693, 13703,
+    13713, 13721, 13728, 13735, 13744, 13753, 13761, 13770, 13778, 13786, 13792, 13799,
+    13806, 13815, 13821, 13828, 13836, 13845, 13853, 13861, 13869, 13878, 13887, 13897,
+    13905, 13914, 13920, 13929, 13938, 13946, 13953, 13963, 13968, 13976, 13984, 13992,
+    14001, 14011, 14021, 14030, 14037, 14045, 14053, 14061, 14069, 14077, 14084, 14093,
+    14100, 14109, 14116, 14125, 14133, 14142, 14151, 14161, 14166, 14176, 14184, 14192,
+    14197, 14205, 14213, 14221, 14229, 14239, 14245, 14253, 14261, 14270, 14276, 14281,
+    14289, 14298, 14308, 14314, 14321, 14329, 14336, 14345, 14355, 14363, 14369, 14378,
+    14387, 14392, 14402, 14410, 14416, 14424, 14431, 14439, 14446, 14452, 14459, 14469,
+    14478, 14483, 14491, 14498, 14508, 14514, 14522, 14530, 14540, 14546, 14554, 14559,
+    14565, 14574, 14582, 14592, 14598, 14604, 14612, 14620, 14628, 14636, 14644, 14654,
+    14661, 14670, 14678, 14686, 14695, 14703, 14712, 14721, 14729, 14736, 14745, 14754,
+    14760, 14768, 14777, 14786, 14794, 14803, 14813, 14820, 14828, 14833, 14843, 14853,
+    14862, 14869, 14875, 14882, 14891, 14899, 14908, 14917, 14925, 14934, 14942, 14950,
+    14958, 14967, 14972, 14979, 14987, 14995, 15004, 15010, 15018, 15023, 15031, 15038,
+    15045, 15054, 15060, 15066, 15075, 15085, 15092, 15102, 15111, 15121, 15129, 15138,
+    15143, 15148, 15154, 15162, 15170, 15175, 15182, 15188, 15195, 15204, 15212, 15221,
+    15230, 15237, 15245, 15255, 15265, 15274, 15282, 15288, 15295, 15304, 15313, 15322,
+    15330, 15338, 15346, 15355, 15360, 15370, 15378, 15385, 15392, 15400, 15409, 15415,
+    15423, 15430, 15437, 15446, 15454, 15461, 15468, 15476, 15483, 15490, 15500, 15506,
+    15513, 15521, 15530, 15539, 15544, 15552, 15562, 15570, 15579, 15587, 15596, 15604,
+    15612, 15622, 15631, 15639, 15648, 15658, 15667, 15675, 15683, 15690, 15695, 15703,
+    15710, 15720, 15726, 15733, 15741, 15750, 15760, 15768, 15776, 15782, 15790, 15797,
+    15802, 15810, 15818, 15826, 15833, 15841, 15846, 15851, 15860, 15867, 15873, 15882,
+    15890, 15899, 15905, 15913, 15921, 15929, 15936, 15944, 15949, 15957, 15965, 15973,
+    15979, 15987, 15993, 15999, 16006, 16015, 16022, 16027,
+   };
+
+static const uint16_t it_d[] = {
+    11, 0, 137, 14, 184, 8, 80, 312, 2, 24, 48, 69,
+    76, 4, 17, 33, 56, 2, 16, 1, 6, 85, 119, 2,
+    194, 103, 104, 1, 154, 98, 43, 164, 17, 355, 0, 0,
+    11, 14, 723, 9, 254, 17, 175, 170, 166, 76, 0, 0,
+    446, 3, 0, 6, 268, 81, 1, 341, 29, 244, 1, 9,
+    1, 38, 1, 3, 3, 19, 228, 8, 6, 84, 1, 8,
+    3, 0, 66, 1, 15, 60, 81, 13, 38, 268, 12, 0,
+    7, 1, 7, 13, 6, 123, 1, 69, 56, 1, 77, 0,
+    61, 65, 15, 15, 1, 1, 1, 83, 6, 5, 0, 15,
+    193, 150, 9, 12, 121, 52, 220, 207, 0, 107, 0, 5,
+    41, 96, 314, 12, 8, 10, 43, 497, 16, 22, 2, 0,
+    2, 296, 46, 1, 2, 33, 38, 2, 0, 137, 4, 241,
+    97, 0, 13, 19, 205, 23, 0, 75, 10, 53, 15, 36,
+    4, 0, 46, 42, 92, 13, 229, 145, 507, 110, 8, 27,
+    44, 32, 11, 6, 75, 0, 589, 0, 3, 33, 135, 116,
+    9, 0, 3, 217, 205, 8, 616, 0, 9, 179, 0, 218,
+    391, 51, 0, 0, 10, 6, 1343, 5, 41, 99, 247, 0,
+    682, 10, 30, 112, 0, 0, 211, 120, 223, 206, 20, 135,
+    5, 20, 334, 13, 283, 67, 41, 3, 85, 43, 206, 123,
+    37, 28, 0, 37, 56, 282, 35, 1, 7, 121, 210, 0,
+    231, 47, 45, 38, 483, 194, 36, 5, 14, 1, 26, 65,
+    1233, 2, 24, 192, 51, 73, 0, 1139, 62, 147, 17, 115,
+    16, 4, 813, 195, 61, 4, 1, 83, 3, 3, 33, 0,
+    281, 195, 53, 4, 63, 586, 106, 743, 0, 5, 69, 175,
+    3, 128, 7, 86, 3, 144, 20, 4, 30, 144, 48, 251,
+    2, 0, 0, 30, 96, 325, 37, 34, 32, 1, 13, 405,
+    194, 5, 118, 67, 5, 1, 12, 187, 98, 38, 50, 37,
+    191, 23, 38, 2, 651, 2, 0, 0, 30, 223, 696, 44,
+    58, 319, 2, 11, 503, 324, 1113, 7, 8, 204, 1545, 132,
+    235, 67, 6, 14, 0, 0, 77, 259, 184, 2, 121, 247,
+    988, 20, 738, 56, 40, 1, 55, 46, 34, 146, 0, 227,
+    252, 12, 1, 393, 34, 1, 89, 786, 0, 29, 1, 638,
+    22, 10, 138, 12, 2, 11, 6, 1, 47, 151, 500, 61,
+    2955, 13, 436, 0, 661, 398, 0, 222, 64, 0, 17, 818,
+    213, 104, 1, 32, 2193, 3, 110, 4, 2326, 134, 831, 318,
+    5, 276, 1674, 13, 1, 0, 0, 28, 83, 0, 0, 5,
+    172, 1698, 1254, 576, 1224, 6, 0, 0, 1, 63, 2083, 118,
+    258, 25, 48, 1626, 45, 41, 710, 5, 3, 266, 1630, 12,
+    2254, 581, 267, 1020, 583, 2352, 13, 321, 115, 321, 288, 35,
+    494, 0, 101, 1, 15, 6, 33, 586, 0, 494, 3657, 309,
+    81, 1902, 261, 21, 2248, 3797, 0, 1157, 141, 50, 1, 4,
+    2869, 828, 1058, 220, 120, 20, 127, 164, 1402, 7, 147, 108,
+    822, 2, 20, 5, 12408, 251, 753, 959,
+   };
+static const uint16_t it_h[] = {
+    1445, 834, 1637, 866, 1463, 691, 1674, 788, 1167, 1273, 106, 760,
+    216, 2012, 641, 624, 1707, 1706, 451, 792, 1422, 88, 1999, 923,
+    994, 1394, 14, 626, 286, 1719, 255, 453, 1708, 599, 1420, 258,
+    565, 1834, 1036, 495, 2037, 1459, 1127, 646, 1542, 1426, 546, 1640,
+    1746, 306, 1620, 906, 1870, 1211, 2043, 361, 522, 1704, 160, 1254,
+    1141, 1583, 231, 249, 95, 1355, 1306, 1441, 291, 915, 277, 32,
+    1822, 875, 322, 163, 2044, 1039, 584, 1961, 282, 683, 1366, 26,
+    475, 411, 189, 1974, 754, 1826, 982, 1788, 1972, 1779, 883, 318,
+    981, 1837, 29, 1789, 300, 494, 349, 1055, 398, 1095, 273, 110,
+    1946, 1471, 1378, 598, 772, 487, 234, 1835, 1395, 1483, 1842, 1993,
+    839, 983, 1742, 1847, 541, 419, 581, 1487, 869, 1024, 31, 1571,
+    1933, 1491, 1113, 292, 221, 1881, 2027, 718, 1479, 115, 1814, 921,
+    1920, 1896, 884, 2014, 1170, 1303, 121, 325, 874, 1986, 2003, 672,
+    142, 1601, 1824, 797, 1533, 1315, 530, 1951, 67, 1921, 888, 1615,
+    944, 1003, 716, 1370, 208, 1054, 1584, 679, 1783, 46, 1981, 364,
+    655, 1414, 1097, 1228, 711, 919, 633, 1793, 308, 1386, 332, 130,
+    408, 1145, 1992, 1430, 722, 1720, 1569, 811, 1860, 1375, 1328, 825,
+    714, 365, 176, 1320, 363, 1543, 120, 1091, 85, 1035, 564, 960,
+    1085, 1736, 870, 903, 1916, 1209, 161, 1474, 537, 323, 1444, 856,
+    164, 1350, 1604, 1828, 1374, 980, 932, 1949, 1398, 468, 474, 1692,
+    902, 821, 1890, 1963, 1724, 520, 1695, 55, 533, 972, 1983, 945,
+    240, 769, 728, 152, 1727, 630, 455, 951, 895, 1468, 977, 1405,
+    153, 146, 101, 1014, 619, 1359, 1572, 1632, 1559, 1821, 500, 1616,
+    1731, 885, 442, 109, 1100, 1106, 126, 1863, 1514, 1728, 285, 0,
+    688, 1680, 1372, 596, 320, 1120, 1979, 1687, 490, 544, 1457, 1752,
+    122, 1769, 1043, 966, 1802, 1947, 653, 1177, 526, 1087, 1401, 749,
+    1906, 777, 2033, 1766, 73, 841, 897, 750, 299, 1119, 1912, 529,
+    1535, 2034, 1319, 108, 1878, 717, 1114, 241, 246, 1421, 1762, 1443,
+    1528, 181, 7, 1501, 808, 1922, 1619, 861, 1791, 1862, 916, 872,
+    362, 1825, 1060, 723, 82, 1761, 1940, 1028, 1625, 149, 1723, 1469,
+    735, 42, 941, 639, 900, 87, 1759, 1467, 959, 878, 1589, 758,
+    514, 1850, 1277, 1810, 124, 557, 1573, 643, 826, 1976, 1175, 1858,
+    1079, 933, 1712, 350, 730, 21, 1313, 380, 628, 1883, 868, 1650,
+    1948, 1089, 1994, 1040, 2046, 1510, 1676, 212, 1146, 1675, 213, 988,
+    1624, 51, 1289, 1276, 1011, 2009, 72, 1214, 673, 1439, 1685, 23,
+    336, 1966, 775, 254, 1647, 459, 1998, 807, 2035, 1025, 260, 935,
+    1969, 974, 400, 954, 34, 651, 1840, 1611, 479, 779, 1646, 1418,
+    1283, 304, 604, 399, 132, 40, 1658, 1717, 1750, 1852, 476, 887,
+    248, 511, 172, 436, 1651, 141, 509, 1475, 1076, 1709, 1908, 1059,
+    785, 503, 918, 1718, 1581, 1304, 726, 1057, 346, 155, 946, 912,
+    2032, 1869, 1485, 1710, 757, 1037, 1666, 159, 736, 1889, 1532, 824,
+    896, 1702, 2031, 575, 795, 1368, 1576, 1080, 708, 242, 1755, 1269,
+    1833, 899, 16, 1222, 1424, 591, 701, 704, 333, 569, 948, 168,
+    1665, 759, 203, 562, 1588, 370, 1259, 613, 52, 28, 1721, 1201,
+    1110, 1349, 1768, 846, 965, 809, 184, 1403, 386, 431, 660, 1521,
+    171, 1312, 1438, 275, 417, 1324, 1001, 955, 1019, 1278, 1117, 1005,
+    2038, 631, 1323, 1630, 1161, 802, 2, 850, 558, 174, 547, 1216,
+    310, 269, 297, 402, 1476, 734, 1009, 713, 1196, 41, 958, 1953,
+    1462, 986, 877, 561, 1614, 58, 1309, 975, 1715, 1301, 725, 128,
+    264, 1582, 473, 1477, 1513, 1670, 448, 68, 1431, 1450, 379, 430,
+    738, 331, 1034, 239, 35, 743, 1238, 83, 1070, 513, 165, 727,
+    1875, 1778, 199, 845, 742, 1568, 1381, 1078, 804, 167, 1156, 1429,
+    1272, 489, 1143, 849, 715, 1492, 157, 1489, 1705, 1088, 671, 1795,
+    1333, 549, 1823, 997, 1923, 745, 38, 1168, 358, 1155, 1073, 984,
+    2021, 1523, 1204, 761, 1626, 1029, 953, 1193, 1679, 1917, 1271, 207,
+    927, 1565, 342, 1884, 257, 461, 1636, 752, 1809, 2017, 762, 425,
+    813, 1407, 1030, 1586, 843, 1663, 6, 1517, 1496, 1334, 1082, 1544,
+    879, 467, 1531, 810, 1411, 178, 289, 1856, 587, 265, 612, 880,
+    17, 2004, 18, 74, 644, 1913, 496, 367, 968, 2016, 556, 1064,
+    1633, 1599, 1678, 908, 356, 828, 1546, 1253, 1478, 1854, 1902, 1152,
+    1434, 638, 148, 1726, 1701, 1353, 1197, 721, 746, 1877, 949, 61,
+    1329, 1732, 354, 440, 747, 1991, 582, 412, 1512, 276, 1302, 1844,
+    125, 694, 198, 1836, 499, 1390, 2023, 1406, 1508, 1412, 1173, 1627,
+    295, 177, 1041, 1031, 1138, 535, 1703, 1284, 1643, 978, 1183, 1997,
+    1499, 281, 1737, 833, 33, 1461, 57, 169, 909, 1530, 1585, 1872,
+    635, 675, 1179, 1936, 209, 985, 854, 1174, 447, 477, 43, 901,
+    1820, 79, 550, 1380, 1980, 287, 1527, 512, 803, 627, 1964, 840,
+    1885, 700, 1428, 1628, 1861, 1227, 1553, 1358, 1493, 458, 1749, 1341,
+    283, 480, 1258, 75, 1472, 662, 979, 1187, 175, 505, 791, 233,
+    39, 996, 210, 450, 211, 45, 1502, 719, 1996, 324, 1371, 508,
+    1590, 1446, 202, 1416, 873, 1505, 1447, 1764, 991, 729, 1907, 1673,
+    330, 1435, 1134, 69, 1012, 993, 433, 1262, 1182, 1261, 98, 296,
+    224, 664, 1977, 1427, 24, 25, 1224, 1657, 917, 1220, 401, 781,
+    1887, 5, 586, 776, 64, 827, 594, 818, 1385, 1629, 1649, 136,
+    573, 376, 1298, 1682, 1613, 1733, 105, 1556, 1944, 667, 1122, 1806,
+    27, 1808, 464, 47, 2019, 1751, 288, 313, 1696, 1053, 1859, 410,
+    1971, 1464, 1886, 670, 377, 1425, 2013, 1291, 1664, 218, 134, 623,
+    964, 424, 577, 351, 929, 1800, 1519, 1124, 2008, 615, 1050, 1065,
+    1570, 355, 406, 1092, 1068, 315, 1504, 889, 590, 1466, 739, 914,
+    876, 1327, 1515, 259, 127, 3, 1557, 911, 348, 1882, 563, 267,
+    1480, 84, 466, 384, 1622, 1905, 220, 920, 378, 1164, 886, 1294,
+    1667, 1669, 1777, 862, 1423, 1402, 1880, 1465, 848, 1693, 1148, 1484,
+    328, 1563, 1734, 1332, 817, 1158, 1655, 1744, 334, 793, 140, 1873,
+    383, 1935, 9, 1668, 938, 657, 1503, 658, 501, 748, 1150, 465,
+    1198, 284, 663, 1270, 989, 1032, 1818, 568, 206, 1453, 1377, 579,
+    925, 1436, 1849, 498, 1058, 1811, 629, 1166, 528, 2020, 144, 1660,
+    2029, 1716, 1540, 1500, 1995, 1551, 1684, 485, 864, 1246, 204, 1498,
+    957, 1240, 1417, 1845, 1763, 129, 1729, 1612, 244, 1652, 353, 469,
+    274, 271, 1066, 1929, 96, 2047, 478, 423, 1900, 1410, 420, 1437,
+    1376, 1952, 1807, 1409, 1898, 1300, 1237, 950, 992, 1506, 1470, 312,
+    1495, 552, 113, 2024, 571, 235, 1606, 690, 409, 1396, 329, 645,
+    1574, 1074, 1638, 1131, 1564, 583, 1317, 1399, 1413, 12, 636, 961,
+    185, 536, 1433, 1987, 741, 352, 971, 1488, 517, 1567, 766, 936,
+    782, 491, 228, 1451, 674, 1361, 4, 486, 542, 89, 1771, 1522,
+    553, 763, 1260, 215, 1, 697, 1550, 280, 1711, 1781, 1026, 397,
+    1400, 837, 737, 1536, 187, 625, 585, 1285, 1867, 1147, 689, 1279,
+    632, 1071, 1888, 506, 1874, 1516, 279, 1805, 2042, 1618, 1340, 470,
+    907, 1321, 337, 698, 123, 1560, 1379, 527, 226, 1215, 1192, 1545,
+    462, 732, 1191, 1282, 387, 196, 382, 518, 1364, 1596, 1096, 1797,
+    1776, 1686, 1552, 251, 942, 1623, 317, 1745, 1988, 1311, 456, 1784,
+    1171, 1541, 789, 1250, 1772, 484, 1415, 1689, 1688, 1458, 1765, 256,
+    1135, 1753, 427, 531, 1775, 1295, 1794, 186, 1105, 327, 1286, 1698,
+    449, 381, 30, 692, 853, 1452, 1244, 1960, 1360, 1490, 832, 1205,
+    1308, 620, 1937, 1547, 973, 1787, 415, 373, 1700, 114, 931, 1061,
+    1959, 1813, 578, 321, 1830, 1938, 1133, 1267, 268, 421, 1044, 1605,
+    1460, 139, 1645, 225, 1539, 648, 1223, 392, 15, 1901, 904, 1086,
+    1384, 1735, 940, 1000, 1801, 48, 1326, 1268, 1248, 1265, 1075, 19,
+    720, 618, 1163, 190, 238, 59, 1554, 1194, 1578, 1661, 13, 1108,
+    1072, 1226, 1876, 1561, 1635, 50, 956, 1383, 707, 601, 1118, 428,
+    1335, 1322, 1140, 11, 559, 1217, 1067, 1348, 1210, 92, 390, 525,
+    1975, 770, 822, 1941, 1363, 463, 8, 1218, 1644, 1388, 170, 1338,
+    357, 614, 1864, 53, 497, 2036, 610, 696, 1945, 1654, 593, 773,
+    1925, 1846, 200, 1672, 787, 1722, 94, 1010, 665, 634, 1190, 1018,
+    1549, 1186, 1841, 695, 1597, 112, 551, 261, 1297, 1595, 1369, 1229,
+    368, 990, 270, 1694, 1351, 928, 1978, 790, 606, 1208, 507, 339,
+    1137, 829, 1408, 1046, 341, 1154, 422, 1233, 396, 652, 1027, 1832,
+    823, 572, 151, 836, 710, 389, 1529, 705, 2045, 443, 1509, 1526,
+    1090, 63, 193, 524, 1591, 943, 1634, 1653, 100, 326, 1310, 805,
+    1899, 1915, 1602, 103, 1292, 1562, 90, 1184, 504, 1056, 158, 138,
+    1235, 247, 1151, 1107, 1507, 1894, 1558, 702, 1892, 976, 191, 1093,
+    1234, 783, 1448, 865, 924, 1780, 1336, 659, 926, 1102, 452, 1404,
+    1853, 1299, 434, 1296, 851, 521, 1142, 1367, 654, 413, 1006, 62,
+    609, 1021, 444, 1577, 1914, 1047, 669, 560, 188, 1738, 183, 1125,
+    135, 107, 1866, 1747, 1796, 1051, 237, 1943, 603, 1255, 540, 262,
+    765, 2007, 1984, 1287, 962, 1957, 1077, 405, 1773, 1362, 1112, 2030,
+    881, 890, 81, 1831, 1518, 617, 252, 441, 137, 1956, 1942, 1895,
+    1758, 316, 294, 756, 952, 1816, 250, 118, 1157, 1440, 1579, 998,
+    566, 1290, 194, 1954, 2041, 359, 253, 1617, 1799, 307, 1236, 1160,
+    2022, 555, 706, 1023, 545, 640, 939, 1337, 1683, 1594, 801, 2040,
+    682, 1049, 510, 588, 416, 570, 344, 78, 602, 1656, 371, 1242,
+    1989, 492, 197, 1128, 661, 1486, 1202, 1903, 99, 1851, 1109, 882,
+    1293, 150, 1677, 156, 1149, 347, 1812, 366, 678, 1603, 1052, 116,
+    1494, 1662, 1756, 403, 1932, 1347, 385, 1524, 1352, 227, 1239, 1609,
+    733, 93, 1357, 1714, 1207, 147, 131, 740, 934, 1681, 937, 647,
+    483, 1910, 1985, 1848, 1934, 1176, 751, 407, 1033, 394, 1697, 1454,
+    1690, 1178, 589, 637, 2025, 1200, 930, 800, 117, 1641, 970, 1062,
+    457, 668, 786, 1419, 1325, 1013, 70, 699, 388, 1356, 335, 2015,
+    681, 1839, 806, 1575, 548, 1955, 532, 523, 1042, 816, 538, 835,
+    1281, 1346, 814, 143, 10, 340, 794, 1199, 372, 922, 830, 764,
+    1962, 1130, 703, 1534, 1189, 303, 104, 1069, 1482, 1251, 712, 768,
+    111, 1129, 778, 1331, 753, 445, 482, 709, 76, 780, 1442, 891,
+    744, 1083, 1007, 179, 1038, 1691, 1132, 1739, 860, 1104, 519, 1387,
+    1473, 1245, 858, 1610, 488, 1343, 1252, 314, 395, 1538, 1101, 1671,
+    580, 481, 404, 574, 910, 1172, 1819, 774, 649, 1185, 86, 1180,
+    1219, 1016, 429, 656, 607, 1165, 1748, 1144, 1511, 600, 1973, 1774,
+    1743, 831, 1230, 222, 1598, 892, 293, 166, 1103, 1169, 1123, 1225,
+    192, 1221, 605, 1008, 278, 1266, 1566, 1958, 1829, 305, 1139, 1580,
+    214, 693, 36, 1084, 345, 2005, 1555, 266, 893, 680, 1389, 1365,
+    1247, 91, 391, 1730, 1456, 60, 987, 493, 1939, 1241, 1803, 1203,
+    676, 686, 1855, 812, 66, 1982, 338, 502, 913, 2026, 1520, 1330,
+    1525, 154, 1063, 815, 360, 567, 1741, 49, 1893, 855, 1002, 1188,
+    1537, 1391, 97, 439, 1815, 37, 1827, 1094, 967, 1263, 616, 844,
+    1004, 1871, 838, 1911, 947, 1339, 1970, 56, 539, 1373, 554, 1967,
+    687, 311, 1785, 454, 685, 1965, 771, 1081, 1857, 133, 1782, 642,
+    245, 1314, 1950, 1305, 102, 1838, 592, 1048, 1926, 1316, 1307, 1639,
+    460, 446, 1865, 798, 437, 1195, 418, 1243, 1968, 1757, 1181, 995,
+    1231, 1392, 263, 1275, 77, 1792, 1659, 1767, 1153, 1481, 2028, 22,
+    677, 859, 1432, 65, 1121, 1274, 1382, 1798, 201, 1280, 471, 1713,
+    2006, 1344, 842, 205, 1621, 999, 1868, 1648, 1213, 1015, 1257, 1206,
+    724, 852, 622, 1232, 1740, 857, 863, 1099, 799, 1162, 1116, 1897,
+    162, 1342, 543, 1593, 731, 298, 230, 1608, 374, 1126, 236, 784,
+    1159, 1397, 414, 1288, 621, 2002, 1600, 1699, 2001, 432, 302, 272,
+    608, 898, 1990, 80, 145, 1760, 2011, 472, 611, 393, 1754, 1455,
+    309, 1592, 2039, 301, 963, 119, 1843, 1928, 1548, 1249, 1770, 223,
+    1817, 1098, 217, 1909, 666, 1924, 847, 435, 534, 650, 767, 195,
+    1318, 438, 1020, 426, 1786, 1891, 1212, 2018, 1345, 755, 1017, 1136,
+    1497, 871, 969, 319, 219, 1790, 343, 1115, 180, 1607, 20, 44,
+    1930, 1631, 1111, 2010, 1725, 232, 1918, 1919, 1904, 684, 516, 182,
+    820, 1927, 819, 71, 54, 1393, 369, 1264, 173, 1354, 595, 1804,
+    1022, 375, 290, 2000, 229, 1449, 1642, 1931, 1587, 515, 1879, 1256,
+    597, 867, 905, 1045, 796, 576, 243, 894,
    };
-#undef it
 
 static const struct words it_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words it_words = {
     true,
     (const char *)it_,
     0, /* Constant string */
-    it_i
+    NULL, /* Words are located by offset */
+    it_o,
+    0u,
+    it_d,
+    it_h
 };
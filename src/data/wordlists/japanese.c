@@ -2051,352 +2051,398 @@ static const unsigned char jp_[] = {
     0xe3,0x82,0x8f,0xe3,0x82,0x89,0xe3,0x81,0x86,0,
     0xe3,0x82,0x8f,0xe3,0x82,0x8c,0xe3,0x82,0x8b,0,
 };
-#define jp ((const char*)jp_)
-static const char *jp_i[] = {
-    jp+0, jp+19, jp+32, jp+45, jp+61, jp+77,
-    jp+87, jp+103, jp+113, jp+132, jp+142, jp+152,
-    jp+165, jp+181, jp+197, jp+210, jp+223, jp+236,
-    jp+252, jp+268, jp+278, jp+288, jp+301, jp+317,
-    jp+330, jp+343, jp+353, jp+369, jp+379, jp+392,
-    jp+405, jp+418, jp+428, jp+441, jp+457, jp+467,
-    jp+480, jp+493, jp+506, jp+516, jp+535, jp+545,
-    jp+561, jp+577, jp+590, jp+603, jp+622, jp+635,
-    jp+648, jp+658, jp+674, jp+684, jp+700, jp+713,
-    jp+726, jp+739, jp+755, jp+765, jp+778, jp+791,
-    jp+804, jp+817, jp+830, jp+840, jp+853, jp+869,
-    jp+885, jp+895, jp+905, jp+915, jp+925, jp+941,
-    jp+951, jp+961, jp+977, jp+993, jp+1009, jp+1022,
-    jp+1035, jp+1045, jp+1061, jp+1074, jp+1084, jp+1097,
-    jp+1113, jp+1132, jp+1145, jp+1158, jp+1174, jp+1184,
-    jp+1197, jp+1210, jp+1223, jp+1236, jp+1249, jp+1262,
-    jp+1278, jp+1288, jp+1304, jp+1317, jp+1330, jp+1343,
-    jp+1353, jp+1366, jp+1382, jp+1395, jp+1405, jp+1418,
-    jp+1428, jp+1438, jp+1448, jp+1461, jp+1471, jp+1481,
-    jp+1491, jp+1504, jp+1514, jp+1527, jp+1537, jp+1547,
-    jp+1557, jp+1567, jp+1577, jp+1590, jp+1603, jp+1613,
-    jp+1629, jp+1639, jp+1652, jp+1662, jp+1672, jp+1685,
-    jp+1701, jp+1714, jp+1724, jp+1737, jp+1747, jp+1769,
-    jp+1779, jp+1789, jp+1802, jp+1815, jp+1828, jp+1850,
-    jp+1863, jp+1879, jp+1892, jp+1902, jp+1912, jp+1925,
-    jp+1938, jp+1951, jp+1967, jp+1977, jp+1993, jp+2006,
-    jp+2025, jp+2038, jp+2051, jp+2064, jp+2074, jp+2090,
-    jp+2103, jp+2113, jp+2126, jp+2139, jp+2158, jp+2168,
-    jp+2181, jp+2200, jp+2213, jp+2223, jp+2239, jp+2255,
-    jp+2265, jp+2278, jp+2291, jp+2307, jp+2323, jp+2333,
-    jp+2346, jp+2359, jp+2372, jp+2388, jp+2398, jp+2408,
-    jp+2418, jp+2434, jp+2453, jp+2466, jp+2476, jp+2486,
-    jp+2499, jp+2509, jp+2528, jp+2544, jp+2557, jp+2573,
-    jp+2586, jp+2599, jp+2612, jp+2625, jp+2635, jp+2645,
-    jp+2655, jp+2665, jp+2678, jp+2691, jp+2704, jp+2720,
-    jp+2733, jp+2746, jp+2762, jp+2775, jp+2788, jp+2804,
-    jp+2817, jp+2827, jp+2837, jp+2850, jp+2863, jp+2876,
-    jp+2889, jp+2902, jp+2912, jp+2925, jp+2938, jp+2954,
-    jp+2964, jp+2974, jp+2987, jp+2997, jp+3007, jp+3020,
-    jp+3030, jp+3043, jp+3056, jp+3069, jp+3085, jp+3101,
-    jp+3117, jp+3130, jp+3146, jp+3159, jp+3175, jp+3188,
-    jp+3201, jp+3214, jp+3227, jp+3240, jp+3253, jp+3266,
-    jp+3279, jp+3292, jp+3308, jp+3321, jp+3331, jp+3341,
-    jp+3351, jp+3370, jp+3380, jp+3393, jp+3406, jp+3419,
-    jp+3432, jp+3445, jp+3461, jp+3471, jp+3484, jp+3503,
-    jp+3522, jp+3532, jp+3545, jp+3555, jp+3568, jp+3578,
-    jp+3591, jp+3604, jp+3617, jp+3630, jp+3643, jp+3659,
-    jp+3675, jp+3688, jp+3701, jp+3714, jp+3730, jp+3740,
-    jp+3756, jp+3769, jp+3779, jp+3789, jp+3805, jp+3821,
-    jp+3837, jp+3850, jp+3869, jp+3885, jp+3898, jp+3917,
-    jp+3933, jp+3943, jp+3956, jp+3969, jp+3979, jp+3995,
-    jp+4011, jp+4027, jp+4037, jp+4053, jp+4066, jp+4079,
-    jp+4092, jp+4108, jp+4124, jp+4143, jp+4153, jp+4166,
-    jp+4179, jp+4195, jp+4211, jp+4224, jp+4237, jp+4256,
-    jp+4272, jp+4294, jp+4307, jp+4320, jp+4333, jp+4346,
-    jp+4362, jp+4375, jp+4388, jp+4404, jp+4414, jp+4424,
-    jp+4434, jp+4447, jp+4460, jp+4473, jp+4486, jp+4499,
-    jp+4512, jp+4525, jp+4541, jp+4551, jp+4561, jp+4577,
-    jp+4596, jp+4612, jp+4628, jp+4647, jp+4666, jp+4676,
-    jp+4689, jp+4702, jp+4712, jp+4725, jp+4735, jp+4751,
-    jp+4767, jp+4777, jp+4793, jp+4803, jp+4813, jp+4823,
-    jp+4833, jp+4843, jp+4856, jp+4869, jp+4882, jp+4895,
-    jp+4908, jp+4921, jp+4931, jp+4950, jp+4960, jp+4970,
-    jp+4980, jp+4993, jp+5003, jp+5013, jp+5023, jp+5033,
-    jp+5043, jp+5053, jp+5063, jp+5073, jp+5083, jp+5099,
-    jp+5109, jp+5125, jp+5141, jp+5157, jp+5167, jp+5180,
-    jp+5190, jp+5200, jp+5210, jp+5220, jp+5236, jp+5261,
-    jp+5274, jp+5299, jp+5324, jp+5349, jp+5359, jp+5369,
-    jp+5379, jp+5389, jp+5399, jp+5412, jp+5425, jp+5438,
-    jp+5451, jp+5464, jp+5480, jp+5493, jp+5503, jp+5513,
-    jp+5526, jp+5539, jp+5549, jp+5562, jp+5572, jp+5588,
-    jp+5598, jp+5608, jp+5621, jp+5631, jp+5647, jp+5657,
-    jp+5667, jp+5680, jp+5693, jp+5703, jp+5713, jp+5723,
-    jp+5745, jp+5755, jp+5774, jp+5784, jp+5794, jp+5804,
-    jp+5814, jp+5833, jp+5843, jp+5862, jp+5872, jp+5882,
-    jp+5892, jp+5902, jp+5912, jp+5922, jp+5935, jp+5948,
-    jp+5964, jp+5983, jp+5999, jp+6018, jp+6031, jp+6044,
-    jp+6057, jp+6067, jp+6083, jp+6096, jp+6112, jp+6125,
-    jp+6141, jp+6154, jp+6167, jp+6177, jp+6190, jp+6203,
-    jp+6216, jp+6226, jp+6236, jp+6252, jp+6262, jp+6275,
-    jp+6288, jp+6301, jp+6320, jp+6333, jp+6343, jp+6362,
-    jp+6378, jp+6397, jp+6410, jp+6423, jp+6436, jp+6452,
-    jp+6468, jp+6484, jp+6497, jp+6507, jp+6520, jp+6530,
-    jp+6540, jp+6556, jp+6572, jp+6582, jp+6598, jp+6608,
-    jp+6624, jp+6634, jp+6644, jp+6654, jp+6667, jp+6683,
-    jp+6702, jp+6718, jp+6731, jp+6741, jp+6754, jp+6767,
-    jp+6777, jp+6790, jp+6812, jp+6825, jp+6850, jp+6863,
-    jp+6873, jp+6886, jp+6902, jp+6915, jp+6934, jp+6953,
-    jp+6969, jp+6985, jp+6998, jp+7014, jp+7027, jp+7052,
-    jp+7068, jp+7078, jp+7094, jp+7104, jp+7120, jp+7133,
-    jp+7146, jp+7159, jp+7178, jp+7191, jp+7204, jp+7214,
-    jp+7227, jp+7240, jp+7256, jp+7269, jp+7282, jp+7295,
-    jp+7317, jp+7333, jp+7346, jp+7362, jp+7378, jp+7388,
-    jp+7401, jp+7411, jp+7421, jp+7431, jp+7444, jp+7454,
-    jp+7464, jp+7477, jp+7493, jp+7509, jp+7519, jp+7532,
-    jp+7542, jp+7552, jp+7562, jp+7572, jp+7585, jp+7598,
-    jp+7608, jp+7621, jp+7631, jp+7641, jp+7654, jp+7670,
-    jp+7683, jp+7696, jp+7712, jp+7725, jp+7741, jp+7754,
-    jp+7767, jp+7780, jp+7793, jp+7806, jp+7825, jp+7835,
-    jp+7848, jp+7861, jp+7874, jp+7884, jp+7897, jp+7907,
-    jp+7923, jp+7936, jp+7949, jp+7962, jp+7975, jp+7994,
-    jp+8010, jp+8023, jp+8036, jp+8049, jp+8062, jp+8078,
-    jp+8091, jp+8104, jp+8117, jp+8130, jp+8143, jp+8159,
-    jp+8172, jp+8185, jp+8201, jp+8217, jp+8230, jp+8243,
-    jp+8253, jp+8263, jp+8276, jp+8292, jp+8305, jp+8318,
-    jp+8331, jp+8344, jp+8357, jp+8370, jp+8383, jp+8393,
-    jp+8403, jp+8416, jp+8426, jp+8436, jp+8446, jp+8456,
-    jp+8466, jp+8476, jp+8489, jp+8505, jp+8515, jp+8528,
-    jp+8538, jp+8551, jp+8561, jp+8574, jp+8590, jp+8603,
-    jp+8613, jp+8623, jp+8639, jp+8649, jp+8662, jp+8672,
-    jp+8688, jp+8701, jp+8714, jp+8724, jp+8734, jp+8747,
-    jp+8763, jp+8773, jp+8783, jp+8799, jp+8821, jp+8834,
-    jp+8850, jp+8863, jp+8873, jp+8889, jp+8902, jp+8912,
-    jp+8922, jp+8932, jp+8942, jp+8952, jp+8962, jp+8975,
-    jp+8985, jp+8995, jp+9005, jp+9024, jp+9037, jp+9050,
-    jp+9063, jp+9076, jp+9089, jp+9099, jp+9115, jp+9128,
-    jp+9144, jp+9157, jp+9170, jp+9186, jp+9202, jp+9215,
-    jp+9225, jp+9238, jp+9251, jp+9267, jp+9280, jp+9293,
-    jp+9312, jp+9325, jp+9338, jp+9351, jp+9367, jp+9386,
-    jp+9399, jp+9418, jp+9428, jp+9441, jp+9454, jp+9464,
-    jp+9477, jp+9490, jp+9506, jp+9516, jp+9529, jp+9539,
-    jp+9549, jp+9559, jp+9575, jp+9588, jp+9598, jp+9611,
-    jp+9627, jp+9640, jp+9659, jp+9675, jp+9688, jp+9704,
-    jp+9720, jp+9736, jp+9752, jp+9762, jp+9775, jp+9785,
-    jp+9798, jp+9808, jp+9818, jp+9828, jp+9841, jp+9857,
-    jp+9870, jp+9880, jp+9893, jp+9903, jp+9916, jp+9932,
-    jp+9942, jp+9952, jp+9974, jp+9984, jp+9994, jp+10004,
-    jp+10017, jp+10036, jp+10049, jp+10059, jp+10072, jp+10082,
-    jp+10098, jp+10111, jp+10124, jp+10140, jp+10153, jp+10166,
-    jp+10176, jp+10186, jp+10196, jp+10206, jp+10219, jp+10229,
-    jp+10242, jp+10258, jp+10271, jp+10281, jp+10291, jp+10301,
-    jp+10311, jp+10321, jp+10331, jp+10341, jp+10354, jp+10367,
-    jp+10377, jp+10393, jp+10406, jp+10419, jp+10429, jp+10439,
-    jp+10452, jp+10465, jp+10478, jp+10491, jp+10504, jp+10514,
-    jp+10524, jp+10534, jp+10547, jp+10563, jp+10579, jp+10592,
-    jp+10602, jp+10612, jp+10622, jp+10635, jp+10648, jp+10658,
-    jp+10674, jp+10684, jp+10697, jp+10707, jp+10720, jp+10730,
-    jp+10746, jp+10756, jp+10766, jp+10776, jp+10786, jp+10796,
-    jp+10806, jp+10819, jp+10835, jp+10845, jp+10855, jp+10865,
-    jp+10878, jp+10891, jp+10904, jp+10926, jp+10942, jp+10958,
-    jp+10971, jp+10981, jp+10997, jp+11010, jp+11023, jp+11036,
-    jp+11049, jp+11065, jp+11081, jp+11094, jp+11107, jp+11120,
-    jp+11133, jp+11152, jp+11168, jp+11184, jp+11200, jp+11210,
-    jp+11226, jp+11248, jp+11264, jp+11280, jp+11296, jp+11312,
-    jp+11325, jp+11338, jp+11354, jp+11364, jp+11377, jp+11396,
-    jp+11415, jp+11428, jp+11441, jp+11454, jp+11464, jp+11474,
-    jp+11487, jp+11500, jp+11510, jp+11523, jp+11542, jp+11561,
-    jp+11577, jp+11593, jp+11606, jp+11622, jp+11632, jp+11642,
-    jp+11655, jp+11665, jp+11678, jp+11688, jp+11701, jp+11717,
-    jp+11727, jp+11740, jp+11753, jp+11769, jp+11782, jp+11792,
-    jp+11802, jp+11812, jp+11822, jp+11835, jp+11854, jp+11870,
-    jp+11889, jp+11902, jp+11912, jp+11925, jp+11938, jp+11951,
-    jp+11964, jp+11974, jp+11984, jp+11994, jp+12004, jp+12017,
-    jp+12027, jp+12046, jp+12059, jp+12069, jp+12085, jp+12101,
-    jp+12117, jp+12130, jp+12146, jp+12159, jp+12172, jp+12182,
-    jp+12198, jp+12211, jp+12221, jp+12231, jp+12250, jp+12260,
-    jp+12270, jp+12283, jp+12293, jp+12303, jp+12316, jp+12332,
-    jp+12345, jp+12358, jp+12371, jp+12390, jp+12406, jp+12422,
-    jp+12438, jp+12454, jp+12467, jp+12483, jp+12496, jp+12509,
-    jp+12519, jp+12532, jp+12545, jp+12558, jp+12571, jp+12581,
-    jp+12591, jp+12601, jp+12614, jp+12624, jp+12640, jp+12650,
-    jp+12663, jp+12673, jp+12686, jp+12696, jp+12712, jp+12728,
-    jp+12741, jp+12754, jp+12767, jp+12780, jp+12793, jp+12806,
-    jp+12822, jp+12835, jp+12848, jp+12861, jp+12874, jp+12890,
-    jp+12906, jp+12925, jp+12935, jp+12957, jp+12970, jp+12983,
-    jp+12996, jp+13009, jp+13022, jp+13041, jp+13054, jp+13064,
-    jp+13074, jp+13093, jp+13103, jp+13128, jp+13138, jp+13151,
-    jp+13164, jp+13180, jp+13193, jp+13206, jp+13219, jp+13229,
-    jp+13242, jp+13252, jp+13265, jp+13278, jp+13288, jp+13301,
-    jp+13314, jp+13324, jp+13334, jp+13344, jp+13357, jp+13373,
-    jp+13383, jp+13396, jp+13409, jp+13428, jp+13441, jp+13454,
-    jp+13467, jp+13477, jp+13493, jp+13509, jp+13522, jp+13532,
-    jp+13545, jp+13558, jp+13571, jp+13581, jp+13591, jp+13601,
-    jp+13614, jp+13624, jp+13637, jp+13653, jp+13666, jp+13676,
-    jp+13689, jp+13702, jp+13718, jp+13731, jp+13747, jp+13763,
-    jp+13779, jp+13798, jp+13811, jp+13821, jp+13834, jp+13847,
-    jp+13860, jp+13873, jp+13892, jp+13902, jp+13918, jp+13931,
-    jp+13941, jp+13957, jp+13985, jp+14001, jp+14014, jp+14027,
-    jp+14043, jp+14059, jp+14072, jp+14094, jp+14107, jp+14120,
-    jp+14133, jp+14146, jp+14165, jp+14178, jp+14191, jp+14201,
-    jp+14223, jp+14242, jp+14252, jp+14265, jp+14278, jp+14291,
-    jp+14301, jp+14317, jp+14327, jp+14340, jp+14350, jp+14360,
-    jp+14370, jp+14380, jp+14393, jp+14403, jp+14413, jp+14426,
-    jp+14439, jp+14449, jp+14462, jp+14472, jp+14488, jp+14507,
-    jp+14520, jp+14539, jp+14555, jp+14568, jp+14578, jp+14594,
-    jp+14604, jp+14620, jp+14636, jp+14655, jp+14668, jp+14687,
-    jp+14703, jp+14713, jp+14726, jp+14742, jp+14752, jp+14762,
-    jp+14775, jp+14785, jp+14798, jp+14811, jp+14824, jp+14837,
-    jp+14847, jp+14860, jp+14873, jp+14883, jp+14893, jp+14903,
-    jp+14916, jp+14926, jp+14936, jp+14961, jp+14974, jp+14984,
-    jp+14994, jp+15004, jp+15017, jp+15030, jp+15046, jp+15062,
-    jp+15072, jp+15085, jp+15095, jp+15105, jp+15118, jp+15131,
-    jp+15144, jp+15169, jp+15185, jp+15198, jp+15211, jp+15224,
-    jp+15237, jp+15250, jp+15263, jp+15276, jp+15292, jp+15305,
-    jp+15321, jp+15340, jp+15353, jp+15366, jp+15382, jp+15395,
-    jp+15408, jp+15418, jp+15428, jp+15438, jp+15451, jp+15461,
-    jp+15471, jp+15481, jp+15494, jp+15504, jp+15520, jp+15530,
-    jp+15540, jp+15550, jp+15560, jp+15576, jp+15586, jp+15596,
-    jp+15606, jp+15616, jp+15629, jp+15645, jp+15655, jp+15665,
-    jp+15675, jp+15685, jp+15695, jp+15708, jp+15724, jp+15734,
-    jp+15744, jp+15754, jp+15770, jp+15786, jp+15808, jp+15821,
-    jp+15837, jp+15850, jp+15869, jp+15879, jp+15889, jp+15905,
-    jp+15918, jp+15931, jp+15941, jp+15954, jp+15967, jp+15977,
-    jp+15990, jp+16000, jp+16019, jp+16032, jp+16042, jp+16052,
-    jp+16065, jp+16075, jp+16085, jp+16095, jp+16105, jp+16118,
-    jp+16131, jp+16144, jp+16157, jp+16167, jp+16180, jp+16196,
-    jp+16206, jp+16222, jp+16232, jp+16245, jp+16261, jp+16271,
-    jp+16281, jp+16294, jp+16304, jp+16314, jp+16324, jp+16337,
-    jp+16350, jp+16363, jp+16373, jp+16383, jp+16393, jp+16403,
-    jp+16416, jp+16426, jp+16436, jp+16449, jp+16462, jp+16475,
-    jp+16485, jp+16498, jp+16511, jp+16524, jp+16537, jp+16553,
-    jp+16566, jp+16582, jp+16592, jp+16605, jp+16618, jp+16631,
-    jp+16650, jp+16669, jp+16682, jp+16692, jp+16702, jp+16718,
-    jp+16731, jp+16747, jp+16763, jp+16779, jp+16795, jp+16805,
-    jp+16821, jp+16831, jp+16847, jp+16860, jp+16870, jp+16886,
-    jp+16899, jp+16915, jp+16925, jp+16935, jp+16954, jp+16970,
-    jp+16986, jp+16996, jp+17009, jp+17019, jp+17032, jp+17048,
-    jp+17061, jp+17074, jp+17084, jp+17097, jp+17110, jp+17126,
-    jp+17139, jp+17149, jp+17162, jp+17175, jp+17188, jp+17201,
-    jp+17214, jp+17230, jp+17255, jp+17268, jp+17287, jp+17306,
-    jp+17319, jp+17332, jp+17342, jp+17358, jp+17374, jp+17390,
-    jp+17400, jp+17416, jp+17426, jp+17436, jp+17446, jp+17456,
-    jp+17466, jp+17476, jp+17486, jp+17499, jp+17515, jp+17525,
-    jp+17541, jp+17554, jp+17564, jp+17580, jp+17590, jp+17600,
-    jp+17610, jp+17620, jp+17636, jp+17646, jp+17656, jp+17669,
-    jp+17685, jp+17698, jp+17714, jp+17730, jp+17746, jp+17762,
-    jp+17772, jp+17785, jp+17795, jp+17808, jp+17821, jp+17843,
-    jp+17853, jp+17863, jp+17873, jp+17889, jp+17899, jp+17918,
-    jp+17931, jp+17944, jp+17963, jp+17976, jp+17989, jp+18002,
-    jp+18012, jp+18025, jp+18038, jp+18048, jp+18061, jp+18071,
-    jp+18084, jp+18100, jp+18110, jp+18129, jp+18142, jp+18158,
-    jp+18171, jp+18187, jp+18200, jp+18210, jp+18220, jp+18233,
-    jp+18246, jp+18256, jp+18266, jp+18279, jp+18292, jp+18302,
-    jp+18312, jp+18322, jp+18335, jp+18348, jp+18358, jp+18374,
-    jp+18390, jp+18400, jp+18416, jp+18426, jp+18436, jp+18446,
-    jp+18459, jp+18472, jp+18485, jp+18498, jp+18511, jp+18533,
-    jp+18543, jp+18556, jp+18575, jp+18594, jp+18604, jp+18614,
-    jp+18627, jp+18640, jp+18653, jp+18669, jp+18682, jp+18695,
-    jp+18708, jp+18718, jp+18728, jp+18738, jp+18748, jp+18758,
-    jp+18774, jp+18790, jp+18803, jp+18813, jp+18823, jp+18833,
-    jp+18849, jp+18862, jp+18878, jp+18891, jp+18904, jp+18914,
-    jp+18927, jp+18940, jp+18953, jp+18966, jp+18976, jp+18989,
-    jp+19002, jp+19018, jp+19028, jp+19047, jp+19060, jp+19073,
-    jp+19083, jp+19099, jp+19109, jp+19119, jp+19135, jp+19148,
-    jp+19158, jp+19168, jp+19178, jp+19191, jp+19204, jp+19214,
-    jp+19227, jp+19237, jp+19250, jp+19266, jp+19282, jp+19295,
-    jp+19305, jp+19318, jp+19334, jp+19356, jp+19372, jp+19385,
-    jp+19398, jp+19417, jp+19427, jp+19440, jp+19450, jp+19460,
-    jp+19473, jp+19483, jp+19493, jp+19506, jp+19519, jp+19532,
-    jp+19545, jp+19558, jp+19571, jp+19584, jp+19594, jp+19610,
-    jp+19623, jp+19636, jp+19652, jp+19665, jp+19681, jp+19694,
-    jp+19707, jp+19723, jp+19736, jp+19749, jp+19765, jp+19775,
-    jp+19785, jp+19795, jp+19808, jp+19821, jp+19834, jp+19850,
-    jp+19860, jp+19873, jp+19883, jp+19896, jp+19909, jp+19922,
-    jp+19932, jp+19945, jp+19958, jp+19971, jp+19984, jp+19994,
-    jp+20004, jp+20017, jp+20027, jp+20043, jp+20056, jp+20069,
-    jp+20082, jp+20095, jp+20108, jp+20121, jp+20134, jp+20147,
-    jp+20157, jp+20176, jp+20189, jp+20199, jp+20209, jp+20219,
-    jp+20232, jp+20242, jp+20255, jp+20265, jp+20278, jp+20288,
-    jp+20298, jp+20311, jp+20324, jp+20334, jp+20344, jp+20360,
-    jp+20370, jp+20380, jp+20393, jp+20406, jp+20419, jp+20432,
-    jp+20445, jp+20458, jp+20471, jp+20484, jp+20497, jp+20510,
-    jp+20523, jp+20539, jp+20552, jp+20571, jp+20587, jp+20597,
-    jp+20610, jp+20623, jp+20639, jp+20655, jp+20668, jp+20678,
-    jp+20688, jp+20698, jp+20708, jp+20724, jp+20734, jp+20744,
-    jp+20757, jp+20770, jp+20783, jp+20799, jp+20818, jp+20828,
-    jp+20841, jp+20854, jp+20870, jp+20883, jp+20896, jp+20909,
-    jp+20922, jp+20935, jp+20948, jp+20964, jp+20980, jp+20999,
-    jp+21012, jp+21025, jp+21038, jp+21048, jp+21058, jp+21068,
-    jp+21078, jp+21088, jp+21098, jp+21108, jp+21118, jp+21128,
-    jp+21141, jp+21151, jp+21161, jp+21180, jp+21190, jp+21215,
-    jp+21225, jp+21235, jp+21245, jp+21258, jp+21271, jp+21281,
-    jp+21294, jp+21307, jp+21317, jp+21339, jp+21349, jp+21365,
-    jp+21381, jp+21397, jp+21410, jp+21420, jp+21436, jp+21452,
-    jp+21462, jp+21472, jp+21482, jp+21495, jp+21508, jp+21518,
-    jp+21531, jp+21541, jp+21551, jp+21561, jp+21577, jp+21587,
-    jp+21597, jp+21607, jp+21623, jp+21639, jp+21649, jp+21659,
-    jp+21672, jp+21682, jp+21698, jp+21708, jp+21718, jp+21728,
-    jp+21738, jp+21751, jp+21764, jp+21777, jp+21790, jp+21803,
-    jp+21816, jp+21829, jp+21845, jp+21864, jp+21874, jp+21887,
-    jp+21900, jp+21913, jp+21932, jp+21945, jp+21955, jp+21965,
-    jp+21975, jp+21985, jp+21995, jp+22011, jp+22030, jp+22040,
-    jp+22050, jp+22063, jp+22076, jp+22086, jp+22096, jp+22109,
-    jp+22119, jp+22135, jp+22145, jp+22158, jp+22168, jp+22178,
-    jp+22191, jp+22201, jp+22214, jp+22230, jp+22240, jp+22250,
-    jp+22260, jp+22270, jp+22283, jp+22293, jp+22303, jp+22313,
-    jp+22323, jp+22333, jp+22343, jp+22353, jp+22363, jp+22373,
-    jp+22386, jp+22405, jp+22421, jp+22434, jp+22450, jp+22463,
-    jp+22482, jp+22495, jp+22508, jp+22524, jp+22534, jp+22550,
-    jp+22563, jp+22573, jp+22586, jp+22599, jp+22609, jp+22622,
-    jp+22635, jp+22648, jp+22658, jp+22671, jp+22681, jp+22697,
-    jp+22722, jp+22732, jp+22745, jp+22764, jp+22783, jp+22796,
-    jp+22809, jp+22822, jp+22832, jp+22842, jp+22861, jp+22874,
-    jp+22887, jp+22900, jp+22913, jp+22926, jp+22936, jp+22946,
-    jp+22956, jp+22969, jp+22982, jp+22992, jp+23002, jp+23012,
-    jp+23022, jp+23032, jp+23042, jp+23052, jp+23062, jp+23075,
-    jp+23085, jp+23095, jp+23105, jp+23115, jp+23125, jp+23147,
-    jp+23163, jp+23173, jp+23186, jp+23202, jp+23212, jp+23222,
-    jp+23232, jp+23242, jp+23255, jp+23268, jp+23281, jp+23291,
-    jp+23304, jp+23317, jp+23327, jp+23337, jp+23347, jp+23360,
-    jp+23370, jp+23383, jp+23393, jp+23403, jp+23416, jp+23426,
-    jp+23436, jp+23446, jp+23456, jp+23469, jp+23479, jp+23492,
-    jp+23502, jp+23512, jp+23522, jp+23535, jp+23548, jp+23564,
-    jp+23577, jp+23587, jp+23597, jp+23607, jp+23620, jp+23630,
-    jp+23640, jp+23650, jp+23660, jp+23676, jp+23686, jp+23699,
-    jp+23709, jp+23719, jp+23732, jp+23745, jp+23755, jp+23768,
-    jp+23778, jp+23797, jp+23810, jp+23820, jp+23836, jp+23846,
-    jp+23856, jp+23869, jp+23879, jp+23892, jp+23902, jp+23912,
-    jp+23928, jp+23938, jp+23948, jp+23958, jp+23968, jp+23978,
-    jp+23988, jp+23998, jp+24014, jp+24024, jp+24037, jp+24053,
-    jp+24069, jp+24082, jp+24098, jp+24108, jp+24118, jp+24128,
-    jp+24141, jp+24151, jp+24161, jp+24171, jp+24184, jp+24197,
-    jp+24207, jp+24217, jp+24227, jp+24240, jp+24253, jp+24263,
-    jp+24276, jp+24289, jp+24302, jp+24315, jp+24331, jp+24344,
-    jp+24354, jp+24367, jp+24383, jp+24396, jp+24409, jp+24428,
-    jp+24441, jp+24451, jp+24470, jp+24483, jp+24493, jp+24503,
-    jp+24516, jp+24529, jp+24545, jp+24567, jp+24589, jp+24599,
-    jp+24609, jp+24622, jp+24641, jp+24654, jp+24667, jp+24677,
-    jp+24687, jp+24703, jp+24713, jp+24723, jp+24733, jp+24746,
-    jp+24756, jp+24772, jp+24782, jp+24792, jp+24802, jp+24812,
-    jp+24822, jp+24832, jp+24848, jp+24861, jp+24871, jp+24887,
-    jp+24897, jp+24913, jp+24923, jp+24948, jp+24961, jp+24974,
-    jp+24984, jp+24997, jp+25007, jp+25017, jp+25027, jp+25040,
-    jp+25053, jp+25066, jp+25079, jp+25089, jp+25099, jp+25109,
-    jp+25119, jp+25135, jp+25148, jp+25158, jp+25174, jp+25187,
-    jp+25197, jp+25207, jp+25220, jp+25236, jp+25246, jp+25262,
-    jp+25272, jp+25285, jp+25295, jp+25305, jp+25315, jp+25325,
-    jp+25347, jp+25357, jp+25367, jp+25377, jp+25393, jp+25406,
-    jp+25416, jp+25432, jp+25445, jp+25458, jp+25471, jp+25490,
-    jp+25500, jp+25513, jp+25523, jp+25533, jp+25543, jp+25553,
-    jp+25563, jp+25576, jp+25589, jp+25605, jp+25615, jp+25625,
-    jp+25635, jp+25645, jp+25655, jp+25665, jp+25675, jp+25685,
-    jp+25695, jp+25714, jp+25724, jp+25737, jp+25750, jp+25766,
-    jp+25779, jp+25789, jp+25799, jp+25809, jp+25822, jp+25835,
-    jp+25848, jp+25861, jp+25874, jp+25890, jp+25909, jp+25922,
-    jp+25935, jp+25948, jp+25967, jp+25980, jp+25996, jp+26006,
-    jp+26022, jp+26035, jp+26048, jp+26061, jp+26074, jp+26090,
-    jp+26106, jp+26119, jp+26129, jp+26142, jp+26158, jp+26171,
-    jp+26184, jp+26194, jp+26210, jp+26223, jp+26233, jp+26243,
-    jp+26253, jp+26263, jp+26276, jp+26289, jp+26305, jp+26315,
-    jp+26325, jp+26335, jp+26348, jp+26361, jp+26371, jp+26387,
-    jp+26403, jp+26413, jp+26423,
+static const uint16_t jp_o[] = {
+    0, 19, 32, 45, 61, 77, 87, 103, 113, 132, 142, 152,
+    165, 181, 197, 210, 223, 236, 252, 268, 278, 288, 301, 317,
+    330, 343, 353, 369, 379, 392, 405, 418, 428, 441, 457, 467,
+    480, 493, 506, 516, 535, 545, 561, 577, 590, 603, 622, 635,
+    648, 658, 674, 684, 700, 713, 726, 739, 755, 765, 778, 791,
+    804, 817, 830, 840, 853, 869, 885, 895, 905, 915, 925, 941,
+    951, 961, 977, 993, 1009, 1022, 1035, 1045, 1061, 1074, 1084, 1097,
+    1113, 1132, 1145, 1158, 1174, 1184, 1197, 1210, 1223, 1236, 1249, 1262,
+    1278, 1288, 1304, 1317, 1330, 1343, 1353, 1366, 1382, 1395, 1405, 1418,
+    1428, 1438, 1448, 1461, 1471, 1481, 1491, 1504, 1514, 1527, 1537, 1547,
+    1557, 1567, 1577, 1590, 1603, 1613, 1629, 1639, 1652, 1662, 1672, 1685,
+    1701, 1714, 1724, 1737, 1747, 1769, 1779, 1789, 1802, 1815, 1828, 1850,
+    1863, 1879, 1892, 1902, 1912, 1925, 1938, 1951, 1967, 1977, 1993, 2006,
+    2025, 2038, 2051, 2064, 2074, 2090, 2103, 2113, 2126, 2139, 2158, 2168,
+    2181, 2200, 2213, 2223, 2239, 2255, 2265, 2278, 2291, 2307, 2323, 2333,
+    2346, 2359, 2372, 2388, 2398, 2408, 2418, 2434, 2453, 2466, 2476, 2486,
+    2499, 2509, 2528, 2544, 2557, 2573, 2586, 2599, 2612, 2625, 2635, 2645,
+    2655, 2665, 2678, 2691, 2704, 2720, 2733, 2746, 2762, 2775, 2788, 2804,
+    2817, 2827, 2837, 2850, 2863, 2876, 2889, 2902, 2912, 2925, 2938, 2954,
+    2964, 2974, 2987, 2997, 3007, 3020, 3030, 3043, 3056, 3069, 3085, 3101,
+    3117, 3130, 3146, 3159, 3175, 3188, 3201, 3214, 3227, 3240, 3253, 3266,
+    3279, 3292, 3308, 3321, 3331, 3341, 3351, 3370, 3380, 3393, 3406, 3419,
+    3432, 3445, 3461, 3471, 3484, 3503, 3522, 3532, 3545, 3555, 3568, 3578,
+    3591, 3604, 3617, 3630, 3643, 3659, 3675, 3688, 3701, 3714, 3730, 3740,
+    3756, 3769, 3779, 3789, 3805, 3821, 3837, 3850, 3869, 3885, 3898, 3917,
+    3933, 3943, 3956, 3969, 3979, 3995, 4011, 4027, 4037, 4053, 4066, 4079,
+    4092, 4108, 4124, 4143, 4153, 4166, 4179, 4195, 4211, 4224, 4237, 4256,
+    4272, 4294, 4307, 4320, 4333, 4346, 4362, 4375, 4388, 4404, 4414, 4424,
+    4434, 4447, 4460, 4473, 4486, 4499, 4512, 4525, 4541, 4551, 4561, 4577,
+    4596, 4612, 4628, 4647, 4666, 4676, 4689, 4702, 4712, 4725, 4735, 4751,
+    4767, 4777, 4793, 4803, 4813, 4823, 4833, 4843, 4856, 4869, 4882, 4895,
+    4908, 4921, 4931, 4950, 4960, 4970, 4980, 4993, 5003, 5013, 5023, 5033,
+    5043, 5053, 5063, 5073, 5083, 5099, 5109, 5125, 5141, 5157, 5167, 5180,
+    5190, 5200, 5210, 5220, 5236, 5261, 5274, 5299, 5324, 5349, 5359, 5369,
+    5379, 5389, 5399, 5412, 5425, 5438, 5451, 5464, 5480, 5493, 5503, 5513,
+    5526, 5539, 5549, 5562, 5572, 5588, 5598, 5608, 5621, 5631, 5647, 5657,
+    5667, 5680, 5693, 5703, 5713, 5723, 5745, 5755, 5774, 5784, 5794, 5804,
+    5814, 5833, 5843, 5862, 5872, 5882, 5892, 5902, 5912, 5922, 5935, 5948,
+    5964, 5983, 5999, 6018, 6031, 6044, 6057, 6067, 6083, 6096, 6112, 6125,
+    6141, 6154, 6167, 6177, 6190, 6203, 6216, 6226, 6236, 6252, 6262, 6275,
+    6288, 6301, 6320, 6333, 6343, 6362, 6378, 6397, 6410, 6423, 6436, 6452,
+    6468, 6484, 6497, 6507, 6520, 6530, 6540, 6556, 6572, 6582, 6598, 6608,
+    6624, 6634, 6644, 6654, 6667, 6683, 6702, 6718, 6731, 6741, 6754, 6767,
+    6777, 6790, 6812, 6825, 6850, 6863, 6873, 6886, 6902, 6915, 6934, 6953,
+    6969, 6985, 6998, 7014, 7027, 7052, 7068, 7078, 7094, 7104, 7120, 7133,
+    7146, 7159, 7178, 7191, 7204, 7214, 7227, 7240, 7256, 7269, 7282, 7295,
+    7317, 7333, 7346, 7362, 7378, 7388, 7401, 7411, 7421, 7431, 7444, 7454,
+    7464, 7477, 7493, 7509, 7519, 7532, 7542, 7552, 7562, 7572, 7585, 7598,
+    7608, 7621, 7631, 7641, 7654, 7670, 7683, 7696, 7712, 7725, 7741, 7754,
+    7767, 7780, 7793, 7806, 7825, 7835, 7848, 7861, 7874, 7884, 7897, 7907,
+    7923, 7936, 7949, 7962, 7975, 7994, 8010, 8023, 8036, 8049, 8062, 8078,
+    8091, 8104, 8117, 8130, 8143, 8159, 8172, 8185, 8201, 8217, 8230, 8243,
+    8253, 8263, 8276, 8292, 8305, 8318, 8331, 8344, 8357, 8370, 8383, 8393,
+    8403, 8416, 8426, 8436, 8446, 8456, 8466, 8476, 8489, 8505, 8515, 8528,
+    8538, 8551, 8561, 8574, 8590, 8603, 8613, 8623, 8639, 8649, 8662, 8672,
+    8688, 8701, 8714, 8724, 8734, 8747, 8763, 8773, 8783, 8799, 8821, 8834,
+    8850, 8863, 8873, 8889, 8902, 8912, 8922, 8932, 8942, 8952, 8962, 8975,
+    8985, 8995, 9005, 9024, 9037, 9050, 9063, 9076, 9089, 9099, 9115, 9128,
+    9144, 9157, 9170, 9186, 9202, 9215, 9225, 9238, 9251, 9267, 9280, 9293,
+    9312, 9325, 9338, 9351, 9367, 9386, 9399, 9418, 9428, 9441, 9454, 9464,
+    9477, 9490, 9506, 9516, 9529, 9539, 9549, 9559, 9575, 9588, 9598, 9611,
+    9627, 9640, 9659, 9675, 9688, 9704, 9720, 9736, 9752, 9762, 9775, 9785,
+    9798, 9808, 9818, 9828, 9841, 9857, 9870, 9880, 9893, 9903, 9916, 9932,
+    9942, 9952, 9974, 9984, 9994, 10004, 10017, 10036, 10049, 10059, 10072, 10082,
+    10098, 10111, 10124, 10140, 10153, 10166, 10176, 10186, 10196, 10206, 10219, 10229,
+    10242, 10258, 10271, 10281, 10291, 10301, 10311, 10321, 10331, 10341, 10354, 10367,
+    10377, 10393, 10406, 10419, 10429, 10439, 10452, 10465, 10478, 10491, 10504, 10514,
+    10524, 10534, 10547, 10563, 10579, 10592, 10602, 10612, 10622, 10635, 10648, 10658,
+    10674, 10684, 10697, 10707, 10720, 10730, 10746, 10756, 10766, 10776, 10786, 10796,
+    10806, 10819, 10835, 10845, 10855, 10865, 10878, 10891, 10904, 10926, 10942, 10958,
+    10971, 10981, 10997, 11010, 11023, 11036, 11049, 11065, 11081, 11094, 11107, 11120,
+    11133, 11152, 11168, 11184, 11200, 11210, 11226, 11248, 11264, 11280, 11296, 11312,
+    11325, 11338, 11354, 11364, 11377, 11396, 11415, 11428, 11441, 11454, 11464, 11474,
+    11487, 11500, 11510, 11523, 11542, 11561, 11577, 11593, 11606, 11622, 11632, 11642,
+    11655, 11665, 11678, 11688, 11701, 11717, 11727, 11740, 11753, 11769, 11782, 11792,
+    11802, 11812, 11822, 11835, 11854, 11870, 11889, 11902, 11912, 11925, 11938, 11951,
+    11964, 11974, 11984, 11994, 12004, 12017, 12027, 12046, 12059, 12069, 12085, 12101,
+    12117, 12130, 12146, 12159, 12172, 12182, 12198, 12211, 12221, 12231, 12250, 12260,
+    12270, 12283, 12293, 12303, 12316, 12332, 12345, 12358, 12371, 12390, 12406, 12422,
+    12438, 12454, 12467, 12483, 12496, 12509, 12519, 12532, 12545, 12558, 12571, 12581,
+    12591, 12601, 12614, 12624, 12640, 12650, 12663, 12673, 12686, 12696, 12712, 12728,
+    12741, 12754, 12767, 12780, 12793, 12806, 12822, 12835, 12848, 12861, 12874, 12890,
+    12906, 12925, 12935, 12957, 12970, 12983, 12996, 13009, 13022, 13041, 13054, 13064,
+    13074, 13093, 13103, 13128, 13138, 13151, 13164, 13180, 13193, 13206, 13219, 13229,
+    13242, 13252, 13265, 13278, 13288, 13301, 13314, 13324, 13334, 13344, 13357, 13373,
+    13383, 13396, 13409, 13428, 13441, 13454, 13467, 13477, 13493, 13509, 13522, 13532,
+    13545, 13558, 13571, 13581, 13591, 13601, 13614, 13624, 13637, 13653, 13666, 13676,
+    13689, 13702, 13718, 13731, 13747, 13763, 13779, 13798, 13811, 13821, 13834, 13847,
+    13860, 13873, 13892, 13902, 13918, 13931, 13941, 13957, 13985, 14001, 14014, 14027,
+    14043, 14059, 14072, 14094, 14107, 14120, 14133, 14146, 14165, 14178, 14191, 14201,
+    14223, 14242, 14252, 14265, 14278, 14291, 14301, 14317, 14327, 14340, 14350, 14360,
+    14370, 14380, 14393, 14403, 14413, 14426, 14439, 14449, 14462, 14472, 14488, 14507,
+    14520, 14539, 14555, 14568, 14578, 14594, 14604, 14620, 14636, 14655, 14668, 14687,
+    14703, 14713, 14726, 14742, 14752, 14762, 14775, 14785, 14798, 14811, 14824, 14837,
+    14847, 14860, 14873, 14883, 14893, 14903, 14916, 14926, 14936, 14961, 14974, 14984,
+    14994, 15004, 15017, 15030, 15046, 15062, 15072, 15085, 15095, 15105, 15118, 15131,
+    15144, 15169, 15185, 15198, 15211, 15224, 15237, 15250, 15263, 15276, 15292, 15305,
+    15321, 15340, 15353, 15366, 15382, 15395, 15408, 15418, 15428, 15438, 15451, 15461,
+    15471, 15481, 15494, 15504, 15520, 15530, 15540, 15550, 15560, 15576, 15586, 15596,
+    15606, 15616, 15629, 15645, 15655, 15665, 15675, 15685, 15695, 15708, 15724, 15734,
+    15744, 15754, 15770, 15786, 15808, 15821, 15837, 15850, 15869, 15879, 15889, 15905,
+    15918, 15931, 15941, 15954, 15967, 15977, 15990, 16000, 16019, 16032, 16042, 16052,
+    16065, 16075, 16085, 16095, 16105, 16118, 16131, 16144, 16157, 16167, 16180, 16196,
+    16206, 16222, 16232, 16245, 16261, 16271, 16281, 16294, 16304, 16314, 16324, 16337,
+    16350, 16363, 16373, 16383, 16393, 16403, 16416, 16426, 16436, 16449, 16462, 16475,
+    16485, 16498, 16511, 16524, 16537, 16553, 16566, 16582, 16592, 16605, 16618, 16631,
+    16650, 16669, 16682, 16692, 16702, 16718, 16731, 16747, 16763, 16779, 16795, 16805,
+    16821, 16831, 16847, 16860, 16870, 16886, 16899, 16915, 16925, 16935, 16954, 16970,
+    16986, 16996, 17009, 17019, 17032, 17048, 17061, 17074, 17084, 17097, 17110, 17126,
+    17139, 17149, 17162, 17175, 17188, 17201, 17214, 17230, 17255, 17268, 17287, 17306,
+    17319, 17332, 17342, 17358, 17374, 17390, 17400, 17416, 17426, 17436, 17446, 17456,
+    17466, 17476, 17486, 17499, 17515, 17525, 17541, 17554, 17564, 17580, 17590, 17600,
+    17610, 17620, 17636, 17646, 17656, 17669, 17685, 17698, 17714, 17730, 17746, 17762,
+    17772, 17785, 17795, 17808, 17821, 17843, 17853, 17863, 17873, 17889, 17899, 17918,
+    17931, 17944, 17963, 17976, 17989, 18002, 18012, 18025, 18038, 18048, 18061, 18071,
+    18084, 18100, 18110, 18129, 18142, 18158, 18171, 18187, 18200, 18210, 18220, 18233,
+    18246, 18256, 18266, 18279, 18292, 18302, 18312, 18322, 18335, 18348, 18358, 18374,
+    18390, 18400, 18416, 18426, 18436, 18446, 18459, 18472, 18485, 18498, 18511, 18533,
+    18543, 18556, 18575, 18594, 18604, 18614, 18627, 18640, 18653, 18669, 18682, 18695,
+    18708, 18718, 18728, 18738, 18748, 18758, 18774, 18790, 18803, 18813, 18823, 18833,
+    18849, 18862, 18878, 18891, 18904, 18914, 18927, 18940, 18953, 18966, 18976, 18989,
+    19002, 19018, 19028, 19047, 19060, 19073, 19083, 19099, 19109, 19119, 19135, 19148,
+    19158, 19168, 19178, 19191, 19204, 19214, 19227, 19237, 19250, 19266, 19282, 19295,
+    19305, 19318, 19334, 19356, 19372, 19385, 19398, 19417, 19427, 19440, 19450, 19460,
+    19473, 19483, 19493, 19506, 19519, 19532, 19545, 19558, 19571, 19584, 19594, 19610,
+    19623, 19636, 19652, 19665, 19681, 19694, 19707, 19723, 19736, 19749, 19765, 19775,
+    19785, 19795, 19808, 19821, 19834, 19850, 19860, 19873, 19883, 19896, 19909, 19922,
+    19932, 19945, 19958, 19971, 19984, 19994, 20004, 20017, 20027, 20043, 20056, 20069,
+    20082, 20095, 20108, 20121, 20134, 20147, 20157, 20176, 20189, 20199, 20209, 20219,
+    20232, 20242, 20255, 20265, 20278, 20288, 20298, 20311, 20324, 20334, 20344, 20360,
+    20370, 20380, 20393, 20406, 20419, 20432, 20445, 20458, 20471, 20484, 20497, 20510,
+    20523, 20539, 20552, 20571, 20587, 20597, 20610, 20623, 20639, 20655, 20668, 20678,
+    20688, 20698, 20708, 20724, 20734, 20744, 20757, 20770, 20783, 20799, 20818, 20828,
+    20841, 20854, 20870, 20883, 20896, 20909, 20922, 20935, 20948, 20964, 20980, 20999,
+    21012, 21025, 21038, 21048, 21058, 21068, 21078, 21088, 21098, 21108, 21118, 21128,
+    21141, 21151, 21161, 21180, 21190, 21215, 21225, 21235, 21245, 21258, 21271, 21281,
+    21294, 21307, 21317, 21339, 21349, 21365, 21381, 21397, 21410, 21420, 21436, 21452,
+    21462, 21472, 21482, 21495, 21508, 21518, 21531, 21541, 21551, 21561, 21577, 21587,
+    21597, 21607, 21623, 21639, 21649, 21659, 21672, 21682, 21698, 21708, 21718, 21728,
+    21738, 21751, 21764, 21777, 21790, 21803, 21816, 21829, 21845, 21864, 21874, 21887,
+    21900, 21913, 21932, 21945, 21955, 21965, 21975, 21985, 21995, 22011, 22030, 22040,
+    22050, 22063, 22076, 22086, 22096, 22109, 22119, 22135, 22145, 22158, 22168, 22178,
+    22191, 22201, 22214, 22230, 22240, 22250, 22260, 22270, 22283, 22293, 22303, 22313,
+    22323, 22333, 22343, 22353, 22363, 22373, 22386, 22405, 22421, 22434, 22450, 22463,
+    22482, 22495, 22508, 22524, 22534, 22550, 22563, 22573, 22586, 22599, 22609, 22622,
+    22635, 22648, 22658, 22671, 22681, 22697, 22722, 22732, 22745, 22764, 22783, 22796,
+    22809, 22822, 22832, 22842, 22861, 22874, 22887, 22900, 22913, 22926, 22936, 22946,
+    22956, 22969, 22982, 22992, 23002, 23012, 23022, 23032, 23042, 23052, 23062, 23075,
+    23085, 23095, 23105, 23115, 23125, 23147, 23163, 23173, 23186, 23202, 23212, 23222,
+    23232, 23242, 23255, 23268, 23281, 23291, 23304, 23317, 23327, 23337, 23347, 23360,
+    23370, 23383, 23393, 23403, 23416, 23426, 23436, 23446, 23456, 23469, 23479, 23492,
+    23502, 23512, 23522, 23535, 23548, 23564, 23577, 23587, 23597, 23607, 23620, 23630,
+    23640, 23650, 23660, 23676, 23686, 23699, 23709, 23719, 23732, 23745, 23755, 23768,
+    23778, 23797, 23810, 23820, 23836, 23846, 23856, 23869, 23879, 23892, 23902, 23912,
+    23928, 23938, 23948, 23958, 23968, 23978, 23988, 23998, 24014, 24024, 24037, 24053,
+    24069, 24082, 24098, 24108, 24118, 24128, 24141, 24151, 24161, 24171, 24184, 24197,
+    24207, 24217, 24227, 24240, 24253, 24263, 24276, 24289, 24302, 24315, 24331, 24344,
+    24354, 24367, 24383, 24396, 24409, 24428, 24441, 24451, 24470, 24483, 24493, 24503,
+    24516, 24529, 24545, 24567, 24589, 24599, 24609, 24622, 24641, 24654, 24667, 24677,
+    24687, 24703, 24713, 24723, 24733, 24746, 24756, 24772, 24782, 24792, 24802, 24812,
+    24822, 24832, 24848, 24861, 24871, 24887, 24897, 24913, 24923, 24948, 24961, 24974,
+    24984, 24997, 25007, 25017, 25027, 25040, 25053, 25066, 25079, 25089, 25099, 25109,
+    25119, 25135, 25148, 25158, 25174, 25187, 25197, 25207, 25220, 25236, 25246, 25262,
+    25272, 25285, 25295, 25305, 25315, 25325, 25347, 25357, 25367, 25377, 25393, 25406,
+    25416, 25432, 25445, 25458, 25471, 25490, 25500, 25513, 25523, 25533, 25543, 25553,
+    25563, 25576, 25589, 25605, 25615, 25625, 25635, 25645, 25655, 25665, 25675, 25685,
+    25695, 25714, 25724, 25737, 25750, 25766, 25779, 25789, 25799, 25809, 25822, 25835,
+    25848, 25861, 25874, 25890, 25909, 25922, 25935, 25948, 25967, 25980, 25996, 26006,
+    26022, 26035, 26048, 26061, 26074, 26090, 26106, 26119, 26129, 26142, 26158, 26171,
+    26184, 26194, 26210, 26223, 26233, 26243, 26253, 26263, 26276, 26289, 26305, 26315,
+    26325, 26335, 26348, 26361, 26371, 26387, 26403, 26413,
+   };
+
+static const uint16_t jp_d[] = {
+    2, 0, 8, 0, 153, 1, 0, 5, 29, 33, 6, 6,
+    21, 139, 3, 0, 166, 27, 6, 87, 14, 509, 3, 3,
+    0, 29, 22, 3, 7, 4, 45, 21, 9, 18, 221, 2,
+    266, 326, 196, 0, 0, 11, 21, 113, 8, 92, 3, 6,
+    1, 55, 68, 96, 9, 2, 2, 2, 181, 1, 0, 50,
+    10, 2, 0, 0, 92, 1, 384, 186, 163, 54, 1, 31,
+    0, 60, 27, 268, 36, 199, 15, 4, 9, 19, 47, 37,
+    120, 97, 1, 130, 71, 5, 908, 20, 147, 1, 442, 68,
+    4, 141, 17, 107, 62, 11, 87, 9, 1, 10, 1, 0,
+    37, 178, 12, 80, 5, 213, 1, 238, 191, 1, 49, 50,
+    63, 1, 60, 44, 291, 4, 368, 26, 84, 5, 14, 32,
+    2, 3, 17, 7, 61, 48, 105, 40, 0, 47, 115, 59,
+    1, 276, 27, 75, 0, 4, 7, 88, 3, 0, 2, 28,
+    95, 0, 12, 2, 312, 45, 70, 3, 0, 5, 6, 3,
+    28, 65, 0, 79, 27, 145, 0, 343, 69, 23, 9, 0,
+    86, 81, 18, 165, 41, 5, 47, 12, 1, 4, 169, 78,
+    80, 9, 0, 337, 6, 0, 213, 9, 25, 2, 6, 11,
+    42, 0, 0, 6, 323, 62, 6, 21, 13, 93, 2, 0,
+    1, 245, 199, 6, 0, 21, 0, 19, 90, 7, 0, 23,
+    3, 190, 2, 5, 61, 231, 328, 31, 23, 19, 1, 7,
+    2, 193, 22, 203, 0, 4, 34, 382, 53, 412, 2, 13,
+    4, 54, 35, 17, 8, 0, 479, 3, 63, 6, 132, 3,
+    0, 9, 0, 15, 0, 71, 111, 172, 2, 108, 16, 0,
+    0, 11, 1, 18, 2, 14, 16, 7, 12, 172, 907, 107,
+    9, 13, 46, 81, 32, 28, 166, 3, 53, 8, 239, 670,
+    268, 233, 306, 231, 7, 708, 0, 142, 330, 384, 140, 88,
+    1582, 34, 16, 96, 0, 5, 51, 7, 28, 96, 1751, 4,
+    218, 42, 6, 735, 153, 11, 5, 242, 0, 95, 18, 65,
+    200, 28, 261, 458, 357, 204, 1, 186, 4, 12, 19, 12,
+    162, 2, 589, 160, 1238, 105, 38, 3, 31, 105, 120, 102,
+    32, 320, 150, 21, 19, 11, 392, 329, 269, 50, 315, 1250,
+    61, 621, 113, 216, 600, 1, 0, 37, 3, 31, 289, 251,
+    3, 21, 60, 336, 0, 0, 0, 91, 300, 201, 362, 542,
+    434, 280, 366, 59, 16, 88, 98, 29, 23, 20, 7, 41,
+    60, 1, 0, 28, 0, 2565, 1844, 105, 27, 26, 624, 35,
+    290, 519, 579, 876, 68, 17, 294, 178, 26, 0, 26, 2,
+    4, 2, 188, 208, 0, 2354, 798, 178, 1022, 47, 47, 550,
+    3742, 607, 1484, 7, 113, 48, 82, 301, 46, 3, 393, 1374,
+    161, 86, 301, 5, 8, 52, 126, 30, 21, 31, 817, 1,
+    0, 12, 1, 25, 2191, 0, 1138, 2, 240, 5, 3846, 29,
+    26, 1663, 4, 229, 285, 964, 541, 3, 30, 82, 643, 134,
+    1241, 231, 465, 113, 2124, 246, 72, 0, 102, 99, 1031, 1086,
+    1212, 372, 122, 247, 77, 214, 2721, 4,
+   };
+static const uint16_t jp_h[] = {
+    492, 863, 1718, 915, 716, 2040, 359, 234, 1617, 1189, 1027, 1762,
+    1519, 1240, 241, 1798, 605, 2016, 1896, 1638, 1057, 551, 1228, 1278,
+    1588, 303, 346, 1614, 584, 397, 1665, 874, 1165, 1565, 1474, 1147,
+    1338, 1486, 559, 1966, 854, 1664, 45, 739, 179, 1800, 141, 1992,
+    1796, 294, 1280, 1273, 579, 1640, 1879, 1377, 1065, 27, 1654, 1431,
+    1826, 1744, 1908, 301, 2034, 1396, 883, 1081, 186, 1328, 1999, 302,
+    2018, 1454, 9, 2047, 2003, 1889, 1892, 918, 1577, 606, 806, 2014,
+    1917, 1359, 260, 1639, 1874, 1234, 802, 1080, 1513, 1977, 1353, 1904,
+    1663, 1284, 369, 1470, 1056, 1931, 1224, 873, 1611, 665, 2026, 403,
+    59, 210, 54, 1387, 1990, 1170, 200, 1305, 1058, 199, 1001, 1634,
+    1120, 1855, 946, 347, 1148, 844, 107, 659, 1349, 73, 1986, 1935,
+    786, 414, 624, 1760, 364, 1764, 1782, 421, 1194, 1805, 671, 84,
+    855, 416, 171, 377, 758, 1390, 1186, 992, 1191, 1203, 948, 982,
+    257, 1350, 1801, 1385, 1432, 142, 917, 90, 523, 446, 1083, 1374,
+    859, 1441, 642, 1533, 1048, 1900, 207, 1285, 1809, 1160, 43, 120,
+    1994, 1686, 732, 1668, 1630, 281, 1236, 968, 1944, 509, 208, 194,
+    852, 226, 410, 213, 1298, 1022, 683, 615, 1615, 1771, 451, 803,
+    41, 1645, 1750, 449, 1776, 1384, 1780, 932, 1693, 144, 991, 490,
+    935, 1044, 1346, 1289, 484, 1698, 273, 1655, 1247, 92, 1263, 1412,
+    253, 227, 1126, 920, 1183, 757, 1288, 1709, 1543, 1556, 1472, 1467,
+    140, 1257, 474, 556, 1427, 1773, 1677, 783, 1429, 897, 627, 1845,
+    39, 1108, 830, 1962, 330, 71, 1135, 1105, 566, 1101, 1182, 1583,
+    1061, 933, 1835, 765, 1325, 1937, 78, 1473, 75, 651, 189, 1496,
+    640, 707, 119, 248, 94, 1178, 390, 182, 1086, 878, 1536, 56,
+    653, 5, 355, 98, 461, 625, 986, 1011, 436, 307, 44, 1785,
+    754, 278, 1039, 176, 1397, 1214, 147, 1860, 191, 486, 1633, 469,
+    1739, 430, 763, 926, 413, 1087, 721, 211, 1372, 1060, 351, 14,
+    526, 741, 1923, 431, 1876, 305, 1493, 1836, 276, 2012, 1471, 1426,
+    1123, 1388, 1073, 1421, 113, 249, 1541, 1939, 118, 160, 2015, 929,
+    670, 1480, 761, 435, 1510, 711, 845, 309, 1802, 1425, 955, 903,
+    375, 2031, 10, 1424, 1333, 953, 1557, 96, 966, 1694, 825, 1440,
+    2019, 1827, 2010, 297, 1151, 1127, 1572, 1326, 284, 1961, 1405, 950,
+    117, 139, 816, 1586, 1516, 613, 658, 581, 1965, 345, 1008, 1973,
+    1842, 690, 1163, 459, 751, 428, 1446, 235, 1589, 724, 1341, 1272,
+    1932, 1684, 1494, 827, 1632, 457, 1229, 1717, 1729, 51, 24, 1481,
+    1317, 887, 1662, 67, 634, 271, 1310, 399, 993, 907, 1757, 621,
+    245, 1993, 89, 2033, 175, 811, 1818, 1082, 239, 1413, 789, 1957,
+    1699, 882, 1945, 614, 1340, 846, 1704, 1710, 77, 387, 1190, 255,
+    703, 1954, 1146, 766, 259, 1485, 444, 1495, 1564, 441, 1626, 1040,
+    1658, 1856, 1462, 152, 650, 1914, 331, 909, 842, 886, 770, 477,
+    1707, 1216, 223, 1545, 495, 148, 238, 2025, 1850, 1209, 1456, 1034,
+    610, 1603, 153, 544, 796, 1404, 1262, 1062, 1629, 524, 1172, 382,
+    1584, 476, 1282, 908, 63, 1331, 40, 1488, 1437, 1911, 247, 775,
+    980, 365, 646, 1816, 1570, 1047, 814, 1307, 1144, 1685, 578, 738,
+    546, 1402, 214, 1804, 733, 899, 392, 1716, 1411, 1175, 1023, 1803,
+    1218, 1176, 1428, 1154, 574, 1943, 265, 528, 747, 500, 527, 1351,
+    1024, 1294, 1054, 834, 88, 952, 2043, 327, 1015, 1967, 1106, 767,
+    1447, 633, 1313, 1790, 300, 675, 429, 781, 975, 2035, 1824, 1124,
+    418, 1244, 841, 1092, 65, 749, 50, 1542, 780, 1025, 1266, 1401,
+    161, 548, 623, 541, 1090, 848, 129, 1364, 304, 1014, 282, 655,
+    904, 409, 726, 1264, 723, 590, 2017, 1311, 1891, 1795, 1909, 1696,
+    1706, 705, 1217, 1974, 136, 237, 290, 1136, 702, 1450, 1140, 895,
+    1299, 1772, 1841, 961, 411, 2038, 1439, 1059, 677, 1072, 31, 1050,
+    589, 1538, 335, 340, 1599, 1301, 1107, 86, 167, 252, 487, 510,
+    753, 2008, 422, 93, 1324, 404, 1657, 942, 553, 1766, 543, 1656,
+    774, 1131, 1142, 1673, 1295, 639, 1399, 805, 251, 905, 1362, 927,
+    2028, 1580, 150, 2, 686, 823, 1261, 1501, 3, 537, 853, 1595,
+    1659, 583, 1681, 338, 1419, 2042, 427, 1884, 557, 725, 109, 742,
+    930, 177, 34, 1751, 1582, 1323, 1259, 420, 1820, 69, 1927, 585,
+    306, 344, 820, 1604, 1031, 913, 1373, 1475, 1319, 1117, 2009, 1393,
+    788, 593, 1002, 1150, 367, 35, 1609, 712, 341, 931, 188, 1971,
+    1622, 885, 417, 1099, 769, 1159, 1461, 401, 1043, 1075, 1551, 1242,
+    622, 1303, 1938, 225, 1279, 1119, 692, 1781, 603, 539, 1811, 268,
+    378, 283, 49, 1074, 587, 1916, 531, 1846, 560, 1731, 936, 1969,
+    1723, 1118, 1682, 101, 938, 1322, 1375, 682, 875, 840, 960, 1409,
+    295, 131, 425, 2036, 1898, 163, 102, 398, 778, 745, 1032, 1208,
+    20, 358, 1607, 1890, 1255, 1831, 1678, 274, 267, 1121, 994, 538,
+    894, 1330, 987, 1158, 1968, 782, 1233, 638, 1763, 13, 714, 924,
+    463, 575, 1036, 1661, 1960, 58, 1921, 970, 962, 696, 976, 1537,
+    17, 1859, 499, 558, 1335, 1561, 990, 471, 1169, 1415, 61, 1955,
+    949, 1045, 1899, 1369, 82, 1828, 502, 1963, 824, 1152, 1546, 66,
+    1903, 666, 1873, 740, 2004, 489, 791, 812, 945, 1928, 1636, 1398,
+    1813, 573, 1788, 807, 880, 1291, 1679, 203, 1476, 1223, 865, 731,
+    978, 1088, 339, 1181, 1418, 7, 734, 1505, 1277, 1521, 1741, 289,
+    137, 1327, 48, 272, 708, 1220, 266, 715, 964, 292, 103, 888,
+    376, 317, 694, 1758, 277, 1477, 1981, 1643, 1188, 1875, 1727, 552,
+    106, 1137, 1807, 1071, 291, 519, 1115, 1641, 764, 1337, 1463, 1287,
+    246, 1574, 1854, 1616, 884, 956, 1204, 1156, 1098, 156, 870, 1618,
+    373, 1605, 472, 565, 1168, 221, 442, 138, 977, 1926, 64, 1370,
+    1797, 1769, 464, 1053, 1936, 1116, 607, 220, 876, 1579, 649, 287,
+    1853, 1096, 1737, 1046, 709, 1479, 1211, 809, 609, 1356, 1363, 784,
+    1100, 1857, 174, 616, 529, 79, 322, 969, 1509, 569, 336, 55,
+    668, 162, 555, 1553, 719, 466, 313, 1173, 1013, 1347, 456, 1198,
+    1382, 1761, 279, 1644, 697, 1498, 1197, 1309, 1422, 693, 1610, 296,
+    947, 1315, 1110, 11, 535, 1012, 216, 1976, 396, 1410, 352, 688,
+    1141, 6, 158, 1791, 37, 415, 934, 1613, 1468, 2022, 261, 1378,
+    166, 1843, 630, 652, 1030, 1312, 1352, 1880, 395, 998, 1708, 1998,
+    1956, 1507, 762, 1740, 1500, 316, 1435, 1174, 813, 232, 861, 1457,
+    1888, 889, 100, 1635, 868, 482, 1870, 438, 561, 1258, 591, 1972,
+    1195, 507, 205, 21, 1358, 1386, 483, 728, 965, 664, 916, 204,
+    1531, 517, 891, 902, 29, 582, 198, 1689, 713, 1991, 1624, 52,
+    776, 1885, 790, 588, 1849, 1079, 407, 324, 1366, 1987, 70, 1759,
+    923, 1653, 1212, 1445, 349, 773, 134, 308, 1946, 1016, 700, 860,
+    408, 1864, 1018, 759, 448, 1742, 1371, 1111, 157, 1547, 572, 87,
+    133, 1833, 1631, 1423, 831, 513, 1865, 357, 196, 116, 568, 727,
+    393, 263, 996, 661, 312, 1558, 1394, 1894, 1133, 1368, 1767, 1095,
+    400, 722, 1666, 1153, 1430, 91, 389, 1448, 197, 1711, 23, 1792,
+    458, 821, 468, 388, 718, 2001, 1357, 60, 1132, 145, 371, 1784,
+    275, 333, 1205, 1847, 1434, 236, 1734, 130, 1248, 667, 1459, 1478,
+    810, 1187, 1700, 1919, 1433, 1514, 687, 580, 643, 1508, 1528, 785,
+    1619, 941, 1983, 1260, 746, 798, 1492, 1491, 748, 1009, 1544, 1573,
+    1286, 1114, 62, 298, 1691, 1878, 1907, 1883, 1232, 674, 1207, 155,
+    1042, 598, 1852, 405, 839, 681, 146, 1334, 293, 1868, 1403, 1930,
+    1934, 1112, 2027, 1091, 1567, 1555, 892, 256, 1213, 562, 440, 318,
+    525, 545, 190, 1068, 473, 1747, 1125, 1719, 2023, 516, 792, 254,
+    1794, 1675, 1817, 906, 12, 730, 912, 620, 1933, 1512, 1808, 862,
+    173, 97, 1007, 135, 1253, 192, 995, 1920, 1035, 752, 779, 1778,
+    1162, 599, 1442, 1777, 1814, 394, 631, 315, 478, 1003, 270, 1250,
+    2032, 348, 1246, 1038, 1033, 768, 617, 1268, 1052, 475, 743, 829,
+    1265, 1674, 2039, 1897, 1913, 121, 1077, 1825, 85, 1829, 1484, 1838,
+    1922, 981, 372, 1251, 857, 1487, 95, 951, 1332, 231, 288, 1819,
+    1979, 412, 808, 1483, 772, 760, 637, 439, 128, 1184, 1743, 1202,
+    26, 1143, 445, 467, 1929, 1725, 1192, 423, 1627, 1502, 337, 1241,
+    1554, 1028, 822, 1527, 328, 1786, 53, 1532, 522, 1355, 1563, 1522,
+    170, 611, 1840, 1812, 1180, 356, 755, 1858, 1292, 1851, 180, 843,
+    1749, 602, 656, 1055, 1839, 1449, 600, 608, 1568, 532, 501, 1540,
+    36, 381, 618, 321, 391, 1343, 1548, 756, 151, 184, 1581, 997,
+    1724, 460, 1171, 368, 958, 1235, 890, 1872, 1005, 149, 534, 1269,
+    832, 178, 437, 1392, 612, 325, 504, 567, 1006, 1069, 1497, 1652,
+    1905, 1592, 801, 577, 229, 383, 1755, 1453, 1344, 8, 1951, 619,
+    1389, 366, 1342, 1417, 2013, 787, 570, 1037, 1252, 243, 1104, 310,
+    1863, 1651, 76, 698, 1712, 168, 1596, 212, 1978, 1910, 1464, 1550,
+    1989, 1886, 1821, 1010, 374, 819, 1094, 804, 2046, 1881, 1705, 209,
+    695, 28, 1958, 112, 159, 660, 736, 219, 1918, 1525, 1271, 230,
+    914, 432, 1695, 38, 2044, 967, 586, 684, 691, 1877, 867, 919,
+    735, 1451, 1571, 1200, 877, 1924, 2024, 285, 105, 632, 1591, 424,
+    1601, 511, 1593, 1680, 1149, 1806, 1420, 1915, 222, 629, 799, 1354,
+    1612, 710, 1029, 1097, 549, 2020, 626, 1721, 1416, 654, 2006, 42,
+    2041, 25, 1300, 1942, 1523, 124, 350, 1756, 385, 939, 332, 800,
+    1239, 521, 1585, 485, 343, 1049, 1276, 1748, 971, 434, 299, 206,
+    1648, 497, 1304, 1064, 533, 402, 837, 881, 628, 1901, 1637, 954,
+    959, 1226, 1672, 1365, 125, 164, 244, 985, 2005, 185, 1379, 1646,
+    1600, 518, 1506, 181, 1219, 1348, 1713, 1745, 264, 1316, 1697, 447,
+    957, 672, 1406, 818, 1623, 1367, 896, 1314, 1231, 1671, 1381, 470,
+    363, 1345, 1206, 922, 126, 1688, 540, 1714, 1400, 353, 704, 943,
+    108, 554, 973, 1539, 1810, 32, 1222, 1844, 1738, 280, 201, 18,
+    1254, 1730, 1559, 1754, 1949, 262, 1628, 1020, 689, 57, 1549, 384,
+    1925, 1732, 1594, 1952, 1906, 342, 1765, 4, 1380, 817, 911, 1848,
+    1940, 866, 530, 1783, 1274, 944, 1221, 362, 1984, 488, 988, 1578,
+    1799, 1185, 258, 127, 828, 706, 505, 1620, 419, 1166, 1066, 19,
+    1621, 354, 1361, 679, 1017, 1887, 720, 1469, 0, 1503, 1576, 1482,
+    1560, 1667, 1953, 1775, 940, 979, 1063, 858, 1230, 1438, 1535, 536,
+    826, 22, 1275, 1179, 910, 1000, 2037, 663, 869, 111, 320, 1822,
+    1832, 1789, 99, 647, 662, 676, 1882, 370, 1787, 1753, 972, 1511,
+    685, 15, 2007, 1995, 1534, 498, 1109, 1297, 1562, 329, 2000, 1067,
+    604, 879, 597, 1138, 1670, 250, 974, 319, 641, 1687, 1225, 508,
+    1895, 269, 165, 2029, 1085, 1515, 851, 1281, 1517, 1466, 454, 833,
+    1443, 1735, 114, 123, 1339, 1869, 480, 1227, 871, 1702, 1460, 2045,
+    1642, 496, 1703, 1606, 1293, 1455, 242, 1130, 1019, 1041, 453, 360,
+    856, 1774, 1866, 1296, 984, 645, 1690, 963, 815, 1122, 1237, 547,
+    850, 1985, 1499, 104, 433, 550, 1793, 1834, 1407, 1530, 1414, 1093,
+    1752, 1383, 835, 701, 1861, 47, 1996, 669, 80, 983, 1770, 1196,
+    1193, 1912, 1837, 793, 1862, 928, 1238, 1602, 314, 849, 2002, 680,
+    455, 334, 465, 564, 1177, 1715, 1113, 224, 771, 1210, 1959, 1608,
+    426, 1360, 30, 1590, 83, 648, 1157, 673, 1164, 594, 132, 1329,
+    777, 1504, 1199, 520, 1283, 183, 187, 1318, 925, 635, 678, 406,
+    1980, 512, 1947, 1587, 1518, 1660, 1948, 1575, 386, 1051, 286, 1970,
+    571, 1452, 1167, 1566, 1733, 1436, 1243, 921, 514, 1988, 563, 494,
+    1676, 1692, 1823, 1408, 893, 515, 657, 737, 1490, 1078, 1249, 750,
+    2011, 937, 154, 729, 1267, 68, 1026, 1529, 744, 311, 33, 1444,
+    1722, 1128, 326, 1524, 989, 838, 493, 323, 2021, 1270, 1830, 1625,
+    1975, 172, 1308, 491, 1902, 1134, 2030, 1376, 1569, 380, 900, 699,
+    1004, 1302, 1728, 115, 797, 1391, 1145, 1465, 1201, 1746, 1598, 1139,
+    479, 1720, 847, 1950, 1155, 1021, 898, 836, 1070, 1701, 1650, 72,
+    901, 1669, 228, 1647, 1458, 193, 794, 462, 143, 1526, 1245, 217,
+    379, 1941, 74, 717, 1129, 1597, 1736, 46, 1997, 81, 576, 1102,
+    122, 1982, 218, 503, 1336, 1076, 595, 215, 1867, 1726, 592, 452,
+    1215, 233, 1964, 644, 202, 450, 361, 1103, 1, 1520, 1893, 16,
+    1779, 1161, 542, 1395, 636, 481, 864, 1306, 1649, 601, 195, 1320,
+    1815, 1089, 110, 443, 795, 1489, 872, 1552, 169, 999, 1290, 240,
+    1084, 1683, 596, 1321, 1871, 1768, 1256, 506,
    };
-#undef jp
 
 static const struct words jp_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words jp_words = {
     false,
     (const char *)jp_,
     0, /* Constant string */
-    jp_i
+    NULL, /* Words are located by offset */
+    jp_o,
+    0u,
+    jp_d,
+    jp_h
 };
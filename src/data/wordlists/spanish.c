@@ -2051,352 +2051,398 @@ static const unsigned char es_[] = {
     0x7a,0x75,0x6d,0x6f,0,
     0x7a,0x75,0x72,0x64,0x6f,0,
 };
-#define es ((const char*)es_)
-static const char *es_i[] = {
-    es+0, es+8, es+16, es+22, es+30, es+38,
-    es+44, es+51, es+58, es+64, es+71, es+77,
-    es+84, es+93, es+100, es+109, es+116, es+123,
-    es+130, es+138, es+146, es+154, es+161, es+168,
-    es+174, es+181, es+186, es+193, es+200, es+207,
-    es+215, es+222, es+229, es+237, es+245, es+252,
-    es+259, es+266, es+274, es+282, es+292, es+299,
-    es+307, es+314, es+321, es+330, es+337, es+344,
-    es+352, es+358, es+363, es+369, es+378, es+384,
-    es+390, es+397, es+402, es+409, es+417, es+423,
-    es+430, es+440, es+448, es+455, es+460, es+468,
-    es+476, es+482, es+489, es+496, es+503, es+509,
-    es+517, es+522, es+532, es+539, es+547, es+554,
-    es+559, es+566, es+576, es+582, es+589, es+596,
-    es+601, es+608, es+615, es+621, es+628, es+635,
-    es+643, es+650, es+657, es+665, es+674, es+680,
-    es+686, es+694, es+699, es+706, es+713, es+719,
-    es+727, es+733, es+739, es+747, es+754, es+763,
-    es+770, es+778, es+785, es+792, es+799, es+807,
-    es+814, es+820, es+827, es+835, es+844, es+852,
-    es+858, es+865, es+873, es+881, es+886, es+894,
-    es+900, es+907, es+913, es+922, es+930, es+938,
-    es+944, es+950, es+958, es+963, es+973, es+981,
-    es+989, es+997, es+1002, es+1008, es+1016, es+1022,
-    es+1029, es+1037, es+1043, es+1053, es+1061, es+1067,
-    es+1072, es+1080, es+1088, es+1094, es+1101, es+1106,
-    es+1114, es+1118, es+1124, es+1131, es+1139, es+1148,
-    es+1153, es+1160, es+1168, es+1174, es+1182, es+1187,
-    es+1195, es+1204, es+1212, es+1218, es+1225, es+1232,
-    es+1239, es+1245, es+1252, es+1257, es+1264, es+1269,
-    es+1277, es+1284, es+1292, es+1299, es+1305, es+1312,
-    es+1318, es+1324, es+1329, es+1334, es+1342, es+1350,
-    es+1356, es+1361, es+1368, es+1374, es+1378, es+1387,
-    es+1393, es+1402, es+1410, es+1416, es+1421, es+1427,
-    es+1433, es+1443, es+1448, es+1454, es+1463, es+1470,
-    es+1475, es+1480, es+1486, es+1492, es+1500, es+1506,
-    es+1512, es+1520, es+1529, es+1535, es+1543, es+1549,
-    es+1555, es+1562, es+1568, es+1574, es+1581, es+1587,
-    es+1597, es+1606, es+1613, es+1621, es+1631, es+1637,
-    es+1644, es+1651, es+1657, es+1664, es+1671, es+1677,
-    es+1683, es+1688, es+1695, es+1701, es+1706, es+1712,
-    es+1719, es+1726, es+1732, es+1736, es+1743, es+1748,
-    es+1753, es+1760, es+1765, es+1772, es+1778, es+1783,
-    es+1790, es+1796, es+1802, es+1809, es+1816, es+1821,
-    es+1830, es+1836, es+1843, es+1850, es+1855, es+1863,
-    es+1872, es+1878, es+1884, es+1890, es+1897, es+1903,
-    es+1910, es+1917, es+1923, es+1929, es+1935, es+1942,
-    es+1948, es+1954, es+1961, es+1967, es+1973, es+1979,
-    es+1985, es+1990, es+1998, es+2006, es+2013, es+2020,
-    es+2026, es+2034, es+2040, es+2046, es+2053, es+2060,
-    es+2068, es+2076, es+2083, es+2090, es+2096, es+2102,
-    es+2112, es+2119, es+2124, es+2131, es+2139, es+2148,
-    es+2153, es+2161, es+2165, es+2173, es+2180, es+2186,
-    es+2194, es+2200, es+2206, es+2212, es+2218, es+2223,
-    es+2230, es+2238, es+2245, es+2251, es+2260, es+2267,
-    es+2274, es+2282, es+2289, es+2295, es+2302, es+2312,
-    es+2318, es+2323, es+2329, es+2339, es+2346, es+2353,
-    es+2361, es+2366, es+2375, es+2384, es+2391, es+2397,
-    es+2406, es+2412, es+2420, es+2426, es+2432, es+2437,
-    es+2443, es+2450, es+2456, es+2463, es+2471, es+2477,
-    es+2484, es+2490, es+2495, es+2503, es+2509, es+2515,
-    es+2521, es+2531, es+2538, es+2547, es+2555, es+2562,
-    es+2569, es+2575, es+2581, es+2588, es+2593, es+2600,
-    es+2608, es+2617, es+2623, es+2630, es+2638, es+2647,
-    es+2655, es+2661, es+2668, es+2674, es+2681, es+2687,
-    es+2694, es+2700, es+2708, es+2715, es+2724, es+2730,
-    es+2736, es+2741, es+2748, es+2754, es+2762, es+2767,
-    es+2773, es+2778, es+2784, es+2793, es+2799, es+2807,
-    es+2813, es+2818, es+2825, es+2832, es+2837, es+2843,
-    es+2849, es+2855, es+2863, es+2869, es+2879, es+2885,
-    es+2895, es+2903, es+2910, es+2915, es+2924, es+2929,
-    es+2935, es+2941, es+2948, es+2956, es+2961, es+2966,
-    es+2973, es+2981, es+2988, es+2995, es+3002, es+3008,
-    es+3016, es+3024, es+3030, es+3037, es+3046, es+3053,
-    es+3059, es+3066, es+3072, es+3080, es+3088, es+3095,
-    es+3100, es+3106, es+3116, es+3124, es+3131, es+3140,
-    es+3147, es+3154, es+3160, es+3167, es+3173, es+3182,
-    es+3191, es+3197, es+3204, es+3213, es+3219, es+3226,
-    es+3233, es+3240, es+3247, es+3253, es+3263, es+3272,
-    es+3278, es+3283, es+3290, es+3297, es+3304, es+3309,
-    es+3316, es+3324, es+3331, es+3338, es+3345, es+3352,
-    es+3358, es+3365, es+3373, es+3379, es+3385, es+3392,
-    es+3400, es+3405, es+3412, es+3418, es+3426, es+3435,
-    es+3441, es+3449, es+3455, es+3461, es+3467, es+3472,
-    es+3478, es+3482, es+3488, es+3496, es+3502, es+3510,
-    es+3519, es+3525, es+3530, es+3538, es+3546, es+3552,
-    es+3561, es+3569, es+3576, es+3583, es+3589, es+3596,
-    es+3604, es+3612, es+3620, es+3629, es+3635, es+3643,
-    es+3651, es+3659, es+3668, es+3676, es+3684, es+3690,
-    es+3696, es+3703, es+3711, es+3720, es+3726, es+3733,
-    es+3740, es+3747, es+3754, es+3760, es+3765, es+3775,
-    es+3781, es+3788, es+3795, es+3802, es+3810, es+3818,
-    es+3824, es+3833, es+3841, es+3846, es+3853, es+3859,
-    es+3864, es+3870, es+3878, es+3882, es+3888, es+3895,
-    es+3902, es+3908, es+3912, es+3918, es+3927, es+3933,
-    es+3939, es+3944, es+3950, es+3958, es+3964, es+3970,
-    es+3976, es+3982, es+3989, es+3994, es+4002, es+4008,
-    es+4014, es+4018, es+4026, es+4031, es+4041, es+4050,
-    es+4057, es+4064, es+4071, es+4078, es+4082, es+4090,
-    es+4099, es+4106, es+4115, es+4122, es+4129, es+4137,
-    es+4144, es+4151, es+4158, es+4165, es+4172, es+4182,
-    es+4189, es+4198, es+4205, es+4213, es+4219, es+4227,
-    es+4235, es+4243, es+4251, es+4257, es+4264, es+4272,
-    es+4281, es+4288, es+4295, es+4302, es+4309, es+4316,
-    es+4326, es+4333, es+4340, es+4347, es+4355, es+4363,
-    es+4370, es+4376, es+4383, es+4390, es+4398, es+4407,
-    es+4414, es+4422, es+4429, es+4438, es+4445, es+4452,
-    es+4460, es+4467, es+4474, es+4482, es+4488, es+4493,
-    es+4500, es+4507, es+4513, es+4520, es+4528, es+4534,
-    es+4541, es+4549, es+4556, es+4563, es+4570, es+4577,
-    es+4584, es+4591, es+4598, es+4605, es+4612, es+4620,
-    es+4628, es+4636, es+4645, es+4653, es+4661, es+4671,
-    es+4680, es+4688, es+4696, es+4703, es+4709, es+4714,
-    es+4720, es+4726, es+4732, es+4739, es+4744, es+4752,
-    es+4759, es+4768, es+4777, es+4783, es+4789, es+4794,
-    es+4801, es+4807, es+4813, es+4817, es+4825, es+4831,
-    es+4837, es+4841, es+4847, es+4853, es+4862, es+4869,
-    es+4878, es+4885, es+4892, es+4897, es+4903, es+4913,
-    es+4919, es+4925, es+4932, es+4937, es+4943, es+4950,
-    es+4957, es+4963, es+4968, es+4973, es+4980, es+4987,
-    es+4994, es+4998, es+5004, es+5011, es+5018, es+5024,
-    es+5030, es+5037, es+5044, es+5049, es+5055, es+5061,
-    es+5067, es+5075, es+5081, es+5086, es+5093, es+5101,
-    es+5107, es+5115, es+5121, es+5127, es+5133, es+5141,
-    es+5148, es+5153, es+5158, es+5166, es+5175, es+5182,
-    es+5188, es+5195, es+5203, es+5209, es+5215, es+5222,
-    es+5228, es+5234, es+5240, es+5247, es+5254, es+5259,
-    es+5265, es+5275, es+5281, es+5290, es+5296, es+5302,
-    es+5311, es+5318, es+5325, es+5331, es+5337, es+5342,
-    es+5347, es+5357, es+5363, es+5369, es+5375, es+5382,
-    es+5388, es+5394, es+5401, es+5407, es+5416, es+5423,
-    es+5428, es+5438, es+5445, es+5451, es+5455, es+5464,
-    es+5470, es+5476, es+5484, es+5492, es+5499, es+5505,
-    es+5513, es+5522, es+5528, es+5533, es+5541, es+5547,
-    es+5554, es+5558, es+5564, es+5571, es+5577, es+5582,
-    es+5588, es+5595, es+5601, es+5606, es+5612, es+5618,
-    es+5624, es+5634, es+5640, es+5646, es+5653, es+5659,
-    es+5666, es+5673, es+5679, es+5684, es+5690, es+5697,
-    es+5704, es+5711, es+5717, es+5723, es+5730, es+5736,
-    es+5744, es+5751, es+5758, es+5766, es+5772, es+5778,
-    es+5787, es+5794, es+5801, es+5807, es+5815, es+5822,
-    es+5828, es+5834, es+5839, es+5846, es+5853, es+5860,
-    es+5864, es+5873, es+5881, es+5887, es+5893, es+5900,
-    es+5906, es+5913, es+5919, es+5927, es+5935, es+5942,
-    es+5948, es+5955, es+5964, es+5972, es+5977, es+5983,
-    es+5992, es+5999, es+6005, es+6013, es+6018, es+6025,
-    es+6031, es+6037, es+6043, es+6048, es+6056, es+6062,
-    es+6069, es+6074, es+6080, es+6087, es+6094, es+6100,
-    es+6106, es+6112, es+6117, es+6124, es+6133, es+6141,
-    es+6146, es+6153, es+6163, es+6169, es+6175, es+6181,
-    es+6188, es+6196, es+6204, es+6211, es+6217, es+6224,
-    es+6234, es+6241, es+6248, es+6255, es+6261, es+6269,
-    es+6277, es+6285, es+6293, es+6302, es+6309, es+6316,
-    es+6324, es+6332, es+6339, es+6347, es+6354, es+6361,
-    es+6369, es+6378, es+6388, es+6397, es+6404, es+6413,
-    es+6422, es+6426, es+6431, es+6440, es+6445, es+6452,
-    es+6461, es+6469, es+6477, es+6484, es+6493, es+6499,
-    es+6505, es+6514, es+6519, es+6527, es+6534, es+6542,
-    es+6549, es+6555, es+6560, es+6567, es+6574, es+6579,
-    es+6587, es+6592, es+6600, es+6607, es+6613, es+6620,
-    es+6626, es+6633, es+6643, es+6649, es+6655, es+6663,
-    es+6670, es+6675, es+6681, es+6687, es+6693, es+6699,
-    es+6704, es+6713, es+6721, es+6731, es+6738, es+6744,
-    es+6750, es+6759, es+6769, es+6774, es+6781, es+6790,
-    es+6796, es+6804, es+6810, es+6816, es+6826, es+6831,
-    es+6839, es+6845, es+6852, es+6858, es+6863, es+6868,
-    es+6878, es+6884, es+6891, es+6896, es+6905, es+6914,
-    es+6921, es+6928, es+6934, es+6941, es+6948, es+6957,
-    es+6966, es+6972, es+6978, es+6983, es+6991, es+7000,
-    es+7006, es+7012, es+7020, es+7027, es+7034, es+7039,
-    es+7046, es+7051, es+7060, es+7068, es+7075, es+7081,
-    es+7087, es+7095, es+7103, es+7108, es+7117, es+7127,
-    es+7132, es+7138, es+7145, es+7151, es+7157, es+7163,
-    es+7169, es+7176, es+7182, es+7189, es+7196, es+7203,
-    es+7210, es+7217, es+7224, es+7229, es+7238, es+7243,
-    es+7250, es+7259, es+7265, es+7273, es+7278, es+7284,
-    es+7289, es+7295, es+7301, es+7307, es+7312, es+7317,
-    es+7323, es+7328, es+7335, es+7340, es+7344, es+7351,
-    es+7357, es+7364, es+7370, es+7377, es+7385, es+7391,
-    es+7397, es+7402, es+7409, es+7416, es+7423, es+7429,
-    es+7434, es+7441, es+7447, es+7453, es+7459, es+7465,
-    es+7473, es+7479, es+7489, es+7496, es+7501, es+7507,
-    es+7513, es+7522, es+7527, es+7537, es+7541, es+7547,
-    es+7553, es+7560, es+7567, es+7574, es+7583, es+7592,
-    es+7599, es+7605, es+7610, es+7620, es+7627, es+7633,
-    es+7641, es+7647, es+7654, es+7663, es+7669, es+7677,
-    es+7683, es+7691, es+7697, es+7706, es+7714, es+7720,
-    es+7727, es+7735, es+7743, es+7749, es+7757, es+7763,
-    es+7770, es+7778, es+7787, es+7796, es+7800, es+7808,
-    es+7813, es+7819, es+7828, es+7834, es+7841, es+7847,
-    es+7852, es+7860, es+7865, es+7869, es+7877, es+7885,
-    es+7894, es+7899, es+7904, es+7911, es+7920, es+7927,
-    es+7933, es+7939, es+7944, es+7952, es+7958, es+7964,
-    es+7970, es+7975, es+7983, es+7992, es+7997, es+8004,
-    es+8009, es+8015, es+8021, es+8027, es+8034, es+8042,
-    es+8048, es+8056, es+8063, es+8069, es+8075, es+8082,
-    es+8089, es+8096, es+8103, es+8109, es+8115, es+8121,
-    es+8128, es+8134, es+8142, es+8149, es+8155, es+8163,
-    es+8168, es+8174, es+8180, es+8187, es+8193, es+8200,
-    es+8208, es+8214, es+8220, es+8225, es+8232, es+8238,
-    es+8244, es+8253, es+8259, es+8264, es+8274, es+8280,
-    es+8286, es+8295, es+8301, es+8309, es+8318, es+8324,
-    es+8330, es+8338, es+8344, es+8351, es+8357, es+8363,
-    es+8370, es+8378, es+8387, es+8393, es+8398, es+8406,
-    es+8412, es+8421, es+8427, es+8435, es+8441, es+8448,
-    es+8455, es+8460, es+8467, es+8473, es+8480, es+8486,
-    es+8491, es+8498, es+8504, es+8512, es+8519, es+8528,
-    es+8534, es+8542, es+8548, es+8557, es+8563, es+8569,
-    es+8575, es+8580, es+8588, es+8595, es+8602, es+8608,
-    es+8613, es+8618, es+8627, es+8635, es+8640, es+8646,
-    es+8652, es+8657, es+8662, es+8671, es+8678, es+8684,
-    es+8690, es+8697, es+8704, es+8709, es+8716, es+8725,
-    es+8733, es+8739, es+8743, es+8749, es+8758, es+8766,
-    es+8771, es+8776, es+8781, es+8788, es+8796, es+8803,
-    es+8810, es+8818, es+8824, es+8829, es+8836, es+8842,
-    es+8849, es+8856, es+8863, es+8871, es+8876, es+8883,
-    es+8889, es+8893, es+8897, es+8904, es+8911, es+8917,
-    es+8922, es+8927, es+8932, es+8939, es+8947, es+8952,
-    es+8957, es+8963, es+8972, es+8980, es+8987, es+8994,
-    es+9000, es+9009, es+9017, es+9027, es+9034, es+9039,
-    es+9048, es+9053, es+9059, es+9065, es+9074, es+9082,
-    es+9090, es+9098, es+9105, es+9112, es+9116, es+9125,
-    es+9131, es+9140, es+9147, es+9154, es+9158, es+9164,
-    es+9172, es+9177, es+9183, es+9191, es+9199, es+9209,
-    es+9216, es+9222, es+9228, es+9234, es+9241, es+9250,
-    es+9255, es+9262, es+9271, es+9279, es+9285, es+9292,
-    es+9301, es+9307, es+9314, es+9321, es+9325, es+9331,
-    es+9340, es+9348, es+9358, es+9365, es+9371, es+9379,
-    es+9387, es+9393, es+9401, es+9407, es+9413, es+9418,
-    es+9428, es+9435, es+9445, es+9451, es+9457, es+9463,
-    es+9472, es+9477, es+9483, es+9488, es+9494, es+9501,
-    es+9507, es+9513, es+9518, es+9525, es+9534, es+9541,
-    es+9548, es+9554, es+9560, es+9566, es+9572, es+9578,
-    es+9584, es+9594, es+9600, es+9608, es+9616, es+9621,
-    es+9628, es+9633, es+9640, es+9650, es+9657, es+9662,
-    es+9669, es+9679, es+9684, es+9691, es+9698, es+9705,
-    es+9712, es+9719, es+9725, es+9733, es+9739, es+9747,
-    es+9752, es+9758, es+9767, es+9777, es+9786, es+9797,
-    es+9801, es+9810, es+9816, es+9825, es+9829, es+9836,
-    es+9843, es+9849, es+9856, es+9862, es+9869, es+9878,
-    es+9883, es+9890, es+9896, es+9903, es+9909, es+9914,
-    es+9921, es+9927, es+9935, es+9940, es+9946, es+9954,
-    es+9960, es+9966, es+9971, es+9977, es+9983, es+9989,
-    es+9996, es+10002, es+10008, es+10014, es+10021, es+10027,
-    es+10032, es+10038, es+10044, es+10050, es+10059, es+10065,
-    es+10071, es+10081, es+10087, es+10093, es+10100, es+10107,
-    es+10112, es+10118, es+10124, es+10134, es+10141, es+10148,
-    es+10155, es+10163, es+10169, es+10178, es+10184, es+10189,
-    es+10195, es+10202, es+10211, es+10218, es+10225, es+10231,
-    es+10238, es+10244, es+10255, es+10265, es+10272, es+10277,
-    es+10284, es+10292, es+10301, es+10308, es+10317, es+10326,
-    es+10332, es+10340, es+10347, es+10354, es+10364, es+10371,
-    es+10381, es+10389, es+10395, es+10402, es+10409, es+10416,
-    es+10422, es+10428, es+10437, es+10443, es+10449, es+10454,
-    es+10460, es+10468, es+10475, es+10480, es+10487, es+10494,
-    es+10501, es+10507, es+10514, es+10521, es+10527, es+10534,
-    es+10544, es+10551, es+10558, es+10567, es+10573, es+10578,
-    es+10587, es+10595, es+10602, es+10607, es+10613, es+10620,
-    es+10626, es+10632, es+10641, es+10647, es+10653, es+10659,
-    es+10664, es+10669, es+10674, es+10682, es+10693, es+10702,
-    es+10711, es+10718, es+10725, es+10732, es+10740, es+10748,
-    es+10755, es+10761, es+10769, es+10773, es+10781, es+10789,
-    es+10797, es+10805, es+10814, es+10822, es+10829, es+10835,
-    es+10841, es+10849, es+10857, es+10863, es+10870, es+10875,
-    es+10882, es+10889, es+10897, es+10905, es+10911, es+10917,
-    es+10925, es+10930, es+10937, es+10944, es+10950, es+10958,
-    es+10966, es+10973, es+10980, es+10984, es+10992, es+10999,
-    es+11007, es+11013, es+11021, es+11028, es+11036, es+11044,
-    es+11051, es+11059, es+11067, es+11071, es+11077, es+11082,
-    es+11088, es+11095, es+11102, es+11107, es+11116, es+11122,
-    es+11131, es+11141, es+11147, es+11155, es+11160, es+11166,
-    es+11171, es+11176, es+11182, es+11187, es+11194, es+11200,
-    es+11206, es+11214, es+11219, es+11226, es+11231, es+11238,
-    es+11245, es+11249, es+11255, es+11261, es+11266, es+11273,
-    es+11278, es+11284, es+11291, es+11297, es+11304, es+11310,
-    es+11315, es+11321, es+11327, es+11333, es+11339, es+11346,
-    es+11351, es+11357, es+11363, es+11371, es+11376, es+11383,
-    es+11392, es+11398, es+11404, es+11410, es+11416, es+11422,
-    es+11430, es+11435, es+11441, es+11448, es+11454, es+11463,
-    es+11471, es+11477, es+11483, es+11489, es+11496, es+11502,
-    es+11512, es+11521, es+11528, es+11535, es+11543, es+11548,
-    es+11554, es+11559, es+11565, es+11573, es+11582, es+11589,
-    es+11597, es+11603, es+11613, es+11623, es+11628, es+11636,
-    es+11642, es+11646, es+11653, es+11658, es+11664, es+11670,
-    es+11677, es+11685, es+11691, es+11698, es+11706, es+11714,
-    es+11722, es+11728, es+11737, es+11741, es+11747, es+11756,
-    es+11763, es+11771, es+11780, es+11785, es+11793, es+11800,
-    es+11805, es+11811, es+11817, es+11824, es+11830, es+11836,
-    es+11842, es+11851, es+11858, es+11867, es+11873, es+11883,
-    es+11889, es+11896, es+11904, es+11910, es+11917, es+11923,
-    es+11929, es+11935, es+11939, es+11946, es+11954, es+11962,
-    es+11971, es+11978, es+11989, es+11996, es+12003, es+12010,
-    es+12017, es+12025, es+12030, es+12037, es+12045, es+12051,
-    es+12060, es+12067, es+12076, es+12085, es+12091, es+12097,
-    es+12104, es+12110, es+12117, es+12123, es+12131, es+12138,
-    es+12145, es+12152, es+12161, es+12167, es+12175, es+12182,
-    es+12190, es+12198, es+12202, es+12208, es+12217, es+12224,
-    es+12230, es+12236, es+12243, es+12251, es+12257, es+12264,
-    es+12269, es+12275, es+12280, es+12286, es+12292, es+12300,
-    es+12306, es+12314, es+12323, es+12330, es+12336, es+12343,
-    es+12348, es+12355, es+12361, es+12369, es+12378, es+12384,
-    es+12390, es+12397, es+12405, es+12411, es+12417, es+12423,
-    es+12431, es+12437, es+12442, es+12450, es+12457, es+12463,
-    es+12469, es+12479, es+12486, es+12492, es+12499, es+12504,
-    es+12515, es+12520, es+12526, es+12533, es+12539, es+12546,
-    es+12552, es+12558, es+12564, es+12573, es+12581, es+12587,
-    es+12597, es+12605, es+12612, es+12618, es+12625, es+12633,
-    es+12640, es+12646, es+12650, es+12656, es+12666, es+12673,
-    es+12680, es+12687, es+12693, es+12699, es+12706, es+12712,
-    es+12719, es+12728, es+12733, es+12739, es+12745, es+12754,
-    es+12759, es+12764, es+12772, es+12780, es+12789, es+12798,
-    es+12803, es+12810, es+12818, es+12824, es+12831, es+12836,
-    es+12841, es+12847, es+12853, es+12858, es+12864, es+12870,
-    es+12875, es+12881, es+12889, es+12896, es+12905, es+12912,
-    es+12917, es+12925, es+12931, es+12937, es+12945, es+12949,
-    es+12955, es+12961, es+12970, es+12978, es+12986, es+12992,
-    es+13002, es+13008, es+13014, es+13020, es+13027, es+13033,
-    es+13040, es+13047, es+13056, es+13063, es+13071, es+13076,
-    es+13083, es+13088, es+13094, es+13100, es+13106, es+13113,
-    es+13121, es+13128, es+13135, es+13142, es+13148, es+13154,
-    es+13160, es+13166, es+13173, es+13179, es+13189, es+13194,
-    es+13201, es+13207, es+13213, es+13221, es+13230, es+13238,
-    es+13246, es+13252, es+13258, es+13265, es+13274, es+13281,
-    es+13288, es+13293, es+13302, es+13306, es+13312, es+13318,
-    es+13325, es+13330, es+13338, es+13343, es+13348, es+13356,
-    es+13363, es+13372, es+13376, es+13381, es+13389, es+13396,
-    es+13402, es+13407, es+13413, es+13421, es+13426, es+13435,
-    es+13441, es+13447, es+13457, es+13465, es+13470, es+13477,
-    es+13485, es+13490, es+13497, es+13504, es+13515, es+13522,
-    es+13528, es+13533, es+13540, es+13546, es+13551, es+13558,
-    es+13564, es+13571, es+13578, es+13584, es+13590, es+13596,
-    es+13600, es+13607, es+13613, es+13619, es+13626, es+13632,
-    es+13638, es+13645, es+13651, es+13657, es+13664, es+13670,
-    es+13680, es+13685, es+13693, es+13700, es+13706, es+13714,
-    es+13720, es+13724, es+13730, es+13738, es+13743, es+13752,
-    es+13761, es+13767, es+13773, es+13780, es+13786, es+13796,
-    es+13802, es+13811, es+13817, es+13823, es+13830, es+13836,
-    es+13841, es+13850, es+13858, es+13865, es+13871, es+13877,
-    es+13882, es+13886, es+13892, es+13899, es+13905, es+13910,
-    es+13916, es+13921, es+13927, es+13932, es+13937, es+13942,
-    es+13948, es+13955, es+13961, es+13968, es+13974, es+13979,
-    es+13985, es+13990, es+13996,
+static const uint16_t es_o[] = {
+    0, 8, 16, 22, 30, 38, 44, 51, 58, 64, 71, 77,
+    84, 93, 100, 109, 116, 123, 130, 138, 146, 154, 161, 168,
+    174, 181, 186, 193, 200, 207, 215, 222, 229, 237, 245, 252,
+    259, 266, 274, 282, 292, 299, 307, 314, 321, 330, 337, 344,
+    352, 358, 363, 369, 378, 384, 390, 397, 402, 409, 417, 423,
+    430, 440, 448, 455, 460, 468, 476, 482, 489, 496, 503, 509,
+    517, 522, 532, 539, 547, 554, 559, 566, 576, 582, 589, 596,
+    601, 608, 615, 621, 628, 635, 643, 650, 657, 665, 674, 680,
+    686, 694, 699, 706, 713, 719, 727, 733, 739, 747, 754, 763,
+    770, 778, 785, 792, 799, 807, 814, 820, 827, 835, 844, 852,
+    858, 865, 873, 881, 886, 894, 900, 907, 913, 922, 930, 938,
+    944, 950, 958, 963, 973, 981, 989, 997, 1002, 1008, 1016, 1022,
+    1029, 1037, 1043, 1053, 1061, 1067, 1072, 1080, 1088, 1094, 1101, 1106,
+    1114, 1118, 1124, 1131, 1139, 1148, 1153, 1160, 1168, 1174, 1182, 1187,
+    1195, 1204, 1212, 1218, 1225, 1232, 1239, 1245, 1252, 1257, 1264, 1269,
+    1277, 1284, 1292, 1299, 1305, 1312, 1318, 1324, 1329, 1334, 1342, 1350,
+    1356, 1361, 1368, 1374, 1378, 1387, 1393, 1402, 1410, 1416, 1421, 1427,
+    1433, 1443, 1448, 1454, 1463, 1470, 1475, 1480, 1486, 1492, 1500, 1506,
+    1512, 1520, 1529, 1535, 1543, 1549, 1555, 1562, 1568, 1574, 1581, 1587,
+    1597, 1606, 1613, 1621, 1631, 1637, 1644, 1651, 1657, 1664, 1671, 1677,
+    1683, 1688, 1695, 1701, 1706, 1712, 1719, 1726, 1732, 1736, 1743, 1748,
+    1753, 1760, 1765, 1772, 1778, 1783, 1790, 1796, 1802, 1809, 1816, 1821,
+    1830, 1836, 1843, 1850, 1855, 1863, 1872, 1878, 1884, 1890, 1897, 1903,
+    1910, 1917, 1923, 1929, 1935, 1942, 1948, 1954, 1961, 1967, 1973, 1979,
+    1985, 1990, 1998, 2006, 2013, 2020, 2026, 2034, 2040, 2046, 2053, 2060,
+    2068, 2076, 2083, 2090, 2096, 2102, 2112, 2119, 2124, 2131, 2139, 2148,
+    2153, 2161, 2165, 2173, 2180, 2186, 2194, 2200, 2206, 2212, 2218, 2223,
+    2230, 2238, 2245, 2251, 2260, 2267, 2274, 2282, 2289, 2295, 2302, 2312,
+    2318, 2323, 2329, 2339, 2346, 2353, 2361, 2366, 2375, 2384, 2391, 2397,
+    2406, 2412, 2420, 2426, 2432, 2437, 2443, 2450, 2456, 2463, 2471, 2477,
+    2484, 2490, 2495, 2503, 2509, 2515, 2521, 2531, 2538, 2547, 2555, 2562,
+    2569, 2575, 2581, 2588, 2593, 2600, 2608, 2617, 2623, 2630, 2638, 2647,
+    2655, 2661, 2668, 2674, 2681, 2687, 2694, 2700, 2708, 2715, 2724, 2730,
+    2736, 2741, 2748, 2754, 2762, 2767, 2773, 2778, 2784, 2793, 2799, 2807,
+    2813, 2818, 2825, 2832, 2837, 2843, 2849, 2855, 2863, 2869, 2879, 2885,
+    2895, 2903, 2910, 2915, 2924, 2929, 2935, 2941, 2948, 2956, 2961, 2966,
+    2973, 2981, 2988, 2995, 3002, 3008, 3016, 3024, 3030, 3037, 3046, 3053,
+    3059, 3066, 3072, 3080, 3088, 3095, 3100, 3106, 3116, 3124, 3131, 3140,
+    3147, 3154, 3160, 3167, 3173, 3182, 3191, 3197, 3204, 3213, 3219, 3226,
+    3233, 3240, 3247, 3253, 3263, 3272, 3278, 3283, 3290, 3297, 3304, 3309,
+    3316, 3324, 3331, 3338, 3345, 3352, 3358, 3365, 3373, 3379, 3385, 3392,
+    3400, 3405, 3412, 3418, 3426, 3435, 3441, 3449, 3455, 3461, 3467, 3472,
+    3478, 3482, 3488, 3496, 3502, 3510, 3519, 3525, 3530, 3538, 3546, 3552,
+    3561, 3569, 3576, 3583, 3589, 3596, 3604, 3612, 3620, 3629, 3635, 3643,
+    3651, 3659, 3668, 3676, 3684, 3690, 3696, 3703, 3711, 3720, 3726, 3733,
+    3740, 3747, 3754, 3760, 3765, 3775, 3781, 3788, 3795, 3802, 3810, 3818,
+    3824, 3833, 3841, 3846, 3853, 3859, 3864, 3870, 3878, 3882, 3888, 3895,
+    3902, 3908, 3912, 3918, 3927, 3933, 3939, 3944, 3950, 3958, 3964, 3970,
+    3976, 3982, 3989, 3994, 4002, 4008, 4014, 4018, 4026, 4031, 4041, 4050,
+    4057, 4064, 4071, 4078, 4082, 4090, 4099, 4106, 4115, 4122, 4129, 4137,
+    4144, 4151, 4158, 4165, 4172, 4182, 4189, 4198, 4205, 4213, 4219, 4227,
+    4235, 4243, 4251, 4257, 4264, 4272, 4281, 4288, 4295, 4302, 4309, 4316,
+    4326, 4333, 4340, 4347, 4355, 4363, 4370, 4376, 4383, 4390, 4398, 4407,
+    4414, 4422, 4429, 4438, 4445, 4452, 4460, 4467, 4474, 4482, 4488, 4493,
+    4500, 4507, 4513, 4520, 4528, 4534, 4541, 4549, 4556, 4563, 4570, 4577,
+    4584, 4591, 4598, 4605, 4612, 4620, 4628, 4636, 4645, 4653, 4661, 4671,
+    4680, 4688, 4696, 4703, 4709, 4714, 4720, 4726, 4732, 4739, 4744, 4752,
+    4759, 4768, 4777, 4783, 4789, 4794, 4801, 4807, 4813, 4817, 4825, 4831,
+    4837, 4841, 4847, 4853, 4862, 4869, 4878, 4885, 4892, 4897, 4903, 4913,
+    4919, 4925, 4932, 4937, 4943, 4950, 4957, 4963, 4968, 4973, 4980, 4987,
+    4994, 4998, 5004, 5011, 5018, 5024, 5030, 5037, 5044, 5049, 5055, 5061,
+    5067, 5075, 5081, 5086, 5093, 5101, 5107, 5115, 5121, 5127, 5133, 5141,
+    5148, 5153, 5158, 5166, 5175, 5182, 5188, 5195, 5203, 5209, 5215, 5222,
+    5228, 5234, 5240, 5247, 5254, 5259, 5265, 5275, 5281, 5290, 5296, 5302,
+    5311, 5318, 5325, 5331, 5337, 5342, 5347, 5357, 5363, 5369, 5375, 5382,
+    5388, 5394, 5401, 5407, 5416, 5423, 5428, 5438, 5445, 5451, 5455, 5464,
+    5470, 5476, 5484, 5492, 5499, 5505, 5513, 5522, 5528, 5533, 5541, 5547,
+    5554, 5558, 5564, 5571, 5577, 5582, 5588, 5595, 5601, 5606, 5612, 5618,
+    5624, 5634, 5640, 5646, 5653, 5659, 5666, 5673, 5679, 5684, 5690, 5697,
+    5704, 5711, 5717, 5723, 5730, 5736, 5744, 5751, 5758, 5766, 5772, 5778,
+    5787, 5794, 5801, 5807, 5815, 5822, 5828, 5834, 5839, 5846, 5853, 5860,
+    5864, 5873, 5881, 5887, 5893, 5900, 5906, 5913, 5919, 5927, 5935, 5942,
+    5948, 5955, 5964, 5972, 5977, 5983, 5992, 5999, 6005, 6013, 6018, 6025,
+    6031, 6037, 6043, 6048, 6056, 6062, 6069, 6074, 6080, 6087, 6094, 6100,
+    6106, 6112, 6117, 6124, 6133, 6141, 6146, 6153, 6163, 6169, 6175, 6181,
+    6188, 6196, 6204, 6211, 6217, 6224, 6234, 6241, 6248, 6255, 6261, 6269,
+    6277, 6285, 6293, 6302, 6309, 6316, 6324, 6332, 6339, 6347, 6354, 6361,
+    6369, 6378, 6388, 6397, 6404, 6413, 6422, 6426, 6431, 6440, 6445, 6452,
+    6461, 6469, 6477, 6484, 6493, 6499, 6505, 6514, 6519, 6527, 6534, 6542,
+    6549, 6555, 6560, 6567, 6574, 6579, 6587, 6592, 6600, 6607, 6613, 6620,
+    6626, 6633, 6643, 6649, 6655, 6663, 6670, 6675, 6681, 6687, 6693, 6699,
+    6704, 6713, 6721, 6731, 6738, 6744, 6750, 6759, 6769, 6774, 6781, 6790,
+    6796, 6804, 6810, 6816, 6826, 6831, 6839, 6845, 6852, 6858, 6863, 6868,
+    6878, 6884, 6891, 6896, 6905, 6914, 6921, 6928, 6934, 6941, 6948, 6957,
+    6966, 6972, 6978, 6983, 6991, 7000, 7006, 7012, 7020, 7027, 7034, 7039,
+    7046, 7051, 7060, 7068, 7075, 7081, 7087, 7095, 7103, 7108, 7117, 7127,
+    7132, 7138, 7145, 7151, 7157, 7163, 7169, 7176, 7182, 7189, 7196, 7203,
+    7210, 7217, 7224, 7229, 7238, 7243, 7250, 7259, 7265, 7273, 7278, 7284,
+    7289, 7295, 7301, 7307, 7312, 7317, 7323, 7328, 7335, 7340, 7344, 7351,
+    7357, 7364, 7370, 7377, 7385, 7391, 7397, 7402, 7409, 7416, 7423, 7429,
+    7434, 7441, 7447, 7453, 7459, 7465, 7473, 7479, 7489, 7496, 7501, 7507,
+    7513, 7522, 7527, 7537, 7541, 7547, 7553, 7560, 7567, 7574, 7583, 7592,
+    7599, 7605, 7610, 7620, 7627, 7633, 7641, 7647, 7654, 7663, 7669, 7677,
+    7683, 7691, 7697, 7706, 7714, 7720, 7727, 7735, 7743, 7749, 7757, 7763,
+    7770, 7778, 7787, 7796, 7800, 7808, 7813, 7819, 7828, 7834, 7841, 7847,
+    7852, 7860, 7865, 7869, 7877, 7885, 7894, 7899, 7904, 7911, 7920, 7927,
+    7933, 7939, 7944, 7952, 7958, 7964, 7970, 7975, 7983, 7992, 7997, 8004,
+    8009, 8015, 8021, 8027, 8034, 8042, 8048, 8056, 8063, 8069, 8075, 8082,
+    8089, 8096, 8103, 8109, 8115, 8121, 8128, 8134, 8142, 8149, 8155, 8163,
+    8168, 8174, 8180, 8187, 8193, 8200, 8208, 8214, 8220, 8225, 8232, 8238,
+    8244, 8253, 8259, 8264, 8274, 8280, 8286, 8295, 8301, 8309, 8318, 8324,
+    8330, 8338, 8344, 8351, 8357, 8363, 8370, 8378, 8387, 8393, 8398, 8406,
+    8412, 8421, 8427, 8435, 8441, 8448, 8455, 8460, 8467, 8473, 8480, 8486,
+    8491, 8498, 8504, 8512, 8519, 8528, 8534, 8542, 8548, 8557, 8563, 8569,
+    8575, 8580, 8588, 8595, 8602, 8608, 8613, 8618, 8627, 8635, 8640, 8646,
+    8652, 8657, 8662, 8671, 8678, 8684, 8690, 8697, 8704, 8709, 8716, 8725,
+    8733, 8739, 8743, 8749, 8758, 8766, 8771, 8776, 8781, 8788, 8796, 8803,
+    8810, 8818, 8824, 8829, 8836, 8842, 8849, 8856, 8863, 8871, 8876, 8883,
+    8889, 8893, 8897, 8904, 8911, 8917, 8922, 8927, 8932, 8939, 8947, 8952,
+    8957, 8963, 8972, 8980, 8987, 8994, 9000, 9009, 9017, 9027, 9034, 9039,
+    9048, 9053, 9059, 9065, 9074, 9082, 9090, 9098, 9105, 9112, 9116, 9125,
+    9131, 9140, 9147, 9154, 9158, 9164, 9172, 9177, 9183, 9191, 9199, 9209,
+    9216, 9222, 9228, 9234, 9241, 9250, 9255, 9262, 9271, 9279, 9285, 9292,
+    9301, 9307, 9314, 9321, 9325, 9331, 9340, 9348, 9358, 9365, 9371, 9379,
+    9387, 9393, 9401, 9407, 9413, 9418, 9428, 9435, 9445, 9451, 9457, 9463,
+    9472, 9477, 9483, 9488, 9494, 9501, 9507, 9513, 9518, 9525, 9534, 9541,
+    9548, 9554, 9560, 9566, 9572, 9578, 9584, 9594, 9600, 9608, 9616, 9621,
+    9628, 9633, 9640, 9650, 9657, 9662, 9669, 9679, 9684, 9691, 9698, 9705,
+    9712, 9719, 9725, 9733, 9739, 9747, 9752, 9758, 9767, 9777, 9786, 9797,
+    9801, 9810, 9816, 9825, 9829, 9836, 9843, 9849, 9856, 9862, 9869, 9878,
+    9883, 9890, 9896, 9903, 9909, 9914, 9921, 9927, 9935, 9940, 9946, 9954,
+    9960, 9966, 9971, 9977, 9983, 9989, 9996, 10002, 10008, 10014, 10021, 10027,
+    10032, 10038, 10044, 10050, 10059, 10065, 10071, 10081, 10087, 10093, 10100, 10107,
+    10112, 10118, 10124, 10134, 10141, 10148, 10155, 10163, 10169, 10178, 10184, 10189,
+    10195, 10202, 10211, 10218, 10225, 10231, 10238, 10244, 10255, 10265, 10272, 10277,
+    10284, 10292, 10301, 10308, 10317, 10326, 10332, 10340, 10347, 10354, 10364, 10371,
+    10381, 10389, 10395, 10402, 10409, 10416, 10422, 10428, 10437, 10443, 10449, 10454,
+    10460, 10468, 10475, 10480, 10487, 10494, 10501, 10507, 10514, 10521, 10527, 10534,
+    10544, 10551, 10558, 10567, 10573, 10578, 10587, 10595, 10602, 10607, 10613, 10620,
+    10626, 10632, 10641, 10647, 10653, 10659, 10664, 10669, 10674, 10682, 10693, 10702,
+    10711, 10718, 10725, 10732, 10740, 10748, 10755, 10761, 10769, 10773, 10781, 10789,
+    10797, 10805, 10814, 10822, 10829, 10835, 10841, 10849, 10857, 10863, 10870, 10875,
+    10882, 10889, 10897, 10905, 10911, 10917, 10925, 10930, 10937, 10944, 10950, 10958,
+    10966, 10973, 10980, 10984, 10992, 10999, 11007, 11013, 11021, 11028, 11036, 11044,
+    11051, 11059, 11067, 11071, 11077, 11082, 11088, 11095, 11102, 11107, 11116, 11122,
+    11131, 11141, 11147, 11155, 11160, 11166, 11171, 11176, 11182, 11187, 11194, 11200,
+    11206, 11214, 11219, 11226, 11231, 11238, 11245, 11249, 11255, 11261, 11266, 11273,
+    11278, 11284, 11291, 11297, 11304, 11310, 11315, 11321, 11327, 11333, 11339, 11346,
+    11351, 11357, 11363, 11371, 11376, 11383, 11392, 11398, 11404, 11410, 11416, 11422,
+    11430, 11435, 11441, 11448, 11454, 11463, 11471, 11477, 11483, 11489, 11496, 11502,
+    11512, 11521, 11528, 11535, 11543, 11548, 11554, 11559, 11565, 11573, 11582, 11589,
+    11597, 11603, 11613, 11623, 11628, 11636, 11642, 11646, 11653, 11658, 11664, 11670,
+    11677, 11685, 11691, 11698, 11706, 11714, 11722, 11728, 11737, 11741, 11747, 11756,
+    11763, 11771, 11780, 11785, 11793, 11800, 11805, 11811, 11817, 11824, 11830, 11836,
+    11842, 11851, 11858, 11867, 11873, 11883, 11889, 11896, 11904, 11910, 11917, 11923,
+    11929, 11935, 11939, 11946, 11954, 11962, 11971, 11978, 11989, 11996, 12003, 12010,
+    12017, 12025, 12030, 12037, 12045, 12051, 12060, 12067, 12076, 12085, 12091, 12097,
+    12104, 12110, 12117, 12123, 12131, 12138, 12145, 12152, 12161, 12167, 12175, 12182,
+    12190, 12198, 12202, 12208, 12217, 12224, 12230, 12236, 12243, 12251, 12257, 12264,
+    12269, 12275, 12280, 12286, 12292, 12300, 12306, 12314, 12323, 12330, 12336, 12343,
+    12348, 12355, 12361, 12369, 12378, 12384, 12390, 12397, 12405, 12411, 12417, 12423,
+    12431, 12437, 12442, 12450, 12457, 12463, 12469, 12479, 12486, 12492, 12499, 12504,
+    12515, 12520, 12526, 12533, 12539, 12546, 12552, 12558, 12564, 12573, 12581, 12587,
+    12597, 12605, 12612, 12618, 12625, 12633, 12640, 12646, 12650, 12656, 12666, 12673,
+    12680, 12687, 12693, 12699, 12706, 12712, 12719, 12728, 12733, 12739, 12745, 12754,
+    12759, 12764, 12772, 12780, 12789, 12798, 12803, 12810, 12818, 12824, 12831, 12836,
+    12841, 12847, 12853, 12858, 12864, 12870, 12875, 12881, 12889, 12896, 12905, 12912,
+    12917, 12925, 12931, 12937, 12945, 12949, 12955, 12961, 12970, 12978, 12986, 12992,
+    13002, 13008, 13014, 13020, 13027, 13033, 13040, 13047, 13056, 13063, 13071, 13076,
+    13083, 13088, 13094, 13100, 13106, 13113, 13121, 13128, 13135, 13142, 13148, 13154,
+    13160, 13166, 13173, 13179, 13189, 13194, 13201, 13207, 13213, 13221, 13230, 13238,
+    13246, 13252, 13258, 13265, 13274, 13281, 13288, 13293, 13302, 13306, 13312, 13318,
+    13325, 13330, 13338, 13343, 13348, 13356, 13363, 13372, 13376, 13381, 13389, 13396,
+    13402, 13407, 13413, 13421, 13426, 13435, 13441, 13447, 13457, 13465, 13470, 13477,
+    13485, 13490, 13497, 13504, 13515, 13522, 13528, 13533, 13540, 13546, 13551, 13558,
+    13564, 13571, 13578, 13584, 13590, 13596, 13600, 13607, 13613, 13619, 13626, 13632,
+    13638, 13645, 13651, 13657, 13664, 13670, 13680, 13685, 13693, 13700, 13706, 13714,
+    13720, 13724, 13730, 13738, 13743, 13752, 13761, 13767, 13773, 13780, 13786, 13796,
+    13802, 13811, 13817, 13823, 13830, 13836, 13841, 13850, 13858, 13865, 13871, 13877,
+    13882, 13886, 13892, 13899, 13905, 13910, 13916, 13921, 13927, 13932, 13937, 13942,
+    13948, 13955, 13961, 13968, 13974, 13979, 13985, 13990,
+   };
+
+static const uint16_t es_d[] = {
+    5, 1, 0, 251, 1, 2, 10, 15, 12, 8, 146, 2,
+    3, 34, 103, 37, 107, 130, 0, 14, 4, 0, 9, 157,
+    0, 3, 305, 4, 3, 4, 53, 4, 0, 7, 288, 19,
+    8, 126, 19, 28, 253, 77, 0, 14, 6, 313, 261, 13,
+    2, 35, 9, 0, 0, 133, 10, 229, 260, 10, 2, 92,
+    52, 290, 10, 11, 0, 280, 2, 0, 26, 34, 42, 40,
+    0, 8, 2, 0, 84, 23, 33, 83, 27, 30, 255, 28,
+    81, 72, 26, 41, 43, 7, 132, 2, 67, 15, 99, 3,
+    60, 6, 2, 1, 0, 8, 11, 10, 368, 59, 104, 9,
+    143, 134, 25, 1, 31, 7, 35, 21, 34, 4, 6, 0,
+    0, 0, 9, 9, 36, 2, 34, 2, 2, 16, 46, 94,
+    133, 21, 252, 176, 19, 71, 100, 14, 38, 6, 6, 1,
+    164, 175, 5, 8, 53, 5, 554, 0, 63, 9, 25, 110,
+    43, 54, 195, 142, 54, 31, 16, 3, 3, 13, 2, 3,
+    0, 9, 0, 72, 10, 2, 15, 107, 0, 0, 2, 3,
+    154, 1, 36, 504, 20, 28, 116, 2, 452, 480, 349, 63,
+    503, 38, 240, 66, 146, 2, 5, 24, 257, 0, 40, 16,
+    10, 7, 50, 23, 2, 306, 25, 21, 0, 0, 446, 46,
+    60, 16, 17, 239, 17, 0, 99, 2, 2, 6, 27, 27,
+    150, 104, 36, 73, 306, 192, 0, 1, 142, 7, 2, 17,
+    2, 129, 910, 153, 2, 24, 2, 50, 174, 2, 101, 456,
+    53, 97, 120, 244, 180, 43, 0, 22, 16, 24, 88, 69,
+    6, 30, 93, 57, 1, 22, 19, 7, 50, 0, 46, 237,
+    204, 15, 3, 398, 488, 154, 59, 216, 29, 23, 65, 451,
+    0, 33, 0, 3, 441, 14, 8, 11, 158, 3, 339, 1,
+    546, 22, 104, 4, 134, 131, 45, 0, 140, 126, 82, 96,
+    132, 30, 140, 14, 993, 30, 0, 290, 212, 97, 0, 59,
+    272, 732, 0, 41, 420, 122, 28, 2, 15, 6, 27, 0,
+    229, 38, 94, 48, 91, 16, 17, 564, 108, 10, 0, 251,
+    69, 253, 241, 0, 1229, 5, 837, 472, 3, 167, 12, 1211,
+    1, 48, 1, 145, 105, 162, 24, 6, 234, 8, 405, 14,
+    462, 367, 105, 65, 129, 1, 0, 323, 204, 17, 185, 6,
+    144, 22, 407, 1, 10, 51, 121, 138, 152, 420, 487, 5,
+    1176, 5, 21, 24, 2099, 230, 1, 85, 1, 310, 1659, 190,
+    298, 84, 2, 1315, 96, 0, 731, 105, 214, 223, 647, 80,
+    21, 1, 349, 252, 143, 780, 113, 51, 3, 0, 286, 23,
+    19, 37, 22, 311, 147, 195, 216, 1884, 15, 742, 0, 76,
+    75, 104, 981, 860, 81, 226, 486, 331, 174, 5183, 48, 194,
+    78, 56, 374, 0, 328, 294, 1, 248, 2121, 6, 1477, 42,
+    0, 2, 10729, 348, 1089, 8, 8, 1011, 2, 6, 148, 118,
+    1, 123, 24, 169, 105, 1246, 29, 144, 553, 0, 537, 2896,
+    47, 2072, 0, 9, 251, 270, 65, 18, 818, 18, 36, 1,
+    4382, 263, 221, 0, 1851, 564, 84, 2,
+   };
+static const uint16_t es_h[] = {
+    1751, 669, 432, 1365, 1498, 999, 803, 977, 76, 707, 1732, 1906,
+    111, 1759, 1484, 1163, 1614, 1299, 355, 1989, 1012, 522, 1646, 1298,
+    698, 1786, 1665, 1360, 72, 673, 1216, 1307, 612, 979, 465, 879,
+    773, 1320, 1931, 2017, 749, 383, 1889, 608, 1478, 81, 441, 1513,
+    122, 537, 610, 581, 1624, 998, 808, 374, 1701, 1403, 175, 809,
+    211, 972, 993, 1715, 1919, 326, 1535, 1033, 642, 1186, 26, 573,
+    1589, 2041, 860, 823, 1604, 1594, 462, 1796, 1384, 1690, 1840, 384,
+    31, 667, 1748, 1638, 336, 552, 1184, 1188, 1639, 1567, 501, 1955,
+    558, 940, 66, 2011, 1241, 1805, 500, 1225, 1754, 150, 1208, 1976,
+    1829, 1645, 1972, 1744, 1421, 1206, 491, 637, 203, 889, 104, 570,
+    1288, 1969, 660, 820, 935, 627, 1678, 1383, 1419, 525, 1372, 1390,
+    789, 1106, 602, 1000, 1054, 1936, 693, 1322, 184, 1996, 1170, 1808,
+    135, 280, 476, 1539, 967, 1262, 207, 106, 876, 1014, 1888, 758,
+    1232, 1951, 1022, 711, 962, 792, 1297, 1290, 883, 1233, 850, 1268,
+    1368, 641, 3, 1605, 1139, 230, 218, 241, 1561, 1160, 131, 1917,
+    1295, 2020, 1077, 162, 1351, 405, 117, 345, 520, 1676, 1116, 2009,
+    1965, 1773, 1998, 499, 694, 1675, 471, 719, 1727, 1619, 933, 410,
+    1930, 592, 746, 761, 16, 1008, 1730, 1062, 73, 555, 1673, 377,
+    303, 654, 1913, 409, 1815, 1716, 1196, 1612, 811, 292, 2039, 1414,
+    1580, 1995, 874, 1181, 2006, 68, 1927, 193, 1734, 545, 490, 1663,
+    1596, 1983, 779, 1438, 493, 309, 1733, 938, 914, 185, 199, 1371,
+    943, 1250, 1376, 1828, 318, 1920, 454, 870, 514, 293, 361, 141,
+    283, 455, 492, 1802, 168, 349, 1801, 620, 1787, 827, 1296, 1630,
+    1746, 96, 249, 1406, 1099, 1079, 1617, 1523, 181, 1040, 1140, 875,
+    365, 1967, 880, 1121, 1502, 228, 1441, 174, 1102, 1420, 720, 319,
+    294, 119, 996, 862, 41, 1035, 333, 445, 1704, 420, 799, 291,
+    1207, 195, 672, 740, 245, 1943, 1279, 1915, 968, 23, 1873, 1851,
+    436, 451, 1558, 1722, 819, 1985, 1197, 1981, 954, 69, 725, 352,
+    671, 1120, 1890, 442, 1862, 11, 1962, 337, 1588, 541, 1052, 180,
+    1818, 1655, 107, 644, 1803, 1294, 227, 459, 1934, 1261, 738, 388,
+    422, 1632, 2035, 1314, 1872, 1149, 392, 1882, 1799, 1213, 912, 1270,
+    1585, 1010, 1190, 1205, 404, 306, 32, 1467, 585, 947, 798, 1282,
+    787, 2004, 1660, 1078, 367, 360, 1706, 70, 1507, 1823, 444, 1204,
+    734, 1355, 1003, 1157, 804, 1717, 457, 1202, 596, 909, 2029, 1696,
+    224, 540, 1291, 1652, 1857, 961, 1075, 1400, 1249, 0, 1938, 580,
+    1935, 743, 84, 1122, 1265, 2001, 680, 87, 1029, 1359, 805, 1592,
+    920, 331, 1454, 1430, 1375, 881, 1103, 1050, 450, 1305, 108, 871,
+    313, 658, 569, 5, 1921, 690, 885, 1287, 1443, 589, 518, 314,
+    579, 1485, 678, 1581, 593, 1053, 905, 1700, 649, 1694, 446, 1260,
+    275, 1785, 43, 605, 1335, 1042, 1782, 607, 997, 565, 210, 1044,
+    1369, 1932, 1496, 688, 697, 1447, 1531, 783, 1557, 1374, 1543, 1986,
+    237, 1494, 763, 898, 123, 1431, 1144, 922, 806, 1256, 865, 469,
+    1395, 2028, 1472, 648, 587, 1114, 2025, 347, 1252, 1929, 1306, 284,
+    1993, 80, 1576, 1425, 1210, 1738, 853, 1703, 63, 36, 974, 1255,
+    896, 1504, 1797, 64, 1499, 1131, 1229, 402, 1028, 134, 2036, 1092,
+    2010, 1195, 686, 1340, 1740, 2022, 557, 713, 248, 1839, 675, 1037,
+    776, 829, 320, 992, 406, 1495, 687, 1177, 288, 1407, 1949, 856,
+    978, 1349, 424, 1221, 120, 1449, 1238, 1136, 902, 1600, 351, 1553,
+    1361, 1666, 1108, 841, 437, 893, 757, 864, 1150, 478, 1235, 89,
+    946, 261, 1445, 334, 517, 1875, 2002, 262, 571, 1391, 1209, 1461,
+    1428, 1336, 718, 1792, 1432, 1319, 951, 1318, 613, 483, 1304, 1224,
+    1097, 1475, 287, 1328, 1301, 840, 118, 949, 1316, 21, 1760, 1658,
+    1462, 1200, 391, 1957, 1765, 359, 1804, 583, 551, 53, 489, 403,
+    246, 259, 624, 90, 1579, 1266, 1363, 1516, 497, 317, 1089, 1315,
+    75, 495, 1396, 826, 1404, 846, 1412, 636, 253, 2046, 987, 1978,
+    412, 302, 200, 28, 1023, 1303, 1611, 145, 1583, 390, 1129, 532,
+    1283, 1591, 863, 1292, 325, 366, 884, 1479, 1603, 1987, 726, 1455,
+    1984, 165, 1662, 1187, 1642, 1525, 568, 311, 1480, 1623, 1158, 633,
+    1317, 991, 1764, 1893, 1049, 663, 1147, 1980, 1426, 354, 1183, 910,
+    61, 1509, 1398, 1607, 966, 327, 1357, 239, 510, 1027, 837, 1059,
+    2042, 741, 300, 1501, 13, 14, 479, 754, 1135, 730, 1910, 316,
+    1174, 1329, 1689, 8, 1521, 1602, 1956, 128, 159, 651, 727, 751,
+    1510, 1767, 515, 1914, 1958, 1812, 1219, 1285, 2044, 900, 1082, 526,
+    643, 507, 1070, 448, 1146, 1904, 1452, 1963, 1512, 1794, 399, 742,
+    1653, 277, 756, 83, 1456, 272, 539, 1055, 1474, 1378, 1661, 1550,
+    1132, 1276, 1113, 1119, 380, 1126, 562, 1005, 144, 206, 1104, 1148,
+    1451, 132, 1334, 1065, 800, 1997, 1470, 328, 1817, 1111, 934, 771,
+    780, 1168, 1458, 2012, 257, 375, 1769, 825, 186, 1714, 652, 103,
+    1483, 157, 1830, 833, 449, 782, 1473, 1871, 1281, 1251, 1056, 1429,
+    989, 240, 484, 1167, 582, 171, 774, 1916, 674, 917, 173, 1222,
+    1570, 149, 1627, 386, 1791, 1086, 1827, 1333, 839, 1051, 1041, 716,
+    1231, 452, 330, 932, 664, 1465, 2023, 689, 1137, 1777, 434, 1648,
+    467, 401, 236, 2037, 778, 226, 136, 1199, 770, 894, 597, 747,
+    1356, 1326, 732, 656, 244, 235, 2031, 1446, 176, 463, 683, 1,
+    1869, 1166, 650, 1992, 1090, 1302, 1685, 888, 973, 18, 344, 308,
+    1522, 1193, 362, 260, 1327, 426, 1982, 1358, 1968, 112, 731, 212,
+    1018, 945, 1527, 1338, 897, 415, 982, 213, 1959, 1729, 2038, 784,
+    655, 911, 1657, 179, 67, 1081, 733, 927, 750, 530, 1080, 1031,
+    916, 682, 791, 769, 20, 1775, 1311, 714, 312, 1874, 2013, 363,
+    1816, 1681, 421, 1833, 1069, 1578, 267, 1416, 1615, 10, 852, 1912,
+    1755, 1002, 1264, 929, 279, 834, 1728, 790, 567, 1339, 1683, 527,
+    1863, 2034, 1950, 1838, 737, 1784, 1548, 925, 468, 1758, 1886, 1925,
+    971, 1493, 440, 1793, 1313, 1876, 1497, 1807, 1001, 549, 665, 1656,
+    370, 676, 1686, 1835, 1155, 1724, 928, 1571, 1488, 428, 835, 129,
+    2033, 1367, 2030, 504, 735, 1142, 378, 1125, 243, 1223, 703, 1423,
+    729, 1593, 1902, 1635, 439, 2032, 1239, 25, 1736, 408, 1850, 1745,
+    217, 1650, 821, 229, 1060, 960, 1809, 931, 1526, 1560, 919, 482,
+    1274, 508, 1405, 1753, 1453, 668, 343, 296, 691, 238, 1308, 209,
+    1928, 785, 258, 1880, 205, 1427, 764, 1953, 431, 1015, 547, 1842,
+    939, 1971, 147, 1194, 1068, 4, 1979, 1903, 957, 2016, 1020, 1254,
+    1743, 1853, 358, 677, 1895, 1944, 407, 921, 952, 1587, 1664, 1248,
+    155, 1860, 1226, 560, 959, 629, 812, 953, 1885, 197, 1723, 1598,
+    1547, 1542, 1343, 866, 6, 1609, 609, 88, 604, 535, 398, 2021,
+    1855, 348, 1364, 472, 564, 298, 524, 600, 350, 542, 1435, 1788,
+    2047, 127, 263, 458, 1013, 786, 295, 289, 1034, 1643, 1024, 1091,
+    1552, 1848, 657, 1076, 630, 1988, 1682, 753, 1564, 1749, 765, 220,
+    1737, 1831, 1819, 937, 969, 601, 1750, 890, 480, 1410, 1651, 371,
+    92, 1267, 1505, 22, 1670, 231, 1087, 124, 1865, 1259, 1621, 126,
+    1933, 1107, 505, 700, 976, 98, 1134, 94, 1424, 251, 891, 631,
+    1616, 1991, 775, 1708, 1771, 614, 563, 1693, 56, 1439, 138, 443,
+    95, 745, 1118, 1824, 695, 1832, 801, 1922, 1321, 1973, 1569, 1293,
+    1946, 1172, 414, 2015, 423, 115, 908, 1798, 33, 182, 1668, 49,
+    1520, 1518, 1286, 1705, 1386, 1325, 323, 1247, 1517, 1544, 1348, 1332,
+    385, 923, 1806, 208, 990, 950, 1061, 1563, 988, 7, 160, 807,
+    1752, 1331, 435, 417, 1489, 1045, 1370, 1180, 1644, 1230, 1064, 1945,
+    125, 554, 1718, 1217, 1774, 1258, 395, 1841, 595, 2005, 255, 142,
+    1058, 1130, 273, 1768, 963, 546, 1471, 1634, 1783, 1381, 105, 617,
+    1508, 1246, 1977, 1854, 389, 1781, 278, 1201, 1067, 44, 708, 1939,
+    1618, 1211, 190, 340, 1433, 357, 1459, 1908, 1608, 474, 857, 233,
+    1038, 2, 1468, 153, 603, 54, 429, 1088, 1153, 1124, 817, 1747,
+    1242, 906, 599, 924, 146, 373, 855, 1562, 556, 606, 506, 1649,
+    427, 1847, 1565, 1422, 958, 475, 561, 1278, 74, 1182, 1537, 1341,
+    1093, 1324, 1127, 685, 1846, 1964, 1695, 1401, 1776, 1362, 1198, 822,
+    477, 1112, 1918, 849, 692, 1273, 645, 1169, 625, 813, 1887, 709,
+    1418, 796, 1637, 1344, 1399, 814, 121, 1098, 728, 1123, 214, 99,
+    538, 1413, 975, 194, 487, 1214, 1859, 886, 29, 1289, 38, 281,
+    748, 2007, 271, 416, 379, 1074, 1043, 1545, 1524, 1519, 1942, 1006,
+    623, 511, 965, 1482, 666, 1515, 1867, 42, 1680, 681, 956, 332,
+    1631, 59, 704, 1674, 854, 1220, 456, 9, 447, 1687, 1811, 1477,
+    494, 1115, 310, 356, 299, 1490, 1613, 948, 1577, 1721, 1100, 1698,
+    873, 78, 1095, 816, 307, 191, 1046, 1236, 418, 290, 1575, 1191,
+    101, 1897, 2000, 154, 1240, 1778, 1016, 1884, 1699, 1990, 486, 1597,
+    1901, 1185, 1707, 1856, 1713, 338, 1864, 616, 1215, 1009, 130, 35,
+    100, 304, 57, 34, 844, 152, 1487, 1417, 1275, 93, 438, 941,
+    1633, 1954, 818, 1476, 699, 1725, 285, 755, 964, 221, 1825, 1133,
+    286, 1036, 1173, 1837, 1128, 55, 1277, 1821, 1394, 1877, 1669, 662,
+    503, 324, 1109, 1310, 1766, 2019, 1868, 256, 1227, 788, 40, 1536,
+    1883, 460, 1941, 980, 611, 143, 167, 1300, 1568, 994, 1858, 1271,
+    759, 1559, 1845, 1464, 1742, 1192, 926, 930, 466, 1007, 1763, 1164,
+    400, 50, 158, 1709, 1549, 276, 187, 30, 1337, 1814, 2026, 342,
+    335, 470, 250, 1450, 1640, 936, 1606, 109, 1388, 485, 1448, 1756,
+    1726, 1084, 955, 202, 722, 578, 1528, 795, 1228, 372, 794, 329,
+    859, 1019, 15, 696, 269, 915, 1409, 52, 24, 45, 282, 1444,
+    615, 679, 498, 904, 225, 1176, 1469, 516, 1105, 2027, 1165, 1923,
+    828, 872, 1861, 1905, 832, 684, 1739, 640, 544, 397, 887, 1599,
+    712, 1096, 140, 543, 2003, 1551, 488, 1117, 1779, 918, 706, 189,
+    1975, 553, 1999, 1566, 1330, 364, 1066, 1393, 382, 1691, 1586, 768,
+    1346, 1697, 1154, 621, 869, 1354, 584, 1672, 661, 71, 1392, 192,
+    574, 1253, 369, 858, 1397, 1719, 1974, 575, 1481, 536, 2045, 1601,
+    1940, 1245, 590, 1790, 1143, 86, 1810, 2008, 970, 1263, 1813, 1466,
+    1720, 598, 1021, 113, 548, 1741, 48, 1554, 877, 1966, 1834, 19,
+    1203, 247, 139, 297, 1534, 1387, 1948, 1590, 1909, 1894, 91, 1573,
+    1610, 1178, 265, 346, 724, 653, 1342, 301, 632, 701, 1659, 1800,
+    723, 1145, 1822, 797, 586, 1924, 1280, 164, 58, 1141, 419, 1761,
+    1541, 1434, 1350, 895, 1503, 767, 1866, 1836, 1057, 1218, 983, 1257,
+    710, 1994, 1900, 1852, 1039, 1511, 2018, 393, 65, 1625, 1380, 1048,
+    274, 1244, 1820, 1961, 1952, 861, 222, 1896, 196, 842, 413, 2024,
+    1891, 232, 1711, 201, 1366, 851, 411, 1156, 1110, 781, 529, 1161,
+    2014, 172, 1171, 1688, 242, 512, 670, 824, 736, 387, 1667, 216,
+    1772, 1030, 1345, 264, 528, 1710, 156, 513, 1072, 1352, 1457, 831,
+    17, 1702, 534, 1234, 1094, 461, 628, 848, 1382, 321, 215, 626,
+    1032, 739, 986, 1538, 594, 984, 12, 647, 892, 47, 252, 868,
+    619, 1879, 1636, 1844, 425, 219, 550, 77, 717, 223, 1385, 1677,
+    1584, 882, 151, 1654, 1436, 1085, 60, 1532, 1770, 1960, 1411, 1762,
+    1628, 519, 772, 1463, 1620, 1272, 430, 815, 1572, 1574, 836, 473,
+    85, 1237, 1442, 521, 1492, 907, 1907, 523, 254, 1373, 944, 353,
+    1353, 1377, 1679, 559, 1556, 901, 1881, 1795, 1500, 576, 79, 169,
+    1898, 116, 702, 2040, 1684, 618, 1582, 1212, 1826, 27, 1408, 588,
+    1083, 1179, 899, 1389, 1629, 1175, 1151, 638, 705, 867, 270, 847,
+    137, 1025, 234, 715, 810, 1415, 1323, 1047, 1159, 163, 639, 46,
+    843, 802, 1073, 114, 62, 1671, 1735, 188, 1540, 1101, 566, 368,
+    37, 1011, 1530, 1152, 1626, 1529, 1506, 51, 1189, 830, 1347, 268,
+    1460, 381, 433, 133, 178, 97, 1870, 1937, 1437, 1892, 464, 1138,
+    496, 1622, 509, 198, 981, 1402, 1731, 1899, 913, 1712, 376, 1440,
+    1004, 266, 845, 777, 635, 646, 1071, 502, 659, 1269, 1789, 315,
+    1911, 1878, 838, 1595, 1243, 622, 204, 1692, 396, 572, 1162, 102,
+    1546, 1641, 82, 481, 1849, 1647, 339, 183, 577, 1555, 1309, 1970,
+    110, 177, 721, 1780, 634, 2043, 591, 1379, 148, 762, 1017, 1926,
+    760, 752, 903, 1491, 1514, 453, 878, 1486, 793, 161, 1312, 1284,
+    1533, 531, 1947, 305, 322, 985, 341, 533, 1843, 1026, 394, 1757,
+    766, 1063, 170, 995, 942, 166, 744, 39,
    };
-#undef es
 
 static const struct words es_words = {
     2048,
@@ -2404,5 +2450,9 @@ static const struct words es_words = {
     false,
     (const char *)es_,
     0, /* Constant string */
-    es_i
+    NULL, /* Words are located by offset */
+    es_o,
+    0u,
+    es_d,
+    es_h
 };
@@ -1,11 +1,16 @@
+#define WALLY_STATS_ALLOC_STAT WALLY_STAT_ELEMENTS_ALLOC_BYTES
 #include "internal.h"
 #include <include/wally_elements.h>
+#include <include/wally_bip32.h>
 #include <include/wally_crypto.h>
+#include <include/wally_transaction.h>
 #include "secp256k1/include/secp256k1_generator.h"
 #include "secp256k1/include/secp256k1_rangeproof.h"
 #include "src/secp256k1/include/secp256k1_surjectionproof.h"
 #include "secp256k1/include/secp256k1_ecdh.h"
+#include "secp256k1/include/secp256k1_whitelist.h"
 #include "ccan/ccan/crypto/sha256/sha256.h"
+#include "hmac.h"
 #include <stdbool.h>
 
 static int get_generator(const secp256k1_context *ctx,
@@ -26,6 +31,12 @@ static int get_commitment(const secp256k1_context *ctx,
     return WALLY_OK;
 }
 
+/* A parsed generator, with its serialization for retrieval */
+struct wally_asset_generator {
+    secp256k1_generator gen;
+    unsigned char generator[ASSET_GENERATOR_LEN];
+};
+
 int wally_asset_generator_from_bytes(const unsigned char *asset, size_t asset_len,
                                      const unsigned char *abf, size_t abf_len,
                                      unsigned char *bytes_out, size_t len)
@@ -48,6 +59,86 @@ int wally_asset_generator_from_bytes(const unsigned char *asset, size_t asset_le
     return WALLY_OK;
 }
 
+int wally_asset_generator_init_alloc(const unsigned char *generator, size_t generator_len,
+                                     struct wally_asset_generator **output)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    struct wally_asset_generator *gen;
+
+    if (output)
+        *output = NULL;
+
+    if (!generator || generator_len != ASSET_GENERATOR_LEN || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!(gen = wally_malloc(sizeof(*gen))))
+        return WALLY_ENOMEM;
+
+    if (get_generator(ctx, generator, generator_len, &gen->gen) != WALLY_OK) {
+        wally_asset_generator_free(gen);
+        return WALLY_EINVAL;
+    }
+    memcpy(gen->generator, generator, sizeof(gen->generator));
+    *output = gen;
+    return WALLY_OK;
+}
+
+int wally_asset_generator_from_tag_alloc(const unsigned char *asset, size_t asset_len,
+                                         const unsigned char *abf, size_t abf_len,
+                                         struct wally_asset_generator **output)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    struct wally_asset_generator *gen;
+    bool ok;
+
+    if (output)
+        *output = NULL;
+
+    if (!asset || asset_len != ASSET_TAG_LEN ||
+        (abf && abf_len != ASSET_TAG_LEN) || (!abf && abf_len) || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!(gen = wally_malloc(sizeof(*gen))))
+        return WALLY_ENOMEM;
+
+    if (abf)
+        ok = secp256k1_generator_generate_blinded(ctx, &gen->gen, asset, abf);
+    else
+        ok = secp256k1_generator_generate(ctx, &gen->gen, asset);
+
+    if (!ok) {
+        wally_asset_generator_free(gen);
+        return WALLY_ERROR; /* Invalid entropy; caller should try again */
+    }
+    secp256k1_generator_serialize(ctx, gen->generator, &gen->gen); /* Never fails */
+    *output = gen;
+    return WALLY_OK;
+}
+
+int wally_asset_generator_to_bytes(const struct wally_asset_generator *generator,
+                                   unsigned char *bytes_out, size_t len)
+{
+    if (!generator || !bytes_out || len != ASSET_GENERATOR_LEN)
+        return WALLY_EINVAL;
+    memcpy(bytes_out, generator->generator, len);
+    return WALLY_OK;
+}
+
+int wally_asset_generator_free(struct wally_asset_generator *generator)
+{
+    if (!generator)
+        return WALLY_EINVAL;
+    wally_clear(generator, sizeof(*generator));
+    wally_free(generator);
+    return WALLY_OK;
+}
+
 int wally_asset_final_vbf(const uint64_t *values, size_t values_len, size_t num_inputs,
                           const unsigned char *abf, size_t abf_len,
                           const unsigned char *vbf, size_t vbf_len,
@@ -67,13 +158,9 @@ int wally_asset_final_vbf(const uint64_t *values, size_t values_len, size_t num_
         !bytes_out || len != ASSET_TAG_LEN)
         return WALLY_EINVAL;
 
-    abf_p = wally_malloc(values_len * sizeof(unsigned char *));
-    vbf_p = wally_malloc(values_len * sizeof(unsigned char *));
-
-    if (!abf_p || !vbf_p) {
-        ret = WALLY_ENOMEM;
-        goto cleanup;
-    }
+    if (!(abf_p = wally_scratch_alloc(2 * values_len * sizeof(unsigned char *))))
+        return WALLY_ENOMEM;
+    vbf_p = abf_p + values_len;
 
     for (i = 0; i < values_len; i++) {
         abf_p[i] = abf + i * ASSET_TAG_LEN;
@@ -87,12 +174,111 @@ int wally_asset_final_vbf(const uint64_t *values, size_t values_len, size_t num_
                                                      values_len, num_inputs))
         ret = WALLY_OK;
 
-cleanup:
-    wally_free(abf_p);
-    wally_free(vbf_p);
+    wally_scratch_free(abf_p, 2 * values_len * sizeof(unsigned char *));
+    return ret;
+}
+
+/* Add value * abf + vbf to a balance for an input, or subtract it for an
+ * output. With no vbf, compute the vbf that balances a final output instead */
+static int blind_sum_update(const unsigned char *sum, uint64_t value,
+                            const unsigned char *abf, const unsigned char *vbf,
+                            bool is_input, unsigned char *bytes_out)
+{
+    static const unsigned char zero[ASSET_TAG_LEN] = { 0 };
+    const secp256k1_context *ctx = secp_ctx();
+    /* The balance so far is an input with no value, and the output
+     * receiving the new balance has no value and a zero blinder */
+    const uint64_t values[3] = { 0, value, 0 };
+    const unsigned char *abf_p[3] = { zero, abf, zero };
+    unsigned char *vbf_p[3] = { (unsigned char *)sum, (unsigned char *)vbf, bytes_out };
+    const size_t num_values = vbf ? 3 : 2;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!vbf)
+        vbf_p[1] = bytes_out; /* Finalizing: the new term is the final output */
+    wally_clear(bytes_out, ASSET_TAG_LEN);
+    if (!secp256k1_pedersen_blind_generator_blind_sum(ctx, values, abf_p, vbf_p, num_values,
+                                                      is_input ? 2 : 1)) {
+        wally_clear(bytes_out, ASSET_TAG_LEN);
+        return WALLY_EINVAL; /* A blinding factor is out of range */
+    }
+    return WALLY_OK;
+}
+
+int wally_asset_blind_sum_init(struct wally_asset_blind_sum *sum)
+{
+    if (!sum)
+        return WALLY_EINVAL;
+    wally_clear(sum, sizeof(*sum));
+    return WALLY_OK;
+}
+
+static int blind_sum_add(struct wally_asset_blind_sum *sum, uint64_t value,
+                         const unsigned char *abf, size_t abf_len,
+                         const unsigned char *vbf, size_t vbf_len,
+                         bool is_input)
+{
+    unsigned char buff[ASSET_TAG_LEN];
+    int ret;
+
+    if (!sum || !abf || abf_len != ASSET_TAG_LEN || !vbf || vbf_len != ASSET_TAG_LEN)
+        return WALLY_EINVAL;
+
+    /* Update via a copy to leave the balance unchanged on failure */
+    ret = blind_sum_update(sum->sum, value, abf, vbf, is_input, buff);
+    if (ret == WALLY_OK)
+        memcpy(sum->sum, buff, sizeof(buff));
+    wally_clear(buff, sizeof(buff));
     return ret;
 }
 
+int wally_asset_blind_sum_add_input(struct wally_asset_blind_sum *sum, uint64_t value,
+                                    const unsigned char *abf, size_t abf_len,
+                                    const unsigned char *vbf, size_t vbf_len)
+{
+    return blind_sum_add(sum, value, abf, abf_len, vbf, vbf_len, true);
+}
+
+int wally_asset_blind_sum_add_output(struct wally_asset_blind_sum *sum, uint64_t value,
+                                     const unsigned char *abf, size_t abf_len,
+                                     const unsigned char *vbf, size_t vbf_len)
+{
+    return blind_sum_add(sum, value, abf, abf_len, vbf, vbf_len, false);
+}
+
+int wally_asset_blind_sum_final_vbf(const struct wally_asset_blind_sum *sum, uint64_t value,
+                                    const unsigned char *abf, size_t abf_len,
+                                    unsigned char *bytes_out, size_t len)
+{
+    if (!sum || !abf || abf_len != ASSET_TAG_LEN || !bytes_out || len != ASSET_TAG_LEN)
+        return WALLY_EINVAL;
+    return blind_sum_update(sum->sum, value, abf, NULL, false, bytes_out);
+}
+
+static int asset_value_commitment(uint64_t value,
+                                  const unsigned char *vbf, size_t vbf_len,
+                                  const secp256k1_generator *gen,
+                                  unsigned char *bytes_out, size_t len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    secp256k1_pedersen_commitment commit;
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!vbf || vbf_len != ASSET_TAG_LEN || !bytes_out || len != ASSET_COMMITMENT_LEN)
+        return WALLY_EINVAL;
+
+    ok = secp256k1_pedersen_commit(ctx, &commit, vbf, value, gen) &&
+         secp256k1_pedersen_commitment_serialize(ctx, bytes_out, &commit);
+
+    wally_clear(&commit, sizeof(commit));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
 int wally_asset_value_commitment(uint64_t value,
                                  const unsigned char *vbf, size_t vbf_len,
                                  const unsigned char *generator, size_t generator_len,
@@ -100,34 +286,152 @@ int wally_asset_value_commitment(uint64_t value,
 {
     const secp256k1_context *ctx = secp_ctx();
     secp256k1_generator gen;
-    secp256k1_pedersen_commitment commit;
-    bool ok;
+    int ret;
 
     if (!ctx)
         return WALLY_ENOMEM;
 
-    if (!vbf || vbf_len != ASSET_TAG_LEN || !bytes_out || len != ASSET_COMMITMENT_LEN ||
-        get_generator(ctx, generator, generator_len, &gen) != WALLY_OK)
+    if (get_generator(ctx, generator, generator_len, &gen) != WALLY_OK)
         return WALLY_EINVAL;
 
-    ok = secp256k1_pedersen_commit(ctx, &commit, vbf, value, &gen) &&
-         secp256k1_pedersen_commitment_serialize(ctx, bytes_out, &commit);
+    ret = asset_value_commitment(value, vbf, vbf_len, &gen, bytes_out, len);
+    wally_clear(&gen, sizeof(gen));
+    return ret;
+}
 
-    wally_clear_2(&gen, sizeof(gen), &commit, sizeof(commit));
-    return ok ? WALLY_OK : WALLY_EINVAL;
+int wally_asset_value_commitment_parsed(uint64_t value,
+                                        const unsigned char *vbf, size_t vbf_len,
+                                        const struct wally_asset_generator *generator,
+                                        unsigned char *bytes_out, size_t len)
+{
+    if (!generator)
+        return WALLY_EINVAL;
+    return asset_value_commitment(value, vbf, vbf_len, &generator->gen, bytes_out, len);
 }
 
-int wally_asset_rangeproof(uint64_t value,
-                           const unsigned char *pub_key, size_t pub_key_len,
-                           const unsigned char *priv_key, size_t priv_key_len,
-                           const unsigned char *asset, size_t asset_len,
-                           const unsigned char *abf, size_t abf_len,
-                           const unsigned char *vbf, size_t vbf_len,
-                           const unsigned char *commitment, size_t commitment_len,
-                           const unsigned char *extra, size_t extra_len,
-                           const unsigned char *generator, size_t generator_len,
-                           uint64_t min_value, unsigned char *bytes_out, size_t len,
-                           size_t *written)
+int wally_asset_value_commitment_batch(const uint64_t *values, size_t values_len,
+                                       const unsigned char *vbf, size_t vbf_len,
+                                       const unsigned char *generator, size_t generator_len,
+                                       unsigned char *bytes_out, size_t len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    const unsigned char *last_generator = NULL;
+    secp256k1_generator gen;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!values || !values_len ||
+        !vbf || vbf_len != values_len * ASSET_TAG_LEN ||
+        !generator || generator_len != values_len * ASSET_GENERATOR_LEN ||
+        !bytes_out || len != values_len * ASSET_COMMITMENT_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < values_len && ret == WALLY_OK; ++i) {
+        const unsigned char *src = generator + i * ASSET_GENERATOR_LEN;
+
+        /* Outputs of the same asset often share a generator: parse it once */
+        if (!last_generator || memcmp(src, last_generator, ASSET_GENERATOR_LEN)) {
+            ret = get_generator(ctx, src, ASSET_GENERATOR_LEN, &gen);
+            last_generator = src;
+        }
+        if (ret == WALLY_OK)
+            ret = asset_value_commitment(values[i], vbf + i * ASSET_TAG_LEN, ASSET_TAG_LEN,
+                                         &gen, bytes_out + i * ASSET_COMMITMENT_LEN,
+                                         ASSET_COMMITMENT_LEN);
+    }
+
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    wally_clear(&gen, sizeof(gen));
+    return ret;
+}
+
+static int clz64(uint64_t v)
+{
+    int n = 0;
+    while (n < 64 && !(v & (1ull << (63 - n))))
+        ++n;
+    return n;
+}
+
+/* Compute the size of the rangeproof secp256k1_rangeproof_sign creates.
+ * This mirrors the parameter selection in secp256k1_range_proveparams */
+static bool rangeproof_size(uint64_t value, uint64_t min_value, int exp, int min_bits,
+                            size_t *written)
+{
+    size_t rings = 1, npub = 2, header = 1;
+
+    if (min_value > value || min_bits < 0 || min_bits > 64 || exp < -1 || exp > 18)
+        return false;
+
+    if (min_value == UINT64_MAX)
+        exp = -1; /* No range can be coded */
+
+    if (exp >= 0) {
+        const int max_bits = min_value ? clz64(min_value) : 64;
+        uint64_t v, v2;
+        int i, mantissa;
+
+        if ((min_value && value > INT64_MAX) || (value && min_value >= INT64_MAX))
+            return false;
+        if (min_bits > max_bits)
+            min_bits = max_bits;
+        if (min_bits > 61 || value > INT64_MAX)
+            exp = 0;
+        v = value - min_value;
+        v2 = min_bits ? (UINT64_MAX >> (64 - min_bits)) : 0;
+        for (i = 0; i < exp && v2 <= UINT64_MAX / 10; ++i) {
+            v /= 10;
+            v2 *= 10;
+        }
+        exp = i;
+        for (v2 = v, i = 0; i < exp; ++i)
+            v2 *= 10;
+        min_value = value - v2; /* The public offset of an imprecise value */
+        mantissa = v ? 64 - clz64(v) : 1;
+        if (min_bits > mantissa)
+            mantissa = min_bits;
+        /* Radix-4 digits, with a radix-2 final digit for odd mantissas */
+        rings = (mantissa + 1) >> 1;
+        npub = rings * 4 - (mantissa & 1 ? 2 : 0);
+        header += 1; /* Mantissa */
+    } else
+        min_value = value; /* A proof of an exact value */
+
+    if (min_value)
+        header += 8;
+    *written = header + ((rings + 6) >> 3) + 32 * (npub + rings - 1) + 32;
+    return true;
+}
+
+int wally_asset_rangeproof_size(uint64_t value, uint64_t min_value, int exp, int min_bits,
+                                size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!written || !rangeproof_size(value, min_value, exp, min_bits, written))
+        return WALLY_EINVAL;
+    return WALLY_OK;
+}
+
+/* Create a rangeproof, using parsed_pub/parsed_gen if given or parsing
+ * pub_key/generator otherwise */
+static int asset_rangeproof(uint64_t value,
+                            const unsigned char *pub_key, size_t pub_key_len,
+                            const secp256k1_pubkey *parsed_pub,
+                            const unsigned char *priv_key, size_t priv_key_len,
+                            const unsigned char *asset, size_t asset_len,
+                            const unsigned char *abf, size_t abf_len,
+                            const unsigned char *vbf, size_t vbf_len,
+                            const unsigned char *commitment, size_t commitment_len,
+                            const unsigned char *extra, size_t extra_len,
+                            const unsigned char *generator, size_t generator_len,
+                            const secp256k1_generator *parsed_gen,
+                            uint64_t min_value, unsigned char *bytes_out, size_t len,
+                            size_t *written)
 {
     const secp256k1_context *ctx = secp_ctx();
     secp256k1_generator gen;
@@ -135,6 +439,7 @@ int wally_asset_rangeproof(uint64_t value,
     secp256k1_pedersen_commitment commit;
     unsigned char nonce[32], message[ASSET_TAG_LEN * 2];
     struct sha256 nonce_sha;
+    size_t proof_len;
     int ret = WALLY_EINVAL;
 
     if (written)
@@ -143,21 +448,32 @@ int wally_asset_rangeproof(uint64_t value,
     if (!ctx)
         return WALLY_ENOMEM;
 
-    if (!pub_key || pub_key_len != EC_PUBLIC_KEY_LEN ||
-        !pubkey_parse(ctx, &pub, pub_key, pub_key_len) ||
-        !asset || asset_len != ASSET_TAG_LEN ||
+    if (parsed_pub)
+        memcpy(&pub, parsed_pub, sizeof(pub));
+    else if (!pub_key || pub_key_len != EC_PUBLIC_KEY_LEN ||
+             !pubkey_parse(ctx, &pub, pub_key, pub_key_len))
+        goto cleanup;
+
+    if (!asset || asset_len != ASSET_TAG_LEN ||
         !abf || abf_len != ASSET_TAG_LEN ||
         !vbf || vbf_len != ASSET_TAG_LEN ||
-        !bytes_out || len < ASSET_RANGEPROOF_MAX_LEN || !written ||
+        !bytes_out || !written ||
         wally_ec_private_key_verify(priv_key, priv_key_len) != WALLY_OK ||
         get_commitment(ctx, commitment, commitment_len, &commit) != WALLY_OK ||
         /* FIXME: Is there an upper size limit on the extra commitment? */
         (extra_len && !extra) ||
         min_value > 0x7ffffffffffffffful ||
-        get_generator(ctx, generator, generator_len, &gen) != WALLY_OK)
+        !rangeproof_size(value, min_value, ASSET_RANGEPROOF_EXP,
+                         ASSET_RANGEPROOF_MIN_BITS, &proof_len) || len < proof_len)
+        goto cleanup;
+
+    if (parsed_gen)
+        memcpy(&gen, parsed_gen, sizeof(gen));
+    else if (get_generator(ctx, generator, generator_len, &gen) != WALLY_OK)
         goto cleanup;
 
     /* Create the rangeproof nonce */
+    WALLY_STATS_ADD(WALLY_STAT_EC_MULTS, 1);
     if (!secp256k1_ecdh(ctx, nonce, &pub, priv_key)) {
         /* FIXME: Only return WALLY_ERROR if this can fail while priv_key
          * passes wally_ec_private_key_verify(), otherwise return WALLY_EINVAL
@@ -171,11 +487,12 @@ int wally_asset_rangeproof(uint64_t value,
     memcpy(message, asset, ASSET_TAG_LEN);
     memcpy(message + ASSET_TAG_LEN, abf, ASSET_TAG_LEN);
 
-    *written = ASSET_RANGEPROOF_MAX_LEN;
+    *written = len;
     /* FIXME: This only allows 32 bit values. The caller should be able to
      * pass in the maximum value allowed */
     if (secp256k1_rangeproof_sign(ctx, bytes_out, written, min_value, &commit,
-                                  vbf, nonce_sha.u.u8, 0, 32, value,
+                                  vbf, nonce_sha.u.u8, ASSET_RANGEPROOF_EXP,
+                                  ASSET_RANGEPROOF_MIN_BITS, value,
                                   message, sizeof(message),
                                   extra, extra_len,
                                   &gen))
@@ -192,6 +509,169 @@ cleanup:
     return ret;
 }
 
+int wally_asset_rangeproof(uint64_t value,
+                           const unsigned char *pub_key, size_t pub_key_len,
+                           const unsigned char *priv_key, size_t priv_key_len,
+                           const unsigned char *asset, size_t asset_len,
+                           const unsigned char *abf, size_t abf_len,
+                           const unsigned char *vbf, size_t vbf_len,
+                           const unsigned char *commitment, size_t commitment_len,
+                           const unsigned char *extra, size_t extra_len,
+                           const unsigned char *generator, size_t generator_len,
+                           uint64_t min_value, unsigned char *bytes_out, size_t len,
+                           size_t *written)
+{
+    int ret;
+
+    WALLY_TRACE2(wally_asset_rangeproof__entry, extra_len, len);
+    ret = asset_rangeproof(value, pub_key, pub_key_len, NULL, priv_key, priv_key_len,
+                           asset, asset_len, abf, abf_len, vbf, vbf_len,
+                           commitment, commitment_len, extra, extra_len,
+                           generator, generator_len, NULL, min_value,
+                           bytes_out, len, written);
+    WALLY_TRACE2(wally_asset_rangeproof__return, ret, written ? *written : 0);
+    return ret;
+}
+
+int wally_asset_rangeproof_parsed(uint64_t value,
+                                  const struct wally_ec_public_key *pub_key,
+                                  const unsigned char *priv_key, size_t priv_key_len,
+                                  const unsigned char *asset, size_t asset_len,
+                                  const unsigned char *abf, size_t abf_len,
+                                  const unsigned char *vbf, size_t vbf_len,
+                                  const unsigned char *commitment, size_t commitment_len,
+                                  const unsigned char *extra, size_t extra_len,
+                                  const struct wally_asset_generator *generator,
+                                  uint64_t min_value, unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!pub_key || !generator)
+        return WALLY_EINVAL;
+
+    return asset_rangeproof(value, NULL, 0, &pub_key->pub, priv_key, priv_key_len,
+                            asset, asset_len, abf, abf_len, vbf, vbf_len,
+                            commitment, commitment_len, extra, extra_len,
+                            NULL, 0, &generator->gen, min_value,
+                            bytes_out, len, written);
+}
+
+int wally_tx_elements_output_rangeproof_set(struct wally_tx_output *output, uint64_t value,
+                                            const unsigned char *pub_key, size_t pub_key_len,
+                                            const unsigned char *priv_key, size_t priv_key_len,
+                                            const unsigned char *asset, size_t asset_len,
+                                            const unsigned char *abf, size_t abf_len,
+                                            const unsigned char *vbf, size_t vbf_len,
+                                            uint64_t min_value)
+{
+#ifdef BUILD_ELEMENTS
+    unsigned char *proof, *surjectionproof = NULL;
+    size_t proof_len, written;
+    int ret;
+
+    if (!output || !(output->features & WALLY_TX_IS_ELEMENTS) ||
+        (output->features & WALLY_TX_READ_ONLY) ||
+        !rangeproof_size(value, min_value, ASSET_RANGEPROOF_EXP,
+                         ASSET_RANGEPROOF_MIN_BITS, &proof_len))
+        return WALLY_EINVAL;
+
+    if (!(proof = wally_malloc(proof_len)))
+        return WALLY_ENOMEM;
+
+    if ((output->features & WALLY_TX_PROOFS_REFERENCED) && output->surjectionproof_len) {
+        /* The surjection proof references the parsed bytes: take a copy of it */
+        if (!(surjectionproof = wally_malloc(output->surjectionproof_len))) {
+            wally_free(proof);
+            return WALLY_ENOMEM;
+        }
+        memcpy(surjectionproof, output->surjectionproof, output->surjectionproof_len);
+    }
+
+    ret = asset_rangeproof(value, pub_key, pub_key_len, NULL, priv_key, priv_key_len,
+                           asset, asset_len, abf, abf_len, vbf, vbf_len,
+                           output->value, output->value_len,
+                           output->script, output->script_len,
+                           output->asset, output->asset_len, NULL, min_value,
+                           proof, proof_len, &written);
+    if (ret != WALLY_OK) {
+        wally_free(proof);
+        wally_free(surjectionproof);
+        return ret;
+    }
+    if (output->features & WALLY_TX_PROOFS_REFERENCED) {
+        output->features &= ~WALLY_TX_PROOFS_REFERENCED;
+        output->surjectionproof = surjectionproof;
+    } else if (output->rangeproof) {
+        wally_clear_public(output->rangeproof, output->rangeproof_len);
+        wally_free(output->rangeproof);
+    }
+    output->rangeproof = proof;
+    output->rangeproof_len = written;
+    return WALLY_OK;
+#else
+    (void)output;
+    (void)value;
+    (void)pub_key;
+    (void)pub_key_len;
+    (void)priv_key;
+    (void)priv_key_len;
+    (void)asset;
+    (void)asset_len;
+    (void)abf;
+    (void)abf_len;
+    (void)vbf;
+    (void)vbf_len;
+    (void)min_value;
+    return WALLY_ERROR;
+#endif /* BUILD_ELEMENTS */
+}
+
+/* Rewind a rangeproof using a parsed sender pubkey and commitments */
+static int asset_unblind(const secp256k1_context *ctx,
+                         const secp256k1_pubkey *pub, const unsigned char *priv_key,
+                         const unsigned char *proof, size_t proof_len,
+                         const secp256k1_pedersen_commitment *commit,
+                         const unsigned char *extra, size_t extra_len,
+                         const secp256k1_generator *gen,
+                         unsigned char *asset_out, unsigned char *abf_out,
+                         unsigned char *vbf_out, uint64_t *value_out)
+{
+    unsigned char nonce[32], message[ASSET_TAG_LEN * 2];
+    struct sha256 nonce_sha;
+    size_t message_len = sizeof(message);
+    uint64_t min_value, max_value;
+    int ret = WALLY_EINVAL;
+
+    /* Create the rangeproof nonce */
+    WALLY_STATS_ADD(WALLY_STAT_EC_MULTS, 1);
+    if (!secp256k1_ecdh(ctx, nonce, pub, priv_key))
+        goto cleanup;
+    wally_sha256(nonce, sizeof(nonce), nonce_sha.u.u8, sizeof(nonce_sha));
+
+    /* Extract the value blinding factor, value and message from the rangeproof */
+    if (!secp256k1_rangeproof_rewind(ctx, vbf_out, value_out,
+                                     message, &message_len,
+                                     nonce_sha.u.u8, &min_value, &max_value,
+                                     commit, proof, proof_len,
+                                     extra, extra_len,
+                                     gen))
+        goto cleanup;
+
+    /* FIXME: check results per blind.cpp */
+
+    /* Extract the asset id and asset blinding factor from the message */
+    memcpy(asset_out, message, ASSET_TAG_LEN);
+    memcpy(abf_out, message + ASSET_TAG_LEN, ASSET_TAG_LEN);
+    ret = WALLY_OK;
+
+cleanup:
+    wally_clear_3(nonce, sizeof(nonce), &nonce_sha, sizeof(nonce_sha),
+                  message, sizeof(message));
+    return ret;
+}
+
 int wally_asset_unblind(const unsigned char *pub_key, size_t pub_key_len,
                         const unsigned char *priv_key, size_t priv_key_len,
                         const unsigned char *proof, size_t proof_len,
@@ -207,10 +687,6 @@ int wally_asset_unblind(const unsigned char *pub_key, size_t pub_key_len,
     secp256k1_generator gen;
     secp256k1_pubkey pub;
     secp256k1_pedersen_commitment commit;
-    unsigned char nonce[32], message[ASSET_TAG_LEN * 2];
-    struct sha256 nonce_sha;
-    size_t message_len = sizeof(message);
-    uint64_t min_value, max_value;
     int ret = WALLY_EINVAL;
 
     if (!ctx)
@@ -228,34 +704,284 @@ int wally_asset_unblind(const unsigned char *pub_key, size_t pub_key_len,
         !vbf_out || vbf_out_len != ASSET_TAG_LEN || !value_out)
         goto cleanup;
 
-    /* Create the rangeproof nonce */
-    if (!secp256k1_ecdh(ctx, nonce, &pub, priv_key))
-        goto cleanup;
-    wally_sha256(nonce, sizeof(nonce), nonce_sha.u.u8, sizeof(nonce_sha));
-
-    /* Extract the value blinding factor, value and message from the rangeproof */
-    if (!secp256k1_rangeproof_rewind(ctx, vbf_out, value_out,
-                                     message, &message_len,
-                                     nonce_sha.u.u8, &min_value, &max_value,
-                                     &commit, proof, proof_len,
-                                     extra, extra_len,
-                                     &gen))
-        goto cleanup;
-
-    /* FIXME: check results per blind.cpp */
-
-    /* Extract the asset id and asset blinding factor from the message */
-    memcpy(asset_out, message, ASSET_TAG_LEN);
-    memcpy(abf_out, message + ASSET_TAG_LEN, ASSET_TAG_LEN);
-    ret = WALLY_OK;
+    ret = asset_unblind(ctx, &pub, priv_key, proof, proof_len, &commit,
+                        extra, extra_len, &gen, asset_out, abf_out, vbf_out,
+                        value_out);
 
 cleanup:
-    wally_clear_6(&gen, sizeof(gen), &pub, sizeof(pub),
-                  &commit, sizeof(commit),  nonce, sizeof(nonce),
-                  &nonce_sha, sizeof(nonce_sha), message, sizeof(message));
+    wally_clear_3(&gen, sizeof(gen), &pub, sizeof(pub), &commit, sizeof(commit));
     return ret;
 }
 
+static int rangeproof_verify(const secp256k1_context *ctx,
+                             const unsigned char *proof, size_t proof_len,
+                             const secp256k1_pedersen_commitment *commit,
+                             const unsigned char *extra, size_t extra_len,
+                             const secp256k1_generator *gen)
+{
+    uint64_t min_value, max_value;
+
+    if (!proof || !proof_len ||
+        !secp256k1_rangeproof_verify(ctx, &min_value, &max_value, commit,
+                                     proof, proof_len, extra, extra_len, gen))
+        return WALLY_EINVAL;
+    return WALLY_OK;
+}
+
+int wally_asset_rangeproof_verify(const unsigned char *proof, size_t proof_len,
+                                  const unsigned char *commitment, size_t commitment_len,
+                                  const unsigned char *extra, size_t extra_len,
+                                  const unsigned char *generator, size_t generator_len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    secp256k1_generator gen;
+    secp256k1_pedersen_commitment commit;
+    int ret;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (get_commitment(ctx, commitment, commitment_len, &commit) != WALLY_OK ||
+        (extra_len && !extra) ||
+        get_generator(ctx, generator, generator_len, &gen) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    WALLY_TRACE2(wally_asset_rangeproof_verify__entry, proof_len, extra_len);
+    ret = rangeproof_verify(ctx, proof, proof_len, &commit, extra, extra_len, &gen);
+    WALLY_TRACE1(wally_asset_rangeproof_verify__return, ret);
+    return ret;
+}
+
+#ifdef BUILD_ELEMENTS
+/* Parse the value commitment and asset generator of a confidential output */
+static int get_output_commitments(const secp256k1_context *ctx,
+                                  const struct wally_tx_output *output,
+                                  secp256k1_pedersen_commitment *commit,
+                                  secp256k1_generator *gen)
+{
+    if (get_commitment(ctx, output->value, output->value_len, commit) != WALLY_OK ||
+        !output->asset || output->asset_len != ASSET_GENERATOR_LEN)
+        return WALLY_EINVAL;
+    if (output->asset[0] == 1) {
+        /* Explicit asset: the generator is the unblinded asset tag */
+        if (!secp256k1_generator_generate(ctx, gen, output->asset + 1))
+            return WALLY_EINVAL;
+        return WALLY_OK;
+    }
+    return get_generator(ctx, output->asset, output->asset_len, gen);
+}
+/* A confidential output whose rangeproof is to be verified */
+struct rangeproof_verify_task {
+    secp256k1_pedersen_commitment commit;
+    secp256k1_generator gen;
+    const struct wally_tx_output *output;
+    int ret;
+};
+
+struct rangeproof_verify_tasks {
+    const secp256k1_context *ctx;
+    struct rangeproof_verify_task *tasks;
+};
+
+static void rangeproof_verify_task(void *task_ctx, size_t i)
+{
+    const struct rangeproof_verify_tasks *t = task_ctx;
+    struct rangeproof_verify_task *task = t->tasks + i;
+
+    task->ret = rangeproof_verify(t->ctx, task->output->rangeproof,
+                                  task->output->rangeproof_len, &task->commit,
+                                  task->output->script, task->output->script_len,
+                                  &task->gen);
+}
+
+#endif /* BUILD_ELEMENTS */
+
+int wally_asset_rangeproof_verify_tx(const struct wally_tx *tx,
+                                     wally_run_tasks_t run_fn, void *run_ctx)
+{
+#ifdef BUILD_ELEMENTS
+    struct rangeproof_verify_tasks tasks;
+    size_t i, num_tasks = 0;
+    int ret = WALLY_OK;
+
+    if (!tx || (tx->num_outputs && !tx->outputs))
+        return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < tx->num_outputs; ++i)
+        if (tx->outputs[i].value_len == WALLY_TX_ASSET_CT_VALUE_LEN)
+            ++num_tasks;
+    if (!num_tasks)
+        return WALLY_OK;
+
+    if (!(tasks.tasks = wally_scratch_alloc(num_tasks * sizeof(*tasks.tasks))))
+        return WALLY_ENOMEM;
+
+    WALLY_TRACE2(wally_asset_rangeproof_verify_tx__entry, tx->num_outputs, num_tasks);
+    for (i = 0, num_tasks = 0; i < tx->num_outputs && ret == WALLY_OK; ++i)
+        if (tx->outputs[i].value_len == WALLY_TX_ASSET_CT_VALUE_LEN) {
+            struct rangeproof_verify_task *task = tasks.tasks + num_tasks++;
+            task->output = tx->outputs + i;
+            ret = get_output_commitments(tasks.ctx, task->output,
+                                         &task->commit, &task->gen);
+        }
+
+    if (ret == WALLY_OK) {
+        wally_run_tasks(run_fn, run_ctx, num_tasks, rangeproof_verify_task, &tasks);
+
+        for (i = 0; i < num_tasks && ret == WALLY_OK; ++i)
+            ret = tasks.tasks[i].ret;
+    }
+    WALLY_TRACE1(wally_asset_rangeproof_verify_tx__return, ret);
+    wally_scratch_free(tasks.tasks, num_tasks * sizeof(*tasks.tasks));
+    return ret;
+#else
+    (void)tx;
+    (void)run_fn;
+    (void)run_ctx;
+    return WALLY_ERROR;
+#endif /* BUILD_ELEMENTS */
+}
+
+#ifdef BUILD_ELEMENTS
+/* A confidential output to try to unblind */
+struct unblind_task {
+    secp256k1_pubkey pub;
+    secp256k1_pedersen_commitment commit;
+    secp256k1_generator gen;
+    const struct wally_tx_output *output;
+    size_t index;
+    unsigned char asset[ASSET_TAG_LEN];
+    unsigned char abf[ASSET_TAG_LEN];
+    unsigned char vbf[ASSET_TAG_LEN];
+    uint64_t value;
+    int ret;
+};
+
+struct unblind_tasks {
+    const secp256k1_context *ctx;
+    const unsigned char *priv_key;
+    struct unblind_task *tasks;
+};
+
+static void unblind_task(void *task_ctx, size_t i)
+{
+    const struct unblind_tasks *t = task_ctx;
+    struct unblind_task *task = t->tasks + i;
+
+    task->ret = asset_unblind(t->ctx, &task->pub, t->priv_key,
+                              task->output->rangeproof, task->output->rangeproof_len,
+                              &task->commit, task->output->script,
+                              task->output->script_len, &task->gen,
+                              task->asset, task->abf, task->vbf, &task->value);
+}
+
+/* Parse an output for unblinding, rejecting those that cannot be ours */
+static bool unblind_task_init(const secp256k1_context *ctx,
+                              const struct wally_tx_output *output,
+                              struct unblind_task *task)
+{
+    int exp, mantissa;
+    uint64_t min_value, max_value;
+
+    task->output = output;
+    /* The proof header is checked first, since decoding it is cheap */
+    return output->value_len == WALLY_TX_ASSET_CT_VALUE_LEN &&
+           output->nonce && output->nonce_len == EC_PUBLIC_KEY_LEN &&
+           output->rangeproof && output->rangeproof_len &&
+           secp256k1_rangeproof_info(ctx, &exp, &mantissa, &min_value, &max_value,
+                                     output->rangeproof, output->rangeproof_len) &&
+           exp >= 0 && mantissa > 0 &&
+           pubkey_parse(ctx, &task->pub, output->nonce, output->nonce_len) &&
+           get_output_commitments(ctx, output, &task->commit, &task->gen) == WALLY_OK;
+}
+#endif /* BUILD_ELEMENTS */
+
+int wally_asset_unblind_tx(const struct wally_tx *tx,
+                           const unsigned char *priv_key, size_t priv_key_len,
+                           wally_run_tasks_t run_fn, void *run_ctx,
+                           uint32_t *index_out,
+                           unsigned char *asset_out, size_t asset_out_len,
+                           unsigned char *abf_out, size_t abf_out_len,
+                           unsigned char *vbf_out, size_t vbf_out_len,
+                           uint64_t *value_out, size_t len, size_t *written)
+{
+#ifdef BUILD_ELEMENTS
+    struct unblind_tasks tasks;
+    size_t i, num_tasks = 0;
+
+    if (written)
+        *written = 0;
+
+    if (!tx || (tx->num_outputs && !tx->outputs) ||
+        wally_ec_private_key_verify(priv_key, priv_key_len) != WALLY_OK ||
+        !index_out || !value_out || !len || !written ||
+        !asset_out || asset_out_len != len * ASSET_TAG_LEN ||
+        !abf_out || abf_out_len != len * ASSET_TAG_LEN ||
+        !vbf_out || vbf_out_len != len * ASSET_TAG_LEN)
+        return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+    tasks.priv_key = priv_key;
+
+    if (!tx->num_outputs)
+        return WALLY_OK;
+    if (!(tasks.tasks = wally_scratch_alloc(tx->num_outputs * sizeof(*tasks.tasks))))
+        return WALLY_ENOMEM;
+
+    WALLY_TRACE1(wally_asset_unblind_tx__entry, tx->num_outputs);
+    for (i = 0; i < tx->num_outputs; ++i) {
+        tasks.tasks[num_tasks].index = i;
+        if (unblind_task_init(tasks.ctx, tx->outputs + i, tasks.tasks + num_tasks))
+            ++num_tasks;
+    }
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, unblind_task, &tasks);
+
+    /* Outputs that fail to rewind are not ours; return the rest in order */
+    for (i = 0; i < num_tasks; ++i) {
+        const struct unblind_task *task = tasks.tasks + i;
+        if (task->ret != WALLY_OK)
+            continue;
+        if (*written < len) {
+            index_out[*written] = (uint32_t)task->index;
+            memcpy(asset_out + *written * ASSET_TAG_LEN, task->asset, ASSET_TAG_LEN);
+            memcpy(abf_out + *written * ASSET_TAG_LEN, task->abf, ASSET_TAG_LEN);
+            memcpy(vbf_out + *written * ASSET_TAG_LEN, task->vbf, ASSET_TAG_LEN);
+            value_out[*written] = task->value;
+        }
+        *written += 1;
+    }
+    WALLY_TRACE1(wally_asset_unblind_tx__return, *written);
+
+    wally_scratch_free(tasks.tasks, tx->num_outputs * sizeof(*tasks.tasks));
+    return WALLY_OK;
+#else
+    (void)tx;
+    (void)priv_key;
+    (void)priv_key_len;
+    (void)run_fn;
+    (void)run_ctx;
+    (void)index_out;
+    (void)asset_out;
+    (void)asset_out_len;
+    (void)abf_out;
+    (void)abf_out_len;
+    (void)vbf_out;
+    (void)vbf_out_len;
+    (void)value_out;
+    (void)len;
+    if (written)
+        *written = 0;
+    return WALLY_ERROR;
+#endif /* BUILD_ELEMENTS */
+}
+
 int wally_asset_surjectionproof_size(size_t num_inputs, size_t *written)
 {
     size_t num_used = num_inputs > 3 ? 3 : num_inputs;
@@ -267,6 +993,39 @@ int wally_asset_surjectionproof_size(size_t num_inputs, size_t *written)
     return WALLY_OK;
 }
 
+/* Create a surjection proof from parsed output and input generators */
+static int asset_surjectionproof(const secp256k1_context *ctx,
+                                 const unsigned char *output_asset,
+                                 const unsigned char *output_abf,
+                                 const secp256k1_generator *gen,
+                                 const unsigned char *bytes,
+                                 const unsigned char *asset, const unsigned char *abf,
+                                 const secp256k1_generator *generators, size_t num_inputs,
+                                 size_t max_iterations,
+                                 unsigned char *bytes_out, size_t len, size_t *written)
+{
+    secp256k1_surjectionproof proof;
+    size_t num_used = num_inputs > 3 ? 3 : num_inputs;
+    size_t actual_index;
+    int ret = WALLY_ERROR; /* Caller must retry with different entropy/outputs */
+
+    if (secp256k1_surjectionproof_initialize(ctx, &proof, &actual_index,
+                                             (const secp256k1_fixed_asset_tag *)asset,
+                                             num_inputs, num_used,
+                                             (const secp256k1_fixed_asset_tag *)output_asset,
+                                             max_iterations, bytes) &&
+        secp256k1_surjectionproof_generate(ctx, &proof, generators, num_inputs,
+                                           gen, actual_index,
+                                           abf + actual_index * ASSET_TAG_LEN,
+                                           output_abf)) {
+        *written = len;
+        secp256k1_surjectionproof_serialize(ctx, bytes_out, written, &proof);
+        ret = WALLY_OK;
+    }
+    wally_clear(&proof, sizeof(proof));
+    return ret;
+}
+
 int wally_asset_surjectionproof(const unsigned char *output_asset, size_t output_asset_len,
                                 const unsigned char *output_abf, size_t output_abf_len,
                                 const unsigned char *output_generator, size_t output_generator_len,
@@ -279,11 +1038,10 @@ int wally_asset_surjectionproof(const unsigned char *output_asset, size_t output
 {
     const secp256k1_context *ctx = secp_ctx();
     secp256k1_generator gen;
-    secp256k1_surjectionproof proof;
     secp256k1_generator *generators = NULL;
     const size_t num_inputs = asset_len / ASSET_TAG_LEN;
     size_t num_used = num_inputs > 3 ? 3 : num_inputs;
-    size_t actual_index, i;
+    size_t i;
     int ret = WALLY_EINVAL;
 
     if (written)
@@ -308,7 +1066,7 @@ int wally_asset_surjectionproof(const unsigned char *output_asset, size_t output
      * currently differ from serialized, if this function took a pointer
      * to an array, all this is actually just a very convoluted cast.
      */
-    if (!(generators = wally_malloc(num_inputs * sizeof(secp256k1_generator)))) {
+    if (!(generators = wally_scratch_alloc(num_inputs * sizeof(secp256k1_generator)))) {
         ret = WALLY_ENOMEM;
         goto cleanup;
     }
@@ -318,31 +1076,993 @@ int wally_asset_surjectionproof(const unsigned char *output_asset, size_t output
             goto cleanup;
     }
 
-    if (!secp256k1_surjectionproof_initialize(ctx, &proof, &actual_index,
-                                              (const secp256k1_fixed_asset_tag *)asset,
-                                              num_inputs, num_used,
-                                              (const secp256k1_fixed_asset_tag *)output_asset,
-                                              100, bytes)) {
-        ret = WALLY_ERROR; /* Caller must retry with different entropy/outputs */
-        goto cleanup;
+    ret = asset_surjectionproof(ctx, output_asset, output_abf, &gen, bytes,
+                                asset, abf, generators, num_inputs,
+                                ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS,
+                                bytes_out, len, written);
+
+cleanup:
+    wally_clear(&gen, sizeof(gen));
+    wally_scratch_free(generators, num_inputs * sizeof(secp256k1_generator));
+    return ret;
+}
+
+/* The input assets of a surjection proof, with their generators parsed */
+struct wally_asset_surjectionproof_inputs {
+    size_t num_inputs;
+    unsigned char *asset;
+    unsigned char *abf;
+    secp256k1_generator *generators;
+};
+
+int wally_asset_surjectionproof_inputs_init_alloc(
+    const unsigned char *asset, size_t asset_len,
+    const unsigned char *abf, size_t abf_len,
+    const unsigned char *generator, size_t generator_len,
+    struct wally_asset_surjectionproof_inputs **output)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    struct wally_asset_surjectionproof_inputs *inputs;
+    const size_t num_inputs = asset_len / ASSET_TAG_LEN;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (output)
+        *output = NULL;
+
+    if (!asset || !num_inputs || (asset_len % ASSET_TAG_LEN != 0) ||
+        !abf || abf_len != num_inputs * ASSET_TAG_LEN ||
+        !generator || generator_len != num_inputs * ASSET_GENERATOR_LEN || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!(inputs = wally_malloc(sizeof(*inputs))))
+        return WALLY_ENOMEM;
+    inputs->num_inputs = num_inputs;
+    inputs->asset = wally_malloc(asset_len);
+    inputs->abf = wally_malloc(abf_len);
+    inputs->generators = wally_malloc(num_inputs * sizeof(*inputs->generators));
+
+    if (!inputs->asset || !inputs->abf || !inputs->generators)
+        ret = WALLY_ENOMEM;
+    for (i = 0; i < num_inputs && ret == WALLY_OK; ++i)
+        ret = get_generator(ctx, generator + i * ASSET_GENERATOR_LEN,
+                            ASSET_GENERATOR_LEN, inputs->generators + i);
+
+    if (ret != WALLY_OK) {
+        wally_asset_surjectionproof_inputs_free(inputs);
+        return ret;
+    }
+    memcpy(inputs->asset, asset, asset_len);
+    memcpy(inputs->abf, abf, abf_len);
+    *output = inputs;
+    return WALLY_OK;
+}
+
+int wally_asset_surjectionproof_inputs_free(struct wally_asset_surjectionproof_inputs *inputs)
+{
+    if (!inputs)
+        return WALLY_EINVAL;
+    if (inputs->asset)
+        wally_clear(inputs->asset, inputs->num_inputs * ASSET_TAG_LEN);
+    if (inputs->abf)
+        wally_clear(inputs->abf, inputs->num_inputs * ASSET_TAG_LEN);
+    if (inputs->generators)
+        wally_clear(inputs->generators, inputs->num_inputs * sizeof(*inputs->generators));
+    wally_free(inputs->asset);
+    wally_free(inputs->abf);
+    wally_free(inputs->generators);
+    wally_clear(inputs, sizeof(*inputs));
+    wally_free(inputs);
+    return WALLY_OK;
+}
+
+int wally_asset_surjectionproof_parsed(const struct wally_asset_surjectionproof_inputs *inputs,
+                                       const unsigned char *output_asset, size_t output_asset_len,
+                                       const unsigned char *output_abf, size_t output_abf_len,
+                                       const unsigned char *output_generator,
+                                       size_t output_generator_len,
+                                       const unsigned char *bytes, size_t bytes_len,
+                                       size_t max_iterations,
+                                       unsigned char *bytes_out, size_t len, size_t *written)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    secp256k1_generator gen;
+    size_t proof_len;
+    int ret;
+
+    if (written)
+        *written = 0;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!inputs ||
+        wally_asset_surjectionproof_size(inputs->num_inputs, &proof_len) != WALLY_OK ||
+        !output_asset || output_asset_len != ASSET_TAG_LEN ||
+        !output_abf || output_abf_len != ASSET_TAG_LEN ||
+        get_generator(ctx, output_generator, output_generator_len, &gen) != WALLY_OK ||
+        !bytes || bytes_len != 32u || !max_iterations ||
+        !bytes_out || len != proof_len || !written)
+        return WALLY_EINVAL;
+
+    ret = asset_surjectionproof(ctx, output_asset, output_abf, &gen, bytes,
+                                inputs->asset, inputs->abf, inputs->generators,
+                                inputs->num_inputs, max_iterations,
+                                bytes_out, len, written);
+    wally_clear(&gen, sizeof(gen));
+    return ret;
+}
+
+/* Surjection proofs for several outputs sharing the same inputs */
+struct surjectionproof_tasks {
+    const secp256k1_context *ctx;
+    const struct wally_asset_surjectionproof_inputs *inputs;
+    const unsigned char *output_asset;
+    const unsigned char *output_abf;
+    const unsigned char *bytes;
+    secp256k1_generator *generators;
+    size_t max_iterations;
+    unsigned char *bytes_out;
+    size_t proof_len;
+    int *rets;
+};
+
+static void surjectionproof_task(void *task_ctx, size_t i)
+{
+    const struct surjectionproof_tasks *t = task_ctx;
+    size_t written;
+
+    t->rets[i] = asset_surjectionproof(t->ctx, t->output_asset + i * ASSET_TAG_LEN,
+                                       t->output_abf + i * ASSET_TAG_LEN,
+                                       t->generators + i, t->bytes + i * 32u,
+                                       t->inputs->asset, t->inputs->abf,
+                                       t->inputs->generators, t->inputs->num_inputs,
+                                       t->max_iterations,
+                                       t->bytes_out + i * t->proof_len, t->proof_len,
+                                       &written);
+}
+
+int wally_asset_surjectionproof_batch(const struct wally_asset_surjectionproof_inputs *inputs,
+                                      const unsigned char *output_asset, size_t output_asset_len,
+                                      const unsigned char *output_abf, size_t output_abf_len,
+                                      const unsigned char *output_generator,
+                                      size_t output_generator_len,
+                                      const unsigned char *bytes, size_t bytes_len,
+                                      size_t max_iterations,
+                                      wally_run_tasks_t run_fn, void *run_ctx,
+                                      unsigned char *bytes_out, size_t len)
+{
+    struct surjectionproof_tasks tasks;
+    const size_t num_outputs = output_asset_len / ASSET_TAG_LEN;
+    const size_t scratch_len = num_outputs * (sizeof(*tasks.generators) +
+                                              sizeof(*tasks.rets));
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!inputs ||
+        wally_asset_surjectionproof_size(inputs->num_inputs, &tasks.proof_len) != WALLY_OK ||
+        !output_asset || !num_outputs || (output_asset_len % ASSET_TAG_LEN != 0) ||
+        !output_abf || output_abf_len != num_outputs * ASSET_TAG_LEN ||
+        !output_generator || output_generator_len != num_outputs * ASSET_GENERATOR_LEN ||
+        !bytes || bytes_len != num_outputs * 32u || !max_iterations ||
+        !bytes_out || len != num_outputs * tasks.proof_len)
+        return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+    tasks.inputs = inputs;
+    tasks.output_asset = output_asset;
+    tasks.output_abf = output_abf;
+    tasks.bytes = bytes;
+    tasks.max_iterations = max_iterations;
+    tasks.bytes_out = bytes_out;
+    /* The generators are followed by the task results in one buffer */
+    if ((tasks.generators = wally_scratch_alloc(scratch_len)))
+        tasks.rets = (int *)(tasks.generators + num_outputs);
+    else
+        ret = WALLY_ENOMEM;
+
+    WALLY_TRACE2(wally_asset_surjectionproof_batch__entry, inputs->num_inputs, num_outputs);
+    for (i = 0; i < num_outputs && ret == WALLY_OK; ++i)
+        ret = get_generator(tasks.ctx, output_generator + i * ASSET_GENERATOR_LEN,
+                            ASSET_GENERATOR_LEN, tasks.generators + i);
+
+    if (ret == WALLY_OK) {
+        wally_run_tasks(run_fn, run_ctx, num_outputs, surjectionproof_task, &tasks);
+
+        for (i = 0; i < num_outputs && ret == WALLY_OK; ++i)
+            ret = tasks.rets[i];
+    }
+    WALLY_TRACE1(wally_asset_surjectionproof_batch__return, ret);
+
+    wally_scratch_free(tasks.generators, scratch_len);
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    return ret;
+}
+
+static int surjectionproof_verify(const secp256k1_context *ctx,
+                                  const unsigned char *proof, size_t proof_len,
+                                  const secp256k1_generator *generators, size_t num_inputs,
+                                  const secp256k1_generator *gen)
+{
+    secp256k1_surjectionproof sp;
+    int ret = WALLY_OK;
+
+    if (!proof || !proof_len ||
+        !secp256k1_surjectionproof_parse(ctx, &sp, proof, proof_len) ||
+        !secp256k1_surjectionproof_verify(ctx, &sp, generators, num_inputs, gen))
+        ret = WALLY_EINVAL;
+    wally_clear(&sp, sizeof(sp));
+    return ret;
+}
+
+/* Parse the input generators of a surjection proof into dest */
+static int get_generators(const secp256k1_context *ctx,
+                          const unsigned char *generator, size_t num_inputs,
+                          secp256k1_generator *dest)
+{
+    size_t i;
+    int ret = WALLY_OK;
+
+    for (i = 0; i < num_inputs && ret == WALLY_OK; ++i)
+        ret = get_generator(ctx, generator + i * ASSET_GENERATOR_LEN,
+                            ASSET_GENERATOR_LEN, dest + i);
+    return ret;
+}
+
+int wally_asset_surjectionproof_verify(const unsigned char *proof, size_t proof_len,
+                                       const unsigned char *output_generator,
+                                       size_t output_generator_len,
+                                       const unsigned char *generator, size_t generator_len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    const size_t num_inputs = generator_len / ASSET_GENERATOR_LEN;
+    secp256k1_generator gen, *generators;
+    int ret;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (get_generator(ctx, output_generator, output_generator_len, &gen) != WALLY_OK ||
+        !generator || !num_inputs || generator_len % ASSET_GENERATOR_LEN)
+        return WALLY_EINVAL;
+
+    if (!(generators = wally_scratch_alloc(num_inputs * sizeof(*generators))))
+        return WALLY_ENOMEM;
+
+    WALLY_TRACE2(wally_asset_surjectionproof_verify__entry, proof_len, num_inputs);
+    ret = get_generators(ctx, generator, num_inputs, generators);
+    if (ret == WALLY_OK)
+        ret = surjectionproof_verify(ctx, proof, proof_len, generators, num_inputs, &gen);
+    WALLY_TRACE1(wally_asset_surjectionproof_verify__return, ret);
+    wally_scratch_free(generators, num_inputs * sizeof(*generators));
+    return ret;
+}
+
+#ifdef BUILD_ELEMENTS
+/* A blinded output whose surjection proof is to be verified */
+struct surjectionproof_verify_task {
+    secp256k1_generator gen;
+    const struct wally_tx_output *output;
+    int ret;
+};
+
+struct surjectionproof_verify_tasks {
+    const secp256k1_context *ctx;
+    const secp256k1_generator *generators;
+    size_t num_inputs;
+    struct surjectionproof_verify_task *tasks;
+};
+
+static void surjectionproof_verify_task(void *task_ctx, size_t i)
+{
+    const struct surjectionproof_verify_tasks *t = task_ctx;
+    struct surjectionproof_verify_task *task = t->tasks + i;
+
+    task->ret = surjectionproof_verify(t->ctx, task->output->surjectionproof,
+                                       task->output->surjectionproof_len,
+                                       t->generators, t->num_inputs, &task->gen);
+}
+
+static bool is_blinded_asset(const struct wally_tx_output *output)
+{
+    return output->asset_len == WALLY_TX_ASSET_CT_ASSET_LEN &&
+           (output->asset[0] == WALLY_TX_ASSET_CT_ASSET_PREFIX_A ||
+            output->asset[0] == WALLY_TX_ASSET_CT_ASSET_PREFIX_B);
+}
+#endif /* BUILD_ELEMENTS */
+
+int wally_asset_surjectionproof_verify_tx(const struct wally_tx *tx,
+                                          const unsigned char *generator,
+                                          size_t generator_len,
+                                          wally_run_tasks_t run_fn, void *run_ctx)
+{
+#ifdef BUILD_ELEMENTS
+    struct surjectionproof_verify_tasks tasks;
+    const size_t num_inputs = generator_len / ASSET_GENERATOR_LEN;
+    size_t i, num_tasks = 0, scratch_len;
+    int ret;
+
+    if (!tx || (tx->num_outputs && !tx->outputs) ||
+        !generator || !num_inputs || generator_len % ASSET_GENERATOR_LEN)
+        return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < tx->num_outputs; ++i)
+        if (is_blinded_asset(tx->outputs + i))
+            ++num_tasks;
+    if (!num_tasks)
+        return WALLY_OK;
+
+    /* The tasks are followed by the shared input generators in one buffer */
+    scratch_len = num_tasks * sizeof(*tasks.tasks) + num_inputs * sizeof(secp256k1_generator);
+    if (!(tasks.tasks = wally_scratch_alloc(scratch_len)))
+        return WALLY_ENOMEM;
+    tasks.generators = (secp256k1_generator *)(tasks.tasks + num_tasks);
+    tasks.num_inputs = num_inputs;
+
+    WALLY_TRACE2(wally_asset_surjectionproof_verify_tx__entry, num_inputs, num_tasks);
+    ret = get_generators(tasks.ctx, generator, num_inputs,
+                         (secp256k1_generator *)tasks.generators);
+    for (i = 0, num_tasks = 0; i < tx->num_outputs && ret == WALLY_OK; ++i)
+        if (is_blinded_asset(tx->outputs + i)) {
+            struct surjectionproof_verify_task *task = tasks.tasks + num_tasks++;
+            task->output = tx->outputs + i;
+            ret = get_generator(tasks.ctx, task->output->asset,
+                                task->output->asset_len, &task->gen);
+        }
+
+    if (ret == WALLY_OK) {
+        wally_run_tasks(run_fn, run_ctx, num_tasks, surjectionproof_verify_task, &tasks);
+
+        for (i = 0; i < num_tasks && ret == WALLY_OK; ++i)
+            ret = tasks.tasks[i].ret;
     }
+    WALLY_TRACE1(wally_asset_surjectionproof_verify_tx__return, ret);
+    wally_scratch_free(tasks.tasks, scratch_len);
+    return ret;
+#else
+    (void)tx;
+    (void)generator;
+    (void)generator_len;
+    (void)run_fn;
+    (void)run_ctx;
+    return WALLY_ERROR;
+#endif /* BUILD_ELEMENTS */
+}
+
+#ifdef BUILD_ELEMENTS
+/* An output to blind, with storage for its new commitments and proofs */
+struct blind_task {
+    secp256k1_pubkey pub;
+    const struct wally_tx_output *output;
+    uint64_t value;
+    const unsigned char *asset;
+    const unsigned char *abf;
+    const unsigned char *vbf;
+    const unsigned char *priv_key;
+    const unsigned char *entropy;
+    unsigned char *generator;
+    unsigned char *commitment;
+    unsigned char *nonce;
+    unsigned char *surjectionproof;
+    size_t surjectionproof_len;
+    unsigned char *rangeproof;
+    size_t rangeproof_len;
+    int ret;
+};
 
-    if (!secp256k1_surjectionproof_generate(ctx, &proof, generators, num_inputs,
-                                            &gen, actual_index,
-                                            abf + actual_index * ASSET_TAG_LEN,
-                                            output_abf)) {
-        ret = WALLY_ERROR; /* Caller must retry with different entropy/outputs */
+struct blind_tasks {
+    const secp256k1_context *ctx;
+    const unsigned char *asset;
+    const unsigned char *abf;
+    secp256k1_generator *generators;
+    size_t num_inputs;
+    size_t surjectionproof_len;
+    struct blind_task *tasks;
+};
+
+static void blind_task(void *task_ctx, size_t i)
+{
+    const struct blind_tasks *t = task_ctx;
+    struct blind_task *task = t->tasks + i;
+    secp256k1_generator gen;
+
+    task->ret = WALLY_ERROR; /* Invalid entropy; caller should try again */
+    if (secp256k1_generator_generate_blinded(t->ctx, &gen, task->asset, task->abf)) {
+        secp256k1_generator_serialize(t->ctx, task->generator, &gen);
+        task->ret = asset_value_commitment(task->value, task->vbf, ASSET_TAG_LEN, &gen,
+                                           task->commitment, ASSET_COMMITMENT_LEN);
+    }
+    if (task->ret == WALLY_OK)
+        task->ret = wally_ec_public_key_from_private_key(task->priv_key, EC_PRIVATE_KEY_LEN,
+                                                         task->nonce, EC_PUBLIC_KEY_LEN);
+    if (task->ret == WALLY_OK)
+        task->ret = asset_rangeproof(task->value, NULL, 0, &task->pub,
+                                     task->priv_key, EC_PRIVATE_KEY_LEN,
+                                     task->asset, ASSET_TAG_LEN, task->abf, ASSET_TAG_LEN,
+                                     task->vbf, ASSET_TAG_LEN,
+                                     task->commitment, ASSET_COMMITMENT_LEN,
+                                     task->output->script, task->output->script_len,
+                                     NULL, 0, &gen, task->value ? 1 : 0,
+                                     task->rangeproof, task->rangeproof_len,
+                                     &task->rangeproof_len);
+    if (task->ret == WALLY_OK)
+        task->ret = asset_surjectionproof(t->ctx, task->asset, task->abf, &gen,
+                                          task->entropy, t->asset, t->abf,
+                                          t->generators, t->num_inputs,
+                                          ASSET_SURJECTIONPROOF_DEFAULT_ITERATIONS,
+                                          task->surjectionproof, t->surjectionproof_len,
+                                          &task->surjectionproof_len);
+    wally_clear(&gen, sizeof(gen));
+}
+
+/* Allocate the storage that a blinded output's proofs are written to */
+static bool blind_task_alloc(struct blind_task *task, size_t surjectionproof_len)
+{
+    return (task->generator = wally_malloc(ASSET_GENERATOR_LEN)) != NULL &&
+           (task->commitment = wally_malloc(ASSET_COMMITMENT_LEN)) != NULL &&
+           (task->nonce = wally_malloc(EC_PUBLIC_KEY_LEN)) != NULL &&
+           (task->surjectionproof = wally_malloc(surjectionproof_len)) != NULL &&
+           (task->rangeproof = wally_malloc(task->rangeproof_len)) != NULL;
+}
+
+static void blind_task_free(struct blind_task *task)
+{
+    wally_free(task->generator);
+    wally_free(task->commitment);
+    wally_free(task->nonce);
+    wally_free(task->surjectionproof);
+    wally_free(task->rangeproof);
+}
+#endif /* BUILD_ELEMENTS */
+
+int wally_tx_blind(struct wally_tx *tx,
+                   const uint32_t *indices, size_t indices_len,
+                   const uint64_t *values, size_t values_len, size_t num_inputs,
+                   const unsigned char *asset, size_t asset_len,
+                   const unsigned char *abf, size_t abf_len,
+                   const unsigned char *vbf, size_t vbf_len,
+                   const unsigned char *generator, size_t generator_len,
+                   const unsigned char *pub_key, size_t pub_key_len,
+                   const unsigned char *priv_key, size_t priv_key_len,
+                   const unsigned char *bytes, size_t bytes_len,
+                   wally_run_tasks_t run_fn, void *run_ctx,
+                   unsigned char *bytes_out, size_t len)
+{
+#ifdef BUILD_ELEMENTS
+    struct blind_tasks tasks;
+    const size_t scratch_len = indices_len * sizeof(*tasks.tasks) +
+                               num_inputs * sizeof(*tasks.generators);
+    size_t i, j;
+    int ret;
+
+    if (!tx || (tx->num_outputs && !tx->outputs) ||
+        !indices || !indices_len || !num_inputs ||
+        values_len != num_inputs + indices_len ||
+        !asset || asset_len != values_len * ASSET_TAG_LEN ||
+        !generator || generator_len != num_inputs * ASSET_GENERATOR_LEN ||
+        !pub_key || pub_key_len != indices_len * EC_PUBLIC_KEY_LEN ||
+        !priv_key || priv_key_len != indices_len * EC_PRIVATE_KEY_LEN ||
+        !bytes || bytes_len != indices_len * 32u ||
+        !bytes_out || len != ASSET_TAG_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < indices_len; ++i) {
+        if (indices[i] >= tx->num_outputs ||
+            !(tx->outputs[indices[i]].features & WALLY_TX_IS_ELEMENTS) ||
+            (tx->outputs[indices[i]].features & WALLY_TX_READ_ONLY) ||
+            wally_ec_private_key_verify(priv_key + i * EC_PRIVATE_KEY_LEN,
+                                        EC_PRIVATE_KEY_LEN) != WALLY_OK)
+            return WALLY_EINVAL;
+        for (j = 0; j < i; ++j)
+            if (indices[j] == indices[i])
+                return WALLY_EINVAL; /* Each output can only be blinded once */
+    }
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    /* The last output's value blinding factor balances the transaction */
+    ret = wally_asset_final_vbf(values, values_len, num_inputs, abf, abf_len,
+                                vbf, vbf_len, bytes_out, len);
+    if (ret != WALLY_OK)
+        return ret;
+
+    tasks.asset = asset;
+    tasks.abf = abf;
+    tasks.num_inputs = num_inputs;
+    wally_asset_surjectionproof_size(num_inputs, &tasks.surjectionproof_len);
+    /* The tasks are followed by the input generators in one buffer */
+    if (!(tasks.tasks = wally_scratch_alloc(scratch_len))) {
+        ret = WALLY_ENOMEM;
         goto cleanup;
     }
+    wally_clear(tasks.tasks, indices_len * sizeof(*tasks.tasks));
+    tasks.generators = (secp256k1_generator *)(tasks.tasks + indices_len);
 
-    *written = len;
-    secp256k1_surjectionproof_serialize(ctx, bytes_out, written, &proof);
-    ret = WALLY_OK;
+    WALLY_TRACE2(wally_tx_blind__entry, num_inputs, indices_len);
+    for (i = 0; i < num_inputs && ret == WALLY_OK; ++i)
+        ret = get_generator(tasks.ctx, generator + i * ASSET_GENERATOR_LEN,
+                            ASSET_GENERATOR_LEN, tasks.generators + i);
+
+    for (i = 0; i < indices_len && ret == WALLY_OK; ++i) {
+        struct blind_task *task = tasks.tasks + i;
+        const size_t n = num_inputs + i;
+
+        task->output = tx->outputs + indices[i];
+        task->value = values[n];
+        task->asset = asset + n * ASSET_TAG_LEN;
+        task->abf = abf + n * ASSET_TAG_LEN;
+        task->vbf = i == indices_len - 1 ? bytes_out : vbf + n * ASSET_TAG_LEN;
+        task->priv_key = priv_key + i * EC_PRIVATE_KEY_LEN;
+        task->entropy = bytes + i * 32u;
+        if (!pubkey_parse(tasks.ctx, &task->pub, pub_key + i * EC_PUBLIC_KEY_LEN,
+                          EC_PUBLIC_KEY_LEN) ||
+            !rangeproof_size(task->value, task->value ? 1 : 0, ASSET_RANGEPROOF_EXP,
+                             ASSET_RANGEPROOF_MIN_BITS, &task->rangeproof_len))
+            ret = WALLY_EINVAL;
+        else if (!blind_task_alloc(task, tasks.surjectionproof_len))
+            ret = WALLY_ENOMEM;
+    }
+
+    if (ret == WALLY_OK) {
+        wally_run_tasks(run_fn, run_ctx, indices_len, blind_task, &tasks);
+
+        for (i = 0; i < indices_len && ret == WALLY_OK; ++i)
+            ret = tasks.tasks[i].ret;
+    }
+
+    /* Only modify the transaction once every output has been blinded */
+    for (i = 0; i < indices_len && ret == WALLY_OK; ++i) {
+        struct blind_task *task = tasks.tasks + i;
+        struct wally_tx_output *output = tx->outputs + indices[i];
+
+        wally_tx_elements_output_commitment_free(output);
+        output->features |= WALLY_TX_IS_ELEMENTS; /* Cleared by the free above */
+        output->asset = task->generator;
+        output->asset_len = ASSET_GENERATOR_LEN;
+        output->value = task->commitment;
+        output->value_len = ASSET_COMMITMENT_LEN;
+        output->nonce = task->nonce;
+        output->nonce_len = EC_PUBLIC_KEY_LEN;
+        output->surjectionproof = task->surjectionproof;
+        output->surjectionproof_len = task->surjectionproof_len;
+        output->rangeproof = task->rangeproof;
+        output->rangeproof_len = task->rangeproof_len;
+        wally_clear(task, sizeof(*task)); /* The output now owns the storage */
+    }
+    WALLY_TRACE1(wally_tx_blind__return, ret);
 
 cleanup:
-    wally_clear_2(&gen, sizeof(gen), &proof, sizeof(proof));
-    if (generators)
-        wally_clear(generators, num_inputs * sizeof(secp256k1_generator));
-    wally_free(generators);
+    if (tasks.tasks) {
+        for (i = 0; i < indices_len; ++i)
+            blind_task_free(tasks.tasks + i);
+        wally_scratch_free(tasks.tasks, scratch_len);
+    }
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    return ret;
+#else
+    (void)tx;
+    (void)indices;
+    (void)indices_len;
+    (void)values;
+    (void)values_len;
+    (void)num_inputs;
+    (void)asset;
+    (void)asset_len;
+    (void)abf;
+    (void)abf_len;
+    (void)vbf;
+    (void)vbf_len;
+    (void)generator;
+    (void)generator_len;
+    (void)pub_key;
+    (void)pub_key_len;
+    (void)priv_key;
+    (void)priv_key_len;
+    (void)bytes;
+    (void)bytes_len;
+    (void)run_fn;
+    (void)run_ctx;
+    (void)bytes_out;
+    (void)len;
+    return WALLY_ERROR;
+#endif /* BUILD_ELEMENTS */
+}
+
+/* The SLIP-21 key derivation label used by SLIP-77 */
+static const unsigned char SLIP77_LABEL[] = {
+    '\0', 'S', 'L', 'I', 'P', '-', '0', '0', '7', '7'
+};
+
+/* Scripts hashed per call to hmac_sha256_ctx_batch_impl */
+#define BLINDING_KEY_BATCH 32
+
+int wally_asset_blinding_key_from_seed(const unsigned char *bytes, size_t bytes_len,
+                                       unsigned char *bytes_out, size_t len)
+{
+    static const unsigned char SLIP21_SEED[] = {
+        'S', 'y', 'm', 'm', 'e', 't', 'r', 'i', 'c', ' ', 'k', 'e', 'y', ' ', 's', 'e', 'e', 'd'
+    };
+    struct sha512 root, node;
+
+    if (!bytes || (bytes_len != BIP32_ENTROPY_LEN_128 && bytes_len != BIP32_ENTROPY_LEN_256 &&
+                   bytes_len != BIP32_ENTROPY_LEN_512) ||
+        !bytes_out || len != HMAC_SHA512_LEN)
+        return WALLY_EINVAL;
+
+    /* The SLIP-21 root node, then its child for the SLIP-77 label */
+    hmac_sha512_impl(&root, SLIP21_SEED, sizeof(SLIP21_SEED), bytes, bytes_len);
+    hmac_sha512_impl(&node, root.u.u8, HMAC_SHA512_LEN / 2,
+                     SLIP77_LABEL, sizeof(SLIP77_LABEL));
+    memcpy(bytes_out, node.u.u8, sizeof(node.u.u8));
+    wally_clear_2(&root, sizeof(root), &node, sizeof(node));
+    return WALLY_OK;
+}
+
+/* Return the key to HMAC scripts with from a SLIP-21 node or its key */
+static const unsigned char *get_master_blinding_key(const unsigned char *bytes, size_t bytes_len)
+{
+    if (!bytes)
+        return NULL;
+    if (bytes_len == HMAC_SHA512_LEN)
+        return bytes + HMAC_SHA512_LEN / 2;
+    return bytes_len == HMAC_SHA512_LEN / 2 ? bytes : NULL;
+}
+
+int wally_asset_blinding_key_ctx_init_alloc(const unsigned char *bytes, size_t bytes_len,
+                                            struct wally_hmac_sha256_ctx **output)
+{
+    const unsigned char *key = get_master_blinding_key(bytes, bytes_len);
+
+    if (output)
+        *output = NULL;
+    if (!key || !output)
+        return WALLY_EINVAL;
+    return wally_hmac_sha256_ctx_init_alloc(key, HMAC_SHA512_LEN / 2, output);
+}
+
+int wally_asset_blinding_key_ctx_to_ec_private_key(const struct wally_hmac_sha256_ctx *ctx,
+                                                   const unsigned char *script, size_t script_len,
+                                                   unsigned char *bytes_out, size_t len)
+{
+    if (!ctx || !script || !script_len || !bytes_out || len != EC_PRIVATE_KEY_LEN)
+        return WALLY_EINVAL;
+    return wally_hmac_sha256_ctx_compute(ctx, script, script_len, bytes_out, len);
+}
+
+int wally_asset_blinding_key_to_ec_private_key(const unsigned char *bytes, size_t bytes_len,
+                                               const unsigned char *script, size_t script_len,
+                                               unsigned char *bytes_out, size_t len)
+{
+    const unsigned char *key = get_master_blinding_key(bytes, bytes_len);
+
+    if (!key || !script || !script_len || !bytes_out || len != EC_PRIVATE_KEY_LEN)
+        return WALLY_EINVAL;
+    return wally_hmac_sha256(key, HMAC_SHA512_LEN / 2, script, script_len, bytes_out, len);
+}
+
+int wally_asset_blinding_key_to_ec_private_key_batch(const unsigned char *bytes,
+                                                     size_t bytes_len,
+                                                     const unsigned char *scripts,
+                                                     size_t scripts_len,
+                                                     size_t item_len,
+                                                     unsigned char *bytes_out,
+                                                     size_t len)
+{
+    const unsigned char *key = get_master_blinding_key(bytes, bytes_len);
+    struct wally_hmac_sha256_ctx ctx;
+    struct sha256 sha[BLINDING_KEY_BATCH];
+    size_t num_scripts, i;
+
+    if (!key || !scripts || !item_len || !scripts_len || scripts_len % item_len ||
+        !bytes_out)
+        return WALLY_EINVAL;
+    num_scripts = scripts_len / item_len;
+    if (len != num_scripts * EC_PRIVATE_KEY_LEN)
+        return WALLY_EINVAL;
+
+    /* Key the HMAC once, then hash the scripts several at a time */
+    hmac_sha256_ctx_init_impl(&ctx, key, HMAC_SHA512_LEN / 2);
+    for (i = 0; i < num_scripts; i += BLINDING_KEY_BATCH) {
+        const size_t n = num_scripts - i < BLINDING_KEY_BATCH ? num_scripts - i : BLINDING_KEY_BATCH;
+
+        hmac_sha256_ctx_batch_impl(&ctx, sha, scripts + i * item_len, item_len, n);
+        memcpy(bytes_out + i * EC_PRIVATE_KEY_LEN, sha, n * sizeof(sha[0]));
+    }
+    wally_clear_2(&ctx, sizeof(ctx), sha, sizeof(sha));
+    return WALLY_OK;
+}
+
+/* Parsed PAK (pegout authorization key) online and offline key lists */
+struct wally_asset_pak_keys {
+    size_t num_keys;
+    secp256k1_pubkey *online;
+    secp256k1_pubkey *offline;
+};
+
+/* Whitelist proofs verified by each task in a batch */
+#define PAK_VERIFY_BATCH_CHUNK 8
+
+/* The number of keys in the PAK key lists online_keys and offline_keys, or 0 if invalid.
+ * The proof encodes the number of keys in a byte, so at most 255 may be used */
+static size_t get_num_pak_keys(const unsigned char *online_keys, size_t online_keys_len,
+                               const unsigned char *offline_keys, size_t offline_keys_len)
+{
+    const size_t num_keys = online_keys_len / EC_PUBLIC_KEY_LEN;
+
+    if (!online_keys || !offline_keys || online_keys_len % EC_PUBLIC_KEY_LEN ||
+        offline_keys_len != online_keys_len || num_keys >= SECP256K1_WHITELIST_MAX_N_KEYS)
+        return 0;
+    return num_keys;
+}
+
+static bool parse_pak_keys(const secp256k1_context *ctx,
+                           const unsigned char *online_keys,
+                           const unsigned char *offline_keys,
+                           struct wally_asset_pak_keys *keys)
+{
+    size_t i;
+
+    for (i = 0; i < keys->num_keys; ++i)
+        if (!pubkey_parse(ctx, keys->online + i, online_keys + i * EC_PUBLIC_KEY_LEN,
+                          EC_PUBLIC_KEY_LEN) ||
+            !pubkey_parse(ctx, keys->offline + i, offline_keys + i * EC_PUBLIC_KEY_LEN,
+                          EC_PUBLIC_KEY_LEN))
+            return false;
+    return true;
+}
+
+static bool pak_whitelistproof_verify(const secp256k1_context *ctx,
+                                      const struct wally_asset_pak_keys *keys,
+                                      const unsigned char *sub_pubkey,
+                                      const unsigned char *proof, size_t proof_len)
+{
+    secp256k1_whitelist_signature sig;
+    secp256k1_pubkey sub;
+
+    return pubkey_parse(ctx, &sub, sub_pubkey, EC_PUBLIC_KEY_LEN) &&
+           secp256k1_whitelist_signature_parse(ctx, &sig, proof, proof_len) &&
+           secp256k1_whitelist_verify(ctx, &sig, keys->online, keys->offline,
+                                      keys->num_keys, &sub);
+}
+
+int wally_asset_pak_whitelistproof_size(size_t num_keys, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!num_keys || num_keys >= SECP256K1_WHITELIST_MAX_N_KEYS || !written)
+        return WALLY_EINVAL;
+    *written = 1 + 32 * (num_keys + 1);
+    return WALLY_OK;
+}
+
+int wally_asset_pak_whitelistproof(const unsigned char *online_keys, size_t online_keys_len,
+                                   const unsigned char *offline_keys, size_t offline_keys_len,
+                                   size_t key_index,
+                                   const unsigned char *sub_pubkey, size_t sub_pubkey_len,
+                                   const unsigned char *online_priv_key,
+                                   size_t online_priv_key_len,
+                                   const unsigned char *summed_key, size_t summed_key_len,
+                                   unsigned char *bytes_out, size_t len, size_t *written)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    const size_t num_keys = get_num_pak_keys(online_keys, online_keys_len,
+                                             offline_keys, offline_keys_len);
+    struct wally_asset_pak_keys keys;
+    secp256k1_whitelist_signature sig;
+    secp256k1_pubkey sub;
+    const size_t pubs_size = num_keys * sizeof(secp256k1_pubkey);
+    size_t proof_len;
+    int ret = WALLY_EINVAL;
+
+    if (written)
+        *written = 0;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!num_keys || key_index >= num_keys ||
+        !sub_pubkey || sub_pubkey_len != EC_PUBLIC_KEY_LEN ||
+        !online_priv_key || online_priv_key_len != EC_PRIVATE_KEY_LEN ||
+        !summed_key || summed_key_len != EC_PRIVATE_KEY_LEN ||
+        !bytes_out || !written ||
+        wally_asset_pak_whitelistproof_size(num_keys, &proof_len) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    if (len < proof_len) {
+        *written = proof_len; /* Tell the caller the required size */
+        return WALLY_OK;
+    }
+
+    keys.num_keys = num_keys;
+    if (!(keys.online = wally_scratch_alloc(2 * pubs_size)))
+        return WALLY_ENOMEM;
+    keys.offline = keys.online + num_keys;
+
+    if (parse_pak_keys(ctx, online_keys, offline_keys, &keys) &&
+        pubkey_parse(ctx, &sub, sub_pubkey, sub_pubkey_len) &&
+        secp256k1_whitelist_sign(ctx, &sig, keys.online, keys.offline, num_keys, &sub,
+                                 online_priv_key, summed_key, key_index, NULL, NULL) &&
+        secp256k1_whitelist_verify(ctx, &sig, keys.online, keys.offline, num_keys, &sub) &&
+        secp256k1_whitelist_signature_serialize(ctx, bytes_out, &proof_len, &sig)) {
+        *written = proof_len;
+        ret = WALLY_OK;
+    }
+
+    wally_clear(&sig, sizeof(sig));
+    wally_scratch_free(keys.online, 2 * pubs_size);
+    return ret;
+}
+
+int wally_asset_pak_keys_init_alloc(const unsigned char *online_keys, size_t online_keys_len,
+                                    const unsigned char *offline_keys, size_t offline_keys_len,
+                                    struct wally_asset_pak_keys **output)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    const size_t num_keys = get_num_pak_keys(online_keys, online_keys_len,
+                                             offline_keys, offline_keys_len);
+    struct wally_asset_pak_keys *keys;
+
+    if (output)
+        *output = NULL;
+
+    if (!num_keys || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!(keys = wally_malloc(sizeof(*keys))))
+        return WALLY_ENOMEM;
+    keys->num_keys = num_keys;
+    if (!(keys->online = wally_malloc(2 * num_keys * sizeof(secp256k1_pubkey)))) {
+        wally_free(keys);
+        return WALLY_ENOMEM;
+    }
+    keys->offline = keys->online + num_keys;
+
+    if (!parse_pak_keys(ctx, online_keys, offline_keys, keys)) {
+        wally_asset_pak_keys_free(keys);
+        return WALLY_EINVAL;
+    }
+    *output = keys;
+    return WALLY_OK;
+}
+
+int wally_asset_pak_keys_free(struct wally_asset_pak_keys *keys)
+{
+    if (!keys)
+        return WALLY_EINVAL;
+    wally_free(keys->online); /* The offline keys share the allocation */
+    wally_clear(keys, sizeof(*keys));
+    wally_free(keys);
+    return WALLY_OK;
+}
+
+int wally_asset_pak_whitelistproof_verify(const unsigned char *online_keys,
+                                          size_t online_keys_len,
+                                          const unsigned char *offline_keys,
+                                          size_t offline_keys_len,
+                                          const unsigned char *sub_pubkey,
+                                          size_t sub_pubkey_len,
+                                          const unsigned char *proof, size_t proof_len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    const size_t num_keys = get_num_pak_keys(online_keys, online_keys_len,
+                                             offline_keys, offline_keys_len);
+    const size_t pubs_size = num_keys * sizeof(secp256k1_pubkey);
+    struct wally_asset_pak_keys keys;
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!num_keys || !sub_pubkey || sub_pubkey_len != EC_PUBLIC_KEY_LEN ||
+        !proof || !proof_len)
+        return WALLY_EINVAL;
+
+    keys.num_keys = num_keys;
+    if (!(keys.online = wally_scratch_alloc(2 * pubs_size)))
+        return WALLY_ENOMEM;
+    keys.offline = keys.online + num_keys;
+
+    ok = parse_pak_keys(ctx, online_keys, offline_keys, &keys) &&
+         pak_whitelistproof_verify(ctx, &keys, sub_pubkey, proof, proof_len);
+
+    wally_scratch_free(keys.online, 2 * pubs_size);
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_asset_pak_whitelistproof_verify_parsed(const struct wally_asset_pak_keys *keys,
+                                                 const unsigned char *sub_pubkey,
+                                                 size_t sub_pubkey_len,
+                                                 const unsigned char *proof, size_t proof_len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!keys || !sub_pubkey || sub_pubkey_len != EC_PUBLIC_KEY_LEN || !proof || !proof_len)
+        return WALLY_EINVAL;
+
+    return pak_whitelistproof_verify(ctx, keys, sub_pubkey,
+                                     proof, proof_len) ? WALLY_OK : WALLY_EINVAL;
+}
+
+/* The inputs and results for verifying a batch of whitelist proofs as tasks */
+struct pak_verify_tasks {
+    const secp256k1_context *ctx;
+    const struct wally_asset_pak_keys *keys;
+    const unsigned char *sub_pubkeys;
+    const unsigned char *proofs;
+    size_t proof_len;
+    size_t num_proofs;
+    unsigned char *results;
+};
+
+static void pak_verify_task(void *task_ctx, size_t index)
+{
+    struct pak_verify_tasks *t = task_ctx;
+    const size_t start = index * PAK_VERIFY_BATCH_CHUNK;
+    size_t i, end = start + PAK_VERIFY_BATCH_CHUNK;
+
+    if (end > t->num_proofs)
+        end = t->num_proofs;
+
+    for (i = start; i < end; ++i)
+        t->results[i] = pak_whitelistproof_verify(t->ctx, t->keys,
+                                                  t->sub_pubkeys + i * EC_PUBLIC_KEY_LEN,
+                                                  t->proofs + i * t->proof_len, t->proof_len);
+}
+
+int wally_asset_pak_whitelistproof_verify_batch(const struct wally_asset_pak_keys *keys,
+                                                const unsigned char *sub_pubkeys,
+                                                size_t sub_pubkeys_len,
+                                                const unsigned char *proofs,
+                                                size_t proofs_len,
+                                                wally_run_tasks_t run_fn, void *run_ctx,
+                                                unsigned char *bytes_out, size_t len)
+{
+    struct pak_verify_tasks tasks;
+    const size_t num_tasks = (len + PAK_VERIFY_BATCH_CHUNK - 1) / PAK_VERIFY_BATCH_CHUNK;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!keys || wally_asset_pak_whitelistproof_size(keys->num_keys,
+                                                     &tasks.proof_len) != WALLY_OK ||
+        !sub_pubkeys || sub_pubkeys_len / EC_PUBLIC_KEY_LEN != len ||
+        sub_pubkeys_len % EC_PUBLIC_KEY_LEN ||
+        !proofs || proofs_len / tasks.proof_len != len || proofs_len % tasks.proof_len ||
+        !bytes_out || !len)
+        return WALLY_EINVAL;
+
+    /* Fetch the context once so every task uses the callers context */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    tasks.keys = keys;
+    tasks.sub_pubkeys = sub_pubkeys;
+    tasks.proofs = proofs;
+    tasks.num_proofs = len;
+    tasks.results = bytes_out;
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, pak_verify_task, &tasks);
+
+    for (i = 0; i < len; ++i)
+        if (!bytes_out[i])
+            ret = WALLY_EINVAL;
     return ret;
 }
@@ -0,0 +1,131 @@
+#include "internal.h"
+
+#include "hash_table.h"
+#include "siphash.h"
+
+#define HASH_TABLE_MIN_ENTRIES 16u
+
+void hash_table_init(struct hash_table *table)
+{
+    wally_clear(table, sizeof(*table));
+    hash_table_key(table, table->key);
+}
+
+void hash_table_free(struct hash_table *table)
+{
+    clear_and_free(table->entries, table->num_entries * sizeof(*table->entries));
+    table->entries = NULL;
+    table->num_entries = 0;
+    table->num_items = 0;
+}
+
+uint64_t hash_table_hash(const struct hash_table *table,
+                         const void *bytes, size_t bytes_len)
+{
+    return siphash24_impl(table->key[0], table->key[1], bytes, bytes_len);
+}
+
+static int hash_table_resize(struct hash_table *table, size_t num_entries)
+{
+    const size_t mask = num_entries - 1;
+    struct hash_table_entry *entries, *old = table->entries;
+    size_t i, j;
+
+    if (num_entries > SIZE_MAX / sizeof(*entries) ||
+        !(entries = wally_malloc(num_entries * sizeof(*entries))))
+        return WALLY_ENOMEM;
+    wally_clear(entries, num_entries * sizeof(*entries));
+
+    for (i = 0; i < table->num_entries; ++i) {
+        if (old[i].item) {
+            for (j = old[i].hash & mask; entries[j].item; j = (j + 1) & mask)
+                ; /* Find an empty slot */
+            entries[j] = old[i];
+        }
+    }
+    clear_and_free(old, table->num_entries * sizeof(*old));
+    table->entries = entries;
+    table->num_entries = num_entries;
+    return WALLY_OK;
+}
+
+int hash_table_reserve(struct hash_table *table, size_t num_items)
+{
+    size_t num_entries = table->num_entries ? table->num_entries : HASH_TABLE_MIN_ENTRIES;
+
+    if (num_items > SIZE_MAX / 4 - table->num_items)
+        return WALLY_ENOMEM;
+    /* Keep the table at most half full, so that probes are short */
+    while ((table->num_items + num_items) * 2 > num_entries)
+        num_entries *= 2;
+    if (num_entries != table->num_entries)
+        return hash_table_resize(table, num_entries);
+    return WALLY_OK;
+}
+
+void hash_table_clear(struct hash_table *table)
+{
+    if (table->entries)
+        wally_clear(table->entries, table->num_entries * sizeof(*table->entries));
+    table->num_items = 0;
+}
+
+struct hash_table_entry *hash_table_find(const struct hash_table *table,
+                                         uint64_t hash,
+                                         hash_table_match_t match_fn,
+                                         const void *ctx, const void *key)
+{
+    const size_t mask = table->num_entries - 1;
+    size_t i = hash & mask;
+
+    /* The table is never more than half full, so an empty slot is found */
+    for (;;) {
+        struct hash_table_entry *entry = table->entries + i;
+        if (!entry->item || (entry->hash == hash && match_fn(ctx, entry, key)))
+            return entry;
+        i = (i + 1) & mask;
+    }
+}
+
+struct hash_table_entry *hash_table_lookup(const struct hash_table *table,
+                                           uint64_t hash,
+                                           hash_table_match_t match_fn,
+                                           const void *ctx, const void *key)
+{
+    struct hash_table_entry *entry;
+
+    if (!table->num_items)
+        return NULL;
+    entry = hash_table_find(table, hash, match_fn, ctx, key);
+    return entry->item ? entry : NULL;
+}
+
+void hash_table_insert(struct hash_table *table, struct hash_table_entry *entry,
+                       uint64_t hash, size_t item, size_t extra)
+{
+    entry->hash = hash;
+    entry->item = item;
+    entry->extra = extra;
+    table->num_items += 1;
+}
+
+void hash_table_delete(struct hash_table *table, struct hash_table_entry *entry)
+{
+    const size_t mask = table->num_entries - 1;
+    size_t i = entry - table->entries, j = i, k;
+
+    for (;;) {
+        table->entries[i].item = 0;
+        do {
+            j = (j + 1) & mask;
+            if (!table->entries[j].item) {
+                table->num_items -= 1;
+                return;
+            }
+            k = table->entries[j].hash & mask;
+            /* Stop at an entry whose home slot is not cyclically in (i, j] */
+        } while (i <= j ? (i < k && k <= j) : (i < k || k <= j));
+        table->entries[i] = table->entries[j];
+        i = j;
+    }
+}
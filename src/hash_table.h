@@ -0,0 +1,75 @@
+#ifndef LIBWALLY_CORE_HASH_TABLE_H
+#define LIBWALLY_CORE_HASH_TABLE_H 1
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A slot in a hash table. item is 0 for an empty slot; otherwise item and
+ * extra are set by the caller, typically to an index plus 1 and a length */
+struct hash_table_entry {
+    uint64_t hash;
+    size_t item;
+    size_t extra;
+};
+
+/* An open addressing hash table with linear probing. Keys are stored by
+ * the caller, and are hashed with siphash under a per-table random key
+ * so that keys colliding in the table cannot be chosen in advance */
+struct hash_table {
+    struct hash_table_entry *entries;
+    size_t num_entries; /* The hash table size, a power of 2, or 0 */
+    size_t num_items;
+    uint64_t key[2];
+};
+
+/* Compare the key of entry with the key being looked up */
+typedef bool (*hash_table_match_t)(const void *ctx,
+                                   const struct hash_table_entry *entry,
+                                   const void *key);
+
+/* NOTE: These internal functions do no parameter checking */
+
+/* Initialize an empty table, which allocates no entries until reserved */
+void hash_table_init(struct hash_table *table);
+
+/* Free the entries of a table */
+void hash_table_free(struct hash_table *table);
+
+/* Hash a key for lookup in or insertion into a table */
+uint64_t hash_table_hash(const struct hash_table *table,
+                         const void *bytes, size_t bytes_len);
+
+/* Ensure that num_items more items can be inserted into a table */
+int hash_table_reserve(struct hash_table *table, size_t num_items);
+
+/* Remove all items from a table, keeping its entries allocated */
+void hash_table_clear(struct hash_table *table);
+
+/* Find the slot holding a key, or the empty slot to insert it into. The
+ * table must have had entries reserved */
+struct hash_table_entry *hash_table_find(const struct hash_table *table,
+                                         uint64_t hash,
+                                         hash_table_match_t match_fn,
+                                         const void *ctx, const void *key);
+
+/* Find a key, returning its entry or NULL if it is not present */
+struct hash_table_entry *hash_table_lookup(const struct hash_table *table,
+                                           uint64_t hash,
+                                           hash_table_match_t match_fn,
+                                           const void *ctx, const void *key);
+
+/* Insert an item into the empty slot entry returned by hash_table_find */
+void hash_table_insert(struct hash_table *table, struct hash_table_entry *entry,
+                       uint64_t hash, size_t item, size_t extra);
+
+/* Remove an entry, moving following entries back to fill its slot */
+void hash_table_delete(struct hash_table *table, struct hash_table_entry *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBWALLY_CORE_HASH_TABLE_H */
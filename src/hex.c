@@ -1,5 +1,172 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <tmmintrin.h>
+#define HAVE_HEX_SSSE3 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+/* SIMD128 is enabled at compile time, so is always used */
+#define HAVE_HEX_SIMD128 1
+#endif
+
 #include "internal.h"
 #include "ccan/ccan/str/hex/hex.h"
+#include <stdbool.h>
+
+#ifdef HAVE_HEX_SSSE3
+static int use_ssse3 = 0;
+
+/* Encode 16 bytes at a time, returning the number of bytes encoded */
+__attribute__((target("ssse3")))
+static size_t hex_encode_ssse3(const unsigned char *bytes, size_t bytes_len,
+                               char *out)
+{
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                      '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    size_t i;
+
+    for (i = 0; i + 16 <= bytes_len; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(bytes + i));
+        const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+        _mm_storeu_si128((__m128i *)(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+/* Convert 16 hex characters to nibbles, setting *valid to false on error */
+__attribute__((target("ssse3")))
+static __m128i hex_nibbles_ssse3(const __m128i v, bool *valid)
+{
+    const __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    const __m128i alpha = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)),
+                                       _mm_set1_epi8('a'));
+    const __m128i zero = _mm_setzero_si128();
+    /* Unsigned x <= n is equivalent to saturating x - n == 0 */
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero);
+    const __m128i is_alpha = _mm_cmpeq_epi8(_mm_subs_epu8(alpha, _mm_set1_epi8(5)), zero);
+
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xffff)
+        *valid = false;
+    return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                        _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+/* Decode 32 hex characters at a time, returning false if any are invalid */
+__attribute__((target("ssse3")))
+static bool hex_decode_ssse3(const char *hex, size_t hex_len,
+                             unsigned char *bytes_out, size_t *written)
+{
+    /* Multiply the high nibble of each pair by 16 and add the low nibble */
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    bool valid = true;
+    size_t i;
+
+    for (i = 0; i + 32 <= hex_len && valid; i += 32) {
+        const __m128i a = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i *)(hex + i)), &valid);
+        const __m128i b = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i *)(hex + i + 16)), &valid);
+        _mm_storeu_si128((__m128i *)(bytes_out + i / 2),
+                         _mm_packus_epi16(_mm_maddubs_epi16(a, weights),
+                                          _mm_maddubs_epi16(b, weights)));
+    }
+    *written = i / 2;
+    return valid;
+}
+#endif
+
+#ifdef HAVE_HEX_SIMD128
+/* Encode 16 bytes at a time, returning the number of bytes encoded */
+static size_t hex_encode_simd128(const unsigned char *bytes, size_t bytes_len,
+                                 char *out)
+{
+    const v128_t lut = wasm_i8x16_make('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const v128_t mask = wasm_i8x16_splat(0x0f);
+    size_t i;
+
+    for (i = 0; i + 16 <= bytes_len; i += 16) {
+        const v128_t v = wasm_v128_load(bytes + i);
+        const v128_t hi = wasm_i8x16_swizzle(lut, wasm_u8x16_shr(v, 4));
+        const v128_t lo = wasm_i8x16_swizzle(lut, wasm_v128_and(v, mask));
+        wasm_v128_store(out + i * 2, wasm_i8x16_shuffle(hi, lo, 0, 16, 1, 17, 2, 18, 3, 19,
+                                                        4, 20, 5, 21, 6, 22, 7, 23));
+        wasm_v128_store(out + i * 2 + 16, wasm_i8x16_shuffle(hi, lo, 8, 24, 9, 25, 10, 26, 11, 27,
+                                                             12, 28, 13, 29, 14, 30, 15, 31));
+    }
+    return i;
+}
+
+/* Convert 16 hex characters to nibbles, setting *valid to false on error */
+static v128_t hex_nibbles_simd128(const v128_t v, bool *valid)
+{
+    const v128_t digit = wasm_i8x16_sub(v, wasm_i8x16_splat('0'));
+    const v128_t alpha = wasm_i8x16_sub(wasm_v128_or(v, wasm_i8x16_splat(0x20)),
+                                        wasm_i8x16_splat('a'));
+    const v128_t zero = wasm_i8x16_splat(0);
+    /* Unsigned x <= n is equivalent to saturating x - n == 0 */
+    const v128_t is_digit = wasm_i8x16_eq(wasm_u8x16_sub_sat(digit, wasm_i8x16_splat(9)), zero);
+    const v128_t is_alpha = wasm_i8x16_eq(wasm_u8x16_sub_sat(alpha, wasm_i8x16_splat(5)), zero);
+
+    if (!wasm_i8x16_all_true(wasm_v128_or(is_digit, is_alpha)))
+        *valid = false;
+    return wasm_v128_or(wasm_v128_and(is_digit, digit),
+                        wasm_v128_and(is_alpha, wasm_i8x16_add(alpha, wasm_i8x16_splat(10))));
+}
+
+/* Decode 32 hex characters at a time, returning false if any are invalid */
+static bool hex_decode_simd128(const char *hex, size_t hex_len,
+                               unsigned char *bytes_out, size_t *written)
+{
+    bool valid = true;
+    size_t i;
+
+    for (i = 0; i + 32 <= hex_len && valid; i += 32) {
+        const v128_t a = hex_nibbles_simd128(wasm_v128_load(hex + i), &valid);
+        const v128_t b = hex_nibbles_simd128(wasm_v128_load(hex + i + 16), &valid);
+        /* Combine the high nibble of each pair with the low nibble */
+        const v128_t hi = wasm_i8x16_shuffle(a, b, 0, 2, 4, 6, 8, 10, 12, 14,
+                                             16, 18, 20, 22, 24, 26, 28, 30);
+        const v128_t lo = wasm_i8x16_shuffle(a, b, 1, 3, 5, 7, 9, 11, 13, 15,
+                                             17, 19, 21, 23, 25, 27, 29, 31);
+        wasm_v128_store(bytes_out + i / 2, wasm_v128_or(wasm_i8x16_shl(hi, 4), lo));
+    }
+    *written = i / 2;
+    return valid;
+}
+#endif
+
+uint32_t hex_optimize(uint32_t cpu_features)
+{
+#ifdef HAVE_HEX_SSSE3
+    if (cpu_features & WALLY_CPU_HEX_SSSE3) {
+        use_ssse3 = 1; /* SSSE3 is available */
+        return WALLY_CPU_HEX_SSSE3;
+    }
+#endif
+    (void)cpu_features;
+#ifdef HAVE_HEX_SIMD128
+    return WALLY_CPU_HEX_SIMD128;
+#else
+    return 0;
+#endif
+}
+
+static void hex_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                           char *output)
+{
+    size_t done = 0;
+
+#if defined(HAVE_HEX_SSSE3)
+    if (use_ssse3)
+        done = hex_encode_ssse3(bytes, bytes_len, output);
+#elif defined(HAVE_HEX_SIMD128)
+    done = hex_encode_simd128(bytes, bytes_len, output);
+#endif
+    /* Note we ignore the return value as this call cannot fail */
+    hex_encode(bytes + done, bytes_len - done, output + done * 2,
+               hex_str_size(bytes_len - done));
+}
 
 int wally_hex_from_bytes(const unsigned char *bytes, size_t bytes_len,
                          char **output)
@@ -14,15 +181,29 @@ int wally_hex_from_bytes(const unsigned char *bytes, size_t bytes_len,
     if (!*output)
         return WALLY_ENOMEM;
 
-    /* Note we ignore the return value as this call cannot fail */
-    hex_encode(bytes, bytes_len, *output, hex_str_size(bytes_len));
+    hex_from_bytes(bytes, bytes_len, *output);
+    return WALLY_OK;
+}
+
+int wally_hex_from_bytes_to_buffer(const unsigned char *bytes, size_t bytes_len,
+                                   char *output, size_t len, size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!bytes || !output || !written)
+        return WALLY_EINVAL;
+
+    *written = hex_str_size(bytes_len);
+    if (len >= *written)
+        hex_from_bytes(bytes, bytes_len, output);
     return WALLY_OK;
 }
 
 int wally_hex_to_bytes(const char *hex,
                        unsigned char *bytes_out, size_t len, size_t *written)
 {
-    size_t bytes_len = hex ? strlen(hex) : 0;
+    size_t bytes_len = hex ? strlen(hex) : 0, done = 0;
 
     if (written)
         *written = 0;
@@ -37,7 +218,14 @@ int wally_hex_to_bytes(const char *hex,
     }
 
     len = bytes_len / 2; /* hex_decode expects exact length */
-    if (!hex_decode(hex, bytes_len, bytes_out, len))
+#if defined(HAVE_HEX_SSSE3)
+    if (use_ssse3 && !hex_decode_ssse3(hex, bytes_len, bytes_out, &done))
+        return WALLY_EINVAL;
+#elif defined(HAVE_HEX_SIMD128)
+    if (!hex_decode_simd128(hex, bytes_len, bytes_out, &done))
+        return WALLY_EINVAL;
+#endif
+    if (!hex_decode(hex + done * 2, bytes_len - done * 2, bytes_out + done, len - done))
         return WALLY_EINVAL;
 
     if (written)
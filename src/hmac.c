@@ -11,8 +11,15 @@
 #define SHA_T sha256
 #define SHA_CTX_MEMBER u32
 #define SHA_PRE(name) sha256 ## name
+#define HMAC_CTX_T wally_hmac_sha256_ctx
 #define HMAC_FUNCTION hmac_sha256_impl
+#define HMAC_CTX_INIT_FUNCTION hmac_sha256_ctx_init_impl
+#define HMAC_CTX_FUNCTION hmac_sha256_ctx_impl
+#define HMAC_CTX_BATCH_FUNCTION hmac_sha256_ctx_batch_impl
 #define WALLY_HMAC_FUNCTION wally_hmac_sha256
+#define WALLY_HMAC_CTX_INIT_FUNCTION wally_hmac_sha256_ctx_init_alloc
+#define WALLY_HMAC_CTX_FUNCTION wally_hmac_sha256_ctx_compute
+#define WALLY_HMAC_CTX_FREE_FUNCTION wally_hmac_sha256_ctx_free
 #include "hmac.inl"
 
 #undef SHA_T
@@ -21,8 +28,22 @@
 #define SHA_CTX_MEMBER u64
 #undef SHA_PRE
 #define SHA_PRE(name) sha512 ## name
+#undef HMAC_CTX_T
+#define HMAC_CTX_T wally_hmac_sha512_ctx
 #undef HMAC_FUNCTION
 #define HMAC_FUNCTION hmac_sha512_impl
+#undef HMAC_CTX_INIT_FUNCTION
+#define HMAC_CTX_INIT_FUNCTION hmac_sha512_ctx_init_impl
+#undef HMAC_CTX_FUNCTION
+#define HMAC_CTX_FUNCTION hmac_sha512_ctx_impl
+#undef HMAC_CTX_BATCH_FUNCTION
+#define HMAC_CTX_BATCH_FUNCTION hmac_sha512_ctx_batch_impl
 #undef WALLY_HMAC_FUNCTION
 #define WALLY_HMAC_FUNCTION wally_hmac_sha512
+#undef WALLY_HMAC_CTX_INIT_FUNCTION
+#define WALLY_HMAC_CTX_INIT_FUNCTION wally_hmac_sha512_ctx_init_alloc
+#undef WALLY_HMAC_CTX_FUNCTION
+#define WALLY_HMAC_CTX_FUNCTION wally_hmac_sha512_ctx_compute
+#undef WALLY_HMAC_CTX_FREE_FUNCTION
+#define WALLY_HMAC_CTX_FREE_FUNCTION wally_hmac_sha512_ctx_free
 #include "hmac.inl"
@@ -1,8 +1,8 @@
 #ifndef LIBWALLY_HMAC_H
 #define LIBWALLY_HMAC_H
 
-struct sha256;
-struct sha512;
+#include <ccan/ccan/crypto/sha256/sha256.h>
+#include <ccan/ccan/crypto/sha512/sha512.h>
 
 /**
  * hmac_sha256 - Compute an HMAC using SHA-256
@@ -30,4 +30,131 @@ void hmac_sha512_impl(struct sha512 *sha,
                       const unsigned char *key, size_t key_len,
                       const unsigned char *msg, size_t msg_len);
 
+/* A precomputed HMAC key: the midstates after hashing the padded keys */
+struct wally_hmac_sha256_ctx {
+    struct sha256_ctx inner;
+    struct sha256_ctx outer;
+};
+
+struct wally_hmac_sha512_ctx {
+    struct sha512_ctx inner;
+    struct sha512_ctx outer;
+};
+
+/**
+ * hmac_sha256_ctx_init - Precompute an HMAC-SHA-256 key
+ *
+ * @ctx: Destination for the key context.
+ * @key: The key for the hash
+ * @key_len: The length of @key in bytes.
+ */
+void hmac_sha256_ctx_init_impl(struct wally_hmac_sha256_ctx *ctx,
+                               const unsigned char *key, size_t key_len);
+
+/**
+ * hmac_sha256_ctx - Compute an HMAC using SHA-256 and a precomputed key
+ *
+ * @ctx: The key context.
+ * @sha: Destination for the resulting HMAC.
+ * @msg: The message to hash
+ * @msg_len: The length of @msg in bytes.
+ */
+void hmac_sha256_ctx_impl(const struct wally_hmac_sha256_ctx *ctx,
+                          struct sha256 *sha,
+                          const unsigned char *msg, size_t msg_len);
+
+/**
+ * hmac_sha256_ctx_batch - Compute HMACs of several messages using SHA-256
+ *
+ * @ctx: The key context.
+ * @sha: Destination for the @n resulting HMACs.
+ * @msgs: The @n messages to hash, stored contiguously.
+ * @msg_len: The length of each message in bytes.
+ * @n: The number of messages.
+ */
+void hmac_sha256_ctx_batch_impl(const struct wally_hmac_sha256_ctx *ctx,
+                                struct sha256 *sha,
+                                const unsigned char *msgs, size_t msg_len,
+                                size_t n);
+
+/**
+ * hmac_sha512_ctx_init - Precompute an HMAC-SHA-512 key
+ *
+ * @ctx: Destination for the key context.
+ * @key: The key for the hash
+ * @key_len: The length of @key in bytes.
+ */
+void hmac_sha512_ctx_init_impl(struct wally_hmac_sha512_ctx *ctx,
+                               const unsigned char *key, size_t key_len);
+
+/**
+ * hmac_sha512_ctx - Compute an HMAC using SHA-512 and a precomputed key
+ *
+ * @ctx: The key context.
+ * @sha: Destination for the resulting HMAC.
+ * @msg: The message to hash
+ * @msg_len: The length of @msg in bytes.
+ */
+void hmac_sha512_ctx_impl(const struct wally_hmac_sha512_ctx *ctx,
+                          struct sha512 *sha,
+                          const unsigned char *msg, size_t msg_len);
+
+/**
+ * hmac_sha512_ctx_batch - Compute HMACs of several messages using SHA-512
+ *
+ * @ctx: The key context.
+ * @sha: Destination for the @n resulting HMACs.
+ * @msgs: The @n messages to hash, stored contiguously.
+ * @msg_len: The length of each message in bytes.
+ * @n: The number of messages.
+ */
+void hmac_sha512_ctx_batch_impl(const struct wally_hmac_sha512_ctx *ctx,
+                                struct sha512 *sha,
+                                const unsigned char *msgs, size_t msg_len,
+                                size_t n);
+
+/**
+ * pbkdf2_hmac_sha256_batch - Compute several PBKDF2-HMAC-SHA-256 keys at once
+ *
+ * @passes: The @n passwords.
+ * @pass_lens: The length of each password in bytes.
+ * @salts: The @n salts.
+ * @salt_lens: The length of each salt in bytes.
+ * @n: The number of keys to compute.
+ * @cost: The number of iterations, as for `wally_pbkdf2_hmac_sha256`.
+ * @bytes_out: Destination for the @n keys, each of @len bytes.
+ * @len: The length of each key. Must be a multiple of PBKDF2_HMAC_SHA256_LEN.
+ *
+ * The iterations of all keys run in lockstep so that the hashing can be
+ * spread across SIMD lanes where the CPU supports it.
+ */
+int pbkdf2_hmac_sha256_batch_impl(const unsigned char *const *passes,
+                                 const size_t *pass_lens,
+                                 const unsigned char *const *salts,
+                                 const size_t *salt_lens, size_t n,
+                                 uint32_t cost, unsigned char *bytes_out,
+                                 size_t len);
+
+/**
+ * pbkdf2_hmac_sha512_batch - Compute several PBKDF2-HMAC-SHA-512 keys at once
+ *
+ * @passes: The @n passwords.
+ * @pass_lens: The length of each password in bytes.
+ * @salts: The @n salts.
+ * @salt_lens: The length of each salt in bytes.
+ * @n: The number of keys to compute.
+ * @cost: The number of iterations, as for `wally_pbkdf2_hmac_sha512`.
+ * @bytes_out: Destination for the @n keys, each of @len bytes.
+ * @len: The length of each key. Must be a multiple of PBKDF2_HMAC_SHA512_LEN.
+ *
+ * The iterations of all keys run in lockstep so that the hashing can be
+ * spread across SIMD lanes where the CPU supports it.
+ */
+int pbkdf2_hmac_sha512_batch_impl(const unsigned char *const *passes,
+                                 const size_t *pass_lens,
+                                 const unsigned char *const *salts,
+                                 const size_t *salt_lens, size_t n,
+                                 uint32_t cost, unsigned char *bytes_out,
+                                 size_t len);
+
 #endif /* LIBWALLY_HMAC_H */
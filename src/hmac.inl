@@ -19,13 +19,11 @@ static void SHA_PRE(_mix)(struct SHA_T *sha, const unsigned char *pad,
     wally_clear(&ctx, sizeof(ctx));
 }
 
-void HMAC_FUNCTION(struct SHA_T *sha,
-                   const unsigned char *key, size_t key_len,
-                   const unsigned char *msg, size_t msg_len)
+/* Compute the inner and outer padded keys */
+static void SHA_PRE(_hmac_pads)(const unsigned char *key, size_t key_len,
+                                unsigned char *ipad, unsigned char *opad)
 {
     struct SHA_PRE(_ctx) ctx;
-    unsigned char ipad[sizeof(ctx.buf)];
-    unsigned char opad[sizeof(ctx.buf)];
     size_t i;
 
     wally_clear(ctx.buf.u8, sizeof(ctx.buf));
@@ -39,7 +37,54 @@ void HMAC_FUNCTION(struct SHA_T *sha,
         opad[i] = ctx.buf.u8[i] ^ 0x5c;
         ipad[i] = ctx.buf.u8[i] ^ 0x36;
     }
+    wally_clear(&ctx, sizeof(ctx));
+}
 
+void HMAC_CTX_INIT_FUNCTION(struct HMAC_CTX_T *ctx,
+                            const unsigned char *key, size_t key_len)
+{
+    unsigned char ipad[sizeof(ctx->inner.buf)];
+    unsigned char opad[sizeof(ctx->outer.buf)];
+
+    SHA_PRE(_hmac_pads)(key, key_len, ipad, opad);
+    SHA_PRE(_init)(&ctx->inner);
+    SHA_PRE(_update)(&ctx->inner, ipad, sizeof(ipad));
+    SHA_PRE(_init)(&ctx->outer);
+    SHA_PRE(_update)(&ctx->outer, opad, sizeof(opad));
+    wally_clear_2(ipad, sizeof(ipad), opad, sizeof(opad));
+}
+
+void HMAC_CTX_FUNCTION(const struct HMAC_CTX_T *ctx, struct SHA_T *sha,
+                       const unsigned char *msg, size_t msg_len)
+{
+    struct SHA_PRE(_ctx) tmp = ctx->inner;
+    struct SHA_T inner;
+
+    SHA_PRE(_update)(&tmp, msg, msg_len);
+    SHA_PRE(_done)(&tmp, &inner);
+    tmp = ctx->outer;
+    SHA_PRE(_update)(&tmp, &inner, sizeof(inner));
+    SHA_PRE(_done)(&tmp, sha);
+    wally_clear_2(&tmp, sizeof(tmp), &inner, sizeof(inner));
+}
+
+void HMAC_CTX_BATCH_FUNCTION(const struct HMAC_CTX_T *ctx, struct SHA_T *sha,
+                             const unsigned char *msgs, size_t msg_len, size_t n)
+{
+    /* Compute the inner hashes, then hash them in place into the results */
+    SHA_PRE(_batch_from)(sha, &ctx->inner, msgs, msg_len, n);
+    SHA_PRE(_batch_from)(sha, &ctx->outer, sha, sizeof(*sha), n);
+}
+
+void HMAC_FUNCTION(struct SHA_T *sha,
+                   const unsigned char *key, size_t key_len,
+                   const unsigned char *msg, size_t msg_len)
+{
+    struct SHA_PRE(_ctx) ctx;
+    unsigned char ipad[sizeof(ctx.buf)];
+    unsigned char opad[sizeof(ctx.buf)];
+
+    SHA_PRE(_hmac_pads)(key, key_len, ipad, opad);
     SHA_PRE(_mix)((struct SHA_T *)ctx.buf.SHA_CTX_MEMBER, ipad, msg, msg_len);
     SHA_PRE(_mix)(sha, opad, ctx.buf.u8, sizeof(*sha));
     wally_clear_3(&ctx, sizeof(ctx), ipad, sizeof(ipad), opad, sizeof(opad));
@@ -64,3 +109,47 @@ int WALLY_HMAC_FUNCTION(const unsigned char *key, size_t key_len,
     }
     return WALLY_OK;
 }
+
+int WALLY_HMAC_CTX_INIT_FUNCTION(const unsigned char *key, size_t key_len,
+                                 struct HMAC_CTX_T **output)
+{
+    if (output)
+        *output = NULL;
+
+    if (!key || !key_len || !output)
+        return WALLY_EINVAL;
+
+    if (!(*output = wally_malloc(sizeof(**output))))
+        return WALLY_ENOMEM;
+    HMAC_CTX_INIT_FUNCTION(*output, key, key_len);
+    return WALLY_OK;
+}
+
+int WALLY_HMAC_CTX_FUNCTION(const struct HMAC_CTX_T *ctx,
+                            const unsigned char *bytes, size_t bytes_len,
+                            unsigned char *bytes_out, size_t len)
+{
+    struct SHA_T sha;
+    bool aligned = alignment_ok(bytes_out, sizeof(sha.u.SHA_CTX_MEMBER));
+    struct SHA_T *sha_p = aligned ? (struct SHA_T *)bytes_out : &sha;
+
+    if (!ctx || !bytes || !bytes_len ||
+        !bytes_out || len != sizeof(struct SHA_T))
+        return WALLY_EINVAL;
+
+    HMAC_CTX_FUNCTION(ctx, sha_p, bytes, bytes_len);
+    if (!aligned) {
+        memcpy(bytes_out, sha_p, sizeof(*sha_p));
+        wally_clear(sha_p, sizeof(*sha_p));
+    }
+    return WALLY_OK;
+}
+
+int WALLY_HMAC_CTX_FREE_FUNCTION(struct HMAC_CTX_T *ctx)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+    wally_clear(ctx, sizeof(*ctx));
+    wally_free(ctx);
+    return WALLY_OK;
+}
@@ -1,4 +1,37 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <cpuid.h>
+#define CPU_DETECT_X86 1
+#ifndef bit_SHA
+#define bit_SHA (1 << 29)
+#endif
+#ifndef bit_AVX512F
+#define bit_AVX512F (1 << 16)
+#endif
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define CPU_DETECT_ARM64 1
+#if defined(__linux__)
+/* Android also reports SHA512 support only through the kernel hwcaps */
+#include <sys/auxv.h>
+#ifndef HWCAP_AES
+#define HWCAP_AES (1 << 3)
+#endif
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#ifndef HWCAP_SHA512
+#define HWCAP_SHA512 (1 << 21)
+#endif
+#endif
+#endif
+#ifdef __ANDROID__
+#include "cpufeatures/cpu-features.h"
+#endif
+
 #include "internal.h"
+#include "siphash.h"
+#include "wordlist.h"
+#include <include/wally_bip39.h>
 #include <include/wally_crypto.h>
 #include "ccan/ccan/build_assert/build_assert.h"
 #include "ccan/ccan/crypto/ripemd160/ripemd160.h"
@@ -10,17 +43,130 @@
 #undef malloc
 #undef free
 
-/* Caller is responsible for thread safety */
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ATOMIC_EXCHANGE(p, v) __atomic_exchange_n(p, v, __ATOMIC_ACQ_REL)
+#define ATOMIC_CAS(p, expected, v) \
+    __atomic_compare_exchange_n(p, expected, v, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define ATOMIC_ADD(p, v) __atomic_fetch_add(p, v, __ATOMIC_RELAXED)
+#define ATOMIC_STORE(p, v) __atomic_store_n(p, v, __ATOMIC_RELAXED)
+#else
+/* No atomics: caller is responsible for thread safety */
+#define ATOMIC_LOAD(p) (*(p))
+static void *atomic_exchange(void **p, void *v)
+{
+    void *old = *p;
+    *p = v;
+    return old;
+}
+#define ATOMIC_EXCHANGE(p, v) atomic_exchange((void **)(p), v)
+#define ATOMIC_CAS(p, expected, v) (*(p) == *(expected) ? (*(p) = (v), true) : (*(expected) = *(p), false))
+#define ATOMIC_ADD(p, v) (*(p) += (v))
+#define ATOMIC_STORE(p, v) (*(p) = (v))
+#endif
+
+#ifdef HAVE_CLOCK_GETTIME
+#include <time.h>
+#endif
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <unistd.h>
+#define HAVE_SECRET_ARENA 1
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+/* Return a monotonic time in nanoseconds, or 0 if no timer is available */
+static uint64_t time_now_ns(void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+    struct timespec ts;
+    if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+    return 0;
+}
+
+/* Created once, either by wally_init() or on first use */
 static secp256k1_context *global_ctx = NULL;
 
-const secp256k1_context *secp_ctx(void)
+#undef secp256k1_context_destroy
+
+#define SECP_CTX_FLAGS (SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN)
+
+/* The secp context flags selected by wally_init() */
+static uint32_t secp_ctx_flags = SECP_CTX_FLAGS;
+
+int secp_ctx_has_tables(uint32_t bits)
 {
-    const uint32_t flags = SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN;
+    return (secp_ctx_flags & bits) == bits;
+}
 
-    if (!global_ctx)
-        global_ctx = secp256k1_context_create(flags);
+static void ignore_illegal_callback(const char *str, void *data)
+{
+    (void)str;
+    (void)data;
+}
+
+static secp256k1_context *secp_ctx_create(void)
+{
+    secp256k1_context *ctx = secp256k1_context_create(secp_ctx_flags);
+
+    /* Using a restricted context for an operation it lacks the tables for
+     * triggers the illegal callback, which aborts by default. Ignore it so
+     * that the secp call simply fails and wally returns an error */
+    if (ctx && secp_ctx_flags != SECP_CTX_FLAGS)
+        secp256k1_context_set_illegal_callback(ctx, ignore_illegal_callback, NULL);
+    return ctx;
+}
+
+/* A scratch buffer, followed by its memory. The union keeps the memory
+ * suitably aligned for any of the structures batched calls store in it */
+union scratch_block {
+    size_t size;
+    uint64_t align_u64;
+    void *align_ptr;
+};
+
+struct wally_thread_ctx {
+    secp256k1_context *secp;
+    union scratch_block *scratch;
+};
+
+static void scratch_block_free(union scratch_block *block);
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#endif
+
+#ifdef THREAD_LOCAL
+/* The context bound to the calling thread, if any */
+static THREAD_LOCAL struct wally_thread_ctx *thread_ctx = NULL;
+#endif
+
+const secp256k1_context *secp_ctx(void)
+{
+    secp256k1_context *ctx, *expected = NULL;
 
-    return global_ctx;
+#ifdef THREAD_LOCAL
+    if (thread_ctx)
+        return thread_ctx->secp;
+#endif
+    ctx = ATOMIC_LOAD(&global_ctx);
+    if (!ctx) {
+        /* Publish a new context, unless another thread beat us to it */
+        if (!(ctx = secp_ctx_create()))
+            return NULL;
+        if (!ATOMIC_CAS(&global_ctx, &expected, ctx)) {
+            secp256k1_context_destroy(ctx);
+            ctx = expected;
+        }
+    }
+    return ctx;
 }
 
 #ifndef SWIG
@@ -46,6 +192,61 @@ int wally_secp_randomize(const unsigned char *bytes, size_t bytes_len)
     return WALLY_OK;
 }
 
+int wally_thread_ctx_init_alloc(const unsigned char *bytes, size_t bytes_len,
+                                struct wally_thread_ctx **output)
+{
+    struct wally_thread_ctx *ctx;
+
+    if (output)
+        *output = NULL;
+
+    if (!bytes || bytes_len != WALLY_SECP_RANDOMIZE_LEN || !output)
+        return WALLY_EINVAL;
+
+    if (!(ctx = wally_malloc(sizeof(*ctx))))
+        return WALLY_ENOMEM;
+
+    ctx->scratch = NULL;
+    if (!(ctx->secp = secp_ctx_create())) {
+        wally_free(ctx);
+        return WALLY_ENOMEM;
+    }
+
+    if (!secp256k1_context_randomize(ctx->secp, bytes)) {
+        wally_thread_ctx_free(ctx);
+        return WALLY_ERROR;
+    }
+
+    *output = ctx;
+    return WALLY_OK;
+}
+
+int wally_thread_ctx_set(struct wally_thread_ctx *ctx)
+{
+#ifdef THREAD_LOCAL
+    thread_ctx = ctx;
+    return WALLY_OK;
+#else
+    return ctx ? WALLY_ERROR : WALLY_OK;
+#endif
+}
+
+int wally_thread_ctx_free(struct wally_thread_ctx *ctx)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+
+#ifdef THREAD_LOCAL
+    if (thread_ctx == ctx)
+        thread_ctx = NULL;
+#endif
+    secp256k1_context_destroy(ctx->secp);
+    scratch_block_free(ctx->scratch);
+    wally_clear(ctx, sizeof(*ctx));
+    wally_free(ctx);
+    return WALLY_OK;
+}
+
 int wally_free_string(char *str)
 {
     if (!str)
@@ -80,7 +281,7 @@ int wally_sha256(const unsigned char *bytes, size_t bytes_len,
     return WALLY_OK;
 }
 
-static void sha256_midstate(struct sha256_ctx *ctx, struct sha256 *res)
+void sha256_midstate(struct sha256_ctx *ctx, struct sha256 *res)
 {
     size_t i;
 
@@ -130,6 +331,49 @@ int wally_sha256d(const unsigned char *bytes, size_t bytes_len,
     return WALLY_OK;
 }
 
+static int wally_sha256_batch_impl(const unsigned char *bytes, size_t bytes_len,
+                                   size_t item_len, unsigned char *bytes_out,
+                                   size_t len, bool dbl)
+{
+    struct sha256 *out, *tmp = NULL;
+    size_t n;
+
+    if (!bytes || !item_len || bytes_len % item_len || !bytes_out)
+        return WALLY_EINVAL;
+    n = bytes_len / item_len;
+    if (!n || len != n * SHA256_LEN)
+        return WALLY_EINVAL;
+
+    out = (struct sha256 *)bytes_out;
+    if (!alignment_ok(bytes_out, sizeof(out->u.u32))) {
+        if (!(tmp = wally_malloc(len)))
+            return WALLY_ENOMEM;
+        out = tmp;
+    }
+    if (dbl)
+        sha256d_batch(out, bytes, item_len, n);
+    else
+        sha256_batch(out, bytes, item_len, n);
+    if (tmp) {
+        memcpy(bytes_out, tmp, len);
+        wally_clear(tmp, len);
+        wally_free(tmp);
+    }
+    return WALLY_OK;
+}
+
+int wally_sha256_batch(const unsigned char *bytes, size_t bytes_len,
+                       size_t item_len, unsigned char *bytes_out, size_t len)
+{
+    return wally_sha256_batch_impl(bytes, bytes_len, item_len, bytes_out, len, false);
+}
+
+int wally_sha256d_batch(const unsigned char *bytes, size_t bytes_len,
+                        size_t item_len, unsigned char *bytes_out, size_t len)
+{
+    return wally_sha256_batch_impl(bytes, bytes_len, item_len, bytes_out, len, true);
+}
+
 int wally_sha512(const unsigned char *bytes, size_t bytes_len,
                  unsigned char *bytes_out, size_t len)
 {
@@ -160,7 +404,7 @@ int wally_hash160(const unsigned char *bytes, size_t bytes_len,
     BUILD_ASSERT(sizeof(ripemd) == HASH160_LEN);
 
     sha256(&sha, bytes, bytes_len);
-    ripemd160(aligned ? (struct ripemd160 *)bytes_out : &ripemd, &sha, sizeof(sha));
+    ripemd160_32(aligned ? (struct ripemd160 *)bytes_out : &ripemd, &sha);
     if (!aligned) {
         memcpy(bytes_out, &ripemd, sizeof(ripemd));
         wally_clear(&ripemd, sizeof(ripemd));
@@ -169,6 +413,183 @@ int wally_hash160(const unsigned char *bytes, size_t bytes_len,
     return WALLY_OK;
 }
 
+/* The number of messages hashed together by wally_hash160_batch */
+#define HASH160_BATCH 64
+
+int wally_hash160_batch(const unsigned char *bytes, size_t bytes_len,
+                        size_t item_len, unsigned char *bytes_out, size_t len)
+{
+    struct sha256 sha[HASH160_BATCH];
+    struct ripemd160 ripemd[HASH160_BATCH];
+    size_t i, n, count;
+
+    if (!bytes || !item_len || bytes_len % item_len || !bytes_out)
+        return WALLY_EINVAL;
+    n = bytes_len / item_len;
+    if (!n || len != n * HASH160_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < n; i += count) {
+        count = n - i < HASH160_BATCH ? n - i : HASH160_BATCH;
+        sha256_batch(sha, bytes + i * item_len, item_len, count);
+        ripemd160_32_batch(ripemd, sha, count);
+        memcpy(bytes_out + i * HASH160_LEN, ripemd, count * HASH160_LEN);
+    }
+    wally_clear_2(sha, sizeof(sha), ripemd, sizeof(ripemd));
+    return WALLY_OK;
+}
+
+struct wally_sha256_ctx {
+    struct sha256_ctx ctx;
+};
+
+struct wally_sha512_ctx {
+    struct sha512_ctx ctx;
+};
+
+int wally_sha256_init_alloc(struct wally_sha256_ctx **output)
+{
+    if (output)
+        *output = NULL;
+    if (!output)
+        return WALLY_EINVAL;
+    if (!(*output = wally_malloc(sizeof(**output))))
+        return WALLY_ENOMEM;
+    sha256_init(&(*output)->ctx);
+    return WALLY_OK;
+}
+
+int wally_sha256_update(struct wally_sha256_ctx *ctx,
+                        const unsigned char *bytes, size_t bytes_len)
+{
+    if (!ctx || (!bytes && bytes_len))
+        return WALLY_EINVAL;
+    if (bytes_len)
+        sha256_update(&ctx->ctx, bytes, bytes_len);
+    return WALLY_OK;
+}
+
+/* Finish the SHA-256 of ctx into sha, resetting ctx for re-use */
+static void sha256_ctx_done(struct wally_sha256_ctx *ctx, struct sha256 *sha)
+{
+    sha256_done(&ctx->ctx, sha);
+    sha256_init(&ctx->ctx);
+}
+
+int wally_sha256_final(struct wally_sha256_ctx *ctx,
+                       unsigned char *bytes_out, size_t len)
+{
+    struct sha256 sha;
+    bool aligned = alignment_ok(bytes_out, sizeof(sha.u.u32));
+
+    if (!ctx || !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    sha256_ctx_done(ctx, aligned ? (struct sha256 *)bytes_out : &sha);
+    if (!aligned) {
+        memcpy(bytes_out, &sha, sizeof(sha));
+        wally_clear(&sha, sizeof(sha));
+    }
+    return WALLY_OK;
+}
+
+int wally_sha256d_final(struct wally_sha256_ctx *ctx,
+                        unsigned char *bytes_out, size_t len)
+{
+    struct sha256 sha_1, sha_2;
+    bool aligned = alignment_ok(bytes_out, sizeof(sha_1.u.u32));
+
+    if (!ctx || !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    sha256_ctx_done(ctx, &sha_1);
+    sha256(aligned ? (struct sha256 *)bytes_out : &sha_2, &sha_1, sizeof(sha_1));
+    if (!aligned) {
+        memcpy(bytes_out, &sha_2, sizeof(sha_2));
+        wally_clear(&sha_2, sizeof(sha_2));
+    }
+    wally_clear(&sha_1, sizeof(sha_1));
+    return WALLY_OK;
+}
+
+int wally_hash160_final(struct wally_sha256_ctx *ctx,
+                        unsigned char *bytes_out, size_t len)
+{
+    struct sha256 sha;
+    struct ripemd160 ripemd;
+    bool aligned = alignment_ok(bytes_out, sizeof(ripemd.u.u32));
+
+    if (!ctx || !bytes_out || len != HASH160_LEN)
+        return WALLY_EINVAL;
+
+    sha256_ctx_done(ctx, &sha);
+    ripemd160_32(aligned ? (struct ripemd160 *)bytes_out : &ripemd, &sha);
+    if (!aligned) {
+        memcpy(bytes_out, &ripemd, sizeof(ripemd));
+        wally_clear(&ripemd, sizeof(ripemd));
+    }
+    wally_clear(&sha, sizeof(sha));
+    return WALLY_OK;
+}
+
+int wally_sha256_free(struct wally_sha256_ctx *ctx)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+    wally_clear(ctx, sizeof(*ctx));
+    wally_free(ctx);
+    return WALLY_OK;
+}
+
+int wally_sha512_init_alloc(struct wally_sha512_ctx **output)
+{
+    if (output)
+        *output = NULL;
+    if (!output)
+        return WALLY_EINVAL;
+    if (!(*output = wally_malloc(sizeof(**output))))
+        return WALLY_ENOMEM;
+    sha512_init(&(*output)->ctx);
+    return WALLY_OK;
+}
+
+int wally_sha512_update(struct wally_sha512_ctx *ctx,
+                        const unsigned char *bytes, size_t bytes_len)
+{
+    if (!ctx || (!bytes && bytes_len))
+        return WALLY_EINVAL;
+    if (bytes_len)
+        sha512_update(&ctx->ctx, bytes, bytes_len);
+    return WALLY_OK;
+}
+
+int wally_sha512_final(struct wally_sha512_ctx *ctx,
+                       unsigned char *bytes_out, size_t len)
+{
+    struct sha512 sha;
+    bool aligned = alignment_ok(bytes_out, sizeof(sha.u.u64));
+
+    if (!ctx || !bytes_out || len != SHA512_LEN)
+        return WALLY_EINVAL;
+
+    sha512_done(&ctx->ctx, aligned ? (struct sha512 *)bytes_out : &sha);
+    sha512_init(&ctx->ctx);
+    if (!aligned) {
+        memcpy(bytes_out, &sha, sizeof(sha));
+        wally_clear(&sha, sizeof(sha));
+    }
+    return WALLY_OK;
+}
+
+int wally_sha512_free(struct wally_sha512_ctx *ctx)
+{
+    if (!ctx)
+        return WALLY_EINVAL;
+    wally_clear(ctx, sizeof(*ctx));
+    wally_free(ctx);
+    return WALLY_OK;
+}
+
 static void wally_internal_bzero(void *dest, size_t len)
 {
 #ifdef HAVE_MEMSET_S
@@ -195,6 +616,11 @@ static void wally_internal_free(void *ptr)
         free(ptr);
 }
 
+static void *wally_internal_realloc(void *ptr, size_t size)
+{
+    return realloc(ptr, size);
+}
+
 static int wally_internal_ec_nonce_fn(unsigned char *nonce32,
                                       const unsigned char *msg32, const unsigned char *key32,
                                       const unsigned char *algo16, void *data, unsigned int attempt)
@@ -206,17 +632,659 @@ static struct wally_operations _ops = {
     wally_internal_malloc,
     wally_internal_free,
     wally_internal_bzero,
-    wally_internal_ec_nonce_fn
+    wally_internal_ec_nonce_fn,
+    wally_internal_realloc,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
 };
 
 void *wally_malloc(size_t size)
 {
+    WALLY_STATS_ADD(WALLY_STAT_ALLOCS, 1);
+    WALLY_STATS_ADD(WALLY_STAT_ALLOC_BYTES, size);
+    if (_ops.malloc_ctx_fn)
+        return _ops.malloc_ctx_fn(_ops.alloc_ctx, size);
     return _ops.malloc_fn(size);
 }
 
 void wally_free(void *ptr)
 {
-    _ops.free_fn(ptr);
+    if (_ops.free_ctx_fn)
+        _ops.free_ctx_fn(_ops.alloc_ctx, ptr);
+    else
+        _ops.free_fn(ptr);
+}
+
+void clear_and_free(void *p, size_t len)
+{
+    if (p) {
+        wally_clear(p, len);
+        wally_free(p);
+    }
+}
+
+void clear_public_and_free(void *p, size_t len)
+{
+    if (p) {
+        wally_clear_public(p, len);
+        wally_free(p);
+    }
+}
+
+void *wally_realloc(void *ptr, size_t old_size, size_t size)
+{
+    unsigned char *p;
+
+    if (ptr && _ops.malloc_ctx_fn && _ops.realloc_ctx_fn)
+        return _ops.realloc_ctx_fn(_ops.alloc_ctx, ptr, size);
+    if (ptr && !_ops.malloc_ctx_fn && _ops.realloc_fn)
+        return _ops.realloc_fn(ptr, size);
+
+    /* No realloc available: allocate, copy and free */
+    if (!(p = wally_malloc(size)))
+        return NULL;
+    if (ptr) {
+        memcpy(p, ptr, old_size < size ? old_size : size);
+        wally_clear(ptr, old_size);
+        wally_free(ptr);
+    }
+    return p;
+}
+
+/* Recently freed fixed size objects, kept for reuse while the default
+ * allocator is in use. Each pool holds blocks of exactly one size, so its
+ * blocks are interchangeable with any other allocation of that size */
+#define POOL_NUM_SIZES 8u
+#define POOL_MAX_BLOCKS 256u
+
+struct pool_block {
+    struct pool_block *next;
+};
+
+struct object_pool {
+    size_t size;
+    size_t num_blocks;
+    struct pool_block *head;
+};
+
+static struct object_pool pools[POOL_NUM_SIZES];
+static int pools_lock = 0;
+
+static void pools_acquire(void)
+{
+    int unlocked = 0;
+    while (!ATOMIC_CAS(&pools_lock, &unlocked, 1))
+        unlocked = 0; /* Spin: the lock is only held for a few instructions */
+}
+
+static void pools_release(void)
+{
+    int locked = 1;
+    ATOMIC_CAS(&pools_lock, &locked, 0);
+}
+
+static bool pools_enabled(void)
+{
+    return !_ops.malloc_ctx_fn && _ops.malloc_fn == wally_internal_malloc &&
+           _ops.free_fn == wally_internal_free;
+}
+
+/* Find the pool for size, claiming an unused one if needed. Caller holds the lock */
+static struct object_pool *pool_for(size_t size, bool claim)
+{
+    size_t i;
+    for (i = 0; i < POOL_NUM_SIZES; ++i) {
+        if (pools[i].size == size)
+            return pools + i;
+        if (!pools[i].size) {
+            if (!claim)
+                return NULL;
+            pools[i].size = size;
+            return pools + i;
+        }
+    }
+    return NULL; /* No free pools */
+}
+
+void *wally_pool_malloc(size_t size)
+{
+    struct object_pool *pool;
+    struct pool_block *block = NULL;
+
+    if (size >= sizeof(struct pool_block) && pools_enabled()) {
+        pools_acquire();
+        if ((pool = pool_for(size, false)) && pool->head) {
+            block = pool->head;
+            pool->head = block->next;
+            --pool->num_blocks;
+        }
+        pools_release();
+    }
+    return block ? block : wally_malloc(size);
+}
+
+void wally_pool_free(void *ptr, size_t size)
+{
+    struct object_pool *pool;
+    bool pooled = false;
+
+    if (ptr && size >= sizeof(struct pool_block) && pools_enabled()) {
+        pools_acquire();
+        if ((pool = pool_for(size, true)) && pool->num_blocks < POOL_MAX_BLOCKS) {
+            ((struct pool_block *)ptr)->next = pool->head;
+            pool->head = (struct pool_block *)ptr;
+            ++pool->num_blocks;
+            pooled = true;
+        }
+        pools_release();
+    }
+    if (!pooled)
+        wally_free(ptr);
+}
+
+/* Return all pooled blocks to the default allocator */
+static void pools_flush(void)
+{
+    struct pool_block *block;
+    size_t i;
+
+    pools_acquire();
+    for (i = 0; i < POOL_NUM_SIZES; ++i) {
+        while ((block = pools[i].head)) {
+            pools[i].head = block->next;
+            wally_internal_free(block);
+        }
+        pools[i].num_blocks = 0;
+    }
+    pools_release();
+}
+
+size_t wally_atomic_add(size_t *p, size_t n)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_fetch_add(p, n, __ATOMIC_ACQ_REL);
+#else
+    const size_t old = *p;
+    *p += n;
+    return old;
+#endif
+}
+
+size_t wally_atomic_load(const size_t *p)
+{
+    return ATOMIC_LOAD(p);
+}
+
+void hash_table_key(const void *p, uint64_t key[2])
+{
+    static size_t counter = 0;
+    uint64_t data[4];
+
+    /* Mix the table and stack addresses, which vary with ASLR, the
+     * time and a counter so that every table gets a distinct key */
+    data[0] = (uint64_t)(uintptr_t)p;
+    data[1] = (uint64_t)(uintptr_t)&data;
+    data[2] = time_now_ns();
+    data[3] = wally_atomic_add(&counter, 1);
+    key[0] = siphash24_impl(0x736f6d6570736575ull, data[2],
+                            (const unsigned char *)data, sizeof(data));
+    key[1] = siphash24_impl(key[0], 0x646f72616e646f6dull,
+                            (const unsigned char *)data, sizeof(data));
+    wally_clear(data, sizeof(data));
+}
+
+void wally_run_tasks(wally_run_tasks_t run_fn, void *run_ctx, size_t num_tasks,
+                     wally_task_t task_fn, void *task_ctx)
+{
+    size_t i;
+
+    if (!num_tasks)
+        return;
+    if (!run_fn) {
+        run_fn = _ops.run_tasks_fn;
+        run_ctx = _ops.run_tasks_ctx;
+    }
+    if (run_fn)
+        run_fn(run_ctx, num_tasks, task_fn, task_ctx);
+    else
+        for (i = 0; i < num_tasks; ++i)
+            task_fn(task_ctx, i);
+}
+
+struct wally_async {
+    wally_async_work_t work_fn;
+    void *work_ctx;
+    size_t work_len;
+    unsigned char *bytes_out;
+    size_t len;
+    wally_async_done_t done_fn;
+    void *done_ctx;
+    int ret;
+    int done;
+    int cancelled;
+    int refs; /* One each for the caller and the running task */
+};
+
+#ifdef THREAD_LOCAL
+/* The asynchronous operation running on the calling thread, if any */
+static THREAD_LOCAL struct wally_async *current_async = NULL;
+#endif
+
+int wally_async_cancelled(void)
+{
+#ifdef THREAD_LOCAL
+    return current_async && ATOMIC_LOAD(&current_async->cancelled);
+#else
+    return 0; /* Cancellation is only checked before starting */
+#endif
+}
+
+/* Drop a reference to op, freeing it when the caller and task are done */
+static void async_release(struct wally_async *op)
+{
+    int expected = 2;
+    if (!ATOMIC_CAS(&op->refs, &expected, 1)) {
+        wally_clear(op, sizeof(*op));
+        wally_free(op);
+    }
+}
+
+static void async_task(void *task_ctx, size_t index)
+{
+    struct wally_async *op = task_ctx;
+    int ret = WALLY_ERROR, expected = 0;
+
+    (void)index;
+    if (!ATOMIC_LOAD(&op->cancelled)) {
+#ifdef THREAD_LOCAL
+        struct wally_async *prev = current_async;
+        current_async = op;
+#endif
+        ret = op->work_fn(op->work_ctx);
+#ifdef THREAD_LOCAL
+        current_async = prev;
+#endif
+        if (ATOMIC_LOAD(&op->cancelled))
+            ret = WALLY_ERROR; /* The work may have stopped early */
+    }
+    wally_secret_free(op->work_ctx, op->work_len);
+    if (ret != WALLY_OK)
+        wally_clear(op->bytes_out, op->len);
+    op->ret = ret;
+    ATOMIC_CAS(&op->done, &expected, 1); /* Publishes ret to pollers */
+    if (op->done_fn)
+        op->done_fn(op->done_ctx, ret);
+    async_release(op);
+}
+
+int wally_async_start(wally_async_work_t work_fn, void *work_ctx, size_t work_len,
+                      unsigned char *bytes_out, size_t len,
+                      wally_async_done_t done_fn, void *done_ctx,
+                      struct wally_async **output)
+{
+    struct wally_async *op;
+    int ret;
+
+    if (output)
+        *output = NULL;
+    if (!work_ctx)
+        return WALLY_ENOMEM;
+    if (!output || !bytes_out || !len) {
+        ret = WALLY_EINVAL;
+        goto fail;
+    }
+    op = wally_malloc(sizeof(*op));
+    if (!op) {
+        ret = WALLY_ENOMEM;
+        goto fail;
+    }
+    op->work_fn = work_fn;
+    op->work_ctx = work_ctx;
+    op->work_len = work_len;
+    op->bytes_out = bytes_out;
+    op->len = len;
+    op->done_fn = done_fn;
+    op->done_ctx = done_ctx;
+    op->ret = WALLY_OK;
+    op->done = op->cancelled = 0;
+    op->refs = 2;
+    /* Set before submitting, as the operation may complete at any time */
+    *output = op;
+    if (!_ops.submit_fn) {
+        async_task(op, 0);
+        return WALLY_OK;
+    }
+    ret = _ops.submit_fn(_ops.submit_ctx, async_task, op);
+    if (ret == WALLY_OK)
+        return WALLY_OK;
+    *output = NULL;
+    wally_free(op);
+fail:
+    wally_secret_free(work_ctx, work_len);
+    return ret;
+}
+
+int wally_async_poll(const struct wally_async *op, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!op || !written)
+        return WALLY_EINVAL;
+    if (!ATOMIC_LOAD(&op->done))
+        return WALLY_OK;
+    *written = 1;
+    return op->ret;
+}
+
+int wally_async_cancel(struct wally_async *op)
+{
+    if (!op)
+        return WALLY_EINVAL;
+    ATOMIC_STORE(&op->cancelled, 1);
+    return WALLY_OK;
+}
+
+int wally_async_free(struct wally_async *op)
+{
+    if (!op)
+        return WALLY_EINVAL;
+    ATOMIC_STORE(&op->cancelled, 1); /* No effect if already done */
+    async_release(op);
+    return WALLY_OK;
+}
+
+/* The scratch buffer used by threads without a bound context */
+static union scratch_block *global_scratch = NULL;
+static size_t scratch_limit = WALLY_SCRATCH_LIMIT_DEFAULT;
+
+static void scratch_block_free(union scratch_block *block)
+{
+    if (block)
+        wally_free(block);
+}
+
+static union scratch_block **scratch_slot(void)
+{
+#ifdef THREAD_LOCAL
+    if (thread_ctx)
+        return &thread_ctx->scratch;
+#endif
+    return &global_scratch;
+}
+
+void *wally_scratch_alloc(size_t size)
+{
+    union scratch_block *block;
+
+    /* Take the kept buffer, so that concurrent callers can't share it */
+    block = ATOMIC_EXCHANGE(scratch_slot(), NULL);
+    if (block && block->size >= size)
+        return block + 1;
+    scratch_block_free(block); /* Too small: replace it */
+
+    if (size > (size_t)-1 - sizeof(*block) ||
+        !(block = wally_malloc(sizeof(*block) + size)))
+        return NULL;
+    block->size = size;
+    return block + 1;
+}
+
+void wally_scratch_free(void *ptr, size_t size)
+{
+    union scratch_block *block;
+
+    if (!ptr)
+        return;
+    block = (union scratch_block *)ptr - 1;
+    wally_clear(ptr, size);
+    if (block->size > ATOMIC_LOAD(&scratch_limit)) {
+        scratch_block_free(block);
+        return;
+    }
+    /* Keep the buffer, freeing any returned meanwhile by another caller */
+    scratch_block_free(ATOMIC_EXCHANGE(scratch_slot(), block));
+}
+
+int wally_set_scratch_limit(size_t limit)
+{
+    union scratch_block *block;
+
+    ATOMIC_STORE(&scratch_limit, limit);
+    /* Drop the calling thread's buffer if it is now too large to keep */
+    block = ATOMIC_EXCHANGE(scratch_slot(), NULL);
+    if (block && block->size > limit)
+        scratch_block_free(block);
+    else if (block)
+        scratch_block_free(ATOMIC_EXCHANGE(scratch_slot(), block));
+    return WALLY_OK;
+}
+
+int wally_get_scratch_limit(size_t *written)
+{
+    if (!written)
+        return WALLY_EINVAL;
+    *written = ATOMIC_LOAD(&scratch_limit);
+    return WALLY_OK;
+}
+
+/* The secret arena hands out memory for secret temporaries by bumping an
+ * offset. Memory is cleared as it is freed, but is not reused until every
+ * allocation has been freed, at which point the offset is reset.
+ * Allocations are aligned for the scrypt buffers and to avoid sharing
+ * cache lines */
+#define SECRET_ALIGN 64u
+
+/* The arena state packs the offset of its next free byte into the high
+ * 32 bits and the number of live allocations into the low 32 bits, so
+ * that both are updated by a single CAS. The count is SECRET_CLOSED when
+ * there is no arena, or while it is being set up or torn down */
+#define SECRET_CLOSED 0xffffffffu
+#define SECRET_STATE(offset, count) (((uint64_t)(offset) << 32u) | (count))
+#define SECRET_OFFSET(state) ((size_t)((state) >> 32u))
+#define SECRET_COUNT(state) ((uint32_t)(state))
+
+static struct {
+    uint64_t state;
+    unsigned char *mem; /* Usable memory, between any guard pages */
+    size_t len; /* Size of mem */
+    unsigned char *map; /* The whole mapping, including any guard pages */
+    size_t map_len;
+    uint32_t flags;
+} secret_arena = { SECRET_STATE(0, SECRET_CLOSED), NULL, 0, NULL, 0, 0 };
+
+/* Move the arena out of a closed state that only the caller can leave,
+ * releasing the caller's changes to the arena along with its new state */
+static void secret_arena_publish(uint64_t from, uint64_t to)
+{
+    ATOMIC_CAS(&secret_arena.state, &from, to);
+}
+
+#ifdef HAVE_SECRET_ARENA
+static void secret_arena_unmap(void)
+{
+    if (secret_arena.flags & WALLY_SECRET_ARENA_LOCK)
+        munlock(secret_arena.mem, secret_arena.len);
+    munmap(secret_arena.map, secret_arena.map_len);
+    secret_arena.mem = secret_arena.map = NULL;
+    secret_arena.len = secret_arena.map_len = 0;
+    secret_arena.flags = 0;
+}
+#endif
+
+int wally_secret_arena_init(size_t len, uint32_t flags)
+{
+#ifdef HAVE_SECRET_ARENA
+    const long page_len = sysconf(_SC_PAGESIZE);
+    const size_t guard_len = flags & WALLY_SECRET_ARENA_GUARD ? (size_t)page_len : 0;
+    uint64_t expected = SECRET_STATE(0, SECRET_CLOSED);
+    size_t map_len;
+
+    if (!len || len > UINT32_MAX ||
+        (flags & ~(WALLY_SECRET_ARENA_LOCK | WALLY_SECRET_ARENA_GUARD)) ||
+        page_len <= 0)
+        return WALLY_EINVAL;
+
+    len = (len + page_len - 1) & ~((size_t)page_len - 1);
+    map_len = len + guard_len * 2;
+    if (map_len < len || len > UINT32_MAX)
+        return WALLY_EINVAL;
+
+    /* Claim the closed arena, leaving it closed to allocators */
+    if (!ATOMIC_CAS(&secret_arena.state, &expected, SECRET_STATE(1, SECRET_CLOSED)))
+        return WALLY_ERROR; /* Already created, or being created */
+
+    secret_arena.map = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (secret_arena.map == MAP_FAILED) {
+        secret_arena.map = NULL;
+        secret_arena_publish(SECRET_STATE(1, SECRET_CLOSED), SECRET_STATE(0, SECRET_CLOSED));
+        return WALLY_ENOMEM;
+    }
+    secret_arena.map_len = map_len;
+    secret_arena.mem = secret_arena.map + guard_len;
+    secret_arena.len = len;
+    secret_arena.flags = flags;
+    if ((guard_len &&
+         (mprotect(secret_arena.map, guard_len, PROT_NONE) ||
+          mprotect(secret_arena.mem + len, guard_len, PROT_NONE))) ||
+        ((flags & WALLY_SECRET_ARENA_LOCK) && mlock(secret_arena.mem, len))) {
+        secret_arena.flags &= ~WALLY_SECRET_ARENA_LOCK; /* Nothing to unlock */
+        secret_arena_unmap();
+        secret_arena_publish(SECRET_STATE(1, SECRET_CLOSED), SECRET_STATE(0, SECRET_CLOSED));
+        return WALLY_ERROR;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(secret_arena.mem, len, MADV_DONTDUMP); /* Keep secrets out of core files */
+#endif
+    secret_arena_publish(SECRET_STATE(1, SECRET_CLOSED), SECRET_STATE(0, 0)); /* Open it */
+    return WALLY_OK;
+#else
+    (void)len;
+    (void)flags;
+    return WALLY_ERROR;
+#endif
+}
+
+int wally_secret_arena_free(uint32_t flags)
+{
+#ifdef HAVE_SECRET_ARENA
+    uint64_t expected = SECRET_STATE(0, 0);
+#endif
+
+    if (flags)
+        return WALLY_EINVAL;
+#ifdef HAVE_SECRET_ARENA
+
+    /* Close the arena, which must be idle */
+    if (!ATOMIC_CAS(&secret_arena.state, &expected, SECRET_STATE(1, SECRET_CLOSED)))
+        return SECRET_COUNT(expected) == SECRET_CLOSED && !SECRET_OFFSET(expected) ?
+               WALLY_OK : WALLY_ERROR;
+    secret_arena_unmap();
+    secret_arena_publish(SECRET_STATE(1, SECRET_CLOSED), SECRET_STATE(0, SECRET_CLOSED));
+#endif
+    return WALLY_OK;
+}
+
+void *wally_secret_arena_alloc(size_t size)
+{
+    uint64_t state = ATOMIC_LOAD(&secret_arena.state);
+    size_t offset;
+
+    if (!size || size > UINT32_MAX)
+        return NULL;
+    size = (size + SECRET_ALIGN - 1) & ~((size_t)SECRET_ALIGN - 1);
+    do {
+        if (SECRET_COUNT(state) >= SECRET_CLOSED - 1)
+            return NULL; /* No arena, or too many live allocations */
+        offset = SECRET_OFFSET(state);
+        if (size > secret_arena.len - offset)
+            return NULL; /* No room */
+    } while (!ATOMIC_CAS(&secret_arena.state, &state,
+                         SECRET_STATE(offset + size, SECRET_COUNT(state) + 1)));
+    return secret_arena.mem + offset;
+}
+
+void *wally_secret_alloc(size_t size)
+{
+    void *p = wally_secret_arena_alloc(size);
+    return p ? p : wally_malloc(size);
+}
+
+void wally_secret_free(void *ptr, size_t size)
+{
+    unsigned char *p = ptr;
+    uint64_t state;
+
+    if (!p)
+        return;
+    wally_clear(ptr, size);
+    /* If p is from the arena, its live allocation keeps the arena open */
+    if (!secret_arena.mem || p < secret_arena.mem ||
+        p >= secret_arena.mem + secret_arena.len) {
+        wally_free(ptr);
+        return;
+    }
+    state = ATOMIC_LOAD(&secret_arena.state);
+    for (;;) {
+        const size_t offset = SECRET_OFFSET(state);
+        if (SECRET_COUNT(state) != 1) {
+            /* Others are live: their space is reclaimed once all are freed */
+            if (ATOMIC_CAS(&secret_arena.state, &state,
+                           SECRET_STATE(offset, SECRET_COUNT(state) - 1)))
+                return;
+        } else if (ATOMIC_CAS(&secret_arena.state, &state, SECRET_STATE(0, 0))) {
+            /* The last live allocation: everything handed out since the
+             * arena was last idle has been cleared, so reuse it from the start */
+            return;
+        }
+    }
+}
+
+/* Caller set input limits, 0 meaning unlimited */
+static size_t input_limits[WALLY_NUM_LIMITS];
+
+int wally_set_input_limit(uint32_t limit, size_t value)
+{
+    if (limit >= WALLY_NUM_LIMITS)
+        return WALLY_EINVAL;
+    ATOMIC_STORE(&input_limits[limit], value);
+    return WALLY_OK;
+}
+
+int wally_get_input_limit(uint32_t limit, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (limit >= WALLY_NUM_LIMITS || !written)
+        return WALLY_EINVAL;
+    *written = ATOMIC_LOAD(&input_limits[limit]);
+    return WALLY_OK;
+}
+
+int wally_exceeds_input_limit(uint32_t limit, size_t len)
+{
+    const size_t max = ATOMIC_LOAD(&input_limits[limit]);
+    return max && len > max;
+}
+
+size_t wally_strlen_limited(const char *str, uint32_t limit)
+{
+    const size_t max = ATOMIC_LOAD(&input_limits[limit]);
+    size_t len = 0;
+
+    if (!max)
+        return strlen(str);
+    while (len <= max && str[len])
+        ++len;
+    return len;
 }
 
 char *wally_strdup(const char *str)
@@ -243,14 +1311,33 @@ int wally_get_operations(struct wally_operations *output)
 
 int wally_set_operations(const struct wally_operations *ops)
 {
-    if (!ops)
+    if (!ops || !ops->malloc_ctx_fn != !ops->free_ctx_fn ||
+        (ops->realloc_ctx_fn && !ops->malloc_ctx_fn))
         return WALLY_EINVAL;
+    pools_flush(); /* Pooled blocks belong to the default allocator */
+    /* The kept scratch buffer belongs to the allocator being replaced */
+    scratch_block_free(ATOMIC_EXCHANGE(&global_scratch, NULL));
 #define COPY_FN_PTR(name) if (ops->name) _ops.name = ops->name
     COPY_FN_PTR(malloc_fn);
     COPY_FN_PTR(free_fn);
     COPY_FN_PTR (bzero_fn);
     COPY_FN_PTR (ec_nonce_fn);
 #undef COPY_FN_PTR
+    _ops.realloc_fn = ops->realloc_fn;
+    _ops.alloc_ctx = ops->alloc_ctx;
+    _ops.malloc_ctx_fn = ops->malloc_ctx_fn;
+    _ops.free_ctx_fn = ops->free_ctx_fn;
+    _ops.realloc_ctx_fn = ops->realloc_ctx_fn;
+    _ops.ec_nonce_ctx = ops->ec_nonce_ctx;
+    _ops.ec_nonce_ctx_fn = ops->ec_nonce_ctx_fn;
+    _ops.run_tasks_ctx = ops->run_tasks_ctx;
+    _ops.run_tasks_fn = ops->run_tasks_fn;
+    _ops.submit_ctx = ops->submit_ctx;
+    _ops.submit_fn = ops->submit_fn;
+    /* The default realloc can only resize memory from the default malloc */
+    if (_ops.realloc_fn == wally_internal_realloc &&
+        (_ops.malloc_fn != wally_internal_malloc || _ops.free_fn != wally_internal_free))
+        _ops.realloc_fn = NULL;
     return WALLY_OK;
 }
 
@@ -266,6 +1353,57 @@ int wally_is_elements_build(uint64_t *value_out)
     return WALLY_OK;
 }
 
+#ifdef WALLY_ENABLE_STATS
+static uint64_t stats[WALLY_NUM_STATS];
+
+void wally_stats_add(uint32_t stat, uint64_t n)
+{
+    ATOMIC_ADD(&stats[stat], n);
+}
+
+uint64_t wally_stats_now(void)
+{
+    return time_now_ns(); /* If no timer is available only counts are recorded */
+}
+
+void wally_stats_time(uint32_t stat, uint32_t ns_stat, uint64_t start)
+{
+    ATOMIC_ADD(&stats[stat], 1);
+    ATOMIC_ADD(&stats[ns_stat], wally_stats_now() - start);
+}
+#endif /* WALLY_ENABLE_STATS */
+
+int wally_get_stats(uint32_t stat, uint64_t *value_out)
+{
+    if (value_out)
+        *value_out = 0;
+    if (stat >= WALLY_NUM_STATS || !value_out)
+        return WALLY_EINVAL;
+#ifdef WALLY_ENABLE_STATS
+    *value_out = ATOMIC_LOAD(&stats[stat]);
+    return WALLY_OK;
+#else
+    return WALLY_ERROR;
+#endif
+}
+
+int wally_reset_stats(uint32_t flags)
+{
+#ifdef WALLY_ENABLE_STATS
+    size_t i;
+#endif
+
+    if (flags)
+        return WALLY_EINVAL;
+#ifdef WALLY_ENABLE_STATS
+    for (i = 0; i < WALLY_NUM_STATS; ++i)
+        ATOMIC_STORE(&stats[i], 0);
+    return WALLY_OK;
+#else
+    return WALLY_ERROR;
+#endif
+}
+
 void wally_clear(void *p, size_t len){
     _ops.bzero_fn(p, len);
 }
@@ -312,29 +1450,208 @@ void wally_clear_6(void *p, size_t len, void *p2, size_t len2,
 }
 
 static bool wally_init_done = false;
+/* The CPU specific implementations selected by wally_init() */
+static uint32_t cpu_features_selected = 0;
+
+/* Return the WALLY_CPU_ implementations that the current CPU can run. The
+ * modules choose between them in their *_optimize() functions */
+static uint32_t cpu_features_detect(void)
+{
+    uint32_t features = 0;
+#if defined(CPU_DETECT_X86)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    uint32_t xcr0_lo = 0, xcr0_hi = 0;
+    bool sse4_ssse3;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return 0;
+    sse4_ssse3 = (ecx & bit_SSE4_1) && (ecx & bit_SSSE3);
+    if (ecx & bit_SSSE3)
+        features |= WALLY_CPU_HEX_SSSE3 | WALLY_CPU_SHA512_SSSE3;
+    if (ecx & bit_SSE4_1)
+        features |= WALLY_CPU_SHA256_SSE4;
+    if (ecx & bit_AES)
+        features |= WALLY_CPU_AES_NI;
+    /* AVX2/AVX-512 need OS support for saving YMM/ZMM (OSXSAVE+AVX) */
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX))
+        __asm__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if (__get_cpuid_max(0, NULL) < 7)
+        return features;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    if ((ebx & bit_SHA) && sse4_ssse3)
+        features |= WALLY_CPU_SHA256_SHANI;
+    if ((xcr0_lo & 6) == 6 && (ebx & bit_AVX2))
+        features |= WALLY_CPU_SHA256_AVX2 | WALLY_CPU_SHA512_AVX2 | WALLY_CPU_SCRYPT_AVX2 |
+                    WALLY_CPU_RIPEMD160_AVX2 | WALLY_CPU_BASE64_AVX2;
+    if ((xcr0_lo & 6) == 6 && (ebx & bit_AVX2) && (ebx & bit_BMI2))
+        features |= WALLY_CPU_SHA512_AVX2_BMI2;
+    if ((xcr0_lo & 0xe6) == 0xe6 && (ebx & bit_AVX512F))
+        features |= WALLY_CPU_SCRYPT_AVX512;
+#elif defined(CPU_DETECT_ARM64)
+#if defined(__ANDROID__)
+    if (android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM64) {
+        const uint64_t arm64 = android_getCpuFeatures();
+        if (arm64 & ANDROID_CPU_ARM64_FEATURE_AES)
+            features |= WALLY_CPU_AES_ARMV8;
+        if (arm64 & ANDROID_CPU_ARM64_FEATURE_SHA2)
+            features |= WALLY_CPU_SHA256_ARMV8;
+    }
+    if (getauxval(AT_HWCAP) & HWCAP_SHA512)
+        features |= WALLY_CPU_SHA512_ARMV8;
+#elif defined(__linux__)
+    const unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & HWCAP_AES)
+        features |= WALLY_CPU_AES_ARMV8;
+    if (hwcap & HWCAP_SHA2)
+        features |= WALLY_CPU_SHA256_ARMV8;
+    if (hwcap & HWCAP_SHA512)
+        features |= WALLY_CPU_SHA512_ARMV8;
+#elif defined(__APPLE__)
+    /* All Apple ARM64 CPUs support the AES and SHA2 instructions */
+    features |= WALLY_CPU_AES_ARMV8 | WALLY_CPU_SHA256_ARMV8;
+#endif
+#elif defined(__ANDROID__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+    if (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON)
+        features |= WALLY_CPU_SCRYPT_NEON;
+#endif
+    return features;
+}
+
+/* Nanoseconds taken by the last successful call to wally_init() */
+static uint64_t init_duration_ns = 0;
+
+/* Run each kind of operation once, so that the first real call does not
+ * pay for page faults and cache misses on the static tables they use */
+static int warm_up(uint32_t ctx_flags)
+{
+    /* The generator G, the public key for the private key 1 */
+    static const unsigned char pub_key[EC_PUBLIC_KEY_LEN] = {
+        0x02, 0x79, 0xbe, 0x66, 0x7e, 0xf9, 0xdc, 0xbb, 0xac, 0x55, 0xa0,
+        0x62, 0x95, 0xce, 0x87, 0x0b, 0x07, 0x02, 0x9b, 0xfc, 0xdb, 0x2d,
+        0xce, 0x28, 0xd9, 0x59, 0xf2, 0x81, 0x5b, 0x16, 0xf8, 0x17, 0x98
+    };
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN] = { 0 }, hash[SHA256_LEN];
+    unsigned char hmac[SHA512_LEN], aes[AES_BLOCK_LEN], sig[EC_SIGNATURE_LEN] = { 0 };
+    char *langs = NULL, *lang, *next;
+    struct words *w;
+    size_t i;
+    int ret;
+
+    priv_key[EC_PRIVATE_KEY_LEN - 1] = 1;
+    sig[31] = sig[63] = 1; /* r = s = 1, for verifying without signing tables */
+
+    /* Hashing, HMAC and AES */
+    if ((ret = wally_sha256(priv_key, sizeof(priv_key), hash, sizeof(hash))) != WALLY_OK ||
+        (ret = wally_hmac_sha512(priv_key, sizeof(priv_key), hash, sizeof(hash),
+                                 hmac, sizeof(hmac))) != WALLY_OK ||
+        (ret = wally_aes(hmac, AES_KEY_LEN_256, hash, AES_BLOCK_LEN, AES_FLAG_ENCRYPT,
+                         aes, sizeof(aes))) != WALLY_OK)
+        goto cleanup;
+
+    /* Signing and verification tables, as present in the context. Without
+     * signing tables the verification runs in full but fails */
+    if (ctx_flags & SECP256K1_FLAGS_BIT_CONTEXT_SIGN &&
+        (ret = wally_ec_sig_from_bytes(priv_key, sizeof(priv_key), hash, sizeof(hash),
+                                       EC_FLAG_ECDSA, sig, sizeof(sig))) != WALLY_OK)
+        goto cleanup;
+    if (ctx_flags & SECP256K1_FLAGS_BIT_CONTEXT_VERIFY)
+        wally_ec_sig_verify(pub_key, sizeof(pub_key), hash, sizeof(hash),
+                            EC_FLAG_ECDSA, sig, sizeof(sig));
+
+    /* Every word and hash table slot of every BIP39 wordlist */
+    if ((ret = bip39_get_languages(&langs)) != WALLY_OK)
+        goto cleanup;
+    for (lang = langs; lang; lang = next) {
+        if ((next = strchr(lang, ' ')))
+            *next++ = '\0';
+        if ((ret = bip39_get_wordlist(lang, &w)) != WALLY_OK)
+            goto cleanup;
+        for (i = 0; i < BIP39_WORDLIST_LEN; ++i)
+            if (wordlist_lookup_word(w, wordlist_lookup_index(w, i)) != i + 1) {
+                ret = WALLY_ERROR;
+                goto cleanup;
+            }
+    }
+
+cleanup:
+    wally_free(langs);
+    wally_clear_5(priv_key, sizeof(priv_key), hash, sizeof(hash),
+                  hmac, sizeof(hmac), aes, sizeof(aes), sig, sizeof(sig));
+    return ret;
+}
 
 int wally_init(uint32_t flags)
 {
-    if (flags)
+    const uint64_t start = time_now_ns();
+    const uint32_t ctx_init_flags = flags & ~WALLY_INIT_WARM_UP;
+    uint32_t ctx_flags = SECP_CTX_FLAGS;
+    secp256k1_context *ctx;
+    int ret;
+
+    if (ctx_init_flags == WALLY_INIT_SIGN_ONLY)
+        ctx_flags = SECP256K1_CONTEXT_SIGN;
+    else if (ctx_init_flags == WALLY_INIT_VERIFY_ONLY)
+        ctx_flags = SECP256K1_CONTEXT_VERIFY;
+    else if (ctx_init_flags)
         return WALLY_EINVAL;
 
     if (!wally_init_done) {
-        sha256_optimize();
+        const uint32_t features = cpu_features_detect();
+        cpu_features_selected = sha256_optimize(features) |
+                                sha512_optimize(features) |
+                                ripemd160_optimize(features) |
+                                hex_optimize(features) |
+                                base64_optimize(features) |
+                                scrypt_optimize(features) |
+                                aes_optimize(features);
         wally_init_done = true;
     }
 
+    if (ctx_flags != secp_ctx_flags) {
+        /* Replace any existing context created with different tables */
+        secp_ctx_flags = ctx_flags;
+        if ((ctx = ATOMIC_EXCHANGE(&global_ctx, NULL)))
+            secp256k1_context_destroy(ctx);
+    }
+
+    /* Create the secp context now rather than on first use */
+    if (!secp_ctx())
+        return WALLY_ENOMEM;
+
+    if (flags & WALLY_INIT_WARM_UP && (ret = warm_up(ctx_flags)) != WALLY_OK)
+        return ret;
+
+    init_duration_ns = time_now_ns() - start;
+    return WALLY_OK;
+}
+
+int wally_get_init_duration(uint64_t *value_out)
+{
+    if (!value_out)
+        return WALLY_EINVAL;
+    *value_out = init_duration_ns;
+    return WALLY_OK;
+}
+
+int wally_get_cpu_features(uint64_t *value_out)
+{
+    if (!value_out)
+        return WALLY_EINVAL;
+    *value_out = cpu_features_selected;
     return WALLY_OK;
 }
 
 int wally_cleanup(uint32_t flags)
 {
+    secp256k1_context *ctx;
+
     if (flags)
         return WALLY_EINVAL;
-    if (global_ctx) {
-#undef secp256k1_context_destroy
-        secp256k1_context_destroy(global_ctx);
-        global_ctx = NULL;
-    }
+    ctx = ATOMIC_EXCHANGE(&global_ctx, NULL);
+    if (ctx)
+        secp256k1_context_destroy(ctx);
+    scratch_block_free(ATOMIC_EXCHANGE(&global_scratch, NULL));
+    pools_flush();
     return WALLY_OK;
 }
 
@@ -6,19 +6,61 @@
 #include <config.h>
 #include <string.h>
 
+/* Stack buffer budgets. Larger data falls back to the heap. Builds for
+ * devices with small task stacks can configure with --enable-small-stack,
+ * or define any of these to override them individually */
+#ifndef WALLY_TX_STACK_SIZE
+#ifdef WALLY_SMALL_STACK
+#define WALLY_TX_STACK_SIZE 256 /* Bytes for tx hex conversion */
+#else
+#define WALLY_TX_STACK_SIZE 2048
+#endif
+#endif
+#ifndef WALLY_BASE58_STACK_WORDS
+#ifdef WALLY_SMALL_STACK
+#define WALLY_BASE58_STACK_WORDS 32 /* 32 bit words for base58 bignums */
+#else
+#define WALLY_BASE58_STACK_WORDS 128
+#endif
+#endif
+
 /* Fetch an internal secp context */
 const secp256k1_context *secp_ctx(void);
+/* Whether the secp context selected by wally_init() has the signing
+ * (SECP256K1_FLAGS_BIT_CONTEXT_SIGN) or verification
+ * (SECP256K1_FLAGS_BIT_CONTEXT_VERIFY) tables given in bits */
+int secp_ctx_has_tables(uint32_t bits);
 #define secp256k1_context_destroy(c) _do_not_destroy_shared_ctx_pointers(c)
 
-#define pubkey_create     secp256k1_ec_pubkey_create
+#define pubkey_create(ctx, pub, key) \
+    (WALLY_STATS_ADD(WALLY_STAT_EC_MULTS, 1), secp256k1_ec_pubkey_create(ctx, pub, key))
 #define pubkey_parse      secp256k1_ec_pubkey_parse
-#define pubkey_tweak_add  secp256k1_ec_pubkey_tweak_add
+#define pubkey_tweak_add(ctx, pub, tweak) \
+    (WALLY_STATS_ADD(WALLY_STAT_EC_MULTS, 1), secp256k1_ec_pubkey_tweak_add(ctx, pub, tweak))
 #define pubkey_serialize  secp256k1_ec_pubkey_serialize
 #define privkey_tweak_add secp256k1_ec_privkey_tweak_add
 
 #define PUBKEY_COMPRESSED   SECP256K1_EC_COMPRESSED
 #define PUBKEY_UNCOMPRESSED SECP256K1_EC_UNCOMPRESSED
 
+/* Fetch the SHA256 midstate of the data hashed so far, which must be a
+ * multiple of the 64 byte block size. Invalidates ctx */
+struct sha256_ctx;
+struct sha256;
+void sha256_midstate(struct sha256_ctx *ctx, struct sha256 *res);
+
+/* A public key parsed once for repeated use */
+struct wally_ec_public_key {
+    secp256k1_pubkey pub;
+    unsigned char pub_key[33]; /* Compressed serialization */
+};
+
+
+/* Return non-zero if len is larger than the caller set input limit */
+int wally_exceeds_input_limit(uint32_t limit, size_t len);
+/* Return the length of str, scanning at most one character past the
+ * caller set input limit so that over-long strings are cheap to reject */
+size_t wally_strlen_limited(const char *str, uint32_t limit);
 
 void wally_clear(void *p, size_t len);
 void wally_clear_2(void *p, size_t len, void *p2, size_t len2);
@@ -33,13 +75,165 @@ void wally_clear_6(void *p, size_t len, void *p2, size_t len2,
                    void *p3, size_t len3, void *p4, size_t len4,
                    void *p5, size_t len5, void *p6, size_t len6);
 
+/* Clear data that is provably public, such as serialized transactions.
+ * This is a no-op when configured with --disable-clear-public */
+#ifdef WALLY_NO_CLEAR_PUBLIC
+#define wally_clear_public(p, len) do { (void)(p); (void)(len); } while (0)
+#else
+#define wally_clear_public(p, len) wally_clear(p, len)
+#endif
+
+/* Statistics counting, compiled out unless configured with --enable-stats */
+#ifdef WALLY_ENABLE_STATS
+void wally_stats_add(uint32_t stat, uint64_t n);
+uint64_t wally_stats_now(void);
+void wally_stats_time(uint32_t stat, uint32_t ns_stat, uint64_t start);
+#define WALLY_STATS_ADD(stat, n) wally_stats_add(stat, n)
+/* Assign the result of call to ret, counting it in stat and timing it in ns_stat */
+#define WALLY_STATS_TIMED(stat, ns_stat, ret, call) do { \
+        const uint64_t stats_start_ = wally_stats_now(); \
+        ret = (call); \
+        wally_stats_time(stat, ns_stat, stats_start_); \
+    } while (0)
+#else
+#define WALLY_STATS_ADD(stat, n) ((void)0)
+#define WALLY_STATS_TIMED(stat, ns_stat, ret, call) ret = (call)
+#endif
+
+/* USDT (DTrace compatible) tracepoints in the "libwally" provider, compiled
+ * out unless configured with --enable-usdt. Probes are named after the
+ * function traced, with "__entry" and "__return" suffixes */
+#ifdef WALLY_ENABLE_USDT
+#include <sys/sdt.h>
+#define WALLY_TRACE1(probe, a) DTRACE_PROBE1(libwally, probe, a)
+#define WALLY_TRACE2(probe, a, b) DTRACE_PROBE2(libwally, probe, a, b)
+#define WALLY_TRACE3(probe, a, b, c) DTRACE_PROBE3(libwally, probe, a, b, c)
+#define WALLY_TRACE4(probe, a, b, c, d) DTRACE_PROBE4(libwally, probe, a, b, c, d)
+#else
+#define WALLY_TRACE1(probe, a) ((void)0)
+#define WALLY_TRACE2(probe, a, b) ((void)0)
+#define WALLY_TRACE3(probe, a, b, c) ((void)0)
+#define WALLY_TRACE4(probe, a, b, c, d) ((void)0)
+#endif
+
+/* Each *_optimize function is passed the WALLY_CPU_ implementations that
+ * the current CPU can run, and returns those it selected */
+
+/* Select the fastest hex encoding/decoding for the current CPU */
+uint32_t hex_optimize(uint32_t cpu_features);
+
+/* Select the fastest base 64 encoding/decoding for the current CPU */
+uint32_t base64_optimize(uint32_t cpu_features);
+
+/* Select hardware AES if the current CPU supports it */
+uint32_t aes_optimize(uint32_t cpu_features);
+
+/* Select the fastest scrypt smix for the current CPU */
+uint32_t scrypt_optimize(uint32_t cpu_features);
+
 /* Fetch our internal operations function pointers */
 const struct wally_operations *wally_ops(void);
 
 void *wally_malloc(size_t size);
 void wally_free(void *ptr);
+/* Clear and free p, which may be NULL */
+void clear_and_free(void *p, size_t len);
+/* As clear_and_free, for public data cleared only if configured to */
+void clear_public_and_free(void *p, size_t len);
+/* Resize memory holding non-secret data. Copies if no realloc is available */
+void *wally_realloc(void *ptr, size_t old_size, size_t size);
 char *wally_strdup(const char *str);
 
+/* Allocate/free fixed size objects such as ext_key and wally_tx_input,
+ * reusing recently freed objects of the same size where possible.
+ * wally_pool_free callers must clear the object first */
+void *wally_pool_malloc(size_t size);
+void wally_pool_free(void *ptr, size_t size);
+
+/* Allocate memory for secret temporaries from the secret arena created
+ * by wally_secret_arena_init, returning NULL if there is no arena or it
+ * is full */
+void *wally_secret_arena_alloc(size_t size);
+/* As wally_secret_arena_alloc, falling back to wally_malloc */
+void *wally_secret_alloc(size_t size);
+/* Clear and free memory from wally_secret_alloc or wally_secret_arena_alloc.
+ * Arena memory is reclaimed once the arena's last allocation is freed */
+void wally_secret_free(void *ptr, size_t size);
+
+/* Per-subsystem allocation counting. A source file defines
+ * WALLY_STATS_ALLOC_STAT as its WALLY_STAT_*_ALLOC_BYTES counter before
+ * including this header, to count the bytes it requests in that counter */
+#if defined(WALLY_ENABLE_STATS) && defined(WALLY_STATS_ALLOC_STAT)
+static inline void *wally_malloc_counted(size_t size)
+{
+    wally_stats_add(WALLY_STATS_ALLOC_STAT, size);
+    return wally_malloc(size);
+}
+
+static inline void *wally_realloc_counted(void *ptr, size_t old_size, size_t size)
+{
+    wally_stats_add(WALLY_STATS_ALLOC_STAT, size);
+    return wally_realloc(ptr, old_size, size);
+}
+
+static inline void *wally_pool_malloc_counted(size_t size)
+{
+    wally_stats_add(WALLY_STATS_ALLOC_STAT, size);
+    return wally_pool_malloc(size);
+}
+
+static inline void *wally_secret_alloc_counted(size_t size)
+{
+    wally_stats_add(WALLY_STATS_ALLOC_STAT, size);
+    return wally_secret_alloc(size);
+}
+
+#define wally_malloc(size) wally_malloc_counted(size)
+#define wally_realloc(ptr, old_size, size) wally_realloc_counted(ptr, old_size, size)
+#define wally_pool_malloc(size) wally_pool_malloc_counted(size)
+#define wally_secret_alloc(size) wally_secret_alloc_counted(size)
+#endif
+
+/* Atomically add n to *p, returning its previous value */
+size_t wally_atomic_add(size_t *p, size_t n);
+/* Atomically load *p */
+size_t wally_atomic_load(const size_t *p);
+
+/* Generate a siphash key for indexing untrusted data in the hash table at
+ * p, so that keys colliding in the table cannot be precomputed */
+void hash_table_key(const void *p, uint64_t key[2]);
+
+/* Run the tasks of a batch call using run_fn if given, otherwise the
+ * run_tasks_fn operation, otherwise serially */
+void wally_run_tasks(wally_run_tasks_t run_fn, void *run_ctx, size_t num_tasks,
+                     wally_task_t task_fn, void *task_ctx);
+
+/* The work of an asynchronous operation, returning its result */
+typedef int (*wally_async_work_t)(void *work_ctx);
+
+/* Start an asynchronous operation running work_fn with the submit_fn
+ * operation, or on the calling thread if it is NULL. work_ctx is a single
+ * allocation of work_len bytes from wally_secret_alloc, which the operation
+ * owns (even on failure) and frees with wally_secret_free once done.
+ * bytes_out of len bytes is cleared if the operation fails or is cancelled */
+int wally_async_start(wally_async_work_t work_fn, void *work_ctx, size_t work_len,
+                      unsigned char *bytes_out, size_t len,
+                      wally_async_done_t done_fn, void *done_ctx,
+                      struct wally_async **output);
+
+/* Non-zero if the asynchronous operation running on this thread, if any,
+ * has been cancelled */
+int wally_async_cancelled(void);
+
+/* Long running loops check for cancellation every 1024 iterations of i */
+#define WALLY_ASYNC_CANCELLED(i) (!((i) & 1023u) && wally_async_cancelled())
+
+/* Allocate/free working memory for a batched call. The calling thread's
+ * context keeps one buffer of up to the scratch limit for reuse, so that
+ * repeated batches don't allocate. wally_scratch_free clears the memory */
+void *wally_scratch_alloc(size_t size);
+void wally_scratch_free(void *ptr, size_t size);
+
 #define malloc(size) __use_wally_malloc_internally__
 #define free(ptr) __use_wally_free_internally__
 #ifdef strdup
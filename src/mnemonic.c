@@ -14,11 +14,7 @@ static size_t extract_index(size_t bits, const unsigned char *bytes, size_t n)
     return value;
 }
 
-/* Store n'th value (of w->bits length) to bytes
- * Assumes: 1) the bits we are writing to are zero
- *          2) value fits within w->bits
- */
-static void store_index(size_t bits, unsigned char *bytes_out, size_t n, size_t value)
+void mnemonic_store_index(size_t bits, unsigned char *bytes_out, size_t n, size_t value)
 {
     size_t i, pos;
     for (pos = n * bits, i = 0; i < bits; ++i, ++pos)
@@ -26,72 +22,87 @@ static void store_index(size_t bits, unsigned char *bytes_out, size_t n, size_t
             U8_AT(bytes_out, pos) |= U8_MASK(pos);
 }
 
-char *mnemonic_from_bytes(const struct words *w, const unsigned char *bytes, size_t bytes_len)
+size_t mnemonic_from_bytes_to_buffer(const struct words *w, const unsigned char *bytes,
+                                     size_t bytes_len, char *output, size_t len)
 {
     size_t total_bits = bytes_len * 8u; /* bits in 'bytes' */
     size_t total_mnemonics = total_bits / w->bits; /* Mnemonics in 'bytes' */
     size_t i, str_len = 0;
-    char *str = NULL;
 
     /* Compute length of result */
     for (i = 0; i < total_mnemonics; ++i) {
-        size_t idx = extract_index(w->bits, bytes, i);
-        size_t mnemonic_len = strlen(w->indices[idx]);
+        const char *word = wordlist_lookup_index(w, extract_index(w->bits, bytes, i));
+        size_t mnemonic_len = strlen(word);
 
         str_len += mnemonic_len + 1; /* +1 for following separator or NUL */
     }
 
-    /* Allocate and fill result */
-    if (str_len && (str = wally_malloc(str_len))) {
-        char *out = str;
+    /* Fill the result if it fits */
+    if (str_len && len >= str_len) {
+        char *out = output;
 
         for (i = 0; i < total_mnemonics; ++i) {
-            size_t idx = extract_index(w->bits, bytes, i);
-            size_t mnemonic_len = strlen(w->indices[idx]);
+            const char *word = wordlist_lookup_index(w, extract_index(w->bits, bytes, i));
+            size_t mnemonic_len = strlen(word);
 
-            memcpy(out, w->indices[idx], mnemonic_len);
+            memcpy(out, word, mnemonic_len);
             out[mnemonic_len] = ' '; /* separator */
             out += mnemonic_len + 1;
         }
-        str[str_len - 1] = '\0'; /* Overwrite the last separator with NUL */
+        output[str_len - 1] = '\0'; /* Overwrite the last separator with NUL */
     }
 
+    return str_len;
+}
+
+char *mnemonic_from_bytes(const struct words *w, const unsigned char *bytes, size_t bytes_len)
+{
+    size_t str_len = mnemonic_from_bytes_to_buffer(w, bytes, bytes_len, NULL, 0);
+    char *str = NULL;
+
+    if (str_len && (str = wally_malloc(str_len)))
+        mnemonic_from_bytes_to_buffer(w, bytes, bytes_len, str, str_len);
     return str;
 }
 
 int mnemonic_to_bytes(const struct words *w, const char *mnemonic,
                       unsigned char *bytes_out, size_t len, size_t *written)
 {
-    struct words *mnemonic_w = wordlist_init(mnemonic);
-    size_t i;
+    const char *p;
+    size_t num_words = 1u, i;
 
     if (written)
         *written = 0;
 
-    if (!mnemonic_w)
-        return WALLY_ENOMEM;
-
-    if (!w || !bytes_out || !len)
+    if (!w || !mnemonic || !bytes_out || !len)
         return WALLY_EINVAL;
 
-    if ((mnemonic_w->len * w->bits + 7u) / 8u > len)
+    for (p = mnemonic; *p; ++p)
+        num_words += *p == ' '; /* FIXME: utf-8 sep */
+
+    if ((num_words * w->bits + 7u) / 8u > len)
         goto cleanup; /* Return the length we would have written */
 
     wally_clear(bytes_out, len);
 
-    for (i = 0; i < mnemonic_w->len; ++i) {
-        size_t idx = wordlist_lookup_word(w, mnemonic_w->indices[i]);
+    /* Look up each word in place, without copying the mnemonic */
+    for (i = 0, p = mnemonic; i < num_words; ++i) {
+        const char *word = p;
+        size_t idx;
+
+        while (*p && *p != ' ') /* FIXME: utf-8 sep */
+            ++p;
+        idx = wordlist_lookup_word_len(w, word, p - word);
         if (!idx) {
-            wordlist_free(mnemonic_w);
             wally_clear(bytes_out, len);
             return WALLY_EINVAL;
         }
-        store_index(w->bits, bytes_out, i, idx - 1);
+        mnemonic_store_index(w->bits, bytes_out, i, idx - 1);
+        ++p; /* Skip the separator */
     }
 
 cleanup:
     if (written)
-        *written = (mnemonic_w->len * w->bits + 7u) / 8u;
-    wordlist_free(mnemonic_w);
+        *written = (num_words * w->bits + 7u) / 8u;
     return WALLY_OK;
 }
@@ -17,6 +17,25 @@ char *mnemonic_from_bytes(
     const unsigned char *bytes,
     size_t len);
 
+/**
+ * Write a mnemonic representation of a block of bytes to a buffer.
+ *
+ * @w: List of words.
+ * @bytes: Bytes to convert to a mnemonic sentence.
+ * @bytes_len: The length of @bytes in bytes.
+ * @output: Where to store the NUL terminated mnemonic sentence.
+ * @len: The length of @output in bytes.
+ *
+ * Returns the length of the sentence including its NUL terminator. @output
+ * is only written to if @len is at least this length.
+ */
+size_t mnemonic_from_bytes_to_buffer(
+    const struct words *w,
+    const unsigned char *bytes,
+    size_t bytes_len,
+    char *output,
+    size_t len);
+
 /**
  * Convert a mnemonic representation into a block of bytes.
  *
@@ -33,4 +52,20 @@ int mnemonic_to_bytes(
     size_t len,
     size_t *written);
 
+/**
+ * Store the n'th value of @bits length to a block of bytes.
+ *
+ * @bits: The number of bits per value, as for a list of words.
+ * @bytes_out: Where to store the value.
+ * @n: The position of the value.
+ * @value: The value to store.
+ *
+ * The bits being written must be zero, and @value must fit in @bits.
+ */
+void mnemonic_store_index(
+    size_t bits,
+    unsigned char *bytes_out,
+    size_t n,
+    size_t value);
+
 #endif /* LIBWALLY_MNEMONIC_H */
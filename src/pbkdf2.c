@@ -14,8 +14,15 @@
 #define SHA_ALIGN_T uint32_t
 #define SHA_MEM u32
 #define SHA_POST(name) name ## sha256
-#define SHA_POST_IMPL(name) name ## sha256_impl
+#define HMAC_CTX_T wally_hmac_sha256_ctx
+#define HMAC_CTX_INIT_IMPL hmac_sha256_ctx_init_impl
+#define HMAC_CTX_IMPL hmac_sha256_ctx_impl
+#define SHA_CTX_T sha256_ctx
+#define SHA_BATCH_EACH sha256_batch_from_each
+#define PBKDF2_BATCH_IMPL pbkdf2_hmac_sha256_batch_impl
 #define PBKDF2_HMAC_SHA_LEN PBKDF2_HMAC_SHA256_LEN
+#define PBKDF2_TRACE_ENTRY wally_pbkdf2_hmac_sha256__entry
+#define PBKDF2_TRACE_RETURN wally_pbkdf2_hmac_sha256__return
 #include "pbkdf2.inl"
 
 #undef SHA_T
@@ -26,9 +33,23 @@
 #define SHA_MEM u64
 #undef SHA_POST
 #define SHA_POST(name) name ## sha512
-#undef SHA_POST_IMPL
-#define SHA_POST_IMPL(name) name ## sha512_impl
+#undef HMAC_CTX_T
+#define HMAC_CTX_T wally_hmac_sha512_ctx
+#undef HMAC_CTX_INIT_IMPL
+#define HMAC_CTX_INIT_IMPL hmac_sha512_ctx_init_impl
+#undef HMAC_CTX_IMPL
+#define HMAC_CTX_IMPL hmac_sha512_ctx_impl
+#undef SHA_CTX_T
+#define SHA_CTX_T sha512_ctx
+#undef SHA_BATCH_EACH
+#define SHA_BATCH_EACH sha512_batch_from_each
+#undef PBKDF2_BATCH_IMPL
+#define PBKDF2_BATCH_IMPL pbkdf2_hmac_sha512_batch_impl
 #undef PBKDF2_HMAC_SHA_LEN
 #define PBKDF2_HMAC_SHA_LEN PBKDF2_HMAC_SHA512_LEN
+#undef PBKDF2_TRACE_ENTRY
+#define PBKDF2_TRACE_ENTRY wally_pbkdf2_hmac_sha512__entry
+#undef PBKDF2_TRACE_RETURN
+#define PBKDF2_TRACE_RETURN wally_pbkdf2_hmac_sha512__return
 #include "pbkdf2.inl"
 
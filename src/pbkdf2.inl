@@ -12,12 +12,13 @@
 /* Extra bytes required at the end of salt for pbkdf2 functions */
 #define PBKDF2_HMAC_EXTRA_LEN 4
 
-int SHA_POST(wally_pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
-                                 const unsigned char *salt, size_t salt_len,
-                                 uint32_t flags, uint32_t cost,
-                                 unsigned char *bytes_out, size_t len)
+static int SHA_POST(pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
+                                  const unsigned char *salt, size_t salt_len,
+                                  uint32_t flags, uint32_t cost,
+                                  unsigned char *bytes_out, size_t len)
 {
     unsigned char *tmp_salt = NULL;
+    struct HMAC_CTX_T hmac_ctx;
     struct SHA_T d1, d2, *sha_cp;
     size_t n, c, j;
 
@@ -33,7 +34,7 @@ int SHA_POST(wally_pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
     if (!len || len % PBKDF2_HMAC_SHA_LEN)
         return WALLY_EINVAL;
 
-    tmp_salt = wally_malloc(salt_len + PBKDF2_HMAC_EXTRA_LEN);
+    tmp_salt = wally_secret_alloc(salt_len + PBKDF2_HMAC_EXTRA_LEN);
     if (!tmp_salt)
         return WALLY_ENOMEM;
     memcpy(tmp_salt, salt, salt_len);
@@ -45,15 +46,20 @@ int SHA_POST(wally_pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
     else
         sha_cp = &d2;
 
+    /* Hash the padded password blocks once, rather than for every HMAC */
+    HMAC_CTX_INIT_IMPL(&hmac_ctx, pass, pass_len);
+
     for (n = 0; n < len / PBKDF2_HMAC_SHA_LEN; ++n) {
         beint32_t block = cpu_to_be32(n + 1); /* Block number */
 
         memcpy(tmp_salt + salt_len - sizeof(block), &block, sizeof(block));
-        SHA_POST_IMPL(hmac_)(&d1, pass, pass_len, tmp_salt, salt_len);
+        HMAC_CTX_IMPL(&hmac_ctx, &d1, tmp_salt, salt_len);
         memcpy(sha_cp, &d1, sizeof(d1));
 
         for (c = 0; cost && c < cost - 1; ++c) {
-            SHA_POST_IMPL(hmac_)(&d1, pass, pass_len, d1.u.u8, sizeof(d1));
+            if (WALLY_ASYNC_CANCELLED(c))
+                break; /* The running operation was cancelled */
+            HMAC_CTX_IMPL(&hmac_ctx, &d1, d1.u.u8, sizeof(d1));
             for (j = 0; j < sizeof(d1.u.SHA_MEM)/sizeof(d1.u.SHA_MEM[0]); ++j)
                 sha_cp->u.SHA_MEM[j] ^= d1.u.SHA_MEM[j];
         }
@@ -65,10 +71,95 @@ int SHA_POST(wally_pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
         bytes_out += PBKDF2_HMAC_SHA_LEN;
     }
 
-    wally_clear_2(&d1, sizeof(d1), &d2, sizeof(d2));
-    if (tmp_salt) {
-        wally_clear(tmp_salt, salt_len);
-        wally_free(tmp_salt);
-    }
+    wally_clear_3(&d1, sizeof(d1), &d2, sizeof(d2), &hmac_ctx, sizeof(hmac_ctx));
+    wally_secret_free(tmp_salt, salt_len);
     return WALLY_OK;
 }
+
+int SHA_POST(wally_pbkdf2_hmac_)(const unsigned char *pass, size_t pass_len,
+                                 const unsigned char *salt, size_t salt_len,
+                                 uint32_t flags, uint32_t cost,
+                                 unsigned char *bytes_out, size_t len)
+{
+    int ret;
+
+    WALLY_TRACE4(PBKDF2_TRACE_ENTRY, pass_len, salt_len, cost, len);
+    ret = SHA_POST(pbkdf2_hmac_)(pass, pass_len, salt, salt_len,
+                                 flags, cost, bytes_out, len);
+    WALLY_TRACE1(PBKDF2_TRACE_RETURN, ret);
+    return ret;
+}
+
+int PBKDF2_BATCH_IMPL(const unsigned char *const *passes, const size_t *pass_lens,
+                      const unsigned char *const *salts, const size_t *salt_lens,
+                      size_t n, uint32_t cost, unsigned char *bytes_out, size_t len)
+{
+    struct HMAC_CTX_T hmac_ctx;
+    struct SHA_CTX_T *ctxs = NULL;
+    struct SHA_T *digests = NULL, *u, *acc;
+    unsigned char *tmp_salt = NULL;
+    size_t max_salt_len = 0, i, block, c, j;
+    int ret = WALLY_OK;
+
+    if (!passes || !pass_lens || !salts || !salt_lens || !n ||
+        !bytes_out || !len || len % PBKDF2_HMAC_SHA_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < n; ++i)
+        if (salt_lens[i] > max_salt_len)
+            max_salt_len = salt_lens[i];
+
+    ctxs = wally_secret_alloc(n * 2 * sizeof(*ctxs));
+    digests = wally_secret_alloc(n * 2 * sizeof(*digests));
+    tmp_salt = wally_secret_alloc(max_salt_len + PBKDF2_HMAC_EXTRA_LEN);
+    if (!ctxs || !digests || !tmp_salt) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+    u = digests;
+    acc = digests + n;
+
+    /* Hash each padded password once, keeping the inner midstates in the
+     * first n contexts and the outer midstates in the last n */
+    for (i = 0; i < n; ++i) {
+        HMAC_CTX_INIT_IMPL(&hmac_ctx, passes[i], pass_lens[i]);
+        ctxs[i] = hmac_ctx.inner;
+        ctxs[n + i] = hmac_ctx.outer;
+    }
+
+    for (block = 0; block < len / PBKDF2_HMAC_SHA_LEN; ++block) {
+        beint32_t block_be = cpu_to_be32(block + 1); /* Block number */
+
+        /* The first iteration hashes each salt, which may differ in length */
+        for (i = 0; i < n; ++i) {
+            hmac_ctx.inner = ctxs[i];
+            hmac_ctx.outer = ctxs[n + i];
+            memcpy(tmp_salt, salts[i], salt_lens[i]);
+            memcpy(tmp_salt + salt_lens[i], &block_be, sizeof(block_be));
+            HMAC_CTX_IMPL(&hmac_ctx, u + i, tmp_salt,
+                          salt_lens[i] + PBKDF2_HMAC_EXTRA_LEN);
+            acc[i] = u[i];
+        }
+
+        /* The remaining iterations hash equal length digests: run all of
+         * the computations in lockstep so they can share SIMD lanes */
+        for (c = 0; cost && c < cost - 1; ++c) {
+            SHA_BATCH_EACH(u, ctxs, u, sizeof(*u), n);
+            SHA_BATCH_EACH(u, ctxs + n, u, sizeof(*u), n);
+            for (i = 0; i < n; ++i)
+                for (j = 0; j < sizeof(u->u.SHA_MEM) / sizeof(u->u.SHA_MEM[0]); ++j)
+                    acc[i].u.SHA_MEM[j] ^= u[i].u.SHA_MEM[j];
+        }
+
+        for (i = 0; i < n; ++i)
+            memcpy(bytes_out + i * len + block * PBKDF2_HMAC_SHA_LEN,
+                   acc + i, sizeof(acc[i]));
+    }
+
+cleanup:
+    wally_clear(&hmac_ctx, sizeof(hmac_ctx));
+    wally_secret_free(ctxs, n * 2 * sizeof(*ctxs));
+    wally_secret_free(digests, n * 2 * sizeof(*digests));
+    wally_secret_free(tmp_salt, max_salt_len + PBKDF2_HMAC_EXTRA_LEN);
+    return ret;
+}
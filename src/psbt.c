@@ -0,0 +1,570 @@
+#include "internal.h"
+
+#include <include/wally_psbt.h>
+#include <include/wally_transaction.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "script_int.h"
+
+#define PSBT_MAGIC "psbt\xff"
+#define PSBT_MAGIC_LEN 5
+#define PSBT_MIN_PAIRS_ALLOCATION 4u
+
+/* Round up to the alignment of a uint64_t */
+#define PSBT_ALIGN(n) (((n) + 7u) & ~(size_t)7u)
+
+/* A pair of a map. owned holds the key followed by the value if the
+ * pair was set after parsing, otherwise the pair refers to the parsed bytes */
+struct psbt_pair {
+    struct wally_psbt_pair pair;
+    unsigned char *owned;
+    size_t owned_len;
+};
+
+/* A map of the PSBT. raw is the serialized map including its separator,
+ * or NULL once the map has been changed. pairs_allocation_len is 0 while
+ * pairs points into the view's allocation */
+struct psbt_map {
+    const unsigned char *raw;
+    size_t raw_len;
+    struct psbt_pair *pairs;
+    size_t num_pairs;
+    size_t pairs_allocation_len;
+};
+
+/* The view, its pairs and its maps are allocated together. maps holds the
+ * global map, then the map of each input, then the map of each output */
+struct wally_psbt_view {
+    struct wally_tx *tx;
+    struct psbt_map *maps;
+    size_t num_maps;
+    size_t allocation_len;
+};
+
+/* Read a varint, returning the following byte or NULL if it overruns end */
+static const unsigned char *psbt_read_varint(const unsigned char *p,
+                                             const unsigned char *end,
+                                             uint64_t *v)
+{
+    if (p >= end || varint_length_from_bytes(p) > (size_t)(end - p))
+        return NULL;
+    return p + varint_from_bytes(p, v);
+}
+
+/* Parse the map starting at p, filling pairs if given. Returns the byte
+ * following the map's separator, or NULL if the map is malformed */
+static const unsigned char *psbt_parse_map(const unsigned char *p,
+                                           const unsigned char *end,
+                                           struct psbt_pair *pairs,
+                                           size_t *num_pairs)
+{
+    const unsigned char *key, *key_data;
+    uint64_t key_len, value_len, type;
+    size_t n = 0;
+
+    for (;;) {
+        if (!(p = psbt_read_varint(p, end, &key_len)))
+            return NULL;
+        if (!key_len)
+            break; /* Separator */
+        if (key_len > (size_t)(end - p))
+            return NULL;
+        key = p;
+        p += key_len;
+        if (!(key_data = psbt_read_varint(key, p, &type)) ||
+            !(p = psbt_read_varint(p, end, &value_len)) ||
+            value_len > (size_t)(end - p))
+            return NULL;
+        if (pairs) {
+            struct wally_psbt_pair *pair = &pairs[n].pair;
+            pair->type = type;
+            pair->key = key;
+            pair->key_len = key_len;
+            pair->key_data = key_data;
+            pair->key_data_len = key + key_len - key_data;
+            pair->value = p;
+            pair->value_len = value_len;
+            pairs[n].owned = NULL;
+            pairs[n].owned_len = 0;
+        }
+        p += value_len;
+        ++n;
+    }
+    *num_pairs = n;
+    return p;
+}
+
+static int psbt_pair_key_cmp(const void *lhs, const void *rhs)
+{
+    const struct wally_psbt_pair *l = *(const struct wally_psbt_pair *const *)lhs;
+    const struct wally_psbt_pair *r = *(const struct wally_psbt_pair *const *)rhs;
+
+    if (l->key_len != r->key_len)
+        return l->key_len < r->key_len ? -1 : 1;
+    return memcmp(l->key, r->key, l->key_len);
+}
+
+/* Check a map for duplicate keys, using sorted as working space */
+static bool psbt_map_has_duplicates(const struct psbt_map *map,
+                                    const struct wally_psbt_pair **sorted)
+{
+    size_t i;
+
+    if (map->num_pairs < 2)
+        return false;
+    for (i = 0; i < map->num_pairs; ++i)
+        sorted[i] = &map->pairs[i].pair;
+    qsort(sorted, map->num_pairs, sizeof(*sorted), psbt_pair_key_cmp);
+    for (i = 1; i < map->num_pairs; ++i)
+        if (!psbt_pair_key_cmp(&sorted[i - 1], &sorted[i]))
+            return true;
+    return false;
+}
+
+static const struct wally_psbt_pair *psbt_map_find(const struct psbt_map *map,
+                                                   uint64_t type,
+                                                   const unsigned char *key_data,
+                                                   size_t key_data_len,
+                                                   size_t *index)
+{
+    size_t i;
+
+    for (i = 0; i < map->num_pairs; ++i) {
+        const struct wally_psbt_pair *pair = &map->pairs[i].pair;
+        if (pair->type == type && pair->key_data_len == key_data_len &&
+            (!key_data_len || !memcmp(pair->key_data, key_data, key_data_len))) {
+            if (index)
+                *index = i;
+            return pair;
+        }
+    }
+    if (index)
+        *index = map->num_pairs;
+    return NULL;
+}
+
+/* Decode the unsigned transaction from the global map */
+static int psbt_get_unsigned_tx(const struct psbt_map *global, struct wally_tx **output)
+{
+    const struct wally_psbt_pair *pair;
+    uint32_t version;
+    size_t i;
+    int ret;
+
+    pair = psbt_map_find(global, WALLY_PSBT_GLOBAL_VERSION, NULL, 0, NULL);
+    if (pair) {
+        if (pair->value_len != sizeof(uint32_t))
+            return WALLY_EINVAL;
+        uint32_from_le_bytes(pair->value, &version);
+        if (version)
+            return WALLY_EINVAL; /* Only version 0 PSBTs are supported */
+    }
+
+    pair = psbt_map_find(global, WALLY_PSBT_GLOBAL_UNSIGNED_TX, NULL, 0, NULL);
+    if (!pair)
+        return WALLY_EINVAL;
+    ret = wally_tx_from_bytes(pair->value, pair->value_len, 0, output);
+    if (ret != WALLY_OK)
+        return ret;
+
+    /* The unsigned transaction must not contain signatures */
+    for (i = 0; i < (*output)->num_inputs; ++i) {
+        const struct wally_tx_input *input = (*output)->inputs + i;
+        if (input->script_len || (input->witness && input->witness->num_items)) {
+            wally_tx_free(*output);
+            *output = NULL;
+            return WALLY_EINVAL;
+        }
+    }
+    return WALLY_OK;
+}
+
+static struct psbt_map *psbt_get_map(const struct wally_psbt_view *view,
+                                     uint32_t map, size_t index)
+{
+    if (!view)
+        return NULL;
+    switch (map) {
+    case WALLY_PSBT_MAP_GLOBAL:
+        return index ? NULL : view->maps;
+    case WALLY_PSBT_MAP_INPUT:
+        return index < view->tx->num_inputs ? view->maps + 1 + index : NULL;
+    case WALLY_PSBT_MAP_OUTPUT:
+        if (index < view->tx->num_outputs)
+            return view->maps + 1 + view->tx->num_inputs + index;
+        break;
+    }
+    return NULL;
+}
+
+static void psbt_map_free(struct psbt_map *map)
+{
+    size_t i;
+
+    for (i = 0; i < map->num_pairs; ++i)
+        clear_and_free(map->pairs[i].owned, map->pairs[i].owned_len);
+    if (map->pairs_allocation_len)
+        clear_and_free(map->pairs, map->pairs_allocation_len * sizeof(*map->pairs));
+}
+
+int wally_psbt_view_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                               uint32_t flags, struct wally_psbt_view **output)
+{
+    const unsigned char *p, *end = bytes + bytes_len, *maps_start;
+    const struct wally_psbt_pair **sorted = NULL;
+    struct wally_psbt_view *result;
+    struct psbt_map global;
+    struct wally_tx *tx = NULL;
+    struct psbt_pair *pairs;
+    size_t i, num_maps, num_pairs, total_pairs = 0, max_pairs, pairs_offset, maps_offset;
+    size_t allocation_len;
+    int ret;
+
+    if (output)
+        *output = NULL;
+
+    if (!bytes || bytes_len < PSBT_MAGIC_LEN || flags || !output ||
+        memcmp(bytes, PSBT_MAGIC, PSBT_MAGIC_LEN))
+        return WALLY_EINVAL;
+
+    /* Parse the global map first to find the number of inputs and outputs */
+    wally_clear(&global, sizeof(global));
+    global.raw = bytes + PSBT_MAGIC_LEN;
+    if (!(maps_start = psbt_parse_map(global.raw, end, NULL, &global.num_pairs)))
+        return WALLY_EINVAL;
+    global.raw_len = maps_start - global.raw;
+    if (!global.num_pairs)
+        return WALLY_EINVAL;
+    if (!(global.pairs = wally_malloc(global.num_pairs * sizeof(*global.pairs))))
+        return WALLY_ENOMEM;
+    global.pairs_allocation_len = global.num_pairs;
+    psbt_parse_map(global.raw, end, global.pairs, &global.num_pairs);
+    max_pairs = global.num_pairs;
+
+    if ((ret = psbt_get_unsigned_tx(&global, &tx)) != WALLY_OK)
+        goto fail;
+
+    /* Count the pairs of the input and output maps */
+    ret = WALLY_EINVAL;
+    num_maps = 1 + tx->num_inputs + tx->num_outputs;
+    for (i = 1, p = maps_start; i < num_maps; ++i) {
+        if (!(p = psbt_parse_map(p, end, NULL, &num_pairs)))
+            goto fail;
+        total_pairs += num_pairs;
+        if (num_pairs > max_pairs)
+            max_pairs = num_pairs;
+    }
+    if (p != end)
+        goto fail; /* Trailing data */
+
+    /* Allocate the view, then the pairs and maps following it */
+    pairs_offset = PSBT_ALIGN(sizeof(*result));
+    maps_offset = pairs_offset + total_pairs * sizeof(struct psbt_pair);
+    allocation_len = maps_offset + num_maps * sizeof(struct psbt_map);
+    ret = WALLY_ENOMEM;
+    if (!(result = wally_malloc(allocation_len)))
+        goto fail;
+    wally_clear(result, allocation_len);
+    result->tx = tx;
+    result->maps = (struct psbt_map *)((unsigned char *)result + maps_offset);
+    result->num_maps = num_maps;
+    result->allocation_len = allocation_len;
+    result->maps[0] = global;
+    tx = NULL;
+    global.pairs = NULL;
+
+    pairs = (struct psbt_pair *)((unsigned char *)result + pairs_offset);
+    for (i = 1, p = maps_start; i < num_maps; ++i) {
+        struct psbt_map *map = result->maps + i;
+        map->raw = p;
+        map->pairs = pairs;
+        p = psbt_parse_map(p, end, pairs, &map->num_pairs);
+        map->raw_len = p - map->raw;
+        pairs += map->num_pairs;
+    }
+
+    /* Keys must be unique within each map */
+    if (!(sorted = wally_malloc(max_pairs * sizeof(*sorted)))) {
+        wally_psbt_view_free(result);
+        return WALLY_ENOMEM;
+    }
+    for (i = 0; i < num_maps; ++i) {
+        if (psbt_map_has_duplicates(result->maps + i, sorted)) {
+            wally_free(sorted);
+            wally_psbt_view_free(result);
+            return WALLY_EINVAL;
+        }
+    }
+    wally_free(sorted);
+    *output = result;
+    return WALLY_OK;
+
+fail:
+    wally_tx_free(tx);
+    wally_free(global.pairs);
+    return ret;
+}
+
+int wally_psbt_view_free(struct wally_psbt_view *view)
+{
+    size_t i;
+
+    if (view) {
+        wally_tx_free(view->tx);
+        for (i = 0; i < view->num_maps; ++i)
+            psbt_map_free(view->maps + i);
+        clear_and_free(view, view->allocation_len);
+    }
+    return WALLY_OK;
+}
+
+int wally_psbt_view_get_tx(const struct wally_psbt_view *view,
+                           const struct wally_tx **output)
+{
+    if (output)
+        *output = NULL;
+    if (!view || !output)
+        return WALLY_EINVAL;
+    *output = view->tx;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_get_num_pairs(const struct wally_psbt_view *view,
+                                  uint32_t map, size_t index, size_t *written)
+{
+    const struct psbt_map *m = psbt_get_map(view, map, index);
+
+    if (written)
+        *written = 0;
+    if (!m || !written)
+        return WALLY_EINVAL;
+    *written = m->num_pairs;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_get_pair(const struct wally_psbt_view *view,
+                             uint32_t map, size_t index, size_t pair_index,
+                             const struct wally_psbt_pair **output)
+{
+    const struct psbt_map *m = psbt_get_map(view, map, index);
+
+    if (output)
+        *output = NULL;
+    if (!m || pair_index >= m->num_pairs || !output)
+        return WALLY_EINVAL;
+    *output = &m->pairs[pair_index].pair;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_find_pair(const struct wally_psbt_view *view,
+                              uint32_t map, size_t index, uint32_t type,
+                              const unsigned char *key_data, size_t key_data_len,
+                              size_t *written)
+{
+    const struct psbt_map *m = psbt_get_map(view, map, index);
+
+    if (written)
+        *written = 0;
+    if (!m || (!key_data && key_data_len) || !written)
+        return WALLY_EINVAL;
+    psbt_map_find(m, type, key_data, key_data_len, written);
+    return WALLY_OK;
+}
+
+/* Return true if pair is the unsigned transaction of the global map */
+static bool psbt_is_unsigned_tx(const struct wally_psbt_view *view,
+                                const struct psbt_map *map,
+                                const struct wally_psbt_pair *pair)
+{
+    return map == view->maps && pair->type == WALLY_PSBT_GLOBAL_UNSIGNED_TX &&
+           !pair->key_data_len;
+}
+
+static int psbt_map_reserve(struct psbt_map *map, size_t num_pairs)
+{
+    struct psbt_pair *new_pairs;
+    size_t allocation_len = map->pairs_allocation_len;
+
+    if (num_pairs <= allocation_len)
+        return WALLY_OK;
+    if (allocation_len < PSBT_MIN_PAIRS_ALLOCATION)
+        allocation_len = PSBT_MIN_PAIRS_ALLOCATION;
+    while (allocation_len < num_pairs)
+        allocation_len *= 2;
+    if (!(new_pairs = wally_malloc(allocation_len * sizeof(*new_pairs))))
+        return WALLY_ENOMEM;
+    if (map->num_pairs)
+        memcpy(new_pairs, map->pairs, map->num_pairs * sizeof(*new_pairs));
+    if (map->pairs_allocation_len)
+        clear_and_free(map->pairs, map->pairs_allocation_len * sizeof(*map->pairs));
+    map->pairs = new_pairs;
+    map->pairs_allocation_len = allocation_len;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_set_pair(struct wally_psbt_view *view,
+                             uint32_t map, size_t index,
+                             const unsigned char *key, size_t key_len,
+                             const unsigned char *value, size_t value_len)
+{
+    struct psbt_map *m = psbt_get_map(view, map, index);
+    struct psbt_pair *dst = NULL;
+    struct wally_psbt_pair pair;
+    unsigned char *owned;
+    size_t i;
+
+    if (!m || !key || !key_len || (!value && value_len) ||
+        !(pair.key_data = psbt_read_varint(key, key + key_len, &pair.type)))
+        return WALLY_EINVAL;
+    pair.key_data_len = key + key_len - pair.key_data;
+    if (psbt_is_unsigned_tx(view, m, &pair))
+        return WALLY_EINVAL;
+
+    for (i = 0; i < m->num_pairs && !dst; ++i)
+        if (m->pairs[i].pair.key_len == key_len &&
+            !memcmp(m->pairs[i].pair.key, key, key_len))
+            dst = m->pairs + i;
+
+    if (!dst && psbt_map_reserve(m, m->num_pairs + 1) != WALLY_OK)
+        return WALLY_ENOMEM;
+    if (!(owned = wally_malloc(key_len + value_len)))
+        return WALLY_ENOMEM;
+    memcpy(owned, key, key_len);
+    if (value_len)
+        memcpy(owned + key_len, value, value_len);
+
+    if (dst)
+        clear_and_free(dst->owned, dst->owned_len);
+    else
+        dst = m->pairs + m->num_pairs++;
+    dst->pair.type = pair.type;
+    dst->pair.key = owned;
+    dst->pair.key_len = key_len;
+    dst->pair.key_data = owned + key_len - pair.key_data_len;
+    dst->pair.key_data_len = pair.key_data_len;
+    dst->pair.value = owned + key_len;
+    dst->pair.value_len = value_len;
+    dst->owned = owned;
+    dst->owned_len = key_len + value_len;
+    m->raw = NULL;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_remove_pair(struct wally_psbt_view *view,
+                                uint32_t map, size_t index, size_t pair_index)
+{
+    struct psbt_map *m = psbt_get_map(view, map, index);
+    struct psbt_pair *pair;
+
+    if (!m || pair_index >= m->num_pairs)
+        return WALLY_EINVAL;
+    pair = m->pairs + pair_index;
+    if (psbt_is_unsigned_tx(view, m, &pair->pair))
+        return WALLY_EINVAL;
+
+    clear_and_free(pair->owned, pair->owned_len);
+    memmove(pair, pair + 1, (m->num_pairs - pair_index - 1) * sizeof(*pair));
+    --m->num_pairs;
+    m->raw = NULL;
+    return WALLY_OK;
+}
+
+int wally_psbt_view_get_input_satoshi(const struct wally_psbt_view *view,
+                                      size_t index, uint64_t *value_out)
+{
+    const struct psbt_map *m = psbt_get_map(view, WALLY_PSBT_MAP_INPUT, index);
+    const struct wally_tx_input *input;
+    const struct wally_psbt_pair *pair;
+    unsigned char txid[WALLY_TXHASH_LEN];
+    struct wally_tx_view *utxo;
+    uint64_t script_len;
+    int ret;
+
+    if (value_out)
+        *value_out = 0;
+    if (!m || !value_out)
+        return WALLY_EINVAL;
+
+    /* A witness UTXO is its serialized output: the value, then the script */
+    pair = psbt_map_find(m, WALLY_PSBT_IN_WITNESS_UTXO, NULL, 0, NULL);
+    if (pair) {
+        const unsigned char *end = pair->value + pair->value_len, *script;
+        if (pair->value_len < sizeof(uint64_t) ||
+            !(script = psbt_read_varint(pair->value + sizeof(uint64_t), end, &script_len)) ||
+            script_len != (size_t)(end - script))
+            return WALLY_EINVAL;
+        uint64_from_le_bytes(pair->value, value_out);
+        return WALLY_OK;
+    }
+
+    /* Otherwise decode the spent output from the non-witness UTXO */
+    pair = psbt_map_find(m, WALLY_PSBT_IN_NON_WITNESS_UTXO, NULL, 0, NULL);
+    if (!pair)
+        return WALLY_EINVAL;
+    input = view->tx->inputs + index;
+    ret = wally_tx_get_txid_from_bytes(pair->value, pair->value_len, 0,
+                                       txid, sizeof(txid));
+    if (ret == WALLY_OK && memcmp(txid, input->txhash, sizeof(txid)))
+        ret = WALLY_EINVAL; /* The UTXO is not the transaction being spent */
+    if (ret == WALLY_OK)
+        ret = wally_tx_view_from_bytes(pair->value, pair->value_len, 0, &utxo);
+    if (ret == WALLY_OK) {
+        if (input->index < utxo->num_outputs)
+            *value_out = utxo->outputs[input->index].satoshi;
+        else
+            ret = WALLY_EINVAL;
+        wally_tx_view_free(utxo);
+    }
+    return ret;
+}
+
+static size_t psbt_map_get_length(const struct psbt_map *map)
+{
+    size_t i, n = 1; /* Separator */
+
+    if (map->raw)
+        return map->raw_len;
+    for (i = 0; i < map->num_pairs; ++i)
+        n += varbuff_get_length(map->pairs[i].pair.key_len) +
+             varbuff_get_length(map->pairs[i].pair.value_len);
+    return n;
+}
+
+int wally_psbt_view_to_bytes(const struct wally_psbt_view *view, uint32_t flags,
+                             unsigned char *bytes_out, size_t len,
+                             size_t *written)
+{
+    unsigned char *p = bytes_out;
+    size_t i, j, n = PSBT_MAGIC_LEN;
+
+    if (written)
+        *written = 0;
+    if (!view || flags || !bytes_out || !len || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < view->num_maps; ++i)
+        n += psbt_map_get_length(view->maps + i);
+    *written = n;
+    if (n > len)
+        return WALLY_OK; /* Tell the caller how much space is needed */
+
+    memcpy(p, PSBT_MAGIC, PSBT_MAGIC_LEN);
+    p += PSBT_MAGIC_LEN;
+    for (i = 0; i < view->num_maps; ++i) {
+        const struct psbt_map *map = view->maps + i;
+        if (map->raw) {
+            /* Unchanged: copy the map as parsed */
+            memcpy(p, map->raw, map->raw_len);
+            p += map->raw_len;
+            continue;
+        }
+        for (j = 0; j < map->num_pairs; ++j) {
+            const struct wally_psbt_pair *pair = &map->pairs[j].pair;
+            p += varbuff_to_bytes(pair->key, pair->key_len, p);
+            p += varbuff_to_bytes(pair->value, pair->value_len, p);
+        }
+        *p++ = 0; /* Separator */
+    }
+    return WALLY_OK;
+}
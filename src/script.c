@@ -1,8 +1,10 @@
+#define WALLY_STATS_ALLOC_STAT WALLY_STAT_SCRIPT_ALLOC_BYTES
 #include "internal.h"
 
 #include "ccan/ccan/crypto/ripemd160/ripemd160.h"
 #include "ccan/ccan/crypto/sha256/sha256.h"
 
+#include <include/wally_address.h>
 #include <include/wally_crypto.h>
 #include <include/wally_script.h>
 #include <include/wally_transaction.h>
@@ -10,6 +12,7 @@
 #include <limits.h>
 #include <stdbool.h>
 #include "script_int.h"
+#include "hash_table.h"
 
 /* varint tags and limits */
 #define VI_TAG_16 253
@@ -22,6 +25,9 @@
 
 #define ALL_SCRIPT_HASH_FLAGS (WALLY_SCRIPT_HASH160 | WALLY_SCRIPT_SHA256)
 
+/* Number of scripts hashed together by wally_scripts_to_addresses */
+#define ADDRESS_BATCH_SIZE 32
+
 static bool script_flags_ok(uint32_t flags, uint32_t extra_flags)
 {
     if ((flags & ~(ALL_SCRIPT_HASH_FLAGS | extra_flags)) ||
@@ -69,42 +75,101 @@ static size_t calc_push_opcode_size(size_t n)
     return 5;
 }
 
-static int get_push_size(const unsigned char *bytes, size_t bytes_len,
-                         bool get_opcode_size, size_t *size_out)
+static int get_push(const unsigned char *bytes, size_t bytes_len,
+                    size_t *opcode_len_out, size_t *push_len_out)
 {
     size_t opcode_len;
 
-    if (!bytes || !bytes_len || !size_out)
-        return WALLY_EINVAL;
-
     if (bytes[0] < 76) {
         opcode_len = 1;
-        *size_out = bytes[0];
+        *push_len_out = bytes[0];
     } else if (bytes[0] == OP_PUSHDATA1) {
         opcode_len = 2;
         if (bytes_len < opcode_len)
             return WALLY_EINVAL;
-        *size_out = bytes[1];
+        *push_len_out = bytes[1];
     } else if (bytes[0] == OP_PUSHDATA2) {
         leint16_t data_len;
         opcode_len = 3;
         if (bytes_len < opcode_len)
             return WALLY_EINVAL;
         memcpy(&data_len, &bytes[1], sizeof(data_len));
-        *size_out = le16_to_cpu(data_len);
+        *push_len_out = le16_to_cpu(data_len);
     } else if (bytes[0] == OP_PUSHDATA4) {
         leint32_t data_len;
         opcode_len = 5;
         if (bytes_len < opcode_len)
             return WALLY_EINVAL;
         memcpy(&data_len, &bytes[1], sizeof(data_len));
-        *size_out = le32_to_cpu(data_len);
+        *push_len_out = le32_to_cpu(data_len);
     } else
         return WALLY_EINVAL; /* Not a push */
-    if (bytes_len < opcode_len + *size_out)
+    if (*push_len_out > bytes_len - opcode_len)
         return WALLY_EINVAL; /* Push is longer than current script bytes */
-    if (get_opcode_size)
-        *size_out = opcode_len;
+    *opcode_len_out = opcode_len;
+    return WALLY_OK;
+}
+
+static int get_push_size(const unsigned char *bytes, size_t bytes_len,
+                         bool get_opcode_size, size_t *size_out)
+{
+    size_t opcode_len, push_len;
+    int ret;
+
+    if (!bytes || !bytes_len || !size_out)
+        return WALLY_EINVAL;
+
+    ret = get_push(bytes, bytes_len, &opcode_len, &push_len);
+    if (ret == WALLY_OK)
+        *size_out = get_opcode_size ? opcode_len : push_len;
+    return ret;
+}
+
+int wally_script_iterator_init(struct wally_script_iterator *iter,
+                               const unsigned char *bytes, size_t bytes_len)
+{
+    if (!iter || (!bytes && bytes_len))
+        return WALLY_EINVAL;
+
+    iter->bytes = bytes;
+    iter->bytes_len = bytes_len;
+    iter->offset = 0;
+    iter->opcode = 0;
+    iter->push = NULL;
+    iter->push_len = 0;
+    return WALLY_OK;
+}
+
+int wally_script_iterator_next(struct wally_script_iterator *iter,
+                               size_t *written)
+{
+    const unsigned char *p;
+    size_t opcode_len = 1, push_len = 0, remaining;
+
+    if (written)
+        *written = 0;
+
+    if (!iter || !written || iter->offset > iter->bytes_len)
+        return WALLY_EINVAL;
+
+    iter->push = NULL;
+    iter->push_len = 0;
+    if (iter->offset == iter->bytes_len)
+        return WALLY_OK; /* End of script */
+
+    p = iter->bytes + iter->offset;
+    remaining = iter->bytes_len - iter->offset;
+    if (*p <= OP_PUSHDATA4 &&
+        get_push(p, remaining, &opcode_len, &push_len) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    iter->opcode = *p;
+    if (push_len) {
+        iter->push = p + opcode_len;
+        iter->push_len = push_len;
+    }
+    iter->offset += opcode_len + push_len;
+    *written = 1;
     return WALLY_OK;
 }
 
@@ -147,6 +212,90 @@ size_t varint_length_from_bytes(const unsigned char *bytes)
     return sizeof(uint8_t);
 }
 
+size_t varint128_to_bytes(uint64_t v, unsigned char *bytes_out)
+{
+    unsigned char tmp[10];
+    size_t n = 0, i;
+
+    for (;;) {
+        tmp[n] = (v & 0x7f) | (n ? 0x80 : 0);
+        if (v <= 0x7f)
+            break;
+        v = (v >> 7) - 1;
+        ++n;
+    }
+    if (bytes_out)
+        for (i = 0; i <= n; ++i)
+            bytes_out[i] = tmp[n - i];
+    return n + 1;
+}
+
+size_t varint128_from_bytes(const unsigned char *p, const unsigned char *end,
+                            uint64_t *v)
+{
+    const unsigned char *start = p;
+
+    *v = 0;
+    while (p < end) {
+        const unsigned char c = *p++;
+        if (*v > (UINT64_MAX >> 7))
+            return 0; /* Overflow */
+        *v = (*v << 7) | (c & 0x7f);
+        if (!(c & 0x80))
+            return p - start;
+        if (*v == UINT64_MAX)
+            return 0; /* Overflow */
+        ++*v;
+    }
+    return 0; /* Truncated */
+}
+
+uint64_t satoshi_compress(uint64_t satoshi)
+{
+    uint64_t e = 0, d;
+
+    if (!satoshi)
+        return 0;
+    while (!(satoshi % 10) && e < 9) {
+        satoshi /= 10;
+        ++e;
+    }
+    if (e == 9)
+        return 1 + (satoshi - 1) * 10 + 9;
+    d = satoshi % 10;
+    return 1 + ((satoshi / 10) * 9 + d - 1) * 10 + e;
+}
+
+bool satoshi_decompress(uint64_t v, uint64_t *satoshi)
+{
+    uint64_t e;
+
+    if (!v) {
+        *satoshi = 0;
+        return true;
+    }
+    --v;
+    e = v % 10;
+    v /= 10;
+    if (e < 9) {
+        const uint64_t d = v % 9 + 1;
+        v /= 9;
+        if (v > SATOSHI_MAX_MONEY / 10)
+            return false;
+        *satoshi = v * 10 + d;
+    } else {
+        if (v >= SATOSHI_MAX_MONEY)
+            return false;
+        *satoshi = v + 1;
+    }
+    for (; e; --e) {
+        if (*satoshi > SATOSHI_MAX_MONEY / 10)
+            return false;
+        *satoshi *= 10;
+    }
+    return *satoshi <= SATOSHI_MAX_MONEY;
+}
+
 /* Get the length of a script integer in bytes. signed_v should not be
  * larger than int32_t (i.e. +/- 31 bits)
  */
@@ -295,12 +444,15 @@ size_t confidential_value_to_bytes(const unsigned char *bytes, size_t bytes_len,
 
 static bool scriptpubkey_is_op_return(const unsigned char *bytes, size_t bytes_len)
 {
-    size_t n_op, n_push;
+    struct wally_script_iterator iter;
+    size_t written;
 
+    /* OP_RETURN followed by a single push */
     return bytes_len && bytes[0] == OP_RETURN &&
-           get_push_size(bytes + 1, bytes_len - 1, true, &n_op) == WALLY_OK &&
-           get_push_size(bytes + 1, bytes_len - 1, false, &n_push) == WALLY_OK &&
-           bytes_len == 1 + n_op + n_push;
+           wally_script_iterator_init(&iter, bytes + 1, bytes_len - 1) == WALLY_OK &&
+           wally_script_iterator_next(&iter, &written) == WALLY_OK &&
+           written && iter.opcode <= OP_PUSHDATA4 &&
+           iter.offset == iter.bytes_len;
 }
 
 static bool scriptpubkey_is_p2pkh(const unsigned char *bytes, size_t bytes_len)
@@ -336,25 +488,56 @@ static bool scriptpubkey_is_p2wsh(const unsigned char *bytes, size_t bytes_len)
 static bool scriptpubkey_is_multisig(const unsigned char *bytes, size_t bytes_len)
 {
     const size_t min_1of1_len = 1 + 1 + 33 + 1 + 1; /* OP_1 [pubkey] OP_1 OP_CHECKMULTISIG */
-    size_t i, n_pushes;
+    struct wally_script_iterator iter;
+    size_t i, n_pushes, written;
 
     if (bytes_len < min_1of1_len || !is_op_n(bytes[0], false, NULL) ||
         bytes[bytes_len - 1] != OP_CHECKMULTISIG ||
         !is_op_n(bytes[bytes_len - 2], false, &n_pushes))
         return false;
 
-    ++bytes;
-    --bytes_len;
+    /* Iterate the pubkey pushes between OP_N and OP_N OP_CHECKMULTISIG */
+    if (wally_script_iterator_init(&iter, bytes + 1, bytes_len - 3) != WALLY_OK)
+        return false;
     for (i = 0; i < n_pushes; ++i) {
-        size_t n_op, n_push;
-        if (get_push_size(bytes, bytes_len, true, &n_op) != WALLY_OK ||
-            get_push_size(bytes, bytes_len, false, &n_push) != WALLY_OK ||
-            !is_pk_len(n_push) || bytes_len < n_op + n_push + 2)
+        if (wally_script_iterator_next(&iter, &written) != WALLY_OK ||
+            !written || !is_pk_len(iter.push_len))
             return false;
-        bytes += n_op + n_push;
-        bytes_len -= n_op + n_push;
     }
-    return bytes_len == 2;
+    return iter.offset == iter.bytes_len;
+}
+
+size_t scriptpubkey_get_type(const unsigned char *bytes, size_t bytes_len)
+{
+    if (!bytes_len)
+        return WALLY_SCRIPT_TYPE_UNKNOWN;
+
+    /* Dispatch on the first opcode: at most one candidate type can match */
+    switch (bytes[0]) {
+    case OP_0:
+        if (scriptpubkey_is_p2wpkh(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_P2WPKH;
+        if (scriptpubkey_is_p2wsh(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_P2WSH;
+        break;
+    case OP_DUP:
+        if (scriptpubkey_is_p2pkh(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_P2PKH;
+        break;
+    case OP_HASH160:
+        if (scriptpubkey_is_p2sh(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_P2SH;
+        break;
+    case OP_RETURN:
+        if (scriptpubkey_is_op_return(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_OP_RETURN;
+        break;
+    default:
+        if (scriptpubkey_is_multisig(bytes, bytes_len))
+            return WALLY_SCRIPT_TYPE_MULTISIG;
+        break;
+    }
+    return WALLY_SCRIPT_TYPE_UNKNOWN;
 }
 
 int wally_scriptpubkey_get_type(const unsigned char *bytes, size_t bytes_len,
@@ -366,42 +549,7 @@ int wally_scriptpubkey_get_type(const unsigned char *bytes, size_t bytes_len,
     if (!bytes || !bytes_len || !written)
         return WALLY_EINVAL;
 
-    if (scriptpubkey_is_op_return(bytes, bytes_len)) {
-        *written = WALLY_SCRIPT_TYPE_OP_RETURN;
-        return WALLY_OK;
-    }
-
-    if (scriptpubkey_is_multisig(bytes, bytes_len)) {
-        *written = WALLY_SCRIPT_TYPE_MULTISIG;
-        return WALLY_OK;
-    }
-
-    switch (bytes_len) {
-    case WALLY_SCRIPTPUBKEY_P2PKH_LEN:
-        if (scriptpubkey_is_p2pkh(bytes, bytes_len)) {
-            *written = WALLY_SCRIPT_TYPE_P2PKH;
-            return WALLY_OK;
-        }
-        break;
-    case WALLY_SCRIPTPUBKEY_P2SH_LEN:
-        if (scriptpubkey_is_p2sh(bytes, bytes_len)) {
-            *written = WALLY_SCRIPT_TYPE_P2SH;
-            return WALLY_OK;
-        }
-        break;
-    case WALLY_SCRIPTPUBKEY_P2WPKH_LEN:
-        if (scriptpubkey_is_p2wpkh(bytes, bytes_len)) {
-            *written = WALLY_SCRIPT_TYPE_P2WPKH;
-            return WALLY_OK;
-        }
-        break;
-    case WALLY_SCRIPTPUBKEY_P2WSH_LEN:
-        if (scriptpubkey_is_p2wsh(bytes, bytes_len)) {
-            *written = WALLY_SCRIPT_TYPE_P2WSH;
-            return WALLY_OK;
-        }
-        break;
-    }
+    *written = scriptpubkey_get_type(bytes, bytes_len);
     return WALLY_OK;
 }
 
@@ -462,6 +610,42 @@ int wally_scriptsig_p2pkh_from_sig(const unsigned char *pub_key, size_t pub_key_
     return ret;
 }
 
+int wally_witness_p2wpkh_from_sig(const unsigned char *pub_key, size_t pub_key_len,
+                                  const unsigned char *sig, size_t sig_len,
+                                  uint32_t sighash,
+                                  unsigned char *bytes_out, size_t len, size_t *written)
+{
+    unsigned char buff[EC_SIGNATURE_DER_MAX_LEN + 1];
+    unsigned char *p = bytes_out;
+    size_t der_len;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (!pub_key || pub_key_len != EC_PUBLIC_KEY_LEN ||
+        (sighash & 0xffffff00) || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    ret = wally_ec_sig_to_der(sig, sig_len, buff, sizeof(buff), &der_len);
+    if (ret == WALLY_OK) {
+        buff[der_len++] = sighash & 0xff;
+        /* The item count, then the signature and pubkey with their lengths */
+        if (len < 3 + der_len + pub_key_len)
+            ret = WALLY_EINVAL;
+        else {
+            *p++ = 2;
+            *p++ = der_len;
+            memcpy(p, buff, der_len);
+            p += der_len;
+            *p++ = pub_key_len;
+            memcpy(p, pub_key, pub_key_len);
+            *written = 3 + der_len + pub_key_len;
+        }
+        wally_clear(buff, der_len);
+    }
+    return ret;
+}
+
 int wally_scriptsig_p2pkh_from_der(
     const unsigned char *pub_key, size_t pub_key_len,
     const unsigned char *sig, size_t sig_len,
@@ -547,14 +731,16 @@ int wally_scriptpubkey_multisig_from_bytes(
 {
     size_t n_pubkeys = bytes_len / EC_PUBLIC_KEY_LEN;
     size_t script_len = 3 + (n_pubkeys * (EC_PUBLIC_KEY_LEN + 1));
-    size_t i;
+    unsigned char order[16];
+    size_t i, j;
 
     if (written)
         *written = 0;
 
     if (!bytes || !bytes_len || bytes_len % EC_PUBLIC_KEY_LEN ||
         n_pubkeys < 1 || n_pubkeys > 16 || threshold < 1 || threshold > 16 ||
-        threshold > n_pubkeys || flags || !bytes_out || !written)
+        threshold > n_pubkeys || (flags & ~WALLY_SCRIPT_MULTISIG_SORTED) ||
+        !bytes_out || !written)
         return WALLY_EINVAL;
 
     if (len < script_len) {
@@ -562,12 +748,21 @@ int wally_scriptpubkey_multisig_from_bytes(
         return WALLY_OK;
     }
 
+    /* Determine the order to write the keys in. For BIP67 sorting we
+     * insertion sort the key indices rather than copying the keys */
+    for (i = 0; i < n_pubkeys; ++i) {
+        for (j = i; j > 0 && (flags & WALLY_SCRIPT_MULTISIG_SORTED) &&
+             memcmp(bytes + order[j - 1] * EC_PUBLIC_KEY_LEN,
+                    bytes + i * EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN) > 0; --j)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+
     *bytes_out++ = v_to_op_n(threshold);
     for (i = 0; i < n_pubkeys; ++i) {
         *bytes_out++ = EC_PUBLIC_KEY_LEN;
-        memcpy(bytes_out, bytes, EC_PUBLIC_KEY_LEN);
+        memcpy(bytes_out, bytes + order[i] * EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN);
         bytes_out += EC_PUBLIC_KEY_LEN;
-        bytes += EC_PUBLIC_KEY_LEN;
     }
     *bytes_out++ = v_to_op_n(n_pubkeys);
     *bytes_out = OP_CHECKMULTISIG;
@@ -641,12 +836,67 @@ cleanup:
     return ret;
 }
 
+int wally_scriptsig_multisig_from_der(
+    const unsigned char *script, size_t script_len,
+    const unsigned char *bytes, size_t bytes_len,
+    const uint32_t *lens, size_t lens_len, uint32_t flags,
+    unsigned char *bytes_out, size_t len, size_t *written)
+{
+    size_t i, n, required = 0, total = 0;
+
+    if (written)
+        *written = 0;
+
+    if (!script || !script_len || !bytes || !bytes_len ||
+        !lens || lens_len < 1 || lens_len > 16 ||
+        flags || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < lens_len; ++i) {
+        if (!lens[i] || lens[i] > EC_SIGNATURE_DER_MAX_LEN + 1)
+            return WALLY_EINVAL;
+        total += lens[i];
+        required += calc_push_opcode_size(lens[i]) + lens[i];
+    }
+    if (total != bytes_len)
+        return WALLY_EINVAL;
+
+    /* Account for the initial OP_0 and final script push */
+    required += 1 + calc_push_opcode_size(script_len) + script_len;
+
+    if (len < required) {
+        *written = required;
+        return WALLY_OK;
+    }
+
+    /* Each signature is shorter than OP_PUSHDATA1, so is pushed using
+     * its length as the opcode; copy the signatures directly */
+    *bytes_out++ = OP_0;
+    for (i = 0; i < lens_len; ++i) {
+        *bytes_out++ = lens[i];
+        memcpy(bytes_out, bytes, lens[i]);
+        bytes_out += lens[i];
+        bytes += lens[i];
+    }
+    n = required - (1 + total + lens_len);
+    if (wally_script_push_from_bytes(script, script_len, 0,
+                                     bytes_out, n, &n) != WALLY_OK)
+        return WALLY_ERROR; /* Required length mismatch, should not happen! */
+    *written = required;
+    return WALLY_OK;
+}
+
 int wally_scriptpubkey_csv_2of2_then_1_from_bytes(
     const unsigned char *bytes, size_t bytes_len, uint32_t csv_blocks,
     uint32_t flags, unsigned char *bytes_out, size_t len, size_t *written)
 {
+    static const unsigned char start[] = { OP_DEPTH, OP_1SUB, OP_IF };
+    static const unsigned char csv_start[] = { OP_CHECKSIGVERIFY, OP_ELSE };
+    static const unsigned char csv_end[] = { OP_CHECKSEQUENCEVERIFY, OP_DROP, OP_ENDIF };
     size_t csv_len = scriptint_get_length(csv_blocks);
     size_t script_len = 2 * (EC_PUBLIC_KEY_LEN + 1) + 9 + 1 + csv_len; /* 1 for push */
+    struct wally_script_writer writer;
+    unsigned char csv[sizeof(uint32_t) + 1];
 
     if (written)
         *written = 0;
@@ -674,23 +924,16 @@ int wally_scriptpubkey_csv_2of2_then_1_from_bytes(
      *     # Check the recovery signature
      *     <recovery_pubkey> OP_CHECKSIG
      */
-    *bytes_out++ = OP_DEPTH;
-    *bytes_out++ = OP_1SUB;
-    *bytes_out++ = OP_IF;
-    *bytes_out++ = EC_PUBLIC_KEY_LEN;
-    memcpy(bytes_out, bytes, EC_PUBLIC_KEY_LEN);
-    bytes_out += EC_PUBLIC_KEY_LEN;
-    *bytes_out++ = OP_CHECKSIGVERIFY;
-    *bytes_out++ = OP_ELSE;
-    *bytes_out++ = csv_len & 0xff;
-    bytes_out += scriptint_to_bytes(csv_blocks, bytes_out);
-    *bytes_out++ = OP_CHECKSEQUENCEVERIFY;
-    *bytes_out++ = OP_DROP;
-    *bytes_out++ = OP_ENDIF;
-    *bytes_out++ = EC_PUBLIC_KEY_LEN;
-    memcpy(bytes_out, bytes + EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN);
-    bytes_out += EC_PUBLIC_KEY_LEN;
-    *bytes_out++ = OP_CHECKSIG;
+    if (wally_script_writer_init(&writer, bytes_out, len, 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, start, sizeof(start)) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, bytes, EC_PUBLIC_KEY_LEN, 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, csv_start, sizeof(csv_start)) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, csv, scriptint_to_bytes(csv_blocks, csv), 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, csv_end, sizeof(csv_end)) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, bytes + EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN, 0) != WALLY_OK ||
+        wally_script_writer_add_opcode(&writer, OP_CHECKSIG) != WALLY_OK ||
+        writer.written != script_len)
+        return WALLY_ERROR; /* Required length mismatch, should not happen! */
 
     *written = script_len;
     return WALLY_OK;
@@ -700,8 +943,15 @@ int wally_scriptpubkey_csv_2of3_then_2_from_bytes(
     const unsigned char *bytes, size_t bytes_len, uint32_t csv_blocks,
     uint32_t flags, unsigned char *bytes_out, size_t len, size_t *written)
 {
+    static const unsigned char start[] = { OP_DEPTH, OP_1SUB, OP_1SUB, OP_IF, OP_2 };
+    static const unsigned char csv_end[] = {
+        OP_CHECKSEQUENCEVERIFY, OP_DROP, OP_1, OP_0, OP_ENDIF
+    };
+    static const unsigned char end[] = { OP_3, OP_CHECKMULTISIG };
     size_t csv_len = scriptint_get_length(csv_blocks);
     size_t script_len = 3 * (EC_PUBLIC_KEY_LEN + 1) + 13 + 1 + csv_len; /* 1 for push */
+    struct wally_script_writer writer;
+    unsigned char csv[sizeof(uint32_t) + 1];
 
     if (written)
         *written = 0;
@@ -733,30 +983,17 @@ int wally_scriptpubkey_csv_2of3_then_2_from_bytes(
      *     # Shared code to check the signatures provided
      *     <recovery_pubkey> <recovery_pubkey_2> OP_3 OP_CHECKMULTISIG
      */
-    *bytes_out++ = OP_DEPTH;
-    *bytes_out++ = OP_1SUB;
-    *bytes_out++ = OP_1SUB;
-    *bytes_out++ = OP_IF;
-    *bytes_out++ = OP_2;
-    *bytes_out++ = EC_PUBLIC_KEY_LEN;
-    memcpy(bytes_out, bytes, EC_PUBLIC_KEY_LEN);
-    bytes_out += EC_PUBLIC_KEY_LEN;
-    *bytes_out++ = OP_ELSE;
-    *bytes_out++ = csv_len & 0xff;
-    bytes_out += scriptint_to_bytes(csv_blocks, bytes_out);
-    *bytes_out++ = OP_CHECKSEQUENCEVERIFY;
-    *bytes_out++ = OP_DROP;
-    *bytes_out++ = OP_1;
-    *bytes_out++ = OP_0;
-    *bytes_out++ = OP_ENDIF;
-    *bytes_out++ = EC_PUBLIC_KEY_LEN;
-    memcpy(bytes_out, bytes + EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN);
-    bytes_out += EC_PUBLIC_KEY_LEN;
-    *bytes_out++ = EC_PUBLIC_KEY_LEN;
-    memcpy(bytes_out, bytes + EC_PUBLIC_KEY_LEN * 2, EC_PUBLIC_KEY_LEN);
-    bytes_out += EC_PUBLIC_KEY_LEN;
-    *bytes_out++ = OP_3;
-    *bytes_out++ = OP_CHECKMULTISIG;
+    if (wally_script_writer_init(&writer, bytes_out, len, 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, start, sizeof(start)) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, bytes, EC_PUBLIC_KEY_LEN, 0) != WALLY_OK ||
+        wally_script_writer_add_opcode(&writer, OP_ELSE) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, csv, scriptint_to_bytes(csv_blocks, csv), 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, csv_end, sizeof(csv_end)) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, bytes + EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN, 0) != WALLY_OK ||
+        wally_script_writer_add_push(&writer, bytes + EC_PUBLIC_KEY_LEN * 2, EC_PUBLIC_KEY_LEN, 0) != WALLY_OK ||
+        wally_script_writer_add_bytes(&writer, end, sizeof(end)) != WALLY_OK ||
+        writer.written != script_len)
+        return WALLY_ERROR; /* Required length mismatch, should not happen! */
 
     *written = script_len;
     return WALLY_OK;
@@ -774,39 +1011,30 @@ int script_get_push_opcode_size_from_bytes(
     return get_push_size(bytes, bytes_len, true, size_out);
 }
 
-int wally_script_push_from_bytes(const unsigned char *bytes, size_t bytes_len,
-                                 uint32_t flags,
-                                 unsigned char *bytes_out, size_t len,
-                                 size_t *written)
+/* Hash the data to push in place of itself if flags requests it */
+static int push_hash(const unsigned char **bytes, size_t *bytes_len,
+                     uint32_t flags, unsigned char *buff)
 {
-    unsigned char buff[SHA256_LEN];
-    size_t opcode_len;
     int ret = WALLY_OK;
 
-    if (written)
-        *written = 0;
-
-    if ((bytes_len && !bytes) || !script_flags_ok(flags, 0) ||
-        !bytes_out || !len || !written)
-        return WALLY_EINVAL;
-
     if (flags & WALLY_SCRIPT_HASH160) {
-        ret = wally_hash160(bytes, bytes_len, buff, HASH160_LEN);
-        bytes = buff;
-        bytes_len = HASH160_LEN;
+        ret = wally_hash160(*bytes, *bytes_len, buff, HASH160_LEN);
+        *bytes = buff;
+        *bytes_len = HASH160_LEN;
     } else if (flags & WALLY_SCRIPT_SHA256) {
-        ret = wally_sha256(bytes, bytes_len, buff, SHA256_LEN);
-        bytes = buff;
-        bytes_len = SHA256_LEN;
+        ret = wally_sha256(*bytes, *bytes_len, buff, SHA256_LEN);
+        *bytes = buff;
+        *bytes_len = SHA256_LEN;
     }
-    if (ret != WALLY_OK)
-        goto cleanup;
-
-    opcode_len = calc_push_opcode_size(bytes_len);
+    return ret;
+}
 
-    *written = bytes_len + opcode_len;
-    if (len < *written)
-        return WALLY_OK; /* Caller needs to pass a bigger buffer */
+/* Write a push of bytes, which requires calc_push_opcode_size(bytes_len)
+ * plus bytes_len bytes */
+static void push_write(const unsigned char *bytes, size_t bytes_len,
+                       unsigned char *bytes_out)
+{
+    const size_t opcode_len = calc_push_opcode_size(bytes_len);
 
     if (bytes_len < 76)
         bytes_out[0] = bytes_len;
@@ -824,12 +1052,152 @@ int wally_script_push_from_bytes(const unsigned char *bytes, size_t bytes_len,
     }
     if (bytes_len)
         memcpy(bytes_out + opcode_len, bytes, bytes_len);
+}
 
-cleanup:
+int wally_script_push_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                 uint32_t flags,
+                                 unsigned char *bytes_out, size_t len,
+                                 size_t *written)
+{
+    unsigned char buff[SHA256_LEN];
+    int ret;
+
+    if (written)
+        *written = 0;
+
+    if ((bytes_len && !bytes) || !script_flags_ok(flags, 0) ||
+        !bytes_out || !len || !written)
+        return WALLY_EINVAL;
+
+    ret = push_hash(&bytes, &bytes_len, flags, buff);
+    if (ret == WALLY_OK) {
+        *written = bytes_len + calc_push_opcode_size(bytes_len);
+        if (len >= *written)
+            push_write(bytes, bytes_len, bytes_out);
+        /* Otherwise the caller needs to pass a bigger buffer */
+    }
+    wally_clear(buff, sizeof(buff));
+    return ret;
+}
+
+int wally_script_writer_init(struct wally_script_writer *writer,
+                             unsigned char *bytes_out, size_t len,
+                             uint32_t flags)
+{
+    const bool grow = flags & WALLY_SCRIPT_WRITER_FLAG_GROW;
+
+    if (writer)
+        wally_clear(writer, sizeof(*writer));
+
+    if (!writer || (flags & ~WALLY_SCRIPT_WRITER_FLAG_GROW) ||
+        (grow ? bytes_out != NULL : (!bytes_out && len)))
+        return WALLY_EINVAL;
+
+    if (grow && len && !(bytes_out = wally_malloc(len)))
+        return WALLY_ENOMEM;
+    writer->bytes = bytes_out;
+    writer->len = len;
+    writer->flags = flags;
+    return WALLY_OK;
+}
+
+int wally_script_writer_free(struct wally_script_writer *writer)
+{
+    if (!writer)
+        return WALLY_EINVAL;
+    if ((writer->flags & WALLY_SCRIPT_WRITER_FLAG_GROW) && writer->bytes) {
+        wally_clear(writer->bytes, writer->len);
+        wally_free(writer->bytes);
+    }
+    wally_clear(writer, sizeof(*writer));
+    return WALLY_OK;
+}
+
+/* Reserve n more bytes of the script. Returns the location to write them
+ * to in *p, or NULL if they don't fit in the caller's buffer */
+static int writer_reserve(struct wally_script_writer *writer, size_t n,
+                          unsigned char **p)
+{
+    const size_t required = writer->written + n;
+
+    *p = NULL;
+    if (required < writer->written)
+        return WALLY_EINVAL; /* Overflow */
+
+    if (required > writer->len && (writer->flags & WALLY_SCRIPT_WRITER_FLAG_GROW)) {
+        size_t new_len = writer->len * 2 > required ? writer->len * 2 : required;
+        unsigned char *new_bytes = wally_realloc(writer->bytes, writer->len, new_len);
+        if (!new_bytes)
+            return WALLY_ENOMEM;
+        writer->bytes = new_bytes;
+        writer->len = new_len;
+    }
+    if (required <= writer->len)
+        *p = writer->bytes + writer->written;
+    writer->written = required;
+    return WALLY_OK;
+}
+
+int wally_script_writer_add_opcode(struct wally_script_writer *writer,
+                                   uint32_t opcode)
+{
+    unsigned char *p;
+    int ret;
+
+    if (!writer || opcode > 0xff)
+        return WALLY_EINVAL;
+    if ((ret = writer_reserve(writer, 1, &p)) == WALLY_OK && p)
+        *p = (unsigned char)opcode;
+    return ret;
+}
+
+int wally_script_writer_add_bytes(struct wally_script_writer *writer,
+                                  const unsigned char *bytes, size_t bytes_len)
+{
+    unsigned char *p;
+    int ret;
+
+    if (!writer || (!bytes && bytes_len))
+        return WALLY_EINVAL;
+    if ((ret = writer_reserve(writer, bytes_len, &p)) == WALLY_OK && p && bytes_len)
+        memcpy(p, bytes, bytes_len);
+    return ret;
+}
+
+int wally_script_writer_add_push(struct wally_script_writer *writer,
+                                 const unsigned char *bytes, size_t bytes_len,
+                                 uint32_t flags)
+{
+    unsigned char buff[SHA256_LEN], *p;
+    int ret;
+
+    if (!writer || (bytes_len && !bytes) || !script_flags_ok(flags, 0))
+        return WALLY_EINVAL;
+
+    ret = push_hash(&bytes, &bytes_len, flags, buff);
+    if (ret == WALLY_OK)
+        ret = writer_reserve(writer, bytes_len + calc_push_opcode_size(bytes_len), &p);
+    if (ret == WALLY_OK && p)
+        push_write(bytes, bytes_len, p);
     wally_clear(buff, sizeof(buff));
     return ret;
 }
 
+int wally_script_writer_add_int(struct wally_script_writer *writer,
+                                int64_t value)
+{
+    unsigned char buff[sizeof(int64_t) + 1];
+
+    if (!writer || value == INT64_MIN)
+        return WALLY_EINVAL;
+
+    if (value == -1)
+        return wally_script_writer_add_opcode(writer, OP_1NEGATE);
+    if (value >= 0 && value <= 16)
+        return wally_script_writer_add_opcode(writer, v_to_op_n((uint64_t)value));
+    return wally_script_writer_add_push(writer, buff, scriptint_to_bytes(value, buff), 0);
+}
+
 int wally_witness_program_from_bytes(const unsigned char *bytes, size_t bytes_len,
                                      uint32_t flags,
                                      unsigned char *bytes_out, size_t len, size_t *written)
@@ -872,3 +1240,350 @@ int wally_witness_program_from_bytes(const unsigned char *bytes, size_t bytes_le
     }
     return ret;
 }
+
+int wally_scripts_to_addresses(const unsigned char *bytes, size_t bytes_len,
+                               size_t item_len, uint32_t script_type,
+                               const char *addr_family, uint32_t version,
+                               uint32_t flags, unsigned char *bytes_out,
+                               size_t len, char *output, size_t output_len,
+                               size_t *written)
+{
+    const bool is_p2sh = script_type & WALLY_SCRIPT_TYPE_P2SH;
+    const bool is_p2wsh = script_type & WALLY_SCRIPT_TYPE_P2WSH;
+    const size_t spk_len = is_p2sh ? WALLY_SCRIPTPUBKEY_P2SH_LEN : WALLY_SCRIPTPUBKEY_P2WSH_LEN;
+    struct sha256 sha[ADDRESS_BATCH_SIZE];
+    unsigned char programs[ADDRESS_BATCH_SIZE * WALLY_SCRIPTPUBKEY_P2WSH_LEN];
+    unsigned char spk[WALLY_SCRIPTPUBKEY_P2WSH_LEN], payload[1 + HASH160_LEN];
+    struct ripemd160 ripemd[ADDRESS_BATCH_SIZE];
+    size_t i, j, n, num_items, total = 0;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!bytes || !bytes_len || !item_len || bytes_len % item_len ||
+        (script_type & ~(WALLY_SCRIPT_TYPE_P2SH | WALLY_SCRIPT_TYPE_P2WSH)) ||
+        (!is_p2sh && !is_p2wsh) || (!is_p2sh && !addr_family) ||
+        (is_p2sh && (version & ~0xff)) || flags || !output || !written)
+        return WALLY_EINVAL;
+
+    num_items = bytes_len / item_len;
+    if (bytes_out ? len != num_items * spk_len : len != 0)
+        return WALLY_EINVAL;
+
+    payload[0] = version & 0xff;
+
+    for (i = 0; i < num_items && ret == WALLY_OK; i += n) {
+        n = num_items - i < ADDRESS_BATCH_SIZE ? num_items - i : ADDRESS_BATCH_SIZE;
+        sha256_batch(sha, bytes + i * item_len, item_len, n);
+
+        if (is_p2sh && is_p2wsh) {
+            /* Hash the P2WSH witness programs to wrap in P2SH */
+            for (j = 0; j < n; ++j) {
+                unsigned char *p = programs + j * WALLY_SCRIPTPUBKEY_P2WSH_LEN;
+                p[0] = OP_0;
+                p[1] = SHA256_LEN;
+                memcpy(p + 2, &sha[j], SHA256_LEN);
+            }
+            sha256_batch(sha, programs, WALLY_SCRIPTPUBKEY_P2WSH_LEN, n);
+        }
+        if (is_p2sh)
+            ripemd160_32_batch(ripemd, sha, n);
+
+        for (j = 0; j < n && ret == WALLY_OK; ++j) {
+            /* Once output is full, only compute the required length */
+            const size_t remaining = total < output_len ? output_len - total : 0;
+            char *str_out = remaining ? output + total : output;
+            unsigned char *p = bytes_out ? bytes_out + (i + j) * spk_len : spk;
+            size_t str_len;
+
+            if (is_p2sh) {
+                p[0] = OP_HASH160;
+                p[1] = HASH160_LEN;
+                memcpy(p + 2, &ripemd[j], HASH160_LEN);
+                p[WALLY_SCRIPTPUBKEY_P2SH_LEN - 1] = OP_EQUAL;
+                memcpy(payload + 1, &ripemd[j], HASH160_LEN);
+                ret = wally_base58_from_bytes_to_buffer(payload, sizeof(payload),
+                                                        BASE58_FLAG_CHECKSUM,
+                                                        str_out, remaining, &str_len);
+            } else {
+                p[0] = OP_0;
+                p[1] = SHA256_LEN;
+                memcpy(p + 2, &sha[j], SHA256_LEN);
+                ret = wally_addr_segwit_from_bytes_to_buffer(p, spk_len, addr_family, 0,
+                                                             str_out, remaining, &str_len);
+            }
+            total += str_len;
+        }
+    }
+
+    wally_clear_3(sha, sizeof(sha), programs, sizeof(programs), ripemd, sizeof(ripemd));
+    if (ret == WALLY_OK)
+        *written = total;
+    else {
+        if (bytes_out)
+            wally_clear(bytes_out, len);
+        wally_clear(output, output_len);
+    }
+    return ret;
+}
+
+struct wally_script_watchset {
+    uint32_t flags;
+    /* The scripts in the set. An entry's item is the offset of its key in
+     * keys plus 1, and extra is the length of the key */
+    struct hash_table table;
+    unsigned char *keys; /* The stored scripts or script hashes */
+    size_t keys_len;
+    size_t keys_allocation_len;
+};
+
+/* A script or script hash to find in a watch set */
+struct watchset_key {
+    const unsigned char *bytes;
+    size_t len;
+};
+
+static size_t watchset_key_len(const struct wally_script_watchset *set,
+                               size_t bytes_len)
+{
+    if (set->flags & WALLY_SCRIPT_HASH160)
+        return HASH160_LEN;
+    if (set->flags & WALLY_SCRIPT_SHA256)
+        return SHA256_LEN;
+    return bytes_len;
+}
+
+/* Get the key stored for a script: either the script itself or its hash */
+static const unsigned char *watchset_key(const struct wally_script_watchset *set,
+                                         const unsigned char *bytes, size_t bytes_len,
+                                         unsigned char *buff, size_t *key_len)
+{
+    if (set->flags & WALLY_SCRIPT_HASH160) {
+        wally_hash160(bytes, bytes_len, buff, HASH160_LEN);
+        *key_len = HASH160_LEN;
+        return buff;
+    }
+    if (set->flags & WALLY_SCRIPT_SHA256) {
+        wally_sha256(bytes, bytes_len, buff, SHA256_LEN);
+        *key_len = SHA256_LEN;
+        return buff;
+    }
+    *key_len = bytes_len;
+    return bytes;
+}
+
+static bool watchset_entry_matches(const void *ctx, const struct hash_table_entry *entry,
+                                   const void *key_in)
+{
+    const struct wally_script_watchset *set = ctx;
+    const struct watchset_key *key = key_in;
+    return entry->extra == key->len &&
+           !memcmp(set->keys + entry->item - 1, key->bytes, key->len);
+}
+
+/* Ensure that num_items more keys totalling keys_len bytes can be inserted */
+static int watchset_reserve(struct wally_script_watchset *set,
+                            size_t num_items, size_t keys_len)
+{
+    if (keys_len > set->keys_allocation_len - set->keys_len) {
+        size_t new_len = set->keys_allocation_len * 2;
+        unsigned char *new_keys;
+
+        if (keys_len > SIZE_MAX / 2 - set->keys_len)
+            return WALLY_ENOMEM;
+        if (new_len < set->keys_len + keys_len)
+            new_len = set->keys_len + keys_len;
+        if (!(new_keys = wally_malloc(new_len)))
+            return WALLY_ENOMEM;
+        if (set->keys_len)
+            memcpy(new_keys, set->keys, set->keys_len);
+        clear_and_free(set->keys, set->keys_allocation_len);
+        set->keys = new_keys;
+        set->keys_allocation_len = new_len;
+    }
+
+    return hash_table_reserve(&set->table, num_items);
+}
+
+/* Insert a script into a set with space reserved for it */
+static void watchset_insert(struct wally_script_watchset *set,
+                            const unsigned char *bytes, size_t bytes_len)
+{
+    unsigned char buff[SHA256_LEN];
+    struct watchset_key key;
+    struct hash_table_entry *entry;
+    uint64_t hash;
+
+    key.bytes = watchset_key(set, bytes, bytes_len, buff, &key.len);
+    hash = hash_table_hash(&set->table, key.bytes, key.len);
+    entry = hash_table_find(&set->table, hash, watchset_entry_matches, set, &key);
+    if (!entry->item) {
+        memcpy(set->keys + set->keys_len, key.bytes, key.len);
+        hash_table_insert(&set->table, entry, hash, set->keys_len + 1, key.len);
+        set->keys_len += key.len;
+    }
+    wally_clear(buff, sizeof(buff));
+}
+
+static bool watchset_contains(const struct wally_script_watchset *set,
+                              const unsigned char *bytes, size_t bytes_len)
+{
+    unsigned char buff[SHA256_LEN];
+    struct watchset_key key;
+
+    if (!bytes_len || !set->table.num_items)
+        return false;
+    key.bytes = watchset_key(set, bytes, bytes_len, buff, &key.len);
+    return hash_table_lookup(&set->table, hash_table_hash(&set->table, key.bytes, key.len),
+                             watchset_entry_matches, set, &key) != NULL;
+}
+
+int wally_script_watchset_init_alloc(size_t allocation_len, uint32_t flags,
+                                     struct wally_script_watchset **output)
+{
+    struct wally_script_watchset *result;
+    size_t key_len;
+    int ret;
+
+    if (output)
+        *output = NULL;
+
+    if (!script_flags_ok(flags, 0) || !output)
+        return WALLY_EINVAL;
+
+    if (!(result = wally_malloc(sizeof(*result))))
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    result->flags = flags;
+    hash_table_init(&result->table);
+    /* Reserve space assuming scripts are of a typical length */
+    key_len = watchset_key_len(result, WALLY_SCRIPTPUBKEY_P2WSH_LEN);
+
+    ret = WALLY_ENOMEM;
+    if (allocation_len <= SIZE_MAX / key_len)
+        ret = watchset_reserve(result, allocation_len, allocation_len * key_len);
+    if (ret != WALLY_OK)
+        wally_script_watchset_free(result);
+    else
+        *output = result;
+    return ret;
+}
+
+int wally_script_watchset_free(struct wally_script_watchset *set)
+{
+    if (set) {
+        hash_table_free(&set->table);
+        clear_and_free(set->keys, set->keys_allocation_len);
+        clear_and_free(set, sizeof(*set));
+    }
+    return WALLY_OK;
+}
+
+int wally_script_watchset_add(struct wally_script_watchset *set,
+                              const unsigned char *bytes, size_t bytes_len)
+{
+    int ret;
+
+    if (!set || !bytes || !bytes_len)
+        return WALLY_EINVAL;
+
+    ret = watchset_reserve(set, 1, watchset_key_len(set, bytes_len));
+    if (ret == WALLY_OK)
+        watchset_insert(set, bytes, bytes_len);
+    return ret;
+}
+
+int wally_script_watchset_add_scripts(struct wally_script_watchset *set,
+                                      const unsigned char *bytes, size_t bytes_len,
+                                      const uint32_t *lens, size_t lens_len)
+{
+    size_t i, total = 0, keys_len;
+    int ret;
+
+    if (!set || (!bytes && bytes_len) || (!lens && lens_len))
+        return WALLY_EINVAL;
+
+    for (i = 0; i < lens_len; ++i) {
+        if (!lens[i] || lens[i] > bytes_len - total)
+            return WALLY_EINVAL;
+        total += lens[i];
+    }
+    if (total != bytes_len)
+        return WALLY_EINVAL;
+
+    keys_len = bytes_len;
+    if (set->flags & ALL_SCRIPT_HASH_FLAGS) {
+        if (lens_len > SIZE_MAX / SHA256_LEN)
+            return WALLY_ENOMEM;
+        keys_len = lens_len * watchset_key_len(set, 0);
+    }
+    ret = watchset_reserve(set, lens_len, keys_len);
+    for (i = 0; ret == WALLY_OK && i < lens_len; ++i) {
+        watchset_insert(set, bytes, lens[i]);
+        bytes += lens[i];
+    }
+    return ret;
+}
+
+int wally_script_watchset_contains(const struct wally_script_watchset *set,
+                                   const unsigned char *bytes, size_t bytes_len,
+                                   size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!set || (!bytes && bytes_len) || !written)
+        return WALLY_EINVAL;
+
+    *written = watchset_contains(set, bytes, bytes_len) ? 1 : 0;
+    return WALLY_OK;
+}
+
+int wally_script_watchset_match_tx(const struct wally_script_watchset *set,
+                                   const struct wally_tx *tx,
+                                   uint32_t *indices_out, size_t len,
+                                   size_t *written)
+{
+    size_t i;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !tx || (tx->num_outputs && !tx->outputs) ||
+        (!indices_out && len) || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < tx->num_outputs; ++i) {
+        if (watchset_contains(set, tx->outputs[i].script, tx->outputs[i].script_len)) {
+            if (*written < len)
+                indices_out[*written] = (uint32_t)i;
+            *written += 1;
+        }
+    }
+    return WALLY_OK;
+}
+
+int wally_script_watchset_match_tx_view(const struct wally_script_watchset *set,
+                                        const struct wally_tx_view *view,
+                                        uint32_t *indices_out, size_t len,
+                                        size_t *written)
+{
+    size_t i;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !view || (view->num_outputs && !view->outputs) ||
+        (!indices_out && len) || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < view->num_outputs; ++i) {
+        if (watchset_contains(set, view->outputs[i].script, view->outputs[i].script_len)) {
+            if (*written < len)
+                indices_out[*written] = (uint32_t)i;
+            *written += 1;
+        }
+    }
+    return WALLY_OK;
+}
@@ -2,6 +2,7 @@
 #define LIBWALLY_CORE_SCRIPT_INT_H 1
 
 #include "ccan/ccan/endian/endian.h"
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,6 +86,27 @@ size_t varint_from_bytes(const unsigned char *bytes, uint64_t *v);
 
 size_t varint_length_from_bytes(const unsigned char *bytes);
 
+/* The largest valid amount in satoshi */
+#define SATOSHI_MAX_MONEY ((uint64_t)WALLY_BTC_MAX * WALLY_SATOSHI_PER_BTC)
+
+/* Write v to bytes_out if non-NULL as a big endian base 128 varint, as
+ * used by bitcoin cores database formats. Returns its length */
+size_t varint128_to_bytes(uint64_t v, unsigned char *bytes_out);
+
+/* Read a base 128 varint from p, returning its length or 0 if it is
+ * truncated or overflows */
+size_t varint128_from_bytes(const unsigned char *p, const unsigned char *end,
+                            uint64_t *v);
+
+/* Compress an amount of at most SATOSHI_MAX_MONEY by removing trailing zeros */
+uint64_t satoshi_compress(uint64_t satoshi);
+
+/* Decompress an amount, returning false if it exceeds SATOSHI_MAX_MONEY */
+bool satoshi_decompress(uint64_t v, uint64_t *satoshi);
+
+/* Get the WALLY_SCRIPT_TYPE_ of a scriptPubkey, which may be empty */
+size_t scriptpubkey_get_type(const unsigned char *bytes, size_t bytes_len);
+
 size_t confidential_asset_length_from_bytes(const unsigned char *bytes);
 
 size_t confidential_value_length_from_bytes(const unsigned char *bytes);
@@ -39,38 +39,169 @@ static void PBKDF2_SHA256(const unsigned char *pass, size_t pass_len,
 # if !defined(__ANDROID__)
 /* No way to check for support, assume Neon present */
 #  define crypto_scrypt_smix_fn crypto_scrypt_smix_neon
+#  define SCRYPT_SMIX_FEATURES WALLY_CPU_SCRYPT_NEON
 # else
-/* On Android, detect Neon support at runtime */
-#  include "cpufeatures/cpu-features.h"
+/* On Android, Neon support is detected at runtime by wally_init() */
 #  include "scrypt/crypto_scrypt_smix.c"
-static void
-crypto_scrypt_smix_fn(uint8_t *B, size_t r, uint64_t N, void *_V, void *XY)
-{
-    if (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON)
-        crypto_scrypt_smix_neon(B, r, N, _V, XY);
-    else
-        crypto_scrypt_smix_c(B, r, N, _V, XY);
-}
+#  define crypto_scrypt_smix_fn crypto_scrypt_smix_c
+#  define HAVE_SCRYPT_SMIX_NEON_RUNTIME 1
 # endif
 #elif defined(__SSE2__)
 /* Use the SSE2 version */
 # include "scrypt/crypto_scrypt_smix_sse2.c"
 # define crypto_scrypt_smix_fn crypto_scrypt_smix_sse2
+# define SCRYPT_SMIX_FEATURES WALLY_CPU_SCRYPT_SSE2
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Also use the multi-lane AVX2/AVX-512 versions when available */
+#  include "scrypt/crypto_scrypt_smix_avx2.c"
+#  include "scrypt/crypto_scrypt_smix_avx512.c"
+#  define HAVE_SCRYPT_SMIX_WIDE 1
+# endif
 #else
 /* Use the C version */
 # include "scrypt/crypto_scrypt_smix.c"
 # define crypto_scrypt_smix_fn crypto_scrypt_smix_c
 #endif
+#ifndef SCRYPT_SMIX_FEATURES
+# define SCRYPT_SMIX_FEATURES 0
+#endif
 
 #include "scrypt/crypto_scrypt.c"
 
+/* The smix routines in use, chosen once by scrypt_optimize() */
+static struct smix_impl smix_impl = { crypto_scrypt_smix_fn, NULL, 0 };
+
+uint32_t scrypt_optimize(uint32_t cpu_features)
+{
+#ifdef HAVE_SCRYPT_SMIX_NEON_RUNTIME
+    if (cpu_features & WALLY_CPU_SCRYPT_NEON) {
+        smix_impl.smix = crypto_scrypt_smix_neon; /* Neon is available */
+        return WALLY_CPU_SCRYPT_NEON;
+    }
+#endif
+#ifdef HAVE_SCRYPT_SMIX_WIDE
+    if (cpu_features & WALLY_CPU_SCRYPT_AVX512) {
+        smix_impl.smix_wide = crypto_scrypt_smix_avx512; /* AVX-512 is available */
+        smix_impl.wide_lanes = AVX512_SMIX_LANES;
+        return SCRYPT_SMIX_FEATURES | WALLY_CPU_SCRYPT_AVX512;
+    }
+    if (cpu_features & WALLY_CPU_SCRYPT_AVX2) {
+        smix_impl.smix_wide = crypto_scrypt_smix_avx2; /* AVX2 is available */
+        smix_impl.wide_lanes = AVX2_SMIX_LANES;
+        return SCRYPT_SMIX_FEATURES | WALLY_CPU_SCRYPT_AVX2;
+    }
+#endif
+    (void)cpu_features;
+    return SCRYPT_SMIX_FEATURES;
+}
+
 /* Our scrypt wrapper. */
 int wally_scrypt(const unsigned char *pass, size_t pass_len,
                  const unsigned char *salt, size_t salt_len,
                  uint32_t cost, uint32_t block_size, uint32_t parallelism,
                  unsigned char *bytes_out, size_t len)
 {
+    int ret;
+
+    WALLY_TRACE4(wally_scrypt__entry, pass_len, salt_len,
+                 (size_t)cost * block_size * parallelism, len);
+    ret = _crypto_scrypt(pass, pass_len, salt, salt_len,
+                         cost, block_size, parallelism,
+                         bytes_out, len, &smix_impl, NULL, NULL);
+    WALLY_TRACE1(wally_scrypt__return, ret);
+    return ret;
+}
+
+/* The copied inputs of an asynchronous scrypt, followed by pass and salt */
+struct scrypt_async {
+    size_t pass_len;
+    size_t salt_len;
+    uint32_t cost;
+    uint32_t block_size;
+    uint32_t parallelism;
+    unsigned char *bytes_out;
+    size_t len;
+};
+
+static int scrypt_async_work(void *work_ctx)
+{
+    struct scrypt_async *a = work_ctx;
+    const unsigned char *pass = (const unsigned char *)(a + 1);
+    return wally_scrypt(pass, a->pass_len, pass + a->pass_len, a->salt_len,
+                        a->cost, a->block_size, a->parallelism,
+                        a->bytes_out, a->len);
+}
+
+int wally_scrypt_async(const unsigned char *pass, size_t pass_len,
+                       const unsigned char *salt, size_t salt_len,
+                       uint32_t cost, uint32_t block_size, uint32_t parallelism,
+                       unsigned char *bytes_out, size_t len,
+                       wally_async_done_t done_fn, void *done_ctx,
+                       struct wally_async **output)
+{
+    const size_t work_len = sizeof(struct scrypt_async) + pass_len + salt_len;
+    struct scrypt_async *a;
+
+    if (output)
+        *output = NULL;
+    if ((!pass && pass_len) || (!salt && salt_len) || !output)
+        return WALLY_EINVAL;
+    if ((a = wally_secret_alloc(work_len))) {
+        a->pass_len = pass_len;
+        a->salt_len = salt_len;
+        a->cost = cost;
+        a->block_size = block_size;
+        a->parallelism = parallelism;
+        a->bytes_out = bytes_out;
+        a->len = len;
+        if (pass_len)
+            memcpy(a + 1, pass, pass_len);
+        if (salt_len)
+            memcpy((unsigned char *)(a + 1) + pass_len, salt, salt_len);
+    }
+    return wally_async_start(scrypt_async_work, a, work_len, bytes_out, len,
+                             done_fn, done_ctx, output);
+}
+
+int wally_scrypt_parallel(const unsigned char *pass, size_t pass_len,
+                          const unsigned char *salt, size_t salt_len,
+                          uint32_t cost, uint32_t block_size, uint32_t parallelism,
+                          wally_run_tasks_t run_fn, void *run_ctx,
+                          unsigned char *bytes_out, size_t len)
+{
+    if (!run_fn) {
+        /* Run the lanes with the run_tasks_fn operation, if any */
+        run_fn = wally_ops()->run_tasks_fn;
+        run_ctx = wally_ops()->run_tasks_ctx;
+    }
     return _crypto_scrypt(pass, pass_len, salt, salt_len,
                           cost, block_size, parallelism,
-                          bytes_out, len, crypto_scrypt_smix_fn);
+                          bytes_out, len, &smix_impl, run_fn, run_ctx);
+}
+
+int wally_scrypt_get_scratch_length(uint32_t cost, uint32_t block_size,
+                                    uint32_t parallelism, size_t *written)
+{
+    struct scrypt_layout layout;
+    int ret;
+
+    if (!written)
+        return WALLY_EINVAL;
+    ret = _crypto_scrypt_scratch_layout(cost, block_size, parallelism,
+                                        &smix_impl, &layout, written);
+    if (ret != WALLY_OK)
+        *written = 0;
+    return ret;
+}
+
+int wally_scrypt_with_scratch(const unsigned char *pass, size_t pass_len,
+                              const unsigned char *salt, size_t salt_len,
+                              uint32_t cost, uint32_t block_size, uint32_t parallelism,
+                              void *scratch, size_t scratch_len,
+                              unsigned char *bytes_out, size_t len)
+{
+    return _crypto_scrypt_scratch(pass, pass_len, salt, salt_len,
+                                  cost, block_size, parallelism,
+                                  bytes_out, len, &smix_impl,
+                                  scratch, scratch_len);
 }
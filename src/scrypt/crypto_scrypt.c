@@ -55,79 +55,213 @@ static void (*smix_func)(uint8_t *, size_t, uint64_t, void *, void *) = NULL;
 #endif
 
 /**
- * _crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen, smix):
- * Perform the requested scrypt computation, using ${smix} as the smix routine.
+ * The smix routines to use: ${smix} computes a single lane, while the
+ * optional ${smix_wide} computes ${wide_lanes} consecutive lanes at once,
+ * taking ${wide_lanes} times the B, V and XY of ${smix}.
  */
-static int
-_crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
-    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t _r, uint32_t _p,
-    uint8_t * buf, size_t buflen,
-    void (*smix)(uint8_t *, size_t, uint64_t, void *, void *))
-{
-	void * B0, * V0, * XY0;
+struct smix_impl {
+	void (*smix)(uint8_t *, size_t, uint64_t, void *, void *);
+	void (*smix_wide)(uint8_t *, size_t, uint64_t, void *, void *);
+	size_t wide_lanes;
+};
+
+/* The working state for running the smix of each group of lanes */
+struct smix_tasks {
+	const struct smix_impl * impl;
 	uint8_t * B;
 	uint32_t * V;
 	uint32_t * XY;
+	size_t r;
+	uint64_t N;
+	size_t p;
+	size_t width;
+};
+
+static void
+smix_group(const struct smix_tasks * t, size_t i, uint32_t * V, uint32_t * XY)
+{
+	size_t lane = i * t->width;
+	size_t end = lane + t->width < t->p ? lane + t->width : t->p;
+
+	/* 3: B_i <-- MF(B_i, N) */
+	if (end - lane == t->width && t->width > 1)
+		(t->impl->smix_wide)(&t->B[lane * 128 * t->r], t->r, t->N, V, XY);
+	else {
+		for (; lane < end; lane++)
+			(t->impl->smix)(&t->B[lane * 128 * t->r], t->r, t->N,
+			    V, XY);
+	}
+}
+
+static void
+smix_task(void * task_ctx, size_t i)
+{
+	struct smix_tasks * t = task_ctx;
+
+	/* Each group of lanes uses its own V and XY */
+	smix_group(t, i, &t->V[i * t->width * 32 * t->r * t->N],
+	    &t->XY[i * t->width * (64 * t->r + 16)]);
+}
+
+/* The sizes of the working memory for a scrypt computation */
+struct scrypt_layout {
+	size_t width;
+	size_t groups;
+	size_t lanes;
+	size_t B_size;
+	size_t XY_size;
+	size_t V_size;
+};
+
+/**
+ * scrypt_layout(N, r, p, buflen, impl, run, layout):
+ * Check the scrypt parameters and compute the working memory ${layout}
+ * needed to run them using ${impl}, with or without a task runner ${run}.
+ */
+static int
+scrypt_layout(uint64_t N, uint32_t _r, uint32_t _p, size_t buflen,
+    const struct smix_impl * impl, wally_run_tasks_t run,
+    struct scrypt_layout * layout)
+{
 	size_t r = _r, p = _p;
-	uint32_t i;
-        int ret = 0;
+	size_t width, groups, lanes;
 
 	/* Sanity-check parameters. */
 #if SIZE_MAX > UINT32_MAX
-	if (buflen > (((uint64_t)(1) << 32) - 1) * 32) {
-		ret = WALLY_EINVAL;
-		goto err0;
-	}
+	if (buflen > (((uint64_t)(1) << 32) - 1) * 32)
+		return WALLY_EINVAL;
 #endif
-	if ((uint64_t)(r) * (uint64_t)(p) >= (1 << 30)) {
-		ret = WALLY_EINVAL;
-		goto err0;
-	}
-	if (((N & (N - 1)) != 0) || (N < 2)) {
-		ret = WALLY_EINVAL;
-		goto err0;
-	}
+	if ((uint64_t)(r) * (uint64_t)(p) >= (1 << 30))
+		return WALLY_EINVAL;
+	if (((N & (N - 1)) != 0) || (N < 2) || r == 0 || p == 0)
+		return WALLY_EINVAL;
+
+	/* Lanes are computed in groups of width lanes, sharing working memory */
+	width = (impl->smix_wide && p >= impl->wide_lanes) ?
+	    impl->wide_lanes : 1;
+	groups = (p + width - 1) / width;
+	lanes = (run != NULL && groups > 1) ? groups * width : width;
+
 	if ((r > SIZE_MAX / 128 / p) ||
 #if SIZE_MAX / 256 <= UINT32_MAX
 	    (r > (SIZE_MAX - 64) / 256) ||
 #endif
-	    (N > SIZE_MAX / 128 / r)) {
-		ret = WALLY_EINVAL;
+	    (N > SIZE_MAX / 128 / r / lanes) ||
+	    (256 * r + 64 > SIZE_MAX / lanes))
+		return WALLY_EINVAL;
+
+	layout->width = width;
+	layout->groups = groups;
+	layout->lanes = lanes;
+	layout->B_size = 128 * r * p;
+	layout->XY_size = (256 * r + 64) * lanes;
+	layout->V_size = 128 * r * N * lanes;
+	return 0;
+}
+
+/**
+ * scrypt_compute(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen,
+ *     impl, run, run_ctx, layout, B, V, XY):
+ * Perform the scrypt computation in the given working memory.
+ */
+static void
+scrypt_compute(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, size_t r, size_t p,
+    uint8_t * buf, size_t buflen, const struct smix_impl * impl,
+    wally_run_tasks_t run, void * run_ctx,
+    const struct scrypt_layout * layout, uint8_t * B, uint32_t * V,
+    uint32_t * XY)
+{
+	struct smix_tasks tasks = { impl, B, V, XY, r, N, p, layout->width };
+	size_t i;
+
+	/* 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen) */
+	PBKDF2_SHA256(passwd, passwdlen, salt, saltlen, 1, B, p * 128 * r);
+
+	/* 2: for i = 0 to p - 1 do */
+	if (layout->lanes > layout->width)
+		(run)(run_ctx, layout->groups, smix_task, &tasks);
+	else {
+		for (i = 0; i < layout->groups; i++)
+			smix_group(&tasks, i, V, XY);
+	}
+
+	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
+	PBKDF2_SHA256(passwd, passwdlen, B, p * 128 * r, 1, buf, buflen);
+}
+
+/**
+ * _crypto_scrypt(passwd, passwdlen, salt, saltlen, N, r, p, buf, buflen, impl,
+ *     run, run_ctx):
+ * Perform the requested scrypt computation, using the smix routines from
+ * ${impl}.  If ${run} is non-NULL, the p smix lanes are passed to it as tasks
+ * which may run concurrently, each with its own working memory.
+ */
+static int
+_crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t _r, uint32_t _p,
+    uint8_t * buf, size_t buflen, const struct smix_impl * impl,
+    wally_run_tasks_t run, void * run_ctx)
+{
+	void * B0, * V0, * XY0;
+	uint8_t * B;
+	uint32_t * V;
+	uint32_t * XY;
+	struct scrypt_layout layout;
+	size_t V_size, XY_size;
+        int ret;
+
+	/* Sanity-check parameters. */
+	if ((ret = scrypt_layout(N, _r, _p, buflen, impl, run, &layout)) != 0)
 		goto err0;
+	V_size = layout.V_size;
+	XY_size = layout.XY_size;
+
+	/* Use the secret arena for all of the buffers if it has room. */
+	if (layout.B_size <= SIZE_MAX - XY_size &&
+	    V_size <= SIZE_MAX - layout.B_size - XY_size &&
+	    (B0 = wally_secret_arena_alloc(layout.B_size + XY_size + V_size)) != NULL) {
+		B = (uint8_t *)(B0);
+		XY = (uint32_t *)(B + layout.B_size);
+		V = (uint32_t *)((uint8_t *)(XY) + XY_size);
+		scrypt_compute(passwd, passwdlen, salt, saltlen, N, _r, _p,
+		    buf, buflen, impl, run, run_ctx, &layout, B, V, XY);
+		wally_secret_free(B0, layout.B_size + XY_size + V_size);
+		return (0);
 	}
 
 	/* Allocate memory. */
 #ifdef HAVE_POSIX_MEMALIGN
-	if ((errno = posix_memalign(&B0, 64, 128 * r * p)) != 0) {
+	if ((errno = posix_memalign(&B0, 64, layout.B_size)) != 0) {
 		ret = WALLY_ENOMEM;
 		goto err0;
         }
 	B = (uint8_t *)(B0);
-	if ((errno = posix_memalign(&XY0, 64, 256 * r + 64)) != 0) {
+	if ((errno = posix_memalign(&XY0, 64, XY_size)) != 0) {
 		ret = WALLY_ENOMEM;
 		goto err1;
 	}
 	XY = (uint32_t *)(XY0);
 #if !defined(MAP_ANON) || !defined(HAVE_MMAP)
-	if ((errno = posix_memalign(&V0, 64, 128 * r * N)) != 0) {
+	if ((errno = posix_memalign(&V0, 64, V_size)) != 0) {
 		ret = WALLY_ENOMEM;
 		goto err2;
 	}
 	V = (uint32_t *)(V0);
 #endif
 #else
-	if ((B0 = malloc(128 * r * p + 63)) == NULL) {
+	if ((B0 = malloc(layout.B_size + 63)) == NULL) {
 		ret = WALLY_ENOMEM;
 		goto err0;
         }
 	B = (uint8_t *)(((uintptr_t)(B0) + 63) & ~ (uintptr_t)(63));
-	if ((XY0 = malloc(256 * r + 64 + 63)) == NULL) {
+	if ((XY0 = malloc(XY_size + 63)) == NULL) {
 		ret = WALLY_ENOMEM;
 		goto err1;
 	}
 	XY = (uint32_t *)(((uintptr_t)(XY0) + 63) & ~ (uintptr_t)(63));
 #if !defined(MAP_ANON) || !defined(HAVE_MMAP)
-	if ((V0 = malloc(128 * r * N + 63)) == NULL) {
+	if ((V0 = malloc(V_size + 63)) == NULL) {
 		ret = WALLY_ENOMEM;
 		goto err2;
 	}
@@ -135,7 +269,7 @@ _crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 #endif
 #endif
 #if defined(MAP_ANON) && defined(HAVE_MMAP)
-	if ((V0 = mmap(NULL, 128 * r * N, PROT_READ | PROT_WRITE,
+	if ((V0 = mmap(NULL, V_size, PROT_READ | PROT_WRITE,
 #ifdef MAP_NOCORE
 	    MAP_ANON | MAP_PRIVATE | MAP_NOCORE,
 #else
@@ -148,21 +282,12 @@ _crypto_scrypt(const uint8_t * passwd, size_t passwdlen,
 	V = (uint32_t *)(V0);
 #endif
 
-	/* 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen) */
-	PBKDF2_SHA256(passwd, passwdlen, salt, saltlen, 1, B, p * 128 * r);
-
-	/* 2: for i = 0 to p - 1 do */
-	for (i = 0; i < p; i++) {
-		/* 3: B_i <-- MF(B_i, N) */
-		(smix)(&B[i * 128 * r], r, N, V, XY);
-	}
-
-	/* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
-	PBKDF2_SHA256(passwd, passwdlen, B, p * 128 * r, 1, buf, buflen);
+	scrypt_compute(passwd, passwdlen, salt, saltlen, N, _r, _p, buf, buflen,
+	    impl, run, run_ctx, &layout, B, V, XY);
 
 	/* Free memory. */
 #if defined(MAP_ANON) && defined(HAVE_MMAP)
-	if (munmap(V0, 128 * r * N)) {
+	if (munmap(V0, V_size)) {
 		ret = WALLY_ENOMEM;
 		goto err2;
 	}
@@ -184,6 +309,70 @@ err0:
 	return ret;
 }
 
+/**
+ * _crypto_scrypt_scratch_layout(N, r, p, impl, layout, scratch_len):
+ * Compute the working memory ${layout} for computing scrypt in a caller
+ * supplied scratch buffer, and the ${scratch_len} it requires.  The buffer
+ * may be unaligned, so 63 bytes are added for aligning it.
+ */
+static int
+_crypto_scrypt_scratch_layout(uint64_t N, uint32_t _r, uint32_t _p,
+    const struct smix_impl * impl, struct scrypt_layout * layout,
+    size_t * scratch_len)
+{
+	int ret;
+
+	if ((ret = scrypt_layout(N, _r, _p, 0, impl, NULL, layout)) != 0)
+		return ret;
+	if (layout->V_size > SIZE_MAX - 63 - layout->B_size - layout->XY_size)
+		return WALLY_EINVAL;
+	*scratch_len = 63 + layout->B_size + layout->XY_size + layout->V_size;
+	return 0;
+}
+
+/**
+ * _crypto_scrypt_scratch(passwd, passwdlen, salt, saltlen, N, r, p, buf,
+ *     buflen, impl, scratch, scratch_len):
+ * As per _crypto_scrypt, but using ${scratch} for all working memory.  If
+ * ${scratch_len} is too small for the multi-lane smix of ${impl}, the single
+ * lane smix is used.  The used part of ${scratch} is cleared on return.
+ */
+static int
+_crypto_scrypt_scratch(const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t _r, uint32_t _p,
+    uint8_t * buf, size_t buflen, const struct smix_impl * impl,
+    void * scratch, size_t scratch_len)
+{
+	struct smix_impl narrow = { impl->smix, NULL, 0 };
+	struct scrypt_layout layout;
+	size_t required;
+	uint8_t * B;
+	int ret;
+
+	if ((ret = _crypto_scrypt_scratch_layout(N, _r, _p, impl, &layout,
+	    &required)) != 0)
+		return ret;
+	if (scratch_len < required) {
+		/* Fall back to the smallest layout if the scratch won't fit */
+		impl = &narrow;
+		if ((ret = _crypto_scrypt_scratch_layout(N, _r, _p, impl,
+		    &layout, &required)) != 0)
+			return ret;
+	}
+	if (!scratch || scratch_len < required)
+		return WALLY_EINVAL;
+	if ((ret = scrypt_layout(N, _r, _p, buflen, impl, NULL, &layout)) != 0)
+		return ret;
+
+	B = (uint8_t *)(((uintptr_t)(scratch) + 63) & ~ (uintptr_t)(63));
+	scrypt_compute(passwd, passwdlen, salt, saltlen, N, _r, _p, buf, buflen,
+	    impl, NULL, NULL, &layout, B,
+	    (uint32_t *)(B + layout.B_size + layout.XY_size),
+	    (uint32_t *)(B + layout.B_size));
+	wally_clear(B, layout.B_size + layout.XY_size + layout.V_size);
+	return 0;
+}
+
 #if 0
 #define TESTLEN 64
 static struct scrypt_test {
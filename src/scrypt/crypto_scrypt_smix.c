@@ -181,6 +181,9 @@ crypto_scrypt_smix_c(uint8_t * B, size_t r, uint64_t N, void * _V, void * XY)
 
 	/* 2: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
 		/* 3: V_i <-- X */
 		blkcpy(&V[i * (32 * r)], X, 128 * r);
 
@@ -196,6 +199,9 @@ crypto_scrypt_smix_c(uint8_t * B, size_t r, uint64_t N, void * _V, void * XY)
 
 	/* 6: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
 		/* 7: j <-- Integerify(X) mod N */
 		j = integerify(X, r) & (N - 1);
 
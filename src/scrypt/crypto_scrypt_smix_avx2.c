@@ -0,0 +1,289 @@
+/*-
+ * Copyright 2009 Colin Percival
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file was originally written by Colin Percival as part of the Tarsnap
+ * online backup system.
+ *
+ * The salsa20/8 core of a single smix is a serial chain, so rather than
+ * vectorizing within a block, this version runs the smix of two independent
+ * lanes at once: each 256-bit register holds the same 128-bit column of
+ * both lanes, laid out exactly as in the SSE2 version.
+ */
+#include <immintrin.h>
+
+#define AVX2_SMIX_LANES 2
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET static void
+avx2_blkcpy(void * dest, const void * src, size_t len)
+{
+	__m256i * D = dest;
+	const __m256i * S = src;
+	size_t L = len / 32;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = S[i];
+}
+
+AVX2_TARGET static void
+avx2_blkxor(void * dest, const void * src, size_t len)
+{
+	__m256i * D = dest;
+	const __m256i * S = src;
+	size_t L = len / 32;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = _mm256_xor_si256(D[i], S[i]);
+}
+
+/**
+ * avx2_salsa20_8(B):
+ * Apply the salsa20/8 core to the provided pair of blocks.
+ */
+AVX2_TARGET static void
+avx2_salsa20_8(__m256i B[4])
+{
+	__m256i X0, X1, X2, X3;
+	__m256i T;
+	size_t i;
+
+	X0 = B[0];
+	X1 = B[1];
+	X2 = B[2];
+	X3 = B[3];
+
+	for (i = 0; i < 8; i += 2) {
+		/* Operate on "columns". */
+		T = _mm256_add_epi32(X0, X3);
+		X1 = _mm256_xor_si256(X1, _mm256_slli_epi32(T, 7));
+		X1 = _mm256_xor_si256(X1, _mm256_srli_epi32(T, 25));
+		T = _mm256_add_epi32(X1, X0);
+		X2 = _mm256_xor_si256(X2, _mm256_slli_epi32(T, 9));
+		X2 = _mm256_xor_si256(X2, _mm256_srli_epi32(T, 23));
+		T = _mm256_add_epi32(X2, X1);
+		X3 = _mm256_xor_si256(X3, _mm256_slli_epi32(T, 13));
+		X3 = _mm256_xor_si256(X3, _mm256_srli_epi32(T, 19));
+		T = _mm256_add_epi32(X3, X2);
+		X0 = _mm256_xor_si256(X0, _mm256_slli_epi32(T, 18));
+		X0 = _mm256_xor_si256(X0, _mm256_srli_epi32(T, 14));
+
+		/* Rearrange data (within each 128-bit lane). */
+		X1 = _mm256_shuffle_epi32(X1, 0x93);
+		X2 = _mm256_shuffle_epi32(X2, 0x4E);
+		X3 = _mm256_shuffle_epi32(X3, 0x39);
+
+		/* Operate on "rows". */
+		T = _mm256_add_epi32(X0, X1);
+		X3 = _mm256_xor_si256(X3, _mm256_slli_epi32(T, 7));
+		X3 = _mm256_xor_si256(X3, _mm256_srli_epi32(T, 25));
+		T = _mm256_add_epi32(X3, X0);
+		X2 = _mm256_xor_si256(X2, _mm256_slli_epi32(T, 9));
+		X2 = _mm256_xor_si256(X2, _mm256_srli_epi32(T, 23));
+		T = _mm256_add_epi32(X2, X3);
+		X1 = _mm256_xor_si256(X1, _mm256_slli_epi32(T, 13));
+		X1 = _mm256_xor_si256(X1, _mm256_srli_epi32(T, 19));
+		T = _mm256_add_epi32(X1, X2);
+		X0 = _mm256_xor_si256(X0, _mm256_slli_epi32(T, 18));
+		X0 = _mm256_xor_si256(X0, _mm256_srli_epi32(T, 14));
+
+		/* Rearrange data (within each 128-bit lane). */
+		X1 = _mm256_shuffle_epi32(X1, 0x39);
+		X2 = _mm256_shuffle_epi32(X2, 0x4E);
+		X3 = _mm256_shuffle_epi32(X3, 0x93);
+	}
+
+	B[0] = _mm256_add_epi32(B[0], X0);
+	B[1] = _mm256_add_epi32(B[1], X1);
+	B[2] = _mm256_add_epi32(B[2], X2);
+	B[3] = _mm256_add_epi32(B[3], X3);
+}
+
+/**
+ * avx2_blockmix_salsa8(Bin, Bout, X, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin) for both lanes.  The input
+ * Bin must be 256r bytes in length; the output Bout must also be the same
+ * size.  The temporary space X must be 128 bytes.
+ */
+AVX2_TARGET static void
+avx2_blockmix_salsa8(const __m256i * Bin, __m256i * Bout, __m256i * X,
+    size_t r)
+{
+	size_t i;
+
+	/* 1: X <-- B_{2r - 1} */
+	avx2_blkcpy(X, &Bin[8 * r - 4], 128);
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		avx2_blkxor(X, &Bin[i * 8], 128);
+		avx2_salsa20_8(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		avx2_blkcpy(&Bout[i * 4], X, 128);
+
+		/* 3: X <-- H(X \xor B_i) */
+		avx2_blkxor(X, &Bin[i * 8 + 4], 128);
+		avx2_salsa20_8(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		avx2_blkcpy(&Bout[(r + i) * 4], X, 128);
+	}
+}
+
+/**
+ * avx2_integerify(B, r, lane):
+ * Return the result of parsing B_{2r-1} of ${lane} as a little-endian
+ * integer.  Note that B's layout is permuted and interleaved compared to
+ * the generic implementation.
+ */
+static uint64_t
+avx2_integerify(const void * B, size_t r, size_t lane)
+{
+	const uint32_t * X = (const void *)((uintptr_t)(B) + (2 * r - 1) * 128);
+
+	return X[lane * 4];
+}
+
+/**
+ * avx2_store_V(V, r, N, i, X):
+ * Store the 128r byte block of each lane in X as V_i of that lane.  Each
+ * lane has its own 128rN byte V, one after the other.
+ */
+AVX2_TARGET static void
+avx2_store_V(void * V, size_t r, uint64_t N, uint64_t i, const __m256i * X)
+{
+	__m128i * V0 = (void *)((uintptr_t)(V) + i * 128 * r);
+	__m128i * V1 = (void *)((uintptr_t)(V0) + 128 * r * N);
+	size_t k;
+
+	for (k = 0; k < 8 * r; k++) {
+		V0[k] = _mm256_castsi256_si128(X[k]);
+		V1[k] = _mm256_extracti128_si256(X[k], 1);
+	}
+}
+
+/**
+ * avx2_xor_V(X, V, r, N, j0, j1):
+ * Compute X <-- X \xor V_j for each lane, where lane 0 uses V_{j0} and
+ * lane 1 uses V_{j1}.
+ */
+AVX2_TARGET static void
+avx2_xor_V(__m256i * X, const void * V, size_t r, uint64_t N,
+    uint64_t j0, uint64_t j1)
+{
+	const __m128i * V0 = (const void *)((uintptr_t)(V) + j0 * 128 * r);
+	const __m128i * V1 =
+	    (const void *)((uintptr_t)(V) + (N + j1) * 128 * r);
+	size_t k;
+
+	for (k = 0; k < 8 * r; k++) {
+		X[k] = _mm256_xor_si256(X[k], _mm256_inserti128_si256(
+		    _mm256_castsi128_si256(V0[k]), V1[k], 1));
+	}
+}
+
+/**
+ * crypto_scrypt_smix_avx2(B, r, N, V, XY):
+ * Compute B_l = SMix_r(B_l, N) for the two consecutive lanes B_0 and B_1.
+ * The input B must be 256r bytes in length; the temporary storage V must be
+ * 256rN bytes in length; the temporary storage XY must be 512r + 128 bytes
+ * in length.  The value N must be a power of 2 greater than 1.  The arrays
+ * B, V, and XY must be aligned to a multiple of 64 bytes.
+ *
+ * Use AVX2 instructions.
+ */
+AVX2_TARGET static void
+crypto_scrypt_smix_avx2(uint8_t * B, size_t r, uint64_t N, void * V,
+    void * XY)
+{
+	__m256i * X = XY;
+	__m256i * Y = (void *)((uintptr_t)(XY) + 256 * r);
+	__m256i * Z = (void *)((uintptr_t)(XY) + 512 * r);
+	uint32_t * X32 = (void *)X;
+	uint64_t i, j0, j1;
+	size_t k, l;
+
+	/* 1: X <-- B */
+	for (l = 0; l < AVX2_SMIX_LANES; l++) {
+		for (k = 0; k < 32 * r; k++) {
+			X32[(k / 4) * 8 + l * 4 + k % 4] = le32dec(
+			    &B[l * 128 * r + (k / 16 * 16 + (k % 16 * 5 % 16)) * 4]);
+		}
+	}
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
+		/* 3: V_i <-- X */
+		avx2_store_V(V, r, N, i, X);
+
+		/* 4: X <-- H(X) */
+		avx2_blockmix_salsa8(X, Y, Z, r);
+
+		/* 3: V_i <-- X */
+		avx2_store_V(V, r, N, i + 1, Y);
+
+		/* 4: X <-- H(X) */
+		avx2_blockmix_salsa8(Y, X, Z, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = avx2_integerify(X, r, 0) & (N - 1);
+		j1 = avx2_integerify(X, r, 1) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		avx2_xor_V(X, V, r, N, j0, j1);
+		avx2_blockmix_salsa8(X, Y, Z, r);
+
+		/* 7: j <-- Integerify(X) mod N */
+		j0 = avx2_integerify(Y, r, 0) & (N - 1);
+		j1 = avx2_integerify(Y, r, 1) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		avx2_xor_V(Y, V, r, N, j0, j1);
+		avx2_blockmix_salsa8(Y, X, Z, r);
+	}
+
+	/* 10: B' <-- X */
+	for (l = 0; l < AVX2_SMIX_LANES; l++) {
+		for (k = 0; k < 32 * r; k++) {
+			le32enc(&B[l * 128 * r + (k / 16 * 16 + (k % 16 * 5 % 16)) * 4],
+			    X32[(k / 4) * 8 + l * 4 + k % 4]);
+		}
+	}
+}
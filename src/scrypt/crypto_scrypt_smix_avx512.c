@@ -0,0 +1,280 @@
+/*-
+ * Copyright 2009 Colin Percival
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file was originally written by Colin Percival as part of the Tarsnap
+ * online backup system.
+ *
+ * As with the AVX2 version, this runs the smix of independent lanes at
+ * once, here four lanes per 512-bit register, using the AVX-512 rotate
+ * instruction in place of pairs of shifts.
+ */
+#include <immintrin.h>
+
+#define AVX512_SMIX_LANES 4
+
+#define AVX512_TARGET __attribute__((target("avx512f")))
+
+AVX512_TARGET static void
+avx512_blkcpy(void * dest, const void * src, size_t len)
+{
+	__m512i * D = dest;
+	const __m512i * S = src;
+	size_t L = len / 64;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = S[i];
+}
+
+AVX512_TARGET static void
+avx512_blkxor(void * dest, const void * src, size_t len)
+{
+	__m512i * D = dest;
+	const __m512i * S = src;
+	size_t L = len / 64;
+	size_t i;
+
+	for (i = 0; i < L; i++)
+		D[i] = _mm512_xor_si512(D[i], S[i]);
+}
+
+/**
+ * avx512_salsa20_8(B):
+ * Apply the salsa20/8 core to the provided four blocks.
+ */
+AVX512_TARGET static void
+avx512_salsa20_8(__m512i B[4])
+{
+	__m512i X0, X1, X2, X3;
+	size_t i;
+
+	X0 = B[0];
+	X1 = B[1];
+	X2 = B[2];
+	X3 = B[3];
+
+	for (i = 0; i < 8; i += 2) {
+		/* Operate on "columns". */
+		X1 = _mm512_xor_si512(X1, _mm512_rol_epi32(_mm512_add_epi32(X0, X3), 7));
+		X2 = _mm512_xor_si512(X2, _mm512_rol_epi32(_mm512_add_epi32(X1, X0), 9));
+		X3 = _mm512_xor_si512(X3, _mm512_rol_epi32(_mm512_add_epi32(X2, X1), 13));
+		X0 = _mm512_xor_si512(X0, _mm512_rol_epi32(_mm512_add_epi32(X3, X2), 18));
+
+		/* Rearrange data (within each 128-bit lane). */
+		X1 = _mm512_shuffle_epi32(X1, (_MM_PERM_ENUM)0x93);
+		X2 = _mm512_shuffle_epi32(X2, (_MM_PERM_ENUM)0x4E);
+		X3 = _mm512_shuffle_epi32(X3, (_MM_PERM_ENUM)0x39);
+
+		/* Operate on "rows". */
+		X3 = _mm512_xor_si512(X3, _mm512_rol_epi32(_mm512_add_epi32(X0, X1), 7));
+		X2 = _mm512_xor_si512(X2, _mm512_rol_epi32(_mm512_add_epi32(X3, X0), 9));
+		X1 = _mm512_xor_si512(X1, _mm512_rol_epi32(_mm512_add_epi32(X2, X3), 13));
+		X0 = _mm512_xor_si512(X0, _mm512_rol_epi32(_mm512_add_epi32(X1, X2), 18));
+
+		/* Rearrange data (within each 128-bit lane). */
+		X1 = _mm512_shuffle_epi32(X1, (_MM_PERM_ENUM)0x39);
+		X2 = _mm512_shuffle_epi32(X2, (_MM_PERM_ENUM)0x4E);
+		X3 = _mm512_shuffle_epi32(X3, (_MM_PERM_ENUM)0x93);
+	}
+
+	B[0] = _mm512_add_epi32(B[0], X0);
+	B[1] = _mm512_add_epi32(B[1], X1);
+	B[2] = _mm512_add_epi32(B[2], X2);
+	B[3] = _mm512_add_epi32(B[3], X3);
+}
+
+/**
+ * avx512_blockmix_salsa8(Bin, Bout, X, r):
+ * Compute Bout = BlockMix_{salsa20/8, r}(Bin) for all four lanes.  The
+ * input Bin must be 512r bytes in length; the output Bout must also be the
+ * same size.  The temporary space X must be 256 bytes.
+ */
+AVX512_TARGET static void
+avx512_blockmix_salsa8(const __m512i * Bin, __m512i * Bout, __m512i * X,
+    size_t r)
+{
+	size_t i;
+
+	/* 1: X <-- B_{2r - 1} */
+	avx512_blkcpy(X, &Bin[8 * r - 4], 256);
+
+	/* 2: for i = 0 to 2r - 1 do */
+	for (i = 0; i < r; i++) {
+		/* 3: X <-- H(X \xor B_i) */
+		avx512_blkxor(X, &Bin[i * 8], 256);
+		avx512_salsa20_8(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		avx512_blkcpy(&Bout[i * 4], X, 256);
+
+		/* 3: X <-- H(X \xor B_i) */
+		avx512_blkxor(X, &Bin[i * 8 + 4], 256);
+		avx512_salsa20_8(X);
+
+		/* 4: Y_i <-- X */
+		/* 6: B' <-- (Y_0, Y_2 ... Y_{2r-2}, Y_1, Y_3 ... Y_{2r-1}) */
+		avx512_blkcpy(&Bout[(r + i) * 4], X, 256);
+	}
+}
+
+/**
+ * avx512_integerify(B, r, lane):
+ * Return the result of parsing B_{2r-1} of ${lane} as a little-endian
+ * integer.  Note that B's layout is permuted and interleaved compared to
+ * the generic implementation.
+ */
+static uint64_t
+avx512_integerify(const void * B, size_t r, size_t lane)
+{
+	const uint32_t * X = (const void *)((uintptr_t)(B) + (2 * r - 1) * 256);
+
+	return X[lane * 4];
+}
+
+/**
+ * avx512_store_V(V, r, N, i, X):
+ * Store the 128r byte block of each lane in X as V_i of that lane.  Each
+ * lane has its own 128rN byte V, one after the other.
+ */
+AVX512_TARGET static void
+avx512_store_V(void * V, size_t r, uint64_t N, uint64_t i, const __m512i * X)
+{
+	__m128i * V0 = (void *)((uintptr_t)(V) + i * 128 * r);
+	const size_t lane = 8 * r * N;
+	size_t k;
+
+	for (k = 0; k < 8 * r; k++) {
+		V0[k] = _mm512_extracti32x4_epi32(X[k], 0);
+		V0[lane + k] = _mm512_extracti32x4_epi32(X[k], 1);
+		V0[2 * lane + k] = _mm512_extracti32x4_epi32(X[k], 2);
+		V0[3 * lane + k] = _mm512_extracti32x4_epi32(X[k], 3);
+	}
+}
+
+/**
+ * avx512_xor_V(X, V, r, N, j):
+ * Compute X <-- X \xor V_j for each lane, where lane l uses V_{j[l]}.
+ */
+AVX512_TARGET static void
+avx512_xor_V(__m512i * X, const void * V, size_t r, uint64_t N,
+    const uint64_t j[4])
+{
+	const __m128i * V0 = (const void *)((uintptr_t)(V) + j[0] * 128 * r);
+	const __m128i * V1 =
+	    (const void *)((uintptr_t)(V) + (N + j[1]) * 128 * r);
+	const __m128i * V2 =
+	    (const void *)((uintptr_t)(V) + (2 * N + j[2]) * 128 * r);
+	const __m128i * V3 =
+	    (const void *)((uintptr_t)(V) + (3 * N + j[3]) * 128 * r);
+	__m512i T;
+	size_t k;
+
+	for (k = 0; k < 8 * r; k++) {
+		T = _mm512_castsi128_si512(V0[k]);
+		T = _mm512_inserti32x4(T, V1[k], 1);
+		T = _mm512_inserti32x4(T, V2[k], 2);
+		T = _mm512_inserti32x4(T, V3[k], 3);
+		X[k] = _mm512_xor_si512(X[k], T);
+	}
+}
+
+/**
+ * crypto_scrypt_smix_avx512(B, r, N, V, XY):
+ * Compute B_l = SMix_r(B_l, N) for the four consecutive lanes B_0 ... B_3.
+ * The input B must be 512r bytes in length; the temporary storage V must be
+ * 512rN bytes in length; the temporary storage XY must be 1024r + 256 bytes
+ * in length.  The value N must be a power of 2 greater than 1.  The arrays
+ * B, V, and XY must be aligned to a multiple of 64 bytes.
+ *
+ * Use AVX-512 instructions.
+ */
+AVX512_TARGET static void
+crypto_scrypt_smix_avx512(uint8_t * B, size_t r, uint64_t N, void * V,
+    void * XY)
+{
+	__m512i * X = XY;
+	__m512i * Y = (void *)((uintptr_t)(XY) + 512 * r);
+	__m512i * Z = (void *)((uintptr_t)(XY) + 1024 * r);
+	uint32_t * X32 = (void *)X;
+	uint64_t i, j[AVX512_SMIX_LANES];
+	size_t k, l;
+
+	/* 1: X <-- B */
+	for (l = 0; l < AVX512_SMIX_LANES; l++) {
+		for (k = 0; k < 32 * r; k++) {
+			X32[(k / 4) * 16 + l * 4 + k % 4] = le32dec(
+			    &B[l * 128 * r + (k / 16 * 16 + (k % 16 * 5 % 16)) * 4]);
+		}
+	}
+
+	/* 2: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
+		/* 3: V_i <-- X */
+		avx512_store_V(V, r, N, i, X);
+
+		/* 4: X <-- H(X) */
+		avx512_blockmix_salsa8(X, Y, Z, r);
+
+		/* 3: V_i <-- X */
+		avx512_store_V(V, r, N, i + 1, Y);
+
+		/* 4: X <-- H(X) */
+		avx512_blockmix_salsa8(Y, X, Z, r);
+	}
+
+	/* 6: for i = 0 to N - 1 do */
+	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
+		/* 7: j <-- Integerify(X) mod N */
+		for (l = 0; l < AVX512_SMIX_LANES; l++)
+			j[l] = avx512_integerify(X, r, l) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		avx512_xor_V(X, V, r, N, j);
+		avx512_blockmix_salsa8(X, Y, Z, r);
+
+		/* 7: j <-- Integerify(X) mod N */
+		for (l = 0; l < AVX512_SMIX_LANES; l++)
+			j[l] = avx512_integerify(Y, r, l) & (N - 1);
+
+		/* 8: X <-- H(X \xor V_j) */
+		avx512_xor_V(Y, V, r, N, j);
+		avx512_blockmix_salsa8(Y, X, Z, r);
+	}
+
+	/* 10: B' <-- X */
+	for (l = 0; l < AVX512_SMIX_LANES; l++) {
+		for (k = 0; k < 32 * r; k++) {
+			le32enc(&B[l * 128 * r + (k / 16 * 16 + (k % 16 * 5 % 16)) * 4],
+			    X32[(k / 4) * 16 + l * 4 + k % 4]);
+		}
+	}
+}
@@ -239,6 +239,9 @@ crypto_scrypt_smix_neon(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
     neon_blkcpy(X, B, 128 * r);
     /* 2: for i = 0 to N - 1 do */
     for (i = 0; i < N; i += 2) {
+        /* Stop early if the running operation was cancelled */
+        if (WALLY_ASYNC_CANCELLED(i))
+            return;
         /* 3: V_i <-- X */
         neon_blkcpy(((unsigned char *)V) + i * 128 * r, X, 128 * r);
         /* 4: X <-- H(X) */
@@ -250,6 +253,9 @@ crypto_scrypt_smix_neon(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
     }
     /* 6: for i = 0 to N - 1 do */
     for (i = 0; i < N; i += 2) {
+        /* Stop early if the running operation was cancelled */
+        if (WALLY_ASYNC_CANCELLED(i))
+            return;
         /* 7: j <-- Integerify(X) mod N */
         j = neon_integerify(X, r) & (N - 1);
         /* 8: X <-- H(X \xor V_j) */
@@ -209,6 +209,9 @@ crypto_scrypt_smix_sse2(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
 
 	/* 2: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
 		/* 3: V_i <-- X */
 		sse2_blkcpy(((unsigned char *)V) + i * 128 * r, X, 128 * r);
 
@@ -224,6 +227,9 @@ crypto_scrypt_smix_sse2(uint8_t * B, size_t r, uint64_t N, void * V, void * XY)
 
 	/* 6: for i = 0 to N - 1 do */
 	for (i = 0; i < N; i += 2) {
+		/* Stop early if the running operation was cancelled */
+		if (WALLY_ASYNC_CANCELLED(i))
+			return;
 		/* 7: j <-- Integerify(X) mod N */
 		j = sse2_integerify(X, r) & (N - 1);
 
@@ -0,0 +1,536 @@
+#include "internal.h"
+
+#include "ccan/ccan/crypto/sha256/sha256.h"
+
+#include <include/wally_crypto.h>
+#include <include/wally_transaction.h>
+
+#include <stdbool.h>
+#include "script_int.h"
+
+#define SIGHASH_MASK 0x1f /* As in transaction.c */
+
+/* Parsing states, in the order the serialization is read */
+enum {
+    SS_VERSION,
+    SS_MARKER, /* BIP 144 marker, or the first byte of the input count */
+    SS_FLAG,
+    SS_NUM_INPUTS,
+    SS_INPUT_PREVOUT,
+    SS_INPUT_SCRIPT_LEN,
+    SS_INPUT_SCRIPT,
+    SS_INPUT_SEQUENCE,
+    SS_NUM_OUTPUTS,
+    SS_OUTPUT_SATOSHI,
+    SS_OUTPUT_SCRIPT_LEN,
+    SS_OUTPUT_SCRIPT,
+    SS_NUM_WITNESS_ITEMS,
+    SS_WITNESS_ITEM_LEN,
+    SS_WITNESS_ITEM,
+    SS_LOCKTIME,
+    SS_DONE,
+    SS_FAILED /* An error occurred, or the stream was finished */
+};
+
+#define SS_PREVOUT_LEN (WALLY_TXHASH_LEN + sizeof(uint32_t))
+
+/* A signature hash to compute as the transaction is streamed */
+struct sighash_stream_req {
+    size_t index;
+    unsigned char *script;
+    size_t script_len;
+    uint64_t satoshi;
+    uint32_t sighash;
+    bool bip143;
+    bool is_one; /* A legacy hash of 1, as for an out of range index */
+    struct sha256_ctx sha; /* The legacy preimage, or a BIP 143 single output */
+    unsigned char prevout[SS_PREVOUT_LEN]; /* BIP 143: The input's outpoint */
+    uint32_t sequence; /* BIP 143: The input's sequence */
+};
+
+struct wally_tx_sighash_stream {
+    struct sighash_stream_req *reqs;
+    size_t num_reqs;
+    struct sha256_ctx prevouts; /* BIP 143 hashPrevouts */
+    struct sha256_ctx sequences; /* BIP 143 hashSequence */
+    struct sha256_ctx outputs; /* BIP 143 hashOutputs */
+    uint32_t version;
+    uint32_t locktime;
+    uint64_t num_inputs;
+    uint64_t num_outputs;
+    uint64_t item; /* The current input, output or witness stack */
+    uint64_t remaining; /* Bytes left of the current script or witness item */
+    uint64_t num_items; /* Items left of the current witness stack */
+    size_t total_len; /* Bytes streamed so far */
+    unsigned char buf[SS_PREVOUT_LEN]; /* The current fixed size field */
+    size_t have; /* Bytes held in buf */
+    size_t need; /* Bytes needed in buf to parse the current field */
+    int state;
+    bool has_witness;
+};
+
+static bool is_anyonecanpay(const struct sighash_stream_req *r)
+{
+    return r->sighash & WALLY_SIGHASH_ANYONECANPAY;
+}
+
+static bool is_none(const struct sighash_stream_req *r)
+{
+    return (r->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
+}
+
+static bool is_single(const struct sighash_stream_req *r)
+{
+    return (r->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+}
+
+/* Whether a legacy preimage includes the input at index i */
+static bool hashes_input(const struct sighash_stream_req *r, uint64_t i)
+{
+    return !r->bip143 && !r->is_one && (!is_anyonecanpay(r) || i == r->index);
+}
+
+/* Whether a preimage, or the BIP 143 hash of a single output, includes
+ * the output at index i in full */
+static bool hashes_output(const struct sighash_stream_req *r, uint64_t i)
+{
+    if (r->bip143)
+        return is_single(r) && i == r->index;
+    return !r->is_one && !is_none(r) && (!is_single(r) || i == r->index);
+}
+
+static void stream_sha256_varint(struct sha256_ctx *ctx, uint64_t v)
+{
+    unsigned char buff[sizeof(uint8_t) + sizeof(uint64_t)];
+
+    sha256_update(ctx, buff, varint_to_bytes(v, buff));
+}
+
+static void stream_sha256d_done(struct sha256_ctx *ctx, unsigned char *bytes_out)
+{
+    struct sha256 sha;
+
+    sha256_done(ctx, &sha);
+    wally_sha256(sha.u.u8, sizeof(sha), bytes_out, SHA256_LEN);
+    wally_clear(&sha, sizeof(sha));
+}
+
+int wally_tx_sighash_stream_init_alloc(uint32_t flags,
+                                       struct wally_tx_sighash_stream **output)
+{
+    struct wally_tx_sighash_stream *result;
+
+    if (output)
+        *output = NULL;
+
+    if (flags || !output)
+        return WALLY_EINVAL;
+
+    result = wally_malloc(sizeof(*result));
+    if (!result)
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    sha256_init(&result->prevouts);
+    sha256_init(&result->sequences);
+    sha256_init(&result->outputs);
+    result->state = SS_VERSION;
+    result->need = sizeof(uint32_t);
+    *output = result;
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_stream_add_input(struct wally_tx_sighash_stream *stream,
+                                      size_t index,
+                                      const unsigned char *script, size_t script_len,
+                                      uint64_t satoshi, uint32_t sighash,
+                                      uint32_t flags)
+{
+    struct sighash_stream_req *reqs, *r;
+
+    if (!stream || stream->state != SS_VERSION || stream->have ||
+        (!script) != (!script_len) || (sighash & 0xffffff00) ||
+        (flags & ~WALLY_TX_FLAG_USE_WITNESS))
+        return WALLY_EINVAL;
+
+    reqs = wally_realloc(stream->reqs, stream->num_reqs * sizeof(*reqs),
+                         (stream->num_reqs + 1) * sizeof(*reqs));
+    if (!reqs)
+        return WALLY_ENOMEM;
+    stream->reqs = reqs;
+    r = reqs + stream->num_reqs;
+    wally_clear(r, sizeof(*r));
+    if (script_len) {
+        if (!(r->script = wally_malloc(script_len)))
+            return WALLY_ENOMEM;
+        memcpy(r->script, script, script_len);
+    }
+    r->index = index;
+    r->script_len = script_len;
+    r->satoshi = satoshi;
+    r->sighash = sighash;
+    r->bip143 = flags & WALLY_TX_FLAG_USE_WITNESS;
+    sha256_init(&r->sha);
+    ++stream->num_reqs;
+    return WALLY_OK;
+}
+
+static bool is_varint_state(int state)
+{
+    return state == SS_NUM_INPUTS || state == SS_INPUT_SCRIPT_LEN ||
+           state == SS_NUM_OUTPUTS || state == SS_OUTPUT_SCRIPT_LEN ||
+           state == SS_NUM_WITNESS_ITEMS || state == SS_WITNESS_ITEM_LEN;
+}
+
+/* Move to the next field of need bytes, or 1 byte for varints */
+static void next_field(struct wally_tx_sighash_stream *s, int state, size_t need)
+{
+    s->state = state;
+    s->have = 0;
+    s->need = need;
+}
+
+/* Move to the next raw bytes field of s->remaining bytes */
+static void next_bytes(struct wally_tx_sighash_stream *s, int state, int next_state, size_t need)
+{
+    if (s->remaining)
+        next_field(s, state, 0);
+    else
+        next_field(s, next_state, need);
+}
+
+static void end_output(struct wally_tx_sighash_stream *s)
+{
+    if (++s->item < s->num_outputs)
+        next_field(s, SS_OUTPUT_SATOSHI, sizeof(uint64_t));
+    else if (s->has_witness) {
+        s->item = 0;
+        next_field(s, SS_NUM_WITNESS_ITEMS, 1);
+    } else
+        next_field(s, SS_LOCKTIME, sizeof(uint32_t));
+}
+
+static void end_witness_stack(struct wally_tx_sighash_stream *s)
+{
+    if (++s->item < s->num_inputs)
+        next_field(s, SS_NUM_WITNESS_ITEMS, 1);
+    else
+        next_field(s, SS_LOCKTIME, sizeof(uint32_t));
+}
+
+static void end_witness_item(struct wally_tx_sighash_stream *s)
+{
+    if (--s->num_items)
+        next_field(s, SS_WITNESS_ITEM_LEN, 1);
+    else
+        end_witness_stack(s);
+}
+
+/* Process raw script or witness bytes from the stream */
+static void process_bytes(struct wally_tx_sighash_stream *s,
+                          const unsigned char *bytes, size_t bytes_len)
+{
+    size_t i;
+
+    if (s->state == SS_OUTPUT_SCRIPT) {
+        sha256_update(&s->outputs, bytes, bytes_len);
+        for (i = 0; i < s->num_reqs; ++i)
+            if (hashes_output(s->reqs + i, s->item))
+                sha256_update(&s->reqs[i].sha, bytes, bytes_len);
+    }
+    if ((s->remaining -= bytes_len))
+        return;
+    if (s->state == SS_INPUT_SCRIPT)
+        next_field(s, SS_INPUT_SEQUENCE, sizeof(uint32_t));
+    else if (s->state == SS_OUTPUT_SCRIPT)
+        end_output(s);
+    else
+        end_witness_item(s);
+}
+
+/* Process the fixed size field or varint held in s->buf */
+static int process_field(struct wally_tx_sighash_stream *s)
+{
+    const unsigned char *p = s->buf;
+    uint64_t v = 0;
+    uint32_t v32;
+    size_t i;
+
+    if (s->state == SS_MARKER) {
+        if (!*p) {
+            s->has_witness = true; /* BIP 144 extended serialization */
+            next_field(s, SS_FLAG, 1);
+            return WALLY_OK;
+        }
+        s->state = SS_NUM_INPUTS; /* The first byte of the input count */
+    }
+
+    if (is_varint_state(s->state)) {
+        /* Fetch the rest of the varint once its length is known */
+        if (s->have < varint_length_from_bytes(p)) {
+            s->need = varint_length_from_bytes(p);
+            return WALLY_OK;
+        }
+        varint_from_bytes(p, &v);
+    }
+
+    switch (s->state) {
+    case SS_VERSION:
+        uint32_from_le_bytes(p, &s->version);
+        for (i = 0; i < s->num_reqs; ++i)
+            if (!s->reqs[i].bip143)
+                sha256_le32(&s->reqs[i].sha, s->version);
+        next_field(s, SS_MARKER, 1);
+        break;
+    case SS_FLAG:
+        if (*p != 0x1)
+            return WALLY_EINVAL; /* Invalid witness flag */
+        next_field(s, SS_NUM_INPUTS, 1);
+        break;
+    case SS_NUM_INPUTS:
+        if (!v)
+            return WALLY_EINVAL;
+        s->num_inputs = v;
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (r->bip143)
+                continue;
+            if (r->index >= v)
+                r->is_one = true;
+            else
+                stream_sha256_varint(&r->sha, is_anyonecanpay(r) ? 1 : v);
+        }
+        s->item = 0;
+        next_field(s, SS_INPUT_PREVOUT, SS_PREVOUT_LEN);
+        break;
+    case SS_INPUT_PREVOUT:
+        sha256_update(&s->prevouts, p, SS_PREVOUT_LEN);
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (r->bip143 && r->index == s->item)
+                memcpy(r->prevout, p, SS_PREVOUT_LEN);
+            else if (hashes_input(r, s->item)) {
+                sha256_update(&r->sha, p, SS_PREVOUT_LEN);
+                if (r->index == s->item) {
+                    stream_sha256_varint(&r->sha, r->script_len);
+                    if (r->script_len)
+                        sha256_update(&r->sha, r->script, r->script_len);
+                } else
+                    sha256_u8(&r->sha, 0); /* Blank scripts for non-signing inputs */
+            }
+        }
+        next_field(s, SS_INPUT_SCRIPT_LEN, 1);
+        break;
+    case SS_INPUT_SCRIPT_LEN:
+        s->remaining = v;
+        next_bytes(s, SS_INPUT_SCRIPT, SS_INPUT_SEQUENCE, sizeof(uint32_t));
+        break;
+    case SS_INPUT_SEQUENCE:
+        uint32_from_le_bytes(p, &v32);
+        sha256_le32(&s->sequences, v32);
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (r->bip143 && r->index == s->item)
+                r->sequence = v32;
+            else if (hashes_input(r, s->item)) {
+                const bool blank = (is_none(r) || is_single(r)) && r->index != s->item;
+                sha256_le32(&r->sha, blank ? 0 : v32);
+            }
+        }
+        if (++s->item < s->num_inputs)
+            next_field(s, SS_INPUT_PREVOUT, SS_PREVOUT_LEN);
+        else
+            next_field(s, SS_NUM_OUTPUTS, 1);
+        break;
+    case SS_NUM_OUTPUTS:
+        if (!v)
+            return WALLY_EINVAL;
+        s->num_outputs = v;
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (r->bip143 || r->is_one)
+                continue;
+            if (is_single(r) && r->index >= v)
+                r->is_one = true;
+            else
+                stream_sha256_varint(&r->sha, is_none(r) ? 0 : is_single(r) ? r->index + 1 : v);
+        }
+        s->item = 0;
+        next_field(s, SS_OUTPUT_SATOSHI, sizeof(uint64_t));
+        break;
+    case SS_OUTPUT_SATOSHI:
+        uint64_from_le_bytes(p, &v);
+        sha256_le64(&s->outputs, v);
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (hashes_output(r, s->item))
+                sha256_le64(&r->sha, v);
+            else if (!r->bip143 && !r->is_one && is_single(r) && s->item < r->index) {
+                sha256_le64(&r->sha, 0xffffffffffffffffull); /* Blank output */
+                sha256_u8(&r->sha, 0);
+            }
+        }
+        next_field(s, SS_OUTPUT_SCRIPT_LEN, 1);
+        break;
+    case SS_OUTPUT_SCRIPT_LEN:
+        stream_sha256_varint(&s->outputs, v);
+        for (i = 0; i < s->num_reqs; ++i)
+            if (hashes_output(s->reqs + i, s->item))
+                stream_sha256_varint(&s->reqs[i].sha, v);
+        s->remaining = v;
+        if (v)
+            next_field(s, SS_OUTPUT_SCRIPT, 0);
+        else
+            end_output(s);
+        break;
+    case SS_NUM_WITNESS_ITEMS:
+        if (wally_exceeds_input_limit(WALLY_LIMIT_TX_WITNESS_ITEMS, v))
+            return WALLY_EINVAL;
+        if ((s->num_items = v))
+            next_field(s, SS_WITNESS_ITEM_LEN, 1);
+        else
+            end_witness_stack(s);
+        break;
+    case SS_WITNESS_ITEM_LEN:
+        if ((s->remaining = v))
+            next_field(s, SS_WITNESS_ITEM, 0);
+        else
+            end_witness_item(s);
+        break;
+    case SS_LOCKTIME:
+        uint32_from_le_bytes(p, &s->locktime);
+        for (i = 0; i < s->num_reqs; ++i) {
+            struct sighash_stream_req *r = s->reqs + i;
+            if (!r->bip143 && !r->is_one) {
+                sha256_le32(&r->sha, s->locktime);
+                sha256_le32(&r->sha, r->sighash);
+            }
+        }
+        next_field(s, SS_DONE, 0);
+        break;
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_stream_update(struct wally_tx_sighash_stream *stream,
+                                   const unsigned char *bytes, size_t bytes_len)
+{
+    struct wally_tx_sighash_stream *s = stream;
+    int ret = WALLY_OK;
+
+    if (!s || s->state == SS_FAILED || (!bytes) != (!bytes_len))
+        return WALLY_EINVAL;
+
+    s->total_len += bytes_len;
+    if (wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, s->total_len))
+        ret = WALLY_EINVAL; /* Too long */
+
+    while (ret == WALLY_OK && bytes_len) {
+        size_t n;
+
+        if (s->state == SS_DONE) {
+            ret = WALLY_EINVAL; /* Trailing data */
+            break;
+        }
+        if (s->state == SS_INPUT_SCRIPT || s->state == SS_OUTPUT_SCRIPT ||
+            s->state == SS_WITNESS_ITEM) {
+            n = s->remaining < bytes_len ? s->remaining : bytes_len;
+            process_bytes(s, bytes, n);
+        } else {
+            n = s->need - s->have < bytes_len ? s->need - s->have : bytes_len;
+            memcpy(s->buf + s->have, bytes, n);
+            if ((s->have += n) == s->need)
+                ret = process_field(s);
+        }
+        bytes += n;
+        bytes_len -= n;
+    }
+    if (ret != WALLY_OK)
+        s->state = SS_FAILED;
+    return ret;
+}
+
+/* Compute the BIP 143 signature hash of a request once streamed */
+static void bip143_final(const struct wally_tx_sighash_stream *s,
+                         struct sighash_stream_req *r, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx = s->prevouts, sha_ctx;
+    unsigned char buff[SHA256_LEN];
+
+    sha256_init(&sha_ctx);
+    sha256_le32(&sha_ctx, s->version);
+
+    if (is_anyonecanpay(r))
+        memset(buff, 0, SHA256_LEN);
+    else
+        stream_sha256d_done(&ctx, buff);
+    sha256_update(&sha_ctx, buff, SHA256_LEN);
+
+    ctx = s->sequences;
+    if (is_anyonecanpay(r) || is_single(r) || is_none(r))
+        memset(buff, 0, SHA256_LEN);
+    else
+        stream_sha256d_done(&ctx, buff);
+    sha256_update(&sha_ctx, buff, SHA256_LEN);
+
+    sha256_update(&sha_ctx, r->prevout, SS_PREVOUT_LEN);
+    stream_sha256_varint(&sha_ctx, r->script_len);
+    if (r->script_len)
+        sha256_update(&sha_ctx, r->script, r->script_len);
+    sha256_le64(&sha_ctx, r->satoshi);
+    sha256_le32(&sha_ctx, r->sequence);
+
+    ctx = s->outputs;
+    if (is_none(r) || (is_single(r) && r->index >= s->num_outputs))
+        memset(buff, 0, SHA256_LEN);
+    else if (is_single(r))
+        stream_sha256d_done(&r->sha, buff);
+    else
+        stream_sha256d_done(&ctx, buff);
+    sha256_update(&sha_ctx, buff, SHA256_LEN);
+
+    sha256_le32(&sha_ctx, s->locktime);
+    sha256_le32(&sha_ctx, r->sighash);
+    stream_sha256d_done(&sha_ctx, bytes_out);
+    wally_clear_3(&ctx, sizeof(ctx), &sha_ctx, sizeof(sha_ctx), buff, sizeof(buff));
+}
+
+int wally_tx_sighash_stream_final(struct wally_tx_sighash_stream *stream,
+                                  unsigned char *bytes_out, size_t len)
+{
+    size_t i;
+
+    if (!stream || stream->state != SS_DONE || !bytes_out ||
+        len != stream->num_reqs * SHA256_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < stream->num_reqs; ++i)
+        if (stream->reqs[i].bip143 && stream->reqs[i].index >= stream->num_inputs)
+            return WALLY_EINVAL;
+
+    stream->state = SS_FAILED; /* Only free may be called from now on */
+    for (i = 0; i < stream->num_reqs; ++i) {
+        struct sighash_stream_req *r = stream->reqs + i;
+        unsigned char *out = bytes_out + i * SHA256_LEN;
+        if (r->bip143)
+            bip143_final(stream, r, out);
+        else if (r->is_one) {
+            memset(out, 0, SHA256_LEN);
+            out[0] = 0x1;
+        } else
+            stream_sha256d_done(&r->sha, out);
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_stream_free(struct wally_tx_sighash_stream *stream)
+{
+    size_t i;
+
+    if (stream) {
+        for (i = 0; i < stream->num_reqs; ++i)
+            clear_and_free(stream->reqs[i].script, stream->reqs[i].script_len);
+        clear_and_free(stream->reqs, stream->num_reqs * sizeof(*stream->reqs));
+        clear_and_free(stream, sizeof(*stream));
+    }
+    return WALLY_OK;
+}
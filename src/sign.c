@@ -1,17 +1,28 @@
 #include "internal.h"
 #include <include/wally_crypto.h>
 #include "script_int.h"
+#include "secp256k1/include/secp256k1_ecdh.h"
+#include "secp256k1/include/secp256k1_recovery.h"
 #if 0
 #include "secp256k1/include/secp256k1_schnorr.h"
 #endif
 #include "ccan/ccan/build_assert/build_assert.h"
+#include "ccan/ccan/crypto/sha256/sha256.h"
 #include <stdbool.h>
 
 #define EC_FLAGS_TYPES (EC_FLAG_ECDSA | EC_FLAG_SCHNORR)
-#define EC_FLAGS_ALL (EC_FLAG_ECDSA | EC_FLAG_SCHNORR | EC_FLAG_GRIND_R)
+#define EC_FLAGS_ALL (EC_FLAG_ECDSA | EC_FLAG_SCHNORR | EC_FLAG_GRIND_R | EC_FLAG_RECOVERABLE)
+#define EC_FLAGS_BATCH (EC_FLAG_ECDSA | EC_FLAG_GRIND_R | EC_FLAG_DER | EC_FLAG_RECOVERABLE)
+
+/* The header byte of a recoverable signature for a compressed public key is
+ * this plus the recovery id, as used by Bitcoin signed messages */
+#define RECOVERABLE_HEADER_COMPRESSED (27 + 4)
 
 #define MSG_ALL_FLAGS (BITCOIN_MESSAGE_FLAG_HASH)
 
+/* The number of public keys serialized before hashing them as a batch */
+#define PUBKEY_HASH_BATCH 8
+
 static const char MSG_PREFIX[] = "\x18" "Bitcoin Signed Message:\n";
 
 /* LCOV_EXCL_START */
@@ -52,6 +63,8 @@ int wally_ec_public_key_from_private_key(const unsigned char *priv_key, size_t p
 
     if (!ctx)
         return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_SIGN))
+        return WALLY_ERROR;
 
     ok = priv_key && priv_key_len == EC_PRIVATE_KEY_LEN &&
          bytes_out && len == EC_PUBLIC_KEY_LEN &&
@@ -65,6 +78,103 @@ int wally_ec_public_key_from_private_key(const unsigned char *priv_key, size_t p
     return ok ? WALLY_OK : WALLY_EINVAL;
 }
 
+int wally_ec_public_keys_from_private_keys(const unsigned char *priv_keys, size_t priv_keys_len,
+                                           uint32_t flags,
+                                           unsigned char *bytes_out, size_t len)
+{
+    const size_t num_keys = priv_keys_len / EC_PRIVATE_KEY_LEN;
+    const bool uncompressed = flags & EC_PUBLIC_KEY_FLAG_UNCOMPRESSED;
+    const size_t key_len = uncompressed ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+    const size_t out_len = flags & EC_PUBLIC_KEY_FLAG_HASH160 ? HASH160_LEN : key_len;
+    const unsigned int serialize_flags = uncompressed ? PUBKEY_UNCOMPRESSED : PUBKEY_COMPRESSED;
+    unsigned char pub_keys_buf[PUBKEY_HASH_BATCH * EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    secp256k1_pubkey pub;
+    const secp256k1_context *ctx = secp_ctx();
+    size_t i, len_in_out;
+    bool ok = true;
+
+    if (!priv_keys || !num_keys || priv_keys_len % EC_PRIVATE_KEY_LEN ||
+        flags & ~(EC_PUBLIC_KEY_FLAG_UNCOMPRESSED | EC_PUBLIC_KEY_FLAG_HASH160) ||
+        !bytes_out || len != num_keys * out_len)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_SIGN))
+        return WALLY_ERROR;
+
+    for (i = 0; i < num_keys && ok; ++i) {
+        /* Serialize directly into the output unless it is to be hashed */
+        const size_t n = i % PUBKEY_HASH_BATCH + 1;
+        unsigned char *dest = flags & EC_PUBLIC_KEY_FLAG_HASH160 ?
+                              pub_keys_buf + (n - 1) * key_len : bytes_out + i * out_len;
+
+        len_in_out = key_len;
+        ok = pubkey_create(ctx, &pub, priv_keys + i * EC_PRIVATE_KEY_LEN) &&
+             pubkey_serialize(ctx, dest, &len_in_out, &pub, serialize_flags) &&
+             len_in_out == key_len;
+        if (ok && (flags & EC_PUBLIC_KEY_FLAG_HASH160) &&
+            (n == PUBKEY_HASH_BATCH || i + 1 == num_keys))
+            ok = wally_hash160_batch(pub_keys_buf, n * key_len, key_len,
+                                     bytes_out + (i + 1 - n) * HASH160_LEN,
+                                     n * HASH160_LEN) == WALLY_OK;
+    }
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear_2(&pub, sizeof(pub), pub_keys_buf, sizeof(pub_keys_buf));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_public_keys_convert(const unsigned char *pub_keys, size_t pub_keys_len,
+                                 uint32_t flags,
+                                 unsigned char *bytes_out, size_t len)
+{
+    const size_t in_len = flags & EC_PUBLIC_KEY_FLAG_FROM_UNCOMPRESSED ?
+                          EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+    const size_t num_keys = pub_keys_len / in_len;
+    const bool uncompressed = flags & EC_PUBLIC_KEY_FLAG_UNCOMPRESSED;
+    const size_t key_len = uncompressed ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+    const size_t out_len = flags & EC_PUBLIC_KEY_FLAG_HASH160 ? HASH160_LEN : key_len;
+    const unsigned int serialize_flags = uncompressed ? PUBKEY_UNCOMPRESSED : PUBKEY_COMPRESSED;
+    unsigned char pub_keys_buf[PUBKEY_HASH_BATCH * EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    secp256k1_pubkey pub;
+    const secp256k1_context *ctx = secp_ctx();
+    size_t i, len_in_out;
+    bool ok = true;
+
+    if (!pub_keys || !num_keys || pub_keys_len % in_len ||
+        flags & ~(EC_PUBLIC_KEY_FLAG_UNCOMPRESSED | EC_PUBLIC_KEY_FLAG_HASH160 |
+                  EC_PUBLIC_KEY_FLAG_FROM_UNCOMPRESSED) ||
+        !bytes_out || len != num_keys * out_len)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < num_keys && ok; ++i) {
+        /* Serialize directly into the output unless it is to be hashed */
+        const size_t n = i % PUBKEY_HASH_BATCH + 1;
+        unsigned char *dest = flags & EC_PUBLIC_KEY_FLAG_HASH160 ?
+                              pub_keys_buf + (n - 1) * key_len : bytes_out + i * out_len;
+
+        len_in_out = key_len;
+        ok = pubkey_parse(ctx, &pub, pub_keys + i * in_len, in_len) &&
+             pubkey_serialize(ctx, dest, &len_in_out, &pub, serialize_flags) &&
+             len_in_out == key_len;
+        if (ok && (flags & EC_PUBLIC_KEY_FLAG_HASH160) &&
+            (n == PUBKEY_HASH_BATCH || i + 1 == num_keys))
+            ok = wally_hash160_batch(pub_keys_buf, n * key_len, key_len,
+                                     bytes_out + (i + 1 - n) * HASH160_LEN,
+                                     n * HASH160_LEN) == WALLY_OK;
+    }
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear_2(&pub, sizeof(pub), pub_keys_buf, sizeof(pub_keys_buf));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
 int wally_ec_public_key_decompress(const unsigned char *pub_key, size_t pub_key_len,
                                    unsigned char *bytes_out, size_t len)
 {
@@ -88,6 +198,249 @@ int wally_ec_public_key_decompress(const unsigned char *pub_key, size_t pub_key_
     return ok ? WALLY_OK : WALLY_EINVAL;
 }
 
+int wally_ec_public_key_init_alloc(const unsigned char *pub_key, size_t pub_key_len,
+                                   struct wally_ec_public_key **output)
+{
+    struct wally_ec_public_key *key;
+    const secp256k1_context *ctx = secp_ctx();
+
+    if (output)
+        *output = NULL;
+
+    if (!pub_key || pub_key_len != EC_PUBLIC_KEY_LEN || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!(key = wally_malloc(sizeof(*key))))
+        return WALLY_ENOMEM;
+
+    if (!pubkey_parse(ctx, &key->pub, pub_key, pub_key_len)) {
+        wally_ec_public_key_free(key);
+        return WALLY_EINVAL;
+    }
+    memcpy(key->pub_key, pub_key, sizeof(key->pub_key));
+    *output = key;
+    return WALLY_OK;
+}
+
+int wally_ec_public_key_decompress_parsed(const struct wally_ec_public_key *key,
+                                          unsigned char *bytes_out, size_t len)
+{
+    size_t len_in_out = EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+    const secp256k1_context *ctx = secp_ctx();
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    ok = key && bytes_out && len == EC_PUBLIC_KEY_UNCOMPRESSED_LEN &&
+         pubkey_serialize(ctx, bytes_out, &len_in_out, &key->pub, PUBKEY_UNCOMPRESSED) &&
+         len_in_out == EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+
+    if (!ok && bytes_out)
+        wally_clear(bytes_out, len);
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_public_key_free(struct wally_ec_public_key *key)
+{
+    if (!key)
+        return WALLY_EINVAL;
+    wally_clear(key, sizeof(*key));
+    wally_free(key);
+    return WALLY_OK;
+}
+
+/* Add tweak times the generator to pub, serializing the resulting key */
+static bool pubkey_tweak_serialize(const secp256k1_context *ctx,
+                                   const secp256k1_pubkey *pub,
+                                   const unsigned char *tweak,
+                                   unsigned int serialize_flags,
+                                   unsigned char *bytes_out, size_t len)
+{
+    secp256k1_pubkey tweaked;
+    size_t len_in_out = len;
+    bool ok;
+
+    memcpy(&tweaked, pub, sizeof(tweaked));
+    ok = pubkey_tweak_add(ctx, &tweaked, tweak) &&
+         pubkey_serialize(ctx, bytes_out, &len_in_out, &tweaked, serialize_flags) &&
+         len_in_out == len;
+    wally_clear(&tweaked, sizeof(tweaked));
+    return ok;
+}
+
+/* Add tweak to priv_key modulo the group order, writing the resulting key */
+static bool privkey_tweak(const secp256k1_context *ctx,
+                          const unsigned char *priv_key,
+                          const unsigned char *tweak, unsigned char *bytes_out)
+{
+    /* The tweak function doesn't reject invalid keys, so check first */
+    if (!secp256k1_ec_seckey_verify(ctx, priv_key))
+        return false;
+    memmove(bytes_out, priv_key, EC_PRIVATE_KEY_LEN);
+    return privkey_tweak_add(ctx, bytes_out, tweak) != 0;
+}
+
+int wally_ec_public_key_tweak_add(const unsigned char *pub_key, size_t pub_key_len,
+                                  const unsigned char *tweak, size_t tweak_len,
+                                  unsigned char *bytes_out, size_t len)
+{
+    secp256k1_pubkey pub;
+    const secp256k1_context *ctx = secp_ctx();
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    ok = pub_key && pub_key_len == EC_PUBLIC_KEY_LEN &&
+         tweak && tweak_len == EC_PRIVATE_KEY_LEN &&
+         bytes_out && len == EC_PUBLIC_KEY_LEN &&
+         pubkey_parse(ctx, &pub, pub_key, pub_key_len) &&
+         pubkey_tweak_serialize(ctx, &pub, tweak, PUBKEY_COMPRESSED, bytes_out, len);
+
+    if (!ok && bytes_out)
+        wally_clear(bytes_out, len);
+    wally_clear(&pub, sizeof(pub));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_public_key_tweak_add_parsed(const struct wally_ec_public_key *key,
+                                         const unsigned char *tweak, size_t tweak_len,
+                                         unsigned char *bytes_out, size_t len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    ok = key && tweak && tweak_len == EC_PRIVATE_KEY_LEN &&
+         bytes_out && len == EC_PUBLIC_KEY_LEN &&
+         pubkey_tweak_serialize(ctx, &key->pub, tweak, PUBKEY_COMPRESSED, bytes_out, len);
+
+    if (!ok && bytes_out)
+        wally_clear(bytes_out, len);
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_public_keys_tweak_add(const unsigned char *pub_keys, size_t pub_keys_len,
+                                   const unsigned char *tweaks, size_t tweaks_len,
+                                   uint32_t flags,
+                                   unsigned char *bytes_out, size_t len)
+{
+    const size_t num_keys = tweaks_len / EC_PRIVATE_KEY_LEN;
+    const bool shared_key = pub_keys_len == EC_PUBLIC_KEY_LEN;
+    const bool uncompressed = flags & EC_PUBLIC_KEY_FLAG_UNCOMPRESSED;
+    const size_t key_len = uncompressed ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+    const size_t out_len = flags & EC_PUBLIC_KEY_FLAG_HASH160 ? HASH160_LEN : key_len;
+    const unsigned int serialize_flags = uncompressed ? PUBKEY_UNCOMPRESSED : PUBKEY_COMPRESSED;
+    unsigned char pub_keys_buf[PUBKEY_HASH_BATCH * EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    secp256k1_pubkey pub;
+    const secp256k1_context *ctx = secp_ctx();
+    size_t i;
+    bool ok = true;
+
+    if (!pub_keys || (!shared_key && pub_keys_len != num_keys * EC_PUBLIC_KEY_LEN) ||
+        !tweaks || !num_keys || tweaks_len % EC_PRIVATE_KEY_LEN ||
+        flags & ~(EC_PUBLIC_KEY_FLAG_UNCOMPRESSED | EC_PUBLIC_KEY_FLAG_HASH160) ||
+        !bytes_out || len != num_keys * out_len)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    /* A key shared by every tweak is only parsed once */
+    if (shared_key)
+        ok = pubkey_parse(ctx, &pub, pub_keys, EC_PUBLIC_KEY_LEN);
+
+    for (i = 0; i < num_keys && ok; ++i) {
+        /* Serialize directly into the output unless it is to be hashed */
+        const size_t n = i % PUBKEY_HASH_BATCH + 1;
+        unsigned char *dest = flags & EC_PUBLIC_KEY_FLAG_HASH160 ?
+                              pub_keys_buf + (n - 1) * key_len : bytes_out + i * out_len;
+
+        if (!shared_key)
+            ok = pubkey_parse(ctx, &pub, pub_keys + i * EC_PUBLIC_KEY_LEN, EC_PUBLIC_KEY_LEN);
+        ok = ok && pubkey_tweak_serialize(ctx, &pub, tweaks + i * EC_PRIVATE_KEY_LEN,
+                                          serialize_flags, dest, key_len);
+        if (ok && (flags & EC_PUBLIC_KEY_FLAG_HASH160) &&
+            (n == PUBKEY_HASH_BATCH || i + 1 == num_keys))
+            ok = wally_hash160_batch(pub_keys_buf, n * key_len, key_len,
+                                     bytes_out + (i + 1 - n) * HASH160_LEN,
+                                     n * HASH160_LEN) == WALLY_OK;
+    }
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear_2(&pub, sizeof(pub), pub_keys_buf, sizeof(pub_keys_buf));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_private_key_tweak_add(const unsigned char *priv_key, size_t priv_key_len,
+                                   const unsigned char *tweak, size_t tweak_len,
+                                   unsigned char *bytes_out, size_t len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    bool ok;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    ok = priv_key && priv_key_len == EC_PRIVATE_KEY_LEN &&
+         tweak && tweak_len == EC_PRIVATE_KEY_LEN &&
+         bytes_out && len == EC_PRIVATE_KEY_LEN &&
+         privkey_tweak(ctx, priv_key, tweak, bytes_out);
+
+    if (!ok && bytes_out)
+        wally_clear(bytes_out, len);
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+int wally_ec_private_keys_tweak_add(const unsigned char *priv_keys, size_t priv_keys_len,
+                                    const unsigned char *tweaks, size_t tweaks_len,
+                                    unsigned char *bytes_out, size_t len)
+{
+    const size_t num_keys = tweaks_len / EC_PRIVATE_KEY_LEN;
+    const size_t priv_key_stride = priv_keys_len == EC_PRIVATE_KEY_LEN ? 0 : EC_PRIVATE_KEY_LEN;
+    unsigned char shared_key[EC_PRIVATE_KEY_LEN];
+    const secp256k1_context *ctx = secp_ctx();
+    size_t i;
+    bool ok = true;
+
+    if (!priv_keys || (priv_key_stride && priv_keys_len != num_keys * EC_PRIVATE_KEY_LEN) ||
+        !tweaks || !num_keys || tweaks_len % EC_PRIVATE_KEY_LEN ||
+        !bytes_out || len != tweaks_len)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    /* Copy a key shared by every tweak, in case the output overwrites it */
+    if (!priv_key_stride) {
+        memcpy(shared_key, priv_keys, sizeof(shared_key));
+        priv_keys = shared_key;
+    }
+
+    for (i = 0; i < num_keys && ok; ++i)
+        ok = privkey_tweak(ctx, priv_keys + i * priv_key_stride,
+                           tweaks + i * EC_PRIVATE_KEY_LEN,
+                           bytes_out + i * EC_PRIVATE_KEY_LEN);
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear(shared_key, sizeof(shared_key));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
 int wally_ec_sig_normalize(const unsigned char *sig, size_t sig_len,
                            unsigned char *bytes_out, size_t len)
 {
@@ -164,57 +517,582 @@ int wally_ec_sig_from_der(const unsigned char *bytes, size_t bytes_len,
     return ok ? WALLY_OK : WALLY_EINVAL;
 }
 
+int wally_ec_sig_normalize_batch(const unsigned char *sigs, size_t sigs_len,
+                                 unsigned char *results_out, size_t results_out_len,
+                                 unsigned char *bytes_out, size_t len)
+{
+    secp256k1_ecdsa_signature sig_secp, sig_low;
+    const size_t num_sigs = results_out_len;
+    const secp256k1_context *ctx;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!sigs || sigs_len / EC_SIGNATURE_LEN != num_sigs || sigs_len % EC_SIGNATURE_LEN ||
+        !results_out || !num_sigs || !bytes_out || len != sigs_len)
+        return WALLY_EINVAL;
+
+    if (!(ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < num_sigs; ++i) {
+        unsigned char *out = bytes_out + i * EC_SIGNATURE_LEN;
+
+        /* The signature is parsed before writing, so sigs may be bytes_out */
+        results_out[i] = secp256k1_ecdsa_signature_parse_compact(ctx, &sig_secp,
+                                                                 sigs + i * EC_SIGNATURE_LEN);
+        if (results_out[i]) {
+            secp256k1_ecdsa_signature_normalize(ctx, &sig_low, &sig_secp);
+            results_out[i] = secp256k1_ecdsa_signature_serialize_compact(ctx, out, &sig_low);
+        }
+        if (!results_out[i]) {
+            wally_clear(out, EC_SIGNATURE_LEN);
+            ret = WALLY_EINVAL;
+        }
+    }
+    wally_clear_2(&sig_secp, sizeof(sig_secp), &sig_low, sizeof(sig_low));
+    return ret;
+}
+
+int wally_ec_sig_to_der_batch(const unsigned char *sigs, size_t sigs_len,
+                              size_t *lens_out, size_t lens_out_len,
+                              unsigned char *bytes_out, size_t len)
+{
+    secp256k1_ecdsa_signature sig_secp;
+    const size_t num_sigs = lens_out_len;
+    const secp256k1_context *ctx;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!sigs || sigs_len / EC_SIGNATURE_LEN != num_sigs || sigs_len % EC_SIGNATURE_LEN ||
+        !lens_out || !num_sigs || !bytes_out ||
+        len / EC_SIGNATURE_DER_MAX_LEN != num_sigs || len % EC_SIGNATURE_DER_MAX_LEN)
+        return WALLY_EINVAL;
+
+    if (!(ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < num_sigs; ++i) {
+        unsigned char *out = bytes_out + i * EC_SIGNATURE_DER_MAX_LEN;
+
+        lens_out[i] = EC_SIGNATURE_DER_MAX_LEN;
+        if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig_secp,
+                                                     sigs + i * EC_SIGNATURE_LEN) ||
+            !secp256k1_ecdsa_signature_serialize_der(ctx, out, lens_out + i, &sig_secp)) {
+            lens_out[i] = 0;
+            ret = WALLY_EINVAL;
+        }
+        wally_clear(out + lens_out[i], EC_SIGNATURE_DER_MAX_LEN - lens_out[i]);
+    }
+    wally_clear(&sig_secp, sizeof(sig_secp));
+    return ret;
+}
+
+int wally_ec_sig_from_der_batch(const unsigned char *bytes, size_t bytes_len,
+                                const size_t *lens, size_t num_lens,
+                                unsigned char *results_out, size_t results_out_len,
+                                unsigned char *bytes_out, size_t len)
+{
+    secp256k1_ecdsa_signature sig_secp;
+    const secp256k1_context *ctx;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!bytes || bytes_len / EC_SIGNATURE_DER_MAX_LEN != num_lens ||
+        bytes_len % EC_SIGNATURE_DER_MAX_LEN || !lens || !num_lens ||
+        !results_out || results_out_len != num_lens ||
+        !bytes_out || len != num_lens * EC_SIGNATURE_LEN)
+        return WALLY_EINVAL;
+
+    if (!(ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    for (i = 0; i < num_lens; ++i) {
+        unsigned char *out = bytes_out + i * EC_SIGNATURE_LEN;
+
+        results_out[i] = lens[i] && lens[i] <= EC_SIGNATURE_DER_MAX_LEN &&
+                         secp256k1_ecdsa_signature_parse_der(ctx, &sig_secp,
+                                                             bytes + i * EC_SIGNATURE_DER_MAX_LEN,
+                                                             lens[i]) &&
+                         secp256k1_ecdsa_signature_serialize_compact(ctx, out, &sig_secp);
+        if (!results_out[i]) {
+            wally_clear(out, EC_SIGNATURE_LEN);
+            ret = WALLY_EINVAL;
+        }
+    }
+    wally_clear(&sig_secp, sizeof(sig_secp));
+    return ret;
+}
+
+/* The nonce function to sign with, fetched once from the current operations */
+struct ecdsa_nonce {
+    wally_ec_nonce_t fn;
+    wally_ec_nonce_ctx_t ctx_fn;
+    void *ctx;
+    void *entropy; /* The extra entropy passed to ctx_fn */
+};
+
+static void ecdsa_nonce_get(struct ecdsa_nonce *nonce)
+{
+    const struct wally_operations *ops = wally_ops();
+    nonce->fn = ops->ec_nonce_fn;
+    nonce->ctx_fn = ops->ec_nonce_ctx_fn;
+    nonce->ctx = ops->ec_nonce_ctx;
+    nonce->entropy = NULL;
+}
+
+/* Pass a caller nonce context through the secp256k1 nonce data */
+static int ecdsa_nonce_ctx_fn(unsigned char *nonce32, const unsigned char *msg32,
+                              const unsigned char *key32, const unsigned char *algo16,
+                              void *data, unsigned int attempt)
+{
+    const struct ecdsa_nonce *nonce = data;
+    return nonce->ctx_fn(nonce->ctx, nonce32, msg32, key32, algo16,
+                         nonce->entropy, attempt);
+}
+
+/* Create a compact ECDSA signature, grinding for low-R if requested.
+ * Stops after max_attempts signing attempts if non-zero, and returns the
+ * number of attempts made in attempts if non-NULL */
+static int ecdsa_sign(const secp256k1_context *ctx, const struct ecdsa_nonce *nonce,
+                      const unsigned char *priv_key, const unsigned char *bytes,
+                      uint32_t flags, uint32_t max_attempts, uint32_t *attempts,
+                      unsigned char *bytes_out)
+{
+    unsigned char extra_entropy[32] = {0}, *entropy_p = NULL;
+    const bool recoverable = flags & EC_FLAG_RECOVERABLE;
+    struct ecdsa_nonce nonce_data = *nonce;
+    wally_ec_nonce_t nonce_fn = nonce->ctx_fn ? ecdsa_nonce_ctx_fn : nonce->fn;
+    uint32_t counter = 0;
+    secp256k1_ecdsa_signature sig_secp;
+    secp256k1_ecdsa_recoverable_signature rsig_secp;
+    void *data;
+    int ok, recid;
+
+    while (true) {
+        if (attempts)
+            *attempts = counter + 1;
+        nonce_data.entropy = entropy_p;
+        data = nonce->ctx_fn ? (void *)&nonce_data : entropy_p;
+        if (recoverable)
+            WALLY_STATS_TIMED(WALLY_STAT_EC_SIGNS, WALLY_STAT_EC_SIGN_NS, ok,
+                              secp256k1_ecdsa_sign_recoverable(ctx, &rsig_secp, bytes, priv_key,
+                                                               nonce_fn, data));
+        else
+            WALLY_STATS_TIMED(WALLY_STAT_EC_SIGNS, WALLY_STAT_EC_SIGN_NS, ok,
+                              secp256k1_ecdsa_sign(ctx, &sig_secp, bytes, priv_key,
+                                                   nonce_fn, data));
+        if (!ok) {
+            wally_clear_2(&sig_secp, sizeof(sig_secp), &rsig_secp, sizeof(rsig_secp));
+            if (!secp256k1_ec_seckey_verify(ctx, priv_key))
+                return WALLY_EINVAL; /* invalid priv_key */
+            return WALLY_ERROR;     /* Nonce function failed */
+        }
+
+        /* Note these functions are documented as never failing */
+        if (recoverable) {
+            secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, bytes_out + 1,
+                                                                    &recid, &rsig_secp);
+            bytes_out[0] = RECOVERABLE_HEADER_COMPRESSED + recid;
+        } else
+            secp256k1_ecdsa_signature_serialize_compact(ctx, bytes_out, &sig_secp);
+
+        if (!(flags & EC_FLAG_GRIND_R) || bytes_out[recoverable ? 1 : 0] < 0x80 ||
+            counter + 1 == max_attempts) {
+            wally_clear_2(&sig_secp, sizeof(sig_secp), &rsig_secp, sizeof(rsig_secp));
+            return WALLY_OK;
+        }
+        /* Incremement nonce to grind for low-R */
+        entropy_p = extra_entropy;
+        ++counter;
+        uint32_to_le_bytes(counter, entropy_p);
+    }
+}
+
+/* A private key with the key dependent RFC6979 HMAC-DRBG state precomputed */
+struct wally_ec_signing_key {
+    unsigned char priv_key[EC_PRIVATE_KEY_LEN];
+    /* The HMAC of RFC6979 3.2.d, with K = 0 and V || 0x00 || priv_key absorbed */
+    struct sha256_ctx inner;
+    struct sha256_ctx outer;
+};
+
+#define NONCE_HMAC_BLOCK_LEN 64 /* The SHA256 block size */
+
+/* HMAC-SHA256 midstates with the key blocks absorbed, for reuse */
+struct nonce_hmac {
+    struct sha256_ctx inner;
+    struct sha256_ctx outer;
+};
+
+static void nonce_hmac_init(struct nonce_hmac *h, const unsigned char *key32)
+{
+    unsigned char pad[NONCE_HMAC_BLOCK_LEN];
+    size_t i;
+
+    for (i = 0; i < sizeof(pad); ++i)
+        pad[i] = (i < SHA256_LEN ? key32[i] : 0) ^ 0x36;
+    sha256_init(&h->inner);
+    sha256_update(&h->inner, pad, sizeof(pad));
+    for (i = 0; i < sizeof(pad); ++i)
+        pad[i] ^= 0x36 ^ 0x5c;
+    sha256_init(&h->outer);
+    sha256_update(&h->outer, pad, sizeof(pad));
+    wally_clear(pad, sizeof(pad));
+}
+
+/* Finish an HMAC whose message has been written to inner */
+static void nonce_hmac_done(const struct sha256_ctx *outer_mid,
+                            struct sha256_ctx *inner, unsigned char *bytes_out)
+{
+    struct sha256_ctx outer = *outer_mid;
+    struct sha256 sha;
+
+    sha256_done(inner, &sha);
+    sha256_update(&outer, &sha, sizeof(sha));
+    sha256_done(&outer, &sha);
+    memcpy(bytes_out, &sha, sizeof(sha));
+    wally_clear_2(&outer, sizeof(outer), &sha, sizeof(sha));
+}
+
+/* V = HMAC_K(V), using the midstates for K */
+static void nonce_hmac_v(const struct nonce_hmac *h, unsigned char *v)
+{
+    struct sha256_ctx inner = h->inner;
+    sha256_update(&inner, v, SHA256_LEN);
+    nonce_hmac_done(&h->outer, &inner, v);
+}
+
+int wally_ec_signing_key_init_alloc(const unsigned char *priv_key, size_t priv_key_len,
+                                    struct wally_ec_signing_key **output)
+{
+    static const unsigned char zero = 0;
+    unsigned char k[SHA256_LEN] = { 0 }, v[SHA256_LEN];
+    struct wally_ec_signing_key *key;
+    struct nonce_hmac h;
+    const secp256k1_context *ctx = secp_ctx();
+
+    if (output)
+        *output = NULL;
+
+    if (!priv_key || priv_key_len != EC_PRIVATE_KEY_LEN || !output)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    if (!secp256k1_ec_seckey_verify(ctx, priv_key))
+        return WALLY_EINVAL;
+
+    if (!(key = wally_malloc(sizeof(*key))))
+        return WALLY_ENOMEM;
+
+    memcpy(key->priv_key, priv_key, sizeof(key->priv_key));
+    nonce_hmac_init(&h, k);
+    memset(v, 0x01, sizeof(v));
+    key->inner = h.inner;
+    sha256_update(&key->inner, v, sizeof(v));
+    sha256_update(&key->inner, &zero, 1);
+    sha256_update(&key->inner, priv_key, EC_PRIVATE_KEY_LEN);
+    key->outer = h.outer;
+    wally_clear(&h, sizeof(h));
+    *output = key;
+    return WALLY_OK;
+}
+
+int wally_ec_signing_key_free(struct wally_ec_signing_key *key)
+{
+    if (key) {
+        wally_clear(key, sizeof(*key));
+        wally_free(key);
+    }
+    return WALLY_OK;
+}
+
+int wally_ec_signing_key_nonce(void *nonce_ctx, unsigned char *nonce32,
+                               const unsigned char *msg32, const unsigned char *key32,
+                               const unsigned char *algo16, void *data,
+                               unsigned int attempt)
+{
+    static const unsigned char zero = 0, one = 1;
+    const struct wally_ec_signing_key *key = nonce_ctx;
+    unsigned char k[SHA256_LEN], v[SHA256_LEN], diff = 0;
+    struct nonce_hmac h;
+    struct sha256_ctx inner;
+    size_t i;
+
+    if (!key || !nonce32 || !msg32 || !key32)
+        return 0;
+
+    for (i = 0; i < EC_PRIVATE_KEY_LEN; ++i)
+        diff |= key->priv_key[i] ^ key32[i];
+    if (diff) {
+        /* Signing with a different key: use the regular nonce function */
+        wally_ec_nonce_t nonce_fn = wally_ops()->ec_nonce_fn;
+        return nonce_fn(nonce32, msg32, key32, algo16, data, attempt);
+    }
+
+    /* RFC6979 3.2.d: K = HMAC_K(V || 0x00 || key || msg || data || algo),
+     * continuing from the precomputed midstate */
+    inner = key->inner;
+    sha256_update(&inner, msg32, SHA256_LEN);
+    if (data)
+        sha256_update(&inner, data, SHA256_LEN);
+    if (algo16)
+        sha256_update(&inner, algo16, 16);
+    nonce_hmac_done(&key->outer, &inner, k);
+    /* RFC6979 3.2.e: V = HMAC_K(V) */
+    nonce_hmac_init(&h, k);
+    memset(v, 0x01, sizeof(v));
+    nonce_hmac_v(&h, v);
+    /* RFC6979 3.2.f: K = HMAC_K(V || 0x01 || key || msg || data || algo).
+     * The midstates for K are reused rather than rehashing the key blocks */
+    inner = h.inner;
+    sha256_update(&inner, v, sizeof(v));
+    sha256_update(&inner, &one, 1);
+    sha256_update(&inner, key32, EC_PRIVATE_KEY_LEN);
+    sha256_update(&inner, msg32, SHA256_LEN);
+    if (data)
+        sha256_update(&inner, data, SHA256_LEN);
+    if (algo16)
+        sha256_update(&inner, algo16, 16);
+    nonce_hmac_done(&h.outer, &inner, k);
+    /* RFC6979 3.2.g: V = HMAC_K(V) */
+    nonce_hmac_init(&h, k);
+    nonce_hmac_v(&h, v);
+    /* RFC6979 3.2.h: generate, reseeding for each retry */
+    for (i = 0; i <= attempt; ++i) {
+        if (i) {
+            inner = h.inner;
+            sha256_update(&inner, v, sizeof(v));
+            sha256_update(&inner, &zero, 1);
+            nonce_hmac_done(&h.outer, &inner, k);
+            nonce_hmac_init(&h, k);
+            nonce_hmac_v(&h, v);
+        }
+        nonce_hmac_v(&h, v);
+    }
+    memcpy(nonce32, v, sizeof(v));
+    wally_clear_4(k, sizeof(k), v, sizeof(v), &h, sizeof(h), &inner, sizeof(inner));
+    return 1;
+}
+
 int wally_ec_sig_from_bytes(const unsigned char *priv_key, size_t priv_key_len,
                             const unsigned char *bytes, size_t bytes_len,
                             uint32_t flags,
                             unsigned char *bytes_out, size_t len)
 {
-    wally_ec_nonce_t nonce_fn = wally_ops()->ec_nonce_fn;
+    struct ecdsa_nonce nonce;
     const secp256k1_context *ctx = secp_ctx();
 
     if (!priv_key || priv_key_len != EC_PRIVATE_KEY_LEN ||
         !bytes || bytes_len != EC_MESSAGE_HASH_LEN ||
         !is_valid_ec_type(flags) || flags & ~EC_FLAGS_ALL ||
-        !bytes_out || len != EC_SIGNATURE_LEN)
+        ((flags & EC_FLAG_SCHNORR) && (flags & EC_FLAG_RECOVERABLE)) ||
+        !bytes_out ||
+        len != (flags & EC_FLAG_RECOVERABLE ? EC_SIGNATURE_RECOVERABLE_LEN : EC_SIGNATURE_LEN))
         return WALLY_EINVAL;
 
     if (!ctx)
         return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_SIGN))
+        return WALLY_ERROR;
 
     if (flags & EC_FLAG_SCHNORR) {
         return WALLY_EINVAL;
 #if 0 /*FIXME: Schnorr is unavailable in secp for now*/
         if (!secp256k1_schnorr_sign(ctx, bytes_out, bytes,
-                                    priv_key, nonce_fn, NULL))
+                                    priv_key, wally_ops()->ec_nonce_fn, NULL))
             return WALLY_EINVAL; /* Failed to sign */
         return WALLY_OK;
 #endif
-    } else {
-        unsigned char extra_entropy[32] = {0}, *entropy_p = NULL;
-        uint32_t counter = 0;
-        secp256k1_ecdsa_signature sig_secp;
-
-        while (true) {
-            if (!secp256k1_ecdsa_sign(ctx, &sig_secp, bytes, priv_key, nonce_fn, entropy_p)) {
-                wally_clear(&sig_secp, sizeof(sig_secp));
-                if (!secp256k1_ec_seckey_verify(ctx, priv_key))
-                    return WALLY_EINVAL; /* invalid priv_key */
-                return WALLY_ERROR;     /* Nonce function failed */
-            }
-
-            /* Note this function is documented as never failing */
-            secp256k1_ecdsa_signature_serialize_compact(ctx, bytes_out, &sig_secp);
+    }
+    ecdsa_nonce_get(&nonce);
+    return ecdsa_sign(ctx, &nonce, priv_key, bytes, flags, 0, NULL, bytes_out);
+}
+
+int wally_ec_sig_from_bytes_grind(const unsigned char *priv_key, size_t priv_key_len,
+                                  const unsigned char *bytes, size_t bytes_len,
+                                  uint32_t flags, uint32_t max_attempts,
+                                  unsigned char *bytes_out, size_t len,
+                                  uint32_t *attempts)
+{
+    struct ecdsa_nonce nonce;
+    const secp256k1_context *ctx = secp_ctx();
 
-            if (!(flags & EC_FLAG_GRIND_R) || bytes_out[0] < 0x80) {
-                wally_clear(&sig_secp, sizeof(sig_secp));
-                return WALLY_OK;
-            }
-            /* Incremement nonce to grind for low-R */
-            entropy_p = extra_entropy;
-            ++counter;
-            uint32_to_le_bytes(counter, entropy_p);
+    if (attempts)
+        *attempts = 0;
+
+    if (!priv_key || priv_key_len != EC_PRIVATE_KEY_LEN ||
+        !bytes || bytes_len != EC_MESSAGE_HASH_LEN ||
+        flags != (EC_FLAG_ECDSA | EC_FLAG_GRIND_R) ||
+        !bytes_out || len != EC_SIGNATURE_LEN || !attempts)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_SIGN))
+        return WALLY_ERROR;
+
+    ecdsa_nonce_get(&nonce);
+    return ecdsa_sign(ctx, &nonce, priv_key, bytes, flags,
+                      max_attempts, attempts, bytes_out);
+}
+
+/* The inputs and results for signing a batch of hashes as tasks */
+struct sig_from_bytes_tasks {
+    const secp256k1_context *ctx;
+    struct ecdsa_nonce nonce;
+    const unsigned char *priv_keys;
+    const unsigned char *bytes;
+    uint32_t flags;
+    size_t sig_len;        /* Length of each compact signature or DER slot */
+    unsigned char *sigs;   /* Compact signatures, or DER slots */
+    size_t *der_lens;      /* DER lengths, if EC_FLAG_DER is given */
+    int *rets;
+};
+
+static void sig_from_bytes_task(void *task_ctx, size_t i)
+{
+    struct sig_from_bytes_tasks *t = task_ctx;
+    const unsigned char *priv_key = t->priv_keys + i * EC_PRIVATE_KEY_LEN;
+    unsigned char sig[EC_SIGNATURE_LEN], *der;
+    secp256k1_ecdsa_signature sig_secp;
+
+    if (!secp256k1_ec_seckey_verify(t->ctx, priv_key)) {
+        t->rets[i] = WALLY_EINVAL;
+        return;
+    }
+
+    if (!(t->flags & EC_FLAG_DER)) {
+        t->rets[i] = ecdsa_sign(t->ctx, &t->nonce, priv_key,
+                                t->bytes + i * EC_MESSAGE_HASH_LEN, t->flags,
+                                0, NULL, t->sigs + i * t->sig_len);
+        return;
+    }
+
+    der = t->sigs + i * t->sig_len;
+    t->der_lens[i] = EC_SIGNATURE_DER_MAX_LEN;
+    t->rets[i] = ecdsa_sign(t->ctx, &t->nonce, priv_key,
+                            t->bytes + i * EC_MESSAGE_HASH_LEN, t->flags,
+                            0, NULL, sig);
+    if (t->rets[i] == WALLY_OK &&
+        (!secp256k1_ecdsa_signature_parse_compact(t->ctx, &sig_secp, sig) ||
+         !secp256k1_ecdsa_signature_serialize_der(t->ctx, der, t->der_lens + i,
+                                                  &sig_secp)))
+        t->rets[i] = WALLY_ERROR;
+    wally_clear_2(sig, sizeof(sig), &sig_secp, sizeof(sig_secp));
+}
+
+int wally_ec_sig_from_bytes_batch_parallel(const unsigned char *priv_keys, size_t priv_keys_len,
+                                           const unsigned char *bytes, size_t bytes_len,
+                                           uint32_t flags,
+                                           wally_run_tasks_t run_fn, void *run_ctx,
+                                           unsigned char *bytes_out, size_t len,
+                                           size_t *written)
+{
+    struct sig_from_bytes_tasks tasks;
+    const size_t num_sigs = priv_keys_len / EC_PRIVATE_KEY_LEN;
+    const size_t sig_len = flags & EC_FLAG_DER ? EC_SIGNATURE_DER_MAX_LEN :
+                           flags & EC_FLAG_RECOVERABLE ? EC_SIGNATURE_RECOVERABLE_LEN :
+                           EC_SIGNATURE_LEN;
+    size_t i, total = 0;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!priv_keys || !num_sigs || priv_keys_len % EC_PRIVATE_KEY_LEN ||
+        !bytes || bytes_len != num_sigs * EC_MESSAGE_HASH_LEN ||
+        !(flags & EC_FLAG_ECDSA) || flags & ~EC_FLAGS_BATCH ||
+        ((flags & EC_FLAG_DER) && (flags & EC_FLAG_RECOVERABLE)) ||
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_SIGN))
+        return WALLY_ERROR;
+
+    ecdsa_nonce_get(&tasks.nonce);
+    tasks.priv_keys = priv_keys;
+    tasks.bytes = bytes;
+    tasks.flags = flags;
+    tasks.sig_len = sig_len;
+    tasks.sigs = wally_malloc(num_sigs * sig_len);
+    tasks.der_lens = wally_malloc(num_sigs * sizeof(size_t));
+    tasks.rets = wally_malloc(num_sigs * sizeof(int));
+    if (!tasks.sigs || !tasks.der_lens || !tasks.rets) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+
+    wally_run_tasks(run_fn, run_ctx, num_sigs, sig_from_bytes_task, &tasks);
+
+    for (i = 0; i < num_sigs && ret == WALLY_OK; ++i) {
+        ret = tasks.rets[i];
+        total += flags & EC_FLAG_DER ? tasks.der_lens[i] : sig_len;
+    }
+    if (ret != WALLY_OK)
+        goto cleanup;
+
+    *written = total;
+    if (total > len)
+        goto cleanup; /* Tell the caller the required length */
+
+    if (!(flags & EC_FLAG_DER))
+        memcpy(bytes_out, tasks.sigs, total);
+    else {
+        unsigned char *p = bytes_out;
+        for (i = 0; i < num_sigs; ++i) {
+            memcpy(p, tasks.sigs + i * sig_len, tasks.der_lens[i]);
+            p += tasks.der_lens[i];
         }
     }
+
+cleanup:
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    if (tasks.sigs)
+        wally_clear(tasks.sigs, num_sigs * sig_len);
+    wally_free(tasks.sigs);
+    wally_free(tasks.der_lens);
+    wally_free(tasks.rets);
+    return ret;
+}
+
+int wally_ec_sig_from_bytes_batch(const unsigned char *priv_keys, size_t priv_keys_len,
+                                  const unsigned char *bytes, size_t bytes_len,
+                                  uint32_t flags,
+                                  unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    return wally_ec_sig_from_bytes_batch_parallel(priv_keys, priv_keys_len,
+                                                  bytes, bytes_len, flags, NULL, NULL,
+                                                  bytes_out, len, written);
+}
+
+/* Verify sig against an already parsed public key */
+static bool sig_verify(const secp256k1_context *ctx, const secp256k1_pubkey *pub,
+                       const unsigned char *bytes, uint32_t flags,
+                       const unsigned char *sig)
+{
+    secp256k1_ecdsa_signature sig_secp;
+    bool ok;
+
+    if (flags & EC_FLAG_SCHNORR)
+#if 0 /*FIXME: Schnorr is unavailable in secp for now*/
+        ok = secp256k1_schnorr_verify(ctx, sig, bytes, pub);
+#else
+        ok = false;
+#endif
+    else if (!secp256k1_ecdsa_signature_parse_compact(ctx, &sig_secp, sig))
+        ok = false;
+    else
+        WALLY_STATS_TIMED(WALLY_STAT_EC_VERIFIES, WALLY_STAT_EC_VERIFY_NS, ok,
+                          secp256k1_ecdsa_verify(ctx, &sig_secp, bytes, pub) != 0);
+
+    wally_clear(&sig_secp, sizeof(sig_secp));
+    return ok;
 }
 
 int wally_ec_sig_verify(const unsigned char *pub_key, size_t pub_key_len,
@@ -223,7 +1101,6 @@ int wally_ec_sig_verify(const unsigned char *pub_key, size_t pub_key_len,
                         const unsigned char *sig, size_t sig_len)
 {
     secp256k1_pubkey pub;
-    secp256k1_ecdsa_signature sig_secp;
     const secp256k1_context *ctx = secp_ctx();
     bool ok;
 
@@ -235,23 +1112,263 @@ int wally_ec_sig_verify(const unsigned char *pub_key, size_t pub_key_len,
 
     if (!ctx)
         return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
 
-    ok = pubkey_parse(ctx, &pub, pub_key, pub_key_len);
+    ok = pubkey_parse(ctx, &pub, pub_key, pub_key_len) &&
+         sig_verify(ctx, &pub, bytes, flags, sig);
 
-    if (flags & EC_FLAG_SCHNORR)
-#if 0 /*FIXME: Schnorr is unavailable in secp for now*/
-        ok = ok && secp256k1_schnorr_verify(ctx, sig, bytes, &pub);
-#else
-        ok = false;
-#endif
-    else
-        ok = ok && secp256k1_ecdsa_signature_parse_compact(ctx, &sig_secp, sig) &&
-             secp256k1_ecdsa_verify(ctx, &sig_secp, bytes, &pub);
+    wally_clear(&pub, sizeof(pub));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
 
-    wally_clear_2(&pub, sizeof(pub), &sig_secp, sizeof(sig_secp));
+int wally_ec_sig_verify_parsed(const struct wally_ec_public_key *key,
+                               const unsigned char *bytes, size_t bytes_len,
+                               uint32_t flags,
+                               const unsigned char *sig, size_t sig_len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+
+    if (!key || !bytes || bytes_len != EC_MESSAGE_HASH_LEN ||
+        !is_valid_ec_type(flags) || flags & ~EC_FLAGS_TYPES ||
+        !sig || sig_len != EC_SIGNATURE_LEN)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    return sig_verify(ctx, &key->pub, bytes, flags, sig) ? WALLY_OK : WALLY_EINVAL;
+}
+
+/* Signatures verified by each task in a batch */
+#define VERIFY_BATCH_CHUNK 64
+
+/* The inputs and results for verifying a batch of signatures as tasks */
+struct sig_verify_tasks {
+    const secp256k1_context *ctx;
+    const unsigned char *pub_keys;
+    const unsigned char *bytes;
+    const unsigned char *sigs;
+    secp256k1_pubkey *pubs;
+    secp256k1_ecdsa_signature *sigs_secp;
+    size_t num_sigs;
+    unsigned char *results;
+};
+
+static void sig_verify_task(void *task_ctx, size_t index)
+{
+    struct sig_verify_tasks *t = task_ctx;
+    const size_t start = index * VERIFY_BATCH_CHUNK;
+    size_t i, end = start + VERIFY_BATCH_CHUNK;
+
+    if (end > t->num_sigs)
+        end = t->num_sigs;
+
+    for (i = start; i < end; ++i) {
+        secp256k1_pubkey *pub = t->pubs + i;
+        secp256k1_ecdsa_signature *sig = t->sigs_secp + i;
+
+        t->results[i] = pubkey_parse(t->ctx, pub, t->pub_keys + i * EC_PUBLIC_KEY_LEN,
+                                     EC_PUBLIC_KEY_LEN) &&
+                        secp256k1_ecdsa_signature_parse_compact(t->ctx, sig,
+                                                                t->sigs + i * EC_SIGNATURE_LEN) &&
+                        secp256k1_ecdsa_verify(t->ctx, sig,
+                                               t->bytes + i * EC_MESSAGE_HASH_LEN, pub);
+    }
+}
+
+int wally_ec_sig_verify_batch(const unsigned char *pub_keys, size_t pub_keys_len,
+                              const unsigned char *bytes, size_t bytes_len,
+                              uint32_t flags,
+                              const unsigned char *sigs, size_t sigs_len,
+                              wally_run_tasks_t run_fn, void *run_ctx,
+                              unsigned char *bytes_out, size_t len)
+{
+    struct sig_verify_tasks tasks;
+    const size_t num_tasks = (len + VERIFY_BATCH_CHUNK - 1) / VERIFY_BATCH_CHUNK;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!pub_keys || pub_keys_len / EC_PUBLIC_KEY_LEN != len ||
+        pub_keys_len % EC_PUBLIC_KEY_LEN ||
+        !bytes || bytes_len / EC_MESSAGE_HASH_LEN != len ||
+        bytes_len % EC_MESSAGE_HASH_LEN || flags != EC_FLAG_ECDSA ||
+        !sigs || sigs_len / EC_SIGNATURE_LEN != len || sigs_len % EC_SIGNATURE_LEN ||
+        !bytes_out || !len)
+        return WALLY_EINVAL;
+
+    /* Fetch the context once so every task uses the callers context */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    tasks.pub_keys = pub_keys;
+    tasks.bytes = bytes;
+    tasks.sigs = sigs;
+    tasks.num_sigs = len;
+    tasks.results = bytes_out;
+    tasks.pubs = wally_malloc(len * sizeof(secp256k1_pubkey));
+    tasks.sigs_secp = wally_malloc(len * sizeof(secp256k1_ecdsa_signature));
+    if (!tasks.pubs || !tasks.sigs_secp) {
+        wally_free(tasks.pubs);
+        wally_free(tasks.sigs_secp);
+        return WALLY_ENOMEM;
+    }
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, sig_verify_task, &tasks);
+
+    for (i = 0; i < len; ++i)
+        if (!bytes_out[i])
+            ret = WALLY_EINVAL;
+
+    wally_clear_2(tasks.pubs, len * sizeof(secp256k1_pubkey),
+                  tasks.sigs_secp, len * sizeof(secp256k1_ecdsa_signature));
+    wally_free(tasks.pubs);
+    wally_free(tasks.sigs_secp);
+    return ret;
+}
+
+/* Recover the public key from a recoverable signature */
+static bool sig_recover(const secp256k1_context *ctx, const unsigned char *bytes,
+                        const unsigned char *sig, secp256k1_pubkey *pub)
+{
+    secp256k1_ecdsa_recoverable_signature sig_secp;
+    bool ok;
+
+    /* Accept headers for both compressed and uncompressed keys */
+    ok = sig[0] >= 27 && sig[0] <= RECOVERABLE_HEADER_COMPRESSED + 3 &&
+         secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &sig_secp, sig + 1,
+                                                             (sig[0] - 27) & 3);
+    if (ok)
+        WALLY_STATS_TIMED(WALLY_STAT_EC_VERIFIES, WALLY_STAT_EC_VERIFY_NS, ok,
+                          secp256k1_ecdsa_recover(ctx, pub, &sig_secp, bytes) != 0);
+
+    wally_clear(&sig_secp, sizeof(sig_secp));
+    return ok;
+}
+
+int wally_ec_sig_to_public_key(const unsigned char *bytes, size_t bytes_len,
+                               const unsigned char *sig, size_t sig_len,
+                               unsigned char *bytes_out, size_t len)
+{
+    secp256k1_pubkey pub;
+    size_t len_in_out = EC_PUBLIC_KEY_LEN;
+    const secp256k1_context *ctx = secp_ctx();
+    bool ok;
+
+    if (!bytes || bytes_len != EC_MESSAGE_HASH_LEN ||
+        !sig || sig_len != EC_SIGNATURE_RECOVERABLE_LEN ||
+        !bytes_out || len != EC_PUBLIC_KEY_LEN)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    ok = sig_recover(ctx, bytes, sig, &pub) &&
+         pubkey_serialize(ctx, bytes_out, &len_in_out, &pub, PUBKEY_COMPRESSED) &&
+         len_in_out == EC_PUBLIC_KEY_LEN;
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear(&pub, sizeof(pub));
     return ok ? WALLY_OK : WALLY_EINVAL;
 }
 
+/* The inputs and results for recovering a batch of public keys as tasks */
+struct sig_to_public_key_tasks {
+    const secp256k1_context *ctx;
+    const unsigned char *bytes;
+    const unsigned char *sigs;
+    uint32_t flags;
+    size_t num_sigs;
+    size_t out_len;
+    unsigned char *bytes_out;
+    unsigned char *results;
+};
+
+static void sig_to_public_key_task(void *task_ctx, size_t index)
+{
+    struct sig_to_public_key_tasks *t = task_ctx;
+    const bool uncompressed = t->flags & EC_PUBLIC_KEY_FLAG_UNCOMPRESSED;
+    const size_t key_len = uncompressed ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+    const size_t start = index * VERIFY_BATCH_CHUNK;
+    unsigned char pub_key[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    secp256k1_pubkey pub;
+    size_t i, len_in_out, end = start + VERIFY_BATCH_CHUNK;
+
+    if (end > t->num_sigs)
+        end = t->num_sigs;
+
+    for (i = start; i < end; ++i) {
+        unsigned char *out = t->bytes_out + i * t->out_len;
+        /* Serialize directly into the output unless it is to be hashed */
+        unsigned char *dest = t->flags & EC_PUBLIC_KEY_FLAG_HASH160 ? pub_key : out;
+
+        len_in_out = key_len;
+        t->results[i] = sig_recover(t->ctx, t->bytes + i * EC_MESSAGE_HASH_LEN,
+                                    t->sigs + i * EC_SIGNATURE_RECOVERABLE_LEN, &pub) &&
+                        pubkey_serialize(t->ctx, dest, &len_in_out, &pub,
+                                         uncompressed ? PUBKEY_UNCOMPRESSED : PUBKEY_COMPRESSED) &&
+                        len_in_out == key_len;
+        if (t->results[i] && dest == pub_key)
+            t->results[i] = wally_hash160(pub_key, key_len, out, HASH160_LEN) == WALLY_OK;
+        if (!t->results[i])
+            wally_clear(out, t->out_len);
+    }
+    wally_clear_2(&pub, sizeof(pub), pub_key, sizeof(pub_key));
+}
+
+int wally_ec_sig_to_public_key_batch(const unsigned char *bytes, size_t bytes_len,
+                                     const unsigned char *sigs, size_t sigs_len,
+                                     uint32_t flags,
+                                     wally_run_tasks_t run_fn, void *run_ctx,
+                                     unsigned char *results_out, size_t results_out_len,
+                                     unsigned char *bytes_out, size_t len)
+{
+    struct sig_to_public_key_tasks tasks;
+    const size_t num_sigs = results_out_len;
+    const size_t num_tasks = (num_sigs + VERIFY_BATCH_CHUNK - 1) / VERIFY_BATCH_CHUNK;
+    size_t i;
+    int ret = WALLY_OK;
+
+    tasks.out_len = flags & EC_PUBLIC_KEY_FLAG_HASH160 ? HASH160_LEN :
+                    flags & EC_PUBLIC_KEY_FLAG_UNCOMPRESSED ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN :
+                    EC_PUBLIC_KEY_LEN;
+
+    if (!bytes || bytes_len / EC_MESSAGE_HASH_LEN != num_sigs ||
+        bytes_len % EC_MESSAGE_HASH_LEN ||
+        !sigs || sigs_len / EC_SIGNATURE_RECOVERABLE_LEN != num_sigs ||
+        sigs_len % EC_SIGNATURE_RECOVERABLE_LEN ||
+        flags & ~(EC_PUBLIC_KEY_FLAG_UNCOMPRESSED | EC_PUBLIC_KEY_FLAG_HASH160) ||
+        !results_out || !num_sigs || !bytes_out || len != num_sigs * tasks.out_len)
+        return WALLY_EINVAL;
+
+    /* Fetch the context once so every task uses the callers context */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+    if (!secp_ctx_has_tables(SECP256K1_FLAGS_BIT_CONTEXT_VERIFY))
+        return WALLY_ERROR;
+
+    tasks.bytes = bytes;
+    tasks.sigs = sigs;
+    tasks.flags = flags;
+    tasks.num_sigs = num_sigs;
+    tasks.bytes_out = bytes_out;
+    tasks.results = results_out;
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, sig_to_public_key_task, &tasks);
+
+    for (i = 0; i < num_sigs; ++i)
+        if (!results_out[i])
+            ret = WALLY_EINVAL;
+    return ret;
+}
+
 static inline size_t varint_len(size_t bytes_len) {
     return bytes_len < 0xfd ? 1u : 3u;
 }
@@ -261,9 +1378,9 @@ int wally_format_bitcoin_message(const unsigned char *bytes, size_t bytes_len,
                                  unsigned char *bytes_out, size_t len,
                                  size_t *written)
 {
-    unsigned char buf[256], *msg_buf = bytes_out, *out;
+    unsigned char buf[sizeof(MSG_PREFIX) - 1 + 3], *out;
     const bool do_hash = (flags & BITCOIN_MESSAGE_FLAG_HASH);
-    size_t msg_len;
+    size_t msg_len, header_len;
 
     if (written)
         *written = 0;
@@ -272,26 +1389,15 @@ int wally_format_bitcoin_message(const unsigned char *bytes, size_t bytes_len,
         (flags & ~MSG_ALL_FLAGS) || !bytes_out || !written)
         return WALLY_EINVAL;
 
-    msg_len = sizeof(MSG_PREFIX) - 1 + varint_len(bytes_len) + bytes_len;
+    header_len = sizeof(MSG_PREFIX) - 1 + varint_len(bytes_len);
+    msg_len = header_len + bytes_len;
     *written = do_hash ? SHA256_LEN : msg_len;
 
     if (len < *written)
         return WALLY_OK; /* Not enough output space, return required size */
 
-    if (do_hash) {
-        /* Ensure we have a suitable temporary buffer to serialize into */
-        msg_buf = buf;
-        if (msg_len > sizeof(buf)) {
-            msg_buf = wally_malloc(msg_len);
-            if (!msg_buf) {
-                *written = 0;
-                return WALLY_ENOMEM;
-            }
-        }
-    }
-
-    /* Serialize the message */
-    out = msg_buf;
+    /* Serialize the message header */
+    out = do_hash ? buf : bytes_out;
     memcpy(out, MSG_PREFIX, sizeof(MSG_PREFIX) - 1);
     out += sizeof(MSG_PREFIX) - 1;
     if (bytes_len < 0xfd)
@@ -301,13 +1407,154 @@ int wally_format_bitcoin_message(const unsigned char *bytes, size_t bytes_len,
         *out++ = bytes_len & 0xff;
         *out++ = bytes_len >> 8;
     }
-    memcpy(out, bytes, bytes_len);
 
     if (do_hash) {
-        wally_sha256d(msg_buf, msg_len, bytes_out, SHA256_LEN);
-        wally_clear(msg_buf, msg_len);
-        if (msg_buf != buf)
-            wally_free(msg_buf);
-    }
+        /* Hash the header and message without copying them together */
+        struct sha256_ctx ctx;
+        struct sha256 sha_1, sha_2;
+
+        sha256_init(&ctx);
+        sha256_update(&ctx, buf, header_len);
+        sha256_update(&ctx, bytes, bytes_len);
+        sha256_done(&ctx, &sha_1);
+        sha256(&sha_2, &sha_1, sizeof(sha_1));
+        memcpy(bytes_out, &sha_2, sizeof(sha_2));
+        wally_clear_4(buf, sizeof(buf), &ctx, sizeof(ctx),
+                      &sha_1, sizeof(sha_1), &sha_2, sizeof(sha_2));
+    } else
+        memcpy(out, bytes, bytes_len);
     return WALLY_OK;
 }
+
+int wally_format_bitcoin_message_batch(const unsigned char *const *messages,
+                                       const size_t *message_lens,
+                                       size_t num_messages,
+                                       uint32_t flags,
+                                       unsigned char *bytes_out, size_t len)
+{
+    size_t i, written;
+    int ret = WALLY_OK;
+
+    if (!messages || !message_lens || !num_messages ||
+        flags != BITCOIN_MESSAGE_FLAG_HASH ||
+        !bytes_out || len / SHA256_LEN != num_messages || len % SHA256_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_messages && ret == WALLY_OK; ++i)
+        ret = wally_format_bitcoin_message(messages[i], message_lens[i], flags,
+                                           bytes_out + i * SHA256_LEN, SHA256_LEN,
+                                           &written);
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    return ret;
+}
+
+static bool ecdh(const secp256k1_context *ctx, const secp256k1_pubkey *pub,
+                 const unsigned char *priv_key, unsigned char *bytes_out)
+{
+    WALLY_STATS_ADD(WALLY_STAT_EC_MULTS, 1);
+    return secp256k1_ecdh(ctx, bytes_out, pub, priv_key) != 0;
+}
+
+int wally_ecdh(const unsigned char *pub_key, size_t pub_key_len,
+               const unsigned char *priv_key, size_t priv_key_len,
+               unsigned char *bytes_out, size_t len)
+{
+    const secp256k1_context *ctx = secp_ctx();
+    secp256k1_pubkey pub;
+    bool ok;
+
+    if (!pub_key || pub_key_len != EC_PUBLIC_KEY_LEN ||
+        !priv_key || priv_key_len != EC_PRIVATE_KEY_LEN ||
+        !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    if (!ctx)
+        return WALLY_ENOMEM;
+
+    ok = pubkey_parse(ctx, &pub, pub_key, pub_key_len) &&
+         ecdh(ctx, &pub, priv_key, bytes_out);
+
+    if (!ok)
+        wally_clear(bytes_out, len);
+    wally_clear(&pub, sizeof(pub));
+    return ok ? WALLY_OK : WALLY_EINVAL;
+}
+
+/* The inputs and results for computing a batch of ECDH secrets as tasks */
+struct ecdh_tasks {
+    const secp256k1_context *ctx;
+    const unsigned char *pub_keys;
+    const unsigned char *priv_keys;
+    size_t priv_key_stride; /* 0 if one private key is used for every secret */
+    secp256k1_pubkey *pubs;
+    size_t num_secrets;
+    unsigned char *bytes_out;
+    unsigned char *results;
+};
+
+static void ecdh_task(void *task_ctx, size_t index)
+{
+    struct ecdh_tasks *t = task_ctx;
+    const size_t start = index * VERIFY_BATCH_CHUNK;
+    size_t i, end = start + VERIFY_BATCH_CHUNK;
+
+    if (end > t->num_secrets)
+        end = t->num_secrets;
+
+    for (i = start; i < end; ++i) {
+        unsigned char *out = t->bytes_out + i * SHA256_LEN;
+
+        t->results[i] = pubkey_parse(t->ctx, t->pubs + i,
+                                     t->pub_keys + i * EC_PUBLIC_KEY_LEN,
+                                     EC_PUBLIC_KEY_LEN) &&
+                        ecdh(t->ctx, t->pubs + i,
+                             t->priv_keys + i * t->priv_key_stride, out);
+        if (!t->results[i])
+            wally_clear(out, SHA256_LEN);
+    }
+}
+
+int wally_ecdh_batch(const unsigned char *pub_keys, size_t pub_keys_len,
+                     const unsigned char *priv_keys, size_t priv_keys_len,
+                     wally_run_tasks_t run_fn, void *run_ctx,
+                     unsigned char *results_out, size_t results_out_len,
+                     unsigned char *bytes_out, size_t len)
+{
+    struct ecdh_tasks tasks;
+    const size_t num_secrets = results_out_len;
+    const size_t num_tasks = (num_secrets + VERIFY_BATCH_CHUNK - 1) / VERIFY_BATCH_CHUNK;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!pub_keys || pub_keys_len / EC_PUBLIC_KEY_LEN != num_secrets ||
+        pub_keys_len % EC_PUBLIC_KEY_LEN || !priv_keys ||
+        (priv_keys_len != EC_PRIVATE_KEY_LEN &&
+         priv_keys_len != num_secrets * EC_PRIVATE_KEY_LEN) ||
+        !results_out || !num_secrets || !bytes_out || len != num_secrets * SHA256_LEN)
+        return WALLY_EINVAL;
+
+    /* Fetch the context once so every task uses the callers context */
+    if (!(tasks.ctx = secp_ctx()))
+        return WALLY_ENOMEM;
+
+    tasks.pub_keys = pub_keys;
+    tasks.priv_keys = priv_keys;
+    tasks.priv_key_stride = priv_keys_len == EC_PRIVATE_KEY_LEN ? 0 : EC_PRIVATE_KEY_LEN;
+    tasks.num_secrets = num_secrets;
+    tasks.bytes_out = bytes_out;
+    tasks.results = results_out;
+    if (!(tasks.pubs = wally_malloc(num_secrets * sizeof(secp256k1_pubkey))))
+        return WALLY_ENOMEM;
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, ecdh_task, &tasks);
+
+    for (i = 0; i < num_secrets; ++i)
+        if (!results_out[i])
+            ret = WALLY_EINVAL;
+
+    /* Release the parsed public keys */
+    wally_clear(tasks.pubs, num_secrets * sizeof(secp256k1_pubkey));
+    wally_free(tasks.pubs);
+    return ret;
+}
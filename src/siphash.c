@@ -0,0 +1,68 @@
+#include "internal.h"
+#include "siphash.h"
+#include <include/wally_crypto.h>
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3) do { \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+
+static uint64_t read_le64(const unsigned char *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 |
+           (uint64_t)p[3] << 24 | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+           (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+uint64_t siphash24_impl(uint64_t k0, uint64_t k1,
+                        const unsigned char *msg, size_t msg_len)
+{
+    uint64_t v0 = k0 ^ 0x736f6d6570736575ull;
+    uint64_t v1 = k1 ^ 0x646f72616e646f6dull;
+    uint64_t v2 = k0 ^ 0x6c7967656e657261ull;
+    uint64_t v3 = k1 ^ 0x7465646279746573ull;
+    uint64_t m, last = (uint64_t)msg_len << 56;
+    const size_t full_len = msg_len & ~(size_t)7;
+    size_t i;
+
+    for (i = 0; i < full_len; i += 8) {
+        m = read_le64(msg + i);
+        v3 ^= m;
+        SIPROUND(v0, v1, v2, v3);
+        SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    for (i = full_len; i < msg_len; ++i)
+        last |= (uint64_t)msg[i] << (8 * (i - full_len));
+    v3 ^= last;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+int wally_siphash24(const unsigned char *key, size_t key_len,
+                    const unsigned char *bytes, size_t bytes_len,
+                    uint64_t *value_out)
+{
+    if (value_out)
+        *value_out = 0;
+    if (!key || key_len != WALLY_SIPHASH_KEY_LEN ||
+        (!bytes && bytes_len) || !value_out)
+        return WALLY_EINVAL;
+
+    *value_out = siphash24_impl(read_le64(key), read_le64(key + 8),
+                                bytes, bytes_len);
+    return WALLY_OK;
+}
@@ -0,0 +1,18 @@
+#ifndef LIBWALLY_SIPHASH_H
+#define LIBWALLY_SIPHASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * siphash24 - Compute SipHash-2-4 of a message
+ *
+ * @k0: The first (little endian) 64 bits of the key.
+ * @k1: The second (little endian) 64 bits of the key.
+ * @msg: The message to hash
+ * @msg_len: The length of @msg in bytes.
+ */
+uint64_t siphash24_impl(uint64_t k0, uint64_t k1,
+                        const unsigned char *msg, size_t msg_len);
+
+#endif /* LIBWALLY_SIPHASH_H */
@@ -0,0 +1,94 @@
+package com.blockstream.test;
+
+import java.util.Arrays;
+
+import com.blockstream.libwally.Wally;
+import static com.blockstream.libwally.Wally.BIP32_FLAG_KEY_PUBLIC;
+import static com.blockstream.libwally.Wally.BIP32_VER_MAIN_PRIVATE;
+import static com.blockstream.libwally.Wally.EC_FLAG_ECDSA;
+
+/* Benchmarks of the per-call cost of the Java binding.
+ *
+ * Times the same operations with the same inputs as the "binding_"
+ * benchmarks of bench_wally, reported under the same names. Zero-copy
+ * and batch calls are not wrapped for Java.
+ */
+public class bench_bindings {
+
+    static final int NUM_SAMPLES = 10;
+
+    final byte[] mBytes = filled(32, 0x02);
+    final byte[] mPrivKey = filled(32, 0x01);
+    final Object mMaster = Wally.bip32_key_from_seed(filled(32, 0x03),
+                                                     BIP32_VER_MAIN_PRIVATE, 0);
+
+    abstract static class Bench {
+        final String mName;
+        final int mIterations;
+        Bench(final String name, final int iterations) {
+            mName = name;
+            mIterations = iterations;
+        }
+        abstract void run();
+    }
+
+    private static byte[] filled(final int len, final int value) {
+        final byte[] ret = new byte[len];
+        Arrays.fill(ret, (byte) value);
+        return ret;
+    }
+
+    /* Print the median and 99th percentile time per call over the samples */
+    private static void runBench(final Bench b) {
+        final int n = Math.min(b.mIterations, NUM_SAMPLES);
+        final int perSample = (b.mIterations + n - 1) / n;
+        final double[] samples = new double[n];
+
+        for (int i = 0; i < b.mIterations / 10 + 1; ++i)
+            b.run(); // Warm up, including JIT compilation
+        for (int i = 0; i < n; ++i) {
+            final long start = System.nanoTime();
+            for (int j = 0; j < perSample; ++j)
+                b.run();
+            samples[i] = (double) (System.nanoTime() - start) / perSample;
+        }
+        Arrays.sort(samples);
+        final double median = n % 2 != 0 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+        final double p99 = samples[(n * 99 + 99) / 100 - 1];
+        System.out.println(String.format("%-32s %14.1f ns/op %14.1f ops/sec %14.1f ns p99",
+                                         b.mName, median, 1e9 / median, p99));
+    }
+
+    public void run(final String[] prefixes) {
+        final Bench[] benchmarks = {
+            new Bench("binding_sha256_32", 200000) {
+                void run() { Wally.sha256(mBytes); }
+            },
+            new Bench("binding_hex_from_bytes_32", 200000) {
+                void run() { Wally.hex_from_bytes(mBytes); }
+            },
+            new Bench("binding_ec_sig_from_bytes", 20000) {
+                void run() { Wally.ec_sig_from_bytes(mPrivKey, mBytes, EC_FLAG_ECDSA); }
+            },
+            new Bench("binding_bip32_derive_pub", 20000) {
+                void run() {
+                    Wally.bip32_key_free(Wally.bip32_key_from_parent(mMaster, 1,
+                                                                     BIP32_FLAG_KEY_PUBLIC));
+                }
+            },
+        };
+        for (final Bench b : benchmarks) {
+            boolean selected = prefixes.length == 0;
+            for (final String prefix : prefixes)
+                selected |= b.mName.startsWith(prefix);
+            if (selected)
+                runBench(b);
+        }
+    }
+
+    public static void main(final String[] args) {
+        final bench_bindings b = new bench_bindings();
+        b.run(args);
+        Wally.bip32_key_free(b.mMaster);
+    }
+}
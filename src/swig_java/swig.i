@@ -216,6 +216,7 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *abf, size_t abf_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *asset, size_t asset_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *bytes, size_t bytes_len) };
+%apply(char *STRING, size_t LENGTH) { (const unsigned char *branch, size_t branch_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *chain_code, size_t chain_code_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *commitment, size_t commitment_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *extra, size_t extra_len) };
@@ -223,16 +224,20 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *hash160, size_t hash160_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *iv, size_t iv_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *key, size_t key_len) };
+%apply(char *STRING, size_t LENGTH) { (const unsigned char *mask, size_t mask_len) };
+%apply(char *STRING, size_t LENGTH) { (const unsigned char *merkle_root, size_t merkle_root_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *output_abf, size_t output_abf_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *output_asset, size_t output_asset_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *output_generator, size_t output_generator_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *pass, size_t pass_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *parent160, size_t parent160_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *priv_key, size_t priv_key_len) };
+%apply(char *STRING, size_t LENGTH) { (const unsigned char *priv_keys, size_t priv_keys_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *proof, size_t proof_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *pub_key, size_t pub_key_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *salt, size_t salt_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *script, size_t script_len) };
+%apply(char *STRING, size_t LENGTH) { (const unsigned char *scripts, size_t scripts_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *sig, size_t sig_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *sighash, size_t sighash_len) };
 %apply(char *STRING, size_t LENGTH) { (const unsigned char *txhash, size_t txhash) };
@@ -246,6 +251,8 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %apply(char *STRING, size_t LENGTH) { (unsigned char *vbf_out, size_t vbf_out_len) };
 
 %apply(uint32_t *STRING, size_t LENGTH) { (const uint32_t *child_path, size_t child_path_len) }
+%apply(uint32_t *STRING, size_t LENGTH) { (const uint32_t *indices, size_t indices_len) }
+%apply(uint32_t *STRING, size_t LENGTH) { (const uint32_t *lens, size_t lens_len) }
 %apply(uint32_t *STRING, size_t LENGTH) { (const uint32_t *sighash, size_t sighash_len) }
 %apply(uint64_t *STRING, size_t LENGTH) { (const uint64_t *values, size_t values_len) }
 
@@ -332,6 +339,9 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %java_opaque_struct(wally_tx_input, 4);
 %java_opaque_struct(wally_tx_output, 5);
 %java_opaque_struct(wally_tx, 6);
+%java_opaque_struct(wally_tx_sighash_ctx, 7);
+%java_opaque_struct(wally_script_watchset, 8);
+%java_opaque_struct(wally_tx_set, 9);
 
 /* Our wrapped functions return types */
 %returns_void__(bip32_key_free);
@@ -369,6 +379,7 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %returns_string(bip39_mnemonic_from_bytes);
 %returns_size_t(bip39_mnemonic_to_bytes);
 %returns_void__(bip39_mnemonic_validate);
+%returns_size_t(bip39_mnemonic_detect_languages);
 %returns_size_t(bip39_mnemonic_to_seed);
 %returns_string(wally_addr_segwit_from_bytes);
 %returns_size_t(wally_addr_segwit_to_bytes);
@@ -384,24 +395,43 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %returns_string(wally_base58_from_bytes);
 %returns_size_t(wally_base58_to_bytes);
 %returns_size_t(wally_base58_get_length);
+%returns_string(wally_base64_from_bytes);
+%returns_size_t(wally_base64_to_bytes);
+%returns_size_t(wally_base64_get_maximum_length);
+%returns_array_(wally_block_get_hash, 3, 4, SHA256_LEN);
 %returns_void__(wally_ec_private_key_verify);
+%returns_array_(wally_ec_private_key_tweak_add, 5, 6, EC_PRIVATE_KEY_LEN);
 %returns_array_(wally_ec_public_key_decompress, 3, 4, EC_PUBLIC_KEY_UNCOMPRESSED_LEN);
+%returns_array_(wally_ec_public_key_tweak_add, 5, 6, EC_PUBLIC_KEY_LEN);
 %returns_array_(wally_ec_public_key_from_private_key, 3, 4, EC_PUBLIC_KEY_LEN);
 %returns_array_(wally_ec_sig_from_bytes, 6, 7, EC_SIGNATURE_LEN);
 %returns_array_(wally_ec_sig_normalize, 3, 4, EC_SIGNATURE_LEN);
 %returns_array_(wally_ec_sig_from_der, 3, 4, EC_SIGNATURE_LEN);
+%returns_array_(wally_ec_sig_to_public_key, 5, 6, EC_PUBLIC_KEY_LEN);
+%returns_size_t(wally_ec_sig_from_bytes_batch);
+%returns_array_(wally_ecdh, 5, 6, SHA256_LEN);
 %returns_size_t(wally_ec_sig_to_der);
 %returns_void__(wally_ec_sig_verify);
 %returns_size_t(wally_format_bitcoin_message);
+%returns_uint64(wally_get_cpu_features);
+%returns_uint64(wally_get_init_duration);
 %returns_array_(wally_hash160, 3, 4, HASH160_LEN);
 %returns_string(wally_hex_from_bytes);
 %returns_size_t(wally_hex_to_bytes);
+%returns_size_t(wally_merkle_branch);
+%returns_void__(wally_merkle_branch_verify);
+%returns_array_(wally_merkle_root, 3, 4, SHA256_LEN);
 %returns_array_(wally_hmac_sha256, 5, 6, HMAC_SHA256_LEN);
 %returns_array_(wally_hmac_sha512, 5, 6, HMAC_SHA512_LEN);
 %returns_void__(wally_init);
 %returns_array_(wally_pbkdf2_hmac_sha256, 7, 8, PBKDF2_HMAC_SHA256_LEN);
 %returns_array_(wally_pbkdf2_hmac_sha512, 7, 8, PBKDF2_HMAC_SHA512_LEN);
 %returns_size_t(wally_script_push_from_bytes);
+%returns_void__(wally_script_watchset_add);
+%returns_void__(wally_script_watchset_add_scripts);
+%returns_size_t(wally_script_watchset_contains);
+%returns_void__(wally_script_watchset_free);
+%returns_struct(wally_script_watchset_init_alloc, wally_script_watchset);
 %returns_size_t(wally_scriptpubkey_csv_2of2_then_1_from_bytes);
 %returns_size_t(wally_scriptpubkey_csv_2of3_then_2_from_bytes);
 %returns_size_t(wally_scriptpubkey_get_type);
@@ -412,6 +442,7 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %returns_size_t(wally_scriptsig_p2pkh_from_sig);
 %returns_size_t(wally_scriptsig_p2pkh_from_der);
 %returns_size_t(wally_scriptsig_multisig_from_bytes);
+%returns_size_t(wally_scriptsig_multisig_from_der);
 %returns_void__(wally_scrypt);
 %returns_void__(wally_secp_randomize);
 %returns_array_(wally_sha256, 3, 4, SHA256_LEN);
@@ -422,29 +453,58 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %returns_void__(wally_tx_add_output);
 %returns_void__(wally_tx_add_raw_output);
 %returns_void__(wally_tx_free);
+%returns_struct(wally_tx_clone, wally_tx);
 %returns_struct(wally_tx_from_bytes, wally_tx);
+%returns_struct(wally_tx_from_compact_bytes, wally_tx);
 %returns_struct(wally_tx_from_hex, wally_tx);
 %returns_array_(wally_tx_get_btc_signature_hash, 8, 9, SHA256_LEN);
+%returns_array_(wally_tx_get_btc_signature_hash_ctx, 9, 10, SHA256_LEN);
+%returns_size_t(wally_tx_get_compact_length);
 %returns_size_t(wally_tx_get_length);
+%returns_size_t(wally_tx_get_output_script_types);
+%returns_size_t(wally_tx_get_output_script_types_from_bytes);
+%returns_array_(wally_tx_get_txid_from_bytes, 4, 5, WALLY_TXHASH_LEN);
 %returns_array_(wally_tx_get_signature_hash, 12, 13, SHA256_LEN);
+%returns_void__(wally_tx_get_signature_hashes);
+%returns_void__(wally_tx_sign_inputs);
+%returns_void__(wally_tx_verify_input_signatures);
 %returns_size_t(wally_tx_get_vsize);
 %returns_size_t(wally_tx_get_weight);
+%returns_size_t(wally_tx_get_weight_estimate);
 %returns_size_t(wally_tx_get_witness_count);
+%returns_array_(wally_tx_get_wtxid_from_bytes, 4, 5, WALLY_TXHASH_LEN);
 %returns_struct(wally_tx_init_alloc, wally_tx);
 %returns_void__(wally_tx_input_free);
+%returns_size_t(wally_tx_input_get_weight_estimate);
 %returns_struct(wally_tx_input_init_alloc, wally_tx_input);
 %returns_void__(wally_tx_output_free);
 %returns_struct(wally_tx_output_init_alloc, wally_tx_output);
 %returns_void__(wally_tx_remove_input);
 %returns_void__(wally_tx_remove_output);
+%returns_void__(wally_tx_remove_inputs);
+%returns_void__(wally_tx_retain_outputs);
+%returns_void__(wally_tx_reserve);
+%returns_void__(wally_tx_sighash_ctx_free);
+%returns_struct(wally_tx_sighash_ctx_init_alloc, wally_tx_sighash_ctx);
 %returns_void__(wally_tx_set_input_script);
 %returns_void__(wally_tx_set_input_witness);
+%returns_void__(wally_tx_set_add);
+%returns_size_t(wally_tx_set_contains);
+%returns_void__(wally_tx_set_free);
+%returns_size_t(wally_tx_set_get_ancestors);
+%returns_size_t(wally_tx_set_get_conflicts);
+%returns_size_t(wally_tx_set_get_num_txs);
+%returns_size_t(wally_tx_set_get_spender);
+%returns_struct(wally_tx_set_init_alloc, wally_tx_set);
+%returns_void__(wally_tx_set_remove);
 %returns_size_t(wally_tx_to_bytes);
+%returns_size_t(wally_tx_to_compact_bytes);
 %returns_string(wally_tx_to_hex);
 %returns_size_t(wally_tx_vsize_from_weight);
 %returns_void__(wally_tx_witness_stack_add);
 %returns_void__(wally_tx_witness_stack_add_dummy);
 %returns_void__(wally_tx_witness_stack_free);
+%returns_void__(wally_tx_witness_stack_reserve);
 %returns_struct(wally_tx_witness_stack_init_alloc, wally_tx_witness_stack);
 %returns_void__(wally_tx_witness_stack_set);
 %returns_void__(wally_tx_witness_stack_set_dummy);
@@ -454,6 +514,7 @@ static jbyteArray create_array(JNIEnv *jenv, const unsigned char* p, size_t len)
 %returns_size_t(wally_wif_to_public_key);
 %returns_string(wally_wif_to_address);
 %returns_size_t(wally_witness_program_from_bytes);
+%returns_size_t(wally_witness_p2wpkh_from_sig);
 %returns_size_t(wally_tx_is_elements);
 %returns_size_t(wally_tx_is_coinbase);
 
@@ -67,6 +67,9 @@ capsule_dtor(wally_tx, wally_tx_free)
 capsule_dtor(wally_tx_input, wally_tx_input_free)
 capsule_dtor(wally_tx_output, wally_tx_output_free)
 capsule_dtor(wally_tx_witness_stack, wally_tx_witness_stack_free)
+capsule_dtor(wally_tx_sighash_ctx, wally_tx_sighash_ctx_free)
+capsule_dtor(wally_script_watchset, wally_script_watchset_free)
+capsule_dtor(wally_tx_set, wally_tx_set_free)
 static void destroy_words(PyObject *obj) { (void)obj; }
 
 #define MAX_LOCAL_STACK 256u
@@ -109,6 +112,7 @@ static void destroy_words(PyObject *obj) { (void)obj; }
 %pybuffer_binary(const unsigned char *abf, size_t abf_len);
 %pybuffer_binary(const unsigned char *asset, size_t asset_len);
 %pybuffer_nullable_binary(const unsigned char *bytes, size_t bytes_len);
+%pybuffer_nullable_binary(const unsigned char *branch, size_t branch_len);
 %pybuffer_binary(const unsigned char *chain_code, size_t chain_code_len);
 %pybuffer_binary(const unsigned char *commitment, size_t commitment_len);
 %pybuffer_nullable_binary(const unsigned char *extra, size_t extra_len);
@@ -116,16 +120,20 @@ static void destroy_words(PyObject *obj) { (void)obj; }
 %pybuffer_nullable_binary(const unsigned char *hash160, size_t hash160_len);
 %pybuffer_binary(const unsigned char *iv, size_t iv_len);
 %pybuffer_binary(const unsigned char *key, size_t key_len);
+%pybuffer_binary(const unsigned char *mask, size_t mask_len);
+%pybuffer_binary(const unsigned char *merkle_root, size_t merkle_root_len);
 %pybuffer_binary(const unsigned char *output_abf, size_t output_abf_len);
 %pybuffer_binary(const unsigned char *output_asset, size_t output_asset_len);
 %pybuffer_binary(const unsigned char *output_generator, size_t output_generator_len);
 %pybuffer_binary(const unsigned char *pass, size_t pass_len);
 %pybuffer_nullable_binary(const unsigned char *parent160, size_t parent160_len);
 %pybuffer_nullable_binary(const unsigned char *priv_key, size_t priv_key_len);
+%pybuffer_binary(const unsigned char *priv_keys, size_t priv_keys_len);
 %pybuffer_binary(const unsigned char *proof, size_t proof_len);
 %pybuffer_nullable_binary(const unsigned char *pub_key, size_t pub_key_len);
 %pybuffer_binary(const unsigned char *salt, size_t salt_len);
 %pybuffer_nullable_binary(const unsigned char *script, size_t script_len);
+%pybuffer_binary(const unsigned char *scripts, size_t scripts_len);
 %pybuffer_binary(const unsigned char *sig, size_t sig_len);
 %pybuffer_binary(const unsigned char *sighash, size_t sighash_len);
 %pybuffer_binary(const unsigned char *txhash, size_t txhash_len);
@@ -231,6 +239,8 @@ static void destroy_words(PyObject *obj) { (void)obj; }
 }
 %enddef
 %py_int_array(uint32_t, 0xffffffffull, child_path, child_path_len)
+%py_int_array(uint32_t, 0xffffffffull, indices, indices_len)
+%py_int_array(uint32_t, 0xffffffffull, lens, lens_len)
 %py_int_array(uint32_t, 0xffull, sighash, sighash_len)
 %py_int_array(uint64_t, 0xffffffffffffffffull, values, values_len)
 
@@ -240,6 +250,9 @@ static void destroy_words(PyObject *obj) { (void)obj; }
 %py_opaque_struct(wally_tx_input);
 %py_opaque_struct(wally_tx_output);
 %py_opaque_struct(wally_tx);
+%py_opaque_struct(wally_tx_sighash_ctx);
+%py_opaque_struct(wally_script_watchset);
+%py_opaque_struct(wally_tx_set);
 
 /* Tell SWIG what uint32_t/uint64_t mean */
 typedef unsigned int uint32_t;
@@ -259,6 +272,9 @@ typedef unsigned long uint64_t;
 %rename("tx_input_init") wally_tx_input_init_alloc;
 %rename("tx_output_init") wally_tx_output_init_alloc;
 %rename("tx_init") wally_tx_init_alloc;
+%rename("tx_sighash_ctx_init") wally_tx_sighash_ctx_init_alloc;
+%rename("script_watchset_init") wally_script_watchset_init_alloc;
+%rename("tx_set_init") wally_tx_set_init_alloc;
 %rename("tx_elements_input_init") wally_tx_elements_input_init_alloc;
 %rename("tx_elements_output_init") wally_tx_elements_output_init_alloc;
 %rename("%(regex:/^wally_(.+)/\\1/)s", %$isfunction) "";
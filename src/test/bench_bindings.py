@@ -0,0 +1,123 @@
+"""Benchmarks of the per-call cost of the Python (ctypes) binding.
+
+Times the same operations with the same inputs as the "binding_" benchmarks
+of bench_wally, reported under the same names. Usage, from src/:
+
+    python3 test/bench_bindings.py [--samples=N] [name_prefix ...]
+
+Results ending in "_zero_copy" reuse the caller's buffers rather than
+allocating results for each call, and "_16" results are for one call on a
+batch of 16 items.
+"""
+import sys
+import time
+from util import *
+
+BATCH_LEN = 16
+DEFAULT_SAMPLES = 10
+
+BYTES = b'\x02' * 32
+PRIV_KEY = b'\x01' * 32
+PRIV_KEYS = PRIV_KEY * BATCH_LEN
+HASHES = BYTES * BATCH_LEN
+SEED = b'\x03' * 32
+FLAG_ECDSA, FLAG_KEY_PUBLIC = 0x1, 0x1
+EC_SIGNATURE_LEN = 64
+
+
+def check(ret):
+    if ret != WALLY_OK:
+        raise RuntimeError('wally call failed: %d' % ret)
+
+
+def bench_sha256(n):
+    for i in range(n):
+        out = create_string_buffer(32)
+        check(wally_sha256(BYTES, 32, out, 32))
+        out.raw
+
+
+def bench_sha256_zero_copy(n, out=create_string_buffer(32)):
+    for i in range(n):
+        check(wally_sha256(BYTES, 32, out, 32))
+
+
+def bench_hex_from_bytes(n):
+    for i in range(n):
+        ret, _ = wally_hex_from_bytes(BYTES, 32)
+        check(ret)
+
+
+def bench_sig(n):
+    for i in range(n):
+        out = create_string_buffer(EC_SIGNATURE_LEN)
+        check(wally_ec_sig_from_bytes(PRIV_KEY, 32, BYTES, 32, FLAG_ECDSA,
+                                      out, EC_SIGNATURE_LEN))
+        out.raw
+
+
+def bench_sig_batch(n, out=create_string_buffer(EC_SIGNATURE_LEN * BATCH_LEN)):
+    for i in range(n):
+        ret, _ = wally_ec_sig_from_bytes_batch(PRIV_KEYS, len(PRIV_KEYS),
+                                               HASHES, len(HASHES), FLAG_ECDSA,
+                                               out, len(out))
+        check(ret)
+
+
+def bench_derive(n, master=ext_key()):
+    check(bip32_key_from_seed(SEED, len(SEED), 0x0488ADE4, 0, byref(master)))
+    for i in range(n):
+        child = ext_key()
+        check(bip32_key_from_parent(byref(master), 1, FLAG_KEY_PUBLIC, byref(child)))
+
+
+def bench_derive_range(n, master=ext_key(), keys=(ext_key * BATCH_LEN)()):
+    check(bip32_key_from_seed(SEED, len(SEED), 0x0488ADE4, 0, byref(master)))
+    for i in range(n):
+        check(bip32_key_from_parent_range(byref(master), 1, FLAG_KEY_PUBLIC,
+                                          keys, BATCH_LEN))
+
+
+BENCHMARKS = [
+    ('binding_sha256_32', bench_sha256, 200000),
+    ('binding_sha256_32_zero_copy', bench_sha256_zero_copy, 200000),
+    ('binding_hex_from_bytes_32', bench_hex_from_bytes, 200000),
+    ('binding_ec_sig_from_bytes', bench_sig, 20000),
+    ('binding_ec_sig_from_bytes_batch_16', bench_sig_batch, 1000),
+    ('binding_bip32_derive_pub', bench_derive, 20000),
+    ('binding_bip32_derive_pub_range_16', bench_derive_range, 1000),
+]
+
+
+def run_bench(name, fn, iterations, num_samples):
+    """Print the median and 99th percentile time per call over the samples"""
+    n = min(iterations, num_samples)
+    per_sample = (iterations + n - 1) // n
+    fn(iterations // 10 + 1) # Warm up
+    samples = []
+    for i in range(n):
+        start = time.perf_counter()
+        fn(per_sample)
+        samples.append((time.perf_counter() - start) * 1e9 / per_sample)
+    samples.sort()
+    median = samples[n // 2] if n % 2 else (samples[n // 2 - 1] + samples[n // 2]) / 2
+    p99 = samples[(n * 99 + 99) // 100 - 1]
+    print('%-32s %14.1f ns/op %14.1f ops/sec %14.1f ns p99' %
+          (name, median, 1e9 / median, p99))
+    sys.stdout.flush()
+
+
+def main(args):
+    num_samples, prefixes = DEFAULT_SAMPLES, []
+    for arg in args:
+        if arg.startswith('--samples='):
+            num_samples = int(arg[len('--samples='):])
+        else:
+            prefixes.append(arg)
+    for name, fn, iterations in BENCHMARKS:
+        if not prefixes or any([name.startswith(p) for p in prefixes]):
+            run_bench(name, fn, iterations, num_samples)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
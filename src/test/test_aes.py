@@ -55,8 +55,7 @@ class AESTests(unittest.TestCase):
 
     ENCRYPT, DECRYPT = 1, 2
 
-    def test_aes(self):
-
+    def _do_test_aes(self):
         for c in cases:
             key, plain, cypher = [make_cbuffer(s)[0] for s in c[1:]]
             key_bytes = { 128: 16, 192: 24, 256: 32}[c[0]]
@@ -70,6 +69,9 @@ class AESTests(unittest.TestCase):
                 self.assertEqual(ret, 0)
                 self.assertEqual(h(out_buf), h(o))
 
+    def test_aes(self):
+        for _ in optimized_runs():
+            self._do_test_aes()
 
     def get_cbc_cases(self):
         lines = []
@@ -79,7 +81,7 @@ class AESTests(unittest.TestCase):
                     lines.append(l.strip().split('=')[1])
         return [lines[x:x+4] for x in range(0, len(lines), 4)]
 
-    def test_aes_cbc(self):
+    def _do_test_aes_cbc(self):
         for c in self.get_cbc_cases():
             plain, key, iv, cypher = [make_cbuffer(s)[0] for s in c]
 
@@ -92,6 +94,172 @@ class AESTests(unittest.TestCase):
                 self.assertEqual((ret, written), (0, len(o)))
                 self.assertEqual(h(out_buf), h(o))
 
+    def test_aes_cbc(self):
+        for _ in optimized_runs():
+            self._do_test_aes_cbc()
+
+    def _aes(self, key, data, flags):
+        out_buf, out_len = make_cbuffer('00' * len(data))
+        ret = wally_aes(key, len(key), data, len(data), flags, out_buf, out_len)
+        self.assertEqual(ret, 0)
+        return out_buf
+
+    def _do_test_aes_blocks(self):
+        """Test multi-block ECB and CBC against single block encryption"""
+        xor = lambda a, b: bytes([x ^ y for x, y in zip(a, b)])
+        for key_len in [16, 24, 32]:
+            key = bytes(range(7, 7 + key_len))
+            iv = bytes(range(100, 116))
+            for num_blocks in range(1, 22):
+                plain = bytes([(i * 13) & 0xff for i in range(num_blocks * 16)])
+                blocks = [plain[i:i + 16] for i in range(0, len(plain), 16)]
+
+                # ECB: Encrypting many blocks matches encrypting each block
+                cypher = self._aes(key, plain, self.ENCRYPT)
+                expected = b''.join([self._aes(key, b, self.ENCRYPT) for b in blocks])
+                self.assertEqual(cypher, expected)
+                self.assertEqual(self._aes(key, cypher, self.DECRYPT), plain)
+
+                # CBC: Matches chaining single blocks, with PKCS7 padding
+                expected, prev = [], iv
+                for b in blocks + [b'\x10' * 16]:
+                    prev = self._aes(key, xor(b, prev), self.ENCRYPT)
+                    expected.append(prev)
+                expected = b''.join(expected)
+                out_buf, out_len = make_cbuffer('00' * len(expected))
+                ret, written = wally_aes_cbc(key, len(key), iv, len(iv), plain, len(plain),
+                                             self.ENCRYPT, out_buf, out_len)
+                self.assertEqual((ret, written, out_buf), (0, len(expected), expected))
+                out_buf, out_len = make_cbuffer('00' * len(expected))
+                ret, written = wally_aes_cbc(key, len(key), iv, len(iv), expected, len(expected),
+                                             self.DECRYPT, out_buf, out_len)
+                self.assertEqual((ret, written, out_buf[:written]), (0, len(plain), plain))
+
+    def test_aes_blocks(self):
+        for _ in optimized_runs():
+            self._do_test_aes_blocks()
+
+    def _do_test_ctx(self):
+        from ctypes import c_void_p, byref
+        for c in cases:
+            key, plain, cypher = [make_cbuffer(s)[0] for s in c[1:]]
+            ctx = c_void_p()
+            self.assertEqual(wally_aes_ctx_init_alloc(key, len(key), byref(ctx)), WALLY_OK)
+            # The context can be used for both encryption and decryption
+            for i in range(2):
+                for p, f, o in [(plain,  self.ENCRYPT, cypher),
+                                (cypher, self.DECRYPT, plain)]:
+                    out_buf, out_len = make_cbuffer('00' * len(o))
+                    ret = wally_aes_ctx_compute(ctx, p, len(p), f, out_buf, out_len)
+                    self.assertEqual((ret, h(out_buf)), (WALLY_OK, h(o)))
+            out_buf, out_len = make_cbuffer('00' * len(plain))
+            for args in [(None, plain,  len(plain), self.ENCRYPT),     # Null ctx
+                         (ctx,  None,   len(plain), self.ENCRYPT),     # Null bytes
+                         (ctx,  plain,  0,          self.ENCRYPT),     # Empty bytes
+                         (ctx,  plain,  len(plain), self.ENCRYPT | self.DECRYPT)]: # Both
+                ret = wally_aes_ctx_compute(args[0], args[1], args[2], args[3], out_buf, out_len)
+                self.assertEqual(ret, WALLY_EINVAL)
+            self.assertEqual(wally_aes_ctx_free(ctx), WALLY_OK)
+
+        for c in self.get_cbc_cases():
+            plain, key, iv, cypher = [make_cbuffer(s)[0] for s in c]
+            ctx = c_void_p()
+            self.assertEqual(wally_aes_ctx_init_alloc(key, len(key), byref(ctx)), WALLY_OK)
+            for p, f, o in [(plain,  self.ENCRYPT, cypher),
+                            (cypher, self.DECRYPT, plain)]:
+                out_buf, out_len = make_cbuffer('00' * len(o))
+                ret, written = wally_aes_cbc_ctx_compute(ctx, iv, len(iv), p, len(p), f,
+                                                         out_buf, out_len)
+                self.assertEqual((ret, written), (0, len(o)))
+                self.assertEqual(h(out_buf), h(o))
+            ret, written = wally_aes_cbc_ctx_compute(None, iv, len(iv), plain, len(plain),
+                                                     self.ENCRYPT, out_buf, out_len)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+            self.assertEqual(wally_aes_ctx_free(ctx), WALLY_OK)
+
+        key, key_len = make_cbuffer('00' * 32)
+        for args in [(None, key_len, byref(ctx)),   # Null key
+                     (key,  15,      byref(ctx)),   # Bad key length
+                     (key,  key_len, None)]:        # Null output
+            self.assertEqual(wally_aes_ctx_init_alloc(*args), WALLY_EINVAL)
+        self.assertEqual(wally_aes_ctx_free(None), WALLY_EINVAL)
+
+    def test_ctx(self):
+        for _ in optimized_runs():
+            self._do_test_ctx()
+
+    def _stream(self, key, iv, data, flags, chunk_lens):
+        from ctypes import c_void_p, byref
+        stream = c_void_p()
+        ret = wally_aes_cbc_stream_init_alloc(key, len(key), iv, len(iv), flags, byref(stream))
+        self.assertEqual(ret, WALLY_OK)
+        result, pos, i = b'', 0, 0
+        while pos < len(data):
+            chunk = data[pos:pos + chunk_lens[i % len(chunk_lens)]]
+            pos, i = pos + len(chunk), i + 1
+            out_buf, out_len = make_cbuffer('00' * (len(chunk) + 16))
+            ret, written = wally_aes_cbc_stream_update(stream, chunk, len(chunk),
+                                                       out_buf, out_len)
+            self.assertEqual(ret, WALLY_OK)
+            result += out_buf[:written]
+        out_buf, out_len = make_cbuffer('00' * 16)
+        ret, written = wally_aes_cbc_stream_final(stream, out_buf, out_len)
+        self.assertEqual(ret, WALLY_OK)
+        # A finished stream cannot be used again
+        self.assertEqual(wally_aes_cbc_stream_final(stream, out_buf, out_len)[0], WALLY_EINVAL)
+        self.assertEqual(wally_aes_cbc_stream_update(stream, data, len(data),
+                                                     out_buf, out_len)[0], WALLY_EINVAL)
+        self.assertEqual(wally_aes_cbc_stream_free(stream), WALLY_OK)
+        return result + out_buf[:written]
+
+    def _do_test_stream(self):
+        for c in self.get_cbc_cases():
+            plain, key, iv, cypher = [make_cbuffer(s)[0] for s in c]
+            for chunk_lens in [[1], [5, 11], [16], [17, 3], [1024]]:
+                self.assertEqual(self._stream(key, iv, plain, self.ENCRYPT, chunk_lens), cypher)
+                self.assertEqual(self._stream(key, iv, cypher, self.DECRYPT, chunk_lens), plain)
+
+        key, iv = bytes(range(32)), bytes(range(16))
+        plain = bytes([(i * 7) & 0xff for i in range(5000)])
+        out_buf, out_len = make_cbuffer('00' * 5008)
+        ret, written = wally_aes_cbc(key, len(key), iv, len(iv), plain, len(plain),
+                                     self.ENCRYPT, out_buf, out_len)
+        cypher = out_buf[:written]
+        for chunk_lens in [[1, 100, 31], [16, 32], [4999]]:
+            self.assertEqual(self._stream(key, iv, plain, self.ENCRYPT, chunk_lens), cypher)
+            self.assertEqual(self._stream(key, iv, cypher, self.DECRYPT, chunk_lens), plain)
+
+    def test_stream(self):
+        from ctypes import c_void_p, byref
+        for _ in optimized_runs():
+            self._do_test_stream()
+
+        key, iv = bytes(range(32)), bytes(range(16))
+        stream = c_void_p()
+        for args in [(None, 32, iv,   16, self.ENCRYPT, byref(stream)), # Null key
+                     (key,  31, iv,   16, self.ENCRYPT, byref(stream)), # Bad key length
+                     (key,  32, None, 16, self.ENCRYPT, byref(stream)), # Null IV
+                     (key,  32, iv,   15, self.ENCRYPT, byref(stream)), # Bad IV length
+                     (key,  32, iv,   16, 0,            byref(stream)), # No operation
+                     (key,  32, iv,   16, 3,            byref(stream)), # Both operations
+                     (key,  32, iv,   16, self.ENCRYPT, None)]:         # Null output
+            self.assertEqual(wally_aes_cbc_stream_init_alloc(*args), WALLY_EINVAL)
+
+        # Too small an output buffer returns the required length and consumes nothing
+        ret = wally_aes_cbc_stream_init_alloc(key, 32, iv, 16, self.DECRYPT, byref(stream))
+        self.assertEqual(ret, WALLY_OK)
+        out_buf, out_len = make_cbuffer('00' * 48)
+        self.assertEqual(wally_aes_cbc_stream_update(stream, key, 32, out_buf, 15), (WALLY_OK, 16))
+        self.assertEqual(wally_aes_cbc_stream_update(stream, key, 32, None, 16), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_aes_cbc_stream_update(None, key, 32, out_buf, 16), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_aes_cbc_stream_update(stream, None, 32, out_buf, 16), (WALLY_EINVAL, 0))
+        # Decryption with no whole final block fails
+        self.assertEqual(wally_aes_cbc_stream_final(stream, out_buf, out_len), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_aes_cbc_stream_update(stream, key, 8, out_buf, 16), (WALLY_OK, 0))
+        self.assertEqual(wally_aes_cbc_stream_final(stream, out_buf, out_len), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_aes_cbc_stream_free(stream), WALLY_OK)
+        self.assertEqual(wally_aes_cbc_stream_free(None), WALLY_EINVAL)
+
 
 if __name__ == '__main__':
     unittest.main()
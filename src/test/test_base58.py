@@ -154,6 +154,133 @@ class Base58Tests(unittest.TestCase):
         self.assertEqual(self.encode('45046252208D', self.FLAG_CHECKSUM),
                                      '4stwEBjT6FYyVV')
 
+    def test_lengths(self):
+        """Test encoding against a reference implementation for all lengths"""
+        alphabet = '123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz'
+        def ref_encode(data):
+            n, out = int.from_bytes(data, 'big'), ''
+            while n:
+                n, r = divmod(n, 58)
+                out = alphabet[r] + out
+            return '1' * (len(data) - len(data.lstrip(b'\x00'))) + out
+
+        for n in list(range(1, 100)) + [460, 461, 600, 767]:
+            for data in [bytes([(i * 151 + n) & 0xff for i in range(n)]),
+                         b'\x00' * (n // 3) + b'\xff' * (n - n // 3)]:
+                expected = ref_encode(data)
+                self.assertEqual(self.encode(data.hex(), 0), expected)
+                self.assertEqual(self.decode(expected, 0), utf8(data.hex().upper()))
+
+        # An invalid character anywhere is detected
+        buf, buf_len = make_cbuffer('00' * 64)
+        valid = self.encode('ff' * 32, 0)
+        for i in range(len(valid)):
+            for c in '0IOl':
+                s = valid[:i] + c + valid[i + 1:]
+                ret, _ = wally_base58_to_bytes(utf8(s), 0, buf, buf_len)
+                self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_from_bytes_to_buffer(self):
+        for hex_in, flags in [('00' * 3, 0), ('00CEF022FA', 0),
+                              ('45046252208D', self.FLAG_CHECKSUM)]:
+            expected = self.encode(hex_in, flags)
+            buf, buf_len = make_cbuffer(hex_in)
+            out = create_string_buffer(len(expected) + 1)
+            ret, written = wally_base58_from_bytes_to_buffer(buf, buf_len, flags,
+                                                             out, len(out))
+            self.assertEqual((ret, written), (WALLY_OK, len(expected) + 1))
+            self.assertEqual(out.value, utf8(expected))
+
+            # Too small, returns the required length and leaves output untouched
+            out = create_string_buffer(len(expected))
+            ret, written = wally_base58_from_bytes_to_buffer(buf, buf_len, flags,
+                                                             out, len(out))
+            self.assertEqual((ret, written), (WALLY_OK, len(expected) + 1))
+            self.assertEqual(out.value, utf8(''))
+
+        buf, buf_len = make_cbuffer('00' * 8)
+        out = create_string_buffer(16)
+        for args in [(None, buf_len, 0, out, len(out)),
+                     (buf, 0, 0, out, len(out)),
+                     (buf, buf_len, 0x7, out, len(out)),
+                     (buf, buf_len, 0, None, len(out))]:
+            self.assertEqual(wally_base58_from_bytes_to_buffer(*args), (WALLY_EINVAL, 0))
+
+
+    def test_batch(self):
+        for item_len, flags in [(21, self.FLAG_CHECKSUM), (78, self.FLAG_CHECKSUM),
+                                (200, self.FLAG_CHECKSUM), (5, 0)]:
+            items = [bytes([(i * 13 + j) & 0xff for j in range(item_len)]) for i in range(10)]
+            items[3] = b'\x00' * item_len
+            expected = ''.join([self.encode(b.hex(), flags) + '\0' for b in items])
+            buf, buf_len = make_cbuffer(b''.join(items).hex())
+
+            out = create_string_buffer(len(expected))
+            for l in [0, len(expected) - 1, len(expected)]:
+                ret, written = wally_base58_from_bytes_batch(buf, buf_len, item_len,
+                                                             flags, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+            self.assertEqual(out.raw, utf8(expected))
+
+            decoded, decoded_len = make_cbuffer('00' * buf_len)
+            for l in [buf_len - 1, buf_len]:
+                ret, written = wally_base58_to_bytes_batch(out, len(out), item_len,
+                                                           flags, decoded, l)
+                self.assertEqual((ret, written), (WALLY_OK, buf_len))
+            self.assertEqual(decoded, b''.join(items))
+
+            # Wrong item length
+            decoded, decoded_len = make_cbuffer('00' * (buf_len + 10))
+            ret, written = wally_base58_to_bytes_batch(out, len(out), item_len + 1,
+                                                       flags, decoded, decoded_len)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+        # Bad checksum in the last string
+        bad = utf8(self.encode('00' * 20 + '01', self.FLAG_CHECKSUM) + '\0' +
+                   self.encode('00' * 25, 0) + '\0')
+        ret, written = wally_base58_to_bytes_batch(bad, len(bad), 21, self.FLAG_CHECKSUM,
+                                                   decoded, decoded_len)
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        self.assertEqual(decoded[:42], b'\x00' * 42)
+
+        buf, buf_len = make_cbuffer('00' * 8)
+        out = create_string_buffer(32)
+        for args in [(None, buf_len, 4, 0, out, len(out)),
+                     (buf, 0, 4, 0, out, len(out)),
+                     (buf, buf_len, 0, 0, out, len(out)),
+                     (buf, buf_len, 3, 0, out, len(out)),
+                     (buf, buf_len, 4, 0x7, out, len(out)),
+                     (buf, buf_len, 4, 0, None, len(out))]:
+            self.assertEqual(wally_base58_from_bytes_batch(*args), (WALLY_EINVAL, 0))
+        # Unterminated, empty and invalid batches
+        for s in [b'1111', b'', b'\0', b'11\0\0', b'0OIl\0']:
+            ret, written = wally_base58_to_bytes_batch(s, len(s), 2, 0, buf, buf_len)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+
+    def test_input_limit(self):
+        """Testing the base58 input length limit"""
+        LIMIT_BASE58_LEN, NUM_LIMITS = 2, 4
+        buf, buf_len = make_cbuffer('00' * 1024)
+        base58 = utf8('16UwLL9Risc3QfPqBUvKofHmBQ7wMtjvM')
+        self.assertEqual(wally_set_input_limit(NUM_LIMITS, 1), WALLY_EINVAL)
+        self.assertEqual(wally_get_input_limit(NUM_LIMITS), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_get_input_limit(LIMIT_BASE58_LEN), (WALLY_OK, 0))
+        try:
+            for limit, expected in [(len(base58), WALLY_OK),
+                                    (len(base58) - 1, WALLY_EINVAL)]:
+                self.assertEqual(wally_set_input_limit(LIMIT_BASE58_LEN, limit), WALLY_OK)
+                self.assertEqual(wally_get_input_limit(LIMIT_BASE58_LEN), (WALLY_OK, limit))
+                self.assertEqual(wally_base58_get_length(base58)[0], expected)
+                ret, _ = wally_base58_to_bytes(base58, 0, buf, buf_len)
+                self.assertEqual(ret, expected)
+                # Long input is rejected without being decoded
+                ret, _ = wally_base58_to_bytes(utf8('z' * 100000), 0, buf, buf_len)
+                self.assertEqual(ret, WALLY_EINVAL)
+        finally:
+            wally_set_input_limit(LIMIT_BASE58_LEN, 0)
+        ret, _ = wally_base58_to_bytes(base58, 0, buf, buf_len)
+        self.assertEqual(ret, WALLY_OK)
 
 
 if __name__ == '__main__':
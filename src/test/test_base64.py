@@ -0,0 +1,114 @@
+import base64
+import unittest
+from util import *
+
+# RFC 4648 test vectors
+RFC4648_CASES = [
+    ('', ''), ('f', 'Zg=='), ('fo', 'Zm8='), ('foo', 'Zm9v'),
+    ('foob', 'Zm9vYg=='), ('fooba', 'Zm9vYmE='), ('foobar', 'Zm9vYmFy'),
+]
+
+
+class Base64Tests(unittest.TestCase):
+
+    def decode(self, str_in, out_len=1024):
+        out, out_len = make_cbuffer('00' * out_len)
+        ret, written = wally_base64_to_bytes(utf8(str_in), 0, out, out_len)
+        if ret == WALLY_OK:
+            return out[:written]
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        return None
+
+    def test_rfc4648(self):
+        for data, expected in RFC4648_CASES:
+            buf = data.encode('ascii') or b'\x00'
+            ret, encoded = wally_base64_from_bytes(buf, len(data), 0)
+            self.assertEqual((ret, encoded), (WALLY_OK, expected))
+            self.assertEqual(self.decode(expected), data.encode('ascii'))
+            ret, max_len = wally_base64_get_maximum_length(utf8(expected), 0)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertTrue(len(data) <= max_len <= len(data) + 2)
+
+    def test_lengths(self):
+        """Test lengths and positions handled by both scalar and optimized code"""
+        for _ in optimized_runs():
+            for n in list(range(0, 200)) + [1023, 1024, 1025]:
+                data = bytes([(i * 37 + n) & 0xff for i in range(n)])
+                expected = base64.b64encode(data).decode('ascii')
+                buf, buf_len = make_cbuffer(data.hex() or '00')
+                ret, encoded = wally_base64_from_bytes(buf, n, 0)
+                self.assertEqual((ret, encoded), (WALLY_OK, expected))
+                self.assertEqual(self.decode(expected, n + 1), data)
+
+                # Every character in the alphabet decodes wherever it occurs
+                if n == 96:
+                    alphabet = base64.b64encode(bytes(range(48)) * 2).decode('ascii')
+                    for i in range(64):
+                        s = alphabet[i:] + alphabet[:i]
+                        self.assertEqual(self.decode(s), base64.b64decode(s))
+
+                # An invalid character anywhere is detected
+                for i in range(0, len(expected), 7 if n > 100 else 1):
+                    for c in '-_*\x80\xff=':
+                        s = expected[:i] + c + expected[i + 1:]
+                        if c == '=' and i >= len(expected) - 2:
+                            continue # Padding is valid here if correctly placed
+                        utf8_s = s.encode('latin-1')
+                        out, out_len = make_cbuffer('00' * (n + 3))
+                        ret, written = wally_base64_to_bytes(utf8_s, 0, out, out_len)
+                        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+    def test_invalid(self):
+        for s in ['A', 'AA', 'AAA', 'AAAAA', # Bad lengths
+                  'Zg', 'Zm8', 'AA==AAAA', 'A===', '====', 'AA=A', # Bad padding
+                  'Zh==', 'Zm9=', # Non-zero unused bits
+                  'Zm9\n', ' m9v', 'Zm9v Zm9']: # Whitespace
+            self.assertIsNone(self.decode(s))
+
+        out, out_len = make_cbuffer('00' * 8)
+        for args in [(None, 0, out, out_len), # Missing input
+                     (utf8('Zm9v'), 1, out, out_len), # Unknown flags
+                     (utf8('Zm9v'), 0, None, out_len), # Missing output
+                     (utf8('Zm9v'), 0, out, 0)]: # Empty output
+            ret, written = wally_base64_to_bytes(*args)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+        for args in [(None, 1, 0), (out, 1, 1)]:
+            ret, encoded = wally_base64_from_bytes(*args)
+            self.assertEqual((ret, encoded), (WALLY_EINVAL, None))
+
+    def test_buffers(self):
+        buf, buf_len = make_cbuffer(b'foobar'.hex())
+        out = create_string_buffer(9)
+        ret, written = wally_base64_from_bytes_to_buffer(buf, buf_len, 0, out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, 9))
+        self.assertEqual(out.value, utf8('Zm9vYmFy'))
+
+        # Too small, returns the required length and leaves output untouched
+        out = create_string_buffer(8)
+        ret, written = wally_base64_from_bytes_to_buffer(buf, buf_len, 0, out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, 9))
+        self.assertEqual(out.value, utf8(''))
+
+        # Decoding into a buffer that is too small returns the required length
+        out, out_len = make_cbuffer('00' * 5)
+        ret, written = wally_base64_to_bytes(utf8('Zm9vYmFy'), 0, out, out_len)
+        self.assertEqual((ret, written), (WALLY_OK, 6))
+        self.assertEqual(out, b'\x00' * 5)
+
+        # Decoding a string that is not NUL terminated
+        out, out_len = make_cbuffer('00' * 6)
+        ret, written = wally_base64_n_to_bytes(utf8('Zm9vYmFyZm9v'), 8, 0, out, out_len)
+        self.assertEqual((ret, out[:written]), (WALLY_OK, b'foobar'))
+
+    def test_psbt(self):
+        # A base 64 PSBT from BIP 174 round trips
+        psbt = 'cHNidP8BAHUCAAAAASaBcTce3/KF6Tet7qSze3gADAVmy7OtZGQXE8pCFxv2AAAAAAD+////AtPf9QUAAAAAGXapFNDFmQPFusKGh2DpD9UhpGZap2UgiKwA4fUFAAAAABepFDVF5uM7gyxHBQ8k0+65PJwDlIvHh7MuEwAAAQD9pQEBAAAAAAECiaPHHqtNIOA3G7ukzGmPopXJRjr6Ljl/hTPMti+VZ+UBAAAAFxYAFL4Y0VKpsBIDna89p95PUzSe7LmF/////4b4qkOnHf8USIk6UwpyN+9rRgi7st0tAXHmOuxqSJC0AQAAABcWABT+Pp7xp0XpdNkCxDVZQ6vLNL1TU/////8CAMLrCwAAAAAZdqkUhc/xCX/Z4Ai7NK9wnGIZeziXikiIrHL++E4sAAAAF6kUM5cluiHv1irHU6m80GfWx6ajnQWHAkcwRAIgJxK+IuAnDzlPVoMR3HyppolwuAJf3TskAinwf4pfOiQCIAGLONfc0xTnNMkna9b7QPZzMlvEuqFEyADS8vAtsnZcASED0uFWdJQbrUqZY3LLh+GFbTZSYG2YVi/jnF6efkE/IQUCSDBFAiEA0SuFLYXc2WHS9fSrZgZU327tzHlMDDPOXMMJ/7X85Y0CIGczio4OFyXBl/saiK9Z9R5E5CVbIBZ8hoQDHAXR8lkqASECI7cr7vCWXRC+B3jv7NYfysb3mk6haTkzgHNEZPhPKrMAAAAAAA=='
+        data = base64.b64decode(psbt)
+        self.assertEqual(self.decode(psbt), data)
+        buf, buf_len = make_cbuffer(data.hex())
+        self.assertEqual(wally_base64_from_bytes(buf, buf_len, 0), (WALLY_OK, psbt))
+
+
+if __name__ == '__main__':
+    unittest.main()
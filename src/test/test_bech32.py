@@ -61,6 +61,13 @@ class Bech32Tests(unittest.TestCase):
                 self.assertEqual(ret, WALLY_OK)
                 self.assertEqual(retstr.lower(), addr.lower())
 
+                out = create_string_buffer(len(addr) + 1)
+                for l in [len(out) - 1, len(out)]:
+                    ret, written = wally_addr_segwit_from_bytes_to_buffer(
+                        script_buf, script_len, utf8(family), 0, out, l)
+                    self.assertEqual((ret, written), (WALLY_OK, len(addr) + 1))
+                self.assertEqual(out.value, utf8(retstr))
+
         # Invalid cases
         for family, addr in invalid_cases:
             ret, result_script_hex = self.decode(addr, family)
@@ -71,6 +78,49 @@ class Bech32Tests(unittest.TestCase):
         ret, written = wally_addr_segwit_to_bytes(utf8(bad), utf8('tb'), 0, out, out_len)
         self.assertEqual((ret, written), (WALLY_EINVAL, 0))
 
+    def test_segwit_address_batch(self):
+        """Tests for batch encoding and decoding segwit addresses"""
+        for item_len in [22, 34]:
+            progs = [bytes([0, item_len - 2]) + bytes([(i * 7 + j) & 0xff for j in range(item_len - 2)])
+                     for i in range(8)]
+            addrs = []
+            for p in progs:
+                buf, buf_len = make_cbuffer(p.hex())
+                ret, addr = wally_addr_segwit_from_bytes(buf, buf_len, utf8('bc'), 0)
+                self.assertEqual(ret, WALLY_OK)
+                addrs.append(addr)
+            expected = utf8(''.join([a + '\0' for a in addrs]))
+            buf, buf_len = make_cbuffer(b''.join(progs).hex())
+
+            out = create_string_buffer(len(expected))
+            for l in [0, len(expected) - 1, len(expected)]:
+                ret, written = wally_addr_segwit_from_bytes_batch(buf, buf_len, item_len,
+                                                                  utf8('bc'), 0, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+            self.assertEqual(out.raw, expected)
+
+            decoded, decoded_len = make_cbuffer('00' * buf_len)
+            for l in [buf_len - 1, buf_len]:
+                ret, written = wally_addr_segwit_to_bytes_batch(out, len(out), item_len,
+                                                                utf8('bc'), 0, decoded, l)
+                self.assertEqual((ret, written), (WALLY_OK, buf_len))
+            self.assertEqual(decoded, b''.join(progs))
+
+            # Wrong family, wrong program length, and a corrupted address
+            decoded, decoded_len = make_cbuffer('00' * (buf_len * 2))
+            corrupt = bytearray(out.raw)
+            corrupt[len(expected) - 2] = ord('q') if corrupt[len(expected) - 2] != ord('q') else ord('p')
+            for s, family, l in [(out.raw, 'tb', item_len), (out.raw, 'bc', item_len + 1),
+                                 (bytes(corrupt), 'bc', item_len)]:
+                ret, written = wally_addr_segwit_to_bytes_batch(s, len(s), l, utf8(family),
+                                                                0, decoded, decoded_len)
+                self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+            # Invalid programs
+            ret, written = wally_addr_segwit_from_bytes_batch(buf, buf_len, item_len - 1,
+                                                              utf8('bc'), 0, out, len(out))
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
 
 if __name__ == '__main__':
     unittest.main()
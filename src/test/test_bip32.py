@@ -355,6 +355,354 @@ class BIP32Tests(unittest.TestCase):
             ret = bip32_key_from_parent_path(key, c_path, plen, flags, key_out)
             self.assertEqual(ret, WALLY_EINVAL)
 
+        # Internal flags are rejected
+        ret = bip32_key_from_parent(byref(priv), 1 | 0x80000000, 0x80000000, key_out)
+        self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_key_from_parent_path_hardened(self):
+        master, _, _ = self.create_master_pub_priv()
+        H = 0x80000000
+        fields = ['chain_code', 'parent160', 'depth', 'priv_key', 'child_num',
+                  'hash160', 'version', 'pub_key']
+        raw = lambda k: [bytes(v) if hasattr(v, '_length_') else v
+                         for v in [getattr(k, f) for f in fields]]
+
+        # Paths whose internal nodes skip public key computation give the
+        # same keys as deriving one step at a time
+        for path in [[H + 44, H, H], [H + 48, H, H, H + 2, 0, 5],
+                     [H + 1, H + 2, H + 3, H + 4, H + 5], [H, 1, H + 2, 3]]:
+            for flags in [FLAG_KEY_PRIVATE, FLAG_KEY_PRIVATE | FLAG_SKIP_HASH]:
+                expected = master
+                for child_num in path:
+                    key_out = ext_key()
+                    ret = bip32_key_from_parent(byref(expected), child_num,
+                                                flags, byref(key_out))
+                    self.assertEqual(ret, WALLY_OK)
+                    expected = key_out
+                key_out = self.derive_key_by_path(master, path, flags)
+                self.assertEqual(raw(key_out), raw(expected))
+
+    def test_key_from_parent_range(self):
+        master, pub, priv = self.create_master_pub_priv()
+        H = 0x80000000
+        raw = lambda k: bytes(memoryview(k))
+
+        for parent, flags, start in [(master, FLAG_KEY_PRIVATE, 0),
+                                     (master, FLAG_KEY_PUBLIC, 5),
+                                     (master, FLAG_KEY_PRIVATE | FLAG_SKIP_HASH, H - 4),
+                                     (pub, FLAG_KEY_PUBLIC, 3),
+                                     (pub, FLAG_KEY_PUBLIC | FLAG_SKIP_HASH, 0)]:
+            for count in [1, 7, 8, 9, 20]:
+                keys = (ext_key * count)()
+                ret = bip32_key_from_parent_range(byref(parent), start, flags,
+                                                  keys, count)
+                self.assertEqual(ret, WALLY_OK)
+                for i in range(count):
+                    expected = ext_key()
+                    ret = bip32_key_from_parent(byref(parent), start + i,
+                                                flags, byref(expected))
+                    self.assertEqual(ret, WALLY_OK)
+                    self.assertEqual(raw(keys[i]), raw(expected))
+
+        # Deriving a hardened child from a public parent clears all output
+        keys = (ext_key * 10)()
+        ret = bip32_key_from_parent_range(byref(pub), H - 5, FLAG_KEY_PUBLIC,
+                                          keys, 10)
+        self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(raw(keys), bytes(len(raw(keys))))
+
+        keys = (ext_key * 3)()
+        m = byref(master)
+        cases = [(None, 0,              FLAG_KEY_PRIVATE,   keys, 3), # Null parent
+                 (m,    0,              FLAG_KEY_PRIVATE,   None, 3), # Null output keys
+                 (m,    0,              ~ALL_DEFINED_FLAGS, keys, 3), # Invalid flags
+                 (m,    0,              FLAG_KEY_PRIVATE,   keys, 0), # No output keys
+                 (m,    0xfffffffe,     FLAG_KEY_PRIVATE,   keys, 3)] # Child number overflow
+        for args in cases:
+            self.assertEqual(bip32_key_from_parent_range(*args), WALLY_EINVAL)
+
+    def test_key_from_parent_parsed(self):
+        master, pub, priv = self.create_master_pub_priv()
+        raw = lambda k: bytes(memoryview(k))
+
+        for parent, flags in [(pub,  FLAG_KEY_PUBLIC),
+                              (pub,  FLAG_KEY_PUBLIC | FLAG_SKIP_HASH),
+                              (priv, FLAG_KEY_PRIVATE),
+                              (priv, FLAG_KEY_PUBLIC)]:
+            parsed = c_void_p()
+            ret = wally_ec_public_key_init_alloc(parent.pub_key, len(parent.pub_key),
+                                                 byref(parsed))
+            self.assertEqual(ret, WALLY_OK)
+            for child_num in range(4):
+                key_out, expected = ext_key(), ext_key()
+                ret = bip32_key_from_parent_parsed(byref(parent), parsed, child_num,
+                                                   flags, byref(key_out))
+                self.assertEqual(ret, WALLY_OK)
+                ret = bip32_key_from_parent(byref(parent), child_num,
+                                            flags, byref(expected))
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(raw(key_out), raw(expected))
+
+            # The parsed key must be the parents public key
+            child = self.derive_key(parent, 1, flags)
+            key_out = ext_key()
+            for key, p in [(None,         parsed), # Null parent
+                           (byref(pub),   None),   # Null parsed key
+                           (byref(child), parsed)]: # Mismatched parsed key
+                ret = bip32_key_from_parent_parsed(key, p, 0, flags, byref(key_out))
+                self.assertEqual(ret, WALLY_EINVAL)
+            self.assertEqual(wally_ec_public_key_free(parsed), WALLY_OK)
+
+    def test_key_from_parent_path_cached(self):
+        master, pub, priv = self.create_master_pub_priv()
+        H = 0x80000000
+        # Compare all members, since padding is not cleared by the derivation
+        raw = lambda k: [bytes(getattr(k, f)) if f != 'depth' and f != 'child_num' and
+                         f != 'version' else getattr(k, f)
+                         for f, _ in k._fields_ if not f.startswith('pad')]
+        cache = c_void_p()
+        self.assertEqual(bip32_path_cache_init_alloc(2, byref(cache)), WALLY_OK)
+
+        def check(parent, path, flags, expected_ret=WALLY_OK):
+            c_path = self.path_to_c(path)
+            key_out, expected = ext_key(), ext_key()
+            ret = bip32_key_from_parent_path_cached(cache, byref(parent), c_path,
+                                                    len(path), flags, byref(key_out))
+            self.assertEqual(ret, expected_ret)
+            ret = bip32_key_from_parent_path(byref(parent), c_path, len(path),
+                                             flags, byref(expected))
+            self.assertEqual(ret, expected_ret)
+            self.assertEqual(raw(key_out), raw(expected))
+
+        # Repeated derivations return identical keys to uncached derivation,
+        # including after eviction from the (two entry) cache
+        for _ in range(2):
+            for parent, prefix, flags in [
+                (master, [H + 84, H, H, 0], FLAG_KEY_PRIVATE),
+                (master, [84, 0, 0, 0], FLAG_KEY_PUBLIC),
+                (master, [H + 84, H, H, 1], FLAG_KEY_PRIVATE | FLAG_SKIP_HASH),
+                (pub, [1, 2], FLAG_KEY_PUBLIC),
+                (pub, [1, 2], FLAG_KEY_PUBLIC | FLAG_SKIP_HASH),
+                (priv, [1, 2], FLAG_KEY_PUBLIC),
+                (master, [5], FLAG_KEY_PRIVATE),
+                (master, [], FLAG_KEY_PRIVATE),
+                (master, list(range(12)), FLAG_KEY_PRIVATE)]:
+                for i in range(3):
+                    check(parent, prefix + [i], flags)
+
+        # Failures are not cached, and leave the cache usable
+        check(pub, [H, 1], FLAG_KEY_PUBLIC, WALLY_EINVAL)
+        check(pub, [1, H], FLAG_KEY_PUBLIC, WALLY_EINVAL)
+        check(pub, [1, 2, 3], FLAG_KEY_PRIVATE, WALLY_EINVAL)
+        check(master, [1, 2, 3], ~ALL_DEFINED_FLAGS, WALLY_EINVAL)
+        check(pub, [1, 2, 3], FLAG_KEY_PUBLIC)
+
+        self.assertEqual(bip32_path_cache_flush(cache), WALLY_OK)
+        check(master, [1, 2, 3], FLAG_KEY_PRIVATE)
+
+        c_path = self.path_to_c([1, 2])
+        key_out = ext_key()
+        for c, k, p, plen, o in [(None,  master, c_path, 2, key_out), # Null cache
+                                 (cache, None,   c_path, 2, key_out), # Null parent
+                                 (cache, master, None,   2, key_out), # Null path
+                                 (cache, master, c_path, 2, None),    # Null output key
+                                 (cache, master, c_path, 0, key_out)]: # Bad path length
+            ret = bip32_key_from_parent_path_cached(c, byref(k) if k else None,
+                                                    p, plen, FLAG_KEY_PRIVATE,
+                                                    byref(o) if o else None)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+        self.assertEqual(bip32_path_cache_free(cache), WALLY_OK)
+        for fn in [bip32_path_cache_flush, bip32_path_cache_free]:
+            self.assertEqual(fn(None), WALLY_EINVAL)
+        cache = c_void_p()
+        self.assertEqual(bip32_path_cache_init_alloc(0, byref(cache)), WALLY_EINVAL)
+        self.assertEqual(cache.value, None)
+
+    def test_key_discover(self):
+        master, pub, priv = self.create_master_pub_priv()
+        P2PKH, P2SH, P2WPKH = 0x2, 0x4, 0x8
+
+        def hash160(b):
+            out = create_string_buffer(20)
+            self.assertEqual(wally_hash160(b, len(b), out, 20), WALLY_OK)
+            return out.raw
+
+        def child_hash(parent, chain, n, p2sh):
+            key = self.derive_key(self.derive_key(parent, chain, FLAG_KEY_PUBLIC),
+                                  n, FLAG_KEY_PUBLIC)
+            h = bytes(key.hash160)
+            return hash160(b'\x00\x14' + h) if p2sh else h
+
+        def discover(parent, hashes, flags, gap, run_fn=run_tasks_fn_t(), n=64):
+            out = (c_uint * n)()
+            ret, written = bip32_key_discover(byref(parent), hashes, len(hashes),
+                                              flags, gap, run_fn, None, out, n)
+            self.assertEqual(ret, WALLY_OK)
+            matches = [(out[i], out[i + 1]) for i in range(0, min(written, n - 1), 2)]
+            return matches, written
+
+        # 70 is too far past 41 to be found with a gap limit of 20
+        used = [(0, 0), (0, 3), (0, 22), (0, 41), (0, 70), (1, 1)]
+        unknown = hash160(b'unknown')
+        for parent in [master, pub]:
+            for p2sh, flags in [(False, P2PKH), (False, P2WPKH), (True, P2SH)]:
+                hashes = unknown + b''.join([child_hash(parent, c, n, p2sh) for c, n in used])
+                for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                    matches, written = discover(parent, hashes, flags, 20, run_fn)
+                    self.assertEqual(matches, used[:4] + used[5:])
+                    self.assertEqual(written, 10)
+                # A larger gap limit finds all the used children
+                matches, _ = discover(parent, hashes, flags | P2PKH | P2WPKH | P2SH, 30)
+                self.assertEqual(matches, used)
+                # A gap limit of 1 stops after the first unused child
+                matches, _ = discover(parent, hashes, flags, 1)
+                self.assertEqual(matches, [(0, 0)])
+                # Too little output space returns the required length
+                matches, written = discover(parent, hashes, flags, 20, n=3)
+                self.assertEqual((matches, written), ([(0, 0)], 10))
+            # Script types whose hashes are not in the set find nothing
+            matches, written = discover(parent, hashes, P2PKH, 20)
+            self.assertEqual((matches, written), ([], 0))
+
+        out = (c_uint * 4)()
+        m, run_fn = byref(master), run_tasks_fn_t()
+        cases = [(None, unknown, 20,  P2PKH,  20, out),  # Null key
+                 (m,    None,    20,  P2PKH,  20, out),  # Null hashes
+                 (m,    unknown, 0,   P2PKH,  20, out),  # Empty hashes
+                 (m,    unknown, 19,  P2PKH,  20, out),  # Bad hashes length
+                 (m,    unknown, 20,  0,      20, out),  # No script types
+                 (m,    unknown, 20,  0x10,   20, out),  # Unsupported type
+                 (m,    unknown, 20,  P2PKH,  0,  out),  # Zero gap limit
+                 (m,    unknown, 20,  P2PKH,  20, None)] # Null output
+        for k, h, hlen, flags, gap, o in cases:
+            ret, written = bip32_key_discover(k, h, hlen, flags, gap, run_fn, None, o, 4)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+    def test_key_to_addresses_range(self):
+        master, pub, priv = self.create_master_pub_priv()
+        P2PKH, P2SH, P2WPKH = 0x2, 0x4, 0x8
+
+        def hash160(b):
+            out = create_string_buffer(20)
+            self.assertEqual(wally_hash160(b, len(b), out, 20), WALLY_OK)
+            return out.raw
+
+        def expected_address(parent, n, flags, version, family):
+            h = bytes(self.derive_key(parent, n, FLAG_KEY_PUBLIC).hash160)
+            if flags == P2WPKH:
+                ret, addr = wally_addr_segwit_from_bytes(b'\x00\x14' + h, 22, family, 0)
+            else:
+                if flags == P2SH:
+                    h = hash160(b'\x00\x14' + h)
+                ret, addr = wally_base58_from_bytes(bytes([version]) + h, 21, 1)
+            self.assertEqual(ret, WALLY_OK)
+            return addr
+
+        for parent in [master, pub]:
+            for flags, version, family in [(P2PKH, 0x00, None), (P2PKH, 0x6f, None),
+                                           (P2SH, 0x05, None), (P2WPKH, 0, utf8('bc')),
+                                           (P2WPKH, 0, utf8('tb'))]:
+                for start, count in [(0, 1), (5, 8), (0x7fffffe0, 17)]:
+                    expected = [expected_address(parent, start + i, flags, version, family)
+                                for i in range(count)]
+                    expected = b''.join([utf8(e) + b'\x00' for e in expected])
+                    out = create_string_buffer(len(expected))
+                    ret, written = bip32_key_to_addresses_range(
+                        byref(parent), start, count, flags, version, family,
+                        out, len(out))
+                    self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+                    self.assertEqual(out.raw, expected)
+                    # Too little output space returns the required length
+                    ret, written = bip32_key_to_addresses_range(
+                        byref(parent), start, count, flags, version, family,
+                        out, len(out) - 1)
+                    self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+
+        out = create_string_buffer(64)
+        m, bc, H = byref(master), utf8('bc'), 0x80000000
+        cases = [(None, 0,          1, P2PKH,  0,     None), # Null key
+                 (m,    0,          0, P2PKH,  0,     None), # No addresses
+                 (m,    0xffffffff, 2, P2PKH,  0,     None), # Child number overflow
+                 (m,    0,          1, 0,      0,     None), # No script type
+                 (m,    0,          1, 0x10,   0,     None), # Unsupported type
+                 (m,    0,          1, P2PKH,  0x100, None), # Bad version
+                 (m,    0,          1, P2PKH,  0,     bc),   # Family for p2pkh
+                 (m,    0,          1, P2WPKH, 0,     None), # No family for p2wpkh
+                 (m,    0,          1, P2WPKH, 5,     bc),   # Version for p2wpkh
+                 (byref(pub), H,    1, P2PKH,  0,     None)] # Hardened public child
+        for k, start, count, flags, version, family in cases:
+            ret, written = bip32_key_to_addresses_range(k, start, count, flags,
+                                                        version, family, out, len(out))
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+    def test_key_pool(self):
+        master, pub, priv = self.create_master_pub_priv()
+        PUB_KEY, HASH160, CHILD_NUM = 0x1, 0x2, 0x4
+        H = 0x80000000
+
+        for fields in [PUB_KEY, HASH160, CHILD_NUM, PUB_KEY | HASH160, 0x7]:
+            pool = POINTER(ext_key_pool)()
+            ret = bip32_key_pool_init_alloc(30, fields, byref(pool))
+            self.assertEqual(ret, WALLY_OK)
+            self.assertEqual((pool.contents.capacity, pool.contents.fields), (30, fields))
+
+            added = []
+            for parent, start, count in [(master, 0, 1), (pub, 7, 20),
+                                         (master, H - 4, 9)]:
+                ret = bip32_key_pool_add_range(pool, byref(parent), start, count, 0)
+                self.assertEqual(ret, WALLY_OK)
+                added.extend([self.derive_key(parent, start + i, FLAG_KEY_PUBLIC)
+                              for i in range(count)])
+            p = pool.contents
+            self.assertEqual(p.num_keys, 30)
+
+            # Nothing more can be added, and a failed add leaves the pool alone
+            ret = bip32_key_pool_add_range(pool, byref(master), 0, 1, 0)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+            for name, flag, width in [('pub_keys', PUB_KEY, 33),
+                                      ('hash160s', HASH160, 20)]:
+                arr = getattr(p, name)
+                if fields & flag:
+                    key_field = 'pub_key' if flag == PUB_KEY else 'hash160'
+                    expected = b''.join([bytes(getattr(k, key_field)) for k in added])
+                    self.assertEqual(bytes(arr[:30 * width]), expected)
+                else:
+                    self.assertFalse(arr)
+            if fields & CHILD_NUM:
+                self.assertEqual(p.child_nums[:30], [k.child_num for k in added])
+            else:
+                self.assertFalse(p.child_nums)
+            width = sum([w for f, w in [(PUB_KEY, 33), (HASH160, 20), (CHILD_NUM, 4)]
+                         if fields & f])
+            self.assertEqual(bip32_key_pool_get_memory_usage(pool),
+                             (WALLY_OK, sizeof(ext_key_pool) + 30 * width))
+            self.assertEqual(bip32_key_pool_free(pool), WALLY_OK)
+
+        pool = POINTER(ext_key_pool)()
+        for capacity, fields in [(0, PUB_KEY), (1, 0), (1, 0x8)]:
+            ret = bip32_key_pool_init_alloc(capacity, fields, byref(pool))
+            self.assertEqual(ret, WALLY_EINVAL)
+            self.assertFalse(pool)
+        self.assertEqual(bip32_key_pool_init_alloc(1, PUB_KEY, None), WALLY_EINVAL)
+
+        self.assertEqual(bip32_key_pool_init_alloc(4, PUB_KEY, byref(pool)), WALLY_OK)
+        m = byref(master)
+        cases = [(None, m,          0,      1, 0), # Null pool
+                 (pool, None,       0,      1, 0), # Null parent
+                 (pool, m,          0,      0, 0), # No keys
+                 (pool, m,          0,      5, 0), # Too many keys
+                 (pool, m,          0,      1, 1), # Invalid flags
+                 (pool, m, 0xffffffff,      2, 0), # Child number overflow
+                 (pool, byref(pub), H - 2,  4, 0)] # Hardened public child
+        for args in cases:
+            self.assertEqual(bip32_key_pool_add_range(*args), WALLY_EINVAL)
+        self.assertEqual(pool.contents.num_keys, 0)
+        self.assertEqual(bip32_key_pool_free(pool), WALLY_OK)
+        self.assertEqual(bip32_key_pool_free(None), WALLY_EINVAL)
+        self.assertEqual(bip32_key_pool_get_memory_usage(None), (WALLY_EINVAL, 0))
+
     def test_free_invalid(self):
         self.assertEqual(WALLY_EINVAL, bip32_key_free(None))
 
@@ -374,6 +722,104 @@ class BIP32Tests(unittest.TestCase):
             self.assertEqual(bip32_key_serialize(key_out, flag, buf, buf_len), WALLY_OK)
             self.assertEqual(h(buf).upper(), exp_hex)
 
+            out_buf = create_string_buffer(len(out) + 1)
+            for l in [len(out_buf), len(out_buf) - 1]:
+                ret, written = bip32_key_to_base58_to_buffer(key, flag, out_buf, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(out) + 1))
+            self.assertEqual(out_buf.value, utf8(out))
+
+    def test_base58_fixed_layout(self):
+        master = self.create_master_pub_priv()[0]
+        buf, buf_len = make_cbuffer('00' * 78)
+
+        # Encoding matches generic base 58 for keys with varied contents
+        for n in range(32):
+            key = self.derive_key(master, n * 0x1234567, FLAG_KEY_PRIVATE)
+            for flag in [FLAG_KEY_PRIVATE, FLAG_KEY_PUBLIC]:
+                self.assertEqual(bip32_key_serialize(key, flag, buf, buf_len), WALLY_OK)
+                ret, expected = wally_base58_from_bytes(buf, buf_len, 1)
+                self.assertEqual(ret, WALLY_OK)
+                ret, out = bip32_key_to_base58(key, flag)
+                self.assertEqual((ret, out), (WALLY_OK, expected))
+                key_out = ext_key()
+                ret = bip32_key_from_base58(utf8(out), byref(key_out))
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(bytes(key_out.pub_key), bytes(key.pub_key))
+
+        # Mutations of a valid key are rejected
+        alphabet = '123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz'
+        for i in [0, 1, 50, 109, 110]:
+            c = alphabet[(alphabet.index(out[i]) + 1) % 58]
+            bad = [out[:i] + c + out[i + 1:], # Changed char (checksum)
+                   out[:i] + '0' + out[i + 1:], # Invalid char
+                   out[:i] + out[i + 1:], # Too short
+                   out[:i] + out[i] + out[i:]] # Too long
+            for b in bad:
+                ret = bip32_key_from_base58(utf8(b), byref(ext_key()))
+                self.assertEqual(ret, WALLY_EINVAL)
+        for b in ['1' + out[1:], 'z' * 111, '2' + '1' * 110, '']:
+            self.assertEqual(bip32_key_from_base58(utf8(b), byref(ext_key())), WALLY_EINVAL)
+        self.assertEqual(bip32_key_from_base58(None, byref(ext_key())), WALLY_EINVAL)
+        self.assertEqual(bip32_key_from_base58(utf8(out), None), WALLY_EINVAL)
+
+        # A valid checksum over an invalid version is rejected
+        self.assertEqual(bip32_key_serialize(key, FLAG_KEY_PUBLIC, buf, buf_len), WALLY_OK)
+        buf = bytearray(buf)
+        buf[3] ^= 1
+        ret, bad = wally_base58_from_bytes(bytes(buf), buf_len, 1)
+        self.assertEqual((ret, len(bad)), (WALLY_OK, 111))
+        self.assertEqual(bip32_key_from_base58(utf8(bad), byref(ext_key())), WALLY_EINVAL)
+
+    def test_base58_batch(self):
+        master, pub, _ = self.create_master_pub_priv()
+        n = 19 # More than one batch, with a partial final batch
+        keys = (ext_key * n)()
+        for i in range(n):
+            keys[i] = self.derive_key(master, i * 0x1234567, FLAG_KEY_PRIVATE)
+        buf, buf_len = make_cbuffer('00' * 78)
+        str_len = 111 + 1
+
+        for flag in [FLAG_KEY_PRIVATE, FLAG_KEY_PUBLIC]:
+            expected_bytes, expected_strs = bytearray(), b''
+            for i in range(n):
+                self.assertEqual(bip32_key_serialize(keys[i], flag, buf, buf_len), WALLY_OK)
+                ret, out = bip32_key_to_base58(keys[i], flag)
+                self.assertEqual(ret, WALLY_OK)
+                expected_bytes += buf
+                expected_strs += utf8(out) + b'\0'
+
+            for want_bytes in [True, False]:
+                bytes_out, bytes_len = make_cbuffer('ff' * 78 * n) if want_bytes else (None, 0)
+                out, out_len = make_cbuffer('ff' * str_len * n)
+                ret, written = bip32_key_to_base58_batch(keys, n, flag, bytes_out, bytes_len,
+                                                         out, out_len)
+                self.assertEqual((ret, written, out), (WALLY_OK, str_len * n, expected_strs))
+                if want_bytes:
+                    self.assertEqual(bytes_out, expected_bytes)
+
+            # Short output buffer returns the required length
+            ret, written = bip32_key_to_base58_batch(keys, n, flag, None, 0, out, out_len - 1)
+            self.assertEqual((ret, written), (WALLY_OK, str_len * n))
+
+        # A key that cannot be serialized fails the batch and clears the output
+        keys[5] = pub
+        bytes_out, bytes_len = make_cbuffer('ff' * 78 * n)
+        out, out_len = make_cbuffer('ff' * str_len * n)
+        ret, written = bip32_key_to_base58_batch(keys, n, FLAG_KEY_PRIVATE, bytes_out, bytes_len,
+                                                 out, out_len)
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        self.assertEqual((bytes_out, out), (b'\0' * bytes_len, b'\0' * out_len))
+
+        # Invalid arguments
+        for k, num, flag, b, b_len, o in [(None, n,     0,               None,      0,            out),
+                                          (keys, 0,     0,               None,      0,            out),
+                                          (keys, n,     0x4,             None,      0,            out),
+                                          (keys, n,     0,               bytes_out, bytes_len - 1, out),
+                                          (keys, n,     0,               None,      bytes_len,    out),
+                                          (keys, n,     0,               None,      0,            None)]:
+            ret, written = bip32_key_to_base58_batch(k, num, flag, b, b_len, o, out_len)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
 
 if __name__ == '__main__':
     unittest.main()
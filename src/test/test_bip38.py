@@ -73,6 +73,15 @@ class BIP38Tests(unittest.TestCase):
             bip38 = bip38.decode('utf-8') if type(bip38) is bytes else bip38
             self.assertEqual(bip38, expected)
 
+            if flags <= K_RAW:
+                priv, p_len = make_cbuffer(priv_key)
+                out = create_string_buffer(len(expected) + 1)
+                for l in [len(out) - 1, len(out)]:
+                    ret, written = bip38_from_private_key_to_buffer(
+                        priv, p_len, passwd, len(passwd), flags, out, l)
+                    self.assertEqual((ret, written), (WALLY_OK, len(out)))
+                self.assertEqual(out.value, utf8(expected))
+
             ret, new_priv_key = self.to_priv(bip38, passwd, flags)
             self.assertEqual(ret, WALLY_OK)
             self.assertEqual(h(new_priv_key).upper(), utf8(priv_key))
@@ -80,6 +89,79 @@ class BIP38Tests(unittest.TestCase):
             self.assertEqual(ret, WALLY_OK)
 
 
+    def test_bip38_batch(self):
+        from ctypes import c_char_p
+        priv_keys = [cases[0][0], cases[3][0], cases[0][0]]
+        passwd = utf8(cases[0][1])
+        bip38 = [utf8(cases[0][3]), utf8(cases[3][3]), utf8(cases[0][3])]
+        n = len(bip38)
+        c_bip38 = (c_char_p * n)(*bip38)
+        expected = utf8(''.join(priv_keys))
+
+        for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+            out_buf, out_len = make_cbuffer('00' * 32 * n)
+            ret = bip38_to_private_key_batch(c_bip38, n, passwd, len(passwd),
+                                             K_MAIN, run_fn, None, out_buf, out_len)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertEqual(h(out_buf).upper(), expected)
+
+        # A bad password for any key fails the batch and clears the output
+        bad_bip38 = (c_char_p * 2)(bip38[0], utf8(cases[1][3]))
+        out_buf, out_len = make_cbuffer('00' * 32 * 2)
+        ret = bip38_to_private_key_batch(bad_bip38, 2, passwd, len(passwd),
+                                         K_MAIN, run_tasks_threaded, None, out_buf, out_len)
+        self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(h(out_buf), utf8('00' * 32 * 2))
+
+        null_bip38 = (c_char_p * 2)(bip38[0], None)
+        out_buf, out_len = make_cbuffer('00' * 32 * n)
+        no_run = run_tasks_fn_t()
+        for args in [(None,      n, out_buf, out_len),      # Null addresses
+                     (null_bip38, 2, out_buf, 64),          # Null address
+                     (c_bip38,   0, out_buf, 0),            # No addresses
+                     (c_bip38,   n, None,    out_len),      # Null output
+                     (c_bip38,   n, out_buf, out_len - 1)]: # Bad length
+            ret = bip38_to_private_key_batch(args[0], args[1], passwd, len(passwd),
+                                             K_MAIN, no_run, None, args[2], args[3])
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_bip38_async(self):
+        from ctypes import c_void_p
+        priv_key, passwd, _, bip38 = cases[0]
+        passwd, bip38 = utf8(passwd), utf8(bip38)
+        results = []
+        done_fn = async_done_fn_t(lambda ctx, ret: results.append(ret))
+        tasks = AsyncTasks(threaded=True)
+
+        for submit_fn in [None, tasks.submit_fn]:
+            set_submit_fn(submit_fn)
+            try:
+                for p, expected in [(passwd, WALLY_OK), (utf8('bad'), WALLY_EINVAL)]:
+                    del results[:]
+                    op, out_buf = c_void_p(), create_string_buffer(32)
+                    ret = bip38_to_private_key_async(bip38, p, len(p), K_MAIN,
+                                                     out_buf, 32, done_fn, None,
+                                                     byref(op))
+                    self.assertEqual(ret, WALLY_OK)
+                    tasks.run()
+                    self.assertEqual(wally_async_poll(op), (expected, 1))
+                    self.assertEqual(results, [expected])
+                    if expected == WALLY_OK:
+                        self.assertEqual(h(out_buf).upper(), utf8(priv_key))
+                    else:
+                        self.assertEqual(out_buf.raw, b'\0' * 32)
+                    self.assertEqual(wally_async_free(op), WALLY_OK)
+            finally:
+                set_submit_fn(None)
+
+        op = c_void_p()
+        for args in [(None, passwd, out_buf, byref(op)),  # Null address
+                     (bip38, None, out_buf, byref(op)),   # Null password
+                     (bip38, passwd, out_buf, None)]:     # Null output
+            ret = bip38_to_private_key_async(args[0], args[1], len(passwd), K_MAIN,
+                                             args[2], 32, done_fn, None, args[3])
+            self.assertEqual((ret, op.value), (WALLY_EINVAL, None))
+
     def test_bip38_invalid(self):
         priv_key = 'CBF4B9F70470856BB4F40F80B87EDB90865997FFEE6DF315AB166D713AF433A5'
         passwd = utf8('TestingInvalidFlags')
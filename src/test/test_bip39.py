@@ -1,5 +1,6 @@
 import unittest
 from util import *
+import util
 import json
 
 
@@ -41,6 +42,11 @@ class BIP39Tests(unittest.TestCase):
 
         self.assertEqual(len(all_langs), len(list(self.langs.keys())))
 
+        out = create_string_buffer(64)
+        ret, written = bip39_get_languages_to_buffer(out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, len(out.value) + 1))
+        self.assertEqual(out.value.split(), [utf8(l) for l in all_langs])
+
 
     def test_bip39_wordlists(self):
 
@@ -62,11 +68,22 @@ class BIP39Tests(unittest.TestCase):
                 word = word.encode('utf-8')
                 self.assertEqual(ret, 0)
                 self.assertEqual(word, utf8(words_list[i]))
+                out = create_string_buffer(len(word) + 1)
+                for l in [len(out) - 1, len(out)]:
+                    ret, written = bip39_get_word_to_buffer(wl, i, out, l)
+                    self.assertEqual((ret, written), (WALLY_OK, len(out)))
+                self.assertEqual(out.value, word)
                 if wordlist_lookup_word is not None:
                     idx = wordlist_lookup_word(wl, word)
                     self.assertEqual(i, idx - 1)
+                    # Words not in the list are not found
+                    for missing in [word[:-1], word + utf8('a'), utf8('a') + word]:
+                        if missing.decode('utf-8', 'ignore') not in words_list:
+                            self.assertEqual(wordlist_lookup_word(wl, missing), 0)
 
         self.assertEqual(bip39_get_word(wl, 2048), (WALLY_EINVAL, None))
+        out = create_string_buffer(16)
+        self.assertEqual(bip39_get_word_to_buffer(wl, 2048, out, len(out)), (WALLY_EINVAL, 0))
 
 
     def test_bip39_vectors(self):
@@ -83,6 +100,12 @@ class BIP39Tests(unittest.TestCase):
             self.assertEqual(result, mnemonic)
             self.assertEqual(bip39_mnemonic_validate(wl, mnemonic), 0)
 
+            out = create_string_buffer(len(result) + 1)
+            for l in [len(out) - 1, len(out)]:
+                ret, written = bip39_mnemonic_from_bytes_to_buffer(wl, buf, buf_len, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(out)))
+            self.assertEqual(out.value, result)
+
             out_buf = create_string_buffer(buf_len)
             ret, rlen = bip39_mnemonic_to_bytes(wl, result, out_buf, buf_len)
             self.assertEqual(ret, 0)
@@ -107,6 +130,203 @@ class BIP39Tests(unittest.TestCase):
         self.assertEqual(h(out_buf).upper(), utf8(expected))
 
 
+    def test_validate_no_alloc(self):
+        """ Test mnemonic validation and decoding do not allocate """
+        mnemonic = self.cases[0][1]
+        buf, buf_len = make_cbuffer(self.cases[0][0])
+        out_buf = create_string_buffer(16)
+        word = utf8('abandon')
+        for lang in ['en', 'es']:
+            wl = self.wordlists[lang]
+            ret, words = bip39_mnemonic_from_bytes(wl, buf, buf_len)
+            self.assertEqual(ret, WALLY_OK)
+            words = utf8(words)
+            util._fail_malloc_counter = 0
+            self.assertEqual(bip39_mnemonic_validate(wl, words), WALLY_OK)
+            self.assertEqual(bip39_mnemonic_to_bytes(wl, words, out_buf, 16), (WALLY_OK, 16))
+            self.assertEqual(util._fail_malloc_counter, 0)
+
+        # Words are split on single spaces, so extra spaces are invalid
+        for bad in [utf8(' ') + mnemonic, mnemonic + utf8(' '),
+                    mnemonic.replace(word, word + utf8(' '), 1),
+                    mnemonic.replace(word, word[:-1], 1),
+                    mnemonic.replace(word, word + utf8('s'), 1),
+                    utf8(''), None]:
+            self.assertEqual(bip39_mnemonic_validate(None, bad), WALLY_EINVAL)
+
+
+    def test_input_limit(self):
+        """ Test the mnemonic input length limit """
+        LIMIT_MNEMONIC_LEN = 3
+        mnemonic = self.cases[0][1]
+        out_buf = create_string_buffer(16)
+        try:
+            for limit, expected in [(len(mnemonic), WALLY_OK),
+                                    (len(mnemonic) - 1, WALLY_EINVAL)]:
+                self.assertEqual(wally_set_input_limit(LIMIT_MNEMONIC_LEN, limit), WALLY_OK)
+                self.assertEqual(bip39_mnemonic_validate(None, mnemonic), expected)
+                ret, _ = bip39_mnemonic_to_bytes(None, mnemonic, out_buf, 16)
+                self.assertEqual(ret, expected)
+        finally:
+            wally_set_input_limit(LIMIT_MNEMONIC_LEN, 0)
+        self.assertEqual(bip39_mnemonic_validate(None, mnemonic), WALLY_OK)
+
+    def test_detect_languages(self):
+        """ Test detecting the languages a mnemonic is valid for """
+        ret, all_langs = bip39_get_languages()
+        self.assertEqual(ret, WALLY_OK)
+        all_langs = all_langs.split()
+
+        def expected_mask(mnemonic):
+            mask = 0
+            for i, lang in enumerate(all_langs):
+                if bip39_mnemonic_validate(self.wordlists[lang], mnemonic) == WALLY_OK:
+                    mask |= 1 << i
+            return mask
+
+        mnemonics = [case[1] for case in self.cases]
+        for i, lang in enumerate(all_langs):
+            for case in self.cases[:4]:
+                buf, buf_len = make_cbuffer(case[0])
+                ret, mnemonic = bip39_mnemonic_from_bytes(self.wordlists[lang], buf, buf_len)
+                self.assertEqual(ret, WALLY_OK)
+                mnemonics.append(utf8(mnemonic))
+        # Chinese lists share many characters, so find some overlapping mnemonics
+        zhs, zht = self.wordlists['zhs'], self.wordlists['zht']
+        for i in range(300):
+            buf, buf_len = make_cbuffer('%064x' % (i * 0x9e3779b97f4a7c15))
+            ret, mnemonic = bip39_mnemonic_from_bytes(zhs, buf, 16)
+            self.assertEqual(ret, WALLY_OK)
+            mnemonics.append(utf8(mnemonic))
+
+        num_overlapping = 0
+        for mnemonic in mnemonics:
+            util._fail_malloc_counter = 0
+            ret, mask = bip39_mnemonic_detect_languages(mnemonic)
+            self.assertEqual(util._fail_malloc_counter, 0)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertNotEqual(mask, 0)
+            self.assertEqual(mask, expected_mask(mnemonic))
+            num_overlapping += bin(mask).count('1') > 1
+        self.assertGreater(num_overlapping, 0)
+
+        for bad in [utf8(''), utf8('abandon'), mnemonics[0] + utf8(' '),
+                    mnemonics[0].replace(utf8('abandon'), utf8('zzz'), 1),
+                    utf8(' '.join(['abandon'] * 33))]:
+            self.assertEqual(bip39_mnemonic_detect_languages(bad), (WALLY_OK, 0))
+        self.assertEqual(bip39_mnemonic_detect_languages(None), (WALLY_EINVAL, 0))
+
+
+    def test_mnemonic_recover(self):
+        """ Test recovering a mnemonic with a wrong or missing word """
+        P2PKH, P2SH, P2WPKH = 0x2, 0x4, 0x8
+        REPLACE, INSERT = 0x1, 0x2
+        wl = self.wordlists['en']
+        words_list, _ = load_words('english')
+        idx = lambda word: words_list.index(word.decode('utf-8'))
+        buf, buf_len = make_cbuffer('5a' * 16)
+        ret, mnemonic = bip39_mnemonic_from_bytes(wl, buf, buf_len)
+        self.assertEqual(ret, WALLY_OK)
+        mnemonic = utf8(mnemonic)
+        words = mnemonic.split()
+        path = (c_uint * 5)(0x80000054, 0x80000000, 0x80000000, 0, 0)
+
+        def first_address_hash(m, passphrase=None):
+            seed = create_string_buffer(64)
+            self.assertEqual(bip39_mnemonic_to_seed(m, passphrase, seed, 64), (WALLY_OK, 64))
+            master, key = ext_key(), ext_key()
+            self.assertEqual(bip32_key_from_seed(seed, 64, 0x0488ADE4, 0, byref(master)), WALLY_OK)
+            self.assertEqual(bip32_key_from_parent_path(byref(master), path, 5, 0, byref(key)), WALLY_OK)
+            return bytes(key.hash160)
+
+        def recover(m, flags, passphrase=None, hashes=None, script_types=0, run_fn=None):
+            out = (c_uint * 8192)()
+            hashes_len = len(hashes) if hashes else 0
+            p, p_len = (path, 5) if hashes else (None, 0)
+            ret, written = bip39_mnemonic_recover(wl, m, flags, passphrase, p, p_len,
+                                                  hashes, hashes_len, script_types,
+                                                  run_fn or run_tasks_fn_t(), None,
+                                                  out, len(out))
+            self.assertEqual(ret, WALLY_OK)
+            return [(c // 2048, c % 2048) for c in out[:written]]
+
+        def apply_fix(m_words, fix, insert=False):
+            pos, i = fix
+            ret, word = bip39_get_word(wl, i)
+            self.assertEqual(ret, WALLY_OK)
+            fixed = list(m_words)
+            if insert:
+                fixed.insert(pos, utf8(word))
+            else:
+                fixed[pos] = utf8(word)
+            return utf8(' ').join(fixed)
+
+        target = first_address_hash(mnemonic)
+
+        # A marked word at a known position: every candidate has a valid checksum
+        marked = list(words)
+        marked[5] = utf8('?')
+        fixes = recover(utf8(' ').join(marked), 0)
+        num_marked_fixes = len(fixes)
+        self.assertEqual(fixes, sorted(fixes))
+        self.assertTrue(all([pos == 5 for pos, _ in fixes]))
+        for fix in fixes:
+            self.assertEqual(bip39_mnemonic_validate(wl, apply_fix(marked, fix)), WALLY_OK)
+        self.assertIn((5, idx(words[5])), fixes)
+        for run_fn in [None, run_tasks_threaded]:
+            self.assertEqual(recover(utf8(' ').join(marked), 0, None, target, P2WPKH, run_fn),
+                             [(5, idx(words[5]))])
+        # The wrong passphrase matches nothing
+        self.assertEqual(recover(utf8(' ').join(marked), 0, utf8('x'), target, P2WPKH | P2SH), [])
+
+        # A misspelt last word and a changed word at an unknown position
+        misspelt = list(words)
+        misspelt[11] = misspelt[11] + utf8('x')
+        fixes = recover(utf8(' ').join(misspelt), 0)
+        # The last word holds the 4 checksum bits, so 1 in 16 are valid
+        self.assertEqual(len(fixes), 2048 // 16)
+        self.assertIn((11, idx(words[11])), fixes)
+        wrong = list(words)
+        wrong[3] = utf8('zoo') if words[3] != utf8('zoo') else utf8('abandon')
+        wrong = utf8(' ').join(wrong)
+        fixes = recover(wrong, REPLACE)
+        self.assertIn((3, idx(words[3])), fixes)
+        self.assertTrue(all([bip39_mnemonic_validate(wl, apply_fix(wrong.split(), f)) == WALLY_OK
+                             for f in fixes]))
+
+        # A missing word at an unknown position
+        missing = utf8(' ').join(words[:7] + words[8:])
+        fixes = recover(missing, INSERT)
+        self.assertIn((7, idx(words[7])), fixes)
+        for fix in fixes:
+            fixed = apply_fix(missing.split(), fix, True)
+            self.assertEqual(bip39_mnemonic_validate(wl, fixed), WALLY_OK)
+
+        out = (c_uint * 2)()
+        for args in [
+            (wl, None, 0, None, None, 0, None, 0, 0), # Empty mnemonic
+            (wl, mnemonic, 0, None, None, 0, None, 0, 0), # Nothing to recover
+            (wl, mnemonic, 3, None, None, 0, None, 0, 0), # Both flags
+            (wl, mnemonic, 4, None, None, 0, None, 0, 0), # Unknown flag
+            (wl, utf8(' ').join(marked[:11]), 0, None, None, 0, None, 0, 0), # Bad length
+            (wl, mnemonic.replace(utf8('pave'), utf8('?'), 1).replace(utf8('worth'), utf8('?')),
+             0, None, None, 0, None, 0, 0), # Two unknown words
+            (wl, utf8(' ').join(marked), INSERT, None, None, 0, None, 0, 0), # Insert with unknown
+            (wl, utf8(' ').join(marked), 0, utf8('x'), None, 0, None, 0, 0), # Passphrase, no hashes
+            (wl, utf8(' ').join(marked), 0, None, path, 5, None, 0, 0), # Path, no hashes
+            (wl, utf8(' ').join(marked), 0, None, None, 0, target, 19, P2PKH), # Bad hashes_len
+            (wl, utf8(' ').join(marked), 0, None, None, 0, target, 20, 0), # No script types
+            (wl, utf8(' ').join(marked), 0, None, None, 0, target, 20, 0x10), # Bad script type
+            (wl, utf8(' ').join(marked), 0, None, None, 0, None, 0, P2PKH), # Types, no hashes
+            ]:
+            ret = bip39_mnemonic_recover(*args, run_tasks_fn_t(), None, out, 2)
+            self.assertEqual(ret, (WALLY_EINVAL, 0))
+        # Too short an output buffer returns the required length
+        ret = bip39_mnemonic_recover(wl, utf8(' ').join(marked), 0, None, None, 0, None, 0, 0,
+                                     run_tasks_fn_t(), None, out, 2)
+        self.assertEqual(ret, (WALLY_OK, num_marked_fixes))
+
+
     def test_mnemonic_to_seed(self):
 
         for case in self.cases:
@@ -119,5 +339,90 @@ class BIP39Tests(unittest.TestCase):
             self.assertEqual(h(buf), seed)
 
 
+    def test_mnemonic_to_seed_async(self):
+        from ctypes import c_void_p
+        results = []
+        done_fn = async_done_fn_t(lambda ctx, ret: results.append(ret))
+        tasks = AsyncTasks()
+        mnemonic, seed = self.cases[0][1], self.cases[0][2]
+
+        for submit_fn in [None, tasks.submit_fn]:
+            set_submit_fn(submit_fn)
+            try:
+                for passphrase in [b'TREZOR', None, b'']:
+                    del results[:]
+                    op, buf = c_void_p(), create_string_buffer(64)
+                    ret = bip39_mnemonic_to_seed_async(mnemonic, passphrase, buf, 64,
+                                                       done_fn, None, byref(op))
+                    self.assertEqual(ret, WALLY_OK)
+                    tasks.run()
+                    self.assertEqual(wally_async_poll(op), (WALLY_OK, 1))
+                    self.assertEqual(results, [WALLY_OK])
+                    expected = create_string_buffer(64)
+                    ret, _ = bip39_mnemonic_to_seed(mnemonic, passphrase, expected, 64)
+                    self.assertEqual(buf.raw, expected.raw)
+                    if passphrase:
+                        self.assertEqual(h(buf), seed)
+                    self.assertEqual(wally_async_free(op), WALLY_OK)
+            finally:
+                set_submit_fn(None)
+
+        # Invalid lengths are reported as the result
+        op, buf = c_void_p(), create_string_buffer(64)
+        ret = bip39_mnemonic_to_seed_async(mnemonic, None, buf, 63,
+                                           done_fn, None, byref(op))
+        self.assertEqual((ret, wally_async_poll(op)), (WALLY_OK, (WALLY_EINVAL, 1)))
+        self.assertEqual(wally_async_free(op), WALLY_OK)
+        for args in [(None, buf, byref(op)),   # Null mnemonic
+                     (mnemonic, None, byref(op)), # Null output
+                     (mnemonic, buf, None)]:    # Null operation
+            ret = bip39_mnemonic_to_seed_async(args[0], None, args[1], 64,
+                                               done_fn, None, args[2])
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_mnemonic_to_seed_batch(self):
+        from ctypes import c_char_p
+        mnemonics = [case[1] for case in self.cases]
+        seeds = b''.join([unhexlify(case[2]) for case in self.cases])
+        n = len(mnemonics)
+        c_mnemonics = (c_char_p * n)(*mnemonics)
+
+        # All with the same passphrase, matching the test vectors
+        c_passphrases = (c_char_p * n)(*([b'TREZOR'] * n))
+        buf = create_string_buffer(64 * n)
+        ret, count = bip39_mnemonic_to_seed_batch(c_mnemonics, c_passphrases,
+                                                  n, buf, 64 * n)
+        self.assertEqual((ret, count), (WALLY_OK, 64 * n))
+        self.assertEqual(buf.raw, seeds)
+
+        # Mixed passphrases, including none, match individual conversion
+        for passphrases in [None, [b'TREZOR', None, b'', b'x' * 200] * n]:
+            for num in [1, 3, 4, 5, n]:
+                c_pass = None
+                if passphrases is not None:
+                    c_pass = (c_char_p * num)(*passphrases[:num])
+                buf = create_string_buffer(64 * num)
+                ret, count = bip39_mnemonic_to_seed_batch(c_mnemonics, c_pass,
+                                                          num, buf, 64 * num)
+                self.assertEqual((ret, count), (WALLY_OK, 64 * num))
+                for i in range(num):
+                    p = None if passphrases is None else passphrases[i]
+                    expected = create_string_buffer(64)
+                    ret, _ = bip39_mnemonic_to_seed(mnemonics[i], p, expected, 64)
+                    self.assertEqual(ret, WALLY_OK)
+                    self.assertEqual(buf.raw[i * 64:(i + 1) * 64], expected.raw)
+
+        null_mnemonics = (c_char_p * 2)(mnemonics[0], None)
+        buf = create_string_buffer(64 * n)
+        for args in [(None,           None, n, buf,  64 * n),     # Null mnemonics
+                     (null_mnemonics, None, 2, buf,  128),        # Null mnemonic
+                     (c_mnemonics,    None, 0, buf,  0),          # No mnemonics
+                     (c_mnemonics,    None, n, None, 64 * n),     # Null output
+                     (c_mnemonics,    None, n, buf,  64 * n - 1), # Bad length
+                     (c_mnemonics,    None, n, buf,  64 * n + 64)]: # Bad length
+            ret, count = bip39_mnemonic_to_seed_batch(*args)
+            self.assertEqual((ret, count), (WALLY_EINVAL, 0))
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -90,10 +90,151 @@ class HashTests(unittest.TestCase):
                         self.assertEqual(result, expected)
 
 
+    def test_cpu_features(self):
+        """The CPU specific implementations selected match the CPU"""
+        import platform
+        (SHA256_SSE4, SHA256_SHANI, SHA256_AVX2, SHA256_ARMV8, SHA512_AVX2,
+         SHA512_ARMV8, AES_NI, AES_ARMV8, HEX_SSSE3, SCRYPT_SSE2, SCRYPT_NEON,
+         SCRYPT_AVX2, SCRYPT_AVX512, SHA512_SSSE3, SHA512_AVX2_BMI2,
+         RIPEMD160_AVX2, BASE64_AVX2, BASE64_NEON, SHA256_SIMD128,
+         HEX_SIMD128) = [1 << i for i in range(20)]
+        value = c_ulonglong()
+        self.assertEqual(wally_get_cpu_features(None), WALLY_EINVAL)
+        wally_init(0)
+        self.assertEqual(wally_get_cpu_features(byref(value)), WALLY_OK)
+        features = value.value
+        self.assertEqual(features & ~((1 << 20) - 1), 0)
+        # Implementations of the same operation are never selected together
+        for exclusive in [SHA256_SSE4 | SHA256_SHANI, SHA256_SHANI | SHA256_AVX2,
+                          AES_NI | AES_ARMV8, SCRYPT_AVX2 | SCRYPT_AVX512,
+                          SCRYPT_SSE2 | SCRYPT_NEON, SHA512_SSSE3 | SHA512_AVX2_BMI2,
+                          SHA512_ARMV8 | SHA512_SSSE3, BASE64_AVX2 | BASE64_NEON]:
+            self.assertNotEqual(features & exclusive, exclusive)
+
+        if platform.machine() not in ['x86_64', 'AMD64']:
+            return
+        self.assertEqual(features & (SHA256_ARMV8 | SHA512_ARMV8 | AES_ARMV8 |
+                                     SCRYPT_NEON | BASE64_NEON | SHA256_SIMD128 |
+                                     HEX_SIMD128), 0)
+        self.assertTrue(features & SCRYPT_SSE2)
+        try:
+            with open('/proc/cpuinfo') as f:
+                flags = [l for l in f if l.startswith('flags')][0].split()
+        except (IOError, IndexError):
+            return # Can't determine the CPU flags to compare against
+        has = lambda f, feature: self.assertEqual(f in flags, bool(features & feature))
+        has('ssse3', HEX_SSSE3)
+        has('aes', AES_NI)
+        has('sha_ni', SHA256_SHANI)
+        has('avx512f', SCRYPT_AVX512)
+        has('avx2', BASE64_AVX2)
+        if 'sha_ni' not in flags:
+            has('sse4_1', SHA256_SSE4)
+            has('avx2', SHA256_AVX2)
+        self.assertEqual('avx2' in flags, bool(features & SHA512_AVX2))
+        has('avx2', RIPEMD160_AVX2)
+        avx2_bmi2 = 'avx2' in flags and 'bmi2' in flags
+        self.assertEqual(avx2_bmi2, bool(features & SHA512_AVX2_BMI2))
+        self.assertEqual('ssse3' in flags and not avx2_bmi2, bool(features & SHA512_SSSE3))
+
     def test_sha_vectors(self):
-        self. _do_test_sha_vectors()
-        wally_init(0) # Enable optimized SHA256 and re-test
-        self. _do_test_sha_vectors()
+        for _ in optimized_runs():
+            self._do_test_sha_vectors()
+
+
+    def test_sha256_lengths(self):
+        """Test multi-block inputs against hashlib, optimized and not"""
+        import hashlib
+        data = bytes([(i * 7) & 0xff for i in range(64 * 9)])
+        for _ in optimized_runs():
+            for n in range(0, len(data), 7):
+                result = self.do_hash(wally_sha256, data[:n].hex())
+                self.assertEqual(result, utf8(hashlib.sha256(data[:n]).hexdigest()))
+
+
+    def test_sha512_lengths(self):
+        """Test multi-block inputs against hashlib, optimized and not"""
+        import hashlib
+        data = bytes([(i * 7) & 0xff for i in range(128 * 9)])
+        for _ in optimized_runs():
+            for n in range(0, len(data), 13):
+                result = self.do_hash(wally_sha512, data[:n].hex())
+                self.assertEqual(result, utf8(hashlib.sha512(data[:n]).hexdigest()))
+
+
+    def test_sha256_batch(self):
+        """Test batch hashing against hashlib, optimized and not"""
+        import hashlib
+        sha256 = lambda m: hashlib.sha256(m).digest()
+        sha256d = lambda m: sha256(sha256(m))
+        for _ in optimized_runs():
+            for item_len in [1, 32, 55, 56, 63, 64, 65, 119, 120, 200]:
+                for count in [1, 7, 8, 9, 17]:
+                    data = bytes([(i * 13 + count) & 0xff for i in range(item_len * count)])
+                    items = [data[i * item_len:(i + 1) * item_len] for i in range(count)]
+                    out_len = count * self.SHA256_LEN
+                    for fn, ref in [(wally_sha256_batch, sha256),
+                                    (wally_sha256d_batch, sha256d)]:
+                        expected = b''.join([ref(m) for m in items])
+                        for aligned in [True, False]:
+                            buf = create_string_buffer(out_len + 1)
+                            out = byref(buf, 0 if aligned else 1)
+                            ret = fn(data, len(data), item_len, out, out_len)
+                            self.assertEqual(ret, WALLY_OK)
+                            self.assertEqual(buf.raw[0 if aligned else 1:][:out_len], expected)
+                        if item_len >= self.SHA256_LEN:
+                            # Hashing in place
+                            buf = create_string_buffer(data, len(data))
+                            ret = fn(buf, len(data), item_len, buf, out_len)
+                            self.assertEqual(ret, WALLY_OK)
+                            self.assertEqual(buf.raw[:out_len], expected)
+
+        data = bytes(64 * 2)
+        buf = create_string_buffer(self.SHA256_LEN * 2)
+        for fn in [wally_sha256_batch, wally_sha256d_batch]:
+            for args in [(None, 128, 64, buf,  64), # Null input
+                         (data, 0,   64, buf,  64), # Empty input
+                         (data, 128, 0,  buf,  64), # Zero item length
+                         (data, 127, 64, buf,  64), # Not a multiple of item length
+                         (data, 128, 64, None, 64), # Null output
+                         (data, 128, 64, buf,  32), # Output too short
+                         (data, 128, 64, buf,  65)]: # Output too long
+                self.assertEqual(fn(*args), WALLY_EINVAL)
+
+
+    def test_hash160_batch(self):
+        """Test batch hash160 against single hashing, optimized and not"""
+        hash160 = lambda m: bytes.fromhex(self.do_hash(wally_hash160, m.hex()).decode())
+        for _ in optimized_runs():
+            for item_len in [1, 20, 33, 65, 100]:
+                for count in [1, 7, 8, 9, 17, 64, 65, 130]:
+                    data = bytes([(i * 11 + count) & 0xff for i in range(item_len * count)])
+                    items = [data[i * item_len:(i + 1) * item_len] for i in range(count)]
+                    expected = b''.join([hash160(m) for m in items])
+                    out_len = count * self.HASH160_LEN
+                    for aligned in [True, False]:
+                        buf = create_string_buffer(out_len + 1)
+                        out = byref(buf, 0 if aligned else 1)
+                        ret = wally_hash160_batch(data, len(data), item_len, out, out_len)
+                        self.assertEqual(ret, WALLY_OK)
+                        self.assertEqual(buf.raw[0 if aligned else 1:][:out_len], expected)
+                    if item_len >= self.HASH160_LEN:
+                        # Hashing in place
+                        buf = create_string_buffer(data, len(data))
+                        ret = wally_hash160_batch(buf, len(data), item_len, buf, out_len)
+                        self.assertEqual(ret, WALLY_OK)
+                        self.assertEqual(buf.raw[:out_len], expected)
+
+        data = bytes(33 * 2)
+        buf = create_string_buffer(self.HASH160_LEN * 2)
+        for args in [(None, 66, 33, buf,  40), # Null input
+                     (data, 0,  33, buf,  40), # Empty input
+                     (data, 66, 0,  buf,  40), # Zero item length
+                     (data, 65, 33, buf,  40), # Not a multiple of item length
+                     (data, 66, 33, None, 40), # Null output
+                     (data, 66, 33, buf,  20), # Output too short
+                     (data, 66, 33, buf,  41)]: # Output too long
+            self.assertEqual(wally_hash160_batch(*args), WALLY_EINVAL)
 
 
     def test_hash160_vectors(self):
@@ -113,6 +254,95 @@ class HashTests(unittest.TestCase):
                 self.assertEqual(fn(args[0], args[1], args[2], args[3]),
                                  WALLY_EINVAL)
 
+    def _siphash24(self, key, msg):
+        """Reference SipHash-2-4 implementation"""
+        mask = (1 << 64) - 1
+        rotl = lambda x, b: ((x << b) | (x >> (64 - b))) & mask
+        def sipround(v):
+            v[0] = (v[0] + v[1]) & mask; v[1] = rotl(v[1], 13) ^ v[0]; v[0] = rotl(v[0], 32)
+            v[2] = (v[2] + v[3]) & mask; v[3] = rotl(v[3], 16) ^ v[2]
+            v[0] = (v[0] + v[3]) & mask; v[3] = rotl(v[3], 21) ^ v[0]
+            v[2] = (v[2] + v[1]) & mask; v[1] = rotl(v[1], 17) ^ v[2]; v[2] = rotl(v[2], 32)
+        k0, k1 = int.from_bytes(key[:8], 'little'), int.from_bytes(key[8:], 'little')
+        v = [k0 ^ 0x736f6d6570736575, k1 ^ 0x646f72616e646f6d,
+             k0 ^ 0x6c7967656e657261, k1 ^ 0x7465646279746573]
+        padded = msg + b'\x00' * (7 - len(msg) % 8) + bytes([len(msg) & 0xff])
+        for i in range(0, len(padded), 8):
+            m = int.from_bytes(padded[i:i + 8], 'little')
+            v[3] ^= m
+            sipround(v); sipround(v)
+            v[0] ^= m
+        v[2] ^= 0xff
+        for i in range(4):
+            sipround(v)
+        return v[0] ^ v[1] ^ v[2] ^ v[3]
+
+    def test_siphash24(self):
+        """Test SipHash-2-4 against the reference vectors"""
+        key = bytes(range(16))
+        value = c_ulonglong()
+        # Vectors from the SipHash paper and reference implementation
+        for msg_len, expected in [(0, 0x726fdb47dd0e0e31), (15, 0xa129ca6149be45e5)]:
+            msg = bytes(range(msg_len))
+            self.assertEqual(wally_siphash24(key, len(key), msg, msg_len, value), WALLY_OK)
+            self.assertEqual(value.value, expected)
+        for msg_len in range(65):
+            msg = bytes(range(msg_len))
+            self.assertEqual(wally_siphash24(key, len(key), msg, msg_len, value), WALLY_OK)
+            self.assertEqual(value.value, self._siphash24(key, msg))
+
+        for args in [(None, 16, key, 1, value),  # Missing key
+                     (key,  15, key, 1, value),  # Bad key length
+                     (key,  16, None, 1, value), # Missing bytes
+                     (key,  16, key, 1, None)]:  # Missing output
+            self.assertEqual(wally_siphash24(*args), WALLY_EINVAL)
+        self.assertEqual(wally_siphash24(key, 16, None, 0, value), WALLY_OK)
+        self.assertEqual(value.value, 0x726fdb47dd0e0e31)
+
+    def test_streaming(self):
+        """Test incremental hashing against the one-shot functions"""
+        from ctypes import c_void_p, byref
+        msg = bytes([(i * 31) & 0xff for i in range(1000)])
+        one_shot = [(wally_sha256, wally_sha256_final, self.SHA256_LEN),
+                    (wally_sha256d, wally_sha256d_final, self.SHA256_LEN),
+                    (wally_hash160, wally_hash160_final, self.HASH160_LEN)]
+        sha256_ctx, sha512_ctx = c_void_p(), c_void_p()
+        self.assertEqual(wally_sha256_init_alloc(byref(sha256_ctx)), WALLY_OK)
+        self.assertEqual(wally_sha512_init_alloc(byref(sha512_ctx)), WALLY_OK)
+        fns = [(fn, final_fn, out_len, sha256_ctx, wally_sha256_update)
+               for fn, final_fn, out_len in one_shot]
+        fns.append((wally_sha512, wally_sha512_final, self.SHA512_LEN,
+                    sha512_ctx, wally_sha512_update))
+
+        for fn, final_fn, out_len, ctx, update_fn in fns:
+            for msg_len in [0, 1, 55, 64, 127, 128, 1000]:
+                expected = create_string_buffer(out_len)
+                self.assertEqual(fn(msg[:msg_len], msg_len, expected, out_len), WALLY_OK)
+                # Final resets the context, allowing it to be re-used
+                for chunk_len in [1, 7, 64, 1000]:
+                    for i in range(0, msg_len, chunk_len):
+                        chunk = msg[i:i + min(chunk_len, msg_len - i)]
+                        self.assertEqual(update_fn(ctx, chunk, len(chunk)), WALLY_OK)
+                    self.assertEqual(update_fn(ctx, None, 0), WALLY_OK)
+                    buf = create_string_buffer(out_len)
+                    self.assertEqual(final_fn(ctx, buf, out_len), WALLY_OK)
+                    self.assertEqual(h(buf), h(expected))
+
+            # Invalid arguments
+            buf = create_string_buffer(out_len)
+            self.assertEqual(update_fn(None, msg, 1), WALLY_EINVAL)
+            self.assertEqual(update_fn(ctx, None, 1), WALLY_EINVAL)
+            self.assertEqual(final_fn(None, buf, out_len), WALLY_EINVAL)
+            self.assertEqual(final_fn(ctx, None, out_len), WALLY_EINVAL)
+            self.assertEqual(final_fn(ctx, buf, out_len - 1), WALLY_EINVAL)
+
+        self.assertEqual(wally_sha256_free(sha256_ctx), WALLY_OK)
+        self.assertEqual(wally_sha512_free(sha512_ctx), WALLY_OK)
+        for init_fn, free_fn in [(wally_sha256_init_alloc, wally_sha256_free),
+                                 (wally_sha512_init_alloc, wally_sha512_free)]:
+            self.assertEqual(init_fn(None), WALLY_EINVAL)
+            self.assertEqual(free_fn(None), WALLY_EINVAL)
+
 
 if __name__ == '__main__':
     unittest.main()
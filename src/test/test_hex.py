@@ -47,6 +47,51 @@ class HexTests(unittest.TestCase):
         ret, written = wally_hex_from_bytes(buf, 0)
         self.assertEqual((ret, written), (WALLY_OK, ''))
 
+    def test_hex_from_bytes_to_buffer(self):
+        buf, buf_len = make_cbuffer('00010203fdfeff')
+        out = create_string_buffer(buf_len * 2 + 1)
+
+        ret, written = wally_hex_from_bytes_to_buffer(buf, buf_len, out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, buf_len * 2 + 1))
+        self.assertEqual(out.value, utf8('00010203fdfeff'))
+
+        # Too small, returns the required length and leaves output untouched
+        out = create_string_buffer(buf_len * 2)
+        ret, written = wally_hex_from_bytes_to_buffer(buf, buf_len, out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, buf_len * 2 + 1))
+        self.assertEqual(out.value, utf8(''))
+
+        # Empty buffer
+        ret, written = wally_hex_from_bytes_to_buffer(buf, 0, out, len(out))
+        self.assertEqual((ret, written), (WALLY_OK, 1))
+
+        # Bad inputs
+        for (b, o) in [(None, out), (buf, None)]:
+            ret, written = wally_hex_from_bytes_to_buffer(b, buf_len, o, len(out))
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+    def test_hex_lengths(self):
+        """Test lengths and positions handled by both scalar and optimized code"""
+        for _ in optimized_runs():
+            for n in range(0, 100):
+                data = bytes([(i * 37 + n) & 0xff for i in range(n)])
+                buf, buf_len = make_cbuffer(data.hex() or '00')
+                ret, retstr = wally_hex_from_bytes(buf, n)
+                self.assertEqual((ret, retstr), (WALLY_OK, data.hex()))
+
+                out, out_len = make_cbuffer('00' * (n + 1))
+                for s in (data.hex(), data.hex().upper()):
+                    ret, written = wally_hex_to_bytes(utf8(s), out, out_len)
+                    self.assertEqual((ret, written), (WALLY_OK, n))
+                    self.assertEqual(out[:n], data)
+
+                # An invalid character anywhere is detected
+                for i in range(n * 2):
+                    for c in 'gG/:@`':
+                        s = data.hex()[:i] + c + data.hex()[i + 1:]
+                        ret, written = wally_hex_to_bytes(utf8(s), out, out_len)
+                        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
 
 if __name__ == '__main__':
     unittest.main()
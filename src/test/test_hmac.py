@@ -91,5 +91,39 @@ class HMACTests(unittest.TestCase):
                 self.assertEqual(result[0:len(expected)], expected)
 
 
+    def test_ctx(self):
+        from ctypes import c_void_p
+        ctx_fns = [(wally_hmac_sha256, wally_hmac_sha256_ctx_init_alloc,
+                    wally_hmac_sha256_ctx_compute, wally_hmac_sha256_ctx_free),
+                   (wally_hmac_sha512, wally_hmac_sha512_ctx_init_alloc,
+                    wally_hmac_sha512_ctx_compute, wally_hmac_sha512_ctx_free)]
+        for test in hmac_cases:
+            k, msg = test[0], test[1]
+            key, key_len = make_cbuffer(k)
+            for fn, init_fn, compute_fn, free_fn in ctx_fns:
+                ctx = c_void_p()
+                self.assertEqual(init_fn(key, key_len, byref(ctx)), WALLY_OK)
+                buf_len = 64 if fn == wally_hmac_sha512 else 32
+                # The context can be reused for many messages
+                for m in [msg, msg[:2], msg + '00' * 200]:
+                    msg_bytes, msg_len = make_cbuffer(m)
+                    buf = create_string_buffer(buf_len)
+                    ret = compute_fn(ctx, msg_bytes, msg_len, buf, buf_len)
+                    self.assertEqual(ret, WALLY_OK)
+                    self.assertEqual((WALLY_OK, h(buf)), self.doHMAC(fn, k, m))
+                # Invalid arguments
+                self.assertEqual(compute_fn(None, msg_bytes, msg_len, buf, buf_len), WALLY_EINVAL)
+                self.assertEqual(compute_fn(ctx, None, msg_len, buf, buf_len), WALLY_EINVAL)
+                self.assertEqual(compute_fn(ctx, msg_bytes, 0, buf, buf_len), WALLY_EINVAL)
+                self.assertEqual(compute_fn(ctx, msg_bytes, msg_len, None, buf_len), WALLY_EINVAL)
+                self.assertEqual(compute_fn(ctx, msg_bytes, msg_len, buf, buf_len + 1), WALLY_EINVAL)
+                self.assertEqual(free_fn(ctx), WALLY_OK)
+
+                self.assertEqual(init_fn(None, key_len, byref(ctx)), WALLY_EINVAL)
+                self.assertEqual(init_fn(key, 0, byref(ctx)), WALLY_EINVAL)
+                self.assertEqual(init_fn(key, key_len, None), WALLY_EINVAL)
+                self.assertEqual(free_fn(None), WALLY_EINVAL)
+
+
 if __name__ == '__main__':
     unittest.main()
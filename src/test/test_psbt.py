@@ -0,0 +1,251 @@
+import unittest
+from hashlib import sha256
+from struct import pack
+from util import *
+
+PSBT_MAGIC = b'psbt\xff'
+MAP_GLOBAL, MAP_INPUT, MAP_OUTPUT = 0, 1, 2
+GLOBAL_UNSIGNED_TX, GLOBAL_VERSION = 0x00, 0xfb
+IN_NON_WITNESS_UTXO, IN_WITNESS_UTXO, IN_PARTIAL_SIG = 0x00, 0x01, 0x02
+OUT_REDEEM_SCRIPT = 0x00
+
+# A signed transaction whose first output is spent by PSBT_TX
+PREV_TX = unhexlify('0100000001be66e10da854e7aea9338c1f91cd489768d1d6d7189f586d7a3613f2a24d5396000000008b483045022100da43201760bda697222002f56266bf65023fef2094519e13077f777baed553b102205ce35d05eabda58cd50a67977a65706347cc25ef43153e309ff210a134722e9e0141042daa93315eebbe2cb9b5c3505df4c6fb6caca8b756786098567550d4820c09db988fe9997d049d687292f815ccd6e7fb5c1b1a91137999818d17c73d0f80aef9ffffffff0123ce0100000000001976a9142bc89c2702e0e618db7d59eb5ce2f0f147b4075488ac00000000')
+PREV_TX_SATOSHI = 0x1ce23
+PREV_TXID = sha256(sha256(PREV_TX).digest()).digest()
+WITNESS_TXID = b'\x11' * 32
+WITNESS_SATOSHI = 50000
+P2WPKH = b'\x00\x14' + b'\x22' * 20
+PUBKEY = b'\x02' + b'\x33' * 32
+SIG = b'\x30\x44' + b'\x44' * 68 + b'\x01'
+
+
+def varint(n):
+    if n < 0xfd:
+        return pack('<B', n)
+    if n <= 0xffff:
+        return b'\xfd' + pack('<H', n)
+    if n <= 0xffffffff:
+        return b'\xfe' + pack('<I', n)
+    return b'\xff' + pack('<Q', n)
+
+
+def pair(key, value):
+    return varint(len(key)) + key + varint(len(value)) + value
+
+
+def unsigned_tx(inputs, scriptsig=b''):
+    tx = pack('<I', 2) + varint(len(inputs))
+    for txhash, index in inputs:
+        tx += txhash + pack('<I', index) + varint(len(scriptsig)) + scriptsig + b'\xff' * 4
+    tx += varint(1) + pack('<Q', 1000) + varint(len(P2WPKH)) + P2WPKH
+    return tx + b'\x00' * 4
+
+
+def psbt(global_pairs, input_maps, output_maps):
+    maps = [global_pairs] + input_maps + output_maps
+    return PSBT_MAGIC + b''.join(b''.join(m) + b'\x00' for m in maps)
+
+
+def witness_utxo(satoshi):
+    return pack('<Q', satoshi) + varint(len(P2WPKH)) + P2WPKH
+
+
+def default_psbt():
+    tx = unsigned_tx([(PREV_TXID, 0), (WITNESS_TXID, 1)])
+    return psbt([pair(b'\x00', tx)],
+                [[pair(b'\x00', PREV_TX), pair(b'\x02' + PUBKEY, SIG)],
+                 [pair(b'\x01', witness_utxo(WITNESS_SATOSHI))]],
+                [[]])
+
+
+class PSBTTests(unittest.TestCase):
+
+    def parse(self, buf):
+        view = c_void_p()
+        ret = wally_psbt_view_from_bytes(buf, len(buf), 0, byref(view))
+        return ret, view
+
+    def serialize(self, view):
+        ret, written = wally_psbt_view_to_bytes(view, 0, None, 0)
+        self.assertEqual(ret, WALLY_EINVAL)
+        buf = create_string_buffer(1)
+        ret, written = wally_psbt_view_to_bytes(view, 0, buf, 1)
+        self.assertEqual(ret, WALLY_OK)
+        buf = create_string_buffer(written)
+        ret, written = wally_psbt_view_to_bytes(view, 0, buf, len(buf))
+        self.assertEqual((ret, written), (WALLY_OK, len(buf)))
+        return buf.raw
+
+    def get_pair(self, view, map_, index, pair_index):
+        p = POINTER(wally_psbt_pair)()
+        ret = wally_psbt_view_get_pair(view, map_, index, pair_index, byref(p))
+        self.assertEqual(ret, WALLY_OK)
+        p = p[0]
+        return (p.type, string_at(p.key, p.key_len),
+                string_at(p.key_data, p.key_data_len),
+                string_at(p.value, p.value_len))
+
+    def test_parse(self):
+        """Test parsing and reading a PSBT"""
+        buf = default_psbt()
+        ret, view = self.parse(buf)
+        self.assertEqual(ret, WALLY_OK)
+
+        tx = POINTER(wally_tx)()
+        self.assertEqual(wally_psbt_view_get_tx(view, byref(tx)), WALLY_OK)
+        self.assertEqual((tx[0].num_inputs, tx[0].num_outputs), (2, 1))
+
+        for map_, index, expected in [(MAP_GLOBAL, 0, 1), (MAP_INPUT, 0, 2),
+                                      (MAP_INPUT, 1, 1), (MAP_OUTPUT, 0, 0)]:
+            self.assertEqual(wally_psbt_view_get_num_pairs(view, map_, index),
+                             (WALLY_OK, expected))
+        for map_, index in [(MAP_GLOBAL, 1), (MAP_INPUT, 2), (MAP_OUTPUT, 1), (3, 0)]:
+            self.assertEqual(wally_psbt_view_get_num_pairs(view, map_, index),
+                             (WALLY_EINVAL, 0))
+
+        self.assertEqual(self.get_pair(view, MAP_INPUT, 0, 1),
+                         (IN_PARTIAL_SIG, b'\x02' + PUBKEY, PUBKEY, SIG))
+        self.assertEqual(self.get_pair(view, MAP_INPUT, 0, 0),
+                         (IN_NON_WITNESS_UTXO, b'\x00', b'', PREV_TX))
+        p = POINTER(wally_psbt_pair)()
+        self.assertEqual(wally_psbt_view_get_pair(view, MAP_INPUT, 1, 1, byref(p)),
+                         WALLY_EINVAL)
+
+        # Pairs are found by type and key data
+        pk, pk_len = PUBKEY, len(PUBKEY)
+        for index, type_, key, expected in [(0, IN_PARTIAL_SIG, pk, 1),
+                                            (0, IN_NON_WITNESS_UTXO, None, 0),
+                                            (0, IN_WITNESS_UTXO, None, 2),
+                                            (0, IN_PARTIAL_SIG, None, 2),
+                                            (1, IN_PARTIAL_SIG, pk, 1),
+                                            (1, IN_WITNESS_UTXO, None, 0)]:
+            key_len = len(key) if key else 0
+            self.assertEqual(wally_psbt_view_find_pair(view, MAP_INPUT, index, type_,
+                                                       key, key_len),
+                             (WALLY_OK, expected))
+
+        # Input values come from either kind of UTXO
+        for index, expected in [(0, PREV_TX_SATOSHI), (1, WITNESS_SATOSHI)]:
+            satoshi = c_ulonglong()
+            ret = wally_psbt_view_get_input_satoshi(view, index, byref(satoshi))
+            self.assertEqual((ret, satoshi.value), (WALLY_OK, expected))
+
+        # Unchanged maps serialize to the parsed bytes
+        self.assertEqual(self.serialize(view), buf)
+        wally_psbt_view_free(view)
+
+    def test_input_satoshi(self):
+        """Test UTXO values are checked against the spending input"""
+        tx = unsigned_tx([(PREV_TXID, 0), (WITNESS_TXID, 0), (PREV_TXID, 1),
+                          (WITNESS_TXID, 2)])
+        buf = psbt([pair(b'\x00', tx)],
+                   [[pair(b'\x00', PREV_TX[:-1] + b'\x01')], # Wrong txid
+                    [], # No UTXO
+                    [pair(b'\x00', PREV_TX)], # Output index out of range
+                    [pair(b'\x01', witness_utxo(1) + b'\x00')]], # Bad witness UTXO
+                   [[]])
+        ret, view = self.parse(buf)
+        self.assertEqual(ret, WALLY_OK)
+        for index in range(5):
+            satoshi = c_ulonglong(1)
+            ret = wally_psbt_view_get_input_satoshi(view, index, byref(satoshi))
+            self.assertEqual((ret, satoshi.value), (WALLY_EINVAL, 0))
+        wally_psbt_view_free(view)
+
+    def test_invalid(self):
+        """Test malformed PSBTs are rejected"""
+        tx = unsigned_tx([(PREV_TXID, 0)])
+        tx_pair = pair(b'\x00', tx)
+        for buf in [
+            b'psbt\xfe' + default_psbt()[5:], # Bad magic
+            PSBT_MAGIC, # No global map
+            psbt([], [[]], [[]]), # No unsigned tx
+            psbt([tx_pair], [[]], []), # Missing output map
+            psbt([tx_pair], [[]], [[]]) + b'\x00', # Trailing data
+            psbt([tx_pair], [[]], [[]])[:-1], # Truncated
+            psbt([tx_pair], [[pair(b'\x02' + PUBKEY, SIG)] * 2], [[]]), # Duplicate key
+            psbt([tx_pair, tx_pair], [[]], [[]]), # Duplicate unsigned tx
+            psbt([pair(b'\x00', unsigned_tx([(PREV_TXID, 0)], b'\x51'))], [[]], [[]]), # Signed
+            psbt([tx_pair, pair(b'\xfb', pack('<I', 2))], [[]], [[]]), # Version 2
+            psbt([tx_pair, pair(b'\xfb', b'\x00')], [[]], [[]]), # Bad version
+            psbt([tx_pair], [[b'\x01\xfd\x00']], [[]]), # Key type overruns key
+            psbt([tx_pair], [[b'\x01\x02\xfe']], [[]]), # Value overruns map
+            ]:
+            ret, view = self.parse(buf)
+            self.assertEqual((ret, view.value), (WALLY_EINVAL, None))
+
+        buf = psbt([tx_pair], [[]], [[]])
+        view = c_void_p()
+        for args in [(None, len(buf), 0, byref(view)),
+                     (buf, 0, 0, byref(view)),
+                     (buf, len(buf), 1, byref(view)),
+                     (buf, len(buf), 0, None)]:
+            self.assertEqual(wally_psbt_view_from_bytes(*args), WALLY_EINVAL)
+
+    def test_modify(self):
+        """Test adding, replacing and removing pairs"""
+        buf = default_psbt()
+        ret, view = self.parse(buf)
+        self.assertEqual(ret, WALLY_OK)
+
+        # The unsigned tx cannot be replaced or removed
+        tx = unsigned_tx([(PREV_TXID, 0)])
+        self.assertEqual(wally_psbt_view_set_pair(view, MAP_GLOBAL, 0, b'\x00', 1, tx, len(tx)),
+                         WALLY_EINVAL)
+        self.assertEqual(wally_psbt_view_remove_pair(view, MAP_GLOBAL, 0, 0), WALLY_EINVAL)
+        for args in [(MAP_INPUT, 2, b'\x02', 1, SIG, len(SIG)), # Bad index
+                     (MAP_INPUT, 0, None, 0, SIG, len(SIG)), # No key
+                     (MAP_INPUT, 0, b'\xfd', 1, SIG, len(SIG)), # Bad key type
+                     (MAP_INPUT, 0, b'\x02', 1, None, 1)]: # Bad value
+            self.assertEqual(wally_psbt_view_set_pair(view, *args), WALLY_EINVAL)
+        self.assertEqual(wally_psbt_view_remove_pair(view, MAP_OUTPUT, 0, 0), WALLY_EINVAL)
+        self.assertEqual(self.serialize(view), buf)
+
+        # Add a signature to the second input and a script to the output
+        pk2, sig2 = b'\x03' + b'\x55' * 32, b'\x30' + b'\x66' * 8
+        redeem = b'\x51' * 40
+        for map_, index, key, value in [(MAP_INPUT, 1, b'\x02' + pk2, sig2),
+                                        (MAP_OUTPUT, 0, b'\x00', redeem)]:
+            self.assertEqual(wally_psbt_view_set_pair(view, map_, index, key, len(key),
+                                                      value, len(value)), WALLY_OK)
+        tx = unsigned_tx([(PREV_TXID, 0), (WITNESS_TXID, 1)])
+        in0 = [pair(b'\x00', PREV_TX), pair(b'\x02' + PUBKEY, SIG)]
+        in1 = [pair(b'\x01', witness_utxo(WITNESS_SATOSHI)), pair(b'\x02' + pk2, sig2)]
+        expected = psbt([pair(b'\x00', tx)], [in0, in1], [[pair(b'\x00', redeem)]])
+        self.assertEqual(self.serialize(view), expected)
+        self.assertEqual(self.get_pair(view, MAP_INPUT, 1, 1),
+                         (IN_PARTIAL_SIG, b'\x02' + pk2, pk2, sig2))
+
+        # Replace a signature in place, and grow a map beyond its parsed size
+        self.assertEqual(wally_psbt_view_set_pair(view, MAP_INPUT, 0, b'\x02' + PUBKEY,
+                                                  len(PUBKEY) + 1, sig2, len(sig2)), WALLY_OK)
+        in0[1] = pair(b'\x02' + PUBKEY, sig2)
+        for i in range(8):
+            key = b'\xfc' + pack('<B', i)
+            self.assertEqual(wally_psbt_view_set_pair(view, MAP_INPUT, 0, key, len(key),
+                                                      None, 0), WALLY_OK)
+            in0.append(pair(key, b''))
+        expected = psbt([pair(b'\x00', tx)], [in0, in1], [[pair(b'\x00', redeem)]])
+        self.assertEqual(self.serialize(view), expected)
+
+        # Remove pairs, including the UTXO
+        self.assertEqual(wally_psbt_view_remove_pair(view, MAP_INPUT, 0, 0), WALLY_OK)
+        self.assertEqual(wally_psbt_view_remove_pair(view, MAP_OUTPUT, 0, 0), WALLY_OK)
+        del in0[0]
+        expected = psbt([pair(b'\x00', tx)], [in0, in1], [[]])
+        self.assertEqual(self.serialize(view), expected)
+        satoshi = c_ulonglong()
+        self.assertEqual(wally_psbt_view_get_input_satoshi(view, 0, byref(satoshi)),
+                         WALLY_EINVAL)
+        wally_psbt_view_free(view)
+
+        # The serialized result parses back to the same PSBT
+        ret, view = self.parse(expected)
+        self.assertEqual(ret, WALLY_OK)
+        self.assertEqual(self.serialize(view), expected)
+        wally_psbt_view_free(view)
+
+
+if __name__ == '__main__':
+    unittest.main()
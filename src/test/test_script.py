@@ -4,10 +4,13 @@ from util import *
 SCRIPT_TYPE_OP_RETURN = 0x1
 SCRIPT_TYPE_P2PKH = 0x2
 SCRIPT_TYPE_P2SH = 0x4
+SCRIPT_TYPE_P2WSH = 0x10
 SCRIPT_TYPE_MULTISIG = 0x20
 
 SCRIPT_HASH160 = 0x1
 SCRIPT_SHA256  = 0x2
+SCRIPT_WRITER_FLAG_GROW = 0x1
+SCRIPT_MULTISIG_SORTED = 0x8
 
 MAX_OP_RETURN_LEN = 80
 
@@ -165,6 +168,28 @@ class ScriptTests(unittest.TestCase):
             ret = wally_scriptpubkey_get_type(out, script_len)
             self.assertEqual(ret, (WALLY_OK, SCRIPT_TYPE_MULTISIG))
 
+        # BIP67 sorted keys
+        keys = ['03' + '22' * 32, '02' + '33' * 32, '02' + '22' * 32]
+        mpk, mpk_len = make_cbuffer(''.join(keys))
+        script_len = 3 + 3 * (33 + 1)
+        ret = wally_scriptpubkey_multisig_from_bytes(mpk, mpk_len, 2, 0, out, out_len)
+        self.assertEqual(ret, (WALLY_OK, script_len))
+        self.assertEqual(out[:script_len], unhexlify('52' + ''.join(['21' + k for k in keys]) + '53ae'))
+        ret = wally_scriptpubkey_multisig_from_bytes(mpk, mpk_len, 2,
+                                                     SCRIPT_MULTISIG_SORTED, out, out_len)
+        self.assertEqual(ret, (WALLY_OK, script_len))
+        self.assertEqual(out[:script_len], unhexlify('52' + ''.join(['21' + k for k in sorted(keys)]) + '53ae'))
+        # Sorting a single key or already sorted keys has no effect
+        for mpk, mpk_len in [(PK, PK_LEN), (MPK_3, MPK_3_LEN)]:
+            script_len = 3 + (mpk_len // 33 * (33 + 1))
+            expected, _ = make_cbuffer('00' * script_len)
+            ret = wally_scriptpubkey_multisig_from_bytes(mpk, mpk_len, 1, 0, expected, script_len)
+            self.assertEqual(ret, (WALLY_OK, script_len))
+            ret = wally_scriptpubkey_multisig_from_bytes(mpk, mpk_len, 1,
+                                                         SCRIPT_MULTISIG_SORTED, out, out_len)
+            self.assertEqual(ret, (WALLY_OK, script_len))
+            self.assertEqual(out[:script_len], expected)
+
     def test_scriptpubkey_csv_2of2_then_1_from_bytes(self):
         """Tests for creating csv 2of2 then 1 scriptPubKeys"""
         # Invalid args
@@ -270,6 +295,27 @@ class ScriptTests(unittest.TestCase):
             ret = wally_scriptsig_p2pkh_from_sig(*args)
             self.assertEqual(ret, (WALLY_OK, args[1] + args[3] + 9))
 
+    def test_witness_p2wpkh(self):
+        """Tests for creating a serialized p2wpkh witness"""
+        out, out_len = make_cbuffer('00' * 108)
+        invalid_args = [
+            (None, PK_LEN, SIG, SIG_LEN, 0x01, out, out_len), # Null pubkey
+            (PKU, PKU_LEN, SIG, SIG_LEN, 0x01, out, out_len), # Uncompressed pubkey
+            (PK, PK_LEN, None, SIG_LEN, 0x01, out, out_len), # Null sig
+            (PK, PK_LEN, SIG, 63, 0x01, out, out_len), # Bad sig length
+            (PK, PK_LEN, SIG_LARGE, SIG_LARGE_LEN, 0x01, out, out_len), # Out of range sig
+            (PK, PK_LEN, SIG, SIG_LEN, 0x100, out, out_len), # Bad sighash
+            (PK, PK_LEN, SIG, SIG_LEN, 0x01, None, out_len), # Null output
+            (PK, PK_LEN, SIG, SIG_LEN, 0x01, out, 106), # Short output
+        ]
+        for args in invalid_args:
+            self.assertEqual(wally_witness_p2wpkh_from_sig(*args), (WALLY_EINVAL, 0))
+
+        ret = wally_witness_p2wpkh_from_sig(PK, PK_LEN, SIG, SIG_LEN, 0x83, out, out_len)
+        self.assertEqual(ret, (WALLY_OK, 107))
+        self.assertEqual(out[:107], unhexlify('024730440220' + '11'*32 + '0220' +
+                                              '11'*32 + '8321' + '11'*33))
+
     def test_scriptsig_multisig(self):
         """Tests for creating multisig scriptsig"""
 
@@ -313,6 +359,41 @@ class ScriptTests(unittest.TestCase):
             self.assertEqual(ret, (WALLY_OK, 73 + 72 * args[5]))
             self.assertEqual(out[:(73 + 72 * args[5])], unhexlify(exp_script))
 
+        # From DER: the result must match converting from compact signatures
+        der_sig = '30440220' + '11'*32 + '0220' + '11'*32
+        ders, ders_len = make_cbuffer(der_sig + '01' + der_sig + '02')
+        der_lens = c_sighash([71, 71])
+        invalid_args = [
+            (None, RS_2of2_LEN, ders, ders_len, der_lens, 2, 0, out, out_len), # Null script
+            (RS_2of2, 0, ders, ders_len, der_lens, 2, 0, out, out_len), # Empty script
+            (RS_2of2, RS_2of2_LEN, None, ders_len, der_lens, 2, 0, out, out_len), # Null bytes
+            (RS_2of2, RS_2of2_LEN, ders, 0, der_lens, 2, 0, out, out_len), # Empty bytes
+            (RS_2of2, RS_2of2_LEN, ders, ders_len - 1, der_lens, 2, 0, out, out_len), # Inconsistent bytes len
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, None, 2, 0, out, out_len), # Null lens
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, der_lens, 0, 0, out, out_len), # Too few sigs
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, der_lens, 1, 0, out, out_len), # Inconsistent lens length
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, c_sighash([0, 142]), 2, 0, out, out_len), # Empty sig
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, c_sighash([74, 68]), 2, 0, out, out_len), # Too long sig
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, der_lens, 2, 1, out, out_len), # Unsupported flags
+            (RS_2of2, RS_2of2_LEN, ders, ders_len, der_lens, 2, 0, None, out_len), # Null output
+        ]
+        for args in invalid_args:
+            ret = wally_scriptsig_multisig_from_der(*args)
+            self.assertEqual(ret, (WALLY_EINVAL, 0))
+
+        expected, expected_len = make_cbuffer('00' * 300)
+        ret = wally_scriptsig_multisig_from_bytes(RS_2of2, RS_2of2_LEN, SIG_COUPLE, SIG_COUPLE_LEN,
+                                                  c_sighash([0x01, 0x02]), 2, 0, expected, expected_len)
+        self.assertEqual(ret, (WALLY_OK, 73 + 72 * 2))
+        ret = wally_scriptsig_multisig_from_der(RS_2of2, RS_2of2_LEN, ders, ders_len,
+                                                der_lens, 2, 0, out, out_len)
+        self.assertEqual(ret, (WALLY_OK, 73 + 72 * 2))
+        self.assertEqual(out[:(73 + 72 * 2)], expected[:(73 + 72 * 2)])
+        # A short output buffer returns the required length
+        ret = wally_scriptsig_multisig_from_der(RS_2of2, RS_2of2_LEN, ders, ders_len,
+                                                der_lens, 2, 0, out, 10)
+        self.assertEqual(ret, (WALLY_OK, 73 + 72 * 2))
+
     def test_script_push_from_bytes(self):
         """Tests for encoding script pushes"""
         out, out_len = make_cbuffer('00' * 165536)
@@ -332,6 +413,74 @@ class ScriptTests(unittest.TestCase):
             self.assertEqual(ret, WALLY_OK)
             self.assertEqual(written, len(data)/2 + len(prefix)/2)
 
+    def test_script_writer(self):
+        """Tests for building scripts with a script writer"""
+        pub_key = '11' * 33
+        key, key_len = make_cbuffer(pub_key)
+        key_hash, key_hash_len = make_cbuffer('00' * 20)
+        self.assertEqual(wally_hash160(key, key_len, key_hash, key_hash_len), WALLY_OK)
+        # OP_1NEGATE OP_0 OP_16 <17> <-17> <0x80> <-0x80> <2^31-1> OP_DROP <pub_key> <hash160(pub_key)>
+        expected = '4f0060' + '0111' + '0191' + '028000' + '028080' + \
+                   '04ffffff7f' + '75' + '21' + pub_key + '14' + h(key_hash).decode()
+
+        def write(writer):
+            for value in [-1, 0, 16, 17, -17, 0x80, -0x80, 0x7fffffff]:
+                self.assertEqual(wally_script_writer_add_int(writer, value), WALLY_OK)
+            self.assertEqual(wally_script_writer_add_opcode(writer, 0x75), WALLY_OK)
+            self.assertEqual(wally_script_writer_add_push(writer, key, key_len, 0), WALLY_OK)
+            self.assertEqual(wally_script_writer_add_push(writer, key, key_len, SCRIPT_HASH160), WALLY_OK)
+
+        # Writing to a caller buffer
+        expected_len = len(expected) // 2
+        for buf_len in [expected_len, expected_len + 5, 10, 0]:
+            buf = create_string_buffer(max(buf_len, 1))
+            writer = wally_script_writer()
+            self.assertEqual(wally_script_writer_init(writer, buf, buf_len, 0), WALLY_OK)
+            write(writer)
+            self.assertEqual(writer.written, expected_len)
+            if buf_len >= expected_len:
+                self.assertEqual(h(buf.raw[:expected_len]), utf8(expected))
+            self.assertEqual(wally_script_writer_free(writer), WALLY_OK)
+
+        # Writing to a growable buffer
+        for initial_len in [0, 1, 64]:
+            writer = wally_script_writer()
+            self.assertEqual(wally_script_writer_init(writer, None, initial_len,
+                                                      SCRIPT_WRITER_FLAG_GROW), WALLY_OK)
+            write(writer)
+            self.assertEqual(writer.written, expected_len)
+            self.assertTrue(writer.len >= expected_len)
+            self.assertEqual(h(string_at(writer.bytes, writer.written)), utf8(expected))
+            # Raw bytes are appended as-is
+            raw, raw_len = make_cbuffer('ab' * 300)
+            self.assertEqual(wally_script_writer_add_bytes(writer, raw, raw_len), WALLY_OK)
+            self.assertEqual(writer.written, expected_len + 300)
+            self.assertEqual(string_at(writer.bytes, writer.written)[expected_len:], raw)
+            self.assertEqual(wally_script_writer_free(writer), WALLY_OK)
+            self.assertEqual((writer.bytes, writer.len, writer.written), (None, 0, 0))
+
+        # Invalid args
+        buf = create_string_buffer(10)
+        writer = wally_script_writer()
+        for args in [(None, buf, 10, 0), # Null writer
+                     (writer, None, 10, 0), # Null buffer
+                     (writer, buf, 10, SCRIPT_WRITER_FLAG_GROW), # Buffer with grow
+                     (writer, buf, 10, 0x2)]: # Unknown flag
+            self.assertEqual(wally_script_writer_init(*args), WALLY_EINVAL)
+        self.assertEqual(wally_script_writer_init(writer, buf, 10, 0), WALLY_OK)
+        for fn, args in [(wally_script_writer_add_opcode, (None, 0)),
+                         (wally_script_writer_add_opcode, (writer, 0x100)),
+                         (wally_script_writer_add_bytes, (None, buf, 1)),
+                         (wally_script_writer_add_bytes, (writer, None, 1)),
+                         (wally_script_writer_add_push, (None, buf, 1, 0)),
+                         (wally_script_writer_add_push, (writer, None, 1, 0)),
+                         (wally_script_writer_add_push, (writer, buf, 1, 0x4)),
+                         (wally_script_writer_add_int, (None, 1)),
+                         (wally_script_writer_add_int, (writer, -2**63))]:
+            self.assertEqual(fn(*args), WALLY_EINVAL)
+        self.assertEqual(writer.written, 0)
+        self.assertEqual(wally_script_writer_free(None), WALLY_EINVAL)
+
     def test_wally_witness_program_from_bytes(self):
         valid_cases = [('00' * 20, 0, '0014'+'00'*20),
                        ('00' * 32, 0, '0020'+'00'*32),
@@ -352,5 +501,76 @@ class ScriptTests(unittest.TestCase):
             ret, written = wally_witness_program_from_bytes(in_, in_len, flags, out, out_len)
             self.assertEqual(ret, WALLY_EINVAL)
 
+    def test_scripts_to_addresses(self):
+        """Tests for batch creation of P2SH/P2WSH scriptPubkeys and addresses"""
+        # 40 redeem scripts hash in more than one batch
+        scripts = ['52' + ('21' + '%02x' % i * 33) * 2 + '52ae' for i in range(40)]
+        item_len = len(scripts[0]) // 2
+        buf, buf_len = make_cbuffer(''.join(scripts))
+        P2SH_P2WSH = SCRIPT_TYPE_P2SH | SCRIPT_TYPE_P2WSH
+
+        def expected(script_type, script):
+            spk, spk_len = make_cbuffer('00' * 34)
+            in_, in_len = make_cbuffer(script)
+            if script_type & SCRIPT_TYPE_P2WSH:
+                ret, written = wally_witness_program_from_bytes(in_, in_len, SCRIPT_SHA256,
+                                                                spk, spk_len)
+                self.assertEqual(ret, WALLY_OK)
+                if script_type == SCRIPT_TYPE_P2WSH:
+                    ret, addr = wally_addr_segwit_from_bytes(spk, written, utf8('tb'), 0)
+                    self.assertEqual(ret, WALLY_OK)
+                    return spk[:written], addr
+                in_, in_len = make_cbuffer(spk[:written].hex())
+            ret, written = wally_scriptpubkey_p2sh_from_bytes(in_, in_len, SCRIPT_HASH160,
+                                                              spk, spk_len)
+            self.assertEqual(ret, WALLY_OK)
+            payload, payload_len = make_cbuffer('c4' + spk[2:22].hex())
+            ret, addr = wally_base58_from_bytes(payload, payload_len, 1) # BASE58_FLAG_CHECKSUM
+            self.assertEqual(ret, WALLY_OK)
+            return spk[:written], addr
+
+        for script_type, spk_len in [(SCRIPT_TYPE_P2SH, SCRIPTPUBKEY_P2SH_LEN),
+                                     (SCRIPT_TYPE_P2WSH, 34), (P2SH_P2WSH, SCRIPTPUBKEY_P2SH_LEN)]:
+            spks, spks_len = make_cbuffer('00' * spk_len * len(scripts))
+            out = create_string_buffer(100 * len(scripts))
+            ret, written = wally_scripts_to_addresses(buf, buf_len, item_len, script_type,
+                                                      utf8('tb'), 0xc4, 0, spks, spks_len,
+                                                      out, len(out))
+            self.assertEqual(ret, WALLY_OK)
+            addrs = out.raw[:written].split(b'\0')[:-1]
+            self.assertEqual(len(addrs), len(scripts))
+            for i, script in enumerate(scripts):
+                exp_spk, exp_addr = expected(script_type, script)
+                self.assertEqual(spks[i * spk_len:(i + 1) * spk_len], exp_spk)
+                self.assertEqual(addrs[i], utf8(exp_addr))
+
+            # Addresses alone, and the required length when output is too small
+            for l in [0, written - 1, written]:
+                short = create_string_buffer(max(l, 1))
+                ret, required = wally_scripts_to_addresses(buf, buf_len, item_len, script_type,
+                                                           utf8('tb'), 0xc4, 0, None, 0, short, l)
+                self.assertEqual((ret, required), (WALLY_OK, written))
+            self.assertEqual(short.raw, out.raw[:written])
+
+            # Invalid args
+            invalid_args = [
+                (None, buf_len, item_len, script_type, utf8('tb'), 0xc4, 0, spks, spks_len), # Null bytes
+                (buf, 0, item_len, script_type, utf8('tb'), 0xc4, 0, spks, spks_len), # Empty bytes
+                (buf, buf_len, 0, script_type, utf8('tb'), 0xc4, 0, spks, spks_len), # Zero item_len
+                (buf, buf_len, item_len - 1, script_type, utf8('tb'), 0xc4, 0, spks, spks_len), # Uneven item_len
+                (buf, buf_len, item_len, 0, utf8('tb'), 0xc4, 0, spks, spks_len), # No script type
+                (buf, buf_len, item_len, SCRIPT_TYPE_P2PKH, utf8('tb'), 0xc4, 0, spks, spks_len), # Bad script type
+                (buf, buf_len, item_len, script_type, utf8('tb'), 0xc4, 1, spks, spks_len), # Unsupported flags
+                (buf, buf_len, item_len, script_type, utf8('tb'), 0xc4, 0, spks, spks_len - 1), # Bad scriptPubkey len
+                (buf, buf_len, item_len, script_type, utf8('tb'), 0xc4, 0, None, spks_len), # Null scriptPubkeys with len
+            ]
+            if script_type == SCRIPT_TYPE_P2WSH:
+                invalid_args.append((buf, buf_len, item_len, script_type, None, 0xc4, 0, spks, spks_len)) # Null family
+            else:
+                invalid_args.append((buf, buf_len, item_len, script_type, utf8('tb'), 0x100, 0, spks, spks_len)) # Bad version
+            for args in invalid_args:
+                ret = wally_scripts_to_addresses(*args, out, len(out))
+                self.assertEqual(ret, (WALLY_EINVAL, 0))
+
 if __name__ == '__main__':
     unittest.main()
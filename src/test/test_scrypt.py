@@ -35,8 +35,7 @@ cases = [
 
 class ScryptTests(unittest.TestCase):
 
-    def test_scrypt(self):
-
+    def _do_test_scrypt(self):
         for c in cases:
             passwd, salt, cost, block, parallel, length, expected = c
             passwd = utf8(passwd)
@@ -50,6 +49,224 @@ class ScryptTests(unittest.TestCase):
             self.assertEqual(ret, 0)
             self.assertEqual(h(out_buf), utf8(expected))
 
+            if cost * block * parallel <= 1024 * 8 * 16:
+                # Run the parallel lanes on threads, and with no runner
+                for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                    out_buf, out_len = make_cbuffer('0' * len(expected))
+                    ret = wally_scrypt_parallel(passwd, len(passwd), salt, len(salt),
+                                                cost, block, parallel, run_fn, None,
+                                                out_buf, out_len)
+                    self.assertEqual(ret, 0)
+                    self.assertEqual(h(out_buf), utf8(expected))
+
+    def test_scrypt(self):
+        for _ in optimized_runs():
+            self._do_test_scrypt()
+
+    def test_scrypt_lanes(self):
+        """Test lane counts that do not fill a multi-lane smix against hashlib"""
+        import hashlib
+        if not hasattr(hashlib, 'scrypt'):
+            self.skipTest('hashlib.scrypt is not available')
+        wally_init(0)
+        passwd, salt = utf8('password'), utf8('NaCl')
+        for block in [1, 2, 8]:
+            for parallel in range(1, 10):
+                expected = hashlib.scrypt(passwd, salt=salt, n=32, r=block,
+                                          p=parallel, dklen=32)
+                for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                    out_buf, out_len = make_cbuffer('00' * 32)
+                    ret = wally_scrypt_parallel(passwd, len(passwd), salt, len(salt),
+                                                32, block, parallel, run_fn, None,
+                                                out_buf, out_len)
+                    self.assertEqual(ret, 0)
+                    self.assertEqual(out_buf, expected)
+
+    def test_scrypt_with_scratch(self):
+        from ctypes import addressof, create_string_buffer, c_void_p
+        wally_init(0)
+        for c in cases[:3]:
+            passwd, salt, cost, block, parallel, length, expected = c
+            passwd = utf8(passwd)
+            salt = utf8(salt)
+            expected = utf8(expected.replace(' ', ''))
+
+            ret, scratch_len = wally_scrypt_get_scratch_length(cost, block, parallel)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertTrue(scratch_len >= 128 * block * (cost + parallel))
+
+            # Use an unaligned scratch buffer, and reuse it for a second call
+            buf = create_string_buffer(scratch_len + 1)
+            scratch = c_void_p(addressof(buf) + 1)
+            for i in range(2):
+                out_buf, out_len = make_cbuffer('00' * length)
+                ret = wally_scrypt_with_scratch(passwd, len(passwd), salt, len(salt),
+                                                cost, block, parallel,
+                                                scratch, scratch_len, out_buf, out_len)
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(h(out_buf), expected)
+                # The working memory is cleared after use
+                self.assertEqual(buf.raw, b'\0' * (scratch_len + 1))
+
+            # Too small or missing scratch buffers fail
+            for args in [(scratch, 0), (scratch, 128 * block), (None, scratch_len)]:
+                ret = wally_scrypt_with_scratch(passwd, len(passwd), salt, len(salt),
+                                                cost, block, parallel,
+                                                args[0], args[1], out_buf, out_len)
+                self.assertEqual(ret, WALLY_EINVAL)
+
+        for args in [(16, 0, 1),   # Zero block size
+                     (16, 1, 0),   # Zero parallelism
+                     (15, 1, 1),   # Cost not a power of 2
+                     (1, 1, 1)]:   # Cost too small
+            ret, scratch_len = wally_scrypt_get_scratch_length(*args)
+            self.assertEqual((ret, scratch_len), (WALLY_EINVAL, 0))
+
+    def test_scrypt_secret_arena(self):
+        from ctypes import c_void_p
+        ARENA_LOCK, ARENA_GUARD = 0x1, 0x2
+        self.assertEqual(wally_secret_arena_free(1), WALLY_EINVAL)
+        self.assertEqual(wally_secret_arena_free(0), WALLY_OK) # No arena
+        for args in [(0, 0), (4096, 0x4), (2 ** 33, 0)]:
+            self.assertEqual(wally_secret_arena_init(*args), WALLY_EINVAL)
+
+        def check_cases():
+            # Cases too large for the arena fall back to the heap
+            for passwd, salt, cost, block, parallel, length, expected in cases[:3]:
+                out_buf, out_len = make_cbuffer('00' * length)
+                ret = wally_scrypt(utf8(passwd), len(passwd), utf8(salt), len(salt),
+                                   cost, block, parallel, out_buf, out_len)
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(h(out_buf), utf8(expected.replace(' ', '')))
+
+        self.assertEqual(wally_secret_arena_init(2 * 1024 * 1024, ARENA_GUARD), WALLY_OK)
+        try:
+            # Only one arena can exist at a time
+            self.assertEqual(wally_secret_arena_init(4096, 0), WALLY_ERROR)
+            check_cases()
+
+            # The arena can't be freed while its memory is in use
+            passwd, salt, cost, block, parallel, length, expected = cases[0]
+            tasks = AsyncTasks()
+            set_submit_fn(tasks.submit_fn)
+            try:
+                op, out_buf = c_void_p(), create_string_buffer(length)
+                ret = wally_scrypt_async(None, 0, None, 0, cost, block, parallel,
+                                         out_buf, length, async_done_fn_t(), None, byref(op))
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(wally_secret_arena_free(0), WALLY_ERROR)
+                tasks.run()
+                self.assertEqual(h(out_buf), utf8(expected.replace(' ', '')))
+                self.assertEqual(wally_async_free(op), WALLY_OK)
+            finally:
+                set_submit_fn(None)
+        finally:
+            self.assertEqual(wally_secret_arena_free(0), WALLY_OK)
+
+        # Locking may fail if the process may not lock enough memory
+        if wally_secret_arena_init(65536, ARENA_LOCK | ARENA_GUARD) == WALLY_OK:
+            check_cases()
+            self.assertEqual(wally_secret_arena_free(0), WALLY_OK)
+
+    def test_scrypt_async(self):
+        import time
+        from ctypes import c_void_p
+        passwd, salt, cost, block, parallel, length, expected = cases[1]
+        passwd, salt = utf8(passwd), utf8(salt)
+        expected = utf8(expected.replace(' ', ''))
+        results = []
+        done_fn = async_done_fn_t(lambda ctx, ret: results.append(ret))
+
+        def start(out_buf, cost=cost, block=block, parallel=parallel):
+            op = c_void_p()
+            ret = wally_scrypt_async(passwd, len(passwd), salt, len(salt),
+                                     cost, block, parallel, out_buf, len(out_buf),
+                                     done_fn, None, byref(op))
+            return ret, op
+
+        # With no submit_fn, the operation completes before returning
+        out_buf = create_string_buffer(length)
+        ret, op = start(out_buf)
+        self.assertEqual((ret, results), (WALLY_OK, [WALLY_OK]))
+        self.assertEqual(wally_async_poll(op), (WALLY_OK, 1))
+        self.assertEqual(h(out_buf), expected)
+        self.assertEqual(wally_async_free(op), WALLY_OK)
+
+        tasks = AsyncTasks()
+        set_submit_fn(tasks.submit_fn)
+        try:
+            # Submitted operations complete when their task runs
+            del results[:]
+            out_buf = create_string_buffer(length)
+            ret, op = start(out_buf)
+            self.assertEqual((ret, results), (WALLY_OK, []))
+            self.assertEqual(wally_async_poll(op), (WALLY_OK, 0))
+            tasks.run()
+            self.assertEqual(wally_async_poll(op), (WALLY_OK, 1))
+            self.assertEqual((results, h(out_buf)), ([WALLY_OK], expected))
+            self.assertEqual(wally_async_free(op), WALLY_OK)
+
+            # Invalid parameters are reported as the result
+            del results[:]
+            ret, op = start(out_buf, cost=15)
+            tasks.run()
+            self.assertEqual(wally_async_poll(op), (WALLY_EINVAL, 1))
+            self.assertEqual((results, out_buf.raw), ([WALLY_EINVAL], b'\0' * length))
+            self.assertEqual(wally_async_free(op), WALLY_OK)
+
+            # Cancelled and freed operations fail and clear their output
+            for cancel in [wally_async_cancel, wally_async_free]:
+                del results[:]
+                out_buf = create_string_buffer(b'\xff' * length, length)
+                ret, op = start(out_buf)
+                self.assertEqual(cancel(op), WALLY_OK)
+                tasks.run()
+                self.assertEqual((results, out_buf.raw), ([WALLY_ERROR], b'\0' * length))
+                if cancel == wally_async_cancel:
+                    self.assertEqual(wally_async_poll(op), (WALLY_ERROR, 1))
+                    self.assertEqual(wally_async_cancel(op), WALLY_OK) # No effect
+                    self.assertEqual(wally_async_free(op), WALLY_OK)
+
+            # A failed submission returns its error and never completes
+            del results[:]
+            tasks.ret = WALLY_ERROR
+            ret, op = start(out_buf)
+            self.assertEqual((ret, op.value, results), (WALLY_ERROR, None, []))
+            tasks.ret = WALLY_OK
+
+            # Cancelling a running operation stops its smix loop early
+            big_cost, big_block = 65536, 8
+            start_time = time.time()
+            ret = wally_scrypt(passwd, len(passwd), salt, len(salt),
+                               big_cost, big_block, 1, out_buf, length)
+            full_time = time.time() - start_time
+            self.assertEqual(ret, WALLY_OK)
+
+            tasks.threaded = True
+            del results[:]
+            ret, op = start(out_buf, cost=big_cost, block=big_block, parallel=1)
+            start_time = time.time()
+            time.sleep(full_time / 10)
+            self.assertEqual(wally_async_cancel(op), WALLY_OK)
+            tasks.run()
+            self.assertLess(time.time() - start_time, full_time * 0.75)
+            self.assertEqual((results, out_buf.raw), ([WALLY_ERROR], b'\0' * length))
+            self.assertEqual(wally_async_free(op), WALLY_OK)
+        finally:
+            set_submit_fn(None)
+
+        for args in [(None, len(passwd), salt, len(salt)),  # Null password
+                     (passwd, len(passwd), None, len(salt))]: # Null salt
+            op = c_void_p()
+            ret = wally_scrypt_async(args[0], args[1], args[2], args[3], cost, block,
+                                     parallel, out_buf, length, done_fn, None, byref(op))
+            self.assertEqual((ret, op.value), (WALLY_EINVAL, None))
+        ret = wally_scrypt_async(passwd, len(passwd), salt, len(salt), cost, block,
+                                 parallel, out_buf, length, done_fn, None, None)
+        self.assertEqual(ret, WALLY_EINVAL)
+        for fn in [wally_async_cancel, wally_async_free]:
+            self.assertEqual(fn(None), WALLY_EINVAL)
+
 
 if __name__ == '__main__':
     unittest.main()
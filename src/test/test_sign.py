@@ -1,10 +1,11 @@
 import unittest
 from util import *
 from hashlib import sha256
+import hmac
 
-FLAG_ECDSA, FLAG_SCHNORR, FLAG_GRIND_R = 1, 2, 4
+FLAG_ECDSA, FLAG_SCHNORR, FLAG_GRIND_R, FLAG_DER, FLAG_RECOVERABLE = 1, 2, 4, 8, 16
 EX_PRIV_KEY_LEN, EC_PUBIC_KEY_LEN, EC_PUBIC_KEY_UNCOMPRESSED_LEN = 32, 33, 65
-EC_SIGNATURE_LEN, EC_SIGNATURE_DER_MAX_LEN = 64, 72
+EC_SIGNATURE_LEN, EC_SIGNATURE_DER_MAX_LEN, EC_SIGNATURE_RECOVERABLE_LEN = 64, 72, 65
 BITCOIN_MESSAGE_HASH_FLAG = 1
 
 class SignTests(unittest.TestCase):
@@ -144,6 +145,646 @@ class SignTests(unittest.TestCase):
             self.assertEqual(ret, WALLY_EINVAL)
 
 
+    def test_shared_context(self):
+        """Test that concurrent first use creates a single shared context"""
+        from threading import Thread
+        priv_key, _ = make_cbuffer('01' * EX_PRIV_KEY_LEN)
+        results = []
+
+        def derive():
+            out_buf, out_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+            for i in range(32):
+                ret = wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                           out_buf, out_len)
+                results.append((ret, h(out_buf)))
+
+        for i in range(2):
+            # Destroy the context so that the threads race to create it
+            self.assertEqual(wally_cleanup(0), WALLY_OK)
+            threads = [Thread(target=derive) for t in range(8)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            self.assertEqual(len(results), (i + 1) * 8 * 32)
+            self.assertEqual(len(set(results)), 1)
+            self.assertEqual(results[0][0], WALLY_OK)
+
+        # wally_init creates the context eagerly and may be called again
+        self.assertEqual(wally_cleanup(0), WALLY_OK)
+        for i in range(2):
+            self.assertEqual(wally_init(0), WALLY_OK)
+        self.assertEqual(wally_secp_randomize(urandom(32), 32), WALLY_OK)
+        derive()
+        self.assertEqual(len(set(results)), 1)
+
+    def test_thread_context(self):
+        """Test signing in parallel with per-thread contexts"""
+        from threading import Thread
+        priv_key, _ = make_cbuffer('02' * EX_PRIV_KEY_LEN)
+        msg, _ = make_cbuffer('03' * 32)
+        expected, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        set_fake_ec_nonce(None)
+        self.assertEqual(self.sign(priv_key, msg, FLAG_ECDSA, expected), WALLY_OK)
+        results, errors = [], []
+
+        def sign():
+            ctx = c_void_p()
+            ret = wally_thread_ctx_init_alloc(urandom(32), 32, byref(ctx))
+            errors.append(ret)
+            errors.append(wally_thread_ctx_set(ctx))
+            sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+            for i in range(16):
+                # Re-randomizing only affects this threads context
+                errors.append(wally_secp_randomize(urandom(32), 32))
+                errors.append(self.sign(priv_key, msg, FLAG_ECDSA, sig))
+                results.append(h(sig))
+            errors.append(wally_thread_ctx_free(ctx))
+
+        threads = [Thread(target=sign) for t in range(8)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(set(errors), set([WALLY_OK]))
+        self.assertEqual(set(results), set([h(expected)]))
+
+        # Unbinding returns the thread to the shared context
+        ctx = c_void_p()
+        self.assertEqual(wally_thread_ctx_init_alloc(urandom(32), 32, byref(ctx)), WALLY_OK)
+        self.assertEqual(wally_thread_ctx_set(ctx), WALLY_OK)
+        self.assertEqual(wally_thread_ctx_set(None), WALLY_OK)
+        self.assertEqual(wally_thread_ctx_free(ctx), WALLY_OK)
+
+        # Invalid cases
+        for entropy, entropy_len, out in [(None,         32, byref(ctx)), # Missing entropy
+                                          (urandom(32), 31, byref(ctx)), # Bad entropy len
+                                          (urandom(32), 32, None)]:      # Missing output
+            self.assertEqual(wally_thread_ctx_init_alloc(entropy, entropy_len, out),
+                             WALLY_EINVAL)
+        self.assertEqual(wally_thread_ctx_free(None), WALLY_EINVAL)
+
+    def test_context_profiles(self):
+        """Test sign-only and verify-only contexts"""
+        WALLY_INIT_SIGN_ONLY, WALLY_INIT_VERIFY_ONLY = 1, 2
+        priv_key, _ = make_cbuffer('04' * EX_PRIV_KEY_LEN)
+        msg, _ = make_cbuffer('05' * 32)
+        pub_key, pub_key_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        set_fake_ec_nonce(None)
+
+        derive = lambda: wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                              pub_key, pub_key_len)
+        sign = lambda: self.sign(priv_key, msg, FLAG_ECDSA, sig)
+        verify = lambda: wally_ec_sig_verify(pub_key, pub_key_len, msg, len(msg),
+                                             FLAG_ECDSA, sig, len(sig))
+        tweaked, tweaked_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        tweak = lambda: wally_ec_public_key_tweak_add(pub_key, pub_key_len, msg, len(msg),
+                                                      tweaked, tweaked_len)
+
+        self.assertEqual((derive(), sign(), verify(), tweak()), (WALLY_OK,) * 4)
+
+        self.assertEqual(wally_init(WALLY_INIT_SIGN_ONLY), WALLY_OK)
+        self.assertEqual((derive(), sign()), (WALLY_OK, WALLY_OK))
+        self.assertEqual(verify(), WALLY_ERROR) # Verify fails without tables
+        self.assertEqual(tweak(), WALLY_ERROR)
+
+        self.assertEqual(wally_init(WALLY_INIT_VERIFY_ONLY), WALLY_OK)
+        self.assertEqual((verify(), tweak()), (WALLY_OK, WALLY_OK))
+        self.assertEqual(derive(), WALLY_ERROR) # Signing tables are required
+        self.assertEqual(sign(), WALLY_ERROR)
+
+        self.assertEqual(wally_init(WALLY_INIT_SIGN_ONLY | WALLY_INIT_VERIFY_ONLY),
+                         WALLY_EINVAL)
+        self.assertEqual(wally_init(0), WALLY_OK)
+        self.assertEqual((derive(), sign(), verify()), (WALLY_OK,) * 3)
+        self.assertEqual(wally_secp_randomize(urandom(32), 32), WALLY_OK)
+
+    def test_init_warm_up(self):
+        """Test eager one-time initialization"""
+        WALLY_INIT_SIGN_ONLY, WALLY_INIT_VERIFY_ONLY, WALLY_INIT_WARM_UP = 1, 2, 4
+        value = c_ulonglong()
+        self.assertEqual(wally_get_init_duration(None), WALLY_EINVAL)
+        for flags in [WALLY_INIT_SIGN_ONLY, WALLY_INIT_VERIFY_ONLY, 0]:
+            self.assertEqual(wally_init(flags | WALLY_INIT_WARM_UP), WALLY_OK)
+            self.assertEqual(wally_get_init_duration(byref(value)), WALLY_OK)
+            warm_up_ns = value.value
+            self.assertEqual(wally_init(flags), WALLY_OK)
+            self.assertEqual(wally_get_init_duration(byref(value)), WALLY_OK)
+            if warm_up_ns:
+                # Warming up the wordlists alone takes longer than initializing
+                self.assertGreater(warm_up_ns, value.value)
+
+        # Failed calls leave the last duration unchanged
+        for flags in [WALLY_INIT_SIGN_ONLY | WALLY_INIT_VERIFY_ONLY | WALLY_INIT_WARM_UP,
+                      0x8 | WALLY_INIT_WARM_UP]:
+            self.assertEqual(wally_init(flags), WALLY_EINVAL)
+            last = c_ulonglong()
+            self.assertEqual(wally_get_init_duration(byref(last)), WALLY_OK)
+            self.assertEqual(last.value, value.value)
+
+    def test_verify_batch(self):
+        n = 150 # More than two groups of signatures
+        pub_keys, msgs, sigs = b'', b'', b''
+        set_fake_ec_nonce(None)
+        for i in range(n):
+            priv_key, _ = make_cbuffer('%02x' % (i + 1) * EX_PRIV_KEY_LEN)
+            msg, _ = make_cbuffer('%02x' % ((i * 7) % 256) * 32)
+            pub_key, pub_key_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+            sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+            ret = wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                       pub_key, pub_key_len)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertEqual(self.sign(priv_key, msg, FLAG_ECDSA, sig), WALLY_OK)
+            pub_keys, msgs, sigs = pub_keys + pub_key, msgs + msg, sigs + sig
+
+        def verify(p, m, s, run_fn=run_tasks_fn_t(), flags=FLAG_ECDSA, out_len=n):
+            out_buf, _ = make_cbuffer('ff' * n)
+            ret = wally_ec_sig_verify_batch(p, len(p), m, len(m), flags,
+                                            s, len(s), run_fn, None, out_buf, out_len)
+            return ret, out_buf
+
+        for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+            ret, results = verify(pub_keys, msgs, sigs, run_fn)
+            self.assertEqual((ret, results), (WALLY_OK, b'\x01' * n))
+
+            # Invalid signatures are reported individually
+            bad_msgs = msgs[:32 * 70] + b'\xee' * 32 + msgs[32 * 71:]
+            bad_pub_keys = pub_keys[:33 * 149] + b'\x00' * 33
+            ret, results = verify(bad_pub_keys, bad_msgs, sigs, run_fn)
+            self.assertEqual(ret, WALLY_EINVAL)
+            self.assertEqual(results, b'\x01' * 70 + b'\x00' + b'\x01' * 78 + b'\x00')
+
+        # Invalid cases
+        for args in [(None,          msgs,      sigs),
+                     (pub_keys[:-1], msgs,      sigs),
+                     (pub_keys,      None,      sigs),
+                     (pub_keys,      msgs[:-1], sigs),
+                     (pub_keys,      msgs,      None),
+                     (pub_keys,      msgs,      sigs[:-1])]:
+            len_or_0 = lambda v: 0 if v is None else len(v)
+            out_buf, _ = make_cbuffer('00' * n)
+            ret = wally_ec_sig_verify_batch(args[0], len_or_0(args[0]),
+                                            args[1], len_or_0(args[1]), FLAG_ECDSA,
+                                            args[2], len_or_0(args[2]),
+                                            run_tasks_fn_t(), None, out_buf, n)
+            self.assertEqual(ret, WALLY_EINVAL)
+        for flags in [0, FLAG_SCHNORR, FLAG_ECDSA | FLAG_SCHNORR]:
+            self.assertEqual(verify(pub_keys, msgs, sigs, flags=flags)[0], WALLY_EINVAL)
+        self.assertEqual(verify(pub_keys, msgs, sigs, out_len=n - 1)[0], WALLY_EINVAL)
+        self.assertEqual(verify(b'', b'', b'', out_len=0)[0], WALLY_EINVAL)
+
+    def test_parsed_public_key(self):
+        priv_key, _ = make_cbuffer('06' * EX_PRIV_KEY_LEN)
+        msg, _ = make_cbuffer('07' * 32)
+        pub_key, pub_key_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        full, full_len = make_cbuffer('00' * EC_PUBIC_KEY_UNCOMPRESSED_LEN)
+        expected, _ = make_cbuffer('00' * EC_PUBIC_KEY_UNCOMPRESSED_LEN)
+        set_fake_ec_nonce(None)
+
+        ret = wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                   pub_key, pub_key_len)
+        self.assertEqual(ret, WALLY_OK)
+        self.assertEqual(self.sign(priv_key, msg, FLAG_ECDSA, sig), WALLY_OK)
+
+        key = c_void_p()
+        ret = wally_ec_public_key_init_alloc(pub_key, pub_key_len, byref(key))
+        self.assertEqual(ret, WALLY_OK)
+
+        ret = wally_ec_sig_verify_parsed(key, msg, len(msg), FLAG_ECDSA, sig, len(sig))
+        self.assertEqual(ret, WALLY_OK)
+        bad_msg, _ = make_cbuffer('08' * 32)
+        ret = wally_ec_sig_verify_parsed(key, bad_msg, len(bad_msg), FLAG_ECDSA,
+                                         sig, len(sig))
+        self.assertEqual(ret, WALLY_EINVAL)
+
+        ret = wally_ec_public_key_decompress(pub_key, pub_key_len, expected, full_len)
+        self.assertEqual(ret, WALLY_OK)
+        ret = wally_ec_public_key_decompress_parsed(key, full, full_len)
+        self.assertEqual((ret, h(full)), (WALLY_OK, h(expected)))
+
+        # Invalid cases
+        for args in [(None, msg,  32, FLAG_ECDSA,   sig,  EC_SIGNATURE_LEN),
+                     (key,  None, 32, FLAG_ECDSA,   sig,  EC_SIGNATURE_LEN),
+                     (key,  msg,  31, FLAG_ECDSA,   sig,  EC_SIGNATURE_LEN),
+                     (key,  msg,  32, 0,            sig,  EC_SIGNATURE_LEN),
+                     (key,  msg,  32, FLAG_SCHNORR, sig,  EC_SIGNATURE_LEN),
+                     (key,  msg,  32, FLAG_ECDSA,   None, EC_SIGNATURE_LEN),
+                     (key,  msg,  32, FLAG_ECDSA,   sig,  EC_SIGNATURE_LEN - 1)]:
+            self.assertEqual(wally_ec_sig_verify_parsed(*args), WALLY_EINVAL)
+        for k, o, o_len in [(None, full, full_len),
+                            (key,  None, full_len),
+                            (key,  full, full_len - 1)]:
+            self.assertEqual(wally_ec_public_key_decompress_parsed(k, o, o_len),
+                             WALLY_EINVAL)
+        self.assertEqual(wally_ec_public_key_free(key), WALLY_OK)
+        self.assertEqual(wally_ec_public_key_free(None), WALLY_EINVAL)
+
+        bad_pub_key, _ = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        for p, p_len, out in [(None,        pub_key_len,     byref(key)),
+                              (pub_key,     pub_key_len - 1, byref(key)),
+                              (bad_pub_key, pub_key_len,     byref(key)),
+                              (pub_key,     pub_key_len,     None)]:
+            self.assertEqual(wally_ec_public_key_init_alloc(p, p_len, out), WALLY_EINVAL)
+
+    def test_sign_batch(self):
+        n = 5
+        priv_keys = b''.join([make_cbuffer('%02x' % (i + 9) * 32)[0] for i in range(n)])
+        msgs = b''.join([make_cbuffer('%02x' % (i + 20) * 32)[0] for i in range(n)])
+        set_fake_ec_nonce(None)
+
+        for flags in [FLAG_ECDSA, FLAG_ECDSA | FLAG_GRIND_R]:
+            # Compute the expected signatures one at a time
+            compact, der = bytearray(), bytearray()
+            sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+            der_buf, der_len = make_cbuffer('00' * EC_SIGNATURE_DER_MAX_LEN)
+            for i in range(n):
+                ret = self.sign(priv_keys[i * 32:(i + 1) * 32],
+                                msgs[i * 32:(i + 1) * 32], flags, sig)
+                self.assertEqual(ret, WALLY_OK)
+                ret, written = wally_ec_sig_to_der(sig, len(sig), der_buf, der_len)
+                self.assertEqual(ret, WALLY_OK)
+                compact, der = compact + sig, der + der_buf[:written]
+
+            compact, der = bytes(compact), bytes(der)
+
+            for out_flags, expected in [(flags, compact), (flags | FLAG_DER, der)]:
+                for run_fn in [None, run_tasks_threaded, run_tasks_fn_t()]:
+                    out_buf, out_len = make_cbuffer('00' * EC_SIGNATURE_DER_MAX_LEN * n)
+                    if run_fn is None:
+                        ret, written = wally_ec_sig_from_bytes_batch(
+                            priv_keys, len(priv_keys), msgs, len(msgs), out_flags,
+                            out_buf, out_len)
+                    else:
+                        ret, written = wally_ec_sig_from_bytes_batch_parallel(
+                            priv_keys, len(priv_keys), msgs, len(msgs), out_flags,
+                            run_fn, None, out_buf, out_len)
+                    self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+                    self.assertEqual(out_buf[:written], expected)
+
+                # Short output buffer returns the required length
+                out_buf, _ = make_cbuffer('00' * 1)
+                ret, written = wally_ec_sig_from_bytes_batch(
+                    priv_keys, len(priv_keys), msgs, len(msgs), out_flags, out_buf, 1)
+                self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+
+        # An invalid private key fails the batch and clears the output
+        bad_keys = priv_keys[:32] + b'\x00' * 32 + priv_keys[64:]
+        out_buf, out_len = make_cbuffer('ff' * EC_SIGNATURE_LEN * n)
+        ret, written = wally_ec_sig_from_bytes_batch(
+            bad_keys, len(bad_keys), msgs, len(msgs), FLAG_ECDSA, out_buf, out_len)
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        self.assertEqual(out_buf, b'\x00' * out_len)
+
+        # Invalid cases
+        out_buf, out_len = make_cbuffer('00' * EC_SIGNATURE_LEN * n)
+        for k, k_len, m, m_len, flags, o in [
+            (None,      len(priv_keys),     msgs, len(msgs),      FLAG_ECDSA,   out_buf),
+            (priv_keys, 0,                  msgs, len(msgs),      FLAG_ECDSA,   out_buf),
+            (priv_keys, len(priv_keys) - 1, msgs, len(msgs),      FLAG_ECDSA,   out_buf),
+            (priv_keys, len(priv_keys),     None, len(msgs),      FLAG_ECDSA,   out_buf),
+            (priv_keys, len(priv_keys),     msgs, len(msgs) - 32, FLAG_ECDSA,   out_buf),
+            (priv_keys, len(priv_keys),     msgs, len(msgs),      0,            out_buf),
+            (priv_keys, len(priv_keys),     msgs, len(msgs),      FLAG_SCHNORR, out_buf),
+            (priv_keys, len(priv_keys),     msgs, len(msgs),      FLAG_ECDSA | 0x20, out_buf),
+            (priv_keys, len(priv_keys),     msgs, len(msgs),      FLAG_ECDSA,   None)]:
+            ret, written = wally_ec_sig_from_bytes_batch(k, k_len, m, m_len, flags,
+                                                         o, out_len)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+    def test_sig_conversion_batch(self):
+        from ctypes import c_ulong
+        n, slot = 5, EC_SIGNATURE_DER_MAX_LEN
+        order = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141
+        set_fake_ec_nonce(None)
+        sigs, _ = make_cbuffer('00' * EC_SIGNATURE_LEN * n)
+        ret, _ = wally_ec_sig_from_bytes_batch(
+            bytes(range(1, 33)) * n, 32 * n, b''.join(bytes([i]) * 32 for i in range(n)),
+            32 * n, FLAG_ECDSA, sigs, len(sigs))
+        self.assertEqual(ret, WALLY_OK)
+        low = bytes(sigs)
+        # Make every other signature high-s
+        high = b''
+        for i in range(n):
+            r, s = low[i * 64:i * 64 + 32], int.from_bytes(low[i * 64 + 32:(i + 1) * 64], 'big')
+            high += r + ((order - s) if i % 2 else s).to_bytes(32, 'big')
+
+        # Normalize, both into a separate buffer and in place
+        results, results_len = make_cbuffer('00' * n)
+        out, out_len = make_cbuffer('ff' * len(high))
+        ret = wally_ec_sig_normalize_batch(high, len(high), results, results_len, out, out_len)
+        self.assertEqual((ret, results, out), (WALLY_OK, b'\x01' * n, low))
+        in_place, in_place_len = make_cbuffer(h(high))
+        ret = wally_ec_sig_normalize_batch(in_place, in_place_len, results, results_len,
+                                           in_place, in_place_len)
+        self.assertEqual((ret, in_place), (WALLY_OK, low))
+
+        # DER encode into fixed slots, matching single conversions
+        lens = (c_ulong * n)()
+        ders, ders_len = make_cbuffer('ff' * slot * n)
+        ret = wally_ec_sig_to_der_batch(high, len(high), lens, n, ders, ders_len)
+        self.assertEqual(ret, WALLY_OK)
+        der, der_len = make_cbuffer('00' * slot)
+        for i in range(n):
+            ret, written = wally_ec_sig_to_der(high[i * 64:(i + 1) * 64], 64, der, der_len)
+            self.assertEqual((ret, lens[i]), (WALLY_OK, written))
+            self.assertEqual(ders[i * slot:(i + 1) * slot],
+                             der[:written] + b'\x00' * (slot - written))
+
+        # Decode the slots back to the original compact signatures
+        out, out_len = make_cbuffer('ff' * len(high))
+        ret = wally_ec_sig_from_der_batch(ders, ders_len, lens, n, results, results_len,
+                                          out, out_len)
+        self.assertEqual((ret, results, out), (WALLY_OK, b'\x01' * n, high))
+
+        # Invalid signatures are reported individually and their outputs cleared
+        bad = high[:64] + b'\xff' * 64 + high[128:]
+        ret = wally_ec_sig_normalize_batch(bad, len(bad), results, results_len, out, out_len)
+        self.assertEqual((ret, results), (WALLY_EINVAL, b'\x01\x00\x01\x01\x01'))
+        self.assertEqual(out[64:128], b'\x00' * 64)
+        ret = wally_ec_sig_to_der_batch(bad, len(bad), lens, n, ders, ders_len)
+        self.assertEqual((ret, lens[1], ders[slot:slot * 2]), (WALLY_EINVAL, 0, b'\x00' * slot))
+        lens[1] = 0
+        lens[3] -= 1
+        ret = wally_ec_sig_from_der_batch(ders, ders_len, lens, n, results, results_len,
+                                          out, out_len)
+        self.assertEqual((ret, results), (WALLY_EINVAL, b'\x01\x00\x01\x00\x01'))
+        self.assertEqual(out[64 * 3:64 * 4], b'\x00' * 64)
+        lens[3] = slot + 1
+        ret = wally_ec_sig_from_der_batch(ders, ders_len, lens, n, results, results_len,
+                                          out, out_len)
+        self.assertEqual((ret, results[3]), (WALLY_EINVAL, 0))
+
+        # Invalid arguments
+        for s, s_len, r_len, o, o_len in [(None, len(high),     n,     out,  out_len),
+                                          (high, len(high) - 1, n,     out,  out_len),
+                                          (high, len(high),     n - 1, out,  out_len),
+                                          (high, len(high),     n,     None, out_len),
+                                          (high, len(high),     n,     out,  out_len - 1),
+                                          (b'',  0,             0,     out,  0)]:
+            ret = wally_ec_sig_normalize_batch(s, s_len, results, r_len, o, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+            d_len = ders_len - (out_len - o_len) if o_len else 0
+            ret = wally_ec_sig_to_der_batch(s, s_len, lens, r_len, o and ders, d_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(wally_ec_sig_to_der_batch(high, len(high), None, n, ders, ders_len),
+                         WALLY_EINVAL)
+        for d, d_len, l, l_len, r_len, o, o_len in [
+            (None, ders_len,     lens, n,     n,     out,  out_len),
+            (ders, ders_len - 1, lens, n,     n,     out,  out_len),
+            (ders, ders_len,     None, n,     n,     out,  out_len),
+            (ders, ders_len,     lens, n - 1, n,     out,  out_len),
+            (ders, ders_len,     lens, n,     n - 1, out,  out_len),
+            (ders, ders_len,     lens, n,     n,     None, out_len),
+            (ders, ders_len,     lens, n,     n,     out,  out_len - 1),
+            (b'',  0,            lens, 0,     0,     out,  0)]:
+            ret = wally_ec_sig_from_der_batch(d, d_len, l, l_len, results, r_len, o, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_sign_grind(self):
+        priv_key, _ = make_cbuffer('0a' * EX_PRIV_KEY_LEN)
+        flags = FLAG_ECDSA | FLAG_GRIND_R
+        sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        expected, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        high_r, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        attempts = c_uint()
+        set_fake_ec_nonce(None)
+
+        def grind(msg, max_attempts):
+            ret = wally_ec_sig_from_bytes_grind(priv_key, len(priv_key), msg, len(msg),
+                                                flags, max_attempts, sig, len(sig),
+                                                byref(attempts))
+            return ret, attempts.value
+
+        seen_grinding = False
+        for i in range(16):
+            msg, _ = make_cbuffer('%02x' % i * 32)
+            self.assertEqual(self.sign(priv_key, msg, flags, expected), WALLY_OK)
+            self.assertEqual(self.sign(priv_key, msg, FLAG_ECDSA, high_r), WALLY_OK)
+
+            # Unbounded grinding matches wally_ec_sig_from_bytes
+            ret, n = grind(msg, 0)
+            self.assertEqual((ret, h(sig)), (WALLY_OK, h(expected)))
+            self.assertTrue(sig[0] < 0x80)
+            self.assertEqual(n == 1, h(expected) == h(high_r))
+            if n > 1:
+                seen_grinding = True
+                # A cap less than the attempts needed returns a high-R signature
+                ret, capped = grind(msg, n - 1)
+                self.assertEqual((ret, capped), (WALLY_OK, n - 1))
+                self.assertTrue(sig[0] >= 0x80)
+                ret, capped = grind(msg, 1)
+                self.assertEqual((ret, capped, h(sig)), (WALLY_OK, 1, h(high_r)))
+            # A cap greater than needed has no effect
+            ret, capped = grind(msg, n + 1)
+            self.assertEqual((ret, capped, h(sig)), (WALLY_OK, n, h(expected)))
+        self.assertTrue(seen_grinding)
+
+        # Invalid cases
+        msg, _ = make_cbuffer('00' * 32)
+        for args in [(None,     32, msg,  32, flags,      1, sig,  64, byref(attempts)),
+                     (priv_key, 31, msg,  32, flags,      1, sig,  64, byref(attempts)),
+                     (priv_key, 32, None, 32, flags,      1, sig,  64, byref(attempts)),
+                     (priv_key, 32, msg,  31, flags,      1, sig,  64, byref(attempts)),
+                     (priv_key, 32, msg,  32, FLAG_ECDSA, 1, sig,  64, byref(attempts)),
+                     (priv_key, 32, msg,  32, flags,      1, None, 64, byref(attempts)),
+                     (priv_key, 32, msg,  32, flags,      1, sig,  63, byref(attempts)),
+                     (priv_key, 32, msg,  32, flags,      1, sig,  64, None)]:
+            self.assertEqual(wally_ec_sig_from_bytes_grind(*args), WALLY_EINVAL)
+
+    def test_public_keys_from_private_keys(self):
+        UNCOMPRESSED, HASH160 = 1, 2
+        n = 4
+        priv_keys = b''.join([make_cbuffer('%02x' % (i + 30) * 32)[0] for i in range(n)])
+        compressed, uncompressed = bytearray(), bytearray()
+        pub_key, pub_key_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        full, full_len = make_cbuffer('00' * EC_PUBIC_KEY_UNCOMPRESSED_LEN)
+        for i in range(n):
+            ret = wally_ec_public_key_from_private_key(priv_keys[i * 32:(i + 1) * 32], 32,
+                                                       pub_key, pub_key_len)
+            self.assertEqual(ret, WALLY_OK)
+            ret = wally_ec_public_key_decompress(pub_key, pub_key_len, full, full_len)
+            self.assertEqual(ret, WALLY_OK)
+            compressed += pub_key
+            uncompressed += full
+        def hash160s(keys, l):
+            out = bytearray()
+            for i in range(n):
+                buf, buf_len = make_cbuffer('00' * 20)
+                key = bytes(keys[i * l:(i + 1) * l])
+                self.assertEqual(wally_hash160(key, l, buf, buf_len), WALLY_OK)
+                out += buf
+            return bytes(out)
+
+        for flags, expected in [(0,                      bytes(compressed)),
+                                (UNCOMPRESSED,           bytes(uncompressed)),
+                                (HASH160,                hash160s(compressed, 33)),
+                                (HASH160 | UNCOMPRESSED, hash160s(uncompressed, 65))]:
+            out_buf, out_len = make_cbuffer('00' * len(expected))
+            ret = wally_ec_public_keys_from_private_keys(priv_keys, len(priv_keys),
+                                                         flags, out_buf, out_len)
+            self.assertEqual((ret, h(out_buf)), (WALLY_OK, h(expected)))
+
+        # An invalid private key fails the batch and clears the output
+        bad_keys = priv_keys[:64] + b'\xff' * 32 + priv_keys[96:]
+        out_buf, out_len = make_cbuffer('00' * len(compressed))
+        ret = wally_ec_public_keys_from_private_keys(bad_keys, len(bad_keys), 0,
+                                                     out_buf, out_len)
+        self.assertEqual((ret, out_buf), (WALLY_EINVAL, b'\x00' * out_len))
+
+        # Invalid cases
+        for k, k_len, flags, o, o_len in [
+            (None,      len(priv_keys),     0,    out_buf, out_len),     # Null keys
+            (priv_keys, 0,                  0,    out_buf, out_len),     # No keys
+            (priv_keys, len(priv_keys) - 1, 0,    out_buf, out_len),     # Bad keys length
+            (priv_keys, len(priv_keys),     0x4,  out_buf, out_len),     # Bad flags
+            (priv_keys, len(priv_keys),     0,    None,    out_len),     # Null output
+            (priv_keys, len(priv_keys),     0,    out_buf, out_len - 1)]: # Bad length
+            ret = wally_ec_public_keys_from_private_keys(k, k_len, flags, o, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_public_keys_convert(self):
+        UNCOMPRESSED, HASH160, FROM_UNCOMPRESSED = 1, 2, 4
+        n = 4
+        priv_keys = b''.join([make_cbuffer('%02x' % (i + 30) * 32)[0] for i in range(n)])
+        keys, hashes = {}, {}
+        for flags in [0, UNCOMPRESSED, HASH160, HASH160 | UNCOMPRESSED]:
+            out_buf, out_len = make_cbuffer('00' * n * [33, 65, 20, 20][flags])
+            ret = wally_ec_public_keys_from_private_keys(priv_keys, len(priv_keys),
+                                                         flags, out_buf, out_len)
+            self.assertEqual(ret, WALLY_OK)
+            (hashes if flags & HASH160 else keys)[flags & UNCOMPRESSED] = bytes(out_buf)
+
+        # Every conversion matches deriving from the private keys
+        for from_flags in [0, FROM_UNCOMPRESSED]:
+            pub_keys = keys[1 if from_flags else 0]
+            for flags in [0, UNCOMPRESSED, HASH160, HASH160 | UNCOMPRESSED]:
+                expected = (hashes if flags & HASH160 else keys)[flags & UNCOMPRESSED]
+                out_buf, out_len = make_cbuffer('00' * len(expected))
+                ret = wally_ec_public_keys_convert(pub_keys, len(pub_keys),
+                                                   flags | from_flags, out_buf, out_len)
+                self.assertEqual((ret, h(out_buf)), (WALLY_OK, h(expected)))
+
+        # An invalid public key fails the batch and clears the output
+        compressed = keys[0]
+        for bad_keys, flags in [(compressed[:66] + b'\x05' + compressed[67:], 0),
+                                (keys[1][:130] + b'\x02' + keys[1][131:], FROM_UNCOMPRESSED)]:
+            out_buf, out_len = make_cbuffer('ff' * n * 65)
+            ret = wally_ec_public_keys_convert(bad_keys, len(bad_keys), flags | UNCOMPRESSED,
+                                               out_buf, out_len)
+            self.assertEqual((ret, out_buf), (WALLY_EINVAL, b'\x00' * out_len))
+
+        # Invalid cases
+        out_buf, out_len = make_cbuffer('00' * len(compressed))
+        for k, k_len, flags, o, o_len in [
+            (None,       len(compressed),     0,    out_buf, out_len),     # Null keys
+            (compressed, 0,                   0,    out_buf, out_len),     # No keys
+            (compressed, len(compressed) - 1, 0,    out_buf, out_len),     # Bad keys length
+            (compressed, len(compressed),     FROM_UNCOMPRESSED,
+                                                    out_buf, out_len),     # Bad keys length
+            (compressed, len(compressed),     0x8,  out_buf, out_len),     # Bad flags
+            (compressed, len(compressed),     0,    None,    out_len),     # Null output
+            (compressed, len(compressed),     0,    out_buf, out_len - 1)]: # Bad length
+            ret = wally_ec_public_keys_convert(k, k_len, flags, o, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_tweak_add(self):
+        UNCOMPRESSED, HASH160 = 1, 2
+        n = 4
+        base_key, _ = make_cbuffer('01' * 32)
+        tweaks = b''.join([make_cbuffer('%02x' % (i + 40) * 32)[0] for i in range(n)])
+        # Adding the negation of base_key gives zero, which is not a valid key
+        order = 0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141
+        negated = (order - int(h(base_key), 16)).to_bytes(32, 'big')
+
+        def pub_keys(priv_keys, flags=0):
+            out_buf, out_len = make_cbuffer('00' * n * [33, 65, 20, 20][flags])
+            ret = wally_ec_public_keys_from_private_keys(priv_keys, len(priv_keys),
+                                                         flags, out_buf, out_len)
+            self.assertEqual(ret, WALLY_OK)
+            return bytes(out_buf)
+
+        # Tweaking a private key and its public key give matching keys
+        tweaked, tweaked_len = make_cbuffer('00' * n * 32)
+        ret = wally_ec_private_keys_tweak_add(base_key, 32, tweaks, len(tweaks),
+                                              tweaked, tweaked_len)
+        self.assertEqual(ret, WALLY_OK)
+        tweaked = bytes(tweaked)
+        base_pub, _ = make_cbuffer('00' * 33)
+        self.assertEqual(wally_ec_public_key_from_private_key(base_key, 32, base_pub, 33),
+                         WALLY_OK)
+        parsed = c_void_p()
+        self.assertEqual(wally_ec_public_key_init_alloc(base_pub, 33, byref(parsed)), WALLY_OK)
+        expected = pub_keys(tweaked)
+        out, _ = make_cbuffer('00' * 33)
+        for i in range(n):
+            tweak = tweaks[i * 32:(i + 1) * 32]
+            ret = wally_ec_private_key_tweak_add(base_key, 32, tweak, 32, out, 32)
+            self.assertEqual((ret, bytes(out[:32])), (WALLY_OK, tweaked[i * 32:(i + 1) * 32]))
+            ret = wally_ec_public_key_tweak_add(base_pub, 33, tweak, 32, out, 33)
+            self.assertEqual((ret, bytes(out)), (WALLY_OK, expected[i * 33:(i + 1) * 33]))
+            ret = wally_ec_public_key_tweak_add_parsed(parsed, tweak, 32, out, 33)
+            self.assertEqual((ret, bytes(out)), (WALLY_OK, expected[i * 33:(i + 1) * 33]))
+
+        # Batches tweak one shared key or a key per tweak
+        base_keys = base_key * n
+        base_pubs = pub_keys(base_keys)
+        for flags in [0, UNCOMPRESSED, HASH160, HASH160 | UNCOMPRESSED]:
+            expected = pub_keys(tweaked, flags)
+            for keys in [bytes(base_pub), base_pubs]:
+                out_buf, out_len = make_cbuffer('00' * len(expected))
+                ret = wally_ec_public_keys_tweak_add(keys, len(keys), tweaks, len(tweaks),
+                                                     flags, out_buf, out_len)
+                self.assertEqual((ret, h(out_buf)), (WALLY_OK, h(expected)))
+        out_buf, out_len = make_cbuffer('00' * len(tweaked))
+        ret = wally_ec_private_keys_tweak_add(base_keys, len(base_keys), tweaks, len(tweaks),
+                                              out_buf, out_len)
+        self.assertEqual((ret, bytes(out_buf)), (WALLY_OK, tweaked))
+
+        # Tweaks giving an invalid key fail, clearing the output
+        bad_tweaks = tweaks[:32] + negated + tweaks[64:]
+        out_buf, out_len = make_cbuffer('ff' * n * 33)
+        ret = wally_ec_public_keys_tweak_add(base_pub, 33, bad_tweaks, len(bad_tweaks), 0,
+                                             out_buf, out_len)
+        self.assertEqual((ret, out_buf), (WALLY_EINVAL, b'\x00' * out_len))
+        out_buf, out_len = make_cbuffer('ff' * n * 32)
+        ret = wally_ec_private_keys_tweak_add(base_key, 32, bad_tweaks, len(bad_tweaks),
+                                              out_buf, out_len)
+        self.assertEqual((ret, out_buf), (WALLY_EINVAL, b'\x00' * out_len))
+        for tweak in [negated, b'\xff' * 32]:
+            self.assertEqual(wally_ec_public_key_tweak_add(base_pub, 33, tweak, 32, out, 33),
+                             WALLY_EINVAL)
+            self.assertEqual(wally_ec_public_key_tweak_add_parsed(parsed, tweak, 32, out, 33),
+                             WALLY_EINVAL)
+            self.assertEqual(wally_ec_private_key_tweak_add(base_key, 32, tweak, 32, out, 32),
+                             WALLY_EINVAL)
+        self.assertEqual(wally_ec_private_key_tweak_add(b'\xff' * 32, 32, tweaks, 32, out, 32),
+                         WALLY_EINVAL) # Invalid private key
+
+        # Invalid cases
+        out_buf, out_len = make_cbuffer('00' * n * 33)
+        for k, k_len, t, t_len, flags, o, o_len in [
+            (None,     33, tweaks, len(tweaks),     0,   out_buf, out_len),     # Null keys
+            (base_pub, 32, tweaks, len(tweaks),     0,   out_buf, out_len),     # Bad keys length
+            (base_pubs, len(base_pubs) - 33, tweaks, len(tweaks),
+                                                    0,   out_buf, out_len),     # Too few keys
+            (base_pub, 33, None,   len(tweaks),     0,   out_buf, out_len),     # Null tweaks
+            (base_pub, 33, tweaks, 0,               0,   out_buf, out_len),     # No tweaks
+            (base_pub, 33, tweaks, len(tweaks) - 1, 0,   out_buf, out_len),     # Bad tweaks length
+            (base_pub, 33, tweaks, len(tweaks),     0x4, out_buf, out_len),     # Bad flags
+            (base_pub, 33, tweaks, len(tweaks),     0,   None,    out_len),     # Null output
+            (base_pub, 33, tweaks, len(tweaks),     0,   out_buf, out_len - 1)]: # Bad length
+            ret = wally_ec_public_keys_tweak_add(k, k_len, t, t_len, flags, o, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(wally_ec_public_key_tweak_add_parsed(None, tweaks, 32, out, 33),
+                         WALLY_EINVAL)
+        self.assertEqual(wally_ec_public_key_tweak_add(base_pub, 33, tweaks, 31, out, 33),
+                         WALLY_EINVAL)
+        self.assertEqual(wally_ec_private_keys_tweak_add(base_key, 32, tweaks, len(tweaks),
+                                                         out_buf, n * 32 - 1), WALLY_EINVAL)
+        wally_ec_public_key_free(parsed)
+
     def test_format_message(self):
         PREFIX, MAX_LEN = b'\x18Bitcoin Signed Message:\n', 64 * 1024 - 64
         out_buf, out_len = make_cbuffer('00' * 64 * 1024)
@@ -183,6 +824,376 @@ class SignTests(unittest.TestCase):
             ret, written = wally_format_bitcoin_message(msg, msg_len, flags, o, o_len)
             self.assertEqual(ret, WALLY_EINVAL)
 
+    def test_recoverable(self):
+        set_fake_ec_nonce(None)
+        n = 70 # More than one group of signatures
+        priv_keys, msgs, sigs = b'', b'', b''
+        for i in range(n):
+            priv_key, _ = make_cbuffer('%02x' % (i + 1) * EX_PRIV_KEY_LEN)
+            message = utf8('address ownership %d' % i)
+            msg, msg_len = make_cbuffer('00' * 32)
+            ret, _ = wally_format_bitcoin_message(message, len(message),
+                                                  BITCOIN_MESSAGE_HASH_FLAG, msg, msg_len)
+            self.assertEqual(ret, WALLY_OK)
+            pub_key, pub_key_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+            ret = wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                       pub_key, pub_key_len)
+            self.assertEqual(ret, WALLY_OK)
+
+            for flags in [FLAG_ECDSA, FLAG_ECDSA | FLAG_GRIND_R]:
+                sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+                rsig, _ = make_cbuffer('00' * EC_SIGNATURE_RECOVERABLE_LEN)
+                self.assertEqual(self.sign(priv_key, msg, flags, sig), WALLY_OK)
+                self.assertEqual(self.sign(priv_key, msg, flags | FLAG_RECOVERABLE, rsig),
+                                 WALLY_OK)
+                # The signature is unchanged, prefixed with its header byte
+                self.assertTrue(31 <= rsig[0] <= 34)
+                self.assertEqual(rsig[1:], sig)
+                if flags & FLAG_GRIND_R:
+                    self.assertLess(rsig[1], 0x80)
+
+                out, out_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+                ret = wally_ec_sig_to_public_key(msg, len(msg), rsig, len(rsig),
+                                                 out, out_len)
+                self.assertEqual((ret, out), (WALLY_OK, pub_key))
+            priv_keys, msgs, sigs = priv_keys + priv_key, msgs + msg, sigs + rsig
+
+        # A wrong recovery id or message recovers a different key, or none
+        out, out_len = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        bad_sig = bytes(bytearray([sigs[0] ^ 1])) + sigs[1:65]
+        ret = wally_ec_sig_to_public_key(msgs[:32], 32, bad_sig, 65, out, out_len)
+        self.assertTrue(ret == WALLY_EINVAL or out != pub_key)
+        ret = wally_ec_sig_to_public_key(msgs[32:64], 32, sigs[:65], 65, out, out_len)
+        self.assertTrue(ret == WALLY_EINVAL or out != pub_key)
+
+        # Invalid cases
+        msg, sig = msgs[:32], sigs[:65]
+        for args in [(None, 32, sig,  65, out,  33),  # Null message hash
+                     (msg,  31, sig,  65, out,  33),  # Bad message hash length
+                     (msg,  32, None, 65, out,  33),  # Null signature
+                     (msg,  32, sig,  64, out,  33),  # Bad signature length
+                     (msg,  32, b'\x1a' + sig[1:], 65, out, 33),  # Bad header
+                     (msg,  32, b'\x23' + sig[1:], 65, out, 33),  # Bad header
+                     (msg,  32, sig,  65, None, 33),  # Null output
+                     (msg,  32, sig,  65, out,  65)]: # Bad output length
+            self.assertEqual(wally_ec_sig_to_public_key(*args), WALLY_EINVAL)
+        rsig, _ = make_cbuffer('00' * EC_SIGNATURE_RECOVERABLE_LEN)
+        for flags, sig_len in [(FLAG_ECDSA | FLAG_RECOVERABLE, EC_SIGNATURE_LEN),
+                               (FLAG_ECDSA, EC_SIGNATURE_RECOVERABLE_LEN),
+                               (FLAG_SCHNORR | FLAG_RECOVERABLE, EC_SIGNATURE_RECOVERABLE_LEN)]:
+            self.assertEqual(self.sign(priv_keys[:32], msg, flags, rsig, sig_len), WALLY_EINVAL)
+
+        # Batch signing produces the same signatures
+        for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+            out, out_len = make_cbuffer('00' * len(sigs))
+            ret, written = wally_ec_sig_from_bytes_batch_parallel(
+                priv_keys, len(priv_keys), msgs, len(msgs),
+                FLAG_ECDSA | FLAG_GRIND_R | FLAG_RECOVERABLE, run_fn, None, out, out_len)
+            self.assertEqual((ret, written, out), (WALLY_OK, len(sigs), sigs))
+        ret, written = wally_ec_sig_from_bytes_batch(
+            priv_keys, len(priv_keys), msgs, len(msgs),
+            FLAG_ECDSA | FLAG_DER | FLAG_RECOVERABLE, out, out_len)
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+
+        # Batch recovery: keys, uncompressed keys or hash160s
+        for flags, item_len in [(0, 33), (1, 65), (2, 20), (3, 20)]:
+            expected, expected_len = make_cbuffer('00' * n * item_len)
+            ret = wally_ec_public_keys_from_private_keys(priv_keys, len(priv_keys), flags,
+                                                         expected, expected_len)
+            self.assertEqual(ret, WALLY_OK)
+            for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                results, results_len = make_cbuffer('00' * n)
+                out, out_len = make_cbuffer('ff' * n * item_len)
+                ret = wally_ec_sig_to_public_key_batch(msgs, len(msgs), sigs, len(sigs),
+                                                       flags, run_fn, None, results,
+                                                       results_len, out, out_len)
+                self.assertEqual((ret, results, out), (WALLY_OK, b'\x01' * n, expected))
+
+        # Failures are reported individually and their outputs cleared
+        bad_sigs = sigs[:65 * 3] + b'\x00' + sigs[65 * 3 + 1:]
+        results, results_len = make_cbuffer('00' * n)
+        out, out_len = make_cbuffer('ff' * n * 33)
+        ret = wally_ec_sig_to_public_key_batch(msgs, len(msgs), bad_sigs, len(bad_sigs), 0,
+                                               run_tasks_threaded, None, results,
+                                               results_len, out, out_len)
+        self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(results, b'\x01' * 3 + b'\x00' + b'\x01' * (n - 4))
+        self.assertEqual(out[33 * 3:33 * 4], b'\x00' * 33)
+
+        len_or_0 = lambda v: 0 if v is None else len(v)
+        for m, s, flags, r_len, o_len in [(None,      sigs,      0, n,     33 * n),
+                                          (msgs[:-1], sigs,      0, n,     33 * n),
+                                          (msgs,      None,      0, n,     33 * n),
+                                          (msgs,      sigs[:-1], 0, n,     33 * n),
+                                          (msgs,      sigs,      4, n,     33 * n),
+                                          (msgs,      sigs,      0, n - 1, 33 * n),
+                                          (msgs,      sigs,      0, n,     65 * n),
+                                          (b'',       b'',       0, 0,     0)]:
+            ret = wally_ec_sig_to_public_key_batch(m, len_or_0(m), s, len_or_0(s), flags,
+                                                   run_tasks_fn_t(), None, results,
+                                                   r_len, out, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_format_message_batch(self):
+        from ctypes import c_char_p, c_ulong
+        messages = [b'a', b'a' * 253, b'\x00binary\x00', b'a' * (64 * 1024 - 64)]
+        n = len(messages)
+        c_messages, c_lens = (c_char_p * n)(*messages), (c_ulong * n)(*map(len, messages))
+        expected = b''
+        for msg in messages:
+            out, out_len = make_cbuffer('00' * 32)
+            ret, _ = wally_format_bitcoin_message(msg, len(msg), BITCOIN_MESSAGE_HASH_FLAG,
+                                                  out, out_len)
+            self.assertEqual(ret, WALLY_OK)
+            expected += out
+
+        out, out_len = make_cbuffer('00' * 32 * n)
+        ret = wally_format_bitcoin_message_batch(c_messages, c_lens, n,
+                                                 BITCOIN_MESSAGE_HASH_FLAG, out, out_len)
+        self.assertEqual((ret, out), (WALLY_OK, expected))
+
+        # An invalid message fails the batch and clears the output
+        bad_lens = (c_ulong * n)(1, 0, 1, 1)
+        ret = wally_format_bitcoin_message_batch(c_messages, bad_lens, n,
+                                                 BITCOIN_MESSAGE_HASH_FLAG, out, out_len)
+        self.assertEqual((ret, out), (WALLY_EINVAL, b'\x00' * 32 * n))
+
+        for args in [(None,       c_lens, n, 1, out,  out_len),      # Null messages
+                     (c_messages, None,   n, 1, out,  out_len),      # Null lengths
+                     (c_messages, c_lens, 0, 1, out,  0),            # No messages
+                     (c_messages, c_lens, n, 0, out,  out_len),      # Unhashed
+                     (c_messages, c_lens, n, 1, None, out_len),      # Null output
+                     (c_messages, c_lens, n, 1, out,  out_len - 1)]: # Bad length
+            self.assertEqual(wally_format_bitcoin_message_batch(*args), WALLY_EINVAL)
+
+    def test_ecdh(self):
+        order = 0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141
+        n = 70 # More than one task chunk
+        priv_keys = b''.join([sha256(bytes([i])).digest() for i in range(n)])
+        other_keys = b''.join([sha256(bytes([i, 1])).digest() for i in range(n)])
+        pub_keys, pub_keys_len = make_cbuffer('00' * n * 33)
+        ret = wally_ec_public_keys_from_private_keys(other_keys, len(other_keys), 0,
+                                                     pub_keys, pub_keys_len)
+        self.assertEqual(ret, WALLY_OK)
+
+        def expected_secret(a, b):
+            # The SHA256 of the compressed point (a * b) * G
+            k = (int.from_bytes(a, 'big') * int.from_bytes(b, 'big')) % order
+            pub, pub_len = make_cbuffer('00' * 33)
+            ret = wally_ec_public_key_from_private_key(k.to_bytes(32, 'big'), 32, pub, pub_len)
+            self.assertEqual(ret, WALLY_OK)
+            return sha256(pub).digest()
+
+        out, out_len = make_cbuffer('00' * 32)
+        expected = b''
+        for i in range(n):
+            priv, other = priv_keys[i * 32:(i + 1) * 32], other_keys[i * 32:(i + 1) * 32]
+            ret = wally_ecdh(pub_keys[i * 33:(i + 1) * 33], 33, priv, 32, out, out_len)
+            secret = expected_secret(priv, other)
+            self.assertEqual((ret, out), (WALLY_OK, secret))
+            expected += secret
+
+        # Batch ECDH with a private key per secret, or one for all secrets
+        single = b''.join([expected_secret(priv_keys[:32], other_keys[i * 32:(i + 1) * 32])
+                           for i in range(n)])
+        for keys, secrets in [(priv_keys, expected), (priv_keys[:32], single)]:
+            for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                results, results_len = make_cbuffer('00' * n)
+                out, out_len = make_cbuffer('ff' * n * 32)
+                ret = wally_ecdh_batch(pub_keys, pub_keys_len, keys, len(keys),
+                                       run_fn, None, results, results_len, out, out_len)
+                self.assertEqual((ret, results, out), (WALLY_OK, b'\x01' * n, secrets))
+
+        # Failures are reported individually and their outputs cleared
+        bad_pub_keys = pub_keys[:33 * 3] + b'\x05' + pub_keys[33 * 3 + 1:]
+        results, results_len = make_cbuffer('00' * n)
+        out, out_len = make_cbuffer('ff' * n * 32)
+        ret = wally_ecdh_batch(bad_pub_keys, len(bad_pub_keys), priv_keys, len(priv_keys),
+                               run_tasks_threaded, None, results, results_len, out, out_len)
+        self.assertEqual(ret, WALLY_EINVAL)
+        self.assertEqual(results, b'\x01' * 3 + b'\x00' + b'\x01' * (n - 4))
+        self.assertEqual(out[32 * 3:32 * 4], b'\x00' * 32)
+        self.assertEqual(out[:32 * 3], expected[:32 * 3])
+
+        # Invalid cases
+        pub, priv, bad_priv = pub_keys[:33], priv_keys[:32], b'\x00' * 32
+        out, out_len = make_cbuffer('ff' * 32)
+        for args in [(None, 33, priv,     32, out,  32),  # Null pubkey
+                     (pub,  65, priv,     32, out,  32),  # Bad pubkey length
+                     (bad_pub_keys[33 * 3:33 * 4], 33, priv, 32, out, 32), # Bad pubkey
+                     (pub,  33, None,     32, out,  32),  # Null private key
+                     (pub,  33, priv,     31, out,  32),  # Bad private key length
+                     (pub,  33, bad_priv, 32, out,  32),  # Bad private key
+                     (pub,  33, priv,     32, None, 32),  # Null output
+                     (pub,  33, priv,     32, out,  33)]: # Bad output length
+            self.assertEqual(wally_ecdh(*args), WALLY_EINVAL)
+        self.assertEqual(out, b'\x00' * 32)
+
+        len_or_0 = lambda v: 0 if v is None else len(v)
+        for p, k, r_len, o_len in [(None,           priv_keys,      n,     32 * n),
+                                   (pub_keys[:-1],  priv_keys,      n,     32 * n),
+                                   (pub_keys,       None,           n,     32 * n),
+                                   (pub_keys,       priv_keys[:-1], n,     32 * n),
+                                   (pub_keys,       priv_keys[:64], n,     32 * n),
+                                   (pub_keys,       priv_keys,      n - 1, 32 * n),
+                                   (pub_keys,       priv_keys,      n,     33 * n),
+                                   (b'',            b'',            0,     0)]:
+            ret = wally_ecdh_batch(p, len_or_0(p), k, len_or_0(k), run_tasks_fn_t(), None,
+                                   results, r_len, out, o_len)
+            self.assertEqual(ret, WALLY_EINVAL)
+
+    def test_signing_key(self):
+        from ctypes import byref, c_void_p
+        set_fake_ec_nonce(None)
+
+        def rfc6979(key, msg, data, algo, attempt):
+            mac = lambda k, m: hmac.new(k, m, sha256).digest()
+            key_data = key + msg + (data or b'') + (algo or b'')
+            k, v = b'\x00' * 32, b'\x01' * 32
+            k = mac(k, v + b'\x00' + key_data)
+            v = mac(k, v)
+            k = mac(k, v + b'\x01' + key_data)
+            v = mac(k, v)
+            for i in range(attempt + 1):
+                if i:
+                    k = mac(k, v + b'\x00')
+                    v = mac(k, v)
+                v = mac(k, v)
+            return v
+
+        priv_key, _ = make_cbuffer('0b' * EX_PRIV_KEY_LEN)
+        other_key, _ = make_cbuffer('0c' * EX_PRIV_KEY_LEN)
+        key = c_void_p()
+        ret = wally_ec_signing_key_init_alloc(priv_key, len(priv_key), byref(key))
+        self.assertEqual(ret, WALLY_OK)
+
+        # Nonces match RFC6979 as implemented by libsecp256k1
+        msg, _ = make_cbuffer('0d' * 32)
+        data, algo = b'\x01' + b'\x00' * 31, b'ECDSA+SHA256\x00\x00\x00\x00'
+        nonce, _ = make_cbuffer('00' * 32)
+        for d in [None, data]:
+            for a in [None, algo]:
+                for attempt in range(3):
+                    ret = wally_ec_signing_key_nonce(key, nonce, msg, priv_key, a, d, attempt)
+                    self.assertEqual((ret, nonce), (1, rfc6979(priv_key, msg, d, a, attempt)))
+        for args in [(None, nonce, msg,  priv_key),
+                     (key,  None,  msg,  priv_key),
+                     (key,  nonce, None, priv_key),
+                     (key,  nonce, msg,  None)]:
+            self.assertEqual(wally_ec_signing_key_nonce(*(args + (None, None, 0))), 0)
+
+        # Signatures are unchanged when the key is installed, for any key
+        cases = []
+        for k in [priv_key, other_key]:
+            for flags in [FLAG_ECDSA, FLAG_ECDSA | FLAG_GRIND_R,
+                          FLAG_ECDSA | FLAG_GRIND_R | FLAG_RECOVERABLE]:
+                for i in range(8):
+                    m, _ = make_cbuffer('%02x' % i * 32)
+                    sig_len = EC_SIGNATURE_RECOVERABLE_LEN if flags & FLAG_RECOVERABLE else EC_SIGNATURE_LEN
+                    sig, _ = make_cbuffer('00' * sig_len)
+                    self.assertEqual(self.sign(k, m, flags, sig), WALLY_OK)
+                    cases.append((k, m, flags, sig))
+
+        ops = operations()
+        self.assertEqual(wally_get_operations(byref(ops)), WALLY_OK)
+        ops.ec_nonce_ctx = key
+        ops.ec_nonce_ctx_fn = cast(wally_ec_signing_key_nonce, type(ops.ec_nonce_ctx_fn))
+        self.assertEqual(wally_set_operations(byref(ops)), WALLY_OK)
+        try:
+            for k, m, flags, expected in cases:
+                sig, _ = make_cbuffer('00' * len(expected))
+                self.assertEqual(self.sign(k, m, flags, sig), WALLY_OK)
+                self.assertEqual(sig, expected)
+        finally:
+            ops.ec_nonce_ctx, ops.ec_nonce_ctx_fn = None, type(ops.ec_nonce_ctx_fn)()
+            self.assertEqual(wally_set_operations(byref(ops)), WALLY_OK)
+        self.assertEqual(wally_ec_signing_key_free(key), WALLY_OK)
+
+        # Invalid cases
+        for k, k_len in [(None, 32), (priv_key, 31), (b'\x00' * 32, 32)]:
+            ret = wally_ec_signing_key_init_alloc(k, k_len, byref(key))
+            self.assertEqual((ret, key.value), (WALLY_EINVAL, None))
+        self.assertEqual(wally_ec_signing_key_init_alloc(priv_key, 32, None), WALLY_EINVAL)
+        self.assertEqual(wally_ec_signing_key_free(None), WALLY_OK)
+
+    def test_stats(self):
+        """Statistics counters track the operations performed"""
+        (ALLOCS, ALLOC_BYTES, SHA256_BLOCKS, SHA512_BLOCKS, EC_MULTS,
+         EC_SIGNS, EC_SIGN_NS, EC_VERIFIES, EC_VERIFY_NS,
+         TX_PARSES, TX_PARSE_NS, SIGHASHES, SIGHASH_NS, TX_ALLOC_BYTES,
+         SCRIPT_ALLOC_BYTES, BIP32_ALLOC_BYTES, ELEMENTS_ALLOC_BYTES,
+         NUM_STATS) = range(18)
+        value = c_ulonglong()
+
+        def stat(i):
+            self.assertEqual(wally_get_stats(i, byref(value)), WALLY_OK)
+            return value.value
+
+        # Invalid stats and reset flags are rejected in all builds
+        self.assertEqual(wally_get_stats(NUM_STATS, byref(value)), WALLY_EINVAL)
+        self.assertEqual(wally_get_stats(0, None), WALLY_EINVAL)
+        self.assertEqual(wally_reset_stats(1), WALLY_EINVAL)
+        if wally_get_stats(0, byref(value)) == WALLY_ERROR:
+            self.assertEqual(value.value, 0)
+            self.assertEqual(wally_reset_stats(0), WALLY_ERROR)
+            return # Not built with --enable-stats
+
+        self.assertEqual(wally_reset_stats(0), WALLY_OK)
+        self.assertEqual([stat(i) for i in range(NUM_STATS)], [0] * NUM_STATS)
+
+        priv_key, _ = make_cbuffer('01' * EX_PRIV_KEY_LEN)
+        msg, _ = make_cbuffer('02' * 32)
+        pub_key, _ = make_cbuffer('00' * EC_PUBIC_KEY_LEN)
+        sig, _ = make_cbuffer('00' * EC_SIGNATURE_LEN)
+        ret = wally_ec_public_key_from_private_key(priv_key, len(priv_key),
+                                                   pub_key, len(pub_key))
+        self.assertEqual(ret, WALLY_OK)
+        self.assertEqual(stat(EC_MULTS), 1)
+        for i in range(3):
+            self.assertEqual(self.sign(priv_key, msg, FLAG_ECDSA, sig), WALLY_OK)
+            ret = wally_ec_sig_verify(pub_key, len(pub_key), msg, len(msg),
+                                      FLAG_ECDSA, sig, len(sig))
+            self.assertEqual(ret, WALLY_OK)
+        self.assertEqual((stat(EC_SIGNS), stat(EC_VERIFIES)), (3, 3))
+        self.assertGreater(stat(EC_SIGN_NS), 0)
+        self.assertGreater(stat(EC_VERIFY_NS), 0)
+
+        # Hashing 100 bytes compresses two blocks
+        blocks = stat(SHA256_BLOCKS)
+        buf, buf_len = make_cbuffer('00' * 100)
+        self.assertEqual(wally_sha256(buf, buf_len, sig, 32), WALLY_OK)
+        self.assertEqual(stat(SHA256_BLOCKS), blocks + 2)
+        blocks = stat(SHA512_BLOCKS)
+        out, out_len = make_cbuffer('00' * 64)
+        self.assertEqual(wally_sha512(buf, buf_len, out, out_len), WALLY_OK)
+        self.assertEqual(stat(SHA512_BLOCKS), blocks + 1)
+
+        # Transaction parses and signature hashes are counted with allocations
+        allocs, alloc_bytes = stat(ALLOCS), stat(ALLOC_BYTES)
+        tx_alloc_bytes, bip32_alloc_bytes = stat(TX_ALLOC_BYTES), stat(BIP32_ALLOC_BYTES)
+        tx = POINTER(wally_tx)()
+        tx_hex = utf8('0100000001' + '00' * 32 + '00000000' + '00' + 'ffffffff' +
+                      '01' + '00' * 8 + '00' + '00000000')
+        self.assertEqual(wally_tx_from_hex(tx_hex, 0, byref(tx)), WALLY_OK)
+        self.assertEqual(stat(TX_PARSES), 1)
+        self.assertGreater(stat(ALLOCS), allocs)
+        self.assertGreater(stat(ALLOC_BYTES), alloc_bytes)
+        # Transaction allocations are counted in their subsystem only
+        self.assertGreater(stat(TX_ALLOC_BYTES), tx_alloc_bytes)
+        self.assertLessEqual(stat(TX_ALLOC_BYTES) - tx_alloc_bytes,
+                             stat(ALLOC_BYTES) - alloc_bytes)
+        self.assertEqual(stat(BIP32_ALLOC_BYTES), bip32_alloc_bytes)
+        script, script_len = make_cbuffer('00')
+        ret = wally_tx_get_btc_signature_hash(tx, 0, script, script_len, 0,
+                                              1, 0, sig, 32)
+        self.assertEqual(ret, WALLY_OK)
+        self.assertEqual(stat(SIGHASHES), 1)
+        self.assertEqual(wally_tx_free(tx), WALLY_OK)
+
+        self.assertEqual(wally_reset_stats(0), WALLY_OK)
+        self.assertEqual(stat(EC_SIGNS), 0)
+
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -1,5 +1,8 @@
 import unittest
+from hashlib import sha256
+from struct import pack, unpack
 from util import *
+import util
 
 MAX_SATOSHI = 21000000 * 100000000
 
@@ -9,6 +12,10 @@ TX_MAX_VERSION = 2
 TX_FAKE_HEX = utf8('010000000100000000000000000000000000000000000000000000000000000000000000000000000000000000000100000000000000000000000000')
 TX_HEX = utf8('0100000001be66e10da854e7aea9338c1f91cd489768d1d6d7189f586d7a3613f2a24d5396000000008b483045022100da43201760bda697222002f56266bf65023fef2094519e13077f777baed553b102205ce35d05eabda58cd50a67977a65706347cc25ef43153e309ff210a134722e9e0141042daa93315eebbe2cb9b5c3505df4c6fb6caca8b756786098567550d4820c09db988fe9997d049d687292f815ccd6e7fb5c1b1a91137999818d17c73d0f80aef9ffffffff0123ce0100000000001976a9142bc89c2702e0e618db7d59eb5ce2f0f147b4075488ac00000000')
 TX_WITNESS_HEX = utf8('020000000001012f94ddd965758445be2dfac132c5e75c517edf5ea04b745a953d0bc04c32829901000000006aedc98002a8c500000000000022002009246bbe3beb48cf1f6f2954f90d648eb04d68570b797e104fead9e6c3c87fd40544020000000000160014c221cdfc1b867d82f19d761d4e09f3b6216d8a8304004830450221008aaa56e4f0efa1f7b7ed690944ac1b59f046a59306fcd1d09924936bd500046d02202b22e13a2ad7e16a0390d726c56dfc9f07647f7abcfac651e35e5dc9d830fc8a01483045022100e096ad0acdc9e8261d1cdad973f7f234ee84a6ee68e0b89ff0c1370896e63fe102202ec36d7554d1feac8bc297279f89830da98953664b73d38767e81ee0763b9988014752210390134e68561872313ba59e56700732483f4a43c2de24559cb8c7039f25f7faf821039eb59b267a78f1020f27a83dc5e3b1e4157e4a517774040a196e9f43f08ad17d52ae89a3b720')
+GENESIS_HEADER_HEX = '0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c'
+BLOCK_1_HEADER_HEX = '010000006fe28c0ab6f1b372c1a6a246ae63f74f931e8365e15a089c68d6190000000000982051fd1e4ba744bbbe680e1fee14677ba1a3c3540bf7b1cdb606e857233e0e61bc6649ffff001d01e36299'
+BLOCK_2_HEADER_HEX = '010000004860eb18bf1b1620e37e9490fc8a427514416fd75159ab86688e9a8300000000d5fdcc541e25de1c7a5addedf24858b8bb665c9f36ef744ee42c316022c90f9bb0bc6649ffff001d08d2bd61'
+GENESIS_TX_HEX = '01000000010000000000000000000000000000000000000000000000000000000000000000ffffffff4d04ffff001d0104455468652054696d65732030332f4a616e2f32303039204368616e63656c6c6f72206f6e206272696e6b206f66207365636f6e64206261696c6f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe5548271967f1a67130b7105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6bf11d5fac00000000'
 
 class TransactionTests(unittest.TestCase):
 
@@ -45,6 +52,276 @@ class TransactionTests(unittest.TestCase):
             self.assertEqual(WALLY_OK, wally_tx_from_hex(*args))
             self.assertEqual(args[0], utf8(self.tx_serialize_hex(args[2][0])))
 
+            # Serializing into a caller supplied buffer
+            out = create_string_buffer(len(args[0]) + 1)
+            ret, written = wally_tx_to_hex_to_buffer(args[2], 1, out, len(out) - 1)
+            self.assertEqual((ret, written, out.value), (WALLY_OK, len(out), utf8('')))
+            ret, written = wally_tx_to_hex_to_buffer(args[2], 1, out, len(out))
+            self.assertEqual((ret, written, out.value), (WALLY_OK, len(out), args[0]))
+
+        # Hex encoding a tx larger than the internal stack buffer
+        tx = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_from_hex(TX_WITNESS_HEX, 0, tx))
+        script, script_len = make_cbuffer('51' * 5000)
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script, script_len))
+        ret, tx_len = wally_tx_get_length(tx, 1)
+        ser, ser_len = make_cbuffer('00' * tx_len)
+        self.assertEqual((WALLY_OK, tx_len), wally_tx_to_bytes(tx, 1, ser, ser_len))
+        self.assertEqual(hexlify(ser), utf8(self.tx_serialize_hex(tx[0])))
+
+        # Every truncation of a valid tx fails to decode
+        for tx_hex in [TX_HEX, TX_WITNESS_HEX]:
+            buf, buf_len = make_cbuffer(tx_hex.decode('ascii'))
+            for i in range(buf_len):
+                self.assertEqual(WALLY_EINVAL, wally_tx_from_bytes(buf, i, 0, pointer(wally_tx())))
+
+        # Serializing into every buffer size returns the full length, and
+        # writes the tx once the buffer is large enough
+        for tx_hex in [TX_HEX, TX_WITNESS_HEX]:
+            tx = self.tx_deserialize_hex(tx_hex)
+            for flags in [0, 1]:
+                ret, tx_len = wally_tx_get_length(tx, flags)
+                for i in range(tx_len + 2):
+                    ser, ser_len = make_cbuffer('00' * i)
+                    ret, written = wally_tx_to_bytes(tx, flags, ser, ser_len)
+                    self.assertEqual((ret, written), (WALLY_OK, tx_len))
+                    if i >= tx_len:
+                        ret, hex_ = wally_tx_to_hex(tx, flags)
+                        self.assertEqual(hexlify(ser[:tx_len]), utf8(hex_))
+
+        # Input/output/witness counts larger than the remaining data
+        for tx_hex in ['01000000ffffffffffffffffff',
+                       TX_FAKE_HEX[:92].decode('ascii') + 'fe00000001',
+                       TX_WITNESS_HEX[:12].decode('ascii') + '01' + '00' * 41 + '01' + '00' * 9 + 'fd0001']:
+            buf, buf_len = make_cbuffer(tx_hex + '00' * 8)
+            self.assertEqual(WALLY_EINVAL, wally_tx_from_bytes(buf, buf_len, 0, pointer(wally_tx())))
+
+    def test_to_iovecs(self):
+        """Testing serialization into segments referencing a tx"""
+        WALLY_TX_IOVEC_REF_LEN = 128
+
+        def to_iovecs(tx, flags, buf_len=4096, iov_len=64):
+            buf = create_string_buffer(buf_len)
+            iov = (wally_tx_iovec * iov_len)()
+            written = c_ulong()
+            ret, iov_written = wally_tx_to_iovecs(tx, flags, buf, buf_len, iov, iov_len,
+                                                  byref(written))
+            self.assertEqual(ret, WALLY_OK)
+            return written.value, iov_written, [string_at(v.iov_base, v.iov_len)
+                                                for v in iov[:iov_written]]
+
+        # Long scripts and witness items are referenced, short ones copied
+        long_script, long_len = make_cbuffer('51' * WALLY_TX_IOVEC_REF_LEN)
+        short_script, short_len = make_cbuffer('51' * (WALLY_TX_IOVEC_REF_LEN - 1))
+        tx = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_from_hex(TX_WITNESS_HEX, 0, tx))
+        self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1, long_script, long_len, 0))
+        self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 2, short_script, short_len, 0))
+        stack = POINTER(wally_tx_witness_stack)()
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(2, byref(stack)))
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, long_script, long_len))
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, short_script, short_len))
+        self.assertEqual(WALLY_OK, wally_tx_set_input_witness(tx, 0, stack))
+        wally_tx_witness_stack_free(stack)
+
+        for flags in [0, 1]:
+            expected = unhexlify(wally_tx_to_hex(tx, flags)[1])
+            written, iov_written, segments = to_iovecs(tx, flags)
+            self.assertEqual(b''.join(segments), expected)
+            refs = 2 if flags else 1
+            self.assertEqual(written, len(expected) - refs * long_len)
+            self.assertEqual(iov_written, 2 * refs + 1)
+            self.assertEqual(segments[1::2], [long_script] * refs)
+
+            # Too small buffers return the required sizes only
+            self.assertEqual((written, iov_written), to_iovecs(tx, flags, written - 1)[:2])
+            self.assertEqual((written, iov_written, [b''] * (iov_written - 1)),
+                             to_iovecs(tx, flags, iov_len=iov_written - 1))
+
+        for args in [
+            (None, 0, None, 0, None, 0, byref(c_ulong())), # Null tx
+            (tx, 2, None, 0, None, 0, byref(c_ulong())),   # Unsupported flags
+            (tx, 0, None, 10, None, 0, byref(c_ulong())),  # Null bytes with length
+            (tx, 0, None, 0, None, 10, byref(c_ulong())),  # Null segments with length
+            (tx, 0, None, 0, None, 0, None),               # Null written
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_tx_to_iovecs(*args))
+        wally_tx_free(tx)
+
+    def test_compact_serialization(self):
+        """Testing compact serialization and deserialization"""
+        for tx_hex in [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX, utf8('ff') + TX_FAKE_HEX[2:]]:
+            tx = self.tx_deserialize_hex(tx_hex)
+            for flags in [0, 1]:
+                ret, tx_len = wally_tx_get_length(tx, flags)
+                ret, compact_len = wally_tx_get_compact_length(tx, flags)
+                self.assertEqual(ret, WALLY_OK)
+                self.assertLess(compact_len, tx_len)
+
+                # Too short a buffer returns the required length
+                out, out_len = make_cbuffer('00' * compact_len)
+                self.assertEqual(wally_tx_to_compact_bytes(tx, flags, out, out_len - 1),
+                                 (WALLY_OK, compact_len))
+                self.assertEqual(out, b"\x00" * compact_len)
+                self.assertEqual(wally_tx_to_compact_bytes(tx, flags, out, out_len),
+                                 (WALLY_OK, compact_len))
+
+                # Decoding gives back the original transaction
+                decoded = pointer(wally_tx())
+                self.assertEqual(wally_tx_from_compact_bytes(out, out_len, 0, decoded), WALLY_OK)
+                self.assertEqual(wally_tx_to_hex(decoded, flags), wally_tx_to_hex(tx, flags))
+                wally_tx_free(decoded)
+
+                # Truncated, extended or unknown format data fails to decode
+                for i in range(out_len):
+                    self.assertEqual(wally_tx_from_compact_bytes(out, i, 0, decoded),
+                                     WALLY_EINVAL)
+                ext, ext_len = make_cbuffer(hexlify(out).decode('ascii') + '00')
+                bad, bad_len = make_cbuffer('02' + hexlify(out[1:]).decode('ascii'))
+                for args in [(ext, ext_len, 0), (bad, bad_len, 0), (out, out_len, 1)]:
+                    self.assertEqual(wally_tx_from_compact_bytes(*args, decoded), WALLY_EINVAL)
+            wally_tx_free(tx)
+
+        # The version, input index, amounts and standard scriptPubKeys save
+        # 21 bytes, while the header, a non-final sequence and locktime cost 3
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        ret, tx_len = wally_tx_get_length(tx, 0)
+        ret, compact_len = wally_tx_get_compact_length(tx, 0)
+        self.assertEqual(tx_len - compact_len, 18)
+
+        # Invalid arguments
+        out, out_len = make_cbuffer('00' * 1024)
+        for args in [(None, 0, out, out_len), (tx, 2, out, out_len), (tx, 0, None, out_len)]:
+            self.assertEqual(wally_tx_to_compact_bytes(*args), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_tx_get_compact_length(None, 0), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_tx_from_compact_bytes(None, 0, 0, pointer(wally_tx())),
+                         WALLY_EINVAL)
+        self.assertEqual(wally_tx_from_compact_bytes(out, out_len, 0, None), WALLY_EINVAL)
+        wally_tx_free(tx)
+
+    def test_memory_usage(self):
+        """Testing the memory usage of a transaction"""
+        tx = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_from_hex(TX_HEX, 0, byref(tx)))
+        self.assertEqual(wally_tx_get_memory_usage(None), (WALLY_EINVAL, 0))
+        ret, used = wally_tx_get_memory_usage(tx)
+        self.assertEqual(ret, WALLY_OK)
+        self.assertGreaterEqual(used, sizeof(wally_tx) + 139)
+
+        # Scripts are counted at their length
+        script, script_len = make_cbuffer('51' * 300)
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script, script_len))
+        self.assertEqual(wally_tx_get_memory_usage(tx), (WALLY_OK, used + 300 - 139))
+        _, used = wally_tx_get_memory_usage(tx)
+        wally_tx_free(tx)
+
+    def test_find_inputs_and_outputs(self):
+        """Testing finding inputs by outpoint and outputs by script"""
+        tx = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 0, 0, byref(tx)))
+        index = c_void_p()
+        self.assertEqual(WALLY_OK, wally_tx_index_init_alloc(tx, 0, byref(index)))
+        # The outpoints and scripts of tx, which repeat
+        outpoints, scripts = [], []
+
+        def outpoint(i):
+            return make_cbuffer('%02x' % (i % 7) * 32)[0], i // 7
+
+        def script(i):
+            return make_cbuffer('0014' + '%02x' % (i % 13) * 20)[0] if i % 13 else b''
+
+        def check():
+            self.assertEqual(WALLY_OK, wally_tx_index_update(index, tx))
+            for i in range(75):
+                expected = (outpoints + [outpoint(i)]).index(outpoint(i))
+                txhash, utxo_index = outpoint(i)
+                for idx in [None, index]:
+                    self.assertEqual((WALLY_OK, expected),
+                                     wally_tx_find_input_by_outpoint(tx, idx, txhash, 32,
+                                                                     utxo_index))
+            for i in range(14):
+                expected = (scripts + [script(i)]).index(script(i))
+                for idx in [None, index]:
+                    self.assertEqual((WALLY_OK, expected),
+                                     wally_tx_find_output_by_script(tx, idx, script(i) or None,
+                                                                    len(script(i))))
+
+        # Appended inputs and outputs are added to the index
+        for i in range(70):
+            txhash, utxo_index = outpoint(i)
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, txhash, 32, utxo_index,
+                                                              0xffffffff, None, 0, None, 0))
+            outpoints.append(outpoint(i))
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1000, script(i) or None,
+                                                               len(script(i)), 0))
+            scripts.append(script(i))
+            check()
+        # Removing inputs or outputs rebuilds the index
+        self.assertEqual(WALLY_OK, wally_tx_remove_input(tx, 3))
+        del outpoints[3]
+        self.assertEqual(WALLY_OK, wally_tx_remove_output(tx, 0))
+        del scripts[0]
+        check()
+        indices = (c_uint * 2)(0, 10)
+        self.assertEqual(WALLY_OK, wally_tx_remove_inputs(tx, indices, 2))
+        del outpoints[10]
+        del outpoints[0]
+        check()
+        txhash = bytes(tx.contents.inputs[0].txhash)
+        self.assertEqual(WALLY_OK, wally_tx_remove_input(tx, 0))
+        del outpoints[0]
+        check()
+        self.assertEqual((WALLY_OK, tx.contents.num_inputs),
+                         wally_tx_find_input_by_outpoint(tx, index, txhash, 32, 0))
+
+        # Items changed in place are checked against tx, never misreported
+        txhash, utxo_index = outpoints[0]
+        tx.contents.inputs[0].index = 1000
+        for idx in [None, index]:
+            self.assertEqual((WALLY_OK, tx.contents.num_inputs),
+                             wally_tx_find_input_by_outpoint(tx, idx, txhash, 32, utxo_index))
+        # The changed outpoint is only found once the index is reallocated
+        self.assertEqual((WALLY_OK, 0),
+                         wally_tx_find_input_by_outpoint(tx, None, txhash, 32, 1000))
+        self.assertEqual((WALLY_OK, tx.contents.num_inputs),
+                         wally_tx_find_input_by_outpoint(tx, index, txhash, 32, 1000))
+        # Shrinking the tx past indexed items never returns an out of range index
+        tx.contents.outputs[0].script_len = 1
+        self.assertEqual(WALLY_OK, wally_tx_remove_output(tx, tx.contents.num_outputs - 1))
+        num_outputs = tx.contents.num_outputs
+        for i in range(14):
+            ret, written = wally_tx_find_output_by_script(tx, index, script(i) or None,
+                                                          len(script(i)))
+            self.assertEqual(WALLY_OK, ret)
+            _, linear = wally_tx_find_output_by_script(tx, None, script(i) or None,
+                                                       len(script(i)))
+            self.assertIn(written, [linear, num_outputs])
+        self.assertEqual(WALLY_OK, wally_tx_index_free(index))
+        self.assertEqual(WALLY_OK, wally_tx_index_init_alloc(tx, 0, byref(index)))
+        self.assertEqual((WALLY_OK, 0),
+                         wally_tx_find_input_by_outpoint(tx, index, txhash, 32, 1000))
+        self.assertEqual((WALLY_OK, 0),
+                         wally_tx_find_output_by_script(tx, index, b'\x00', 1))
+
+        txhash = outpoint(0)[0]
+        for args in [(None, 0, byref(index)),  # Null tx
+                     (tx, 1, byref(index)),    # Invalid flags
+                     (tx, 0, None)]:           # Null output
+            self.assertEqual(WALLY_EINVAL, wally_tx_index_init_alloc(*args))
+        for args in [(None, tx),               # Null index
+                     (index, None)]:           # Null tx
+            self.assertEqual(WALLY_EINVAL, wally_tx_index_update(*args))
+        for args in [(None, index, txhash, 32, 0),  # Null tx
+                     (tx, index, None, 32, 0),      # Null txhash
+                     (tx, index, txhash, 31, 0)]:   # Invalid txhash length
+            self.assertEqual((WALLY_EINVAL, 0), wally_tx_find_input_by_outpoint(*args))
+        for args in [(None, index, txhash, 22),     # Null tx
+                     (tx, index, None, 22)]:        # Null script with length
+            self.assertEqual((WALLY_EINVAL, 0), wally_tx_find_output_by_script(*args))
+        self.assertEqual(WALLY_OK, wally_tx_index_free(index))
+        self.assertEqual(WALLY_OK, wally_tx_index_free(None))
+        wally_tx_free(tx)
+
     def test_lengths(self):
         """Testing functions measuring different lengths for a tx"""
         for tx_hex, length in [
@@ -140,6 +417,431 @@ class TransactionTests(unittest.TestCase):
             self.assertEqual(WALLY_OK, wally_tx_remove_input(byref(args[0]), args[0].num_inputs-1))
             self.assertEqual(before, self.tx_serialize_hex(args[0]))
 
+    def test_reserve(self):
+        """Testing functions reserving and growing inputs, outputs and witness items"""
+        self.assertEqual(WALLY_EINVAL, wally_tx_reserve(None, 1, 1))
+        self.assertEqual(WALLY_EINVAL, wally_tx_witness_stack_reserve(None, 1))
+
+        tx = wally_tx()
+        self.assertEqual(WALLY_OK, wally_tx_reserve(tx, 3, 5))
+        self.assertEqual((tx.inputs_allocation_len, tx.outputs_allocation_len), (3, 5))
+        self.assertEqual(WALLY_OK, wally_tx_reserve(tx, 1, 1)) # Never shrinks
+        self.assertEqual((tx.inputs_allocation_len, tx.outputs_allocation_len), (3, 5))
+
+        # Outputs grow geometrically once the reserved space is used
+        script, script_len = make_cbuffer('00')
+        for i in range(6):
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1, script, script_len, 0))
+        self.assertEqual((tx.num_outputs, tx.outputs_allocation_len), (6, 10))
+        self.assertEqual(WALLY_OK, wally_tx_reserve(tx, 0, 0))
+        self.assertEqual(tx.outputs_allocation_len, 10)
+        self.assertEqual(self.tx_serialize_hex(tx),
+                         '000000000006' + '01000000000000000100' * 6 + '00000000')
+
+        stack = wally_tx_witness_stack()
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_reserve(stack, 4))
+        self.assertEqual(stack.items_allocation_len, 4)
+        witness, witness_len = make_cbuffer('00')
+        for i in range(5):
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, witness, witness_len))
+        self.assertEqual((stack.num_items, stack.items_allocation_len), (5, 8))
+
+    def check_lengths(self, tx):
+        _, base_len = wally_tx_get_length(tx, 0)
+        _, total_len = wally_tx_get_length(tx, 1)
+        self.assertEqual(total_len * 2, len(self.tx_serialize_hex(tx)))
+        self.assertEqual(wally_tx_get_weight(tx), (WALLY_OK, base_len * 3 + total_len))
+        weight = base_len * 3 + total_len
+        self.assertEqual(wally_tx_get_vsize(tx), (WALLY_OK, (weight + 3) // 4))
+        ret, num_witnesses = wally_tx_get_witness_count(tx)
+        self.assertEqual((ret, num_witnesses != 0), (WALLY_OK, total_len != base_len))
+
+    def test_modified_lengths(self):
+        """Testing lengths as a transaction is modified"""
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        self.check_lengths(tx)
+
+        script, script_len = make_cbuffer('00' * 300)
+        witness = pointer(wally_tx_witness_stack())
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(2, witness))
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(witness, script, 253))
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add_dummy(witness, 1))
+        for fn, args in [
+            (wally_tx_add_raw_input, (script, 32, 1, 2, script, script_len, witness, 0)),
+            (wally_tx_add_raw_input, (script, 32, 3, 4, None, 0, None, 0)),
+            (wally_tx_add_raw_output, (1000, script, 252, 0)),
+            (wally_tx_set_input_script, (0, script, 10)),
+            (wally_tx_set_input_witness, (0, None)),
+            (wally_tx_set_input_witness, (2, witness)),
+            (wally_tx_remove_output, (0,)),
+            (wally_tx_remove_input, (1,)),
+            (wally_tx_remove_input, (0,)),
+            (wally_tx_set_input_witness, (0, None)),
+            ]:
+            self.assertEqual(WALLY_OK, fn(tx, *args))
+            self.check_lengths(tx)
+        self.assertEqual(wally_tx_get_witness_count(tx), (WALLY_OK, 0))
+
+        # Witnesses and scripts changed directly are reflected in the lengths
+        self.assertEqual(WALLY_OK, wally_tx_set_input_witness(tx, 0, witness))
+        self.check_lengths(tx)
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_set(tx.inputs[0].witness, 1,
+                                                              script, script_len))
+        self.check_lengths(tx)
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(tx.inputs[0].witness,
+                                                              script, script_len))
+        self.check_lengths(tx)
+        tx.outputs[0].script_len -= 1
+        self.check_lengths(tx)
+        tx.outputs[0].script_len += 1
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script, 10))
+        tx.inputs[0].script_len -= 1
+        tx.inputs[0].witness[0].items[0].len -= 1
+        self.check_lengths(tx)
+        tx.inputs[0].script_len += 1
+        tx.inputs[0].witness[0].items[0].len += 1
+        self.check_lengths(tx)
+        wally_tx_witness_stack_free(witness)
+
+    def test_clone(self):
+        """Testing cloning a transaction"""
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        for args in [
+            (None, 0, pointer(wally_tx())), # Null tx
+            (tx, 2, pointer(wally_tx())),   # Unsupported flags
+            (tx, 0, None),                  # Null output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_clone(*args))
+
+        clone_p = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_clone(tx, 0, clone_p))
+        clone = clone_p[0]
+        self.assertEqual(self.tx_serialize_hex(clone), TX_WITNESS_HEX.decode('ascii'))
+        self.check_lengths(clone)
+        # Modifying the clone doesn't change the original
+        self.assertEqual(WALLY_OK, wally_tx_set_input_witness(clone, 0, None))
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(clone, 0, None, 0))
+        self.assertEqual(self.tx_serialize_hex(tx), TX_WITNESS_HEX.decode('ascii'))
+        wally_tx_free(clone)
+
+        # Cloning a tx with no inputs or outputs
+        self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 0, 0, clone_p))
+        empty_p = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_clone(clone_p, 0, empty_p))
+        self.assertEqual(self.tx_serialize_hex(empty_p[0]), '02000000000000000000')
+        for t in [clone_p, empty_p]:
+            wally_tx_free(t)
+
+    def test_clone_read_only(self):
+        """Testing cloning a transaction into a single read-only allocation"""
+        WALLY_TX_CLONE_READ_ONLY = 1
+        WALLY_TX_READ_ONLY = 32 # Set in the features of read-only inputs/outputs
+        script, script_len = make_cbuffer('51')
+        for tx_hex in [TX_WITNESS_HEX, TX_HEX]:
+            tx = self.tx_deserialize_hex(tx_hex)
+            clone_p = pointer(wally_tx())
+            self.assertEqual(WALLY_OK, wally_tx_clone(tx, WALLY_TX_CLONE_READ_ONLY, clone_p))
+            clone = clone_p[0]
+            self.assertNotEqual(addressof(clone), addressof(tx))
+            self.assertEqual(self.tx_serialize_hex(clone), tx_hex.decode('ascii'))
+            self.check_lengths(clone)
+            # The clone is immutable, but is not shared
+            self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(clone))
+            for fn, args in [(wally_tx_set_input_script, (0, script, script_len)),
+                             (wally_tx_add_raw_output, (1, script, script_len, 0)),
+                             (wally_tx_remove_input, (0,)),
+                             (wally_tx_reserve, (10, 10))]:
+                self.assertEqual(WALLY_EINVAL, fn(clone, *args))
+            # As are its inputs, outputs and witness stacks
+            for item in [clone.inputs[0], clone.outputs[0]]:
+                self.assertTrue(item.features & WALLY_TX_READ_ONLY)
+            self.assertEqual(WALLY_EINVAL, wally_tx_input_free(byref(clone.inputs[0])))
+            self.assertEqual(WALLY_EINVAL, wally_tx_output_free(byref(clone.outputs[0])))
+            witness = clone.inputs[0].witness
+            if witness:
+                for fn, args in [(wally_tx_witness_stack_add, (script, script_len)),
+                                 (wally_tx_witness_stack_add_dummy, (1,)),
+                                 (wally_tx_witness_stack_set, (0, script, script_len)),
+                                 (wally_tx_witness_stack_set_dummy, (0, 1)),
+                                 (wally_tx_witness_stack_reserve, (10,))]:
+                    self.assertEqual(WALLY_EINVAL, fn(witness, *args))
+                self.assertEqual(WALLY_EINVAL, wally_tx_witness_stack_free(witness))
+            self.assertEqual(self.tx_serialize_hex(clone), tx_hex.decode('ascii'))
+            ret, usage = wally_tx_get_memory_usage(clone)
+            self.assertEqual(ret, WALLY_OK)
+            self.assertTrue(0 < usage < 64 * 1024)
+            # Its data is held in the same allocation as the transaction
+            block_start = addressof(clone)
+            block_end = block_start + 64 * 1024
+            for ptr in [addressof(clone.inputs[0]), clone.inputs[0].script,
+                        addressof(clone.outputs[0]), clone.outputs[0].script]:
+                self.assertTrue(not ptr or block_start < ptr < block_end)
+            # Clones of the clone are independent of it
+            copy_p = pointer(wally_tx())
+            self.assertEqual(WALLY_OK, wally_tx_clone(clone, 0, copy_p))
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(copy_p, 0, script, script_len))
+            self.assertEqual(WALLY_OK, wally_tx_free(copy_p))
+            # Copies of its inputs, outputs and witness stacks are modifiable
+            self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 1, 1, copy_p))
+            copy = copy_p[0]
+            self.assertEqual(WALLY_OK, wally_tx_add_input(copy, byref(clone.inputs[0])))
+            self.assertEqual(WALLY_OK, wally_tx_add_output(copy, byref(clone.outputs[0])))
+            for item in [copy.inputs[0], copy.outputs[0]]:
+                self.assertFalse(item.features & WALLY_TX_READ_ONLY)
+            if witness:
+                self.assertEqual(WALLY_OK, wally_tx_set_input_witness(copy, 0, witness))
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(copy.inputs[0].witness,
+                                                                      script, script_len))
+            self.assertEqual(WALLY_OK, wally_tx_free(copy_p))
+            # It can be shared, and is freed by its last owner
+            shared = POINTER(wally_tx)()
+            self.assertEqual(WALLY_OK, wally_tx_share(clone_p, byref(shared)))
+            self.assertEqual((WALLY_OK, 1), wally_tx_is_shared(clone))
+            self.assertEqual(WALLY_OK, wally_tx_free(shared))
+            self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(clone))
+            self.assertEqual(self.tx_serialize_hex(clone), tx_hex.decode('ascii'))
+            # Unsharing it replaces it with a modifiable copy
+            unshared = clone_p
+            self.assertEqual(WALLY_OK, wally_tx_unshare(byref(unshared)))
+            self.assertNotEqual(addressof(unshared.contents), block_start)
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(unshared, 0, script, script_len))
+            self.assertEqual(WALLY_OK, wally_tx_free(unshared))
+            wally_tx_free(tx)
+
+        # Cloning a tx with no inputs or outputs
+        empty = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 0, 0, byref(empty)))
+        clone = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_clone(empty, WALLY_TX_CLONE_READ_ONLY, byref(clone)))
+        self.assertEqual(self.tx_serialize_hex(clone[0]), '02000000000000000000')
+        for t in [clone, empty]:
+            self.assertEqual(WALLY_OK, wally_tx_free(t))
+
+    def test_share(self):
+        """Testing sharing transactions between owners"""
+        import threading
+        WALLY_TX_CLONE_READ_ONLY = 1
+        original = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        tx_p = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_clone(original, WALLY_TX_CLONE_READ_ONLY, byref(tx_p)))
+        tx = tx_p[0]
+        shared = POINTER(wally_tx)()
+        # Only read-only clones can be shared
+        for args in [(None, byref(shared)), (tx, None), (original, byref(shared))]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_share(*args))
+        self.assertEqual(WALLY_EINVAL, wally_tx_unshare(None))
+        self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(tx))
+        self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(original))
+
+        # Sharing doesn't copy the transaction, which remains immutable
+        self.assertEqual(WALLY_OK, wally_tx_share(tx, byref(shared)))
+        self.assertEqual(addressof(shared.contents), addressof(tx))
+        self.assertEqual((WALLY_OK, 1), wally_tx_is_shared(tx))
+        script, script_len = make_cbuffer('51')
+        for fn, args in [(wally_tx_set_input_script, (0, script, script_len)),
+                         (wally_tx_set_input_witness, (0, None)),
+                         (wally_tx_add_raw_output, (1, script, script_len, 0)),
+                         (wally_tx_remove_input, (0,)),
+                         (wally_tx_remove_output, (0,)),
+                         (wally_tx_reserve, (10, 10))]:
+            self.assertEqual(WALLY_EINVAL, fn(tx, *args))
+        self.assertEqual(self.tx_serialize_hex(tx), TX_WITNESS_HEX.decode('ascii'))
+
+        # Owners can read the transaction concurrently, and free it in any order
+        owners = [POINTER(wally_tx)() for i in range(4)]
+        for owner in owners:
+            self.assertEqual(WALLY_OK, wally_tx_share(tx, byref(owner)))
+        results = []
+        def read(owner):
+            for i in range(50):
+                results.append(self.tx_serialize_hex(owner) == TX_WITNESS_HEX.decode('ascii'))
+            wally_tx_free(owner)
+        threads = [threading.Thread(target=read, args=(owner,)) for owner in owners]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(results, [True] * 200)
+        self.assertEqual((WALLY_OK, 1), wally_tx_is_shared(tx))
+
+        # Other transactions are shared and released independently
+        others = [POINTER(wally_tx)() for i in range(20)]
+        copies = [POINTER(wally_tx)() for other in others]
+        for other, copy in zip(others, copies):
+            self.assertEqual(WALLY_OK, wally_tx_clone(original, WALLY_TX_CLONE_READ_ONLY, byref(other)))
+            self.assertEqual(WALLY_OK, wally_tx_share(other, byref(copy)))
+        for other, copy in zip(others, copies):
+            self.assertEqual((WALLY_OK, 1), wally_tx_is_shared(other))
+            self.assertEqual(WALLY_OK, wally_tx_free(copy))
+            self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(other))
+            self.assertEqual((WALLY_OK, 1), wally_tx_is_shared(tx))
+            self.assertEqual(WALLY_OK, wally_tx_free(other))
+
+        # Unsharing copies a shared transaction, releasing the original
+        self.assertEqual(WALLY_OK, wally_tx_unshare(byref(shared)))
+        self.assertNotEqual(addressof(shared.contents), addressof(tx))
+        self.assertEqual((WALLY_OK, 0), wally_tx_is_shared(tx))
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(shared, 0, script, script_len))
+        self.assertEqual(self.tx_serialize_hex(tx), TX_WITNESS_HEX.decode('ascii'))
+        self.assertNotEqual(self.tx_serialize_hex(shared), TX_WITNESS_HEX.decode('ascii'))
+        # Unsharing a modifiable transaction leaves it unchanged
+        unshared = pointer(original)
+        self.assertEqual(WALLY_OK, wally_tx_unshare(byref(unshared)))
+        self.assertEqual(addressof(unshared.contents), addressof(original))
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(original, 0, script, script_len))
+        for t in [shared, tx_p, original]:
+            self.assertEqual(WALLY_OK, wally_tx_free(t))
+
+    def test_bulk_removal(self):
+        """Testing removing multiple inputs and outputs"""
+        def make_tx():
+            tx_p = pointer(wally_tx())
+            txhash, txhash_len = make_cbuffer('11' * 32)
+            self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 6, 6, tx_p))
+            for i in range(6):
+                script, script_len = make_cbuffer('51' * (i + 1))
+                self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx_p, txhash, txhash_len, i, 0xffffffff,
+                                                                  script, script_len, None, 0))
+                self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx_p, i, script, script_len, 0))
+            return tx_p[0]
+
+        tx, expected = make_tx(), make_tx()
+        indices = (c_uint * 3)(0, 2, 5)
+        for args in [
+            (None, indices, 3),                  # Null tx
+            (tx, None, 3),                       # Null indices
+            (tx, (c_uint * 1)(6), 1),            # Index out of range
+            (tx, (c_uint * 2)(2, 2), 2),         # Duplicate index
+            (tx, (c_uint * 2)(3, 1), 2),         # Not in increasing order
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_remove_inputs(*args))
+        self.assertEqual(WALLY_OK, wally_tx_remove_inputs(tx, None, 0))
+        self.assertEqual(WALLY_OK, wally_tx_remove_inputs(tx, indices, 3))
+        for i in [5, 2, 0]:
+            self.assertEqual(WALLY_OK, wally_tx_remove_input(expected, i))
+        self.assertEqual(tx.num_inputs, 3)
+        self.assertEqual(self.tx_serialize_hex(tx), self.tx_serialize_hex(expected))
+        self.check_lengths(tx)
+
+        mask, mask_len = make_cbuffer('000101000001')
+        for args in [
+            (None, mask, mask_len), # Null tx
+            (tx, None, mask_len),   # Null mask
+            (tx, mask, 5),          # Mask length doesn't match the outputs
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_retain_outputs(*args))
+        self.assertEqual(WALLY_OK, wally_tx_retain_outputs(tx, mask, mask_len))
+        for i in [4, 3, 0]:
+            self.assertEqual(WALLY_OK, wally_tx_remove_output(expected, i))
+        self.assertEqual((tx.num_outputs, tx.outputs_allocation_len), (3, 6))
+        self.assertEqual(self.tx_serialize_hex(tx), self.tx_serialize_hex(expected))
+        self.check_lengths(tx)
+        for t in [tx, expected]:
+            wally_tx_free(t)
+
+    def test_input_limits(self):
+        """Testing transaction length and witness item limits"""
+        LIMIT_TX_LEN, LIMIT_TX_WITNESS_ITEMS = 0, 1
+        tx_len = len(TX_WITNESS_HEX) // 2
+        tx_bytes, _ = make_cbuffer(TX_WITNESS_HEX.decode('ascii'))
+        try:
+            for limit, expected in [(tx_len, WALLY_OK), (tx_len - 1, WALLY_EINVAL)]:
+                self.assertEqual(wally_set_input_limit(LIMIT_TX_LEN, limit), WALLY_OK)
+                for flags in [0, 0x4]: # Also with FLAG_SKIP_WITNESS_DECODE
+                    tx = POINTER(wally_tx)()
+                    self.assertEqual(wally_tx_from_hex(TX_WITNESS_HEX, flags, byref(tx)),
+                                     expected)
+                    self.assertEqual(wally_tx_from_bytes(tx_bytes, tx_len, flags, byref(tx)),
+                                     expected)
+                    wally_tx_free(tx)
+            wally_set_input_limit(LIMIT_TX_LEN, 0)
+
+            # The first input has a 4 item witness stack
+            for limit, expected in [(4, WALLY_OK), (3, WALLY_EINVAL)]:
+                self.assertEqual(wally_set_input_limit(LIMIT_TX_WITNESS_ITEMS, limit), WALLY_OK)
+                tx = POINTER(wally_tx)()
+                self.assertEqual(wally_tx_from_hex(TX_WITNESS_HEX, 0, byref(tx)), expected)
+                wally_tx_free(tx)
+                self.assertEqual(wally_tx_from_hex(TX_HEX, 0, byref(tx)), WALLY_OK)
+                wally_tx_free(tx)
+        finally:
+            wally_set_input_limit(LIMIT_TX_LEN, 0)
+            wally_set_input_limit(LIMIT_TX_WITNESS_ITEMS, 0)
+
+    def test_skip_witness_decode(self):
+        """Testing decoding without decoding witness stacks"""
+        FLAG_SKIP_WITNESS_DECODE = 0x4
+        self.assertEqual(WALLY_EINVAL, wally_tx_from_hex(TX_WITNESS_HEX,
+                                                         FLAG_SKIP_WITNESS_DECODE | 0x2,
+                                                         pointer(wally_tx())))
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        tx_p = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_from_hex(TX_WITNESS_HEX, FLAG_SKIP_WITNESS_DECODE,
+                                                     tx_p))
+        skipped = tx_p[0]
+        # The witnesses are not decoded, so the tx has the serialization
+        # and lengths of the original without its witnesses
+        for i in range(tx.num_inputs):
+            self.assertFalse(skipped.inputs[i].witness)
+        self.assertEqual(wally_tx_to_hex(tx, 0), wally_tx_to_hex(skipped, 0))
+        self.assertEqual(wally_tx_get_witness_count(skipped), (WALLY_OK, 0))
+        _, base_len = wally_tx_get_length(tx, 0)
+        self.assertEqual(wally_tx_get_length(skipped, 1), (WALLY_OK, base_len))
+        self.check_lengths(skipped)
+        wally_tx_free(skipped)
+
+        # The offsets of the skipped witnesses are reported
+        tx_bytes, tx_len = make_cbuffer(TX_WITNESS_HEX.decode('ascii'))
+        offsets = (c_ulong * tx.num_inputs)()
+        written = c_ulong()
+        def skip_witness(flags, offsets, num_offsets):
+            tx_p = POINTER(wally_tx)()
+            ret = wally_tx_from_bytes_skip_witness(tx_bytes, tx_len, flags, offsets,
+                                                   num_offsets, byref(written), byref(tx_p))
+            return ret, written.value, tx_p
+
+        for flags in [0x2, 0x4]: # Elements, or the implied flag, are invalid
+            ret, num_inputs, tx_p = skip_witness(flags, offsets, tx.num_inputs)
+            self.assertEqual((ret, num_inputs, bool(tx_p)), (WALLY_EINVAL, 0, False))
+        for num_offsets in [1, 0, tx.num_inputs]:
+            ret, num_inputs, tx_p = skip_witness(0, offsets if num_offsets else None,
+                                                 num_offsets)
+            self.assertEqual((ret, num_inputs), (WALLY_OK, tx.num_inputs))
+            if num_offsets:
+                self.assertTrue(offsets[0] != 0)
+            if num_offsets == 1 and tx.num_inputs > 1:
+                self.assertEqual(offsets[1], 0)
+            wally_tx_free(tx_p)
+
+        # Decoding the witnesses from their offsets recovers the original tx
+        ret, _, tx_p = skip_witness(0, offsets, tx.num_inputs)
+        self.assertEqual(ret, WALLY_OK)
+        for i in range(tx.num_inputs):
+            stack = POINTER(wally_tx_witness_stack)()
+            ret = wally_tx_witness_stack_from_bytes(tx_bytes[offsets[i]:],
+                                                    tx_len - offsets[i],
+                                                    byref(written), byref(stack))
+            self.assertEqual(ret, WALLY_OK)
+            end = offsets[i + 1] if i + 1 < tx.num_inputs else tx_len - 4
+            self.assertEqual(offsets[i] + written.value, end)
+            self.assertEqual(WALLY_OK, wally_tx_set_input_witness(tx_p, i, stack))
+            wally_tx_witness_stack_free(stack)
+        self.assertEqual(self.tx_serialize_hex(tx_p), TX_WITNESS_HEX.decode('ascii'))
+        wally_tx_free(tx_p)
+
+        # Invalid or truncated stacks are rejected
+        for stack_hex in ['', '01', '0201aa', '01fd', '0102aa', 'fd0100']:
+            stack_bytes, stack_len = make_cbuffer(stack_hex)
+            stack = POINTER(wally_tx_witness_stack)()
+            ret = wally_tx_witness_stack_from_bytes(stack_bytes, stack_len,
+                                                    byref(written), byref(stack))
+            self.assertEqual((ret, written.value, bool(stack)), (WALLY_EINVAL, 0, False))
+        # Empty stacks decode to NULL, and trailing bytes are ignored
+        stack_bytes, stack_len = make_cbuffer('0001aa')
+        ret = wally_tx_witness_stack_from_bytes(stack_bytes, stack_len,
+                                                byref(written), byref(stack))
+        self.assertEqual((ret, written.value, bool(stack)), (WALLY_OK, 1, False))
+
     def test_witness(self):
         """Testing functions manipulating witness"""
         witness, witness_len = make_cbuffer('00')
@@ -155,6 +857,1866 @@ class TransactionTests(unittest.TestCase):
             self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(*args))
             # To test the expected stack, it should be included in serialized transaction
 
+        # Replacing an item with one of the same or shorter length reuses its buffer
+        stack = pointer(wally_tx_witness_stack())
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(1, stack))
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_add_dummy(stack, 0x2)) # DUMMY_SIG
+        item = stack[0].items[0]
+        dummy_p, dummy_len = item.witness, item.len
+        for sig_hex in ['11' * dummy_len, '22' * (dummy_len - 1)]:
+            sig, sig_len = make_cbuffer(sig_hex)
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_set(stack, 0, sig, sig_len))
+            item = stack[0].items[0]
+            self.assertEqual((item.witness, item.len), (dummy_p, sig_len))
+            self.assertEqual(string_at(item.witness, item.len), string_at(sig, sig_len))
+        for sig_hex in ['33' * dummy_len, '']:
+            sig, sig_len = make_cbuffer(sig_hex)
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_set(stack, 0, sig, sig_len))
+            item = stack[0].items[0]
+            self.assertEqual(item.len, sig_len)
+            self.assertEqual(string_at(item.witness, item.len) if sig_len else item.witness,
+                             string_at(sig, sig_len) if sig_len else None)
+        wally_tx_witness_stack_free(stack)
+
+        # Items may be replaced, or set from the data of other items
+        def stack_items(stack):
+            items = [stack[0].items[i] for i in range(stack[0].num_items)]
+            return [string_at(i.witness, i.len) if i.len else b'' for i in items]
+
+        tx = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_from_hex(TX_WITNESS_HEX, 0, tx))
+        stack = tx[0].inputs[0].witness
+        expected = stack_items(stack)
+        self.assertEqual([len(e) for e in expected], [0, 72, 72, 71])
+        big, big_len = make_cbuffer('44' * 100)
+        self.assertEqual(WALLY_OK, wally_tx_witness_stack_set(stack, 1, big, big_len))
+        expected[1] = b'\x44' * 100
+        self.assertEqual(stack_items(stack), expected)
+        for i in range(20):
+            src = stack[0].items[3]
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, src.witness, src.len))
+            expected.append(expected[3])
+            self.assertEqual(stack_items(stack), expected)
+        clone = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_clone(tx, 0, clone))
+        self.assertEqual(stack_items(clone[0].inputs[0].witness), expected)
+        wally_tx_free(clone)
+        wally_tx_free(tx)
+
+        # The same applies to scripts
+        tx = self.tx_deserialize_hex(TX_HEX)
+        script_p, script_len = tx.inputs[0].script, tx.inputs[0].script_len
+        sig, sig_len = make_cbuffer('44' * (script_len - 1))
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, sig, sig_len))
+        self.assertEqual((tx.inputs[0].script, tx.inputs[0].script_len), (script_p, sig_len))
+        self.check_lengths(tx)
+
+    def test_txid_from_bytes(self):
+        """Testing functions computing txids from serialized bytes"""
+        fake, fake_len = make_cbuffer(TX_FAKE_HEX)
+        out, out_len = make_cbuffer('00'*32)
+        for fn in [wally_tx_get_txid_from_bytes, wally_tx_get_wtxid_from_bytes]:
+            for args in [
+                (None, fake_len, 0, out, out_len), # Empty bytes
+                (fake, fake_len-1, 0, out, out_len), # Short bytes
+                (fake, fake_len, 2, out, out_len), # Unsupported flag
+                (fake, fake_len, 0, None, out_len), # Empty output
+                (fake, fake_len, 0, out, out_len-1), # Invalid output length
+                ]:
+                self.assertEqual(WALLY_EINVAL, fn(*args))
+        self.assertEqual(WALLY_EINVAL, wally_tx_get_wtxid_from_bytes(fake, fake_len, 1, out, out_len))
+
+        expected, expected_len = make_cbuffer('00'*32)
+        for tx_hex in [TX_FAKE_HEX, TX_HEX, TX_WITNESS_HEX]:
+            buf, buf_len = make_cbuffer(tx_hex)
+            tx = self.tx_deserialize_hex(tx_hex)
+            for fn, flags in [(wally_tx_get_txid_from_bytes, 0),
+                              (wally_tx_get_wtxid_from_bytes, 1)]:
+                ser, ser_len = make_cbuffer('00'*1000)
+                ret, written = wally_tx_to_bytes(tx, flags, ser, ser_len)
+                self.assertEqual(WALLY_OK, ret)
+                self.assertEqual(WALLY_OK, wally_sha256d(ser, written, expected, expected_len))
+                self.assertEqual(WALLY_OK, fn(buf, buf_len, 0, out, out_len))
+                self.assertEqual(h(expected), h(out))
+
+    def test_output_script_types(self):
+        """Testing batch classification of output scripts"""
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        scripts = ['76a914' + '11'*20 + '88ac', # P2PKH
+                   'a914' + '11'*20 + '87', # P2SH
+                   '6a04' + '11'*4, # OP_RETURN
+                   '5121' + '02'*33 + '51ae', # 1of1 multisig
+                   '5121' + '02'*33 + '52ae', # Invalid multisig
+                   '51'] # Unknown
+        for script in scripts:
+            buf, buf_len = make_cbuffer(script)
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1000, buf, buf_len, 0))
+        expected = [0x10, 0x8, 0x2, 0x4, 0x1, 0x20, 0x0, 0x0]
+
+        ser, ser_len = make_cbuffer('00'*1000)
+        ret, ser_len = wally_tx_to_bytes(tx, 1, ser, ser_len)
+        self.assertEqual(WALLY_OK, ret)
+        out, out_len = make_cbuffer('ff'*len(expected))
+
+        for args in [
+            (None, out, out_len), # Empty tx
+            (tx, None, out_len), # Empty output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_get_output_script_types(*args)[0])
+        for args in [
+            (None, ser_len, 0, out, out_len), # Empty bytes
+            (ser, ser_len-1, 0, out, out_len), # Short bytes
+            (ser, ser_len, 2, out, out_len), # Unsupported flag
+            (ser, ser_len, 0, None, out_len), # Empty output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_get_output_script_types_from_bytes(*args)[0])
+
+        # A short output buffer is left untouched, returning the size required
+        self.assertEqual((WALLY_OK, len(expected)),
+                         wally_tx_get_output_script_types(tx, out, out_len-1))
+        self.assertEqual((WALLY_OK, len(expected)),
+                         wally_tx_get_output_script_types_from_bytes(ser, ser_len, 0, out, out_len-1))
+        self.assertEqual(out, b'\xff' * len(expected))
+
+        for fn, args in [(wally_tx_get_output_script_types, (tx, )),
+                         (wally_tx_get_output_script_types_from_bytes, (ser, ser_len, 0))]:
+            out, out_len = make_cbuffer('ff'*len(expected))
+            self.assertEqual((WALLY_OK, len(expected)), fn(*args + (out, out_len)))
+            self.assertEqual(list(out), expected)
+
+        # Each type matches classifying the added outputs one at a time
+        for script, script_type in zip(scripts, expected[2:]):
+            buf, buf_len = make_cbuffer(script)
+            self.assertEqual((WALLY_OK, script_type), wally_scriptpubkey_get_type(buf, buf_len))
+
+    def test_block_header_verify_chain(self):
+        """Testing block header chain verification"""
+        headers_hex = GENESIS_HEADER_HEX + BLOCK_1_HEADER_HEX + BLOCK_2_HEADER_HEX
+        headers, headers_len = make_cbuffer(headers_hex)
+        zeros, zeros_len = make_cbuffer('00' * 32)
+        out, out_len = make_cbuffer('00' * 32)
+        for args in [
+            (None, headers_len, None, 0, 0, out, out_len), # Empty bytes
+            (headers, 0, None, 0, 0, out, out_len), # Empty bytes
+            (headers, 79, None, 0, 0, out, out_len), # Partial header
+            (headers, headers_len, None, 32, 0, out, out_len), # Missing prev_hash
+            (headers, headers_len, zeros, 31, 0, out, out_len), # Bad prev_hash length
+            (headers, headers_len, None, 0, 1, out, out_len), # Unsupported flags
+            (headers, headers_len, None, 0, 0, out, 31), # Bad output length
+            (headers, headers_len, None, 0, 0, None, out_len), # Missing output
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_block_header_verify_chain(*args))
+
+        # The genesis block follows the all zero hash
+        for prev, prev_len in [(None, 0), (zeros, zeros_len)]:
+            ret = wally_block_header_verify_chain(headers, headers_len, prev, prev_len,
+                                                 0, out, out_len)
+            self.assertEqual(ret, (WALLY_OK, 3))
+            self.assertEqual(h(out[::-1]), utf8('000000006a625f06636b8bb6ac7b960a8d03705d1ace08b1a19da3fdcc99ddbd'))
+        # Verifying in several calls gives the same tip
+        self.assertEqual((WALLY_OK, 1), wally_block_header_verify_chain(
+            headers, 80, None, 0, 0, out, out_len))
+        self.assertEqual((WALLY_OK, 2), wally_block_header_verify_chain(
+            headers[80:], 160, out, out_len, 0, None, 0))
+
+        # Out of order or modified headers are rejected where they fail
+        for bad_hex, index in [
+            (GENESIS_HEADER_HEX + BLOCK_2_HEADER_HEX, 1), # Missing block 1
+            (headers_hex[:-2] + '00', 2), # Nonce changed, hash too large
+            (GENESIS_HEADER_HEX + BLOCK_1_HEADER_HEX[:144] + 'ffff801d' + BLOCK_1_HEADER_HEX[152:], 1), # Negative target
+            (GENESIS_HEADER_HEX + BLOCK_1_HEADER_HEX[:144] + 'ffff0022' + BLOCK_1_HEADER_HEX[152:], 1), # Overflowed target
+            ]:
+            bad, bad_len = make_cbuffer(bad_hex)
+            self.assertEqual((WALLY_EINVAL, index), wally_block_header_verify_chain(
+                bad, bad_len, None, 0, 0, out, out_len))
+        self.assertEqual((WALLY_EINVAL, 0), wally_block_header_verify_chain(
+            headers, headers_len, out, out_len, 0, None, 0))
+
+        # Chains longer than a single hashing batch link across batches
+        chain = [GENESIS_HEADER_HEX]
+        for i in range(60):
+            prev = make_cbuffer(chain[-1])[0]
+            tip, _ = make_cbuffer('00' * 32)
+            wally_block_get_hash(prev, 80, tip, 32)
+            # A minimal difficulty target that any hash meets
+            chain.append('01000000' + h(tip).decode() + '00' * 32 + '29ab5f49' + 'ffff0021' + '%08x' % i)
+        long_chain, long_len = make_cbuffer(''.join(chain))
+        self.assertEqual((WALLY_OK, 61), wally_block_header_verify_chain(
+            long_chain, long_len, None, 0, 0, None, 0))
+
+    def test_block(self):
+        """Testing block header parsing and transaction iteration"""
+        block, block_len = make_cbuffer(GENESIS_HEADER_HEX + '01' + GENESIS_TX_HEX)
+        header = wally_block_header()
+        for args in [
+            (None, block_len, header), # Empty bytes
+            (block, 79, header), # Short header
+            (block, block_len, None), # Empty output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_block_header_from_bytes(*args))
+        self.assertEqual(WALLY_OK, wally_block_header_from_bytes(block, 80, header))
+        self.assertEqual((header.version, header.timestamp, header.bits, header.nonce),
+                         (1, 1231006505, 0x1d00ffff, 2083236893))
+        self.assertEqual(bytes(header.prev_block_hash), b'\x00' * 32)
+        self.assertEqual(bytes(header.merkle_root), block[36:68])
+
+        out, out_len = make_cbuffer('00'*32)
+        self.assertEqual(WALLY_EINVAL, wally_block_get_hash(block, 79, out, out_len))
+        self.assertEqual(WALLY_OK, wally_block_get_hash(block, block_len, out, out_len))
+        self.assertEqual(h(out[::-1]), utf8('000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f'))
+
+        it = wally_block_iterator()
+        for args in [
+            (None, block_len, 0, it), # Empty bytes
+            (block, 80, 0, it), # Missing transaction count
+            (make_cbuffer(GENESIS_HEADER_HEX + '00')[0], 81, 0, it), # No transactions
+            (block, block_len, 2, it), # Unsupported flags
+            (block, block_len, 0, None), # Empty output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_block_iterator_init(*args))
+
+        # The genesis block has a single transaction whose txid is the merkle root
+        tx_bytes, tx_len = c_void_p(), c_ulong()
+        self.assertEqual(WALLY_OK, wally_block_iterator_init(block, block_len, 0, it))
+        self.assertEqual(WALLY_EINVAL, wally_block_iterator_next(it, None, byref(tx_len), out, out_len))
+        self.assertEqual(WALLY_EINVAL, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), out, 31))
+        self.assertEqual(WALLY_OK, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), out, out_len))
+        self.assertEqual(string_at(tx_bytes, tx_len.value), unhexlify(GENESIS_TX_HEX))
+        self.assertEqual(out, block[36:68])
+        self.assertEqual(WALLY_OK, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), None, 0))
+        self.assertEqual((tx_bytes.value, tx_len.value), (None, 0))
+
+        # Transactions with and without witnesses
+        txs = [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX]
+        block_hex = utf8(GENESIS_HEADER_HEX + '03') + b''.join(txs)
+        for extra, expected in [('', WALLY_OK), ('00', WALLY_EINVAL)]:
+            block, block_len = make_cbuffer(block_hex + utf8(extra))
+            txid, txid_len = make_cbuffer('00'*32)
+            self.assertEqual(WALLY_OK, wally_block_iterator_init(block, block_len, 0, it))
+            for tx_hex in txs:
+                self.assertEqual(WALLY_OK, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), out, out_len))
+                self.assertEqual(h(string_at(tx_bytes, tx_len.value)), tx_hex)
+                buf, buf_len = make_cbuffer(tx_hex)
+                self.assertEqual(WALLY_OK, wally_tx_get_txid_from_bytes(buf, buf_len, 0, txid, txid_len))
+                self.assertEqual(txid, out)
+            self.assertEqual(expected, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), None, 0))
+
+        # Truncated block
+        block, block_len = make_cbuffer(block_hex[:-2])
+        self.assertEqual(WALLY_OK, wally_block_iterator_init(block, block_len, 0, it))
+        for i in range(2):
+            self.assertEqual(WALLY_OK, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), None, 0))
+        self.assertEqual(WALLY_EINVAL, wally_block_iterator_next(it, byref(tx_bytes), byref(tx_len), None, 0))
+
+    def test_block_get_txids(self):
+        """Testing computing the txids of a block in parallel"""
+        WALLY_TX_FLAG_USE_WITNESS = 0x1
+        txs = [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX]
+        root, root_len = make_cbuffer('00' * 32)
+
+        # Blocks that fit in one task and blocks split across many
+        for num_txs in [1, 3, 1000]:
+            block_txs = [txs[i % len(txs)] for i in range(num_txs)]
+            count = '%02x' % num_txs if num_txs < 0xfd else 'fd' + h(pack('<H', num_txs)).decode()
+            block, block_len = make_cbuffer(utf8(GENESIS_HEADER_HEX + count) + b''.join(block_txs))
+            txids, wtxids = b'', b''
+            for tx_hex in block_txs:
+                buf, buf_len = make_cbuffer(tx_hex)
+                txid, wtxid = make_cbuffer('00' * 32)[0], make_cbuffer('00' * 32)[0]
+                self.assertEqual(WALLY_OK, wally_tx_get_txid_from_bytes(buf, buf_len, 0, txid, 32))
+                self.assertEqual(WALLY_OK, wally_tx_get_wtxid_from_bytes(buf, buf_len, 0, wtxid, 32))
+                txids, wtxids = txids + txid, wtxids + wtxid
+            expected_root, _ = make_cbuffer('00' * 32)
+            self.assertEqual(WALLY_OK, wally_merkle_root(txids, len(txids), expected_root, 32))
+
+            for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                for flags, expected in [(0, txids), (WALLY_TX_FLAG_USE_WITNESS, txids + wtxids)]:
+                    out, out_len = make_cbuffer('00' * len(expected))
+                    ret, written = wally_block_get_txids(block, block_len, flags, run_fn, None,
+                                                         root, root_len, out, out_len)
+                    self.assertEqual((ret, written), (WALLY_OK, len(expected)))
+                    self.assertEqual(out, expected)
+                    self.assertEqual(root, expected_root)
+                    # Short buffers return the required length
+                    self.assertEqual((WALLY_OK, len(expected)),
+                                     wally_block_get_txids(block, block_len, flags, run_fn, None,
+                                                           None, 0, out, out_len - 1))
+
+        # The merkle root of the genesis block is its coinbase txid
+        genesis, genesis_len = make_cbuffer(GENESIS_HEADER_HEX + '01' + GENESIS_TX_HEX)
+        out, out_len = make_cbuffer('00' * 32)
+        self.assertEqual((WALLY_OK, 32), wally_block_get_txids(genesis, genesis_len, 0, run_tasks_fn_t(), None,
+                                                                root, root_len, out, out_len))
+        self.assertEqual((out, root), (genesis[36:68], genesis[36:68]))
+
+        out, out_len = make_cbuffer('00' * 32 * 1000)
+        trailing, trailing_len = make_cbuffer(h(block) + b'00')
+        for args in [
+            (None, block_len, 0, None, 0),      # Empty bytes
+            (block, block_len, 2, None, 0),     # Unsupported flags
+            (block, block_len, 0, root, 31),    # Short merkle root
+            (trailing, trailing_len, 0, None, 0), # Trailing data
+            (block, block_len - 1, 0, None, 0), # Truncated block
+            ]:
+            ret = wally_block_get_txids(args[0], args[1], args[2], run_tasks_fn_t(), None,
+                                        args[3], args[4], out, out_len)
+            self.assertEqual((WALLY_EINVAL, 0), ret)
+        self.assertEqual((WALLY_EINVAL, 0), wally_block_get_txids(
+            block, block_len, 0, run_tasks_fn_t(), None, None, 0, None, out_len))
+
+    def test_bip152_short_ids(self):
+        """Testing BIP 152 compact block short ids"""
+        WALLY_TX_FLAG_USE_WITNESS, WALLY_BIP152_NO_MATCH = 0x1, 0xffffffff
+        txs = [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX]
+        block_hex = utf8(GENESIS_HEADER_HEX + '03') + b''.join(txs)
+        block, block_len = make_cbuffer(block_hex)
+        nonce = 0x0123456789abcdef
+
+        # The key is the start of SHA256(header || nonce)
+        key, key_len = make_cbuffer('00' * 16)
+        for args in [
+            (None, block_len, nonce, key, key_len), # Empty bytes
+            (block, 79, nonce, key, key_len), # Short header
+            (block, block_len, nonce, None, key_len), # Empty output
+            (block, block_len, nonce, key, 15), # Bad output length
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_bip152_short_id_key(*args))
+        self.assertEqual(WALLY_OK, wally_bip152_short_id_key(block, 80, nonce, key, key_len))
+        self.assertEqual(key, sha256(block[:80] + pack('<Q', nonce)).digest()[:16])
+
+        # Short ids are the SipHash of each txid/wtxid, truncated to 6 bytes
+        value = c_ulonglong()
+        hashes = {0: b'', WALLY_TX_FLAG_USE_WITNESS: b''}
+        expected = {0: b'', WALLY_TX_FLAG_USE_WITNESS: b''}
+        for tx_hex in txs:
+            buf, buf_len = make_cbuffer(tx_hex)
+            for flags, fn in [(0, wally_tx_get_txid_from_bytes),
+                              (WALLY_TX_FLAG_USE_WITNESS, wally_tx_get_wtxid_from_bytes)]:
+                txhash, txhash_len = make_cbuffer('00' * 32)
+                self.assertEqual(WALLY_OK, fn(buf, buf_len, 0, txhash, txhash_len))
+                self.assertEqual(WALLY_OK, wally_siphash24(key, key_len, txhash, txhash_len, value))
+                hashes[flags] += txhash
+                expected[flags] += pack('<Q', value.value)[:6]
+        self.assertNotEqual(expected[0], expected[WALLY_TX_FLAG_USE_WITNESS])
+
+        out, out_len = make_cbuffer('00' * 18)
+        for flags in hashes:
+            txhashes = hashes[flags]
+            self.assertEqual(WALLY_OK, wally_bip152_short_ids(key, key_len, txhashes, len(txhashes), out, out_len))
+            self.assertEqual(out, expected[flags])
+            self.assertEqual((WALLY_OK, out_len), wally_block_get_short_ids(block, block_len, nonce, flags, out, out_len))
+            self.assertEqual(out, expected[flags])
+            # Too short an output returns the required length
+            self.assertEqual((WALLY_OK, out_len), wally_block_get_short_ids(block, block_len, nonce, flags, out, 17))
+
+        txhashes = hashes[0]
+        for args in [
+            (None, key_len, txhashes, 96, out, out_len), # Empty key
+            (key, 15, txhashes, 96, out, out_len), # Bad key length
+            (key, key_len, None, 96, out, out_len), # Empty hashes
+            (key, key_len, txhashes, 0, out, out_len), # Empty hashes
+            (key, key_len, txhashes, 95, out, out_len), # Partial hash
+            (key, key_len, txhashes, 96, None, out_len), # Empty output
+            (key, key_len, txhashes, 96, out, 17), # Bad output length
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_bip152_short_ids(*args))
+
+        bad_block, bad_block_len = make_cbuffer(block_hex + utf8('00'))
+        for args in [
+            (None, block_len, nonce, 0, out, out_len), # Empty block
+            (block, 80, nonce, 0, out, out_len), # Missing transaction count
+            (bad_block, bad_block_len, nonce, 0, out, out_len), # Trailing data
+            (block, block_len - 1, nonce, 0, out, out_len), # Truncated block
+            (block, block_len, nonce, 2, out, out_len), # Unsupported flags
+            (block, block_len, nonce, 0, None, out_len), # Empty output
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_block_get_short_ids(*args))
+
+        # Match the short ids against a mempool in a different order, with
+        # an extra transaction and one missing
+        short_ids = expected[0]
+        mempool = hashes[0][64:] + b'\x11' * 32 + hashes[0][:32]
+        indices = (c_uint * 3)()
+        self.assertEqual((WALLY_OK, 2), wally_bip152_short_ids_match(
+            key, key_len, short_ids, len(short_ids), mempool, len(mempool), indices, 3))
+        self.assertEqual(list(indices), [2, WALLY_BIP152_NO_MATCH, 0])
+        # Short ids that match more than one transaction are not matched
+        mempool += hashes[0][:32]
+        self.assertEqual((WALLY_OK, 1), wally_bip152_short_ids_match(
+            key, key_len, short_ids, len(short_ids), mempool, len(mempool), indices, 3))
+        self.assertEqual(list(indices), [WALLY_BIP152_NO_MATCH, WALLY_BIP152_NO_MATCH, 0])
+        # An empty mempool matches nothing
+        self.assertEqual((WALLY_OK, 0), wally_bip152_short_ids_match(
+            key, key_len, short_ids, len(short_ids), None, 0, indices, 3))
+        self.assertEqual(list(indices), [WALLY_BIP152_NO_MATCH] * 3)
+        for args in [
+            (None, key_len, short_ids, 18, mempool, 96, indices, 3), # Empty key
+            (key, 15, short_ids, 18, mempool, 96, indices, 3), # Bad key length
+            (key, key_len, None, 18, mempool, 96, indices, 3), # Empty short ids
+            (key, key_len, short_ids, 17, mempool, 96, indices, 3), # Partial short id
+            (key, key_len, short_ids, 18, None, 96, indices, 3), # Empty hashes
+            (key, key_len, short_ids, 18, mempool, 95, indices, 3), # Partial hash
+            (key, key_len, short_ids, 18, mempool, 96, None, 3), # Empty output
+            (key, key_len, short_ids, 18, mempool, 96, indices, 2), # Bad output length
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_bip152_short_ids_match(*args))
+
+    def test_bip158_filters(self):
+        """Testing BIP 158 basic block filters"""
+        OP_RETURN_SCRIPT = '6a0100'
+
+        def gcs_filter(block_hash, scripts):
+            # Reference Golomb-Rice coded set construction
+            key = block_hash[:16]
+            items = sorted(set(scripts))
+            value, values = c_ulonglong(), []
+            for item in items:
+                self.assertEqual(WALLY_OK, wally_siphash24(key, 16, item, len(item), value))
+                values.append((value.value * len(items) * 784931) >> 64)
+            bits, prev = '', 0
+            for v in sorted(values):
+                delta = v - prev
+                bits += '1' * (delta >> 19) + '0' + format(delta & 0x7ffff, '019b')
+                prev = v
+            bits += '0' * (-len(bits) % 8)
+            encoded = bytes(int(bits[i:i + 8], 2) for i in range(0, len(bits), 8))
+            return bytes([len(items)]) + encoded
+
+        def make_scripts(scripts):
+            lens = (c_uint * max(len(scripts), 1))(*[len(s) for s in scripts])
+            return b''.join(scripts), sum(len(s) for s in scripts), lens, len(scripts)
+
+        # The BIP 158 test vector for the testnet genesis block
+        testnet_genesis = GENESIS_HEADER_HEX[:136] + 'dae5494dffff001d1aa4ae18'
+        block, block_len = make_cbuffer(testnet_genesis + '01' + GENESIS_TX_HEX)
+        block_hash, block_hash_len = make_cbuffer('00' * 32)
+        self.assertEqual(WALLY_OK, wally_block_get_hash(block, block_len, block_hash, block_hash_len))
+        out, out_len = make_cbuffer('00' * 256)
+        ret, written = wally_block_get_bip158_filter(block, block_len, None, 0, None, 0, 0, out, out_len)
+        self.assertEqual((ret, h(out[:written])), (WALLY_OK, utf8('019dfca8')))
+        zeros, zeros_len = make_cbuffer('00' * 32)
+        filter_header, filter_header_len = make_cbuffer('00' * 32)
+        self.assertEqual(WALLY_OK, wally_bip158_filter_header(out, written, zeros, zeros_len,
+                                                              filter_header, filter_header_len))
+        self.assertEqual(h(filter_header[::-1]),
+                         utf8('21584579b7eb08997773e5aeff3a7f932700042d0ed2a6129012b7d7ae81b750'))
+
+        # A block with spent scripts, OP_RETURN and empty scripts
+        txs = [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX]
+        block_hex = utf8(GENESIS_HEADER_HEX + '03') + b''.join(txs)
+        block, block_len = make_cbuffer(block_hex)
+        self.assertEqual(WALLY_OK, wally_block_get_hash(block, block_len, block_hash, block_hash_len))
+        output_scripts = []
+        for tx_hex, num_outputs in zip(txs, [1, 2, 1]):
+            buf, buf_len = make_cbuffer(tx_hex)
+            view = c_void_p()
+            self.assertEqual(WALLY_OK, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+            for i in range(num_outputs):
+                ret, written = wally_tx_view_get_output_script(view, i, out, out_len)
+                self.assertEqual(WALLY_OK, ret)
+                output_scripts.append(out[:written])
+            self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+        self.assertIn(b'', output_scripts) # TX_FAKE_HEX has an empty script
+        prev_scripts = [unhexlify(OP_RETURN_SCRIPT), b'']
+        prevs, prevs_len, prev_lens, prev_lens_len = make_scripts(prev_scripts)
+        ret, written = wally_block_get_bip158_filter(block, block_len, prevs, prevs_len,
+                                                     prev_lens, 2, 0, out, out_len)
+        self.assertEqual(ret, WALLY_OK)
+        # Spent OP_RETURN scripts are included, unlike OP_RETURN outputs
+        items = [s for s in output_scripts + prev_scripts if s]
+        self.assertEqual(len(items), len(output_scripts)) # One empty script of each
+        expected = gcs_filter(bytes(block_hash), items)
+        self.assertEqual(out[:written], expected)
+
+        # Building from the scripts directly gives the same filter, with
+        # duplicate scripts included once
+        scripts, scripts_len, lens, lens_len = make_scripts(items + items[:2])
+        ret, written = wally_bip158_filter_from_scripts(block_hash, block_hash_len, scripts, scripts_len,
+                                                        lens, lens_len, out, out_len)
+        self.assertEqual((ret, out[:written]), (WALLY_OK, expected))
+        # Too short an output returns the required length
+        self.assertEqual((WALLY_OK, written), wally_bip158_filter_from_scripts(
+            block_hash, block_hash_len, scripts, scripts_len, lens, lens_len, out, written - 1))
+        # An empty filter
+        ret, written = wally_bip158_filter_from_scripts(block_hash, block_hash_len, None, 0,
+                                                        None, 0, out, out_len)
+        self.assertEqual((ret, h(out[:written])), (WALLY_OK, utf8('00')))
+
+        for args in [
+            (None, block_len, prevs, prevs_len, prev_lens, 2, 0, out, out_len), # Empty block
+            (block, block_len - 1, prevs, prevs_len, prev_lens, 2, 0, out, out_len), # Truncated block
+            (block, block_len, None, prevs_len, prev_lens, 2, 0, out, out_len), # Empty spent scripts
+            (block, block_len, prevs, prevs_len, None, 2, 0, out, out_len), # Empty spent lengths
+            (block, block_len, prevs, prevs_len, prev_lens, 1, 0, out, out_len), # Too few spent scripts
+            (block, block_len, prevs, prevs_len, prev_lens, 3, 0, out, out_len), # Too many spent scripts
+            (block, block_len, prevs, prevs_len - 1, prev_lens, 2, 0, out, out_len), # Bad spent lengths
+            (block, block_len, prevs, prevs_len, prev_lens, 2, 1, out, out_len), # Unsupported flags
+            (block, block_len, prevs, prevs_len, prev_lens, 2, 0, None, out_len), # Empty output
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_block_get_bip158_filter(*args))
+
+        for args in [
+            (None, 32, scripts, scripts_len, lens, lens_len, out, out_len), # Empty block hash
+            (block_hash, 31, scripts, scripts_len, lens, lens_len, out, out_len), # Bad block hash length
+            (block_hash, 32, None, scripts_len, lens, lens_len, out, out_len), # Empty scripts
+            (block_hash, 32, scripts, scripts_len - 1, lens, lens_len, out, out_len), # Bad script lengths
+            (block_hash, 32, scripts, scripts_len, None, lens_len, out, out_len), # Empty lengths
+            (block_hash, 32, scripts, scripts_len, lens, lens_len, None, out_len), # Empty output
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_bip158_filter_from_scripts(*args))
+        empty_lens = (c_uint * 1)(0)
+        self.assertEqual((WALLY_EINVAL, 0), wally_bip158_filter_from_scripts(
+            block_hash, 32, scripts, 0, empty_lens, 1, out, out_len)) # Empty script
+
+        # Match a wallet's scripts against the filter
+        filter_bytes = expected
+        wallet = items[:2] + [b'\x51' * 20, b'\x52' * 25] + items[:1]
+        scripts, scripts_len, lens, lens_len = make_scripts(wallet)
+        self.assertEqual((WALLY_OK, 3), wally_bip158_filter_match(
+            block_hash, block_hash_len, filter_bytes, len(filter_bytes),
+            scripts, scripts_len, lens, lens_len))
+        scripts, scripts_len, lens, lens_len = make_scripts(items)
+        self.assertEqual((WALLY_OK, len(items)), wally_bip158_filter_match(
+            block_hash, block_hash_len, filter_bytes, len(filter_bytes),
+            scripts, scripts_len, lens, lens_len))
+        # Nothing matches an empty filter or an empty script list
+        self.assertEqual((WALLY_OK, 0), wally_bip158_filter_match(
+            block_hash, block_hash_len, b'\x00', 1, scripts, scripts_len, lens, lens_len))
+        self.assertEqual((WALLY_OK, 0), wally_bip158_filter_match(
+            block_hash, block_hash_len, filter_bytes, len(filter_bytes), None, 0, None, 0))
+        for args in [
+            (None, 32, filter_bytes, len(filter_bytes), scripts, scripts_len, lens, lens_len), # Empty block hash
+            (block_hash, 31, filter_bytes, len(filter_bytes), scripts, scripts_len, lens, lens_len), # Bad block hash length
+            (block_hash, 32, None, len(filter_bytes), scripts, scripts_len, lens, lens_len), # Empty filter
+            (block_hash, 32, filter_bytes, 0, scripts, scripts_len, lens, lens_len), # Empty filter
+            (block_hash, 32, filter_bytes, 2, scripts, scripts_len, lens, lens_len), # Truncated filter
+            (block_hash, 32, b'\xfd', 1, scripts, scripts_len, lens, lens_len), # Truncated item count
+            (block_hash, 32, filter_bytes, len(filter_bytes), None, scripts_len, lens, lens_len), # Empty scripts
+            (block_hash, 32, filter_bytes, len(filter_bytes), scripts, scripts_len - 1, lens, lens_len), # Bad script lengths
+            ]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_bip158_filter_match(*args))
+
+        for args in [
+            (None, 4, zeros, 32, filter_header, 32), # Empty filter
+            (out, 0, zeros, 32, filter_header, 32), # Empty filter
+            (out, 4, None, 32, filter_header, 32), # Empty previous header
+            (out, 4, zeros, 31, filter_header, 32), # Bad previous header length
+            (out, 4, zeros, 32, None, 32), # Empty output
+            (out, 4, zeros, 32, filter_header, 31), # Bad output length
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_bip158_filter_header(*args))
+
+    def test_merkle(self):
+        """Testing merkle root and branch functions"""
+        sha256d = lambda b: sha256(sha256(b).digest()).digest()
+
+        def merkle_root(nodes):
+            while len(nodes) > 1:
+                if len(nodes) % 2:
+                    nodes = nodes + [nodes[-1]]
+                nodes = [sha256d(nodes[i] + nodes[i + 1]) for i in range(0, len(nodes), 2)]
+            return nodes[0]
+
+        out, out_len = make_cbuffer('00'*32)
+        txids, txids_len = make_cbuffer('11'*64)
+        for args in [
+            (None, txids_len, out, out_len), # Empty txids
+            (txids, 0, out, out_len), # Empty length
+            (txids, txids_len-1, out, out_len), # Partial txid
+            (txids, txids_len, None, out_len), # Empty output
+            (txids, txids_len, out, out_len-1), # Invalid output length
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_merkle_root(*args))
+
+        branch, branch_len = make_cbuffer('00'*32*5)
+        for args in [
+            (None, txids_len, 0, branch, branch_len), # Empty txids
+            (txids, txids_len-1, 0, branch, branch_len), # Partial txid
+            (txids, txids_len, 2, branch, branch_len), # Invalid index
+            (txids, txids_len, 0, None, branch_len), # Empty output
+            ]:
+            ret, _ = wally_merkle_branch(*args)
+            self.assertEqual(WALLY_EINVAL, ret)
+        self.assertEqual((WALLY_OK, 32), wally_merkle_branch(txids, txids_len, 0, branch, 31))
+
+        for n in range(1, 18):
+            nodes = [sha256d(pack('<I', i)) for i in range(n)]
+            txids, txids_len = make_cbuffer(h(b''.join(nodes)))
+            root = merkle_root(nodes)
+            self.assertEqual(WALLY_OK, wally_merkle_root(txids, txids_len, out, out_len))
+            self.assertEqual(h(root), h(out))
+
+            for i in range(n):
+                ret, written = wally_merkle_branch(txids, txids_len, i, branch, branch_len)
+                self.assertEqual(WALLY_OK, ret)
+                self.assertEqual(written % 32, 0)
+                proof = branch[:written] if written else None
+                self.assertEqual(WALLY_OK,
+                                 wally_merkle_branch_verify(nodes[i], 32, proof, written, i, root, 32))
+                bad = [(nodes[i], 32, proof, written, i + (1 << (written // 32)), root, 32), # Index too large
+                       (nodes[i], 32, proof, written, i, b'\x00' * 32, 32)] # Wrong root
+                if i ^ 1 < n:
+                    bad.append((nodes[i], 32, proof, written, i ^ 1, root, 32)) # Wrong index
+                for args in bad:
+                    self.assertEqual(WALLY_EINVAL, wally_merkle_branch_verify(*args))
+                if written:
+                    tampered = bytes([branch[0] ^ 1]) + branch[1:written]
+                    self.assertEqual(WALLY_EINVAL,
+                                     wally_merkle_branch_verify(nodes[i], 32, tampered, written, i, root, 32))
+
+    def test_arena(self):
+        """Testing transaction decoding from an arena"""
+        mem = create_string_buffer(4096)
+        arena = wally_tx_arena()
+        for args in [
+            (None, mem, len(mem)), # Empty arena
+            (arena, None, len(mem)), # Empty memory
+            (arena, mem, 0), # Empty length
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_arena_init(*args))
+        self.assertEqual(WALLY_EINVAL, wally_tx_arena_reset(arena)) # Uninitialized
+        self.assertEqual(WALLY_OK, wally_tx_arena_init(arena, mem, len(mem)))
+
+        fake, fake_len = make_cbuffer(TX_FAKE_HEX)
+        tx_p = pointer(wally_tx())
+        for args in [
+            (None, fake_len, 0, arena, tx_p), # Empty bytes
+            (fake, fake_len, 0, None, tx_p), # Empty arena
+            (fake, fake_len, 0, arena, None), # Empty output
+            (fake, fake_len, 1, arena, tx_p), # Unsupported flag
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_from_bytes_arena(*args))
+        self.assertEqual(arena.used, 0)
+
+        # Multiple transactions can be allocated from the same arena
+        txs = []
+        for tx_hex in [TX_FAKE_HEX, TX_HEX, TX_WITNESS_HEX]:
+            buf, buf_len = make_cbuffer(tx_hex)
+            tx_p = pointer(wally_tx())
+            self.assertEqual(WALLY_OK, wally_tx_from_bytes_arena(buf, buf_len, 0, arena, tx_p))
+            txs.append((tx_hex, tx_p))
+        for tx_hex, tx_p in txs:
+            self.assertEqual(tx_hex, utf8(self.tx_serialize_hex(tx_p[0])))
+
+        # Running out of arena memory leaves the arena unchanged
+        used = arena.used
+        small = wally_tx_arena()
+        self.assertEqual(WALLY_OK, wally_tx_arena_init(small, mem, used + 64))
+        small.used = used
+        buf, buf_len = make_cbuffer(TX_WITNESS_HEX)
+        self.assertEqual(WALLY_ENOMEM, wally_tx_from_bytes_arena(buf, buf_len, 0, small, tx_p))
+        self.assertEqual(small.used, used)
+
+        self.assertEqual(WALLY_OK, wally_tx_arena_reset(arena))
+        self.assertEqual(arena.used, 0)
+        self.assertEqual(mem.raw, b'\x00' * len(mem))
+
+    def test_arena_batch(self):
+        """Testing batch transaction decoding into an arena"""
+        from ctypes import c_void_p, c_ulong, cast
+        hexes = [TX_FAKE_HEX, TX_HEX, TX_WITNESS_HEX] * 40
+        bufs = [make_cbuffer(tx_hex)[0] for tx_hex in hexes]
+        n = len(bufs)
+        c_bufs = (c_void_p * n)(*[cast(b, c_void_p) for b in bufs])
+        c_lens = (c_ulong * n)(*[len(b) for b in bufs])
+        mem = create_string_buffer(256 * 1024)
+        arena = wally_tx_arena()
+        self.assertEqual(WALLY_OK, wally_tx_arena_init(arena, mem, len(mem)))
+
+        # Decoding one at a time gives the minimum arena usage
+        tx_p = pointer(wally_tx())
+        for b in bufs:
+            self.assertEqual(WALLY_OK, wally_tx_from_bytes_arena(b, len(b), 0, arena, tx_p))
+        min_used = arena.used
+        self.assertEqual(WALLY_OK, wally_tx_arena_reset(arena))
+
+        no_run = run_tasks_fn_t()
+        for run_fn in [run_tasks_threaded, no_run]:
+            # Start from an unaligned offset
+            arena.used = 3
+            txs = (POINTER(wally_tx) * n)()
+            ret = wally_txs_from_bytes_arena(c_bufs, c_lens, n, 0, run_fn, None, arena, txs)
+            self.assertEqual(ret, WALLY_OK)
+            for tx_hex, tx_p in zip(hexes, txs):
+                self.assertEqual(tx_hex, utf8(self.tx_serialize_hex(tx_p[0])))
+            used = arena.used
+            self.assertTrue(min_used <= used - 3 <= min_used + 8 * n)
+
+            # Too small an arena, or an invalid transaction, changes nothing
+            small = wally_tx_arena()
+            self.assertEqual(WALLY_OK, wally_tx_arena_init(small, mem, used - 1))
+            small.used = 3
+            bad_lens = (c_ulong * n)(*c_lens)
+            bad_lens[n // 2] -= 1
+            for a, lens, expected in [(small, c_lens, WALLY_ENOMEM),
+                                      (arena, bad_lens, WALLY_EINVAL)]:
+                self.assertEqual(WALLY_OK, wally_tx_arena_reset(arena))
+                arena.used = small.used = 3
+                ret = wally_txs_from_bytes_arena(c_bufs, lens, n, 0, run_fn, None, a, txs)
+                self.assertEqual(ret, expected)
+                self.assertEqual(a.used, 3)
+                self.assertFalse(any(txs))
+                self.assertEqual(mem.raw, b'\x00' * len(mem))
+            arena.used = 0
+
+        txs = (POINTER(wally_tx) * n)()
+        null_bufs = (c_void_p * 2)(c_bufs[0], None)
+        for args in [(None, c_lens, n, 0, arena, txs),      # Null transactions
+                     (null_bufs, c_lens, 2, 0, arena, txs), # Null transaction
+                     (c_bufs, None, n, 0, arena, txs),      # Null lengths
+                     (c_bufs, c_lens, 0, 0, arena, txs),    # No transactions
+                     (c_bufs, c_lens, n, 1, arena, txs),    # Unsupported flag
+                     (c_bufs, c_lens, n, 0, None, txs),     # Null arena
+                     (c_bufs, c_lens, n, 0, arena, None)]:  # Null output
+            ret = wally_txs_from_bytes_arena(args[0], args[1], args[2], args[3],
+                                             no_run, None, args[4], args[5])
+            self.assertEqual(ret, WALLY_EINVAL)
+            self.assertEqual(arena.used, 0)
+
+    def test_weight_estimate(self):
+        """Testing arithmetic input and transaction weight estimation"""
+        P2PKH, P2SH, P2WPKH, P2WSH, MULTISIG = 0x2, 0x4, 0x8, 0x10, 0x20
+        DUMMY_NULL, DUMMY_SIG, DUMMY_SIG_LOW_R = 0x1, 0x2, 0x4
+        pk = '02' + '11' * 32
+
+        def push(h):
+            n = len(h) // 2
+            if n < 76:
+                return '%02x' % n + h
+            return ('4c%02x' % n if n < 256 else '4d' + pack('<H', n).hex()) + h
+
+        def make_input(script_type, threshold, num_keys, flags):
+            """Create the scriptSig and witness an input would have when
+               populated with dummy signatures"""
+            sig = '00' * (73 if flags == DUMMY_SIG else 72)
+            redeem = '%02x' % (0x50 + threshold) + push(pk) * num_keys + '%02xae' % (0x50 + num_keys)
+            script, items = '', None
+            if script_type == P2PKH:
+                script = push(sig) + push(pk)
+            elif script_type in [P2WPKH, P2SH | P2WPKH]:
+                items = [flags, pk]
+                if script_type & P2SH:
+                    script = push('0014' + '22' * 20)
+            elif script_type in [MULTISIG, P2SH | MULTISIG]:
+                script = '00' + push(sig) * threshold
+                if script_type & P2SH:
+                    script += push(redeem)
+            else:
+                items = [DUMMY_NULL] + [flags] * threshold + [redeem]
+                if script_type & P2SH:
+                    script = push('0020' + '22' * 32)
+            witness = None
+            if items is not None:
+                witness = pointer(wally_tx_witness_stack())
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(len(items), witness))
+                for item in items:
+                    if isinstance(item, int):
+                        ret = wally_tx_witness_stack_add_dummy(witness, item)
+                    else:
+                        ret = wally_tx_witness_stack_add(witness, *make_cbuffer(item))
+                    self.assertEqual(WALLY_OK, ret)
+            return make_cbuffer(script), witness
+
+        cases = [(P2PKH, 0, 0), (P2WPKH, 0, 0), (P2SH | P2WPKH, 0, 0),
+                 (MULTISIG, 1, 1), (MULTISIG, 2, 3), (P2SH | MULTISIG, 1, 2),
+                 (P2SH | MULTISIG, 2, 3), (P2SH | MULTISIG, 11, 15),
+                 (P2WSH | MULTISIG, 2, 3), (P2WSH | MULTISIG, 16, 16),
+                 (P2SH | P2WSH | MULTISIG, 2, 3), (P2SH | P2WSH | MULTISIG, 11, 15)]
+        txhash, txhash_len = make_cbuffer('33' * 32)
+        out_script, out_script_len = make_cbuffer('0014' + '44' * 20)
+
+        def new_tx():
+            tx = pointer(wally_tx())
+            self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, 300, 1, tx))
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1000, out_script, out_script_len, 0))
+            return tx
+
+        for flags in [DUMMY_SIG, DUMMY_SIG_LOW_R]:
+            outputs_tx, mixed_tx = new_tx(), new_tx()
+            total_weight, num_witness = 0, 0
+            # Add each input to its own transaction, and cycle through all
+            # of them until there are over 253 inputs in the mixed transaction
+            for i, (script_type, threshold, num_keys) in enumerate(cases * 22):
+                (script, script_len), witness = make_input(script_type, threshold, num_keys, flags)
+                if not script_len:
+                    script = None
+                ret, weight = wally_tx_input_get_weight_estimate(script_type, threshold, num_keys, flags)
+                self.assertEqual(ret, WALLY_OK)
+                add_args = (txhash, txhash_len, i, 0xffffffff, script, script_len, witness, 0)
+                self.assertEqual(WALLY_OK, wally_tx_add_raw_input(mixed_tx, *add_args))
+                if i < len(cases):
+                    has_witness = witness is not None
+                    tx = new_tx()
+                    self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, *add_args))
+                    ret = wally_tx_get_weight_estimate(outputs_tx, 1, has_witness, weight)
+                    self.assertEqual(ret, (WALLY_OK, wally_tx_get_weight(tx)[1]))
+                    # Adding the same input again to a tx that already has it
+                    ret = wally_tx_get_weight_estimate(tx, 1, has_witness, weight)
+                    self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, *add_args))
+                    self.assertEqual(ret, (WALLY_OK, wally_tx_get_weight(tx)[1]))
+                    wally_tx_free(tx)
+                if witness:
+                    wally_tx_witness_stack_free(witness)
+                    num_witness += 1
+                total_weight += weight
+            ret = wally_tx_get_weight_estimate(outputs_tx, len(cases) * 22, num_witness, total_weight)
+            self.assertEqual(ret, (WALLY_OK, wally_tx_get_weight(mixed_tx)[1]))
+            # Legacy inputs only
+            ret, weight = wally_tx_input_get_weight_estimate(P2PKH, 0, 0, flags)
+            ret = wally_tx_get_weight_estimate(outputs_tx, 2, 0, weight * 2)
+            self.assertEqual(ret[1], wally_tx_get_weight(outputs_tx)[1] + weight * 2)
+            wally_tx_free(outputs_tx)
+            wally_tx_free(mixed_tx)
+
+        # Invalid args
+        tx = new_tx()
+        for args in [
+            (P2PKH, 0, 0, 0), # No signature type
+            (P2PKH, 0, 0, DUMMY_NULL), # Unsupported signature type
+            (P2PKH, 1, 0, DUMMY_SIG), # Threshold for a non-multisig type
+            (P2WPKH, 0, 1, DUMMY_SIG), # Keys for a non-multisig type
+            (P2WSH, 0, 0, DUMMY_SIG), # P2WSH without a script type
+            (P2SH, 0, 0, DUMMY_SIG), # P2SH without a script type
+            (P2SH | P2PKH, 0, 0, DUMMY_SIG), # Unsupported combination
+            (MULTISIG, 0, 1, DUMMY_SIG), # Zero threshold
+            (MULTISIG, 3, 2, DUMMY_SIG), # Threshold too large
+            (MULTISIG, 17, 17, DUMMY_SIG), # Too many keys
+            (P2SH | MULTISIG, 1, 16, DUMMY_SIG), # Redeem script too large for P2SH
+            ]:
+            self.assertEqual(wally_tx_input_get_weight_estimate(*args), (WALLY_EINVAL, 0))
+        for args in [
+            (None, 1, 0, 100), # Null tx
+            (tx, 1, 2, 100), # More witness inputs than inputs
+            ]:
+            self.assertEqual(wally_tx_get_weight_estimate(*args), (WALLY_EINVAL, 0))
+        wally_tx_free(tx)
+
+    def test_coinselect(self):
+        """Testing coin selection by branch and bound and knapsack"""
+        BNB, KNAPSACK = 0x1, 0x2
+        P2WPKH, DUMMY_SIG = 0x8, 0x2
+        ret, in_weight = wally_tx_input_get_weight_estimate(P2WPKH, 0, 0, DUMMY_SIG)
+        self.assertEqual(ret, WALLY_OK)
+        base_weight, fee_rate, cost_of_change = 4 * 53 + 2, 2000, 5000
+        import random
+        rng = random.Random(77)
+
+        def select(values, weights, target, flags, run_fn=run_tasks_fn_t(), n=None):
+            n = len(values) if n is None else n
+            out = (c_uint * max(n, 1))(*([0xffffffff] * max(n, 1)))
+            ret, written = wally_coinselect((c_ulonglong * len(values))(*values), len(values),
+                                            (c_uint * len(weights))(*weights), len(weights),
+                                            target, base_weight, fee_rate, cost_of_change,
+                                            flags, run_fn, None, out, n)
+            self.assertEqual(ret, WALLY_OK)
+            return [out[i] for i in range(min(written, n))], written
+
+        def fee(weight):
+            return (weight * fee_rate + 3999) // 4000
+
+        def effective(values, weights):
+            return [v - fee(w) for v, w in zip(values, weights)]
+
+        def target_ev(values, weights, target):
+            n = len([e for e in effective(values, weights) if e > 0])
+            varint_extra = 0 if n < 0xfd else 2
+            return target + fee(base_weight + 4 * varint_extra + 3)
+
+        # Changeless selections: compare against an exhaustive search
+        for _ in range(20):
+            values = [rng.randint(1000, 100000) for _ in range(12)]
+            weights = [in_weight] * len(values)
+            evs = effective(values, weights)
+            target = rng.randint(10000, sum(values) // 2)
+            t_ev = target_ev(values, weights, target)
+            best = None
+            for mask in range(1, 1 << len(values)):
+                chosen = [i for i in range(len(values)) if mask & (1 << i)]
+                total = sum(evs[i] for i in chosen)
+                if t_ev <= total <= t_ev + cost_of_change:
+                    key = (total - t_ev, len(chosen))
+                    best = key if best is None or key < best else best
+            for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+                selected, written = select(values, weights, target, BNB, run_fn)
+                self.assertEqual(len(selected), written)
+                self.assertEqual(selected, sorted(selected))
+                if best is None:
+                    self.assertEqual(written, 0)
+                else:
+                    total = sum(evs[i] for i in selected)
+                    self.assertEqual((total - t_ev, written), best)
+
+        # An exact match, with an output too small to be worth spending
+        values = [50000, 20000 + fee(in_weight), 100, 30000 + fee(in_weight)]
+        weights = [in_weight] * len(values)
+        target = 50000 - fee(base_weight + 3)
+        for flags in [BNB, KNAPSACK, BNB | KNAPSACK]:
+            self.assertEqual(select(values, weights, target, flags), ([1, 3], 2))
+        # Knapsack uses the lowest larger output when no subset leaves
+        # enough change, whereas branch and bound finds a changeless subset
+        values = [8000, 8000, 30000]
+        weights = [in_weight] * len(values)
+        target = 12000
+        self.assertEqual(select(values, weights, target, BNB), ([0, 1], 2))
+        self.assertEqual(select(values, weights, target, KNAPSACK), ([2], 1))
+        self.assertEqual(select(values, weights, target, BNB | KNAPSACK), ([0, 1], 2))
+        self.assertEqual(select(values, weights, 20000, BNB), ([], 0))
+        self.assertEqual(select(values, weights, 20000, BNB | KNAPSACK), ([2], 1))
+        # Insufficient funds after fees
+        target = sum(effective(values, weights)) - fee(base_weight + 3) + 1
+        self.assertEqual(select(values, weights, target, BNB | KNAPSACK), ([], 0))
+        self.assertEqual(select(values, weights, target - 1, KNAPSACK), ([0, 1, 2], 3))
+        # Too small an output buffer returns the required length
+        self.assertEqual(select(values, weights, target - 1, KNAPSACK, n=2), ([0xffffffff] * 2, 3))
+
+        # Knapsack selections leave change, and results do not depend on threading
+        values = [rng.randint(546, 10000000) for _ in range(3000)]
+        weights = [rng.choice([in_weight, in_weight + 1, 4 * 148 + 1]) for _ in values]
+        evs = effective(values, weights)
+        for target in [100000, 5000000, 123456789]:
+            t_ev = target_ev(values, weights, target)
+            for flags in [BNB, KNAPSACK, BNB | KNAPSACK]:
+                results = [select(values, weights, target, flags, run_fn)
+                           for run_fn in [run_tasks_threaded, run_tasks_fn_t()]]
+                self.assertEqual(results[0], results[1])
+                selected, written = results[0]
+                self.assertEqual(selected, sorted(set(selected)))
+                total = sum(evs[i] for i in selected)
+                if flags == BNB:
+                    self.assertTrue(written == 0 or t_ev <= total <= t_ev + cost_of_change)
+                else:
+                    self.assertTrue(written > 0 and total >= t_ev)
+
+        # Invalid args
+        values, weights, out = (c_ulonglong * 2)(1000, 2000), (c_uint * 2)(100, 100), (c_uint * 2)()
+        big = (c_ulonglong * 2)(MAX_SATOSHI, 1)
+        no_run = run_tasks_fn_t()
+        for args in [
+            (None, 2, weights, 2, 1000, 0, 1000, 0, BNB, no_run, None, out, 2), # Null values
+            (values, 0, weights, 2, 1000, 0, 1000, 0, BNB, no_run, None, out, 2), # Empty values
+            (values, 2, None, 2, 1000, 0, 1000, 0, BNB, no_run, None, out, 2), # Null weights
+            (values, 2, weights, 1, 1000, 0, 1000, 0, BNB, no_run, None, out, 2), # Mismatched weights
+            (big, 2, weights, 2, 1000, 0, 1000, 0, BNB, no_run, None, out, 2), # Total too large
+            (values, 2, weights, 2, 4000, 0, 1000, 0, BNB, no_run, None, out, 2), # Target too large
+            (values, 2, weights, 2, 1000, 0, 0, 0, BNB, no_run, None, out, 2), # Zero fee rate
+            (values, 2, weights, 2, 1000, 0, 1000, 0, 0, no_run, None, out, 2), # No flags
+            (values, 2, weights, 2, 1000, 0, 1000, 0, 0x4, no_run, None, out, 2), # Unknown flags
+            (values, 2, weights, 2, 1000, 0, 1000, 0, BNB, no_run, None, None, 2), # Null output
+            ]:
+            self.assertEqual(wally_coinselect(*args), (WALLY_EINVAL, 0))
+
+    def test_utxo_snapshot(self):
+        """Testing building and searching sorted UTXO snapshots"""
+        RECORD_LEN, HEADER_LEN = 80, 16
+        import random
+        rng = random.Random(78)
+        scripts = ['76a914%s88ac', 'a914%s87', '0014%s', '0020%s']
+        utxos = []
+        for i in range(60):
+            txhash = bytes([rng.randrange(256) for _ in range(32)])
+            if i % 5 == 4:
+                txhash = utxos[-1][0] # Several outputs of the same tx
+            script = scripts[i % 4] % ('%02x' % i * (32 if i % 4 == 3 else 20))
+            utxos.append((txhash, rng.randrange(8), rng.randrange(MAX_SATOSHI), script))
+        utxos = list({(u[0], u[1]): u for u in utxos}.values())
+
+        def make_record(txhash, vout, satoshi, script):
+            out = create_string_buffer(RECORD_LEN)
+            s, s_len = make_cbuffer(script)
+            ret = wally_utxo_record_from_script(txhash, 32, vout, satoshi, s, s_len, out, RECORD_LEN)
+            return ret, out.raw
+
+        def make_snapshot(records):
+            ret, written = wally_utxo_snapshot_from_records(records, len(records), None, 0)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+            ret, written = wally_utxo_snapshot_from_records(records, len(records),
+                                                            create_string_buffer(1), 1)
+            self.assertEqual((ret, written), (WALLY_OK, HEADER_LEN + len(records)))
+            out = create_string_buffer(written)
+            ret, written = wally_utxo_snapshot_from_records(records, len(records), out, written)
+            self.assertEqual(ret, WALLY_OK)
+            return out.raw
+
+        records = []
+        for u in utxos:
+            ret, record = make_record(*u)
+            self.assertEqual(ret, WALLY_OK)
+            records.append(record)
+        snapshot = make_snapshot(b''.join(records))
+        # The snapshot is sorted, so any input order gives the same snapshot
+        rng.shuffle(records)
+        self.assertEqual(make_snapshot(b''.join(records)), snapshot)
+        # Building in place, from records already at the header offset
+        buf = create_string_buffer(b'\0' * HEADER_LEN + b''.join(records), len(snapshot))
+        ret, written = wally_utxo_snapshot_from_records(byref(buf, HEADER_LEN), len(snapshot) - HEADER_LEN,
+                                                        buf, len(snapshot))
+        self.assertEqual((ret, buf.raw), (WALLY_OK, snapshot))
+
+        snapshot_len = len(snapshot)
+        self.assertEqual(wally_utxo_snapshot_get_num_records(snapshot, snapshot_len),
+                         (WALLY_OK, len(utxos)))
+        found = set()
+        for txhash, vout, satoshi, script in utxos:
+            ret, i = wally_utxo_snapshot_find(snapshot, snapshot_len, txhash, 32, vout)
+            self.assertEqual(ret, WALLY_OK)
+            found.add(i)
+            txhash_out, vout_out, satoshi_out = create_string_buffer(32), c_uint(), c_ulonglong()
+            ret = wally_utxo_snapshot_get(snapshot, snapshot_len, i, txhash_out, 32,
+                                          byref(vout_out), byref(satoshi_out))
+            self.assertEqual(ret, WALLY_OK)
+            self.assertEqual((txhash_out.raw, vout_out.value, satoshi_out.value),
+                             (txhash, vout, satoshi))
+            out = create_string_buffer(34)
+            ret, written = wally_utxo_snapshot_get_scriptpubkey(snapshot, snapshot_len, i, out, 34)
+            self.assertEqual((ret, out.raw[:written].hex()), (WALLY_OK, script))
+        self.assertEqual(found, set(range(len(utxos))))
+        for txhash, vout in [(utxos[0][0], 8), (b'\xff' * 32, 0), (b'\0' * 32, 0)]:
+            self.assertEqual(wally_utxo_snapshot_find(snapshot, snapshot_len, txhash, 32, vout),
+                             (WALLY_OK, len(utxos)))
+
+        # Sign a transaction spending P2PKH and P2WPKH outputs of the snapshot
+        spends = [u for u in utxos if u[3][:4] in ['76a9', '0014']][:6]
+        hash160 = lambda u: u[3][6:46] if u[3][:4] == '76a9' else u[3][4:]
+        tx = pointer(wally_tx())
+        self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, len(spends), 1, tx))
+        for txhash, vout, _, _ in spends:
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, txhash, 32, vout, 0xffffffff,
+                                                              None, 0, None, 0))
+        out_script, out_script_len = make_cbuffer('0014' + '44' * 20)
+        self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1000, out_script, out_script_len, 0))
+        n = len(spends)
+        values = (c_ulonglong * n)()
+        ret, written = wally_utxo_snapshot_get_prevouts(snapshot, snapshot_len, tx, values, n, None, 0)
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        ret, written = wally_utxo_snapshot_get_prevouts(snapshot, snapshot_len, tx, values, n,
+                                                        create_string_buffer(1), 1)
+        self.assertEqual((ret, written), (WALLY_OK, n * 26))
+        prevouts = create_string_buffer(written)
+        ret, written = wally_utxo_snapshot_get_prevouts(snapshot, snapshot_len, tx, values, n,
+                                                        prevouts, written)
+        self.assertEqual(ret, WALLY_OK)
+        self.assertEqual(list(values), [u[2] for u in spends])
+        expected = ''.join(['19' + '76a914%s88ac' % hash160(u) for u in spends])
+        self.assertEqual(prevouts.raw.hex(), expected)
+        sighashes = (c_uint * n)(*([1] * n))
+        hashes = create_string_buffer(32 * n)
+        self.assertEqual(WALLY_OK, wally_tx_get_signature_hashes(tx, prevouts, written, values, n,
+                                                                 sighashes, n, 1, hashes, 32 * n))
+        for i, u in enumerate(spends):
+            script, script_len = make_cbuffer('76a914%s88ac' % hash160(u))
+            out, out_len = make_cbuffer('00' * 32)
+            self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(tx, i, script, script_len,
+                                                                       u[2], 1, 1, out, out_len))
+            self.assertEqual(hashes.raw[i * 32:(i + 1) * 32], out)
+
+        # Spending an unknown or a script hash output fails
+        p2sh = [u for u in utxos if u[3][:4] == 'a914'][0]
+        for txhash, vout in [(b'\xff' * 32, 0), (p2sh[0], p2sh[1])]:
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, txhash, 32, vout, 0xffffffff,
+                                                              None, 0, None, 0))
+            values = (c_ulonglong * (n + 1))()
+            ret = wally_utxo_snapshot_get_prevouts(snapshot, snapshot_len, tx, values, n + 1,
+                                                   prevouts, len(prevouts))
+            self.assertEqual(ret, (WALLY_EINVAL, 0))
+            self.assertEqual(WALLY_OK, wally_tx_remove_input(tx, n))
+        wally_tx_free(tx)
+
+        # Invalid args
+        txhash, vout, satoshi, script = utxos[0]
+        s, s_len = make_cbuffer(script)
+        out = create_string_buffer(RECORD_LEN)
+        for args in [
+            (None, 32, vout, satoshi, s, s_len, out, RECORD_LEN), # Null txhash
+            (txhash, 31, vout, satoshi, s, s_len, out, RECORD_LEN), # Bad txhash length
+            (txhash, 32, vout, MAX_SATOSHI + 1, s, s_len, out, RECORD_LEN), # Value too large
+            (txhash, 32, vout, satoshi, None, s_len, out, RECORD_LEN), # Null script
+            (txhash, 32, vout, satoshi, s, s_len, None, RECORD_LEN), # Null output
+            (txhash, 32, vout, satoshi, s, s_len, out, RECORD_LEN - 1), # Bad output length
+            ]:
+            self.assertEqual(wally_utxo_record_from_script(*args), WALLY_EINVAL)
+        for script in ['6a0100', '51', '5121%s51ae' % ('02' + '11' * 32)]:
+            self.assertEqual(make_record(txhash, vout, satoshi, script)[0], WALLY_EINVAL)
+        record = records[0]
+        for bad in [record[:-1], # Bad length
+                    record[:44] + b'\x20' + record[45:], # Unsupported script type
+                    record[:45] + b'\x21' + record[46:], # Bad program length
+                    record[:79] + b'\x01', # Non-zero padding
+                    record * 2]: # Duplicate outpoint
+            ret, written = wally_utxo_snapshot_from_records(bad, len(bad), create_string_buffer(200), 200)
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        # An empty snapshot is valid
+        empty = create_string_buffer(HEADER_LEN)
+        self.assertEqual(wally_utxo_snapshot_from_records(None, 0, empty, HEADER_LEN), (WALLY_OK, HEADER_LEN))
+        self.assertEqual(wally_utxo_snapshot_get_num_records(empty, HEADER_LEN), (WALLY_OK, 0))
+        for bad in [snapshot[:-1], # Truncated
+                    b'X' + snapshot[1:], # Bad magic
+                    snapshot[:4] + b'\x02' + snapshot[5:], # Unknown version
+                    snapshot[:8] + b'\x01' + snapshot[9:], # Wrong record count
+                    None]:
+            bad_len = len(bad) if bad else 0
+            self.assertEqual(wally_utxo_snapshot_get_num_records(bad, bad_len), (WALLY_EINVAL, 0))
+            self.assertEqual(wally_utxo_snapshot_find(bad, bad_len, txhash, 32, 0), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_utxo_snapshot_find(snapshot, snapshot_len, None, 32, 0), (WALLY_EINVAL, 0))
+        self.assertEqual(wally_utxo_snapshot_find(snapshot, snapshot_len, txhash, 31, 0), (WALLY_EINVAL, 0))
+        n = len(utxos)
+        out32 = create_string_buffer(32)
+        for args in [(snapshot, snapshot_len, n, None, 0, None, None), # Bad index
+                     (snapshot, snapshot_len, 0, out32, 31, None, None), # Bad txhash length
+                     (snapshot, snapshot_len, 0, None, 32, None, None)]: # Null txhash
+            self.assertEqual(wally_utxo_snapshot_get(*args), WALLY_EINVAL)
+        self.assertEqual(wally_utxo_snapshot_get(snapshot, snapshot_len, 0, None, 0, None, None), WALLY_OK)
+        self.assertEqual(wally_utxo_snapshot_get_scriptpubkey(snapshot, snapshot_len, n, out32, 32),
+                         (WALLY_EINVAL, 0))
+
+    def test_txout_compressed(self):
+        """Testing bitcoin core compressed txouts and coins"""
+        COIN, RECORD_LEN = 100000000, 80
+        FLAG_SKIP_UNSUPPORTED, FLAG_COINS_BY_TXID = 0x1, 0x2
+        G_X = '79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798'
+        G_Y = '483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8'
+        h20, h32 = '11' * 20, '22' * 32
+        cases = [
+            # satoshi, script, compressed. Amounts match bitcoin core's tests
+            (0, '76a914%s88ac' % h20, '0000' + h20),
+            (1, 'a914%s87' % h20, '0101' + h20),
+            (1000000, '21' + '02' + G_X + 'ac', '0702' + G_X),
+            (COIN, '21' + '03' + G_X + 'ac', '0903' + G_X),
+            (50 * COIN, '41' + '04' + G_X + G_Y + 'ac', '3204' + G_X),
+            (21000000 * COIN, '0014' + h20, '8980dd40' + '1c' + '0014' + h20),
+            (1234, '0020' + h32, 'd55d' + '28' + '0020' + h32),
+            (1234, '', 'd55d' + '06'),
+        ]
+        for satoshi, script, expected in cases:
+            s, s_len = make_cbuffer(script)
+            ret, written = wally_txout_to_compressed(satoshi, s, s_len, create_string_buffer(1), 1)
+            self.assertEqual((ret, written), (WALLY_OK, len(expected) // 2))
+            out = create_string_buffer(written)
+            ret, written = wally_txout_to_compressed(satoshi, s, s_len, out, written)
+            self.assertEqual((ret, out.raw.hex()), (WALLY_OK, expected))
+
+            c, c_len = make_cbuffer(expected + 'ff') # Trailing data is ignored
+            satoshi_out, script_out, written = c_ulonglong(), create_string_buffer(100), c_ulong()
+            ret, consumed = wally_txout_from_compressed(c, c_len, byref(satoshi_out),
+                                                        script_out, 1, byref(written))
+            self.assertEqual((ret, written.value), (WALLY_OK, s_len))
+            ret, consumed = wally_txout_from_compressed(c, c_len, byref(satoshi_out),
+                                                        script_out, 100, byref(written))
+            self.assertEqual((ret, satoshi_out.value, script_out.raw[:written.value].hex(),
+                              consumed), (WALLY_OK, satoshi, script, c_len - 1))
+            for i in range(c_len - 1): # Truncated
+                ret, consumed = wally_txout_from_compressed(c, i, byref(satoshi_out),
+                                                            script_out, 100, byref(written))
+                self.assertEqual((ret, satoshi_out.value, written.value, consumed),
+                                 (WALLY_EINVAL, 0, 0, 0))
+
+        # Invalid pubkeys, amounts and oversized scripts
+        bad_x = '05' * 32 # x^3 + 7 is not a square
+        s, s_len = make_cbuffer('41' + '04' + bad_x + bad_x + 'ac')
+        out = create_string_buffer(100)
+        ret, written = wally_txout_to_compressed(1, s, s_len, out, 100)
+        self.assertEqual((ret, written), (WALLY_OK, 2 + s_len)) # Stored as a raw script
+        satoshi_out, written = c_ulonglong(), c_ulong()
+        for c in ['0004' + bad_x, '00', 'd55d', 'ffffffffffffffffffffff00']:
+            c, c_len = make_cbuffer(c)
+            ret, _ = wally_txout_from_compressed(c, c_len, byref(satoshi_out), out, 100,
+                                                 byref(written))
+            self.assertEqual(ret, WALLY_EINVAL)
+        for args in [(21000000 * COIN + 1, s, s_len, out, 100), (1, None, 1, out, 100),
+                     (1, s, s_len, None, 100)]:
+            self.assertEqual(wally_txout_to_compressed(*args), (WALLY_EINVAL, 0))
+        big, big_len = make_cbuffer('00' + 'cd17' + '00' * 10001) # A 10001 byte script
+        ret, consumed = wally_txout_from_compressed(big, big_len, byref(satoshi_out), out, 100,
+                                                    byref(written))
+        self.assertEqual((ret, out.raw[:written.value].hex(), consumed), (WALLY_OK, '6a', big_len))
+
+        # Coins in both dumptxoutset layouts give the same records
+        txid = bytes(range(32)).hex()
+        coins = [(0, cases[0]), (1, cases[1]), (5, cases[5]), (300, cases[6]), (2, cases[2])]
+        code = '81ff01' # Height and coinbase flag
+        legacy = ''.join([txid + vout.to_bytes(4, 'little').hex() + code + c[2]
+                          for vout, c in coins])
+        grouped = txid + '05' + ''.join(['%s%s%s' % ('fd2c01' if vout == 300 else '%02x' % vout,
+                                                     code, c[2]) for vout, c in coins])
+        records = []
+        for vout, (satoshi, script, _) in coins[:4]:
+            record = create_string_buffer(RECORD_LEN)
+            s, s_len = make_cbuffer(script)
+            self.assertEqual(wally_utxo_record_from_script(bytes(range(32)), 32, vout, satoshi,
+                                                           s, s_len, record, RECORD_LEN), WALLY_OK)
+            records.append(record.raw)
+        for coins_hex, flags in [(legacy, 0), (grouped, FLAG_COINS_BY_TXID)]:
+            b, b_len = make_cbuffer(coins_hex)
+            out = create_string_buffer(RECORD_LEN * 5)
+            # The P2PK coin isn't supported by records
+            ret, written = wally_utxo_records_from_coins(b, b_len, flags, out, len(out))
+            self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+            flags |= FLAG_SKIP_UNSUPPORTED
+            ret, written = wally_utxo_records_from_coins(b, b_len, flags, None, 0)
+            self.assertEqual((ret, written), (WALLY_OK, RECORD_LEN * 4))
+            ret, written = wally_utxo_records_from_coins(b, b_len, flags, out, len(out))
+            self.assertEqual((ret, out.raw[:written]), (WALLY_OK, b''.join(records)))
+            if flags & FLAG_COINS_BY_TXID:
+                for i in range(1, b_len): # Truncated
+                    ret, written = wally_utxo_records_from_coins(b, i, flags, out, len(out))
+                    self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        for args in [(None, 1, 0, out, len(out)), (b, b_len, 0x4, out, len(out)),
+                     (b, b_len, 0, None, 1)]:
+            self.assertEqual(wally_utxo_records_from_coins(*args), (WALLY_EINVAL, 0))
+
+    def test_block_reader(self):
+        """Testing streaming blocks and transactions from block files"""
+        MAINNET, REGTEST = 0xd9b4bef9, 0xdab5bffa
+        genesis = unhexlify(GENESIS_HEADER_HEX + '01' + GENESIS_TX_HEX)
+        txs = [TX_HEX, TX_WITNESS_HEX, TX_FAKE_HEX]
+        block = unhexlify(utf8(GENESIS_HEADER_HEX + '03') + b''.join(txs))
+        blocks = [genesis, block, genesis]
+        import random
+        rng = random.Random(79)
+
+        def frame(b, magic=MAINNET):
+            return pack('<II', magic, len(b)) + b
+
+        def make_file(blocks, padding):
+            data = b''.join([frame(b) + b'\0' * rng.randrange(3) for b in blocks])
+            return data + b'\0' * (padding - len(data) % padding)
+
+        read_fns = []
+
+        def make_reader(data, max_block_len=4000000, key=None, chunk=None, fail_at=None):
+            state = {'pos': 0}
+
+            def read(ctx, bytes_out, length, written):
+                n = min(length, len(data) - state['pos'], chunk or length)
+                if fail_at is not None and state['pos'] + n > fail_at:
+                    return WALLY_ERROR
+                memmove(bytes_out, data[state['pos']:state['pos'] + n], n)
+                state['pos'] += n
+                written[0] = n
+                return WALLY_OK
+            read_fn = read_fn_t(read)
+            reader = c_void_p()
+            ret = wally_block_reader_init_alloc(MAINNET, key, len(key) if key else 0,
+                                                max_block_len, read_fn, None, 0, byref(reader))
+            self.assertEqual(ret, WALLY_OK)
+            read_fns.append(read_fn) # Keep the callback alive
+            return reader
+
+        def read_blocks(reader):
+            out, block_bytes, block_len, ret = [], c_void_p(), c_ulong(), WALLY_OK
+            while ret == WALLY_OK:
+                ret = wally_block_reader_next_block(reader, byref(block_bytes), byref(block_len))
+                if ret == WALLY_OK:
+                    if not block_bytes.value:
+                        break
+                    out.append(string_at(block_bytes, block_len.value))
+            return ret, out
+
+        key = bytes(range(1, 9))
+        for padding in [8, 4096]:
+            data = make_file(blocks, padding)
+            xored = bytes([c ^ key[i % 8] for i, c in enumerate(data)])
+            for stream, k in [(data, None), (xored, key), (data, b'\0' * 8)]:
+                for chunk in [None, 1, 7, 1000]:
+                    reader = make_reader(stream, key=k, chunk=chunk)
+                    self.assertEqual(read_blocks(reader), (WALLY_OK, blocks))
+                    # Reading past the end returns no block
+                    self.assertEqual(read_blocks(reader), (WALLY_OK, []))
+                    wally_block_reader_free(reader)
+
+        # Transactions are returned from every block in turn
+        expected = [utf8(GENESIS_TX_HEX)] + txs + [utf8(GENESIS_TX_HEX)]
+        tx_bytes, tx_len = c_void_p(), c_ulong()
+        txid, txid_len = make_cbuffer('00' * 32)
+        reader = make_reader(make_file(blocks, 8), chunk=5)
+        for tx_hex in expected:
+            self.assertEqual(WALLY_OK, wally_block_reader_next_tx(reader, byref(tx_bytes), byref(tx_len),
+                                                                  txid, txid_len))
+            self.assertEqual(h(string_at(tx_bytes, tx_len.value)), tx_hex)
+            buf, buf_len = make_cbuffer(tx_hex)
+            expected_txid, _ = make_cbuffer('00' * 32)
+            self.assertEqual(WALLY_OK, wally_tx_get_txid_from_bytes(buf, buf_len, 0, expected_txid, 32))
+            self.assertEqual(txid, expected_txid)
+        self.assertEqual(WALLY_OK, wally_block_reader_next_tx(reader, byref(tx_bytes), byref(tx_len), None, 0))
+        self.assertEqual((tx_bytes.value, tx_len.value), (None, 0))
+        wally_block_reader_free(reader)
+        # After reading a block, its transactions are returned first
+        reader = make_reader(make_file(blocks, 8))
+        block_bytes, block_len = c_void_p(), c_ulong()
+        for i in range(2):
+            self.assertEqual(WALLY_OK, wally_block_reader_next_block(reader, byref(block_bytes), byref(block_len)))
+        self.assertEqual(WALLY_OK, wally_block_reader_next_tx(reader, byref(tx_bytes), byref(tx_len), None, 0))
+        self.assertEqual(h(string_at(tx_bytes, tx_len.value)), txs[0])
+        wally_block_reader_free(reader)
+
+        # Blocks of other networks are skipped, as is other data between blocks
+        data = frame(block, REGTEST) + b'junk' + frame(genesis)
+        reader = make_reader(data)
+        self.assertEqual(read_blocks(reader), (WALLY_OK, [genesis]))
+        wally_block_reader_free(reader)
+        # Errors
+        for data, max_block_len, fail_at in [
+            (make_file(blocks, 8), len(block) - 1, None), # Block too large for the buffer
+            (frame(genesis)[:-1], 4000000, None), # Truncated block
+            (frame(genesis)[:6], 4000000, None), # Truncated frame
+            (frame(genesis)[:4] + pack('<I', 80) + genesis, 4000000, None), # Block too small
+            (make_file(blocks, 8), 4000000, len(genesis) + 20), # Read error
+            ]:
+            reader = make_reader(data, max_block_len, chunk=16, fail_at=fail_at)
+            ret, read = read_blocks(reader)
+            self.assertNotEqual(ret, WALLY_OK)
+            self.assertTrue(len(read) <= 1)
+            wally_block_reader_free(reader)
+        # A block with trailing data is returned, but fails once iterated
+        bad = frame(genesis + b'\0')
+        reader = make_reader(bad + frame(genesis))
+        self.assertEqual(read_blocks(reader), (WALLY_OK, [genesis + b'\0', genesis]))
+        wally_block_reader_free(reader)
+        reader = make_reader(bad + frame(genesis))
+        self.assertEqual(WALLY_OK, wally_block_reader_next_tx(reader, byref(tx_bytes), byref(tx_len), None, 0))
+        self.assertEqual(WALLY_EINVAL, wally_block_reader_next_tx(reader, byref(tx_bytes), byref(tx_len), None, 0))
+        wally_block_reader_free(reader)
+
+        # Invalid args
+        read_fn = read_fn_t(lambda ctx, b, l, w: WALLY_OK)
+        reader = c_void_p()
+        for args in [
+            (MAINNET, key, 7, 4000000, read_fn, None, 0, byref(reader)), # Bad key length
+            (MAINNET, None, 8, 4000000, read_fn, None, 0, byref(reader)), # Null key
+            (MAINNET, None, 0, 80, read_fn, None, 0, byref(reader)), # Buffer too small
+            (MAINNET, None, 0, 1 << 32, read_fn, None, 0, byref(reader)), # Buffer too large
+            (MAINNET, None, 0, 4000000, read_fn_t(), None, 0, byref(reader)), # Null read function
+            (MAINNET, None, 0, 4000000, read_fn, None, 1, byref(reader)), # Unknown flags
+            (MAINNET, None, 0, 4000000, read_fn, None, 0, None), # Null output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_block_reader_init_alloc(*args))
+        reader = make_reader(b'')
+        for args in [(None, byref(block_bytes), byref(block_len)),
+                     (reader, None, byref(block_len)),
+                     (reader, byref(block_bytes), None)]:
+            self.assertEqual(WALLY_EINVAL, wally_block_reader_next_block(*args))
+        for args in [(None, byref(tx_bytes), byref(tx_len), None, 0),
+                     (reader, None, byref(tx_len), None, 0),
+                     (reader, byref(tx_bytes), None, None, 0),
+                     (reader, byref(tx_bytes), byref(tx_len), txid, 31)]:
+            self.assertEqual(WALLY_EINVAL, wally_block_reader_next_tx(*args))
+        self.assertEqual(WALLY_OK, wally_block_reader_free(reader))
+        self.assertEqual(WALLY_OK, wally_block_reader_free(None))
+
+    def test_script_watchset(self):
+        """Testing matching outputs against a set of watched scripts"""
+        ws = c_void_p()
+        for args in [
+            (0, 3, byref(ws)), # Multiple hash flags
+            (0, 4, byref(ws)), # Unsupported flag
+            (0, 0, None), # Empty output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_script_watchset_init_alloc(*args))
+
+        # Get the output scripts of a transaction, and its view
+        buf, buf_len = make_cbuffer(TX_WITNESS_HEX)
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        view = c_void_p()
+        self.assertEqual(WALLY_OK, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+        scripts = []
+        for i in range(2):
+            out, out_len = make_cbuffer('00'*34)
+            ret, written = wally_tx_view_get_output_script(view, i, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+            scripts.append(out[:written])
+
+        # Enough unmatched scripts of varying lengths to grow the set
+        others = [pack('<I', i) * (i % 9 + 1) for i in range(500)]
+        others_buf = b''.join(others)
+        others_lens = (c_uint * len(others))(*[len(o) for o in others])
+
+        indices = (c_uint * 4)()
+        for flags in [0, 1, 2]:
+            self.assertEqual(WALLY_OK, wally_script_watchset_init_alloc(0, flags, byref(ws)))
+            script, script_len = make_cbuffer(h(scripts[1]))
+            for args in [
+                (None, script, script_len), # Empty watch set
+                (ws, None, script_len), # Empty script
+                (ws, script, 0), # Zero length script
+                ]:
+                self.assertEqual(WALLY_EINVAL, wally_script_watchset_add(*args))
+            bad_lens = (c_uint * 2)(len(others[0]), 0)
+            for args in [
+                (None, others_buf, len(others_buf), others_lens, len(others)), # Empty watch set
+                (ws, None, len(others_buf), others_lens, len(others)), # Empty scripts
+                (ws, others_buf, len(others_buf), None, len(others)), # Empty lengths
+                (ws, others_buf, len(others_buf) - 1, others_lens, len(others)), # Short scripts
+                (ws, others_buf, len(others_buf) + 1, others_lens, len(others)), # Long scripts
+                (ws, others_buf, len(others[0]), bad_lens, 2), # Zero length script
+                ]:
+                self.assertEqual(WALLY_EINVAL, wally_script_watchset_add_scripts(*args))
+            # Failed additions leave the set unchanged
+            self.assertEqual((WALLY_OK, 0), wally_script_watchset_contains(ws, others_buf, len(others[0])))
+
+            self.assertEqual(WALLY_OK, wally_script_watchset_add_scripts(ws, others_buf, len(others_buf),
+                                                                          others_lens, len(others)))
+            self.assertEqual(WALLY_OK, wally_script_watchset_add(ws, script, script_len))
+            self.assertEqual(WALLY_OK, wally_script_watchset_add(ws, script, script_len)) # Duplicate
+            for other in others:
+                self.assertEqual((WALLY_OK, 1), wally_script_watchset_contains(ws, other, len(other)))
+            self.assertEqual((WALLY_OK, 1), wally_script_watchset_contains(ws, script, script_len))
+            self.assertEqual((WALLY_OK, 0), wally_script_watchset_contains(ws, scripts[0], len(scripts[0])))
+            self.assertEqual((WALLY_OK, 0), wally_script_watchset_contains(ws, script, script_len - 1))
+            self.assertEqual((WALLY_OK, 0), wally_script_watchset_contains(ws, None, 0))
+            ret, _ = wally_script_watchset_contains(None, script, script_len)
+            self.assertEqual(WALLY_EINVAL, ret)
+
+            for fn, t in [(wally_script_watchset_match_tx, tx),
+                          (wally_script_watchset_match_tx_view, view)]:
+                for args in [
+                    (None, t, indices, 4), # Empty watch set
+                    (ws, None, indices, 4), # Empty transaction
+                    (ws, t, None, 4), # Empty indices
+                    ]:
+                    ret, _ = fn(*args)
+                    self.assertEqual(WALLY_EINVAL, ret)
+                self.assertEqual((WALLY_OK, 1), fn(ws, t, None, 0)) # Count only
+                self.assertEqual((WALLY_OK, 1), fn(ws, t, indices, 4))
+                self.assertEqual(indices[0], 1)
+
+            # Both outputs match once the first output script is added
+            self.assertEqual(WALLY_OK, wally_script_watchset_add(ws, scripts[0], len(scripts[0])))
+            indices[1] = 99
+            self.assertEqual((WALLY_OK, 2), wally_script_watchset_match_tx(ws, tx, indices, 1))
+            self.assertEqual((indices[0], indices[1]), (0, 99)) # Only len indices written
+            self.assertEqual((WALLY_OK, 2), wally_script_watchset_match_tx_view(ws, view, indices, 4))
+            self.assertEqual((indices[0], indices[1]), (0, 1))
+            self.assertEqual(WALLY_OK, wally_script_watchset_free(ws))
+        self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+
+    def test_tx_set(self):
+        """Testing sets of transactions indexed by txid and outpoint"""
+        WALLY_TX_SET_WTXID = 0x1
+        script, script_len = make_cbuffer('0014' + '11' * 20)
+        item, item_len = make_cbuffer('22' * 72)
+
+        def make_tx(prevouts, witness=False):
+            tx = POINTER(wally_tx)()
+            self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, len(prevouts), 2, byref(tx)))
+            stack = POINTER(wally_tx_witness_stack)()
+            if witness:
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(1, byref(stack)))
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, item, item_len))
+            for txhash, index in prevouts:
+                ret = wally_tx_add_raw_input(tx, txhash, len(txhash), index, 0xffffffff,
+                                             None, 0, stack, 0)
+                self.assertEqual(WALLY_OK, ret)
+            wally_tx_witness_stack_free(stack)
+            for satoshi in [1000, 2000]:
+                self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, satoshi, script, script_len, 0))
+            return tx
+
+        def tx_id(tx, flags=0):
+            buf, buf_len = make_cbuffer('00' * 4096)
+            ret, written = wally_tx_to_bytes(tx, flags, buf, buf_len)
+            self.assertEqual(WALLY_OK, ret)
+            return sha256(sha256(buf[:written]).digest()).digest()
+
+        def txids(ts, fn, *args):
+            out, out_len = make_cbuffer('00' * 32 * 8)
+            ret, written = fn(ts, *args, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+            return [out[i:i + 32] for i in range(0, written, 32)]
+
+        def spender(ts, txhash, index):
+            out, out_len = make_cbuffer('00' * 32)
+            ret, written = wally_tx_set_get_spender(ts, txhash, 32, index, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+            return out[:written] if written else None
+
+        ts = c_void_p()
+        for args in [
+            (0, 1, byref(ts)), # Unsupported flag
+            (0, 0, None),      # Null output
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_set_init_alloc(*args))
+        self.assertEqual(WALLY_OK, wally_tx_set_init_alloc(0, 0, byref(ts)))
+
+        funding = b'\x01' * 32
+        a = make_tx([(funding, 0)], witness=True)
+        a_id = tx_id(a)
+        b = make_tx([(a_id, 0)])
+        b_id = tx_id(b)
+        c = make_tx([(b_id, 0), (a_id, 1)])
+        c_id = tx_id(c)
+        for tx in [a, b, c]:
+            self.assertEqual(WALLY_OK, wally_tx_set_add(ts, tx))
+        self.assertEqual((WALLY_OK, 3), wally_tx_set_get_num_txs(ts))
+
+        # Lookups by txid and wtxid
+        a_wtxid = tx_id(a, 1)
+        self.assertNotEqual(a_id, a_wtxid)
+        for txhash, flags, expected in [(a_id, 0, 1), (a_wtxid, 0, 0),
+                                        (a_wtxid, WALLY_TX_SET_WTXID, 1),
+                                        (a_id, WALLY_TX_SET_WTXID, 0),
+                                        (b_id, WALLY_TX_SET_WTXID, 1),
+                                        (funding, 0, 0)]:
+            self.assertEqual((WALLY_OK, expected), wally_tx_set_contains(ts, txhash, 32, flags))
+        found = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_set_get_tx(ts, a_wtxid, 32, WALLY_TX_SET_WTXID, byref(found)))
+        self.assertEqual(tx_id(found), a_id)
+        self.assertEqual(WALLY_OK, wally_tx_set_get_tx(ts, funding, 32, 0, byref(found)))
+        self.assertFalse(found)
+        for args in [
+            (None, a_id, 32, 0),   # Null set
+            (ts, None, 32, 0),     # Null txid
+            (ts, a_id, 31, 0),     # Short txid
+            (ts, a_id, 32, 2),     # Unsupported flag
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_set_contains(*args)[0])
+            self.assertEqual(WALLY_EINVAL, wally_tx_set_get_tx(*args, byref(found)))
+
+        # Outpoint lookups
+        self.assertEqual(spender(ts, funding, 0), a_id)
+        self.assertEqual(spender(ts, funding, 1), None)
+        self.assertEqual(spender(ts, a_id, 0), b_id)
+        self.assertEqual(spender(ts, a_id, 1), c_id)
+        self.assertEqual(spender(ts, c_id, 0), None)
+
+        # Duplicates, conflicts and invalid transactions can't be added
+        d = make_tx([(b'\x02' * 32, 0), (funding, 0), (a_id, 0)])
+        e = make_tx([(b'\x03' * 32, 0), (b'\x03' * 32, 0)])
+        coinbase = make_tx([(b'\x00' * 32, 0xffffffff)])
+        for tx in [a, d, e, coinbase]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_set_add(ts, tx))
+        self.assertEqual(WALLY_EINVAL, wally_tx_set_add(None, a))
+        self.assertEqual((WALLY_OK, 3), wally_tx_set_get_num_txs(ts))
+        self.assertEqual(spender(ts, b'\x03' * 32, 0), None)
+        self.assertEqual(txids(ts, wally_tx_set_get_conflicts, d), [a_id, b_id])
+        self.assertEqual(txids(ts, wally_tx_set_get_conflicts, a), [a_id])
+        self.assertEqual(txids(ts, wally_tx_set_get_conflicts, e), [])
+        # Short buffers return the required length
+        out, out_len = make_cbuffer('00' * 32)
+        self.assertEqual((WALLY_OK, 64), wally_tx_set_get_conflicts(ts, d, out, out_len))
+        self.assertEqual(out, a_id)
+        self.assertEqual((WALLY_EINVAL, 0), wally_tx_set_get_conflicts(ts, d, out, 31))
+
+        # Ancestors, nearest first
+        self.assertEqual(txids(ts, wally_tx_set_get_ancestors, c_id, 32), [b_id, a_id])
+        self.assertEqual(txids(ts, wally_tx_set_get_ancestors, b_id, 32), [a_id])
+        self.assertEqual(txids(ts, wally_tx_set_get_ancestors, a_id, 32), [])
+        self.assertEqual(WALLY_EINVAL, wally_tx_set_get_ancestors(ts, funding, 32, out, out_len)[0])
+
+        # Prevout values, leaving inputs from outside the set unchanged
+        values = (c_ulonglong * 3)(7, 7, 7)
+        self.assertEqual((WALLY_OK, 2), wally_tx_set_get_prevout_values(ts, c, values, 2))
+        self.assertEqual(list(values[:2]), [1000, 2000])
+        values = (c_ulonglong * 3)(7, 7, 7)
+        self.assertEqual((WALLY_OK, 1), wally_tx_set_get_prevout_values(ts, d, values, 3))
+        self.assertEqual(list(values), [7, 7, 1000])
+        for args in [(None, c, values, 2), (ts, None, values, 2),
+                     (ts, c, None, 2), (ts, c, values, 1), (ts, c, values, 3)]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_tx_set_get_prevout_values(*args))
+
+        # Removal
+        for args in [(None, b_id, 32), (ts, None, 32), (ts, b_id, 31), (ts, funding, 32)]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_set_remove(*args))
+        self.assertEqual(WALLY_OK, wally_tx_set_remove(ts, b_id, 32))
+        self.assertEqual((WALLY_OK, 2), wally_tx_set_get_num_txs(ts))
+        self.assertEqual((WALLY_OK, 0), wally_tx_set_contains(ts, b_id, 32, 0))
+        self.assertEqual(spender(ts, a_id, 0), None)
+        self.assertEqual(spender(ts, a_id, 1), c_id)
+        self.assertEqual(txids(ts, wally_tx_set_get_ancestors, c_id, 32), [a_id])
+        # The conflicting transaction can now be added
+        self.assertEqual(WALLY_OK, wally_tx_set_remove(ts, a_id, 32))
+        self.assertEqual(WALLY_OK, wally_tx_set_add(ts, d))
+        self.assertEqual(spender(ts, funding, 0), tx_id(d))
+        for tx in [a, b, c, d, e, coinbase]:
+            wally_tx_free(tx)
+        self.assertEqual(WALLY_OK, wally_tx_set_free(ts))
+
+        # Compare a larger set against a model as transactions come and go
+        self.assertEqual(WALLY_OK, wally_tx_set_init_alloc(4, 0, byref(ts)))
+        model = {} # txid: prevouts
+        for i in range(400):
+            if i % 3 == 2 and model:
+                txid = sorted(model)[i % len(model)]
+                self.assertEqual(WALLY_OK, wally_tx_set_remove(ts, txid, 32))
+                del model[txid]
+                continue
+            prevouts = [(pack('<II', i, 0) * 4, j) for j in range(i % 3 + 1)]
+            if model:
+                parent = sorted(model)[i % len(model)]
+                spent = [p for ps in model.values() for p in ps]
+                prevouts += [(parent, j) for j in range(2) if (parent, j) not in spent]
+            tx = make_tx(prevouts)
+            self.assertEqual(WALLY_OK, wally_tx_set_add(ts, tx))
+            model[tx_id(tx)] = prevouts
+            wally_tx_free(tx)
+        self.assertEqual((WALLY_OK, len(model)), wally_tx_set_get_num_txs(ts))
+        for txid, prevouts in model.items():
+            self.assertEqual((WALLY_OK, 1), wally_tx_set_contains(ts, txid, 32, 0))
+            for txhash, index in prevouts:
+                self.assertEqual(spender(ts, txhash, index), txid)
+            ancestors, pending = set(), [txid]
+            while pending:
+                parents = [p for p, _ in model[pending.pop()] if p in model]
+                pending += [p for p in parents if p not in ancestors]
+                ancestors.update(parents)
+            out, out_len = make_cbuffer('00' * 32 * len(model))
+            ret, written = wally_tx_set_get_ancestors(ts, txid, 32, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+            found = [out[i:i + 32] for i in range(0, written, 32)]
+            self.assertEqual(len(found), len(ancestors))
+            self.assertEqual(set(found), ancestors)
+        self.assertEqual(WALLY_OK, wally_tx_set_free(ts))
+
+        # Outpoints whose txhashes share a prefix are indexed by their full value
+        self.assertEqual(WALLY_OK, wally_tx_set_init_alloc(0, 0, byref(ts)))
+        prevouts = [(b'\x05' * 24 + pack('<Q', i), 0) for i in range(64)]
+        tx = make_tx(prevouts)
+        self.assertEqual(WALLY_OK, wally_tx_set_add(ts, tx))
+        for txhash, index in prevouts:
+            self.assertEqual(spender(ts, txhash, index), tx_id(tx))
+            self.assertEqual(spender(ts, txhash, index + 1), None)
+        self.assertEqual(WALLY_OK, wally_tx_set_remove(ts, tx_id(tx), 32))
+        self.assertEqual(spender(ts, prevouts[0][0], 0), None)
+        wally_tx_free(tx)
+        self.assertEqual(WALLY_OK, wally_tx_set_free(ts))
+
+    def test_fee(self):
+        """Testing fee and fee rate computation"""
+        script, script_len = make_cbuffer('0014' + '11' * 20)
+
+        def make_tx(num_inputs, satoshi):
+            tx = POINTER(wally_tx)()
+            self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 0, num_inputs, 1, byref(tx)))
+            for i in range(num_inputs):
+                ret = wally_tx_add_raw_input(tx, b'\x01' * 32, 32, i, 0xffffffff,
+                                             None, 0, None, 0)
+                self.assertEqual(WALLY_OK, ret)
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, satoshi, script, script_len, 0))
+            return tx
+
+        def call(fn, *args):
+            value = c_ulonglong(1)
+            ret = fn(*args, byref(value))
+            return ret, value.value
+
+        tx = make_tx(2, 5000)
+        _, vsize = wally_tx_get_vsize(tx)
+        values = (c_ulonglong * 2)(3000, 2500)
+        self.assertEqual((WALLY_OK, 500), call(wally_tx_get_fee, tx, values, 2))
+        self.assertEqual((WALLY_OK, 500 * 1000 // vsize), call(wally_tx_get_fee_rate, tx, values, 2))
+
+        exact = (c_ulonglong * 2)(3000, 2000)
+        short = (c_ulonglong * 2)(3000, 1999)
+        big = (c_ulonglong * 2)(MAX_SATOSHI, 1)
+        for args in [
+            (None, values, 2),  # Null tx
+            (tx, None, 2),      # Null values
+            (tx, values, 1),    # Too few values
+            (tx, values, 3),    # Too many values
+            (tx, short, 2),     # Outputs spend more than the inputs
+            (tx, big, 2),       # Inputs spend too many satoshi
+            ]:
+            for fn in [wally_tx_get_fee, wally_tx_get_fee_rate]:
+                self.assertEqual((WALLY_EINVAL, 0), call(fn, *args))
+        self.assertEqual((WALLY_OK, 0), call(wally_tx_get_fee, tx, exact, 2))
+        self.assertEqual((WALLY_OK, 0), call(wally_tx_get_fee_rate, tx, exact, 2))
+
+        # Batched fee rates match those computed individually
+        txs = [make_tx(i % 3 + 1, 1000 * i) for i in range(10)]
+        all_values, expected = [], []
+        for i, t in enumerate(txs):
+            tx_values = [1000 * i + 100 * j for j in range(i % 3 + 1)]
+            all_values += tx_values
+            ret, rate = call(wally_tx_get_fee_rate, t,
+                             (c_ulonglong * len(tx_values))(*tx_values), len(tx_values))
+            self.assertEqual(WALLY_OK, ret)
+            expected.append(rate)
+        tx_ptrs = (POINTER(wally_tx) * len(txs))(*txs)
+        batch_values = (c_ulonglong * len(all_values))(*all_values)
+        rates = (c_ulonglong * len(txs))()
+        self.assertEqual(WALLY_OK, wally_tx_get_fee_rates(tx_ptrs, len(txs), batch_values,
+                                                          len(all_values), rates, len(txs)))
+        self.assertEqual(list(rates), expected)
+        for args in [
+            (None, len(txs), batch_values, len(all_values), rates, len(txs)),
+            (tx_ptrs, 0, batch_values, len(all_values), rates, len(txs)),
+            (tx_ptrs, len(txs), None, len(all_values), rates, len(txs)),
+            (tx_ptrs, len(txs), batch_values, len(all_values) - 1, rates, len(txs)),
+            (tx_ptrs, len(txs) - 1, batch_values, len(all_values), rates, len(txs) - 1),
+            (tx_ptrs, len(txs), batch_values, len(all_values), None, len(txs)),
+            (tx_ptrs, len(txs), batch_values, len(all_values), rates, len(txs) - 1),
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_get_fee_rates(*args))
+        self.assertEqual(list(rates), [0] * len(txs))
+        for t in txs + [tx]:
+            wally_tx_free(t)
+
+    def test_view(self):
+        """Testing the zero-copy transaction view"""
+        view = c_void_p()
+        fake, fake_len = make_cbuffer(TX_FAKE_HEX)
+        short, short_len = make_cbuffer('00'*5)
+        no_inputs, no_inputs_len = make_cbuffer(TX_FAKE_HEX[:9]+utf8('0')+TX_FAKE_HEX[92:])
+        for args in [
+            (None, fake_len, 0, byref(view)), # Empty bytes
+            (short, short_len, 0, byref(view)), # Short bytes
+            (no_inputs, no_inputs_len, 0, byref(view)), # No inputs
+            (fake, fake_len, 0, None), # Empty output
+            (fake, fake_len, 1, byref(view)), # Unsupported flag
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_view_from_bytes(*args))
+
+        # Every truncation of a valid tx fails without reading past the end
+        for tx_hex in [TX_HEX, TX_WITNESS_HEX]:
+            for i in range(0, len(tx_hex) - 2, 2):
+                buf, buf_len = make_cbuffer(tx_hex[:i])
+                self.assertEqual(WALLY_EINVAL, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+
+        def varint(v):
+            # Test scripts and witness items are all shorter than 0xfd bytes
+            return bytes([v])
+
+        for tx_hex, num_inputs, num_outputs, witness_counts in [
+            (TX_FAKE_HEX, 1, 1, None),
+            (TX_HEX, 1, 1, None),
+            (TX_WITNESS_HEX, 1, 2, [4]),
+            ]:
+            buf, buf_len = make_cbuffer(tx_hex)
+            self.assertEqual(WALLY_OK, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+
+            # Re-serialize the transaction from the view and compare
+            txhash, txhash_len = make_cbuffer('00'*32)
+            out, out_len = make_cbuffer('00'*1000)
+            satoshi = c_ulonglong()
+            ser = buf[:4] + (b'\x00\x01' if witness_counts else b'') + varint(num_inputs)
+            for i in range(num_inputs):
+                self.assertEqual(WALLY_OK, wally_tx_view_get_input_txhash(view, i, txhash, txhash_len))
+                ret, index = wally_tx_view_get_input_index(view, i)
+                self.assertEqual(WALLY_OK, ret)
+                ret, sequence = wally_tx_view_get_input_sequence(view, i)
+                self.assertEqual(WALLY_OK, ret)
+                ret, script_len = wally_tx_view_get_input_script_len(view, i)
+                self.assertEqual(WALLY_OK, ret)
+                self.assertEqual((WALLY_OK, script_len),
+                                 wally_tx_view_get_input_script(view, i, out, out_len))
+                ser += txhash + pack('<I', index) + varint(script_len) + out[:script_len] + pack('<I', sequence)
+            self.assertEqual(WALLY_EINVAL, wally_tx_view_get_input_txhash(view, num_inputs, txhash, txhash_len))
+            ret, _ = wally_tx_view_get_input_script_len(view, num_inputs)
+            self.assertEqual(WALLY_EINVAL, ret) # Invalid index
+
+            ser += varint(num_outputs)
+            for i in range(num_outputs):
+                self.assertEqual(WALLY_OK, wally_tx_view_get_output_satoshi(view, i, byref(satoshi)))
+                ret, script_len = wally_tx_view_get_output_script_len(view, i)
+                self.assertEqual(WALLY_OK, ret)
+                self.assertEqual((WALLY_OK, script_len),
+                                 wally_tx_view_get_output_script(view, i, out, out_len))
+                ser += pack('<Q', satoshi.value) + varint(script_len) + out[:script_len]
+            self.assertEqual(WALLY_EINVAL, wally_tx_view_get_output_satoshi(view, num_outputs, byref(satoshi)))
+
+            for i, num_items in enumerate(witness_counts or []):
+                ser += varint(num_items)
+                for j in range(num_items):
+                    ret, item_len = wally_tx_view_get_input_witness_len(view, i, j)
+                    self.assertEqual(WALLY_OK, ret)
+                    self.assertEqual((WALLY_OK, item_len),
+                                     wally_tx_view_get_input_witness(view, i, j, out, out_len))
+                    ser += varint(item_len) + out[:item_len]
+                ret, _ = wally_tx_view_get_input_witness_len(view, i, num_items)
+                self.assertEqual(WALLY_EINVAL, ret) # Invalid witness index
+
+            ser += buf[-4:]
+            self.assertEqual(h(buf), h(ser))
+            self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+
+            # Decoding from hex into a caller supplied buffer gives the same view
+            scratch, scratch_len = make_cbuffer('ff' * buf_len)
+            self.assertEqual(WALLY_OK, wally_tx_view_from_hex(tx_hex, 0, scratch, scratch_len,
+                                                              byref(view)))
+            self.assertEqual(h(scratch), h(buf))
+            self.assertEqual((WALLY_OK, script_len), wally_tx_view_get_output_script_len(view, num_outputs - 1))
+            self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+            for args in [
+                (None, 0, scratch, scratch_len, byref(view)),         # Null hex
+                (tx_hex[:-1], 0, scratch, scratch_len, byref(view)),  # Odd length hex
+                (tx_hex, 1, scratch, scratch_len, byref(view)),       # Unsupported flag
+                (tx_hex, 0, None, scratch_len, byref(view)),          # Null buffer
+                (tx_hex, 0, scratch, scratch_len - 1, byref(view)),   # Short buffer
+                (tx_hex, 0, scratch, scratch_len, None),              # Null output
+                ]:
+                self.assertEqual(WALLY_EINVAL, wally_tx_view_from_hex(*args))
+
+    def test_tx_batch(self):
+        """Testing columnar transaction batches"""
+        txs = [TX_FAKE_HEX, TX_HEX, TX_WITNESS_HEX, TX_HEX]
+        buf, buf_len = make_cbuffer(b''.join(txs))
+        block, block_len = make_cbuffer(utf8(GENESIS_HEADER_HEX + '04') + b''.join(txs))
+        short_block, short_block_len = make_cbuffer(utf8(GENESIS_HEADER_HEX + '05') + b''.join(txs))
+        batch = POINTER(wally_tx_batch)()
+        for fn, args in [
+            (wally_tx_batch_from_bytes, (None, buf_len, 0, byref(batch))),      # Null bytes
+            (wally_tx_batch_from_bytes, (buf, 0, 0, byref(batch))),             # Empty bytes
+            (wally_tx_batch_from_bytes, (buf, buf_len - 1, 0, byref(batch))),   # Truncated tx
+            (wally_tx_batch_from_bytes, (buf, buf_len, 1, byref(batch))),       # Unsupported flag
+            (wally_tx_batch_from_bytes, (buf, buf_len, 0, None)),               # Null output
+            (wally_block_get_tx_batch, (None, block_len, 0, byref(batch))),     # Null block
+            (wally_block_get_tx_batch, (block, block_len - 1, 0, byref(batch))), # Truncated block
+            (wally_block_get_tx_batch, (block, block_len, 1, byref(batch))),    # Unsupported flag
+            (wally_block_get_tx_batch, (block, block_len, 0, None)),            # Null output
+            (wally_block_get_tx_batch, (short_block, short_block_len, 0, byref(batch))), # Missing tx
+            ]:
+            self.assertEqual(WALLY_EINVAL, fn(*args))
+
+        # Trailing data after the last transaction of a block is invalid
+        long_block, long_block_len = make_cbuffer(utf8(GENESIS_HEADER_HEX + '03') + b''.join(txs))
+        self.assertEqual(WALLY_EINVAL, wally_block_get_tx_batch(long_block, long_block_len, 0, byref(batch)))
+
+        # Build the expected columns from transaction views
+        expected = {'versions': [], 'locktimes': [], 'input_offsets': [0], 'output_offsets': [0],
+                    'prevouts': [], 'sequences': [], 'satoshis': [], 'scripts': []}
+        for tx_hex, num_inputs, num_outputs in zip(txs, [1, 1, 1, 1], [1, 1, 2, 1]):
+            tx_buf, tx_buf_len = make_cbuffer(tx_hex)
+            view = c_void_p()
+            self.assertEqual(WALLY_OK, wally_tx_view_from_bytes(tx_buf, tx_buf_len, 0, byref(view)))
+            expected['versions'].append(unpack('<I', tx_buf[:4])[0])
+            expected['locktimes'].append(unpack('<I', tx_buf[-4:])[0])
+            for i in range(num_inputs):
+                txhash, txhash_len = make_cbuffer('00' * 32)
+                self.assertEqual(WALLY_OK, wally_tx_view_get_input_txhash(view, i, txhash, txhash_len))
+                ret, index = wally_tx_view_get_input_index(view, i)
+                expected['prevouts'].append((bytes(txhash), index))
+                ret, sequence = wally_tx_view_get_input_sequence(view, i)
+                expected['sequences'].append(sequence)
+            for i in range(num_outputs):
+                satoshi = c_ulonglong()
+                self.assertEqual(WALLY_OK, wally_tx_view_get_output_satoshi(view, i, byref(satoshi)))
+                expected['satoshis'].append(satoshi.value)
+                out, out_len = make_cbuffer('00' * 256)
+                ret, written = wally_tx_view_get_output_script(view, i, out, out_len)
+                expected['scripts'].append(out[:written])
+            expected['input_offsets'].append(expected['input_offsets'][-1] + num_inputs)
+            expected['output_offsets'].append(expected['output_offsets'][-1] + num_outputs)
+            self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+
+        for fn, args in [(wally_tx_batch_from_bytes, (buf, buf_len)),
+                         (wally_block_get_tx_batch, (block, block_len))]:
+            self.assertEqual(WALLY_OK, fn(*args, 0, byref(batch)))
+            b = batch.contents
+            self.assertEqual((b.num_txs, b.num_inputs, b.num_outputs),
+                             (len(txs), len(expected['prevouts']), len(expected['satoshis'])))
+            self.assertEqual(b.versions[:b.num_txs], expected['versions'])
+            self.assertEqual(b.locktimes[:b.num_txs], expected['locktimes'])
+            self.assertEqual(b.input_offsets[:b.num_txs + 1], expected['input_offsets'])
+            self.assertEqual(b.output_offsets[:b.num_txs + 1], expected['output_offsets'])
+            prevouts = [(string_at(b.prevout_txhashes + i * 32, 32), b.prevout_indices[i])
+                        for i in range(b.num_inputs)]
+            self.assertEqual(prevouts, expected['prevouts'])
+            self.assertEqual(b.sequences[:b.num_inputs], expected['sequences'])
+            self.assertEqual(b.satoshis[:b.num_outputs], expected['satoshis'])
+            offsets = b.script_offsets[:b.num_outputs + 1]
+            scripts = [string_at(b.scripts + offsets[i], offsets[i + 1] - offsets[i])
+                       for i in range(b.num_outputs)]
+            self.assertEqual(scripts, expected['scripts'])
+            self.assertEqual(WALLY_OK, wally_tx_batch_free(batch))
+
     def test_get_signature_hash(self):
         """Testing function to get the signature hash"""
         tx = self.tx_deserialize_hex(TX_FAKE_HEX)
@@ -195,6 +2757,741 @@ class TransactionTests(unittest.TestCase):
             self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(*args))
             self.assertEqual(expected, h(out[:out_len]))
 
+    def test_get_signature_hash_large(self):
+        """Testing the signature hash of a tx larger than the stack buffer"""
+        tx = self.tx_deserialize_hex(TX_HEX)
+        script, script_len = make_cbuffer('51' * 3000)
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script, script_len))
+        out, out_len = make_cbuffer('00'*32)
+        self.assertEqual(WALLY_OK,
+                         wally_tx_get_btc_signature_hash(tx, 0, script, script_len,
+                                                         0, 1, 0, out, out_len))
+        # The preimage is the tx serialized with the signing script, plus sighash
+        ret, written = wally_tx_get_length(tx, 0)
+        self.assertEqual(WALLY_OK, ret)
+        buf, buf_len = make_cbuffer('00' * written)
+        self.assertEqual((WALLY_OK, written), wally_tx_to_bytes(tx, 0, buf, buf_len))
+        preimage, preimage_len = make_cbuffer(h(buf) + utf8('01000000'))
+        expected, expected_len = make_cbuffer('00'*32)
+        self.assertEqual(WALLY_OK, wally_sha256d(preimage, preimage_len, expected, expected_len))
+        self.assertEqual(h(expected), h(out))
+
+    def test_get_signature_hash_ctx(self):
+        """Testing signature hashes computed with a precomputed context"""
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        ctx = c_void_p()
+        self.assertEqual(WALLY_EINVAL, wally_tx_sighash_ctx_init_alloc(None, 0, byref(ctx)))
+        self.assertEqual(WALLY_EINVAL, wally_tx_sighash_ctx_init_alloc(tx, 1, byref(ctx)))
+        self.assertEqual(WALLY_OK, wally_tx_sighash_ctx_init_alloc(tx, 0, byref(ctx)))
+
+        script, script_len = make_cbuffer('00')
+        out, out_len = make_cbuffer('00'*32)
+        expected, expected_len = make_cbuffer('00'*32)
+        for sighash in [0x1, 0x2, 0x3, 0x81, 0x82, 0x83]:
+            for flags in [0, 1]:
+                args = [tx, 0, script, script_len, 5000, sighash, flags]
+                self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(*(args + [expected, expected_len])))
+                for c in [ctx, None]:
+                    args = [tx, c, 0, script, script_len, 5000, sighash, flags, out, out_len]
+                    self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash_ctx(*args))
+                    self.assertEqual(h(expected), h(out))
+
+        # The context must match the transaction it was created from
+        other = self.tx_deserialize_hex(TX_HEX)
+        self.assertEqual(WALLY_EINVAL, wally_tx_get_btc_signature_hash_ctx(
+            other, ctx, 0, script, script_len, 5000, 1, 1, out, out_len))
+        self.assertEqual(WALLY_OK, wally_tx_sighash_ctx_free(ctx))
+
+    def test_sighash_ctx_export(self):
+        """Testing exporting sighash contexts and verifying them when streamed"""
+        SIGHASH_CTX_LEN = 106
+        tx, _, _ = self.make_signing_tx()
+        ctx = c_void_p()
+        self.assertEqual(WALLY_OK, wally_tx_sighash_ctx_init_alloc(tx, 0, byref(ctx)))
+        buf, buf_len = make_cbuffer('00' * SIGHASH_CTX_LEN)
+
+        # Export
+        for args in [(None, 0, buf, buf_len), (ctx, 1, buf, buf_len), (ctx, 0, None, buf_len)]:
+            self.assertEqual((WALLY_EINVAL, 0), wally_tx_sighash_ctx_to_bytes(*args))
+        self.assertEqual((WALLY_OK, SIGHASH_CTX_LEN),
+                         wally_tx_sighash_ctx_to_bytes(ctx, 0, buf, buf_len - 1))
+        self.assertEqual((WALLY_OK, SIGHASH_CTX_LEN),
+                         wally_tx_sighash_ctx_to_bytes(ctx, 0, buf, buf_len))
+        self.assertEqual(h(buf)[:20], utf8('0100' + '03000000' + '02000000'))
+
+        # Import, giving the same signature hashes
+        imported = create_string_buffer(256)
+        for args in [(None, buf_len, 0, imported), (buf, buf_len - 1, 0, imported),
+                     (buf, buf_len, 1, imported), (buf, buf_len, 0, None)]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_ctx_from_bytes(*args))
+        for bad in ['02' + h(buf)[2:].decode('ascii'), '0102' + h(buf)[4:].decode('ascii')]:
+            bad, bad_len = make_cbuffer(bad)
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_ctx_from_bytes(bad, bad_len, 0, imported))
+        self.assertEqual(WALLY_OK, wally_tx_sighash_ctx_from_bytes(buf, buf_len, 0, imported))
+        script, script_len = make_cbuffer('00')
+        out, out_len = make_cbuffer('00'*32)
+        expected, expected_len = make_cbuffer('00'*32)
+        for sighash in [0x1, 0x2, 0x3, 0x81]:
+            args = [0, script, script_len, 5000, sighash, 1]
+            self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(tx, *(args + [expected, expected_len])))
+            self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash_ctx(tx, imported, *(args + [out, out_len])))
+            self.assertEqual(h(expected), h(out))
+
+        # Verify the imported hashes against the streamed transaction
+        def stream(sequence_delta=0, satoshi_delta=0):
+            verifier = c_void_p()
+            self.assertEqual(WALLY_OK, wally_tx_sighash_verifier_init_alloc(imported, 0, byref(verifier)))
+            # The inputs and outputs match those of make_signing_tx
+            for i in range(3):
+                txhash, txhash_len = make_cbuffer('%02x' % (i + 1) * 32)
+                self.assertEqual(WALLY_OK, wally_tx_sighash_verifier_add_input(
+                    verifier, txhash, txhash_len, i, 0xfffffffd - i + sequence_delta))
+            # All inputs and outputs must be passed, and no more
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_add_input(
+                verifier, txhash, txhash_len, 0, 0))
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_final(verifier))
+            for i in range(2):
+                script, script_len = make_cbuffer('0014' + '%02x' % i * 20)
+                self.assertEqual(WALLY_OK, wally_tx_sighash_verifier_add_output(
+                    verifier, 1000 * (i + 1) + satoshi_delta, script, script_len))
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_add_output(verifier, 0, None, 0))
+            ret = wally_tx_sighash_verifier_final(verifier)
+            # Once finished, the verifier can only be freed
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_final(verifier))
+            self.assertEqual(WALLY_OK, wally_tx_sighash_verifier_free(verifier))
+            return ret
+
+        verifier = c_void_p()
+        for args in [(None, 0), (imported, 1)]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_init_alloc(*(args + (byref(verifier),))))
+        self.assertEqual(WALLY_EINVAL, wally_tx_sighash_verifier_init_alloc(imported, 0, None))
+        self.assertEqual(WALLY_OK, stream())
+        self.assertEqual(WALLY_ERROR, stream(sequence_delta=-1))
+        self.assertEqual(WALLY_ERROR, stream(satoshi_delta=1))
+        self.assertEqual(WALLY_OK, wally_tx_sighash_ctx_free(ctx))
+        self.assertEqual(WALLY_OK, wally_tx_free(tx))
+
+    def test_sighash_stream(self):
+        """Testing signature hashes computed from a streamed transaction"""
+        script, script_len = make_cbuffer('76a914' + '11' * 20 + '88ac')
+        expected, expected_len = make_cbuffer('00'*32)
+        signing_tx, signing_buf, signing_buf_len = self.make_signing_tx()
+        txs = [(signing_tx, signing_buf)]
+        for tx_hex in [TX_HEX, TX_WITNESS_HEX]:
+            txs.append((self.tx_deserialize_hex(tx_hex), make_cbuffer(tx_hex)[0]))
+
+        def stream_hashes(buf, requests, chunk_len):
+            stream = c_void_p()
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_init_alloc(0, byref(stream)))
+            for args in requests:
+                self.assertEqual(WALLY_OK, wally_tx_sighash_stream_add_input(stream, *args))
+            for i in range(0, len(buf), chunk_len):
+                chunk = buf[i:i + chunk_len]
+                self.assertEqual(WALLY_OK, wally_tx_sighash_stream_update(stream, chunk, len(chunk)))
+            out, out_len = make_cbuffer('00' * 32 * len(requests))
+            ret = wally_tx_sighash_stream_final(stream, out, out_len)
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_free(stream))
+            return ret, h(out)
+
+        for tx, buf in txs:
+            buf = bytes(buf)
+            requests, hashes = [], b''
+            num_inputs = getattr(tx, 'contents', tx).num_inputs
+            for index in range(num_inputs + 1):
+                for sighash in [0x1, 0x2, 0x3, 0x81, 0x82, 0x83]:
+                    # Legacy hashes of out of range inputs are 1, as tested below
+                    for flags in [0, 1] if index < num_inputs else [0]:
+                        args = [index, script, script_len, 5000 + index, sighash, flags]
+                        ret = wally_tx_get_btc_signature_hash(tx, *(args + [expected, expected_len]))
+                        if ret == WALLY_OK:
+                            requests.append(args)
+                            hashes += h(expected)
+            for chunk_len in [1, 7, 64, len(buf)]:
+                self.assertEqual((WALLY_OK, hashes), stream_hashes(buf, requests, chunk_len))
+
+        # Out of range BIP143 inputs and incomplete or invalid transactions fail
+        buf = bytes(signing_buf)
+        self.assertEqual(WALLY_EINVAL, stream_hashes(buf, [[3, None, 0, 0, 1, 1]], 64)[0])
+        one = '01' + '00' * 31
+        self.assertEqual((WALLY_OK, utf8(one * 2)),
+                         stream_hashes(buf, [[3, None, 0, 0, 1, 0], [2, None, 0, 0, 3, 0]], 64))
+        stream = c_void_p()
+        for args in [(1, byref(stream)), (0, None)]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_init_alloc(*args))
+        for case in [buf[:-1], buf + b'\x00', buf[:4] + b'\x00\x02' + buf[4:],
+                     buf[:4] + b'\x00\x01\x00' + buf[5:]]:
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_init_alloc(0, byref(stream)))
+            request = [stream, 0, script, script_len, 0, 1, 0]
+            for args in [[None] + request[1:], request[:2] + [None] + request[3:],
+                         request[:5] + [0x100, 0], request[:6] + [2]]:
+                self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_add_input(*args))
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_add_input(*request))
+            ret = wally_tx_sighash_stream_update(stream, case, len(case))
+            # Hashes can't be requested once streaming has started
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_add_input(*request))
+            out, out_len = make_cbuffer('00' * 32)
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_final(stream, out, out_len - 1))
+            if case == buf[:-1]:
+                # Truncated: the stream can't be finished until complete
+                self.assertEqual(WALLY_OK, ret)
+                self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_final(stream, out, out_len))
+                self.assertEqual(WALLY_OK, wally_tx_sighash_stream_update(stream, buf[-1:], 1))
+                self.assertEqual(WALLY_OK, wally_tx_sighash_stream_final(stream, out, out_len))
+                self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_final(stream, out, out_len))
+            else:
+                self.assertEqual(WALLY_EINVAL, ret)
+                self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_update(stream, buf, len(buf)))
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_free(stream))
+
+        # Transactions longer than the input limit are rejected
+        LIMIT_TX_LEN = 0
+        self.assertEqual(WALLY_OK, wally_set_input_limit(LIMIT_TX_LEN, len(buf) - 1))
+        try:
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_init_alloc(0, byref(stream)))
+            self.assertEqual(WALLY_EINVAL, wally_tx_sighash_stream_update(stream, buf, len(buf)))
+            self.assertEqual(WALLY_OK, wally_tx_sighash_stream_free(stream))
+        finally:
+            wally_set_input_limit(LIMIT_TX_LEN, 0)
+        self.assertEqual(WALLY_OK, wally_tx_free(signing_tx))
+
+    def make_signing_tx(self):
+        """Create a tx with several inputs and outputs and return its bytes"""
+        tx = POINTER(wally_tx)()
+        self.assertEqual(WALLY_OK, wally_tx_init_alloc(2, 500, 3, 2, byref(tx)))
+        for i in range(3):
+            txhash, txhash_len = make_cbuffer('%02x' % (i + 1) * 32)
+            script, script_len = make_cbuffer('51' * i * 100)
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_input(tx, txhash, txhash_len, i,
+                                                              0xfffffffd - i, script if i else None,
+                                                              script_len, None, 0))
+        for i in range(2):
+            script, script_len = make_cbuffer('0014' + '%02x' % i * 20)
+            self.assertEqual(WALLY_OK, wally_tx_add_raw_output(tx, 1000 * (i + 1),
+                                                               script, script_len, 0))
+        ret, hex_ = wally_tx_to_hex(tx, 0)
+        self.assertEqual(ret, WALLY_OK)
+        buf, buf_len = make_cbuffer(utf8(hex_))
+        return tx, buf, buf_len
+
+    def test_view_signature_hash(self):
+        """Testing signature hashes computed from a transaction view"""
+        tx, buf, buf_len = self.make_signing_tx()
+        view = c_void_p()
+        self.assertEqual(WALLY_OK, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+
+        script, script_len = make_cbuffer('76a914' + '11' * 20 + '88ac')
+        out, out_len = make_cbuffer('00'*32)
+        expected, expected_len = make_cbuffer('00'*32)
+        for args in [
+            (None, 0, script, script_len, 1, 1, 0, out, out_len), # Empty view
+            (view, 0, None, script_len, 1, 1, 0, out, out_len), # Empty script
+            (view, 0, script, 0, 1, 1, 0, out, out_len), # Invalid script length
+            (view, 0, script, script_len, MAX_SATOSHI+1, 1, 1, out, out_len), # Invalid amount
+            (view, 0, script, script_len, 1, 0x100, 0, out, out_len), # Invalid sighash
+            (view, 0, script, script_len, 1, 1, 2, out, out_len), # Invalid flags
+            (view, 0, script, script_len, 1, 1, 0, None, out_len), # Empty bytes
+            (view, 0, script, script_len, 1, 1, 0, out, 31), # Short len
+            (view, 0, script, script_len, 1, 1, 0, out, 33), # Long len
+            (view, 3, script, script_len, 1, 1, 1, out, out_len), # Invalid segwit index
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_view_get_btc_signature_hash(*args))
+
+        # The hashes match those computed from the parsed tx
+        for index in range(4):
+            for sighash in [0x1, 0x2, 0x3, 0x81, 0x82, 0x83]:
+                for flags in [0, 1]:
+                    if flags and index == 3:
+                        continue # Invalid index, tested above
+                    args = [index, script, script_len, 5000, sighash, flags]
+                    self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(
+                        tx, *(args + [expected, expected_len])))
+                    self.assertEqual(WALLY_OK, wally_tx_view_get_btc_signature_hash(
+                        view, *(args + [out, out_len])))
+                    self.assertEqual(h(expected), h(out))
+        self.assertEqual(WALLY_OK, wally_tx_view_free(view))
+        self.assertEqual(WALLY_OK, wally_tx_free(tx))
+
+    def test_heap_free_signing(self):
+        """Testing that the heap-free signing APIs never allocate"""
+        tx, buf, buf_len = self.make_signing_tx()
+        mem = create_string_buffer(1024)
+        arena = wally_tx_arena()
+        self.assertEqual(WALLY_OK, wally_tx_arena_init(arena, mem, len(mem)))
+        seed, seed_len = make_cbuffer('01' * 32)
+        master = ext_key()
+        self.assertEqual(WALLY_OK, bip32_key_from_seed(seed, seed_len, 0x0488ADE4, 0, byref(master)))
+        path = (c_uint * 5)(0x80000054, 0x80000000, 0x80000000, 0, 0)
+        script, script_len = make_cbuffer('76a914' + '11' * 20 + '88ac')
+        sighash, sighash_len = make_cbuffer('00'*32)
+        expected, expected_len = make_cbuffer('00'*32)
+        sig, sig_len = make_cbuffer('00'*64)
+        out, out_len = make_cbuffer('00'*200)
+        self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(
+            tx, 1, script, script_len, 5000, 1, 1, expected, expected_len))
+
+        def failing_malloc(size):
+            return None
+
+        ops = util.operations()
+        self.assertEqual(wally_get_operations(byref(ops)), WALLY_OK)
+        ops.malloc_fn = util._malloc_fn_t(failing_malloc)
+        self.assertEqual(wally_set_operations(byref(ops)), WALLY_OK)
+        try:
+            # Allocating APIs fail
+            view = c_void_p()
+            self.assertEqual(WALLY_ENOMEM, wally_tx_view_from_bytes(buf, buf_len, 0, byref(view)))
+
+            # Parsing, hashing, derivation, signing and script building don't
+            self.assertEqual(WALLY_OK, wally_tx_view_from_bytes_arena(buf, buf_len, 0, arena, byref(view)))
+            self.assertEqual(WALLY_OK, wally_tx_view_get_btc_signature_hash(
+                view, 1, script, script_len, 5000, 1, 1, sighash, sighash_len))
+            self.assertEqual(h(expected), h(sighash))
+            self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(
+                tx, 1, script, script_len, 5000, 1, 1, sighash, sighash_len))
+            self.assertEqual(WALLY_OK, wally_tx_get_btc_signature_hash(
+                tx, 2, script, script_len, 5000, 1, 0, sighash, sighash_len))
+            key = ext_key()
+            self.assertEqual(WALLY_OK, bip32_key_from_parent_path(byref(master), path, len(path), 0, byref(key)))
+            priv_key, pub_key = bytes(key.priv_key)[1:], bytes(key.pub_key)
+            self.assertEqual(WALLY_OK, wally_ec_sig_from_bytes(priv_key, 32, sighash, sighash_len,
+                                                               1, sig, sig_len))
+            der, der_len = make_cbuffer('00'*72)
+            ret, der_written = wally_ec_sig_to_der(sig, sig_len, der, der_len)
+            self.assertEqual(WALLY_OK, ret)
+            ret, written = wally_witness_p2wpkh_from_sig(pub_key, 33, sig, sig_len, 1, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+            witness = bytes([2, der_written + 1]) + der[:der_written] + b'\x01' + bytes([33]) + pub_key
+            self.assertEqual(h(out[:written]), h(witness))
+            ret, written = wally_scriptsig_p2pkh_from_sig(pub_key, 33, sig, sig_len, 1, out, out_len)
+            self.assertEqual(WALLY_OK, ret)
+        finally:
+            self.assertEqual(wally_set_operations(byref(util._new_ops)), WALLY_OK)
+
+        # A full arena leaves the arena unchanged
+        small = wally_tx_arena()
+        self.assertEqual(WALLY_OK, wally_tx_arena_init(small, mem, 64))
+        self.assertEqual(WALLY_ENOMEM, wally_tx_view_from_bytes_arena(buf, buf_len, 0, small, byref(view)))
+        self.assertEqual(small.used, 0)
+        for args in [
+            (None, buf_len, 0, arena, byref(view)), # Empty bytes
+            (buf, buf_len, 0, None, byref(view)), # Empty arena
+            (buf, buf_len, 0, arena, None), # Empty output
+            (buf, buf_len, 1, arena, byref(view)), # Unsupported flag
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_view_from_bytes_arena(*args))
+        self.assertEqual(WALLY_OK, wally_tx_arena_reset(arena))
+        self.assertEqual(WALLY_OK, wally_tx_free(tx))
+
+    def test_get_signature_hashes(self):
+        """Testing function to get the signature hashes of all inputs"""
+        tx = self.tx_deserialize_hex(TX_WITNESS_HEX)
+        txhash, txhash_len = make_cbuffer('11'*32)
+        script, script_len = make_cbuffer('00')
+        self.assertEqual(WALLY_OK,
+                         wally_tx_add_raw_input(tx, txhash, txhash_len, 1, 0xfffffffe,
+                                                script, script_len, None, 0))
+        scripts, scripts_len = make_cbuffer('0100' + '03515253')
+        values = (c_ulonglong * 2)(5000, 7000)
+        sighashes = (c_uint * 2)(0x1, 0x83)
+        out, out_len = make_cbuffer('00'*64)
+
+        for args in [
+            (None, scripts, scripts_len, values, 2, sighashes, 2, 1, out, out_len), # Empty tx
+            (tx, None, scripts_len, values, 2, sighashes, 2, 1, out, out_len), # Empty scripts
+            (tx, scripts, scripts_len-1, values, 2, sighashes, 2, 1, out, out_len), # Short scripts
+            (tx, scripts, 2, values, 2, sighashes, 2, 1, out, out_len), # Missing script
+            (tx, scripts, scripts_len, None, 2, sighashes, 2, 1, out, out_len), # Empty values
+            (tx, scripts, scripts_len, values, 1, sighashes, 2, 1, out, out_len), # Too few values
+            (tx, scripts, scripts_len, values, 2, None, 2, 1, out, out_len), # Empty sighashes
+            (tx, scripts, scripts_len, values, 2, sighashes, 1, 1, out, out_len), # Too few sighashes
+            (tx, scripts, scripts_len, values, 2, sighashes, 2, 2, out, out_len), # Invalid flags
+            (tx, scripts, scripts_len, values, 2, sighashes, 2, 1, None, out_len), # Empty bytes
+            (tx, scripts, scripts_len, values, 2, sighashes, 2, 1, out, 32), # Short len
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_get_signature_hashes(*args))
+
+        trailing, trailing_len = make_cbuffer('0100' + '0351525300')
+        self.assertEqual(WALLY_EINVAL,
+                         wally_tx_get_signature_hashes(tx, trailing, trailing_len, values, 2,
+                                                       sighashes, 2, 1, out, out_len))
+
+        expected, expected_len = make_cbuffer('00'*32)
+        for flags in [0, 1]:
+            self.assertEqual(WALLY_OK,
+                             wally_tx_get_signature_hashes(tx, scripts, scripts_len, values, 2,
+                                                           sighashes, 2, flags, out, out_len))
+            for i, (s, sighash) in enumerate([('00', 0x1), ('515253', 0x83)]):
+                s, s_len = make_cbuffer(s)
+                self.assertEqual(WALLY_OK,
+                                 wally_tx_get_btc_signature_hash(tx, i, s, s_len, values[i], sighash,
+                                                                 flags, expected, expected_len))
+                self.assertEqual(h(expected), h(out[i*32:(i+1)*32]))
+
+        # Many inputs with a mix of sighash types, so that the shared
+        # SIGHASH_ALL segments are used for some inputs but not others
+        n = 20
+        for i in range(n - 2):
+            self.assertEqual(WALLY_OK,
+                             wally_tx_add_raw_input(tx, txhash, txhash_len, i + 2, i,
+                                                    script, script_len, None, 0))
+        input_scripts = ['%02x' % (i % 4) + '51' * (i % 4) for i in range(n)]
+        scripts, scripts_len = make_cbuffer(''.join(input_scripts))
+        values = (c_ulonglong * n)(*[1000 * i for i in range(n)])
+        types = [0x1, 0x1, 0x2, 0x1, 0x3, 0x81, 0x1, 0x0, 0x1, 0x4]
+        sighashes = (c_uint * n)(*[types[i % len(types)] for i in range(n)])
+        out, out_len = make_cbuffer('00' * 32 * n)
+        self.assertEqual(WALLY_OK,
+                         wally_tx_get_signature_hashes(tx, scripts, scripts_len, values, n,
+                                                       sighashes, n, 0, out, out_len))
+        for i in range(n):
+            s, s_len = make_cbuffer(input_scripts[i][2:])
+            self.assertEqual(WALLY_OK,
+                             wally_tx_get_btc_signature_hash(tx, i, s or None, s_len, values[i],
+                                                             sighashes[i], 0, expected, expected_len))
+            self.assertEqual(h(expected), h(out[i*32:(i+1)*32]))
+
+    def test_sign_inputs(self):
+        """Testing signing all inputs of a transaction"""
+        FLAG_ECDSA, FLAG_GRIND_R = 1, 4
+
+        def hash160(b):
+            buf, buf_len = make_cbuffer('00'*20)
+            self.assertEqual(WALLY_OK, wally_hash160(b, len(b), buf, buf_len))
+            return buf
+
+        def push(b):
+            return bytes([len(b)]) + b
+
+        keys = [bytes([i + 1]) * 32 for i in range(3)]
+        pubs = []
+        for k in keys:
+            pub, pub_len = make_cbuffer('00'*33)
+            self.assertEqual(WALLY_OK,
+                             wally_ec_public_key_from_private_key(k, 32, pub, pub_len))
+            pubs.append(pub)
+        h160s = [hash160(pub) for pub in pubs]
+        redeem = b'\x00\x14' + h160s[2]
+        spks = [b'\x76\xa9\x14' + h160s[0] + b'\x88\xac', # p2pkh
+                b'\x00\x14' + h160s[1], # p2wpkh
+                b'\xa9\x14' + hash160(redeem) + b'\x87'] # p2sh-p2wpkh
+        values = (c_ulonglong * 3)(10000, 20000, 30000)
+        unsigned_hex = utf8('02000000' + '03' +
+                            ''.join(['%02x' % (i + 1) * 32 + '00000000' + '00' + 'ffffffff'
+                                     for i in range(3)]) +
+                            '01' + '1027000000000000' + '160014' + '11' * 20 + '00000000')
+        scripts = b''.join([push(spk) for spk in spks])
+        priv_keys = b''.join(keys)
+
+        def expected_hex(sighash, flags):
+            tx = self.tx_deserialize_hex(unsigned_hex)
+            sigs = []
+            for i in range(3):
+                script_code = spks[0] if i == 0 else b'\x76\xa9\x14' + h160s[i] + b'\x88\xac'
+                msg, msg_len = make_cbuffer('00'*32)
+                self.assertEqual(WALLY_OK,
+                                 wally_tx_get_btc_signature_hash(tx, i, script_code, len(script_code),
+                                                                 values[i], sighash, 1 if i else 0,
+                                                                 msg, msg_len))
+                sig, sig_len = make_cbuffer('00'*64)
+                self.assertEqual(WALLY_OK,
+                                 wally_ec_sig_from_bytes(keys[i], 32, msg, msg_len,
+                                                         FLAG_ECDSA | flags, sig, sig_len))
+                der, der_len = make_cbuffer('00'*72)
+                ret, written = wally_ec_sig_to_der(sig, sig_len, der, der_len)
+                self.assertEqual(WALLY_OK, ret)
+                sigs.append(der[:written] + bytes([sighash]))
+            script_sig = push(sigs[0]) + push(pubs[0])
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script_sig, len(script_sig)))
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 2, push(redeem), len(redeem) + 1))
+            for i in [1, 2]:
+                stack = POINTER(wally_tx_witness_stack)()
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(2, byref(stack)))
+                for item in [sigs[i], pubs[i]]:
+                    self.assertEqual(WALLY_OK, wally_tx_witness_stack_add(stack, item, len(item)))
+                self.assertEqual(WALLY_OK, wally_tx_set_input_witness(tx, i, stack))
+                self.assertEqual(WALLY_OK, wally_tx_witness_stack_free(stack))
+            return self.tx_serialize_hex(tx)
+
+        tx = self.tx_deserialize_hex(unsigned_hex)
+        for sighash, flags in [(0x1, 0), (0x83, FLAG_GRIND_R)]:
+            expected = expected_hex(sighash, flags)
+            self.assertEqual(WALLY_OK,
+                             wally_tx_sign_inputs(tx, scripts, len(scripts), values, 3,
+                                                  priv_keys, len(priv_keys), sighash, flags))
+            self.assertEqual(expected, self.tx_serialize_hex(tx))
+            # Signing on multiple threads gives the same result
+            self.assertEqual(WALLY_OK,
+                             wally_tx_sign_inputs_parallel(tx, scripts, len(scripts), values, 3,
+                                                           priv_keys, len(priv_keys), sighash, flags,
+                                                           run_tasks_threaded, None))
+            self.assertEqual(expected, self.tx_serialize_hex(tx))
+
+        wrong_keys = keys[0] + keys[2] + keys[1]
+        bad_scripts = push(spks[0]) + push(spks[1]) + push(b'\x51')
+        for args in [
+            (None, scripts, len(scripts), values, 3, priv_keys, 96, 1, 0), # Empty tx
+            (tx, None, len(scripts), values, 3, priv_keys, 96, 1, 0), # Empty scripts
+            (tx, scripts, len(scripts) - 1, values, 3, priv_keys, 96, 1, 0), # Short scripts
+            (tx, scripts + b'\x00', len(scripts) + 1, values, 3, priv_keys, 96, 1, 0), # Trailing data
+            (tx, bad_scripts, len(bad_scripts), values, 3, priv_keys, 96, 1, 0), # Unsupported script
+            (tx, scripts, len(scripts), None, 3, priv_keys, 96, 1, 0), # Empty values
+            (tx, scripts, len(scripts), values, 2, priv_keys, 96, 1, 0), # Too few values
+            (tx, scripts, len(scripts), values, 3, None, 96, 1, 0), # Empty keys
+            (tx, scripts, len(scripts), values, 3, priv_keys, 64, 1, 0), # Too few keys
+            (tx, scripts, len(scripts), values, 3, wrong_keys, 96, 1, 0), # Keys don't match
+            (tx, scripts, len(scripts), values, 3, b'\x00' * 96, 96, 1, 0), # Invalid keys
+            (tx, scripts, len(scripts), values, 3, priv_keys, 96, 0, 0), # Empty sighash
+            (tx, scripts, len(scripts), values, 3, priv_keys, 96, 0x100, 0), # Invalid sighash
+            (tx, scripts, len(scripts), values, 3, priv_keys, 96, 1, FLAG_ECDSA), # Invalid flags
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_sign_inputs(*args))
+            # A failed call leaves the transaction untouched
+            self.assertEqual(expected, self.tx_serialize_hex(tx))
+
+    def test_verify_input_signatures(self):
+        """Testing verifying the signatures of all inputs of a transaction"""
+        FLAG_ECDSA = 1
+
+        def hash160(b):
+            buf, buf_len = make_cbuffer('00'*20)
+            self.assertEqual(WALLY_OK, wally_hash160(b, len(b), buf, buf_len))
+            return buf
+
+        def push(b):
+            return bytes([len(b)]) + b
+
+        def p2pkh(pub):
+            return b'\x76\xa9\x14' + hash160(pub) + b'\x88\xac'
+
+        keys = [bytes([i + 1]) * 32 for i in range(5)]
+        pubs = []
+        for k in keys:
+            pub, pub_len = make_cbuffer('00'*33)
+            self.assertEqual(WALLY_OK,
+                             wally_ec_public_key_from_private_key(k, 32, pub, pub_len))
+            pubs.append(pub)
+        full_pub, full_pub_len = make_cbuffer('00'*65)
+        self.assertEqual(WALLY_OK,
+                         wally_ec_public_key_decompress(pubs[4], 33, full_pub, full_pub_len))
+        redeem = b'\x00\x14' + hash160(pubs[2])
+        multisig = b'\x52' + b''.join([push(pub) for pub in pubs[:3]]) + b'\x53\xae'
+        multisig_hash, multisig_hash_len = make_cbuffer('00'*32)
+        self.assertEqual(WALLY_OK, wally_sha256(multisig, len(multisig),
+                                                multisig_hash, multisig_hash_len))
+        spks = [p2pkh(pubs[0]), # p2pkh
+                b'\x00\x14' + hash160(pubs[1]), # p2wpkh
+                b'\xa9\x14' + hash160(redeem) + b'\x87', # p2sh-p2wpkh
+                b'\x00\x20' + multisig_hash, # p2wsh 2-of-3 multisig
+                p2pkh(full_pub)] # p2pkh, uncompressed key
+        num_inputs = len(spks)
+        values = (c_ulonglong * num_inputs)(*[10000 * (i + 1) for i in range(num_inputs)])
+        unsigned_hex = utf8('02000000' + '%02x' % num_inputs +
+                            ''.join(['%02x' % (i + 1) * 32 + '00000000' + '00' + 'ffffffff'
+                                     for i in range(num_inputs)]) +
+                            '01' + '1027000000000000' + '160014' + '11' * 20 + '00000000')
+        scripts = b''.join([push(spk) for spk in spks])
+
+        def sign(tx, i, key, script_code, sighash=1):
+            msg, msg_len = make_cbuffer('00'*32)
+            self.assertEqual(WALLY_OK,
+                             wally_tx_get_btc_signature_hash(tx, i, script_code, len(script_code),
+                                                             values[i], sighash,
+                                                             0 if i in (0, 4) else 1,
+                                                             msg, msg_len))
+            sig, sig_len = make_cbuffer('00'*64)
+            self.assertEqual(WALLY_OK,
+                             wally_ec_sig_from_bytes(key, 32, msg, msg_len, FLAG_ECDSA, sig, sig_len))
+            der, der_len = make_cbuffer('00'*72)
+            ret, written = wally_ec_sig_to_der(sig, sig_len, der, der_len)
+            self.assertEqual(WALLY_OK, ret)
+            return der[:written] + bytes([sighash])
+
+        def set_witness(tx, i, items):
+            stack = POINTER(wally_tx_witness_stack)()
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_init_alloc(len(items), byref(stack)))
+            for item in items:
+                self.assertEqual(WALLY_OK,
+                                 wally_tx_witness_stack_add(stack, item or None, len(item)))
+            self.assertEqual(WALLY_OK, wally_tx_set_input_witness(tx, i, stack))
+            self.assertEqual(WALLY_OK, wally_tx_witness_stack_free(stack))
+
+        def signed_tx(multisig_signers=(0, 2), p2wpkh_sighash=1):
+            tx = self.tx_deserialize_hex(unsigned_hex)
+            script_sig = push(sign(tx, 0, keys[0], spks[0])) + push(pubs[0])
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 0, script_sig, len(script_sig)))
+            sig = sign(tx, 1, keys[1], p2pkh(pubs[1]), p2wpkh_sighash)
+            set_witness(tx, 1, [sig, pubs[1]])
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 2, push(redeem), len(redeem) + 1))
+            set_witness(tx, 2, [sign(tx, 2, keys[2], p2pkh(pubs[2])), pubs[2]])
+            sigs = [sign(tx, 3, keys[j], multisig, 0x81 if j else 1) for j in multisig_signers]
+            set_witness(tx, 3, [b''] + sigs + [multisig])
+            script_sig = push(sign(tx, 4, keys[4], spks[4])) + push(full_pub)
+            self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 4, script_sig, len(script_sig)))
+            return tx
+
+        def verify(tx, expected, scripts=scripts, values=values):
+            results, results_len = make_cbuffer('ff' * num_inputs)
+            ret = wally_tx_verify_input_signatures(tx, scripts, len(scripts), values,
+                                                   num_inputs, 0, results, results_len)
+            self.assertEqual(ret, WALLY_OK if sum(expected) == num_inputs else WALLY_EINVAL)
+            self.assertEqual(list(results), expected)
+            results, results_len = make_cbuffer('ff' * num_inputs)
+            ret = wally_tx_verify_input_signatures_parallel(tx, scripts, len(scripts), values,
+                                                            num_inputs, 0, run_tasks_threaded,
+                                                            None, results, results_len)
+            self.assertEqual(list(results), expected)
+
+        tx = signed_tx()
+        verify(tx, [1] * num_inputs)
+
+        # Multisig signatures must be in key order, by distinct keys
+        for signers, ok in [((0, 1), 1), ((1, 2), 1), ((2, 0), 0), ((0, 0), 0),
+                            ((0, 3), 0), ((0,), 0), ((0, 1, 2), 0)]:
+            verify(signed_tx(signers), [1, 1, 1, ok, 1])
+        # A signature is checked against its own sighash type
+        verify(signed_tx(p2wpkh_sighash=3), [1, 1, 1, 1, 1])
+        tx = signed_tx()
+        sig = sign(tx, 1, keys[1], p2pkh(pubs[1]), 3)[:-1] + b'\x01'
+        set_witness(tx, 1, [sig, pubs[1]])
+        verify(tx, [1, 0, 1, 1, 1])
+        # Segwit signatures commit to the value spent
+        wrong_values = (c_ulonglong * num_inputs)(*[1] * num_inputs)
+        verify(tx, [1, 0, 0, 0, 1], values=wrong_values)
+        # Spends in the wrong form, or of unsupported scripts, are invalid
+        tx = signed_tx()
+        set_witness(tx, 0, [b'\x01'])
+        set_witness(tx, 1, [pubs[1], pubs[1]])
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 2, None, 0))
+        bad_key = full_pub[:-1] + bytes([full_pub[-1] ^ 2])
+        script_sig = push(sign(tx, 4, keys[4], p2pkh(bad_key))) + push(bad_key)
+        self.assertEqual(WALLY_OK, wally_tx_set_input_script(tx, 4, script_sig, len(script_sig)))
+        verify(tx, [0, 0, 0, 1, 0], scripts=scripts[:-26] + push(p2pkh(bad_key)))
+        bad_scripts = push(b'\x51') + scripts[len(spks[0]) + 1:]
+        verify(signed_tx(), [0, 1, 1, 1, 1], scripts=bad_scripts)
+
+        tx = signed_tx()
+        results, results_len = make_cbuffer('00' * num_inputs)
+        for args in [
+            (None, scripts, len(scripts), values, 5, 0, results, 5), # Empty tx
+            (tx, None, len(scripts), values, 5, 0, results, 5), # Empty scripts
+            (tx, scripts, len(scripts) - 1, values, 5, 0, results, 5), # Short scripts
+            (tx, scripts + b'\x00', len(scripts) + 1, values, 5, 0, results, 5), # Trailing data
+            (tx, scripts, len(scripts), None, 5, 0, results, 5), # Empty values
+            (tx, scripts, len(scripts), values, 4, 0, results, 5), # Too few values
+            (tx, scripts, len(scripts), values, 5, 1, results, 5), # Invalid flags
+            (tx, scripts, len(scripts), values, 5, 0, None, 5), # Empty results
+            (tx, scripts, len(scripts), values, 5, 0, results, 4), # Too few results
+            ]:
+            self.assertEqual(WALLY_EINVAL, wally_tx_verify_input_signatures(*args))
+
+    def test_pooled_objects(self):
+        """Fixed size objects are reused when the default allocator is in use"""
+        seed, seed_len = make_cbuffer('01' * 32)
+        txhash, txhash_len = make_cbuffer('02' * 32)
+        script, script_len = make_cbuffer('0014' + '03' * 20)
+
+        def alloc_and_free(n):
+            keys, inputs, outputs, stacks = [], [], [], []
+            for i in range(n):
+                key = POINTER(ext_key)()
+                ret = bip32_key_from_seed_alloc(seed, seed_len, 0x0488ADE4, 0, byref(key))
+                self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(key.contents.depth, 0)
+                keys.append(key)
+                stack = POINTER(wally_tx_witness_stack)()
+                self.assertEqual(wally_tx_witness_stack_init_alloc(1, byref(stack)), WALLY_OK)
+                self.assertEqual(wally_tx_witness_stack_add(stack, script, i), WALLY_OK)
+                stacks.append(stack)
+                tx_input = POINTER(wally_tx_input)()
+                ret = wally_tx_input_init_alloc(txhash, txhash_len, i, 0xffffffff,
+                                                script, script_len, stack, byref(tx_input))
+                self.assertEqual(ret, WALLY_OK)
+                inputs.append(tx_input)
+                tx_output = POINTER(wally_tx_output)()
+                ret = wally_tx_output_init_alloc(i, script, script_len, byref(tx_output))
+                self.assertEqual(ret, WALLY_OK)
+                outputs.append(tx_output)
+            for i in range(n):
+                # Reused objects are fully initialized
+                self.assertEqual(inputs[i].contents.index, i)
+                self.assertEqual(inputs[i].contents.witness.contents.items[0].len, i)
+                self.assertEqual(outputs[i].contents.satoshi, i)
+                self.assertEqual(bip32_key_free(keys[i]), WALLY_OK)
+                self.assertEqual(wally_tx_witness_stack_free(stacks[i]), WALLY_OK)
+                self.assertEqual(wally_tx_input_free(inputs[i]), WALLY_OK)
+                self.assertEqual(wally_tx_output_free(outputs[i]), WALLY_OK)
+
+        # The test suite replaces the allocator, disabling pooling: restore
+        # the default allocator, then switch back, which flushes the pools
+        self.assertEqual(wally_set_operations(byref(util._original_ops)), WALLY_OK)
+        try:
+            for n in [1, 10, 300]:
+                alloc_and_free(n)
+            self.assertEqual(wally_cleanup(0), WALLY_OK)
+            alloc_and_free(5)
+        finally:
+            self.assertEqual(wally_set_operations(byref(util._new_ops)), WALLY_OK)
+        alloc_and_free(5)
+
+    def test_context_allocator(self):
+        """Context aware allocation hooks are used for allocation and resizing"""
+        libc = CDLL(None)
+        libc.malloc.restype, libc.malloc.argtypes = c_void_p, [c_ulong]
+        libc.free.argtypes = [c_void_p]
+        libc.realloc.restype, libc.realloc.argtypes = c_void_p, [c_void_p, c_ulong]
+        ctx = c_ulong(0xcafe)
+        calls = {'malloc': 0, 'free': 0, 'realloc': 0}
+
+        def malloc_ctx(alloc_ctx, size):
+            self.assertEqual(alloc_ctx, addressof(ctx))
+            calls['malloc'] += 1
+            return libc.malloc(size)
+
+        def free_ctx(alloc_ctx, ptr):
+            self.assertEqual(alloc_ctx, addressof(ctx))
+            if ptr:
+                calls['free'] += 1
+            libc.free(ptr)
+
+        def realloc_ctx(alloc_ctx, ptr, size):
+            self.assertEqual(alloc_ctx, addressof(ctx))
+            calls['realloc'] += 1
+            return libc.realloc(ptr, size)
+
+        fns = [util._malloc_ctx_fn_t(malloc_ctx), util._free_ctx_fn_t(free_ctx),
+               util._realloc_ctx_fn_t(realloc_ctx)]
+        ops = util.operations()
+        self.assertEqual(wally_get_operations(byref(ops)), WALLY_OK)
+        ops.alloc_ctx = addressof(ctx)
+        ops.malloc_ctx_fn = fns[0]
+        # malloc_ctx_fn and free_ctx_fn must be given together
+        self.assertEqual(wally_set_operations(byref(ops)), WALLY_EINVAL)
+        ops.free_ctx_fn = fns[1]
+
+        txhash, txhash_len = make_cbuffer('02' * 32)
+        script, script_len = make_cbuffer('0014' + '03' * 20)
+        for realloc_fn in [None, fns[2]]:
+            ops.realloc_ctx_fn = realloc_fn if realloc_fn else util._realloc_ctx_fn_t()
+            for k in calls:
+                calls[k] = 0
+            self.assertEqual(wally_set_operations(byref(ops)), WALLY_OK)
+            try:
+                tx = POINTER(wally_tx)()
+                self.assertEqual(wally_tx_init_alloc(2, 0, 1, 1, byref(tx)), WALLY_OK)
+                for i in range(20):
+                    ret = wally_tx_add_raw_input(tx, txhash, txhash_len, i, 0xffffffff,
+                                                 script, script_len, None, 0)
+                    self.assertEqual(ret, WALLY_OK)
+                self.assertEqual(tx.contents.num_inputs, 20)
+                self.assertEqual(tx.contents.inputs[0].index, 0)
+                self.assertEqual(wally_tx_free(tx), WALLY_OK)
+            finally:
+                self.assertEqual(wally_set_operations(byref(util._new_ops)), WALLY_OK)
+            self.assertGreater(calls['malloc'], 0)
+            self.assertEqual(calls['malloc'], calls['free'])
+            # Growing the inputs resizes in place when realloc is available
+            self.assertEqual(calls['realloc'] > 0, realloc_fn is not None)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -34,6 +34,12 @@ class WIFTests(unittest.TestCase):
             self.assertEqual(ret, WALLY_OK)
             self.assertEqual(utf8(wif), expected_wif)
 
+            out = create_string_buffer(len(expected_wif) + 1)
+            for l in [len(out) - 1, len(out)]:
+                ret, written = wally_wif_from_bytes_to_buffer(prv, prv_len, PREFIX, flag, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(out)))
+            self.assertEqual(out.value, expected_wif)
+
     def test_wif_to_bytes(self):
         buf, buf_len = make_cbuffer('00'*32)
 
@@ -104,6 +110,106 @@ class WIFTests(unittest.TestCase):
             self.assertEqual(ret, WALLY_OK)
             self.assertEqual(addr, exp_addr)
 
+            out = create_string_buffer(len(addr) + 1)
+            for l in [len(out) - 1, len(out)]:
+                ret, written = wally_wif_to_address_to_buffer(wif, PREFIX, VERSION, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(out)))
+            self.assertEqual(out.value, utf8(addr))
+
+    def test_wif_decode(self):
+        from ctypes import byref, c_char_p, c_uint, create_string_buffer
+        prv, prv_len = make_cbuffer('00' * 32)
+        pub, pub_len = make_cbuffer('00' * 65)
+        flags = c_uint()
+
+        for is_uncompressed, wif in [(1, PRV_WIF_UNCOMPRESS), (0, PRV_WIF_COMPRESS)]:
+            ret, addr = wally_wif_decode(wif, PREFIX, VERSION, prv, prv_len,
+                                         pub, pub_len, byref(flags))
+            self.assertEqual(ret, WALLY_OK)
+            self.assertEqual(h(prv).upper(), PRV_HEX)
+            self.assertEqual(flags.value, is_uncompressed)
+            expected = self.private_to_public(prv, is_uncompressed)
+            self.assertEqual(pub, expected + b'\0' * (65 - len(expected)))
+            self.assertEqual(addr, wally_wif_to_address(wif, PREFIX, VERSION)[1])
+
+        for args in [(None, PREFIX, VERSION, prv, prv_len, pub, pub_len),  # Null WIF
+                     (PRV_WIF_COMPRESS, 0x81, VERSION, prv, prv_len, pub, pub_len),  # Wrong prefix
+                     (PRV_WIF_COMPRESS, 0x100, VERSION, prv, prv_len, pub, pub_len),  # Bad prefix
+                     (PRV_WIF_COMPRESS, PREFIX, 0x100, prv, prv_len, pub, pub_len),  # Bad version
+                     (PRV_WIF_COMPRESS, PREFIX, VERSION, None, prv_len, pub, pub_len),  # Null priv key
+                     (PRV_WIF_COMPRESS, PREFIX, VERSION, prv, 31, pub, pub_len),  # Bad priv key len
+                     (PRV_WIF_COMPRESS, PREFIX, VERSION, prv, prv_len, None, pub_len),  # Null pub key
+                     (PRV_WIF_COMPRESS, PREFIX, VERSION, prv, prv_len, pub, 33),  # Bad pub key len
+                     (utf8('11111'), PREFIX, VERSION, prv, prv_len, pub, pub_len)]:  # Bad checksum
+            self.assertEqual(wally_wif_decode(*(args + (byref(flags),))), (WALLY_EINVAL, None))
+            self.assertEqual(flags.value, 0)
+        self.assertEqual(wally_wif_decode(PRV_WIF_COMPRESS, PREFIX, VERSION, prv, prv_len,
+                                          pub, pub_len, None), (WALLY_EINVAL, None))
+
+        # Batch decoding
+        other, other_len = make_cbuffer('11' * 32)
+        other_wif = utf8(wally_wif_from_bytes(other, other_len, PREFIX, 0)[1])
+        wifs = [PRV_WIF_COMPRESS, other_wif, PRV_WIF_UNCOMPRESS]
+        n = len(wifs)
+        c_wifs = (c_char_p * n)(*wifs)
+        expected = [wally_wif_decode(w, PREFIX, VERSION, prv, prv_len, pub, pub_len,
+                                     byref(flags)) + (bytes(bytearray(prv)), bytes(bytearray(pub)), flags.value)
+                    for w in wifs]
+        exp_addrs = utf8(''.join([e[1] + '\0' for e in expected]))
+
+        for run_fn in [run_tasks_threaded, run_tasks_fn_t()]:
+            prvs, prvs_len = make_cbuffer('00' * 32 * n)
+            pubs, pubs_len = make_cbuffer('00' * 65 * n)
+            c_flags = (c_uint * n)()
+            out = create_string_buffer(len(exp_addrs))
+            for l in [0, len(exp_addrs) - 1, len(exp_addrs)]:
+                ret, written = wally_wif_decode_batch(c_wifs, n, PREFIX, VERSION,
+                                                      run_fn, None, prvs, prvs_len,
+                                                      pubs, pubs_len, c_flags, n, out, l)
+                self.assertEqual((ret, written), (WALLY_OK, len(exp_addrs)))
+            self.assertEqual(out.raw, exp_addrs)
+            self.assertEqual(prvs, b''.join([e[2] for e in expected]))
+            self.assertEqual(pubs, b''.join([e[3] for e in expected]))
+            self.assertEqual(list(c_flags), [e[4] for e in expected])
+
+            # Addresses are optional
+            ret, written = wally_wif_decode_batch(c_wifs, n, PREFIX, VERSION,
+                                                  run_fn, None, prvs, prvs_len,
+                                                  pubs, pubs_len, c_flags, n, None, 0)
+            self.assertEqual((ret, written), (WALLY_OK, 0))
+            self.assertEqual(pubs, b''.join([e[3] for e in expected]))
+
+        # Any invalid WIF fails the batch and clears the outputs
+        bad_wifs = (c_char_p * 2)(PRV_WIF_COMPRESS, utf8('11111'))
+        prvs, prvs_len = make_cbuffer('00' * 64)
+        pubs, pubs_len = make_cbuffer('00' * 130)
+        c_flags = (c_uint * 2)()
+        ret, written = wally_wif_decode_batch(bad_wifs, 2, PREFIX, VERSION,
+                                              run_tasks_threaded, None, prvs, prvs_len,
+                                              pubs, pubs_len, c_flags, 2, out, len(out))
+        self.assertEqual((ret, written), (WALLY_EINVAL, 0))
+        self.assertEqual((prvs, pubs, list(c_flags)), (b'\0' * 64, b'\0' * 130, [0, 0]))
+
+        null_wifs = (c_char_p * 2)(PRV_WIF_COMPRESS, None)
+        prvs, prvs_len = make_cbuffer('00' * 32 * n)
+        pubs, pubs_len = make_cbuffer('00' * 65 * n)
+        c_flags = (c_uint * n)()
+        no_run = run_tasks_fn_t()
+        for args in [(None, n, PREFIX, prvs, prvs_len, pubs, pubs_len, c_flags, n, out, len(out)),  # Null WIFs
+                     (null_wifs, 2, PREFIX, prvs, 64, pubs, 130, c_flags, 2, out, len(out)),  # Null WIF
+                     (c_wifs, 0, PREFIX, prvs, 0, pubs, 0, c_flags, 0, out, len(out)),  # No WIFs
+                     (c_wifs, n, 0x100, prvs, prvs_len, pubs, pubs_len, c_flags, n, out, len(out)),  # Bad prefix
+                     (c_wifs, n, PREFIX, None, prvs_len, pubs, pubs_len, c_flags, n, out, len(out)),  # Null priv keys
+                     (c_wifs, n, PREFIX, prvs, prvs_len - 1, pubs, pubs_len, c_flags, n, out, len(out)),  # Bad priv keys len
+                     (c_wifs, n, PREFIX, prvs, prvs_len, None, pubs_len, c_flags, n, out, len(out)),  # Null pub keys
+                     (c_wifs, n, PREFIX, prvs, prvs_len, pubs, 33 * n, c_flags, n, out, len(out)),  # Bad pub keys len
+                     (c_wifs, n, PREFIX, prvs, prvs_len, pubs, pubs_len, None, n, out, len(out)),  # Null flags
+                     (c_wifs, n, PREFIX, prvs, prvs_len, pubs, pubs_len, c_flags, n - 1, out, len(out)),  # Bad flags len
+                     (c_wifs, n, PREFIX, prvs, prvs_len, pubs, pubs_len, c_flags, n, None, len(out))]:  # Null output with len
+            ret = wally_wif_decode_batch(args[0], args[1], args[2], VERSION, no_run, None,
+                                         *args[3:])
+            self.assertEqual(ret, (WALLY_EINVAL, 0))
+
     def private_to_public(self, prv, is_uncompressed):
         pub, pub_len = make_cbuffer('00' * 33)
         self.assertEqual(wally_ec_public_key_from_private_key(prv, 32, pub, pub_len), WALLY_OK)
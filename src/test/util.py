@@ -23,12 +23,44 @@ _malloc_fn_t = CFUNCTYPE(c_void_p, c_ulong)
 _free_fn_t = CFUNCTYPE(c_void_p)
 _bzero_fn_t = CFUNCTYPE(c_void_p, c_ulong)
 _ec_nonce_fn_t = CFUNCTYPE(c_int, c_void_p, c_void_p, c_void_p, c_void_p, c_void_p, c_uint)
+_ec_nonce_ctx_fn_t = CFUNCTYPE(c_int, c_void_p, c_void_p, c_void_p, c_void_p, c_void_p, c_void_p, c_uint)
+_realloc_fn_t = CFUNCTYPE(c_void_p, c_void_p, c_ulong)
+_malloc_ctx_fn_t = CFUNCTYPE(c_void_p, c_void_p, c_ulong)
+_free_ctx_fn_t = CFUNCTYPE(None, c_void_p, c_void_p)
+_realloc_ctx_fn_t = CFUNCTYPE(c_void_p, c_void_p, c_void_p, c_ulong)
+task_fn_t = CFUNCTYPE(None, c_void_p, c_ulong)
+run_tasks_fn_t = CFUNCTYPE(None, c_void_p, c_ulong, task_fn_t, c_void_p)
+
+def _run_tasks_threaded(run_ctx, num_tasks, task_fn, task_ctx):
+    """Run each task on its own thread, as a caller supplied pool would"""
+    import threading
+    threads = [threading.Thread(target=task_fn, args=(task_ctx, i)) for i in range(num_tasks)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+run_tasks_threaded = run_tasks_fn_t(_run_tasks_threaded)
+submit_fn_t = CFUNCTYPE(c_int, c_void_p, task_fn_t, c_void_p)
+async_done_fn_t = CFUNCTYPE(None, c_void_p, c_int)
+read_fn_t = CFUNCTYPE(c_int, c_void_p, c_void_p, c_ulong, POINTER(c_ulong))
 
 class operations(Structure):
     _fields_ = [('malloc_fn', _malloc_fn_t),
                 ('free_fn', _free_fn_t),
                 ('bzero_fn', _bzero_fn_t),
-                ('ec_nonce_fn', _ec_nonce_fn_t)]
+                ('ec_nonce_fn', _ec_nonce_fn_t),
+                ('realloc_fn', _realloc_fn_t),
+                ('alloc_ctx', c_void_p),
+                ('malloc_ctx_fn', _malloc_ctx_fn_t),
+                ('free_ctx_fn', _free_ctx_fn_t),
+                ('realloc_ctx_fn', _realloc_ctx_fn_t),
+                ('ec_nonce_ctx', c_void_p),
+                ('ec_nonce_ctx_fn', _ec_nonce_ctx_fn_t),
+                ('run_tasks_ctx', c_void_p),
+                ('run_tasks_fn', run_tasks_fn_t),
+                ('submit_ctx', c_void_p),
+                ('submit_fn', submit_fn_t)]
 
 class ext_key(Structure):
     _fields_ = [('chain_code', c_ubyte * 32),
@@ -42,6 +74,14 @@ class ext_key(Structure):
                 ('pad2', c_ubyte * 3),
                 ('pub_key', c_ubyte * 33)]
 
+class ext_key_pool(Structure):
+    _fields_ = [('pub_keys', POINTER(c_ubyte)),
+                ('hash160s', POINTER(c_ubyte)),
+                ('child_nums', POINTER(c_uint)),
+                ('num_keys', c_ulong),
+                ('capacity', c_ulong),
+                ('fields', c_uint)]
+
 # Sentinel classes for returning output parameters
 class c_char_p_p_class(object):
     pass
@@ -108,9 +148,69 @@ class wally_tx(Structure):
                 ('num_outputs', c_ulong),
                 ('outputs_allocation_len', c_ulong),]
 
+class wally_block_header(Structure):
+    _fields_ = [('version', c_uint),
+                ('prev_block_hash', c_ubyte * 32),
+                ('merkle_root', c_ubyte * 32),
+                ('timestamp', c_uint),
+                ('bits', c_uint),
+                ('nonce', c_uint)]
+
+class wally_block_iterator(Structure):
+    _fields_ = [('bytes', c_void_p),
+                ('bytes_len', c_ulong),
+                ('offset', c_ulong),
+                ('num_txs', c_ulong),
+                ('index', c_ulong)]
+
+class wally_tx_batch(Structure):
+    _fields_ = [('num_txs', c_ulong),
+                ('versions', POINTER(c_uint)),
+                ('locktimes', POINTER(c_uint)),
+                ('input_offsets', POINTER(c_ulong)),
+                ('output_offsets', POINTER(c_ulong)),
+                ('num_inputs', c_ulong),
+                ('prevout_txhashes', c_void_p),
+                ('prevout_indices', POINTER(c_uint)),
+                ('sequences', POINTER(c_uint)),
+                ('num_outputs', c_ulong),
+                ('satoshis', POINTER(c_ulonglong)),
+                ('script_offsets', POINTER(c_ulong)),
+                ('scripts', c_void_p)]
+
+class wally_tx_arena(Structure):
+    _fields_ = [('bytes', c_void_p),
+                ('len', c_ulong),
+                ('used', c_ulong)]
+
+class wally_script_writer(Structure):
+    _fields_ = [('bytes', c_void_p),
+                ('len', c_ulong),
+                ('written', c_ulong),
+                ('flags', c_uint)]
+
+class wally_tx_iovec(Structure):
+    _fields_ = [('iov_base', c_void_p),
+                ('iov_len', c_ulong)]
+
+class wally_psbt_pair(Structure):
+    _fields_ = [('type', c_ulonglong),
+                ('key', c_void_p),
+                ('key_len', c_ulong),
+                ('key_data', c_void_p),
+                ('key_data_len', c_ulong),
+                ('value', c_void_p),
+                ('value_len', c_ulong)]
+
 for f in (
     ('wally_init', c_int, [c_uint]),
     ('wally_cleanup', c_int, [c_uint]),
+    ('wally_get_cpu_features', c_int, [POINTER(c_ulonglong)]),
+    ('wally_get_init_duration', c_int, [POINTER(c_ulonglong)]),
+    ('wally_get_input_limit', c_int, [c_uint, c_ulong_p]),
+    ('wally_get_scratch_limit', c_int, [c_ulong_p]),
+    ('wally_get_stats', c_int, [c_uint, POINTER(c_ulonglong)]),
+    ('wally_reset_stats', c_int, [c_uint]),
     ('wordlist_init', c_void_p, [c_char_p]),
     ('wordlist_lookup_word', c_ulong, [c_void_p, c_char_p]),
     ('wordlist_lookup_index', c_char_p, [c_void_p, c_ulong]),
@@ -118,59 +218,201 @@ for f in (
     ('mnemonic_from_bytes', c_char_p, [c_void_p, c_void_p, c_ulong]),
     ('mnemonic_to_bytes', c_int, [c_void_p, c_char_p, c_void_p, c_ulong, c_ulong_p]),
     ('wally_base58_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_char_p_p]),
+    ('wally_base58_from_bytes_to_buffer', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_base58_from_bytes_batch', c_int, [c_void_p, c_ulong, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_base58_to_bytes_batch', c_int, [c_void_p, c_ulong, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_base58_get_length', c_int, [c_char_p, c_ulong_p]),
     ('wally_base58_to_bytes', c_int, [c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_base64_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_char_p_p]),
+    ('wally_base64_from_bytes_to_buffer', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_base64_get_maximum_length', c_int, [c_char_p, c_uint, c_ulong_p]),
+    ('wally_base64_n_to_bytes', c_int, [c_char_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_base64_to_bytes', c_int, [c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('bip32_key_free', c_int, [POINTER(ext_key)]),
     ('bip32_key_from_seed', c_int, [c_void_p, c_ulong, c_uint, c_uint, POINTER(ext_key)]),
+    ('bip32_key_from_seed_alloc', c_int, [c_void_p, c_ulong, c_uint, c_uint, POINTER(POINTER(ext_key))]),
     ('bip32_key_serialize', c_int, [POINTER(ext_key), c_uint, c_void_p, c_ulong]),
     ('bip32_key_unserialize', c_int, [c_void_p, c_uint, POINTER(ext_key)]),
     ('bip32_key_from_parent', c_int, [c_void_p, c_uint, c_uint, POINTER(ext_key)]),
+    ('bip32_key_from_parent_parsed', c_int, [c_void_p, c_void_p, c_uint, c_uint, POINTER(ext_key)]),
+    ('bip32_key_from_parent_range', c_int, [c_void_p, c_uint, c_uint, POINTER(ext_key), c_ulong]),
     ('bip32_key_from_parent_path', c_int, [c_void_p, c_uint_p, c_ulong, c_uint, POINTER(ext_key)]),
+    ('bip32_key_discover', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_uint, run_tasks_fn_t, c_void_p, c_uint_p, c_ulong, c_ulong_p]),
+    ('bip32_key_to_addresses_range', c_int, [c_void_p, c_uint, c_ulong, c_uint, c_uint, c_char_p, c_void_p, c_ulong, c_ulong_p]),
+    ('bip32_key_pool_add_range', c_int, [POINTER(ext_key_pool), c_void_p, c_uint, c_ulong, c_uint]),
+    ('bip32_key_pool_free', c_int, [POINTER(ext_key_pool)]),
+    ('bip32_key_pool_get_memory_usage', c_int, [POINTER(ext_key_pool), c_ulong_p]),
+    ('bip32_key_pool_init_alloc', c_int, [c_ulong, c_uint, POINTER(POINTER(ext_key_pool))]),
+    ('bip32_key_from_parent_path_cached', c_int, [c_void_p, c_void_p, c_uint_p, c_ulong, c_uint, POINTER(ext_key)]),
+    ('bip32_path_cache_flush', c_int, [c_void_p]),
+    ('bip32_path_cache_free', c_int, [c_void_p]),
+    ('bip32_path_cache_init_alloc', c_int, [c_ulong, POINTER(c_void_p)]),
     ('bip32_key_to_base58', c_int, [POINTER(ext_key), c_uint, c_char_p_p]),
+    ('bip32_key_to_base58_to_buffer', c_int, [POINTER(ext_key), c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('bip32_key_to_base58_batch', c_int, [POINTER(ext_key), c_ulong, c_uint, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('bip32_key_from_base58', c_int, [c_char_p, POINTER(ext_key)]),
     ('bip32_key_from_base58_alloc', c_int, [c_char_p, POINTER(POINTER(ext_key))]),
     ('bip38_raw_from_private_key', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
     ('bip38_from_private_key', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_char_p_p]),
+    ('bip38_from_private_key_to_buffer', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('bip38_to_private_key', c_int, [c_char_p, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('bip38_to_private_key_batch', c_int, [POINTER(c_char_p), c_ulong, c_void_p, c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong]),
+    ('bip38_to_private_key_async', c_int, [c_char_p, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, async_done_fn_t, c_void_p, POINTER(c_void_p)]),
     ('bip38_raw_to_private_key', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
     ('bip38_raw_get_flags', c_int, [c_void_p, c_ulong, c_ulong_p]),
     ('bip38_get_flags', c_int, [c_char_p, c_ulong_p]),
     ('bip39_get_languages', c_int, [c_char_p_p]),
+    ('bip39_get_languages_to_buffer', c_int, [c_void_p, c_ulong, c_ulong_p]),
     ('bip39_get_wordlist', c_int, [c_char_p, POINTER(c_void_p)]),
     ('bip39_get_word', c_int, [c_void_p, c_ulong, c_char_p_p]),
+    ('bip39_get_word_to_buffer', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('bip39_mnemonic_from_bytes', c_int, [c_void_p, c_void_p, c_ulong, c_char_p_p]),
+    ('bip39_mnemonic_from_bytes_to_buffer', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('bip39_mnemonic_to_bytes', c_int, [c_void_p, c_char_p, c_void_p, c_ulong, c_ulong_p]),
     ('bip39_mnemonic_validate', c_int, [c_void_p, c_char_p]),
+    ('bip39_mnemonic_detect_languages', c_int, [c_char_p, c_ulong_p]),
     ('bip39_mnemonic_to_seed', c_int, [c_char_p, c_char_p, c_void_p, c_ulong, c_ulong_p]),
+    ('bip39_mnemonic_to_seed_batch', c_int, [POINTER(c_char_p), POINTER(c_char_p), c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('bip39_mnemonic_to_seed_async', c_int, [c_char_p, c_char_p, c_void_p, c_ulong, async_done_fn_t, c_void_p, POINTER(c_void_p)]),
+    ('bip39_mnemonic_recover', c_int, [c_void_p, c_char_p, c_uint, c_char_p, c_uint_p, c_ulong, c_void_p, c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_uint_p, c_ulong, c_ulong_p]),
     ('wally_addr_segwit_from_bytes', c_int, [c_void_p, c_ulong, c_char_p, c_uint, c_char_p_p]),
+    ('wally_addr_segwit_from_bytes_to_buffer', c_int, [c_void_p, c_ulong, c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_addr_segwit_from_bytes_batch', c_int, [c_void_p, c_ulong, c_ulong, c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_addr_segwit_to_bytes_batch', c_int, [c_void_p, c_ulong, c_ulong, c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_addr_segwit_to_bytes', c_int, [c_void_p, c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_sha256', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
     ('wally_sha256d', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_sha256_batch', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong]),
+    ('wally_sha256d_batch', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong]),
     ('wally_sha512', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_siphash24', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, POINTER(c_ulonglong)]),
     ('wally_hash160', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_hash160_batch', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong]),
+    ('wally_hash160_final', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha256_init_alloc', c_int, [POINTER(c_void_p)]),
+    ('wally_sha256_update', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha256_final', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha256d_final', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha256_free', c_int, [c_void_p]),
+    ('wally_sha512_init_alloc', c_int, [POINTER(c_void_p)]),
+    ('wally_sha512_update', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha512_final', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_sha512_free', c_int, [c_void_p]),
     ('wally_hex_from_bytes', c_int, [c_void_p, c_ulong, c_char_p_p]),
+    ('wally_hex_from_bytes_to_buffer', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('wally_hex_to_bytes', c_int, [c_char_p, c_void_p, c_ulong, c_ulong_p]),
     ('wally_hmac_sha256', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p]),
     ('wally_hmac_sha512', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p]),
+    ('wally_hmac_sha256_ctx_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_hmac_sha256_ctx_compute', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_hmac_sha256_ctx_free', c_int, [c_void_p]),
+    ('wally_hmac_sha512_ctx_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_hmac_sha512_ctx_compute', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_hmac_sha512_ctx_free', c_int, [c_void_p]),
     ('wally_aes', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
     ('wally_aes_cbc', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_aes_ctx_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_aes_ctx_compute', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_aes_cbc_ctx_compute', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_aes_ctx_free', c_int, [c_void_p]),
+    ('wally_aes_cbc_stream_init_alloc', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, POINTER(c_void_p)]),
+    ('wally_aes_cbc_stream_update', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_aes_cbc_stream_final', c_int, [c_void_p, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_aes_cbc_stream_free', c_int, [c_void_p]),
     ('wally_pbkdf2_hmac_sha256', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_ulong, c_void_p, c_ulong]),
     ('wally_pbkdf2_hmac_sha512', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_ulong, c_void_p, c_ulong]),
     ('wally_scrypt', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_uint, c_uint, c_void_p, c_ulong]),
+    ('wally_scrypt_parallel', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_uint, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong]),
+    ('wally_scrypt_async', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_uint, c_uint, c_void_p, c_ulong, async_done_fn_t, c_void_p, POINTER(c_void_p)]),
+    ('wally_scrypt_get_scratch_length', c_int, [c_uint, c_uint, c_uint, c_ulong_p]),
+    ('wally_set_input_limit', c_int, [c_uint, c_ulong]),
+    ('wally_set_scratch_limit', c_int, [c_ulong]),
+    ('wally_scrypt_with_scratch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_uint, c_uint, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_secret_arena_free', c_int, [c_uint]),
+    ('wally_secret_arena_init', c_int, [c_ulong, c_uint]),
     ('wally_secp_randomize', c_int, [c_void_p, c_ulong]),
+    ('wally_thread_ctx_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_thread_ctx_set', c_int, [c_void_p]),
+    ('wally_thread_ctx_free', c_int, [c_void_p]),
+    ('wally_thread_pool_init_alloc', c_int, [c_ulong, POINTER(c_void_p)]),
+    ('wally_thread_pool_run', None, [c_void_p, c_ulong, task_fn_t, c_void_p]),
+    ('wally_thread_pool_free', c_int, [c_void_p]),
+    ('wally_async_poll', c_int, [c_void_p, c_ulong_p]),
+    ('wally_async_cancel', c_int, [c_void_p]),
+    ('wally_async_free', c_int, [c_void_p]),
     ('wally_ec_private_key_verify', c_int, [c_void_p, c_ulong]),
     ('wally_ec_public_key_decompress', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_public_key_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_ec_public_key_decompress_parsed', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_ec_public_key_free', c_int, [c_void_p]),
+    ('wally_ec_public_key_tweak_add_parsed', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_signing_key_init_alloc', c_int, [c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_ec_signing_key_free', c_int, [c_void_p]),
+    ('wally_ec_signing_key_nonce', c_int, [c_void_p, c_void_p, c_void_p, c_void_p, c_void_p, c_void_p, c_uint]),
+    ('wally_ec_sig_verify_parsed', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
     ('wally_ec_public_key_from_private_key', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_public_keys_convert', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_ec_public_keys_from_private_keys', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_ec_public_key_tweak_add', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_public_keys_tweak_add', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_ec_private_key_tweak_add', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_private_keys_tweak_add', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_sig_from_bytes_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_ec_sig_from_bytes_batch_parallel', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_ec_sig_from_bytes_grind', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_uint, c_void_p, c_ulong, POINTER(c_uint)]),
     ('wally_ec_sig_from_bytes', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
     ('wally_ec_sig_from_der', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_sig_from_der_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
     ('wally_ec_sig_normalize', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_sig_normalize_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_sig_to_public_key', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ecdh', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ecdh_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, run_tasks_fn_t, c_void_p, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_ec_sig_to_public_key_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong, c_void_p, c_ulong]),
     ('wally_ec_sig_to_der', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_ec_sig_to_der_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
     ('wally_ec_sig_verify', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_ec_sig_verify_batch', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, run_tasks_fn_t, c_void_p, c_void_p, c_ulong]),
     ('wally_get_operations', c_int, [POINTER(operations)]),
     ('wally_set_operations', c_int, [POINTER(operations)]),
     ('wally_format_bitcoin_message', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_format_bitcoin_message_batch', c_int, [POINTER(c_char_p), POINTER(c_ulong), c_ulong, c_uint, c_void_p, c_ulong]),
     ('wally_scriptpubkey_get_type', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_script_watchset_init_alloc', c_int, [c_ulong, c_uint, POINTER(c_void_p)]),
+    ('wally_script_watchset_free', c_int, [c_void_p]),
+    ('wally_script_watchset_add', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_script_watchset_add_scripts', c_int, [c_void_p, c_void_p, c_ulong, c_uint_p, c_ulong]),
+    ('wally_script_watchset_contains', c_int, [c_void_p, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_script_watchset_match_tx', c_int, [c_void_p, POINTER(wally_tx), c_uint_p, c_ulong, c_ulong_p]),
+    ('wally_script_watchset_match_tx_view', c_int, [c_void_p, c_void_p, c_uint_p, c_ulong, c_ulong_p]),
+    ('wally_psbt_view_from_bytes', c_int, [c_void_p, c_ulong, c_uint, POINTER(c_void_p)]),
+    ('wally_psbt_view_free', c_int, [c_void_p]),
+    ('wally_psbt_view_get_tx', c_int, [c_void_p, POINTER(POINTER(wally_tx))]),
+    ('wally_psbt_view_get_num_pairs', c_int, [c_void_p, c_uint, c_ulong, c_ulong_p]),
+    ('wally_psbt_view_get_pair', c_int, [c_void_p, c_uint, c_ulong, c_ulong, POINTER(POINTER(wally_psbt_pair))]),
+    ('wally_psbt_view_find_pair', c_int, [c_void_p, c_uint, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_psbt_view_set_pair', c_int, [c_void_p, c_uint, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_psbt_view_remove_pair', c_int, [c_void_p, c_uint, c_ulong, c_ulong]),
+    ('wally_psbt_view_get_input_satoshi', c_int, [c_void_p, c_ulong, POINTER(c_ulonglong)]),
+    ('wally_psbt_view_to_bytes', c_int, [c_void_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_set_init_alloc', c_int, [c_ulong, c_uint, POINTER(c_void_p)]),
+    ('wally_tx_set_free', c_int, [c_void_p]),
+    ('wally_tx_set_add', c_int, [c_void_p, POINTER(wally_tx)]),
+    ('wally_tx_set_remove', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_tx_set_get_num_txs', c_int, [c_void_p, c_ulong_p]),
+    ('wally_tx_set_contains', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_ulong_p]),
+    ('wally_tx_set_get_tx', c_int, [c_void_p, c_void_p, c_ulong, c_uint, POINTER(POINTER(wally_tx))]),
+    ('wally_tx_set_get_spender', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_set_get_conflicts', c_int, [c_void_p, POINTER(wally_tx), c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_set_get_ancestors', c_int, [c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_set_get_prevout_values', c_int, [c_void_p, POINTER(wally_tx), POINTER(c_ulonglong), c_ulong, c_ulong_p]),
     ('wally_script_push_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_script_writer_init', c_int, [POINTER(wally_script_writer), c_void_p, c_ulong, c_uint]),
+    ('wally_script_writer_free', c_int, [POINTER(wally_script_writer)]),
+    ('wally_script_writer_add_opcode', c_int, [POINTER(wally_script_writer), c_uint]),
+    ('wally_script_writer_add_bytes', c_int, [POINTER(wally_script_writer), c_void_p, c_ulong]),
+    ('wally_script_writer_add_push', c_int, [POINTER(wally_script_writer), c_void_p, c_ulong, c_uint]),
+    ('wally_script_writer_add_int', c_int, [POINTER(wally_script_writer), c_int64]),
     ('wally_scriptpubkey_op_return_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_scriptpubkey_p2pkh_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_scriptpubkey_p2sh_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
@@ -180,24 +422,123 @@ for f in (
     ('wally_scriptsig_p2pkh_from_der', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('wally_scriptsig_p2pkh_from_sig', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_scriptsig_multisig_from_bytes', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_scriptsig_multisig_from_der', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_witness_program_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_witness_p2wpkh_from_sig', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_scripts_to_addresses', c_int, [c_void_p, c_ulong, c_ulong, c_uint, c_char_p, c_uint, c_uint, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('wally_tx_to_hex', c_int, [POINTER(wally_tx), c_uint, c_char_p_p]),
+    ('wally_tx_to_hex_to_buffer', c_int, [POINTER(wally_tx), c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_get_memory_usage', c_int, [POINTER(wally_tx), c_ulong_p]),
+    ('wally_tx_to_iovecs', c_int, [POINTER(wally_tx), c_uint, c_void_p, c_ulong, POINTER(wally_tx_iovec), c_ulong, POINTER(c_ulong), c_ulong_p]),
     ('wally_tx_from_hex', c_int, [c_char_p, c_uint, POINTER(POINTER(wally_tx))]),
     ('wally_tx_to_bytes', c_int, [POINTER(wally_tx), c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_tx_from_bytes', c_int, [c_void_p, c_ulong, c_uint, POINTER(POINTER(wally_tx))]),
+    ('wally_tx_from_bytes_skip_witness', c_int, [c_void_p, c_ulong, c_uint, POINTER(c_ulong), c_ulong, POINTER(c_ulong), POINTER(POINTER(wally_tx))]),
+    ('wally_tx_get_compact_length', c_int, [POINTER(wally_tx), c_uint, c_ulong_p]),
+    ('wally_tx_to_compact_bytes', c_int, [POINTER(wally_tx), c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_from_compact_bytes', c_int, [c_void_p, c_ulong, c_uint, POINTER(POINTER(wally_tx))]),
+    ('wally_block_get_hash', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_block_header_from_bytes', c_int, [c_void_p, c_ulong, POINTER(wally_block_header)]),
+    ('wally_block_header_verify_chain', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_block_iterator_init', c_int, [c_void_p, c_ulong, c_uint, POINTER(wally_block_iterator)]),
+    ('wally_block_iterator_next', c_int, [POINTER(wally_block_iterator), POINTER(c_void_p), POINTER(c_ulong), c_void_p, c_ulong]),
+    ('wally_block_get_txids', c_int, [c_void_p, c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_bip152_short_id_key', c_int, [c_void_p, c_ulong, c_ulonglong, c_void_p, c_ulong]),
+    ('wally_bip152_short_ids', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_block_get_short_ids', c_int, [c_void_p, c_ulong, c_ulonglong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_bip152_short_ids_match', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_ulong_p]),
+    ('wally_bip158_filter_from_scripts', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_block_get_bip158_filter', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_bip158_filter_match', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_ulong_p]),
+    ('wally_bip158_filter_header', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_block_reader_init_alloc', c_int, [c_uint, c_void_p, c_ulong, c_ulong, read_fn_t, c_void_p, c_uint, POINTER(c_void_p)]),
+    ('wally_block_reader_free', c_int, [c_void_p]),
+    ('wally_block_reader_next_block', c_int, [c_void_p, POINTER(c_void_p), POINTER(c_ulong)]),
+    ('wally_block_reader_next_tx', c_int, [c_void_p, POINTER(c_void_p), POINTER(c_ulong), c_void_p, c_ulong]),
+    ('wally_merkle_root', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_merkle_branch', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_merkle_branch_verify', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong, c_void_p, c_ulong]),
+    ('wally_tx_get_txid_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_get_wtxid_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_get_output_script_types', c_int, [POINTER(wally_tx), c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_get_output_script_types_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_arena_init', c_int, [POINTER(wally_tx_arena), c_void_p, c_ulong]),
+    ('wally_tx_arena_reset', c_int, [POINTER(wally_tx_arena)]),
+    ('wally_tx_from_bytes_arena', c_int, [c_void_p, c_ulong, c_uint, POINTER(wally_tx_arena), POINTER(POINTER(wally_tx))]),
+    ('wally_txs_from_bytes_arena', c_int, [POINTER(c_void_p), POINTER(c_ulong), c_ulong, c_uint, run_tasks_fn_t, c_void_p, POINTER(wally_tx_arena), POINTER(POINTER(wally_tx))]),
+    ('wally_tx_view_from_bytes', c_int, [c_void_p, c_ulong, c_uint, POINTER(c_void_p)]),
+    ('wally_tx_view_from_hex', c_int, [c_char_p, c_uint, c_void_p, c_ulong, POINTER(c_void_p)]),
+    ('wally_tx_view_free', c_int, [c_void_p]),
+    ('wally_tx_view_get_input_txhash', c_int, [c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_tx_view_get_input_index', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_input_sequence', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_input_script', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_input_script_len', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_input_witness', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_input_witness_len', c_int, [c_void_p, c_ulong, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_output_script', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_output_script_len', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_view_get_output_satoshi', c_int, [c_void_p, c_ulong, POINTER(c_ulonglong)]),
+    ('wally_tx_view_from_bytes_arena', c_int, [c_void_p, c_ulong, c_uint, POINTER(wally_tx_arena), POINTER(c_void_p)]),
+    ('wally_tx_view_get_btc_signature_hash', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulonglong, c_uint, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_batch_from_bytes', c_int, [c_void_p, c_ulong, c_uint, POINTER(POINTER(wally_tx_batch))]),
+    ('wally_block_get_tx_batch', c_int, [c_void_p, c_ulong, c_uint, POINTER(POINTER(wally_tx_batch))]),
+    ('wally_tx_batch_free', c_int, [POINTER(wally_tx_batch)]),
     ('wally_tx_init_alloc', c_int, [c_uint, c_uint, c_ulong, c_ulong, POINTER(POINTER(wally_tx))]),
     ('wally_tx_free', c_int, [POINTER(wally_tx)]),
+    ('wally_tx_clone', c_int, [POINTER(wally_tx), c_uint, POINTER(POINTER(wally_tx))]),
+    ('wally_tx_is_shared', c_int, [POINTER(wally_tx), c_ulong_p]),
+    ('wally_tx_share', c_int, [POINTER(wally_tx), POINTER(POINTER(wally_tx))]),
+    ('wally_tx_unshare', c_int, [POINTER(POINTER(wally_tx))]),
     ('wally_tx_get_length', c_int, [POINTER(wally_tx), c_uint, c_ulong_p]),
     ('wally_tx_get_vsize', c_int, [POINTER(wally_tx), c_ulong_p]),
     ('wally_tx_get_weight', c_int, [POINTER(wally_tx), c_ulong_p]),
     ('wally_tx_vsize_from_weight', c_int, [c_ulong, c_ulong_p]),
+    ('wally_tx_input_get_weight_estimate', c_int, [c_uint, c_uint, c_uint, c_uint, c_ulong_p]),
+    ('wally_tx_get_weight_estimate', c_int, [POINTER(wally_tx), c_ulong, c_ulong, c_ulong, c_ulong_p]),
+    ('wally_coinselect', c_int, [POINTER(c_ulonglong), c_ulong, c_uint_p, c_ulong, c_ulonglong, c_ulong, c_ulonglong, c_ulonglong, c_uint, run_tasks_fn_t, c_void_p, c_uint_p, c_ulong, c_ulong_p]),
+    ('wally_utxo_record_from_script', c_int, [c_void_p, c_ulong, c_uint, c_ulonglong, c_void_p, c_ulong, c_void_p, c_ulong]),
+    ('wally_txout_to_compressed', c_int, [c_ulonglong, c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_txout_from_compressed', c_int, [c_void_p, c_ulong, POINTER(c_ulonglong), c_void_p, c_ulong, POINTER(c_ulong), c_ulong_p]),
+    ('wally_utxo_records_from_coins', c_int, [c_void_p, c_ulong, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_utxo_snapshot_from_records', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_utxo_snapshot_get_num_records', c_int, [c_void_p, c_ulong, c_ulong_p]),
+    ('wally_utxo_snapshot_find', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_uint, c_ulong_p]),
+    ('wally_utxo_snapshot_get', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong, c_uint_p, POINTER(c_ulonglong)]),
+    ('wally_utxo_snapshot_get_scriptpubkey', c_int, [c_void_p, c_ulong, c_ulong, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_utxo_snapshot_get_prevouts', c_int, [c_void_p, c_ulong, POINTER(wally_tx), POINTER(c_ulonglong), c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('wally_tx_get_total_output_satoshi', c_int, [POINTER(wally_tx), POINTER(c_ulonglong)]),
+    ('wally_tx_get_fee', c_int, [POINTER(wally_tx), POINTER(c_ulonglong), c_ulong, POINTER(c_ulonglong)]),
+    ('wally_tx_get_fee_rate', c_int, [POINTER(wally_tx), POINTER(c_ulonglong), c_ulong, POINTER(c_ulonglong)]),
+    ('wally_tx_get_fee_rates', c_int, [POINTER(POINTER(wally_tx)), c_ulong, POINTER(c_ulonglong), c_ulong, POINTER(c_ulonglong), c_ulong]),
     ('wally_tx_get_witness_count', c_int, [POINTER(wally_tx), c_ulong_p]),
     ('wally_tx_get_btc_signature_hash', c_int, [POINTER(wally_tx), c_ulong, c_void_p, c_ulong, c_ulonglong, c_uint, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_sighash_ctx_init_alloc', c_int, [POINTER(wally_tx), c_uint, POINTER(c_void_p)]),
+    ('wally_tx_sighash_ctx_free', c_int, [c_void_p]),
+    ('wally_tx_sighash_ctx_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_void_p]),
+    ('wally_tx_sighash_ctx_to_bytes', c_int, [c_void_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_sighash_stream_add_input', c_int, [c_void_p, c_ulong, c_void_p, c_ulong, c_ulonglong, c_uint, c_uint]),
+    ('wally_tx_sighash_stream_final', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_tx_sighash_stream_free', c_int, [c_void_p]),
+    ('wally_tx_sighash_stream_init_alloc', c_int, [c_uint, POINTER(c_void_p)]),
+    ('wally_tx_sighash_stream_update', c_int, [c_void_p, c_void_p, c_ulong]),
+    ('wally_tx_sighash_verifier_add_input', c_int, [c_void_p, c_void_p, c_ulong, c_uint, c_uint]),
+    ('wally_tx_sighash_verifier_add_output', c_int, [c_void_p, c_ulonglong, c_void_p, c_ulong]),
+    ('wally_tx_sighash_verifier_final', c_int, [c_void_p]),
+    ('wally_tx_sighash_verifier_free', c_int, [c_void_p]),
+    ('wally_tx_sighash_verifier_init_alloc', c_int, [c_void_p, c_uint, POINTER(c_void_p)]),
+    ('wally_tx_get_btc_signature_hash_ctx', c_int, [POINTER(wally_tx), c_void_p, c_ulong, c_void_p, c_ulong, c_ulonglong, c_uint, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_get_signature_hashes', c_int, [POINTER(wally_tx), c_void_p, c_ulong, POINTER(c_ulonglong), c_ulong, c_uint_p, c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_sign_inputs', c_int, [POINTER(wally_tx), c_void_p, c_ulong, POINTER(c_ulonglong), c_ulong, c_void_p, c_ulong, c_uint, c_uint]),
+    ('wally_tx_verify_input_signatures', c_int, [POINTER(wally_tx), c_void_p, c_ulong, POINTER(c_ulonglong), c_ulong, c_uint, c_void_p, c_ulong]),
+    ('wally_tx_verify_input_signatures_parallel', c_int, [POINTER(wally_tx), c_void_p, c_ulong, POINTER(c_ulonglong), c_ulong, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong]),
+    ('wally_tx_sign_inputs_parallel', c_int, [POINTER(wally_tx), c_void_p, c_ulong, POINTER(c_ulonglong), c_ulong, c_void_p, c_ulong, c_uint, c_uint, run_tasks_fn_t, c_void_p]),
     ('wally_tx_witness_stack_init_alloc', c_int, [c_ulong, POINTER(POINTER(wally_tx_witness_stack))]),
     ('wally_tx_witness_stack_free', c_int, [POINTER(wally_tx_witness_stack)]),
+    ('wally_tx_witness_stack_from_bytes', c_int, [c_void_p, c_ulong, POINTER(c_ulong), POINTER(POINTER(wally_tx_witness_stack))]),
     ('wally_tx_witness_stack_add', c_int, [POINTER(wally_tx_witness_stack), c_void_p, c_ulong]),
     ('wally_tx_witness_stack_add_dummy', c_int, [POINTER(wally_tx_witness_stack), c_uint]),
+    ('wally_tx_witness_stack_reserve', c_int, [POINTER(wally_tx_witness_stack), c_ulong]),
     ('wally_tx_witness_stack_set', c_int, [POINTER(wally_tx_witness_stack), c_ulong, c_void_p, c_ulong]),
     ('wally_tx_witness_stack_set_dummy', c_int, [POINTER(wally_tx_witness_stack), c_ulong, c_uint]),
     ('wally_tx_output_init_alloc', c_int, [c_ulonglong, c_void_p, c_ulong, POINTER(POINTER(wally_tx_output))]),
@@ -205,15 +546,27 @@ for f in (
     ('wally_tx_add_output', c_int, [POINTER(wally_tx), POINTER(wally_tx_output)]),
     ('wally_tx_add_raw_output', c_int, [POINTER(wally_tx), c_ulonglong, c_void_p, c_ulong, c_uint]),
     ('wally_tx_remove_output', c_int, [POINTER(wally_tx), c_ulong]),
+    ('wally_tx_index_init_alloc', c_int, [POINTER(wally_tx), c_uint, POINTER(c_void_p)]),
+    ('wally_tx_index_update', c_int, [c_void_p, POINTER(wally_tx)]),
+    ('wally_tx_index_free', c_int, [c_void_p]),
+    ('wally_tx_find_input_by_outpoint', c_int, [POINTER(wally_tx), c_void_p, c_void_p, c_ulong, c_uint, c_ulong_p]),
+    ('wally_tx_find_output_by_script', c_int, [POINTER(wally_tx), c_void_p, c_void_p, c_ulong, c_ulong_p]),
+    ('wally_tx_retain_outputs', c_int, [POINTER(wally_tx), c_void_p, c_ulong]),
+    ('wally_tx_reserve', c_int, [POINTER(wally_tx), c_ulong, c_ulong]),
     ('wally_tx_input_init_alloc', c_int, [c_void_p, c_ulong, c_uint, c_uint, c_void_p, c_ulong, POINTER(wally_tx_witness_stack), POINTER(POINTER(wally_tx_input))]),
     ('wally_tx_input_free', c_int, [POINTER(wally_tx_input)]),
     ('wally_tx_add_input', c_int, [POINTER(wally_tx), POINTER(wally_tx_input)]),
     ('wally_tx_add_raw_input', c_int, [POINTER(wally_tx), c_void_p, c_ulong, c_uint, c_uint, c_void_p, c_ulong, POINTER(wally_tx_witness_stack), c_uint]),
     ('wally_tx_remove_input', c_int, [POINTER(wally_tx), c_ulong]),
+    ('wally_tx_remove_inputs', c_int, [POINTER(wally_tx), POINTER(c_uint), c_ulong]),
     ('wally_tx_set_input_script', c_int, [POINTER(wally_tx), c_ulong, c_void_p, c_ulong]),
     ('wally_tx_set_input_witness', c_int, [POINTER(wally_tx), c_ulong, POINTER(wally_tx_witness_stack)]),
+    ('wally_wif_decode', c_int, [c_char_p, c_uint, c_uint, c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_char_p_p]),
+    ('wally_wif_decode_batch', c_int, [POINTER(c_char_p), c_ulong, c_uint, c_uint, run_tasks_fn_t, c_void_p, c_void_p, c_ulong, c_void_p, c_ulong, c_uint_p, c_ulong, c_void_p, c_ulong, c_ulong_p]),
     ('wally_wif_from_bytes', c_int, [c_void_p, c_ulong, c_uint, c_uint, c_char_p_p]),
+    ('wally_wif_from_bytes_to_buffer', c_int, [c_void_p, c_ulong, c_uint, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_wif_to_address', c_int, [c_char_p, c_uint, c_uint, c_char_p_p]),
+    ('wally_wif_to_address_to_buffer', c_int, [c_char_p, c_uint, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_wif_to_bytes', c_int, [c_char_p, c_uint, c_uint, c_void_p, c_ulong]),
     ('wally_wif_to_public_key', c_int, [c_char_p, c_uint, c_void_p, c_ulong, c_ulong_p]),
     ('wally_wif_is_uncompressed', c_int, [c_char_p, c_ulong_p]),
@@ -289,6 +642,17 @@ _new_ops = operations()
 for ops in (_original_ops, _new_ops):
     assert wally_get_operations(byref(ops)) == WALLY_OK
 
+# Run a test with the portable implementations and then with any optimized
+# ones. The portable run only happens while wally_init has not yet selected
+# optimized implementations in this process
+def optimized_runs():
+    features = c_ulonglong()
+    assert wally_get_cpu_features(byref(features)) == WALLY_OK
+    if not features.value:
+        yield False
+        assert wally_init(0) == WALLY_OK
+    yield True
+
 # Disable internal tests if not available
 def internal_only():
     def decorator(test_func):
@@ -340,4 +704,36 @@ def _fake_ec_nonce_fn(nonce32, msg32, key32, algo16, data, attempt):
 
 _new_ops.ec_nonce_fn = _ec_nonce_fn_t(_fake_ec_nonce_fn)
 
+# Support for asynchronous operation testing
+def set_submit_fn(submit_fn):
+    """Run asynchronous operations with submit_fn, or synchronously if None"""
+    ops = operations()
+    assert wally_get_operations(byref(ops)) == WALLY_OK
+    ops.submit_fn = submit_fn or submit_fn_t()
+    assert wally_set_operations(byref(ops)) == WALLY_OK
+
+class AsyncTasks(object):
+    """Collects submitted tasks, to run them later or on their own threads"""
+    def __init__(self, threaded=False, ret=WALLY_OK):
+        self.tasks, self.threads, self.threaded, self.ret = [], [], threaded, ret
+        self.submit_fn = submit_fn_t(self._submit)
+
+    def _submit(self, submit_ctx, task_fn, task_ctx):
+        if self.ret == WALLY_OK:
+            if self.threaded:
+                import threading
+                t = threading.Thread(target=task_fn, args=(task_ctx, 0))
+                self.threads.append(t)
+                t.start()
+            else:
+                self.tasks.append((task_fn, task_ctx))
+        return self.ret
+
+    def run(self):
+        for task_fn, task_ctx in self.tasks:
+            task_fn(task_ctx, 0)
+        for t in self.threads:
+            t.join()
+        self.tasks, self.threads = [], []
+
 assert wally_set_operations(byref(_new_ops)) == WALLY_OK
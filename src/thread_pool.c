@@ -0,0 +1,192 @@
+#include "internal.h"
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <stdbool.h>
+
+/* A fixed set of worker threads that run the tasks of one batch at a time.
+ * The thread submitting a batch works on it too, taking task indices from
+ * the same counter as the workers until none remain */
+struct wally_thread_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond; /* Signalled when a batch starts or on stop */
+    pthread_cond_t done_cond; /* Signalled when a batch completes */
+    pthread_mutex_t run_lock; /* Held while a batch is running */
+    pthread_t *threads;
+    size_t num_threads;
+    /* The current batch, protected by lock */
+    wally_task_t task_fn;
+    void *task_ctx;
+    size_t num_tasks;
+    size_t next_task;
+    size_t num_done;
+    uint64_t batch_id;
+    bool stop;
+};
+
+/* Run tasks from the current batch until none remain. Called with lock held */
+static void pool_work(struct wally_thread_pool *pool)
+{
+    while (pool->next_task < pool->num_tasks) {
+        const size_t i = pool->next_task++;
+        wally_task_t task_fn = pool->task_fn;
+        void *task_ctx = pool->task_ctx;
+
+        pthread_mutex_unlock(&pool->lock);
+        task_fn(task_ctx, i);
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->num_done == pool->num_tasks)
+            pthread_cond_signal(&pool->done_cond);
+    }
+}
+
+static void *pool_worker(void *arg)
+{
+    struct wally_thread_pool *pool = arg;
+    uint64_t seen_id = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->batch_id == seen_id)
+            pthread_cond_wait(&pool->work_cond, &pool->lock);
+        if (pool->stop)
+            break;
+        seen_id = pool->batch_id;
+        pool_work(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+static void pool_stop(struct wally_thread_pool *pool)
+{
+    size_t i;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->num_threads; ++i)
+        pthread_join(pool->threads[i], NULL);
+    pool->num_threads = 0;
+}
+
+int wally_thread_pool_init_alloc(size_t num_threads,
+                                 struct wally_thread_pool **output)
+{
+    struct wally_thread_pool *pool;
+
+    if (output)
+        *output = NULL;
+
+    if (num_threads > WALLY_THREAD_POOL_MAX_THREADS || !output)
+        return WALLY_EINVAL;
+
+    if (!(pool = wally_malloc(sizeof(*pool))))
+        return WALLY_ENOMEM;
+    wally_clear(pool, sizeof(*pool));
+
+    if (num_threads &&
+        !(pool->threads = wally_malloc(num_threads * sizeof(*pool->threads)))) {
+        wally_free(pool);
+        return WALLY_ENOMEM;
+    }
+
+    if (pthread_mutex_init(&pool->lock, NULL) ||
+        pthread_mutex_init(&pool->run_lock, NULL) ||
+        pthread_cond_init(&pool->work_cond, NULL) ||
+        pthread_cond_init(&pool->done_cond, NULL)) {
+        wally_free(pool->threads);
+        wally_free(pool);
+        return WALLY_ERROR;
+    }
+
+    for (; pool->num_threads < num_threads; ++pool->num_threads) {
+        if (pthread_create(pool->threads + pool->num_threads, NULL,
+                           pool_worker, pool)) {
+            wally_thread_pool_free(pool);
+            return WALLY_ERROR;
+        }
+    }
+    *output = pool;
+    return WALLY_OK;
+}
+
+void wally_thread_pool_run(void *run_ctx, size_t num_tasks,
+                           wally_task_t task_fn, void *task_ctx)
+{
+    struct wally_thread_pool *pool = run_ctx;
+    size_t i;
+
+    if (!num_tasks || !task_fn)
+        return;
+
+    if (!pool || !pool->num_threads || num_tasks == 1 ||
+        pthread_mutex_trylock(&pool->run_lock)) {
+        /* No workers to share with, or the pool is busy */
+        for (i = 0; i < num_tasks; ++i)
+            task_fn(task_ctx, i);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task_fn = task_fn;
+    pool->task_ctx = task_ctx;
+    pool->num_tasks = num_tasks;
+    pool->next_task = 0;
+    pool->num_done = 0;
+    ++pool->batch_id;
+    pthread_cond_broadcast(&pool->work_cond);
+
+    pool_work(pool);
+    while (pool->num_done != pool->num_tasks)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pool->task_fn = NULL;
+    pool->task_ctx = NULL;
+    pool->num_tasks = 0;
+    pool->next_task = 0;
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run_lock);
+}
+
+int wally_thread_pool_free(struct wally_thread_pool *pool)
+{
+    if (!pool)
+        return WALLY_EINVAL;
+
+    pool_stop(pool);
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->run_lock);
+    pthread_mutex_destroy(&pool->lock);
+    wally_free(pool->threads);
+    wally_clear(pool, sizeof(*pool));
+    wally_free(pool);
+    return WALLY_OK;
+}
+#else
+int wally_thread_pool_init_alloc(size_t num_threads,
+                                 struct wally_thread_pool **output)
+{
+    (void)num_threads;
+    if (output)
+        *output = NULL;
+    return output ? WALLY_ERROR : WALLY_EINVAL;
+}
+
+void wally_thread_pool_run(void *run_ctx, size_t num_tasks,
+                           wally_task_t task_fn, void *task_ctx)
+{
+    size_t i;
+
+    (void)run_ctx;
+    if (task_fn)
+        for (i = 0; i < num_tasks; ++i)
+            task_fn(task_ctx, i);
+}
+
+int wally_thread_pool_free(struct wally_thread_pool *pool)
+{
+    return pool ? WALLY_ERROR : WALLY_EINVAL;
+}
+#endif /* HAVE_PTHREAD */
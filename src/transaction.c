@@ -1,14 +1,20 @@
+#define WALLY_STATS_ALLOC_STAT WALLY_STAT_TX_ALLOC_BYTES
 #include "internal.h"
 
 #include "ccan/ccan/build_assert/build_assert.h"
+#include "ccan/ccan/crypto/sha256/sha256.h"
 
 #include <include/wally_crypto.h>
+#include <include/wally_elements.h>
+#include <include/wally_script.h>
 #include <include/wally_transaction.h>
 
 #include <limits.h>
 #include <stdbool.h>
 #include "transaction_int.h"
 #include "script_int.h"
+#include "siphash.h"
+#include "hash_table.h"
 
 #define WALLY_TX_ALL_FLAGS (WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_USE_ELEMENTS)
 
@@ -22,11 +28,11 @@ static const unsigned char DUMMY_SIG[EC_SIGNATURE_DER_MAX_LEN + 1]; /* +1 for si
 #define SIGHASH_MASK 0x1f
 
 /* Bytes of stack space to use to avoid allocations for tx serializing */
-#define TX_STACK_SIZE 2048
+#define TX_STACK_SIZE WALLY_TX_STACK_SIZE
 
 #define TX_CHECK_OUTPUT if (!output) return WALLY_EINVAL; else *output = NULL
 #define TX_OUTPUT_ALLOC(typ) \
-    *output = wally_malloc(sizeof(typ)); \
+    *output = wally_pool_malloc(sizeof(typ)); \
     if (!*output) return WALLY_ENOMEM; \
     wally_clear((void *)*output, sizeof(typ)); \
     result = (typ *) *output;
@@ -43,6 +49,8 @@ static const unsigned char DUMMY_SIG[EC_SIGNATURE_DER_MAX_LEN + 1]; /* +1 for si
 
 #define MAX_INVALID_SATOSHI ((uint64_t) -1)
 
+#define MAX_SCRIPT_ELEMENT_SIZE 520 /* Maximum size of a pushed P2SH redeem script */
+
 /* Extra options when serializing for hashing */
 struct tx_serialize_opts
 {
@@ -55,6 +63,7 @@ struct tx_serialize_opts
     bool bip143;                     /* Serialize for BIP143 hash */
     const unsigned char *value;      /* Confidential value of the input we are signing */
     size_t value_len;                /* length of 'value' in bytes */
+    const struct wally_tx_sighash_ctx *ctx; /* Precomputed BIP143 hashes, or NULL */
 };
 
 static const unsigned char EMPTY_OUTPUT[9] = {
@@ -73,25 +82,67 @@ static void assert_tx_assumptions(void)
 }
 /* LCOV_EXCL_END */
 
+/* The allocation length marking the arrays of a read-only clone, which
+ * are never resized or freed individually */
+#define TX_READ_ONLY_LEN ((size_t)-1)
+
+/* A read-only clone: the transaction and all of its data in a single
+ * allocation, freed when its last owner calls wally_tx_free */
+struct tx_block {
+    size_t refs; /* The number of owners in addition to the first */
+    size_t len; /* The length of the allocation */
+    struct wally_tx tx;
+};
+
+static struct tx_block *tx_block_of(const struct wally_tx *tx)
+{
+    return (struct tx_block *)((const unsigned char *)tx - offsetof(struct tx_block, tx));
+}
+
+static bool is_read_only_witness_stack(const struct wally_tx_witness_stack *stack)
+{
+    return stack && stack->items_allocation_len == TX_READ_ONLY_LEN;
+}
+
 static bool is_valid_witness_stack(const struct wally_tx_witness_stack *stack)
 {
     return stack &&
-           BYTES_VALID(stack->items, stack->items_allocation_len) &&
+           (is_read_only_witness_stack(stack) ||
+            BYTES_VALID(stack->items, stack->items_allocation_len)) &&
            (stack->items != NULL || stack->num_items == 0);
 }
 
+/* As is_valid_witness_stack, additionally requiring that stack may be modified */
+static bool is_mutable_witness_stack(const struct wally_tx_witness_stack *stack)
+{
+    return is_valid_witness_stack(stack) && !is_read_only_witness_stack(stack);
+}
+
+static bool is_read_only_tx(const struct wally_tx *tx)
+{
+    return tx->inputs_allocation_len == TX_READ_ONLY_LEN &&
+           tx->outputs_allocation_len == TX_READ_ONLY_LEN;
+}
+
 static bool is_valid_tx(const struct wally_tx *tx)
 {
     /* Note: The last two conditions are redundant, but having them here
      *       ensures accurate static analysis from tools like clang.
      */
     return tx &&
-           BYTES_VALID(tx->inputs, tx->inputs_allocation_len) &&
-           BYTES_VALID(tx->outputs, tx->outputs_allocation_len) &&
+           (is_read_only_tx(tx) ||
+            (BYTES_VALID(tx->inputs, tx->inputs_allocation_len) &&
+             BYTES_VALID(tx->outputs, tx->outputs_allocation_len))) &&
            (tx->num_inputs == 0 || tx->inputs != NULL) &&
            (tx->num_outputs == 0 || tx->outputs != NULL);
 }
 
+/* As is_valid_tx, additionally requiring that tx may be modified */
+static bool is_mutable_tx(const struct wally_tx *tx)
+{
+    return is_valid_tx(tx) && !is_read_only_tx(tx);
+}
+
 static bool is_valid_tx_input(const struct wally_tx_input *input)
 {
     return input &&
@@ -171,36 +222,87 @@ static bool clone_bytes(unsigned char **dst, const unsigned char *src, size_t le
     return *dst != NULL;
 }
 
-static void clear_and_free(void *p, size_t len)
+/* Alignment of arena allocations, suitable for all transaction structures */
+#define ARENA_ALIGN sizeof(uint64_t)
+
+static void *arena_alloc(struct wally_tx_arena *arena, size_t len)
+{
+    const uintptr_t base = (uintptr_t)(arena->bytes + arena->used);
+    const size_t offset = arena->used + ((ARENA_ALIGN - base % ARENA_ALIGN) % ARENA_ALIGN);
+    void *p;
+
+    if (offset > arena->len || len > arena->len - offset)
+        return NULL;
+    p = arena->bytes + offset;
+    arena->used = offset + len;
+    wally_clear(p, len);
+    return p;
+}
+
+static bool arena_clone_bytes(struct wally_tx_arena *arena, unsigned char **dst,
+                              const unsigned char *src, size_t len)
 {
-    if (p) {
-        wally_clear(p, len);
-        wally_free(p);
+    if (!len) {
+        *dst = NULL;
+        return true;
     }
+    if ((*dst = arena_alloc(arena, len)))
+        memcpy(*dst, src, len);
+    return *dst != NULL;
 }
 
-static void *realloc_array(const void *src, size_t old_n, size_t new_n, size_t size)
+/* Round len up to a whole number of arena allocation units */
+#define ARENA_ALIGN_UP(len) (((len) + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN)
+
+/* Ensure an array can hold at least new_n items, preserving its contents.
+ * Arrays hold no secret data, so they can be resized in place */
+static int array_reserve(void **src, size_t *allocation_len,
+                         size_t new_n, size_t size)
 {
-    unsigned char *p = wally_malloc(new_n * size);
-    if (!p)
-        return NULL;
-    if (src)
-        memcpy(p, src, old_n * size);
-    wally_clear(p + old_n * size, (new_n - old_n) * size);
-    return p;
+    unsigned char *p;
+
+    if (new_n <= *allocation_len)
+        return WALLY_OK;
+
+    if (!(p = wally_realloc(*src, *allocation_len * size, new_n * size)))
+        return WALLY_ENOMEM;
+
+    wally_clear(p + *allocation_len * size, (new_n - *allocation_len) * size);
+    *src = p;
+    *allocation_len = new_n;
+    return WALLY_OK;
 }
 
-static int replace_script(const unsigned char *script, size_t script_len,
-                          unsigned char **script_out, size_t *script_len_out)
+/* Grow an array geometrically so that appending items is amortized O(1) */
+static int array_grow(void **src, size_t *allocation_len,
+                      size_t new_n, size_t size)
 {
-    /* TODO: Avoid reallocation if new script is smaller than the existing one */
-    unsigned char *new_script = NULL;
-    if (!clone_bytes(&new_script, script, script_len))
+    if (new_n <= *allocation_len)
+        return WALLY_OK;
+    if (new_n < *allocation_len * 2)
+        new_n = *allocation_len * 2;
+    return array_reserve(src, allocation_len, new_n, size);
+}
+
+static int replace_bytes(const unsigned char *bytes, size_t bytes_len,
+                         unsigned char **bytes_out, size_t *bytes_len_out)
+{
+    unsigned char *new_bytes = NULL;
+
+    if (bytes_len && *bytes_out && bytes_len <= *bytes_len_out) {
+        /* Reuse the existing allocation, wiping any unused tail */
+        memmove(*bytes_out, bytes, bytes_len);
+        wally_clear_public(*bytes_out + bytes_len, *bytes_len_out - bytes_len);
+        *bytes_len_out = bytes_len;
+        return WALLY_OK;
+    }
+
+    if (!clone_bytes(&new_bytes, bytes, bytes_len))
         return WALLY_ENOMEM;
 
-    clear_and_free(*script_out, *script_len_out);
-    *script_out = new_script;
-    *script_len_out = script_len;
+    clear_public_and_free(*bytes_out, *bytes_len_out);
+    *bytes_out = new_bytes;
+    *bytes_len_out = bytes_len;
     return WALLY_OK;
 }
 
@@ -212,7 +314,9 @@ static struct wally_tx_witness_stack *clone_witness(
     size_t i;
     int ret;
 
-    ret = wally_tx_witness_stack_init_alloc(stack->items_allocation_len, &result);
+    ret = wally_tx_witness_stack_init_alloc(is_read_only_witness_stack(stack) ?
+                                            stack->num_items : stack->items_allocation_len,
+                                            &result);
 
     if (ret == WALLY_OK) {
         for (i = 0; i < stack->num_items && ret == WALLY_OK; ++i) {
@@ -259,20 +363,22 @@ static int tx_witness_stack_free(struct wally_tx_witness_stack *stack,
         if (stack->items) {
             for (i = 0; i < stack->num_items; ++i) {
                 if (stack->items[i].witness)
-                    clear_and_free(stack->items[i].witness,
-                                   stack->items[i].witness_len);
+                    clear_public_and_free(stack->items[i].witness,
+                                          stack->items[i].witness_len);
             }
-            clear_and_free(stack->items, stack->num_items * sizeof(*stack->items));
+            clear_public_and_free(stack->items, stack->num_items * sizeof(*stack->items));
         }
         wally_clear(stack, sizeof(*stack));
         if (free_parent)
-            wally_free(stack);
+            wally_pool_free(stack, sizeof(*stack));
     }
     return WALLY_OK;
 }
 
 int wally_tx_witness_stack_free(struct wally_tx_witness_stack *stack)
 {
+    if (is_read_only_witness_stack(stack))
+        return WALLY_EINVAL; /* Freed with the read-only clone that holds it */
     return tx_witness_stack_free(stack, true);
 }
 
@@ -295,34 +401,41 @@ int wally_tx_witness_stack_add_dummy(
 }
 
 
+int wally_tx_witness_stack_reserve(struct wally_tx_witness_stack *stack,
+                                   size_t num_items)
+{
+    if (!is_mutable_witness_stack(stack))
+        return WALLY_EINVAL;
+
+    return array_reserve((void **)&stack->items,
+                         &stack->items_allocation_len, num_items,
+                         sizeof(*stack->items));
+}
+
 int wally_tx_witness_stack_set(struct wally_tx_witness_stack *stack, size_t index,
                                const unsigned char *witness, size_t witness_len)
 {
     unsigned char *new_witness = NULL;
 
-    if (!is_valid_witness_stack(stack) || (!witness && witness_len))
+    if (!is_mutable_witness_stack(stack) || (!witness && witness_len))
         return WALLY_EINVAL;
 
+    if (index < stack->num_items)
+        return replace_bytes(witness, witness_len, &stack->items[index].witness,
+                             &stack->items[index].witness_len);
+
     if (!clone_bytes(&new_witness, witness, witness_len))
         return WALLY_ENOMEM;
 
-    if (index >= stack->num_items) {
-        if (index >= stack->items_allocation_len) {
-            /* Expand the witness array */
-            struct wally_tx_witness_item *p;
-            p = realloc_array(stack->items, stack->items_allocation_len,
-                              index + 1, sizeof(*stack->items));
-            if (!p) {
-                clear_and_free(new_witness, witness_len);
-                return WALLY_ENOMEM;
-            }
-            clear_and_free(stack->items, stack->num_items * sizeof(*stack->items));
-            stack->items = p;
-            stack->items_allocation_len = index + 1;
-        }
-        stack->num_items = index + 1;
+    /* Expand the witness array */
+    if (array_grow((void **)&stack->items,
+                   &stack->items_allocation_len, index + 1,
+                   sizeof(*stack->items)) != WALLY_OK) {
+        clear_public_and_free(new_witness, witness_len);
+        return WALLY_ENOMEM;
     }
-    clear_and_free(stack->items[index].witness, stack->items[index].witness_len);
+    stack->num_items = index + 1;
+    clear_public_and_free(stack->items[index].witness, stack->items[index].witness_len);
     stack->items[index].witness = new_witness;
     stack->items[index].witness_len = witness_len;
     return WALLY_OK;
@@ -371,12 +484,12 @@ static bool clone_input_to(
         !clone_bytes(&new_inflation_keys_rangeproof, src->inflation_keys_rangeproof, src->inflation_keys_rangeproof_len) ||
 #endif
         (src->witness && !new_witness)) {
-        clear_and_free(new_script, src->script_len);
+        clear_public_and_free(new_script, src->script_len);
 #ifdef BUILD_ELEMENTS
-        clear_and_free(new_issuance_amount, src->issuance_amount_len);
-        clear_and_free(new_inflation_keys, src->inflation_keys_len);
-        clear_and_free(new_issuance_amount_rangeproof, src->issuance_amount_rangeproof_len);
-        clear_and_free(new_inflation_keys_rangeproof, src->inflation_keys_rangeproof_len);
+        clear_public_and_free(new_issuance_amount, src->issuance_amount_len);
+        clear_public_and_free(new_inflation_keys, src->inflation_keys_len);
+        clear_public_and_free(new_issuance_amount_rangeproof, src->issuance_amount_rangeproof_len);
+        clear_public_and_free(new_inflation_keys_rangeproof, src->inflation_keys_rangeproof_len);
         wally_tx_witness_stack_free(new_pegin_witness);
 #endif
         wally_tx_witness_stack_free(new_witness);
@@ -384,6 +497,8 @@ static bool clone_input_to(
     }
 
     memcpy(dst, src, sizeof(*src));
+    /* The clone owns its proofs, and may be modified */
+    dst->features &= ~(WALLY_TX_PROOFS_REFERENCED | WALLY_TX_READ_ONLY);
     dst->script = new_script;
 #ifdef BUILD_ELEMENTS
     dst->issuance_amount = new_issuance_amount;
@@ -401,22 +516,34 @@ static int tx_elements_input_issuance_proof_init(
     const unsigned char *issuance_amount_rangeproof,
     size_t issuance_amount_rangeproof_len,
     const unsigned char *inflation_keys_rangeproof,
-    size_t inflation_keys_rangeproof_len)
+    size_t inflation_keys_rangeproof_len,
+    bool reference)
 {
 #ifdef BUILD_ELEMENTS
     unsigned char *new_issuance_amount_rangeproof = NULL, *new_inflation_keys_rangeproof = NULL;
 #endif
     (void) input;
+    (void) reference;
 
     if (BYTES_INVALID(issuance_amount_rangeproof, issuance_amount_rangeproof_len) ||
         BYTES_INVALID(inflation_keys_rangeproof, inflation_keys_rangeproof_len))
         return WALLY_EINVAL;
 
 #ifdef BUILD_ELEMENTS
+    if (reference) {
+        /* Point into the caller's bytes, which outlive the input */
+        input->issuance_amount_rangeproof = (unsigned char *)issuance_amount_rangeproof;
+        input->issuance_amount_rangeproof_len = issuance_amount_rangeproof_len;
+        input->inflation_keys_rangeproof = (unsigned char *)inflation_keys_rangeproof;
+        input->inflation_keys_rangeproof_len = inflation_keys_rangeproof_len;
+        if (issuance_amount_rangeproof || inflation_keys_rangeproof)
+            input->features |= WALLY_TX_PROOFS_REFERENCED;
+        return WALLY_OK;
+    }
     if (!clone_bytes(&new_issuance_amount_rangeproof, issuance_amount_rangeproof, issuance_amount_rangeproof_len) ||
         !clone_bytes(&new_inflation_keys_rangeproof, inflation_keys_rangeproof, inflation_keys_rangeproof_len)) {
-        clear_and_free(new_issuance_amount_rangeproof, issuance_amount_rangeproof_len);
-        clear_and_free(new_inflation_keys_rangeproof, inflation_keys_rangeproof_len);
+        clear_public_and_free(new_issuance_amount_rangeproof, issuance_amount_rangeproof_len);
+        clear_public_and_free(new_inflation_keys_rangeproof, inflation_keys_rangeproof_len);
         return WALLY_ENOMEM;
     }
 
@@ -467,11 +594,12 @@ static int tx_elements_input_issuance_init(
                                                     issuance_amount_rangeproof,
                                                     issuance_amount_rangeproof_len,
                                                     inflation_keys_rangeproof,
-                                                    inflation_keys_rangeproof_len);
+                                                    inflation_keys_rangeproof_len,
+                                                    false);
 
     if (ret != WALLY_OK) {
-        clear_and_free(new_issuance_amount, issuance_amount_len);
-        clear_and_free(new_inflation_keys, inflation_keys_len);
+        clear_public_and_free(new_issuance_amount, issuance_amount_len);
+        clear_public_and_free(new_inflation_keys, inflation_keys_len);
         return ret;
     }
 
@@ -516,8 +644,13 @@ int wally_tx_elements_input_issuance_set(
     size_t input_issuance_amount_rangeproof_len = input->issuance_amount_rangeproof_len;
     unsigned char *input_inflation_keys_rangeproof = input->inflation_keys_rangeproof;
     size_t input_inflation_keys_rangeproof_len = input->inflation_keys_rangeproof_len;
+    const bool referenced = input->features & WALLY_TX_PROOFS_REFERENCED;
 #endif /* BUILD_ELEMENTS */
-    int ret = tx_elements_input_issuance_init(input,
+    int ret;
+
+    if (input && (input->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL;
+    ret = tx_elements_input_issuance_init(input,
                                               nonce,
                                               nonce_len,
                                               entropy,
@@ -533,10 +666,13 @@ int wally_tx_elements_input_issuance_set(
                                               true);
 #ifdef BUILD_ELEMENTS
     if (ret == WALLY_OK) {
-        clear_and_free(input_issuance_amount, input_issuance_amount_len);
-        clear_and_free(input_inflation_keys, input_inflation_keys_len);
-        clear_and_free(input_issuance_amount_rangeproof, input_issuance_amount_rangeproof_len);
-        clear_and_free(input_inflation_keys_rangeproof, input_inflation_keys_rangeproof_len);
+        clear_public_and_free(input_issuance_amount, input_issuance_amount_len);
+        clear_public_and_free(input_inflation_keys, input_inflation_keys_len);
+        if (!referenced) {
+            clear_public_and_free(input_issuance_amount_rangeproof, input_issuance_amount_rangeproof_len);
+            clear_public_and_free(input_inflation_keys_rangeproof, input_inflation_keys_rangeproof_len);
+        }
+        input->features &= ~WALLY_TX_PROOFS_REFERENCED;
     }
 #endif /* BUILD_ELEMENTS */
     return ret;
@@ -546,15 +682,20 @@ int wally_tx_elements_input_issuance_free(
     struct wally_tx_input *input)
 {
     (void) input;
+    if (input && (input->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL;
 #ifdef BUILD_ELEMENTS
     if (input) {
-        input->features &= ~(WALLY_TX_IS_ELEMENTS | WALLY_TX_IS_ISSUANCE);
         wally_clear(input->blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
         wally_clear(input->entropy, WALLY_TX_ASSET_TAG_LEN);
-        clear_and_free(input->issuance_amount, input->issuance_amount_len);
-        clear_and_free(input->inflation_keys, input->inflation_keys_len);
-        clear_and_free(input->issuance_amount_rangeproof, input->issuance_amount_rangeproof_len);
-        clear_and_free(input->inflation_keys_rangeproof, input->inflation_keys_rangeproof_len);
+        clear_public_and_free(input->issuance_amount, input->issuance_amount_len);
+        clear_public_and_free(input->inflation_keys, input->inflation_keys_len);
+        if (!(input->features & WALLY_TX_PROOFS_REFERENCED)) {
+            clear_public_and_free(input->issuance_amount_rangeproof, input->issuance_amount_rangeproof_len);
+            clear_public_and_free(input->inflation_keys_rangeproof, input->inflation_keys_rangeproof_len);
+        }
+        input->features &= ~(WALLY_TX_IS_ELEMENTS | WALLY_TX_IS_ISSUANCE |
+                             WALLY_TX_PROOFS_REFERENCED);
         input->issuance_amount = NULL;
         input->inflation_keys = NULL;
         input->issuance_amount_rangeproof = NULL;
@@ -621,7 +762,7 @@ static int tx_elements_input_init(
     if (ret != WALLY_OK) {
         wally_tx_witness_stack_free(new_witness);
         wally_tx_witness_stack_free(new_pegin_witness);
-        clear_and_free(new_script, script_len);
+        clear_public_and_free(new_script, script_len);
         output->features = old_features;
     } else {
         const bool is_coinbase = is_coinbase_bytes(txhash, WALLY_TXHASH_LEN, index);
@@ -731,7 +872,7 @@ int wally_tx_elements_input_init_alloc(
                                  result, true);
 
     if (ret != WALLY_OK) {
-        clear_and_free(result, sizeof(*result));
+        clear_public_and_free(result, sizeof(*result));
         *output = NULL;
     }
     return ret;
@@ -753,7 +894,7 @@ int wally_tx_input_init_alloc(const unsigned char *txhash, size_t txhash_len,
                               script, script_len, witness, result);
 
     if (ret != WALLY_OK) {
-        clear_and_free(result, sizeof(*result));
+        clear_public_and_free(result, sizeof(*result));
         *output = NULL;
     }
     return ret;
@@ -762,18 +903,20 @@ int wally_tx_input_init_alloc(const unsigned char *txhash, size_t txhash_len,
 static int tx_input_free(struct wally_tx_input *input, bool free_parent)
 {
     if (input) {
-        clear_and_free(input->script, input->script_len);
+        clear_public_and_free(input->script, input->script_len);
         tx_witness_stack_free(input->witness, true);
         wally_tx_elements_input_issuance_free(input);
         wally_clear(input, sizeof(*input));
         if (free_parent)
-            wally_free(input);
+            wally_pool_free(input, sizeof(*input));
     }
     return WALLY_OK;
 }
 
 int wally_tx_input_free(struct wally_tx_input *input)
 {
+    if (input && (input->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL; /* Freed with the read-only clone that holds it */
     return tx_input_free(input, true);
 }
 
@@ -798,18 +941,20 @@ static bool clone_output_to(struct wally_tx_output *dst,
 #else
     if (!clone_bytes(&new_script, src->script, src->script_len)) {
 #endif
-        clear_and_free(new_script, src->script_len);
+        clear_public_and_free(new_script, src->script_len);
 #ifdef BUILD_ELEMENTS
-        clear_and_free(new_asset, src->asset_len);
-        clear_and_free(new_value, src->value_len);
-        clear_and_free(new_nonce, src->nonce_len);
-        clear_and_free(new_surjectionproof,  src->surjectionproof_len);
-        clear_and_free(new_rangeproof, src->rangeproof_len);
+        clear_public_and_free(new_asset, src->asset_len);
+        clear_public_and_free(new_value, src->value_len);
+        clear_public_and_free(new_nonce, src->nonce_len);
+        clear_public_and_free(new_surjectionproof,  src->surjectionproof_len);
+        clear_public_and_free(new_rangeproof, src->rangeproof_len);
 #endif
         return false;
     }
 
     memcpy(dst, src, sizeof(*src));
+    /* The clone owns its proofs, and may be modified */
+    dst->features &= ~(WALLY_TX_PROOFS_REFERENCED | WALLY_TX_READ_ONLY);
     dst->script = new_script;
 #ifdef BUILD_ELEMENTS
     dst->asset = new_asset;
@@ -826,9 +971,11 @@ static int tx_elements_output_proof_init(
     const unsigned char *surjectionproof,
     size_t surjectionproof_len,
     const unsigned char *rangeproof,
-    size_t rangeproof_len)
+    size_t rangeproof_len,
+    bool reference)
 {
     (void) output;
+    (void) reference;
 #ifdef BUILD_ELEMENTS
     unsigned char *new_surjectionproof = NULL, *new_rangeproof = NULL;
 #endif
@@ -838,10 +985,20 @@ static int tx_elements_output_proof_init(
         return WALLY_EINVAL;
 
 #ifdef BUILD_ELEMENTS
+    if (reference) {
+        /* Point into the caller's bytes, which outlive the output */
+        output->surjectionproof = (unsigned char *)surjectionproof;
+        output->surjectionproof_len = surjectionproof_len;
+        output->rangeproof = (unsigned char *)rangeproof;
+        output->rangeproof_len = rangeproof_len;
+        if (surjectionproof || rangeproof)
+            output->features |= WALLY_TX_PROOFS_REFERENCED;
+        return WALLY_OK;
+    }
     if (!clone_bytes(&new_surjectionproof, surjectionproof, surjectionproof_len) ||
         !clone_bytes(&new_rangeproof, rangeproof, rangeproof_len)) {
-        clear_and_free(new_surjectionproof,  surjectionproof_len);
-        clear_and_free(new_rangeproof, rangeproof_len);
+        clear_public_and_free(new_surjectionproof,  surjectionproof_len);
+        clear_public_and_free(new_rangeproof, rangeproof_len);
         return WALLY_ENOMEM;
     }
 
@@ -891,11 +1048,12 @@ static int tx_elements_output_commitment_init(
                                             surjectionproof,
                                             surjectionproof_len,
                                             rangeproof,
-                                            rangeproof_len);
+                                            rangeproof_len,
+                                            false);
     if (ret != WALLY_OK) {
-        clear_and_free(new_asset, asset_len);
-        clear_and_free(new_value, value_len);
-        clear_and_free(new_nonce, nonce_len);
+        clear_public_and_free(new_asset, asset_len);
+        clear_public_and_free(new_value, value_len);
+        clear_public_and_free(new_nonce, nonce_len);
         return ret;
     }
 
@@ -937,19 +1095,27 @@ int wally_tx_elements_output_commitment_set(
     size_t output_surjectionproof_len = output->surjectionproof_len;
     unsigned char *output_rangeproof = output->rangeproof;
     size_t output_rangeproof_len = output->rangeproof_len;
+    const bool referenced = output->features & WALLY_TX_PROOFS_REFERENCED;
 #endif /* BUILD_ELEMENTS */
-    int ret = tx_elements_output_commitment_init(output, asset, asset_len,
+    int ret;
+
+    if (output && (output->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL;
+    ret = tx_elements_output_commitment_init(output, asset, asset_len,
                                                  value, value_len,
                                                  nonce, nonce_len,
                                                  surjectionproof, surjectionproof_len,
                                                  rangeproof, rangeproof_len, true);
     if (ret == WALLY_OK) {
 #ifdef BUILD_ELEMENTS
-        clear_and_free(output_asset, output_asset_len);
-        clear_and_free(output_value, output_value_len);
-        clear_and_free(output_nonce, output_nonce_len);
-        clear_and_free(output_surjectionproof, output_surjectionproof_len);
-        clear_and_free(output_rangeproof, output_rangeproof_len);
+        clear_public_and_free(output_asset, output_asset_len);
+        clear_public_and_free(output_value, output_value_len);
+        clear_public_and_free(output_nonce, output_nonce_len);
+        if (!referenced) {
+            clear_public_and_free(output_surjectionproof, output_surjectionproof_len);
+            clear_public_and_free(output_rangeproof, output_rangeproof_len);
+        }
+        output->features &= ~WALLY_TX_PROOFS_REFERENCED;
 #endif /* BUILD_ELEMENTS */
     }
     return ret;
@@ -959,14 +1125,18 @@ int wally_tx_elements_output_commitment_free(
     struct wally_tx_output *output)
 {
     (void) output;
+    if (output && (output->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL;
 #ifdef BUILD_ELEMENTS
     if (output) {
-        output->features &= ~WALLY_TX_IS_ELEMENTS;
-        clear_and_free(output->asset, output->asset_len);
-        clear_and_free(output->value, output->value_len);
-        clear_and_free(output->nonce, output->nonce_len);
-        clear_and_free(output->surjectionproof, output->surjectionproof_len);
-        clear_and_free(output->rangeproof, output->rangeproof_len);
+        clear_public_and_free(output->asset, output->asset_len);
+        clear_public_and_free(output->value, output->value_len);
+        clear_public_and_free(output->nonce, output->nonce_len);
+        if (!(output->features & WALLY_TX_PROOFS_REFERENCED)) {
+            clear_public_and_free(output->surjectionproof, output->surjectionproof_len);
+            clear_public_and_free(output->rangeproof, output->rangeproof_len);
+        }
+        output->features &= ~(WALLY_TX_IS_ELEMENTS | WALLY_TX_PROOFS_REFERENCED);
     }
 #endif /* BUILD_ELEMENTS */
     return WALLY_OK;
@@ -1008,7 +1178,7 @@ static int tx_elements_output_init(
                                                   rangeproof, rangeproof_len,
                                                   is_elements)) != WALLY_OK) {
         output->features = old_features;
-        clear_and_free(new_script, script_len);
+        clear_public_and_free(new_script, script_len);
         return ret;
     }
 
@@ -1070,7 +1240,7 @@ int wally_tx_elements_output_init_alloc(
                                   rangeproof, rangeproof_len,
                                   result, true);
     if (ret != WALLY_OK) {
-        clear_and_free(result, sizeof(*result));
+        clear_public_and_free(result, sizeof(*result));
         *output = NULL;
     }
     return ret;
@@ -1098,7 +1268,7 @@ int wally_tx_output_init_alloc(uint64_t satoshi,
     ret = wally_tx_output_init(satoshi, script, script_len, result);
 
     if (ret != WALLY_OK) {
-        clear_and_free(result, sizeof(*result));
+        clear_public_and_free(result, sizeof(*result));
         *output = NULL;
     }
     return ret;
@@ -1107,20 +1277,46 @@ int wally_tx_output_init_alloc(uint64_t satoshi,
 static int tx_output_free(struct wally_tx_output *output, bool free_parent)
 {
     if (output) {
-        clear_and_free(output->script, output->script_len);
+        clear_public_and_free(output->script, output->script_len);
         wally_tx_elements_output_commitment_free(output);
         wally_clear(output, sizeof(*output));
         if (free_parent)
-            wally_free(output);
+            wally_pool_free(output, sizeof(*output));
     }
     return WALLY_OK;
 }
 
 int wally_tx_output_free(struct wally_tx_output *output)
 {
+    if (output && (output->features & WALLY_TX_READ_ONLY))
+        return WALLY_EINVAL; /* Freed with the read-only clone that holds it */
     return tx_output_free(output, true);
 }
 
+static size_t tx_witness_length(const struct wally_tx_witness_stack *stack)
+{
+    const size_t num_items = stack ? stack->num_items : 0;
+    size_t i, n = varint_get_length(num_items);
+
+    for (i = 0; i < num_items; ++i)
+        n += varbuff_get_length(stack->items[i].witness_len);
+    return n;
+}
+
+/* Get the serialized length of an inputs witness stack */
+static size_t tx_input_witness_length(const struct wally_tx_input *input)
+{
+    return tx_witness_length(input->witness);
+}
+
+/* Replace the witness of an input, taking ownership of new_witness */
+static void tx_set_input_witness(struct wally_tx_input *input,
+                                 struct wally_tx_witness_stack *new_witness)
+{
+    tx_witness_stack_free(input->witness, true);
+    input->witness = new_witness;
+}
+
 int wally_tx_init_alloc(uint32_t version, uint32_t locktime,
                         size_t inputs_allocation_len,
                         size_t outputs_allocation_len,
@@ -1163,39 +1359,281 @@ static int tx_free(struct wally_tx *tx, bool free_parent)
     if (tx) {
         for (i = 0; i < tx->num_inputs; ++i)
             tx_input_free(&tx->inputs[i], false);
-        clear_and_free(tx->inputs, tx->inputs_allocation_len * sizeof(*tx->inputs));
+        clear_public_and_free(tx->inputs, tx->inputs_allocation_len * sizeof(*tx->inputs));
         for (i = 0; i < tx->num_outputs; ++i)
             tx_output_free(&tx->outputs[i], false);
-        clear_and_free(tx->outputs, tx->outputs_allocation_len * sizeof(*tx->outputs));
+        clear_public_and_free(tx->outputs, tx->outputs_allocation_len * sizeof(*tx->outputs));
         wally_clear(tx, sizeof(*tx));
         if (free_parent)
-            wally_free(tx);
+            wally_pool_free(tx, sizeof(*tx));
     }
     return WALLY_OK;
 }
 
 int wally_tx_free(struct wally_tx *tx)
 {
-    return tx_free(tx, true);
+    struct tx_block *block;
+
+    if (!tx || !is_read_only_tx(tx))
+        return tx_free(tx, true);
+    /* Only the last owner of a read-only clone frees it */
+    block = tx_block_of(tx);
+    if (!wally_atomic_add(&block->refs, (size_t)-1))
+        clear_public_and_free(block, block->len);
+    return WALLY_OK;
 }
 
-int wally_tx_add_input(struct wally_tx *tx, const struct wally_tx_input *input)
+int wally_tx_share(struct wally_tx *tx, struct wally_tx **output)
 {
-    if (!is_valid_tx(tx) || !is_valid_tx_input(input))
+    TX_CHECK_OUTPUT;
+    if (!is_valid_tx(tx) || !is_read_only_tx(tx))
         return WALLY_EINVAL;
+    wally_atomic_add(&tx_block_of(tx)->refs, 1);
+    *output = tx;
+    return WALLY_OK;
+}
 
-    if (tx->num_inputs >= tx->inputs_allocation_len) {
-        /* Expand the inputs array */
-        struct wally_tx_input *p;
-        p = realloc_array(tx->inputs, tx->inputs_allocation_len,
-                          tx->num_inputs + 1, sizeof(*tx->inputs));
-        if (!p)
-            return WALLY_ENOMEM;
+int wally_tx_unshare(struct wally_tx **tx)
+{
+    struct wally_tx *result;
+    int ret;
+
+    if (!tx || !is_valid_tx(*tx))
+        return WALLY_EINVAL;
+    if (!is_read_only_tx(*tx))
+        return WALLY_OK; /* Already modifiable */
+    if ((ret = wally_tx_clone(*tx, 0, &result)) != WALLY_OK)
+        return ret;
+    wally_tx_free(*tx); /* Release our ownership of the original */
+    *tx = result;
+    return WALLY_OK;
+}
+
+int wally_tx_is_shared(const struct wally_tx *tx, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!is_valid_tx(tx) || !written)
+        return WALLY_EINVAL;
+    if (is_read_only_tx(tx))
+        *written = wally_atomic_load(&tx_block_of(tx)->refs) ? 1 : 0;
+    return WALLY_OK;
+}
+
+/* The arena bytes needed to copy a witness stack */
+static size_t witness_arena_len(const struct wally_tx_witness_stack *stack)
+{
+    size_t total, i;
+
+    if (!stack)
+        return 0;
+    total = ARENA_ALIGN_UP(sizeof(*stack)) +
+            ARENA_ALIGN_UP(stack->num_items * sizeof(*stack->items));
+    for (i = 0; i < stack->num_items; ++i)
+        total += ARENA_ALIGN_UP(stack->items[i].witness_len);
+    return total;
+}
+
+/* The arena bytes needed to copy the contents of a transaction, when
+ * tx_arena_clone starts from an aligned offset */
+static size_t tx_clone_arena_len(const struct wally_tx *tx)
+{
+    size_t total, i;
+
+    total = ARENA_ALIGN_UP(tx->num_inputs * sizeof(*tx->inputs)) +
+            ARENA_ALIGN_UP(tx->num_outputs * sizeof(*tx->outputs));
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        total += ARENA_ALIGN_UP(input->script_len) +
+                 witness_arena_len(input->witness);
+#ifdef BUILD_ELEMENTS
+        total += ARENA_ALIGN_UP(input->issuance_amount_len) +
+                 ARENA_ALIGN_UP(input->inflation_keys_len) +
+                 ARENA_ALIGN_UP(input->issuance_amount_rangeproof_len) +
+                 ARENA_ALIGN_UP(input->inflation_keys_rangeproof_len) +
+                 witness_arena_len(input->pegin_witness);
+#endif
+    }
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        total += ARENA_ALIGN_UP(output->script_len);
+#ifdef BUILD_ELEMENTS
+        total += ARENA_ALIGN_UP(output->asset_len) +
+                 ARENA_ALIGN_UP(output->value_len) +
+                 ARENA_ALIGN_UP(output->nonce_len) +
+                 ARENA_ALIGN_UP(output->surjectionproof_len) +
+                 ARENA_ALIGN_UP(output->rangeproof_len);
+#endif
+    }
+    return total;
+}
+
+/* Copy a witness stack into an arena with room for it */
+static struct wally_tx_witness_stack *witness_arena_clone(
+    struct wally_tx_arena *arena, const struct wally_tx_witness_stack *src)
+{
+    struct wally_tx_witness_stack *stack;
+    size_t i;
+
+    if (!src)
+        return NULL;
+    stack = arena_alloc(arena, sizeof(*stack));
+    if (src->num_items)
+        stack->items = arena_alloc(arena, src->num_items * sizeof(*stack->items));
+    stack->num_items = src->num_items;
+    stack->items_allocation_len = TX_READ_ONLY_LEN;
+    for (i = 0; i < src->num_items; ++i) {
+        arena_clone_bytes(arena, &stack->items[i].witness,
+                          src->items[i].witness, src->items[i].witness_len);
+        stack->items[i].witness_len = src->items[i].witness_len;
+    }
+    return stack;
+}
+
+/* Copy the contents of a transaction into result, a zeroed transaction,
+ * from an arena with room for them as sized by tx_clone_arena_len. The
+ * copy and all of its inputs, outputs and witness stacks are read-only */
+static void tx_arena_clone(struct wally_tx_arena *arena,
+                           const struct wally_tx *tx, struct wally_tx *result)
+{
+    size_t i;
+
+    result->version = tx->version;
+    result->locktime = tx->locktime;
+    if (tx->num_inputs)
+        result->inputs = arena_alloc(arena, tx->num_inputs * sizeof(*result->inputs));
+    result->num_inputs = tx->num_inputs;
+    result->inputs_allocation_len = TX_READ_ONLY_LEN;
+    if (tx->num_outputs)
+        result->outputs = arena_alloc(arena, tx->num_outputs * sizeof(*result->outputs));
+    result->num_outputs = tx->num_outputs;
+    result->outputs_allocation_len = TX_READ_ONLY_LEN;
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *src = tx->inputs + i;
+        struct wally_tx_input *dst = result->inputs + i;
+
+        memcpy(dst, src, sizeof(*src));
+        /* The clone owns its proofs, and may not be modified */
+        dst->features &= ~WALLY_TX_PROOFS_REFERENCED;
+        dst->features |= WALLY_TX_READ_ONLY;
+        arena_clone_bytes(arena, &dst->script, src->script, src->script_len);
+        dst->witness = witness_arena_clone(arena, src->witness);
+#ifdef BUILD_ELEMENTS
+        arena_clone_bytes(arena, &dst->issuance_amount, src->issuance_amount,
+                          src->issuance_amount_len);
+        arena_clone_bytes(arena, &dst->inflation_keys, src->inflation_keys,
+                          src->inflation_keys_len);
+        arena_clone_bytes(arena, &dst->issuance_amount_rangeproof,
+                          src->issuance_amount_rangeproof,
+                          src->issuance_amount_rangeproof_len);
+        arena_clone_bytes(arena, &dst->inflation_keys_rangeproof,
+                          src->inflation_keys_rangeproof,
+                          src->inflation_keys_rangeproof_len);
+        dst->pegin_witness = witness_arena_clone(arena, src->pegin_witness);
+#endif
+    }
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *src = tx->outputs + i;
+        struct wally_tx_output *dst = result->outputs + i;
+
+        memcpy(dst, src, sizeof(*src));
+        /* The clone owns its proofs, and may not be modified */
+        dst->features &= ~WALLY_TX_PROOFS_REFERENCED;
+        dst->features |= WALLY_TX_READ_ONLY;
+        arena_clone_bytes(arena, &dst->script, src->script, src->script_len);
+#ifdef BUILD_ELEMENTS
+        arena_clone_bytes(arena, &dst->asset, src->asset, src->asset_len);
+        arena_clone_bytes(arena, &dst->value, src->value, src->value_len);
+        arena_clone_bytes(arena, &dst->nonce, src->nonce, src->nonce_len);
+        arena_clone_bytes(arena, &dst->surjectionproof, src->surjectionproof,
+                          src->surjectionproof_len);
+        arena_clone_bytes(arena, &dst->rangeproof, src->rangeproof, src->rangeproof_len);
+#endif
+    }
+}
+
+/* Clone a transaction into a single read-only allocation, which is freed
+ * as a whole by wally_tx_free */
+static int tx_clone_read_only(const struct wally_tx *tx, struct wally_tx **output)
+{
+    /* Allow for an allocator returning memory that isn't ARENA_ALIGN aligned */
+    const size_t len = sizeof(struct tx_block) + tx_clone_arena_len(tx) + ARENA_ALIGN;
+    struct tx_block *block;
+    struct wally_tx_arena arena;
+
+    if (!(block = wally_malloc(len)))
+        return WALLY_ENOMEM;
+    wally_clear(block, sizeof(*block));
+    block->len = len;
+    wally_tx_arena_init(&arena, (unsigned char *)(block + 1), len - sizeof(*block));
+    tx_arena_clone(&arena, tx, &block->tx);
+    *output = &block->tx;
+    return WALLY_OK;
+}
+
+int wally_tx_clone(const struct wally_tx *tx, uint32_t flags,
+                   struct wally_tx **output)
+{
+    struct wally_tx *result;
+    size_t i;
+    int ret;
+
+    TX_CHECK_OUTPUT;
+
+    if (!is_valid_tx(tx) || (flags & ~WALLY_TX_CLONE_READ_ONLY))
+        return WALLY_EINVAL;
+    if (flags)
+        return tx_clone_read_only(tx, output);
+
+    ret = wally_tx_init_alloc(tx->version, tx->locktime,
+                              tx->num_inputs, tx->num_outputs, output);
+    if (ret != WALLY_OK)
+        return ret;
+    result = *output;
 
-        clear_and_free(tx->inputs, tx->num_inputs * sizeof(*tx->inputs));
-        tx->inputs = p;
-        tx->inputs_allocation_len += 1;
+    for (i = 0; i < tx->num_inputs; ++i) {
+        if (!clone_input_to(result->inputs + i, tx->inputs + i))
+            goto fail;
+        result->num_inputs += 1;
+    }
+    for (i = 0; i < tx->num_outputs; ++i) {
+        if (!clone_output_to(result->outputs + i, tx->outputs + i))
+            goto fail;
+        result->num_outputs += 1;
     }
+    return WALLY_OK;
+
+fail:
+    tx_free(result, true);
+    *output = NULL;
+    return WALLY_ENOMEM;
+}
+
+int wally_tx_reserve(struct wally_tx *tx, size_t num_inputs, size_t num_outputs)
+{
+    if (!is_mutable_tx(tx))
+        return WALLY_EINVAL;
+
+    if (array_reserve((void **)&tx->inputs,
+                      &tx->inputs_allocation_len, num_inputs,
+                      sizeof(*tx->inputs)) != WALLY_OK ||
+        array_reserve((void **)&tx->outputs,
+                      &tx->outputs_allocation_len, num_outputs,
+                      sizeof(*tx->outputs)) != WALLY_OK)
+        return WALLY_ENOMEM;
+    return WALLY_OK;
+}
+
+int wally_tx_add_input(struct wally_tx *tx, const struct wally_tx_input *input)
+{
+    if (!is_mutable_tx(tx) || !is_valid_tx_input(input))
+        return WALLY_EINVAL;
+
+    /* Expand the inputs array */
+    if (array_grow((void **)&tx->inputs, &tx->inputs_allocation_len,
+                   tx->num_inputs + 1, sizeof(*tx->inputs)) != WALLY_OK)
+        return WALLY_ENOMEM;
     if (!clone_input_to(tx->inputs + tx->num_inputs, input))
         return WALLY_ENOMEM;
 
@@ -1343,7 +1781,7 @@ int wally_tx_remove_input(struct wally_tx *tx, size_t index)
 {
     struct wally_tx_input *input;
 
-    if (!is_valid_tx(tx) || index >= tx->num_inputs)
+    if (!is_mutable_tx(tx) || index >= tx->num_inputs)
         return WALLY_EINVAL;
 
     input = tx->inputs + index;
@@ -1357,30 +1795,50 @@ int wally_tx_remove_input(struct wally_tx *tx, size_t index)
     return WALLY_OK;
 }
 
+int wally_tx_remove_inputs(struct wally_tx *tx, const uint32_t *indices,
+                           size_t indices_len)
+{
+    size_t i, j = 0, n = 0;
+
+    if (!is_mutable_tx(tx) || (!indices && indices_len))
+        return WALLY_EINVAL;
+
+    for (i = 0; i < indices_len; ++i)
+        if (indices[i] >= tx->num_inputs || (i && indices[i] <= indices[i - 1]))
+            return WALLY_EINVAL; /* Out of range or not strictly increasing */
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        struct wally_tx_input *input = tx->inputs + i;
+        if (j < indices_len && indices[j] == i) {
+            tx_input_free(input, false);
+            ++j;
+        } else {
+            if (n != i)
+                memcpy(tx->inputs + n, input, sizeof(*input));
+            ++n;
+        }
+    }
+    wally_clear(tx->inputs + n, (tx->num_inputs - n) * sizeof(*tx->inputs));
+    tx->num_inputs = n;
+    return WALLY_OK;
+}
+
 int wally_tx_add_output(struct wally_tx *tx, const struct wally_tx_output *output)
 {
     uint64_t total;
     const bool is_elements = output->features & WALLY_TX_IS_ELEMENTS;
     if (!is_elements) {
-        if (!is_valid_tx(tx) || !is_valid_tx_output(output) ||
+        if (!is_mutable_tx(tx) || !is_valid_tx_output(output) ||
             wally_tx_get_total_output_satoshi(tx, &total) != WALLY_OK ||
             total + output->satoshi < total || total + output->satoshi > WALLY_SATOSHI_MAX)
             return WALLY_EINVAL;
-    } else if (!is_valid_tx(tx) || !is_valid_elements_tx_output(output))
+    } else if (!is_mutable_tx(tx) || !is_valid_elements_tx_output(output))
         return WALLY_EINVAL;
 
-    if (tx->num_outputs >= tx->outputs_allocation_len) {
-        /* Expand the outputs array */
-        struct wally_tx_output *p;
-        p = realloc_array(tx->outputs, tx->outputs_allocation_len,
-                          tx->num_outputs + 1, sizeof(*tx->outputs));
-        if (!p)
-            return WALLY_ENOMEM;
-
-        clear_and_free(tx->outputs, tx->num_outputs * sizeof(*tx->outputs));
-        tx->outputs = p;
-        tx->outputs_allocation_len += 1;
-    }
+    /* Expand the outputs array */
+    if (array_grow((void **)&tx->outputs, &tx->outputs_allocation_len,
+                   tx->num_outputs + 1, sizeof(*tx->outputs)) != WALLY_OK)
+        return WALLY_ENOMEM;
     if (!clone_output_to(tx->outputs + tx->num_outputs, output))
         return WALLY_ENOMEM;
 
@@ -1411,7 +1869,9 @@ static int tx_add_elements_raw_output(
         satoshi, (unsigned char *)script, script_len,
         is_elements ? WALLY_TX_IS_ELEMENTS : 0,
 #ifdef BUILD_ELEMENTS
-        NULL, 0, NULL, 0, NULL, 0, (unsigned char *) surjectionproof, surjectionproof_len,
+        (unsigned char *)asset, asset_len, (unsigned char *)value, value_len,
+        (unsigned char *)nonce, nonce_len,
+        (unsigned char *)surjectionproof, surjectionproof_len,
         (unsigned char *)rangeproof, rangeproof_len,
 #endif /* BUILD_ELEMENTS */
     };
@@ -1473,7 +1933,7 @@ int wally_tx_remove_output(struct wally_tx *tx, size_t index)
 {
     struct wally_tx_output *output;
 
-    if (!is_valid_tx(tx) || index >= tx->num_outputs)
+    if (!is_mutable_tx(tx) || index >= tx->num_outputs)
         return WALLY_EINVAL;
 
     output = tx->outputs + index;
@@ -1487,59 +1947,309 @@ int wally_tx_remove_output(struct wally_tx *tx, size_t index)
     return WALLY_OK;
 }
 
-int wally_tx_get_witness_count(const struct wally_tx *tx, size_t *written)
+int wally_tx_retain_outputs(struct wally_tx *tx, const unsigned char *mask,
+                            size_t mask_len)
 {
-    size_t i;
-
-    if (written)
-        *written = 0;
+    size_t i, n = 0;
 
-    if (!is_valid_tx(tx) || !written)
+    if (!is_mutable_tx(tx) || BYTES_INVALID(mask, mask_len) ||
+        mask_len != tx->num_outputs)
         return WALLY_EINVAL;
 
-    for (i = 0; i < tx->num_inputs; ++i) {
-        if (tx->inputs[i].witness)
-            *written += 1;
-#ifdef BUILD_ELEMENTS
-        /* TODO: check the count in the presence of a mix of NULL and non-NULL witnesses */
-        if (tx->inputs[i].issuance_amount_rangeproof_len)
-            *written += 1;
-        if (tx->inputs[i].inflation_keys_rangeproof_len)
-            *written += 1;
-        if (tx->inputs[i].pegin_witness)
-            *written += 1;
-#endif
-    }
-
-#ifdef BUILD_ELEMENTS
-    /* TODO: check the count in the presence of a mix of NULL and non-NULL witnesses */
     for (i = 0; i < tx->num_outputs; ++i) {
-        if (tx->outputs[i].surjectionproof_len)
-            *written += 1;
-        if (tx->outputs[i].rangeproof_len)
-            *written += 1;
+        struct wally_tx_output *output = tx->outputs + i;
+        if (!mask[i]) {
+            tx_output_free(output, false);
+        } else {
+            if (n != i)
+                memcpy(tx->outputs + n, output, sizeof(*output));
+            ++n;
+        }
     }
-#endif
-
+    wally_clear(tx->outputs + n, (tx->num_outputs - n) * sizeof(*tx->outputs));
+    tx->num_outputs = n;
     return WALLY_OK;
 }
 
-/* We compute the size of the witness separately so we can compute vsize
- * without iterating the transaction twice with different flags.
- */
-static int tx_get_lengths(const struct wally_tx *tx,
-                          const struct tx_serialize_opts *opts, uint32_t flags,
-                          size_t *base_size, size_t *witness_size,
-                          size_t *witness_count, bool is_elements)
-{
-    size_t n, i, j;
-    const bool anyonecanpay = opts && opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
-    const bool sh_none = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
-    const bool sh_single = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+/* A table of the inputs or outputs of a transaction, keyed by outpoint for
+ * inputs or by script for outputs. An entry's item is the index of its
+ * input or output plus 1 */
+struct tx_index_table {
+    struct hash_table table;
+    size_t num_indexed; /* The number of inputs or outputs indexed */
+};
 
-    *witness_count = 0;
+struct wally_tx_index {
+    struct tx_index_table inputs;
+    struct tx_index_table outputs;
+};
 
-    if (opts) {
+/* The key of an input is its outpoint: its txhash and index. The key of an
+ * output is its script and script length */
+struct tx_index_key {
+    const struct wally_tx *tx;
+    bool outputs;
+    const unsigned char *bytes;
+    size_t n;
+};
+
+/* Hash the key of an input or output. Outpoints and scripts both come
+ * from untrusted transactions, so the hash is keyed per table */
+static uint64_t tx_index_hash(const struct hash_table *table,
+                              const struct tx_index_key *key)
+{
+    unsigned char buff[WALLY_TXHASH_LEN + sizeof(uint32_t)];
+    uint32_t utxo_index = (uint32_t)key->n;
+
+    if (key->outputs)
+        return hash_table_hash(table, key->bytes, key->n);
+    memcpy(buff, key->bytes, WALLY_TXHASH_LEN);
+    memcpy(buff + WALLY_TXHASH_LEN, &utxo_index, sizeof(utxo_index));
+    return hash_table_hash(table, buff, sizeof(buff));
+}
+
+/* Compare an input or output with a key. Items are checked against the
+ * current tx, so entries for removed or changed items never match */
+static bool tx_index_matches(const struct tx_index_key *key, size_t i)
+{
+    const struct wally_tx *tx = key->tx;
+
+    if (key->outputs) {
+        const struct wally_tx_output *output;
+        if (i >= tx->num_outputs)
+            return false;
+        output = tx->outputs + i;
+        return output->script_len == key->n &&
+               (!key->n || !memcmp(output->script, key->bytes, key->n));
+    }
+    return i < tx->num_inputs && tx->inputs[i].index == key->n &&
+           !memcmp(tx->inputs[i].txhash, key->bytes, WALLY_TXHASH_LEN);
+}
+
+static bool tx_index_entry_matches(const void *ctx, const struct hash_table_entry *entry,
+                                   const void *key)
+{
+    (void)ctx;
+    return tx_index_matches(key, entry->item - 1);
+}
+
+/* Index the inputs or outputs of tx. Items appended since the table was
+ * last updated are inserted; if any were removed it is rebuilt */
+static int tx_index_update(const struct wally_tx *tx, struct tx_index_table *index,
+                           bool outputs)
+{
+    const size_t num_items = outputs ? tx->num_outputs : tx->num_inputs;
+    size_t i;
+    int ret;
+
+    if (num_items < index->num_indexed) {
+        hash_table_clear(&index->table); /* Items were removed: rebuild */
+        index->num_indexed = 0;
+    }
+    if ((ret = hash_table_reserve(&index->table, num_items - index->num_indexed)) != WALLY_OK)
+        return ret;
+    for (i = index->num_indexed; i < num_items; ++i) {
+        struct tx_index_key key;
+        struct hash_table_entry *entry;
+        uint64_t hash;
+
+        key.tx = tx;
+        key.outputs = outputs;
+        key.bytes = outputs ? tx->outputs[i].script : tx->inputs[i].txhash;
+        key.n = outputs ? tx->outputs[i].script_len : tx->inputs[i].index;
+        hash = tx_index_hash(&index->table, &key);
+        entry = hash_table_find(&index->table, hash, tx_index_entry_matches, NULL, &key);
+        if (!entry->item)
+            hash_table_insert(&index->table, entry, hash, i + 1, 0);
+        /* Otherwise a lower index has the same key */
+    }
+    index->num_indexed = num_items;
+    return WALLY_OK;
+}
+
+int wally_tx_index_init_alloc(const struct wally_tx *tx, uint32_t flags,
+                              struct wally_tx_index **output)
+{
+    struct wally_tx_index *result;
+    int ret;
+
+    TX_CHECK_OUTPUT;
+    if (!is_valid_tx(tx) || flags)
+        return WALLY_EINVAL;
+
+    if (!(result = wally_malloc(sizeof(*result))))
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    hash_table_init(&result->inputs.table);
+    hash_table_init(&result->outputs.table);
+    ret = wally_tx_index_update(result, tx);
+    if (ret != WALLY_OK)
+        wally_tx_index_free(result);
+    else
+        *output = result;
+    return ret;
+}
+
+int wally_tx_index_update(struct wally_tx_index *index, const struct wally_tx *tx)
+{
+    int ret;
+
+    if (!index || !is_valid_tx(tx))
+        return WALLY_EINVAL;
+    ret = tx_index_update(tx, &index->inputs, false);
+    if (ret == WALLY_OK)
+        ret = tx_index_update(tx, &index->outputs, true);
+    return ret;
+}
+
+int wally_tx_index_free(struct wally_tx_index *index)
+{
+    if (index) {
+        hash_table_free(&index->inputs.table);
+        hash_table_free(&index->outputs.table);
+        clear_and_free(index, sizeof(*index));
+    }
+    return WALLY_OK;
+}
+
+/* Find the first input or output of tx with a given key */
+static int tx_index_lookup(const struct wally_tx *tx, const struct wally_tx_index *index,
+                           bool outputs, const unsigned char *bytes, size_t n,
+                           size_t *written)
+{
+    const struct tx_index_key key = { tx, outputs, bytes, n };
+    const size_t num_items = outputs ? tx->num_outputs : tx->num_inputs;
+    size_t i;
+
+    *written = num_items;
+    if (index) {
+        const struct hash_table *table = outputs ? &index->outputs.table : &index->inputs.table;
+        const struct hash_table_entry *entry;
+
+        entry = hash_table_lookup(table, tx_index_hash(table, &key),
+                                  tx_index_entry_matches, NULL, &key);
+        if (entry)
+            *written = entry->item - 1;
+        return WALLY_OK;
+    }
+
+    for (i = 0; i < num_items; ++i) {
+        if (tx_index_matches(&key, i)) {
+            *written = i;
+            break;
+        }
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_find_input_by_outpoint(const struct wally_tx *tx,
+                                    const struct wally_tx_index *index,
+                                    const unsigned char *txhash, size_t txhash_len,
+                                    uint32_t utxo_index, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!is_valid_tx(tx) || !txhash || txhash_len != WALLY_TXHASH_LEN || !written)
+        return WALLY_EINVAL;
+    return tx_index_lookup(tx, index, false, txhash, utxo_index, written);
+}
+
+int wally_tx_find_output_by_script(const struct wally_tx *tx,
+                                   const struct wally_tx_index *index,
+                                   const unsigned char *script, size_t script_len,
+                                   size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!is_valid_tx(tx) || BYTES_INVALID(script, script_len) || !written)
+        return WALLY_EINVAL;
+    return tx_index_lookup(tx, index, true, script, script_len, written);
+}
+
+int wally_tx_get_witness_count(const struct wally_tx *tx, size_t *written)
+{
+    size_t i;
+
+    if (written)
+        *written = 0;
+
+    if (!is_valid_tx(tx) || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        if (tx->inputs[i].witness)
+            *written += 1;
+#ifdef BUILD_ELEMENTS
+        /* TODO: check the count in the presence of a mix of NULL and non-NULL witnesses */
+        if (tx->inputs[i].issuance_amount_rangeproof_len)
+            *written += 1;
+        if (tx->inputs[i].inflation_keys_rangeproof_len)
+            *written += 1;
+        if (tx->inputs[i].pegin_witness)
+            *written += 1;
+#endif
+    }
+
+#ifdef BUILD_ELEMENTS
+    /* TODO: check the count in the presence of a mix of NULL and non-NULL witnesses */
+    for (i = 0; i < tx->num_outputs; ++i) {
+        if (tx->outputs[i].surjectionproof_len)
+            *written += 1;
+        if (tx->outputs[i].rangeproof_len)
+            *written += 1;
+    }
+#endif
+
+    return WALLY_OK;
+}
+
+/* We compute the size of the witness separately so we can compute vsize
+ * without iterating the transaction twice with different flags.
+ */
+#ifdef BUILD_ELEMENTS
+/* The length of the witness of an elements transaction, which is
+ * serialized whenever any input or output has witness data */
+static size_t tx_elements_witness_length(const struct wally_tx *tx)
+{
+    size_t n = 0, i;
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        size_t num_items, j;
+        n += varbuff_get_length(input->issuance_amount_rangeproof_len);
+        n += varbuff_get_length(input->inflation_keys_rangeproof_len);
+        n += tx_input_witness_length(input);
+        num_items = input->pegin_witness ? input->pegin_witness->num_items : 0;
+        n += varint_get_length(num_items);
+        for (j = 0; j < num_items; ++j) {
+            const struct wally_tx_witness_item *stack;
+            stack = input->pegin_witness->items + j;
+            n += varbuff_get_length(stack->witness_len);
+        }
+    }
+
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        n += varbuff_get_length(output->surjectionproof_len);
+        n += varbuff_get_length(output->rangeproof_len);
+    }
+    return n;
+}
+#endif /* BUILD_ELEMENTS */
+
+static int tx_get_lengths(const struct wally_tx *tx,
+                          const struct tx_serialize_opts *opts, uint32_t flags,
+                          size_t *base_size, size_t *witness_size,
+                          size_t *witness_count, bool is_elements)
+{
+    size_t n, i;
+    const bool anyonecanpay = opts && opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
+    const bool sh_none = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
+    const bool sh_single = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+
+    *witness_count = 0;
+
+    if (opts) {
         if (flags & WALLY_TX_FLAG_USE_WITNESS)
             return WALLY_ERROR; /* Segwit tx hashing uses bip143 opts member */
 
@@ -1637,46 +2347,13 @@ static int tx_get_lengths(const struct wally_tx *tx,
     if (flags & WALLY_TX_FLAG_USE_WITNESS) {
         if (is_elements) {
 #ifdef BUILD_ELEMENTS
-            for (i = 0; i < tx->num_inputs; ++i) {
-                const struct wally_tx_input *input = tx->inputs + i;
-                size_t num_items;
-                n += varbuff_get_length(input->issuance_amount_rangeproof_len);
-                n += varbuff_get_length(input->inflation_keys_rangeproof_len);
-                num_items = input->witness ? input->witness->num_items : 0;
-                n += varint_get_length(num_items);
-                for (j = 0; j < num_items; ++j) {
-                    const struct wally_tx_witness_item *stack;
-                    stack = input->witness->items + j;
-                    n += varbuff_get_length(stack->witness_len);
-                }
-                num_items = input->pegin_witness ? input->pegin_witness->num_items : 0;
-                n += varint_get_length(num_items);
-                for (j = 0; j < num_items; ++j) {
-                    const struct wally_tx_witness_item *stack;
-                    stack = input->pegin_witness->items + j;
-                    n += varbuff_get_length(stack->witness_len);
-                }
-            }
-
-            for (i = 0; i < tx->num_outputs; ++i) {
-                const struct wally_tx_output *output = tx->outputs + i;
-                n += varbuff_get_length(output->surjectionproof_len);
-                n += varbuff_get_length(output->rangeproof_len);
-            }
-#endif /* BUILD_ELEMENTS */
+            n = tx_elements_witness_length(tx);
+#endif
         } else {
             n = 2; /* For marker and flag bytes 0x00 0x01 */
 
-            for (i = 0; i < tx->num_inputs; ++i) {
-                const struct wally_tx_input *input = tx->inputs + i;
-                size_t num_items = input->witness ? input->witness->num_items : 0;
-                n += varint_get_length(num_items);
-                for (j = 0; j < num_items; ++j) {
-                    const struct wally_tx_witness_item *stack;
-                    stack = input->witness->items + j;
-                    n += varbuff_get_length(stack->witness_len);
-                }
-            }
+            for (i = 0; i < tx->num_inputs; ++i)
+                n += tx_input_witness_length(tx->inputs + i);
         }
     }
 
@@ -1758,214 +2435,626 @@ int wally_tx_get_vsize(const struct wally_tx *tx, size_t *written)
     return ret;
 }
 
-static inline int tx_to_bip143_bytes(const struct wally_tx *tx,
-                                     const struct tx_serialize_opts *opts,
-                                     uint32_t flags,
-                                     unsigned char *bytes_out, size_t len,
-                                     size_t *written)
+int wally_tx_input_get_weight_estimate(uint32_t script_type, uint32_t threshold,
+                                       uint32_t num_keys, uint32_t flags,
+                                       size_t *written)
 {
-    unsigned char buff[TX_STACK_SIZE / 2], *buff_p = buff;
-    size_t i, inputs_size, outputs_size, issuances_size = 0, buff_len = sizeof(buff);
-    size_t is_elements = 0;
-    const bool anyonecanpay = opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
-    const bool sh_none = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
-    const bool sh_single = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
-    unsigned char *p = bytes_out, *output_p;
-    int ret = WALLY_OK;
+    /* Signatures are pushed with their length, as are compressed pubkeys */
+    const size_t sig_len = 1 + (flags == WALLY_TX_DUMMY_SIG_LOW_R ?
+                                sizeof(DUMMY_SIG) - 1 : sizeof(DUMMY_SIG));
+    const size_t pubkey_len = 1 + EC_PUBLIC_KEY_LEN;
+    size_t script_len = 0, witness_len = 0, redeem_len = 0, sigs_len = 0;
 
-    (void)flags;
-    (void)len;
+    if (written)
+        *written = 0;
 
-#ifdef BUILD_ELEMENTS
-    if ((ret = wally_tx_is_elements(tx, &is_elements)) != WALLY_OK)
-        return ret;
-#endif
+    if ((flags != WALLY_TX_DUMMY_SIG && flags != WALLY_TX_DUMMY_SIG_LOW_R) || !written)
+        return WALLY_EINVAL;
 
-    /* Note we assume tx_to_bytes has already validated all inputs */
-    p += uint32_to_le_bytes(tx->version, p);
+    if (script_type & WALLY_SCRIPT_TYPE_MULTISIG) {
+        if (threshold < 1 || threshold > num_keys || num_keys > 16)
+            return WALLY_EINVAL;
+        redeem_len = 3 + num_keys * pubkey_len;
+        sigs_len = threshold * sig_len;
+    } else if (threshold || num_keys)
+        return WALLY_EINVAL;
 
-    inputs_size = tx->num_inputs * (WALLY_TXHASH_LEN + sizeof(uint32_t));
-    if (sh_none || (sh_single && opts->index >= tx->num_outputs))
-        outputs_size = 0;
-    else if (sh_single) {
-        if (!is_elements)
-            outputs_size = sizeof(uint64_t) +
-                           varbuff_get_length(tx->outputs[opts->index].script_len);
-#ifdef BUILD_ELEMENTS
-        else
-            outputs_size = confidential_asset_length_from_bytes(tx->outputs[opts->index].asset) +
-                           confidential_value_length_from_bytes(tx->outputs[opts->index].value) +
-                           confidential_nonce_length_from_bytes(tx->outputs[opts->index].nonce) +
-                           varbuff_get_length(tx->outputs[opts->index].script_len);
-#else
-        else
+    switch (script_type) {
+    case WALLY_SCRIPT_TYPE_P2PKH:
+        script_len = sig_len + pubkey_len;
+        break;
+    case WALLY_SCRIPT_TYPE_P2SH | WALLY_SCRIPT_TYPE_P2WPKH:
+        script_len = 1 + WALLY_SCRIPTPUBKEY_P2WPKH_LEN;
+        /* Fall through */
+    case WALLY_SCRIPT_TYPE_P2WPKH:
+        witness_len = varint_get_length(2) + sig_len + pubkey_len;
+        break;
+    case WALLY_SCRIPT_TYPE_MULTISIG:
+        script_len = 1 + sigs_len; /* OP_0 for the CHECKMULTISIG bug */
+        break;
+    case WALLY_SCRIPT_TYPE_P2SH | WALLY_SCRIPT_TYPE_MULTISIG:
+        if (redeem_len > MAX_SCRIPT_ELEMENT_SIZE)
             return WALLY_EINVAL;
-#endif
-    } else {
-        outputs_size = 0;
-        for (i = 0; i < tx->num_outputs; ++i) {
-            if (!is_elements)
-                outputs_size += sizeof(uint64_t);
-#ifdef BUILD_ELEMENTS
-            else
-                outputs_size += confidential_asset_length_from_bytes(tx->outputs[i].asset) +
-                                confidential_value_length_from_bytes(tx->outputs[i].value) +
-                                confidential_nonce_length_from_bytes(tx->outputs[i].nonce);
-#else
-            else
-                return WALLY_EINVAL;
-#endif
-            outputs_size += varbuff_get_length(tx->outputs[i].script_len);
-        }
+        script_len = 1 + sigs_len + (redeem_len < OP_PUSHDATA1 ? 1 :
+                                     redeem_len <= 0xff ? 2 : 3) + redeem_len;
+        break;
+    case WALLY_SCRIPT_TYPE_P2SH | WALLY_SCRIPT_TYPE_P2WSH | WALLY_SCRIPT_TYPE_MULTISIG:
+        script_len = 1 + WALLY_SCRIPTPUBKEY_P2WSH_LEN;
+        /* Fall through */
+    case WALLY_SCRIPT_TYPE_P2WSH | WALLY_SCRIPT_TYPE_MULTISIG:
+        /* An empty item for the CHECKMULTISIG bug, the sigs and the script */
+        witness_len = varint_get_length(threshold + 2) + 1 + sigs_len +
+                      varbuff_get_length(redeem_len);
+        break;
+    default:
+        return WALLY_EINVAL;
     }
 
+    *written = (WALLY_TXHASH_LEN + sizeof(uint32_t) + /* outpoint */
+                varbuff_get_length(script_len) +
+                sizeof(uint32_t)) * 4 + witness_len; /* sequence */
+    return WALLY_OK;
+}
+
+int wally_tx_get_weight_estimate(const struct wally_tx *tx, size_t num_inputs,
+                                 size_t num_witness_inputs, size_t input_weight,
+                                 size_t *written)
+{
+    size_t base_size, witness_size, witness_count;
+    size_t is_elements = 0;
+
+    if (written)
+        *written = 0;
+
 #ifdef BUILD_ELEMENTS
-    if (is_elements && !anyonecanpay) {
-        for (i = 0; i < tx->num_inputs; ++i) {
-            if (tx->inputs[i].features & WALLY_TX_IS_ISSUANCE)
-                issuances_size +=
-                    2 * WALLY_TX_ASSET_TAG_LEN +
-                    confidential_value_length_from_bytes(tx->inputs[i].issuance_amount) +
-                    confidential_value_length_from_bytes(tx->inputs[i].inflation_keys);
-            else
-                issuances_size += 1;
-        }
-    }
+    if (wally_tx_is_elements(tx, &is_elements) != WALLY_OK)
+        return WALLY_EINVAL;
 #endif
 
-    if (inputs_size > buff_len || outputs_size > buff_len || issuances_size > buff_len) {
-        buff_len = inputs_size > outputs_size ? inputs_size : outputs_size;
-        buff_len = buff_len > issuances_size ? buff_len : issuances_size;
-        buff_p = wally_malloc(buff_len);
-        if (buff_p == NULL)
-            return WALLY_ENOMEM;
+    if (!is_valid_tx(tx) || is_elements || num_witness_inputs > num_inputs || !written ||
+        tx_get_lengths(tx, NULL, WALLY_TX_FLAG_USE_WITNESS, &base_size,
+                       &witness_size, &witness_count, false) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    base_size += varint_get_length(tx->num_inputs + num_inputs) -
+                 varint_get_length(tx->num_inputs);
+    *written = base_size * 4 + input_weight;
+    if (witness_count || num_witness_inputs) {
+        /* Inputs without a witness serialize an empty witness stack */
+        if (!witness_count)
+            witness_size = 2 + tx->num_inputs; /* Add 2 for the marker and flag */
+        *written += witness_size + num_inputs - num_witness_inputs;
     }
+    return WALLY_OK;
+}
 
-    /* Inputs */
-    if (anyonecanpay)
-        memset(p, 0, SHA256_LEN);
-    else {
-        for (i = 0; i < tx->num_inputs; ++i) {
-            unsigned char *tmp_p = buff_p + i * (WALLY_TXHASH_LEN + sizeof(uint32_t));
-            memcpy(tmp_p, tx->inputs[i].txhash, WALLY_TXHASH_LEN);
-            uint32_to_le_bytes(tx->inputs[i].index, tmp_p + WALLY_TXHASH_LEN);
-        }
+int wally_tx_get_blinded_weight_estimate(const struct wally_tx *tx,
+                                         const uint32_t *indices, size_t indices_len,
+                                         const uint64_t *values, size_t values_len,
+                                         size_t num_inputs, size_t *written)
+{
+#ifdef BUILD_ELEMENTS
+    size_t base_size, witness_size, witness_count, surjectionproof_len, i, j;
+    size_t is_elements = 0;
 
-        if ((ret = wally_sha256d(buff_p, inputs_size, p, SHA256_LEN)) != WALLY_OK)
-            goto error;
-    }
-    p += SHA256_LEN;
+    if (written)
+        *written = 0;
 
-    /* Sequences */
-    if (anyonecanpay || sh_single || sh_none)
-        memset(p, 0, SHA256_LEN);
-    else {
-        for (i = 0; i < tx->num_inputs; ++i)
-            uint32_to_le_bytes(tx->inputs[i].sequence, buff_p + i * sizeof(uint32_t));
+    if (!is_valid_tx(tx) || !indices || !indices_len || !num_inputs ||
+        !values || values_len != num_inputs + indices_len || !written ||
+        wally_tx_is_elements(tx, &is_elements) != WALLY_OK || !is_elements ||
+        wally_asset_surjectionproof_size(num_inputs, &surjectionproof_len) != WALLY_OK ||
+        tx_get_lengths(tx, NULL, 0, &base_size, &witness_size,
+                       &witness_count, true) != WALLY_OK)
+        return WALLY_EINVAL;
 
-        ret = wally_sha256d(buff_p, tx->num_inputs * sizeof(uint32_t), p, SHA256_LEN);
-        if (ret != WALLY_OK)
-            goto error;
-    }
-    p += SHA256_LEN;
+    /* Blinded outputs always have proofs, so the witness is serialized */
+    witness_size = tx_elements_witness_length(tx);
 
-#ifdef BUILD_ELEMENTS
-    if (is_elements) {
-        /* Issuance */
-        if (anyonecanpay)
-            memset(p, 0, SHA256_LEN);
-        else {
-            unsigned char *tmp_p = buff_p;
-            for (i = 0; i < tx->num_inputs; ++i) {
-                if (tx->inputs[i].features & WALLY_TX_IS_ISSUANCE) {
-                    memcpy(tmp_p, tx->inputs[i].blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
-                    tmp_p += WALLY_TX_ASSET_TAG_LEN;
-                    memcpy(tmp_p, tx->inputs[i].entropy, WALLY_TX_ASSET_TAG_LEN);
-                    tmp_p += WALLY_TX_ASSET_TAG_LEN;
-                    tmp_p += confidential_value_to_bytes(tx->inputs[i].issuance_amount,
-                                                         tx->inputs[i].issuance_amount_len, tmp_p);
-                    tmp_p += confidential_value_to_bytes(tx->inputs[i].inflation_keys,
-                                                         tx->inputs[i].inflation_keys_len, tmp_p);
-                }
-                else
-                    *tmp_p++ = 0;
-            }
+    for (i = 0; i < indices_len; ++i) {
+        const struct wally_tx_output *output;
+        const uint64_t value = values[num_inputs + i];
+        size_t rangeproof_len;
 
-            if ((ret = wally_sha256d(buff_p, issuances_size, p, SHA256_LEN)) != WALLY_OK)
-                goto error;
-        }
-        p += SHA256_LEN;
+        if (indices[i] >= tx->num_outputs ||
+            !(tx->outputs[indices[i]].features & WALLY_TX_IS_ELEMENTS) ||
+            wally_asset_rangeproof_size(value, value ? 1 : 0, ASSET_RANGEPROOF_EXP,
+                                        ASSET_RANGEPROOF_MIN_BITS,
+                                        &rangeproof_len) != WALLY_OK)
+            return WALLY_EINVAL;
+        for (j = 0; j < i; ++j)
+            if (indices[j] == indices[i])
+                return WALLY_EINVAL; /* Each output can only be blinded once */
+
+        /* Replace the output's commitments and proofs with blinded ones */
+        output = tx->outputs + indices[i];
+        base_size += ASSET_GENERATOR_LEN + ASSET_COMMITMENT_LEN + EC_PUBLIC_KEY_LEN;
+        base_size -= confidential_asset_length_from_bytes(output->asset) +
+                     confidential_value_length_from_bytes(output->value) +
+                     confidential_nonce_length_from_bytes(output->nonce);
+        witness_size += varbuff_get_length(surjectionproof_len) +
+                        varbuff_get_length(rangeproof_len);
+        witness_size -= varbuff_get_length(output->surjectionproof_len) +
+                        varbuff_get_length(output->rangeproof_len);
     }
+    *written = base_size * 4 + witness_size;
+    return WALLY_OK;
+#else
+    (void)tx;
+    (void)indices;
+    (void)indices_len;
+    (void)values;
+    (void)values_len;
+    (void)num_inputs;
+    if (written)
+        *written = 0;
+    return WALLY_ERROR;
 #endif /* BUILD_ELEMENTS */
+}
 
-    /* Input details */
-    memcpy(p, tx->inputs[opts->index].txhash, WALLY_TXHASH_LEN);
-    p += WALLY_TXHASH_LEN;
-    p += uint32_to_le_bytes(tx->inputs[opts->index].index, p);
-    p += varbuff_to_bytes(opts->script, opts->script_len, p);
-    if (!is_elements)
-        p += uint64_to_le_bytes(opts->satoshi, p);
-#ifdef BUILD_ELEMENTS
-    else
-        p += confidential_value_to_bytes(opts->value, opts->value_len, p);
-#endif
-    p += uint32_to_le_bytes(tx->inputs[opts->index].sequence, p);
+/* Finish a double SHA256 started with sha256_init() */
+static void sha256d_done(struct sha256_ctx *ctx, unsigned char *bytes_out)
+{
+    struct sha256 sha;
 
-#ifdef BUILD_ELEMENTS
-    if (is_elements && (tx->inputs[opts->index].features & WALLY_TX_IS_ISSUANCE)) {
-        memcpy(p, tx->inputs[opts->index].blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
-        p += WALLY_TX_ASSET_TAG_LEN;
-        memcpy(p, tx->inputs[opts->index].entropy, WALLY_TX_ASSET_TAG_LEN);
-        p += WALLY_TX_ASSET_TAG_LEN;
-        p += confidential_value_to_bytes(tx->inputs[opts->index].issuance_amount,
-                                         tx->inputs[opts->index].issuance_amount_len, p);
-        p += confidential_value_to_bytes(tx->inputs[opts->index].inflation_keys,
-                                         tx->inputs[opts->index].inflation_keys_len, p);
-    }
-#endif
+    sha256_done(ctx, &sha);
+    wally_sha256(sha.u.u8, sizeof(sha), bytes_out, SHA256_LEN);
+    wally_clear(&sha, sizeof(sha));
+}
 
-    /* Outputs */
+static void sha256_varint(struct sha256_ctx *ctx, uint64_t v)
+{
+    unsigned char buff[sizeof(uint8_t) + sizeof(uint64_t)];
+
+    sha256_update(ctx, buff, varint_to_bytes(v, buff));
+}
+
+static void sha256_varbuff(struct sha256_ctx *ctx,
+                           const unsigned char *bytes, size_t bytes_len)
+{
+    sha256_varint(ctx, bytes_len);
+    if (bytes_len)
+        sha256_update(ctx, bytes, bytes_len);
+}
+
+#ifdef BUILD_ELEMENTS
+static void sha256_confidential_value(struct sha256_ctx *ctx,
+                                      const unsigned char *bytes, size_t bytes_len)
+{
+    if (!bytes_len)
+        sha256_u8(ctx, 0);
+    else
+        sha256_update(ctx, bytes, bytes_len);
+}
+#endif
+
+/* BIP 143 hashPrevouts */
+static void tx_hash_prevouts(const struct wally_tx *tx, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = 0; i < tx->num_inputs; ++i) {
+        sha256_update(&ctx, tx->inputs[i].txhash, WALLY_TXHASH_LEN);
+        sha256_le32(&ctx, tx->inputs[i].index);
+    }
+    sha256d_done(&ctx, bytes_out);
+}
+
+/* BIP 143 hashSequence */
+static void tx_hash_sequences(const struct wally_tx *tx, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = 0; i < tx->num_inputs; ++i)
+        sha256_le32(&ctx, tx->inputs[i].sequence);
+    sha256d_done(&ctx, bytes_out);
+}
+
+#ifdef BUILD_ELEMENTS
+/* Elements hashIssuance */
+static void tx_hash_issuances(const struct wally_tx *tx, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        if (input->features & WALLY_TX_IS_ISSUANCE) {
+            sha256_update(&ctx, input->blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
+            sha256_update(&ctx, input->entropy, WALLY_TX_ASSET_TAG_LEN);
+            sha256_confidential_value(&ctx, input->issuance_amount,
+                                      input->issuance_amount_len);
+            sha256_confidential_value(&ctx, input->inflation_keys,
+                                      input->inflation_keys_len);
+        } else
+            sha256_u8(&ctx, 0);
+    }
+    sha256d_done(&ctx, bytes_out);
+}
+#endif /* BUILD_ELEMENTS */
+
+/* BIP 143 hashOutputs over the outputs from 'start' up to 'end' */
+static void tx_hash_outputs(const struct wally_tx *tx, size_t start, size_t end,
+                            bool is_elements, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = start; i < end; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        if (!is_elements)
+            sha256_le64(&ctx, output->satoshi);
+#ifdef BUILD_ELEMENTS
+        else {
+            sha256_confidential_value(&ctx, output->asset, output->asset_len);
+            sha256_confidential_value(&ctx, output->value, output->value_len);
+            sha256_confidential_value(&ctx, output->nonce, output->nonce_len);
+        }
+#endif
+        sha256_varbuff(&ctx, output->script, output->script_len);
+    }
+    sha256d_done(&ctx, bytes_out);
+}
+
+static void tx_sighash_ctx_init(const struct wally_tx *tx, bool is_elements,
+                                struct wally_tx_sighash_ctx *ctx)
+{
+    tx_hash_prevouts(tx, ctx->hash_prevouts);
+    tx_hash_sequences(tx, ctx->hash_sequence);
+    tx_hash_outputs(tx, 0, tx->num_outputs, is_elements, ctx->hash_outputs);
+#ifdef BUILD_ELEMENTS
+    if (is_elements)
+        tx_hash_issuances(tx, ctx->hash_issuances);
+    else
+        wally_clear(ctx->hash_issuances, sizeof(ctx->hash_issuances));
+#endif
+    ctx->num_inputs = tx->num_inputs;
+    ctx->num_outputs = tx->num_outputs;
+    ctx->is_elements = is_elements;
+}
+
+/* Hash the BIP143 signature hash preimage for the input being signed.
+ * Streaming the preimage means signing never needs a buffer sized to
+ * the script being signed.
+ */
+static void tx_bip143_to_sha256(const struct wally_tx *tx,
+                                const struct tx_serialize_opts *opts,
+                                struct sha256_ctx *sha_ctx, bool is_elements)
+{
+    const struct wally_tx_sighash_ctx *ctx = opts->ctx;
+    const struct wally_tx_input *input = tx->inputs + opts->index;
+    const bool anyonecanpay = opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
+    const bool sh_none = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
+    const bool sh_single = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+    unsigned char buff[SHA256_LEN];
+
+    /* Note we assume tx_get_length has already validated all inputs */
+    sha256_le32(sha_ctx, tx->version);
+
+    /* Inputs */
+    if (anyonecanpay)
+        memset(buff, 0, SHA256_LEN);
+    else if (ctx)
+        memcpy(buff, ctx->hash_prevouts, SHA256_LEN);
+    else
+        tx_hash_prevouts(tx, buff);
+    sha256_update(sha_ctx, buff, SHA256_LEN);
+
+    /* Sequences */
+    if (anyonecanpay || sh_single || sh_none)
+        memset(buff, 0, SHA256_LEN);
+    else if (ctx)
+        memcpy(buff, ctx->hash_sequence, SHA256_LEN);
+    else
+        tx_hash_sequences(tx, buff);
+    sha256_update(sha_ctx, buff, SHA256_LEN);
+
+#ifdef BUILD_ELEMENTS
+    if (is_elements) {
+        /* Issuance */
+        if (anyonecanpay)
+            memset(buff, 0, SHA256_LEN);
+        else if (ctx)
+            memcpy(buff, ctx->hash_issuances, SHA256_LEN);
+        else
+            tx_hash_issuances(tx, buff);
+        sha256_update(sha_ctx, buff, SHA256_LEN);
+    }
+#endif /* BUILD_ELEMENTS */
+
+    /* Input details */
+    sha256_update(sha_ctx, input->txhash, WALLY_TXHASH_LEN);
+    sha256_le32(sha_ctx, input->index);
+    sha256_varbuff(sha_ctx, opts->script, opts->script_len);
+    if (!is_elements)
+        sha256_le64(sha_ctx, opts->satoshi);
+#ifdef BUILD_ELEMENTS
+    else
+        sha256_confidential_value(sha_ctx, opts->value, opts->value_len);
+#endif
+    sha256_le32(sha_ctx, input->sequence);
+
+#ifdef BUILD_ELEMENTS
+    if (is_elements && (input->features & WALLY_TX_IS_ISSUANCE)) {
+        sha256_update(sha_ctx, input->blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
+        sha256_update(sha_ctx, input->entropy, WALLY_TX_ASSET_TAG_LEN);
+        sha256_confidential_value(sha_ctx, input->issuance_amount,
+                                  input->issuance_amount_len);
+        sha256_confidential_value(sha_ctx, input->inflation_keys,
+                                  input->inflation_keys_len);
+    }
+#endif
+
+    /* Outputs */
     if (sh_none || (sh_single && opts->index >= tx->num_outputs))
-        memset(p, 0, SHA256_LEN);
-    else {
-        output_p = buff_p;
-        for (i = 0; i < tx->num_outputs; ++i) {
-            if (sh_single && i != opts->index)
-                continue;
+        memset(buff, 0, SHA256_LEN);
+    else if (sh_single)
+        tx_hash_outputs(tx, opts->index, opts->index + 1, is_elements, buff);
+    else if (ctx)
+        memcpy(buff, ctx->hash_outputs, SHA256_LEN);
+    else
+        tx_hash_outputs(tx, 0, tx->num_outputs, is_elements, buff);
+    sha256_update(sha_ctx, buff, SHA256_LEN);
+
+    /* nlocktime and sighash*/
+    sha256_le32(sha_ctx, tx->locktime);
+    sha256_le32(sha_ctx, opts->tx_sighash);
+}
+
+/* Hash the pre-segwit signature hash preimage for the input being signed.
+ * This produces the same data as tx_to_bytes for non-BIP143 opts, without
+ * requiring a buffer to serialize the transaction into.
+ */
+static int tx_to_sha256(const struct wally_tx *tx,
+                        const struct tx_serialize_opts *opts,
+                        struct sha256_ctx *ctx, bool is_elements)
+{
+    const bool anyonecanpay = opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
+    const bool sh_none = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
+    const bool sh_single = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+    size_t i;
+
+    sha256_le32(ctx, tx->version);
+    if (anyonecanpay)
+        sha256_u8(ctx, 1);
+    else
+        sha256_varint(ctx, tx->num_inputs);
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        if (anyonecanpay && i != opts->index)
+            continue; /* anyonecanpay only signs the given index */
+
+        sha256_update(ctx, input->txhash, sizeof(input->txhash));
+        sha256_le32(ctx, input->index);
+        if (i == opts->index)
+            sha256_varbuff(ctx, opts->script, opts->script_len);
+        else
+            sha256_u8(ctx, 0); /* Blank scripts for non-signing inputs */
+
+        if ((sh_none || sh_single) && i != opts->index)
+            sha256_le32(ctx, 0);
+        else
+            sha256_le32(ctx, input->sequence);
+        if (input->features & WALLY_TX_IS_ISSUANCE) {
             if (!is_elements)
-                output_p += uint64_to_le_bytes(tx->outputs[i].satoshi, output_p);
+                return WALLY_EINVAL;
 #ifdef BUILD_ELEMENTS
+            sha256_update(ctx, input->blinding_nonce, WALLY_TX_ASSET_TAG_LEN);
+            sha256_update(ctx, input->entropy, WALLY_TX_ASSET_TAG_LEN);
+            sha256_confidential_value(ctx, input->issuance_amount, input->issuance_amount_len);
+            sha256_confidential_value(ctx, input->inflation_keys, input->inflation_keys_len);
+#endif
+        }
+    }
+
+    if (sh_none)
+        sha256_u8(ctx, 0);
+    else {
+        size_t num_outputs = sh_single ? opts->index + 1 : tx->num_outputs;
+        sha256_varint(ctx, num_outputs);
+
+        for (i = 0; i < num_outputs; ++i) {
+            const struct wally_tx_output *output = tx->outputs + i;
+            if (sh_single && i != opts->index)
+                sha256_update(ctx, EMPTY_OUTPUT, sizeof(EMPTY_OUTPUT));
             else {
-                output_p += confidential_value_to_bytes(tx->outputs[i].asset, tx->outputs[i].asset_len,
-                                                        output_p);
-                output_p += confidential_value_to_bytes(tx->outputs[i].value, tx->outputs[i].value_len,
-                                                        output_p);
-                output_p += confidential_value_to_bytes(tx->outputs[i].nonce, tx->outputs[i].nonce_len,
-                                                        output_p);
-            }
+                if (output->features & WALLY_TX_IS_ELEMENTS) {
+                    if (!is_elements)
+                        return WALLY_EINVAL;
+#ifdef BUILD_ELEMENTS
+                    sha256_confidential_value(ctx, output->asset, output->asset_len);
+                    sha256_confidential_value(ctx, output->value, output->value_len);
+                    sha256_confidential_value(ctx, output->nonce, output->nonce_len);
 #endif
-            output_p += varbuff_to_bytes(tx->outputs[i].script,
-                                         tx->outputs[i].script_len, output_p);
+                } else
+                    sha256_le64(ctx, output->satoshi);
+                sha256_varbuff(ctx, output->script, output->script_len);
+            }
         }
+    }
 
-        ret = wally_sha256d(buff_p, outputs_size, p, SHA256_LEN);
-        if (ret != WALLY_OK)
-            goto error;
+    sha256_le32(ctx, tx->locktime);
+    sha256_le32(ctx, opts->tx_sighash);
+    return WALLY_OK;
+}
+
+/* The hashed prefix shared by the pre-segwit SIGHASH_ALL preimages of the
+ * inputs of a transaction. Each input's preimage is the prefix of the
+ * blanked inputs before it, its own outpoint, script and sequence, then
+ * the blanked inputs after it and the outputs. Inputs are usually signed
+ * in order, so the prefix for each input extends that of the last one */
+struct tx_legacy_sighash {
+    struct sha256_ctx prefix; /* Version, input count and inputs before next */
+    size_t next;
+    bool initialized;
+};
+
+/* The size of a serialized input with a blank scriptSig */
+#define LEGACY_BLANK_INPUT_LEN (WALLY_TXHASH_LEN + sizeof(uint32_t) + 1 + sizeof(uint32_t))
+/* The number of blank inputs serialized on the stack per hash update */
+#define LEGACY_BLANK_INPUTS_PER_UPDATE 8u
+
+/* Hash inputs [start, end) with blank scriptSigs. Inputs are serialized
+ * a few at a time into a small buffer, since hashing each field
+ * separately costs more than hashing the inputs themselves */
+static void sha256_blank_inputs(struct sha256_ctx *ctx, const struct wally_tx *tx,
+                                size_t start, size_t end)
+{
+    unsigned char buf[LEGACY_BLANK_INPUTS_PER_UPDATE * LEGACY_BLANK_INPUT_LEN], *p = buf;
+
+    for (; start < end; ++start) {
+        const struct wally_tx_input *input = tx->inputs + start;
+        memcpy(p, input->txhash, WALLY_TXHASH_LEN);
+        p += WALLY_TXHASH_LEN;
+        p += uint32_to_le_bytes(input->index, p);
+        *p++ = 0; /* Blank scriptSig */
+        p += uint32_to_le_bytes(input->sequence, p);
+        if (p == buf + sizeof(buf)) {
+            sha256_update(ctx, buf, sizeof(buf));
+            p = buf;
+        }
     }
-    p += SHA256_LEN;
+    if (p != buf)
+        sha256_update(ctx, buf, p - buf);
+}
 
-    /* nlocktime and sighash*/
-    p += uint32_to_le_bytes(tx->locktime, p);
-    p += uint32_to_le_bytes(opts->tx_sighash, p);
+/* As tx_to_sha256, for SIGHASH_ALL preimages of a non-elements tx */
+static int tx_legacy_to_sha256(const struct wally_tx *tx,
+                               struct tx_legacy_sighash *legacy,
+                               const struct tx_serialize_opts *opts,
+                               struct sha256_ctx *ctx)
+{
+    const struct wally_tx_input *input = tx->inputs + opts->index;
+    size_t i;
 
-    *written = p - bytes_out;
+    if (!legacy->initialized) {
+        for (i = 0; i < tx->num_inputs; ++i)
+            if (tx->inputs[i].features & WALLY_TX_IS_ISSUANCE)
+                return WALLY_EINVAL;
+        for (i = 0; i < tx->num_outputs; ++i)
+            if (tx->outputs[i].features & WALLY_TX_IS_ELEMENTS)
+                return WALLY_EINVAL;
+        legacy->initialized = true;
+        legacy->next = tx->num_inputs; /* Force the prefix to be initialized */
+    }
 
-error:
-    if (buff_p != buff)
-        clear_and_free(buff_p, buff_len);
-    else
-        wally_clear(buff, sizeof(buff));
-    return ret;
+    if (legacy->next > opts->index) {
+        /* Inputs are usually signed in order, otherwise start again */
+        sha256_init(&legacy->prefix);
+        sha256_le32(&legacy->prefix, tx->version);
+        sha256_varint(&legacy->prefix, tx->num_inputs);
+        legacy->next = 0;
+    }
+    sha256_blank_inputs(&legacy->prefix, tx, legacy->next, opts->index);
+    legacy->next = opts->index;
+
+    *ctx = legacy->prefix;
+    sha256_update(ctx, input->txhash, sizeof(input->txhash));
+    sha256_le32(ctx, input->index);
+    sha256_varbuff(ctx, opts->script, opts->script_len);
+    sha256_le32(ctx, input->sequence);
+    sha256_blank_inputs(ctx, tx, opts->index + 1, tx->num_inputs);
+    sha256_varint(ctx, tx->num_outputs);
+    for (i = 0; i < tx->num_outputs; ++i) {
+        sha256_le64(ctx, tx->outputs[i].satoshi);
+        sha256_varbuff(ctx, tx->outputs[i].script, tx->outputs[i].script_len);
+    }
+    sha256_le32(ctx, tx->locktime);
+    sha256_le32(ctx, opts->tx_sighash);
+    return WALLY_OK;
+}
+
+/* Serialize the witness stack of an input */
+static size_t tx_input_witness_to_bytes(const struct wally_tx_input *input,
+                                        unsigned char *bytes_out)
+{
+    const size_t num_items = input->witness ? input->witness->num_items : 0;
+    unsigned char *p = bytes_out;
+    size_t i;
+
+    p += varint_to_bytes(num_items, p);
+    for (i = 0; i < num_items; ++i) {
+        const struct wally_tx_witness_item *item = input->witness->items + i;
+        p += varbuff_to_bytes(item->witness, item->witness_len, p);
+    }
+    return p - bytes_out;
+}
+
+/* Serialize a non-elements tx without a separate length pass, checking
+ * for room as each field is written. Returns WALLY_ENOMEM if bytes_out
+ * is too small, in which case its contents are undefined.
+ */
+static int tx_to_bytes_single_pass(const struct wally_tx *tx, uint32_t flags,
+                                   unsigned char *bytes_out, size_t len,
+                                   size_t *written)
+{
+    unsigned char *p = bytes_out, *end = bytes_out + len;
+    size_t i, witness_count;
+
+#define TX_ENSURE_ROOM(n) if ((size_t)(end - p) < (n)) return WALLY_ENOMEM
+
+    if (flags & WALLY_TX_FLAG_USE_WITNESS) {
+        if (wally_tx_get_witness_count(tx, &witness_count) != WALLY_OK)
+            return WALLY_EINVAL;
+        if (!witness_count)
+            flags &= ~WALLY_TX_FLAG_USE_WITNESS;
+    }
+
+    TX_ENSURE_ROOM(sizeof(uint32_t) + (flags & WALLY_TX_FLAG_USE_WITNESS ? 2 : 0) +
+                   varint_get_length(tx->num_inputs));
+    p += uint32_to_le_bytes(tx->version, p);
+    if (flags & WALLY_TX_FLAG_USE_WITNESS) {
+        *p++ = 0; /* Write BIP 144 marker */
+        *p++ = 1; /* Write BIP 144 flag */
+    }
+    p += varint_to_bytes(tx->num_inputs, p);
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        if (input->features & WALLY_TX_IS_ISSUANCE)
+            return WALLY_EINVAL;
+        TX_ENSURE_ROOM(sizeof(input->txhash) + sizeof(uint32_t) +
+                       varbuff_get_length(input->script_len) + sizeof(uint32_t));
+        memcpy(p, input->txhash, sizeof(input->txhash));
+        p += sizeof(input->txhash);
+        if (input->features & WALLY_TX_IS_PEGIN)
+            p += uint32_to_le_bytes(input->index | WALLY_TX_PEGIN_FLAG, p);
+        else
+            p += uint32_to_le_bytes(input->index, p);
+        p += varbuff_to_bytes(input->script, input->script_len, p);
+        p += uint32_to_le_bytes(input->sequence, p);
+    }
+
+    TX_ENSURE_ROOM(varint_get_length(tx->num_outputs));
+    p += varint_to_bytes(tx->num_outputs, p);
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        if (output->features & WALLY_TX_IS_ELEMENTS)
+            return WALLY_EINVAL;
+        TX_ENSURE_ROOM(sizeof(uint64_t) + varbuff_get_length(output->script_len));
+        p += uint64_to_le_bytes(output->satoshi, p);
+        p += varbuff_to_bytes(output->script, output->script_len, p);
+    }
+
+    if (flags & WALLY_TX_FLAG_USE_WITNESS) {
+        for (i = 0; i < tx->num_inputs; ++i) {
+            TX_ENSURE_ROOM(tx_input_witness_length(tx->inputs + i));
+            p += tx_input_witness_to_bytes(tx->inputs + i, p);
+        }
+    }
+
+    TX_ENSURE_ROOM(sizeof(uint32_t));
+    p += uint32_to_le_bytes(tx->locktime, p);
+#undef TX_ENSURE_ROOM
+    *written = p - bytes_out;
+    return WALLY_OK;
 }
 
 static int tx_to_bytes(const struct wally_tx *tx,
@@ -1975,7 +3064,7 @@ static int tx_to_bytes(const struct wally_tx *tx,
                        size_t *written,
                        bool is_elements)
 {
-    size_t n, i, j, witness_count;
+    size_t n, i, witness_count;
     const bool anyonecanpay = opts && opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
     const bool sh_none = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
     const bool sh_single = opts && (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
@@ -1985,8 +3074,17 @@ static int tx_to_bytes(const struct wally_tx *tx,
         *written = 0;
 
     if (!is_valid_tx(tx) || (flags & ~WALLY_TX_FLAG_USE_WITNESS) ||
-        !bytes_out || !written ||
-        tx_get_length(tx, opts, flags, &n, is_elements) != WALLY_OK)
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    if (!opts && !is_elements) {
+        int ret = tx_to_bytes_single_pass(tx, flags, bytes_out, len, written);
+        if (ret != WALLY_ENOMEM)
+            return ret;
+        /* Too small: fall through to return the required length */
+    }
+
+    if (tx_get_length(tx, opts, flags, &n, is_elements) != WALLY_OK)
         return WALLY_EINVAL;
 
     if (opts && (flags & WALLY_TX_FLAG_USE_WITNESS))
@@ -1998,7 +3096,7 @@ static int tx_to_bytes(const struct wally_tx *tx,
     }
 
     if (opts && opts->bip143)
-        return tx_to_bip143_bytes(tx, opts, flags, bytes_out, len, written);
+        return WALLY_ERROR; /* BIP143 preimages are streamed into the hash */
 
     if (flags & WALLY_TX_FLAG_USE_WITNESS) {
         if (wally_tx_get_witness_count(tx, &witness_count) != WALLY_OK)
@@ -2090,16 +3188,8 @@ static int tx_to_bytes(const struct wally_tx *tx,
     }
 
     if (!is_elements && (flags & WALLY_TX_FLAG_USE_WITNESS)) {
-        for (i = 0; i < tx->num_inputs; ++i) {
-            const struct wally_tx_input *input = tx->inputs + i;
-            size_t num_items = input->witness ? input->witness->num_items : 0;
-            p += varint_to_bytes(num_items, p);
-            for (j = 0; j < num_items; ++j) {
-                const struct wally_tx_witness_item *stack;
-                stack = input->witness->items + j;
-                p += varbuff_to_bytes(stack->witness, stack->witness_len, p);
-            }
-        }
+        for (i = 0; i < tx->num_inputs; ++i)
+            p += tx_input_witness_to_bytes(tx->inputs + i, p);
     }
 
     p += uint32_to_le_bytes(tx->locktime, p);
@@ -2110,16 +3200,10 @@ static int tx_to_bytes(const struct wally_tx *tx,
     if (is_elements && (flags & WALLY_TX_FLAG_USE_WITNESS)) {
         for (i = 0; i < tx->num_inputs; ++i) {
             const struct wally_tx_input *input = tx->inputs + i;
-            size_t num_items;
+            size_t num_items, j;
             p += varbuff_to_bytes(input->issuance_amount_rangeproof, input->issuance_amount_rangeproof_len, p);
             p += varbuff_to_bytes(input->inflation_keys_rangeproof, input->inflation_keys_rangeproof_len, p);
-            num_items = input->witness ? input->witness->num_items : 0;
-            p += varint_to_bytes(num_items, p);
-            for (j = 0; j < num_items; ++j) {
-                const struct wally_tx_witness_item *stack;
-                stack = input->witness->items + j;
-                p += varbuff_to_bytes(stack->witness, stack->witness_len, p);
-            }
+            p += tx_input_witness_to_bytes(input, p);
             num_items = input->pegin_witness ? input->pegin_witness->num_items : 0;
             p += varint_to_bytes(num_items, p);
             for (j = 0; j < num_items; ++j) {
@@ -2143,35 +3227,48 @@ int wally_tx_to_bytes(const struct wally_tx *tx, uint32_t flags,
                       unsigned char *bytes_out, size_t len,
                       size_t *written)
 {
-    return tx_to_bytes(tx, NULL, flags & ~WALLY_TX_FLAG_USE_ELEMENTS, bytes_out, len, written,
-                       flags & WALLY_TX_FLAG_USE_ELEMENTS);
+    return tx_to_bytes(tx, NULL, flags & ~WALLY_TX_FLAG_USE_ELEMENTS,
+                       bytes_out, len, written, flags & WALLY_TX_FLAG_USE_ELEMENTS);
+}
+
+/* Serialize into the end of a buffer of n * 2 + 1 chars and hex encode in
+ * place. Each byte is read before the characters written for it can reach
+ * it, so no binary temporary is needed.
+ */
+static int tx_to_hex_in_place(const struct wally_tx *tx, uint32_t flags,
+                              char *output, size_t n, size_t *written,
+                              bool is_elements)
+{
+    unsigned char *bytes = (unsigned char *)output + n + 1;
+    size_t n2;
+    int ret = tx_to_bytes(tx, NULL, flags, bytes, n, &n2, is_elements);
+
+    if (ret == WALLY_OK && n2 != n)
+        ret = WALLY_ERROR; /* Length calculated incorrectly */
+    if (ret == WALLY_OK)
+        ret = wally_hex_from_bytes_to_buffer(bytes, n, output, n * 2 + 1, written);
+    return ret;
 }
 
 static int tx_to_hex(const struct wally_tx *tx, uint32_t flags,
                      char **output, bool is_elements)
 {
-    unsigned char buff[TX_STACK_SIZE], *buff_p = buff;
     size_t n, written;
     int ret;
 
-    if (!output)
+    if (output)
+        *output = NULL;
+
+    if (!output || tx_get_length(tx, NULL, flags, &n, is_elements) != WALLY_OK)
         return WALLY_EINVAL;
 
-    ret = tx_to_bytes(tx, NULL, flags, buff_p, sizeof(buff), &n, is_elements);
-    if (ret == WALLY_OK) {
-        if (n > sizeof(buff)) {
-            if ((buff_p = wally_malloc(n)) == NULL)
-                return WALLY_ENOMEM;
-            ret = tx_to_bytes(tx, NULL, flags, buff_p, n, &written, is_elements);
-            if (n != written)
-                ret = WALLY_ERROR; /* Length calculated incorrectly */
-        }
-        if (ret == WALLY_OK)
-            ret = wally_hex_from_bytes(buff_p, n, output);
-        if (buff_p != buff)
-            clear_and_free(buff_p, n);
-        else
-            wally_clear(buff, n);
+    if (!(*output = wally_malloc(n * 2 + 1)))
+        return WALLY_ENOMEM;
+
+    ret = tx_to_hex_in_place(tx, flags, *output, n, &written, is_elements);
+    if (ret != WALLY_OK) {
+        clear_public_and_free(*output, n * 2 + 1);
+        *output = NULL;
     }
     return ret;
 }
@@ -2183,9 +3280,242 @@ int wally_tx_to_hex(const struct wally_tx *tx, uint32_t flags,
                      flags & WALLY_TX_FLAG_USE_ELEMENTS);
 }
 
-static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
-                      uint32_t flags, size_t *num_inputs, size_t *num_outputs,
-                      bool *expect_witnesses)
+int wally_tx_to_hex_to_buffer(const struct wally_tx *tx, uint32_t flags,
+                              char *output, size_t len, size_t *written)
+{
+    const bool is_elements = flags & WALLY_TX_FLAG_USE_ELEMENTS;
+    size_t n;
+
+    if (written)
+        *written = 0;
+
+    flags &= ~WALLY_TX_FLAG_USE_ELEMENTS;
+    if (!output || !written ||
+        tx_get_length(tx, NULL, flags, &n, is_elements) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    if (len < n * 2 + 1) {
+        *written = n * 2 + 1;
+        return WALLY_OK; /* Not enough room in output */
+    }
+    return tx_to_hex_in_place(tx, flags, output, n, written, is_elements);
+}
+
+static size_t tx_witness_memory_usage(const struct wally_tx_witness_stack *stack)
+{
+    size_t total = 0, i;
+
+    if (!stack)
+        return 0;
+    total = sizeof(*stack) + stack->items_allocation_len * sizeof(*stack->items);
+    for (i = 0; i < stack->num_items; ++i)
+        total += stack->items[i].witness_len;
+    return total;
+}
+
+int wally_tx_get_memory_usage(const struct wally_tx *tx, size_t *written)
+{
+    size_t total, i;
+
+    if (written)
+        *written = 0;
+    if (!tx || !written)
+        return WALLY_EINVAL;
+
+    if (is_read_only_tx(tx)) {
+        /* A read-only clone is a single allocation */
+        *written = tx_block_of(tx)->len;
+        return WALLY_OK;
+    }
+
+    total = sizeof(*tx) +
+            tx->inputs_allocation_len * sizeof(*tx->inputs) +
+            tx->outputs_allocation_len * sizeof(*tx->outputs);
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        total += input->script_len;
+        total += tx_witness_memory_usage(input->witness);
+#ifdef BUILD_ELEMENTS
+        total += input->issuance_amount_len + input->inflation_keys_len;
+        if (!(input->features & WALLY_TX_PROOFS_REFERENCED))
+            total += input->issuance_amount_rangeproof_len +
+                     input->inflation_keys_rangeproof_len;
+        total += tx_witness_memory_usage(input->pegin_witness);
+#endif
+    }
+
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        total += output->script_len;
+#ifdef BUILD_ELEMENTS
+        total += output->asset_len + output->value_len + output->nonce_len;
+        if (!(output->features & WALLY_TX_PROOFS_REFERENCED))
+            total += output->surjectionproof_len + output->rangeproof_len;
+#endif
+    }
+
+
+    *written = total;
+    return WALLY_OK;
+}
+
+/* Builds the segments of a serialization for wally_tx_to_iovecs. Sizes
+ * are counted past the end of the caller's buffers, so that the required
+ * sizes can be returned when they are too small */
+struct tx_iov_writer {
+    unsigned char *bytes;
+    size_t len;
+    size_t used;
+    size_t run_start; /* Start of the bytes not yet in a segment */
+    struct wally_tx_iovec *iov;
+    size_t iov_len;
+    size_t num_iov;
+};
+
+static void tx_iov_add(struct tx_iov_writer *w, const void *base, size_t len)
+{
+    if (w->num_iov < w->iov_len) {
+        w->iov[w->num_iov].iov_base = base;
+        w->iov[w->num_iov].iov_len = len;
+    }
+    w->num_iov += 1;
+}
+
+/* End the current run of copied bytes as a segment */
+static void tx_iov_flush(struct tx_iov_writer *w)
+{
+    if (w->used > w->run_start)
+        tx_iov_add(w, w->bytes + w->run_start, w->used - w->run_start);
+    w->run_start = w->used;
+}
+
+static void tx_iov_copy(struct tx_iov_writer *w, const void *bytes, size_t len)
+{
+    if (len && w->used + len <= w->len)
+        memcpy(w->bytes + w->used, bytes, len);
+    w->used += len;
+}
+
+static void tx_iov_varint(struct tx_iov_writer *w, uint64_t v)
+{
+    unsigned char buff[9];
+    tx_iov_copy(w, buff, varint_to_bytes(v, buff));
+}
+
+static void tx_iov_le32(struct tx_iov_writer *w, uint32_t v)
+{
+    unsigned char buff[sizeof(uint32_t)];
+    tx_iov_copy(w, buff, uint32_to_le_bytes(v, buff));
+}
+
+/* Add a length prefixed buffer, referencing it if it's long enough */
+static void tx_iov_varbuff(struct tx_iov_writer *w, const unsigned char *bytes,
+                           size_t len, bool with_len)
+{
+    if (with_len)
+        tx_iov_varint(w, len);
+    if (len < WALLY_TX_IOVEC_REF_LEN)
+        tx_iov_copy(w, bytes, len);
+    else {
+        tx_iov_flush(w);
+        tx_iov_add(w, bytes, len);
+    }
+}
+
+/* Whether tx has any elements data, so can't be serialized as bitcoin */
+static bool tx_has_elements_data(const struct wally_tx *tx)
+{
+    size_t is_elements = 0, i;
+
+#ifdef BUILD_ELEMENTS
+    if (wally_tx_is_elements(tx, &is_elements) != WALLY_OK || is_elements)
+        return true;
+#endif
+    for (i = 0; i < tx->num_inputs && !is_elements; ++i)
+        is_elements = tx->inputs[i].features & (WALLY_TX_IS_ISSUANCE | WALLY_TX_IS_PEGIN);
+    for (i = 0; i < tx->num_outputs && !is_elements; ++i)
+        is_elements = tx->outputs[i].features & WALLY_TX_IS_ELEMENTS;
+    return is_elements != 0;
+}
+
+int wally_tx_to_iovecs(const struct wally_tx *tx, uint32_t flags,
+                       unsigned char *bytes_out, size_t len,
+                       struct wally_tx_iovec *iov_out, size_t iov_len,
+                       size_t *written, size_t *iov_written)
+{
+    struct tx_iov_writer w;
+    size_t witness_count = 0, i, j;
+    unsigned char buff[sizeof(uint64_t)];
+
+    if (written)
+        *written = 0;
+    if (iov_written)
+        *iov_written = 0;
+
+    if (!is_valid_tx(tx) || (flags & ~WALLY_TX_FLAG_USE_WITNESS) ||
+        (!bytes_out && len) || (!iov_out && iov_len) || !written || !iov_written ||
+        tx_has_elements_data(tx))
+        return WALLY_EINVAL;
+    if ((flags & WALLY_TX_FLAG_USE_WITNESS) &&
+        wally_tx_get_witness_count(tx, &witness_count) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    wally_clear(&w, sizeof(w));
+    w.bytes = bytes_out;
+    w.len = len;
+    w.iov = iov_out;
+    w.iov_len = iov_len;
+
+    tx_iov_le32(&w, tx->version);
+    if (witness_count) {
+        buff[0] = 0; /* BIP 144 marker */
+        buff[1] = 1; /* BIP 144 flag */
+        tx_iov_copy(&w, buff, 2);
+    }
+    tx_iov_varint(&w, tx->num_inputs);
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        tx_iov_copy(&w, input->txhash, sizeof(input->txhash));
+        tx_iov_le32(&w, input->index);
+        tx_iov_varbuff(&w, input->script, input->script_len, true);
+        tx_iov_le32(&w, input->sequence);
+    }
+    tx_iov_varint(&w, tx->num_outputs);
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        tx_iov_copy(&w, buff, uint64_to_le_bytes(output->satoshi, buff));
+        tx_iov_varbuff(&w, output->script, output->script_len, true);
+    }
+    for (i = 0; i < tx->num_inputs && witness_count; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        const struct wally_tx_witness_stack *witness = input->witness;
+        tx_iov_varint(&w, witness ? witness->num_items : 0);
+        for (j = 0; witness && j < witness->num_items; ++j)
+            tx_iov_varbuff(&w, witness->items[j].witness,
+                           witness->items[j].witness_len, true);
+    }
+    tx_iov_le32(&w, tx->locktime);
+    tx_iov_flush(&w);
+
+    *written = w.used;
+    *iov_written = w.num_iov;
+    if (w.used > len || w.num_iov > iov_len)
+        wally_clear(iov_out, iov_len * sizeof(*iov_out)); /* Too small */
+    return WALLY_OK;
+}
+
+/* Offsets of the parts of a serialized transaction found by analyze_tx */
+struct tx_offsets {
+    size_t outputs; /* Start of the outputs, at the output count */
+    size_t outputs_end; /* End of the outputs */
+    size_t locktime; /* Start of the locktime */
+    size_t end; /* End of the transaction */
+};
+
+static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
+                      uint32_t flags, size_t *num_inputs, size_t *num_outputs,
+                      bool *expect_witnesses, struct tx_offsets *offsets)
 {
     const unsigned char *p = bytes, *end = bytes + bytes_len;
     uint64_t v, num_witnesses;
@@ -2221,7 +3551,8 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
 
 #define ensure_n(n) if (p > end || p + (n) > end) return WALLY_EINVAL
 
-#define ensure_varint(dst) ensure_n(varint_length_from_bytes(p)); \
+#define ensure_varint(dst) ensure_n(sizeof(uint8_t)); \
+    ensure_n(varint_length_from_bytes(p)); \
     p += varint_from_bytes(p, (dst))
 
 #define ensure_varbuff(dst) ensure_varint((dst)); \
@@ -2255,6 +3586,9 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
 #define ensure_committed_nonce(dst) \
     ensure_commitment(dst, WALLY_TX_ASSET_CT_NONCE_LEN, WALLY_TX_ASSET_CT_NONCE_PREFIX_A, WALLY_TX_ASSET_CT_NONCE_PREFIX_B)
 
+#define ensure_witness_items(n) \
+    if (wally_exceeds_input_limit(WALLY_LIMIT_TX_WITNESS_ITEMS, (n))) return WALLY_EINVAL
+
     ensure_varint(&v);
     if (!v)
         return WALLY_EINVAL;
@@ -2280,6 +3614,8 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
         }
     }
 
+    if (offsets)
+        offsets->outputs = p - bytes;
     ensure_varint(&v);
     if (!v)
         return WALLY_EINVAL;
@@ -2298,10 +3634,13 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
         /* FIXME: Analyze script types if required */
         p += v;
     }
+    if (offsets)
+        offsets->outputs_end = p - bytes;
 
     if (*expect_witnesses && !is_elements) {
         for (i = 0; i < *num_inputs; ++i) {
             ensure_varint(&num_witnesses);
+            ensure_witness_items(num_witnesses);
             for (j = 0; j < num_witnesses; ++j) {
                 ensure_varbuff(&v);
                 p += v;
@@ -2310,6 +3649,10 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
     }
 
     ensure_n(sizeof(uint32_t)); /* Locktime */
+    if (offsets) {
+        offsets->locktime = p - bytes;
+        offsets->end = offsets->locktime + sizeof(uint32_t);
+    }
 
     if (*expect_witnesses && is_elements) {
         p += sizeof(uint32_t);
@@ -2319,11 +3662,13 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
             ensure_varbuff(&v); /* inflation keys rangeproof */
             p += v;
             ensure_varint(&num_witnesses); /* scriptWitness */
+            ensure_witness_items(num_witnesses);
             for (j = 0; j < num_witnesses; ++j) {
                 ensure_varbuff(&v);
                 p += v;
             }
             ensure_varint(&num_witnesses); /* peginWitness */
+            ensure_witness_items(num_witnesses);
             for (j = 0; j < num_witnesses; ++j) {
                 ensure_varbuff(&v);
                 p += v;
@@ -2337,6 +3682,8 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
             p += v;
         }
     }
+    if (offsets && *expect_witnesses && is_elements)
+        offsets->end = p - bytes;
 
 #undef ensure_n
 #undef ensure_varint
@@ -2345,14 +3692,37 @@ static int analyze_tx(const unsigned char *bytes, size_t bytes_len,
 #undef ensure_committed_value
 #undef ensure_committed_asset
 #undef ensure_committed_nonce
+#undef ensure_witness_items
     return WALLY_OK;
 }
 
+/* Find an item in serialized witness stack data following the item count */
+static const unsigned char *witness_item_from_bytes(const unsigned char *bytes,
+                                                    size_t num_items, size_t index,
+                                                    size_t *witness_len)
+{
+    const unsigned char *p = bytes;
+    uint64_t tmp;
+    size_t i;
+
+    if (index >= num_items)
+        return NULL;
+    for (i = 0; ; ++i) {
+        p += varint_from_bytes(p, &tmp);
+        if (i == index)
+            break;
+        p += tmp;
+    }
+    *witness_len = tmp;
+    return p;
+}
+
+/* Decode a validated serialized witness stack */
 static int witness_stack_from_bytes(const unsigned char *bytes, struct wally_tx_witness_stack **witness, size_t *offset)
 {
     int ret = WALLY_OK;
     size_t i;
-    uint64_t num_witnesses;
+    uint64_t num_witnesses, witness_len;
     const unsigned char *p = bytes;
     p += varint_from_bytes(p, &num_witnesses);
     if (num_witnesses) {
@@ -2361,7 +3731,6 @@ static int witness_stack_from_bytes(const unsigned char *bytes, struct wally_tx_
             goto cleanup;
 
         for (i = 0; i < num_witnesses; ++i) {
-            uint64_t witness_len;
             p += varint_from_bytes(p, &witness_len);
             ret = wally_tx_witness_stack_set(*witness, i, p, witness_len);
             if (ret != WALLY_OK)
@@ -2376,22 +3745,160 @@ cleanup:
     return ret;
 }
 
+/* Decode a non-elements transaction, validating as it is built. If
+ * witnesses are skipped, the offset of each input's serialized witness
+ * stack is stored in witness_offsets, if given */
+static int tx_from_bytes_btc(const unsigned char *bytes, size_t bytes_len,
+                             uint32_t flags, size_t *witness_offsets,
+                             size_t witness_offsets_len, struct wally_tx **output)
+{
+    const unsigned char *p = bytes, *end = bytes + bytes_len;
+    const bool skip_witness_decode = flags & WALLY_TX_FLAG_SKIP_WITNESS_DECODE;
+    bool expect_witnesses = false;
+    uint32_t version;
+    uint64_t v, num_witnesses;
+    size_t i, j, offset;
+    struct wally_tx *result = NULL;
+    int ret = WALLY_EINVAL;
+
+    if (!bytes || bytes_len < sizeof(uint32_t) + 2 ||
+        (flags & ~(WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_SKIP_WITNESS_DECODE)))
+        return WALLY_EINVAL;
+
+    p += uint32_from_le_bytes(p, &version);
+    if (*p == 0) {
+        /* BIP 144 extended serialization */
+        if (p[1] != 0x1)
+            return WALLY_EINVAL; /* Invalid witness flag */
+        p += 2;
+        expect_witnesses = true;
+    }
+
+#define ensure_n(n) if (p > end || p + (n) > end) { ret = WALLY_EINVAL; goto fail; }
+
+#define ensure_varint(dst) ensure_n(sizeof(uint8_t)); \
+    ensure_n(varint_length_from_bytes(p)); \
+    p += varint_from_bytes(p, (dst))
+
+#define ensure_varbuff(dst) ensure_varint((dst)); \
+    ensure_n(*dst)
+
+/* Reject counts that can't fit in the remaining bytes before allocating */
+#define ensure_count(n, min_len) \
+    if (!(n) || (n) > (uint64_t)(end - p) / (min_len)) { ret = WALLY_EINVAL; goto fail; }
+
+    ensure_varint(&v);
+    ensure_count(v, WALLY_TXHASH_LEN + sizeof(uint32_t) * 2 + 1);
+    ret = wally_tx_init_alloc(version, 0, v, 0, output);
+    if (ret != WALLY_OK)
+        return ret;
+    result = *output;
+
+    for (i = 0; i < result->inputs_allocation_len; ++i) {
+        const unsigned char *txhash = p, *script;
+        uint32_t index, sequence;
+        ensure_n(WALLY_TXHASH_LEN + sizeof(uint32_t));
+        p += WALLY_TXHASH_LEN;
+        p += uint32_from_le_bytes(p, &index);
+        ensure_varbuff(&v);
+        script = p;
+        p += v;
+        ensure_n(sizeof(uint32_t));
+        p += uint32_from_le_bytes(p, &sequence);
+        ret = tx_elements_input_init(txhash, WALLY_TXHASH_LEN, index, sequence,
+                                     v ? script : NULL, v, NULL,
+                                     NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                     NULL, 0, NULL, 0, NULL, &result->inputs[i], false);
+        if (ret != WALLY_OK)
+            goto fail;
+        result->num_inputs += 1;
+    }
+
+    ensure_varint(&v);
+    ensure_count(v, sizeof(uint64_t) + 1);
+    ret = wally_tx_reserve(result, 0, v);
+    if (ret != WALLY_OK)
+        goto fail;
+
+    for (i = 0; i < result->outputs_allocation_len; ++i) {
+        const unsigned char *script;
+        uint64_t satoshi;
+        ensure_n(sizeof(uint64_t));
+        p += uint64_from_le_bytes(p, &satoshi);
+        ensure_varbuff(&v);
+        script = p;
+        p += v;
+        ret = tx_elements_output_init(satoshi, v ? script : NULL, v,
+                                      NULL, 0, NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                      &result->outputs[i], false);
+        if (ret != WALLY_OK)
+            goto fail;
+        result->num_outputs += 1;
+    }
+
+    for (i = 0; expect_witnesses && i < result->num_inputs; ++i) {
+        struct wally_tx_input *input = result->inputs + i;
+        const unsigned char *witness_start = p;
+        if (skip_witness_decode && i < witness_offsets_len)
+            witness_offsets[i] = witness_start - bytes;
+        ensure_varint(&num_witnesses);
+        if (!num_witnesses)
+            continue;
+        ensure_count(num_witnesses, 1);
+        if (wally_exceeds_input_limit(WALLY_LIMIT_TX_WITNESS_ITEMS, num_witnesses)) {
+            ret = WALLY_EINVAL;
+            goto fail;
+        }
+        for (j = 0; j < num_witnesses; ++j) {
+            ensure_varbuff(&v);
+            p += v;
+        }
+        if (skip_witness_decode)
+            continue; /* Validated only, input->witness is left NULL */
+        ret = witness_stack_from_bytes(witness_start, &input->witness, &offset);
+        if (ret != WALLY_OK)
+            goto fail;
+    }
+
+    ensure_n(sizeof(uint32_t));
+    uint32_from_le_bytes(p, &result->locktime);
+
+#undef ensure_n
+#undef ensure_varint
+#undef ensure_varbuff
+#undef ensure_count
+
+    return WALLY_OK;
+fail:
+    tx_free(result, true);
+    *output = NULL;
+    return ret;
+}
+
 static int tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
                          uint32_t flags, struct wally_tx **output,
                          bool is_elements)
 {
     const unsigned char *p = bytes;
     bool expect_witnesses;
-    uint32_t analyze_flags = flags & ~WALLY_TX_FLAG_USE_WITNESS;
-    size_t i, j, num_inputs, num_outputs;
-    uint64_t tmp, num_witnesses;
+    uint32_t analyze_flags = flags & ~(WALLY_TX_FLAG_USE_WITNESS | WALLY_TX_FLAG_REFERENCE_PROOFS);
+    size_t i, num_inputs, num_outputs;
+    uint64_t tmp;
     int ret;
     struct wally_tx *result;
 
     TX_CHECK_OUTPUT;
 
-    if (analyze_tx(bytes, bytes_len, analyze_flags, &num_inputs, &num_outputs,
-                   &expect_witnesses) != WALLY_OK)
+    if (wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len))
+        return WALLY_EINVAL;
+
+    if (!is_elements)
+        return tx_from_bytes_btc(bytes, bytes_len, flags, NULL, 0, output);
+
+    /* Elements transactions are validated by analyze_tx before decoding */
+    if ((flags & WALLY_TX_FLAG_SKIP_WITNESS_DECODE) ||
+        analyze_tx(bytes, bytes_len, analyze_flags, &num_inputs, &num_outputs,
+                   &expect_witnesses, NULL) != WALLY_OK)
         return WALLY_EINVAL;
 
     ret = wally_tx_init_alloc(0, 0, num_inputs, num_outputs, output);
@@ -2466,31 +3973,10 @@ static int tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
         result->num_outputs += 1;
     }
 
-    if (expect_witnesses && !is_elements) {
-        for (i = 0; i < num_inputs; ++i) {
-            p += varint_from_bytes(p, &num_witnesses);
-            if (!num_witnesses)
-                continue;
-            ret = wally_tx_witness_stack_init_alloc(num_witnesses,
-                                                    &result->inputs[i].witness);
-            if (ret != WALLY_OK)
-                goto fail;
-
-            for (j = 0; j < num_witnesses; ++j) {
-                uint64_t witness_len;
-                p += varint_from_bytes(p, &witness_len);
-                ret = wally_tx_witness_stack_set(result->inputs[i].witness, j,
-                                                 p, witness_len);
-                if (ret != WALLY_OK)
-                    goto fail;
-                p += witness_len;
-            }
-        }
-    }
-
     uint32_from_le_bytes(p, &result->locktime);
 
 #ifdef BUILD_ELEMENTS
+    const bool reference_proofs = flags & WALLY_TX_FLAG_REFERENCE_PROOFS;
 
 #define proof_from_bytes(dst, len) \
     p += varint_from_bytes(p, (len)); \
@@ -2508,7 +3994,8 @@ static int tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
                                                         issuance_amount_rangeproof_len ? issuance_amount_rangeproof : NULL,
                                                         issuance_amount_rangeproof_len,
                                                         inflation_keys_rangeproof_len ? inflation_keys_rangeproof : NULL,
-                                                        inflation_keys_rangeproof_len);
+                                                        inflation_keys_rangeproof_len,
+                                                        reference_proofs);
             if (ret != WALLY_OK)
                 goto fail;
             ret = witness_stack_from_bytes(p, &result->inputs[i].witness, &offset);
@@ -2530,178 +4017,3523 @@ static int tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
                                                 surjectionproof_len ? surjectionproof : NULL,
                                                 surjectionproof_len,
                                                 rangeproof_len ? rangeproof : NULL,
-                                                rangeproof_len);
+                                                rangeproof_len, reference_proofs);
             if (ret != WALLY_OK)
                 goto fail;
         }
     }
 
-#undef proof_from_bytes
+#undef proof_from_bytes
+
+#endif /* BUILD_ELEMENTS */
+    return WALLY_OK;
+fail:
+    tx_free(result, true);
+    *output = NULL;
+    return ret;
+}
+
+int wally_tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                        uint32_t flags, struct wally_tx **output)
+{
+    int ret;
+
+    WALLY_TRACE2(wally_tx_from_bytes__entry, bytes_len, flags);
+    WALLY_STATS_TIMED(WALLY_STAT_TX_PARSES, WALLY_STAT_TX_PARSE_NS, ret,
+                      tx_from_bytes(bytes, bytes_len, flags, output,
+                                    flags & WALLY_TX_FLAG_USE_ELEMENTS));
+    WALLY_TRACE1(wally_tx_from_bytes__return, ret);
+    return ret;
+}
+
+int wally_tx_from_hex(const char *hex, uint32_t flags,
+                      struct wally_tx **output)
+{
+    unsigned char buff[TX_STACK_SIZE], *buff_p = buff;
+    size_t hex_len = hex ? strlen(hex) : 0, bin_len;
+    size_t written;
+    int ret;
+
+    /* Proofs can't reference the temporary buffer the hex is decoded into */
+    if (!hex || hex_len & 0x1 || (flags & WALLY_TX_FLAG_REFERENCE_PROOFS) || !output)
+        return WALLY_EINVAL;
+
+    bin_len = hex_len / 2;
+    if (wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bin_len))
+        return WALLY_EINVAL; /* Reject before decoding the hex */
+
+    if (bin_len > sizeof(buff)) {
+        if ((buff_p = wally_malloc(bin_len)) == NULL)
+            return WALLY_ENOMEM;
+    }
+    ret = wally_hex_to_bytes(hex, buff_p, bin_len, &written);
+    if (ret == WALLY_OK)
+        WALLY_STATS_TIMED(WALLY_STAT_TX_PARSES, WALLY_STAT_TX_PARSE_NS, ret,
+                          tx_from_bytes(buff_p, bin_len, flags, output,
+                                        flags & WALLY_TX_FLAG_USE_ELEMENTS));
+
+    if (buff_p != buff)
+        clear_public_and_free(buff_p, bin_len);
+    else
+        wally_clear_public(buff, bin_len);
+
+    return ret;
+}
+
+int wally_tx_from_bytes_skip_witness(const unsigned char *bytes, size_t bytes_len,
+                                     uint32_t flags, size_t *witness_offsets,
+                                     size_t witness_offsets_len, size_t *written,
+                                     struct wally_tx **output)
+{
+    size_t i;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (witness_offsets)
+        for (i = 0; i < witness_offsets_len; ++i)
+            witness_offsets[i] = 0;
+    TX_CHECK_OUTPUT;
+    if (!written || (!witness_offsets && witness_offsets_len) ||
+        (flags & ~WALLY_TX_FLAG_USE_WITNESS) ||
+        wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len))
+        return WALLY_EINVAL;
+
+    flags |= WALLY_TX_FLAG_SKIP_WITNESS_DECODE;
+    WALLY_STATS_TIMED(WALLY_STAT_TX_PARSES, WALLY_STAT_TX_PARSE_NS, ret,
+                      tx_from_bytes_btc(bytes, bytes_len, flags, witness_offsets,
+                                        witness_offsets_len, output));
+    if (ret == WALLY_OK)
+        *written = (*output)->num_inputs;
+    return ret;
+}
+
+int wally_tx_witness_stack_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                      size_t *written,
+                                      struct wally_tx_witness_stack **output)
+{
+    const unsigned char *p = bytes, *end = bytes + bytes_len;
+    uint64_t num_items, item_len;
+    size_t i;
+    int ret;
+
+    if (written)
+        *written = 0;
+    TX_CHECK_OUTPUT;
+    if (!bytes || !bytes_len || !written ||
+        varint_length_from_bytes(p) > bytes_len)
+        return WALLY_EINVAL;
+
+    /* Validate the stack before decoding it */
+    p += varint_from_bytes(p, &num_items);
+    if (num_items > bytes_len ||
+        wally_exceeds_input_limit(WALLY_LIMIT_TX_WITNESS_ITEMS, num_items))
+        return WALLY_EINVAL;
+    for (i = 0; i < num_items; ++i) {
+        if (p >= end || varint_length_from_bytes(p) > (size_t)(end - p))
+            return WALLY_EINVAL;
+        p += varint_from_bytes(p, &item_len);
+        if (item_len > (uint64_t)(end - p))
+            return WALLY_EINVAL;
+        p += item_len;
+    }
+
+    ret = witness_stack_from_bytes(bytes, output, written);
+    if (ret != WALLY_OK) {
+        wally_tx_witness_stack_free(*output);
+        *output = NULL;
+        *written = 0;
+    }
+    return ret;
+}
+
+/* Compact serialization. Integers are written as big endian base 128
+ * varints (as used by bitcoin cores UTXO database), amounts are compressed
+ * by removing trailing zeros and standard scriptPubKeys are replaced by
+ * a template number followed by their hash */
+#define COMPACT_FLAG_WITNESS 0x1 /* The compact header flag for witness data */
+#define COMPACT_SCRIPT_MAX_LEN (3 + SHA256_LEN + 2)
+
+static const struct compact_script {
+    unsigned char prefix[3];
+    unsigned char prefix_len;
+    unsigned char hash_len;
+    unsigned char suffix[2];
+    unsigned char suffix_len;
+} COMPACT_SCRIPTS[] = {
+    { { OP_DUP, OP_HASH160, HASH160_LEN }, 3, HASH160_LEN, { OP_EQUALVERIFY, OP_CHECKSIG }, 2 },
+    { { OP_HASH160, HASH160_LEN }, 2, HASH160_LEN, { OP_EQUAL }, 1 },
+    { { OP_0, HASH160_LEN }, 2, HASH160_LEN, { 0 }, 0 }, /* P2WPKH */
+    { { OP_0, SHA256_LEN }, 2, SHA256_LEN, { 0 }, 0 }, /* P2WSH */
+    { { OP_1, SHA256_LEN }, 2, SHA256_LEN, { 0 }, 0 } /* P2TR */
+};
+#define NUM_COMPACT_SCRIPTS (sizeof(COMPACT_SCRIPTS) / sizeof(COMPACT_SCRIPTS[0]))
+
+/* Return the template number of a scriptPubKey, or NUM_COMPACT_SCRIPTS */
+static size_t compact_script_type(const unsigned char *script, size_t script_len)
+{
+    size_t i;
+
+    if (script_len != WALLY_SCRIPTPUBKEY_P2PKH_LEN && script_len != WALLY_SCRIPTPUBKEY_P2SH_LEN &&
+        script_len != WALLY_SCRIPTPUBKEY_P2WPKH_LEN && script_len != WALLY_SCRIPTPUBKEY_P2WSH_LEN)
+        return NUM_COMPACT_SCRIPTS; /* Not a template length, P2TR is as long as P2WSH */
+
+    for (i = 0; i < NUM_COMPACT_SCRIPTS; ++i) {
+        const struct compact_script *t = COMPACT_SCRIPTS + i;
+        if (script_len == (size_t)t->prefix_len + t->hash_len + t->suffix_len &&
+            !memcmp(script, t->prefix, t->prefix_len) &&
+            !memcmp(script + script_len - t->suffix_len, t->suffix, t->suffix_len))
+            return i;
+    }
+    return NUM_COMPACT_SCRIPTS;
+}
+
+/* Write an output script to bytes_out if non-NULL, returning its length */
+static size_t compact_script_to_bytes(const unsigned char *script, size_t script_len,
+                                      unsigned char *bytes_out)
+{
+    const size_t type = compact_script_type(script, script_len);
+    const struct compact_script *t = COMPACT_SCRIPTS + type;
+    size_t n;
+
+    if (type == NUM_COMPACT_SCRIPTS) {
+        n = varint128_to_bytes(NUM_COMPACT_SCRIPTS + script_len, bytes_out);
+        if (bytes_out && script_len)
+            memcpy(bytes_out + n, script, script_len);
+        return n + script_len;
+    }
+    if (bytes_out) {
+        *bytes_out = (unsigned char)type;
+        memcpy(bytes_out + 1, script + t->prefix_len, t->hash_len);
+    }
+    return 1 + t->hash_len;
+}
+
+/* Write tx in compact form to bytes_out if non-NULL, returning its length */
+static size_t tx_to_compact_bytes(const struct wally_tx *tx, bool use_witness,
+                                  unsigned char *bytes_out)
+{
+    unsigned char *p = bytes_out;
+    size_t n = 1, i;
+
+#define COMPACT_VARINT(v) n += varint128_to_bytes((v), p ? p + n : NULL)
+#define COMPACT_BYTES(src, len) do { \
+        if (p && (len)) memcpy(p + n, (src), (len)); \
+        n += (len); \
+    } while (0)
+
+    if (p)
+        *p = use_witness ? COMPACT_FLAG_WITNESS : 0;
+    COMPACT_VARINT(tx->version);
+    COMPACT_VARINT(tx->num_inputs);
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        COMPACT_BYTES(input->txhash, WALLY_TXHASH_LEN);
+        /* Coinbase and final inputs encode in a single byte */
+        COMPACT_VARINT((uint32_t)(input->index + 1));
+        COMPACT_VARINT((uint32_t)~input->sequence);
+        COMPACT_VARINT(input->script_len);
+        COMPACT_BYTES(input->script, input->script_len);
+    }
+    COMPACT_VARINT(tx->num_outputs);
+    for (i = 0; i < tx->num_outputs; ++i) {
+        const struct wally_tx_output *output = tx->outputs + i;
+        COMPACT_VARINT(satoshi_compress(output->satoshi));
+        n += compact_script_to_bytes(output->script, output->script_len, p ? p + n : NULL);
+    }
+    for (i = 0; use_witness && i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        if (p)
+            n += tx_input_witness_to_bytes(input, p + n);
+        else
+            n += tx_input_witness_length(input);
+    }
+    COMPACT_VARINT(tx->locktime);
+
+#undef COMPACT_VARINT
+#undef COMPACT_BYTES
+    return n;
+}
+
+/* Validate tx for compact serialization, returning whether to use witnesses */
+static int tx_compact_check(const struct wally_tx *tx, uint32_t flags, bool *use_witness)
+{
+    size_t witness_count = 0, i;
+
+    *use_witness = false;
+    if (!is_valid_tx(tx) || (flags & ~WALLY_TX_FLAG_USE_WITNESS) ||
+        tx_has_elements_data(tx))
+        return WALLY_EINVAL;
+    for (i = 0; i < tx->num_outputs; ++i)
+        if (tx->outputs[i].satoshi > SATOSHI_MAX_MONEY)
+            return WALLY_EINVAL;
+    if ((flags & WALLY_TX_FLAG_USE_WITNESS) &&
+        wally_tx_get_witness_count(tx, &witness_count) != WALLY_OK)
+        return WALLY_EINVAL;
+    *use_witness = witness_count != 0;
+    return WALLY_OK;
+}
+
+int wally_tx_get_compact_length(const struct wally_tx *tx, uint32_t flags,
+                                size_t *written)
+{
+    bool use_witness;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (!written)
+        return WALLY_EINVAL;
+    ret = tx_compact_check(tx, flags, &use_witness);
+    if (ret == WALLY_OK)
+        *written = tx_to_compact_bytes(tx, use_witness, NULL);
+    return ret;
+}
+
+int wally_tx_to_compact_bytes(const struct wally_tx *tx, uint32_t flags,
+                              unsigned char *bytes_out, size_t len,
+                              size_t *written)
+{
+    bool use_witness;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (!bytes_out || !written)
+        return WALLY_EINVAL;
+    ret = tx_compact_check(tx, flags, &use_witness);
+    if (ret == WALLY_OK) {
+        *written = tx_to_compact_bytes(tx, use_witness, NULL);
+        if (*written <= len)
+            tx_to_compact_bytes(tx, use_witness, bytes_out);
+    }
+    return ret;
+}
+
+int wally_tx_from_compact_bytes(const unsigned char *bytes, size_t bytes_len,
+                                uint32_t flags, struct wally_tx **output)
+{
+    const unsigned char *p = bytes, *end = bytes + bytes_len;
+    unsigned char script[COMPACT_SCRIPT_MAX_LEN];
+    bool use_witness;
+    uint32_t version;
+    uint64_t v, num_witnesses;
+    size_t i, j, n, offset;
+    struct wally_tx *result = NULL;
+    int ret = WALLY_EINVAL;
+
+    TX_CHECK_OUTPUT;
+
+    if (!bytes || !bytes_len || flags || (*p & ~COMPACT_FLAG_WITNESS) ||
+        wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len))
+        return WALLY_EINVAL;
+    use_witness = *p++ & COMPACT_FLAG_WITNESS;
+
+#define ensure_n(n) if (p > end || (size_t)(end - p) < (n)) { ret = WALLY_EINVAL; goto fail; }
+
+#define ensure_varint(dst) \
+    if (!(n = varint128_from_bytes(p, end, (dst)))) { ret = WALLY_EINVAL; goto fail; } \
+    p += n
+
+#define ensure_uint32(dst) ensure_varint(&v); \
+    if (v > UINT32_MAX) { ret = WALLY_EINVAL; goto fail; } \
+    dst = (uint32_t)v
+
+/* Reject counts that can't fit in the remaining bytes before allocating */
+#define ensure_count(n, min_len) \
+    if ((n) > (uint64_t)(end - p) / (min_len)) { ret = WALLY_EINVAL; goto fail; }
+
+    ensure_uint32(version);
+    ensure_varint(&v);
+    ensure_count(v, WALLY_TXHASH_LEN + 3);
+    ret = wally_tx_init_alloc(version, 0, v, 0, output);
+    if (ret != WALLY_OK)
+        return ret;
+    result = *output;
+
+    for (i = 0; i < result->inputs_allocation_len; ++i) {
+        const unsigned char *txhash = p;
+        uint32_t index, sequence;
+        ensure_n(WALLY_TXHASH_LEN);
+        p += WALLY_TXHASH_LEN;
+        ensure_uint32(index);
+        ensure_uint32(sequence);
+        ensure_varint(&v);
+        ensure_n(v);
+        ret = tx_elements_input_init(txhash, WALLY_TXHASH_LEN, index - 1, ~sequence,
+                                     v ? p : NULL, v, NULL,
+                                     NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                     NULL, 0, NULL, 0, NULL, &result->inputs[i], false);
+        if (ret != WALLY_OK)
+            goto fail;
+        p += v;
+        result->num_inputs += 1;
+    }
+
+    ensure_varint(&v);
+    ensure_count(v, 2);
+    ret = wally_tx_reserve(result, 0, v);
+    if (ret != WALLY_OK)
+        goto fail;
+
+    for (i = 0; i < result->outputs_allocation_len; ++i) {
+        const unsigned char *script_p = p;
+        uint64_t satoshi;
+        ensure_varint(&v);
+        if (!satoshi_decompress(v, &satoshi)) {
+            ret = WALLY_EINVAL;
+            goto fail;
+        }
+        ensure_varint(&v);
+        if (v < NUM_COMPACT_SCRIPTS) {
+            const struct compact_script *t = COMPACT_SCRIPTS + v;
+            ensure_n(t->hash_len);
+            memcpy(script, t->prefix, t->prefix_len);
+            memcpy(script + t->prefix_len, p, t->hash_len);
+            memcpy(script + t->prefix_len + t->hash_len, t->suffix, t->suffix_len);
+            p += t->hash_len;
+            script_p = script;
+            v = t->prefix_len + t->hash_len + t->suffix_len;
+        } else {
+            v -= NUM_COMPACT_SCRIPTS;
+            ensure_n(v);
+            script_p = p;
+            p += v;
+        }
+        ret = tx_elements_output_init(satoshi, v ? script_p : NULL, v,
+                                      NULL, 0, NULL, 0, NULL, 0, NULL, 0, NULL, 0,
+                                      &result->outputs[i], false);
+        if (ret != WALLY_OK)
+            goto fail;
+        result->num_outputs += 1;
+    }
+
+    for (i = 0; use_witness && i < result->num_inputs; ++i) {
+        const unsigned char *witness_start = p;
+        ensure_n(sizeof(uint8_t));
+        ensure_n(varint_length_from_bytes(p));
+        p += varint_from_bytes(p, &num_witnesses);
+        if (!num_witnesses)
+            continue;
+        ensure_count(num_witnesses, 1);
+        if (wally_exceeds_input_limit(WALLY_LIMIT_TX_WITNESS_ITEMS, num_witnesses)) {
+            ret = WALLY_EINVAL;
+            goto fail;
+        }
+        for (j = 0; j < num_witnesses; ++j) {
+            ensure_n(sizeof(uint8_t));
+            ensure_n(varint_length_from_bytes(p));
+            p += varint_from_bytes(p, &v);
+            ensure_n(v);
+            p += v;
+        }
+        ret = witness_stack_from_bytes(witness_start, &result->inputs[i].witness, &offset);
+        if (ret != WALLY_OK)
+            goto fail;
+    }
+
+    ensure_uint32(result->locktime);
+    if (p != end) {
+        ret = WALLY_EINVAL; /* Trailing bytes */
+        goto fail;
+    }
+
+#undef ensure_n
+#undef ensure_varint
+#undef ensure_uint32
+#undef ensure_count
+
+    return WALLY_OK;
+fail:
+    tx_free(result, true);
+    *output = NULL;
+    return ret;
+}
+
+/* Hash the txid or wtxid ranges of a transaction analyzed by analyze_tx */
+static void tx_get_id_from_offsets(const unsigned char *bytes,
+                                   const struct tx_offsets *offsets,
+                                   bool expect_witnesses, bool is_elements,
+                                   bool with_witness, unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+
+    sha256_init(&ctx);
+    if (with_witness || !expect_witnesses)
+        sha256_update(&ctx, bytes, offsets->end);
+    else {
+        /* Hash the non-witness ranges of the serialization */
+        const size_t start = sizeof(uint32_t) + (is_elements ? 1 : 2);
+        sha256_update(&ctx, bytes, sizeof(uint32_t));
+        if (is_elements)
+            sha256_u8(&ctx, 0); /* Witness flag */
+        sha256_update(&ctx, bytes + start, offsets->outputs_end - start);
+        sha256_update(&ctx, bytes + offsets->locktime, sizeof(uint32_t));
+    }
+    sha256d_done(&ctx, bytes_out);
+}
+
+static int tx_get_id_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                uint32_t flags, bool with_witness,
+                                unsigned char *bytes_out, size_t len)
+{
+    struct tx_offsets offsets;
+    size_t num_inputs, num_outputs;
+    bool expect_witnesses;
+    const bool is_elements = flags & WALLY_TX_FLAG_USE_ELEMENTS;
+
+    if (!bytes_out || len != WALLY_TXHASH_LEN || (with_witness && is_elements) ||
+        analyze_tx(bytes, bytes_len, flags, &num_inputs, &num_outputs,
+                   &expect_witnesses, &offsets) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    tx_get_id_from_offsets(bytes, &offsets, expect_witnesses, is_elements,
+                           with_witness, bytes_out);
+    return WALLY_OK;
+}
+
+int wally_tx_get_txid_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                 uint32_t flags, unsigned char *bytes_out,
+                                 size_t len)
+{
+    return tx_get_id_from_bytes(bytes, bytes_len, flags, false, bytes_out, len);
+}
+
+int wally_tx_get_wtxid_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                  uint32_t flags, unsigned char *bytes_out,
+                                  size_t len)
+{
+    return tx_get_id_from_bytes(bytes, bytes_len, flags, true, bytes_out, len);
+}
+
+/* Classify the output scripts of a transaction analyzed by analyze_tx */
+static void tx_get_output_script_types_from_offsets(const unsigned char *bytes,
+                                                    const struct tx_offsets *offsets,
+                                                    size_t num_outputs,
+                                                    bool is_elements,
+                                                    unsigned char *bytes_out)
+{
+    const unsigned char *p = bytes + offsets->outputs;
+    uint64_t v;
+    size_t i;
+
+    p += varint_from_bytes(p, &v); /* Output count */
+    for (i = 0; i < num_outputs; ++i) {
+        if (is_elements) {
+            p += confidential_asset_length_from_bytes(p);
+            p += confidential_value_length_from_bytes(p);
+            p += confidential_nonce_length_from_bytes(p);
+        } else
+            p += sizeof(uint64_t);
+        p += varint_from_bytes(p, &v);
+        bytes_out[i] = scriptpubkey_get_type(p, v);
+        p += v;
+    }
+}
+
+int wally_tx_get_output_script_types(const struct wally_tx *tx,
+                                     unsigned char *bytes_out, size_t len,
+                                     size_t *written)
+{
+    size_t i;
+
+    if (written)
+        *written = 0;
+
+    if (!is_valid_tx(tx) || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    *written = tx->num_outputs;
+    if (len < tx->num_outputs)
+        return WALLY_OK; /* Not enough room in output */
+
+    for (i = 0; i < tx->num_outputs; ++i)
+        bytes_out[i] = scriptpubkey_get_type(tx->outputs[i].script,
+                                             tx->outputs[i].script_len);
+    return WALLY_OK;
+}
+
+int wally_tx_get_output_script_types_from_bytes(const unsigned char *bytes,
+                                                size_t bytes_len, uint32_t flags,
+                                                unsigned char *bytes_out,
+                                                size_t len, size_t *written)
+{
+    struct tx_offsets offsets;
+    size_t num_inputs, num_outputs;
+    bool expect_witnesses;
+
+    if (written)
+        *written = 0;
+
+    if (!bytes_out || !written ||
+        analyze_tx(bytes, bytes_len, flags, &num_inputs, &num_outputs,
+                   &expect_witnesses, &offsets) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    *written = num_outputs;
+    if (len >= num_outputs)
+        tx_get_output_script_types_from_offsets(bytes, &offsets, num_outputs,
+                                                flags & WALLY_TX_FLAG_USE_ELEMENTS,
+                                                bytes_out);
+    return WALLY_OK;
+}
+
+int wally_block_header_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                  struct wally_block_header *output)
+{
+    const unsigned char *p = bytes;
+
+    if (!bytes || bytes_len < WALLY_BLOCK_HEADER_LEN || !output)
+        return WALLY_EINVAL;
+
+    p += uint32_from_le_bytes(p, &output->version);
+    memcpy(output->prev_block_hash, p, SHA256_LEN);
+    p += SHA256_LEN;
+    memcpy(output->merkle_root, p, SHA256_LEN);
+    p += SHA256_LEN;
+    p += uint32_from_le_bytes(p, &output->timestamp);
+    p += uint32_from_le_bytes(p, &output->bits);
+    uint32_from_le_bytes(p, &output->nonce);
+    return WALLY_OK;
+}
+
+int wally_block_get_hash(const unsigned char *bytes, size_t bytes_len,
+                         unsigned char *bytes_out, size_t len)
+{
+    if (!bytes || bytes_len < WALLY_BLOCK_HEADER_LEN)
+        return WALLY_EINVAL;
+    return wally_sha256d(bytes, WALLY_BLOCK_HEADER_LEN, bytes_out, len);
+}
+
+/* The number of headers hashed together by sha256d_batch */
+#define HEADER_BATCH 16u
+
+/* Check a little endian block hash against the compact target in bits */
+static bool block_hash_meets_target(const unsigned char *hash, uint32_t bits)
+{
+    unsigned char target[SHA256_LEN];
+    const uint32_t mantissa = bits & 0x7fffff;
+    const int exponent = (int)(bits >> 24);
+    int i, pos;
+
+    if (!mantissa || (bits & 0x800000))
+        return false; /* Zero or negative targets can't be met */
+
+    memset(target, 0, sizeof(target));
+    for (i = 0; i < 3; ++i) {
+        const unsigned char byte = (mantissa >> (8 * i)) & 0xff;
+        pos = exponent - 3 + i;
+        if (pos >= (int)sizeof(target)) {
+            if (byte)
+                return false; /* Overflow */
+        } else if (pos >= 0)
+            target[pos] = byte;
+    }
+
+    for (i = SHA256_LEN - 1; i >= 0; --i)
+        if (hash[i] != target[i])
+            return hash[i] < target[i];
+    return true;
+}
+
+int wally_block_header_verify_chain(const unsigned char *bytes, size_t bytes_len,
+                                    const unsigned char *prev_hash, size_t prev_hash_len,
+                                    uint32_t flags,
+                                    unsigned char *bytes_out, size_t len,
+                                    size_t *written)
+{
+    struct sha256 hashes[HEADER_BATCH];
+    unsigned char last[SHA256_LEN];
+    const unsigned char *prev = prev_hash;
+    size_t num_headers, i, j, n;
+    uint32_t bits;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+    if (!bytes || !bytes_len || bytes_len % WALLY_BLOCK_HEADER_LEN ||
+        BYTES_INVALID_N(prev_hash, prev_hash_len, SHA256_LEN) || flags ||
+        BYTES_INVALID_N(bytes_out, len, SHA256_LEN) || !written)
+        return WALLY_EINVAL;
+
+    num_headers = bytes_len / WALLY_BLOCK_HEADER_LEN;
+    for (i = 0; i < num_headers && ret == WALLY_OK; i += n) {
+        const unsigned char *p = bytes + i * WALLY_BLOCK_HEADER_LEN;
+        n = num_headers - i < HEADER_BATCH ? num_headers - i : HEADER_BATCH;
+        /* Hash several headers at once, using multiple lanes if available */
+        sha256d_batch(hashes, p, WALLY_BLOCK_HEADER_LEN, n);
+        for (j = 0; j < n; ++j, p += WALLY_BLOCK_HEADER_LEN) {
+            uint32_from_le_bytes(p + 72, &bits);
+            if ((prev && memcmp(p + 4, prev, SHA256_LEN)) ||
+                !block_hash_meets_target(hashes[j].u.u8, bits)) {
+                ret = WALLY_EINVAL;
+                break;
+            }
+            ++*written;
+            prev = hashes[j].u.u8;
+        }
+        /* The next batch overwrites hashes, so keep the last one */
+        memcpy(last, hashes[n - 1].u.u8, SHA256_LEN);
+        prev = last;
+    }
+    if (ret == WALLY_OK && bytes_out)
+        memcpy(bytes_out, last, SHA256_LEN);
+    return ret;
+}
+
+int wally_block_iterator_init(const unsigned char *bytes, size_t bytes_len,
+                              uint32_t flags, struct wally_block_iterator *output)
+{
+    const unsigned char *p = bytes + WALLY_BLOCK_HEADER_LEN;
+    uint64_t num_txs;
+
+    if (output)
+        wally_clear(output, sizeof(*output));
+
+    /* Elements blocks are not supported yet */
+    if (!bytes || bytes_len <= WALLY_BLOCK_HEADER_LEN || flags || !output ||
+        varint_length_from_bytes(p) > bytes_len - WALLY_BLOCK_HEADER_LEN)
+        return WALLY_EINVAL;
+
+    p += varint_from_bytes(p, &num_txs);
+    if (!num_txs || num_txs > bytes_len)
+        return WALLY_EINVAL;
+
+    output->bytes = bytes;
+    output->bytes_len = bytes_len;
+    output->offset = p - bytes;
+    output->num_txs = num_txs;
+    output->index = 0;
+    return WALLY_OK;
+}
+
+/* Advance a block iterator, returning the layout of the next transaction.
+ * tx_bytes is set to NULL once all transactions have been returned */
+static int block_iterator_next_tx(struct wally_block_iterator *iter,
+                                  const unsigned char **tx_bytes,
+                                  struct tx_offsets *offsets,
+                                  size_t *num_inputs, size_t *num_outputs,
+                                  bool *expect_witnesses)
+{
+    *tx_bytes = NULL;
+    if (iter->index == iter->num_txs) {
+        /* Iteration is complete: the block must not have trailing data */
+        return iter->offset == iter->bytes_len ? WALLY_OK : WALLY_EINVAL;
+    }
+
+    if (analyze_tx(iter->bytes + iter->offset, iter->bytes_len - iter->offset, 0,
+                   num_inputs, num_outputs, expect_witnesses,
+                   offsets) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    *tx_bytes = iter->bytes + iter->offset;
+    iter->offset += offsets->end;
+    iter->index += 1;
+    return WALLY_OK;
+}
+
+int wally_block_iterator_next(struct wally_block_iterator *iter,
+                              const unsigned char **tx_bytes, size_t *tx_bytes_len,
+                              unsigned char *bytes_out, size_t len)
+{
+    struct tx_offsets offsets;
+    size_t num_inputs, num_outputs;
+    bool expect_witnesses;
+    int ret;
+
+    if (tx_bytes)
+        *tx_bytes = NULL;
+    if (tx_bytes_len)
+        *tx_bytes_len = 0;
+
+    if (!iter || !iter->bytes || iter->offset > iter->bytes_len ||
+        !tx_bytes || !tx_bytes_len || BYTES_INVALID_N(bytes_out, len, SHA256_LEN))
+        return WALLY_EINVAL;
+
+    ret = block_iterator_next_tx(iter, tx_bytes, &offsets, &num_inputs,
+                                 &num_outputs, &expect_witnesses);
+    if (ret != WALLY_OK || !*tx_bytes)
+        return ret;
+
+    *tx_bytes_len = offsets.end;
+    if (bytes_out)
+        tx_get_id_from_offsets(*tx_bytes, &offsets, expect_witnesses, false,
+                               false, bytes_out);
+    return WALLY_OK;
+}
+
+/* The minimum number of transaction bytes hashed by each txid task */
+#define BLOCK_TXIDS_TASK_BYTES 32768u
+
+/* The layout of each transaction and the range hashed by each task */
+struct block_txids_tasks {
+    const unsigned char **txs;
+    struct tx_offsets *offsets;
+    bool *expect_witnesses;
+    size_t *task_starts; /* The first tx of each task, then num_txs */
+    bool with_witness;
+    size_t num_txs;
+    unsigned char *bytes_out;
+};
+
+static void block_txids_task(void *task_ctx, size_t index)
+{
+    const struct block_txids_tasks *t = task_ctx;
+    unsigned char *wtxids = t->bytes_out + t->num_txs * WALLY_TXHASH_LEN;
+    size_t i;
+
+    for (i = t->task_starts[index]; i < t->task_starts[index + 1]; ++i) {
+        unsigned char *txid = t->bytes_out + i * WALLY_TXHASH_LEN;
+        tx_get_id_from_offsets(t->txs[i], t->offsets + i, t->expect_witnesses[i],
+                               false, false, txid);
+        if (!t->with_witness)
+            continue;
+        if (t->expect_witnesses[i])
+            tx_get_id_from_offsets(t->txs[i], t->offsets + i, true, false, true,
+                                   wtxids + i * WALLY_TXHASH_LEN);
+        else
+            memcpy(wtxids + i * WALLY_TXHASH_LEN, txid, WALLY_TXHASH_LEN);
+    }
+}
+
+int wally_block_get_txids(const unsigned char *bytes, size_t bytes_len,
+                          uint32_t flags,
+                          wally_run_tasks_t run_fn, void *run_ctx,
+                          unsigned char *merkle_root_out, size_t merkle_root_len,
+                          unsigned char *bytes_out, size_t len,
+                          size_t *written)
+{
+    struct wally_block_iterator iter;
+    struct block_txids_tasks t;
+    const unsigned char *tx_bytes;
+    size_t num_inputs, num_outputs, num_tasks = 0, task_bytes = 0;
+    size_t hashes_len, alloc_len, i;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if ((flags & ~WALLY_TX_FLAG_USE_WITNESS) || !bytes_out || !written ||
+        BYTES_INVALID_N(merkle_root_out, merkle_root_len, SHA256_LEN))
+        return WALLY_EINVAL;
+
+    ret = wally_block_iterator_init(bytes, bytes_len, 0, &iter);
+    if (ret != WALLY_OK)
+        return ret;
+    t.with_witness = flags & WALLY_TX_FLAG_USE_WITNESS;
+    t.num_txs = iter.num_txs;
+    t.bytes_out = bytes_out;
+    hashes_len = iter.num_txs * WALLY_TXHASH_LEN * (t.with_witness ? 2 : 1);
+    if (len < hashes_len) {
+        *written = hashes_len;
+        return WALLY_OK; /* Tell the caller how much room is required */
+    }
+
+    /* Allocate the per-transaction layouts in order of alignment */
+    alloc_len = iter.num_txs * (sizeof(*t.offsets) + sizeof(*t.task_starts) +
+                                sizeof(*t.txs) + sizeof(*t.expect_witnesses)) +
+                sizeof(*t.task_starts);
+    if (!(t.offsets = wally_malloc(alloc_len)))
+        return WALLY_ENOMEM;
+    t.task_starts = (size_t *)(t.offsets + iter.num_txs);
+    t.txs = (const unsigned char **)(t.task_starts + iter.num_txs + 1);
+    t.expect_witnesses = (bool *)(t.txs + iter.num_txs);
+
+    /* Find the transactions serially, splitting them into byte ranges of
+     * at least BLOCK_TXIDS_TASK_BYTES to be hashed concurrently */
+    for (i = 0; i < iter.num_txs && ret == WALLY_OK; ++i) {
+        ret = block_iterator_next_tx(&iter, &tx_bytes, t.offsets + i, &num_inputs,
+                                     &num_outputs, t.expect_witnesses + i);
+        if (ret == WALLY_OK && !tx_bytes)
+            ret = WALLY_EINVAL;
+        if (ret == WALLY_OK) {
+            t.txs[i] = tx_bytes;
+            if (!task_bytes)
+                t.task_starts[num_tasks++] = i;
+            task_bytes += t.offsets[i].end;
+            if (task_bytes >= BLOCK_TXIDS_TASK_BYTES)
+                task_bytes = 0;
+        }
+    }
+    if (ret == WALLY_OK) {
+        /* Check the block has no trailing data */
+        ret = block_iterator_next_tx(&iter, &tx_bytes, t.offsets, &num_inputs,
+                                     &num_outputs, t.expect_witnesses);
+    }
+    if (ret != WALLY_OK)
+        goto cleanup;
+    t.task_starts[num_tasks] = iter.num_txs;
+
+    wally_run_tasks(run_fn, run_ctx, num_tasks, block_txids_task, &t);
+
+    if (merkle_root_out)
+        ret = wally_merkle_root(bytes_out, iter.num_txs * WALLY_TXHASH_LEN,
+                                merkle_root_out, merkle_root_len);
+    if (ret == WALLY_OK)
+        *written = hashes_len;
+    else
+        wally_clear(bytes_out, hashes_len);
+
+cleanup:
+    wally_free(t.offsets);
+    return ret;
+}
+
+int wally_bip152_short_id_key(const unsigned char *bytes, size_t bytes_len,
+                              uint64_t nonce,
+                              unsigned char *bytes_out, size_t len)
+{
+    struct sha256_ctx ctx;
+    struct sha256 sha;
+
+    if (!bytes || bytes_len < WALLY_BLOCK_HEADER_LEN ||
+        !bytes_out || len != WALLY_SIPHASH_KEY_LEN)
+        return WALLY_EINVAL;
+
+    /* The key is the first 16 bytes of SHA256(header || nonce) */
+    sha256_init(&ctx);
+    sha256_update(&ctx, bytes, WALLY_BLOCK_HEADER_LEN);
+    sha256_le64(&ctx, nonce);
+    sha256_done(&ctx, &sha);
+    memcpy(bytes_out, sha.u.u8, WALLY_SIPHASH_KEY_LEN);
+    wally_clear_2(&ctx, sizeof(ctx), &sha, sizeof(sha));
+    return WALLY_OK;
+}
+
+/* Compute the 48 bit short id of a txid or wtxid */
+static uint64_t bip152_short_id(uint64_t k0, uint64_t k1, const unsigned char *hash)
+{
+    return siphash24_impl(k0, k1, hash, WALLY_TXHASH_LEN) & 0xffffffffffffull;
+}
+
+static void bip152_short_id_to_bytes(uint64_t id, unsigned char *bytes_out)
+{
+    size_t i;
+    for (i = 0; i < WALLY_BIP152_SHORT_ID_LEN; ++i)
+        bytes_out[i] = (id >> (8 * i)) & 0xff;
+}
+
+static uint64_t bip152_short_id_from_bytes(const unsigned char *bytes)
+{
+    uint64_t id = 0;
+    size_t i;
+    for (i = 0; i < WALLY_BIP152_SHORT_ID_LEN; ++i)
+        id |= (uint64_t)bytes[i] << (8 * i);
+    return id;
+}
+
+static void bip152_key_from_bytes(const unsigned char *key, uint64_t *k0, uint64_t *k1)
+{
+    uint32_t lo, hi;
+    uint32_from_le_bytes(key, &lo);
+    uint32_from_le_bytes(key + 4, &hi);
+    *k0 = (uint64_t)hi << 32 | lo;
+    uint32_from_le_bytes(key + 8, &lo);
+    uint32_from_le_bytes(key + 12, &hi);
+    *k1 = (uint64_t)hi << 32 | lo;
+}
+
+int wally_bip152_short_ids(const unsigned char *key, size_t key_len,
+                           const unsigned char *bytes, size_t bytes_len,
+                           unsigned char *bytes_out, size_t len)
+{
+    const size_t num_hashes = bytes_len / WALLY_TXHASH_LEN;
+    uint64_t k0, k1;
+    size_t i;
+
+    if (!key || key_len != WALLY_SIPHASH_KEY_LEN ||
+        !bytes || !bytes_len || bytes_len % WALLY_TXHASH_LEN ||
+        !bytes_out || len != num_hashes * WALLY_BIP152_SHORT_ID_LEN)
+        return WALLY_EINVAL;
+
+    bip152_key_from_bytes(key, &k0, &k1);
+    for (i = 0; i < num_hashes; ++i)
+        bip152_short_id_to_bytes(bip152_short_id(k0, k1, bytes + i * WALLY_TXHASH_LEN),
+                                 bytes_out + i * WALLY_BIP152_SHORT_ID_LEN);
+    return WALLY_OK;
+}
+
+int wally_block_get_short_ids(const unsigned char *bytes, size_t bytes_len,
+                              uint64_t nonce, uint32_t flags,
+                              unsigned char *bytes_out, size_t len,
+                              size_t *written)
+{
+    struct wally_block_iterator iter;
+    unsigned char key[WALLY_SIPHASH_KEY_LEN], hash[WALLY_TXHASH_LEN];
+    const bool use_witness = flags & WALLY_TX_FLAG_USE_WITNESS;
+    const unsigned char *tx_bytes;
+    size_t tx_bytes_len, i;
+    uint64_t k0, k1;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if ((flags & ~WALLY_TX_FLAG_USE_WITNESS) || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    ret = wally_block_iterator_init(bytes, bytes_len, 0, &iter);
+    if (ret != WALLY_OK)
+        return ret;
+    if (iter.num_txs > len / WALLY_BIP152_SHORT_ID_LEN) {
+        *written = iter.num_txs * WALLY_BIP152_SHORT_ID_LEN;
+        return WALLY_OK; /* Tell the caller how much room is required */
+    }
+
+    wally_bip152_short_id_key(bytes, bytes_len, nonce, key, sizeof(key));
+    bip152_key_from_bytes(key, &k0, &k1);
+    for (i = 0; i < iter.num_txs && ret == WALLY_OK; ++i) {
+        ret = wally_block_iterator_next(&iter, &tx_bytes, &tx_bytes_len,
+                                        use_witness ? NULL : hash,
+                                        use_witness ? 0 : sizeof(hash));
+        if (ret == WALLY_OK && use_witness)
+            ret = tx_get_id_from_bytes(tx_bytes, tx_bytes_len, 0, true,
+                                       hash, sizeof(hash));
+        if (ret == WALLY_OK)
+            bip152_short_id_to_bytes(bip152_short_id(k0, k1, hash),
+                                     bytes_out + i * WALLY_BIP152_SHORT_ID_LEN);
+    }
+    if (ret == WALLY_OK) {
+        /* Check the block has no trailing data */
+        ret = wally_block_iterator_next(&iter, &tx_bytes, &tx_bytes_len, NULL, 0);
+    }
+    if (ret == WALLY_OK)
+        *written = iter.num_txs * WALLY_BIP152_SHORT_ID_LEN;
+    wally_clear(key, sizeof(key));
+    return ret;
+}
+
+struct bip152_entry {
+    uint64_t id;
+    uint32_t index;
+};
+
+static int bip152_entry_cmp(const void *lhs, const void *rhs)
+{
+    const uint64_t l = ((const struct bip152_entry *)lhs)->id;
+    const uint64_t r = ((const struct bip152_entry *)rhs)->id;
+    return l < r ? -1 : l > r;
+}
+
+int wally_bip152_short_ids_match(const unsigned char *key, size_t key_len,
+                                 const unsigned char *short_ids, size_t short_ids_len,
+                                 const unsigned char *bytes, size_t bytes_len,
+                                 uint32_t *indices_out, size_t len,
+                                 size_t *written)
+{
+    const size_t num_ids = short_ids_len / WALLY_BIP152_SHORT_ID_LEN;
+    const size_t num_hashes = bytes_len / WALLY_TXHASH_LEN;
+    struct bip152_entry *entries = NULL, *found, target;
+    uint64_t k0, k1;
+    size_t i;
+
+    if (written)
+        *written = 0;
+    if (!key || key_len != WALLY_SIPHASH_KEY_LEN ||
+        !short_ids || !short_ids_len || short_ids_len % WALLY_BIP152_SHORT_ID_LEN ||
+        BYTES_INVALID(bytes, bytes_len) || bytes_len % WALLY_TXHASH_LEN ||
+        num_hashes >= WALLY_BIP152_NO_MATCH ||
+        !indices_out || len != num_ids || !written)
+        return WALLY_EINVAL;
+
+    if (num_hashes) {
+        entries = wally_malloc(num_hashes * sizeof(*entries));
+        if (!entries)
+            return WALLY_ENOMEM;
+        bip152_key_from_bytes(key, &k0, &k1);
+        for (i = 0; i < num_hashes; ++i) {
+            entries[i].id = bip152_short_id(k0, k1, bytes + i * WALLY_TXHASH_LEN);
+            entries[i].index = (uint32_t)i;
+        }
+        qsort(entries, num_hashes, sizeof(*entries), bip152_entry_cmp);
+    }
+
+    for (i = 0; i < num_ids; ++i) {
+        indices_out[i] = WALLY_BIP152_NO_MATCH;
+        if (!entries)
+            continue;
+        target.id = bip152_short_id_from_bytes(short_ids + i * WALLY_BIP152_SHORT_ID_LEN);
+        found = bsearch(&target, entries, num_hashes, sizeof(*entries), bip152_entry_cmp);
+        if (!found ||
+            (found > entries && found[-1].id == target.id) ||
+            (found < entries + num_hashes - 1 && found[1].id == target.id))
+            continue; /* Not found, or ambiguous */
+        indices_out[i] = found->index;
+        ++*written;
+    }
+    wally_free(entries);
+    return WALLY_OK;
+}
+
+/*
+ * BIP 158 compact block filters: a Golomb-Rice coded set of item hashes
+ */
+#define BIP158_P 19u /* Golomb-Rice parameter */
+#define BIP158_M 784931ull /* Inverse false positive rate */
+
+struct gcs_item {
+    const unsigned char *bytes;
+    size_t len;
+};
+
+struct gcs_writer {
+    unsigned char *p;
+    uint64_t acc;
+    unsigned int num_bits;
+};
+
+struct gcs_reader {
+    const unsigned char *p, *end;
+    uint64_t acc;
+    unsigned int num_bits;
+};
+
+static int gcs_item_cmp(const void *lhs, const void *rhs)
+{
+    const struct gcs_item *l = lhs, *r = rhs;
+    const int cmp = memcmp(l->bytes, r->bytes, l->len < r->len ? l->len : r->len);
+    return cmp ? cmp : (l->len > r->len) - (l->len < r->len);
+}
+
+static int gcs_value_cmp(const void *lhs, const void *rhs)
+{
+    const uint64_t l = *(const uint64_t *)lhs, r = *(const uint64_t *)rhs;
+    return l < r ? -1 : l > r;
+}
+
+/* Return the high 64 bits of a 64 by 64 bit multiplication */
+static uint64_t mul_hi64(uint64_t a, uint64_t b)
+{
+    const uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    const uint64_t hi_lo = a_hi * b_lo;
+    const uint64_t cross = ((a_lo * b_lo) >> 32) + (hi_lo & 0xffffffff) + a_lo * b_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+/* Hash an item uniformly into the range [0, n * M) */
+static uint64_t gcs_hash_to_range(uint64_t k0, uint64_t k1,
+                                  const unsigned char *bytes, size_t bytes_len,
+                                  uint64_t range)
+{
+    return mul_hi64(siphash24_impl(k0, k1, bytes, bytes_len), range);
+}
+
+/* Write up to 32 bits, most significant first */
+static void gcs_write_bits(struct gcs_writer *w, uint64_t v, unsigned int n)
+{
+    w->acc = (w->acc << n) | (v & ((1ull << n) - 1));
+    w->num_bits += n;
+    while (w->num_bits >= 8) {
+        w->num_bits -= 8;
+        *w->p++ = (w->acc >> w->num_bits) & 0xff;
+    }
+}
+
+static void gcs_write_delta(struct gcs_writer *w, uint64_t delta)
+{
+    uint64_t q = delta >> BIP158_P;
+
+    /* The quotient in unary, terminated by a zero bit */
+    for (; q >= 31; q -= 31)
+        gcs_write_bits(w, 0x7fffffff, 31);
+    gcs_write_bits(w, ((1ull << q) - 1) << 1, (unsigned int)q + 1);
+    gcs_write_bits(w, delta, BIP158_P);
+}
+
+/* Read up to 32 bits, most significant first */
+static bool gcs_read_bits(struct gcs_reader *r, unsigned int n, uint64_t *v)
+{
+    while (r->num_bits < n) {
+        if (r->p == r->end)
+            return false;
+        r->acc = (r->acc << 8) | *r->p++;
+        r->num_bits += 8;
+    }
+    r->num_bits -= n;
+    *v = (r->acc >> r->num_bits) & ((1ull << n) - 1);
+    return true;
+}
+
+static bool gcs_read_delta(struct gcs_reader *r, uint64_t *delta)
+{
+    uint64_t q = 0, bit;
+
+    for (;;) {
+        if (!gcs_read_bits(r, 1, &bit))
+            return false;
+        if (!bit)
+            break;
+        ++q;
+    }
+    if (!gcs_read_bits(r, BIP158_P, delta))
+        return false;
+    *delta |= q << BIP158_P;
+    return true;
+}
+
+static void bip158_key_from_block_hash(const unsigned char *block_hash,
+                                       uint64_t *k0, uint64_t *k1)
+{
+    /* The key is the first 16 bytes of the block hash */
+    bip152_key_from_bytes(block_hash, k0, k1);
+}
+
+/* Build a filter from items, which are sorted and de-duplicated in place */
+static int gcs_build(const unsigned char *block_hash,
+                     struct gcs_item *items, size_t num_items,
+                     unsigned char *bytes_out, size_t len, size_t *written)
+{
+    struct gcs_writer w;
+    uint64_t *values, k0, k1, range, prev = 0;
+    size_t i, n = 0, num_bits = 0, required;
+
+    if (num_items) {
+        /* The filter is of the set of distinct items */
+        qsort(items, num_items, sizeof(*items), gcs_item_cmp);
+        for (i = 0; i < num_items; ++i)
+            if (!n || gcs_item_cmp(&items[n - 1], &items[i]))
+                items[n++] = items[i];
+    }
+
+    if (!(values = wally_malloc((n ? n : 1) * sizeof(*values))))
+        return WALLY_ENOMEM;
+    bip158_key_from_block_hash(block_hash, &k0, &k1);
+    range = (uint64_t)n * BIP158_M;
+    for (i = 0; i < n; ++i)
+        values[i] = gcs_hash_to_range(k0, k1, items[i].bytes, items[i].len, range);
+    qsort(values, n, sizeof(*values), gcs_value_cmp);
+
+    for (i = 0; i < n; ++i) {
+        num_bits += ((values[i] - prev) >> BIP158_P) + 1 + BIP158_P;
+        prev = values[i];
+    }
+    required = varint_get_length(n) + (num_bits + 7) / 8;
+    *written = required;
+    if (required <= len) {
+        w.p = bytes_out + varint_to_bytes(n, bytes_out);
+        w.acc = 0;
+        w.num_bits = 0;
+        for (i = 0, prev = 0; i < n; ++i) {
+            gcs_write_delta(&w, values[i] - prev);
+            prev = values[i];
+        }
+        if (w.num_bits)
+            gcs_write_bits(&w, 0, 8 - w.num_bits); /* Pad the final byte */
+    }
+    wally_free(values);
+    return WALLY_OK;
+}
+
+/* Convert a list of concatenated scripts into filter items */
+static int gcs_items_from_scripts(const unsigned char *bytes, size_t bytes_len,
+                                  const uint32_t *lens, size_t lens_len,
+                                  struct gcs_item **items)
+{
+    size_t i, offset = 0;
+
+    *items = NULL;
+    if (BYTES_INVALID(bytes, bytes_len) || BYTES_INVALID(lens, lens_len))
+        return WALLY_EINVAL;
+    for (i = 0; i < lens_len; ++i) {
+        if (!lens[i] || lens[i] > bytes_len - offset)
+            return WALLY_EINVAL;
+        offset += lens[i];
+    }
+    if (offset != bytes_len)
+        return WALLY_EINVAL;
+
+    if (!(*items = wally_malloc((lens_len ? lens_len : 1) * sizeof(**items))))
+        return WALLY_ENOMEM;
+    for (i = 0, offset = 0; i < lens_len; offset += lens[i++]) {
+        (*items)[i].bytes = bytes + offset;
+        (*items)[i].len = lens[i];
+    }
+    return WALLY_OK;
+}
+
+int wally_bip158_filter_from_scripts(const unsigned char *block_hash, size_t block_hash_len,
+                                     const unsigned char *bytes, size_t bytes_len,
+                                     const uint32_t *lens, size_t lens_len,
+                                     unsigned char *bytes_out, size_t len,
+                                     size_t *written)
+{
+    struct gcs_item *items;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (!block_hash || block_hash_len != SHA256_LEN || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    ret = gcs_items_from_scripts(bytes, bytes_len, lens, lens_len, &items);
+    if (ret == WALLY_OK)
+        ret = gcs_build(block_hash, items, lens_len, bytes_out, len, written);
+    wally_free(items);
+    return ret;
+}
+
+/* Append a filter item, growing the item array as required */
+static int gcs_items_append(struct gcs_item **items, size_t *num_items,
+                            size_t *allocation_len,
+                            const unsigned char *bytes, size_t bytes_len)
+{
+    int ret = array_grow((void **)items, allocation_len,
+                         *num_items + 1, sizeof(**items));
+    if (ret == WALLY_OK) {
+        (*items)[*num_items].bytes = bytes;
+        (*items)[(*num_items)++].len = bytes_len;
+    }
+    return ret;
+}
+
+int wally_block_get_bip158_filter(const unsigned char *bytes, size_t bytes_len,
+                                  const unsigned char *prev_scripts, size_t prev_scripts_len,
+                                  const uint32_t *prev_lens, size_t prev_lens_len,
+                                  uint32_t flags,
+                                  unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    struct wally_block_iterator iter;
+    struct tx_offsets offsets;
+    struct gcs_item *items = NULL;
+    unsigned char block_hash[SHA256_LEN];
+    const unsigned char *tx_bytes, *p;
+    size_t num_items = 0, allocation_len = 0, num_prevouts = 0;
+    size_t num_inputs, num_outputs, i, offset = 0;
+    bool expect_witnesses;
+    uint64_t v;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (BYTES_INVALID(prev_scripts, prev_scripts_len) ||
+        BYTES_INVALID(prev_lens, prev_lens_len) ||
+        flags || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    ret = wally_block_iterator_init(bytes, bytes_len, 0, &iter);
+    if (ret != WALLY_OK)
+        return ret;
+
+    /* The scripts spent by each input after the coinbase, skipping empty ones */
+    for (i = 0; i < prev_lens_len && ret == WALLY_OK; offset += prev_lens[i++]) {
+        if (prev_lens[i] > prev_scripts_len - offset)
+            ret = WALLY_EINVAL;
+        else if (prev_lens[i])
+            ret = gcs_items_append(&items, &num_items, &allocation_len,
+                                   prev_scripts + offset, prev_lens[i]);
+    }
+    if (ret == WALLY_OK && offset != prev_scripts_len)
+        ret = WALLY_EINVAL;
+
+    /* Every output script, except empty and OP_RETURN scripts */
+    while (ret == WALLY_OK) {
+        ret = block_iterator_next_tx(&iter, &tx_bytes, &offsets, &num_inputs,
+                                     &num_outputs, &expect_witnesses);
+        if (ret != WALLY_OK || !tx_bytes)
+            break;
+        if (iter.index > 1)
+            num_prevouts += num_inputs;
+        p = tx_bytes + offsets.outputs;
+        p += varint_from_bytes(p, &v); /* Output count */
+        for (i = 0; i < num_outputs && ret == WALLY_OK; ++i) {
+            p += sizeof(uint64_t);
+            p += varint_from_bytes(p, &v);
+            if (v && *p != OP_RETURN)
+                ret = gcs_items_append(&items, &num_items, &allocation_len, p, v);
+            p += v;
+        }
+    }
+    if (ret == WALLY_OK && num_prevouts != prev_lens_len)
+        ret = WALLY_EINVAL; /* Wrong number of spent scripts given */
+
+    if (ret == WALLY_OK) {
+        wally_sha256d(bytes, WALLY_BLOCK_HEADER_LEN, block_hash, sizeof(block_hash));
+        ret = gcs_build(block_hash, items, num_items, bytes_out, len, written);
+    }
+    wally_free(items);
+    return ret;
+}
+
+int wally_bip158_filter_match(const unsigned char *block_hash, size_t block_hash_len,
+                              const unsigned char *filter, size_t filter_len,
+                              const unsigned char *bytes, size_t bytes_len,
+                              const uint32_t *lens, size_t lens_len,
+                              size_t *written)
+{
+    struct gcs_item *items;
+    struct gcs_reader r;
+    uint64_t *values = NULL, k0, k1, n, value = 0, delta;
+    size_t i, j = 0;
+    int ret;
+
+    if (written)
+        *written = 0;
+    if (!block_hash || block_hash_len != SHA256_LEN || !filter || !filter_len ||
+        varint_length_from_bytes(filter) > filter_len || !written)
+        return WALLY_EINVAL;
+
+    r.p = filter + varint_from_bytes(filter, &n);
+    r.end = filter + filter_len;
+    r.acc = 0;
+    r.num_bits = 0;
+    /* Each item takes at least P + 1 bits */
+    if (n > (uint64_t)(r.end - r.p) * 8 / (BIP158_P + 1))
+        return WALLY_EINVAL;
+
+    ret = gcs_items_from_scripts(bytes, bytes_len, lens, lens_len, &items);
+    if (ret == WALLY_OK && lens_len && !(values = wally_malloc(lens_len * sizeof(*values))))
+        ret = WALLY_ENOMEM;
+    if (ret != WALLY_OK || !lens_len || !n)
+        goto cleanup;
+
+    /* Hash and sort the scripts, then merge them with the decoded filter */
+    bip158_key_from_block_hash(block_hash, &k0, &k1);
+    for (i = 0; i < lens_len; ++i)
+        values[i] = gcs_hash_to_range(k0, k1, items[i].bytes, items[i].len,
+                                      n * BIP158_M);
+    qsort(values, lens_len, sizeof(*values), gcs_value_cmp);
+
+    for (i = 0; i < n && j < lens_len; ++i) {
+        if (!gcs_read_delta(&r, &delta)) {
+            ret = WALLY_EINVAL;
+            *written = 0;
+            break;
+        }
+        value += delta;
+        while (j < lens_len && values[j] < value)
+            ++j;
+        for (; j < lens_len && values[j] == value; ++j)
+            ++*written;
+    }
+
+cleanup:
+    wally_free(values);
+    wally_free(items);
+    return ret;
+}
+
+int wally_bip158_filter_header(const unsigned char *filter, size_t filter_len,
+                               const unsigned char *prev_header, size_t prev_header_len,
+                               unsigned char *bytes_out, size_t len)
+{
+    unsigned char buff[SHA256_LEN * 2];
+    int ret;
+
+    if (!filter || !filter_len || !prev_header || prev_header_len != SHA256_LEN ||
+        !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    ret = wally_sha256d(filter, filter_len, buff, SHA256_LEN);
+    if (ret == WALLY_OK) {
+        memcpy(buff + SHA256_LEN, prev_header, SHA256_LEN);
+        ret = wally_sha256d(buff, sizeof(buff), bytes_out, len);
+    }
+    wally_clear(buff, sizeof(buff));
+    return ret;
+}
+
+/* Hash a pair of merkle tree nodes into a parent node */
+static void merkle_hash_pair(const unsigned char *left, const unsigned char *right,
+                             unsigned char *bytes_out)
+{
+    unsigned char buff[SHA256_LEN * 2];
+    struct sha256 sha;
+
+    memcpy(buff, left, SHA256_LEN);
+    memcpy(buff + SHA256_LEN, right, SHA256_LEN);
+    sha256d_64(&sha, buff);
+    memcpy(bytes_out, sha.u.u8, SHA256_LEN);
+    wally_clear_2(buff, sizeof(buff), &sha, sizeof(sha));
+}
+
+/* Hash a level of n merkle tree nodes into its parent level, duplicating
+ * the last node when n is odd. dst may equal src and must be suitably
+ * aligned for a struct sha256. Returns the new level size */
+static size_t merkle_hash_level(const unsigned char *src, size_t n,
+                                unsigned char *dst)
+{
+    const size_t pairs = n / 2;
+
+    /* Adjacent nodes are contiguous 64 byte pairs: hash them together */
+    sha256d_batch((struct sha256 *)dst, src, SHA256_LEN * 2, pairs);
+    if (n & 1) {
+        const unsigned char *last = src + (n - 1) * SHA256_LEN;
+        merkle_hash_pair(last, last, dst + pairs * SHA256_LEN);
+    }
+    return (n + 1) / 2;
+}
+
+int wally_merkle_root(const unsigned char *bytes, size_t bytes_len,
+                      unsigned char *bytes_out, size_t len)
+{
+    unsigned char *nodes;
+    size_t n = bytes_len / SHA256_LEN;
+
+    if (!bytes || !bytes_len || bytes_len % SHA256_LEN ||
+        !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    if (n == 1) {
+        memcpy(bytes_out, bytes, SHA256_LEN);
+        return WALLY_OK;
+    }
+
+    /* Hash the first level into a working buffer, then the rest in place */
+    if (!(nodes = wally_malloc((n + 1) / 2 * SHA256_LEN)))
+        return WALLY_ENOMEM;
+    n = merkle_hash_level(bytes, n, nodes);
+    while (n > 1)
+        n = merkle_hash_level(nodes, n, nodes);
+    memcpy(bytes_out, nodes, SHA256_LEN);
+    wally_free(nodes);
+    return WALLY_OK;
+}
+
+int wally_merkle_branch(const unsigned char *bytes, size_t bytes_len,
+                        size_t index, unsigned char *bytes_out, size_t len,
+                        size_t *written)
+{
+    unsigned char *nodes;
+    size_t n = bytes_len / SHA256_LEN, depth = 0, i;
+
+    if (written)
+        *written = 0;
+
+    if (!bytes || !bytes_len || bytes_len % SHA256_LEN || index >= n ||
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    for (i = n; i > 1; i = (i + 1) / 2)
+        ++depth;
+    *written = depth * SHA256_LEN;
+    if (len < *written || !depth)
+        return WALLY_OK; /* Tell the caller the required length */
+
+    if (!(nodes = wally_malloc(bytes_len)))
+        return WALLY_ENOMEM;
+    memcpy(nodes, bytes, bytes_len);
+    for (i = 0; n > 1; ++i) {
+        const size_t sibling = (index ^ 1) < n ? index ^ 1 : index;
+        memcpy(bytes_out + i * SHA256_LEN, nodes + sibling * SHA256_LEN, SHA256_LEN);
+        n = merkle_hash_level(nodes, n, nodes);
+        index /= 2;
+    }
+    wally_free(nodes);
+    return WALLY_OK;
+}
+
+int wally_merkle_branch_verify(const unsigned char *txhash, size_t txhash_len,
+                               const unsigned char *branch, size_t branch_len,
+                               size_t index,
+                               const unsigned char *merkle_root, size_t merkle_root_len)
+{
+    unsigned char node[SHA256_LEN];
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!txhash || txhash_len != WALLY_TXHASH_LEN ||
+        BYTES_INVALID(branch, branch_len) || branch_len % SHA256_LEN ||
+        !merkle_root || merkle_root_len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    memcpy(node, txhash, SHA256_LEN);
+    for (i = 0; i < branch_len; i += SHA256_LEN) {
+        if (index & 1)
+            merkle_hash_pair(branch + i, node, node);
+        else
+            merkle_hash_pair(node, branch + i, node);
+        index >>= 1;
+    }
+
+    if (index || memcmp(node, merkle_root, SHA256_LEN))
+        ret = WALLY_EINVAL;
+    wally_clear(node, sizeof(node));
+    return ret;
+}
+
+int wally_tx_arena_init(struct wally_tx_arena *arena,
+                        unsigned char *bytes_out, size_t len)
+{
+    if (!arena || !bytes_out || !len)
+        return WALLY_EINVAL;
+    arena->bytes = bytes_out;
+    arena->len = len;
+    arena->used = 0;
+    return WALLY_OK;
+}
+
+int wally_tx_arena_reset(struct wally_tx_arena *arena)
+{
+    if (!arena || !arena->bytes)
+        return WALLY_EINVAL;
+    wally_clear(arena->bytes, arena->used);
+    arena->used = 0;
+    return WALLY_OK;
+}
+
+/* The arena bytes needed to decode a transaction validated by analyze_tx,
+ * when tx_arena_decode starts from an aligned offset */
+static size_t tx_arena_len(const unsigned char *bytes,
+                           size_t num_inputs, size_t num_outputs,
+                           bool expect_witnesses)
+{
+    const unsigned char *p = bytes + sizeof(uint32_t) + (expect_witnesses ? 2 : 0);
+    size_t total, i, j;
+    uint64_t tmp, num_witnesses;
+
+    total = ARENA_ALIGN_UP(sizeof(struct wally_tx)) +
+            ARENA_ALIGN_UP(num_inputs * sizeof(struct wally_tx_input)) +
+            ARENA_ALIGN_UP(num_outputs * sizeof(struct wally_tx_output));
+
+    p += varint_from_bytes(p, &tmp);
+    for (i = 0; i < num_inputs; ++i) {
+        p += WALLY_TXHASH_LEN + sizeof(uint32_t);
+        p += varint_from_bytes(p, &tmp);
+        total += ARENA_ALIGN_UP(tmp);
+        p += tmp + sizeof(uint32_t);
+    }
+
+    p += varint_from_bytes(p, &tmp);
+    for (i = 0; i < num_outputs; ++i) {
+        p += sizeof(uint64_t);
+        p += varint_from_bytes(p, &tmp);
+        total += ARENA_ALIGN_UP(tmp);
+        p += tmp;
+    }
+
+    if (expect_witnesses) {
+        for (i = 0; i < num_inputs; ++i) {
+            p += varint_from_bytes(p, &num_witnesses);
+            if (!num_witnesses)
+                continue;
+            total += ARENA_ALIGN_UP(sizeof(struct wally_tx_witness_stack)) +
+                     ARENA_ALIGN_UP(num_witnesses * sizeof(struct wally_tx_witness_item));
+            for (j = 0; j < num_witnesses; ++j) {
+                p += varint_from_bytes(p, &tmp);
+                total += ARENA_ALIGN_UP(tmp);
+                p += tmp;
+            }
+        }
+    }
+    return total;
+}
+
+/* Decode a transaction validated by analyze_tx, allocating from an arena.
+ * The arena is left unchanged on failure */
+static int tx_arena_decode(const unsigned char *bytes,
+                           size_t num_inputs, size_t num_outputs,
+                           bool expect_witnesses, struct wally_tx_arena *arena,
+                           struct wally_tx **output)
+{
+    const unsigned char *p = bytes;
+    const size_t used = arena->used; /* Restored on failure */
+    size_t i, j;
+    uint64_t tmp, num_witnesses;
+    struct wally_tx *result;
+    int ret = WALLY_ENOMEM;
+
+    if (!(result = arena_alloc(arena, sizeof(*result))) ||
+        !(result->inputs = arena_alloc(arena, num_inputs * sizeof(*result->inputs))) ||
+        !(result->outputs = arena_alloc(arena, num_outputs * sizeof(*result->outputs))))
+        goto fail;
+    result->inputs_allocation_len = num_inputs;
+    result->outputs_allocation_len = num_outputs;
+
+    p += uint32_from_le_bytes(p, &result->version);
+    if (expect_witnesses)
+        p += 2; /* Skip flag bytes */
+    p += varint_from_bytes(p, &tmp);
+
+    for (i = 0; i < num_inputs; ++i) {
+        struct wally_tx_input *input = result->inputs + i;
+        memcpy(input->txhash, p, WALLY_TXHASH_LEN);
+        p += WALLY_TXHASH_LEN;
+        p += uint32_from_le_bytes(p, &input->index);
+        p += varint_from_bytes(p, &tmp);
+        if (!arena_clone_bytes(arena, &input->script, p, tmp))
+            goto fail;
+        input->script_len = tmp;
+        p += tmp;
+        p += uint32_from_le_bytes(p, &input->sequence);
+        if (is_coinbase_bytes(input->txhash, WALLY_TXHASH_LEN, input->index))
+            input->features = WALLY_TX_IS_COINBASE;
+        result->num_inputs += 1;
+    }
+
+    p += varint_from_bytes(p, &tmp);
+    for (i = 0; i < num_outputs; ++i) {
+        struct wally_tx_output *out = result->outputs + i;
+        p += uint64_from_le_bytes(p, &out->satoshi);
+        if (out->satoshi > WALLY_SATOSHI_MAX) {
+            ret = WALLY_EINVAL;
+            goto fail;
+        }
+        p += varint_from_bytes(p, &tmp);
+        if (!arena_clone_bytes(arena, &out->script, p, tmp))
+            goto fail;
+        out->script_len = tmp;
+        p += tmp;
+        result->num_outputs += 1;
+    }
+
+    if (expect_witnesses) {
+        for (i = 0; i < num_inputs; ++i) {
+            struct wally_tx_witness_stack *stack;
+            p += varint_from_bytes(p, &num_witnesses);
+            if (!num_witnesses)
+                continue;
+            if (!(stack = arena_alloc(arena, sizeof(*stack))) ||
+                !(stack->items = arena_alloc(arena, num_witnesses * sizeof(*stack->items))))
+                goto fail;
+            stack->items_allocation_len = num_witnesses;
+            result->inputs[i].witness = stack;
+
+            for (j = 0; j < num_witnesses; ++j) {
+                p += varint_from_bytes(p, &tmp);
+                if (!arena_clone_bytes(arena, &stack->items[j].witness, p, tmp))
+                    goto fail;
+                stack->items[j].witness_len = tmp;
+                stack->num_items += 1;
+                p += tmp;
+            }
+        }
+    }
+
+    uint32_from_le_bytes(p, &result->locktime);
+    *output = result;
+    return WALLY_OK;
+
+fail:
+    wally_clear(arena->bytes + used, arena->used - used);
+    arena->used = used;
+    return ret;
+}
+
+static int tx_from_bytes_arena(const unsigned char *bytes, size_t bytes_len,
+                               uint32_t flags, struct wally_tx_arena *arena,
+                               struct wally_tx **output)
+{
+    bool expect_witnesses;
+    size_t num_inputs, num_outputs;
+
+    TX_CHECK_OUTPUT;
+
+    /* Elements transactions are not supported yet */
+    if (!arena || !arena->bytes || flags ||
+        wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len) ||
+        analyze_tx(bytes, bytes_len, 0, &num_inputs, &num_outputs,
+                   &expect_witnesses, NULL) != WALLY_OK)
+        return WALLY_EINVAL;
+    return tx_arena_decode(bytes, num_inputs, num_outputs, expect_witnesses,
+                           arena, output);
+}
+
+int wally_tx_from_bytes_arena(const unsigned char *bytes, size_t bytes_len,
+                              uint32_t flags, struct wally_tx_arena *arena,
+                              struct wally_tx **output)
+{
+    int ret;
+
+    WALLY_STATS_TIMED(WALLY_STAT_TX_PARSES, WALLY_STAT_TX_PARSE_NS, ret,
+                      tx_from_bytes_arena(bytes, bytes_len, flags, arena, output));
+    return ret;
+}
+
+/* The minimum number of transaction bytes decoded by each arena task */
+#define TXS_ARENA_TASK_BYTES 16384u
+
+/* The layout of each transaction in a batch decoded into an arena */
+struct tx_arena_layout {
+    size_t num_inputs;
+    size_t num_outputs;
+    size_t offset; /* From the start of the arena memory */
+    size_t len;
+    bool expect_witnesses;
+    int ret;
+};
+
+struct txs_arena_tasks {
+    const unsigned char *const *bytes;
+    const size_t *bytes_lens;
+    struct tx_arena_layout *layouts;
+    size_t *task_starts; /* One more than the number of tasks */
+    struct wally_tx_arena *arena;
+    struct wally_tx **output;
+    bool decode; /* False when validating and sizing, true when decoding */
+};
+
+static void txs_arena_task(void *task_ctx, size_t index)
+{
+    struct txs_arena_tasks *t = task_ctx;
+    size_t i;
+
+    for (i = t->task_starts[index]; i < t->task_starts[index + 1]; ++i) {
+        struct tx_arena_layout *l = t->layouts + i;
+        if (t->decode) {
+            /* Each transaction decodes into its own part of the arena */
+            struct wally_tx_arena part = { NULL, 0, 0 };
+            part.bytes = t->arena->bytes + l->offset;
+            part.len = l->len;
+            l->ret = tx_arena_decode(t->bytes[i], l->num_inputs, l->num_outputs,
+                                     l->expect_witnesses, &part, t->output + i);
+        } else if (!t->bytes[i] ||
+                   wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, t->bytes_lens[i]) ||
+                   analyze_tx(t->bytes[i], t->bytes_lens[i], 0, &l->num_inputs,
+                              &l->num_outputs, &l->expect_witnesses, NULL) != WALLY_OK)
+            l->ret = WALLY_EINVAL;
+        else {
+            l->len = tx_arena_len(t->bytes[i], l->num_inputs, l->num_outputs,
+                                  l->expect_witnesses);
+            l->ret = WALLY_OK;
+        }
+    }
+}
+
+int wally_txs_from_bytes_arena(const unsigned char *const *bytes,
+                               const size_t *bytes_lens, size_t num_txs,
+                               uint32_t flags,
+                               wally_run_tasks_t run_fn, void *run_ctx,
+                               struct wally_tx_arena *arena,
+                               struct wally_tx **output)
+{
+    struct txs_arena_tasks t;
+    size_t num_tasks = 0, task_bytes = 0, start, offset, i;
+    int ret = WALLY_OK;
+
+    if (output)
+        for (i = 0; i < num_txs; ++i)
+            output[i] = NULL;
+
+    /* Elements transactions are not supported yet */
+    if (!bytes || !bytes_lens || !num_txs || flags ||
+        !arena || !arena->bytes || !output)
+        return WALLY_EINVAL;
+
+    WALLY_STATS_ADD(WALLY_STAT_TX_PARSES, num_txs);
+    if (!(t.layouts = wally_malloc(num_txs * (sizeof(*t.layouts) + sizeof(*t.task_starts)) +
+                                   sizeof(*t.task_starts))))
+        return WALLY_ENOMEM;
+    t.task_starts = (size_t *)(t.layouts + num_txs);
+    t.bytes = bytes;
+    t.bytes_lens = bytes_lens;
+    t.arena = arena;
+    t.output = output;
+    t.decode = false;
+
+    /* Split the transactions into ranges of at least TXS_ARENA_TASK_BYTES */
+    for (i = 0; i < num_txs; ++i) {
+        if (!task_bytes)
+            t.task_starts[num_tasks++] = i;
+        task_bytes += bytes_lens[i];
+        if (task_bytes >= TXS_ARENA_TASK_BYTES)
+            task_bytes = 0;
+    }
+    t.task_starts[num_tasks] = num_txs;
+
+    /* Validate and size every transaction, then lay them out in order */
+    wally_run_tasks(run_fn, run_ctx, num_tasks, txs_arena_task, &t);
+    start = arena->used + ((ARENA_ALIGN - (uintptr_t)(arena->bytes + arena->used) % ARENA_ALIGN) % ARENA_ALIGN);
+    for (i = 0, offset = start; i < num_txs && ret == WALLY_OK; ++i) {
+        ret = t.layouts[i].ret;
+        t.layouts[i].offset = offset;
+        offset += t.layouts[i].len;
+    }
+    if (ret == WALLY_OK && (start > arena->len || offset - start > arena->len - start))
+        ret = WALLY_ENOMEM; /* The arena is too small */
+
+    if (ret == WALLY_OK) {
+        t.decode = true;
+        wally_run_tasks(run_fn, run_ctx, num_tasks, txs_arena_task, &t);
+        for (i = 0; i < num_txs && ret == WALLY_OK; ++i)
+            ret = t.layouts[i].ret;
+        if (ret == WALLY_OK)
+            arena->used = offset;
+        else {
+            wally_clear(arena->bytes + start, offset - start);
+            for (i = 0; i < num_txs; ++i)
+                output[i] = NULL;
+        }
+    }
+    wally_free(t.layouts);
+    return ret;
+}
+
+/* Bytes needed for a view and its input/output arrays in one block */
+static size_t tx_view_alloc_len(size_t num_inputs, size_t num_outputs)
+{
+    return sizeof(struct wally_tx_view) +
+           num_inputs * sizeof(struct wally_tx_view_input) +
+           num_outputs * sizeof(struct wally_tx_view_output);
+}
+
+/* Initialize a view allocated with tx_view_alloc_len() bytes. The
+ * serialization must have been validated by analyze_tx already */
+static void tx_view_init(const unsigned char *bytes, size_t bytes_len,
+                         size_t num_inputs, size_t num_outputs,
+                         bool expect_witnesses, struct wally_tx_view *result)
+{
+    const unsigned char *p = bytes;
+    size_t i, j;
+    uint64_t tmp;
+
+    result->bytes = bytes;
+    result->bytes_len = bytes_len;
+    result->inputs = (struct wally_tx_view_input *)(result + 1);
+    result->num_inputs = num_inputs;
+    result->outputs = (struct wally_tx_view_output *)(result->inputs + num_inputs);
+    result->num_outputs = num_outputs;
+
+    p += uint32_from_le_bytes(p, &result->version);
+    if (expect_witnesses)
+        p += 2; /* Skip flag bytes */
+    p += varint_from_bytes(p, &tmp);
+
+    for (i = 0; i < num_inputs; ++i) {
+        struct wally_tx_view_input *input = result->inputs + i;
+        input->txhash = p;
+        p += WALLY_TXHASH_LEN;
+        p += uint32_from_le_bytes(p, &input->index);
+        p += varint_from_bytes(p, &tmp);
+        input->script = tmp ? p : NULL;
+        input->script_len = tmp;
+        p += tmp;
+        p += uint32_from_le_bytes(p, &input->sequence);
+        input->witness = NULL;
+        input->num_witness_items = 0;
+    }
+
+    p += varint_from_bytes(p, &tmp);
+    for (i = 0; i < num_outputs; ++i) {
+        struct wally_tx_view_output *out = result->outputs + i;
+        p += uint64_from_le_bytes(p, &out->satoshi);
+        p += varint_from_bytes(p, &tmp);
+        out->script = tmp ? p : NULL;
+        out->script_len = tmp;
+        p += tmp;
+    }
+
+    if (expect_witnesses) {
+        for (i = 0; i < num_inputs; ++i) {
+            struct wally_tx_view_input *input = result->inputs + i;
+            p += varint_from_bytes(p, &tmp);
+            input->num_witness_items = tmp;
+            input->witness = tmp ? p : NULL;
+            for (j = 0; j < input->num_witness_items; ++j) {
+                p += varint_from_bytes(p, &tmp);
+                p += tmp;
+            }
+        }
+    }
+
+    uint32_from_le_bytes(p, &result->locktime);
+}
+
+int wally_tx_view_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                             uint32_t flags, struct wally_tx_view **output)
+{
+    bool expect_witnesses;
+    size_t num_inputs, num_outputs;
+
+    TX_CHECK_OUTPUT;
+
+    /* Elements transactions are not supported yet */
+    if (flags || wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len) ||
+        analyze_tx(bytes, bytes_len, 0, &num_inputs, &num_outputs,
+                   &expect_witnesses, NULL) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    if (!(*output = wally_malloc(tx_view_alloc_len(num_inputs, num_outputs))))
+        return WALLY_ENOMEM;
+    tx_view_init(bytes, bytes_len, num_inputs, num_outputs, expect_witnesses, *output);
+    return WALLY_OK;
+}
+
+int wally_tx_view_from_bytes_arena(const unsigned char *bytes, size_t bytes_len,
+                                   uint32_t flags, struct wally_tx_arena *arena,
+                                   struct wally_tx_view **output)
+{
+    bool expect_witnesses;
+    size_t num_inputs, num_outputs;
+
+    TX_CHECK_OUTPUT;
+
+    /* Elements transactions are not supported yet */
+    if (!arena || !arena->bytes || flags ||
+        wally_exceeds_input_limit(WALLY_LIMIT_TX_LEN, bytes_len) ||
+        analyze_tx(bytes, bytes_len, 0, &num_inputs, &num_outputs,
+                   &expect_witnesses, NULL) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    if (!(*output = arena_alloc(arena, tx_view_alloc_len(num_inputs, num_outputs))))
+        return WALLY_ENOMEM; /* arena_alloc leaves the arena unchanged */
+    tx_view_init(bytes, bytes_len, num_inputs, num_outputs, expect_witnesses, *output);
+    return WALLY_OK;
+}
+
+int wally_tx_view_from_hex(const char *hex, uint32_t flags,
+                           unsigned char *bytes_out, size_t len,
+                           struct wally_tx_view **output)
+{
+    const size_t hex_len = hex ? strlen(hex) : 0;
+    size_t written;
+    int ret;
+
+    TX_CHECK_OUTPUT;
+
+    if (!hex_len || hex_len & 0x1 || !bytes_out || len < hex_len / 2)
+        return WALLY_EINVAL;
+
+    ret = wally_hex_to_bytes(hex, bytes_out, len, &written);
+    if (ret == WALLY_OK)
+        ret = wally_tx_view_from_bytes(bytes_out, written, flags, output);
+    return ret;
+}
+
+int wally_tx_view_free(struct wally_tx_view *view)
+{
+    if (view)
+        wally_free(view);
+    return WALLY_OK;
+}
+
+static const struct wally_tx_view_input *tx_view_get_input(const struct wally_tx_view *view,
+                                                           size_t index)
+{
+    return view && index < view->num_inputs ? &view->inputs[index] : NULL;
+}
+
+static const struct wally_tx_view_output *tx_view_get_output(const struct wally_tx_view *view,
+                                                             size_t index)
+{
+    return view && index < view->num_outputs ? &view->outputs[index] : NULL;
+}
+
+static int tx_view_getb_impl(const void *src, size_t src_len,
+                             unsigned char *bytes_out, size_t len, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!bytes_out || !written)
+        return WALLY_EINVAL;
+    *written = src_len;
+    if (len >= src_len && src_len)
+        memcpy(bytes_out, src, src_len);
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_input_txhash(const struct wally_tx_view *view, size_t index,
+                                   unsigned char *bytes_out, size_t len)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (!input || !bytes_out || len != WALLY_TXHASH_LEN)
+        return WALLY_EINVAL;
+    memcpy(bytes_out, input->txhash, WALLY_TXHASH_LEN);
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_input_index(const struct wally_tx_view *view, size_t index,
+                                  size_t *written)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (written)
+        *written = 0;
+    if (!input || !written)
+        return WALLY_EINVAL;
+    *written = input->index;
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_input_sequence(const struct wally_tx_view *view, size_t index,
+                                     size_t *written)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (written)
+        *written = 0;
+    if (!input || !written)
+        return WALLY_EINVAL;
+    *written = input->sequence;
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_input_script(const struct wally_tx_view *view, size_t index,
+                                   unsigned char *bytes_out, size_t len,
+                                   size_t *written)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (!input) {
+        if (written)
+            *written = 0;
+        return WALLY_EINVAL;
+    }
+    return tx_view_getb_impl(input->script, input->script_len,
+                             bytes_out, len, written);
+}
+
+int wally_tx_view_get_input_script_len(const struct wally_tx_view *view, size_t index,
+                                       size_t *written)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (written)
+        *written = 0;
+    if (!input || !written)
+        return WALLY_EINVAL;
+    *written = input->script_len;
+    return WALLY_OK;
+}
+
+/* Find a witness item in the serialized witness stack of an input */
+static const unsigned char *tx_view_get_witness(const struct wally_tx_view *view,
+                                                size_t index, size_t wit_index,
+                                                size_t *witness_len)
+{
+    const struct wally_tx_view_input *input = tx_view_get_input(view, index);
+
+    if (!input)
+        return NULL;
+    return witness_item_from_bytes(input->witness, input->num_witness_items,
+                                   wit_index, witness_len);
+}
+
+int wally_tx_view_get_input_witness(const struct wally_tx_view *view, size_t index,
+                                    size_t wit_index, unsigned char *bytes_out,
+                                    size_t len, size_t *written)
+{
+    size_t witness_len;
+    const unsigned char *witness = tx_view_get_witness(view, index, wit_index,
+                                                       &witness_len);
+
+    if (!witness) {
+        if (written)
+            *written = 0;
+        return WALLY_EINVAL;
+    }
+    return tx_view_getb_impl(witness, witness_len, bytes_out, len, written);
+}
+
+int wally_tx_view_get_input_witness_len(const struct wally_tx_view *view, size_t index,
+                                        size_t wit_index, size_t *written)
+{
+    size_t witness_len;
+    const unsigned char *witness = tx_view_get_witness(view, index, wit_index,
+                                                       &witness_len);
+
+    if (written)
+        *written = 0;
+    if (!witness || !written)
+        return WALLY_EINVAL;
+    *written = witness_len;
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_output_script(const struct wally_tx_view *view, size_t index,
+                                    unsigned char *bytes_out, size_t len,
+                                    size_t *written)
+{
+    const struct wally_tx_view_output *output = tx_view_get_output(view, index);
+
+    if (!output) {
+        if (written)
+            *written = 0;
+        return WALLY_EINVAL;
+    }
+    return tx_view_getb_impl(output->script, output->script_len,
+                             bytes_out, len, written);
+}
+
+int wally_tx_view_get_output_script_len(const struct wally_tx_view *view, size_t index,
+                                        size_t *written)
+{
+    const struct wally_tx_view_output *output = tx_view_get_output(view, index);
+
+    if (written)
+        *written = 0;
+    if (!output || !written)
+        return WALLY_EINVAL;
+    *written = output->script_len;
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_output_satoshi(const struct wally_tx_view *view, size_t index,
+                                     uint64_t *value_out)
+{
+    const struct wally_tx_view_output *output = tx_view_get_output(view, index);
+
+    if (value_out)
+        *value_out = 0;
+    if (!output || !value_out)
+        return WALLY_EINVAL;
+    *value_out = output->satoshi;
+    return WALLY_OK;
+}
+
+/* BIP 143 hashPrevouts for a view */
+static void tx_view_hash_prevouts(const struct wally_tx_view *view,
+                                  unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = 0; i < view->num_inputs; ++i) {
+        sha256_update(&ctx, view->inputs[i].txhash, WALLY_TXHASH_LEN);
+        sha256_le32(&ctx, view->inputs[i].index);
+    }
+    sha256d_done(&ctx, bytes_out);
+}
+
+/* BIP 143 hashSequence for a view */
+static void tx_view_hash_sequences(const struct wally_tx_view *view,
+                                   unsigned char *bytes_out)
+{
+    struct sha256_ctx ctx;
+    size_t i;
+
+    sha256_init(&ctx);
+    for (i = 0; i < view->num_inputs; ++i)
+        sha256_le32(&ctx, view->inputs[i].sequence);
+    sha256d_done(&ctx, bytes_out);
+}
+
+/* Hash the outputs of a view from 'start' up to 'end' */
+static void tx_view_outputs_to_sha256(const struct wally_tx_view *view,
+                                      size_t start, size_t end,
+                                      struct sha256_ctx *ctx)
+{
+    size_t i;
+
+    for (i = start; i < end; ++i) {
+        sha256_le64(ctx, view->outputs[i].satoshi);
+        sha256_varbuff(ctx, view->outputs[i].script, view->outputs[i].script_len);
+    }
+}
+
+/* Hash a view's signature hash preimage, as tx_to_sha256 and
+ * tx_bip143_to_sha256 do for a tx */
+static void tx_view_to_sha256(const struct wally_tx_view *view,
+                              const struct tx_serialize_opts *opts,
+                              struct sha256_ctx *ctx)
+{
+    const struct wally_tx_view_input *input = view->inputs + opts->index;
+    const bool anyonecanpay = opts->sighash & WALLY_SIGHASH_ANYONECANPAY;
+    const bool sh_none = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_NONE;
+    const bool sh_single = (opts->sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE;
+    unsigned char buff[SHA256_LEN];
+    size_t i;
+
+    sha256_le32(ctx, view->version);
+
+    if (opts->bip143) {
+        if (anyonecanpay)
+            memset(buff, 0, SHA256_LEN);
+        else
+            tx_view_hash_prevouts(view, buff);
+        sha256_update(ctx, buff, SHA256_LEN);
+
+        if (anyonecanpay || sh_single || sh_none)
+            memset(buff, 0, SHA256_LEN);
+        else
+            tx_view_hash_sequences(view, buff);
+        sha256_update(ctx, buff, SHA256_LEN);
+
+        sha256_update(ctx, input->txhash, WALLY_TXHASH_LEN);
+        sha256_le32(ctx, input->index);
+        sha256_varbuff(ctx, opts->script, opts->script_len);
+        sha256_le64(ctx, opts->satoshi);
+        sha256_le32(ctx, input->sequence);
+
+        if (sh_none || (sh_single && opts->index >= view->num_outputs))
+            memset(buff, 0, SHA256_LEN);
+        else {
+            struct sha256_ctx outputs_ctx;
+
+            sha256_init(&outputs_ctx);
+            if (sh_single)
+                tx_view_outputs_to_sha256(view, opts->index, opts->index + 1, &outputs_ctx);
+            else
+                tx_view_outputs_to_sha256(view, 0, view->num_outputs, &outputs_ctx);
+            sha256d_done(&outputs_ctx, buff);
+        }
+        sha256_update(ctx, buff, SHA256_LEN);
+        wally_clear(buff, sizeof(buff));
+    } else {
+        if (anyonecanpay)
+            sha256_u8(ctx, 1);
+        else
+            sha256_varint(ctx, view->num_inputs);
+
+        for (i = 0; i < view->num_inputs; ++i) {
+            if (anyonecanpay && i != opts->index)
+                continue; /* anyonecanpay only signs the given index */
+
+            sha256_update(ctx, view->inputs[i].txhash, WALLY_TXHASH_LEN);
+            sha256_le32(ctx, view->inputs[i].index);
+            if (i == opts->index)
+                sha256_varbuff(ctx, opts->script, opts->script_len);
+            else
+                sha256_u8(ctx, 0); /* Blank scripts for non-signing inputs */
+            if ((sh_none || sh_single) && i != opts->index)
+                sha256_le32(ctx, 0);
+            else
+                sha256_le32(ctx, view->inputs[i].sequence);
+        }
+
+        if (sh_none)
+            sha256_u8(ctx, 0);
+        else if (sh_single) {
+            sha256_varint(ctx, opts->index + 1);
+            for (i = 0; i < opts->index; ++i)
+                sha256_update(ctx, EMPTY_OUTPUT, sizeof(EMPTY_OUTPUT));
+            tx_view_outputs_to_sha256(view, opts->index, opts->index + 1, ctx);
+        } else {
+            sha256_varint(ctx, view->num_outputs);
+            tx_view_outputs_to_sha256(view, 0, view->num_outputs, ctx);
+        }
+    }
+
+    sha256_le32(ctx, view->locktime);
+    sha256_le32(ctx, opts->tx_sighash);
+}
+
+static int tx_view_signature_hash(const struct wally_tx_view *view,
+                                  size_t index,
+                                  const unsigned char *script, size_t script_len,
+                                  uint64_t satoshi, uint32_t sighash, uint32_t flags,
+                                  unsigned char *bytes_out, size_t len)
+{
+    const struct tx_serialize_opts opts = {
+        sighash, sighash, index, script, script_len, satoshi,
+        (flags & WALLY_TX_FLAG_USE_WITNESS) ? true : false,
+        NULL, 0, NULL
+    };
+    struct sha256_ctx sha_ctx;
+
+    if (!view || BYTES_INVALID(script, script_len) ||
+        satoshi > WALLY_SATOSHI_MAX || (sighash & 0xffffff00) ||
+        (flags & ~WALLY_TX_FLAG_USE_WITNESS) || !bytes_out || len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    if (index >= view->num_inputs ||
+        (index >= view->num_outputs && (sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE)) {
+        if (opts.bip143) {
+            if (index >= view->num_inputs)
+                return WALLY_EINVAL;
+        } else {
+            memset(bytes_out, 0, SHA256_LEN);
+            bytes_out[0] = 0x1;
+            return WALLY_OK;
+        }
+    }
+
+    sha256_init(&sha_ctx);
+    tx_view_to_sha256(view, &opts, &sha_ctx);
+    sha256d_done(&sha_ctx, bytes_out);
+    wally_clear(&sha_ctx, sizeof(sha_ctx));
+    return WALLY_OK;
+}
+
+int wally_tx_view_get_btc_signature_hash(const struct wally_tx_view *view,
+                                         size_t index,
+                                         const unsigned char *script, size_t script_len,
+                                         uint64_t satoshi, uint32_t sighash, uint32_t flags,
+                                         unsigned char *bytes_out, size_t len)
+{
+    int ret;
+
+    WALLY_STATS_TIMED(WALLY_STAT_SIGHASHES, WALLY_STAT_SIGHASH_NS, ret,
+                      tx_view_signature_hash(view, index, script, script_len,
+                                             satoshi, sighash, flags,
+                                             bytes_out, len));
+    return ret;
+}
+
+/* Totals of the transactions making up a batch */
+struct tx_batch_totals {
+    size_t num_txs;
+    size_t num_inputs;
+    size_t num_outputs;
+    size_t scripts_len;
+};
+
+/* Validate the concatenated transactions in bytes, totalling their
+ * columns. If num_txs is non-zero, exactly that many must fill bytes */
+static int tx_batch_analyze(const unsigned char *bytes, size_t bytes_len,
+                            size_t num_txs, struct tx_batch_totals *totals)
+{
+    struct tx_offsets offsets;
+    size_t offset = 0, num_inputs, num_outputs, i;
+    bool expect_witnesses;
+    uint64_t v;
+
+    wally_clear(totals, sizeof(*totals));
+    while (offset < bytes_len && (!num_txs || totals->num_txs < num_txs)) {
+        const unsigned char *p = bytes + offset;
+
+        if (analyze_tx(p, bytes_len - offset, 0, &num_inputs, &num_outputs,
+                       &expect_witnesses, &offsets) != WALLY_OK)
+            return WALLY_EINVAL;
+
+        p += offsets.outputs;
+        p += varint_from_bytes(p, &v);
+        for (i = 0; i < num_outputs; ++i) {
+            p += sizeof(uint64_t);
+            p += varint_from_bytes(p, &v);
+            totals->scripts_len += v;
+            p += v;
+        }
+        totals->num_txs += 1;
+        totals->num_inputs += num_inputs;
+        totals->num_outputs += num_outputs;
+        offset += offsets.end;
+    }
+
+    if (!totals->num_txs || offset != bytes_len ||
+        (num_txs && totals->num_txs != num_txs))
+        return WALLY_EINVAL;
+    return WALLY_OK;
+}
+
+static size_t tx_batch_alloc_len(const struct tx_batch_totals *totals)
+{
+    /* Columns are laid out in decreasing order of alignment */
+    return sizeof(struct wally_tx_batch) +
+           totals->num_outputs * sizeof(uint64_t) +
+           (2 * (totals->num_txs + 1) + totals->num_outputs + 1) * sizeof(size_t) +
+           (2 * totals->num_txs + 2 * totals->num_inputs) * sizeof(uint32_t) +
+           totals->num_inputs * WALLY_TXHASH_LEN + totals->scripts_len;
+}
+
+/* Initialize a batch allocated with tx_batch_alloc_len() bytes. The
+ * transactions must have been validated by tx_batch_analyze already */
+static void tx_batch_init(const unsigned char *bytes,
+                          const struct tx_batch_totals *totals,
+                          struct wally_tx_batch *batch)
+{
+    const unsigned char *p = bytes;
+    size_t t, i, j, in = 0, out = 0, script_offset = 0;
+    uint64_t num_inputs, num_outputs, tmp;
+
+    batch->num_txs = totals->num_txs;
+    batch->num_inputs = totals->num_inputs;
+    batch->num_outputs = totals->num_outputs;
+    batch->satoshis = (uint64_t *)(batch + 1);
+    batch->input_offsets = (size_t *)(batch->satoshis + totals->num_outputs);
+    batch->output_offsets = batch->input_offsets + totals->num_txs + 1;
+    batch->script_offsets = batch->output_offsets + totals->num_txs + 1;
+    batch->versions = (uint32_t *)(batch->script_offsets + totals->num_outputs + 1);
+    batch->locktimes = batch->versions + totals->num_txs;
+    batch->prevout_indices = batch->locktimes + totals->num_txs;
+    batch->sequences = batch->prevout_indices + totals->num_inputs;
+    batch->prevout_txhashes = (unsigned char *)(batch->sequences + totals->num_inputs);
+    batch->scripts = batch->prevout_txhashes + totals->num_inputs * WALLY_TXHASH_LEN;
+
+    for (t = 0; t < totals->num_txs; ++t) {
+        bool expect_witnesses;
+
+        batch->input_offsets[t] = in;
+        batch->output_offsets[t] = out;
+        p += uint32_from_le_bytes(p, &batch->versions[t]);
+        if ((expect_witnesses = *p == 0))
+            p += 2; /* Skip flag bytes */
+
+        p += varint_from_bytes(p, &num_inputs);
+        for (i = 0; i < num_inputs; ++i, ++in) {
+            memcpy(batch->prevout_txhashes + in * WALLY_TXHASH_LEN, p, WALLY_TXHASH_LEN);
+            p += WALLY_TXHASH_LEN;
+            p += uint32_from_le_bytes(p, &batch->prevout_indices[in]);
+            p += varint_from_bytes(p, &tmp);
+            p += tmp;
+            p += uint32_from_le_bytes(p, &batch->sequences[in]);
+        }
+
+        p += varint_from_bytes(p, &num_outputs);
+        for (i = 0; i < num_outputs; ++i, ++out) {
+            p += uint64_from_le_bytes(p, &batch->satoshis[out]);
+            p += varint_from_bytes(p, &tmp);
+            batch->script_offsets[out] = script_offset;
+            memcpy(batch->scripts + script_offset, p, tmp);
+            script_offset += tmp;
+            p += tmp;
+        }
+
+        if (expect_witnesses) {
+            for (i = 0; i < num_inputs; ++i) {
+                uint64_t num_items;
+                p += varint_from_bytes(p, &num_items);
+                for (j = 0; j < num_items; ++j) {
+                    p += varint_from_bytes(p, &tmp);
+                    p += tmp;
+                }
+            }
+        }
+        p += uint32_from_le_bytes(p, &batch->locktimes[t]);
+    }
+    batch->input_offsets[t] = in;
+    batch->output_offsets[t] = out;
+    batch->script_offsets[out] = script_offset;
+}
+
+static int tx_batch_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                               size_t num_txs, struct wally_tx_batch **output)
+{
+    struct tx_batch_totals totals;
+
+    if (tx_batch_analyze(bytes, bytes_len, num_txs, &totals) != WALLY_OK)
+        return WALLY_EINVAL;
+    if (!(*output = wally_malloc(tx_batch_alloc_len(&totals))))
+        return WALLY_ENOMEM;
+    tx_batch_init(bytes, &totals, *output);
+    return WALLY_OK;
+}
+
+int wally_tx_batch_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                              uint32_t flags, struct wally_tx_batch **output)
+{
+    TX_CHECK_OUTPUT;
+
+    /* Elements transactions are not supported yet */
+    if (!bytes || !bytes_len || flags)
+        return WALLY_EINVAL;
+    return tx_batch_from_bytes(bytes, bytes_len, 0, output);
+}
+
+int wally_block_get_tx_batch(const unsigned char *bytes, size_t bytes_len,
+                             uint32_t flags, struct wally_tx_batch **output)
+{
+    struct wally_block_iterator iter;
+
+    TX_CHECK_OUTPUT;
+
+    if (wally_block_iterator_init(bytes, bytes_len, flags, &iter) != WALLY_OK)
+        return WALLY_EINVAL;
+    return tx_batch_from_bytes(bytes + iter.offset, bytes_len - iter.offset,
+                               iter.num_txs, output);
+}
+
+int wally_tx_batch_free(struct wally_tx_batch *batch)
+{
+    if (batch)
+        wally_free(batch);
+    return WALLY_OK;
+}
+
+int wally_tx_is_elements(const struct wally_tx *tx, size_t *written)
+{
+    if (!tx || !written)
+        return WALLY_EINVAL;
+
+    *written = is_valid_elements_tx(tx);
+
+    return WALLY_OK;
+}
+
+int wally_tx_elements_input_is_pegin(const struct wally_tx_input *input,
+                                     size_t *written)
+{
+    if (!input || !written)
+        return WALLY_EINVAL;
+
+    *written = is_valid_elements_tx_input_pegin(input);
+
+    return WALLY_OK;
+}
+
+int wally_tx_is_coinbase(const struct wally_tx *tx, size_t *written)
+{
+    if (!tx || !written)
+        return WALLY_EINVAL;
+
+    *written = tx->num_inputs == 1 && is_valid_coinbase_input(tx->inputs);
+
+    return WALLY_OK;
+}
+
+static int tx_signature_hash(const struct wally_tx *tx,
+                             const struct wally_tx_sighash_ctx *ctx,
+                             struct tx_legacy_sighash *legacy,
+                             size_t index,
+                             const unsigned char *script, size_t script_len,
+                             const unsigned char *extra, size_t extra_len,
+                             uint32_t extra_offset, uint64_t satoshi,
+                             const unsigned char *value,
+                             size_t value_len,
+                             uint32_t sighash, uint32_t tx_sighash, uint32_t flags,
+                             unsigned char *bytes_out, size_t len)
+{
+    struct sha256_ctx sha_ctx;
+    size_t is_elements = 0, n;
+    int ret;
+    const struct tx_serialize_opts opts = {
+        sighash, tx_sighash, index, script, script_len, satoshi,
+        (flags & WALLY_TX_FLAG_USE_WITNESS) ? true : false,
+        value, value_len, ctx
+    };
+
+    if (!is_valid_tx(tx) || BYTES_INVALID(script, script_len) ||
+        (ctx && (ctx->num_inputs != tx->num_inputs ||
+                 ctx->num_outputs != tx->num_outputs)) ||
+        BYTES_INVALID(extra, extra_len) ||
+        satoshi > WALLY_SATOSHI_MAX || (sighash & 0xffffff00) ||
+        (flags & ~WALLY_TX_FLAG_USE_WITNESS) || !bytes_out || len < SHA256_LEN)
+        return WALLY_EINVAL;
+
+    if (extra || extra_len || extra_offset)
+        return WALLY_ERROR; /* FIXME: Not implemented yet */
+
+    if (index >= tx->num_inputs ||
+        (index >= tx->num_outputs && (sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE)) {
+        if (!(flags & WALLY_TX_FLAG_USE_WITNESS)) {
+            memset(bytes_out, 0, SHA256_LEN);
+            bytes_out[0] = 0x1;
+            return WALLY_OK;
+        }
+    }
+
+    if (ctx)
+        is_elements = ctx->is_elements;
+#ifdef BUILD_ELEMENTS
+    else if ((ret = wally_tx_is_elements(tx, &is_elements)) != WALLY_OK)
+        return ret;
+#endif
+
+    if (len != SHA256_LEN)
+        return WALLY_EINVAL;
+
+    /* Stream the preimage into the hash instead of serializing it, so
+     * that computing a signature hash never allocates */
+    sha256_init(&sha_ctx);
+    if (!opts.bip143 && legacy && !is_elements &&
+        !(sighash & WALLY_SIGHASH_ANYONECANPAY) &&
+        (sighash & SIGHASH_MASK) != WALLY_SIGHASH_NONE &&
+        (sighash & SIGHASH_MASK) != WALLY_SIGHASH_SINGLE)
+        ret = tx_legacy_to_sha256(tx, legacy, &opts, &sha_ctx);
+    else if (!opts.bip143)
+        ret = tx_to_sha256(tx, &opts, &sha_ctx, is_elements != 0);
+    else if ((ret = tx_get_length(tx, &opts, 0, &n, is_elements != 0)) == WALLY_OK)
+        tx_bip143_to_sha256(tx, &opts, &sha_ctx, is_elements != 0);
+    if (ret == WALLY_OK)
+        sha256d_done(&sha_ctx, bytes_out);
+    wally_clear(&sha_ctx, sizeof(sha_ctx));
+    return ret;
+}
+
+static int tx_get_signature_hash(const struct wally_tx *tx,
+                                 const struct wally_tx_sighash_ctx *ctx,
+                                 struct tx_legacy_sighash *legacy,
+                                 size_t index,
+                                 const unsigned char *script, size_t script_len,
+                                 const unsigned char *extra, size_t extra_len,
+                                 uint32_t extra_offset, uint64_t satoshi,
+                                 const unsigned char *value,
+                                 size_t value_len,
+                                 uint32_t sighash, uint32_t tx_sighash, uint32_t flags,
+                                 unsigned char *bytes_out, size_t len)
+{
+    int ret;
+
+    WALLY_TRACE4(tx_get_signature_hash__entry, index, script_len, sighash, flags);
+    WALLY_STATS_TIMED(WALLY_STAT_SIGHASHES, WALLY_STAT_SIGHASH_NS, ret,
+                      tx_signature_hash(tx, ctx, legacy, index, script, script_len,
+                                        extra, extra_len, extra_offset, satoshi,
+                                        value, value_len, sighash, tx_sighash,
+                                        flags, bytes_out, len));
+    WALLY_TRACE1(tx_get_signature_hash__return, ret);
+    return ret;
+}
+
+int wally_tx_get_signature_hash(const struct wally_tx *tx,
+                                size_t index,
+                                const unsigned char *script, size_t script_len,
+                                const unsigned char *extra, size_t extra_len,
+                                uint32_t extra_offset, uint64_t satoshi,
+                                uint32_t sighash, uint32_t tx_sighash, uint32_t flags,
+                                unsigned char *bytes_out, size_t len)
+{
+    return tx_get_signature_hash(tx, NULL, NULL, index, script, script_len,
+                                 extra, extra_len, extra_offset, satoshi,
+                                 NULL, 0, sighash, tx_sighash, flags, bytes_out, len);
+}
+
+int wally_tx_get_btc_signature_hash(const struct wally_tx *tx, size_t index,
+                                    const unsigned char *script, size_t script_len,
+                                    uint64_t satoshi, uint32_t sighash, uint32_t flags,
+                                    unsigned char *bytes_out, size_t len)
+{
+    return wally_tx_get_signature_hash(tx, index, script, script_len,
+                                       NULL, 0, 0, satoshi, sighash, sighash,
+                                       flags, bytes_out, len);
+}
+
+int wally_tx_sighash_ctx_init(const struct wally_tx *tx, uint32_t flags,
+                              struct wally_tx_sighash_ctx *ctx)
+{
+    size_t is_elements = 0;
+
+    if (ctx)
+        wally_clear(ctx, sizeof(*ctx));
+
+    if (!is_valid_tx(tx) || flags || !ctx)
+        return WALLY_EINVAL;
+
+#ifdef BUILD_ELEMENTS
+    if (wally_tx_is_elements(tx, &is_elements) != WALLY_OK)
+        return WALLY_EINVAL;
+#endif
+    tx_sighash_ctx_init(tx, is_elements != 0, ctx);
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_ctx_init_alloc(const struct wally_tx *tx, uint32_t flags,
+                                    struct wally_tx_sighash_ctx **output)
+{
+    int ret;
+
+    TX_CHECK_OUTPUT;
+    *output = wally_malloc(sizeof(struct wally_tx_sighash_ctx));
+    if (!*output)
+        return WALLY_ENOMEM;
+
+    ret = wally_tx_sighash_ctx_init(tx, flags, *output);
+    if (ret != WALLY_OK) {
+        wally_free(*output);
+        *output = NULL;
+    }
+    return ret;
+}
+
+int wally_tx_sighash_ctx_free(struct wally_tx_sighash_ctx *ctx)
+{
+    if (ctx)
+        clear_public_and_free(ctx, sizeof(*ctx));
+    return WALLY_OK;
+}
+
+/* Serialized sighash context: version, flags, input and output counts,
+ * then each hash in struct order */
+#define SIGHASH_CTX_VERSION 1
+#define SIGHASH_CTX_ELEMENTS 0x1
+#define SIGHASH_CTX_HEADER_LEN 10
+
+int wally_tx_sighash_ctx_to_bytes(const struct wally_tx_sighash_ctx *ctx,
+                                  uint32_t flags,
+                                  unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    unsigned char *p = bytes_out;
+    size_t needed;
+
+    if (written)
+        *written = 0;
+
+    if (!ctx || flags || !bytes_out || !written ||
+        ctx->num_inputs > 0xffffffff || ctx->num_outputs > 0xffffffff)
+        return WALLY_EINVAL;
+
+    needed = ctx->is_elements ? WALLY_TX_SIGHASH_CTX_ELEMENTS_LEN : WALLY_TX_SIGHASH_CTX_LEN;
+    if (len < needed) {
+        *written = needed;
+        return WALLY_OK;
+    }
+    *p++ = SIGHASH_CTX_VERSION;
+    *p++ = ctx->is_elements ? SIGHASH_CTX_ELEMENTS : 0;
+    p += uint32_to_le_bytes(ctx->num_inputs, p);
+    p += uint32_to_le_bytes(ctx->num_outputs, p);
+    memcpy(p, ctx->hash_prevouts, SHA256_LEN);
+    memcpy(p + SHA256_LEN, ctx->hash_sequence, SHA256_LEN);
+    memcpy(p + SHA256_LEN * 2, ctx->hash_outputs, SHA256_LEN);
+#ifdef BUILD_ELEMENTS
+    if (ctx->is_elements)
+        memcpy(p + SHA256_LEN * 3, ctx->hash_issuances, SHA256_LEN);
+#endif
+    *written = needed;
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_ctx_from_bytes(const unsigned char *bytes, size_t bytes_len,
+                                    uint32_t flags,
+                                    struct wally_tx_sighash_ctx *ctx)
+{
+    const unsigned char *p = bytes + SIGHASH_CTX_HEADER_LEN;
+    uint32_t num_inputs, num_outputs;
+    bool is_elements;
+
+    if (ctx)
+        wally_clear(ctx, sizeof(*ctx));
+
+    if (!bytes || bytes_len < SIGHASH_CTX_HEADER_LEN || flags || !ctx ||
+        bytes[0] != SIGHASH_CTX_VERSION || (bytes[1] & ~SIGHASH_CTX_ELEMENTS))
+        return WALLY_EINVAL;
+
+    is_elements = bytes[1] & SIGHASH_CTX_ELEMENTS;
+#ifndef BUILD_ELEMENTS
+    if (is_elements)
+        return WALLY_EINVAL;
+#endif
+    if (bytes_len != (is_elements ? WALLY_TX_SIGHASH_CTX_ELEMENTS_LEN : WALLY_TX_SIGHASH_CTX_LEN))
+        return WALLY_EINVAL;
+
+    uint32_from_le_bytes(bytes + 2, &num_inputs);
+    uint32_from_le_bytes(bytes + 6, &num_outputs);
+    memcpy(ctx->hash_prevouts, p, SHA256_LEN);
+    memcpy(ctx->hash_sequence, p + SHA256_LEN, SHA256_LEN);
+    memcpy(ctx->hash_outputs, p + SHA256_LEN * 2, SHA256_LEN);
+#ifdef BUILD_ELEMENTS
+    if (is_elements)
+        memcpy(ctx->hash_issuances, p + SHA256_LEN * 3, SHA256_LEN);
+#endif
+    ctx->num_inputs = num_inputs;
+    ctx->num_outputs = num_outputs;
+    ctx->is_elements = is_elements;
+    return WALLY_OK;
+}
+
+struct wally_tx_sighash_verifier {
+    struct wally_tx_sighash_ctx ctx; /* The hashes being verified */
+    struct sha256_ctx prevouts;
+    struct sha256_ctx sequences;
+    struct sha256_ctx outputs;
+    size_t num_inputs; /* Inputs passed so far */
+    size_t num_outputs; /* Outputs passed so far */
+    bool finished;
+};
+
+int wally_tx_sighash_verifier_init_alloc(const struct wally_tx_sighash_ctx *ctx,
+                                         uint32_t flags,
+                                         struct wally_tx_sighash_verifier **output)
+{
+    struct wally_tx_sighash_verifier *result;
+
+    TX_CHECK_OUTPUT;
+    if (!ctx || ctx->is_elements || flags)
+        return WALLY_EINVAL;
+
+    result = wally_malloc(sizeof(*result));
+    if (!result)
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    memcpy(&result->ctx, ctx, sizeof(*ctx));
+    sha256_init(&result->prevouts);
+    sha256_init(&result->sequences);
+    sha256_init(&result->outputs);
+    *output = result;
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_verifier_add_input(struct wally_tx_sighash_verifier *verifier,
+                                        const unsigned char *txhash, size_t txhash_len,
+                                        uint32_t utxo_index, uint32_t sequence)
+{
+    if (!verifier || verifier->finished ||
+        verifier->num_inputs == verifier->ctx.num_inputs ||
+        !txhash || txhash_len != WALLY_TXHASH_LEN)
+        return WALLY_EINVAL;
+
+    sha256_update(&verifier->prevouts, txhash, WALLY_TXHASH_LEN);
+    sha256_le32(&verifier->prevouts, utxo_index);
+    sha256_le32(&verifier->sequences, sequence);
+    ++verifier->num_inputs;
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_verifier_add_output(struct wally_tx_sighash_verifier *verifier,
+                                         uint64_t satoshi,
+                                         const unsigned char *script, size_t script_len)
+{
+    if (!verifier || verifier->finished ||
+        verifier->num_outputs == verifier->ctx.num_outputs ||
+        satoshi > WALLY_SATOSHI_MAX || BYTES_INVALID(script, script_len))
+        return WALLY_EINVAL;
+
+    sha256_le64(&verifier->outputs, satoshi);
+    sha256_varbuff(&verifier->outputs, script, script_len);
+    ++verifier->num_outputs;
+    return WALLY_OK;
+}
+
+int wally_tx_sighash_verifier_final(struct wally_tx_sighash_verifier *verifier)
+{
+    unsigned char hashes[SHA256_LEN * 3];
+    int ret = WALLY_OK;
+
+    if (!verifier || verifier->finished ||
+        verifier->num_inputs != verifier->ctx.num_inputs ||
+        verifier->num_outputs != verifier->ctx.num_outputs)
+        return WALLY_EINVAL;
+
+    verifier->finished = true;
+    sha256d_done(&verifier->prevouts, hashes);
+    sha256d_done(&verifier->sequences, hashes + SHA256_LEN);
+    sha256d_done(&verifier->outputs, hashes + SHA256_LEN * 2);
+    if (memcmp(hashes, verifier->ctx.hash_prevouts, SHA256_LEN) ||
+        memcmp(hashes + SHA256_LEN, verifier->ctx.hash_sequence, SHA256_LEN) ||
+        memcmp(hashes + SHA256_LEN * 2, verifier->ctx.hash_outputs, SHA256_LEN))
+        ret = WALLY_ERROR;
+    wally_clear(hashes, sizeof(hashes));
+    return ret;
+}
+
+int wally_tx_sighash_verifier_free(struct wally_tx_sighash_verifier *verifier)
+{
+    if (verifier)
+        clear_public_and_free(verifier, sizeof(*verifier));
+    return WALLY_OK;
+}
+
+int wally_tx_get_btc_signature_hash_ctx(const struct wally_tx *tx,
+                                        const struct wally_tx_sighash_ctx *ctx,
+                                        size_t index,
+                                        const unsigned char *script, size_t script_len,
+                                        uint64_t satoshi, uint32_t sighash, uint32_t flags,
+                                        unsigned char *bytes_out, size_t len)
+{
+    return tx_get_signature_hash(tx, ctx, NULL, index, script, script_len,
+                                 NULL, 0, 0, satoshi, NULL, 0,
+                                 sighash, sighash, flags, bytes_out, len);
+}
+
+int wally_tx_get_signature_hashes(const struct wally_tx *tx,
+                                  const unsigned char *scripts, size_t scripts_len,
+                                  const uint64_t *values, size_t values_len,
+                                  const uint32_t *sighash, size_t sighash_len,
+                                  uint32_t flags,
+                                  unsigned char *bytes_out, size_t len)
+{
+    struct wally_tx_sighash_ctx ctx;
+    struct tx_legacy_sighash legacy;
+    size_t is_elements = 0;
+    const unsigned char *end = scripts + scripts_len;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (!is_valid_tx(tx) || !tx->num_inputs || !scripts || !scripts_len ||
+        !values || values_len != tx->num_inputs ||
+        !sighash || sighash_len != tx->num_inputs ||
+        (flags & ~WALLY_TX_FLAG_USE_WITNESS) ||
+        !bytes_out || len != tx->num_inputs * SHA256_LEN)
+        return WALLY_EINVAL;
+
+    if (flags & WALLY_TX_FLAG_USE_WITNESS) {
+        if ((ret = wally_tx_sighash_ctx_init(tx, 0, &ctx)) != WALLY_OK)
+            return ret;
+    } else {
+        /* Legacy hashing doesn't use the BIP143 hashes: don't compute them */
+#ifdef BUILD_ELEMENTS
+        if ((ret = wally_tx_is_elements(tx, &is_elements)) != WALLY_OK)
+            return ret;
+#endif
+        wally_clear(&ctx, sizeof(ctx));
+        ctx.num_inputs = tx->num_inputs;
+        ctx.num_outputs = tx->num_outputs;
+        ctx.is_elements = is_elements != 0;
+    }
+    wally_clear(&legacy, sizeof(legacy));
+
+    for (i = 0; i < tx->num_inputs && ret == WALLY_OK; ++i) {
+        uint64_t script_len;
+
+        if (scripts >= end || scripts + varint_length_from_bytes(scripts) > end)
+            ret = WALLY_EINVAL;
+        else {
+            scripts += varint_from_bytes(scripts, &script_len);
+            if (script_len > (uint64_t)(end - scripts))
+                ret = WALLY_EINVAL;
+            else {
+                ret = tx_get_signature_hash(tx, &ctx, &legacy, i,
+                                            script_len ? scripts : NULL, script_len,
+                                            NULL, 0, 0, values[i], NULL, 0,
+                                            sighash[i], sighash[i], flags,
+                                            bytes_out + i * SHA256_LEN, SHA256_LEN);
+                scripts += script_len;
+            }
+        }
+    }
+
+    if (ret == WALLY_OK && scripts != end)
+        ret = WALLY_EINVAL; /* Trailing data after the last script */
+    if (ret != WALLY_OK)
+        wally_clear(bytes_out, len);
+    wally_clear(&ctx, sizeof(ctx));
+    wally_clear(&legacy, sizeof(legacy));
+    return ret;
+}
+
+/* The inputs wally_tx_sign_inputs can sign */
+#define SIGN_P2PKH 0
+#define SIGN_P2WPKH 1
+#define SIGN_P2SH_P2WPKH 2
+
+/* Per input data for wally_tx_sign_inputs */
+struct sign_input {
+    unsigned char type;
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN];
+    unsigned char script_code[WALLY_SCRIPTPUBKEY_P2PKH_LEN];
+};
+
+/* Determine how to sign an input from the script it spends, checking
+ * the script pays to the compressed public key of priv_key */
+static int sign_input_init(const unsigned char *priv_key,
+                           const unsigned char *script, size_t script_len,
+                           struct sign_input *in)
+{
+    unsigned char hash[HASH160_LEN], redeem[2 + HASH160_LEN];
+    size_t script_type, written;
+    int ret;
+
+    ret = wally_ec_public_key_from_private_key(priv_key, EC_PRIVATE_KEY_LEN,
+                                               in->pub_key, sizeof(in->pub_key));
+    if (ret == WALLY_OK)
+        ret = wally_hash160(in->pub_key, sizeof(in->pub_key), hash, sizeof(hash));
+    if (ret == WALLY_OK)
+        ret = wally_scriptpubkey_get_type(script, script_len, &script_type);
+    if (ret == WALLY_OK)
+        ret = wally_scriptpubkey_p2pkh_from_bytes(hash, sizeof(hash), 0,
+                                                  in->script_code,
+                                                  sizeof(in->script_code), &written);
+    if (ret != WALLY_OK)
+        return ret;
+
+    switch (script_type) {
+    case WALLY_SCRIPT_TYPE_P2PKH:
+        in->type = SIGN_P2PKH;
+        return memcmp(script, in->script_code, script_len) ? WALLY_EINVAL : WALLY_OK;
+    case WALLY_SCRIPT_TYPE_P2WPKH:
+        in->type = SIGN_P2WPKH;
+        return memcmp(script + 2, hash, sizeof(hash)) ? WALLY_EINVAL : WALLY_OK;
+    case WALLY_SCRIPT_TYPE_P2SH:
+        /* Only p2sh-p2wpkh can be signed for without a redeem script */
+        in->type = SIGN_P2SH_P2WPKH;
+        redeem[0] = OP_0;
+        redeem[1] = HASH160_LEN;
+        memcpy(redeem + 2, hash, sizeof(hash));
+        ret = wally_hash160(redeem, sizeof(redeem), hash, sizeof(hash));
+        if (ret == WALLY_OK && memcmp(script + 2, hash, sizeof(hash)))
+            ret = WALLY_EINVAL;
+        wally_clear(redeem, sizeof(redeem));
+        return ret;
+    }
+    return WALLY_EINVAL; /* Unsupported script type */
+}
+
+/* Set the scriptSig and witness of a signed input */
+static int sign_input_finalize(struct wally_tx *tx, size_t index,
+                               const struct sign_input *in,
+                               const unsigned char *sig, uint32_t sighash)
+{
+    unsigned char script[WALLY_SCRIPTSIG_P2PKH_MAX_LEN], der[EC_SIGNATURE_DER_MAX_LEN + 1];
+    struct wally_tx_witness_stack *witness = NULL;
+    size_t script_len = 0, der_len;
+    int ret;
+
+    if (in->type == SIGN_P2PKH)
+        ret = wally_scriptsig_p2pkh_from_sig(in->pub_key, sizeof(in->pub_key),
+                                             sig, EC_SIGNATURE_LEN, sighash,
+                                             script, sizeof(script), &script_len);
+    else {
+        if (in->type == SIGN_P2SH_P2WPKH) {
+            /* A push of the p2wpkh witness program */
+            script[0] = WALLY_SCRIPTPUBKEY_P2WPKH_LEN;
+            script[1] = OP_0;
+            script[2] = HASH160_LEN;
+            memcpy(script + 3, in->script_code + 3, HASH160_LEN);
+            script_len = WALLY_SCRIPTPUBKEY_P2WPKH_LEN + 1;
+        }
+        ret = wally_ec_sig_to_der(sig, EC_SIGNATURE_LEN, der, sizeof(der), &der_len);
+        if (ret == WALLY_OK) {
+            der[der_len++] = (unsigned char)sighash;
+            ret = wally_tx_witness_stack_init_alloc(2, &witness);
+        }
+        if (ret == WALLY_OK)
+            ret = wally_tx_witness_stack_add(witness, der, der_len);
+        if (ret == WALLY_OK)
+            ret = wally_tx_witness_stack_add(witness, in->pub_key, sizeof(in->pub_key));
+    }
+    if (ret == WALLY_OK)
+        ret = wally_tx_set_input_script(tx, index, script_len ? script : NULL, script_len);
+    if (ret == WALLY_OK) {
+        tx_set_input_witness(tx->inputs + index, witness);
+        witness = NULL;
+    }
+    wally_tx_witness_stack_free(witness);
+    wally_clear(der, sizeof(der));
+    return ret;
+}
+
+int wally_tx_sign_inputs_parallel(struct wally_tx *tx,
+                                  const unsigned char *scripts, size_t scripts_len,
+                                  const uint64_t *values, size_t values_len,
+                                  const unsigned char *priv_keys, size_t priv_keys_len,
+                                  uint32_t sighash, uint32_t flags,
+                                  wally_run_tasks_t run_fn, void *run_ctx)
+{
+    struct wally_tx_sighash_ctx ctx;
+    struct tx_legacy_sighash legacy;
+    const unsigned char *end = scripts + scripts_len;
+    struct sign_input *ins = NULL;
+    unsigned char *hashes = NULL, *sigs = NULL;
+    size_t is_elements, n, i, written;
+    int ret;
+
+    if (!is_mutable_tx(tx) || !tx->num_inputs || !scripts || !scripts_len ||
+        !values || values_len != tx->num_inputs ||
+        !priv_keys || priv_keys_len != tx->num_inputs * EC_PRIVATE_KEY_LEN ||
+        !sighash || (sighash & 0xffffff00) || (flags & ~EC_FLAG_GRIND_R))
+        return WALLY_EINVAL;
+
+    if ((ret = wally_tx_is_elements(tx, &is_elements)) != WALLY_OK)
+        return ret;
+    if (is_elements)
+        return WALLY_EINVAL; /* Elements signing is not supported */
+
+    n = tx->num_inputs;
+    ins = wally_malloc(n * sizeof(*ins));
+    hashes = wally_malloc(n * SHA256_LEN);
+    sigs = wally_malloc(n * EC_SIGNATURE_LEN);
+    if (!ins || !hashes || !sigs) {
+        ret = WALLY_ENOMEM;
+        goto cleanup;
+    }
+
+    /* Signature hashes do not depend on the scriptSigs or witnesses
+     * being written, so compute them all up front */
+    if ((ret = wally_tx_sighash_ctx_init(tx, 0, &ctx)) != WALLY_OK)
+        goto cleanup;
+    wally_clear(&legacy, sizeof(legacy));
+    for (i = 0; i < n && ret == WALLY_OK; ++i) {
+        const unsigned char *priv_key = priv_keys + i * EC_PRIVATE_KEY_LEN;
+        uint64_t script_len;
+
+        if (scripts >= end || scripts + varint_length_from_bytes(scripts) > end) {
+            ret = WALLY_EINVAL;
+            break;
+        }
+        scripts += varint_from_bytes(scripts, &script_len);
+        if (!script_len || script_len > (uint64_t)(end - scripts)) {
+            ret = WALLY_EINVAL;
+            break;
+        }
+        ret = sign_input_init(priv_key, scripts, script_len, ins + i);
+        if (ret == WALLY_OK)
+            ret = tx_get_signature_hash(tx, &ctx, &legacy, i,
+                                        ins[i].script_code, sizeof(ins[i].script_code),
+                                        NULL, 0, 0, values[i], NULL, 0,
+                                        sighash, sighash,
+                                        ins[i].type == SIGN_P2PKH ? 0 : WALLY_TX_FLAG_USE_WITNESS,
+                                        hashes + i * SHA256_LEN, SHA256_LEN);
+        scripts += script_len;
+    }
+    if (ret == WALLY_OK && scripts != end)
+        ret = WALLY_EINVAL; /* Trailing data after the last script */
+    wally_clear(&ctx, sizeof(ctx));
+    wally_clear(&legacy, sizeof(legacy));
+
+    if (ret == WALLY_OK)
+        ret = wally_ec_sig_from_bytes_batch_parallel(priv_keys, priv_keys_len,
+                                                     hashes, n * SHA256_LEN,
+                                                     EC_FLAG_ECDSA | flags,
+                                                     run_fn, run_ctx,
+                                                     sigs, n * EC_SIGNATURE_LEN,
+                                                     &written);
+    for (i = 0; i < n && ret == WALLY_OK; ++i)
+        ret = sign_input_finalize(tx, i, ins + i, sigs + i * EC_SIGNATURE_LEN, sighash);
+
+cleanup:
+    clear_public_and_free(ins, n * sizeof(*ins));
+    clear_public_and_free(hashes, n * SHA256_LEN);
+    clear_public_and_free(sigs, n * EC_SIGNATURE_LEN);
+    return ret;
+}
+
+int wally_tx_sign_inputs(struct wally_tx *tx,
+                         const unsigned char *scripts, size_t scripts_len,
+                         const uint64_t *values, size_t values_len,
+                         const unsigned char *priv_keys, size_t priv_keys_len,
+                         uint32_t sighash, uint32_t flags)
+{
+    return wally_tx_sign_inputs_parallel(tx, scripts, scripts_len, values, values_len,
+                                         priv_keys, priv_keys_len, sighash, flags,
+                                         NULL, NULL);
+}
+
+/* The most keys a P2WSH multisig script verified by
+ * wally_tx_verify_input_signatures can have: OP_1 to OP_16 */
+#define VERIFY_MAX_KEYS 16
+/* A P2WSH multisig witness: a dummy item, signatures and the script */
+#define VERIFY_MAX_WITNESS_ITEMS (VERIFY_MAX_KEYS + 2)
+#define SIGN_P2WSH_MULTISIG 3
+
+/* A push of a scriptSig, or an item of a witness */
+struct verify_item {
+    const unsigned char *bytes;
+    size_t len;
+};
+
+/* The signatures and keys an input spends with */
+struct verify_spend {
+    unsigned char type;
+    struct verify_item sigs[VERIFY_MAX_KEYS];
+    struct verify_item keys[VERIFY_MAX_KEYS];
+    size_t num_sigs;
+    size_t num_keys;
+    const unsigned char *script_code;
+    size_t script_code_len;
+    unsigned char p2pkh[WALLY_SCRIPTPUBKEY_P2PKH_LEN];
+};
+
+/* Per input data for wally_tx_verify_input_signatures. Signature i may
+ * match keys i to i + num_keys - num_sigs, as for OP_CHECKMULTISIG, and
+ * each pairing is a check in the batch starting at first */
+struct verify_input {
+    size_t first;
+    size_t num_sigs;
+    size_t num_keys;
+    bool is_valid;
+};
+
+/* Split a push only scriptSig into its pushes. Returns the number of
+ * pushes, or max + 1 if there are more or the script is not push only */
+static size_t verify_get_pushes(const unsigned char *script, size_t script_len,
+                                struct verify_item *items, size_t max)
+{
+    struct wally_script_iterator iter;
+    size_t n = 0, written;
+
+    if (wally_script_iterator_init(&iter, script, script_len) != WALLY_OK)
+        return max + 1;
+    for (;;) {
+        if (wally_script_iterator_next(&iter, &written) != WALLY_OK)
+            return max + 1;
+        if (!written)
+            return n;
+        if (iter.opcode > OP_PUSHDATA4 || n == max)
+            return max + 1;
+        items[n].bytes = iter.push;
+        items[n++].len = iter.push_len;
+    }
+}
+
+/* Get the items of an input's witness. Returns the number of items,
+ * or max + 1 if there are more */
+static size_t verify_get_witness(const struct wally_tx_input *input,
+                                 struct verify_item *items, size_t max)
+{
+    size_t i;
 
-#endif /* BUILD_ELEMENTS */
-    return WALLY_OK;
-fail:
-    tx_free(result, true);
-    *output = NULL;
-    return ret;
+    if (!input->witness)
+        return 0;
+    if (input->witness->num_items > max)
+        return max + 1;
+    for (i = 0; i < input->witness->num_items; ++i) {
+        items[i].bytes = input->witness->items[i].witness;
+        items[i].len = input->witness->items[i].witness_len;
+    }
+    return input->witness->num_items;
 }
 
-int wally_tx_from_bytes(const unsigned char *bytes, size_t bytes_len,
-                        uint32_t flags, struct wally_tx **output)
+static bool verify_hash160_matches(const struct verify_item *item,
+                                   const unsigned char *hash)
 {
-    return tx_from_bytes(bytes, bytes_len, flags & ~WALLY_TX_FLAG_USE_ELEMENTS, output,
-                         flags & WALLY_TX_FLAG_USE_ELEMENTS);
+    unsigned char h[HASH160_LEN];
+    return wally_hash160(item->bytes, item->len, h, sizeof(h)) == WALLY_OK &&
+           !memcmp(h, hash, sizeof(h));
 }
 
-int wally_tx_from_hex(const char *hex, uint32_t flags,
-                      struct wally_tx **output)
+/* Parse an m-of-n multisig script into its keys */
+static bool verify_parse_multisig(const struct verify_item *script,
+                                  struct verify_spend *spend)
 {
-    unsigned char buff[TX_STACK_SIZE], *buff_p = buff;
-    size_t hex_len = hex ? strlen(hex) : 0, bin_len;
+    struct wally_script_iterator iter;
     size_t written;
-    int ret;
-
-    if (!hex || hex_len & 0x1 || !output)
-        return WALLY_EINVAL;
-
-    bin_len = hex_len / 2;
 
-    if (bin_len > sizeof(buff)) {
-        if ((buff_p = wally_malloc(bin_len)) == NULL)
-            return WALLY_ENOMEM;
+    spend->num_keys = 0;
+    if (wally_script_iterator_init(&iter, script->bytes, script->len) != WALLY_OK ||
+        wally_script_iterator_next(&iter, &written) != WALLY_OK || !written ||
+        iter.opcode < OP_1 || iter.opcode > OP_16)
+        return false;
+    spend->num_sigs = iter.opcode - OP_1 + 1;
+    for (;;) {
+        if (wally_script_iterator_next(&iter, &written) != WALLY_OK || !written)
+            return false;
+        if (iter.opcode > OP_PUSHDATA4)
+            break;
+        if (spend->num_keys == VERIFY_MAX_KEYS)
+            return false;
+        spend->keys[spend->num_keys].bytes = iter.push;
+        spend->keys[spend->num_keys++].len = iter.push_len;
     }
-    ret = wally_hex_to_bytes(hex, buff_p, bin_len, &written);
-    if (ret == WALLY_OK)
-        ret = tx_from_bytes(buff_p, bin_len, flags, output,
-                            flags & WALLY_TX_FLAG_USE_ELEMENTS);
-
-    if (buff_p != buff)
-        clear_and_free(buff_p, bin_len);
-    else
-        wally_clear(buff, bin_len);
-
-    return ret;
+    if (iter.opcode < OP_1 || iter.opcode > OP_16 ||
+        (size_t)(iter.opcode - OP_1 + 1) != spend->num_keys ||
+        spend->num_sigs > spend->num_keys ||
+        wally_script_iterator_next(&iter, &written) != WALLY_OK || !written ||
+        iter.opcode != OP_CHECKMULTISIG)
+        return false;
+    return wally_script_iterator_next(&iter, &written) == WALLY_OK && !written;
 }
 
-int wally_tx_is_elements(const struct wally_tx *tx, size_t *written)
+/* Find the signatures and keys of an input from its scriptSig and witness,
+ * checking they match the script it spends */
+static int verify_spend_init(const struct wally_tx_input *input,
+                             const unsigned char *script, size_t script_len,
+                             struct verify_spend *spend)
 {
-    if (!tx || !written)
+    struct verify_item items[VERIFY_MAX_WITNESS_ITEMS], redeem;
+    unsigned char hash[SHA256_LEN];
+    const unsigned char *program = script + 2;
+    size_t num_items, written;
+
+    num_items = verify_get_witness(input, items, VERIFY_MAX_WITNESS_ITEMS);
+    if (num_items > VERIFY_MAX_WITNESS_ITEMS)
         return WALLY_EINVAL;
+    spend->num_sigs = spend->num_keys = 1;
 
-    *written = is_valid_elements_tx(tx);
+    switch (scriptpubkey_get_type(script, script_len)) {
+    case WALLY_SCRIPT_TYPE_P2PKH:
+        if (num_items || verify_get_pushes(input->script, input->script_len, items, 2) != 2 ||
+            !verify_hash160_matches(items + 1, script + 3))
+            return WALLY_EINVAL;
+        spend->type = SIGN_P2PKH;
+        spend->sigs[0] = items[0];
+        spend->keys[0] = items[1];
+        spend->script_code = script;
+        spend->script_code_len = script_len;
+        return WALLY_OK;
+    case WALLY_SCRIPT_TYPE_P2SH:
+        /* Only p2sh-p2wpkh is supported */
+        if (verify_get_pushes(input->script, input->script_len, &redeem, 1) != 1 ||
+            redeem.len != WALLY_SCRIPTPUBKEY_P2WPKH_LEN ||
+            redeem.bytes[0] != OP_0 || redeem.bytes[1] != HASH160_LEN ||
+            !verify_hash160_matches(&redeem, script + 2))
+            return WALLY_EINVAL;
+        program = redeem.bytes + 2;
+        spend->type = SIGN_P2SH_P2WPKH;
+        break;
+    case WALLY_SCRIPT_TYPE_P2WPKH:
+        spend->type = SIGN_P2WPKH;
+        break;
+    case WALLY_SCRIPT_TYPE_P2WSH:
+        /* A dummy item for the OP_CHECKMULTISIG bug, signatures, the script */
+        if (input->script_len || num_items < 3 || items[0].len ||
+            wally_sha256(items[num_items - 1].bytes, items[num_items - 1].len,
+                         hash, sizeof(hash)) != WALLY_OK ||
+            memcmp(hash, script + 2, SHA256_LEN) ||
+            !verify_parse_multisig(items + num_items - 1, spend) ||
+            spend->num_sigs != num_items - 2)
+            return WALLY_EINVAL;
+        spend->type = SIGN_P2WSH_MULTISIG;
+        memcpy(spend->sigs, items + 1, spend->num_sigs * sizeof(*items));
+        spend->script_code = items[num_items - 1].bytes;
+        spend->script_code_len = items[num_items - 1].len;
+        return WALLY_OK;
+    default:
+        return WALLY_EINVAL; /* Unsupported script type */
+    }
 
-    return WALLY_OK;
+    /* p2wpkh, native or nested */
+    if ((spend->type == SIGN_P2WPKH && input->script_len) || num_items != 2 ||
+        !verify_hash160_matches(items + 1, program))
+        return WALLY_EINVAL;
+    spend->sigs[0] = items[0];
+    spend->keys[0] = items[1];
+    spend->script_code = spend->p2pkh;
+    spend->script_code_len = sizeof(spend->p2pkh);
+    return wally_scriptpubkey_p2pkh_from_bytes(program, HASH160_LEN, 0, spend->p2pkh,
+                                               sizeof(spend->p2pkh), &written);
 }
 
-int wally_tx_elements_input_is_pegin(const struct wally_tx_input *input,
-                                     size_t *written)
+/* Get the compressed form of a public key for the batch verifier */
+static bool verify_compress_key(const struct verify_item *key, unsigned char *bytes_out)
 {
-    if (!input || !written)
-        return WALLY_EINVAL;
-
-    *written = is_valid_elements_tx_input_pegin(input);
+    unsigned char full[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
 
-    return WALLY_OK;
+    if (key->len == EC_PUBLIC_KEY_LEN) {
+        memcpy(bytes_out, key->bytes, EC_PUBLIC_KEY_LEN);
+        return key->bytes[0] == 0x02 || key->bytes[0] == 0x03;
+    }
+    if (key->len != EC_PUBLIC_KEY_UNCOMPRESSED_LEN || key->bytes[0] != 0x04)
+        return false;
+    bytes_out[0] = 0x02 | (key->bytes[EC_PUBLIC_KEY_UNCOMPRESSED_LEN - 1] & 1);
+    memcpy(bytes_out + 1, key->bytes + 1, EC_PUBLIC_KEY_LEN - 1);
+    /* Only x and the parity of y are verified with, so check y is correct */
+    return wally_ec_public_key_decompress(bytes_out, EC_PUBLIC_KEY_LEN,
+                                          full, sizeof(full)) == WALLY_OK &&
+           !memcmp(full, key->bytes, sizeof(full));
 }
 
-int wally_tx_is_coinbase(const struct wally_tx *tx, size_t *written)
+/* Add the checks of an input's signatures to the batch */
+static void verify_input_add_checks(const struct wally_tx *tx,
+                                    const struct wally_tx_sighash_ctx *ctx,
+                                    struct tx_legacy_sighash *legacy,
+                                    size_t index, uint64_t satoshi,
+                                    const struct verify_spend *spend,
+                                    const struct verify_input *in,
+                                    unsigned char *pub_keys, unsigned char *hashes,
+                                    unsigned char *sigs)
 {
-    if (!tx || !written)
-        return WALLY_EINVAL;
+    const size_t window = in->num_keys - in->num_sigs + 1;
+    const uint32_t flags = spend->type == SIGN_P2PKH ? 0 : WALLY_TX_FLAG_USE_WITNESS;
+    unsigned char hash[SHA256_LEN], sig[EC_SIGNATURE_LEN], pub_key[EC_PUBLIC_KEY_LEN];
+    size_t i, j, check;
+
+    for (i = 0; i < in->num_sigs; ++i) {
+        const struct verify_item *der = spend->sigs + i;
+        bool ok = der->len > 1;
+
+        /* Failed checks are left zeroed, and fail to verify */
+        if (ok)
+            ok = wally_ec_sig_from_der(der->bytes, der->len - 1, sig, sizeof(sig)) == WALLY_OK;
+        if (ok)
+            ok = tx_get_signature_hash(tx, ctx, legacy, index,
+                                       spend->script_code, spend->script_code_len,
+                                       NULL, 0, 0, satoshi, NULL, 0,
+                                       der->bytes[der->len - 1], der->bytes[der->len - 1],
+                                       flags, hash, sizeof(hash)) == WALLY_OK;
+        for (j = i; ok && j < i + window; ++j) {
+            check = in->first + i * window + (j - i);
+            if (!verify_compress_key(spend->keys + j, pub_key))
+                continue;
+            memcpy(pub_keys + check * EC_PUBLIC_KEY_LEN, pub_key, EC_PUBLIC_KEY_LEN);
+            memcpy(hashes + check * SHA256_LEN, hash, SHA256_LEN);
+            memcpy(sigs + check * EC_SIGNATURE_LEN, sig, EC_SIGNATURE_LEN);
+        }
+    }
+}
 
-    *written = tx->num_inputs == 1 && is_valid_coinbase_input(tx->inputs);
+/* Match an input's signatures to its keys from the check results, in key
+ * order as OP_CHECKMULTISIG does */
+static bool verify_input_result(const struct verify_input *in, const unsigned char *results)
+{
+    const size_t window = in->num_keys - in->num_sigs + 1;
+    size_t i, j = 0;
 
-    return WALLY_OK;
+    if (!in->is_valid)
+        return false;
+    for (i = 0; i < in->num_sigs; ++i) {
+        while (j < i + window && !results[in->first + i * window + (j - i)])
+            ++j;
+        if (j++ == i + window)
+            return false;
+    }
+    return true;
 }
 
-static int tx_get_signature_hash(const struct wally_tx *tx,
-                                 size_t index,
-                                 const unsigned char *script, size_t script_len,
-                                 const unsigned char *extra, size_t extra_len,
-                                 uint32_t extra_offset, uint64_t satoshi,
-                                 const unsigned char *value,
-                                 size_t value_len,
-                                 uint32_t sighash, uint32_t tx_sighash, uint32_t flags,
-                                 unsigned char *bytes_out, size_t len)
+int wally_tx_verify_input_signatures_parallel(const struct wally_tx *tx,
+                                              const unsigned char *scripts,
+                                              size_t scripts_len,
+                                              const uint64_t *values, size_t values_len,
+                                              uint32_t flags,
+                                              wally_run_tasks_t run_fn, void *run_ctx,
+                                              unsigned char *bytes_out, size_t len)
 {
-    unsigned char buff[TX_STACK_SIZE], *buff_p = buff;
-    size_t n, n2;
-    size_t is_elements = 0;
+    struct wally_tx_sighash_ctx ctx;
+    struct tx_legacy_sighash legacy;
+    struct verify_spend spend;
+    const unsigned char *end = scripts + scripts_len, *p;
+    struct verify_input *ins = NULL;
+    unsigned char *pub_keys = NULL, *hashes = NULL, *sigs = NULL, *results = NULL;
+    size_t is_elements, n, i, num_checks = 0;
+    uint64_t script_len;
     int ret;
-    const struct tx_serialize_opts opts = {
-        sighash, tx_sighash, index, script, script_len, satoshi,
-        (flags & WALLY_TX_FLAG_USE_WITNESS) ? true : false,
-        value, value_len
-    };
-
-    if (!is_valid_tx(tx) || BYTES_INVALID(script, script_len) ||
-        BYTES_INVALID(extra, extra_len) ||
-        satoshi > WALLY_SATOSHI_MAX || (sighash & 0xffffff00) ||
-        (flags & ~WALLY_TX_FLAG_USE_WITNESS) || !bytes_out || len < SHA256_LEN)
-        return WALLY_EINVAL;
 
-    if (extra || extra_len || extra_offset)
-        return WALLY_ERROR; /* FIXME: Not implemented yet */
+    if (bytes_out && len)
+        wally_clear(bytes_out, len);
 
-    if (index >= tx->num_inputs ||
-        (index >= tx->num_outputs && (sighash & SIGHASH_MASK) == WALLY_SIGHASH_SINGLE)) {
-        if (!(flags & WALLY_TX_FLAG_USE_WITNESS)) {
-            memset(bytes_out, 0, SHA256_LEN);
-            bytes_out[0] = 0x1;
-            return WALLY_OK;
-        }
-    }
+    if (!is_valid_tx(tx) || !tx->num_inputs || !scripts || !scripts_len ||
+        !values || values_len != tx->num_inputs || flags ||
+        !bytes_out || len != tx->num_inputs)
+        return WALLY_EINVAL;
 
-#ifdef BUILD_ELEMENTS
     if ((ret = wally_tx_is_elements(tx, &is_elements)) != WALLY_OK)
-        goto fail;
-#endif
+        return ret;
+    if (is_elements)
+        return WALLY_EINVAL; /* Elements verification is not supported */
 
-    if ((ret = tx_get_length(tx, &opts, 0, &n, is_elements != 0)) != WALLY_OK)
-        goto fail;
+    n = tx->num_inputs;
+    if (!(ins = wally_malloc(n * sizeof(*ins))))
+        return WALLY_ENOMEM;
 
-    if (n > sizeof(buff) && (buff_p = wally_malloc(n)) == NULL) {
-        ret = WALLY_ENOMEM;
-        goto fail;
+    /* Find the signatures to check for each input */
+    for (i = 0, p = scripts; i < n; ++i) {
+        if (p >= end || p + varint_length_from_bytes(p) > end)
+            break;
+        p += varint_from_bytes(p, &script_len);
+        if (!script_len || script_len > (uint64_t)(end - p))
+            break;
+        ins[i].is_valid = verify_spend_init(tx->inputs + i, p, script_len,
+                                            &spend) == WALLY_OK;
+        ins[i].first = num_checks;
+        ins[i].num_sigs = ins[i].is_valid ? spend.num_sigs : 0;
+        ins[i].num_keys = ins[i].is_valid ? spend.num_keys : 0;
+        if (ins[i].is_valid)
+            num_checks += spend.num_sigs * (spend.num_keys - spend.num_sigs + 1);
+        p += script_len;
+    }
+    if (i != n || p != end) {
+        ret = WALLY_EINVAL; /* Malformed or trailing scripts */
+        goto cleanup;
     }
 
-    if ((ret = tx_to_bytes(tx, &opts, 0, buff_p, n, &n2, is_elements != 0)) != WALLY_OK)
-        goto fail;
+    if (num_checks) {
+        pub_keys = wally_malloc(num_checks * EC_PUBLIC_KEY_LEN);
+        hashes = wally_malloc(num_checks * SHA256_LEN);
+        sigs = wally_malloc(num_checks * EC_SIGNATURE_LEN);
+        results = wally_malloc(num_checks);
+        if (!pub_keys || !hashes || !sigs || !results) {
+            ret = WALLY_ENOMEM;
+            goto cleanup;
+        }
+        wally_clear_3(pub_keys, num_checks * EC_PUBLIC_KEY_LEN,
+                      hashes, num_checks * SHA256_LEN, sigs, num_checks * EC_SIGNATURE_LEN);
 
-    if (n != n2)
-        ret = WALLY_ERROR; /* tx_get_length/tx_to_bytes mismatch, should not happen! */
-    else
-        ret = wally_sha256d(buff_p, n2, bytes_out, len);
+        if ((ret = wally_tx_sighash_ctx_init(tx, 0, &ctx)) != WALLY_OK)
+            goto cleanup;
+        wally_clear(&legacy, sizeof(legacy));
+        for (i = 0, p = scripts; i < n; ++i) {
+            p += varint_from_bytes(p, &script_len);
+            if (ins[i].is_valid && verify_spend_init(tx->inputs + i, p, script_len,
+                                                     &spend) == WALLY_OK)
+                verify_input_add_checks(tx, &ctx, &legacy, i, values[i], &spend,
+                                        ins + i, pub_keys, hashes, sigs);
+            p += script_len;
+        }
+        wally_clear(&ctx, sizeof(ctx));
+        wally_clear(&legacy, sizeof(legacy));
+
+        ret = wally_ec_sig_verify_batch(pub_keys, num_checks * EC_PUBLIC_KEY_LEN,
+                                        hashes, num_checks * SHA256_LEN, EC_FLAG_ECDSA,
+                                        sigs, num_checks * EC_SIGNATURE_LEN,
+                                        run_fn, run_ctx, results, num_checks);
+        if (ret == WALLY_ENOMEM)
+            goto cleanup;
+    }
 
-fail:
-    if (buff_p != buff)
-        clear_and_free(buff_p, n);
-    else
-        wally_clear(buff, sizeof(buff));
-    return ret;
-}
+    ret = WALLY_OK;
+    for (i = 0; i < n; ++i) {
+        bytes_out[i] = verify_input_result(ins + i, results);
+        if (!bytes_out[i])
+            ret = WALLY_EINVAL;
+    }
 
-int wally_tx_get_signature_hash(const struct wally_tx *tx,
-                                size_t index,
-                                const unsigned char *script, size_t script_len,
-                                const unsigned char *extra, size_t extra_len,
-                                uint32_t extra_offset, uint64_t satoshi,
-                                uint32_t sighash, uint32_t tx_sighash, uint32_t flags,
-                                unsigned char *bytes_out, size_t len)
-{
-    return tx_get_signature_hash(tx, index, script, script_len,
-                                 extra, extra_len, extra_offset, satoshi,
-                                 NULL, 0, sighash, tx_sighash, flags, bytes_out, len);
+cleanup:
+    clear_public_and_free(ins, n * sizeof(*ins));
+    clear_public_and_free(pub_keys, num_checks * EC_PUBLIC_KEY_LEN);
+    clear_public_and_free(hashes, num_checks * SHA256_LEN);
+    clear_public_and_free(sigs, num_checks * EC_SIGNATURE_LEN);
+    clear_public_and_free(results, num_checks);
+    return ret;
 }
 
-int wally_tx_get_btc_signature_hash(const struct wally_tx *tx, size_t index,
-                                    const unsigned char *script, size_t script_len,
-                                    uint64_t satoshi, uint32_t sighash, uint32_t flags,
-                                    unsigned char *bytes_out, size_t len)
+int wally_tx_verify_input_signatures(const struct wally_tx *tx,
+                                     const unsigned char *scripts, size_t scripts_len,
+                                     const uint64_t *values, size_t values_len,
+                                     uint32_t flags,
+                                     unsigned char *bytes_out, size_t len)
 {
-    return wally_tx_get_signature_hash(tx, index, script, script_len,
-                                       NULL, 0, 0, satoshi, sighash, sighash,
-                                       flags, bytes_out, len);
+    return wally_tx_verify_input_signatures_parallel(tx, scripts, scripts_len,
+                                                     values, values_len, flags,
+                                                     NULL, NULL, bytes_out, len);
 }
 
 int wally_tx_get_elements_signature_hash(const struct wally_tx *tx,
@@ -2711,7 +7543,20 @@ int wally_tx_get_elements_signature_hash(const struct wally_tx *tx,
                                          uint32_t sighash, uint32_t flags,
                                          unsigned char *bytes_out, size_t len)
 {
-    return tx_get_signature_hash(tx, index, script, script_len,
+    return tx_get_signature_hash(tx, NULL, NULL, index, script, script_len,
+                                 NULL, 0, 0, 0, value, value_len,
+                                 sighash, sighash, flags, bytes_out, len);
+}
+
+int wally_tx_get_elements_signature_hash_ctx(const struct wally_tx *tx,
+                                             const struct wally_tx_sighash_ctx *ctx,
+                                             size_t index,
+                                             const unsigned char *script, size_t script_len,
+                                             const unsigned char *value, size_t value_len,
+                                             uint32_t sighash, uint32_t flags,
+                                             unsigned char *bytes_out, size_t len)
+{
+    return tx_get_signature_hash(tx, ctx, NULL, index, script, script_len,
                                  NULL, 0, 0, 0, value, value_len,
                                  sighash, sighash, flags, bytes_out, len);
 }
@@ -2729,6 +7574,46 @@ int wally_tx_confidential_value_from_satoshi(uint64_t satoshi,
     return WALLY_OK;
 }
 
+int wally_tx_confidential_value_from_satoshi_batch(const uint64_t *satoshi,
+                                                   size_t satoshi_len,
+                                                   unsigned char *bytes_out,
+                                                   size_t len)
+{
+    size_t i;
+
+    if (!satoshi || !satoshi_len || !bytes_out ||
+        len != satoshi_len * WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < satoshi_len; ++i) {
+        *bytes_out = 0x1;
+        uint64_to_be_bytes(satoshi[i], bytes_out + 1);
+        bytes_out += WALLY_TX_ASSET_CT_VALUE_UNBLIND_LEN;
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_confidential_asset_from_tag_batch(const unsigned char *asset,
+                                               size_t asset_len,
+                                               unsigned char *bytes_out,
+                                               size_t len)
+{
+    const size_t num_assets = asset_len / WALLY_TX_ASSET_TAG_LEN;
+    size_t i;
+
+    if (!asset || !num_assets || asset_len % WALLY_TX_ASSET_TAG_LEN ||
+        !bytes_out || len != num_assets * WALLY_TX_ASSET_CT_ASSET_LEN)
+        return WALLY_EINVAL;
+
+    /* Work backwards so that bytes_out may start at asset */
+    for (i = num_assets; i > 0; --i) {
+        unsigned char *dst = bytes_out + (i - 1) * WALLY_TX_ASSET_CT_ASSET_LEN;
+        memmove(dst + 1, asset + (i - 1) * WALLY_TX_ASSET_TAG_LEN, WALLY_TX_ASSET_TAG_LEN);
+        *dst = 0x1;
+    }
+    return WALLY_OK;
+}
+
 int wally_tx_elements_issuance_generate_entropy(const unsigned char *txhash,
                                                 size_t txhash_len,
                                                 uint32_t index,
@@ -2815,6 +7700,106 @@ int wally_tx_elements_issuance_calculate_reissuance_token(const unsigned char *e
                                         bytes_out, len);
 }
 
+#ifdef BUILD_ELEMENTS
+/* Compute the entropy, asset and reissuance token of an issuance input */
+static void tx_issuance_ids(const struct wally_tx_input *input,
+                            struct sha256_ctx *ctx, unsigned char *buff,
+                            unsigned char *entropy_out, unsigned char *asset_out,
+                            unsigned char *token_out)
+{
+    static const unsigned char zero[SHA256_LEN] = { 0 };
+    const bool is_reissuance = memcmp(input->blinding_nonce, zero, SHA256_LEN) != 0;
+    struct sha256 sha;
+
+    if (is_reissuance)
+        memcpy(entropy_out, input->entropy, SHA256_LEN); /* Already the asset entropy */
+    else {
+        /* SHA256 midstate of SHA256d(prevout) and the contract hash */
+        memcpy(buff, input->txhash, WALLY_TXHASH_LEN);
+        uint32_to_le_bytes(input->index, buff + WALLY_TXHASH_LEN);
+        sha256(&sha, buff, WALLY_TXHASH_LEN + sizeof(uint32_t));
+        sha256(&sha, &sha, sizeof(sha));
+        memcpy(buff, &sha, SHA256_LEN);
+        memcpy(buff + SHA256_LEN, input->entropy, SHA256_LEN);
+        sha256_init(ctx);
+        sha256_update(ctx, buff, 2 * SHA256_LEN);
+        sha256_midstate(ctx, &sha);
+        memcpy(entropy_out, &sha, SHA256_LEN);
+    }
+
+    /* The asset and token follow the entropy with a 32 byte constant */
+    memcpy(buff, entropy_out, SHA256_LEN);
+    memset(buff + SHA256_LEN, 0, SHA256_LEN);
+    sha256_init(ctx);
+    sha256_update(ctx, buff, 2 * SHA256_LEN);
+    sha256_midstate(ctx, &sha);
+    memcpy(asset_out, &sha, SHA256_LEN);
+
+    if (is_reissuance)
+        memset(token_out, 0, SHA256_LEN); /* The token was created at issuance */
+    else {
+        /* '1' for an unblinded initial issuance, '2' for a confidential one */
+        buff[SHA256_LEN] = input->issuance_amount_len == WALLY_TX_ASSET_CT_VALUE_LEN ? 2 : 1;
+        sha256_init(ctx);
+        sha256_update(ctx, buff, 2 * SHA256_LEN);
+        sha256_midstate(ctx, &sha);
+        memcpy(token_out, &sha, SHA256_LEN);
+    }
+    wally_clear(&sha, sizeof(sha));
+}
+#endif /* BUILD_ELEMENTS */
+
+int wally_tx_elements_issuance_calculate_ids(const struct wally_tx *tx,
+                                             uint32_t *index_out,
+                                             unsigned char *entropy_out, size_t entropy_out_len,
+                                             unsigned char *asset_out, size_t asset_out_len,
+                                             unsigned char *token_out, size_t token_out_len,
+                                             size_t len, size_t *written)
+{
+#ifdef BUILD_ELEMENTS
+    unsigned char buff[2 * SHA256_LEN];
+    struct sha256_ctx ctx;
+    size_t i;
+
+    if (written)
+        *written = 0;
+    if (!is_valid_tx(tx) || !index_out || !entropy_out || !asset_out || !token_out ||
+        !len || entropy_out_len != len * SHA256_LEN ||
+        asset_out_len != len * SHA256_LEN || token_out_len != len * SHA256_LEN ||
+        !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+
+        if (!(input->features & WALLY_TX_IS_ISSUANCE))
+            continue;
+        if (*written < len) {
+            const size_t offset = *written * SHA256_LEN;
+            index_out[*written] = i;
+            tx_issuance_ids(input, &ctx, buff, entropy_out + offset,
+                            asset_out + offset, token_out + offset);
+        }
+        *written += 1;
+    }
+    wally_clear_2(buff, sizeof(buff), &ctx, sizeof(ctx));
+    return WALLY_OK;
+#else
+    (void)tx;
+    (void)index_out;
+    (void)entropy_out;
+    (void)entropy_out_len;
+    (void)asset_out;
+    (void)asset_out_len;
+    (void)token_out;
+    (void)token_out_len;
+    (void)len;
+    if (written)
+        *written = 0;
+    return WALLY_ERROR;
+#endif
+}
+
 int wally_tx_get_total_output_satoshi(const struct wally_tx *tx, uint64_t *value_out)
 {
     size_t i;
@@ -2839,11 +7824,108 @@ int wally_tx_get_total_output_satoshi(const struct wally_tx *tx, uint64_t *value
     return WALLY_OK;
 }
 
+/* Compute the fee of a BTC transaction given the values its inputs spend */
+static int tx_get_fee(const struct wally_tx *tx,
+                      const uint64_t *values, size_t values_len,
+                      uint64_t *value_out)
+{
+    uint64_t total_in = 0, total_out;
+    size_t i, is_elements = 0;
+
+    *value_out = 0;
+#ifdef BUILD_ELEMENTS
+    if (wally_tx_is_elements(tx, &is_elements) != WALLY_OK)
+        return WALLY_EINVAL;
+#endif
+    if (is_elements || (!values && values_len) || !is_valid_tx(tx) ||
+        values_len != tx->num_inputs ||
+        wally_tx_get_total_output_satoshi(tx, &total_out) != WALLY_OK)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < values_len; ++i) {
+        if (values[i] > WALLY_SATOSHI_MAX - total_in)
+            return WALLY_EINVAL; /* Overflow or too many satoshi in inputs */
+        total_in += values[i];
+    }
+    if (total_in < total_out)
+        return WALLY_EINVAL; /* Outputs spend more than the inputs */
+    *value_out = total_in - total_out;
+    return WALLY_OK;
+}
+
+/* Compute the fee rate of a transaction in satoshi per 1000 vbytes */
+static int tx_get_fee_rate(const struct wally_tx *tx,
+                           const uint64_t *values, size_t values_len,
+                           uint64_t *value_out)
+{
+    uint64_t fee;
+    size_t vsize;
+    int ret = tx_get_fee(tx, values, values_len, &fee);
+
+    if (ret == WALLY_OK)
+        ret = wally_tx_get_vsize(tx, &vsize);
+    if (ret == WALLY_OK && !vsize)
+        ret = WALLY_EINVAL;
+    /* fee is at most WALLY_SATOSHI_MAX, so this cannot overflow */
+    *value_out = ret == WALLY_OK ? fee * 1000 / vsize : 0;
+    return ret;
+}
+
+int wally_tx_get_fee(const struct wally_tx *tx,
+                     const uint64_t *values, size_t values_len,
+                     uint64_t *value_out)
+{
+    if (!value_out)
+        return WALLY_EINVAL;
+    return tx_get_fee(tx, values, values_len, value_out);
+}
+
+int wally_tx_get_fee_rate(const struct wally_tx *tx,
+                          const uint64_t *values, size_t values_len,
+                          uint64_t *value_out)
+{
+    if (!value_out)
+        return WALLY_EINVAL;
+    return tx_get_fee_rate(tx, values, values_len, value_out);
+}
+
+int wally_tx_get_fee_rates(const struct wally_tx *const *txs, size_t num_txs,
+                           const uint64_t *values, size_t values_len,
+                           uint64_t *fee_rates_out, size_t fee_rates_len)
+{
+    size_t i, offset = 0;
+    int ret = WALLY_OK;
+
+    if (!txs || !num_txs || !values || !fee_rates_out || fee_rates_len != num_txs)
+        return WALLY_EINVAL;
+
+    for (i = 0; ret == WALLY_OK && i < num_txs; ++i) {
+        const size_t num_inputs = txs[i] ? txs[i]->num_inputs : 0;
+        if (!txs[i] || num_inputs > values_len - offset)
+            ret = WALLY_EINVAL;
+        else
+            ret = tx_get_fee_rate(txs[i], values + offset, num_inputs,
+                                  fee_rates_out + i);
+        offset += num_inputs;
+    }
+    if (ret == WALLY_OK && offset != values_len)
+        ret = WALLY_EINVAL; /* Values given for more inputs than the txs have */
+    if (ret != WALLY_OK)
+        wally_clear(fee_rates_out, fee_rates_len * sizeof(*fee_rates_out));
+    return ret;
+}
+
 static struct wally_tx_input *tx_get_input(const struct wally_tx *tx, size_t index)
 {
     return is_valid_tx(tx) && index < tx->num_inputs ? &tx->inputs[index] : NULL;
 }
 
+/* As tx_get_input, returning NULL if the input may not be modified */
+static struct wally_tx_input *tx_get_mutable_input(const struct wally_tx *tx, size_t index)
+{
+    return is_mutable_tx(tx) ? tx_get_input(tx, index) : NULL;
+}
+
 
 #if defined (SWIG_JAVA_BUILD) || defined (SWIG_PYTHON_BUILD) || defined (SWIG_JAVASCRIPT_BUILD)
 
@@ -2889,7 +7971,8 @@ int wally_tx_input_get_txhash(const struct wally_tx_input *input,
 
 GET_TX_B(tx_input, script, input->script_len)
 static bool get_witness_preamble(const struct wally_tx_input *input,
-                                 size_t index, size_t *written)
+                                 size_t index, size_t *written,
+                                 const unsigned char **witness, size_t *witness_len)
 {
     if (written)
         *written = 0;
@@ -2897,18 +7980,23 @@ static bool get_witness_preamble(const struct wally_tx_input *input,
         !is_valid_witness_stack(input->witness) ||
         index >= input->witness->num_items)
         return false;
+    *witness = input->witness->items[index].witness;
+    *witness_len = input->witness->items[index].witness_len;
     return true;
 }
 
 int wally_tx_input_get_witness(const struct wally_tx_input *input, size_t index,
                                unsigned char *bytes_out, size_t len, size_t *written)
 {
-    if (!bytes_out || !get_witness_preamble(input, index, written) ||
-        len < input->witness->items[index].witness_len)
+    const unsigned char *witness;
+    size_t witness_len;
+
+    if (!bytes_out ||
+        !get_witness_preamble(input, index, written, &witness, &witness_len) ||
+        len < witness_len)
         return WALLY_EINVAL;
-    memcpy(bytes_out, input->witness->items[index].witness,
-           input->witness->items[index].witness_len);
-    *written = input->witness->items[index].witness_len;
+    memcpy(bytes_out, witness, witness_len);
+    *written = witness_len;
     return WALLY_OK;
 }
 
@@ -2919,9 +8007,12 @@ GET_TX_I(tx_input, script_len, size_t)
 int wally_tx_input_get_witness_len(const struct wally_tx_input *input,
                                    size_t index, size_t *written)
 {
-    if (!get_witness_preamble(input, index, written))
+    const unsigned char *witness;
+    size_t witness_len;
+
+    if (!get_witness_preamble(input, index, written, &witness, &witness_len))
         return WALLY_EINVAL;
-    *written = input->witness->items[index].witness_len;
+    *written = witness_len;
     return WALLY_OK;
 }
 
@@ -2937,14 +8028,16 @@ GET_TX_I(tx, num_outputs, size_t)
 int wally_tx_output_set_script(struct wally_tx_output *output,
                                const unsigned char *script, size_t script_len)
 {
-    if (!is_valid_tx_output(output) || BYTES_INVALID(script, script_len))
+    if (!is_valid_tx_output(output) || (output->features & WALLY_TX_READ_ONLY) ||
+        BYTES_INVALID(script, script_len))
         return WALLY_EINVAL;
-    return replace_script(script, script_len, &output->script, &output->script_len);
+    return replace_bytes(script, script_len, &output->script, &output->script_len);
 }
 
 int wally_tx_output_set_satoshi(struct wally_tx_output *output, uint64_t satoshi)
 {
-    if (!is_valid_tx_output(output) || satoshi > WALLY_SATOSHI_MAX)
+    if (!is_valid_tx_output(output) || (output->features & WALLY_TX_READ_ONLY) ||
+        satoshi > WALLY_SATOSHI_MAX)
         return WALLY_EINVAL;
     output->satoshi = satoshi;
     return WALLY_OK;
@@ -2955,6 +8048,12 @@ static struct wally_tx_output *tx_get_output(const struct wally_tx *tx, size_t i
     return is_valid_tx(tx) && index < tx->num_outputs ? &tx->outputs[index] : NULL;
 }
 
+/* As tx_get_output, returning NULL if the output may not be modified */
+static struct wally_tx_output *tx_get_mutable_output(const struct wally_tx *tx, size_t index)
+{
+    return is_mutable_tx(tx) ? tx_get_output(tx, index) : NULL;
+}
+
 int wally_tx_get_input_script(const struct wally_tx *tx, size_t index,
                               unsigned char *bytes_out, size_t len, size_t *written)
 {
@@ -3009,7 +8108,7 @@ int wally_tx_get_output_satoshi(const struct wally_tx *tx, size_t index, uint64_
 
 int wally_tx_set_input_index(const struct wally_tx *tx, size_t index, uint32_t index_in)
 {
-    struct wally_tx_input *input = tx_get_input(tx, index);
+    struct wally_tx_input *input = tx_get_mutable_input(tx, index);
     if (input)
         input->index = index_in;
     return input ? WALLY_OK : WALLY_EINVAL;
@@ -3017,7 +8116,7 @@ int wally_tx_set_input_index(const struct wally_tx *tx, size_t index, uint32_t i
 
 int wally_tx_set_input_sequence(const struct wally_tx *tx, size_t index, uint32_t sequence)
 {
-    struct wally_tx_input *input = tx_get_input(tx, index);
+    struct wally_tx_input *input = tx_get_mutable_input(tx, index);
     if (input)
         input->sequence = sequence;
     return input ? WALLY_OK : WALLY_EINVAL;
@@ -3026,31 +8125,35 @@ int wally_tx_set_input_sequence(const struct wally_tx *tx, size_t index, uint32_
 int wally_tx_set_output_script(const struct wally_tx *tx, size_t index,
                                const unsigned char *script, size_t script_len)
 {
-    return wally_tx_output_set_script(tx_get_output(tx, index), script, script_len);
+    struct wally_tx_output *output = tx_get_mutable_output(tx, index);
+    if (!output)
+        return WALLY_EINVAL;
+    return wally_tx_output_set_script(output, script, script_len);
 }
 
 int wally_tx_set_output_satoshi(const struct wally_tx *tx, size_t index, uint64_t satoshi)
 {
     uint64_t current, total;
 
-    if (wally_tx_get_output_satoshi(tx, index, &current) != WALLY_OK ||
+    if (!tx_get_mutable_output(tx, index) ||
+        wally_tx_get_output_satoshi(tx, index, &current) != WALLY_OK ||
         wally_tx_get_total_output_satoshi(tx, &total) != WALLY_OK)
         return WALLY_EINVAL;
     total -= current;
     if (total + satoshi < total || total + satoshi > WALLY_SATOSHI_MAX)
         return WALLY_EINVAL;
-    return wally_tx_output_set_satoshi(tx_get_output(tx, index), satoshi);
+    return wally_tx_output_set_satoshi(tx_get_mutable_output(tx, index), satoshi);
 }
 #endif /* SWIG_JAVA_BUILD/SWIG_PYTHON_BUILD */
 
 int wally_tx_set_input_script(const struct wally_tx *tx, size_t index,
                               const unsigned char *script, size_t script_len)
 {
-    struct wally_tx_input *input = tx_get_input(tx, index);
+    struct wally_tx_input *input = tx_get_mutable_input(tx, index);
 
     if (!input || BYTES_INVALID(script, script_len))
         return WALLY_EINVAL;
-    return replace_script(script, script_len, &input->script, &input->script_len);
+    return replace_bytes(script, script_len, &input->script, &input->script_len);
 }
 
 int wally_tx_set_input_witness(const struct wally_tx *tx, size_t index,
@@ -3059,13 +8162,12 @@ int wally_tx_set_input_witness(const struct wally_tx *tx, size_t index,
     struct wally_tx_input *input;
     struct wally_tx_witness_stack *new_witness = NULL;
 
-    if (!(input = tx_get_input(tx, index)) || (stack && !is_valid_witness_stack(stack)))
+    if (!(input = tx_get_mutable_input(tx, index)) || (stack && !is_valid_witness_stack(stack)))
         return WALLY_EINVAL;
 
     if (stack && (new_witness = clone_witness(stack)) == NULL)
         return WALLY_ENOMEM;
 
-    tx_witness_stack_free(input->witness, true);
-    input->witness = new_witness;
+    tx_set_input_witness(input, new_witness);
     return WALLY_OK;
 }
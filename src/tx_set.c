@@ -0,0 +1,492 @@
+#define WALLY_STATS_ALLOC_STAT WALLY_STAT_TX_ALLOC_BYTES
+#include "internal.h"
+
+#include <include/wally_transaction.h>
+
+#include "hash_table.h"
+#include <stdbool.h>
+
+/* A transaction in a set, with its ids */
+struct tx_set_item {
+    struct wally_tx *tx;
+    unsigned char txid[WALLY_TXHASH_LEN];
+    unsigned char wtxid[WALLY_TXHASH_LEN];
+};
+
+struct wally_tx_set {
+    struct tx_set_item *items;
+    size_t num_items;
+    size_t items_allocation_len;
+    /* The transactions by txid, by wtxid and by the outpoints they spend.
+     * An entry's item is the index of its transaction plus 1; for
+     * outpoints, extra is the index of the spending input */
+    struct hash_table txids;
+    struct hash_table wtxids;
+    struct hash_table outpoints;
+};
+
+/* An outpoint, or a txid or wtxid with an index of 0 */
+struct tx_set_key {
+    const struct hash_table *table;
+    const unsigned char *txhash;
+    uint32_t index;
+};
+
+/* Hash a key. The txhashes of spent outpoints are chosen by the sender,
+ * so the hash is keyed per table */
+static uint64_t tx_set_hash(const struct hash_table *table,
+                            const unsigned char *txhash, uint32_t index)
+{
+    unsigned char buff[WALLY_TXHASH_LEN + sizeof(index)];
+
+    memcpy(buff, txhash, WALLY_TXHASH_LEN);
+    memcpy(buff + WALLY_TXHASH_LEN, &index, sizeof(index));
+    return hash_table_hash(table, buff, sizeof(buff));
+}
+
+static bool tx_set_entry_matches(const void *ctx, const struct hash_table_entry *entry,
+                                 const void *key_in)
+{
+    const struct wally_tx_set *set = ctx;
+    const struct tx_set_key *key = key_in;
+    const struct tx_set_item *item = set->items + entry->item - 1;
+
+    if (key->table == &set->txids)
+        return !memcmp(item->txid, key->txhash, WALLY_TXHASH_LEN);
+    if (key->table == &set->wtxids)
+        return !memcmp(item->wtxid, key->txhash, WALLY_TXHASH_LEN);
+    return item->tx->inputs[entry->extra].index == key->index &&
+           !memcmp(item->tx->inputs[entry->extra].txhash, key->txhash, WALLY_TXHASH_LEN);
+}
+
+/* Find the slot holding a key, or the empty slot to insert it into */
+static struct hash_table_entry *tx_set_find(const struct wally_tx_set *set,
+                                            const struct hash_table *table,
+                                            const unsigned char *txhash, uint32_t index)
+{
+    const struct tx_set_key key = { table, txhash, index };
+    return hash_table_find(table, tx_set_hash(table, txhash, index),
+                           tx_set_entry_matches, set, &key);
+}
+
+/* Look up a key, returning its entry or NULL if it is not present */
+static struct hash_table_entry *tx_set_lookup(const struct wally_tx_set *set,
+                                              const struct hash_table *table,
+                                              const unsigned char *txhash, uint32_t index)
+{
+    const struct tx_set_key key = { table, txhash, index };
+    return hash_table_lookup(table, tx_set_hash(table, txhash, index),
+                             tx_set_entry_matches, set, &key);
+}
+
+/* Insert a key into a table with space reserved for it */
+static void tx_set_insert(struct hash_table *table, struct hash_table_entry *entry,
+                          const unsigned char *txhash, uint32_t index,
+                          size_t item, size_t input)
+{
+    hash_table_insert(table, entry, tx_set_hash(table, txhash, index), item + 1, input);
+}
+
+/* Ensure that num_txs more transactions with num_inputs inputs can be added */
+static int tx_set_reserve(struct wally_tx_set *set, size_t num_txs, size_t num_inputs)
+{
+    int ret;
+
+    if (num_txs > SIZE_MAX / 4 - set->num_items)
+        return WALLY_ENOMEM;
+    if (set->num_items + num_txs > set->items_allocation_len) {
+        size_t new_len = set->items_allocation_len * 2;
+        struct tx_set_item *new_items;
+
+        if (new_len < set->num_items + num_txs)
+            new_len = set->num_items + num_txs;
+        if (new_len > SIZE_MAX / sizeof(*new_items) ||
+            !(new_items = wally_malloc(new_len * sizeof(*new_items))))
+            return WALLY_ENOMEM;
+        if (set->num_items)
+            memcpy(new_items, set->items, set->num_items * sizeof(*new_items));
+        clear_and_free(set->items, set->items_allocation_len * sizeof(*new_items));
+        set->items = new_items;
+        set->items_allocation_len = new_len;
+    }
+    ret = hash_table_reserve(&set->txids, num_txs);
+    if (ret == WALLY_OK)
+        ret = hash_table_reserve(&set->wtxids, num_txs);
+    if (ret == WALLY_OK)
+        ret = hash_table_reserve(&set->outpoints, num_inputs);
+    return ret;
+}
+
+/* Compute the txid and wtxid of a transaction */
+static int tx_set_get_ids(const struct wally_tx *tx, unsigned char *txid,
+                          unsigned char *wtxid)
+{
+    unsigned char buff[1024], *bytes = buff;
+    size_t bytes_len, written;
+    int ret;
+
+    ret = wally_tx_get_length(tx, WALLY_TX_FLAG_USE_WITNESS, &bytes_len);
+    if (ret == WALLY_OK && bytes_len > sizeof(buff) &&
+        !(bytes = wally_malloc(bytes_len)))
+        ret = WALLY_ENOMEM;
+    if (ret == WALLY_OK)
+        ret = wally_tx_to_bytes(tx, WALLY_TX_FLAG_USE_WITNESS, bytes, bytes_len, &written);
+    if (ret == WALLY_OK)
+        ret = wally_tx_get_txid_from_bytes(bytes, written, 0, txid, WALLY_TXHASH_LEN);
+    if (ret == WALLY_OK)
+        ret = wally_tx_get_wtxid_from_bytes(bytes, written, 0, wtxid, WALLY_TXHASH_LEN);
+    if (bytes != buff)
+        clear_and_free(bytes, bytes_len);
+    else
+        wally_clear(buff, sizeof(buff));
+    return ret;
+}
+
+static bool is_valid_tx_set_tx(const struct wally_tx *tx)
+{
+    size_t is_coinbase;
+#ifdef BUILD_ELEMENTS
+    size_t is_elements;
+
+    if (!tx || wally_tx_is_elements(tx, &is_elements) != WALLY_OK || is_elements)
+        return false;
+#endif /* BUILD_ELEMENTS */
+    return tx && tx->num_inputs && tx->inputs &&
+           wally_tx_is_coinbase(tx, &is_coinbase) == WALLY_OK && !is_coinbase;
+}
+
+/* Remove the outpoint entries for the first num_inputs inputs of an item */
+static void tx_set_delete_outpoints(struct wally_tx_set *set, size_t item,
+                                    size_t num_inputs)
+{
+    const struct wally_tx *tx = set->items[item].tx;
+    size_t i;
+
+    for (i = 0; i < num_inputs; ++i) {
+        struct hash_table_entry *entry = tx_set_lookup(set, &set->outpoints,
+                                                       tx->inputs[i].txhash,
+                                                       tx->inputs[i].index);
+        if (entry && entry->item == item + 1 && entry->extra == i)
+            hash_table_delete(&set->outpoints, entry);
+    }
+}
+
+int wally_tx_set_init_alloc(size_t allocation_len, uint32_t flags,
+                            struct wally_tx_set **output)
+{
+    struct wally_tx_set *result;
+    int ret;
+
+    if (output)
+        *output = NULL;
+
+    if (flags || !output)
+        return WALLY_EINVAL;
+
+    if (!(result = wally_malloc(sizeof(*result))))
+        return WALLY_ENOMEM;
+    wally_clear(result, sizeof(*result));
+    hash_table_init(&result->txids);
+    hash_table_init(&result->wtxids);
+    hash_table_init(&result->outpoints);
+
+    /* Reserve space assuming transactions have two inputs */
+    ret = WALLY_ENOMEM;
+    if (allocation_len <= SIZE_MAX / 8)
+        ret = tx_set_reserve(result, allocation_len, allocation_len * 2);
+    if (ret != WALLY_OK)
+        wally_tx_set_free(result);
+    else
+        *output = result;
+    return ret;
+}
+
+int wally_tx_set_free(struct wally_tx_set *set)
+{
+    size_t i;
+
+    if (set) {
+        for (i = 0; i < set->num_items; ++i)
+            wally_tx_free(set->items[i].tx);
+        clear_and_free(set->items, set->items_allocation_len * sizeof(*set->items));
+        hash_table_free(&set->txids);
+        hash_table_free(&set->wtxids);
+        hash_table_free(&set->outpoints);
+        clear_and_free(set, sizeof(*set));
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_set_add(struct wally_tx_set *set, const struct wally_tx *tx)
+{
+    struct tx_set_item *item;
+    struct hash_table_entry *entry;
+    unsigned char txid[WALLY_TXHASH_LEN], wtxid[WALLY_TXHASH_LEN];
+    size_t i;
+    int ret;
+
+    if (!set || !is_valid_tx_set_tx(tx))
+        return WALLY_EINVAL;
+
+    ret = tx_set_get_ids(tx, txid, wtxid);
+    if (ret == WALLY_OK && tx_set_lookup(set, &set->txids, txid, 0))
+        ret = WALLY_EINVAL; /* Already present */
+    for (i = 0; ret == WALLY_OK && i < tx->num_inputs; ++i)
+        if (tx_set_lookup(set, &set->outpoints, tx->inputs[i].txhash, tx->inputs[i].index))
+            ret = WALLY_EINVAL; /* Conflicts with a transaction in the set */
+    if (ret == WALLY_OK)
+        ret = tx_set_reserve(set, 1, tx->num_inputs);
+    if (ret != WALLY_OK)
+        return ret;
+
+    item = set->items + set->num_items;
+    if ((ret = wally_tx_clone(tx, WALLY_TX_CLONE_READ_ONLY, &item->tx)) != WALLY_OK)
+        return ret;
+    memcpy(item->txid, txid, sizeof(txid));
+    memcpy(item->wtxid, wtxid, sizeof(wtxid));
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        entry = tx_set_find(set, &set->outpoints, input->txhash, input->index);
+        if (entry->item) {
+            /* The transaction spends the same outpoint more than once */
+            tx_set_delete_outpoints(set, set->num_items, i);
+            wally_tx_free(item->tx);
+            wally_clear(item, sizeof(*item));
+            return WALLY_EINVAL;
+        }
+        tx_set_insert(&set->outpoints, entry, input->txhash, input->index,
+                      set->num_items, i);
+    }
+    tx_set_insert(&set->txids, tx_set_find(set, &set->txids, txid, 0),
+                  txid, 0, set->num_items, 0);
+    tx_set_insert(&set->wtxids, tx_set_find(set, &set->wtxids, wtxid, 0),
+                  wtxid, 0, set->num_items, 0);
+    set->num_items += 1;
+    return WALLY_OK;
+}
+
+int wally_tx_set_remove(struct wally_tx_set *set,
+                        const unsigned char *txhash, size_t txhash_len)
+{
+    struct hash_table_entry *entry;
+    struct tx_set_item *item, *last;
+    size_t index, i;
+
+    if (!set || !txhash || txhash_len != WALLY_TXHASH_LEN ||
+        !(entry = tx_set_lookup(set, &set->txids, txhash, 0)))
+        return WALLY_EINVAL;
+
+    index = entry->item - 1;
+    item = set->items + index;
+    hash_table_delete(&set->txids, entry);
+    hash_table_delete(&set->wtxids, tx_set_lookup(set, &set->wtxids, item->wtxid, 0));
+    tx_set_delete_outpoints(set, index, item->tx->num_inputs);
+    wally_tx_free(item->tx);
+
+    /* Move the last transaction into the removed slot */
+    last = set->items + set->num_items - 1;
+    if (item != last) {
+        *item = *last;
+        tx_set_lookup(set, &set->txids, item->txid, 0)->item = index + 1;
+        tx_set_lookup(set, &set->wtxids, item->wtxid, 0)->item = index + 1;
+        for (i = 0; i < item->tx->num_inputs; ++i)
+            tx_set_lookup(set, &set->outpoints, item->tx->inputs[i].txhash,
+                          item->tx->inputs[i].index)->item = index + 1;
+    }
+    wally_clear(last, sizeof(*last));
+    set->num_items -= 1;
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_num_txs(const struct wally_tx_set *set, size_t *written)
+{
+    if (written)
+        *written = 0;
+    if (!set || !written)
+        return WALLY_EINVAL;
+    *written = set->num_items;
+    return WALLY_OK;
+}
+
+static const struct tx_set_item *tx_set_get_item(const struct wally_tx_set *set,
+                                                 const unsigned char *bytes,
+                                                 size_t bytes_len, uint32_t flags)
+{
+    const struct hash_table_entry *entry;
+
+    if (!set || !bytes || bytes_len != WALLY_TXHASH_LEN || (flags & ~WALLY_TX_SET_WTXID))
+        return NULL;
+    entry = tx_set_lookup(set, flags ? &set->wtxids : &set->txids, bytes, 0);
+    return entry ? set->items + entry->item - 1 : NULL;
+}
+
+int wally_tx_set_contains(const struct wally_tx_set *set,
+                          const unsigned char *bytes, size_t bytes_len,
+                          uint32_t flags, size_t *written)
+{
+    if (written)
+        *written = 0;
+
+    if (!set || !bytes || bytes_len != WALLY_TXHASH_LEN ||
+        (flags & ~WALLY_TX_SET_WTXID) || !written)
+        return WALLY_EINVAL;
+
+    *written = tx_set_get_item(set, bytes, bytes_len, flags) ? 1 : 0;
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_tx(const struct wally_tx_set *set,
+                        const unsigned char *bytes, size_t bytes_len,
+                        uint32_t flags, const struct wally_tx **output)
+{
+    const struct tx_set_item *item;
+
+    if (output)
+        *output = NULL;
+
+    if (!output || !set || !bytes || bytes_len != WALLY_TXHASH_LEN || (flags & ~WALLY_TX_SET_WTXID))
+        return WALLY_EINVAL;
+    if ((item = tx_set_get_item(set, bytes, bytes_len, flags)))
+        *output = item->tx;
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_spender(const struct wally_tx_set *set,
+                             const unsigned char *txhash, size_t txhash_len,
+                             uint32_t utxo_index,
+                             unsigned char *bytes_out, size_t len,
+                             size_t *written)
+{
+    const struct hash_table_entry *entry;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !txhash || txhash_len != WALLY_TXHASH_LEN ||
+        !bytes_out || len != WALLY_TXHASH_LEN || !written)
+        return WALLY_EINVAL;
+
+    if ((entry = tx_set_lookup(set, &set->outpoints, txhash, utxo_index))) {
+        memcpy(bytes_out, set->items[entry->item - 1].txid, WALLY_TXHASH_LEN);
+        *written = WALLY_TXHASH_LEN;
+    }
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_conflicts(const struct wally_tx_set *set,
+                               const struct wally_tx *tx,
+                               unsigned char *bytes_out, size_t len,
+                               size_t *written)
+{
+    size_t i, j, num_conflicts = 0, *conflicts;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !tx || (tx->num_inputs && !tx->inputs) ||
+        (!bytes_out && len) || len % WALLY_TXHASH_LEN || !written)
+        return WALLY_EINVAL;
+
+    if (!tx->num_inputs)
+        return WALLY_OK;
+    if (tx->num_inputs > SIZE_MAX / sizeof(size_t) ||
+        !(conflicts = wally_malloc(tx->num_inputs * sizeof(size_t))))
+        return WALLY_ENOMEM;
+
+    /* Collect the distinct spenders of the inputs, in input order */
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct hash_table_entry *entry;
+        entry = tx_set_lookup(set, &set->outpoints, tx->inputs[i].txhash,
+                              tx->inputs[i].index);
+        if (!entry)
+            continue;
+        for (j = 0; j < num_conflicts && conflicts[j] != entry->item; ++j)
+            ; /* Check for an already found spender */
+        if (j == num_conflicts) {
+            if ((num_conflicts + 1) * WALLY_TXHASH_LEN <= len)
+                memcpy(bytes_out + num_conflicts * WALLY_TXHASH_LEN,
+                       set->items[entry->item - 1].txid, WALLY_TXHASH_LEN);
+            conflicts[num_conflicts++] = entry->item;
+        }
+    }
+    *written = num_conflicts * WALLY_TXHASH_LEN;
+    clear_and_free(conflicts, tx->num_inputs * sizeof(size_t));
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_ancestors(const struct wally_tx_set *set,
+                               const unsigned char *txhash, size_t txhash_len,
+                               unsigned char *bytes_out, size_t len,
+                               size_t *written)
+{
+    const struct hash_table_entry *entry;
+    size_t *queue, head = 0, tail = 0, i;
+    unsigned char *seen;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !txhash || txhash_len != WALLY_TXHASH_LEN ||
+        (!bytes_out && len) || len % WALLY_TXHASH_LEN || !written ||
+        !(entry = tx_set_lookup(set, &set->txids, txhash, 0)))
+        return WALLY_EINVAL;
+
+    if (!(queue = wally_malloc(set->num_items * (sizeof(size_t) + 1))))
+        return WALLY_ENOMEM;
+    seen = (unsigned char *)(queue + set->num_items);
+    wally_clear(seen, set->num_items);
+
+    /* Breadth first search of the in-set parents of each transaction */
+    seen[entry->item - 1] = 1;
+    queue[tail++] = entry->item - 1;
+    while (head < tail) {
+        const struct wally_tx *tx = set->items[queue[head++]].tx;
+        for (i = 0; i < tx->num_inputs; ++i) {
+            const struct hash_table_entry *parent;
+            parent = tx_set_lookup(set, &set->txids, tx->inputs[i].txhash, 0);
+            if (parent && !seen[parent->item - 1]) {
+                seen[parent->item - 1] = 1;
+                queue[tail++] = parent->item - 1;
+            }
+        }
+    }
+
+    /* The first queued transaction is the one whose ancestors were found */
+    for (i = 1; i < tail && i * WALLY_TXHASH_LEN <= len; ++i)
+        memcpy(bytes_out + (i - 1) * WALLY_TXHASH_LEN,
+               set->items[queue[i]].txid, WALLY_TXHASH_LEN);
+    *written = (tail - 1) * WALLY_TXHASH_LEN;
+    clear_and_free(queue, set->num_items * (sizeof(size_t) + 1));
+    return WALLY_OK;
+}
+
+int wally_tx_set_get_prevout_values(const struct wally_tx_set *set,
+                                    const struct wally_tx *tx,
+                                    uint64_t *values_out, size_t values_len,
+                                    size_t *written)
+{
+    size_t i, num_found = 0;
+
+    if (written)
+        *written = 0;
+
+    if (!set || !tx || (tx->num_inputs && !tx->inputs) ||
+        (!values_out && values_len) || values_len != tx->num_inputs || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < tx->num_inputs; ++i) {
+        const struct hash_table_entry *entry;
+        const struct wally_tx *parent;
+        entry = tx_set_lookup(set, &set->txids, tx->inputs[i].txhash, 0);
+        if (!entry)
+            continue;
+        parent = set->items[entry->item - 1].tx;
+        if (tx->inputs[i].index < parent->num_outputs) {
+            values_out[i] = parent->outputs[tx->inputs[i].index].satoshi;
+            ++num_found;
+        }
+    }
+    *written = num_found;
+    return WALLY_OK;
+}
@@ -0,0 +1,647 @@
+#include "internal.h"
+
+#include <include/wally_crypto.h>
+#include <include/wally_script.h>
+#include <include/wally_transaction.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include "script_int.h"
+
+/* Snapshot header: magic, version, record count */
+#define SNAPSHOT_MAGIC "WUTX"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_COUNT_OFFSET 8
+
+/* Record layout */
+#define RECORD_VOUT_OFFSET WALLY_TXHASH_LEN
+#define RECORD_SATOSHI_OFFSET (RECORD_VOUT_OFFSET + sizeof(uint32_t))
+#define RECORD_TYPE_OFFSET (RECORD_SATOSHI_OFFSET + sizeof(uint64_t))
+#define RECORD_PROGRAM_OFFSET (RECORD_TYPE_OFFSET + 2)
+
+/* Bitcoin core compressed txout script types. Scripts that aren't one of
+ * the special types are stored with a type of their length plus this */
+#define TXOUT_P2PKH 0
+#define TXOUT_P2SH 1
+#define TXOUT_P2PK_EVEN 2 /* Compressed pubkey, prefix 0x02 */
+#define TXOUT_P2PK_ODD 3 /* Compressed pubkey, prefix 0x03 */
+#define TXOUT_P2PK_UNCOMPRESSED_EVEN 4
+#define TXOUT_P2PK_UNCOMPRESSED_ODD 5
+#define TXOUT_NUM_SPECIAL_SCRIPTS 6
+#define TXOUT_MAX_SCRIPT_SIZE 10000 /* Larger scripts decompress as OP_RETURN */
+
+static size_t program_len_for_type(uint32_t script_type)
+{
+    switch (script_type) {
+    case WALLY_SCRIPT_TYPE_P2PKH:
+    case WALLY_SCRIPT_TYPE_P2SH:
+    case WALLY_SCRIPT_TYPE_P2WPKH:
+        return HASH160_LEN;
+    case WALLY_SCRIPT_TYPE_P2WSH:
+        return SHA256_LEN;
+    }
+    return 0;
+}
+
+/* Compare a records outpoint to the given outpoint */
+static int outpoint_cmp(const unsigned char *record,
+                        const unsigned char *txhash, uint32_t vout)
+{
+    int ret = memcmp(record, txhash, WALLY_TXHASH_LEN);
+    uint32_t record_vout;
+
+    if (ret)
+        return ret;
+    uint32_from_le_bytes(record + RECORD_VOUT_OFFSET, &record_vout);
+    return record_vout < vout ? -1 : record_vout > vout;
+}
+
+static int record_cmp(const void *lhs, const void *rhs)
+{
+    uint32_t vout;
+    uint32_from_le_bytes((const unsigned char *)rhs + RECORD_VOUT_OFFSET, &vout);
+    return outpoint_cmp(lhs, rhs, vout);
+}
+
+static bool is_valid_record(const unsigned char *record)
+{
+    const size_t program_len = program_len_for_type(record[RECORD_TYPE_OFFSET]);
+    uint64_t satoshi;
+    size_t i;
+
+    uint64_from_le_bytes(record + RECORD_SATOSHI_OFFSET, &satoshi);
+    if (satoshi > SATOSHI_MAX_MONEY || !program_len ||
+        record[RECORD_TYPE_OFFSET + 1] != program_len)
+        return false;
+    /* Padding after the program must be zero */
+    for (i = RECORD_PROGRAM_OFFSET + program_len; i < WALLY_UTXO_RECORD_LEN; ++i)
+        if (record[i])
+            return false;
+    return true;
+}
+
+/* Validate a snapshot header and get its number of records */
+static bool get_num_records(const unsigned char *bytes, size_t bytes_len,
+                            size_t *num_records)
+{
+    uint32_t version;
+    uint64_t count;
+
+    *num_records = 0;
+    if (!bytes || bytes_len < WALLY_UTXO_SNAPSHOT_HEADER_LEN ||
+        memcmp(bytes, SNAPSHOT_MAGIC, 4))
+        return false;
+    uint32_from_le_bytes(bytes + 4, &version);
+    uint64_from_le_bytes(bytes + SNAPSHOT_COUNT_OFFSET, &count);
+    bytes_len -= WALLY_UTXO_SNAPSHOT_HEADER_LEN;
+    if (version != SNAPSHOT_VERSION || bytes_len % WALLY_UTXO_RECORD_LEN ||
+        count != bytes_len / WALLY_UTXO_RECORD_LEN)
+        return false;
+    *num_records = (size_t)count;
+    return true;
+}
+
+static const unsigned char *get_record(const unsigned char *bytes, size_t i)
+{
+    return bytes + WALLY_UTXO_SNAPSHOT_HEADER_LEN + i * WALLY_UTXO_RECORD_LEN;
+}
+
+/* Binary search for an outpoint, returning its position or num_records */
+static size_t find_record(const unsigned char *bytes, size_t num_records,
+                          const unsigned char *txhash, uint32_t vout)
+{
+    size_t lo = 0, hi = num_records;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int cmp = outpoint_cmp(get_record(bytes, mid), txhash, vout);
+        if (!cmp)
+            return mid;
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return num_records;
+}
+
+static int record_to_scriptpubkey(const unsigned char *record,
+                                  unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    const unsigned char *program = record + RECORD_PROGRAM_OFFSET;
+    const size_t program_len = program_len_for_type(record[RECORD_TYPE_OFFSET]);
+
+    if (!program_len || record[RECORD_TYPE_OFFSET + 1] != program_len)
+        return WALLY_EINVAL; /* Corrupt record */
+
+    switch (record[RECORD_TYPE_OFFSET]) {
+    case WALLY_SCRIPT_TYPE_P2PKH:
+        return wally_scriptpubkey_p2pkh_from_bytes(program, program_len, 0,
+                                                   bytes_out, len, written);
+    case WALLY_SCRIPT_TYPE_P2SH:
+        return wally_scriptpubkey_p2sh_from_bytes(program, program_len, 0,
+                                                  bytes_out, len, written);
+    }
+    return wally_witness_program_from_bytes(program, program_len, 0,
+                                            bytes_out, len, written);
+}
+
+static void record_init(const unsigned char *txhash, uint32_t vout, uint64_t satoshi,
+                        size_t script_type, const unsigned char *program,
+                        size_t program_len, unsigned char *bytes_out)
+{
+    memcpy(bytes_out, txhash, WALLY_TXHASH_LEN);
+    uint32_to_le_bytes(vout, bytes_out + RECORD_VOUT_OFFSET);
+    uint64_to_le_bytes(satoshi, bytes_out + RECORD_SATOSHI_OFFSET);
+    bytes_out[RECORD_TYPE_OFFSET] = (unsigned char)script_type;
+    bytes_out[RECORD_TYPE_OFFSET + 1] = (unsigned char)program_len;
+    memcpy(bytes_out + RECORD_PROGRAM_OFFSET, program, program_len);
+    memset(bytes_out + RECORD_PROGRAM_OFFSET + program_len, 0,
+           WALLY_UTXO_RECORD_LEN - RECORD_PROGRAM_OFFSET - program_len);
+}
+
+int wally_utxo_record_from_script(const unsigned char *txhash, size_t txhash_len,
+                                  uint32_t vout, uint64_t satoshi,
+                                  const unsigned char *script, size_t script_len,
+                                  unsigned char *bytes_out, size_t len)
+{
+    size_t script_type, program_len;
+    int ret;
+
+    if (!txhash || txhash_len != WALLY_TXHASH_LEN ||
+        satoshi > SATOSHI_MAX_MONEY || !script || !script_len ||
+        !bytes_out || len != WALLY_UTXO_RECORD_LEN)
+        return WALLY_EINVAL;
+
+    ret = wally_scriptpubkey_get_type(script, script_len, &script_type);
+    if (ret != WALLY_OK)
+        return ret;
+    if (!(program_len = program_len_for_type(script_type)))
+        return WALLY_EINVAL; /* Not a single key or script hash type */
+
+    /* The program is the hash at the end of the script, except for P2PKH
+     * where it is followed by OP_EQUALVERIFY OP_CHECKSIG */
+    record_init(txhash, vout, satoshi, script_type,
+                script + script_len - program_len -
+                (script_type == WALLY_SCRIPT_TYPE_P2PKH ? 2 : 0) -
+                (script_type == WALLY_SCRIPT_TYPE_P2SH ? 1 : 0),
+                program_len, bytes_out);
+    return WALLY_OK;
+}
+
+int wally_utxo_snapshot_from_records(const unsigned char *bytes, size_t bytes_len,
+                                     unsigned char *bytes_out, size_t len,
+                                     size_t *written)
+{
+    const size_t num_records = bytes_len / WALLY_UTXO_RECORD_LEN;
+    unsigned char *records = bytes_out + WALLY_UTXO_SNAPSHOT_HEADER_LEN;
+    size_t i;
+
+    if (written)
+        *written = 0;
+
+    if ((!bytes && bytes_len) || bytes_len % WALLY_UTXO_RECORD_LEN ||
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_records; ++i)
+        if (!is_valid_record(bytes + i * WALLY_UTXO_RECORD_LEN))
+            return WALLY_EINVAL;
+
+    *written = WALLY_UTXO_SNAPSHOT_HEADER_LEN + bytes_len;
+    if (len < *written)
+        return WALLY_OK; /* Tell the caller the required length */
+
+    if (bytes_len)
+        memmove(records, bytes, bytes_len); /* bytes may overlap bytes_out */
+    memcpy(bytes_out, SNAPSHOT_MAGIC, 4);
+    uint32_to_le_bytes(SNAPSHOT_VERSION, bytes_out + 4);
+    uint64_to_le_bytes(num_records, bytes_out + SNAPSHOT_COUNT_OFFSET);
+    qsort(records, num_records, WALLY_UTXO_RECORD_LEN, record_cmp);
+
+    for (i = 1; i < num_records; ++i) {
+        if (!record_cmp(records + (i - 1) * WALLY_UTXO_RECORD_LEN,
+                        records + i * WALLY_UTXO_RECORD_LEN)) {
+            /* Duplicate outpoint */
+            wally_clear(bytes_out, *written);
+            *written = 0;
+            return WALLY_EINVAL;
+        }
+    }
+    return WALLY_OK;
+}
+
+int wally_utxo_snapshot_get_num_records(const unsigned char *bytes, size_t bytes_len,
+                                        size_t *written)
+{
+    size_t num_records;
+
+    if (written)
+        *written = 0;
+    if (!get_num_records(bytes, bytes_len, &num_records) || !written)
+        return WALLY_EINVAL;
+    *written = num_records;
+    return WALLY_OK;
+}
+
+int wally_utxo_snapshot_find(const unsigned char *bytes, size_t bytes_len,
+                             const unsigned char *txhash, size_t txhash_len,
+                             uint32_t vout, size_t *written)
+{
+    size_t num_records;
+
+    if (written)
+        *written = 0;
+    if (!get_num_records(bytes, bytes_len, &num_records) ||
+        !txhash || txhash_len != WALLY_TXHASH_LEN || !written)
+        return WALLY_EINVAL;
+    *written = find_record(bytes, num_records, txhash, vout);
+    return WALLY_OK;
+}
+
+int wally_utxo_snapshot_get(const unsigned char *bytes, size_t bytes_len,
+                            size_t index,
+                            unsigned char *txhash_out, size_t txhash_len,
+                            uint32_t *vout_out, uint64_t *satoshi_out)
+{
+    const unsigned char *record;
+    size_t num_records;
+
+    if (!get_num_records(bytes, bytes_len, &num_records) || index >= num_records ||
+        (txhash_out && txhash_len != WALLY_TXHASH_LEN) ||
+        (!txhash_out && txhash_len))
+        return WALLY_EINVAL;
+
+    record = get_record(bytes, index);
+    if (txhash_out)
+        memcpy(txhash_out, record, WALLY_TXHASH_LEN);
+    if (vout_out)
+        uint32_from_le_bytes(record + RECORD_VOUT_OFFSET, vout_out);
+    if (satoshi_out)
+        uint64_from_le_bytes(record + RECORD_SATOSHI_OFFSET, satoshi_out);
+    return WALLY_OK;
+}
+
+int wally_utxo_snapshot_get_scriptpubkey(const unsigned char *bytes, size_t bytes_len,
+                                         size_t index,
+                                         unsigned char *bytes_out, size_t len,
+                                         size_t *written)
+{
+    size_t num_records;
+
+    if (written)
+        *written = 0;
+    if (!get_num_records(bytes, bytes_len, &num_records) || index >= num_records ||
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+    return record_to_scriptpubkey(get_record(bytes, index), bytes_out, len, written);
+}
+
+int wally_utxo_snapshot_get_prevouts(const unsigned char *bytes, size_t bytes_len,
+                                     const struct wally_tx *tx,
+                                     uint64_t *values_out, size_t values_len,
+                                     unsigned char *bytes_out, size_t len,
+                                     size_t *written)
+{
+    size_t num_records, i, pos = 0;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!get_num_records(bytes, bytes_len, &num_records) ||
+        !tx || (tx->num_inputs && !tx->inputs) || !values_out || values_len != tx->num_inputs || !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < tx->num_inputs && ret == WALLY_OK; ++i) {
+        const struct wally_tx_input *input = tx->inputs + i;
+        const size_t n = find_record(bytes, num_records, input->txhash, input->index);
+        const unsigned char *record = get_record(bytes, n);
+        unsigned char script[WALLY_SCRIPTPUBKEY_P2PKH_LEN];
+        size_t script_len;
+
+        if (n == num_records) {
+            ret = WALLY_EINVAL; /* Unknown prevout */
+            break;
+        }
+        /* Records are not validated when mapped, so check before use */
+        if (!is_valid_record(record)) {
+            ret = WALLY_EINVAL;
+            break;
+        }
+        uint64_from_le_bytes(record + RECORD_SATOSHI_OFFSET, values_out + i);
+        if (record[RECORD_TYPE_OFFSET] == WALLY_SCRIPT_TYPE_P2PKH ||
+            record[RECORD_TYPE_OFFSET] == WALLY_SCRIPT_TYPE_P2WPKH) {
+            /* Both sign with the P2PKH script (BIP143 scriptCode for P2WPKH) */
+            ret = wally_scriptpubkey_p2pkh_from_bytes(record + RECORD_PROGRAM_OFFSET,
+                                                      HASH160_LEN, 0, script,
+                                                      sizeof(script), &script_len);
+        } else
+            ret = WALLY_EINVAL; /* Script hash types need their redeem script */
+
+        if (ret == WALLY_OK) {
+            if (pos + 1 + script_len <= len) {
+                bytes_out[pos] = (unsigned char)script_len;
+                memcpy(bytes_out + pos + 1, script, script_len);
+            }
+            pos += 1 + script_len;
+        }
+    }
+
+    if (ret != WALLY_OK) {
+        wally_clear(values_out, values_len * sizeof(*values_out));
+        wally_clear(bytes_out, len);
+    } else
+        *written = pos;
+    return ret;
+}
+
+/* Compressed txouts */
+static size_t txout_script_type(const unsigned char *script, size_t script_len)
+{
+    secp256k1_pubkey pub;
+
+    if (script_len == WALLY_SCRIPTPUBKEY_P2PKH_LEN && script[0] == OP_DUP &&
+        script[1] == OP_HASH160 && script[2] == HASH160_LEN &&
+        script[23] == OP_EQUALVERIFY && script[24] == OP_CHECKSIG)
+        return TXOUT_P2PKH;
+    if (script_len == WALLY_SCRIPTPUBKEY_P2SH_LEN && script[0] == OP_HASH160 &&
+        script[1] == HASH160_LEN && script[22] == OP_EQUAL)
+        return TXOUT_P2SH;
+    if (script_len == EC_PUBLIC_KEY_LEN + 2 && script[0] == EC_PUBLIC_KEY_LEN &&
+        script[EC_PUBLIC_KEY_LEN + 1] == OP_CHECKSIG && (script[1] == 2 || script[1] == 3))
+        return script[1];
+    if (script_len == EC_PUBLIC_KEY_UNCOMPRESSED_LEN + 2 &&
+        script[0] == EC_PUBLIC_KEY_UNCOMPRESSED_LEN &&
+        script[EC_PUBLIC_KEY_UNCOMPRESSED_LEN + 1] == OP_CHECKSIG && script[1] == 4 &&
+        pubkey_parse(secp_ctx(), &pub, script + 1, EC_PUBLIC_KEY_UNCOMPRESSED_LEN))
+        return TXOUT_P2PK_UNCOMPRESSED_EVEN + (script[EC_PUBLIC_KEY_UNCOMPRESSED_LEN] & 1);
+    return TXOUT_NUM_SPECIAL_SCRIPTS + script_len;
+}
+
+/* The number of bytes following a compressed script type */
+static uint64_t txout_payload_len(uint64_t script_type)
+{
+    if (script_type < TXOUT_P2PK_EVEN)
+        return HASH160_LEN;
+    if (script_type < TXOUT_NUM_SPECIAL_SCRIPTS)
+        return EC_PUBLIC_KEY_LEN - 1;
+    return script_type - TXOUT_NUM_SPECIAL_SCRIPTS;
+}
+
+int wally_txout_to_compressed(uint64_t satoshi,
+                              const unsigned char *script, size_t script_len,
+                              unsigned char *bytes_out, size_t len,
+                              size_t *written)
+{
+    size_t script_type, offset, n;
+
+    if (written)
+        *written = 0;
+    if (satoshi > SATOSHI_MAX_MONEY || (!script && script_len) ||
+        !bytes_out || !written)
+        return WALLY_EINVAL;
+
+    script_type = txout_script_type(script, script_len);
+    n = varint128_to_bytes(satoshi_compress(satoshi), NULL);
+    n += varint128_to_bytes(script_type, NULL) + txout_payload_len(script_type);
+    *written = n;
+    if (n > len)
+        return WALLY_OK; /* Tell the caller the required length */
+
+    offset = varint128_to_bytes(satoshi_compress(satoshi), bytes_out);
+    offset += varint128_to_bytes(script_type, bytes_out + offset);
+    if (script_type == TXOUT_P2PKH)
+        memcpy(bytes_out + offset, script + 3, HASH160_LEN);
+    else if (script_type == TXOUT_P2SH)
+        memcpy(bytes_out + offset, script + 2, HASH160_LEN);
+    else if (script_type < TXOUT_NUM_SPECIAL_SCRIPTS)
+        memcpy(bytes_out + offset, script + 2, EC_PUBLIC_KEY_LEN - 1);
+    else if (script_len)
+        memcpy(bytes_out + offset, script, script_len);
+    return WALLY_OK;
+}
+
+/* Parse a compressed txout, leaving p after it */
+static bool txout_parse(const unsigned char **p, const unsigned char *end,
+                        uint64_t *satoshi, uint64_t *script_type,
+                        const unsigned char **payload, uint64_t *payload_len)
+{
+    uint64_t v;
+    size_t n;
+
+    if (!(n = varint128_from_bytes(*p, end, &v)) || !satoshi_decompress(v, satoshi))
+        return false;
+    *p += n;
+    if (!(n = varint128_from_bytes(*p, end, script_type)))
+        return false;
+    *p += n;
+    *payload_len = txout_payload_len(*script_type);
+    if (*script_type >= UINT64_MAX - TXOUT_NUM_SPECIAL_SCRIPTS ||
+        *payload_len > (uint64_t)(end - *p))
+        return false;
+    *payload = *p;
+    *p += *payload_len;
+    return true;
+}
+
+/* Write the script of a parsed txout */
+static int txout_to_script(uint64_t script_type,
+                           const unsigned char *payload, size_t payload_len,
+                           unsigned char *bytes_out, size_t len, size_t *written)
+{
+    unsigned char pub_key[EC_PUBLIC_KEY_LEN];
+    size_t n;
+
+    switch (script_type) {
+    case TXOUT_P2PKH:
+        n = WALLY_SCRIPTPUBKEY_P2PKH_LEN;
+        break;
+    case TXOUT_P2SH:
+        n = WALLY_SCRIPTPUBKEY_P2SH_LEN;
+        break;
+    case TXOUT_P2PK_EVEN:
+    case TXOUT_P2PK_ODD:
+        n = EC_PUBLIC_KEY_LEN + 2;
+        break;
+    case TXOUT_P2PK_UNCOMPRESSED_EVEN:
+    case TXOUT_P2PK_UNCOMPRESSED_ODD:
+        n = EC_PUBLIC_KEY_UNCOMPRESSED_LEN + 2;
+        break;
+    default:
+        n = payload_len > TXOUT_MAX_SCRIPT_SIZE ? 1 : payload_len;
+    }
+    *written = n;
+    if (n > len)
+        return WALLY_OK; /* Tell the caller the required length */
+
+    switch (script_type) {
+    case TXOUT_P2PKH:
+        bytes_out[0] = OP_DUP;
+        bytes_out[1] = OP_HASH160;
+        bytes_out[2] = HASH160_LEN;
+        memcpy(bytes_out + 3, payload, HASH160_LEN);
+        bytes_out[23] = OP_EQUALVERIFY;
+        bytes_out[24] = OP_CHECKSIG;
+        break;
+    case TXOUT_P2SH:
+        bytes_out[0] = OP_HASH160;
+        bytes_out[1] = HASH160_LEN;
+        memcpy(bytes_out + 2, payload, HASH160_LEN);
+        bytes_out[22] = OP_EQUAL;
+        break;
+    case TXOUT_P2PK_EVEN:
+    case TXOUT_P2PK_ODD:
+        bytes_out[0] = EC_PUBLIC_KEY_LEN;
+        bytes_out[1] = (unsigned char)script_type;
+        memcpy(bytes_out + 2, payload, EC_PUBLIC_KEY_LEN - 1);
+        bytes_out[EC_PUBLIC_KEY_LEN + 1] = OP_CHECKSIG;
+        break;
+    case TXOUT_P2PK_UNCOMPRESSED_EVEN:
+    case TXOUT_P2PK_UNCOMPRESSED_ODD:
+        pub_key[0] = (unsigned char)(script_type - 2);
+        memcpy(pub_key + 1, payload, EC_PUBLIC_KEY_LEN - 1);
+        bytes_out[0] = EC_PUBLIC_KEY_UNCOMPRESSED_LEN;
+        if (wally_ec_public_key_decompress(pub_key, sizeof(pub_key), bytes_out + 1,
+                                           EC_PUBLIC_KEY_UNCOMPRESSED_LEN) != WALLY_OK) {
+            *written = 0;
+            return WALLY_EINVAL; /* Not a point on the curve */
+        }
+        bytes_out[EC_PUBLIC_KEY_UNCOMPRESSED_LEN + 1] = OP_CHECKSIG;
+        break;
+    default:
+        if (n == 1 && payload_len)
+            bytes_out[0] = OP_RETURN; /* Unspendable, as for bitcoin core */
+        else if (n)
+            memcpy(bytes_out, payload, n);
+    }
+    return WALLY_OK;
+}
+
+int wally_txout_from_compressed(const unsigned char *bytes, size_t bytes_len,
+                                uint64_t *satoshi_out,
+                                unsigned char *bytes_out, size_t len,
+                                size_t *written, size_t *consumed)
+{
+    const unsigned char *p = bytes, *payload;
+    uint64_t script_type, payload_len;
+    int ret;
+
+    if (satoshi_out)
+        *satoshi_out = 0;
+    if (written)
+        *written = 0;
+    if (consumed)
+        *consumed = 0;
+    if (!bytes || !bytes_len || !satoshi_out || !bytes_out || !written || !consumed)
+        return WALLY_EINVAL;
+
+    if (!txout_parse(&p, bytes + bytes_len, satoshi_out, &script_type,
+                     &payload, &payload_len))
+        ret = WALLY_EINVAL;
+    else
+        ret = txout_to_script(script_type, payload, payload_len, bytes_out, len, written);
+    if (ret == WALLY_OK)
+        *consumed = p - bytes;
+    else
+        *satoshi_out = 0;
+    return ret;
+}
+
+/* Add a record for a parsed coin, returning false if its script type
+ * isn't supported by records */
+static bool coin_to_record(const unsigned char *txhash, uint32_t vout, uint64_t satoshi,
+                           uint64_t script_type, const unsigned char *payload,
+                           size_t payload_len, unsigned char *bytes_out)
+{
+    if (script_type == TXOUT_P2PKH || script_type == TXOUT_P2SH) {
+        if (bytes_out)
+            record_init(txhash, vout, satoshi,
+                        script_type == TXOUT_P2PKH ? WALLY_SCRIPT_TYPE_P2PKH : WALLY_SCRIPT_TYPE_P2SH,
+                        payload, HASH160_LEN, bytes_out);
+        return true;
+    }
+    if (script_type < TXOUT_NUM_SPECIAL_SCRIPTS || payload_len > TXOUT_MAX_SCRIPT_SIZE ||
+        (payload_len != WALLY_SCRIPTPUBKEY_P2WPKH_LEN &&
+         payload_len != WALLY_SCRIPTPUBKEY_P2WSH_LEN) || payload[0] != OP_0 ||
+        payload[1] != payload_len - 2)
+        return false; /* P2PK or not a v0 witness program */
+    if (bytes_out)
+        record_init(txhash, vout, satoshi,
+                    payload_len == WALLY_SCRIPTPUBKEY_P2WPKH_LEN ?
+                    WALLY_SCRIPT_TYPE_P2WPKH : WALLY_SCRIPT_TYPE_P2WSH,
+                    payload + 2, payload_len - 2, bytes_out);
+    return true;
+}
+
+int wally_utxo_records_from_coins(const unsigned char *bytes, size_t bytes_len,
+                                  uint32_t flags,
+                                  unsigned char *bytes_out, size_t len,
+                                  size_t *written)
+{
+    const bool by_txid = flags & WALLY_UTXO_FLAG_COINS_BY_TXID;
+    const unsigned char *p = bytes, *end = bytes + bytes_len, *txhash = NULL, *payload;
+    uint64_t v, num_coins = 0, satoshi, script_type, payload_len;
+    uint32_t vout;
+    size_t n, pos = 0;
+
+    if (written)
+        *written = 0;
+    if ((!bytes && bytes_len) ||
+        (flags & ~(WALLY_UTXO_FLAG_SKIP_UNSUPPORTED | WALLY_UTXO_FLAG_COINS_BY_TXID)) ||
+        (!bytes_out && len) || !written)
+        return WALLY_EINVAL;
+
+#define ensure_n(n) if ((size_t)(end - p) < (n)) goto fail
+#define ensure_varint(dst) ensure_n(1); ensure_n(varint_length_from_bytes(p)); \
+    p += varint_from_bytes(p, (dst))
+
+    while (p < end) {
+        if (!num_coins) {
+            /* Start of an outpoint, or of a transactions coins */
+            ensure_n(WALLY_TXHASH_LEN);
+            txhash = p;
+            p += WALLY_TXHASH_LEN;
+            if (by_txid) {
+                ensure_varint(&num_coins);
+                if (!num_coins)
+                    goto fail;
+            } else
+                num_coins = 1;
+        }
+        if (by_txid) {
+            ensure_varint(&v);
+            if (v > UINT32_MAX)
+                goto fail;
+            vout = (uint32_t)v;
+        } else {
+            ensure_n(sizeof(uint32_t));
+            p += uint32_from_le_bytes(p, &vout);
+        }
+        /* The coin's height and coinbase flag are not kept */
+        if (!(n = varint128_from_bytes(p, end, &v)) || v > UINT32_MAX)
+            goto fail;
+        p += n;
+        if (!txout_parse(&p, end, &satoshi, &script_type, &payload, &payload_len))
+            goto fail;
+        if (coin_to_record(txhash, vout, satoshi, script_type, payload, payload_len,
+                           pos + WALLY_UTXO_RECORD_LEN <= len ? bytes_out + pos : NULL))
+            pos += WALLY_UTXO_RECORD_LEN;
+        else if (!(flags & WALLY_UTXO_FLAG_SKIP_UNSUPPORTED))
+            goto fail;
+        --num_coins;
+    }
+    if (num_coins)
+        goto fail; /* Truncated list of a transactions coins */
+
+#undef ensure_n
+#undef ensure_varint
+
+    *written = pos;
+    return WALLY_OK;
+fail:
+    if (bytes_out)
+        wally_clear(bytes_out, len);
+    return WALLY_EINVAL;
+}
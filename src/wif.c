@@ -5,6 +5,28 @@
 
 #define WIF_ALL_DEFINED_FLAGS (WALLY_WIF_FLAG_COMPRESSED | WALLY_WIF_FLAG_UNCOMPRESSED)
 
+/* Build the WIF payload for a private key, returning its length or 0 if
+ * the arguments are invalid */
+static size_t wif_payload(const unsigned char *priv_key, size_t priv_key_len,
+                          uint32_t prefix, uint32_t flags,
+                          unsigned char *buf)
+{
+    size_t buf_len = 2 + EC_PRIVATE_KEY_LEN;
+
+    if(!priv_key || priv_key_len != EC_PRIVATE_KEY_LEN || (prefix & ~0xff) ||
+       (flags & ~WIF_ALL_DEFINED_FLAGS))
+        return 0;
+
+    buf[0] = (unsigned char) prefix & 0xff;
+    memcpy(&buf[1], priv_key, EC_PRIVATE_KEY_LEN);
+
+    if (flags & WALLY_WIF_FLAG_UNCOMPRESSED)
+        buf_len--;
+    else
+        buf[buf_len - 1] = 0x01;
+    return buf_len;
+}
+
 int wally_wif_from_bytes(const unsigned char *priv_key,
                          size_t priv_key_len,
                          uint32_t prefix,
@@ -13,24 +35,41 @@ int wally_wif_from_bytes(const unsigned char *priv_key,
 {
     int ret;
     unsigned char buf[2 + EC_PRIVATE_KEY_LEN];
-    size_t buf_len = sizeof(buf);
+    size_t buf_len;
 
     if (output)
         *output = NULL;
 
-    if(!priv_key || priv_key_len != EC_PRIVATE_KEY_LEN || (prefix & ~0xff) ||
-       (flags & ~WIF_ALL_DEFINED_FLAGS) || !output)
+    buf_len = wif_payload(priv_key, priv_key_len, prefix, flags, buf);
+    if (!buf_len || !output)
         return WALLY_EINVAL;
 
-    buf[0] = (unsigned char) prefix & 0xff;
-    memcpy(&buf[1], priv_key, EC_PRIVATE_KEY_LEN);
+    ret = wally_base58_from_bytes(buf, buf_len, BASE58_FLAG_CHECKSUM, output);
 
-    if (flags & WALLY_WIF_FLAG_UNCOMPRESSED)
-        buf_len--;
-    else
-        buf[buf_len - 1] = 0x01;
+    wally_clear(buf, sizeof(buf));
+    return ret;
+}
 
-    ret = wally_base58_from_bytes(buf, buf_len, BASE58_FLAG_CHECKSUM, output);
+int wally_wif_from_bytes_to_buffer(const unsigned char *priv_key,
+                                   size_t priv_key_len,
+                                   uint32_t prefix,
+                                   uint32_t flags,
+                                   char *output, size_t len,
+                                   size_t *written)
+{
+    int ret;
+    unsigned char buf[2 + EC_PRIVATE_KEY_LEN];
+    size_t buf_len;
+
+    if (written)
+        *written = 0;
+
+    buf_len = wif_payload(priv_key, priv_key_len, prefix, flags, buf);
+    if (!buf_len || !output || !written)
+        return WALLY_EINVAL;
+
+    ret = wally_base58_from_bytes_to_buffer(buf, buf_len, BASE58_FLAG_CHECKSUM,
+                                            output, len, written);
 
     wally_clear(buf, sizeof(buf));
     return ret;
@@ -146,31 +185,239 @@ int wally_wif_to_public_key(const char *wif,
     return ret;
 }
 
+/* Compute the P2PKH payload for the public key of a WIF */
+static int wif_address_payload(const char *wif, uint32_t prefix, uint32_t version,
+                               unsigned char *address)
+{
+    int ret;
+    unsigned char pubkey[EC_PUBLIC_KEY_UNCOMPRESSED_LEN];
+    size_t written;
+
+    if (!wif || (prefix & ~0xff) || (version & ~0xff))
+        return WALLY_EINVAL;
+
+    if ((ret = wally_wif_to_public_key(wif, prefix, pubkey, sizeof(pubkey), &written)))
+        return ret;
+
+    address[0] = (unsigned char) version & 0xff;
+
+    ret = wally_hash160(pubkey, written, &address[1], HASH160_LEN);
+    wally_clear(pubkey, sizeof(pubkey));
+    return ret;
+}
+
 int wally_wif_to_address(const char *wif,
                          uint32_t prefix,
                          uint32_t version,
                          char **output)
 {
     int ret;
-    unsigned char pubkey[EC_PUBLIC_KEY_UNCOMPRESSED_LEN], address[HASH160_LEN + 1];
-    size_t written;
+    unsigned char address[HASH160_LEN + 1];
 
     if (output)
         *output = NULL;
 
-    if (!wif || (prefix & ~0xff) || (version & ~0xff) || !output)
+    if (!output)
         return WALLY_EINVAL;
 
-    if ((ret = wally_wif_to_public_key(wif, prefix, pubkey, sizeof(pubkey), &written)))
-        return ret;
+    ret = wif_address_payload(wif, prefix, version, address);
+    if (ret == WALLY_OK)
+        ret = wally_base58_from_bytes(address, sizeof(address), BASE58_FLAG_CHECKSUM, output);
 
-    address[0] = (unsigned char) version & 0xff;
+    wally_clear(address, sizeof(address));
+    return ret;
+}
 
-    if ((ret = wally_hash160(pubkey, written, &address[1], HASH160_LEN)))
-        return ret;
+int wally_wif_to_address_to_buffer(const char *wif,
+                                   uint32_t prefix,
+                                   uint32_t version,
+                                   char *output, size_t len,
+                                   size_t *written)
+{
+    int ret;
+    unsigned char address[HASH160_LEN + 1];
+
+    if (written)
+        *written = 0;
+
+    if (!output || !written)
+        return WALLY_EINVAL;
+
+    ret = wif_address_payload(wif, prefix, version, address);
+    if (ret == WALLY_OK)
+        ret = wally_base58_from_bytes_to_buffer(address, sizeof(address),
+                                                BASE58_FLAG_CHECKSUM,
+                                                output, len, written);
+
+    wally_clear(address, sizeof(address));
+    return ret;
+}
 
-    ret = wally_base58_from_bytes(address, sizeof(address), BASE58_FLAG_CHECKSUM, output);
+/* Decode a WIF once, returning its private key, flags, public key (padded
+ * to EC_PUBLIC_KEY_UNCOMPRESSED_LEN) and optionally its P2PKH payload */
+static int wif_decode(const char *wif, uint32_t prefix, uint32_t version,
+                      unsigned char *priv_key_out, unsigned char *pub_key_out,
+                      uint32_t *flags_out, unsigned char *payload_out)
+{
+    unsigned char buf[2 + EC_PRIVATE_KEY_LEN + BASE58_CHECKSUM_LEN];
+    secp256k1_pubkey pub;
+    size_t uncompressed, pub_key_len;
+    int ret;
 
-    wally_clear_2(pubkey, sizeof(pubkey), address, sizeof(address));
+    ret = is_uncompressed(wif, buf, sizeof(buf), &uncompressed);
+    if (ret == WALLY_OK && buf[0] != prefix)
+        ret = WALLY_EINVAL; /* Prefix does not match */
+    if (ret == WALLY_OK) {
+        pub_key_len = uncompressed ? EC_PUBLIC_KEY_UNCOMPRESSED_LEN : EC_PUBLIC_KEY_LEN;
+        if (!pubkey_create(secp_ctx(), &pub, &buf[1]) ||
+            !pubkey_serialize(secp_ctx(), pub_key_out, &pub_key_len, &pub,
+                              uncompressed ? PUBKEY_UNCOMPRESSED : PUBKEY_COMPRESSED))
+            ret = WALLY_EINVAL; /* Invalid private key */
+    }
+    if (ret == WALLY_OK) {
+        memcpy(priv_key_out, &buf[1], EC_PRIVATE_KEY_LEN);
+        memset(pub_key_out + pub_key_len, 0, EC_PUBLIC_KEY_UNCOMPRESSED_LEN - pub_key_len);
+        *flags_out = uncompressed ? WALLY_WIF_FLAG_UNCOMPRESSED : WALLY_WIF_FLAG_COMPRESSED;
+        if (payload_out) {
+            payload_out[0] = (unsigned char) version & 0xff;
+            ret = wally_hash160(pub_key_out, pub_key_len, payload_out + 1, HASH160_LEN);
+        }
+    }
+    wally_clear_2(buf, sizeof(buf), &pub, sizeof(pub));
+    return ret;
+}
+
+int wally_wif_decode(const char *wif,
+                     uint32_t prefix,
+                     uint32_t version,
+                     unsigned char *priv_key_out,
+                     size_t priv_key_out_len,
+                     unsigned char *pub_key_out,
+                     size_t pub_key_out_len,
+                     uint32_t *flags_out,
+                     char **output)
+{
+    unsigned char payload[HASH160_LEN + 1];
+    int ret;
+
+    if (flags_out)
+        *flags_out = 0;
+    if (output)
+        *output = NULL;
+
+    if (!wif || (prefix & ~0xff) || (version & ~0xff) ||
+        !priv_key_out || priv_key_out_len != EC_PRIVATE_KEY_LEN ||
+        !pub_key_out || pub_key_out_len != EC_PUBLIC_KEY_UNCOMPRESSED_LEN ||
+        !flags_out)
+        return WALLY_EINVAL;
+
+    ret = wif_decode(wif, prefix, version, priv_key_out, pub_key_out,
+                     flags_out, output ? payload : NULL);
+    if (ret == WALLY_OK && output)
+        ret = wally_base58_from_bytes(payload, sizeof(payload),
+                                      BASE58_FLAG_CHECKSUM, output);
+    if (ret != WALLY_OK) {
+        wally_clear_2(priv_key_out, priv_key_out_len, pub_key_out, pub_key_out_len);
+        *flags_out = 0;
+    }
+    wally_clear(payload, sizeof(payload));
+    return ret;
+}
+
+/* The inputs and results for decoding a batch of WIFs as tasks */
+struct wif_decode_tasks {
+    const char *const *wifs;
+    uint32_t prefix;
+    uint32_t version;
+    unsigned char *priv_keys_out;
+    unsigned char *pub_keys_out;
+    uint32_t *flags_out;
+    unsigned char *payloads; /* NULL if addresses are not wanted */
+    int *rets;
+};
+
+static void wif_decode_task(void *task_ctx, size_t i)
+{
+    struct wif_decode_tasks *t = task_ctx;
+    t->rets[i] = wif_decode(t->wifs[i], t->prefix, t->version,
+                            t->priv_keys_out + i * EC_PRIVATE_KEY_LEN,
+                            t->pub_keys_out + i * EC_PUBLIC_KEY_UNCOMPRESSED_LEN,
+                            t->flags_out + i,
+                            t->payloads ? t->payloads + i * (HASH160_LEN + 1) : NULL);
+}
+
+int wally_wif_decode_batch(const char *const *wifs,
+                           size_t num_wifs,
+                           uint32_t prefix,
+                           uint32_t version,
+                           wally_run_tasks_t run_fn,
+                           void *run_ctx,
+                           unsigned char *priv_keys_out,
+                           size_t priv_keys_out_len,
+                           unsigned char *pub_keys_out,
+                           size_t pub_keys_out_len,
+                           uint32_t *flags_out,
+                           size_t flags_out_len,
+                           char *output,
+                           size_t len,
+                           size_t *written)
+{
+    struct wif_decode_tasks tasks;
+    size_t i;
+    int ret = WALLY_OK;
+
+    if (written)
+        *written = 0;
+
+    if (!wifs || !num_wifs || (prefix & ~0xff) || (version & ~0xff) ||
+        !priv_keys_out || priv_keys_out_len / EC_PRIVATE_KEY_LEN != num_wifs ||
+        priv_keys_out_len % EC_PRIVATE_KEY_LEN ||
+        !pub_keys_out || pub_keys_out_len / EC_PUBLIC_KEY_UNCOMPRESSED_LEN != num_wifs ||
+        pub_keys_out_len % EC_PUBLIC_KEY_UNCOMPRESSED_LEN ||
+        !flags_out || flags_out_len != num_wifs ||
+        (!output && len) || !written)
+        return WALLY_EINVAL;
+
+    for (i = 0; i < num_wifs; ++i)
+        if (!wifs[i])
+            return WALLY_EINVAL;
+
+    /* Create the shared secp context before any tasks can run concurrently */
+    if (!secp_ctx())
+        return WALLY_ENOMEM;
+
+    tasks.wifs = wifs;
+    tasks.prefix = prefix;
+    tasks.version = version;
+    tasks.priv_keys_out = priv_keys_out;
+    tasks.pub_keys_out = pub_keys_out;
+    tasks.flags_out = flags_out;
+    tasks.payloads = NULL;
+    if (!(tasks.rets = wally_malloc(num_wifs * sizeof(int))))
+        return WALLY_ENOMEM;
+    if (output &&
+        !(tasks.payloads = wally_malloc(num_wifs * (HASH160_LEN + 1)))) {
+        wally_free(tasks.rets);
+        return WALLY_ENOMEM;
+    }
+
+    wally_run_tasks(run_fn, run_ctx, num_wifs, wif_decode_task, &tasks);
+
+    for (i = 0; i < num_wifs && ret == WALLY_OK; ++i)
+        ret = tasks.rets[i];
+    if (ret == WALLY_OK && output)
+        ret = wally_base58_from_bytes_batch(tasks.payloads, num_wifs * (HASH160_LEN + 1),
+                                            HASH160_LEN + 1, BASE58_FLAG_CHECKSUM,
+                                            output, len, written);
+    if (ret != WALLY_OK) {
+        wally_clear_2(priv_keys_out, priv_keys_out_len, pub_keys_out, pub_keys_out_len);
+        wally_clear(flags_out, flags_out_len * sizeof(uint32_t));
+        *written = 0;
+    }
+    if (tasks.payloads) {
+        wally_clear(tasks.payloads, num_wifs * (HASH160_LEN + 1));
+        wally_free(tasks.payloads);
+    }
+    wally_free(tasks.rets);
     return ret;
 }
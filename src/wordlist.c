@@ -1,9 +1,48 @@
 #include "internal.h"
 #include "wordlist.h"
 
-static int bstrcmp(const void *l, const void *r)
+/* A word to look up, which need not be NUL terminated */
+struct word_key {
+    const char *word;
+    size_t len;
+};
+
+/* Compare a key to a word, with shorter words sorting first */
+static int key_cmp(const struct word_key *key, const char *word)
+{
+    int ret = strncmp(key->word, word, key->len);
+    return ret ? ret : -!!word[key->len];
+}
+
+static bool words_equal(const struct word_key *key, const char *word)
+{
+    return !strncmp(key->word, word, key->len) && !word[key->len];
+}
+
+/* Return the word at idx, which must be in range */
+static const char *word_at(const struct words *w, size_t idx)
+{
+    return w->offsets ? w->str + w->offsets[idx] : w->indices[idx];
+}
+
+/* The murmur3 64 bit finalizer */
+static uint64_t wordlist_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    return h ^ (h >> 33);
+}
+
+/* FNV-1a, mixed. Must match word_hash() in tools/wordlist_cc.py */
+static uint64_t wordlist_hash(uint32_t seed, const struct word_key *key)
 {
-    return strcmp(l, (*(const char **)r));
+    uint64_t h = 0xcbf29ce484222325ull ^ seed;
+    size_t i;
+    for (i = 0; i < key->len; ++i)
+        h = (h ^ (unsigned char)key->word[i]) * 0x100000001b3ull;
+    return wordlist_mix(h);
 }
 
 /* https://graphics.stanford.edu/~seander/bithacks.html#IntegerLogObvious */
@@ -15,24 +54,31 @@ static int get_bits(size_t n)
     return bits;
 }
 
+/* The size of the single allocation holding a words structure made by
+ * wordlist_init, followed by its word pointers and then its string */
+static size_t wordlist_alloc_len(size_t len, size_t str_len)
+{
+    return sizeof(struct words) + len * sizeof(const char *) + str_len + 1;
+}
+
 /* Allocate a new words structure */
 static struct words *wordlist_alloc(const char *words, size_t len)
 {
-    struct words *w = wally_malloc(sizeof(struct words));
+    const size_t str_len = strlen(words);
+    struct words *w = wally_malloc(wordlist_alloc_len(len, str_len));
     if (w) {
-        w->str = wally_strdup(words);
-        if (w->str) {
-            w->str_len = strlen(w->str);
-            w->len = len;
-            w->bits = get_bits(len);
-            w->indices = wally_malloc(len * sizeof(const char *));
-            if (w->indices)
-                return w;
-        }
-        w->str_len = 0;
-        wordlist_free(w);
+        w->indices = (const char **)(w + 1);
+        w->str = (const char *)(w->indices + len);
+        memcpy((char *)w->str, words, str_len + 1);
+        w->str_len = str_len;
+        w->len = len;
+        w->bits = get_bits(len);
+        w->offsets = NULL;
+        w->hash_seed = 0;
+        w->hash_displacements = NULL;
+        w->hash_table = NULL;
     }
-    return NULL;
+    return w;
 }
 
 static size_t wordlist_count(const char *words)
@@ -67,39 +113,70 @@ struct words *wordlist_init(const char *words)
     return w;
 }
 
-size_t wordlist_lookup_word(const struct words *w, const char *word)
+uint64_t wordlist_hash_word(const struct words *w, const char *word, size_t word_len)
+{
+    const struct word_key key = { word, word_len };
+    return wordlist_hash(w->hash_seed, &key);
+}
+
+size_t wordlist_lookup_word_hash(const struct words *w, const char *word,
+                                 size_t word_len, uint64_t hash)
 {
-    const size_t size = sizeof(const char *);
-    const char **found = NULL;
+    const struct word_key key = { word, word_len };
+    size_t i;
 
-    if (w->sorted)
-        found = (const char **)bsearch(word, w->indices, w->len, size, bstrcmp);
-    else {
-        size_t i;
-        for (i = 0; i < w->len && !found; ++i)
-            if (!strcmp(word, w->indices[i]))
-                found = w->indices + i;
+    if (w->hash_table) {
+        /* Built-in lists have a power of 2 length and a perfect hash
+         * generated by tools/wordlist_cc.py. Only the word in the slot
+         * it hashes to can match */
+        const size_t num_buckets = w->len >= 4 ? w->len / 4 : 1;
+        const uint64_t d = w->hash_displacements[hash & (num_buckets - 1)];
+        const size_t idx = w->hash_table[wordlist_mix(hash + d) & (w->len - 1)];
+        return words_equal(&key, word_at(w, idx)) ? idx + 1u : 0u;
+    }
+    if (w->sorted) {
+        size_t lo = 0, hi = w->len;
+        while (lo < hi) {
+            const int cmp = key_cmp(&key, word_at(w, (i = lo + (hi - lo) / 2)));
+            if (!cmp)
+                return i + 1u;
+            if (cmp < 0)
+                hi = i;
+            else
+                lo = i + 1;
+        }
+        return 0;
     }
-    return found ? found - w->indices + 1u : 0u;
+    for (i = 0; i < w->len; ++i)
+        if (words_equal(&key, word_at(w, i)))
+            return i + 1u;
+    return 0;
+}
+
+size_t wordlist_lookup_word_len(const struct words *w, const char *word, size_t word_len)
+{
+    const uint64_t hash = w->hash_table ? wordlist_hash_word(w, word, word_len) : 0;
+    return wordlist_lookup_word_hash(w, word, word_len, hash);
+}
+
+size_t wordlist_lookup_word(const struct words *w, const char *word)
+{
+    return wordlist_lookup_word_len(w, word, strlen(word));
 }
 
 const char *wordlist_lookup_index(const struct words *w, size_t idx)
 {
     if (idx >= w->len)
         return NULL;
-    return w->indices[idx];
+    return word_at(w, idx);
 }
 
 void wordlist_free(struct words *w)
 {
     if (w && w->str_len) {
-        if (w->str) {
-            wally_clear((void *)w->str,  w->str_len);
-            wally_free((void *)w->str);
-        }
-        if (w->indices)
-            wally_free((void *)w->indices); /* No need to clear */
-        wally_clear(w, sizeof(*w));
+        /* Built-in lists have no str_len and are never freed */
+        const size_t len = wordlist_alloc_len(w->len, w->str_len);
+        wally_clear(w, len);
         wally_free(w);
     }
 }
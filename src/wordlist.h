@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * struct words- structure representing a parsed list of words
@@ -18,8 +19,18 @@ struct words {
     const char *str;
     /* The length of str, or 0 if str points to constant storage */
     size_t str_len;
-    /* Pointers to the individual words */
+    /* Pointers to the individual words, or NULL if offsets is given */
     const char **indices;
+    /* Offsets of the individual words in str, used by the built-in lists
+     * generated by tools/wordlist_cc.py in place of indices */
+    const uint16_t *offsets;
+    /* Seed of the minimal perfect hash of the words */
+    uint32_t hash_seed;
+    /* Perfect hash displacement for each bucket of len / 4 words, or NULL */
+    const uint16_t *hash_displacements;
+    /* Index of the word in each perfect hash slot, or NULL if the list
+     * has no perfect hash (lists created by wordlist_init) */
+    const uint16_t *hash_table;
 };
 
 /**
@@ -28,7 +39,8 @@ struct words {
  * @text: List of words to initialize from, split by whitespace and
  *        NUL terminated. Must be UTF-8 encoded.
  *
- * The returned structure contains a copy of @text.
+ * The returned structure contains a copy of @text, allocated along with
+ * the structure and its word pointers in a single block.
  */
 struct words *wordlist_init(const char *text);
 
@@ -45,6 +57,53 @@ size_t wordlist_lookup_word(
     const struct words *w,
     const char *word);
 
+/**
+ * Find a word that is not NUL terminated in a wordlist.
+ *
+ * @w: Parsed list of words to look up in.
+ * @word: The word to look up.
+ * @word_len: The length of @word in bytes.
+ *
+ * Returns 0 if not found, idx + 1 otherwise.
+ * @see wordlist_lookup_word.
+ */
+size_t wordlist_lookup_word_len(
+    const struct words *w,
+    const char *word,
+    size_t word_len);
+
+/**
+ * Hash a word for lookup in a wordlist.
+ *
+ * @w: Parsed list of words the hash will be used with.
+ * @word: The word to hash.
+ * @word_len: The length of @word in bytes.
+ *
+ * Lists with the same hash_seed give the same hash for a word, so the
+ * hash can be computed once to look the word up in each of them.
+ */
+uint64_t wordlist_hash_word(
+    const struct words *w,
+    const char *word,
+    size_t word_len);
+
+/**
+ * Find a word in a wordlist, given its hash.
+ *
+ * @w: Parsed list of words to look up in.
+ * @word: The word to look up.
+ * @word_len: The length of @word in bytes.
+ * @hash: The hash of @word from wordlist_hash_word, or any value if
+ *        @w has no perfect hash.
+ *
+ * Returns 0 if not found, idx + 1 otherwise.
+ */
+size_t wordlist_lookup_word_hash(
+    const struct words *w,
+    const char *word,
+    size_t word_len,
+    uint64_t hash);
+
 /**
  * Return the Nth word in a wordlist.
  *
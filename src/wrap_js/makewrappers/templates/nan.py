@@ -304,20 +304,26 @@ def _generate_nan(funcname, f):
             else:
                 result_wrap = 'res%s' % i
         elif arg == 'out_uint64_t':
-            assert num_outs > 1  # wally_asset_unblind is the only func using this type
             output_args.extend([
                 'unsigned char *res_ptr%s = Allocate(sizeof(uint64_t), ret);' % i,
                 'LocalObject res%s = AllocateBuffer(res_ptr%s, sizeof(uint64_t), sizeof(uint64_t), ret);' % (i, i),
                 'uint64_t *be64%s = reinterpret_cast<uint64_t *>(res_ptr%s);' % (i, i),
             ])
             args.append('be64%s' % i)
-            postprocessing.extend([
-                'if (ret == WALLY_OK) {',
-                '    *be64%s = cpu_to_be64(*be64%s);' % (i, i),
-                '    res->Set(%s, res%s);' % (cur_out, i),
-                '}',
-            ])
-            cur_out += 1
+            if num_outs > 1:
+                postprocessing.extend([
+                    'if (ret == WALLY_OK) {',
+                    '    *be64%s = cpu_to_be64(*be64%s);' % (i, i),
+                    '    res->Set(%s, res%s);' % (cur_out, i),
+                    '}',
+                ])
+                cur_out += 1
+            else:
+                postprocessing.extend([
+                    'if (ret == WALLY_OK)',
+                    '    *be64%s = cpu_to_be64(*be64%s);' % (i, i),
+                ])
+                result_wrap = 'res%s' % i
         elif arg == 'bip32_in':
             input_args.append((
                 'ext_key* inkey;'
@@ -0,0 +1,242 @@
+TEMPLATE = '''
+/* Generated by wrap.py: WebAssembly wrapper, see tools/build_wasm.sh.
+ * Exposes the same promise based API as the node.js wrapper, calling into
+ * the Emscripten module wallycore.js, which is loaded on first use */
+var createWallycore = require('./wallycore.js');
+
+module.exports = {};
+
+var _instance = null;
+var _load = function () {
+    if (!_instance) {
+        _instance = createWallycore().then(function (m) {
+            _check(m._wally_init(0), 'wally_init');
+            return m;
+        });
+    }
+    return _instance;
+};
+module.exports.load = _load;
+
+var _check = function (ret, name) {
+    if (ret == module.exports.WALLY_EINVAL)
+        throw new TypeError(name);
+    if (ret != 0)
+        throw new Error(name);
+};
+
+/* Allocate len bytes on the wasm heap, to be cleared and freed once the call completes */
+var _alloc = function (m, allocs, len) {
+    var ptr = m._malloc(len || 1);
+    if (!ptr)
+        throw new Error('malloc');
+    allocs.push([ptr, len]);
+    return ptr;
+};
+
+var _free = function (m, allocs) {
+    allocs.forEach(function (a) {
+        if (a[1] < 0) {
+            /* A wally allocated object, freed by its destructor */
+            var obj = m.HEAPU32[a[0] >> 2];
+            if (obj)
+                (a[1] == -1 ? m._bip32_key_free : m._wally_free_string)(obj);
+            m.HEAPU32[a[0] >> 2] = 0;
+            a[1] = 4;
+        }
+        m.HEAPU8.fill(0, a[0], a[0] + a[1]);
+        m._free(a[0]);
+    });
+};
+
+var _bytes = function (m, allocs, bytes) {
+    if (bytes === null || bytes === undefined)
+        return [0, 0];
+    var ptr = _alloc(m, allocs, bytes.length);
+    m.HEAPU8.set(bytes, ptr);
+    return [ptr, bytes.length];
+};
+
+var _string = function (m, allocs, str) {
+    if (str === null || str === undefined)
+        return 0;
+    var len = m.lengthBytesUTF8(str) + 1;
+    var ptr = _alloc(m, allocs, len);
+    m.stringToUTF8(str, ptr, len);
+    return ptr;
+};
+
+/* uint64_t values are expected as an 8 byte buffer of big endian bytes */
+var _uint64 = function (bytes) {
+    if (!bytes || bytes.length != 8)
+        throw new TypeError('uint64_t');
+    return bytes.reduce(function (v, b) { return (v << BigInt(8)) | BigInt(b); }, BigInt(0));
+};
+
+var _uint64s = function (m, allocs, values) {
+    var ptr = _alloc(m, allocs, values.length * 8);
+    values.forEach(function (v, i) {
+        if (!v || v.length != 8)
+            throw new TypeError('uint64_t');
+        for (var j = 0; j < 8; ++j)
+            m.HEAPU8[ptr + i * 8 + j] = v[7 - j];
+    });
+    return [ptr, values.length];
+};
+
+var _uint64_result = function (m, ptr) {
+    return new Uint8Array(m.HEAPU8.subarray(ptr, ptr + 8)).reverse();
+};
+
+/* An output buffer of len bytes, or the callers buffer if one is supplied */
+var _out = function (m, allocs, supplied, len) {
+    if (supplied instanceof Uint8Array)
+        return [_alloc(m, allocs, supplied.length), supplied.length, supplied];
+    return [_alloc(m, allocs, len), len, null];
+};
+
+var _out_result = function (m, out, written, sized) {
+    if (written > out[1])
+        throw new TypeError('output buffer too small');
+    var res = m.HEAPU8.subarray(out[0], out[0] + written);
+    if (!out[2])
+        return new Uint8Array(res);
+    out[2].set(res);
+    /* Caller supplied buffers for sized outputs return the number of bytes written */
+    return sized ? written : out[2];
+};
+
+/* A pointer to a wally allocated object: -1 for ext_key, -2 for strings */
+var _obj = function (m, allocs, kind) {
+    var ptr = m._malloc(4);
+    if (!ptr)
+        throw new Error('malloc');
+    m.HEAPU32[ptr >> 2] = 0;
+    allocs.push([ptr, kind]);
+    return ptr;
+};
+
+var _bip32_in = function (m, allocs, bytes) {
+    var key = _bytes(m, allocs, bytes);
+    var ptr = _obj(m, allocs, -1);
+    _check(m._bip32_key_unserialize_alloc(key[0], key[1], ptr), 'bip32_key_unserialize_alloc');
+    return m.HEAPU32[ptr >> 2];
+};
+
+var _bip32_out = function (m, allocs, ptr, flags) {
+    var len = module.exports.BIP32_SERIALIZED_LEN;
+    var out = _alloc(m, allocs, len);
+    _check(m._bip32_key_serialize(m.HEAPU32[ptr >> 2], flags, out, len), 'bip32_key_serialize');
+    return new Uint8Array(m.HEAPU8.subarray(out, out + len));
+};
+
+var _string_result = function (m, ptr) {
+    return m.UTF8ToString(m.HEAPU32[ptr >> 2]);
+};
+
+!!list_of_wasm_funcs!!
+
+var _export = function(name, value) {
+    Object.defineProperty(module.exports, name, {'value': value, 'writable': false});
+}
+var _zero = new Uint8Array([0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00]);
+var _one = new Uint8Array([0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01]);
+_export('ZERO_64', _zero);
+_export('ONE_64', _one);
+
+'''
+
+
+def _generate_wasm(funcname, f):
+    inputs = []
+    args = []
+    results = []
+    cur_out = 0
+    for i, arg in enumerate(f.arguments):
+        if isinstance(arg, tuple) or arg in ['out_bytes_sized', 'out_bytes_fixedsized']:
+            if isinstance(arg, tuple):
+                size = str(arg[1])
+            elif f.out_size:
+                size = f.out_size
+            elif f.out_sizes:
+                size = f.out_sizes[cur_out]
+            else:
+                size = '_arguments[%s]' % i # The size is passed from js directly
+            inputs.append('var res%s = _out(m, _allocs, _arguments[%s], %s);' % (i, i, size))
+            args.extend(['res%s[0]' % i, 'res%s[1]' % i])
+            if arg == 'out_bytes_sized':
+                inputs.append('var written%s = _alloc(m, _allocs, 4);' % i)
+                args.append('written%s' % i)
+                results.append('_out_result(m, res%s, m.HEAPU32[written%s >> 2], true)' % (i, i))
+            else:
+                results.append('_out_result(m, res%s, res%s[1], false)' % (i, i))
+            cur_out += 1
+        elif arg.startswith('const_bytes'):
+            inputs.append('var arg%s = _bytes(m, _allocs, _arguments[%s]);' % (i, i))
+            args.extend(['arg%s[0]' % i, 'arg%s[1]' % i])
+        elif arg.startswith('const_uint64s'):
+            inputs.append('var arg%s = _uint64s(m, _allocs, _arguments[%s]);' % (i, i))
+            args.extend(['arg%s[0]' % i, 'arg%s[1]' % i])
+        elif arg.startswith('uint32_t'):
+            args.append('_arguments[%s] >>> 0' % i)
+        elif arg.startswith('uint64_t'):
+            args.append('_uint64(_arguments[%s])' % i)
+        elif arg.startswith('string'):
+            args.append('_string(m, _allocs, _arguments[%s])' % i)
+        elif arg == 'out_str_p':
+            inputs.append('var str%s = _obj(m, _allocs, -2);' % i)
+            args.append('str%s' % i)
+            results.append('_string_result(m, str%s)' % i)
+        elif arg == 'out_uint64_t':
+            inputs.append('var u64%s = _alloc(m, _allocs, 8);' % i)
+            args.append('u64%s' % i)
+            results.append('_uint64_result(m, u64%s)' % i)
+        elif arg == 'bip32_in':
+            args.append('_bip32_in(m, _allocs, _arguments[%s])' % i)
+        elif arg in ['bip32_pub_out', 'bip32_priv_out']:
+            inputs.append('var key%s = _obj(m, _allocs, -1);' % i)
+            args.append('key%s' % i)
+            flag = {'bip32_pub_out': 'BIP32_FLAG_KEY_PUBLIC',
+                    'bip32_priv_out': 'BIP32_FLAG_KEY_PRIVATE'}[arg]
+            results.append('_bip32_out(m, _allocs, key%s, module.exports.%s)' % (i, flag))
+        else:
+            assert False, 'unknown argument type'
+
+    call_name = (f.wally_name or funcname) + ('_alloc' if f.nodejs_append_alloc else '')
+    result = results[0] if len(results) == 1 else '[%s]' % ', '.join(results)
+    return ('''
+module.exports.%s = function () {
+    var _arguments = arguments;
+    return _load().then(function (m) {
+        var _allocs = [];
+        try {
+            !!inputs!!
+            _check(m._%s(!!args!!), '%s');
+            return %s;
+        } finally {
+            _free(m, _allocs);
+        }
+    });
+};''' % (funcname, call_name, funcname, result)).replace(
+        '!!inputs!!', '\n            '.join(inputs)
+    ).replace(
+        '!!args!!', ', '.join(args)
+    )
+
+
+def exports(functions):
+    """Return the C functions called by the wrapper, one per line for EXPORTED_FUNCTIONS"""
+    names = ['wally_init', 'malloc', 'free', 'wally_free_string',
+             'bip32_key_unserialize_alloc', 'bip32_key_serialize', 'bip32_key_free']
+    for funcname, f in functions:
+        name = (f.wally_name or funcname) + ('_alloc' if f.nodejs_append_alloc else '')
+        if name not in names:
+            names.append(name)
+    return ''.join('_%s\n' % name for name in names)
+
+
+def generate(functions, build_type):
+    return TEMPLATE.replace(
+        '!!list_of_wasm_funcs!!',
+        '\n'.join(_generate_wasm(funcname, f) for funcname, f in functions)
+    )
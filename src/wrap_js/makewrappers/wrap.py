@@ -1,4 +1,4 @@
-from templates import js, nan, java, swift
+from templates import js, nan, java, swift, wasm
 import export_js_constants
 import sys, os
 
@@ -138,6 +138,11 @@ FUNCS = [
         BITCOIN_MESSAGE_FLAG_HASH, SHA256_LEN))),
 ]
 FUNCS_NODE = [
+    # Statistics, returned as a big endian 8 byte buffer:
+    ('wally_get_stats', F([
+        'uint32_t[stat]', 'out_uint64_t'
+    ])),
+
     # Assets:
     ('wally_asset_generator_from_bytes', F([
         'const_bytes[asset]', 'const_bytes[abf]', 'out_bytes_fixedsized'
@@ -208,6 +213,15 @@ def main():
         # Swift cordova plugin for iOS
         with open_file(prefix + 'cordovaplugin', 'WallyCordova.swift') as f:
             f.write(swift.generate(FUNCS, build_type))
+    elif sys.argv[1] == 'wasm':
+        # JS wrapper for the WebAssembly build, see tools/build_wasm.sh
+        with open_file(prefix + 'wasm', 'wally.js') as f:
+            f.write(wasm.generate(FUNCS + FUNCS_NODE, build_type))
+            f.write(export_js_constants.generate(os.path.pardir))
+    elif sys.argv[1] == 'wasm-exports':
+        # The C functions the WebAssembly wrapper calls, for emcc
+        with open_file(prefix + 'wasm', 'exports.txt') as f:
+            f.write(wasm.exports(FUNCS + FUNCS_NODE))
 
 
 if __name__ == '__main__':
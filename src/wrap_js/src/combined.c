@@ -2,19 +2,29 @@
 #include "internal.c"
 #include "aes.c"
 #include "base58.c"
+#include "base64.c"
 #include "bech32.c"
 #include "bip32.c"
 #include "bip38.c"
 #include "bip39.c"
+#include "block_reader.c"
+#include "coinselect.c"
 #include "elements.c"
+#include "hash_table.c"
 #include "hex.c"
 #include "hmac.c"
 #include "mnemonic.c"
 #include "pbkdf2.c"
+#include "psbt.c"
 #include "script.c"
 #include "scrypt.c"
+#include "sighash_stream.c"
 #include "sign.c"
+#include "siphash.c"
+#include "thread_pool.c"
 #include "transaction.c"
+#include "tx_set.c"
+#include "utxo_snapshot.c"
 #include "wif.c"
 #include "wordlist.c"
 #undef PACKAGE
@@ -39,7 +49,7 @@ void wally_silence_unused_warnings(void)
     secp256k1_ecmult_multi_var(NULL, NULL, NULL, NULL, NULL, NULL, 0);
     secp256k1_ecmult_strauss_batch_single(NULL, NULL, NULL, NULL, NULL, NULL, 0);
     secp256k1_ecmult_pippenger_batch_single(NULL, NULL, NULL, NULL, NULL, NULL, 0);
-    tx_elements_input_issuance_proof_init(NULL, NULL, 0, NULL, 0);
-    tx_elements_output_proof_init(NULL, NULL, 0, NULL, 0);
+    tx_elements_input_issuance_proof_init(NULL, NULL, 0, NULL, 0, false);
+    tx_elements_output_proof_init(NULL, NULL, 0, NULL, 0, false);
     witness_stack_from_bytes(NULL, NULL, NULL);
 }
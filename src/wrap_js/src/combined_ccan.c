@@ -1,3 +1,7 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <immintrin.h>
+#endif
 #include "internal.h"
 #include "ccan/ccan/crypto/sha512/sha512.c"
 #include "ccan/ccan/str/hex/hex.c"
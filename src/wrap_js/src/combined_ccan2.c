@@ -1,2 +1,6 @@
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+/* Included before internal.h, which prevents the use of malloc/free */
+#include <immintrin.h>
+#endif
 #include "internal.h"
 #include "ccan/ccan/crypto/ripemd160/ripemd160.c"
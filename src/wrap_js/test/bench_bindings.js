@@ -0,0 +1,76 @@
+/* Benchmarks of the per-call cost of the JS binding.
+ *
+ * Times the same operations with the same inputs as the "binding_"
+ * benchmarks of bench_wally, reported under the same names. Usage, from src/:
+ *
+ *   node wrap_js/test/bench_bindings.js [name_prefix ...]
+ *
+ * Hex encoding, zero-copy and batch calls are not wrapped for JS.
+ */
+var wally = require('../wally');
+
+var NUM_SAMPLES = 10;
+var FLAG_ECDSA = 1, FLAG_KEY_PUBLIC = 1;
+
+var bytes = Buffer.alloc(32, 0x02);
+var privKey = Buffer.alloc(32, 0x01);
+var seed = Buffer.alloc(32, 0x03);
+var master;
+
+var benchmarks = [
+    ['binding_sha256_32', 200000, function () { return wally.wally_sha256(bytes); }],
+    ['binding_ec_sig_from_bytes', 20000, function () {
+        return wally.wally_ec_sig_from_bytes(privKey, bytes, FLAG_ECDSA);
+    }],
+    ['binding_bip32_derive_pub', 20000, function () {
+        return wally.bip32_pubkey_from_parent(master, 1, FLAG_KEY_PUBLIC);
+    }]
+];
+
+/* Run fn n times, one call after another */
+function repeat(fn, n) {
+    var p = Promise.resolve();
+    for (var i = 0; i < n; ++i)
+        p = p.then(fn);
+    return p;
+}
+
+/* Print the median and 99th percentile time per call over the samples */
+function runBench(name, iterations, fn) {
+    var n = Math.min(iterations, NUM_SAMPLES);
+    var perSample = Math.ceil(iterations / n);
+    var samples = [];
+
+    function sample() {
+        var start = process.hrtime();
+        return repeat(fn, perSample).then(function () {
+            var t = process.hrtime(start);
+            samples.push((t[0] * 1e9 + t[1]) / perSample);
+        });
+    }
+
+    return repeat(fn, Math.floor(iterations / 10) + 1) /* Warm up */
+        .then(function () { return repeat(sample, n); })
+        .then(function () {
+            samples.sort(function (a, b) { return a - b; });
+            var median = n % 2 ? samples[(n - 1) / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+            var p99 = samples[Math.ceil(n * 99 / 100) - 1];
+            console.log(name.padEnd(32) + ' ' + median.toFixed(1).padStart(14) + ' ns/op ' +
+                        (1e9 / median).toFixed(1).padStart(14) + ' ops/sec ' +
+                        p99.toFixed(1).padStart(14) + ' ns p99');
+        });
+}
+
+var prefixes = process.argv.slice(2);
+wally.bip32_key_from_seed(seed, 0x0488ADE4, 0).then(function (key) {
+    master = key;
+    return benchmarks.reduce(function (p, b) {
+        var selected = !prefixes.length || prefixes.some(function (prefix) {
+            return b[0].indexOf(prefix) === 0;
+        });
+        return selected ? p.then(function () { return runBench(b[0], b[1], b[2]); }) : p;
+    }, Promise.resolve());
+}).catch(function (err) {
+    console.error(err);
+    process.exit(1);
+});
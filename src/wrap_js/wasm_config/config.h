@@ -0,0 +1,27 @@
+#ifndef LIBWALLYCORE_CONFIG_H
+#define LIBWALLYCORE_CONFIG_H
+/* Configuration for Emscripten builds targeting wasm32, see tools/build_wasm.sh.
+ * Browsers have no threads without cross origin isolation, so pthread support
+ * is left disabled and batch calls run serially */
+
+#define HAVE_ATTRIBUTE_WEAK 1
+#define HAVE_CLOCK_GETTIME 1
+#define HAVE_INTTYPES_H 1
+#define HAVE_POSIX_MEMALIGN 1
+#define HAVE_STDINT_H 1
+#define HAVE_STDIO_H 1
+#define HAVE_STDLIB_H 1
+#define HAVE_STRINGS_H 1
+#define HAVE_STRING_H 1
+#define HAVE_SYS_STAT_H 1
+#define HAVE_SYS_TYPES_H 1
+#define HAVE_UNALIGNED_ACCESS 1
+#define HAVE_UNISTD_H 1
+#define PACKAGE "libwallycore"
+#define PACKAGE_NAME "libwallycore"
+#define PACKAGE_VERSION "0.6.6"
+#define STDC_HEADERS 1
+#define VERSION "0.6.6"
+
+#include "ccan_config.h"
+#endif /*LIBWALLYCORE_CONFIG_H*/
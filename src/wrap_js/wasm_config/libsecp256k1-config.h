@@ -0,0 +1,30 @@
+#ifndef LIBSECP256K1_CONFIG_H
+#define LIBSECP256K1_CONFIG_H
+/* secp256k1 configuration for wasm32. WebAssembly has native 32x32->64 bit
+ * multiplication but no 128 bit product, so the 10x26 field and 8x32 scalar
+ * representations are used. The signing tables are generated at build time
+ * by tools/build_wasm.sh so that context creation does not compute them */
+
+#define ENABLE_MODULE_ECDH 1
+#define ENABLE_MODULE_GENERATOR 1
+#define ENABLE_MODULE_RANGEPROOF 1
+#define ENABLE_MODULE_RECOVERY 1
+#define ENABLE_MODULE_SURJECTIONPROOF 1
+#define ENABLE_MODULE_WHITELIST 1
+#define HAVE_INTTYPES_H 1
+#define HAVE_STDINT_H 1
+#define HAVE_STDLIB_H 1
+#define HAVE_STRINGS_H 1
+#define HAVE_STRING_H 1
+#define HAVE_SYS_STAT_H 1
+#define HAVE_SYS_TYPES_H 1
+#define HAVE_UNISTD_H 1
+#define STDC_HEADERS 1
+#define USE_ECMULT_STATIC_PRECOMPUTATION 1
+#define USE_FIELD_10X26 1
+#define USE_FIELD_INV_BUILTIN 1
+#define USE_NUM_NONE 1
+#define USE_SCALAR_8X32 1
+#define USE_SCALAR_INV_BUILTIN 1
+
+#endif /*LIBSECP256K1_CONFIG_H*/
@@ -4,6 +4,7 @@
 #define ENABLE_MODULE_ECDH 1
 #define ENABLE_MODULE_GENERATOR 1
 #define ENABLE_MODULE_RANGEPROOF 1
+#define ENABLE_MODULE_RECOVERY 1
 #define ENABLE_MODULE_SURJECTIONPROOF 1
 #define ENABLE_MODULE_WHITELIST 1
 #define HAVE_DLFCN_H 1
@@ -1,4 +1,10 @@
 #!/bin/sh
+# Apply our patches to the vendored secp256k1, unless already applied
+for p in ./tools/secp256k1-*.patch; do
+    if ! patch -p1 -R -s -f --dry-run <$p >/dev/null 2>&1; then
+        patch -p1 -N -s <$p || exit 1
+    fi
+done
 autoreconf --install --force --warnings=all
 if uname | grep "Darwin" >/dev/null 2>&1; then
     # Hack libtool to work around OSX requiring AR set to /usr/bin/libtool
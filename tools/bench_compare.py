@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Compare two bench_wally --json result files.
+
+Usage: bench_compare.py OLD.json NEW.json [--threshold PERCENT]
+
+Prints the change in median time per operation for each benchmark present
+in both files, and exits with status 1 if any benchmark's median is slower
+by more than the threshold (default 5%).
+"""
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        results = json.load(f)
+    return ({b['name']: b for b in results['benchmarks']},
+            results.get('cpu_features'))
+
+
+def main(argv):
+    threshold = 5.0
+    args = []
+    i = 0
+    while i < len(argv):
+        if argv[i] == '--threshold' and i + 1 < len(argv):
+            threshold = float(argv[i + 1])
+            i += 1
+        elif argv[i].startswith('--threshold='):
+            threshold = float(argv[i].split('=', 1)[1])
+        else:
+            args.append(argv[i])
+        i += 1
+    if len(args) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+
+    (old, old_cpu), (new, new_cpu) = load(args[0]), load(args[1])
+    if old_cpu != new_cpu:
+        print('warning: CPU features differ (%s vs %s), results may not be comparable'
+              % (old_cpu, new_cpu))
+    regressions = []
+    print('%-32s %14s %14s %9s %14s' % ('name', 'old ns/op', 'new ns/op',
+                                        'change', 'new p99 ns'))
+    for name in sorted(set(old) & set(new)):
+        old_ns, new_ns = old[name]['median_ns'], new[name]['median_ns']
+        change = (new_ns - old_ns) * 100.0 / old_ns if old_ns else 0.0
+        flag = ''
+        if change > threshold:
+            regressions.append(name)
+            flag = ' REGRESSION'
+        print('%-32s %14.1f %14.1f %+8.1f%% %14.1f%s' % (
+              name, old_ns, new_ns, change, new[name]['p99_ns'], flag))
+
+    for name in sorted(set(old) ^ set(new)):
+        print('%-32s only in %s' % (name, args[0] if name in old else args[1]))
+
+    if regressions:
+        print('%d benchmark(s) regressed by more than %.1f%%' %
+              (len(regressions), threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,55 @@
+#! /usr/bin/env bash
+#
+# Cross compile for aarch64 Linux and run the tests under qemu user mode
+# emulation, exercising the ARMv8 SHA256, SHA512 and AES code and the NEON
+# base64 code on x86 hosts.
+# Run from the top level directory after ./tools/autogen.sh. The library is
+# configured with --enable-arm-kernels, so the ARM kernels that are off by
+# default are built and tested.
+#
+# Requires an aarch64 cross compiler and qemu-aarch64 registered with
+# binfmt_misc, e.g. on Debian/Ubuntu:
+#
+#   apt-get install gcc-aarch64-linux-gnu libc6-dev-arm64-cross qemu-user-static
+#
+# The C tests are always run. The Python tests hold the hash and AES test
+# vectors, and need an aarch64 python3 to load the cross compiled library:
+# set AARCH64_SYSROOT to an arm64 root filesystem containing python3, e.g.
+# one created with "qemu-debootstrap --arch=arm64 --include=python3 ...".
+#
+# The tests are run once for each CPU in QEMU_CPUS. The default of
+# "max cortex-a53" runs the ARMv8 SHA256, SHA512 and AES paths, then the
+# portable SHA512 alongside them, as the cortex-a53 lacks the ARMv8.2
+# SHA512 instructions.
+#
+set -e
+
+HOST=${HOST:-aarch64-linux-gnu}
+QEMU_CPUS=${QEMU_CPUS:-"max cortex-a53"}
+
+if ! which $HOST-gcc >/dev/null 2>&1; then
+    echo "$HOST-gcc not found: install an aarch64 cross compiler" >&2
+    exit 1
+fi
+if [ ! -e /proc/sys/fs/binfmt_misc/qemu-aarch64 ]; then
+    echo "qemu-aarch64 is not registered with binfmt_misc: install qemu-user-static" >&2
+    exit 1
+fi
+
+if [ -n "$AARCH64_SYSROOT" ]; then
+    export QEMU_LD_PREFIX=$AARCH64_SYSROOT
+    python_test="PYTHONDONTWRITEBYTECODE=1 $AARCH64_SYSROOT/usr/bin/python3"
+else
+    export QEMU_LD_PREFIX=/usr/$HOST
+    # The host python cannot load an aarch64 library, so skip the Python tests
+    echo "AARCH64_SYSROOT is not set: only the C tests will be run" >&2
+    python_test=true
+fi
+
+CC=$HOST-gcc ./configure --host=$HOST --disable-dependency-tracking --enable-export-all --enable-arm-kernels $DEBUG_WALLY $ENABLE_ELEMENTS
+make
+
+for cpu in $QEMU_CPUS; do
+    echo "Running tests with QEMU_CPU=$cpu"
+    QEMU_CPU=$cpu make check PYTHON_TEST="$python_test"
+done
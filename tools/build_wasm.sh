@@ -0,0 +1,48 @@
+#! /usr/bin/env bash
+#
+# Build a WebAssembly module with JS bindings, for use from browsers/node.js.
+# Requires the Emscripten SDK, with emcc in the path. Set ENABLE_ELEMENTS
+# to --enable-elements to include Elements support.
+#
+# Outputs src/wrap_js/wasm/wally.js, which exposes the same promise based
+# API as the node.js wrapper, and the Emscripten module wallycore.js/.wasm.
+#
+# WebAssembly SIMD128 kernels for SHA-256 and hex are used; the resulting
+# module requires a runtime with SIMD support (all current browsers and
+# node.js 16.4+). Set WASM_NO_SIMD=1 to build without them.
+#
+set -e
+
+if ! which emcc >/dev/null 2>&1; then
+    echo "emcc not found: install and activate the Emscripten SDK" >&2
+    exit 1
+fi
+
+# The signing tables are generated by a native build of gen_context
+CC_NATIVE=${CC_NATIVE:-cc}
+(cd src/secp256k1 && \
+ $CC_NATIVE -I. -Isrc src/gen_context.c -o gen_context && \
+ ./gen_context && rm gen_context)
+
+mkdir -p src/wrap_js/wasm
+(cd src && \
+ PYTHONDONTWRITEBYTECODE=1 python3 wrap_js/makewrappers/wrap.py wasm Release && \
+ PYTHONDONTWRITEBYTECODE=1 python3 wrap_js/makewrappers/wrap.py wasm-exports Release)
+
+defines="-DSWIG_JAVASCRIPT_BUILD -DHAVE_CONFIG_H"
+if [ -n "$ENABLE_ELEMENTS" ]; then
+    defines="$defines -DBUILD_ELEMENTS"
+fi
+simd="-msimd128"
+if [ -n "$WASM_NO_SIMD" ]; then
+    simd=""
+fi
+
+emcc -O3 $simd $defines \
+    -Isrc/wrap_js/wasm_config -I. -Isrc -Isrc/secp256k1 -Isrc/secp256k1/src -Isrc/ccan \
+    src/wrap_js/src/combined.c src/wrap_js/src/combined_ccan.c src/wrap_js/src/combined_ccan2.c \
+    -s MODULARIZE=1 -s EXPORT_NAME=createWallycore \
+    -s ALLOW_MEMORY_GROWTH=1 -s WASM_BIGINT=1 \
+    -s EXPORTED_FUNCTIONS=@src/wrap_js/wasm/exports.txt \
+    -s EXPORTED_RUNTIME_METHODS=HEAPU8,HEAPU32,UTF8ToString,stringToUTF8,lengthBytesUTF8 \
+    -o src/wrap_js/wasm/wallycore.js
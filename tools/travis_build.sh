@@ -1,5 +1,10 @@
 #! /usr/bin/env bash
 
+if [ "$HOST" = "aarch64-linux-gnu" ]; then
+    # Cross compiled, with the tests run under qemu
+    exec ./tools/build_aarch64_qemu.sh
+fi
+
 ENABLE_SWIG_PYTHON="--enable-swig-python"
 ENABLE_SWIG_JAVA="--enable-swig-java"
 
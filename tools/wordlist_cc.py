@@ -4,6 +4,57 @@ import sys
 def as_hex(s):
     return ','.join([hex(c) for c in s.encode('utf8')])
 
+M64 = 0xffffffffffffffff
+
+def mix(h):
+    """ The murmur3 64 bit finalizer, matching wordlist_mix() in wordlist.c """
+    h ^= h >> 33
+    h = (h * 0xff51afd7ed558ccd) & M64
+    h ^= h >> 33
+    h = (h * 0xc4ceb9fe1a85ec53) & M64
+    return h ^ (h >> 33)
+
+def word_hash(seed, w):
+    """ FNV-1a, then mixed, matching wordlist_hash() in wordlist.c """
+    h = 0xcbf29ce484222325 ^ seed
+    for c in w.encode('utf8'):
+        h = ((h ^ c) * 0x100000001b3) & M64
+    return mix(h)
+
+def perfect_hash(words):
+    """ Build a minimal perfect hash using hash and displace.
+
+    Each word falls in a bucket selected by its hash h, and is stored at
+    slot mix(h + d) mod n, where d is the displacement chosen for its
+    bucket. Returns the seed, per bucket displacements and per slot word
+    indices.
+    """
+    n = len(words)
+    num_buckets = max(n // 4, 1)
+    for seed in range(1000):
+        hashes = [word_hash(seed, w) for w in words]
+        buckets = [[] for _ in range(num_buckets)]
+        for i, h in enumerate(hashes):
+            buckets[h % num_buckets].append(i)
+        displacements = [0] * num_buckets
+        table = [None] * n
+        ok = True
+        # Place the largest buckets first, while the table is emptiest
+        for b in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+            for d in range(65536):
+                slots = [mix((hashes[i] + d) & M64) % n for i in buckets[b]]
+                if len(set(slots)) == len(slots) and all(table[s] is None for s in slots):
+                    break
+            else:
+                ok = False
+                break
+            displacements[b] = d
+            for i, s in zip(buckets[b], slots):
+                table[s] = i
+        if ok:
+            return seed, displacements, table
+    assert False, 'No perfect hash found'
+
 if __name__ == "__main__":
 
     bits = { 2 ** x : x for x in range(12) } # Up to 4k words
@@ -18,10 +69,10 @@ if __name__ == "__main__":
         assert len(words) >= 2
         assert len(words) in bits
 
-        lengths = [ 0 ];
-        for w in words:
-            lengths.append(lengths[-1] + len(w.encode('utf-8')) + 1)
-        idxs = ['{0}+{1}'.format(string_name, n) for n in lengths]
+        offsets = [ 0 ];
+        for w in words[:-1]:
+            offsets.append(offsets[-1] + len(w.encode('utf-8')) + 1)
+        assert offsets[-1] < 65536, 'Word offsets must fit in uint16_t'
 
         print('/* Generated file - do not edit! */')
         print('#include <wordlist.h>')
@@ -33,14 +84,25 @@ if __name__ == "__main__":
             print('    %s,0,' % as_hex(w))
         print('};')
 
-        print('#define %s ((const char*)%s_)' % (string_name, string_name))
 
-        print('static const char *%s_i[] = {' % (string_name))
-        grouped = [idxs[i : i + 6] for i in range(0, len(idxs), 6)]
+        print('static const uint16_t %s_o[] = {' % string_name)
+        grouped = [offsets[i : i + 12] for i in range(0, len(offsets), 12)]
+        for g in grouped:
+            print('    %s,' % (', '.join([str(o) for o in g])))
+        print('   };')
+
+        seed, displacements, table = perfect_hash(words)
+        print()
+        print('static const uint16_t %s_d[] = {' % string_name)
+        grouped = [displacements[i : i + 12] for i in range(0, len(displacements), 12)]
+        for g in grouped:
+            print('    %s,' % (', '.join([str(d) for d in g])))
+        print('   };')
+        print('static const uint16_t %s_h[] = {' % string_name)
+        grouped = [table[i : i + 12] for i in range(0, len(table), 12)]
         for g in grouped:
-            print('    %s,' % (', '.join(g)))
+            print('    %s,' % (', '.join([str(i) for i in g])))
         print('   };')
-        print('#undef %s' % string_name)
 
         print()
         print('static const struct words %s = {' % struct_name)
@@ -49,5 +111,9 @@ if __name__ == "__main__":
         print('    {0},'.format(str(is_sorted).lower()))
         print('    (const char *)%s_,' % string_name)
         print('    0, /* Constant string */')
-        print('    %s_i' % string_name)
+        print('    NULL, /* Words are located by offset */')
+        print('    %s_o,' % string_name)
+        print('    {0}u,'.format(seed))
+        print('    %s_d,' % string_name)
+        print('    %s_h' % string_name)
         print('};')